@@ -3,13 +3,17 @@ import random
 import enum
 import socket
 
-CURRENT_REQUEST_VERSION = 1
-MAX_REQUEST_DATA_SIZE = 32
-MAX_PACKET_SIZE = 48
+CURRENT_REQUEST_VERSION = 2
+MAX_REQUEST_DATA_SIZE = 32 * 1024
+MAX_PACKET_SIZE = MAX_REQUEST_DATA_SIZE + 16
 
 class RequestType(enum.IntEnum):
     ReadMemory = 1,
-    WriteMemory = 2
+    WriteMemory = 2,
+    ReadMemoryBatch = 3,
+    WriteMemoryBatch = 4,
+    Subscribe = 5,
+    MemoryUpdate = 6
 
 CITRA_PORT = 45987
 
@@ -17,6 +21,7 @@ class Citra:
     def __init__(self, address="127.0.0.1", port=CITRA_PORT):
         self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
         self.address = address
+        self._pending_updates = []
 
     def is_connected(self):
         return self.socket is not None
@@ -25,6 +30,18 @@ class Citra:
         request_id = random.getrandbits(32)
         return (struct.pack("IIII", CURRENT_REQUEST_VERSION, request_id, request_type, data_size), request_id)
 
+    def _send_request(self, request_type, request_data):
+        request, request_id = self._generate_header(request_type, len(request_data))
+        self.socket.sendto(request + request_data, (self.address, CITRA_PORT))
+        while True:
+            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+            reply_version, reply_id, reply_type, reply_data_size = struct.unpack("IIII", raw_reply[:4*4])
+            # Memory updates of a subscription may arrive before the reply
+            if reply_type == RequestType.MemoryUpdate:
+                self._pending_updates.append(raw_reply)
+                continue
+            return self._read_and_validate_header(raw_reply, request_id, request_type)
+
     def _read_and_validate_header(self, raw_reply, expected_id, expected_type):
         reply_version, reply_id, reply_type, reply_data_size = struct.unpack("IIII", raw_reply[:4*4])
         if (CURRENT_REQUEST_VERSION == reply_version and
@@ -43,12 +60,7 @@ class Citra:
         while read_size > 0:
             temp_read_size = min(read_size, MAX_REQUEST_DATA_SIZE)
             request_data = struct.pack("II", read_address, temp_read_size)
-            request, request_id = self._generate_header(RequestType.ReadMemory, len(request_data))
-            request += request_data
-            self.socket.sendto(request, (self.address, CITRA_PORT))
-
-            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
-            reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.ReadMemory)
+            reply_data = self._send_request(RequestType.ReadMemory, request_data)
 
             if reply_data:
                 result += reply_data
@@ -75,12 +87,7 @@ class Citra:
             temp_write_size = min(write_size, MAX_REQUEST_DATA_SIZE - 8)
             request_data = struct.pack("II", write_address, temp_write_size)
             request_data += write_contents[:temp_write_size]
-            request, request_id = self._generate_header(RequestType.WriteMemory, len(request_data))
-            request += request_data
-            self.socket.sendto(request, (self.address, CITRA_PORT))
-
-            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
-            reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.WriteMemory)
+            reply_data = self._send_request(RequestType.WriteMemory, request_data)
 
             if None != reply_data:
                 write_address += temp_write_size
@@ -90,6 +97,102 @@ class Citra:
                 return False
         return True
 
+    def read_memory_batch(self, ranges):
+        """
+        Reads a list of (address, size) ranges in as few requests as possible.
+        >>> c.read_memory_batch([(0x100000, 4)]) == [c.read_memory(0x100000, 4)]
+        True
+        """
+        # Split the ranges larger than a reply, then group them into requests
+        chunks = []
+        for index, (address, size) in enumerate(ranges):
+            for offset in range(0, size, MAX_REQUEST_DATA_SIZE):
+                chunks.append((index, address + offset, min(size - offset, MAX_REQUEST_DATA_SIZE)))
+
+        result = [b""] * len(ranges)
+        while chunks:
+            batch = []
+            batch_size = 0
+            while chunks and batch_size + chunks[0][2] <= MAX_REQUEST_DATA_SIZE:
+                batch.append(chunks.pop(0))
+                batch_size += batch[-1][2]
+            request_data = b"".join(struct.pack("II", address, size) for _, address, size in batch)
+            reply_data = self._send_request(RequestType.ReadMemoryBatch, request_data)
+            if reply_data is None or len(reply_data) != batch_size:
+                return None
+
+            offset = 0
+            for index, _, size in batch:
+                result[index] += reply_data[offset:offset + size]
+                offset += size
+        return result
+
+    def write_memory_batch(self, writes):
+        """
+        Writes a list of (address, contents) ranges in as few requests as possible.
+        >>> c.write_memory_batch([(0x100000, b"\\x07\\x00\\x00\\xeb")])
+        True
+        """
+        request_data = b""
+        for address, contents in writes:
+            while contents:
+                space = MAX_REQUEST_DATA_SIZE - len(request_data) - 8
+                if space <= 0:
+                    if self._send_request(RequestType.WriteMemoryBatch, request_data) is None:
+                        return False
+                    request_data = b""
+                    continue
+                chunk = contents[:space]
+                request_data += struct.pack("II", address, len(chunk)) + chunk
+                address += len(chunk)
+                contents = contents[len(chunk):]
+        if request_data:
+            return self._send_request(RequestType.WriteMemoryBatch, request_data) is not None
+        return True
+
+    def subscribe(self, ranges):
+        """
+        Watches a list of (address, size) ranges, replacing those watched before. The changes are
+        pushed at the end of each frame, starting with the whole contents of the ranges. An empty
+        list ends the subscription.
+        >>> c.subscribe([(0x100000, 4)])
+        True
+        >>> c.receive_update()[1]
+        [(1048576, b'\\x07\\x00\\x00\\xeb')]
+        >>> c.subscribe([])
+        True
+        """
+        request_data = b"".join(struct.pack("II", address, size) for address, size in ranges)
+        return self._send_request(RequestType.Subscribe, request_data) is not None
+
+    def receive_update(self, timeout=None):
+        """
+        Waits for a memory update of the subscription, returning the frame number and a list of
+        the (address, contents) ranges that changed, or None on timeout.
+        """
+        if self._pending_updates:
+            raw_update = self._pending_updates.pop(0)
+        else:
+            self.socket.settimeout(timeout)
+            try:
+                raw_update = self.socket.recv(MAX_PACKET_SIZE)
+            except socket.timeout:
+                return None
+            finally:
+                self.socket.settimeout(None)
+
+        version, frame, update_type, data_size = struct.unpack("IIII", raw_update[:4*4])
+        if update_type != RequestType.MemoryUpdate:
+            return None
+        changes = []
+        data = raw_update[4*4:]
+        offset = 0
+        while offset + 8 <= len(data):
+            address, size = struct.unpack("II", data[offset:offset + 8])
+            changes.append((address, data[offset + 8:offset + 8 + size]))
+            offset += 8 + size
+        return (frame, changes)
+
 if "__main__" == __name__:
     import doctest
     doctest.testmod(extraglobs={'c': Citra()})
@@ -56,6 +56,11 @@ class CitraApplication : Application() {
         createNotificationChannel()
     }
 
+    override fun onTrimMemory(level: Int) {
+        super.onTrimMemory(level)
+        NativeLibrary.onTrimMemory(level)
+    }
+
     companion object {
         private var application: CitraApplication? = null
 
@@ -99,6 +99,13 @@ object NativeLibrary {
 
     external fun reloadSettings()
 
+    /**
+     * Asks the emulator caches to shrink, called when the system runs low on memory.
+     *
+     * @param level The level passed to ComponentCallbacks2.onTrimMemory.
+     */
+    external fun onTrimMemory(level: Int)
+
     external fun getTitleId(filename: String): Long
 
     external fun getIsSystemTitle(path: String): Boolean
@@ -510,6 +517,11 @@ object NativeLibrary {
 
     external fun loadState(slot: Int)
 
+    /**
+     * Steps the emulation back to the most recent state of the rewind buffer, if enabled.
+     */
+    external fun rewind()
+
     /**
      * Logs the Citra version, Android version and, CPU.
      */
@@ -490,6 +490,11 @@ class EmulationFragment : Fragment(), SurfaceHolder.Callback, Choreographer.Fram
                     true
                 }
 
+                R.id.menu_emulation_rewind -> {
+                    NativeLibrary.rewind()
+                    true
+                }
+
                 else -> true
             }
         }
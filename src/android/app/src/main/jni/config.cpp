@@ -131,6 +131,14 @@ void Config::ReadValues() {
     // Core
     ReadSetting("Core", Settings::values.use_cpu_jit);
     ReadSetting("Core", Settings::values.cpu_clock_percentage);
+    ReadSetting("Core", Settings::values.use_fastmem);
+    ReadSetting("Core", Settings::values.use_multi_core);
+    ReadSetting("Core", Settings::values.rewind_buffer_size);
+    ReadSetting("Core", Settings::values.rewind_interval);
+    ReadSetting("Core", Settings::values.use_boot_snapshot);
+    ReadSetting("Core", Settings::values.boot_snapshot_frames);
+    ReadSetting("Core", Settings::values.emulate_fs_delay);
+    ReadSetting("Core", Settings::values.thread_policy);
 
     // Renderer
     Settings::values.use_gles = sdl2_config->GetBoolean("Renderer", "use_gles", true);
@@ -169,6 +177,23 @@ void Config::ReadValues() {
     ReadSetting("Renderer", Settings::values.bg_red);
     ReadSetting("Renderer", Settings::values.bg_green);
     ReadSetting("Renderer", Settings::values.bg_blue);
+    ReadSetting("Renderer", Settings::values.async_gpu);
+    ReadSetting("Renderer", Settings::values.vertex_cache_size);
+    ReadSetting("Renderer", Settings::values.parallel_vertex_shading);
+    ReadSetting("Renderer", Settings::values.gpu_texture_decode);
+    ReadSetting("Renderer", Settings::values.gpu_y2r_conversion);
+    ReadSetting("Renderer", Settings::values.async_surface_readback);
+    ReadSetting("Renderer", Settings::values.frame_pacing);
+    ReadSetting("Renderer", Settings::values.low_latency_presentation);
+    ReadSetting("Renderer", Settings::values.ubershader_fallback);
+    ReadSetting("Renderer", Settings::values.parallel_command_recording);
+    ReadSetting("Renderer", Settings::values.texture_memory_budget);
+    ReadSetting("Renderer", Settings::values.deduplicate_texture_uploads);
+    ReadSetting("Renderer", Settings::values.dynamic_resolution);
+    ReadSetting("Renderer", Settings::values.adaptive_target_scale);
+    ReadSetting("Renderer", Settings::values.spatial_upscaling);
+    ReadSetting("Renderer", Settings::values.frame_skip);
+    ReadSetting("Renderer", Settings::values.perf_overlay);
 
     // Layout
     Settings::values.layout_option = static_cast<Settings::LayoutOption>(sdl2_config->GetInteger(
@@ -195,14 +220,18 @@ void Config::ReadValues() {
     // Audio
     ReadSetting("Audio", Settings::values.audio_emulation);
     ReadSetting("Audio", Settings::values.enable_audio_stretching);
+    ReadSetting("Audio", Settings::values.audio_stretching_quality);
     ReadSetting("Audio", Settings::values.volume);
     ReadSetting("Audio", Settings::values.output_type);
     ReadSetting("Audio", Settings::values.output_device);
+    ReadSetting("Audio", Settings::values.audio_buffer_size);
+    ReadSetting("Audio", Settings::values.audio_latency);
     ReadSetting("Audio", Settings::values.input_type);
     ReadSetting("Audio", Settings::values.input_device);
 
     // Data Storage
     ReadSetting("Data Storage", Settings::values.use_virtual_sd);
+    ReadSetting("Data Storage", Settings::values.romfs_cache_size);
 
     // System
     ReadSetting("System", Settings::values.is_new_3ds);
@@ -244,12 +273,14 @@ void Config::ReadValues() {
 
     // Miscellaneous
     ReadSetting("Miscellaneous", Settings::values.log_filter);
+    ReadSetting("Miscellaneous", Settings::values.log_deferred_formatting);
 
     // Apply the log_filter setting as the logger has already been initialized
     // and doesn't pick up the filter on its own.
     Common::Log::Filter filter;
     filter.ParseFilterString(Settings::values.log_filter.GetValue());
     Common::Log::SetGlobalFilter(filter);
+    Common::Log::SetDeferredFormatting(Settings::values.log_deferred_formatting.GetValue());
 
     // Debugging
     Settings::values.record_frame_times =
@@ -257,6 +288,8 @@ void Config::ReadValues() {
     ReadSetting("Debugging", Settings::values.renderer_debug);
     ReadSetting("Debugging", Settings::values.use_gdbstub);
     ReadSetting("Debugging", Settings::values.gdbstub_port);
+    ReadSetting("Debugging", Settings::values.profile_guest_code);
+    ReadSetting("Debugging", Settings::values.record_trace);
 
     for (const auto& service_module : Service::service_module_map) {
         bool use_lle = sdl2_config->GetBoolean("Debugging", "LLE\\" + service_module.name, false);
@@ -270,6 +303,10 @@ void Config::ReadValues() {
         sdl2_config->GetString("WebService", "web_api_url", "https://api.citra-emu.org");
     NetSettings::values.citra_username = sdl2_config->GetString("WebService", "citra_username", "");
     NetSettings::values.citra_token = sdl2_config->GetString("WebService", "citra_token", "");
+
+    // Multiplayer
+    NetSettings::values.wifi_coalescing_window_us = static_cast<unsigned int>(
+        sdl2_config->GetInteger("Multiplayer", "wifi_coalescing_window_us", 500));
 }
 
 void Config::Reload() {
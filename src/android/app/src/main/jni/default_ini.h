@@ -97,6 +97,30 @@ use_cpu_jit =
 # Range is any positive integer (but we suspect 25 - 400 is a good idea) Default is 100
 cpu_clock_percentage =
 
+# Memory in MiB kept for rewinding the emulation through recent states. 0 (default) disables it.
+rewind_buffer_size =
+
+# Emulated time in milliseconds between the states kept for rewinding. Default is 500
+rewind_interval =
+
+# Whether to snapshot a title once it booted and load the snapshot instead of booting it again.
+# The snapshot is remade after the title or the emulator are updated.
+# 0 (default): Off, 1: On
+use_boot_snapshot =
+
+# Number of frames after boot at which the boot snapshot is captured. Default is 600
+boot_snapshot_frames =
+
+# Whether file reads and opens take as long as on the console. Few titles depend on it, the others
+# load faster without it.
+# 0: Off, 1 (default): On
+emulate_fs_delay =
+
+# How the emulator threads are scheduled on the host CPU
+# 0: By the OS, 1 (default): Prioritized by role, 2: Prioritized by role and kept on the
+# performance or efficiency cores suited to it
+thread_policy =
+
 [Renderer]
 # Whether to render using OpenGL
 # 1: OpenGL ES (default), 2: Vulkan
@@ -240,6 +264,11 @@ enable_dsp_lle_thread =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# How audio stretching is done. The lower qualities use a lighter algorithm with less latency and
+# CPU usage, but more audible artifacts.
+# 0 (default): Low, 1: Medium, 2: High
+audio_stretching_quality =
+
 # Output volume.
 # 1.0 (default): 100%, 0.0; mute
 volume =
@@ -252,6 +281,17 @@ output_type =
 # auto (default): Auto-select
 output_device =
 
+# Number of frames the audio output requests at once. Smaller buffers lower the latency, but may
+# crackle on slower audio drivers.
+# 64 - 4096, 256 (default)
+audio_buffer_size =
+
+# Maximum amount of audio queued for output when audio stretching is off, in milliseconds. The
+# output rate is adjusted slightly to hold the queue at half of it, and older audio is dropped to
+# stay within it.
+# 5 - 250, 20 (default)
+audio_latency =
+
 # Which audio input type to use.
 # 0 (default): Auto-select, 1: No audio input, 2: Static noise, 3: Cubeb (if available), 4: OpenAL (if available)
 input_type =
@@ -265,6 +305,9 @@ input_device =
 # 1 (default): Yes, 0: No
 use_virtual_sd =
 
+# Memory in MiB used to cache the RomFS of each running title. Default is 8
+romfs_cache_size =
+
 [System]
 # The system model that Citra will try to emulate
 # 0: Old 3DS (default), 1: New 3DS
@@ -338,6 +381,10 @@ camera_inner_flip =
 # Examples: *:Debug Kernel.SVC:Trace Service.*:Critical
 log_filter = *:Info
 
+# Formats the log messages on the logging thread and limits the messages per second of each class,
+# to reduce the cost of verbose logging on the emulation. 0 (default): Off, 1: On
+log_deferred_formatting =
+
 [Debugging]
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
@@ -350,8 +397,17 @@ renderer_debug =
 use_gdbstub=false
 gdbstub_port=24689
 
+# Record the profiling scopes of every thread to a Chrome trace file in the log directory, which
+# can be opened with Perfetto. 0 (default): Off, 1: On
+record_trace =
+
 # To LLE a service module add "LLE\<module name>=true"
 
+[Multiplayer]
+# Wi-Fi frames to the same player queued within this many microseconds are sent as one packet
+# 0: Send every frame on its own, 500 (default)
+wifi_coalescing_window_us =
+
 [WebService]
 # Whether or not to enable telemetry
 # 0 (default): No, 1: Yes
@@ -89,3 +89,9 @@ void EmuWindow_Android::MakeCurrent() {
 void EmuWindow_Android::DoneCurrent() {
     core_context->DoneCurrent();
 }
+
+void EmuWindow_Android::PollEvents() {
+    if (performance_hint) {
+        performance_hint->OnFrameEnd();
+    }
+}
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include "core/frontend/emu_window.h"
+#include "jni/performance_hint.h"
 
 namespace Core {
 class System;
@@ -29,6 +31,14 @@ public:
 
     void DoneCurrent() override;
 
+    /// Called by the renderer at the end of every frame, and while emulation is paused
+    void PollEvents() override;
+
+    /// Sets the performance hint to report the frames to
+    void SetPerformanceHint(std::unique_ptr<PerformanceHint> hint) {
+        performance_hint = std::move(hint);
+    }
+
     virtual void TryPresenting() {}
 
     virtual void StopPresenting() {}
@@ -55,4 +65,5 @@ protected:
     int window_height{};
 
     std::unique_ptr<Frontend::GraphicsContext> core_context;
+    std::unique_ptr<PerformanceHint> performance_hint;
 };
@@ -4,14 +4,17 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdlib>
 #include <string>
+#include <thread>
 
 #include <android/native_window_jni.h>
 #include <glad/glad.h>
 
 #include "common/logging/log.h"
 #include "common/settings.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "input_common/main.h"
 #include "jni/emu_window/emu_window_gl.h"
@@ -73,7 +76,8 @@ private:
 };
 
 EmuWindow_Android_OpenGL::EmuWindow_Android_OpenGL(Core::System& system_, ANativeWindow* surface)
-    : EmuWindow_Android{surface}, system{system_} {
+    : EmuWindow_Android{surface}, system{system_},
+      use_present_thread{Settings::values.async_presentation.GetValue()} {
     if (egl_display = eglGetDisplay(EGL_DEFAULT_DISPLAY); egl_display == EGL_NO_DISPLAY) {
         LOG_CRITICAL(Frontend, "eglGetDisplay() failed");
         return;
@@ -179,10 +183,12 @@ std::unique_ptr<Frontend::GraphicsContext> EmuWindow_Android_OpenGL::CreateShare
 }
 
 void EmuWindow_Android_OpenGL::PollEvents() {
+    EmuWindow_Android::PollEvents();
     if (!render_window) {
         return;
     }
 
+    std::scoped_lock lock{present_mutex};
     host_window = render_window;
     render_window = nullptr;
 
@@ -193,25 +199,78 @@ void EmuWindow_Android_OpenGL::PollEvents() {
 }
 
 void EmuWindow_Android_OpenGL::StopPresenting() {
-    if (presenting_state == PresentingState::Running) {
-        eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    // The present thread can be in the middle of a frame, which uses the renderer, so it is joined
+    // before returning to keep the renderer alive until it is done. That happens once the lock is
+    // released, as the thread takes it too, and the next TryPresenting starts it again.
+    std::jthread stopped_thread;
+    {
+        std::scoped_lock lock{present_mutex};
+        // The present thread releases the context itself on the way out.
+        if (presenting_state == PresentingState::Running && !use_present_thread) {
+            eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            context_current = false;
+        }
+        presenting_state = PresentingState::Stopped;
+        stopped_thread = std::move(present_thread);
     }
-    presenting_state = PresentingState::Stopped;
 }
 
 void EmuWindow_Android_OpenGL::TryPresenting() {
     if (!system.IsPoweredOn()) {
         return;
     }
-    if (presenting_state == PresentingState::Initial) [[unlikely]] {
-        eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-        presenting_state = PresentingState::Running;
-    }
-    if (presenting_state != PresentingState::Running) [[unlikely]] {
+    if (use_present_thread) {
+        // Swaps and vsync waits happen on the present thread instead of the UI thread.
+        std::scoped_lock lock{present_mutex};
+        if (!present_thread.joinable()) {
+            present_thread =
+                std::jthread([this](std::stop_token token) { PresentThread(token); });
+        }
         return;
     }
+    PresentFrame(0);
+}
+
+bool EmuWindow_Android_OpenGL::PresentFrame(int timeout_ms) {
+    EGLSurface surface;
+    {
+        std::scoped_lock lock{present_mutex};
+        if (!system.IsPoweredOn() || presenting_state == PresentingState::Stopped) {
+            if (context_current) {
+                eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+                context_current = false;
+            }
+            return false;
+        }
+        if (presenting_state == PresentingState::Initial) [[unlikely]] {
+            eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            context_current = true;
+            presenting_state = PresentingState::Running;
+        }
+        surface = egl_surface;
+    }
+
+    // Waiting for the frame and the swap can take the timeout and a vsync, so they run without
+    // the lock to keep surface changes on the UI thread responsive. A surface destroyed meanwhile
+    // is only released by EGL once it is no longer current here, the next call binds the new one.
     eglSwapInterval(egl_display, Settings::values.use_vsync_new ? 1 : 0);
-    system.GPU().Renderer().TryPresent(0);
-    eglSwapBuffers(egl_display, egl_surface);
+    system.GPU().Renderer().TryPresent(timeout_ms);
+    eglSwapBuffers(egl_display, surface);
+    return true;
+}
+
+void EmuWindow_Android_OpenGL::PresentThread(std::stop_token token) {
+    Common::SetCurrentThreadRole(Common::ThreadRole::Render, "GLPresent");
+    while (!token.stop_requested()) {
+        if (!PresentFrame(100)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    std::scoped_lock lock{present_mutex};
+    if (context_current) {
+        eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        context_current = false;
+    }
 }
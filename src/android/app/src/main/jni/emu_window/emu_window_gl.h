@@ -4,11 +4,13 @@
 
 #pragma once
 
+#include <mutex>
 #include <vector>
 
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 
+#include "common/polyfill_thread.h"
 #include "jni/emu_window/emu_window.h"
 
 namespace Core {
@@ -33,6 +35,13 @@ private:
     void DestroyWindowSurface() override;
     void DestroyContext() override;
 
+    /// Presents the newest frame, waiting up to timeout_ms for one. Returns false if the
+    /// surface is not ready for presentation.
+    bool PresentFrame(int timeout_ms);
+
+    /// Presents frames as they arrive when presentation is decoupled from the UI thread.
+    void PresentThread(std::stop_token token);
+
 private:
     Core::System& system;
     EGLConfig egl_config;
@@ -46,4 +55,8 @@ private:
         Stopped,
     };
     PresentingState presenting_state{};
+    bool context_current{};
+    bool use_present_thread{};
+    std::mutex present_mutex;
+    std::jthread present_thread;
 };
@@ -3,9 +3,12 @@
 // Refer to the license.txt file included.
 
 #include <cstdlib>
+#include <android/choreographer.h>
+#include <android/looper.h>
 #include <android/native_window_jni.h>
 #include "common/logging/log.h"
 #include "common/settings.h"
+#include "common/thread.h"
 #include "jni/emu_window/emu_window_vk.h"
 
 class GraphicsContext_Android final : public Frontend::GraphicsContext {
@@ -25,7 +28,8 @@ private:
 
 EmuWindow_Android_Vulkan::EmuWindow_Android_Vulkan(
     ANativeWindow* surface, std::shared_ptr<Common::DynamicLibrary> driver_library_)
-    : EmuWindow_Android{surface}, driver_library{driver_library_} {
+    : EmuWindow_Android{surface}, driver_library{driver_library_},
+      android_library{"libandroid.so"} {
     CreateWindowSurface();
 
     if (core_context = CreateSharedContext(); !core_context) {
@@ -34,6 +38,56 @@ EmuWindow_Android_Vulkan::EmuWindow_Android_Vulkan(
     }
 
     OnFramebufferSizeChanged();
+
+    // The 64-bit frame time callback replaces the one taking a long on Android 10
+    if (android_library.IsLoaded()) {
+        post_frame_callback64 = android_library.GetSymbol<decltype(post_frame_callback64)>(
+            "AChoreographer_postFrameCallback64");
+    }
+    vsync_thread = std::jthread([this](std::stop_token stop_token) { VsyncThread(stop_token); });
+}
+
+EmuWindow_Android_Vulkan::~EmuWindow_Android_Vulkan() = default;
+
+std::chrono::steady_clock::time_point EmuWindow_Android_Vulkan::GetLastVsync() const {
+    // Frame times are in CLOCK_MONOTONIC, which is what steady_clock uses on Android
+    return std::chrono::steady_clock::time_point{
+        std::chrono::nanoseconds{last_vsync_ns.load(std::memory_order_relaxed)}};
+}
+
+void EmuWindow_Android_Vulkan::VsyncThread(std::stop_token stop_token) {
+    Common::SetCurrentThreadName("VsyncThread");
+    ALooper* looper = ALooper_prepare(0);
+    choreographer = AChoreographer_getInstance();
+    if (!choreographer) {
+        LOG_WARNING(Frontend, "Unable to get the Choreographer, presenting without vsync timing");
+        return;
+    }
+    ALooper_acquire(looper);
+    std::stop_callback wake{stop_token, [looper] { ALooper_wake(looper); }};
+
+    PostFrameCallback();
+    while (!stop_token.stop_requested()) {
+        ALooper_pollOnce(-1, nullptr, nullptr, nullptr);
+    }
+    ALooper_release(looper);
+}
+
+void EmuWindow_Android_Vulkan::OnVsync(s64 frame_time_nanos, void* data) {
+    auto* const window = static_cast<EmuWindow_Android_Vulkan*>(data);
+    window->last_vsync_ns.store(frame_time_nanos, std::memory_order_relaxed);
+    window->PostFrameCallback();
+}
+
+void EmuWindow_Android_Vulkan::PostFrameCallback() {
+    if (post_frame_callback64) {
+        post_frame_callback64(choreographer, &EmuWindow_Android_Vulkan::OnVsync, this);
+        return;
+    }
+    const auto callback = [](long frame_time_nanos, void* data) {
+        OnVsync(static_cast<s64>(frame_time_nanos), data);
+    };
+    AChoreographer_postFrameCallback(choreographer, callback, this);
 }
 
 bool EmuWindow_Android_Vulkan::CreateWindowSurface() {
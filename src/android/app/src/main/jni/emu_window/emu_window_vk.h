@@ -4,25 +4,42 @@
 
 #pragma once
 
+#include <atomic>
+#include <thread>
+#include "common/dynamic_library/dynamic_library.h"
 #include "jni/emu_window/emu_window.h"
 
+struct AChoreographer;
 struct ANativeWindow;
 
 class EmuWindow_Android_Vulkan : public EmuWindow_Android {
 public:
     EmuWindow_Android_Vulkan(ANativeWindow* surface,
                              std::shared_ptr<Common::DynamicLibrary> driver_library);
-    ~EmuWindow_Android_Vulkan() override = default;
-
-    void PollEvents() override {}
+    ~EmuWindow_Android_Vulkan() override;
 
     std::unique_ptr<GraphicsContext> CreateSharedContext() const override;
 
     std::shared_ptr<Common::DynamicLibrary> GetDriverLibrary() override;
 
+    std::chrono::steady_clock::time_point GetLastVsync() const override;
+
 private:
     bool CreateWindowSurface() override;
 
+    /// Receives the vsync signals of the display from the Choreographer of its own looper
+    void VsyncThread(std::stop_token stop_token);
+
+    /// Called by the Choreographer with the time of the vsync that started the current frame
+    static void OnVsync(s64 frame_time_nanos, void* data);
+
+    void PostFrameCallback();
+
 private:
     std::shared_ptr<Common::DynamicLibrary> driver_library;
+    Common::DynamicLibrary android_library;
+    void (*post_frame_callback64)(AChoreographer*, void (*)(s64, void*), void*){};
+    AChoreographer* choreographer{};
+    std::atomic<s64> last_vsync_ns{};
+    std::jthread vsync_thread;
 };
@@ -26,11 +26,13 @@
 #include "common/file_util.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
+#include "common/memory_budget.h"
 #include "common/microprofile.h"
 #include "common/scm_rev.h"
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "common/string_util.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "core/frontend/applets/default_applets.h"
 #include "core/frontend/camera/factory.h"
@@ -55,6 +57,7 @@
 #include "jni/id_cache.h"
 #include "jni/input_manager.h"
 #include "jni/ndk_motion.h"
+#include "jni/performance_hint.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
@@ -117,6 +120,8 @@ static void TryShutdown() {
         return;
     }
 
+    // Presenting uses the renderer, so it has to stop before the renderer is destroyed
+    window->StopPresenting();
     window->DoneCurrent();
     Core::System::GetInstance().Shutdown();
     window.reset();
@@ -135,6 +140,7 @@ static Core::System::ResultStatus RunCitra(const std::string& filepath) {
 
     LOG_INFO(Frontend, "Citra starting...");
 
+    Common::SetCurrentThreadRole(Common::ThreadRole::Emulation, "EmuThread");
     MicroProfileOnThreadCreate("EmuThread");
 
     if (filepath.empty()) {
@@ -222,6 +228,8 @@ static Core::System::ResultStatus RunCitra(const std::string& filepath) {
 
     SCOPE_EXIT({ TryShutdown(); });
 
+    window->SetPerformanceHint(std::make_unique<PerformanceHint>(system));
+
     // Start running emulation
     while (!stop_run) {
         if (!pause_emulation) {
@@ -545,6 +553,21 @@ void Java_org_citra_citra_1emu_NativeLibrary_onTouchMoved([[maybe_unused]] JNIEn
     window->OnTouchMoved((int)x, (int)y);
 }
 
+void Java_org_citra_citra_1emu_NativeLibrary_onTrimMemory([[maybe_unused]] JNIEnv* env,
+                                                          [[maybe_unused]] jobject obj,
+                                                          jint level) {
+    // Levels of ComponentCallbacks2, the UI being hidden alone is not a sign of low memory
+    constexpr jint TRIM_MEMORY_RUNNING_MODERATE = 5;
+    constexpr jint TRIM_MEMORY_RUNNING_CRITICAL = 15;
+    constexpr jint TRIM_MEMORY_UI_HIDDEN = 20;
+    if (level == TRIM_MEMORY_UI_HIDDEN || level < TRIM_MEMORY_RUNNING_MODERATE) {
+        return;
+    }
+    Common::MemoryBudget::Instance().ReportPressure(level >= TRIM_MEMORY_RUNNING_CRITICAL
+                                                        ? Common::MemoryPressure::Critical
+                                                        : Common::MemoryPressure::Moderate);
+}
+
 jlong Java_org_citra_citra_1emu_NativeLibrary_getTitleId(JNIEnv* env, [[maybe_unused]] jobject obj,
                                                          jstring j_filename) {
     std::string filepath = GetJString(env, j_filename);
@@ -732,6 +755,11 @@ void Java_org_citra_citra_1emu_NativeLibrary_loadState([[maybe_unused]] JNIEnv*
     Core::System::GetInstance().SendSignal(Core::System::Signal::Load, slot);
 }
 
+void Java_org_citra_citra_1emu_NativeLibrary_rewind([[maybe_unused]] JNIEnv* env,
+                                                    [[maybe_unused]] jobject obj) {
+    Core::System::GetInstance().SendSignal(Core::System::Signal::Rewind);
+}
+
 void Java_org_citra_citra_1emu_NativeLibrary_logDeviceInfo([[maybe_unused]] JNIEnv* env,
                                                            [[maybe_unused]] jobject obj) {
     LOG_INFO(Frontend, "Citra Version: {} | {}-{}", Common::g_build_fullname, Common::g_scm_branch,
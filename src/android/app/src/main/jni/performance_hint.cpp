@@ -0,0 +1,163 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <android/api-level.h>
+#include <unistd.h>
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/perf_stats.h"
+#include "jni/performance_hint.h"
+
+namespace {
+
+// Values of AThermalStatus
+constexpr int THERMAL_STATUS_MODERATE = 2;
+constexpr int THERMAL_STATUS_SEVERE = 3;
+
+} // Anonymous namespace
+
+PerformanceHint::PerformanceHint(Core::System& system_)
+    : system{system_}, android_library{"libandroid.so"} {
+    if (!android_library.IsLoaded()) {
+        return;
+    }
+
+    const int api_level = android_get_device_api_level();
+    if (api_level >= 33) {
+        const auto get_manager = android_library.GetSymbol<APerformanceHintManager* (*)()>(
+            "APerformanceHint_getManager");
+        create_session = android_library.GetSymbol<decltype(create_session)>(
+            "APerformanceHint_createSession");
+        update_target_duration = android_library.GetSymbol<decltype(update_target_duration)>(
+            "APerformanceHint_updateTargetWorkDuration");
+        report_actual_duration = android_library.GetSymbol<decltype(report_actual_duration)>(
+            "APerformanceHint_reportActualWorkDuration");
+        close_session =
+            android_library.GetSymbol<decltype(close_session)>("APerformanceHint_closeSession");
+        APerformanceHintManager* manager =
+            get_manager && create_session ? get_manager() : nullptr;
+        if (manager && update_target_duration && report_actual_duration && close_session) {
+            const std::int32_t thread_id = gettid();
+            session = create_session(manager, &thread_id, 1,
+                                     static_cast<std::int64_t>(1e9 / SCREEN_REFRESH_RATE));
+        }
+        if (session) {
+            UpdateTargetDuration();
+        } else {
+            LOG_WARNING(Frontend, "Unable to create a performance hint session");
+        }
+    }
+
+    if (api_level >= 30) {
+        const auto acquire_manager =
+            android_library.GetSymbol<AThermalManager* (*)()>("AThermal_acquireManager");
+        const auto get_status = android_library.GetSymbol<int (*)(AThermalManager*)>(
+            "AThermal_getCurrentThermalStatus");
+        const auto register_listener =
+            android_library.GetSymbol<int (*)(AThermalManager*, int (*)(void*, int), void*)>(
+                "AThermal_registerThermalStatusListener");
+        unregister_thermal_listener = android_library.GetSymbol<decltype(
+            unregister_thermal_listener)>("AThermal_unregisterThermalStatusListener");
+        release_thermal_manager =
+            android_library.GetSymbol<decltype(release_thermal_manager)>("AThermal_releaseManager");
+        if (acquire_manager && get_status && register_listener && unregister_thermal_listener &&
+            release_thermal_manager) {
+            thermal_manager = acquire_manager();
+        }
+        if (thermal_manager) {
+            OnThermalStatus(this, get_status(thermal_manager));
+            if (register_listener(thermal_manager, &PerformanceHint::OnThermalStatus, this) != 0) {
+                LOG_WARNING(Frontend, "Unable to listen to thermal status changes");
+                release_thermal_manager(thermal_manager);
+                thermal_manager = nullptr;
+            }
+        }
+    }
+}
+
+PerformanceHint::~PerformanceHint() {
+    if (thermal_manager) {
+        unregister_thermal_listener(thermal_manager, &PerformanceHint::OnThermalStatus, this);
+        release_thermal_manager(thermal_manager);
+    }
+    if (applied_level != ThermalLevel::Normal) {
+        ApplyThermalLevel(ThermalLevel::Normal);
+    }
+    if (session) {
+        close_session(session);
+    }
+}
+
+void PerformanceHint::OnFrameEnd() {
+    const ThermalLevel level = requested_level.load(std::memory_order_relaxed);
+    if (level != applied_level) {
+        ApplyThermalLevel(level);
+    }
+    if (!session) {
+        return;
+    }
+
+    // The window is also polled while emulation is paused, only report frames once
+    const auto [frame_end, work_time] = system.perf_stats->GetLastFrameWorkTime();
+    if (frame_end == last_frame_end) {
+        return;
+    }
+    last_frame_end = frame_end;
+    if (frame_limit != Settings::values.frame_limit.GetValue()) {
+        UpdateTargetDuration();
+    }
+    report_actual_duration(session,
+                           std::chrono::duration_cast<std::chrono::nanoseconds>(work_time).count());
+}
+
+int PerformanceHint::OnThermalStatus(void* data, int status) {
+    auto* const hint = static_cast<PerformanceHint*>(data);
+    ThermalLevel level = ThermalLevel::Normal;
+    if (status >= THERMAL_STATUS_SEVERE) {
+        level = ThermalLevel::SkipFrames;
+    } else if (status >= THERMAL_STATUS_MODERATE) {
+        level = ThermalLevel::LowerResolution;
+    }
+    if (level != hint->requested_level.exchange(level, std::memory_order_relaxed)) {
+        LOG_INFO(Frontend, "Thermal status changed to {}", status);
+    }
+    return 0;
+}
+
+void PerformanceHint::UpdateTargetDuration() {
+    // Frames are due at the emulated refresh rate scaled by the frame limit. Unlimited frame
+    // rates have no deadline, the native refresh rate keeps the governor from idling.
+    frame_limit = Settings::values.frame_limit.GetValue();
+    const double speed = frame_limit == 0 ? 1.0 : frame_limit / 100.0;
+    update_target_duration(session,
+                           static_cast<std::int64_t>(1e9 / (SCREEN_REFRESH_RATE * speed)));
+}
+
+void PerformanceHint::ApplyThermalLevel(ThermalLevel level) {
+    if (applied_level == ThermalLevel::Normal && level != ThermalLevel::Normal) {
+        user_resolution_factor = Settings::values.resolution_factor.GetValue();
+        user_frame_skip = Settings::values.frame_skip.GetValue();
+    }
+    switch (level) {
+    case ThermalLevel::Normal:
+        if (applied_level != ThermalLevel::Normal) {
+            Settings::values.resolution_factor = user_resolution_factor;
+            Settings::values.frame_skip = user_frame_skip;
+        }
+        break;
+    case ThermalLevel::LowerResolution:
+    case ThermalLevel::SkipFrames:
+        // A factor of 0 scales to the window, which is usually several times the native size
+        Settings::values.resolution_factor = std::max(user_resolution_factor / 2, 1U);
+        Settings::values.frame_skip =
+            level == ThermalLevel::SkipFrames ? std::max(user_frame_skip, 1U) : user_frame_skip;
+        break;
+    }
+    applied_level = level;
+    LOG_INFO(Frontend, "Rendering at {}x resolution with {} skipped frames",
+             Settings::values.resolution_factor.GetValue(), Settings::values.frame_skip.GetValue());
+}
@@ -0,0 +1,70 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "common/common_types.h"
+#include "common/dynamic_library/dynamic_library.h"
+
+namespace Core {
+class System;
+}
+
+struct APerformanceHintManager;
+struct APerformanceHintSession;
+struct AThermalManager;
+
+/**
+ * Tells the OS how long the emulation thread has to finish each frame and how long it actually
+ * took, through the Android Dynamic Performance Framework, so that the CPU governor clocks for the
+ * frame deadlines instead of reacting late to load spikes. When the device heats up, image quality
+ * is lowered step by step before the OS has to throttle: first the resolution scale, then frames
+ * are skipped. The user settings are restored once the device cools down.
+ * The APIs are loaded at runtime, each part is disabled on Android versions that lack it.
+ */
+class PerformanceHint {
+public:
+    /// Must be created on the emulation thread, which is the thread the hints are reported for
+    explicit PerformanceHint(Core::System& system);
+    ~PerformanceHint();
+
+    /// Reports the frame that just ended. Called by the emulation thread once per frame.
+    void OnFrameEnd();
+
+private:
+    enum class ThermalLevel : u32 {
+        Normal,          ///< The user settings apply
+        LowerResolution, ///< The resolution scale is halved
+        SkipFrames,      ///< Every other frame is skipped as well
+    };
+
+    /// Called by the OS on a binder thread when the thermal status of the device changes
+    static int OnThermalStatus(void* data, int status);
+
+    void UpdateTargetDuration();
+    void ApplyThermalLevel(ThermalLevel level);
+
+    Core::System& system;
+    Common::DynamicLibrary android_library;
+
+    APerformanceHintSession* (*create_session)(APerformanceHintManager*, const std::int32_t*,
+                                               std::size_t, std::int64_t){};
+    int (*update_target_duration)(APerformanceHintSession*, std::int64_t){};
+    int (*report_actual_duration)(APerformanceHintSession*, std::int64_t){};
+    void (*close_session)(APerformanceHintSession*){};
+    APerformanceHintSession* session{};
+    u16 frame_limit{};
+    std::chrono::high_resolution_clock::time_point last_frame_end{};
+
+    void (*release_thermal_manager)(AThermalManager*){};
+    int (*unregister_thermal_listener)(AThermalManager*, int (*)(void*, int), void*){};
+    AThermalManager* thermal_manager{};
+    std::atomic<ThermalLevel> requested_level{ThermalLevel::Normal};
+    ThermalLevel applied_level{ThermalLevel::Normal};
+    u32 user_resolution_factor{};
+    u32 user_frame_skip{};
+};
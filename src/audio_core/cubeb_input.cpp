@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
 #include <utility>
 #include <vector>
 #include <cubeb/cubeb.h>
@@ -9,17 +10,22 @@
 #include "audio_core/input.h"
 #include "audio_core/sink.h"
 #include "common/logging/log.h"
-#include "common/threadsafe_queue.h"
+#include "common/ring_buffer.h"
 
 namespace AudioCore {
 
-using SampleQueue = Common::SPSCQueue<Samples>;
+/// Bytes of converted samples buffered between the capture thread and the emulation thread, about
+/// two seconds of 16-bit audio at the highest sample rate.
+constexpr std::size_t sample_buffer_size = 0x10000;
 
 struct CubebInput::Impl {
     cubeb* ctx = nullptr;
     cubeb_stream* stream = nullptr;
 
-    SampleQueue sample_queue{};
+    /// Samples already in the format requested by the application, converted on the capture thread
+    Common::RingBuffer<u8, sample_buffer_size> sample_buffer;
+    /// Only used by the capture thread, to convert a block of samples before pushing it
+    std::array<u8, 0x400> convert_buffer;
     u8 sample_size_in_bytes = 0;
 
     static long DataCallback(cubeb_stream* stream, void* user_data, const void* input_buffer,
@@ -49,6 +55,7 @@ void CubebInput::StartSampling(const InputParameters& params) {
 
     parameters = params;
     impl->sample_size_in_bytes = params.sample_size / 8;
+    impl->sample_buffer.Discard(impl->sample_buffer.Size());
 
     auto init_result = cubeb_init(&impl->ctx, "Citra Input", nullptr);
     if (init_result != CUBEB_OK) {
@@ -134,17 +141,14 @@ void CubebInput::AdjustSampleRate(u32 sample_rate) {
     StartSampling(new_parameters);
 }
 
-Samples CubebInput::Read() {
+void CubebInput::Read(Samples& samples) {
+    samples.clear();
     if (!IsSampling()) {
-        return {};
+        return;
     }
 
-    Samples samples{};
-    Samples queue;
-    while (impl->sample_queue.Pop(queue)) {
-        samples.insert(samples.end(), queue.begin(), queue.end());
-    }
-    return samples;
+    samples.resize(impl->sample_buffer.Size());
+    samples.resize(impl->sample_buffer.Pop(samples.data(), samples.size()));
 }
 
 long CubebInput::Impl::DataCallback(cubeb_stream* stream, void* user_data, const void* input_buffer,
@@ -158,21 +162,29 @@ long CubebInput::Impl::DataCallback(cubeb_stream* stream, void* user_data, const
         return static_cast<u8>(static_cast<u16>(sample) >> 8);
     };
 
-    std::vector<u8> samples{};
-    samples.reserve(num_frames * impl->sample_size_in_bytes);
-    if (impl->sample_size_in_bytes == 1) {
+    // Only push whole samples, dropping the rest if the emulation thread fell behind
+    const std::size_t sample_size = impl->sample_size_in_bytes;
+    const std::size_t free_samples =
+        (sample_buffer_size - impl->sample_buffer.Size()) / sample_size;
+    const std::size_t count = std::min(static_cast<std::size_t>(num_frames), free_samples);
+
+    const u8* data = static_cast<const u8*>(input_buffer);
+    if (sample_size == 1) {
         // If the sample format is 8bit, then resample back to 8bit before passing back to core
-        for (std::size_t i = 0; i < static_cast<std::size_t>(num_frames); i++) {
-            s16 data;
-            std::memcpy(&data, static_cast<const u8*>(input_buffer) + i * 2, 2);
-            samples.push_back(resample_s16_s8(data));
+        for (std::size_t i = 0; i < count;) {
+            const std::size_t block = std::min(count - i, impl->convert_buffer.size());
+            for (std::size_t j = 0; j < block; j++) {
+                s16 sample;
+                std::memcpy(&sample, data + (i + j) * 2, 2);
+                impl->convert_buffer[j] = resample_s16_s8(sample);
+            }
+            impl->sample_buffer.Push(impl->convert_buffer.data(), block);
+            i += block;
         }
     } else {
         // Otherwise copy all of the samples to the buffer (which will be treated as s16 by core)
-        const u8* data = reinterpret_cast<const u8*>(input_buffer);
-        samples.insert(samples.begin(), data, data + num_frames * impl->sample_size_in_bytes);
+        impl->sample_buffer.Push(data, count * sample_size);
     }
-    impl->sample_queue.Push(samples);
 
     // returning less than num_frames here signals cubeb to stop sampling
     return num_frames;
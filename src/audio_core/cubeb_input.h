@@ -20,7 +20,7 @@ public:
     void StopSampling() override;
     bool IsSampling() override;
     void AdjustSampleRate(u32 sample_rate) override;
-    Samples Read() override;
+    void Read(Samples& samples) override;
 
 private:
     struct Impl;
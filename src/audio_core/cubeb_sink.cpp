@@ -9,6 +9,7 @@
 #include "audio_core/audio_types.h"
 #include "audio_core/cubeb_sink.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 
 namespace AudioCore {
 
@@ -68,9 +69,11 @@ CubebSink::CubebSink(std::string_view target_device_name) : impl(std::make_uniqu
         }
     }
 
+    const u32 latency =
+        std::max(Settings::values.audio_buffer_size.GetValue(), minimum_latency);
     auto stream_err = cubeb_stream_init(impl->ctx, &impl->stream, "CitraAudio", nullptr, nullptr,
-                                        output_device, &params, std::max(512u, minimum_latency),
-                                        &Impl::DataCallback, &Impl::StateCallback, impl.get());
+                                        output_device, &params, latency, &Impl::DataCallback,
+                                        &Impl::StateCallback, impl.get());
     if (stream_err != CUBEB_OK) {
         switch (stream_err) {
         case CUBEB_ERROR:
@@ -2,18 +2,27 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/sink.h"
 #include "audio_core/sink_details.h"
 #include "common/assert.h"
+#include "common/microprofile.h"
 #include "common/settings.h"
 #include "core/core.h"
 #include "core/dumping/backend.h"
 
 namespace AudioCore {
 
-DspInterface::DspInterface(Core::System& system_) : system(system_) {}
+MICROPROFILE_DEFINE(Audio_Output, "Audio", "Output Callback", MP_RGB(100, 100, 255));
+
+DspInterface::DspInterface(Core::System& system_)
+    : system(system_),
+      requested_stretching_quality{Settings::values.audio_stretching_quality.GetValue()},
+      stretching_quality{requested_stretching_quality},
+      time_stretcher{CreateTimeStretcher(stretching_quality)} {}
 
 DspInterface::~DspInterface() = default;
 
@@ -24,7 +33,8 @@ void DspInterface::SetSink(AudioCore::SinkType sink_type, std::string_view audio
     sink = AudioCore::GetSinkDetails(sink_type).create_sink(audio_device);
     sink->SetCallback(
         [this](s16* buffer, std::size_t num_frames) { OutputCallback(buffer, num_frames); });
-    time_stretcher.SetOutputSampleRate(sink->GetNativeSampleRate());
+    output_sample_rate = sink->GetNativeSampleRate();
+    time_stretcher->SetOutputSampleRate(output_sample_rate);
 }
 
 Sink& DspInterface::GetSink() {
@@ -36,12 +46,45 @@ void DspInterface::EnableStretching(bool enable) {
     enable_time_stretching = enable;
 }
 
+void DspInterface::SetStretchingQuality(Settings::AudioStretchingQuality quality) {
+    requested_stretching_quality = quality;
+}
+
+DspInterface::Stats DspInterface::GetAndResetStats() {
+    const u64 callbacks = stats.callbacks.exchange(0, std::memory_order_relaxed);
+    const u64 fill_sum = stats.fill_sum.exchange(0, std::memory_order_relaxed);
+    const u64 min_fill =
+        stats.min_fill.exchange(std::numeric_limits<u64>::max(), std::memory_order_relaxed);
+    const u64 stretch_in = stats.stretch_in.exchange(0, std::memory_order_relaxed);
+    const u64 stretch_out = stats.stretch_out.exchange(0, std::memory_order_relaxed);
+    const u64 frame_time_ns = stats.frame_time_ns.exchange(0, std::memory_order_relaxed);
+    const u64 frames_timed = stats.frames_timed.exchange(0, std::memory_order_relaxed);
+
+    return {
+        .frames_produced = stats.frames_produced.exchange(0, std::memory_order_relaxed),
+        .frames_consumed = stats.frames_consumed.exchange(0, std::memory_order_relaxed),
+        .mean_fill = callbacks ? static_cast<double>(fill_sum) / callbacks : 0.0,
+        .min_fill = callbacks ? min_fill : 0,
+        .stretch_ratio = stretch_out ? static_cast<double>(stretch_in) / stretch_out : 0.0,
+        .max_callback_jitter = stats.max_jitter_ns.exchange(0, std::memory_order_relaxed) / 1e9,
+        .mean_frame_time = frames_timed ? frame_time_ns / 1e9 / frames_timed : 0.0,
+    };
+}
+
+void DspInterface::RecordFrameTime(std::chrono::nanoseconds time) {
+    stats.frame_time_ns.fetch_add(time.count(), std::memory_order_relaxed);
+    stats.frames_timed.fetch_add(1, std::memory_order_relaxed);
+}
+
 void DspInterface::OutputFrame(StereoFrame16 frame) {
     if (!sink) {
         return;
     }
 
-    fifo.Push(frame.data(), frame.size());
+    if (fifo.Push(frame.data(), frame.size()) != frame.size()) {
+        overrun_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    stats.frames_produced.fetch_add(frame.size(), std::memory_order_relaxed);
 
     auto video_dumper = system.GetVideoDumper();
     if (video_dumper && video_dumper->IsDumping()) {
@@ -54,7 +97,10 @@ void DspInterface::OutputSample(std::array<s16, 2> sample) {
         return;
     }
 
-    fifo.Push(&sample, 1);
+    if (fifo.Push(&sample, 1) != 1) {
+        overrun_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    stats.frames_produced.fetch_add(1, std::memory_order_relaxed);
 
     auto video_dumper = system.GetVideoDumper();
     if (video_dumper && video_dumper->IsDumping()) {
@@ -62,10 +108,87 @@ void DspInterface::OutputSample(std::array<s16, 2> sample) {
     }
 }
 
+void DspInterface::RecordCallbackStats(std::size_t num_frames) {
+    const auto now = std::chrono::steady_clock::now();
+    if (last_callback_frames != 0) {
+        // The interval between two callbacks ideally matches the audio played by the first one
+        const auto expected = std::chrono::nanoseconds(
+            static_cast<s64>(last_callback_frames * 1'000'000'000ULL / output_sample_rate));
+        const auto jitter = static_cast<u64>(
+            std::abs((now - last_callback_time - expected) / std::chrono::nanoseconds(1)));
+        if (jitter > stats.max_jitter_ns.load(std::memory_order_relaxed)) {
+            stats.max_jitter_ns.store(jitter, std::memory_order_relaxed);
+        }
+    }
+    last_callback_time = now;
+    last_callback_frames = num_frames;
+
+    const u64 fill = fifo.Size();
+    stats.fill_sum.fetch_add(fill, std::memory_order_relaxed);
+    stats.callbacks.fetch_add(1, std::memory_order_relaxed);
+    if (fill < stats.min_fill.load(std::memory_order_relaxed)) {
+        stats.min_fill.store(fill, std::memory_order_relaxed);
+    }
+    stats.frames_consumed.fetch_add(num_frames, std::memory_order_relaxed);
+}
+
+double DspInterface::UpdateOutputRate(std::size_t queued_frames, std::size_t target_frames,
+                                      std::size_t num_frames) {
+    // The emulator produces a frame every 5 ms, and the frame limiter adds its own jitter, so the
+    // fill level is averaged over about a second before it is acted on.
+    constexpr double fill_time_scale = 1.0; // seconds
+    const double time_delta = static_cast<double>(num_frames) / native_sample_rate;
+    average_fill += (1.0 - std::exp(-time_delta / fill_time_scale)) *
+                    (static_cast<double>(queued_frames) - average_fill);
+
+    // Play slightly faster when the queue is fuller than the target and slower when it is
+    // emptier. The adjustment stays small enough for the change of pitch to be inaudible.
+    constexpr double max_rate_adjustment = 0.005;
+    const double error = (average_fill - static_cast<double>(target_frames)) /
+                         static_cast<double>(std::max<std::size_t>(target_frames, 1));
+    return 1.0 + std::clamp(error * max_rate_adjustment, -max_rate_adjustment, max_rate_adjustment);
+}
+
+std::size_t DspInterface::ResampleFifo(s16* buffer, std::size_t num_frames, double ratio) {
+    std::size_t frames_written = 0;
+    while (frames_written < num_frames) {
+        while (resample_position >= 1.0) {
+            std::array<s16, 2> frame;
+            if (fifo.Pop(&frame, 1) == 0) {
+                return frames_written;
+            }
+            resample_frames = {resample_frames[1], frame};
+            resample_position -= 1.0;
+        }
+
+        // Linear interpolation, which passes the frames through unchanged at the native rate
+        const auto& [previous, next] = resample_frames;
+        for (std::size_t channel = 0; channel < 2; channel++) {
+            buffer[2 * frames_written + channel] = static_cast<s16>(
+                previous[channel] + (next[channel] - previous[channel]) * resample_position);
+        }
+        frames_written++;
+        resample_position += ratio;
+    }
+    return frames_written;
+}
+
 void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
-    // Determine if we should stretch based on the current emulation speed.
+    MICROPROFILE_SCOPE(Audio_Output);
+    RecordCallbackStats(num_frames);
+
+    // The stretcher is only used on this thread, replace it here when the quality changed
+    if (const auto quality = requested_stretching_quality.load(); quality != stretching_quality) {
+        stretching_quality = quality;
+        time_stretcher = CreateTimeStretcher(quality);
+        time_stretcher->SetOutputSampleRate(output_sample_rate);
+    }
+
+    // Determine if we should stretch based on the current emulation speed. In turbo mode the
+    // audio is played back as it comes, stretching it would only lag further behind.
     const auto perf_stats = system.GetLastPerfStats();
-    const auto should_stretch = enable_time_stretching && perf_stats.emulation_speed <= 95;
+    const auto should_stretch = enable_time_stretching && !Settings::values.turbo_mode.GetValue() &&
+                                perf_stats.emulation_speed <= 95;
     if (performing_time_stretching && !should_stretch) {
         // If we just stopped stretching, flush the stretcher before returning to normal output.
         flushing_time_stretcher = true;
@@ -74,21 +197,40 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
 
     std::size_t frames_written = 0;
     if (performing_time_stretching) {
-        const std::vector<s16> in{fifo.Pop()};
-        const std::size_t num_in{in.size() / 2};
-        frames_written = time_stretcher.Process(in.data(), num_in, buffer, num_frames);
+        const std::size_t num_in = fifo.Pop(stretch_input.data(), stretch_input.size() / 2);
+        frames_written = time_stretcher->Process(stretch_input.data(), num_in, buffer, num_frames);
+        stats.stretch_in.fetch_add(num_in, std::memory_order_relaxed);
+        stats.stretch_out.fetch_add(frames_written, std::memory_order_relaxed);
     } else {
         if (flushing_time_stretcher) {
-            time_stretcher.Flush();
-            frames_written = time_stretcher.Process(nullptr, 0, buffer, num_frames);
+            time_stretcher->Flush();
+            frames_written = time_stretcher->Process(nullptr, 0, buffer, num_frames);
             flushing_time_stretcher = false;
 
             // Make sure any frames that did not fit are cleared from the time stretcher,
             // so that they do not bleed into the next time the stretcher is enabled.
-            time_stretcher.Clear();
+            time_stretcher->Clear();
+        }
+
+        // Drop the oldest frames when the queue grew past the configured latency, otherwise a
+        // burst of frames from the emulator delays all the audio following it.
+        const std::size_t max_frames =
+            Settings::values.audio_latency.GetValue() * native_sample_rate / 1000;
+        const std::size_t queued_frames = fifo.Size();
+        if (queued_frames > max_frames + num_frames) {
+            fifo.Discard(queued_frames - max_frames);
+            overrun_count.fetch_add(1, std::memory_order_relaxed);
         }
-        frames_written += fifo.Pop(buffer, num_frames - frames_written);
+
+        const double ratio = UpdateOutputRate(queued_frames, max_frames / 2, num_frames);
+        frames_written +=
+            ResampleFifo(buffer + 2 * frames_written, num_frames - frames_written, ratio);
+    }
+
+    if (frames_written < num_frames && !starved) {
+        underrun_count.fetch_add(1, std::memory_order_relaxed);
     }
+    starved = frames_written < num_frames;
 
     if (frames_written > 0) {
         std::memcpy(&last_frame[0], buffer + 2 * (frames_written - 1), 2 * sizeof(s16));
@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
 #include <memory>
 #include <span>
 #include <boost/serialization/access.hpp>
@@ -21,6 +25,10 @@ namespace Service::DSP {
 enum class InterruptType : u32;
 } // namespace Service::DSP
 
+namespace Settings {
+enum class AudioStretchingQuality : u32;
+} // namespace Settings
+
 namespace AudioCore {
 
 class Sink;
@@ -105,23 +113,107 @@ public:
     Sink& GetSink();
     /// Enable/Disable audio stretching.
     void EnableStretching(bool enable);
+    /// Select the audio stretching algorithm, applied on the next output callback.
+    void SetStretchingQuality(Settings::AudioStretchingQuality quality);
+
+    /// Returns the number of frames queued for output.
+    std::size_t GetQueuedFrames() const {
+        return fifo.Size();
+    }
+
+    /// Returns how many times the sink ran out of audio to play.
+    u64 GetUnderrunCount() const {
+        return underrun_count.load(std::memory_order_relaxed);
+    }
+
+    /// Returns how many times audio was dropped, either because the output queue was full or to
+    /// bring it back to the configured latency.
+    u64 GetOverrunCount() const {
+        return overrun_count.load(std::memory_order_relaxed);
+    }
+
+    /// Audio output statistics, accumulated since they were last reset.
+    struct Stats {
+        /// Frames output by the emulated DSP
+        u64 frames_produced;
+        /// Frames played by the sink, including the ones repeated when the output queue ran dry
+        u64 frames_consumed;
+        /// Mean and lowest number of frames queued for output, sampled at each sink callback
+        double mean_fill;
+        u64 min_fill;
+        /// Queued frames consumed per frame played by the time stretcher, 0 when not stretching
+        double stretch_ratio;
+        /// Largest difference between the interval of two sink callbacks and the duration of the
+        /// audio the first one played, in seconds
+        double max_callback_jitter;
+        /// Mean walltime spent generating a DSP frame, in seconds, 0 if it is not measured
+        double mean_frame_time;
+    };
+
+    /// Returns the statistics accumulated since the previous call and resets them.
+    Stats GetAndResetStats();
 
 protected:
     void OutputFrame(StereoFrame16 frame);
     void OutputSample(std::array<s16, 2> sample);
 
+    /// Records the walltime spent generating an audio frame, for the statistics.
+    void RecordFrameTime(std::chrono::nanoseconds time);
+
 private:
     void FlushResidualStretcherAudio();
     void OutputCallback(s16* buffer, std::size_t num_frames);
 
+    /// Updates the fill, jitter and consumption statistics at the start of a sink callback.
+    void RecordCallbackStats(std::size_t num_frames);
+
+    /// Returns the number of fifo frames to consume per output frame, so that the fifo is held
+    /// around the target fill without stretching the audio.
+    double UpdateOutputRate(std::size_t queued_frames, std::size_t target_frames,
+                            std::size_t num_frames);
+
+    /// Pops frames from the fifo resampled by `ratio`, returns the number of frames written.
+    std::size_t ResampleFifo(s16* buffer, std::size_t num_frames, double ratio);
+
     Core::System& system;
 
     std::atomic<bool> enable_time_stretching = false;
     std::atomic<bool> performing_time_stretching = false;
     std::atomic<bool> flushing_time_stretcher = false;
+    std::atomic<Settings::AudioStretchingQuality> requested_stretching_quality;
+    Settings::AudioStretchingQuality stretching_quality;
+    std::atomic<unsigned int> output_sample_rate = native_sample_rate;
     Common::RingBuffer<s16, 0x2000, 2> fifo;
+    /// Frames popped from the fifo for the time stretcher, kept here so that the sink thread
+    /// does not allocate.
+    std::array<s16, 0x2000 * 2> stretch_input{};
     std::array<s16, 2> last_frame{};
-    TimeStretcher time_stretcher;
+    /// State of the output rate control, only used by the sink thread
+    double average_fill = 0.0;
+    std::array<std::array<s16, 2>, 2> resample_frames{};
+    double resample_position = 1.0;
+    /// Whether the previous callback could not be filled, so that a starvation is counted once
+    bool starved = false;
+    std::atomic<u64> underrun_count = 0;
+    std::atomic<u64> overrun_count = 0;
+
+    /// Counters behind Stats, updated by the emulation and sink threads
+    struct StatsCounters {
+        std::atomic<u64> frames_produced = 0;
+        std::atomic<u64> frames_consumed = 0;
+        std::atomic<u64> fill_sum = 0;
+        std::atomic<u64> callbacks = 0;
+        std::atomic<u64> min_fill = std::numeric_limits<u64>::max();
+        std::atomic<u64> stretch_in = 0;
+        std::atomic<u64> stretch_out = 0;
+        std::atomic<u64> max_jitter_ns = 0;
+        std::atomic<u64> frame_time_ns = 0;
+        std::atomic<u64> frames_timed = 0;
+    } stats;
+    /// Time and length of the previous sink callback, only used by the sink thread
+    std::chrono::steady_clock::time_point last_callback_time{};
+    std::size_t last_callback_frames = 0;
+    std::unique_ptr<TimeStretcher> time_stretcher;
     std::unique_ptr<Sink> sink;
 
     template <class Archive>
@@ -4,10 +4,40 @@
 
 #include <neaacdec.h>
 #include "audio_core/hle/aac_decoder.h"
+#include "common/microprofile.h"
 
 namespace AudioCore::HLE {
 
-AACDecoder::AACDecoder(Memory::MemorySystem& memory) : memory(memory) {
+MICROPROFILE_DEFINE(Audio_DecodeAAC, "Audio", "Decode AAC", MP_RGB(40, 220, 100));
+
+namespace {
+
+/// Response given when decoding fails. This is a hack to continue games when a failure occurs.
+BinaryMessage FallbackResponse(const BinaryMessage& request) {
+    BinaryMessage response{};
+    response.header.codec = request.header.codec;
+    response.header.cmd = request.header.cmd;
+    response.decode_aac_response.size = request.decode_aac_request.size;
+    response.decode_aac_response.sample_rate = DecoderSampleRate::Rate48000;
+    response.decode_aac_response.num_channels = 2;
+    response.decode_aac_response.num_samples = 1024;
+    return response;
+}
+
+} // Anonymous namespace
+
+AACDecoder::AACDecoder(Memory::MemorySystem& memory)
+    : memory(memory), worker(1, "AAC decoder", Common::ThreadRole::Emulation) {
+    OpenDecoder();
+}
+
+AACDecoder::~AACDecoder() {
+    // The worker may still be using the decoder
+    worker.WaitForRequests();
+    CloseDecoder();
+}
+
+void AACDecoder::OpenDecoder() {
     decoder = NeAACDecOpen();
     if (decoder == nullptr) {
         LOG_CRITICAL(Audio_DSP, "Could not open FAAD2 decoder.");
@@ -27,94 +57,148 @@ AACDecoder::AACDecoder(Memory::MemorySystem& memory) : memory(memory) {
     LOG_INFO(Audio_DSP, "Created FAAD2 AAC decoder.");
 }
 
-AACDecoder::~AACDecoder() {
+void AACDecoder::CloseDecoder() {
     if (decoder) {
         NeAACDecClose(decoder);
         decoder = nullptr;
 
         LOG_INFO(Audio_DSP, "Destroyed FAAD2 AAC decoder.");
     }
+    stream_initialized = false;
+}
+
+void AACDecoder::StartRequest(const BinaryMessage& request) {
+    // Copy the input now, the worker does not access emulated memory
+    std::vector<u8> input;
+    if (request.header.codec == DecoderCodec::DecodeAAC &&
+        request.header.cmd == DecoderCommand::EncodeDecode) {
+        const u32 src_addr = request.decode_aac_request.src_addr;
+        const u32 size = request.decode_aac_request.size;
+        if (src_addr < Memory::FCRAM_PADDR ||
+            src_addr + size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+            LOG_ERROR(Audio_DSP, "Got out of bounds src_addr {:08x}", src_addr);
+        } else {
+            const u8* data = memory.GetFCRAMPointer(src_addr - Memory::FCRAM_PADDR);
+            input.assign(data, data + size);
+        }
+    }
+
+    std::promise<Result> promise;
+    pending.push(promise.get_future());
+    worker.QueueWork([this, request, input = std::move(input),
+                      promise = std::move(promise)]() mutable {
+        promise.set_value(Process(request, input));
+    });
+}
+
+std::optional<BinaryMessage> AACDecoder::FinishRequest() {
+    if (pending.empty()) {
+        return std::nullopt;
+    }
+    Result result = pending.front().get();
+    pending.pop();
+
+    // Transfer the decoded buffer from vector to the FCRAM.
+    for (std::size_t ch = 0; ch < result.samples.size(); ch++) {
+        if (result.samples[ch].empty()) {
+            continue;
+        }
+        auto byte_size = result.samples[ch].size() * sizeof(s16);
+        auto dst = ch == 0 ? result.request.decode_aac_request.dst_addr_ch0
+                           : result.request.decode_aac_request.dst_addr_ch1;
+        if (dst < Memory::FCRAM_PADDR ||
+            dst + byte_size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch{} {:08x}", ch, dst);
+            return FallbackResponse(result.request);
+        }
+        std::memcpy(memory.GetFCRAMPointer(dst - Memory::FCRAM_PADDR), result.samples[ch].data(),
+                    byte_size);
+    }
+
+    return result.response;
 }
 
-BinaryMessage AACDecoder::ProcessRequest(const BinaryMessage& request) {
+AACDecoder::Result AACDecoder::Process(const BinaryMessage& request, std::vector<u8>& input) {
     if (request.header.codec != DecoderCodec::DecodeAAC) {
         LOG_ERROR(Audio_DSP, "AAC decoder received unsupported codec: {}",
                   static_cast<u16>(request.header.codec));
         return {
-            .header =
+            .response =
                 {
-                    .result = ResultStatus::Error,
+                    .header =
+                        {
+                            .result = ResultStatus::Error,
+                        },
                 },
+            .request = request,
         };
     }
 
     switch (request.header.cmd) {
     case DecoderCommand::Init: {
-        BinaryMessage response = request;
-        response.header.result = ResultStatus::Success;
-        return response;
+        // A new stream starts, drop the state of the previous one
+        if (stream_initialized) {
+            CloseDecoder();
+            OpenDecoder();
+        }
+        Result result{.response = request, .request = request};
+        result.response.header.result = ResultStatus::Success;
+        return result;
     }
     case DecoderCommand::EncodeDecode: {
-        return Decode(request);
+        return Decode(request, input);
     }
     case DecoderCommand::Shutdown:
     case DecoderCommand::SaveState:
     case DecoderCommand::LoadState: {
         LOG_WARNING(Audio_DSP, "Got unimplemented AAC binary request: {}",
                     static_cast<u16>(request.header.cmd));
-        BinaryMessage response = request;
-        response.header.result = ResultStatus::Success;
-        return response;
+        Result result{.response = request, .request = request};
+        result.response.header.result = ResultStatus::Success;
+        return result;
     }
     default:
         LOG_ERROR(Audio_DSP, "Got unknown AAC binary request: {}",
                   static_cast<u16>(request.header.cmd));
         return {
-            .header =
+            .response =
                 {
-                    .result = ResultStatus::Error,
+                    .header =
+                        {
+                            .result = ResultStatus::Error,
+                        },
                 },
+            .request = request,
         };
     }
 }
 
-BinaryMessage AACDecoder::Decode(const BinaryMessage& request) {
-    BinaryMessage response{};
-    response.header.codec = request.header.codec;
-    response.header.cmd = request.header.cmd;
-    response.decode_aac_response.size = request.decode_aac_request.size;
-    // This is a hack to continue games when a failure occurs.
-    response.decode_aac_response.sample_rate = DecoderSampleRate::Rate48000;
-    response.decode_aac_response.num_channels = 2;
-    response.decode_aac_response.num_samples = 1024;
-
-    if (decoder == nullptr) {
-        return response;
+AACDecoder::Result AACDecoder::Decode(const BinaryMessage& request, std::vector<u8>& input) {
+    MICROPROFILE_SCOPE(Audio_DecodeAAC);
+    Result result{.response = FallbackResponse(request), .request = request};
+    if (decoder == nullptr || input.empty()) {
+        return result;
     }
 
-    if (request.decode_aac_request.src_addr < Memory::FCRAM_PADDR ||
-        request.decode_aac_request.src_addr + request.decode_aac_request.size >
-            Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-        LOG_ERROR(Audio_DSP, "Got out of bounds src_addr {:08x}",
-                  request.decode_aac_request.src_addr);
-        return response;
-    }
-    u8* data = memory.GetFCRAMPointer(request.decode_aac_request.src_addr - Memory::FCRAM_PADDR);
-    u32 data_len = request.decode_aac_request.size;
-
-    unsigned long sample_rate;
-    u8 num_channels;
-    auto init_result = NeAACDecInit(decoder, data, data_len, &sample_rate, &num_channels);
-    if (init_result < 0) {
-        LOG_ERROR(Audio_DSP, "Could not initialize FAAD2 AAC decoder for request: {}", init_result);
-        return response;
-    }
+    u8* data = input.data();
+    u32 data_len = static_cast<u32>(input.size());
+
+    // The decoder keeps its state across the frames of a stream
+    if (!stream_initialized) {
+        auto init_result = NeAACDecInit(decoder, data, data_len, &sample_rate, &num_channels);
+        if (init_result < 0) {
+            LOG_ERROR(Audio_DSP, "Could not initialize FAAD2 AAC decoder for request: {}",
+                      init_result);
+            return result;
+        }
+        stream_initialized = true;
 
-    // Advance past the frame header if needed.
-    data += init_result;
-    data_len -= init_result;
+        // Advance past the frame header if needed.
+        data += init_result;
+        data_len -= init_result;
+    }
 
-    std::array<std::vector<s16>, 2> out_streams;
+    auto& out_streams = result.samples;
 
     while (data_len > 0) {
         NeAACDecFrameInfo frame_info;
@@ -122,7 +206,11 @@ BinaryMessage AACDecoder::Decode(const BinaryMessage& request) {
             static_cast<s16*>(NeAACDecDecode(decoder, &frame_info, data, data_len));
         if (curr_sample_buffer == nullptr || frame_info.error != 0) {
             LOG_ERROR(Audio_DSP, "Failed to decode AAC buffer using FAAD2: {}", frame_info.error);
-            return response;
+            // Start over with a clean decoder on the next request
+            CloseDecoder();
+            OpenDecoder();
+            out_streams = {};
+            return result;
         }
 
         // Split the decode result into channels.
@@ -137,29 +225,12 @@ BinaryMessage AACDecoder::Decode(const BinaryMessage& request) {
         data_len -= frame_info.bytesconsumed;
     }
 
-    // Transfer the decoded buffer from vector to the FCRAM.
-    for (std::size_t ch = 0; ch < out_streams.size(); ch++) {
-        if (out_streams[ch].empty()) {
-            continue;
-        }
-        auto byte_size = out_streams[ch].size() * sizeof(s16);
-        auto dst = ch == 0 ? request.decode_aac_request.dst_addr_ch0
-                           : request.decode_aac_request.dst_addr_ch1;
-        if (dst < Memory::FCRAM_PADDR ||
-            dst + byte_size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch{} {:08x}", ch, dst);
-            return response;
-        }
-        std::memcpy(memory.GetFCRAMPointer(dst - Memory::FCRAM_PADDR), out_streams[ch].data(),
-                    byte_size);
-    }
-
     // Set the output frame info.
-    response.decode_aac_response.sample_rate = GetSampleRateEnum(sample_rate);
-    response.decode_aac_response.num_channels = num_channels;
-    response.decode_aac_response.num_samples = static_cast<u32_le>(out_streams[0].size());
+    result.response.decode_aac_response.sample_rate = GetSampleRateEnum(sample_rate);
+    result.response.decode_aac_response.num_channels = num_channels;
+    result.response.decode_aac_response.num_samples = static_cast<u32_le>(out_streams[0].size());
 
-    return response;
+    return result;
 }
 
 } // namespace AudioCore::HLE
@@ -4,23 +4,55 @@
 
 #pragma once
 
+#include <array>
+#include <future>
+#include <queue>
+#include <vector>
 #include "audio_core/hle/decoder.h"
+#include "common/thread_worker.h"
 
 namespace AudioCore::HLE {
 
 using NeAACDecHandle = void*;
 
+/**
+ * Decodes AAC with FAAD2 on a worker thread. The input is copied from FCRAM when a request is
+ * started, and the decoded samples are written to FCRAM when it is finished, so the worker never
+ * touches emulated memory.
+ */
 class AACDecoder final : public DecoderBase {
 public:
     explicit AACDecoder(Memory::MemorySystem& memory);
     ~AACDecoder() override;
-    BinaryMessage ProcessRequest(const BinaryMessage& request) override;
+
+    void StartRequest(const BinaryMessage& request) override;
+    std::optional<BinaryMessage> FinishRequest() override;
 
 private:
-    BinaryMessage Decode(const BinaryMessage& request);
+    struct Result {
+        BinaryMessage response;
+        BinaryMessage request;
+        /// Decoded samples of each channel, to write to the destination addresses
+        std::array<std::vector<s16>, 2> samples;
+    };
+
+    /// Runs on the worker thread
+    Result Process(const BinaryMessage& request, std::vector<u8>& input);
+    Result Decode(const BinaryMessage& request, std::vector<u8>& input);
+    void OpenDecoder();
+    void CloseDecoder();
 
     Memory::MemorySystem& memory;
+
+    // Only used by the worker thread once it started. The handle is kept across requests, and
+    // only recreated when a new stream is initialized or after an error.
     NeAACDecHandle decoder = nullptr;
+    bool stream_initialized = false;
+    unsigned long sample_rate = 0;
+    u8 num_channels = 0;
+
+    std::queue<std::future<Result>> pending;
+    Common::ThreadWorker worker;
 };
 
 } // namespace AudioCore::HLE
@@ -136,7 +136,24 @@ enum_le<DecoderSampleRate> GetSampleRateEnum(u32 sample_rate);
 class DecoderBase {
 public:
     virtual ~DecoderBase() = default;
-    virtual BinaryMessage ProcessRequest(const BinaryMessage& request) = 0;
+
+    /**
+     * Starts processing a request, possibly on another thread. Requests are processed in the order
+     * they are started. Must be called on the emulation thread.
+     */
+    virtual void StartRequest(const BinaryMessage& request) = 0;
+
+    /**
+     * Completes the oldest started request, waiting for it if needed, and returns its response.
+     * Returns nothing if no request is pending. Must be called on the emulation thread.
+     */
+    virtual std::optional<BinaryMessage> FinishRequest() = 0;
+
+    /// Processes a request right away. No other request may be pending.
+    BinaryMessage ProcessRequest(const BinaryMessage& request) {
+        StartRequest(request);
+        return *FinishRequest();
+    }
 };
 
 } // namespace AudioCore::HLE
@@ -21,6 +21,7 @@
 #include "common/common_types.h"
 #include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 
@@ -44,6 +45,12 @@ SERIALIZE_IMPL(DspHle)
 // This value has been verified against a rough hardware test with hardware and LLE
 static constexpr u64 audio_frame_ticks = samples_per_frame * 4096 * 2ull; ///< Units: ARM11 cycles
 
+// Time the DSP is modelled to take to decode an AAC frame, after which the response is delivered.
+// This is an estimate, it has not been measured on hardware.
+static constexpr u64 aac_decode_ticks = audio_frame_ticks / 4; ///< Units: ARM11 cycles
+
+MICROPROFILE_DEFINE(Audio_Frame, "Audio", "DSP Frame", MP_RGB(100, 180, 255));
+
 struct DspHle::Impl final {
 public:
     explicit Impl(DspHle& parent, Memory::MemorySystem& memory, Core::Timing& timing);
@@ -74,6 +81,7 @@ private:
     StereoFrame16 GenerateCurrentFrame();
     bool Tick();
     void AudioTickCallback(s64 cycles_late);
+    void DecodeDoneCallback();
 
     DspState dsp_state = DspState::Off;
     std::array<std::vector<u8>, num_dsp_pipe> pipe_data{};
@@ -91,6 +99,7 @@ private:
     DspHle& parent;
     Core::Timing& core_timing;
     Core::TimingEventType* tick_event{};
+    Core::TimingEventType* decode_event{};
 
     std::unique_ptr<HLE::DecoderBase> aac_decoder{};
 
@@ -122,10 +131,13 @@ DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory, Core::Timing&
             this->AudioTickCallback(cycles_late);
         });
     core_timing.ScheduleEvent(audio_frame_ticks, tick_event);
+    decode_event = core_timing.RegisterEvent("AudioCore::DspHle::decode_event",
+                                             [this](u64, s64) { this->DecodeDoneCallback(); });
 }
 
 DspHle::Impl::~Impl() {
     core_timing.UnscheduleEvent(tick_event, 0);
+    core_timing.UnscheduleEvent(decode_event, 0);
 }
 
 DspState DspHle::Impl::GetDspState() const {
@@ -253,7 +265,6 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, std::span<const u8> buffer) {
         return;
     }
     case DspPipe::Binary: {
-        // TODO(B3N30): Make this async, and signal the interrupt
         HLE::BinaryMessage request{};
         if (sizeof(request) != buffer.size()) {
             LOG_CRITICAL(Audio_DSP, "got binary pipe with wrong size {}", buffer.size());
@@ -266,11 +277,10 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, std::span<const u8> buffer) {
             UNIMPLEMENTED();
             return;
         }
-        const HLE::BinaryMessage response = aac_decoder->ProcessRequest(request);
-        pipe_data[static_cast<u32>(pipe_number)].resize(sizeof(response));
-        std::memcpy(pipe_data[static_cast<u32>(pipe_number)].data(), &response, sizeof(response));
-
-        interrupt_handler(InterruptType::Pipe, DspPipe::Binary);
+        // The request is processed in the background, the response is delivered when the DSP
+        // would have finished it
+        aac_decoder->StartRequest(request);
+        core_timing.ScheduleEvent(aac_decode_ticks, decode_event);
         break;
     }
     default:
@@ -396,17 +406,35 @@ StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
 }
 
 bool DspHle::Impl::Tick() {
+    MICROPROFILE_SCOPE(Audio_Frame);
     StereoFrame16 current_frame = {};
 
     // TODO: Check dsp::DSP semaphore (which indicates emulated application has finished writing to
     // shared memory region)
+    const auto frame_start = std::chrono::steady_clock::now();
     current_frame = GenerateCurrentFrame();
+    parent.RecordFrameTime(std::chrono::steady_clock::now() - frame_start);
 
     parent.OutputFrame(std::move(current_frame));
 
     return GetDspState() == DspState::On;
 }
 
+void DspHle::Impl::DecodeDoneCallback() {
+    const auto response = aac_decoder->FinishRequest();
+    if (!response) {
+        // The pending requests are not kept in save states
+        LOG_WARNING(Audio_DSP, "No AAC request pending for the decode event");
+        return;
+    }
+
+    auto& data = pipe_data[static_cast<u32>(DspPipe::Binary)];
+    data.resize(sizeof(*response));
+    std::memcpy(data.data(), &*response, sizeof(*response));
+
+    interrupt_handler(InterruptType::Pipe, DspPipe::Binary);
+}
+
 void DspHle::Impl::AudioTickCallback(s64 cycles_late) {
     if (Tick()) {
         // TODO(merry): Signal all the other interrupts as appropriate.
@@ -0,0 +1,99 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include "audio_core/hle/mix.h"
+#include "common/arch.h"
+
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
+// The vector paths only use SSE2 and NEON, which every x86_64 and arm64 CPU has. They give the
+// same results as the scalar path: each product is rounded to a float and truncated as before.
+
+namespace AudioCore::HLE {
+
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& samples,
+                       const std::array<float, 4>& gains) {
+#if CITRA_ARCH(x86_64)
+    const __m128 gain = _mm_loadu_ps(gains.data());
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        s32 pair;
+        std::memcpy(&pair, samples[i].data(), sizeof(pair));
+        // {left, right, left, right} sign extended to 32 bits
+        const __m128i stereo = _mm_shuffle_epi32(_mm_cvtsi32_si128(pair), 0);
+        const __m128i quad = _mm_srai_epi32(_mm_unpacklo_epi16(stereo, stereo), 16);
+        const __m128i mixed = _mm_cvttps_epi32(_mm_mul_ps(gain, _mm_cvtepi32_ps(quad)));
+        s32* const out = dest[i].data();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                         _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(out)),
+                                       mixed));
+    }
+#elif CITRA_ARCH(arm64)
+    const float32x4_t gain = vld1q_f32(gains.data());
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        s32 pair;
+        std::memcpy(&pair, samples[i].data(), sizeof(pair));
+        // {left, right, left, right} sign extended to 32 bits
+        const int32x4_t quad = vmovl_s16(vreinterpret_s16_s32(vdup_n_s32(pair)));
+        const int32x4_t mixed = vcvtq_s32_f32(vmulq_f32(gain, vcvtq_f32_s32(quad)));
+        s32* const out = dest[i].data();
+        vst1q_s32(out, vaddq_s32(vld1q_s32(out), mixed));
+    }
+#else
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        dest[i][0] += static_cast<s32>(gains[0] * samples[i][0]);
+        dest[i][1] += static_cast<s32>(gains[1] * samples[i][1]);
+        dest[i][2] += static_cast<s32>(gains[2] * samples[i][0]);
+        dest[i][3] += static_cast<s32>(gains[3] * samples[i][1]);
+    }
+#endif
+}
+
+void DownmixQuadIntoStereo(StereoFrame16& dest, const QuadFrame32& samples, float gain) {
+    static_assert(samples_per_frame % 2 == 0, "Samples are downmixed two at a time");
+#if CITRA_ARCH(x86_64)
+    const __m128 scale = _mm_set1_ps(gain);
+    for (std::size_t i = 0; i < samples_per_frame; i += 2) {
+        const auto* const in = reinterpret_cast<const __m128i*>(samples[i].data());
+        const __m128 first = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(in)), scale);
+        const __m128 second = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(in + 1)), scale);
+        // {front left + back left, front right + back right} of both samples
+        const __m128 stereo =
+            _mm_add_ps(_mm_movelh_ps(first, second), _mm_movehl_ps(second, first));
+        const __m128i clamped = _mm_packs_epi32(_mm_cvttps_epi32(stereo), _mm_setzero_si128());
+        s16* const out = dest[i].data();
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out),
+                         _mm_adds_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(out)),
+                                        clamped));
+    }
+#elif CITRA_ARCH(arm64)
+    for (std::size_t i = 0; i < samples_per_frame; i += 2) {
+        const float32x4_t first = vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(samples[i].data())), gain);
+        const float32x4_t second =
+            vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(samples[i + 1].data())), gain);
+        // {front left + back left, front right + back right} of both samples
+        const float32x4_t stereo =
+            vcombine_f32(vadd_f32(vget_low_f32(first), vget_high_f32(first)),
+                         vadd_f32(vget_low_f32(second), vget_high_f32(second)));
+        const int16x4_t clamped = vqmovn_s32(vcvtq_s32_f32(stereo));
+        s16* const out = dest[i].data();
+        vst1_s16(out, vqadd_s16(vld1_s16(out), clamped));
+    }
+#else
+    const auto clamp = [](s32 value) { return static_cast<s16>(std::clamp(value, -32768, 32767)); };
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        const s16 left = clamp(static_cast<s32>(gain * samples[i][0] + gain * samples[i][2]));
+        const s16 right = clamp(static_cast<s32>(gain * samples[i][1] + gain * samples[i][3]));
+        dest[i][0] = clamp(dest[i][0] + left);
+        dest[i][1] = clamp(dest[i][1] + right);
+    }
+#endif
+}
+
+} // namespace AudioCore::HLE
@@ -0,0 +1,31 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include "audio_core/audio_types.h"
+
+namespace AudioCore::HLE {
+
+/**
+ * Mixes a stereo frame into a quadraphonic one. The front and back left channels of the
+ * destination take the left samples, the right channels the right samples.
+ * @param dest Quadraphonic frame the samples are added to
+ * @param samples Stereo frame to mix
+ * @param gains Gains of the four destination channels
+ */
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& samples,
+                       const std::array<float, 4>& gains);
+
+/**
+ * Downmixes a quadraphonic frame to stereo and adds it to a stereo frame, saturating the results
+ * to 16 bits.
+ * @param dest Stereo frame the samples are added to
+ * @param samples Quadraphonic frame to downmix
+ * @param gain Gain of all the channels
+ */
+void DownmixQuadIntoStereo(StereoFrame16& dest, const QuadFrame32& samples, float gain);
+
+} // namespace AudioCore::HLE
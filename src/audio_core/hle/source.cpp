@@ -6,14 +6,20 @@
 #include <array>
 #include "audio_core/codec.h"
 #include "audio_core/hle/common.h"
+#include "audio_core/hle/mix.h"
 #include "audio_core/hle/source.h"
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/memory.h"
 
 namespace AudioCore::HLE {
 
+MICROPROFILE_DEFINE(Audio_DecodePCM8, "Audio", "Decode PCM8", MP_RGB(160, 220, 100));
+MICROPROFILE_DEFINE(Audio_DecodePCM16, "Audio", "Decode PCM16", MP_RGB(120, 220, 100));
+MICROPROFILE_DEFINE(Audio_DecodeADPCM, "Audio", "Decode ADPCM", MP_RGB(80, 220, 100));
+
 SourceStatus::Status Source::Tick(SourceConfiguration::Configuration& config,
                                   const s16_le (&adpcm_coeffs)[16]) {
     ParseConfig(config, adpcm_coeffs);
@@ -29,14 +35,8 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
     if (!state.enabled)
         return;
 
-    const std::array<float, 4>& gains = state.gain.at(intermediate_mix_id);
-    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
-        // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
-        dest[samplei][0] += static_cast<s32>(gains[0] * current_frame[samplei][0]);
-        dest[samplei][1] += static_cast<s32>(gains[1] * current_frame[samplei][1]);
-        dest[samplei][2] += static_cast<s32>(gains[2] * current_frame[samplei][0]);
-        dest[samplei][3] += static_cast<s32>(gains[3] * current_frame[samplei][1]);
-    }
+    // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
+    MixStereoIntoQuad(dest, current_frame, state.gain.at(intermediate_mix_id));
 }
 
 void Source::Reset() {
@@ -195,10 +195,12 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
                 UNIMPLEMENTED_MSG("{} not handled for partial buffer updates", "PCM8");
                 // state.current_buffer = Codec::DecodePCM8(num_channels, memory, config.length);
                 break;
-            case Format::PCM16:
+            case Format::PCM16: {
+                MICROPROFILE_SCOPE(Audio_DecodePCM16);
                 state.current_buffer = Codec::DecodePCM16(num_channels, memory, config.length);
                 valid = true;
                 break;
+            }
             case Format::ADPCM:
                 // TODO(xperia64): Are partial embedded buffer updates even valid for ADPCM? What
                 // about the adpcm state?
@@ -346,9 +348,8 @@ void Source::GenerateFrame() {
                                 current_frame, frame_position);
             break;
         case InterpolationMode::Polyphase:
-            // TODO(merry): Implement polyphase interpolation
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
-                                current_frame, frame_position);
+            AudioInterp::Polyphase(state.interp_state, state.current_buffer,
+                                   state.rate_multiplier, current_frame, frame_position);
             break;
         default:
             UNIMPLEMENTED();
@@ -383,17 +384,23 @@ bool Source::DequeueBuffer() {
     if (memory) {
         const unsigned num_channels = buf.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
         switch (buf.format) {
-        case Format::PCM8:
+        case Format::PCM8: {
+            MICROPROFILE_SCOPE(Audio_DecodePCM8);
             state.current_buffer = Codec::DecodePCM8(num_channels, memory, buf.length);
             break;
-        case Format::PCM16:
+        }
+        case Format::PCM16: {
+            MICROPROFILE_SCOPE(Audio_DecodePCM16);
             state.current_buffer = Codec::DecodePCM16(num_channels, memory, buf.length);
             break;
-        case Format::ADPCM:
+        }
+        case Format::ADPCM: {
+            MICROPROFILE_SCOPE(Audio_DecodeADPCM);
             DEBUG_ASSERT(num_channels == 1);
             state.current_buffer =
                 Codec::DecodeADPCM(memory, buf.length, state.adpcm_coeffs, state.adpcm_state);
             break;
+        }
         default:
             UNIMPLEMENTED();
             break;
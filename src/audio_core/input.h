@@ -50,8 +50,10 @@ public:
      * Called from the actual event timing at a constant period under a given sample rate.
      * When sampling is enabled this function is expected to return a buffer of 16 samples in ideal
      * conditions, but can be lax if the data is coming in from another source like a real mic.
+     * The samples replace the contents of the caller's buffer, whose storage is reused so that the
+     * emulation thread does not allocate once it has grown to the usual read size.
      */
-    virtual Samples Read() = 0;
+    virtual void Read(Samples& samples) = 0;
 
 protected:
     InputParameters parameters;
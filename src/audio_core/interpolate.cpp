@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cmath>
+#include <numbers>
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
 
@@ -10,11 +12,19 @@ namespace AudioCore::AudioInterp {
 
 // Calculations are done in fixed point with 24 fractional bits.
 // (This is not verified. This was chosen for minimal error.)
-constexpr u64 scale_factor = 1 << 24;
+constexpr u64 scale_bits = 24;
+constexpr u64 scale_factor = 1 << scale_bits;
 constexpr u64 scale_mask = scale_factor - 1;
 
+/// Phases of the polyphase filter, selected by the top bits of the fractional position.
+constexpr std::size_t polyphase_phase_bits = 8;
+constexpr std::size_t polyphase_phases = 1 << polyphase_phase_bits;
+/// The polyphase coefficients are fixed point with 14 fractional bits.
+constexpr int polyphase_coefficient_bits = 14;
+
 /// Here we step over the input in steps of rate, until we consume all of the input.
-/// Three adjacent samples are passed to fn each step.
+/// Four adjacent samples are passed to fn each step, the output lies between the second and the
+/// third one.
 template <typename Function>
 static void StepOverSamples(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
                             std::size_t& outputi, Function fn) {
@@ -23,7 +33,7 @@ static void StepOverSamples(State& state, StereoBuffer16& input, float rate, Ste
     if (input.empty())
         return;
 
-    input.insert(input.begin(), {state.xn2, state.xn1});
+    input.insert(input.begin(), {state.xn3, state.xn2, state.xn1});
 
     const u64 step_size = static_cast<u64>(rate * scale_factor);
     u64 fposition = state.fposition;
@@ -32,36 +42,71 @@ static void StepOverSamples(State& state, StereoBuffer16& input, float rate, Ste
     while (outputi < output.size()) {
         inputi = static_cast<std::size_t>(fposition / scale_factor);
 
-        if (inputi + 2 >= input.size()) {
-            inputi = input.size() - 2;
+        if (inputi + 3 >= input.size()) {
+            inputi = input.size() - 3;
             break;
         }
 
         u64 fraction = fposition & scale_mask;
-        output[outputi++] = fn(fraction, input[inputi], input[inputi + 1], input[inputi + 2]);
+        output[outputi++] = fn(fraction, input[inputi], input[inputi + 1], input[inputi + 2],
+                               input[inputi + 3]);
 
         fposition += step_size;
     }
 
-    state.xn2 = input[inputi];
-    state.xn1 = input[inputi + 1];
+    state.xn3 = input[inputi];
+    state.xn2 = input[inputi + 1];
+    state.xn1 = input[inputi + 2];
     state.fposition = fposition - inputi * scale_factor;
 
-    input.erase(input.begin(), std::next(input.begin(), inputi + 2));
+    input.erase(input.begin(), std::next(input.begin(), inputi + 3));
 }
 
+/// Computes the coefficients of the polyphase filter, a Lanczos kernel with a = 2 normalized so
+/// that each phase has a unity gain.
+static std::array<std::array<s16, 4>, polyphase_phases> MakePolyphaseCoefficients() {
+    const auto sinc = [](double x) {
+        return x == 0.0 ? 1.0 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+    };
+    std::array<std::array<s16, 4>, polyphase_phases> coefficients{};
+    for (std::size_t phase = 0; phase < polyphase_phases; phase++) {
+        const double fraction = static_cast<double>(phase) / polyphase_phases;
+        std::array<double, 4> kernel;
+        double sum = 0.0;
+        for (std::size_t tap = 0; tap < 4; tap++) {
+            // Distance of the tap from the output sample, taps are at -1, 0, 1 and 2
+            const double x = static_cast<double>(tap) - 1.0 - fraction;
+            kernel[tap] = sinc(x) * sinc(x / 2.0);
+            sum += kernel[tap];
+        }
+        int total = 0;
+        for (std::size_t tap = 0; tap < 4; tap++) {
+            coefficients[phase][tap] = static_cast<s16>(
+                std::lround(kernel[tap] / sum * (1 << polyphase_coefficient_bits)));
+            total += coefficients[phase][tap];
+        }
+        // Put the rounding error on the largest tap so that a constant input stays constant
+        const std::size_t largest = fraction < 0.5 ? 1 : 2;
+        coefficients[phase][largest] += static_cast<s16>((1 << polyphase_coefficient_bits) - total);
+    }
+    return coefficients;
+}
+
+static const auto polyphase_coefficients = MakePolyphaseCoefficients();
+
 void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
           std::size_t& outputi) {
-    StepOverSamples(
-        state, input, rate, output, outputi,
-        [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) { return x0; });
+    StepOverSamples(state, input, rate, output, outputi,
+                    [](u64 fraction, const auto& xm1, const auto& x0, const auto& x1,
+                       const auto& x2) { return x0; });
 }
 
 void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
             std::size_t& outputi) {
     // Note on accuracy: Some values that this produces are +/- 1 from the actual firmware.
     StepOverSamples(state, input, rate, output, outputi,
-                    [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) {
+                    [](u64 fraction, const auto& xm1, const auto& x0, const auto& x1,
+                       const auto& x2) {
                         // This is a saturated subtraction. (Verified by black-box fuzzing.)
                         s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
                         s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
@@ -73,4 +118,23 @@ void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& outp
                     });
 }
 
+void Polyphase(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
+               std::size_t& outputi) {
+    StepOverSamples(
+        state, input, rate, output, outputi,
+        [](u64 fraction, const auto& xm1, const auto& x0, const auto& x1, const auto& x2) {
+            const auto& c = polyphase_coefficients[fraction >> (scale_bits - polyphase_phase_bits)];
+            constexpr s32 rounding = 1 << (polyphase_coefficient_bits - 1);
+            const auto filter = [&c](s32 sm1, s32 s0, s32 s1, s32 s2) {
+                const s32 sum = c[0] * sm1 + c[1] * s0 + c[2] * s1 + c[3] * s2 + rounding;
+                return static_cast<s16>(
+                    std::clamp(sum >> polyphase_coefficient_bits, -32768, 32767));
+            };
+            return std::array<s16, 2>{
+                filter(xm1[0], x0[0], x1[0], x2[0]),
+                filter(xm1[1], x0[1], x1[1], x2[1]),
+            };
+        });
+}
+
 } // namespace AudioCore::AudioInterp
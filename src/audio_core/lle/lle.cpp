@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <teakra/teakra.h>
 #include "audio_core/lle/lle.h"
@@ -136,50 +139,89 @@ struct DspLle::Impl final {
     bool semaphore_signaled = false;
     bool data_signaled = false;
 
+    /// Samples output by the DSP, passed on a whole frame at a time
+    StereoFrame16 output_frame{};
+    std::size_t output_frame_samples = 0;
+
     Core::Timing& core_timing;
     Core::TimingEventType* teakra_slice_event;
     std::atomic<bool> loaded = false;
 
     const bool multithread;
     std::thread teakra_thread;
-    Common::Barrier teakra_slice_barrier{2};
-    std::atomic<bool> stop_signal = false;
-    std::size_t stop_generation;
+    std::mutex slice_mutex;
+    std::condition_variable slice_cv;
+    /// Number of slices the emulated time allowed so far, and the number the DSP thread ran
+    u64 slices_granted = 0;
+    u64 slices_run = 0;
+    bool stop_signal = false;
 
     static constexpr u32 DspDataOffset = 0x40000;
     static constexpr u32 TeakraSlice = 16384;
+    /// Number of slices the DSP thread may run ahead of or behind the emulated time, about 2 ms
+    static constexpr u64 SliceWindow = 8;
 
     void TeakraThread() {
+        Common::SetCurrentThreadRole(Common::ThreadRole::Emulation, "DSP");
+        std::unique_lock lock{slice_mutex};
         while (true) {
-            teakra.Run(TeakraSlice);
-            teakra_slice_barrier.Sync();
+            slice_cv.wait(lock, [this] {
+                return stop_signal || slices_run < slices_granted + SliceWindow;
+            });
             if (stop_signal) {
-                if (stop_generation == teakra_slice_barrier.Generation())
-                    break;
+                break;
             }
+            lock.unlock();
+            teakra.Run(TeakraSlice);
+            lock.lock();
+            slices_run++;
+            slice_cv.notify_all();
         }
+    }
+
+    void StartTeakraThread() {
+        slices_granted = 0;
+        slices_run = 0;
         stop_signal = false;
+        teakra_thread = std::thread(&Impl::TeakraThread, this);
     }
 
     void StopTeakraThread() {
         if (teakra_thread.joinable()) {
-            stop_generation = teakra_slice_barrier.Generation() + 1;
-            stop_signal = true;
-            teakra_slice_barrier.Sync();
+            {
+                std::scoped_lock lock{slice_mutex};
+                stop_signal = true;
+            }
+            slice_cv.notify_all();
             teakra_thread.join();
         }
     }
 
-    void RunTeakraSlice() {
-        if (multithread) {
-            teakra_slice_barrier.Sync();
-        } else {
+    /**
+     * Advances the DSP by a slice. With the DSP thread, the slice is only granted to it. When
+     * `wait` is set, this waits for the DSP to run at least one slice after the call, even if it
+     * is already ahead of the emulated time, so that the callers polling for a reply always see
+     * the DSP progress. Otherwise this only waits when the DSP fell more than the window behind.
+     * The DSP runs freely within the window, and the emulation only synchronizes with it when it
+     * needs a reply.
+     */
+    void RunTeakraSlice(bool wait = true) {
+        if (!multithread || std::this_thread::get_id() == teakra_thread.get_id()) {
             teakra.Run(TeakraSlice);
+            return;
+        }
+        std::unique_lock lock{slice_mutex};
+        slices_granted++;
+        slice_cv.notify_all();
+        u64 target = slices_granted > SliceWindow ? slices_granted - SliceWindow : 0;
+        if (wait) {
+            target = std::max(slices_granted, slices_run + 1);
         }
+        slice_cv.wait(lock, [this, target] { return slices_run >= target; });
     }
 
     void TeakraSliceEvent(u64 late) {
-        RunTeakraSlice();
+        RunTeakraSlice(false);
         u64 next = TeakraSlice * 2; // DSP runs at clock rate half of the CPU rate
         if (next < late)
             next = 0;
@@ -329,7 +371,7 @@ struct DspLle::Impl final {
         core_timing.ScheduleEvent(TeakraSlice, teakra_slice_event, 0);
 
         if (multithread) {
-            teakra_thread = std::thread(&Impl::TeakraThread, this);
+            StartTeakraThread();
         }
 
         // Wait for initialization
@@ -462,6 +504,12 @@ void DspLle::LoadComponent(std::span<const u8> buffer) {
 
 void DspLle::UnloadComponent() {
     impl->UnloadComponent();
+
+    // Pass on the samples of the partial frame, the DSP thread was stopped
+    for (std::size_t i = 0; i < impl->output_frame_samples; i++) {
+        OutputSample(impl->output_frame[i]);
+    }
+    impl->output_frame_samples = 0;
 }
 
 DspLle::DspLle(Core::System& system, bool multithread)
@@ -470,32 +518,43 @@ DspLle::DspLle(Core::System& system, bool multithread)
 DspLle::DspLle(Core::System& system, Memory::MemorySystem& memory, Core::Timing& timing,
                bool multithread)
     : DspInterface(system), impl(std::make_unique<Impl>(timing, multithread)) {
-    Teakra::AHBMCallback ahbm;
-    ahbm.read8 = [&memory](u32 address) -> u8 {
-        return *memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR);
+    // The DSP reaches FCRAM through these on every DMA transfer, so they index the FCRAM
+    // allocation directly, which lives as long as the memory system.
+    u8* const fcram = memory.GetFCRAMPointer(0);
+    const auto fcram_at = [fcram](u32 address) {
+        const u32 offset = address - Memory::FCRAM_PADDR;
+        ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
+        return fcram + offset;
     };
-    ahbm.write8 = [&memory](u32 address, u8 value) {
-        *memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR) = value;
-    };
-    ahbm.read16 = [&memory](u32 address) -> u16 {
+    Teakra::AHBMCallback ahbm;
+    ahbm.read8 = [fcram_at](u32 address) -> u8 { return *fcram_at(address); };
+    ahbm.write8 = [fcram_at](u32 address, u8 value) { *fcram_at(address) = value; };
+    ahbm.read16 = [fcram_at](u32 address) -> u16 {
         u16 value;
-        std::memcpy(&value, memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR), sizeof(u16));
+        std::memcpy(&value, fcram_at(address), sizeof(u16));
         return value;
     };
-    ahbm.write16 = [&memory](u32 address, u16 value) {
-        std::memcpy(memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR), &value, sizeof(u16));
+    ahbm.write16 = [fcram_at](u32 address, u16 value) {
+        std::memcpy(fcram_at(address), &value, sizeof(u16));
     };
-    ahbm.read32 = [&memory](u32 address) -> u32 {
+    ahbm.read32 = [fcram_at](u32 address) -> u32 {
         u32 value;
-        std::memcpy(&value, memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR), sizeof(u32));
+        std::memcpy(&value, fcram_at(address), sizeof(u32));
         return value;
     };
-    ahbm.write32 = [&memory](u32 address, u32 value) {
-        std::memcpy(memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR), &value, sizeof(u32));
+    ahbm.write32 = [fcram_at](u32 address, u32 value) {
+        std::memcpy(fcram_at(address), &value, sizeof(u32));
     };
     impl->teakra.SetAHBMCallback(ahbm);
-    impl->teakra.SetAudioCallback(
-        [this](std::array<s16, 2> sample) { OutputSample(std::move(sample)); });
+    // The DSP outputs a sample at a time. Collecting them into frames spares the fifo the
+    // synchronization, and the video dumper the allocations, of every single sample.
+    impl->teakra.SetAudioCallback([this](std::array<s16, 2> sample) {
+        impl->output_frame[impl->output_frame_samples++] = sample;
+        if (impl->output_frame_samples == impl->output_frame.size()) {
+            OutputFrame(impl->output_frame);
+            impl->output_frame_samples = 0;
+        }
+    });
 }
 DspLle::~DspLle() = default;
 
@@ -29,8 +29,8 @@ public:
 
     void AdjustSampleRate(u32 sample_rate) override {}
 
-    Samples Read() override {
-        return {};
+    void Read(Samples& samples) override {
+        samples.clear();
     }
 
 private:
@@ -84,9 +84,10 @@ void OpenALInput::AdjustSampleRate(u32 sample_rate) {
     StartSampling(new_params);
 }
 
-Samples OpenALInput::Read() {
+void OpenALInput::Read(Samples& samples) {
+    samples.clear();
     if (!IsSampling()) {
-        return {};
+        return;
     }
 
     ALCint samples_captured = 0;
@@ -94,21 +95,19 @@ Samples OpenALInput::Read() {
     auto error = alcGetError(impl->device);
     if (error != ALC_NO_ERROR) {
         LOG_WARNING(Audio, "alcGetIntegerv(ALC_CAPTURE_SAMPLES) failed: {}", error);
-        return {};
+        return;
     }
 
     auto num_samples = std::min(samples_captured, static_cast<ALsizei>(parameters.buffer_size /
                                                                        impl->sample_size_in_bytes));
-    Samples samples(num_samples * impl->sample_size_in_bytes);
+    samples.resize(num_samples * impl->sample_size_in_bytes);
 
     alcCaptureSamples(impl->device, samples.data(), num_samples);
     error = alcGetError(impl->device);
     if (error != ALC_NO_ERROR) {
         LOG_WARNING(Audio, "alcCaptureSamples failed: {}", error);
-        return {};
+        samples.clear();
     }
-
-    return samples;
 }
 
 std::vector<std::string> ListOpenALInputDevices() {
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <AL/al.h>
 #include <AL/alc.h>
@@ -9,6 +11,7 @@
 #include "audio_core/audio_types.h"
 #include "audio_core/openal_sink.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 
 namespace AudioCore {
 
@@ -34,7 +37,12 @@ OpenALSink::OpenALSink(std::string device_name) : impl(std::make_unique<Impl>())
         return;
     }
 
-    impl->context = alcCreateContext(impl->device, nullptr);
+    // The device mixes ALC_REFRESH times per second, which sets the size of its buffers
+    const ALCint refresh = std::max<ALCint>(
+        native_sample_rate / static_cast<ALCint>(Settings::values.audio_buffer_size.GetValue()),
+        1);
+    const std::array<ALCint, 3> context_attributes{ALC_REFRESH, refresh, 0};
+    impl->context = alcCreateContext(impl->device, context_attributes.data());
     if (impl->context == nullptr) {
         LOG_CRITICAL(Audio_Sink, "alcCreateContext failed: {}", alcGetError(impl->device));
         Close();
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <bit>
 #include <string>
 #include <vector>
 #include <SDL.h>
@@ -9,6 +10,7 @@
 #include "audio_core/sdl2_sink.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 
 namespace AudioCore {
 
@@ -34,7 +36,9 @@ SDL2Sink::SDL2Sink(std::string device_name) : impl(std::make_unique<Impl>()) {
     desired_audiospec.format = AUDIO_S16;
     desired_audiospec.channels = 2;
     desired_audiospec.freq = native_sample_rate;
-    desired_audiospec.samples = 512;
+    // SDL2 expects a power of two
+    desired_audiospec.samples =
+        static_cast<Uint16>(std::bit_ceil(Settings::values.audio_buffer_size.GetValue()));
     desired_audiospec.userdata = impl.get();
     desired_audiospec.callback = &Impl::Callback;
 
@@ -32,8 +32,9 @@ public:
 
     void AdjustSampleRate(u32 sample_rate) {}
 
-    Samples Read() {
-        return (parameters.sample_size == 8) ? CACHE_8_BIT : CACHE_16_BIT;
+    void Read(Samples& samples) {
+        const auto& cache = (parameters.sample_size == 8) ? CACHE_8_BIT : CACHE_16_BIT;
+        samples.assign(cache.begin(), cache.end());
     }
 
 private:
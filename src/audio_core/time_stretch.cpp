@@ -13,32 +13,24 @@
 
 #include "audio_core/audio_types.h"
 #include "audio_core/time_stretch.h"
+#include "audio_core/wsola_stretcher.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 
 namespace AudioCore {
 
-TimeStretcher::TimeStretcher() : sound_touch(std::make_unique<soundtouch::SoundTouch>()) {
-    sound_touch->setChannels(2);
-    sound_touch->setSampleRate(native_sample_rate);
-    sound_touch->setPitch(1.0);
-    sound_touch->setTempo(1.0);
-}
+TimeStretcher::TimeStretcher(double max_latency_) : max_latency{max_latency_} {}
 
 TimeStretcher::~TimeStretcher() = default;
 
-void TimeStretcher::SetOutputSampleRate(unsigned int sample_rate) {
-    sound_touch->setSampleRate(sample_rate);
-}
-
-std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
-                                   std::size_t num_out) {
+double TimeStretcher::UpdateStretchRatio(std::size_t& num_in, std::size_t num_out,
+                                         std::size_t backlog) {
     const double time_delta = static_cast<double>(num_out) / native_sample_rate; // seconds
     double current_ratio = static_cast<double>(num_in) / static_cast<double>(num_out);
 
-    const double max_latency = 0.25; // seconds
     const double max_backlog = native_sample_rate * max_latency;
-    const double backlog_fullness = sound_touch->numSamples() / max_backlog;
+    const double backlog_fullness = backlog / max_backlog;
     if (backlog_fullness > 4.0) {
         // Too many samples in backlog: Don't push anymore on
         num_in = 0;
@@ -60,32 +52,53 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
     // Place a lower limit of 5% speed. When a game boots up, there will be
     // many silence samples. These do not need to be timestretched.
     stretch_ratio = std::max(stretch_ratio, 0.05);
-    sound_touch->setTempo(stretch_ratio);
 
     LOG_TRACE(Audio, "{:5}/{:5} ratio:{:0.6f} backlog:{:0.6f}", num_in, num_out, stretch_ratio,
               backlog_fullness);
 
+    return stretch_ratio;
+}
+
+SoundTouchStretcher::SoundTouchStretcher()
+    : TimeStretcher(0.25), sound_touch(std::make_unique<soundtouch::SoundTouch>()) {
+    sound_touch->setChannels(2);
+    sound_touch->setSampleRate(native_sample_rate);
+    sound_touch->setPitch(1.0);
+    sound_touch->setTempo(1.0);
+}
+
+SoundTouchStretcher::~SoundTouchStretcher() = default;
+
+void SoundTouchStretcher::SetOutputSampleRate(unsigned int sample_rate) {
+    sound_touch->setSampleRate(sample_rate);
+}
+
+std::size_t SoundTouchStretcher::Process(const s16* in, std::size_t num_in, s16* out,
+                                         std::size_t num_out) {
+    sound_touch->setTempo(UpdateStretchRatio(num_in, num_out, sound_touch->numSamples()));
+
     if constexpr (std::is_floating_point<soundtouch::SAMPLETYPE>()) {
         // The SoundTouch library on most systems expects float samples
-        // use this vector to store input if soundtouch::SAMPLETYPE is a float
-        std::vector<soundtouch::SAMPLETYPE> float_in(2 * num_in);
-        std::vector<soundtouch::SAMPLETYPE> float_out(2 * num_out);
+        // use these vectors to store input if soundtouch::SAMPLETYPE is a float
+        float_in.resize(std::max(float_in.size(), 2 * num_in));
+        float_out.resize(std::max(float_out.size(), 2 * num_out));
 
         for (std::size_t i = 0; i < (2 * num_in); i++) {
             // Conventional integer PCM uses a range of -32768 to 32767,
             // but float samples use -1 to 1
             // As a result we need to scale sample values during conversion
             const float temp = static_cast<float>(in[i]) / std::numeric_limits<s16>::max();
-            float_in[i] = static_cast<soundtouch::SAMPLETYPE>(temp);
+            float_in[i] = temp;
         }
 
-        sound_touch->putSamples(float_in.data(), static_cast<u32>(num_in));
+        sound_touch->putSamples(reinterpret_cast<const soundtouch::SAMPLETYPE*>(float_in.data()),
+                                static_cast<u32>(num_in));
 
-        const std::size_t samples_received =
-            sound_touch->receiveSamples(float_out.data(), static_cast<u32>(num_out));
+        const std::size_t samples_received = sound_touch->receiveSamples(
+            reinterpret_cast<soundtouch::SAMPLETYPE*>(float_out.data()), static_cast<u32>(num_out));
 
         // Converting output samples back to shorts so we can use them
-        for (std::size_t i = 0; i < (2 * num_out); i++) {
+        for (std::size_t i = 0; i < (2 * samples_received); i++) {
             const s16 temp = static_cast<s16>(float_out[i] * std::numeric_limits<s16>::max());
             out[i] = temp;
         }
@@ -105,12 +118,24 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
     }
 }
 
-void TimeStretcher::Clear() {
+void SoundTouchStretcher::Clear() {
     sound_touch->clear();
 }
 
-void TimeStretcher::Flush() {
+void SoundTouchStretcher::Flush() {
     sound_touch->flush();
 }
 
+std::unique_ptr<TimeStretcher> CreateTimeStretcher(Settings::AudioStretchingQuality quality) {
+    switch (quality) {
+    case Settings::AudioStretchingQuality::Low:
+        return std::make_unique<WsolaStretcher>(WsolaStretcher::LowLatency);
+    case Settings::AudioStretchingQuality::Medium:
+        return std::make_unique<WsolaStretcher>(WsolaStretcher::Balanced);
+    case Settings::AudioStretchingQuality::High:
+    default:
+        return std::make_unique<SoundTouchStretcher>();
+    }
+}
+
 } // namespace AudioCore
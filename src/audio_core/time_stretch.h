@@ -7,35 +7,83 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <vector>
 #include "common/common_types.h"
 
 namespace soundtouch {
 class SoundTouch;
 }
 
+namespace Settings {
+enum class AudioStretchingQuality : u32;
+}
+
 namespace AudioCore {
 
+/**
+ * Changes the tempo of the audio so that it keeps up with the emulation speed, without changing
+ * its pitch. The tempo follows the ratio of the input to the requested output, corrected so that
+ * the audio buffered inside the stretcher stays around half of its maximum latency.
+ */
 class TimeStretcher {
 public:
-    TimeStretcher();
-    ~TimeStretcher();
+    virtual ~TimeStretcher();
 
-    void SetOutputSampleRate(unsigned int sample_rate);
+    virtual void SetOutputSampleRate(unsigned int sample_rate) = 0;
 
     /// @param in       Input sample buffer
     /// @param num_in   Number of input frames in `in`
     /// @param out      Output sample buffer
     /// @param num_out  Desired number of output frames in `out`
     /// @returns Actual number of frames written to `out`
-    std::size_t Process(const s16* in, std::size_t num_in, s16* out, std::size_t num_out);
+    virtual std::size_t Process(const s16* in, std::size_t num_in, s16* out,
+                                std::size_t num_out) = 0;
+
+    virtual void Clear() = 0;
+
+    virtual void Flush() = 0;
 
-    void Clear();
+protected:
+    explicit TimeStretcher(double max_latency);
 
-    void Flush();
+    /**
+     * Updates the stretch ratio for a call to Process.
+     * @param num_in   Number of input frames, set to 0 when the backlog is too full to take them
+     * @param num_out  Desired number of output frames
+     * @param backlog  Number of frames buffered inside the stretcher
+     * @returns The new stretch ratio, the number of input frames consumed per output frame
+     */
+    double UpdateStretchRatio(std::size_t& num_in, std::size_t num_out, std::size_t backlog);
 
 private:
-    std::unique_ptr<soundtouch::SoundTouch> sound_touch;
+    /// Maximum amount of audio buffered inside the stretcher, in seconds
+    double max_latency;
     double stretch_ratio = 1.0;
 };
 
+/// Time stretcher backed by SoundTouch, with the best quality but the highest latency and CPU cost.
+class SoundTouchStretcher final : public TimeStretcher {
+public:
+    SoundTouchStretcher();
+    ~SoundTouchStretcher() override;
+
+    void SetOutputSampleRate(unsigned int sample_rate) override;
+
+    std::size_t Process(const s16* in, std::size_t num_in, s16* out, std::size_t num_out) override;
+
+    void Clear() override;
+
+    void Flush() override;
+
+private:
+    std::unique_ptr<soundtouch::SoundTouch> sound_touch;
+    /// Conversion buffers for when SoundTouch works on floats, reused across calls so that the
+    /// sink thread does not allocate.
+    std::vector<float> float_in;
+    std::vector<float> float_out;
+};
+
+/// Creates the time stretcher matching a quality setting.
+std::unique_ptr<TimeStretcher> CreateTimeStretcher(Settings::AudioStretchingQuality quality);
+
 } // namespace AudioCore
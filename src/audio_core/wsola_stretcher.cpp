@@ -0,0 +1,183 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include "audio_core/audio_types.h"
+#include "audio_core/wsola_stretcher.h"
+
+namespace AudioCore {
+
+WsolaStretcher::WsolaStretcher(const Parameters& parameters_)
+    : TimeStretcher(parameters_.max_latency), parameters{parameters_} {
+    SetOutputSampleRate(native_sample_rate);
+}
+
+WsolaStretcher::~WsolaStretcher() = default;
+
+void WsolaStretcher::SetOutputSampleRate(unsigned int sample_rate) {
+    hop_size = std::max<std::size_t>(std::lround(parameters.window * sample_rate / 2), 16);
+    search_size = static_cast<std::size_t>(std::lround(parameters.search * sample_rate));
+
+    fade_in.resize(hop_size);
+    for (std::size_t i = 0; i < hop_size; i++) {
+        const double sine = std::sin(std::numbers::pi * (i + 0.5) / (2 * hop_size));
+        fade_in[i] = static_cast<float>(sine * sine);
+    }
+    overlap.resize(2 * hop_size);
+    reference.resize(hop_size);
+    candidates.resize(2 * search_size + 1 + hop_size);
+
+    // Size the buffers for the largest backlog up front, so that the sink thread does not
+    // allocate while playing.
+    const auto max_backlog = static_cast<std::size_t>(4 * parameters.max_latency * sample_rate);
+    input.reserve(2 * (max_backlog + 2 * (hop_size + search_size)));
+    output.reserve(2 * (max_backlog + hop_size));
+
+    Clear();
+}
+
+std::size_t WsolaStretcher::Process(const s16* in, std::size_t num_in, s16* out,
+                                    std::size_t num_out) {
+    const double queued = std::max(input.size() / 2.0 - position, 0.0);
+    const std::size_t backlog = static_cast<std::size_t>(queued) + output.size() / 2 - output_read;
+    const double tempo = UpdateStretchRatio(num_in, num_out, backlog);
+
+    const std::size_t input_size = input.size();
+    input.resize(input_size + 2 * num_in);
+    std::transform(in, in + 2 * num_in, input.begin() + input_size,
+                   [](s16 sample) { return static_cast<float>(sample); });
+
+    while (output.size() / 2 - output_read < num_out && OutputHop(tempo)) {
+    }
+
+    const std::size_t frames_written = std::min(output.size() / 2 - output_read, num_out);
+    std::memcpy(out, output.data() + 2 * output_read, frames_written * 2 * sizeof(s16));
+    output_read += frames_written;
+
+    Compact();
+    return frames_written;
+}
+
+void WsolaStretcher::Clear() {
+    input.clear();
+    position = 0.0;
+    continuation = 0;
+    has_previous = false;
+    std::fill(overlap.begin(), overlap.end(), 0.0f);
+    output.clear();
+    output_read = 0;
+}
+
+void WsolaStretcher::Flush() {
+    // Let the last window fade out, the input left is shorter than a window
+    if (has_previous) {
+        const std::size_t output_size = output.size();
+        output.resize(output_size + overlap.size());
+        std::transform(overlap.begin(), overlap.end(), output.begin() + output_size,
+                       [](float sample) { return static_cast<s16>(sample); });
+    }
+
+    input.clear();
+    position = 0.0;
+    continuation = 0;
+    has_previous = false;
+    std::fill(overlap.begin(), overlap.end(), 0.0f);
+}
+
+bool WsolaStretcher::OutputHop(double tempo) {
+    const std::size_t frames = input.size() / 2;
+    const auto center = static_cast<std::size_t>(position);
+    if (center + search_size + 2 * hop_size > frames ||
+        (has_previous && continuation + hop_size > frames)) {
+        return false;
+    }
+
+    const std::size_t start = has_previous ? FindBestWindow(center) : center;
+    const float* window = input.data() + 2 * start;
+
+    // The rising half of the window is added to the falling half of the previous one
+    const std::size_t output_size = output.size();
+    output.resize(output_size + 2 * hop_size);
+    s16* dest = output.data() + output_size;
+    for (std::size_t i = 0; i < hop_size; i++) {
+        for (std::size_t channel = 0; channel < 2; channel++) {
+            const float sample = overlap[2 * i + channel] + fade_in[i] * window[2 * i + channel];
+            dest[2 * i + channel] = static_cast<s16>(std::clamp(
+                sample, static_cast<float>(std::numeric_limits<s16>::min()),
+                static_cast<float>(std::numeric_limits<s16>::max())));
+        }
+    }
+    for (std::size_t i = 0; i < hop_size; i++) {
+        for (std::size_t channel = 0; channel < 2; channel++) {
+            overlap[2 * i + channel] =
+                (1.0f - fade_in[i]) * window[2 * (hop_size + i) + channel];
+        }
+    }
+
+    continuation = start + hop_size;
+    has_previous = true;
+    position += hop_size * tempo;
+    return true;
+}
+
+std::size_t WsolaStretcher::FindBestWindow(std::size_t center) {
+    const std::size_t first = center > search_size ? center - search_size : 0;
+    const std::size_t count = center + search_size - first + 1;
+
+    // Correlate mono mixes, laid out contiguously so that the loops vectorize
+    for (std::size_t i = 0; i < hop_size; i++) {
+        reference[i] = input[2 * (continuation + i)] + input[2 * (continuation + i) + 1];
+    }
+    for (std::size_t i = 0; i < count + hop_size - 1; i++) {
+        candidates[i] = input[2 * (first + i)] + input[2 * (first + i) + 1];
+    }
+
+    double energy = 0.0;
+    for (std::size_t i = 0; i < hop_size; i++) {
+        energy += candidates[i] * candidates[i];
+    }
+
+    std::size_t best = center;
+    double best_score = -std::numeric_limits<double>::infinity();
+    for (std::size_t offset = 0; offset < count; offset++) {
+        const float* candidate = candidates.data() + offset;
+        float correlation = 0.0f;
+        for (std::size_t i = 0; i < hop_size; i++) {
+            correlation += candidate[i] * reference[i];
+        }
+
+        // Normalize by the energy of the candidate so that loud windows are not favored
+        const double score = correlation / std::sqrt(std::max(energy, 1.0));
+        if (score > best_score) {
+            best_score = score;
+            best = first + offset;
+        }
+
+        if (offset + 1 < count) {
+            energy += candidate[hop_size] * candidate[hop_size] - candidate[0] * candidate[0];
+        }
+    }
+    return best;
+}
+
+void WsolaStretcher::Compact() {
+    output.erase(output.begin(), output.begin() + 2 * output_read);
+    output_read = 0;
+
+    // Keep the input from the earliest position a window may still start at
+    std::size_t keep = std::min(static_cast<std::size_t>(position), input.size() / 2);
+    keep = keep > search_size ? keep - search_size : 0;
+    if (has_previous) {
+        keep = std::min(keep, continuation);
+    }
+    input.erase(input.begin(), input.begin() + 2 * keep);
+    position -= keep;
+    continuation -= has_previous ? keep : 0;
+}
+
+} // namespace AudioCore
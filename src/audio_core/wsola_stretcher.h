@@ -0,0 +1,85 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "audio_core/time_stretch.h"
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+/**
+ * Time stretcher using waveform similarity overlap-add (WSOLA). The output is built from windows
+ * of the input overlapping by half. Each window is taken near the position given by the tempo, at
+ * the offset that best continues the previous window, which keeps the pitch intact.
+ *
+ * It is much lighter than SoundTouch and adds less latency, at the cost of more audible artifacts
+ * on strongly stretched audio.
+ */
+class WsolaStretcher final : public TimeStretcher {
+public:
+    struct Parameters {
+        /// Length of the overlapped windows, in seconds
+        double window;
+        /// Distance around the ideal position searched for the best window, in seconds
+        double search;
+        /// Maximum amount of audio buffered inside the stretcher, in seconds
+        double max_latency;
+    };
+
+    /// Short windows, for the lowest latency and CPU cost
+    static constexpr Parameters LowLatency{0.010, 0.003, 0.05};
+    /// Longer windows, for fewer artifacts on tonal audio
+    static constexpr Parameters Balanced{0.020, 0.005, 0.10};
+
+    explicit WsolaStretcher(const Parameters& parameters);
+    ~WsolaStretcher() override;
+
+    void SetOutputSampleRate(unsigned int sample_rate) override;
+
+    std::size_t Process(const s16* in, std::size_t num_in, s16* out, std::size_t num_out) override;
+
+    void Clear() override;
+
+    void Flush() override;
+
+private:
+    /// Outputs half a window. Returns false if there is not enough input for it.
+    bool OutputHop(double tempo);
+
+    /// Returns the start of the window around `center` that best continues the previous one.
+    std::size_t FindBestWindow(std::size_t center);
+
+    /// Drops the input and output that are no longer needed.
+    void Compact();
+
+    Parameters parameters;
+    /// Half the window length, in frames
+    std::size_t hop_size = 0;
+    std::size_t search_size = 0;
+    /// Rising half of a Hann window, the falling half is its complement to one
+    std::vector<float> fade_in;
+
+    /// Interleaved stereo input frames
+    std::vector<float> input;
+    /// Ideal position of the next window in the input, in frames
+    double position = 0.0;
+    /// Position in the input that naturally continues the previous window, in frames
+    std::size_t continuation = 0;
+    bool has_previous = false;
+
+    /// Second half of the previous window, faded out, to add to the next one
+    std::vector<float> overlap;
+    /// Mono mixes of the natural continuation and of the searched input
+    std::vector<float> reference;
+    std::vector<float> candidates;
+
+    /// Interleaved stereo frames produced but not yet returned
+    std::vector<s16> output;
+    std::size_t output_read = 0;
+};
+
+} // namespace AudioCore
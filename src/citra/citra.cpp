@@ -2,11 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <regex>
 #include <string>
 #include <thread>
+#include <json.hpp>
 
 // This needs to be included before getopt.h because the latter #defines symbols used by it
 #include "common/microprofile.h"
@@ -16,6 +21,7 @@
 #ifdef ENABLE_OPENGL
 #include "citra/emu_window/emu_window_sdl2_gl.h"
 #endif
+#include "citra/emu_window/emu_window_sdl2_null.h"
 #ifdef ENABLE_SOFTWARE_RENDERER
 #include "citra/emu_window/emu_window_sdl2_sw.h"
 #endif
@@ -31,6 +37,8 @@
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "common/string_util.h"
+#include "common/thread.h"
+#include "common/zstd_seekable.h"
 #include "core/core.h"
 #include "core/dumping/backend.h"
 #include "core/dumping/ffmpeg_backend.h"
@@ -38,6 +46,7 @@
 #include "core/frontend/framebuffer_layout.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/cfg/cfg.h"
+#include "core/loader/loader.h"
 #include "core/movie.h"
 #include "core/telemetry_session.h"
 #include "input_common/main.h"
@@ -72,17 +81,128 @@ static void PrintHelp(const char* argv0) {
               << " [options] <filename>\n"
                  "-g, --gdbport=NUMBER Enable gdb stub on port NUMBER\n"
                  "-i, --install=FILE    Installs a specified CIA file\n"
+                 "-c, --compress=FILE   Compresses a CCI or CXI image next to it, as a ZCCI or "
+                 "ZCXI image\n"
                  "-m, --multiplayer=nick:password@address:port"
                  " Nickname, password, address and port for multiplayer\n"
                  "-r, --movie-record=[file]  Record a movie (game inputs) to the given file\n"
                  "-a, --movie-record-author=AUTHOR Sets the author of the movie to be recorded\n"
                  "-p, --movie-play=[file]    Playback the movie (game inputs) from the given file\n"
                  "-d, --dump-video=[file]    Dumps audio and video to the given video file\n"
+                 "-b, --benchmark=[file]     Plays back the movie unthrottled and writes the "
+                 "frame time statistics to the given file\n"
+                 "-n, --no-present     Do not present frames while benchmarking\n"
                  "-f, --fullscreen     Start in fullscreen mode\n"
                  "-h, --help           Display this help and exit\n"
                  "-v, --version        Output version information and exit\n";
 }
 
+/// Writes the statistics of a movie played back with --benchmark as JSON
+static void WriteBenchmarkReport(const std::string& path, Core::System& system,
+                                 std::chrono::steady_clock::duration wall_time) {
+    auto frametimes = system.GetFrametimeHistory();
+    std::sort(frametimes.begin(), frametimes.end());
+    const auto percentile = [&frametimes](double p) {
+        if (frametimes.empty()) {
+            return 0.0;
+        }
+        const auto rank = static_cast<std::size_t>(p / 100.0 * (frametimes.size() - 1) + 0.5);
+        return frametimes[rank];
+    };
+    const double mean = frametimes.empty()
+                            ? 0.0
+                            : std::accumulate(frametimes.begin(), frametimes.end(), 0.0) /
+                                  static_cast<double>(frametimes.size());
+
+    using DoubleSecs = std::chrono::duration<double>;
+    const double wall_secs = std::chrono::duration_cast<DoubleSecs>(wall_time).count();
+    const double emulated_secs =
+        std::chrono::duration_cast<DoubleSecs>(system.CoreTiming().GetGlobalTimeUs()).count();
+    const auto stats = system.GetAndResetPerfStats();
+
+    const nlohmann::json report = {
+        {"version", Common::g_scm_desc},
+        {"build", Common::g_build_fullname},
+        {"graphics_api", static_cast<u32>(Settings::values.graphics_api.GetValue())},
+        {"frames", frametimes.size()},
+        {"wall_time_s", wall_secs},
+        {"emulated_time_s", emulated_secs},
+        {"emulation_speed", wall_secs > 0.0 ? emulated_secs / wall_secs : 0.0},
+        {"frametime_ms",
+         {
+             {"mean", mean},
+             {"p50", percentile(50.0)},
+             {"p90", percentile(90.0)},
+             {"p95", percentile(95.0)},
+             {"p99", percentile(99.0)},
+             {"max", frametimes.empty() ? 0.0 : frametimes.back()},
+         }},
+        {"perf_stats",
+         {
+             {"system_fps", stats.system_fps},
+             {"game_fps", stats.game_fps},
+             {"frametime", stats.frametime},
+             {"emulation_speed", stats.emulation_speed},
+             {"idle_skipped", stats.idle_skipped},
+         }},
+    };
+
+    std::ofstream file{path};
+    file << report.dump(4) << std::endl;
+    if (!file) {
+        LOG_ERROR(Frontend, "Failed to write benchmark results to {}", path);
+        return;
+    }
+    LOG_INFO(Frontend, "Benchmark: {} frames, {:.2f} ms mean, {:.2f} ms p99, {:.1f}% speed",
+             frametimes.size(), mean, percentile(99.0),
+             wall_secs > 0.0 ? emulated_secs / wall_secs * 100.0 : 0.0);
+}
+
+/// Compresses a CCI or CXI image into the seekable format, next to the original
+static bool CompressGameImage(const std::string& path) {
+    std::string directory, name, extension;
+    Common::SplitPath(path, &directory, &name, &extension);
+    const Loader::FileType type = Loader::GuessFromExtension(extension);
+    if (type != Loader::FileType::CCI && type != Loader::FileType::CXI) {
+        LOG_ERROR(Frontend, "Only CCI and CXI images can be compressed: {}", path);
+        return false;
+    }
+
+    FileUtil::IOFile source(path, "rb");
+    if (!source.IsOpen()) {
+        LOG_ERROR(Frontend, "Failed to open {}", path);
+        return false;
+    }
+    if (source.IsCompressed()) {
+        LOG_ERROR(Frontend, "{} is already compressed", path);
+        return false;
+    }
+    const std::string destination_path =
+        directory + name + (type == Loader::FileType::CCI ? ".zcci" : ".zcxi");
+    FileUtil::IOFile destination(destination_path, "wb");
+    if (!destination.IsOpen()) {
+        LOG_ERROR(Frontend, "Failed to create {}", destination_path);
+        return false;
+    }
+
+    u64 last_percentage = 0;
+    const auto progress = [&last_percentage](u64 compressed, u64 total) {
+        const u64 percentage = compressed * 100 / total;
+        if (percentage != last_percentage) {
+            LOG_INFO(Frontend, "{:02d}%", percentage);
+            last_percentage = percentage;
+        }
+    };
+    if (!Common::Compression::CompressSeekableZSTD(source, destination, 0, progress)) {
+        LOG_ERROR(Frontend, "Failed to compress {}", path);
+        destination.Close();
+        FileUtil::Delete(destination_path);
+        return false;
+    }
+    LOG_INFO(Frontend, "Compressed {} to {}", path, destination_path);
+    return true;
+}
+
 static void PrintVersion() {
     std::cout << "Citra " << Common::g_scm_branch << " " << Common::g_scm_desc << std::endl;
 }
@@ -196,6 +316,8 @@ int main(int argc, char** argv) {
     std::string movie_record_author;
     std::string movie_play;
     std::string dump_video;
+    std::string benchmark;
+    bool present = true;
 
     char* endarg;
 #ifdef _WIN32
@@ -219,11 +341,14 @@ int main(int argc, char** argv) {
     static struct option long_options[] = {
         {"gdbport", required_argument, 0, 'g'},
         {"install", required_argument, 0, 'i'},
+        {"compress", required_argument, 0, 'c'},
         {"multiplayer", required_argument, 0, 'm'},
         {"movie-record", required_argument, 0, 'r'},
         {"movie-record-author", required_argument, 0, 'a'},
         {"movie-play", required_argument, 0, 'p'},
         {"dump-video", required_argument, 0, 'd'},
+        {"benchmark", required_argument, 0, 'b'},
+        {"no-present", no_argument, 0, 'n'},
         {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
@@ -231,7 +356,7 @@ int main(int argc, char** argv) {
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:i:m:r:p:fhv", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:i:c:m:r:p:b:nfhv", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'g':
@@ -256,6 +381,10 @@ int main(int argc, char** argv) {
                     exit(1);
                 break;
             }
+            case 'c':
+                if (!CompressGameImage(std::string(optarg)))
+                    exit(1);
+                exit(0);
             case 'm': {
                 use_multiplayer = true;
                 const std::string str_arg(optarg);
@@ -300,6 +429,12 @@ int main(int argc, char** argv) {
             case 'd':
                 dump_video = optarg;
                 break;
+            case 'b':
+                benchmark = optarg;
+                break;
+            case 'n':
+                present = false;
+                break;
             case 'f':
                 fullscreen = true;
                 LOG_INFO(Frontend, "Starting in fullscreen mode...");
@@ -338,6 +473,11 @@ int main(int argc, char** argv) {
         return -1;
     }
 
+    if (!benchmark.empty() && movie_play.empty()) {
+        LOG_CRITICAL(Frontend, "Benchmarking requires a movie to play back");
+        return -1;
+    }
+
     auto& system = Core::System::GetInstance();
     auto& movie = system.Movie();
 
@@ -351,6 +491,10 @@ int main(int argc, char** argv) {
     // Apply the command line arguments
     Settings::values.gdbstub_port = gdb_port;
     Settings::values.use_gdbstub = use_gdbstub;
+    if (!benchmark.empty()) {
+        Settings::values.frame_limit.SetValue(0);
+        Settings::values.use_vsync_new.SetValue(false);
+    }
     system.ApplySettings();
 
     // Register frontend applets
@@ -374,6 +518,8 @@ int main(int argc, char** argv) {
         case Settings::GraphicsAPI::Software:
             return std::make_unique<EmuWindow_SDL2_SW>(system, fullscreen, is_secondary);
 #endif
+        case Settings::GraphicsAPI::Null:
+            return std::make_unique<EmuWindow_SDL2_Null>(system, is_secondary);
         default:
             LOG_CRITICAL(
                 Frontend,
@@ -386,8 +532,7 @@ int main(int argc, char** argv) {
 #elif ENABLE_SOFTWARE_RENDERER
             return std::make_unique<EmuWindow_SDL2_SW>(system, fullscreen, is_secondary);
 #else
-// TODO: Add a null renderer backend for this, perhaps.
-#error "At least one renderer must be enabled."
+            return std::make_unique<EmuWindow_SDL2_Null>(system, is_secondary);
 #endif
         }
     };
@@ -395,7 +540,8 @@ int main(int argc, char** argv) {
     const auto emu_window{create_emu_window(fullscreen, false)};
     const bool use_secondary_window{
         Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows &&
-        Settings::values.graphics_api.GetValue() != Settings::GraphicsAPI::Software};
+        Settings::values.graphics_api.GetValue() != Settings::GraphicsAPI::Software &&
+        Settings::values.graphics_api.GetValue() != Settings::GraphicsAPI::Null};
     const auto secondary_window = use_secondary_window ? create_emu_window(false, true) : nullptr;
 
     const auto scope = emu_window->Acquire();
@@ -478,9 +624,20 @@ int main(int argc, char** argv) {
     Common::Linux::StartGamemode();
 #endif
 
-    std::thread main_render_thread([&emu_window] { emu_window->Present(); });
-    std::thread secondary_render_thread([&secondary_window] {
-        if (secondary_window) {
+    // Benchmarks stop once the movie has been played back
+    std::atomic_bool benchmark_done{false};
+    if (!benchmark.empty()) {
+        movie.SetPlaybackCompletionCallback([&benchmark_done] { benchmark_done = true; });
+    }
+    system.GPU().Renderer().Settings().skip_presentation = !present;
+
+    std::thread main_render_thread([&emu_window, present] {
+        if (present) {
+            emu_window->Present();
+        }
+    });
+    std::thread secondary_render_thread([&secondary_window, present] {
+        if (secondary_window && present) {
             secondary_window->Present();
         }
     });
@@ -496,7 +653,10 @@ int main(int argc, char** argv) {
         // if the secondary window isn't created, it shouldn't affect the main loop
         return secondary_window ? secondary_window->IsOpen() : true;
     };
-    while (emu_window->IsOpen() && secondary_is_open()) {
+    // The emulation runs on the main thread, which keeps the name of the process
+    Common::SetCurrentThreadRole(Common::ThreadRole::Emulation, "citra");
+    const auto run_start = std::chrono::steady_clock::now();
+    while (emu_window->IsOpen() && secondary_is_open() && !benchmark_done) {
         const auto result = system.RunLoop();
 
         switch (result) {
@@ -510,6 +670,9 @@ int main(int argc, char** argv) {
             break;
         }
     }
+    if (!benchmark.empty()) {
+        WriteBenchmarkReport(benchmark, system, std::chrono::steady_clock::now() - run_start);
+    }
     emu_window->RequestClose();
     if (secondary_window) {
         secondary_window->RequestClose();
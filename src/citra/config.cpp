@@ -130,6 +130,14 @@ void Config::ReadValues() {
     // Core
     ReadSetting("Core", Settings::values.use_cpu_jit);
     ReadSetting("Core", Settings::values.cpu_clock_percentage);
+    ReadSetting("Core", Settings::values.use_fastmem);
+    ReadSetting("Core", Settings::values.use_multi_core);
+    ReadSetting("Core", Settings::values.rewind_buffer_size);
+    ReadSetting("Core", Settings::values.rewind_interval);
+    ReadSetting("Core", Settings::values.use_boot_snapshot);
+    ReadSetting("Core", Settings::values.boot_snapshot_frames);
+    ReadSetting("Core", Settings::values.emulate_fs_delay);
+    ReadSetting("Core", Settings::values.thread_policy);
 
     // Renderer
     ReadSetting("Renderer", Settings::values.graphics_api);
@@ -158,6 +166,24 @@ void Config::ReadValues() {
     ReadSetting("Renderer", Settings::values.bg_red);
     ReadSetting("Renderer", Settings::values.bg_green);
     ReadSetting("Renderer", Settings::values.bg_blue);
+    ReadSetting("Renderer", Settings::values.async_gpu);
+    ReadSetting("Renderer", Settings::values.vertex_cache_size);
+    ReadSetting("Renderer", Settings::values.parallel_vertex_shading);
+    ReadSetting("Renderer", Settings::values.gpu_texture_decode);
+    ReadSetting("Renderer", Settings::values.gpu_y2r_conversion);
+    ReadSetting("Renderer", Settings::values.async_surface_readback);
+    ReadSetting("Renderer", Settings::values.frame_pacing);
+    ReadSetting("Renderer", Settings::values.low_latency_presentation);
+    ReadSetting("Renderer", Settings::values.ubershader_fallback);
+    ReadSetting("Renderer", Settings::values.parallel_command_recording);
+    ReadSetting("Renderer", Settings::values.texture_memory_budget);
+    ReadSetting("Renderer", Settings::values.deduplicate_texture_uploads);
+    ReadSetting("Renderer", Settings::values.dynamic_resolution);
+    ReadSetting("Renderer", Settings::values.adaptive_target_scale);
+    ReadSetting("Renderer", Settings::values.spatial_upscaling);
+    ReadSetting("Renderer", Settings::values.frame_skip);
+    ReadSetting("Renderer", Settings::values.turbo_mode);
+    ReadSetting("Renderer", Settings::values.perf_overlay);
 
     // Layout
     ReadSetting("Layout", Settings::values.layout_option);
@@ -180,19 +206,24 @@ void Config::ReadValues() {
     ReadSetting("Utility", Settings::values.custom_textures);
     ReadSetting("Utility", Settings::values.preload_textures);
     ReadSetting("Utility", Settings::values.async_custom_loading);
+    ReadSetting("Utility", Settings::values.compress_custom_textures);
 
     // Audio
     ReadSetting("Audio", Settings::values.audio_emulation);
     ReadSetting("Audio", Settings::values.enable_audio_stretching);
+    ReadSetting("Audio", Settings::values.audio_stretching_quality);
     ReadSetting("Audio", Settings::values.volume);
     ReadSetting("Audio", Settings::values.output_type);
     ReadSetting("Audio", Settings::values.output_device);
+    ReadSetting("Audio", Settings::values.audio_buffer_size);
+    ReadSetting("Audio", Settings::values.audio_latency);
     ReadSetting("Audio", Settings::values.input_type);
     ReadSetting("Audio", Settings::values.input_device);
 
     // Data Storage
     ReadSetting("Data Storage", Settings::values.use_virtual_sd);
     ReadSetting("Data Storage", Settings::values.use_custom_storage);
+    ReadSetting("Data Storage", Settings::values.romfs_cache_size);
 
     if (Settings::values.use_custom_storage) {
         FileUtil::UpdateUserPath(FileUtil::UserPath::NANDDir,
@@ -306,19 +337,24 @@ void Config::ReadValues() {
 
     // Miscellaneous
     ReadSetting("Miscellaneous", Settings::values.log_filter);
+    ReadSetting("Miscellaneous", Settings::values.log_deferred_formatting);
 
     // Apply the log_filter setting as the logger has already been initialized
     // and doesn't pick up the filter on its own.
     Common::Log::Filter filter;
     filter.ParseFilterString(Settings::values.log_filter.GetValue());
     Common::Log::SetGlobalFilter(filter);
+    Common::Log::SetDeferredFormatting(Settings::values.log_deferred_formatting.GetValue());
 
     // Debugging
     Settings::values.record_frame_times =
         sdl2_config->GetBoolean("Debugging", "record_frame_times", false);
     ReadSetting("Debugging", Settings::values.renderer_debug);
+    ReadSetting("Debugging", Settings::values.gpu_profiling);
     ReadSetting("Debugging", Settings::values.use_gdbstub);
     ReadSetting("Debugging", Settings::values.gdbstub_port);
+    ReadSetting("Debugging", Settings::values.profile_guest_code);
+    ReadSetting("Debugging", Settings::values.record_trace);
 
     for (const auto& service_module : Service::service_module_map) {
         bool use_lle = sdl2_config->GetBoolean("Debugging", "LLE\\" + service_module.name, false);
@@ -333,6 +369,10 @@ void Config::ReadValues() {
     NetSettings::values.citra_username = sdl2_config->GetString("WebService", "citra_username", "");
     NetSettings::values.citra_token = sdl2_config->GetString("WebService", "citra_token", "");
 
+    // Multiplayer
+    NetSettings::values.wifi_coalescing_window_us = static_cast<unsigned int>(
+        sdl2_config->GetInteger("Multiplayer", "wifi_coalescing_window_us", 500));
+
     // Video Dumping
     Settings::values.output_format =
         sdl2_config->GetString("Video Dumping", "output_format", "webm");
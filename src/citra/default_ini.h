@@ -97,9 +97,43 @@ use_cpu_jit =
 # Range is any positive integer (but we suspect 25 - 400 is a good idea) Default is 100
 cpu_clock_percentage =
 
+# Whether to map guest memory into a host address space so JIT code can access it directly.
+# Requires the JIT and a 64-bit host with 4 KiB pages.
+# 0 (default): Off, 1: On
+use_fastmem =
+
+# Whether to run each emulated CPU core on its own host thread. Requires the JIT and a renderer
+# other than OpenGL.
+# 0 (default): Off, 1: On
+use_multi_core =
+
+# Memory in MiB kept for rewinding the emulation through recent states. 0 (default) disables it.
+rewind_buffer_size =
+
+# Emulated time in milliseconds between the states kept for rewinding. Default is 500
+rewind_interval =
+
+# Whether to snapshot a title once it booted and load the snapshot instead of booting it again.
+# The snapshot is remade after the title or the emulator are updated.
+# 0 (default): Off, 1: On
+use_boot_snapshot =
+
+# Number of frames after boot at which the boot snapshot is captured. Default is 600
+boot_snapshot_frames =
+
+# Whether file reads and opens take as long as on the console. Few titles depend on it, the others
+# load faster without it.
+# 0: Off, 1 (default): On
+emulate_fs_delay =
+
+# How the emulator threads are scheduled on the host CPU
+# 0: By the OS, 1 (default): Prioritized by role, 2: Prioritized by role and kept on the
+# performance or efficiency cores suited to it
+thread_policy =
+
 [Renderer]
 # Whether to render using OpenGL or Software
-# 0: Software, 1: OpenGL (default), 2: Vulkan
+# 0: Software, 1: OpenGL (default), 2: Vulkan, 3: Null (renders nothing, for CPU benchmarks)
 graphics_api =
 
 # Whether to render using GLES or OpenGL
@@ -180,6 +214,95 @@ anaglyph_shader_name =
 # 0: Nearest, 1 (default): Linear
 filter_mode =
 
+# Processes PICA command lists on a dedicated GPU thread (Vulkan and Software only)
+# 0 (default): Off, 1: On
+async_gpu =
+
+# Maximum number of entries in the post-transform vertex cache used by software vertex processing
+# Rounded down to a power of two. 16 - 65536: 8192 (default)
+vertex_cache_size =
+
+# Whether to shade large non-indexed draws on multiple threads when using software vertex shaders
+# 0: Off, 1 (default): On
+parallel_vertex_shading =
+
+# Whether to detile and decode texture-only formats with a compute shader (Vulkan only)
+# 0 (default): Off, 1: On
+gpu_texture_decode =
+
+# Whether to convert Y2R images with a compute shader straight into the cached texture, which
+# is only written back to emulated memory if the game reads it (Vulkan only)
+# 0 (default): Off, 1: On
+gpu_y2r_conversion =
+
+# Whether to start copying finished render targets back to emulated memory in the background,
+# so that CPU reads only wait for the GPU instead of a full download (Vulkan only)
+# 0 (default): Off, 1: On
+async_surface_readback =
+
+# Presents on every display refresh when VSync is on, repeating the last frame until the next one is
+# ready. Gives an even frame cadence on displays faster than 60 Hz. Vulkan only.
+# 0 (default): Off, 1: On
+frame_pacing =
+
+# Keeps at most one frame waiting for presentation, lowering input latency at the cost of some
+# throughput. Vulkan only.
+# 0 (default): Off, 1: On
+low_latency_presentation =
+
+# Draws with a generic fragment shader while the specialized Vulkan pipeline compiles,
+# instead of skipping or stalling on it. Adds a small GPU cost to those draws
+# 0 (default): Off, 1: On
+ubershader_fallback =
+
+# Records the draws of each Vulkan render pass into secondary command buffers on helper threads.
+# Can help at high resolution scales with many render passes per frame
+# 0 (default): Off, 1: On
+parallel_command_recording =
+
+# Host memory in MiB the texture cache may use before it starts evicting the least recently used
+# surfaces. 0 (default) sizes it from the memory budget the graphics driver reports
+texture_memory_budget =
+
+# Hashes the guest data of whole texture levels and skips decoding and uploading them again when
+# the texture still holds identical data, e.g. after a title streams the same texture back in
+# 0 (default): Off, 1: On
+deduplicate_texture_uploads =
+
+# Lowers the resolution scale while the GPU cannot render frames within the frame limit and raises
+# it back up to resolution_factor once it can. Vulkan only
+# 0 (default): Off, 1: On
+dynamic_resolution =
+
+# Renders small intermediate targets and targets the game keeps reading back at native resolution
+# instead of the resolution scale. Per-title overrides in load/textures/<title_id>/scale.json
+# apply regardless
+# 0 (default): Off, 1: On
+adaptive_target_scale =
+
+# Upscales the emulated screens to the window with an edge adaptive filter instead of bilinear
+# filtering. Pairs well with a low resolution_factor, which is much cheaper than rendering at
+# window resolution. Post processing shaders and stereoscopic 3D modes take precedence
+# 0 (default): Off, 1: Smooth, 2: Sharp
+spatial_upscaling =
+
+# Number of frames whose draws are skipped after each rendered frame. Emulation keeps running at
+# full speed, which buys back GPU time on slow devices but may leave effects a game renders only
+# once missing. Render targets the game reads back with the CPU are always drawn
+# 0 (default): Off, 1: Render every other frame, ..., 3: Render one of four frames
+frame_skip =
+
+# Runs the emulation as fast as possible, ignoring the speed limit. Frames are only presented
+# as fast as the display can show them, the others are dropped, and audio is not stretched
+# 0 (default): Off, 1: On
+turbo_mode =
+
+# Shows the frame rate and where the time of each frame went in the corner of the window: the
+# emulated CPU, GPU command processing, GPU execution and waiting for presentation, along with the
+# queued audio and the shader compilations and cache flushes. OpenGL and Vulkan only
+# 0 (default): Off, 1: On
+perf_overlay =
+
 [Layout]
 # Layout for the screen inside the render window.
 # 0 (default): Default Top Bottom Screen
@@ -237,6 +360,11 @@ preload_textures =
 # 0: Off, 1 (default): On
 async_custom_loading =
 
+# Transcodes PNG custom textures to BC3 and caches them, reducing load times and video memory use.
+# Requires a GPU with BCn texture support.
+# 0 (default): Off, 1: On
+compress_custom_textures =
+
 [Audio]
 # Whether or not to enable DSP LLE
 # 0 (default): No, 1: Yes
@@ -252,6 +380,11 @@ enable_dsp_lle_thread =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# How audio stretching is done. The lower qualities use a lighter algorithm with less latency and
+# CPU usage, but more audible artifacts.
+# 0: Low, 1: Medium, 2 (default): High
+audio_stretching_quality =
+
 # Output volume.
 # 1.0 (default): 100%, 0.0; mute
 volume =
@@ -264,6 +397,17 @@ output_type =
 # auto (default): Auto-select
 output_device =
 
+# Number of frames the audio output requests at once. Smaller buffers lower the latency, but may
+# crackle on slower audio drivers.
+# 64 - 4096, 256 (default)
+audio_buffer_size =
+
+# Maximum amount of audio queued for output when audio stretching is off, in milliseconds. The
+# output rate is adjusted slightly to hold the queue at half of it, and older audio is dropped to
+# stay within it.
+# 5 - 250, 20 (default)
+audio_latency =
+
 # Which audio input type to use.
 # 0 (default): Auto-select, 1: No audio input, 2: Static noise, 3: Cubeb (if available), 4: OpenAL (if available)
 input_type =
@@ -281,6 +425,9 @@ use_virtual_sd =
 # 1: Yes, 0 (default): No
 use_custom_storage =
 
+# Memory in MiB used to cache the RomFS of each running title. Default is 8
+romfs_cache_size =
+
 # The path of the virtual SD card directory.
 # empty (default) will use the user_path
 sdmc_directory =
@@ -346,6 +493,10 @@ camera_inner_flip =
 # Examples: *:Debug Kernel.SVC:Trace Service.*:Critical
 log_filter = *:Info
 
+# Formats the log messages on the logging thread and limits the messages per second of each class,
+# to reduce the cost of verbose logging on the emulation. 0 (default): Off, 1: On
+log_deferred_formatting =
+
 [Debugging]
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
@@ -358,8 +509,25 @@ gdbstub_port=24689
 # 0 (default): Off, 1: On
 renderer_debug =
 
+# Measure the GPU time of render passes, blits, texture filters and transfers with timestamp queries
+# 0 (default): Off, 1: On
+gpu_profiling =
+
+# Sample the guest PC of every core and write a flame graph profile to the log directory
+# 0 (default): Off, 1: On
+profile_guest_code =
+
+# Record the profiling scopes of every thread to a Chrome trace file in the log directory, which
+# can be opened with Perfetto. 0 (default): Off, 1: On
+record_trace =
+
 # To LLE a service module add "LLE\<module name>=true"
 
+[Multiplayer]
+# Wi-Fi frames to the same player queued within this many microseconds are sent as one packet
+# 0: Send every frame on its own, 500 (default)
+wifi_coalescing_window_us =
+
 [WebService]
 # Whether or not to enable telemetry
 # 0 (default): No, 1: Yes
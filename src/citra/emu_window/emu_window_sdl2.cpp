@@ -10,6 +10,7 @@
 #include "citra/emu_window/emu_window_sdl2.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
+#include "common/settings.h"
 #include "core/core.h"
 #include "input_common/keyboard.h"
 #include "input_common/main.h"
@@ -117,6 +118,10 @@ EmuWindow_SDL2::~EmuWindow_SDL2() {
 }
 
 void EmuWindow_SDL2::InitializeSDL2() {
+    // The null renderer shows nothing, so it runs without a display unless told otherwise
+    if (Settings::values.graphics_api.GetValue() == Settings::GraphicsAPI::Null) {
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    }
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) < 0) {
         LOG_CRITICAL(Frontend, "Failed to initialize SDL2: {}! Exiting...", SDL_GetError());
         exit(1);
@@ -0,0 +1,38 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdlib>
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include "citra/emu_window/emu_window_sdl2_null.h"
+#include "common/logging/log.h"
+#include "core/3ds.h"
+
+class NullContext : public Frontend::GraphicsContext {};
+
+EmuWindow_SDL2_Null::EmuWindow_SDL2_Null(Core::System& system, bool is_secondary)
+    : EmuWindow_SDL2{system, is_secondary} {
+    // Only created to keep the input and window events working
+    render_window =
+        SDL_CreateWindow("Citra", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                         Core::kScreenTopWidth, Core::kScreenTopHeight + Core::kScreenBottomHeight,
+                         SDL_WINDOW_HIDDEN);
+    if (render_window == nullptr) {
+        LOG_CRITICAL(Frontend, "Failed to create SDL2 window: {}", SDL_GetError());
+        exit(1);
+    }
+    render_window_id = SDL_GetWindowID(render_window);
+
+    UpdateCurrentFramebufferLayout(Core::kScreenTopWidth,
+                                   Core::kScreenTopHeight + Core::kScreenBottomHeight);
+    SDL_PumpEvents();
+}
+
+EmuWindow_SDL2_Null::~EmuWindow_SDL2_Null() {
+    SDL_DestroyWindow(render_window);
+}
+
+std::unique_ptr<Frontend::GraphicsContext> EmuWindow_SDL2_Null::CreateSharedContext() const {
+    return std::make_unique<NullContext>();
+}
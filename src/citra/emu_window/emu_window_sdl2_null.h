@@ -0,0 +1,23 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include "citra/emu_window/emu_window_sdl2.h"
+
+namespace Core {
+class System;
+}
+
+/// Hidden window for the null renderer, which presents nothing.
+class EmuWindow_SDL2_Null : public EmuWindow_SDL2 {
+public:
+    explicit EmuWindow_SDL2_Null(Core::System& system, bool is_secondary);
+    ~EmuWindow_SDL2_Null();
+
+    std::unique_ptr<GraphicsContext> CreateSharedContext() const override;
+    void MakeCurrent() override {}
+    void DoneCurrent() override {}
+};
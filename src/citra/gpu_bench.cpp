@@ -0,0 +1,236 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <json.hpp>
+#include "citra/config.h"
+#include "citra/emu_window/emu_window_sdl2.h"
+#ifdef ENABLE_OPENGL
+#include "citra/emu_window/emu_window_sdl2_gl.h"
+#endif
+#ifdef ENABLE_SOFTWARE_RENDERER
+#include "citra/emu_window/emu_window_sdl2_sw.h"
+#endif
+#ifdef ENABLE_VULKAN
+#include "citra/emu_window/emu_window_sdl2_vk.h"
+#endif
+#include "common/logging/backend.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "core/core.h"
+#include "core/tracer/player.h"
+#include "input_common/main.h"
+#include "network/network.h"
+#include "video_core/gpu.h"
+#include "video_core/renderer_base.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <trace.ctf>\n"
+                 "Replays a CiTrace and reports the time spent on each frame as JSON.\n"
+                 "-a, --api=NAME        Renderer to replay with: opengl, vulkan or software\n"
+                 "-s, --scale=FACTOR    Internal resolution scale\n"
+                 "-l, --loops=COUNT     Number of times the trace is replayed\n"
+                 "-o, --output=FILE     Writes the report to FILE instead of stdout\n"
+                 "-h, --help            Display this help and exit\n";
+}
+
+static std::unique_ptr<EmuWindow_SDL2> CreateWindow(Core::System& system,
+                                                    Settings::GraphicsAPI api) {
+    switch (api) {
+#ifdef ENABLE_OPENGL
+    case Settings::GraphicsAPI::OpenGL:
+        return std::make_unique<EmuWindow_SDL2_GL>(system, false, false);
+#endif
+#ifdef ENABLE_VULKAN
+    case Settings::GraphicsAPI::Vulkan:
+        return std::make_unique<EmuWindow_SDL2_VK>(system, false, false);
+#endif
+#ifdef ENABLE_SOFTWARE_RENDERER
+    case Settings::GraphicsAPI::Software:
+        return std::make_unique<EmuWindow_SDL2_SW>(system, false, false);
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+int main(int argc, char** argv) {
+    Common::Log::Initialize();
+    Common::Log::SetColorConsoleBackendEnabled(true);
+    Common::Log::Start();
+    Config config;
+
+    std::string api_name = "vulkan";
+    u32 resolution_scale = Settings::values.resolution_factor.GetValue();
+    u32 loops = 1;
+    std::string output;
+    std::string filepath;
+
+    static struct option long_options[] = {
+        {"api", required_argument, 0, 'a'},   {"scale", required_argument, 0, 's'},
+        {"loops", required_argument, 0, 'l'}, {"output", required_argument, 0, 'o'},
+        {"help", no_argument, 0, 'h'},        {0, 0, 0, 0},
+    };
+
+    int option_index = 0;
+    while (optind < argc) {
+        const int arg = getopt_long(argc, argv, "a:s:l:o:h", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'a':
+                api_name = optarg;
+                break;
+            case 's':
+                resolution_scale = static_cast<u32>(std::strtoul(optarg, nullptr, 0));
+                break;
+            case 'l':
+                loops = static_cast<u32>(std::strtoul(optarg, nullptr, 0));
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            default:
+                PrintHelp(argv[0]);
+                return -1;
+            }
+        } else {
+            filepath = argv[optind];
+            optind++;
+        }
+    }
+
+    Settings::GraphicsAPI api;
+    if (api_name == "opengl") {
+        api = Settings::GraphicsAPI::OpenGL;
+    } else if (api_name == "vulkan") {
+        api = Settings::GraphicsAPI::Vulkan;
+    } else if (api_name == "software") {
+        api = Settings::GraphicsAPI::Software;
+    } else {
+        LOG_CRITICAL(Frontend, "Unknown graphics API {}", api_name);
+        return -1;
+    }
+    if (filepath.empty() || loops == 0) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    // Frames are replayed as fast as possible at a fixed scale and presented to a single window
+    Settings::values.graphics_api.SetValue(api);
+    Settings::values.resolution_factor.SetValue(resolution_scale);
+    Settings::values.frame_limit.SetValue(0);
+    Settings::values.use_vsync_new.SetValue(false);
+    Settings::values.dynamic_resolution.SetValue(false);
+    Settings::values.layout_option.SetValue(Settings::LayoutOption::Default);
+
+    auto& system = Core::System::GetInstance();
+    EmuWindow_SDL2::InitializeSDL2();
+    const auto emu_window = CreateWindow(system, api);
+    if (!emu_window) {
+        LOG_CRITICAL(Frontend, "Graphics API {} is not available in this build", api_name);
+        return -1;
+    }
+
+    const auto scope = emu_window->Acquire();
+    if (system.InitForTracePlayback(*emu_window) != Core::System::ResultStatus::Success) {
+        return -1;
+    }
+    CiTrace::Player player{system};
+    if (!player.Load(filepath)) {
+        system.Shutdown();
+        return -1;
+    }
+
+    std::thread render_thread([&emu_window] { emu_window->Present(); });
+
+    using namespace std::chrono;
+    auto& renderer = system.GPU().Renderer();
+    const auto* rasterizer = renderer.Rasterizer();
+    const auto to_ms = [](auto time) {
+        return duration_cast<duration<double, std::milli>>(time).count();
+    };
+
+    nlohmann::json frames = nlohmann::json::array();
+    double total_cpu_ms = 0.0;
+    double total_gpu_ms = 0.0;
+    for (u32 loop = 0; loop < loops && emu_window->IsOpen(); loop++) {
+        player.Reset();
+        for (u32 frame = 0; emu_window->IsOpen(); frame++) {
+            const auto start = steady_clock::now();
+            if (!player.PlayFrame()) {
+                break;
+            }
+            const double cpu_ms = to_ms(steady_clock::now() - start);
+            const double gpu_ms = to_ms(renderer.LastGpuTime());
+            const auto stats = rasterizer->GetCacheStats();
+            total_cpu_ms += cpu_ms;
+            total_gpu_ms += gpu_ms;
+
+            frames.push_back({
+                {"loop", loop},
+                {"frame", frame},
+                {"cpu_ms", cpu_ms},
+                {"gpu_ms", gpu_ms > 0.0 ? nlohmann::json(gpu_ms) : nlohmann::json()},
+                {"pipelines", stats.pipelines},
+                {"shaders", stats.shaders},
+                {"surface_memory", stats.surface_memory},
+                {"evicted_surfaces", stats.evicted_surfaces},
+                {"flushed_surfaces", stats.flushed_surfaces},
+                {"stream_wait_us", stats.stream_wait_us},
+                {"cpu_reinterpretations", stats.cpu_reinterpretations},
+                {"cpu_fills", stats.cpu_fills},
+                {"pipeline_waits", stats.pipeline_waits},
+                {"pipeline_wait_us", stats.pipeline_wait_us},
+                {"pipeline_max_wait_us", stats.pipeline_max_wait_us},
+            });
+        }
+    }
+
+    emu_window->RequestClose();
+    render_thread.join();
+
+    const std::size_t num_frames = frames.size();
+    const nlohmann::json report = {
+        {"trace", filepath},
+        {"api", api_name},
+        {"resolution_scale", resolution_scale},
+        {"loops", loops},
+        {"frames", std::move(frames)},
+        {"summary",
+         {
+             {"frames", num_frames},
+             {"mean_cpu_ms", num_frames ? total_cpu_ms / num_frames : 0.0},
+             {"mean_gpu_ms", num_frames && total_gpu_ms > 0.0
+                                 ? nlohmann::json(total_gpu_ms / num_frames)
+                                 : nlohmann::json()},
+         }},
+    };
+
+    if (output.empty()) {
+        std::cout << report.dump(4) << std::endl;
+    } else {
+        std::ofstream file{output};
+        file << report.dump(4) << std::endl;
+    }
+
+    Network::Shutdown();
+    InputCommon::Shutdown();
+    system.Shutdown();
+    return 0;
+}
@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <QApplication>
 #include <QHBoxLayout>
 #include <QKeyEvent>
@@ -14,6 +17,7 @@
 #include "common/microprofile.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
+#include "common/thread.h"
 #include "core/3ds.h"
 #include "core/core.h"
 #include "core/frontend/framebuffer_layout.h"
@@ -61,6 +65,7 @@ static GMainWindow* GetMainWindow() {
 }
 
 void EmuThread::run() {
+    Common::SetCurrentThreadRole(Common::ThreadRole::Emulation, "EmuThread");
     MicroProfileOnThreadCreate("EmuThread");
     const auto scope = core_context.Acquire();
 
@@ -256,6 +261,12 @@ public:
     }
 
     virtual ~RenderWidget() = default;
+
+    /// Called once the emulated system is powered on, before the emulation thread starts
+    virtual void OnEmulationStarting() {}
+
+    /// Called before the emulation thread shuts the emulated system down
+    virtual void OnEmulationStopping() {}
 };
 
 #ifdef ENABLE_OPENGL
@@ -275,23 +286,27 @@ public:
         context = std::move(context_);
     }
 
-    void Present() {
-        if (!isVisible()) {
-            return;
-        }
-        if (!system.IsPoweredOn()) {
-            return;
-        }
-        context->MakeCurrent();
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-        system.GPU().Renderer().TryPresent(100, is_secondary);
-        context->SwapBuffers();
-        glFinish();
+    /**
+     * Frames are presented on a thread of their own, which owns the context of the widget, so
+     * that the work of the GUI thread does not delay them. The thread only runs while the
+     * emulated system is powered on, which is what keeps the renderer alive.
+     */
+    void OnEmulationStarting() override {
+        present_thread = std::jthread([this](std::stop_token stop_token) { Present(stop_token); });
     }
 
-    void paintEvent(QPaintEvent* event) override {
-        Present();
-        update();
+    void OnEmulationStopping() override {
+        present_thread = {};
+    }
+
+    void showEvent(QShowEvent* event) override {
+        RenderWidget::showEvent(event);
+        is_visible = true;
+    }
+
+    void hideEvent(QHideEvent* event) override {
+        RenderWidget::hideEvent(event);
+        is_visible = false;
     }
 
     QPaintEngine* paintEngine() const override {
@@ -299,9 +314,32 @@ public:
     }
 
 private:
+    void Present(std::stop_token stop_token) {
+        Common::SetCurrentThreadRole(Common::ThreadRole::Render,
+                                     is_secondary ? "SecondaryPresentThread" : "PresentThread");
+        MicroProfileOnThreadCreate("PresentThread");
+        context->MakeCurrent();
+        while (!stop_token.stop_requested()) {
+            if (!is_visible) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{16});
+                continue;
+            }
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            system.GPU().Renderer().TryPresent(100, is_secondary);
+            context->SwapBuffers();
+            glFinish();
+        }
+        context->DoneCurrent();
+#if MICROPROFILE_ENABLED
+        MicroProfileOnThreadExit();
+#endif
+    }
+
     std::unique_ptr<Frontend::GraphicsContext> context{};
     Core::System& system;
     bool is_secondary;
+    std::atomic_bool is_visible{false};
+    std::jthread present_thread;
 };
 #endif
 
@@ -813,10 +851,16 @@ void GRenderWindow::InitializeSoftware() {
 
 void GRenderWindow::OnEmulationStarting(EmuThread* emu_thread) {
     this->emu_thread = emu_thread;
+    if (child_widget) {
+        static_cast<RenderWidget*>(child_widget)->OnEmulationStarting();
+    }
 }
 
 void GRenderWindow::OnEmulationStopping() {
     emu_thread = nullptr;
+    if (child_widget) {
+        static_cast<RenderWidget*>(child_widget)->OnEmulationStopping();
+    }
 }
 
 void GRenderWindow::showEvent(QShowEvent* event) {
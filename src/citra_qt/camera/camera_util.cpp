@@ -172,28 +172,34 @@ static constexpr int V(int r, int g, int b) {
 
 std::vector<u16> Rgb2Yuv(const QImage& source, int width, int height) {
     auto buffer = std::vector<u16>(width * height);
-    auto dest = buffer.begin();
+    // Read the pixels straight from the scan lines of a 32-bit image, rather than through
+    // QImage::pixel which converts from the image format on every call
+    const QImage image = source.format() == QImage::Format_RGB32 ||
+                                 source.format() == QImage::Format_ARGB32
+                             ? source
+                             : source.convertToFormat(QImage::Format_RGB32);
+    const auto pack = [](int y, int uv) {
+        return static_cast<u16>(std::clamp(y, 0, 0xFF) | (std::clamp(uv, 0, 0xFF) << 8));
+    };
+
+    u16* dest = buffer.data();
     bool write = false;
     int py, pu, pv;
     for (int j = 0; j < height; ++j) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(j));
         for (int i = 0; i < width; ++i) {
-            QRgb rgb = source.pixel(i, j);
-            int r = qRed(rgb);
-            int g = qGreen(rgb);
-            int b = qBlue(rgb);
+            const int r = qRed(line[i]);
+            const int g = qGreen(line[i]);
+            const int b = qBlue(line[i]);
 
             // The following transformation is a reverse of the one in Y2R using ITU_Rec601
-            int y = YuvTable::Y(r, g, b);
-            int u = YuvTable::U(r, g, b);
-            int v = YuvTable::V(r, g, b);
+            const int y = YuvTable::Y(r, g, b);
+            const int u = YuvTable::U(r, g, b);
+            const int v = YuvTable::V(r, g, b);
 
             if (write) {
-                pu = (pu + u) / 2;
-                pv = (pv + v) / 2;
-                *(dest++) =
-                    static_cast<u16>(std::clamp(py, 0, 0xFF) | (std::clamp(pu, 0, 0xFF) << 8));
-                *(dest++) =
-                    static_cast<u16>(std::clamp(y, 0, 0xFF) | (std::clamp(pv, 0, 0xFF) << 8));
+                *(dest++) = pack(py, (pu + u) / 2);
+                *(dest++) = pack(y, (pv + v) / 2);
             } else {
                 py = y;
                 pu = u;
@@ -54,7 +54,7 @@ const std::array<std::array<int, 5>, Settings::NativeAnalog::NumAnalogs> Config:
 // This must be in alphabetical order according to action name as it must have the same order as
 // UISetting::values.shortcuts, which is alphabetically ordered.
 // clang-format off
-const std::array<UISettings::Shortcut, 30> Config::default_hotkeys {{
+const std::array<UISettings::Shortcut, 32> Config::default_hotkeys {{
      {QStringLiteral("Advance Frame"),            QStringLiteral("Main Window"), {QStringLiteral(""),       Qt::ApplicationShortcut}},
      {QStringLiteral("Audio Mute/Unmute"),        QStringLiteral("Main Window"), {QStringLiteral("Ctrl+M"), Qt::WindowShortcut}},
      {QStringLiteral("Audio Volume Down"),        QStringLiteral("Main Window"), {QStringLiteral(""),       Qt::WindowShortcut}},
@@ -73,6 +73,7 @@ const std::array<UISettings::Shortcut, 30> Config::default_hotkeys {{
      {QStringLiteral("Load from Newest Slot"),    QStringLiteral("Main Window"), {QStringLiteral("Ctrl+V"), Qt::WindowShortcut}},
      {QStringLiteral("Remove Amiibo"),            QStringLiteral("Main Window"), {QStringLiteral("F3"),     Qt::ApplicationShortcut}},
      {QStringLiteral("Restart Emulation"),        QStringLiteral("Main Window"), {QStringLiteral("F6"),     Qt::WindowShortcut}},
+     {QStringLiteral("Rewind"),                   QStringLiteral("Main Window"), {QStringLiteral("Backspace"), Qt::WindowShortcut}},
      {QStringLiteral("Rotate Screens Upright"),   QStringLiteral("Main Window"), {QStringLiteral("F8"),     Qt::WindowShortcut}},
      {QStringLiteral("Save to Oldest Slot"),      QStringLiteral("Main Window"), {QStringLiteral("Ctrl+C"), Qt::WindowShortcut}},
      {QStringLiteral("Stop Emulation"),           QStringLiteral("Main Window"), {QStringLiteral("F5"),     Qt::WindowShortcut}},
@@ -85,6 +86,7 @@ const std::array<UISettings::Shortcut, 30> Config::default_hotkeys {{
      {QStringLiteral("Toggle Screen Layout"),     QStringLiteral("Main Window"), {QStringLiteral("F10"),    Qt::WindowShortcut}},
      {QStringLiteral("Toggle Status Bar"),        QStringLiteral("Main Window"), {QStringLiteral("Ctrl+S"), Qt::WindowShortcut}},
      {QStringLiteral("Toggle Texture Dumping"),   QStringLiteral("Main Window"), {QStringLiteral(""),       Qt::ApplicationShortcut}},
+     {QStringLiteral("Toggle Turbo Mode"),        QStringLiteral("Main Window"), {QStringLiteral("Tab"),    Qt::ApplicationShortcut}},
     }};
 // clang-format on
 
@@ -273,11 +275,14 @@ void Config::ReadAudioValues() {
 
     ReadGlobalSetting(Settings::values.audio_emulation);
     ReadGlobalSetting(Settings::values.enable_audio_stretching);
+    ReadGlobalSetting(Settings::values.audio_stretching_quality);
     ReadGlobalSetting(Settings::values.volume);
 
     if (global) {
         ReadBasicSetting(Settings::values.output_type);
         ReadBasicSetting(Settings::values.output_device);
+        ReadBasicSetting(Settings::values.audio_buffer_size);
+        ReadBasicSetting(Settings::values.audio_latency);
         ReadBasicSetting(Settings::values.input_type);
         ReadBasicSetting(Settings::values.input_device);
     }
@@ -441,6 +446,7 @@ void Config::ReadUtilityValues() {
     ReadGlobalSetting(Settings::values.custom_textures);
     ReadGlobalSetting(Settings::values.preload_textures);
     ReadGlobalSetting(Settings::values.async_custom_loading);
+    ReadBasicSetting(Settings::values.compress_custom_textures);
 
     qt_config->endGroup();
 }
@@ -449,10 +455,18 @@ void Config::ReadCoreValues() {
     qt_config->beginGroup(QStringLiteral("Core"));
 
     ReadGlobalSetting(Settings::values.cpu_clock_percentage);
+    ReadGlobalSetting(Settings::values.use_boot_snapshot);
+    ReadGlobalSetting(Settings::values.emulate_fs_delay);
 
     if (global) {
         ReadBasicSetting(Settings::values.use_cpu_jit);
         ReadBasicSetting(Settings::values.delay_start_for_lle_modules);
+        ReadBasicSetting(Settings::values.use_fastmem);
+        ReadBasicSetting(Settings::values.use_multi_core);
+        ReadBasicSetting(Settings::values.rewind_buffer_size);
+        ReadBasicSetting(Settings::values.rewind_interval);
+        ReadBasicSetting(Settings::values.boot_snapshot_frames);
+        ReadBasicSetting(Settings::values.thread_policy);
     }
 
     qt_config->endGroup();
@@ -463,6 +477,7 @@ void Config::ReadDataStorageValues() {
 
     ReadBasicSetting(Settings::values.use_virtual_sd);
     ReadBasicSetting(Settings::values.use_custom_storage);
+    ReadBasicSetting(Settings::values.romfs_cache_size);
 
     const std::string nand_dir =
         ReadSetting(QStringLiteral("nand_directory"), QStringLiteral("")).toString().toStdString();
@@ -487,6 +502,9 @@ void Config::ReadDebuggingValues() {
     ReadBasicSetting(Settings::values.gdbstub_port);
     ReadBasicSetting(Settings::values.renderer_debug);
     ReadBasicSetting(Settings::values.dump_command_buffers);
+    ReadBasicSetting(Settings::values.gpu_profiling);
+    ReadBasicSetting(Settings::values.profile_guest_code);
+    ReadBasicSetting(Settings::values.record_trace);
 
     qt_config->beginGroup(QStringLiteral("LLE"));
     for (const auto& service_module : Service::service_module_map) {
@@ -531,6 +549,7 @@ void Config::ReadMiscellaneousValues() {
     qt_config->beginGroup(QStringLiteral("Miscellaneous"));
 
     ReadBasicSetting(Settings::values.log_filter);
+    ReadBasicSetting(Settings::values.log_deferred_formatting);
     ReadBasicSetting(Settings::values.enable_gamemode);
 
     qt_config->endGroup();
@@ -557,6 +576,8 @@ void Config::ReadMultiplayerValues() {
     UISettings::values.game_id = ReadSetting(QStringLiteral("game_id"), 0).toULongLong();
     UISettings::values.room_description =
         ReadSetting(QStringLiteral("room_description"), QString{}).toString();
+    NetSettings::values.wifi_coalescing_window_us =
+        ReadSetting(QStringLiteral("wifi_coalescing_window_us"), 500).toUInt();
     // Read ban list back
     int size = qt_config->beginReadArray(QStringLiteral("username_ban_list"));
     UISettings::values.ban_list.first.resize(size);
@@ -649,9 +670,26 @@ void Config::ReadRendererValues() {
 
     ReadGlobalSetting(Settings::values.texture_filter);
     ReadGlobalSetting(Settings::values.texture_sampling);
+    ReadGlobalSetting(Settings::values.ubershader_fallback);
 
     if (global) {
         ReadBasicSetting(Settings::values.use_shader_jit);
+        ReadBasicSetting(Settings::values.async_gpu);
+        ReadBasicSetting(Settings::values.vertex_cache_size);
+        ReadBasicSetting(Settings::values.parallel_vertex_shading);
+        ReadBasicSetting(Settings::values.gpu_texture_decode);
+        ReadBasicSetting(Settings::values.gpu_y2r_conversion);
+        ReadBasicSetting(Settings::values.async_surface_readback);
+        ReadBasicSetting(Settings::values.frame_pacing);
+        ReadBasicSetting(Settings::values.low_latency_presentation);
+        ReadBasicSetting(Settings::values.parallel_command_recording);
+        ReadBasicSetting(Settings::values.texture_memory_budget);
+        ReadBasicSetting(Settings::values.deduplicate_texture_uploads);
+        ReadBasicSetting(Settings::values.dynamic_resolution);
+        ReadBasicSetting(Settings::values.adaptive_target_scale);
+        ReadBasicSetting(Settings::values.spatial_upscaling);
+        ReadBasicSetting(Settings::values.frame_skip);
+        ReadBasicSetting(Settings::values.perf_overlay);
     }
 
     qt_config->endGroup();
@@ -862,11 +900,14 @@ void Config::SaveAudioValues() {
 
     WriteGlobalSetting(Settings::values.audio_emulation);
     WriteGlobalSetting(Settings::values.enable_audio_stretching);
+    WriteGlobalSetting(Settings::values.audio_stretching_quality);
     WriteGlobalSetting(Settings::values.volume);
 
     if (global) {
         WriteBasicSetting(Settings::values.output_type);
         WriteBasicSetting(Settings::values.output_device);
+        WriteBasicSetting(Settings::values.audio_buffer_size);
+        WriteBasicSetting(Settings::values.audio_latency);
         WriteBasicSetting(Settings::values.input_type);
         WriteBasicSetting(Settings::values.input_device);
     }
@@ -970,6 +1011,7 @@ void Config::SaveUtilityValues() {
     WriteGlobalSetting(Settings::values.custom_textures);
     WriteGlobalSetting(Settings::values.preload_textures);
     WriteGlobalSetting(Settings::values.async_custom_loading);
+    WriteBasicSetting(Settings::values.compress_custom_textures);
 
     qt_config->endGroup();
 }
@@ -978,10 +1020,18 @@ void Config::SaveCoreValues() {
     qt_config->beginGroup(QStringLiteral("Core"));
 
     WriteGlobalSetting(Settings::values.cpu_clock_percentage);
+    WriteGlobalSetting(Settings::values.use_boot_snapshot);
+    WriteGlobalSetting(Settings::values.emulate_fs_delay);
 
     if (global) {
         WriteBasicSetting(Settings::values.use_cpu_jit);
         WriteBasicSetting(Settings::values.delay_start_for_lle_modules);
+        WriteBasicSetting(Settings::values.use_fastmem);
+        WriteBasicSetting(Settings::values.use_multi_core);
+        WriteBasicSetting(Settings::values.rewind_buffer_size);
+        WriteBasicSetting(Settings::values.rewind_interval);
+        WriteBasicSetting(Settings::values.boot_snapshot_frames);
+        WriteBasicSetting(Settings::values.thread_policy);
     }
 
     qt_config->endGroup();
@@ -992,6 +1042,7 @@ void Config::SaveDataStorageValues() {
 
     WriteBasicSetting(Settings::values.use_virtual_sd);
     WriteBasicSetting(Settings::values.use_custom_storage);
+    WriteBasicSetting(Settings::values.romfs_cache_size);
     WriteSetting(QStringLiteral("nand_directory"),
                  QString::fromStdString(FileUtil::GetUserPath(FileUtil::UserPath::NANDDir)),
                  QStringLiteral(""));
@@ -1010,6 +1061,9 @@ void Config::SaveDebuggingValues() {
     WriteBasicSetting(Settings::values.use_gdbstub);
     WriteBasicSetting(Settings::values.gdbstub_port);
     WriteBasicSetting(Settings::values.renderer_debug);
+    WriteBasicSetting(Settings::values.gpu_profiling);
+    WriteBasicSetting(Settings::values.profile_guest_code);
+    WriteBasicSetting(Settings::values.record_trace);
 
     qt_config->beginGroup(QStringLiteral("LLE"));
     for (const auto& service_module : Settings::values.lle_modules) {
@@ -1054,6 +1108,7 @@ void Config::SaveMiscellaneousValues() {
     qt_config->beginGroup(QStringLiteral("Miscellaneous"));
 
     WriteBasicSetting(Settings::values.log_filter);
+    WriteBasicSetting(Settings::values.log_deferred_formatting);
     WriteBasicSetting(Settings::values.enable_gamemode);
 
     qt_config->endGroup();
@@ -1074,6 +1129,8 @@ void Config::SaveMultiplayerValues() {
     WriteSetting(QStringLiteral("game_id"), UISettings::values.game_id, 0);
     WriteSetting(QStringLiteral("room_description"), UISettings::values.room_description,
                  QString{});
+    WriteSetting(QStringLiteral("wifi_coalescing_window_us"),
+                 NetSettings::values.wifi_coalescing_window_us, 500);
     // Write ban list
     qt_config->beginWriteArray(QStringLiteral("username_ban_list"));
     for (std::size_t i = 0; i < UISettings::values.ban_list.first.size(); ++i) {
@@ -1140,10 +1197,27 @@ void Config::SaveRendererValues() {
 
     WriteGlobalSetting(Settings::values.texture_filter);
     WriteGlobalSetting(Settings::values.texture_sampling);
+    WriteGlobalSetting(Settings::values.ubershader_fallback);
 
     if (global) {
         WriteSetting(QStringLiteral("use_shader_jit"), Settings::values.use_shader_jit.GetValue(),
                      true);
+        WriteBasicSetting(Settings::values.async_gpu);
+        WriteBasicSetting(Settings::values.vertex_cache_size);
+        WriteBasicSetting(Settings::values.parallel_vertex_shading);
+        WriteBasicSetting(Settings::values.gpu_texture_decode);
+        WriteBasicSetting(Settings::values.gpu_y2r_conversion);
+        WriteBasicSetting(Settings::values.async_surface_readback);
+        WriteBasicSetting(Settings::values.frame_pacing);
+        WriteBasicSetting(Settings::values.low_latency_presentation);
+        WriteBasicSetting(Settings::values.parallel_command_recording);
+        WriteBasicSetting(Settings::values.texture_memory_budget);
+        WriteBasicSetting(Settings::values.deduplicate_texture_uploads);
+        WriteBasicSetting(Settings::values.dynamic_resolution);
+        WriteBasicSetting(Settings::values.adaptive_target_scale);
+        WriteBasicSetting(Settings::values.spatial_upscaling);
+        WriteBasicSetting(Settings::values.frame_skip);
+        WriteBasicSetting(Settings::values.perf_overlay);
     }
 
     qt_config->endGroup();
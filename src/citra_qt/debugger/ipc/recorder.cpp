@@ -9,8 +9,10 @@
 #include "citra_qt/debugger/ipc/record_dialog.h"
 #include "citra_qt/debugger/ipc/recorder.h"
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "common/string_util.h"
 #include "core/core.h"
+#include "core/hle/kernel/ipc_debugger/profiler.h"
 #include "core/hle/kernel/ipc_debugger/recorder.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/service/sm/sm.h"
@@ -25,6 +27,7 @@ IPCRecorderWidget::IPCRecorderWidget(Core::System& system_, QWidget* parent)
     connect(ui->enabled, &QCheckBox::stateChanged, this,
             [this](int new_state) { SetEnabled(new_state == Qt::Checked); });
     connect(ui->clearButton, &QPushButton::clicked, this, &IPCRecorderWidget::Clear);
+    connect(ui->dumpProfileButton, &QPushButton::clicked, this, &IPCRecorderWidget::DumpProfile);
     connect(ui->filter, &QLineEdit::textChanged, this, &IPCRecorderWidget::ApplyFilterToAll);
     connect(ui->main, &QTreeWidget::itemDoubleClicked, this, &IPCRecorderWidget::OpenRecordDialog);
     connect(this, &IPCRecorderWidget::EntryUpdated, this, &IPCRecorderWidget::OnEntryUpdated);
@@ -120,6 +123,17 @@ void IPCRecorderWidget::Clear() {
 
     records.clear();
     ui->main->invisibleRootItem()->takeChildren();
+
+    if (system.IsPoweredOn()) {
+        system.Kernel().GetIPCProfiler().Reset();
+    }
+}
+
+void IPCRecorderWidget::DumpProfile() {
+    if (!system.IsPoweredOn()) {
+        return;
+    }
+    LOG_INFO(Kernel, "HLE service profile:\n{}", system.Kernel().GetIPCProfiler().Dump());
 }
 
 QString IPCRecorderWidget::GetServiceName(const IPCDebugger::RequestRecord& record) const {
@@ -35,6 +35,7 @@ private:
     void OnEntryUpdated(IPCDebugger::RequestRecord record);
     void SetEnabled(bool enabled);
     void Clear();
+    void DumpProfile();
     void ApplyFilter(int index);
     void ApplyFilterToAll();
     QString GetServiceName(const IPCDebugger::RequestRecord& record) const;
@@ -541,6 +541,7 @@ void GameList::AddGamePopup(QMenu& context_menu, const QString& path, const QStr
     QAction* open_texture_dump_location = context_menu.addAction(tr("Open Texture Dump Location"));
     QAction* open_texture_load_location =
         context_menu.addAction(tr("Open Custom Texture Location"));
+    QAction* build_texture_pack = context_menu.addAction(tr("Build Custom Texture Pack File"));
     QAction* open_mods_location = context_menu.addAction(tr("Open Mods Location"));
     QAction* dump_romfs = context_menu.addAction(tr("Dump RomFS"));
 
@@ -606,6 +607,10 @@ void GameList::AddGamePopup(QMenu& context_menu, const QString& path, const QStr
     open_dlc_location->setEnabled(has_dlc);
     open_texture_dump_location->setEnabled(is_application);
     open_texture_load_location->setEnabled(is_application);
+    build_texture_pack->setEnabled(
+        is_application && FileUtil::Exists(fmt::format(
+                              "{}textures/{:016X}/",
+                              FileUtil::GetUserPath(FileUtil::UserPath::LoadDir), program_id)));
     open_mods_location->setEnabled(is_application);
     dump_romfs->setEnabled(is_application);
 
@@ -647,6 +652,8 @@ void GameList::AddGamePopup(QMenu& context_menu, const QString& path, const QStr
             emit OpenFolderRequested(program_id, GameListOpenTarget::TEXTURE_LOAD);
         }
     });
+    connect(build_texture_pack, &QAction::triggered, this,
+            [this, program_id] { emit BuildTexturePackRequested(program_id); });
     connect(open_mods_location, &QAction::triggered, this, [this, program_id] {
         if (FileUtil::CreateFullPath(fmt::format("{}mods/{:016X}/",
                                                  FileUtil::GetUserPath(FileUtil::UserPath::LoadDir),
@@ -931,8 +938,9 @@ void GameList::LoadInterfaceLayout() {
 }
 
 const QStringList GameList::supported_file_extensions = {
-    QStringLiteral("3ds"), QStringLiteral("3dsx"), QStringLiteral("elf"), QStringLiteral("axf"),
-    QStringLiteral("cci"), QStringLiteral("cxi"),  QStringLiteral("app")};
+    QStringLiteral("3ds"), QStringLiteral("3dsx"), QStringLiteral("elf"),  QStringLiteral("axf"),
+    QStringLiteral("cci"), QStringLiteral("cxi"),  QStringLiteral("app"),  QStringLiteral("zcci"),
+    QStringLiteral("zcxi")};
 
 void GameList::RefreshGameDirectory() {
     if (!UISettings::values.game_dirs.isEmpty() && current_worker != nullptr) {
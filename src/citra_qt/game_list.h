@@ -90,6 +90,7 @@ signals:
                                         const CompatibilityList& compatibility_list);
     void OpenPerGameGeneralRequested(const QString file);
     void DumpRomFSRequested(QString game_path, u64 program_id);
+    void BuildTexturePackRequested(u64 program_id);
     void OpenDirectory(const QString& directory);
     void AddDirectory();
     void ShowList(bool show);
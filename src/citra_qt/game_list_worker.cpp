@@ -2,8 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <QDir>
@@ -15,15 +17,49 @@
 #include "citra_qt/uisettings.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "common/thread_worker.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/fs/archive.h"
 #include "core/loader/loader.h"
 
 namespace {
+
+constexpr u32 METADATA_CACHE_MAGIC = 0x434D'4C47; // "GLMC"
+constexpr u32 METADATA_CACHE_VERSION = 1;
+
+/// Upper bound of the size of the cached SMDH of a file, to reject corrupted caches
+constexpr u32 MAX_CACHED_SMDH_SIZE = 0x10000;
+
+struct MetadataCacheHeader {
+    u32_le magic;
+    u32_le version;
+    u32_le num_entries;
+};
+
+/// Cached metadata of a file, followed by its path and SMDH
+struct CachedFileEntry {
+    u32_le path_size;
+    u32_le smdh_size;
+    u64_le size;
+    s64_le modification_time;
+    u64_le program_id;
+    u64_le extdata_id;
+    u32_le file_type;
+    u32_le is_title;
+};
+static_assert(sizeof(CachedFileEntry) == 0x30, "CachedFileEntry has incorrect size");
+
 bool HasSupportedFileExtension(const std::string& file_name) {
     const QFileInfo file = QFileInfo(QString::fromStdString(file_name));
     return GameList::supported_file_extensions.contains(file.suffix(), Qt::CaseInsensitive);
 }
+
+std::string GetMetadataCachePath() {
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "game_list" DIR_SEP "metadata.bin";
+}
+
 } // Anonymous namespace
 
 GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs,
@@ -46,75 +82,28 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
         const std::string physical_name = directory + DIR_SEP + virtual_name;
         const bool is_dir = FileUtil::IsDirectory(physical_name);
         if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader) {
-                return true;
-            }
+            FileMetadata metadata{};
+            metadata.size = FileUtil::GetSize(physical_name);
+            metadata.modification_time =
+                FileUtil::GetModificationTime(physical_name).value_or(-1);
 
-            bool executable = false;
-            const auto res = loader->IsExecutable(executable);
-            if (!executable && res != Loader::ResultStatus::ErrorEncrypted) {
+            // Files that did not change since the previous scan are not opened again
+            const auto it = cache.find(physical_name);
+            if (it != cache.end() && metadata.modification_time != -1 &&
+                it->second.size == metadata.size &&
+                it->second.modification_time == metadata.modification_time) {
+                EmitEntry(physical_name, it->second, parent_dir, media_type);
+                std::scoped_lock lock{scanned_mutex};
+                scanned.insert_or_assign(physical_name, it->second);
                 return true;
             }
 
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
-
-            u64 extdata_id = 0;
-            loader->ReadExtdataId(extdata_id);
-
-            std::vector<u8> smdh;
-            // Look for an update icon if available
-            if (!(program_id & ~0x00040000FFFFFFFF)) {
-                std::string update_path = Service::AM::GetTitleContentPath(
-                    Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
-                if (FileUtil::Exists(update_path)) {
-                    std::unique_ptr<Loader::AppLoader> update_loader =
-                        Loader::GetLoader(update_path);
-                    if (update_loader) {
-                        update_loader->ReadIcon(smdh);
-                    }
-                }
-            }
-
-            if (!Loader::IsValidSMDH(smdh)) {
-                // Read the original smdh if there is no valid update smdh
-                loader->ReadIcon(smdh);
-            }
-
-            const auto system_title = ((program_id >> 32) & 0xFFFFFFFF) == 0x00040010;
-            if (Loader::IsValidSMDH(smdh)) {
-                if (system_title) {
-                    auto smdh_struct = reinterpret_cast<Loader::SMDH*>(smdh.data());
-                    if (!(smdh_struct->flags & Loader::SMDH::Flags::Visible)) {
-                        // Skip system titles without the visible flag.
-                        return true;
-                    }
+            workers->QueueWork([this, physical_name, parent_dir, media_type,
+                                metadata = std::move(metadata)]() mutable {
+                if (!stop_processing) {
+                    LoadFileMetadata(physical_name, parent_dir, media_type, std::move(metadata));
                 }
-            } else if (UISettings::values.game_list_hide_no_icon || system_title) {
-                // Skip this invalid entry
-                return true;
-            }
-
-            auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
-
-            // The game list uses this as compatibility number for untested games
-            QString compatibility(QStringLiteral("99"));
-            if (it != compatibility_list.end())
-                compatibility = it->second.first;
-
-            emit EntryReady(
-                {
-                    new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
-                                         extdata_id, media_type),
-                    new GameListItemCompat(compatibility),
-                    new GameListItemRegion(smdh),
-                    new GameListItem(
-                        QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()))),
-                    new GameListItemSize(FileUtil::GetSize(physical_name)),
-                },
-                parent_dir);
-
+            });
         } else if (is_dir && recursion > 0) {
             watch_list.append(QString::fromStdString(physical_name));
             AddFstEntriesToGameList(physical_name, recursion - 1, parent_dir, media_type);
@@ -126,8 +115,163 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
     FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
 }
 
+void GameListWorker::LoadFileMetadata(const std::string& physical_name, GameListDir* parent_dir,
+                                      Service::FS::MediaType media_type, FileMetadata metadata) {
+    std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
+    if (loader) {
+        bool executable = false;
+        const auto res = loader->IsExecutable(executable);
+        metadata.is_title = executable || res == Loader::ResultStatus::ErrorEncrypted;
+    }
+
+    if (metadata.is_title) {
+        loader->ReadProgramId(metadata.program_id);
+        loader->ReadExtdataId(metadata.extdata_id);
+        loader->ReadIcon(metadata.smdh);
+        metadata.file_type = static_cast<u32>(loader->GetFileType());
+        EmitEntry(physical_name, metadata, parent_dir, media_type);
+    }
+
+    std::scoped_lock lock{scanned_mutex};
+    scanned.insert_or_assign(physical_name, std::move(metadata));
+}
+
+void GameListWorker::EmitEntry(const std::string& physical_name, const FileMetadata& metadata,
+                               GameListDir* parent_dir, Service::FS::MediaType media_type) {
+    if (!metadata.is_title) {
+        return;
+    }
+    const u64 program_id = metadata.program_id;
+
+    std::vector<u8> smdh;
+    // Look for an update icon if available
+    if (!(program_id & ~0x00040000FFFFFFFF)) {
+        std::string update_path = Service::AM::GetTitleContentPath(
+            Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
+        if (FileUtil::Exists(update_path)) {
+            std::unique_ptr<Loader::AppLoader> update_loader = Loader::GetLoader(update_path);
+            if (update_loader) {
+                update_loader->ReadIcon(smdh);
+            }
+        }
+    }
+
+    if (!Loader::IsValidSMDH(smdh)) {
+        // Use the original smdh if there is no valid update smdh
+        smdh = metadata.smdh;
+    }
+
+    const auto system_title = ((program_id >> 32) & 0xFFFFFFFF) == 0x00040010;
+    if (Loader::IsValidSMDH(smdh)) {
+        if (system_title) {
+            auto smdh_struct = reinterpret_cast<Loader::SMDH*>(smdh.data());
+            if (!(smdh_struct->flags & Loader::SMDH::Flags::Visible)) {
+                // Skip system titles without the visible flag.
+                return;
+            }
+        }
+    } else if (UISettings::values.game_list_hide_no_icon || system_title) {
+        // Skip this invalid entry
+        return;
+    }
+
+    auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
+
+    // The game list uses this as compatibility number for untested games
+    QString compatibility(QStringLiteral("99"));
+    if (it != compatibility_list.end())
+        compatibility = it->second.first;
+
+    emit EntryReady(
+        {
+            new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
+                                 metadata.extdata_id, media_type),
+            new GameListItemCompat(compatibility),
+            new GameListItemRegion(smdh),
+            new GameListItem(QString::fromStdString(
+                Loader::GetFileTypeString(static_cast<Loader::FileType>(metadata.file_type)))),
+            new GameListItemSize(metadata.size),
+        },
+        parent_dir);
+}
+
+void GameListWorker::LoadCache() {
+    cache.clear();
+    FileUtil::IOFile file(GetMetadataCachePath(), "rb");
+    MetadataCacheHeader header{};
+    if (!file || file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != METADATA_CACHE_MAGIC || header.version != METADATA_CACHE_VERSION) {
+        return;
+    }
+
+    const u64 file_size = file.GetSize();
+    for (u32 i = 0; i < header.num_entries; i++) {
+        CachedFileEntry entry;
+        if (file.ReadBytes(&entry, sizeof(entry)) != sizeof(entry) ||
+            entry.path_size > file_size || entry.smdh_size > MAX_CACHED_SMDH_SIZE) {
+            break;
+        }
+        std::string path(entry.path_size, '\0');
+        FileMetadata metadata{
+            .size = entry.size,
+            .modification_time = entry.modification_time,
+            .is_title = entry.is_title != 0,
+            .program_id = entry.program_id,
+            .extdata_id = entry.extdata_id,
+            .file_type = entry.file_type,
+            .smdh = std::vector<u8>(entry.smdh_size),
+        };
+        if (file.ReadBytes(path.data(), path.size()) != path.size() ||
+            file.ReadBytes(metadata.smdh.data(), metadata.smdh.size()) != metadata.smdh.size()) {
+            break;
+        }
+        cache.insert_or_assign(std::move(path), std::move(metadata));
+    }
+}
+
+void GameListWorker::SaveCache() const {
+    const std::string cache_path = GetMetadataCachePath();
+    if (!FileUtil::CreateFullPath(cache_path)) {
+        return;
+    }
+
+    FileUtil::IOFile file(cache_path, "wb");
+    MetadataCacheHeader header{};
+    header.magic = METADATA_CACHE_MAGIC;
+    header.version = METADATA_CACHE_VERSION;
+    header.num_entries = static_cast<u32>(scanned.size());
+    bool success = file.WriteObject(header) == 1;
+    for (const auto& [path, metadata] : scanned) {
+        if (!success) {
+            break;
+        }
+        CachedFileEntry entry{};
+        entry.path_size = static_cast<u32>(path.size());
+        entry.smdh_size = static_cast<u32>(metadata.smdh.size());
+        entry.size = metadata.size;
+        entry.modification_time = metadata.modification_time;
+        entry.program_id = metadata.program_id;
+        entry.extdata_id = metadata.extdata_id;
+        entry.file_type = metadata.file_type;
+        entry.is_title = metadata.is_title ? 1 : 0;
+        success = file.WriteObject(entry) == 1 && file.WriteString(path) == path.size() &&
+                  file.WriteBytes(metadata.smdh.data(), metadata.smdh.size()) ==
+                      metadata.smdh.size();
+    }
+    if (!success) {
+        LOG_ERROR(Frontend, "Could not write the game list cache {}", cache_path);
+        file.Close();
+        FileUtil::Delete(cache_path);
+    }
+}
+
 void GameListWorker::run() {
     stop_processing = false;
+    LoadCache();
+    scanned.clear();
+    workers = std::make_unique<Common::ThreadWorker>(
+        std::clamp(std::thread::hardware_concurrency(), 2U, 8U), "GameListWorker",
+        Common::ThreadRole::Background);
     for (UISettings::GameDir& game_dir : game_dirs) {
         if (game_dir.path == QStringLiteral("INSTALLED")) {
             QString games_path =
@@ -167,6 +311,13 @@ void GameListWorker::run() {
         }
     }
 
+    // Wait for the files read on the workers before reporting the list complete
+    workers->WaitForRequests();
+    workers.reset();
+    if (!stop_processing) {
+        SaveCache();
+    }
+
     emit Finished(watch_list);
 }
 
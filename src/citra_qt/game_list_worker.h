@@ -6,7 +6,10 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <QList>
 #include <QObject>
 #include <QRunnable>
@@ -15,6 +18,11 @@
 #include "citra_qt/compatibility_list.h"
 #include "common/common_types.h"
 
+namespace Common {
+template <class StateType>
+class StatefulThreadWorker;
+}
+
 namespace Service::FS {
 enum class MediaType : u32;
 }
@@ -55,12 +63,43 @@ signals:
     void Finished(QStringList watch_list);
 
 private:
+    /// What is read from a game file for its entry, cached between scans
+    struct FileMetadata {
+        u64 size;
+        s64 modification_time;
+        /// Whether the file is a title shown in the list, the other fields are unset otherwise
+        bool is_title;
+        u64 program_id;
+        u64 extdata_id;
+        u32 file_type;
+        std::vector<u8> smdh;
+    };
+
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
                                  GameListDir* parent_dir, Service::FS::MediaType media_type);
 
+    /// Reads the metadata of a file that is not cached or changed since it was cached.
+    void LoadFileMetadata(const std::string& physical_name, GameListDir* parent_dir,
+                          Service::FS::MediaType media_type, FileMetadata metadata);
+
+    void EmitEntry(const std::string& physical_name, const FileMetadata& metadata,
+                   GameListDir* parent_dir, Service::FS::MediaType media_type);
+
+    void LoadCache();
+    void SaveCache() const;
+
     QVector<UISettings::GameDir>& game_dirs;
     const CompatibilityList& compatibility_list;
 
     QStringList watch_list;
     std::atomic_bool stop_processing;
+
+    /// Metadata of the files found by the previous scans, by path
+    std::unordered_map<std::string, FileMetadata> cache;
+    /// Metadata of the files found by this scan, saved as the cache once it is done
+    std::unordered_map<std::string, FileMetadata> scanned;
+    std::mutex scanned_mutex;
+
+    /// Reads the metadata of the files on several threads
+    std::unique_ptr<Common::StatefulThreadWorker<void>> workers;
 };
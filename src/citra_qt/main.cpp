@@ -95,6 +95,7 @@
 #include "input_common/main.h"
 #include "network/network_settings.h"
 #include "ui_main.h"
+#include "video_core/custom_textures/custom_tex_manager.h"
 #include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
 
@@ -404,8 +405,11 @@ void GMainWindow::InitializeWidgets() {
     emu_frametime_label->setToolTip(
         tr("Time taken to emulate a 3DS frame, not counting framelimiting or v-sync. For "
            "full-speed emulation this should be at most 16.67 ms."));
+    gpu_time_label = new QLabel();
+    audio_label = new QLabel();
 
-    for (auto& label : {emu_speed_label, game_fps_label, emu_frametime_label}) {
+    for (auto& label :
+         {emu_speed_label, game_fps_label, emu_frametime_label, gpu_time_label, audio_label}) {
         label->setVisible(false);
         label->setFrameStyle(QFrame::NoFrame);
         label->setContentsMargins(4, 0, 4, 0);
@@ -681,6 +685,10 @@ void GMainWindow::InitializeHotkeys() {
                      [&] { Settings::values.dump_textures = !Settings::values.dump_textures; });
     connect_shortcut(QStringLiteral("Toggle Custom Textures"),
                      [&] { Settings::values.custom_textures = !Settings::values.custom_textures; });
+    connect_shortcut(QStringLiteral("Toggle Turbo Mode"), [&] {
+        Settings::values.turbo_mode = !Settings::values.turbo_mode.GetValue();
+        UpdateStatusBar();
+    });
     // We use "static" here in order to avoid capturing by lambda due to a MSVC bug, which makes
     // the variable hold a garbage value after this function exits
     static constexpr u16 SPEED_LIMIT_STEP = 5;
@@ -707,6 +715,12 @@ void GMainWindow::InitializeHotkeys() {
         UpdateStatusBar();
     });
 
+    connect_shortcut(QStringLiteral("Rewind"), [&] {
+        if (emulation_running) {
+            system.SendSignal(Core::System::Signal::Rewind);
+        }
+    });
+
     connect_shortcut(QStringLiteral("Audio Mute/Unmute"), &GMainWindow::OnMute);
     connect_shortcut(QStringLiteral("Audio Volume Down"), &GMainWindow::OnDecreaseVolume);
     connect_shortcut(QStringLiteral("Audio Volume Up"), &GMainWindow::OnIncreaseVolume);
@@ -832,6 +846,8 @@ void GMainWindow::ConnectWidgetEvents() {
     connect(game_list, &GameList::NavigateToGamedbEntryRequested, this,
             &GMainWindow::OnGameListNavigateToGamedbEntry);
     connect(game_list, &GameList::DumpRomFSRequested, this, &GMainWindow::OnGameListDumpRomFS);
+    connect(game_list, &GameList::BuildTexturePackRequested, this,
+            &GMainWindow::OnGameListBuildTexturePack);
     connect(game_list, &GameList::AddDirectory, this, &GMainWindow::OnGameListAddDirectory);
     connect(game_list_placeholder, &GameListPlaceholder::AddDirectory, this,
             &GMainWindow::OnGameListAddDirectory);
@@ -1430,6 +1446,8 @@ void GMainWindow::ShutdownGame() {
     emu_speed_label->setVisible(false);
     game_fps_label->setVisible(false);
     emu_frametime_label->setVisible(false);
+    gpu_time_label->setVisible(false);
+    audio_label->setVisible(false);
 
     UpdateSaveStates();
 
@@ -1683,6 +1701,36 @@ void GMainWindow::OnGameListDumpRomFS(QString game_path, u64 program_id) {
     future_watcher->setFuture(future);
 }
 
+void GMainWindow::OnGameListBuildTexturePack(u64 program_id) {
+    auto* dialog = new QProgressDialog(tr("Building texture pack..."), tr("Cancel"), 0, 0, this);
+    dialog->setWindowModality(Qt::WindowModal);
+    dialog->setWindowFlags(dialog->windowFlags() &
+                           ~(Qt::WindowCloseButtonHint | Qt::WindowContextHelpButtonHint));
+    dialog->setCancelButton(nullptr);
+    dialog->setMinimumDuration(0);
+    dialog->setValue(0);
+
+    auto* future_watcher = new QFutureWatcher<bool>(this);
+    connect(future_watcher, &QFutureWatcher<bool>::finished, this, [this, dialog, future_watcher] {
+        dialog->hide();
+        if (!future_watcher->result()) {
+            QMessageBox::critical(
+                this, tr("Citra"),
+                tr("Could not build the custom texture pack.\nRefer to the log for details."));
+            return;
+        }
+        QMessageBox::information(this, tr("Citra"),
+                                 tr("The custom texture pack file was built. It is loaded instead "
+                                    "of the texture folder until it is deleted."));
+    });
+
+    auto future = QtConcurrent::run([this, program_id] {
+        VideoCore::CustomTexManager custom_tex_manager{system};
+        return custom_tex_manager.BuildTexturePack(program_id);
+    });
+    future_watcher->setFuture(future);
+}
+
 void GMainWindow::OnGameListOpenDirectory(const QString& directory) {
     QString path;
     if (directory == QStringLiteral("INSTALLED")) {
@@ -2582,7 +2630,10 @@ void GMainWindow::UpdateStatusBar() {
 
     auto results = system.GetAndResetPerfStats();
 
-    if (Settings::values.frame_limit.GetValue() == 0) {
+    if (Settings::values.turbo_mode.GetValue()) {
+        emu_speed_label->setText(
+            tr("Speed: %1% (Turbo)").arg(results.emulation_speed * 100.0, 0, 'f', 0));
+    } else if (Settings::values.frame_limit.GetValue() == 0) {
         emu_speed_label->setText(tr("Speed: %1%").arg(results.emulation_speed * 100.0, 0, 'f', 0));
     } else {
         emu_speed_label->setText(tr("Speed: %1% / %2%")
@@ -2595,6 +2646,45 @@ void GMainWindow::UpdateStatusBar() {
     emu_speed_label->setVisible(true);
     game_fps_label->setVisible(true);
     emu_frametime_label->setVisible(true);
+
+    // The GPU time breakdown is only measured when profiling is enabled in the debug settings
+    const bool show_gpu_time = Settings::values.gpu_profiling.GetValue();
+    if (show_gpu_time) {
+        const auto entries = system.GPU().Renderer().Profiler().LastFrame();
+        const auto to_ms = [](std::chrono::nanoseconds time) {
+            return std::chrono::duration<double, std::milli>(time).count();
+        };
+        double total_ms = 0.0;
+        QStringList breakdown;
+        for (const auto& entry : entries) {
+            total_ms += to_ms(entry.time);
+            breakdown.append(tr("%1: %2 ms (%3)")
+                                 .arg(QString::fromUtf8(entry.name))
+                                 .arg(to_ms(entry.time), 0, 'f', 2)
+                                 .arg(entry.count));
+        }
+        gpu_time_label->setText(tr("GPU: %1 ms").arg(total_ms, 0, 'f', 2));
+        gpu_time_label->setToolTip(breakdown.join(QLatin1Char('\n')));
+    }
+    gpu_time_label->setVisible(show_gpu_time);
+
+    audio_label->setText(tr("Audio: %1 ms").arg(results.audio_fill * 1000.0, 0, 'f', 0));
+    audio_label->setToolTip(
+        tr("Audio queued for output: %1 ms (lowest %2 ms)\n"
+           "Produced / played: %3\n"
+           "Stretch ratio: %4\n"
+           "Output callback jitter: %5 ms\n"
+           "DSP frame time: %6 ms\n"
+           "Underruns: %7, overruns: %8")
+            .arg(results.audio_fill * 1000.0, 0, 'f', 1)
+            .arg(results.audio_min_fill * 1000.0, 0, 'f', 1)
+            .arg(results.audio_production_ratio, 0, 'f', 3)
+            .arg(results.audio_stretch_ratio, 0, 'f', 3)
+            .arg(results.audio_callback_jitter * 1000.0, 0, 'f', 2)
+            .arg(results.audio_frame_time * 1000.0, 0, 'f', 3)
+            .arg(results.audio_underruns)
+            .arg(results.audio_overruns));
+    audio_label->setVisible(true);
 }
 
 void GMainWindow::UpdateBootHomeMenuState() {
@@ -2683,14 +2773,18 @@ void GMainWindow::UpdateVolumeUI() {
 
 void GMainWindow::UpdateAPIIndicator(bool update) {
     static std::array graphics_apis = {QStringLiteral("SOFTWARE"), QStringLiteral("OPENGL"),
-                                       QStringLiteral("VULKAN")};
+                                       QStringLiteral("VULKAN"), QStringLiteral("NULL")};
 
     static std::array graphics_api_colors = {QStringLiteral("#3ae400"), QStringLiteral("#00ccdd"),
-                                             QStringLiteral("#91242a")};
+                                             QStringLiteral("#91242a"), QStringLiteral("#808080")};
 
     u32 api_index = static_cast<u32>(Settings::values.graphics_api.GetValue());
     if (update) {
         api_index = (api_index + 1) % graphics_apis.size();
+        // The null renderer is meant for headless runs, only the configuration file selects it
+        if (api_index == static_cast<u32>(Settings::GraphicsAPI::Null)) {
+            api_index = (api_index + 1) % graphics_apis.size();
+        }
         // Skip past any disabled renderers.
 #ifndef ENABLE_SOFTWARE_RENDERER
         if (api_index == static_cast<u32>(Settings::GraphicsAPI::Software)) {
@@ -2848,8 +2942,8 @@ static bool IsSingleFileDropEvent(const QMimeData* mime) {
     return mime->hasUrls() && mime->urls().length() == 1;
 }
 
-static const std::array<std::string, 8> AcceptedExtensions = {"cci",  "3ds", "cxi", "bin",
-                                                              "3dsx", "app", "elf", "axf"};
+static const std::array<std::string, 10> AcceptedExtensions = {
+    "cci", "3ds", "cxi", "bin", "3dsx", "app", "elf", "axf", "zcci", "zcxi"};
 
 static bool IsCorrectFileExtension(const QMimeData* mime) {
     const QString& filename = mime->urls().at(0).toLocalFile();
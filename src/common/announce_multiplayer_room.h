@@ -103,6 +103,12 @@ public:
      * Sends a delete message to the announce service
      */
     virtual void Delete() = 0;
+
+    /**
+     * Aborts the update or registration in progress from another thread, so that it fails right
+     * away instead of waiting for the announce service
+     */
+    virtual void Interrupt() = 0;
 };
 
 /**
@@ -131,6 +137,7 @@ public:
     }
 
     void Delete() override {}
+    void Interrupt() override {}
 };
 
 } // namespace AnnounceMultiplayerRoom
@@ -0,0 +1,75 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "common/async_file_reader.h"
+#include "common/file_util.h"
+
+namespace FileUtil {
+
+AsyncFileReader::AsyncFileReader(std::size_t num_threads, std::string_view name)
+    : workers{num_threads, name, Common::ThreadRole::Background} {}
+
+AsyncFileReader::~AsyncFileReader() = default;
+
+AsyncFileReader& AsyncFileReader::Instance() {
+    // Storage handles a few requests in flight well, more threads only contend for it
+    static AsyncFileReader instance{std::clamp(std::thread::hardware_concurrency() / 2, 2U, 4U),
+                                    "File I/O"};
+    return instance;
+}
+
+std::future<std::size_t> AsyncFileReader::ReadAt(IOFile& file, u8* buffer, std::size_t length,
+                                                 std::size_t offset) {
+    std::promise<std::size_t> promise;
+    auto future = promise.get_future();
+    workers.QueueWork([&file, buffer, length, offset, promise = std::move(promise)]() mutable {
+        promise.set_value(file.ReadAtBytes(buffer, length, offset));
+    });
+    return future;
+}
+
+std::future<void> AsyncFileReader::ReadBatch(IOFile& file, std::vector<Request> requests,
+                                             Callback callback) {
+    struct Batch {
+        std::vector<Request> requests;
+        Callback callback;
+        std::atomic<std::size_t> remaining_runs;
+        std::promise<void> done;
+    };
+
+    const std::size_t num_requests = requests.size();
+    const std::size_t num_runs = std::min(workers.NumWorkers(), num_requests);
+    auto batch = std::make_shared<Batch>();
+    batch->requests = std::move(requests);
+    batch->callback = std::move(callback);
+    batch->remaining_runs = num_runs;
+    auto future = batch->done.get_future();
+    if (num_runs == 0) {
+        batch->done.set_value();
+        return future;
+    }
+
+    for (std::size_t run = 0; run < num_runs; run++) {
+        const std::size_t begin = num_requests * run / num_runs;
+        const std::size_t end = num_requests * (run + 1) / num_runs;
+        workers.QueueWork([batch, &file, begin, end] {
+            for (std::size_t i = begin; i < end; i++) {
+                const Request& request = batch->requests[i];
+                const std::size_t read_size =
+                    file.ReadAtBytes(request.buffer, request.length, request.offset);
+                batch->callback(i, read_size);
+            }
+            if (--batch->remaining_runs == 0) {
+                batch->done.set_value();
+            }
+        });
+    }
+    return future;
+}
+
+} // namespace FileUtil
@@ -0,0 +1,63 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <string_view>
+#include <vector>
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+
+namespace FileUtil {
+
+class IOFile;
+
+/**
+ * Reads files on a pool of I/O threads, so that the callers can issue many reads at once without
+ * blocking on them. The reads are positional, they do not move the position of the files and
+ * several of them may run on the same file at the same time.
+ */
+class AsyncFileReader {
+public:
+    struct Request {
+        u8* buffer;
+        std::size_t length;
+        std::size_t offset;
+    };
+
+    /// Called on an I/O thread with the index of a request and the number of bytes read for it,
+    /// which is larger than the length of the request when the read failed.
+    using Callback = std::function<void(std::size_t index, std::size_t read_size)>;
+
+    AsyncFileReader(std::size_t num_threads, std::string_view name);
+    ~AsyncFileReader();
+
+    /// Returns the reader shared by the emulator components.
+    static AsyncFileReader& Instance();
+
+    /**
+     * Reads from a file in the background.
+     * The file and the buffer must be kept alive until the returned future is ready.
+     * @returns Future of the number of bytes read
+     */
+    std::future<std::size_t> ReadAt(IOFile& file, u8* buffer, std::size_t length,
+                                    std::size_t offset);
+
+    /**
+     * Reads a batch of requests from a file in the background. The batch is split in runs of
+     * consecutive requests, one per thread, so that each thread reads its part of the file in
+     * order and the batch only takes a single queue entry per thread.
+     * The file and the buffers must be kept alive until the returned future is ready.
+     * @param callback Called once per request, as soon as it is read
+     * @returns Future that is ready once all the callbacks returned
+     */
+    std::future<void> ReadBatch(IOFile& file, std::vector<Request> requests, Callback callback);
+
+private:
+    Common::ThreadWorker workers;
+};
+
+} // namespace FileUtil
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <limits>
 #include <memory>
+#include <span>
 #include <sstream>
 #include <unordered_map>
 #include <boost/iostreams/device/file_descriptor.hpp>
@@ -19,6 +20,7 @@
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
 #include "common/string_util.h"
+#include "common/zstd_seekable.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -54,6 +56,7 @@
 #include <cstring>
 #include <dirent.h>
 #include <pwd.h>
+#include <sys/file.h>
 #include <unistd.h>
 #endif
 
@@ -315,6 +318,26 @@ bool Rename(const std::string& srcFilename, const std::string& destFilename) {
     return false;
 }
 
+bool RenameReplacing(const std::string& srcFilename, const std::string& destFilename) {
+    LOG_TRACE(Common_Filesystem, "{} --> {}", srcFilename, destFilename);
+#ifdef _WIN32
+    if (MoveFileExW(Common::UTF8ToUTF16W(srcFilename).c_str(),
+                    Common::UTF8ToUTF16W(destFilename).c_str(), MOVEFILE_REPLACE_EXISTING))
+        return true;
+#elif ANDROID
+    // The storage framework cannot replace a file, so readers may briefly find it missing
+    Delete(destFilename);
+    if (AndroidStorage::RenameFile(srcFilename, std::string(GetFilename(destFilename))))
+        return true;
+#else
+    if (rename(srcFilename.c_str(), destFilename.c_str()) == 0)
+        return true;
+#endif
+    LOG_ERROR(Common_Filesystem, "failed {} --> {}: {}", srcFilename, destFilename,
+              GetLastErrorMsg());
+    return false;
+}
+
 bool Copy(const std::string& srcFilename, const std::string& destFilename) {
     LOG_TRACE(Common_Filesystem, "{} --> {}", srcFilename, destFilename);
 #ifdef _WIN32
@@ -428,6 +451,24 @@ u64 GetSize(FILE* f) {
     return size;
 }
 
+std::optional<s64> GetModificationTime([[maybe_unused]] const std::string& filename) {
+#ifdef ANDROID
+    return std::nullopt;
+#else
+    struct stat buf;
+#ifdef _WIN32
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) != 0)
+#else
+    if (stat(filename.c_str(), &buf) != 0)
+#endif
+    {
+        LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+        return std::nullopt;
+    }
+    return static_cast<s64>(buf.st_mtime);
+#endif
+}
+
 bool CreateEmptyFile(const std::string& filename) {
     LOG_TRACE(Common_Filesystem, "{}", filename);
 
@@ -1029,6 +1070,31 @@ std::string SanitizePath(std::string_view path_, DirectorySeparator directory_se
     return std::string(RemoveTrailingSlash(path));
 }
 
+#ifdef _WIN32
+static std::size_t pread(int fd, void* buf, std::size_t count, uint64_t offset) {
+    long unsigned int read_bytes = 0;
+    OVERLAPPED overlapped = {0};
+    HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+
+    overlapped.OffsetHigh = static_cast<uint32_t>(offset >> 32);
+    overlapped.Offset = static_cast<uint32_t>(offset & 0xFFFF'FFFFLL);
+    SetLastError(0);
+    bool ret = ReadFile(file, buf, static_cast<uint32_t>(count), &read_bytes, &overlapped);
+
+    if (!ret && GetLastError() != ERROR_HANDLE_EOF) {
+        errno = GetLastError();
+        return std::numeric_limits<std::size_t>::max();
+    }
+    return read_bytes;
+}
+#else
+#define pread ::pread
+#endif
+
+static std::size_t ReadAtFile(std::FILE* file, void* data, std::size_t length, u64 offset) {
+    return static_cast<std::size_t>(pread(fileno(file), data, length, offset));
+}
+
 IOFile::IOFile() = default;
 
 IOFile::IOFile(const std::string& filename, const char openmode[], int flags)
@@ -1053,6 +1119,8 @@ void IOFile::Swap(IOFile& other) noexcept {
     std::swap(m_file, other.m_file);
     std::swap(m_fd, other.m_fd);
     std::swap(m_good, other.m_good);
+    std::swap(m_compressed, other.m_compressed);
+    std::swap(m_compressed_pos, other.m_compressed_pos);
     std::swap(filename, other.filename);
     std::swap(openmode, other.openmode);
     std::swap(flags, other.flags);
@@ -1104,6 +1172,14 @@ bool IOFile::Open() {
     m_good = m_file != nullptr;
 #endif
 
+    if (m_good && openmode.find_first_of("wa+") == std::string::npos) {
+        std::FILE* const file = m_file;
+        m_compressed = Common::Compression::SeekableZSTDReader::Open(
+            [file](std::span<u8> data, u64 offset) {
+                return ReadAtFile(file, data.data(), data.size(), offset);
+            });
+    }
+
     return m_good;
 }
 
@@ -1112,10 +1188,15 @@ bool IOFile::Close() {
         m_good = false;
 
     m_file = nullptr;
+    m_compressed.reset();
+    m_compressed_pos = 0;
     return m_good;
 }
 
 u64 IOFile::GetSize() const {
+    if (m_compressed)
+        return m_compressed->GetSize();
+
     if (IsOpen())
         return FileUtil::GetSize(m_file);
 
@@ -1123,6 +1204,21 @@ u64 IOFile::GetSize() const {
 }
 
 bool IOFile::Seek(s64 off, int origin) {
+    if (m_compressed) {
+        s64 base = 0;
+        if (origin == SEEK_CUR) {
+            base = static_cast<s64>(m_compressed_pos);
+        } else if (origin == SEEK_END) {
+            base = static_cast<s64>(m_compressed->GetSize());
+        }
+        if (base + off < 0) {
+            m_good = false;
+        } else {
+            m_compressed_pos = static_cast<u64>(base + off);
+        }
+        return m_good;
+    }
+
     if (!IsOpen() || 0 != fseeko(m_file, off, origin))
         m_good = false;
 
@@ -1130,6 +1226,9 @@ bool IOFile::Seek(s64 off, int origin) {
 }
 
 u64 IOFile::Tell() const {
+    if (m_compressed)
+        return m_compressed_pos;
+
     if (IsOpen())
         return ftello(m_file);
 
@@ -1143,6 +1242,39 @@ bool IOFile::Flush() {
     return m_good;
 }
 
+bool IOFile::Lock(bool exclusive) {
+    const int fd = GetFd();
+    if (fd == -1) {
+        return false;
+    }
+#ifdef _WIN32
+    const HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    OVERLAPPED overlapped{};
+    if (!LockFileEx(handle, exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, MAXDWORD, MAXDWORD,
+                    &overlapped)) {
+#else
+    if (flock(fd, exclusive ? LOCK_EX : LOCK_SH) != 0) {
+#endif
+        LOG_ERROR(Common_Filesystem, "Failed to lock {}: {}", filename, GetLastErrorMsg());
+        return false;
+    }
+    return true;
+}
+
+bool IOFile::Unlock() {
+    const int fd = GetFd();
+    if (fd == -1) {
+        return false;
+    }
+#ifdef _WIN32
+    const HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    OVERLAPPED overlapped{};
+    return UnlockFileEx(handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+    return flock(fd, LOCK_UN) == 0;
+#endif
+}
+
 std::size_t IOFile::ReadImpl(void* data, std::size_t length, std::size_t data_size) {
     if (!IsOpen()) {
         m_good = false;
@@ -1155,29 +1287,15 @@ std::size_t IOFile::ReadImpl(void* data, std::size_t length, std::size_t data_si
 
     DEBUG_ASSERT(data != nullptr);
 
-    return std::fread(data, data_size, length, m_file);
-}
-
-#ifdef _WIN32
-static std::size_t pread(int fd, void* buf, std::size_t count, uint64_t offset) {
-    long unsigned int read_bytes = 0;
-    OVERLAPPED overlapped = {0};
-    HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
-
-    overlapped.OffsetHigh = static_cast<uint32_t>(offset >> 32);
-    overlapped.Offset = static_cast<uint32_t>(offset & 0xFFFF'FFFFLL);
-    SetLastError(0);
-    bool ret = ReadFile(file, buf, static_cast<uint32_t>(count), &read_bytes, &overlapped);
-
-    if (!ret && GetLastError() != ERROR_HANDLE_EOF) {
-        errno = GetLastError();
-        return std::numeric_limits<std::size_t>::max();
+    if (m_compressed) {
+        const std::size_t read_size = m_compressed->ReadAt(
+            std::span{static_cast<u8*>(data), data_size * length}, m_compressed_pos);
+        m_compressed_pos += read_size;
+        return read_size / data_size;
     }
-    return read_bytes;
+
+    return std::fread(data, data_size, length, m_file);
 }
-#else
-#define pread ::pread
-#endif
 
 std::size_t IOFile::ReadAtImpl(void* data, std::size_t length, std::size_t data_size,
                                std::size_t offset) {
@@ -1192,7 +1310,11 @@ std::size_t IOFile::ReadAtImpl(void* data, std::size_t length, std::size_t data_
 
     DEBUG_ASSERT(data != nullptr);
 
-    return pread(fileno(m_file), data, data_size * length, offset);
+    if (m_compressed) {
+        return m_compressed->ReadAt(std::span{static_cast<u8*>(data), data_size * length}, offset);
+    }
+
+    return ReadAtFile(m_file, data, data_size * length, offset);
 }
 
 std::size_t IOFile::WriteImpl(const void* data, std::size_t length, std::size_t data_size) {
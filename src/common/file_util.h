@@ -9,6 +9,7 @@
 #include <functional>
 #include <ios>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -22,6 +23,10 @@
 #include "common/string_util.h"
 #endif
 
+namespace Common::Compression {
+class SeekableZSTDReader;
+}
+
 namespace FileUtil {
 
 // User paths for GetUserPath
@@ -105,6 +110,10 @@ private:
 // Overloaded GetSize, accepts FILE*
 [[nodiscard]] u64 GetSize(FILE* f);
 
+// Returns the time filename was last modified, in seconds since the epoch, or nullopt if it is
+// unknown, such as for the content URIs of Android
+[[nodiscard]] std::optional<s64> GetModificationTime(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
@@ -121,6 +130,10 @@ bool DeleteDir(const std::string& filename);
 // renames file srcFilename to destFilename, returns true on success
 bool Rename(const std::string& srcFilename, const std::string& destFilename);
 
+// renames file srcFilename to destFilename, replacing destFilename if it exists. Processes opening
+// destFilename meanwhile see either the old or the new file. Returns true on success
+bool RenameReplacing(const std::string& srcFilename, const std::string& destFilename);
+
 // copies file srcFilename to destFilename, returns true on success
 bool Copy(const std::string& srcFilename, const std::string& destFilename);
 
@@ -264,6 +277,8 @@ enum class DirectorySeparator {
 // simple wrapper for cstdlib file functions to
 // hopefully will make error checking easier
 // and make forgetting an fclose() harder
+// Files in the seekable Zstandard format that are opened for reading only are decompressed
+// transparently, so that compressed game images can be read like the raw ones
 class IOFile : public NonCopyable {
 public:
     IOFile();
@@ -350,6 +365,11 @@ public:
         return nullptr != m_file;
     }
 
+    // whether reads are decompressed from a file in the seekable Zstandard format
+    [[nodiscard]] bool IsCompressed() const {
+        return m_compressed != nullptr;
+    }
+
     // m_good is set to false when a read, write or other function fails
     [[nodiscard]] bool IsGood() const {
         return m_good;
@@ -373,6 +393,14 @@ public:
     bool Resize(u64 size);
     bool Flush();
 
+    /**
+     * Takes an advisory lock on the whole file, to coordinate with other processes using it:
+     * readers take a shared lock, writers an exclusive one. Blocks until the lock is granted.
+     * Only other lockers are held off, the file can still be accessed without the lock.
+     */
+    bool Lock(bool exclusive);
+    bool Unlock();
+
     // clear error state
     void Clear() {
         m_good = true;
@@ -391,6 +419,9 @@ private:
     int m_fd = -1;
     bool m_good = true;
 
+    std::unique_ptr<Common::Compression::SeekableZSTDReader> m_compressed;
+    u64 m_compressed_pos = 0;
+
     std::string filename;
     std::string openmode;
     u32 flags;
@@ -413,6 +444,27 @@ private:
     friend class boost::serialization::access;
 };
 
+/// Holds an advisory lock on a file while in scope, see IOFile::Lock
+class ScopedFileLock : NonCopyable {
+public:
+    explicit ScopedFileLock(IOFile& file_, bool exclusive)
+        : file{file_}, locked{file_.Lock(exclusive)} {}
+
+    ~ScopedFileLock() {
+        if (locked) {
+            file.Unlock();
+        }
+    }
+
+    [[nodiscard]] bool IsLocked() const {
+        return locked;
+    }
+
+private:
+    IOFile& file;
+    bool locked;
+};
+
 template <std::ios_base::openmode o, typename T>
 void OpenFStream(T& fstream, const std::string& filename);
 } // namespace FileUtil
@@ -0,0 +1,266 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include "common/arch.h"
+#include "common/hash.h"
+
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// The stripes are accumulated with SSE2 and NEON, which every x86_64 and arm64 CPU has, and give
+// the same hashes as the scalar path.
+
+namespace Common {
+
+namespace {
+
+constexpr u64 Prime32_1 = 0x9E3779B1U;
+constexpr u64 Prime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr u64 Prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr u64 Prime64_3 = 0x165667B19E3779F9ULL;
+
+constexpr std::size_t StripeSize = 64;
+constexpr std::size_t NumLanes = StripeSize / sizeof(u64);
+/// Stripes accumulated between two scrambles of the accumulators
+constexpr std::size_t StripesPerBlock = 16;
+constexpr std::size_t BlockSize = StripeSize * StripesPerBlock;
+
+/// Keys mixed with the input. Each stripe of a block reads the keys one further than the last.
+constexpr std::array<u64, 32> Secret = [] {
+    std::array<u64, 32> secret{};
+    u64 state = Prime64_3;
+    for (u64& key : secret) {
+        // SplitMix64
+        state += 0x9E3779B97F4A7C15ULL;
+        u64 z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        key = z ^ (z >> 31);
+    }
+    return secret;
+}();
+constexpr std::size_t ScrambleSecret = StripesPerBlock;
+constexpr std::size_t LastStripeSecret = StripesPerBlock + NumLanes;
+constexpr std::size_t MergeSecret = 8;
+
+u64 Read64(const u8* data) {
+    u64 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+u32 Read32(const u8* data) {
+    u32 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/// Multiplies two 64-bit values into 128 bits and folds the halves together.
+u64 MulFold64(u64 lhs, u64 rhs) {
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t product = static_cast<__uint128_t>(lhs) * rhs;
+    return static_cast<u64>(product) ^ static_cast<u64>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    u64 high;
+    const u64 low = _umul128(lhs, rhs, &high);
+    return low ^ high;
+#else
+    const u64 lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+    const u64 hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+    const u64 lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+    const u64 hi_hi = (lhs >> 32) * (rhs >> 32);
+    const u64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    const u64 high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    const u64 low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return low ^ high;
+#endif
+}
+
+u64 Avalanche(u64 hash) {
+    hash ^= hash >> 37;
+    hash *= 0x165667919E3779F9ULL;
+    return hash ^ (hash >> 32);
+}
+
+u64 Mix16(const u8* data, std::size_t secret) {
+    return MulFold64(Read64(data) ^ Secret[secret], Read64(data + 8) ^ Secret[secret + 1]);
+}
+
+u64 HashShort(const u8* data, std::size_t len) {
+    if (len > 8) {
+        const u64 low = Read64(data) ^ Secret[0];
+        const u64 high = Read64(data + len - 8) ^ Secret[1];
+        return Avalanche(len + low + high + MulFold64(low, high));
+    }
+    if (len >= 4) {
+        const u64 value = (static_cast<u64>(Read32(data)) << 32) | Read32(data + len - 4);
+        return Avalanche(MulFold64(value ^ Secret[2], len + Prime64_1));
+    }
+    if (len > 0) {
+        const u64 value = (static_cast<u64>(data[0]) << 16) |
+                          (static_cast<u64>(data[len / 2]) << 8) | data[len - 1];
+        return Avalanche(MulFold64(value ^ Secret[3], len + Prime64_2));
+    }
+    return Avalanche(Secret[4] ^ Secret[5]);
+}
+
+u64 HashMedium(const u8* data, std::size_t len) {
+    // Pairs of 16 bytes from both ends, which overlap when the length is not a multiple of 32
+    u64 acc = len * Prime64_1;
+    const std::size_t num_pairs = (len + 31) / 32;
+    for (std::size_t i = 0; i < num_pairs; i++) {
+        acc += Mix16(data + i * 16, i * 4);
+        acc += Mix16(data + len - (i + 1) * 16, i * 4 + 2);
+    }
+    return Avalanche(acc);
+}
+
+/**
+ * Accumulates consecutive stripes into the lanes, each lane adds the product of the 32-bit halves
+ * of its keyed input and the input of its neighbour. The stripe n is keyed from Secret[secret + n].
+ * The lanes are kept in registers meanwhile, as the input could alias them otherwise.
+ */
+void AccumulateStripes(std::array<u64, NumLanes>& acc, const u8* data, std::size_t num_stripes,
+                       std::size_t secret) {
+#if CITRA_ARCH(x86_64)
+    const auto accumulate = [](__m128i lane, const __m128i* input, const __m128i* keys) {
+        const __m128i value = _mm_loadu_si128(input);
+        const __m128i key = _mm_xor_si128(value, _mm_loadu_si128(keys));
+        const __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, 0x31));
+        const __m128i swapped = _mm_shuffle_epi32(value, 0x4E);
+        return _mm_add_epi64(lane, _mm_add_epi64(product, swapped));
+    };
+    auto* const lanes = reinterpret_cast<__m128i*>(acc.data());
+    __m128i lanes01 = _mm_loadu_si128(lanes);
+    __m128i lanes23 = _mm_loadu_si128(lanes + 1);
+    __m128i lanes45 = _mm_loadu_si128(lanes + 2);
+    __m128i lanes67 = _mm_loadu_si128(lanes + 3);
+    for (std::size_t stripe = 0; stripe < num_stripes; stripe++) {
+        const auto* const input = reinterpret_cast<const __m128i*>(data + stripe * StripeSize);
+        const auto* const keys = reinterpret_cast<const __m128i*>(Secret.data() + secret + stripe);
+        lanes01 = accumulate(lanes01, input, keys);
+        lanes23 = accumulate(lanes23, input + 1, keys + 1);
+        lanes45 = accumulate(lanes45, input + 2, keys + 2);
+        lanes67 = accumulate(lanes67, input + 3, keys + 3);
+    }
+    _mm_storeu_si128(lanes, lanes01);
+    _mm_storeu_si128(lanes + 1, lanes23);
+    _mm_storeu_si128(lanes + 2, lanes45);
+    _mm_storeu_si128(lanes + 3, lanes67);
+#elif CITRA_ARCH(arm64)
+    const auto accumulate = [](uint64x2_t lane, const u8* input, const u64* keys) {
+        const uint64x2_t value = vreinterpretq_u64_u8(vld1q_u8(input));
+        const uint64x2_t key = veorq_u64(value, vld1q_u64(keys));
+        const uint64x2_t product = vmull_u32(vmovn_u64(key), vshrn_n_u64(key, 32));
+        const uint64x2_t swapped = vextq_u64(value, value, 1);
+        return vaddq_u64(lane, vaddq_u64(product, swapped));
+    };
+    uint64x2_t lanes01 = vld1q_u64(acc.data());
+    uint64x2_t lanes23 = vld1q_u64(acc.data() + 2);
+    uint64x2_t lanes45 = vld1q_u64(acc.data() + 4);
+    uint64x2_t lanes67 = vld1q_u64(acc.data() + 6);
+    for (std::size_t stripe = 0; stripe < num_stripes; stripe++) {
+        const u8* const input = data + stripe * StripeSize;
+        const u64* const keys = Secret.data() + secret + stripe;
+        lanes01 = accumulate(lanes01, input, keys);
+        lanes23 = accumulate(lanes23, input + 16, keys + 2);
+        lanes45 = accumulate(lanes45, input + 32, keys + 4);
+        lanes67 = accumulate(lanes67, input + 48, keys + 6);
+    }
+    vst1q_u64(acc.data(), lanes01);
+    vst1q_u64(acc.data() + 2, lanes23);
+    vst1q_u64(acc.data() + 4, lanes45);
+    vst1q_u64(acc.data() + 6, lanes67);
+#else
+    std::array<u64, NumLanes> lanes = acc;
+    for (std::size_t stripe = 0; stripe < num_stripes; stripe++) {
+        for (std::size_t i = 0; i < NumLanes; i++) {
+            const u64 value = Read64(data + stripe * StripeSize + i * 8);
+            const u64 key = value ^ Secret[secret + stripe + i];
+            lanes[i ^ 1] += value;
+            lanes[i] += (key & 0xFFFFFFFF) * (key >> 32);
+        }
+    }
+    acc = lanes;
+#endif
+}
+
+void ScrambleLanes(std::array<u64, NumLanes>& acc) {
+#if CITRA_ARCH(x86_64)
+    auto* const lanes = reinterpret_cast<__m128i*>(acc.data());
+    const auto* const keys = reinterpret_cast<const __m128i*>(Secret.data() + ScrambleSecret);
+    const __m128i prime = _mm_set1_epi32(static_cast<s32>(Prime32_1));
+    for (std::size_t i = 0; i < NumLanes / 2; i++) {
+        __m128i lane = _mm_loadu_si128(lanes + i);
+        lane = _mm_xor_si128(lane, _mm_srli_epi64(lane, 47));
+        lane = _mm_xor_si128(lane, _mm_loadu_si128(keys + i));
+        // 64x32 bit multiply from the products of both halves
+        const __m128i low = _mm_mul_epu32(lane, prime);
+        const __m128i high = _mm_mul_epu32(_mm_srli_epi64(lane, 32), prime);
+        _mm_storeu_si128(lanes + i, _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+    }
+#elif CITRA_ARCH(arm64)
+    const uint32x2_t prime = vdup_n_u32(static_cast<u32>(Prime32_1));
+    for (std::size_t i = 0; i < NumLanes; i += 2) {
+        uint64x2_t lane = vld1q_u64(acc.data() + i);
+        lane = veorq_u64(lane, vshrq_n_u64(lane, 47));
+        lane = veorq_u64(lane, vld1q_u64(Secret.data() + ScrambleSecret + i));
+        // 64x32 bit multiply from the products of both halves
+        const uint64x2_t low = vmull_u32(vmovn_u64(lane), prime);
+        const uint64x2_t high = vmull_u32(vshrn_n_u64(lane, 32), prime);
+        vst1q_u64(acc.data() + i, vaddq_u64(low, vshlq_n_u64(high, 32)));
+    }
+#else
+    for (std::size_t i = 0; i < NumLanes; i++) {
+        acc[i] = (acc[i] ^ (acc[i] >> 47) ^ Secret[ScrambleSecret + i]) * Prime32_1;
+    }
+#endif
+}
+
+u64 HashLong(const u8* data, std::size_t len) {
+    std::array<u64, NumLanes> acc{Prime32_1, Prime64_1, Prime64_2, Prime64_3,
+                                  Prime64_1, Prime64_2, Prime64_3, Prime32_1};
+
+    const std::size_t num_blocks = (len - 1) / BlockSize;
+    for (std::size_t block = 0; block < num_blocks; block++) {
+        AccumulateStripes(acc, data + block * BlockSize, StripesPerBlock, 0);
+        ScrambleLanes(acc);
+    }
+
+    // The last block is partial, its last stripe is read from the end of the data
+    const u8* last_block = data + num_blocks * BlockSize;
+    const std::size_t num_stripes = (len - 1 - num_blocks * BlockSize) / StripeSize;
+    AccumulateStripes(acc, last_block, num_stripes, 0);
+    AccumulateStripes(acc, data + len - StripeSize, 1, LastStripeSecret);
+
+    u64 result = len * Prime64_1;
+    for (std::size_t i = 0; i < NumLanes; i += 2) {
+        result += MulFold64(acc[i] ^ Secret[MergeSecret + i],
+                            acc[i + 1] ^ Secret[MergeSecret + i + 1]);
+    }
+    return Avalanche(result);
+}
+
+} // Anonymous namespace
+
+u64 ComputeFastHash64(const void* data, std::size_t len) noexcept {
+    const u8* bytes = static_cast<const u8*>(data);
+    if (len <= 16) {
+        return HashShort(bytes, len);
+    }
+    if (len <= 128) {
+        return HashMedium(bytes, len);
+    }
+    return HashLong(bytes, len);
+}
+
+} // namespace Common
@@ -21,6 +21,18 @@ static inline u64 ComputeHash64(const void* data, std::size_t len) noexcept {
     return CityHash64(static_cast<const char*>(data), len);
 }
 
+/**
+ * Computes a 64-bit hash over the specified block of data, about 1.5 times as fast as
+ * ComputeHash64 on large blocks. Like XXH3, it accumulates 64-byte stripes into eight independent
+ * lanes with 32x32 bit multiplies, which are done with SSE2 or NEON. The values are not
+ * compatible with ComputeHash64 and may change between versions, so it is only meant for hashes
+ * that are never stored, like the ones detecting changes of guest data.
+ * @param data Block of data to compute hash over
+ * @param len Length of data (in bytes) to compute hash over
+ * @returns 64-bit hash value that was computed over the data block
+ */
+[[nodiscard]] u64 ComputeFastHash64(const void* data, std::size_t len) noexcept;
+
 /**
  * Computes a 64-bit hash of a struct. In addition to being trivially copyable, it is also critical
  * that either the struct includes no padding, or that any padding is initialized to a known value
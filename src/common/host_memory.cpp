@@ -0,0 +1,242 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <fmt/format.h>
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/host_memory.h"
+#include "common/logging/log.h"
+
+namespace Common {
+
+namespace {
+
+/// Guest pages are aliased individually, so host pages must not be larger than them.
+constexpr long GuestPageSize = 0x1000;
+
+/// Size of the large pages on x86-64 and of the transparent huge pages on ARM64 with 4 KiB pages
+constexpr std::size_t HugePageSize = 2 * 1024 * 1024;
+
+#ifdef _WIN32
+/// Large pages can only be allocated by users granted the "Lock pages in memory" privilege
+bool EnableLockMemoryPrivilege() {
+    HANDLE token;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        return false;
+    }
+    TOKEN_PRIVILEGES privileges{};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    const bool enabled =
+        LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+        AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+        GetLastError() == ERROR_SUCCESS;
+    CloseHandle(token);
+    return enabled;
+}
+#else
+/// Asks the kernel to back a range with transparent huge pages, where it supports them
+void AdviseHugePages([[maybe_unused]] void* pointer, [[maybe_unused]] std::size_t length) {
+#ifdef MADV_HUGEPAGE
+    madvise(pointer, length, MADV_HUGEPAGE);
+#endif
+}
+
+int CreateSharedMemory(std::size_t size) {
+#if defined(__linux__)
+    // Use the raw syscall as older Android NDKs lack the memfd_create wrapper.
+    const int fd = static_cast<int>(syscall(__NR_memfd_create, "CitraHostMemory", 0));
+#else
+    const std::string name = fmt::format("/CitraHostMemory-{}", getpid());
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name.c_str());
+    }
+#endif
+    if (fd < 0) {
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+#endif
+
+} // Anonymous namespace
+
+HostMemory::HostMemory(std::size_t backing_size_) : backing_size{backing_size_} {
+#ifdef _WIN32
+    LOG_WARNING(Common_Memory, "Aliased host memory is not supported on this platform");
+#else
+    if (sysconf(_SC_PAGESIZE) != GuestPageSize) {
+        LOG_WARNING(Common_Memory, "Host page size {} does not match the guest page size",
+                    sysconf(_SC_PAGESIZE));
+        return;
+    }
+
+    fd = CreateSharedMemory(backing_size);
+    if (fd < 0) {
+        LOG_ERROR(Common_Memory, "Unable to create shared memory of size {:#x}", backing_size);
+        return;
+    }
+
+    void* base = mmap(nullptr, backing_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Unable to map shared memory of size {:#x}", backing_size);
+        close(fd);
+        fd = -1;
+        return;
+    }
+    backing_base = static_cast<u8*>(base);
+    // Shared memory gets huge pages when the host enables them for shmem with "advise"
+    AdviseHugePages(backing_base, backing_size);
+#endif
+}
+
+HostMemory::~HostMemory() {
+#ifndef _WIN32
+    if (backing_base) {
+        munmap(backing_base, backing_size);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+}
+
+VirtualArena::VirtualArena(HostMemory& backing_, std::size_t virtual_size_)
+    : backing{backing_}, virtual_size{virtual_size_} {
+#ifndef _WIN32
+    if (!backing.IsValid()) {
+        return;
+    }
+
+    void* base = mmap(nullptr, virtual_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                      -1, 0);
+    if (base == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Unable to reserve virtual arena of size {:#x}", virtual_size);
+        return;
+    }
+    virtual_base = static_cast<u8*>(base);
+#endif
+}
+
+VirtualArena::~VirtualArena() {
+#ifndef _WIN32
+    if (virtual_base) {
+        munmap(virtual_base, virtual_size);
+    }
+#endif
+}
+
+void VirtualArena::Map(std::size_t virtual_offset, std::size_t backing_offset,
+                       std::size_t length) {
+    ASSERT(virtual_offset + length <= virtual_size);
+    ASSERT(backing_offset + length <= backing.backing_size);
+#ifndef _WIN32
+    void* ret = mmap(virtual_base + virtual_offset, length, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_FIXED, backing.fd, static_cast<off_t>(backing_offset));
+    ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", strerror(errno));
+    // Large ranges, like the linear heap, may be mapped with huge pages too
+    if (length >= HugePageSize) {
+        AdviseHugePages(ret, length);
+    }
+#endif
+}
+
+void VirtualArena::Unmap(std::size_t virtual_offset, std::size_t length) {
+    ASSERT(virtual_offset + length <= virtual_size);
+#ifndef _WIN32
+    // Replace the range with a fresh inaccessible reservation so it cannot be claimed by others.
+    void* ret = mmap(virtual_base + virtual_offset, length, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", strerror(errno));
+#endif
+}
+
+LargePageBuffer::LargePageBuffer(std::size_t size_) : size{size_} {
+#ifdef _WIN32
+    const std::size_t large_page_size = GetLargePageMinimum();
+    if (large_page_size != 0 && EnableLockMemoryPrivilege()) {
+        mapped_size = Common::AlignUp(size, large_page_size);
+        base = static_cast<u8*>(VirtualAlloc(nullptr, mapped_size,
+                                             MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                             PAGE_READWRITE));
+        large_pages = base != nullptr;
+    }
+    if (!base) {
+        mapped_size = size;
+        base = static_cast<u8*>(
+            VirtualAlloc(nullptr, mapped_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    }
+    if (!base) {
+        LOG_ERROR(Common_Memory, "Unable to allocate {:#x} bytes of memory", size);
+    }
+#else
+#ifdef MAP_HUGETLB
+    // Explicit huge pages are only available when the administrator reserved a pool of them
+    mapped_size = Common::AlignUp(size, HugePageSize);
+    void* huge = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (huge != MAP_FAILED) {
+        base = static_cast<u8*>(huge);
+        large_pages = true;
+        LOG_INFO(Common_Memory, "Allocated {:#x} bytes of huge pages", mapped_size);
+        return;
+    }
+#endif
+
+    // Transparent huge pages can only back the ranges aligned to them, so align the block by
+    // reserving a huge page more and trimming the excess on both sides
+    const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    mapped_size = Common::AlignUp(size, page_size);
+    const std::size_t reserved_size = mapped_size + HugePageSize;
+    void* reserved =
+        mmap(nullptr, reserved_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Unable to allocate {:#x} bytes of memory", size);
+        return;
+    }
+    u8* const reserved_base = static_cast<u8*>(reserved);
+    base = reinterpret_cast<u8*>(
+        Common::AlignUp(reinterpret_cast<std::uintptr_t>(reserved_base), HugePageSize));
+    const std::size_t head = static_cast<std::size_t>(base - reserved_base);
+    if (head != 0) {
+        munmap(reserved_base, head);
+    }
+    if (reserved_size - head > mapped_size) {
+        munmap(base + mapped_size, reserved_size - head - mapped_size);
+    }
+    AdviseHugePages(base, mapped_size);
+#endif
+}
+
+LargePageBuffer::~LargePageBuffer() {
+    if (!base) {
+        return;
+    }
+#ifdef _WIN32
+    VirtualFree(base, 0, MEM_RELEASE);
+#else
+    munmap(base, mapped_size);
+#endif
+}
+
+} // namespace Common
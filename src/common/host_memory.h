@@ -0,0 +1,126 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * A block of shared host memory whose pages can be aliased into any number of VirtualArena
+ * reservations. This lets the emulated RAM also be exposed as a flat guest address space.
+ */
+class HostMemory {
+public:
+    explicit HostMemory(std::size_t backing_size);
+    ~HostMemory();
+
+    HostMemory(const HostMemory&) = delete;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    /// Returns true if the backing memory was successfully allocated.
+    [[nodiscard]] bool IsValid() const noexcept {
+        return backing_base != nullptr;
+    }
+
+    /// Returns the offset of pointer into the backing memory, or nullopt if it lies outside it.
+    [[nodiscard]] std::optional<std::size_t> OffsetOf(const u8* pointer) const noexcept {
+        if (pointer < backing_base || pointer >= backing_base + backing_size) {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>(pointer - backing_base);
+    }
+
+    [[nodiscard]] u8* BackingBasePointer() noexcept {
+        return backing_base;
+    }
+
+    [[nodiscard]] const u8* BackingBasePointer() const noexcept {
+        return backing_base;
+    }
+
+private:
+    friend class VirtualArena;
+
+    std::size_t backing_size{};
+    u8* backing_base{};
+    int fd{-1};
+};
+
+/**
+ * A reservation of host address space where ranges of a HostMemory can be mapped. Ranges that
+ * are not mapped are inaccessible, so any host access to them faults.
+ */
+class VirtualArena {
+public:
+    explicit VirtualArena(HostMemory& backing, std::size_t virtual_size);
+    ~VirtualArena();
+
+    VirtualArena(const VirtualArena&) = delete;
+    VirtualArena& operator=(const VirtualArena&) = delete;
+
+    /// Returns true if the address space was successfully reserved.
+    [[nodiscard]] bool IsValid() const noexcept {
+        return virtual_base != nullptr;
+    }
+
+    /// Maps length bytes of the backing memory at backing_offset to virtual_offset.
+    void Map(std::size_t virtual_offset, std::size_t backing_offset, std::size_t length);
+
+    /// Makes length bytes at virtual_offset inaccessible again.
+    void Unmap(std::size_t virtual_offset, std::size_t length);
+
+    [[nodiscard]] u8* VirtualBasePointer() noexcept {
+        return virtual_base;
+    }
+
+private:
+    HostMemory& backing;
+    std::size_t virtual_size{};
+    u8* virtual_base{};
+};
+
+/**
+ * A zeroed block of private host memory backed by large pages where the host permits it, to cut
+ * down on TLB misses when a large block is accessed randomly, like the emulated RAM. Explicit
+ * large pages are used when the host has them reserved, otherwise the memory is aligned and
+ * marked for transparent huge pages. Falls back to regular pages everywhere else.
+ */
+class LargePageBuffer {
+public:
+    explicit LargePageBuffer(std::size_t size);
+    ~LargePageBuffer();
+
+    LargePageBuffer(const LargePageBuffer&) = delete;
+    LargePageBuffer& operator=(const LargePageBuffer&) = delete;
+
+    /// Returns true if the memory was successfully allocated.
+    [[nodiscard]] bool IsValid() const noexcept {
+        return base != nullptr;
+    }
+
+    /// Returns true if the memory is backed by explicit large pages.
+    [[nodiscard]] bool UsesLargePages() const noexcept {
+        return large_pages;
+    }
+
+    [[nodiscard]] u8* Data() noexcept {
+        return base;
+    }
+
+    [[nodiscard]] std::size_t Size() const noexcept {
+        return size;
+    }
+
+private:
+    std::size_t size{};
+    std::size_t mapped_size{};
+    u8* base{};
+    bool large_pages{};
+};
+
+} // namespace Common
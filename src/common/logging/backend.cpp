@@ -4,6 +4,7 @@
 
 #include <chrono>
 
+#include <fmt/args.h>
 #include <fmt/format.h>
 
 #ifdef _WIN32
@@ -181,6 +182,42 @@ public:
 
 bool initialization_in_progress_suppress_logging = true;
 
+/// Messages of a class written per second when formatting is deferred, errors are not limited
+constexpr u32 MaxMessagesPerSecond = 1000;
+
+/// Formats a message whose formatting was deferred to the backend thread.
+std::string FormatDeferredMessage(const char* format, const DeferredArgs& deferred_args) {
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    for (std::size_t i = 0; i < deferred_args.count; i++) {
+        const DeferredArg& arg = deferred_args.args[i];
+        switch (arg.type) {
+        case DeferredArg::Type::Bool:
+            store.push_back(arg.b);
+            break;
+        case DeferredArg::Type::Char:
+            store.push_back(arg.c);
+            break;
+        case DeferredArg::Type::Int:
+            store.push_back(arg.i);
+            break;
+        case DeferredArg::Type::UInt:
+            store.push_back(arg.u);
+            break;
+        case DeferredArg::Type::Float:
+            store.push_back(arg.f);
+            break;
+        case DeferredArg::Type::Double:
+            store.push_back(arg.d);
+            break;
+        }
+    }
+    try {
+        return fmt::vformat(format, store);
+    } catch (const fmt::format_error& e) {
+        return fmt::format("Invalid format string \"{}\": {}", format, e.what());
+    }
+}
+
 #ifdef CITRA_LINUX_GCC_BACKTRACE
 [[noreturn]] void SleepForever() {
     while (true) {
@@ -213,6 +250,7 @@ public:
         filter.ParseFilterString(Settings::values.log_filter.GetValue());
         instance = std::unique_ptr<Impl, decltype(&Deleter)>(
             new Impl(fmt::format("{}{}", log_dir, log_file), filter), Deleter);
+        instance->SetDeferredFormatting(Settings::values.log_deferred_formatting.GetValue());
         initialization_in_progress_suppress_logging = false;
     }
 
@@ -238,13 +276,33 @@ public:
         color_console_backend.SetEnabled(enabled);
     }
 
+    void SetDeferredFormatting(bool enabled) {
+        deferred_formatting = enabled;
+    }
+
     void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
-                   const char* function, std::string message) {
+                   const char* function, const char* format, const fmt::format_args& args,
+                   const DeferredArgs* deferred_args) {
         if (!filter.CheckMessage(log_class, log_level)) {
             return;
         }
-        message_queue.EmplaceWait(
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+        if (!deferred_formatting.load(std::memory_order_relaxed)) {
+            message_queue.EmplaceWait(CreateEntry(log_class, log_level, filename, line_num,
+                                                  function, fmt::vformat(format, args)));
+            return;
+        }
+
+        Entry entry = CreateEntry(log_class, log_level, filename, line_num, function, {});
+        if (!CheckRateLimit(entry)) {
+            return;
+        }
+        if (deferred_args) {
+            entry.format = format;
+            entry.args = *deferred_args;
+        } else {
+            entry.message = fmt::vformat(format, args);
+        }
+        message_queue.EmplaceWait(std::move(entry));
     }
 
 private:
@@ -319,9 +377,16 @@ private:
             const auto write_logs = [this, &entry]() {
                 ForEachBackend([&entry](Backend& backend) { backend.Write(entry); });
             };
+            const auto format_message = [&entry] {
+                if (entry.format != nullptr) {
+                    entry.message = FormatDeferredMessage(entry.format, entry.args);
+                    entry.format = nullptr;
+                }
+            };
             while (!stop_token.stop_requested()) {
                 message_queue.PopWait(entry, stop_token);
                 if (entry.filename != nullptr) {
+                    format_message();
                     write_logs();
                 }
             }
@@ -329,6 +394,7 @@ private:
             // case where a system is repeatedly spamming logs even on close.
             int max_logs_to_write = filter.IsDebug() ? INT_MAX : 100;
             while (max_logs_to_write-- && message_queue.TryPop(entry)) {
+                format_message();
                 write_logs();
             }
         });
@@ -360,6 +426,35 @@ private:
         };
     }
 
+    /// Returns whether a message fits in the messages per second of its class. When a new second
+    /// starts, the number of messages dropped during the previous ones is logged.
+    bool CheckRateLimit(const Entry& entry) {
+        if (entry.log_level >= Level::Error) {
+            return true;
+        }
+
+        auto& limit = rate_limits[static_cast<std::size_t>(entry.log_class)];
+        using std::chrono::duration_cast;
+        using std::chrono::seconds;
+
+        const s64 second = duration_cast<seconds>(entry.timestamp).count();
+        s64 last_second = limit.second.load(std::memory_order_relaxed);
+        if (second != last_second && limit.second.compare_exchange_strong(last_second, second)) {
+            limit.count = 0;
+            if (const u32 dropped = limit.dropped.exchange(0); dropped != 0) {
+                message_queue.EmplaceWait(CreateEntry(
+                    entry.log_class, Level::Warning, TrimSourcePath(__FILE__), __LINE__, __func__,
+                    fmt::format("{} messages of this class were dropped by the rate limit",
+                                dropped)));
+            }
+        }
+        if (limit.count.fetch_add(1, std::memory_order_relaxed) < MaxMessagesPerSecond) {
+            return true;
+        }
+        limit.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
     void ForEachBackend(auto lambda) {
         lambda(static_cast<Backend&>(debugger_backend));
         lambda(static_cast<Backend&>(color_console_backend));
@@ -415,6 +510,15 @@ private:
 
     MPSCQueue<Entry> message_queue{};
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
+
+    /// Messages of a class pushed during the current second, only counted with deferred formatting
+    struct RateLimit {
+        std::atomic<s64> second{0};
+        std::atomic<u32> count{0};
+        std::atomic<u32> dropped{0};
+    };
+    std::atomic_bool deferred_formatting{false};
+    std::array<RateLimit, static_cast<std::size_t>(Class::Count)> rate_limits{};
     std::jthread backend_thread;
 
 #ifdef CITRA_LINUX_GCC_BACKTRACE
@@ -450,12 +554,16 @@ void SetColorConsoleBackendEnabled(bool enabled) {
     Impl::Instance().SetColorConsoleBackendEnabled(enabled);
 }
 
+void SetDeferredFormatting(bool enabled) {
+    Impl::Instance().SetDeferredFormatting(enabled);
+}
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
-                       const fmt::format_args& args) {
+                       const fmt::format_args& args, const DeferredArgs* deferred_args) {
     if (!initialization_in_progress_suppress_logging) {
-        Impl::Instance().PushEntry(log_class, log_level, filename, line_num, function,
-                                   fmt::vformat(format, args));
+        Impl::Instance().PushEntry(log_class, log_level, filename, line_num, function, format,
+                                   args, deferred_args);
     }
 }
 } // namespace Common::Log
@@ -27,4 +27,10 @@ void DisableLoggingInTests();
 void SetGlobalFilter(const Filter& filter);
 
 void SetColorConsoleBackendEnabled(bool enabled);
+
+/**
+ * Formats the messages with only numeric arguments on the backend thread instead of the thread
+ * logging them, and limits the messages of each class written per second, errors excepted.
+ */
+void SetDeferredFormatting(bool enabled);
 } // namespace Common::Log
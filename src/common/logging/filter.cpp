@@ -116,6 +116,7 @@ bool ParseFilterRule(Filter& instance, Iterator begin, Iterator end) {
     SUB(Service, PS)                                                                               \
     SUB(Service, PLGLDR)                                                                           \
     SUB(Service, NEWS)                                                                             \
+    SUB(Service, MVD)                                                                              \
     CLS(HW)                                                                                        \
     SUB(HW, Memory)                                                                                \
     SUB(HW, LCD)                                                                                   \
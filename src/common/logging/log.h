@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <array>
 #include <string_view>
+#include <type_traits>
 
 #include "common/logging/formatter.h"
 #include "common/logging/types.h"
@@ -22,16 +23,85 @@ constexpr const char* TrimSourcePath(std::string_view source) {
     return source.data() + idx;
 }
 
-/// Logs a message to the global logger, using fmt
+/// Maximum number of arguments of a message that can be formatted by the backend thread
+constexpr std::size_t MaxDeferredArgs = 8;
+
+/// An argument of a message, copied so that the message can be formatted later
+struct DeferredArg {
+    enum class Type : u8 {
+        Bool,
+        Char,
+        Int,
+        UInt,
+        Float,
+        Double,
+    };
+
+    Type type;
+    union {
+        bool b;
+        char c;
+        s64 i;
+        u64 u;
+        float f;
+        double d;
+    };
+};
+
+struct DeferredArgs {
+    std::array<DeferredArg, MaxDeferredArgs> args;
+    std::size_t count = 0;
+};
+
+/// Arguments that are formatted the same once copied to a DeferredArg
+template <typename T>
+constexpr bool IsDeferrable = std::is_arithmetic_v<T> && !std::is_same_v<T, long double>;
+
+template <typename T>
+DeferredArg MakeDeferredArg(T value) {
+    DeferredArg arg;
+    if constexpr (std::is_same_v<T, bool>) {
+        arg.type = DeferredArg::Type::Bool;
+        arg.b = value;
+    } else if constexpr (std::is_same_v<T, char>) {
+        arg.type = DeferredArg::Type::Char;
+        arg.c = value;
+    } else if constexpr (std::is_same_v<T, float>) {
+        arg.type = DeferredArg::Type::Float;
+        arg.f = value;
+    } else if constexpr (std::is_same_v<T, double>) {
+        arg.type = DeferredArg::Type::Double;
+        arg.d = value;
+    } else if constexpr (std::is_signed_v<T>) {
+        arg.type = DeferredArg::Type::Int;
+        arg.i = value;
+    } else {
+        arg.type = DeferredArg::Type::UInt;
+        arg.u = value;
+    }
+    return arg;
+}
+
+/**
+ * Logs a message to the global logger, using fmt. When deferred arguments are given and deferred
+ * formatting is enabled, the message is formatted on the backend thread instead of the calling
+ * one, in which case the format string must outlive the logger, like string literals do.
+ */
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
-                       const fmt::format_args& args);
+                       const fmt::format_args& args, const DeferredArgs* deferred_args);
 
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, const char* format, const Args&... args) {
-    FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
-                      fmt::make_format_args(args...));
+    if constexpr (sizeof...(Args) <= MaxDeferredArgs && (IsDeferrable<Args> && ...)) {
+        const DeferredArgs deferred_args{{MakeDeferredArg(args)...}, sizeof...(Args)};
+        FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
+                          fmt::make_format_args(args...), &deferred_args);
+    } else {
+        FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
+                          fmt::make_format_args(args...), nullptr);
+    }
 }
 
 } // namespace Common::Log
@@ -6,7 +6,7 @@
 
 #include <chrono>
 
-#include "common/logging/types.h"
+#include "common/logging/log.h"
 
 namespace Common::Log {
 
@@ -20,8 +20,11 @@ struct Entry {
     Level log_level{};
     const char* filename = nullptr;
     u32 line_num = 0;
-    std::string function;
+    const char* function = nullptr;
     std::string message;
+    /// Format string and arguments of the message, when it is formatted by the backend thread
+    const char* format = nullptr;
+    DeferredArgs args;
 };
 
 } // namespace Common::Log
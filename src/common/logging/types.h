@@ -83,6 +83,7 @@ enum class Class : u8 {
     Service_PS,      ///< The PS (Process) service
     Service_PLGLDR,  ///< The PLGLDR (plugin loader) service
     Service_NEWS,    ///< The NEWS (Notifications) service
+    Service_MVD,     ///< The MVD (Video decoding) service
     HW,              ///< Low-level hardware emulation
     HW_Memory,       ///< Memory-map and address translation
     HW_LCD,          ///< LCD register emulation
@@ -0,0 +1,127 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/mapped_file.h"
+
+namespace Common {
+
+#ifndef _WIN32
+namespace {
+
+/// Returns the range of host pages covering length bytes at address.
+std::pair<u8*, std::size_t> PageRange(const u8* address, std::size_t length) {
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(address) & ~(page_size - 1);
+    const uintptr_t end =
+        (reinterpret_cast<uintptr_t>(address) + length + page_size - 1) & ~(page_size - 1);
+    return {reinterpret_cast<u8*>(begin), static_cast<std::size_t>(end - begin)};
+}
+
+} // Anonymous namespace
+#endif
+
+MappedFile::MappedFile([[maybe_unused]] const FileUtil::IOFile& file, [[maybe_unused]] u64 offset,
+                       [[maybe_unused]] std::size_t size_) {
+#ifdef _WIN32
+    LOG_DEBUG(Common_Filesystem, "File mappings are not supported on this platform");
+#else
+    // Accessing the pages past the end of the file would fault
+    if (size_ == 0 || !file.IsOpen() || file.IsCompressed() || offset + size_ > file.GetSize()) {
+        return;
+    }
+
+    const auto page_size = static_cast<u64>(sysconf(_SC_PAGESIZE));
+    const u64 aligned_offset = offset & ~(page_size - 1);
+    const std::size_t delta = static_cast<std::size_t>(offset - aligned_offset);
+    void* const mapping = mmap(nullptr, size_ + delta, PROT_READ, MAP_SHARED, file.GetFd(),
+                               static_cast<off_t>(aligned_offset));
+    if (mapping == MAP_FAILED) {
+        LOG_WARNING(Common_Filesystem, "Unable to map {:#x} bytes at offset {:#x}", size_,
+                    offset);
+        return;
+    }
+    base = static_cast<u8*>(mapping);
+    map_size = size_ + delta;
+    data = base + delta;
+    size = size_;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    Unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : base{std::exchange(other.base, nullptr)}, map_size{std::exchange(other.map_size, 0)},
+      data{std::exchange(other.data, nullptr)}, size{std::exchange(other.size, 0)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Unmap();
+        base = std::exchange(other.base, nullptr);
+        map_size = std::exchange(other.map_size, 0);
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+void MappedFile::Unmap() {
+#ifndef _WIN32
+    if (base != nullptr) {
+        munmap(base, map_size);
+    }
+#endif
+    base = nullptr;
+    map_size = 0;
+    data = nullptr;
+    size = 0;
+}
+
+void MappedFile::Prefetch(std::size_t offset, std::size_t length) const {
+#ifndef _WIN32
+    if (!IsValid() || offset >= size) {
+        return;
+    }
+    const auto [begin, range] = PageRange(data + offset, std::min(length, size - offset));
+    madvise(begin, range, MADV_WILLNEED);
+#endif
+}
+
+bool MappedFile::IsResident(std::size_t offset, std::size_t length) const {
+#ifdef _WIN32
+    return false;
+#else
+    if (!IsValid() || offset >= size) {
+        return false;
+    }
+    const auto [begin, range] = PageRange(data + offset, std::min(length, size - offset));
+#ifdef __APPLE__
+    std::vector<char> residency(range / static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+#else
+    std::vector<unsigned char> residency(range / static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+#endif
+    if (mincore(begin, range, residency.data()) != 0) {
+        return false;
+    }
+    for (const auto page : residency) {
+        if ((page & 1) == 0) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+} // namespace Common
@@ -0,0 +1,67 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include "common/common_types.h"
+
+namespace FileUtil {
+class IOFile;
+}
+
+namespace Common {
+
+/**
+ * A read-only mapping of a range of a file. Reads from it are served straight from the page cache
+ * of the host, without a system call or a copy through an intermediate buffer.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /**
+     * Maps size bytes of a file starting at offset. The mapping is invalid if it failed, if the
+     * range is not within the file, if the file is decompressed on the fly, or if the platform
+     * does not support it.
+     */
+    MappedFile(const FileUtil::IOFile& file, u64 offset, std::size_t size);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// Returns true if the range of the file was successfully mapped.
+    [[nodiscard]] bool IsValid() const noexcept {
+        return data != nullptr;
+    }
+
+    [[nodiscard]] std::span<const u8> Data() const noexcept {
+        return {data, size};
+    }
+
+    /// Starts reading a range of the mapping from the disk in the background.
+    void Prefetch(std::size_t offset, std::size_t length) const;
+
+    /// Returns true if a range of the mapping is in host memory, so that reading it does not wait
+    /// for the disk.
+    [[nodiscard]] bool IsResident(std::size_t offset, std::size_t length) const;
+
+private:
+    void Unmap();
+
+    /// Start of the mapping, aligned down to a host page
+    u8* base{};
+    std::size_t map_size{};
+
+    const u8* data{};
+    std::size_t size{};
+};
+
+} // namespace Common
@@ -0,0 +1,142 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#ifdef __linux__
+#include <fstream>
+#include <sstream>
+#endif
+#include "common/literals.h"
+#include "common/logging/log.h"
+#include "common/memory_budget.h"
+#include "common/memory_detect.h"
+
+namespace Common {
+
+namespace {
+
+using namespace Common::Literals;
+
+constexpr auto PollInterval = std::chrono::seconds{1};
+
+const char* PressureName(MemoryPressure pressure) {
+    switch (pressure) {
+    case MemoryPressure::None:
+        return "none";
+    case MemoryPressure::Moderate:
+        return "moderate";
+    case MemoryPressure::Critical:
+        return "critical";
+    }
+    return "unknown";
+}
+
+#ifdef __linux__
+/// Returns the share of time, in percent, some or all tasks stalled on memory in the last 10s
+std::pair<double, double> ReadPressureStall() {
+    std::ifstream file{"/proc/pressure/memory"};
+    double some = 0.0;
+    double full = 0.0;
+    std::string line;
+    while (std::getline(file, line)) {
+        // Lines are like "some avg10=0.00 avg60=0.00 avg300=0.00 total=0"
+        std::istringstream stream{line};
+        std::string kind;
+        std::string avg10;
+        stream >> kind >> avg10;
+        if (!avg10.starts_with("avg10=")) {
+            continue;
+        }
+        const double value = std::strtod(avg10.c_str() + 6, nullptr);
+        (kind == "full" ? full : some) = value;
+    }
+    return {some, full};
+}
+#endif
+
+} // Anonymous namespace
+
+MemoryBudget& MemoryBudget::Instance() {
+    static MemoryBudget instance;
+    return instance;
+}
+
+MemoryBudget::MemoryBudget() : total_memory{GetMemInfo().total_physical_memory} {
+    // A quarter of the host memory leaves room for the emulated FCRAM, the driver and the rest of
+    // the system, which matters on phones with 3 or 4 GiB shared with the GPU.
+    cache_budget = std::max<u64>(total_memory / 4, 256_MiB);
+}
+
+std::size_t MemoryBudget::AddCache(std::string_view name, Priority priority,
+                                   TrimCallback&& callback) {
+    std::scoped_lock lock{mutex};
+    const std::size_t handle = next_handle++;
+    const auto it = std::ranges::upper_bound(caches, priority, {}, &Cache::priority);
+    caches.insert(it, Cache{handle, std::string{name}, priority, std::move(callback)});
+    return handle;
+}
+
+void MemoryBudget::RemoveCache(std::size_t handle) {
+    std::scoped_lock lock{mutex};
+    std::erase_if(caches, [handle](const Cache& cache) { return cache.handle == handle; });
+}
+
+void MemoryBudget::ReportPressure(MemoryPressure reported) {
+    MemoryPressure current = reported_pressure.load(std::memory_order_relaxed);
+    while (current < reported &&
+           !reported_pressure.compare_exchange_weak(current, reported, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryBudget::Update() {
+    MemoryPressure level = reported_pressure.exchange(MemoryPressure::None);
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= next_poll) {
+        next_poll = now + PollInterval;
+        level = std::max(level, PollPressure());
+    } else if (level == MemoryPressure::None) {
+        return;
+    }
+    pressure.store(level, std::memory_order_relaxed);
+    if (level == MemoryPressure::None) {
+        return;
+    }
+
+    // Under moderate pressure an eighth of the budget is enough to get some headroom back
+    const u64 target = level == MemoryPressure::Critical ? ~u64{0} : cache_budget / 8;
+    u64 released = 0;
+    std::scoped_lock lock{mutex};
+    for (const Cache& cache : caches) {
+        const u64 cache_released = cache.callback(level);
+        LOG_DEBUG(Common_Memory, "Released {} KiB of {} for {} memory pressure",
+                  cache_released / 1_KiB, cache.name, PressureName(level));
+        released += cache_released;
+        if (released >= target) {
+            break;
+        }
+    }
+    LOG_INFO(Common_Memory, "Released {} MiB of caches for {} memory pressure", released / 1_MiB,
+             PressureName(level));
+}
+
+MemoryPressure MemoryBudget::PollPressure() const {
+    const u64 available = GetMemInfo().available_physical_memory;
+    MemoryPressure level = MemoryPressure::None;
+    if (available != 0 && available < total_memory / 20) {
+        level = MemoryPressure::Critical;
+    } else if (available != 0 && available < total_memory / 10) {
+        level = MemoryPressure::Moderate;
+    }
+#ifdef __linux__
+    const auto [some, full] = ReadPressureStall();
+    if (full >= 10.0) {
+        level = MemoryPressure::Critical;
+    } else if (some >= 20.0) {
+        level = std::max(level, MemoryPressure::Moderate);
+    }
+#endif
+    return level;
+}
+
+} // namespace Common
@@ -0,0 +1,94 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common {
+
+enum class MemoryPressure : u32 {
+    None,
+    Moderate, ///< Memory is getting low, the caches should drop what is cheap to rebuild
+    Critical, ///< The process is about to be killed, the caches should drop all they can
+};
+
+/**
+ * Sizes the large caches from the host memory and asks them to shrink when the host runs low on
+ * memory. The pressure is either reported by the frontend, like onTrimMemory on Android, or
+ * polled from the available memory and the Linux pressure stall information. The caches are asked
+ * in order of priority, the ones cheapest to rebuild first, and under moderate pressure only until
+ * enough was released.
+ */
+class MemoryBudget {
+public:
+    /// Releases memory of a cache for the pressure, returns the number of bytes released
+    using TrimCallback = std::function<u64(MemoryPressure)>;
+
+    /// Priorities of the caches, the lower ones are asked to shrink first
+    enum class Priority : u32 {
+        RomFS,
+        CustomTextures,
+        Surfaces,
+    };
+
+    static MemoryBudget& Instance();
+
+    /// Returns the number of bytes the large caches should use together at most
+    [[nodiscard]] u64 CacheBudget() const {
+        return cache_budget;
+    }
+
+    /// Returns the pressure of the last update
+    [[nodiscard]] MemoryPressure Pressure() const {
+        return pressure.load(std::memory_order_relaxed);
+    }
+
+    /// Registers a cache to shrink under pressure, returns its handle
+    std::size_t AddCache(std::string_view name, Priority priority, TrimCallback&& callback);
+
+    /// Unregisters the cache with the handle
+    void RemoveCache(std::size_t handle);
+
+    /// Reports pressure signalled by the host, it is handled on the next update. Thread safe.
+    void ReportPressure(MemoryPressure reported);
+
+    /**
+     * Polls the host memory and asks the caches to shrink when it is under pressure. Called once
+     * per frame while the GPU is idle, so that the caches can be trimmed right away.
+     */
+    void Update();
+
+private:
+    struct Cache {
+        std::size_t handle;
+        std::string name;
+        Priority priority;
+        TrimCallback callback;
+    };
+
+    MemoryBudget();
+
+    /// Returns the pressure from the available memory and the pressure stall information
+    MemoryPressure PollPressure() const;
+
+    u64 total_memory{};
+    u64 cache_budget{};
+    std::atomic<MemoryPressure> reported_pressure{MemoryPressure::None};
+    std::atomic<MemoryPressure> pressure{MemoryPressure::None};
+    std::chrono::steady_clock::time_point next_poll{};
+
+    std::mutex mutex;
+    std::vector<Cache> caches;
+    std::size_t next_handle{};
+};
+
+} // namespace Common
@@ -12,6 +12,8 @@
 #if defined(__APPLE__) || defined(__FreeBSD__)
 #include <sys/sysctl.h>
 #elif defined(__linux__)
+#include <fstream>
+#include <string>
 #include <sys/sysinfo.h>
 #endif
 #endif
@@ -20,6 +22,20 @@
 
 namespace Common {
 
+#ifdef __linux__
+/// Returns the MemAvailable estimate of the kernel in bytes, zero if it is not known
+static u64 ReadAvailableMemory() {
+    std::ifstream file{"/proc/meminfo"};
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.starts_with("MemAvailable:")) {
+            return std::strtoull(line.c_str() + 13, nullptr, 10) * 1024;
+        }
+    }
+    return 0;
+}
+#endif
+
 // Detects the RAM and Swapfile sizes
 const MemoryInfo GetMemInfo() {
     MemoryInfo mem_info{};
@@ -30,6 +46,7 @@ const MemoryInfo GetMemInfo() {
     GlobalMemoryStatusEx(&memorystatus);
     mem_info.total_physical_memory = memorystatus.ullTotalPhys;
     mem_info.total_swap_memory = memorystatus.ullTotalPageFile - mem_info.total_physical_memory;
+    mem_info.available_physical_memory = memorystatus.ullAvailPhys;
 #elif defined(__APPLE__)
     u64 ramsize;
     struct xsw_usage vmusage;
@@ -53,8 +70,14 @@ const MemoryInfo GetMemInfo() {
 #elif defined(__linux__)
     struct sysinfo meminfo;
     sysinfo(&meminfo);
-    mem_info.total_physical_memory = meminfo.totalram;
-    mem_info.total_swap_memory = meminfo.totalswap;
+    mem_info.total_physical_memory = u64{meminfo.totalram} * meminfo.mem_unit;
+    mem_info.total_swap_memory = u64{meminfo.totalswap} * meminfo.mem_unit;
+    // The free memory does not count the page cache, which is dropped before processes are killed
+    mem_info.available_physical_memory = ReadAvailableMemory();
+    if (mem_info.available_physical_memory == 0) {
+        mem_info.available_physical_memory =
+            (u64{meminfo.freeram} + meminfo.bufferram) * meminfo.mem_unit;
+    }
 #else
     mem_info.total_physical_memory = sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGE_SIZE);
     mem_info.total_swap_memory = 0;
@@ -11,11 +11,13 @@ namespace Common {
 struct MemoryInfo {
     u64 total_physical_memory{};
     u64 total_swap_memory{};
+    u64 available_physical_memory{}; ///< Zero when the host does not report it
 };
 
 /**
  * Gets the memory info of the host system
- * @return Reference to a MemoryInfo struct with the physical and swap memory sizes in bytes
+ * @return Reference to a MemoryInfo struct with the physical and swap memory sizes in bytes, and
+ * the physical memory still available
  */
 [[nodiscard]] const MemoryInfo GetMemInfo();
 
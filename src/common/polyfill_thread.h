@@ -12,6 +12,7 @@
 
 #ifdef __cpp_lib_jthread
 
+#include <chrono>
 #include <stop_token>
 #include <thread>
 
@@ -22,11 +23,18 @@ void CondvarWait(Condvar& cv, Lock& lock, std::stop_token token, Pred&& pred) {
     cv.wait(lock, token, std::move(pred));
 }
 
+template <typename Condvar, typename Lock, typename Clock, typename Duration, typename Pred>
+bool CondvarWaitUntil(Condvar& cv, Lock& lock, std::stop_token token,
+                      const std::chrono::time_point<Clock, Duration>& abs_time, Pred&& pred) {
+    return cv.wait_until(lock, token, abs_time, std::move(pred));
+}
+
 } // namespace Common
 
 #else
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
@@ -333,6 +341,18 @@ void CondvarWait(Condvar& cv, Lock& lock, std::stop_token token, Pred pred) {
     cv.wait(lock, [&] { return pred() || token.stop_requested(); });
 }
 
+template <typename Condvar, typename Lock, typename Clock, typename Duration, typename Pred>
+bool CondvarWaitUntil(Condvar& cv, Lock& lock, std::stop_token token,
+                      const std::chrono::time_point<Clock, Duration>& abs_time, Pred pred) {
+    if (token.stop_requested()) {
+        return pred();
+    }
+
+    std::stop_callback callback(token, [&] { cv.notify_all(); });
+    cv.wait_until(lock, abs_time, [&] { return pred() || token.stop_requested(); });
+    return pred();
+}
+
 } // namespace Common
 
 #endif // __cpp_lib_jthread
@@ -33,6 +33,8 @@ std::string_view GetGraphicsAPIName(GraphicsAPI api) {
         return "OpenGL";
     case GraphicsAPI::Vulkan:
         return "Vulkan";
+    case GraphicsAPI::Null:
+        return "Null";
     default:
         return "Invalid";
     }
@@ -70,6 +72,19 @@ std::string_view GetTextureSamplingName(TextureSampling sampling) {
     }
 }
 
+std::string_view GetSpatialUpscalingName(SpatialUpscaling upscaling) {
+    switch (upscaling) {
+    case SpatialUpscaling::Off:
+        return "Off";
+    case SpatialUpscaling::Smooth:
+        return "Smooth";
+    case SpatialUpscaling::Sharp:
+        return "Sharp";
+    default:
+        return "Invalid";
+    }
+}
+
 } // Anonymous namespace
 
 Values values = {};
@@ -83,12 +98,21 @@ void LogSettings() {
     LOG_INFO(Config, "Citra Configuration:");
     log_setting("Core_UseCpuJit", values.use_cpu_jit.GetValue());
     log_setting("Core_CPUClockPercentage", values.cpu_clock_percentage.GetValue());
+    log_setting("Core_UseFastmem", values.use_fastmem.GetValue());
+    log_setting("Core_UseMultiCore", values.use_multi_core.GetValue());
+    log_setting("Core_RewindBufferSize", values.rewind_buffer_size.GetValue());
+    log_setting("Core_RewindInterval", values.rewind_interval.GetValue());
+    log_setting("Core_UseBootSnapshot", values.use_boot_snapshot.GetValue());
+    log_setting("Core_BootSnapshotFrames", values.boot_snapshot_frames.GetValue());
+    log_setting("Core_EmulateFsDelay", values.emulate_fs_delay.GetValue());
+    log_setting("Core_ThreadPolicy", static_cast<u32>(values.thread_policy.GetValue()));
     log_setting("Renderer_UseGLES", values.use_gles.GetValue());
     log_setting("Renderer_GraphicsAPI", GetGraphicsAPIName(values.graphics_api.GetValue()));
     log_setting("Renderer_AsyncShaders", values.async_shader_compilation.GetValue());
     log_setting("Renderer_AsyncPresentation", values.async_presentation.GetValue());
     log_setting("Renderer_SpirvShaderGen", values.spirv_shader_gen.GetValue());
     log_setting("Renderer_Debug", values.renderer_debug.GetValue());
+    log_setting("Renderer_GpuProfiling", values.gpu_profiling.GetValue());
     log_setting("Renderer_UseHwShader", values.use_hw_shader.GetValue());
     log_setting("Renderer_ShadersAccurateMul", values.shaders_accurate_mul.GetValue());
     log_setting("Renderer_UseShaderJit", values.use_shader_jit.GetValue());
@@ -100,6 +124,26 @@ void LogSettings() {
     log_setting("Renderer_TextureFilter", GetTextureFilterName(values.texture_filter.GetValue()));
     log_setting("Renderer_TextureSampling",
                 GetTextureSamplingName(values.texture_sampling.GetValue()));
+    log_setting("Renderer_AsyncGpu", values.async_gpu.GetValue());
+    log_setting("Renderer_VertexCacheSize", values.vertex_cache_size.GetValue());
+    log_setting("Renderer_ParallelVertexShading", values.parallel_vertex_shading.GetValue());
+    log_setting("Renderer_GpuTextureDecode", values.gpu_texture_decode.GetValue());
+    log_setting("Renderer_GpuY2RConversion", values.gpu_y2r_conversion.GetValue());
+    log_setting("Renderer_AsyncSurfaceReadback", values.async_surface_readback.GetValue());
+    log_setting("Renderer_FramePacing", values.frame_pacing.GetValue());
+    log_setting("Renderer_LowLatencyPresentation", values.low_latency_presentation.GetValue());
+    log_setting("Renderer_UbershaderFallback", values.ubershader_fallback.GetValue());
+    log_setting("Renderer_ParallelCommandRecording", values.parallel_command_recording.GetValue());
+    log_setting("Renderer_TextureMemoryBudget", values.texture_memory_budget.GetValue());
+    log_setting("Renderer_DeduplicateTextureUploads",
+                values.deduplicate_texture_uploads.GetValue());
+    log_setting("Renderer_DynamicResolution", values.dynamic_resolution.GetValue());
+    log_setting("Renderer_AdaptiveTargetScale", values.adaptive_target_scale.GetValue());
+    log_setting("Renderer_SpatialUpscaling",
+                GetSpatialUpscalingName(values.spatial_upscaling.GetValue()));
+    log_setting("Renderer_FrameSkip", values.frame_skip.GetValue());
+    log_setting("Renderer_TurboMode", values.turbo_mode.GetValue());
+    log_setting("Renderer_PerfOverlay", values.perf_overlay.GetValue());
     log_setting("Stereoscopy_Render3d", values.render_3d.GetValue());
     log_setting("Stereoscopy_Factor3d", values.factor_3d.GetValue());
     log_setting("Stereoscopy_MonoRenderOption", values.mono_render_option.GetValue());
@@ -115,12 +159,17 @@ void LogSettings() {
     log_setting("Utility_PreloadTextures", values.preload_textures.GetValue());
     log_setting("Utility_AsyncCustomLoading", values.async_custom_loading.GetValue());
     log_setting("Utility_UseDiskShaderCache", values.use_disk_shader_cache.GetValue());
+    log_setting("Utility_CompressCustomTextures", values.compress_custom_textures.GetValue());
     log_setting("Audio_Emulation", GetAudioEmulationName(values.audio_emulation.GetValue()));
     log_setting("Audio_OutputType", values.output_type.GetValue());
     log_setting("Audio_OutputDevice", values.output_device.GetValue());
+    log_setting("Audio_BufferSize", values.audio_buffer_size.GetValue());
+    log_setting("Audio_Latency", values.audio_latency.GetValue());
     log_setting("Audio_InputType", values.input_type.GetValue());
     log_setting("Audio_InputDevice", values.input_device.GetValue());
     log_setting("Audio_EnableAudioStretching", values.enable_audio_stretching.GetValue());
+    log_setting("Audio_StretchingQuality",
+                static_cast<u32>(values.audio_stretching_quality.GetValue()));
     using namespace Service::CAM;
     log_setting("Camera_OuterRightName", values.camera_name[OuterRightCamera]);
     log_setting("Camera_OuterRightConfig", values.camera_config[OuterRightCamera]);
@@ -133,6 +182,7 @@ void LogSettings() {
     log_setting("Camera_OuterLeftFlip", values.camera_flip[OuterLeftCamera]);
     log_setting("DataStorage_UseVirtualSd", values.use_virtual_sd.GetValue());
     log_setting("DataStorage_UseCustomStorage", values.use_custom_storage.GetValue());
+    log_setting("DataStorage_RomFSCacheSize", values.romfs_cache_size.GetValue());
     if (values.use_custom_storage) {
         log_setting("DataStorage_SdmcDir", FileUtil::GetUserPath(FileUtil::UserPath::SDMCDir));
         log_setting("DataStorage_NandDir", FileUtil::GetUserPath(FileUtil::UserPath::NANDDir));
@@ -171,12 +221,14 @@ void RestoreGlobalState(bool is_powered_on) {
     // Audio
     values.audio_emulation.SetGlobal(true);
     values.enable_audio_stretching.SetGlobal(true);
+    values.audio_stretching_quality.SetGlobal(true);
     values.volume.SetGlobal(true);
 
     // Core
     values.cpu_clock_percentage.SetGlobal(true);
     values.is_new_3ds.SetGlobal(true);
     values.lle_applets.SetGlobal(true);
+    values.emulate_fs_delay.SetGlobal(true);
 
     // Renderer
     values.graphics_api.SetGlobal(true);
@@ -207,6 +259,7 @@ void RestoreGlobalState(bool is_powered_on) {
     values.dump_textures.SetGlobal(true);
     values.custom_textures.SetGlobal(true);
     values.preload_textures.SetGlobal(true);
+    values.ubershader_fallback.SetGlobal(true);
 }
 
 void LoadProfile(int index) {
@@ -21,6 +21,7 @@ enum class GraphicsAPI {
     Software = 0,
     OpenGL = 1,
     Vulkan = 2,
+    Null = 3,
 };
 
 enum class InitClock : u32 {
@@ -28,6 +29,12 @@ enum class InitClock : u32 {
     FixedTime = 1,
 };
 
+enum class ThreadPolicy : u32 {
+    System = 0,              ///< Leave the scheduling of the threads to the OS
+    Priority = 1,            ///< Prioritize the threads by their role
+    PriorityAndAffinity = 2, ///< Also keep each role on the host cores suited to it
+};
+
 enum class InitTicks : u32 {
     Random = 0,
     Fixed = 1,
@@ -73,6 +80,12 @@ enum class AudioEmulation : u32 {
     LLEMultithreaded = 2,
 };
 
+enum class AudioStretchingQuality : u32 {
+    Low = 0,
+    Medium = 1,
+    High = 2,
+};
+
 enum class TextureFilter : u32 {
     None = 0,
     Anime4K = 1,
@@ -88,6 +101,12 @@ enum class TextureSampling : u32 {
     Linear = 2,
 };
 
+enum class SpatialUpscaling : u32 {
+    Off = 0,
+    Smooth = 1,
+    Sharp = 2,
+};
+
 namespace NativeButton {
 
 enum Values {
@@ -430,13 +449,22 @@ struct Values {
 
     // Core
     Setting<bool> use_cpu_jit{true, "use_cpu_jit"};
+    Setting<bool> use_fastmem{false, "use_fastmem"};
+    Setting<bool> use_multi_core{false, "use_multi_core"};
     SwitchableSetting<s32, true> cpu_clock_percentage{100, 5, 400, "cpu_clock_percentage"};
     SwitchableSetting<bool> is_new_3ds{true, "is_new_3ds"};
     SwitchableSetting<bool> lle_applets{false, "lle_applets"};
+    Setting<u32> rewind_buffer_size{0, "rewind_buffer_size"};
+    Setting<u32> rewind_interval{500, "rewind_interval"};
+    SwitchableSetting<bool> use_boot_snapshot{false, "use_boot_snapshot"};
+    SwitchableSetting<bool> emulate_fs_delay{true, "emulate_fs_delay"};
+    Setting<u32> boot_snapshot_frames{600, "boot_snapshot_frames"};
+    Setting<ThreadPolicy> thread_policy{ThreadPolicy::Priority, "thread_policy"};
 
     // Data Storage
     Setting<bool> use_virtual_sd{true, "use_virtual_sd"};
     Setting<bool> use_custom_storage{false, "use_custom_storage"};
+    Setting<u32> romfs_cache_size{8, "romfs_cache_size"};
 
     // System
     SwitchableSetting<s32> region_value{REGION_VALUE_AUTO_SELECT, "region_value"};
@@ -457,23 +485,41 @@ struct Values {
 #elif defined(ENABLE_SOFTWARE_RENDERER)
         GraphicsAPI::Software,
 #else
-// TODO: Add a null renderer backend for this, perhaps.
-#error "At least one renderer must be enabled."
+        GraphicsAPI::Null,
 #endif
-            GraphicsAPI::Software, GraphicsAPI::Vulkan, "graphics_api"
+            GraphicsAPI::Software, GraphicsAPI::Null, "graphics_api"
     };
     SwitchableSetting<u32> physical_device{0, "physical_device"};
     Setting<bool> use_gles{false, "use_gles"};
     Setting<bool> renderer_debug{false, "renderer_debug"};
     Setting<bool> dump_command_buffers{false, "dump_command_buffers"};
+    Setting<bool> gpu_profiling{false, "gpu_profiling"};
     SwitchableSetting<bool> spirv_shader_gen{true, "spirv_shader_gen"};
     SwitchableSetting<bool> async_shader_compilation{false, "async_shader_compilation"};
+    SwitchableSetting<bool> ubershader_fallback{false, "ubershader_fallback"};
     SwitchableSetting<bool> async_presentation{true, "async_presentation"};
+    Setting<bool> async_gpu{false, "async_gpu"};
     SwitchableSetting<bool> use_hw_shader{true, "use_hw_shader"};
     SwitchableSetting<bool> use_disk_shader_cache{true, "use_disk_shader_cache"};
     SwitchableSetting<bool> shaders_accurate_mul{true, "shaders_accurate_mul"};
     SwitchableSetting<bool> use_vsync_new{true, "use_vsync_new"};
+    Setting<bool> frame_pacing{false, "frame_pacing"};
+    Setting<bool> low_latency_presentation{false, "low_latency_presentation"};
+    Setting<bool> parallel_command_recording{false, "parallel_command_recording"};
     Setting<bool> use_shader_jit{true, "use_shader_jit"};
+    Setting<u32, true> vertex_cache_size{8192, 16, 65536, "vertex_cache_size"};
+    Setting<bool> parallel_vertex_shading{true, "parallel_vertex_shading"};
+    Setting<bool> gpu_texture_decode{false, "gpu_texture_decode"};
+    Setting<bool> gpu_y2r_conversion{false, "gpu_y2r_conversion"};
+    Setting<bool> async_surface_readback{false, "async_surface_readback"};
+    Setting<u32> texture_memory_budget{0, "texture_memory_budget"};
+    Setting<bool> deduplicate_texture_uploads{false, "deduplicate_texture_uploads"};
+    Setting<bool> dynamic_resolution{false, "dynamic_resolution"};
+    Setting<bool> adaptive_target_scale{false, "adaptive_target_scale"};
+    Setting<SpatialUpscaling> spatial_upscaling{SpatialUpscaling::Off, "spatial_upscaling"};
+    Setting<u32, true> frame_skip{0, 0, 3, "frame_skip"};
+    Setting<bool> turbo_mode{false, "turbo_mode"};
+    Setting<bool> perf_overlay{false, "perf_overlay"};
     SwitchableSetting<u32, true> resolution_factor{1, 0, 10, "resolution_factor"};
     SwitchableSetting<u16, true> frame_limit{100, 0, 1000, "frame_limit"};
     SwitchableSetting<TextureFilter> texture_filter{TextureFilter::None, "texture_filter"};
@@ -517,14 +563,24 @@ struct Values {
     SwitchableSetting<bool> custom_textures{false, "custom_textures"};
     SwitchableSetting<bool> preload_textures{false, "preload_textures"};
     SwitchableSetting<bool> async_custom_loading{true, "async_custom_loading"};
+    Setting<bool> compress_custom_textures{false, "compress_custom_textures"};
 
     // Audio
     bool audio_muted;
     SwitchableSetting<AudioEmulation> audio_emulation{AudioEmulation::HLE, "audio_emulation"};
     SwitchableSetting<bool> enable_audio_stretching{true, "enable_audio_stretching"};
+#ifdef ANDROID
+    SwitchableSetting<AudioStretchingQuality> audio_stretching_quality{AudioStretchingQuality::Low,
+                                                                       "audio_stretching_quality"};
+#else
+    SwitchableSetting<AudioStretchingQuality> audio_stretching_quality{
+        AudioStretchingQuality::High, "audio_stretching_quality"};
+#endif
     SwitchableSetting<float, true> volume{1.f, 0.f, 1.f, "volume"};
     Setting<AudioCore::SinkType> output_type{AudioCore::SinkType::Auto, "output_type"};
     Setting<std::string> output_device{"auto", "output_device"};
+    Setting<u32, true> audio_buffer_size{256, 64, 4096, "audio_buffer_size"};
+    Setting<u32, true> audio_latency{20, 5, 250, "audio_latency"};
     Setting<AudioCore::InputType> input_type{AudioCore::InputType::Auto, "input_type"};
     Setting<std::string> input_device{"auto", "input_device"};
 
@@ -539,9 +595,12 @@ struct Values {
     Setting<bool> delay_start_for_lle_modules{true, "delay_start_for_lle_modules"};
     Setting<bool> use_gdbstub{false, "use_gdbstub"};
     Setting<u16> gdbstub_port{24689, "gdbstub_port"};
+    Setting<bool> profile_guest_code{false, "profile_guest_code"};
+    Setting<bool> record_trace{false, "record_trace"};
 
     // Miscellaneous
     Setting<std::string> log_filter{"*:Info", "log_filter"};
+    Setting<bool> log_deferred_formatting{false, "log_deferred_formatting"};
 
     // Video Dumping
     std::string output_format;
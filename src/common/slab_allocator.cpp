@@ -0,0 +1,57 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/slab_allocator.h"
+
+namespace Common {
+
+SlabHeap::~SlabHeap() {
+    for (Pool& pool : pools) {
+        for (std::byte* slab : pool.slabs) {
+            ::operator delete[](slab);
+        }
+    }
+}
+
+void* SlabHeap::Allocate(std::size_t size) {
+    const std::size_t block_size =
+        std::max((size + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1), sizeof(FreeBlock));
+
+    std::scoped_lock lock{mutex};
+    Pool& pool = GetPool(block_size);
+    if (!pool.free_list) {
+        auto* slab = static_cast<std::byte*>(::operator new[](block_size * BLOCKS_PER_SLAB));
+        pool.slabs.push_back(slab);
+        for (std::size_t i = BLOCKS_PER_SLAB; i-- > 0;) {
+            pool.free_list = new (slab + i * block_size) FreeBlock{pool.free_list};
+        }
+    }
+
+    FreeBlock* const block = pool.free_list;
+    pool.free_list = block->next;
+    return block;
+}
+
+void SlabHeap::Deallocate(void* block, std::size_t size) {
+    const std::size_t block_size =
+        std::max((size + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1), sizeof(FreeBlock));
+
+    std::scoped_lock lock{mutex};
+    Pool& pool = GetPool(block_size);
+    pool.free_list = new (block) FreeBlock{pool.free_list};
+}
+
+SlabHeap::Pool& SlabHeap::GetPool(std::size_t block_size) {
+    // There is one pool per object type, so a few at most
+    const auto it = std::find_if(pools.begin(), pools.end(), [block_size](const Pool& pool) {
+        return pool.block_size == block_size;
+    });
+    if (it != pools.end()) {
+        return *it;
+    }
+    return pools.emplace_back(Pool{block_size});
+}
+
+} // namespace Common
@@ -0,0 +1,90 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace Common {
+
+/**
+ * Heap of small fixed size objects. Blocks of each size are carved out of slabs and recycled
+ * through a free list, so that objects which are created and destroyed all the time seldom reach
+ * the system allocator. Slabs are only released along with the heap.
+ */
+class SlabHeap {
+public:
+    static constexpr std::size_t BLOCK_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static constexpr std::size_t BLOCKS_PER_SLAB = 64;
+
+    SlabHeap() = default;
+    ~SlabHeap();
+
+    SlabHeap(const SlabHeap&) = delete;
+    SlabHeap& operator=(const SlabHeap&) = delete;
+
+    /// Returns a block of at least size bytes aligned to BLOCK_ALIGNMENT.
+    void* Allocate(std::size_t size);
+
+    /// Returns a block obtained from Allocate with the same size to its free list.
+    void Deallocate(void* block, std::size_t size);
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Pool {
+        std::size_t block_size;
+        FreeBlock* free_list = nullptr;
+        std::vector<std::byte*> slabs;
+    };
+
+    Pool& GetPool(std::size_t block_size);
+
+    std::mutex mutex;
+    std::vector<Pool> pools;
+};
+
+/**
+ * Standard allocator drawing from a SlabHeap, meant for std::allocate_shared so that the object
+ * and its control block share a single block. Every copy keeps the heap alive, which makes it
+ * safe for objects to outlive the owner of the heap.
+ */
+template <typename T>
+class SlabAllocator {
+public:
+    using value_type = T;
+
+    explicit SlabAllocator(std::shared_ptr<SlabHeap> heap_) noexcept : heap(std::move(heap_)) {}
+
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U>& other) noexcept : heap(other.heap) {}
+
+    T* allocate(std::size_t n) {
+        static_assert(alignof(T) <= SlabHeap::BLOCK_ALIGNMENT);
+        return static_cast<T*>(heap->Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        heap->Deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const SlabAllocator<U>& other) const noexcept {
+        return heap == other.heap;
+    }
+
+private:
+    std::shared_ptr<SlabHeap> heap;
+
+    template <typename U>
+    friend class SlabAllocator;
+};
+
+} // namespace Common
@@ -2,13 +2,20 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <fstream>
 #include <string>
+#include <utility>
+#include <vector>
+#include <fmt/format.h>
 
 #include "common/error.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "common/thread.h"
 #ifdef __APPLE__
 #include <mach/mach.h>
+#include <pthread.h>
 #elif defined(_WIN32)
 #include <windows.h>
 #include "common/string_util.h"
@@ -23,6 +30,10 @@
 #ifndef _WIN32
 #include <unistd.h>
 #endif
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
 
 #ifdef __FreeBSD__
 #define cpu_set_t cpuset_t
@@ -76,6 +87,14 @@ void SetCurrentThreadPriority(ThreadPriority new_priority) {
     }
 
     pthread_setschedparam(this_thread, scheduling_type, &params);
+
+#ifdef __linux__
+    // The static priorities of SCHED_OTHER are all 0, but Linux threads have their own nice
+    // value, which can be raised without privileges.
+    if (new_priority == ThreadPriority::Low) {
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+    }
+#endif
 }
 
 #endif
@@ -120,4 +139,198 @@ void SetCurrentThreadName(const char*) {
 
 #endif
 
+namespace {
+
+/// Host cores split by type, empty if the cores are all alike
+struct CoreTypes {
+    std::vector<u32> performance;
+    std::vector<u32> efficiency;
+};
+
+/**
+ * Splits cores ranked by performance, the lowest ranked ones being the efficiency cores.
+ * @param min_gap_percent How much faster the fastest cores must be than the slowest ones, in
+ *                        percent, for the cores to be told apart
+ */
+CoreTypes ClassifyCores(const std::vector<std::pair<u32, u64>>& ranked_cores,
+                        u64 min_gap_percent = 0) {
+    if (ranked_cores.empty()) {
+        return {};
+    }
+    const auto [min, max] = std::ranges::minmax_element(
+        ranked_cores, [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+    if (max->second * 100 <= min->second * (100 + min_gap_percent)) {
+        return {};
+    }
+    CoreTypes types;
+    for (const auto& [core, rank] : ranked_cores) {
+        (rank == min->second ? types.efficiency : types.performance).push_back(core);
+    }
+    return types;
+}
+
+#ifdef _WIN32
+
+CoreTypes DetectCoreTypes() {
+    ULONG length = 0;
+    GetSystemCpuSetInformation(nullptr, 0, &length, GetCurrentProcess(), 0);
+    std::vector<u8> buffer(length);
+    if (!GetSystemCpuSetInformation(reinterpret_cast<PSYSTEM_CPU_SET_INFORMATION>(buffer.data()),
+                                    length, &length, GetCurrentProcess(), 0)) {
+        return {};
+    }
+
+    // CPU sets are ranked by their efficiency class, higher classes being faster
+    std::vector<std::pair<u32, u64>> ranked_cores;
+    for (ULONG offset = 0; offset < length;) {
+        const auto* info = reinterpret_cast<const SYSTEM_CPU_SET_INFORMATION*>(&buffer[offset]);
+        if (info->Type == CpuSetInformation) {
+            ranked_cores.emplace_back(info->CpuSet.Id, info->CpuSet.EfficiencyClass);
+        }
+        offset += info->Size;
+    }
+    return ClassifyCores(ranked_cores);
+}
+
+void SetCurrentThreadCores(const std::vector<u32>& cores) {
+    std::vector<ULONG> cpu_sets(cores.begin(), cores.end());
+    SetThreadSelectedCpuSets(GetCurrentThread(), cpu_sets.data(),
+                             static_cast<ULONG>(cpu_sets.size()));
+}
+
+#elif defined(__linux__)
+
+/// Parses a list of cores in the format of sysfs, like "0-7,16"
+std::vector<u32> ParseCoreList(const std::string& list) {
+    std::vector<u32> cores;
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+        const std::size_t end = std::min(list.find(',', pos), list.size());
+        const std::string range = list.substr(pos, end - pos);
+        const std::size_t dash = range.find('-');
+        const u32 first = static_cast<u32>(std::stoul(range));
+        const u32 last = dash == std::string::npos
+                             ? first
+                             : static_cast<u32>(std::stoul(range.substr(dash + 1)));
+        for (u32 core = first; core <= last; core++) {
+            cores.push_back(core);
+        }
+        pos = end + 1;
+    }
+    return cores;
+}
+
+CoreTypes DetectCoreTypes() {
+    const auto read_line = [](const std::string& path) {
+        std::ifstream stream{path};
+        std::string line;
+        std::getline(stream, line);
+        return line;
+    };
+
+    // Hybrid Intel CPUs list their core types as separate PMUs
+    const std::string core_list = read_line("/sys/devices/cpu_core/cpus");
+    const std::string atom_list = read_line("/sys/devices/cpu_atom/cpus");
+    if (!core_list.empty() && !atom_list.empty()) {
+        try {
+            return {ParseCoreList(core_list), ParseCoreList(atom_list)};
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+
+    // Elsewhere cores are ranked by the capacity the scheduler gives them on ARM, or by their
+    // maximum frequency. Favored cores of otherwise identical CPUs boost slightly higher than the
+    // others, so frequencies only tell core types apart when they differ widely.
+    const auto read_value = [](u32 cpu, const char* file) -> u64 {
+        std::ifstream stream{fmt::format("/sys/devices/system/cpu/cpu{}/{}", cpu, file)};
+        u64 value = 0;
+        stream >> value;
+        return stream ? value : 0;
+    };
+    static constexpr u64 MinFrequencyGapPercent = 25;
+    std::vector<std::pair<u32, u64>> ranked_cores;
+    bool by_frequency = false;
+    const long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+    for (u32 cpu = 0; cpu < static_cast<u32>(std::max(num_cpus, 0L)); cpu++) {
+        u64 rank = read_value(cpu, "cpu_capacity");
+        if (rank == 0) {
+            rank = read_value(cpu, "cpufreq/cpuinfo_max_freq");
+            by_frequency = true;
+        }
+        if (rank == 0) {
+            return {};
+        }
+        ranked_cores.emplace_back(cpu, rank);
+    }
+    return ClassifyCores(ranked_cores, by_frequency ? MinFrequencyGapPercent : 0);
+}
+
+void SetCurrentThreadCores(const std::vector<u32>& cores) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const u32 core : cores) {
+        CPU_SET(core, &set);
+    }
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+#else
+
+// Elsewhere the core type is chosen by the OS, from the priority of the thread
+CoreTypes DetectCoreTypes() {
+    return {};
+}
+
+void SetCurrentThreadCores(const std::vector<u32>&) {}
+
+#endif
+
+const CoreTypes& GetCoreTypes() {
+    static const CoreTypes core_types = [] {
+        CoreTypes types = DetectCoreTypes();
+        if (!types.performance.empty()) {
+            LOG_INFO(Common, "Host CPU has {} performance and {} efficiency cores",
+                     types.performance.size(), types.efficiency.size());
+        }
+        return types;
+    }();
+    return core_types;
+}
+
+} // Anonymous namespace
+
+void SetCurrentThreadRole(ThreadRole role, const char* name) {
+    SetCurrentThreadName(name);
+
+    if (Settings::values.thread_policy.GetValue() == Settings::ThreadPolicy::System) {
+        return;
+    }
+    const bool is_background = role == ThreadRole::Background;
+    SetCurrentThreadPriority(is_background ? ThreadPriority::Low : ThreadPriority::High);
+    SwitchCurrentThreadRole(role);
+}
+
+void SwitchCurrentThreadRole(ThreadRole role) {
+    const auto policy = Settings::values.thread_policy.GetValue();
+    if (policy == Settings::ThreadPolicy::System) {
+        return;
+    }
+
+    const bool is_background = role == ThreadRole::Background;
+#ifdef __APPLE__
+    // The quality of service class decides both the priority and the core type of the thread
+    pthread_set_qos_class_self_np(is_background ? QOS_CLASS_UTILITY : QOS_CLASS_USER_INTERACTIVE,
+                                  0);
+#endif
+
+    if (policy != Settings::ThreadPolicy::PriorityAndAffinity) {
+        return;
+    }
+    const CoreTypes& core_types = GetCoreTypes();
+    if (!core_types.performance.empty()) {
+        SetCurrentThreadCores(is_background ? core_types.efficiency : core_types.performance);
+    }
+}
+
 } // namespace Common
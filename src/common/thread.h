@@ -112,4 +112,26 @@ void SetCurrentThreadPriority(ThreadPriority new_priority);
 
 void SetCurrentThreadName(const char* name);
 
+/// What a thread does, which decides how it is scheduled
+enum class ThreadRole : u32 {
+    Emulation,  ///< Runs the emulated CPU cores and the HLE services
+    Render,     ///< Processes, records, submits or presents GPU work
+    Background, ///< Work off the critical path of a frame, such as compiling shaders
+};
+
+/**
+ * Names the current thread and, depending on the thread policy setting, sets its priority and
+ * the type of host core it runs on for its role. On CPUs mixing performance and efficiency cores,
+ * emulation and rendering are kept on the performance cores and background work on the
+ * efficiency cores.
+ */
+void SetCurrentThreadRole(ThreadRole role, const char* name);
+
+/**
+ * Moves the current thread, which changes roles over time like the workers of the thread pool,
+ * to the host cores of the role. Its priority is left as is: on Linux a thread can lower its
+ * nice value but not raise it back without privileges.
+ */
+void SwitchCurrentThreadRole(ThreadRole role);
+
 } // namespace Common
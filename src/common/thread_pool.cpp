@@ -0,0 +1,330 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "common/thread_pool.h"
+
+namespace Common {
+
+namespace {
+
+constexpr std::size_t NoWorker = std::numeric_limits<std::size_t>::max();
+
+/// I/O tasks taking longer than this are logged
+constexpr std::chrono::milliseconds SlowIOThreshold{100};
+
+/// Pool and index of the worker running on this thread, if any
+thread_local ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_worker = NoWorker;
+
+ThreadRole RoleOf(TaskPriority priority) {
+    switch (priority) {
+    case TaskPriority::LatencyCritical:
+        return ThreadRole::Emulation;
+    case TaskPriority::FrameCritical:
+        return ThreadRole::Render;
+    case TaskPriority::Background:
+    case TaskPriority::Prefetch:
+    default:
+        return ThreadRole::Background;
+    }
+}
+
+} // Anonymous namespace
+
+struct ThreadPool::Worker {
+    std::mutex mutex;
+    std::array<std::deque<Task>, NumTaskPriorities> queues;
+};
+
+struct ThreadPool::IOThreads {
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        Task task;
+        Clock::time_point submitted;
+    };
+
+    std::mutex mutex;
+    std::condition_variable_any condition;
+    /// Queued tasks of each order key, the key stays while one of its tasks runs
+    std::unordered_map<const void*, std::deque<Entry>> queues;
+    /// Keys with queued tasks and none running, in the order they became ready
+    std::deque<const void*> ready_keys;
+    u64 num_tasks = 0;
+    Clock::duration total_latency{};
+    Clock::duration max_latency{};
+    std::vector<std::jthread> threads;
+};
+
+struct ThreadPool::SpareThreads {
+    std::mutex mutex;
+    std::condition_variable_any condition;
+    std::queue<Task> tasks;
+    std::size_t num_idle = 0;
+    std::vector<std::jthread> threads;
+};
+
+ThreadPool::ThreadPool(std::size_t num_threads, std::size_t num_io_threads)
+    : io_threads{std::make_unique<IOThreads>()}, spare_threads{std::make_unique<SpareThreads>()} {
+    num_threads = std::max<std::size_t>(num_threads, 1);
+    workers.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    threads.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; i++) {
+        threads.emplace_back([this, i](std::stop_token stop_token) { WorkerLoop(stop_token, i); });
+    }
+    num_io_threads = std::max<std::size_t>(num_io_threads, 1);
+    io_threads->threads.reserve(num_io_threads);
+    for (std::size_t i = 0; i < num_io_threads; i++) {
+        io_threads->threads.emplace_back(
+            [&io = *io_threads](std::stop_token stop_token) { IOLoop(stop_token, io); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    // Stop the I/O and spare threads first, their tasks may wait on work queued to the workers
+    io_threads.reset();
+    spare_threads.reset();
+    threads.clear();
+}
+
+ThreadPool& ThreadPool::Instance() {
+    // The emulation thread keeps a core to itself
+    static ThreadPool instance{std::max(std::thread::hardware_concurrency(), 3U) - 1,
+                               std::clamp(std::thread::hardware_concurrency() / 2, 2U, 4U)};
+    return instance;
+}
+
+void ThreadPool::Submit(TaskPriority priority, Task task) {
+    // Tasks queued by a worker usually depend on the data it just worked on
+    const std::size_t index = current_pool == this
+                                  ? current_worker
+                                  : next_worker.fetch_add(1, std::memory_order_relaxed) %
+                                        workers.size();
+    // Counted before they can be taken, so that the count never goes below zero
+    num_pending.fetch_add(1);
+    {
+        Worker& worker = *workers[index];
+        std::scoped_lock lock{worker.mutex};
+        worker.queues[static_cast<std::size_t>(priority)].push_back(std::move(task));
+    }
+    {
+        std::scoped_lock lock{sleep_mutex};
+    }
+    sleep_condition.notify_one();
+}
+
+void ThreadPool::SubmitIO(const void* order_key, Task task) {
+    IOThreads& io = *io_threads;
+    std::scoped_lock lock{io.mutex};
+    auto [it, inserted] = io.queues.try_emplace(order_key);
+    it->second.push_back({std::move(task), IOThreads::Clock::now()});
+    // Otherwise a task of the key is queued or running already, the new one runs after it
+    if (inserted) {
+        io.ready_keys.push_back(order_key);
+        io.condition.notify_one();
+    }
+}
+
+ThreadPool::IOStats ThreadPool::GetAndResetIOStats() {
+    IOThreads& io = *io_threads;
+    std::scoped_lock lock{io.mutex};
+    using Nanoseconds = std::chrono::nanoseconds;
+    const IOStats stats{
+        .num_tasks = io.num_tasks,
+        .mean_latency = io.num_tasks ? std::chrono::duration_cast<Nanoseconds>(io.total_latency /
+                                                                                io.num_tasks)
+                                     : Nanoseconds{},
+        .max_latency = std::chrono::duration_cast<Nanoseconds>(io.max_latency),
+    };
+    io.num_tasks = 0;
+    io.total_latency = {};
+    io.max_latency = {};
+    return stats;
+}
+
+void ThreadPool::SubmitBlocking(Task task) {
+    SpareThreads& spare = *spare_threads;
+    std::scoped_lock lock{spare.mutex};
+    spare.tasks.push(std::move(task));
+    if (spare.num_idle >= spare.tasks.size()) {
+        spare.condition.notify_one();
+        return;
+    }
+    spare.threads.emplace_back([&spare](std::stop_token stop_token) {
+        SetCurrentThreadRole(ThreadRole::Emulation, "Blocking tasks");
+        std::unique_lock lock{spare.mutex};
+        while (true) {
+            spare.num_idle++;
+            CondvarWait(spare.condition, lock, stop_token, [&] { return !spare.tasks.empty(); });
+            spare.num_idle--;
+            if (stop_token.stop_requested()) {
+                return;
+            }
+            Task task = std::move(spare.tasks.front());
+            spare.tasks.pop();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    });
+}
+
+bool ThreadPool::RunPendingTask(TaskPriority max_priority) {
+    const std::size_t index = current_pool == this ? current_worker : NoWorker;
+    Task task;
+    TaskPriority priority{};
+    if (!PopTask(index, max_priority, task, priority)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::WorkerLoop(std::stop_token stop_token, std::size_t index) {
+    current_pool = this;
+    current_worker = index;
+    SetCurrentThreadName("Pool worker");
+    std::optional<ThreadRole> role;
+    while (!stop_token.stop_requested()) {
+        Task task;
+        TaskPriority priority{};
+        if (!PopTask(index, TaskPriority::Prefetch, task, priority)) {
+            std::unique_lock lock{sleep_mutex};
+            CondvarWait(sleep_condition, lock, stop_token,
+                        [this] { return num_pending.load() != 0; });
+            continue;
+        }
+        // Changing the role takes system calls, so it is only done when the class changes
+        if (RoleOf(priority) != role) {
+            role = RoleOf(priority);
+            SwitchCurrentThreadRole(*role);
+        }
+        task();
+    }
+}
+
+void ThreadPool::IOLoop(std::stop_token stop_token, IOThreads& io) {
+    SetCurrentThreadRole(ThreadRole::Emulation, "I/O tasks");
+    std::unique_lock lock{io.mutex};
+    while (true) {
+        CondvarWait(io.condition, lock, stop_token, [&] { return !io.ready_keys.empty(); });
+        if (stop_token.stop_requested()) {
+            return;
+        }
+        const void* order_key = io.ready_keys.front();
+        io.ready_keys.pop_front();
+        auto& queue = io.queues.at(order_key);
+        IOThreads::Entry entry = std::move(queue.front());
+        queue.pop_front();
+
+        lock.unlock();
+        const auto started = IOThreads::Clock::now();
+        entry.task();
+        const auto completed = IOThreads::Clock::now();
+        const auto latency = completed - entry.submitted;
+        if (latency > SlowIOThreshold) {
+            using Milliseconds = std::chrono::duration<double, std::milli>;
+            LOG_DEBUG(Common, "Slow I/O task: {:.1f} ms queued, {:.1f} ms running",
+                      Milliseconds(started - entry.submitted).count(),
+                      Milliseconds(completed - started).count());
+        }
+        entry.task = {};
+        lock.lock();
+
+        io.num_tasks++;
+        io.total_latency += latency;
+        io.max_latency = std::max(io.max_latency, latency);
+        // The next task of the key goes behind the keys already waiting
+        if (queue.empty()) {
+            io.queues.erase(order_key);
+        } else {
+            io.ready_keys.push_back(order_key);
+            io.condition.notify_one();
+        }
+    }
+}
+
+bool ThreadPool::PopTask(std::size_t index, TaskPriority max_priority, Task& task,
+                         TaskPriority& priority) {
+    const std::size_t num_workers = workers.size();
+    // Start from the own queues of the worker, then steal from the following ones
+    const std::size_t first =
+        index != NoWorker ? index : next_worker.load(std::memory_order_relaxed) % num_workers;
+    for (std::size_t queue = 0; queue <= static_cast<std::size_t>(max_priority); queue++) {
+        for (std::size_t i = 0; i < num_workers; i++) {
+            Worker& worker = *workers[(first + i) % num_workers];
+            std::scoped_lock lock{worker.mutex};
+            auto& tasks = worker.queues[queue];
+            if (tasks.empty()) {
+                continue;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            num_pending.fetch_sub(1);
+            priority = static_cast<TaskPriority>(queue);
+            return true;
+        }
+    }
+    return false;
+}
+
+TaskGroup::TaskGroup(TaskPriority priority_, ThreadPool& pool_)
+    : pool{pool_}, priority{priority_}, least_urgent{static_cast<u32>(priority_)} {}
+
+TaskGroup::~TaskGroup() {
+    cancelled = true;
+    WaitForRequests();
+}
+
+void TaskGroup::QueueWork(UniqueFunction<void> work) {
+    QueueWork(std::move(work), priority);
+}
+
+void TaskGroup::QueueWork(UniqueFunction<void> work, TaskPriority work_priority) {
+    u32 current = least_urgent.load(std::memory_order_relaxed);
+    while (current < static_cast<u32>(work_priority) &&
+           !least_urgent.compare_exchange_weak(current, static_cast<u32>(work_priority),
+                                               std::memory_order_relaxed)) {
+    }
+    num_pending.fetch_add(1);
+    pool.Submit(work_priority, [this, work = std::move(work)] {
+        if (!cancelled.load(std::memory_order_relaxed)) {
+            work();
+        }
+        // Decremented under the lock, so the group is not destroyed before the notification
+        std::scoped_lock lock{mutex};
+        if (num_pending.fetch_sub(1) == 1) {
+            condition.notify_all();
+        }
+    });
+}
+
+void TaskGroup::WaitForRequests() {
+    while (num_pending.load() != 0) {
+        // Includes the less urgent tasks of the group, which the workers would only get to last
+        const auto max_priority = static_cast<TaskPriority>(least_urgent.load());
+        if (pool.RunPendingTask(max_priority)) {
+            continue;
+        }
+        std::unique_lock lock{mutex};
+        condition.wait(lock, [this] { return num_pending.load() == 0; });
+    }
+    // The last task may still hold the lock after its decrement
+    std::scoped_lock lock{mutex};
+}
+
+} // namespace Common
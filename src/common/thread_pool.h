@@ -0,0 +1,150 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+#include "common/unique_function.h"
+
+namespace Common {
+
+/// Priority classes of the pool tasks, a worker always runs the most urgent task available
+enum class TaskPriority : u32 {
+    LatencyCritical, ///< Blocks the emulated CPU until done, like HLE service requests
+    FrameCritical,   ///< Needed to finish the current frame, like software rasterization
+    Background,      ///< Off the critical path of a frame, like compiling shaders
+    Prefetch,        ///< Speculative work that may never be needed, like warming caches
+};
+
+constexpr std::size_t NumTaskPriorities = 4;
+
+/**
+ * Process-wide pool of worker threads shared by the emulator components, so that they do not
+ * each spawn as many threads as the host has cores. Every worker has its own queue per priority
+ * class: tasks queued from a worker go to its own queue, the others are spread over the workers,
+ * and idle workers steal from the queues of the busy ones. The workers run on the host cores of
+ * the class of their task, at an unchanged priority. Tasks waiting on I/O run on separate threads,
+ * so that they do not hold up the workers.
+ */
+class ThreadPool {
+public:
+    using Task = UniqueFunction<void>;
+
+    /// Latency of the I/O tasks, from their submission to their completion
+    struct IOStats {
+        u64 num_tasks{};
+        std::chrono::nanoseconds mean_latency{};
+        std::chrono::nanoseconds max_latency{};
+    };
+
+    ThreadPool(std::size_t num_threads, std::size_t num_io_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Returns the pool shared by the emulator components, sized to leave a core to emulation.
+    static ThreadPool& Instance();
+
+    /// Queues a task to run on a worker.
+    void Submit(TaskPriority priority, Task task);
+
+    /**
+     * Runs a task doing I/O, like reading a file, on the I/O threads. There are only a few of
+     * them, as storage handles a few requests in flight well and more threads only contend for
+     * it. The tasks with the same order key run one at a time, in the order they were submitted.
+     */
+    void SubmitIO(const void* order_key, Task task);
+
+    /// Returns the latency of the I/O tasks completed since the last call
+    IOStats GetAndResetIOStats();
+
+    /**
+     * Runs a task that may block for a long time, like waiting on a socket, on a spare thread
+     * instead of a worker so that it does not hold up the other tasks. The spare threads are kept
+     * to be reused, they are only created when all of them are busy.
+     */
+    void SubmitBlocking(Task task);
+
+    /**
+     * Runs a queued task on the calling thread, so that a thread waiting for tasks to complete can
+     * help with them.
+     * @param max_priority Least urgent class of task to run
+     * @returns True if a task was run, false if none was queued
+     */
+    bool RunPendingTask(TaskPriority max_priority);
+
+    /// Returns the number of worker threads
+    [[nodiscard]] std::size_t NumThreads() const noexcept {
+        return workers.size();
+    }
+
+private:
+    struct Worker;
+    struct IOThreads;
+    struct SpareThreads;
+
+    void WorkerLoop(std::stop_token stop_token, std::size_t index);
+    static void IOLoop(std::stop_token stop_token, IOThreads& io);
+    bool PopTask(std::size_t index, TaskPriority max_priority, Task& task,
+                 TaskPriority& priority);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unique_ptr<IOThreads> io_threads;
+    std::unique_ptr<SpareThreads> spare_threads;
+    std::atomic<std::size_t> num_pending{};
+    std::atomic<std::size_t> next_worker{};
+    std::mutex sleep_mutex;
+    std::condition_variable_any sleep_condition;
+    std::vector<std::jthread> threads;
+};
+
+/**
+ * Set of tasks queued to the shared thread pool that can be waited on together, to use in place
+ * of a dedicated Common::ThreadWorker. The thread waiting for the tasks runs queued tasks of the
+ * same or more urgent class meanwhile. Tasks that did not start yet when the group is destroyed
+ * are skipped.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskPriority priority, ThreadPool& pool = ThreadPool::Instance());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// Queues a task of the group.
+    void QueueWork(UniqueFunction<void> work);
+
+    /// Queues a task of the group with a priority other than the one of the group.
+    void QueueWork(UniqueFunction<void> work, TaskPriority work_priority);
+
+    /// Waits until all the tasks of the group ran.
+    void WaitForRequests();
+
+    /// Returns the number of threads running the tasks of the group, the waiting one included
+    [[nodiscard]] std::size_t NumWorkers() const noexcept {
+        return pool.NumThreads() + 1;
+    }
+
+private:
+    ThreadPool& pool;
+    TaskPriority priority;
+    /// Least urgent class of the tasks queued so far, which the waiting thread helps with
+    std::atomic<u32> least_urgent;
+    std::atomic<std::size_t> num_pending{};
+    std::atomic_bool cancelled{};
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+} // namespace Common
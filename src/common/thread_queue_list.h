@@ -4,8 +4,8 @@
 
 #pragma once
 
-#include <algorithm>
 #include <array>
+#include <bit>
 #include <deque>
 #include <boost/serialization/deque.hpp>
 #include <boost/serialization/split_member.hpp>
@@ -13,195 +13,192 @@
 
 namespace Common {
 
+/// Links of an element in a ThreadQueueList, embedded in the element as a member named queue_node
+template <class T>
+struct ThreadQueueNode {
+    T* prev = nullptr;
+    T* next = nullptr;
+    bool queued = false;
+};
+
+/**
+ * Ready queue of threads ordered by priority, lower levels being scheduled first. Each level is
+ * an intrusive list threaded through the queue_node member of the elements, and a bitmap tracks
+ * the non-empty levels so that the best one is found with a single bit scan. Nothing is
+ * allocated and all operations but contains are O(1).
+ */
 template <class T, unsigned int N>
 struct ThreadQueueList {
-    // TODO(yuriks): If performance proves to be a problem, the std::deques can be replaced with
-    //               (dynamically resizable) circular buffers to remove their overhead when
-    //               inserting and popping.
-
     using Priority = unsigned int;
 
     // Number of priority levels. (Valid levels are [0..NUM_QUEUES).)
     static constexpr Priority NUM_QUEUES = N;
-
-    ThreadQueueList() {
-        first = nullptr;
-    }
+    static_assert(NUM_QUEUES <= 64, "The priority bitmap holds at most 64 levels");
 
     // Only for debugging, returns priority level.
-    [[nodiscard]] Priority contains(const T& uid) const {
+    [[nodiscard]] Priority contains(const T* thread) const {
         for (Priority i = 0; i < NUM_QUEUES; ++i) {
-            const Queue& cur = queues[i];
-            if (std::find(cur.data.cbegin(), cur.data.cend(), uid) != cur.data.cend()) {
-                return i;
+            for (const T* cur = queues[i].head; cur != nullptr; cur = cur->queue_node.next) {
+                if (cur == thread) {
+                    return i;
+                }
             }
         }
 
         return -1;
     }
 
-    [[nodiscard]] T get_first() const {
-        const Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                return cur->data.front();
-            }
-            cur = cur->next_nonempty;
+    [[nodiscard]] T* get_first() const {
+        if (non_empty == 0) {
+            return nullptr;
         }
-
-        return T();
+        return queues[std::countr_zero(non_empty)].head;
     }
 
-    T pop_first() {
-        Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
-        }
+    T* pop_first() {
+        return pop_from(non_empty);
+    }
 
-        return T();
+    T* pop_first_better(Priority priority) {
+        return pop_from(non_empty & ((u64{1} << priority) - 1));
     }
 
-    T pop_first_better(Priority priority) {
-        Queue* cur = first;
-        Queue* stop = &queues[priority];
-        while (cur < stop) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
+    /// Inserts thread at the front of its level. The thread must not be queued already.
+    void push_front(Priority priority, T* thread) {
+        Queue& queue = queues[priority];
+        auto& node = thread->queue_node;
+        node = {nullptr, queue.head, true};
+        if (queue.head) {
+            queue.head->queue_node.prev = thread;
+        } else {
+            queue.tail = thread;
         }
-
-        return T();
+        queue.head = thread;
+        non_empty |= u64{1} << priority;
     }
 
-    void push_front(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_front(thread_id);
+    /// Inserts thread at the back of its level. The thread must not be queued already.
+    void push_back(Priority priority, T* thread) {
+        Queue& queue = queues[priority];
+        auto& node = thread->queue_node;
+        node = {queue.tail, nullptr, true};
+        if (queue.tail) {
+            queue.tail->queue_node.next = thread;
+        } else {
+            queue.head = thread;
+        }
+        queue.tail = thread;
+        non_empty |= u64{1} << priority;
     }
 
-    void push_back(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_back(thread_id);
+    void move(T* thread, Priority old_priority, Priority new_priority) {
+        remove(old_priority, thread);
+        push_back(new_priority, thread);
     }
 
-    void move(const T& thread_id, Priority old_priority, Priority new_priority) {
-        remove(old_priority, thread_id);
-        prepare(new_priority);
-        push_back(new_priority, thread_id);
-    }
+    /// Unlinks thread from its level, doing nothing if it is not queued.
+    void remove(Priority priority, T* thread) {
+        auto& node = thread->queue_node;
+        if (!node.queued) {
+            return;
+        }
 
-    void remove(Priority priority, const T& thread_id) {
-        Queue* const cur = &queues[priority];
-        const auto iter = std::remove(cur->data.begin(), cur->data.end(), thread_id);
-        cur->data.erase(iter, cur->data.end());
+        Queue& queue = queues[priority];
+        if (node.prev) {
+            node.prev->queue_node.next = node.next;
+        } else {
+            queue.head = node.next;
+        }
+        if (node.next) {
+            node.next->queue_node.prev = node.prev;
+        } else {
+            queue.tail = node.prev;
+        }
+        node = {};
+
+        if (!queue.head) {
+            non_empty &= ~(u64{1} << priority);
+        }
     }
 
     void rotate(Priority priority) {
-        Queue* cur = &queues[priority];
-
-        if (cur->data.size() > 1) {
-            cur->data.push_back(std::move(cur->data.front()));
-            cur->data.pop_front();
+        Queue& queue = queues[priority];
+        if (queue.head != queue.tail) {
+            T* const front = queue.head;
+            remove(priority, front);
+            push_back(priority, front);
         }
     }
 
     void clear() {
-        queues.fill(Queue());
-        first = nullptr;
+        for (Queue& queue : queues) {
+            while (queue.head) {
+                T* const next = queue.head->queue_node.next;
+                queue.head->queue_node = {};
+                queue.head = next;
+            }
+            queue.tail = nullptr;
+        }
+        non_empty = 0;
     }
 
     [[nodiscard]] bool empty(Priority priority) const {
-        const Queue* cur = &queues[priority];
-        return cur->data.empty();
-    }
-
-    void prepare(Priority priority) {
-        Queue* cur = &queues[priority];
-        if (cur->next_nonempty == UnlinkedTag())
-            link(priority);
+        return (non_empty & (u64{1} << priority)) == 0;
     }
 
 private:
     struct Queue {
-        // Points to the next active priority, skipping over ones that have never been used.
-        Queue* next_nonempty = UnlinkedTag();
-        // Double-ended queue of threads in this priority level
-        std::deque<T> data;
+        T* head = nullptr;
+        T* tail = nullptr;
     };
 
-    /// Special tag used to mark priority levels that have never been used.
-    static Queue* UnlinkedTag() {
-        return reinterpret_cast<Queue*>(1);
-    }
-
-    void link(Priority priority) {
-        Queue* cur = &queues[priority];
-
-        for (int i = priority - 1; i >= 0; --i) {
-            if (queues[i].next_nonempty != UnlinkedTag()) {
-                cur->next_nonempty = queues[i].next_nonempty;
-                queues[i].next_nonempty = cur;
-                return;
-            }
-        }
-
-        cur->next_nonempty = first;
-        first = cur;
-    }
-
-    // The first queue that's ever been used.
-    Queue* first;
-    // The priority level queues of thread ids.
-    std::array<Queue, NUM_QUEUES> queues;
-
-    s64 ToIndex(const Queue* q) const {
-        if (q == nullptr) {
-            return -2;
-        } else if (q == UnlinkedTag()) {
-            return -1;
-        } else {
-            return q - queues.data();
-        }
-    }
-
-    Queue* ToPointer(s64 idx) {
-        if (idx == -1) {
-            return UnlinkedTag();
-        } else if (idx < 0) {
+    /// Pops the front thread of the best level in the given subset of the bitmap.
+    T* pop_from(u64 levels) {
+        if (levels == 0) {
             return nullptr;
-        } else {
-            return &queues[idx];
         }
+        const auto priority = static_cast<Priority>(std::countr_zero(levels));
+        T* const thread = queues[priority].head;
+        remove(priority, thread);
+        return thread;
     }
 
+    // The priority level queues of threads.
+    std::array<Queue, NUM_QUEUES> queues{};
+    // Bit i is set when the level i is not empty.
+    u64 non_empty = 0;
+
+    // The layout matches the previous deque based list, whose linked level indices are written
+    // as unused placeholders so that older savestates keep loading.
     friend class boost::serialization::access;
     template <class Archive>
     void save(Archive& ar, const unsigned int file_version) const {
-        const s64 idx = ToIndex(first);
-        ar << idx;
+        const s64 unused_index = -1;
+        ar << unused_index;
         for (std::size_t i = 0; i < NUM_QUEUES; i++) {
-            const s64 idx1 = ToIndex(queues[i].next_nonempty);
-            ar << idx1;
-            ar << queues[i].data;
+            std::deque<T*> data;
+            for (T* cur = queues[i].head; cur != nullptr; cur = cur->queue_node.next) {
+                data.push_back(cur);
+            }
+            ar << unused_index;
+            ar << data;
         }
     }
 
     template <class Archive>
     void load(Archive& ar, const unsigned int file_version) {
-        s64 idx;
-        ar >> idx;
-        first = ToPointer(idx);
-        for (std::size_t i = 0; i < NUM_QUEUES; i++) {
-            ar >> idx;
-            queues[i].next_nonempty = ToPointer(idx);
-            ar >> queues[i].data;
+        // The loaded threads are new objects, the links of the previous ones are left alone
+        queues = {};
+        non_empty = 0;
+        s64 unused_index;
+        ar >> unused_index;
+        for (Priority i = 0; i < NUM_QUEUES; i++) {
+            std::deque<T*> data;
+            ar >> unused_index;
+            ar >> data;
+            for (T* thread : data) {
+                push_back(i, thread);
+            }
         }
     }
 
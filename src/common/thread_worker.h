@@ -37,10 +37,10 @@ class StatefulThreadWorker {
 
 public:
     explicit StatefulThreadWorker(std::size_t num_workers, std::string_view name,
-                                  StateMaker func = {})
+                                  Common::ThreadRole role, StateMaker func = {})
         : workers_queued{num_workers}, thread_name{name} {
-        const auto lambda = [this, func](std::stop_token stop_token, std::size_t index) {
-            Common::SetCurrentThreadName(thread_name.data());
+        const auto lambda = [this, role, func](std::stop_token stop_token, std::size_t index) {
+            Common::SetCurrentThreadRole(role, thread_name.data());
             {
                 [[maybe_unused]] std::conditional_t<with_state, StateType, int> state{func(index)};
                 while (!stop_token.stop_requested()) {
@@ -0,0 +1,165 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <fmt/format.h>
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/trace_recorder.h"
+
+namespace Common {
+
+#if MICROPROFILE_ENABLED
+
+/// Escapes a string to be written in a JSON string literal.
+static std::string EscapeJson(std::string_view str) {
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<u8>(c) < 0x20) {
+            escaped += fmt::format("\\u{:04x}", c);
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+static_assert(MICROPROFILE_MAX_THREADS <= 32, "Too many MicroProfile threads to trace");
+
+TraceRecorder::TraceRecorder(const std::string& path) : file(path, "w") {
+    if (!file.IsOpen()) {
+        LOG_ERROR(Common, "Could not create the trace file {}", path);
+        return;
+    }
+    file.WriteString("[\n");
+    LOG_INFO(Common, "Recording a trace to {}", path);
+
+    std::scoped_lock lock{MicroProfileGetMutex()};
+    const MicroProfile& profile = *MicroProfileGet();
+    base_tick = MP_TICK();
+    for (std::size_t i = 0; i < MICROPROFILE_MAX_THREADS; i++) {
+        if (const MicroProfileThreadLog* log = profile.Pool[i]) {
+            read_positions[i] = log->nPut.load(std::memory_order_acquire);
+            thread_ids[i] = log->nThreadId;
+        }
+    }
+
+    // Scopes are only logged for the enabled groups, and without the profiler UI only when forced
+    all_groups_were_enabled = MicroProfileGetEnableAllGroups();
+    was_force_enabled = MicroProfileGetForceEnable();
+    MicroProfileSetEnableAllGroups(true);
+    MicroProfileSetForceEnable(true);
+}
+
+TraceRecorder::~TraceRecorder() {
+    if (!file.IsOpen()) {
+        return;
+    }
+    MicroProfileSetEnableAllGroups(all_groups_were_enabled);
+    MicroProfileSetForceEnable(was_force_enabled);
+
+    std::scoped_lock lock{mutex};
+    buffer += "\n]\n";
+    file.WriteString(buffer);
+}
+
+void TraceRecorder::RecordFrame() {
+    if (!file.IsOpen()) {
+        return;
+    }
+
+    std::scoped_lock profile_lock{MicroProfileGetMutex()};
+    std::scoped_lock lock{mutex};
+    const MicroProfile& profile = *MicroProfileGet();
+    const MicroProfileFrameState& frame = profile.Frames[profile.nFramePut];
+    for (std::size_t i = 0; i < MICROPROFILE_MAX_THREADS; i++) {
+        const MicroProfileThreadLog* log = profile.Pool[i];
+        if (!log || log->nGpu) {
+            continue;
+        }
+        if (thread_ids[i] != log->nThreadId) {
+            // The log was given to another thread, which started writing it from the beginning
+            thread_ids[i] = log->nThreadId;
+            read_positions[i] = 0;
+            named_threads[i] = false;
+        }
+        if (!named_threads[i]) {
+            WriteEvent(fmt::format(
+                R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})", i,
+                EscapeJson(log->ThreadName)));
+            named_threads[i] = true;
+        }
+
+        // Only the part logged before the flip is read, the threads keep writing after it
+        const u32 end = frame.nLogStart[i];
+        for (u32 pos = read_positions[i]; pos != end; pos = (pos + 1) % MICROPROFILE_BUFFER_SIZE) {
+            const MicroProfileLogEntry entry = log->Log[pos];
+            const int type = MicroProfileLogType(entry);
+            if (type != MP_LOG_ENTER && type != MP_LOG_LEAVE) {
+                continue;
+            }
+            const u64 timer = MicroProfileLogTimerIndex(entry);
+            const MicroProfileTimerInfo& info = profile.TimerInfo[timer];
+            const MicroProfileGroupInfo& group = profile.GroupInfo[profile.TimerToGroup[timer]];
+            WriteEvent(fmt::format(
+                R"({{"name":"{}","cat":"{}","ph":"{}","ts":{:.3f},"pid":1,"tid":{}}})",
+                EscapeJson(info.pName), EscapeJson(group.pName), type == MP_LOG_ENTER ? 'B' : 'E',
+                ToTimestamp(MicroProfileLogGetTick(entry)), i));
+        }
+        read_positions[i] = end;
+    }
+
+    file.WriteString(buffer);
+    buffer.clear();
+}
+
+void TraceRecorder::RecordCounter(std::string_view name,
+                                  std::span<const std::pair<const char*, double>> values) {
+    if (!file.IsOpen() || values.empty()) {
+        return;
+    }
+
+    std::string args;
+    for (const auto& [series, value] : values) {
+        args += fmt::format(R"({}"{}":{})", args.empty() ? "" : ",", EscapeJson(series), value);
+    }
+    std::scoped_lock lock{mutex};
+    WriteEvent(fmt::format(R"({{"name":"{}","ph":"C","ts":{:.3f},"pid":1,"args":{{{}}}}})",
+                           EscapeJson(name), ToTimestamp(MP_TICK()), args));
+}
+
+double TraceRecorder::ToTimestamp(s64 tick) const {
+    // The logged ticks are truncated to the bits of MP_LOG_TICK_MASK
+    const s64 elapsed = (tick - base_tick) & MP_LOG_TICK_MASK;
+    return static_cast<double>(elapsed) * 1e6 /
+           static_cast<double>(MicroProfileTicksPerSecondCpu());
+}
+
+void TraceRecorder::WriteEvent(std::string_view event) {
+    if (!first_event) {
+        buffer += ",\n";
+    }
+    first_event = false;
+    buffer += event;
+}
+
+#else
+
+TraceRecorder::TraceRecorder(const std::string& path) {
+    LOG_ERROR(Common, "MicroProfile is disabled in this build, no trace is recorded");
+}
+
+TraceRecorder::~TraceRecorder() = default;
+
+void TraceRecorder::RecordFrame() {}
+
+void TraceRecorder::RecordCounter(std::string_view name,
+                                  std::span<const std::pair<const char*, double>> values) {}
+
+#endif
+
+} // namespace Common
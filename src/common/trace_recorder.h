@@ -0,0 +1,65 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Common {
+
+/**
+ * Records the MicroProfile scopes of every thread to a file in the Chrome trace event format,
+ * which can be opened by Perfetto or chrome://tracing. The scopes are read from the MicroProfile
+ * thread logs once per frame, after they were flipped, so that the profiled threads only pay for
+ * the scopes as they already do. Counters, like the GPU time of the renderer operations, can be
+ * added to the trace as well.
+ */
+class TraceRecorder {
+public:
+    explicit TraceRecorder(const std::string& path);
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /// Writes the scopes logged since the previous call. Called right after MicroProfileFlip.
+    void RecordFrame();
+
+    /**
+     * Writes the values of a counter track at the current time.
+     * @param name Name of the track
+     * @param values Names and values of the series of the track
+     */
+    void RecordCounter(std::string_view name,
+                       std::span<const std::pair<const char*, double>> values);
+
+private:
+    static constexpr std::size_t MaxThreads = 32;
+
+    /// Returns the trace timestamp, in microseconds, of a MicroProfile tick.
+    double ToTimestamp(s64 tick) const;
+
+    void WriteEvent(std::string_view event);
+
+    std::mutex mutex;
+    FileUtil::IOFile file;
+    std::string buffer;
+    bool first_event = true;
+    bool all_groups_were_enabled = false;
+    bool was_force_enabled = false;
+
+    s64 base_tick = 0;
+    std::array<u32, MaxThreads> read_positions{};
+    std::array<u64, MaxThreads> thread_ids{};
+    std::array<bool, MaxThreads> named_threads{};
+};
+
+} // namespace Common
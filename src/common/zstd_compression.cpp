@@ -70,4 +70,110 @@ std::vector<u8> DecompressDataZSTD(std::span<const u8> compressed) {
     return decompressed;
 }
 
+ZSTDCompressStreamBuf::ZSTDCompressStreamBuf(Sink sink_, s32 compression_level, u32 num_workers)
+    : sink(std::move(sink_)), context(ZSTD_createCCtx()), input(ZSTD_CStreamInSize()),
+      output(ZSTD_CStreamOutSize()) {
+    compression_level = std::clamp(compression_level, ZSTD_minCLevel(), ZSTD_maxCLevel());
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, compression_level);
+    if (num_workers != 0) {
+        // Fails when zstd is built without multithreading, which leaves compression synchronous
+        const std::size_t result =
+            ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, static_cast<int>(num_workers));
+        if (ZSTD_isError(result)) {
+            LOG_DEBUG(Common, "ZSTD multithreaded compression unavailable: {}",
+                      ZSTD_getErrorName(result));
+        }
+    }
+    setp(input.data(), input.data() + input.size());
+}
+
+ZSTDCompressStreamBuf::~ZSTDCompressStreamBuf() {
+    ZSTD_freeCCtx(context);
+}
+
+bool ZSTDCompressStreamBuf::Finish() {
+    return Compress(true) && !failed;
+}
+
+ZSTDCompressStreamBuf::int_type ZSTDCompressStreamBuf::overflow(int_type ch) {
+    if (!Compress(false)) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+bool ZSTDCompressStreamBuf::Compress(bool end_frame) {
+    if (failed) {
+        return false;
+    }
+
+    ZSTD_inBuffer in{pbase(), static_cast<std::size_t>(pptr() - pbase()), 0};
+    const ZSTD_EndDirective mode = end_frame ? ZSTD_e_end : ZSTD_e_continue;
+    bool done = false;
+    while (!done) {
+        ZSTD_outBuffer out{output.data(), output.size(), 0};
+        const std::size_t remaining = ZSTD_compressStream2(context, &out, &in, mode);
+        if (ZSTD_isError(remaining)) {
+            LOG_ERROR(Common, "Error compressing ZSTD stream: {} ({})",
+                      ZSTD_getErrorName(remaining), remaining);
+            failed = true;
+            return false;
+        }
+        if (out.pos != 0 && !sink(std::span{output.data(), out.pos})) {
+            failed = true;
+            return false;
+        }
+        // The frame is complete once nothing remains to be flushed, otherwise all the input must
+        // have been consumed
+        done = end_frame ? remaining == 0 : in.pos == in.size;
+    }
+
+    setp(input.data(), input.data() + input.size());
+    return true;
+}
+
+ZSTDDecompressStreamBuf::ZSTDDecompressStreamBuf(Source source_)
+    : source(std::move(source_)), context(ZSTD_createDCtx()), input(ZSTD_DStreamInSize()),
+      output(ZSTD_DStreamOutSize()) {
+    setg(output.data(), output.data(), output.data());
+}
+
+ZSTDDecompressStreamBuf::~ZSTDDecompressStreamBuf() {
+    ZSTD_freeDCtx(context);
+}
+
+ZSTDDecompressStreamBuf::int_type ZSTDDecompressStreamBuf::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    while (true) {
+        if (input_pos == input_size) {
+            input_size = source(input);
+            input_pos = 0;
+            if (input_size == 0) {
+                return traits_type::eof();
+            }
+        }
+
+        ZSTD_inBuffer in{input.data(), input_size, input_pos};
+        ZSTD_outBuffer out{output.data(), output.size(), 0};
+        const std::size_t result = ZSTD_decompressStream(context, &out, &in);
+        input_pos = in.pos;
+        if (ZSTD_isError(result)) {
+            LOG_ERROR(Common, "Error decompressing ZSTD stream: {} ({})",
+                      ZSTD_getErrorName(result), result);
+            return traits_type::eof();
+        }
+        if (out.pos != 0) {
+            setg(output.data(), output.data(), output.data() + out.pos);
+            return traits_type::to_int_type(*gptr());
+        }
+    }
+}
+
 } // namespace Common::Compression
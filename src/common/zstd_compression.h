@@ -4,11 +4,16 @@
 
 #pragma once
 
+#include <functional>
 #include <span>
+#include <streambuf>
 #include <vector>
 
 #include "common/common_types.h"
 
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
 namespace Common::Compression {
 
 /**
@@ -40,4 +45,63 @@ namespace Common::Compression {
  */
 [[nodiscard]] std::vector<u8> DecompressDataZSTD(std::span<const u8> compressed);
 
+/**
+ * Stream buffer compressing everything written to it into a single Zstandard frame, which is
+ * handed to a sink in chunks as it is produced. Only a chunk of the uncompressed and of the
+ * compressed data are buffered at any time, and compression may run on worker threads.
+ */
+class ZSTDCompressStreamBuf final : public std::streambuf {
+public:
+    /// Receives the compressed data, returns false if it could not be consumed.
+    using Sink = std::function<bool(std::span<const u8>)>;
+
+    /**
+     * @param sink the destination of the compressed data.
+     * @param compression_level the used compression level. Should be between 1 and 22, or 0 for
+     *                          the default level.
+     * @param num_workers the number of compression threads, 0 to compress on the calling thread.
+     */
+    ZSTDCompressStreamBuf(Sink sink, s32 compression_level, u32 num_workers);
+    ~ZSTDCompressStreamBuf() override;
+
+    /// Compresses the remaining data and ends the frame. Returns false if an error happened.
+    [[nodiscard]] bool Finish();
+
+protected:
+    int_type overflow(int_type ch) override;
+
+private:
+    bool Compress(bool end_frame);
+
+    Sink sink;
+    ZSTD_CCtx_s* context;
+    std::vector<char> input;
+    std::vector<u8> output;
+    bool failed = false;
+};
+
+/**
+ * Stream buffer reading the data decompressed from Zstandard frames, with the compressed data
+ * pulled from a source in chunks as needed.
+ */
+class ZSTDDecompressStreamBuf final : public std::streambuf {
+public:
+    /// Fills the buffer with compressed data and returns the amount read, 0 at the end.
+    using Source = std::function<std::size_t(std::span<u8>)>;
+
+    explicit ZSTDDecompressStreamBuf(Source source);
+    ~ZSTDDecompressStreamBuf() override;
+
+protected:
+    int_type underflow() override;
+
+private:
+    Source source;
+    ZSTD_DCtx_s* context;
+    std::vector<u8> input;
+    std::size_t input_pos = 0;
+    std::size_t input_size = 0;
+    std::vector<char> output;
+};
+
 } // namespace Common::Compression
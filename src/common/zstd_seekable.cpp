@@ -0,0 +1,301 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <thread>
+#include <zstd.h>
+
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "common/thread_worker.h"
+#include "common/zstd_compression.h"
+#include "common/zstd_seekable.h"
+
+namespace Common::Compression {
+
+namespace {
+
+constexpr u32 SEEKABLE_MAGIC = 0x4B53'5A43; // "CZSK"
+constexpr u32 SEEKABLE_VERSION = 1;
+
+/// Size of the blocks written by the compressor. Bigger blocks compress better, smaller ones make
+/// small random reads cheaper.
+constexpr u32 DEFAULT_BLOCK_SIZE = 128 * 1024;
+constexpr u32 MIN_BLOCK_SIZE = 4 * 1024;
+constexpr u32 MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+/// Size of the decompressed blocks kept in the cache of a reader
+constexpr std::size_t CACHE_SIZE = 16 * 1024 * 1024;
+
+/// Maximum number of threads decompressing the blocks of a read
+constexpr std::size_t MAX_DECOMPRESS_WORKERS = 4;
+
+struct SeekableHeader {
+    u32_le magic;
+    u32_le version;
+    u32_le block_size;
+    u32_le num_blocks;
+    /// Size of the decompressed data
+    u64_le size;
+    /// Offset of the block index, which also ends the last block
+    u64_le index_offset;
+};
+static_assert(sizeof(SeekableHeader) == 32, "SeekableHeader has incorrect size");
+
+struct DecompressContextDeleter {
+    void operator()(ZSTD_DCtx* context) const {
+        ZSTD_freeDCtx(context);
+    }
+};
+using DecompressContext = std::unique_ptr<ZSTD_DCtx, DecompressContextDeleter>;
+
+} // Anonymous namespace
+
+class SeekableZSTDReader::Workers : public Common::StatefulThreadWorker<DecompressContext> {
+public:
+    Workers()
+        : StatefulThreadWorker(
+              std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1,
+                                      MAX_DECOMPRESS_WORKERS),
+              "ZSTD decompression", Common::ThreadRole::Emulation,
+              [](std::size_t) { return DecompressContext{ZSTD_createDCtx()}; }) {}
+};
+
+SeekableZSTDReader::SeekableZSTDReader(Source source_, u32 block_size_, u64 size_,
+                                       std::vector<u64> block_offsets_)
+    : source{std::move(source_)}, block_size{block_size_}, size{size_},
+      block_offsets{std::move(block_offsets_)},
+      cache_capacity{std::max<std::size_t>(CACHE_SIZE / block_size, 1)} {}
+
+SeekableZSTDReader::~SeekableZSTDReader() = default;
+
+std::unique_ptr<SeekableZSTDReader> SeekableZSTDReader::Open(Source source) {
+    SeekableHeader header;
+    if (source(std::span{reinterpret_cast<u8*>(&header), sizeof(header)}, 0) != sizeof(header) ||
+        header.magic != SEEKABLE_MAGIC) {
+        return nullptr;
+    }
+    if (header.version != SEEKABLE_VERSION) {
+        LOG_ERROR(Common, "Unsupported seekable ZSTD version {}", header.version);
+        return nullptr;
+    }
+    if (header.block_size < MIN_BLOCK_SIZE || header.block_size > MAX_BLOCK_SIZE ||
+        header.num_blocks != (header.size + header.block_size - 1) / header.block_size) {
+        LOG_ERROR(Common, "Invalid seekable ZSTD header, block_size={}, num_blocks={}, size={}",
+                  header.block_size, header.num_blocks, header.size);
+        return nullptr;
+    }
+
+    std::vector<u64_le> index(header.num_blocks);
+    const std::size_t index_size = index.size() * sizeof(u64_le);
+    if (source(std::span{reinterpret_cast<u8*>(index.data()), index_size},
+               header.index_offset) != index_size) {
+        LOG_ERROR(Common, "Failed to read the seekable ZSTD index");
+        return nullptr;
+    }
+
+    std::vector<u64> block_offsets(index.begin(), index.end());
+    block_offsets.push_back(header.index_offset);
+    u64 previous = sizeof(SeekableHeader);
+    for (const u64 offset : block_offsets) {
+        if (offset < previous) {
+            LOG_ERROR(Common, "Corrupted seekable ZSTD index");
+            return nullptr;
+        }
+        previous = offset;
+    }
+
+    return std::unique_ptr<SeekableZSTDReader>(new SeekableZSTDReader(
+        std::move(source), header.block_size, header.size, std::move(block_offsets)));
+}
+
+std::size_t SeekableZSTDReader::ReadAt(std::span<u8> data, u64 offset) {
+    if (offset >= size || data.empty()) {
+        return 0;
+    }
+    const std::size_t length = static_cast<std::size_t>(std::min<u64>(data.size(), size - offset));
+    const std::size_t first = static_cast<std::size_t>(offset / block_size);
+    const std::size_t last = static_cast<std::size_t>((offset + length - 1) / block_size);
+
+    std::vector<std::shared_ptr<const Block>> blocks(last - first + 1);
+    std::vector<std::size_t> missing;
+    for (std::size_t i = 0; i < blocks.size(); i++) {
+        blocks[i] = FindBlock(first + i);
+        if (!blocks[i]) {
+            missing.push_back(i);
+        }
+    }
+
+    if (!missing.empty()) {
+        // The calling thread decompresses the first missing block, the workers the others
+        std::vector<std::pair<std::size_t, std::future<std::shared_ptr<const Block>>>> pending;
+        if (missing.size() > 1) {
+            std::call_once(workers_flag, [this] { workers = std::make_unique<Workers>(); });
+            for (auto it = missing.begin() + 1; it != missing.end(); ++it) {
+                std::promise<std::shared_ptr<const Block>> promise;
+                pending.emplace_back(*it, promise.get_future());
+                workers->QueueWork([this, index = first + *it, promise = std::move(promise)](
+                                       DecompressContext* context) mutable {
+                    promise.set_value(LoadBlock(index, context->get()));
+                });
+            }
+        }
+        blocks[missing.front()] = LoadBlock(first + missing.front(), nullptr);
+        for (auto& [i, future] : pending) {
+            blocks[i] = future.get();
+        }
+    }
+
+    std::size_t read_progress = 0;
+    for (std::size_t i = 0; i < blocks.size() && read_progress < length; i++) {
+        if (!blocks[i]) {
+            break;
+        }
+        const std::size_t block_offset =
+            static_cast<std::size_t>(offset + read_progress - (first + i) * u64{block_size});
+        const std::size_t copy_amount =
+            std::min(blocks[i]->size() - block_offset, length - read_progress);
+        std::memcpy(data.data() + read_progress, blocks[i]->data() + block_offset, copy_amount);
+        read_progress += copy_amount;
+    }
+    return read_progress;
+}
+
+std::shared_ptr<const SeekableZSTDReader::Block> SeekableZSTDReader::FindBlock(std::size_t index) {
+    std::scoped_lock lock{cache_mutex};
+    const auto it = cache.find(index);
+    if (it == cache.end()) {
+        return nullptr;
+    }
+    lru.splice(lru.begin(), lru, it->second.first);
+    return it->second.second;
+}
+
+std::shared_ptr<const SeekableZSTDReader::Block> SeekableZSTDReader::LoadBlock(
+    std::size_t index, ZSTD_DCtx_s* context) {
+    const u64 begin = block_offsets[index];
+    const std::size_t decompressed_size =
+        static_cast<std::size_t>(std::min<u64>(block_size, size - index * u64{block_size}));
+
+    std::vector<u8> compressed(static_cast<std::size_t>(block_offsets[index + 1] - begin));
+    if (source(compressed, begin) != compressed.size()) {
+        LOG_ERROR(Common, "Failed to read seekable ZSTD block {}", index);
+        return nullptr;
+    }
+
+    std::shared_ptr<Block> block;
+    if (compressed.size() == decompressed_size) {
+        // Blocks that do not shrink are stored as is
+        block = std::make_shared<Block>(std::move(compressed));
+    } else {
+        block = std::make_shared<Block>(decompressed_size);
+        const std::size_t result =
+            context != nullptr
+                ? ZSTD_decompressDCtx(context, block->data(), block->size(), compressed.data(),
+                                      compressed.size())
+                : ZSTD_decompress(block->data(), block->size(), compressed.data(),
+                                  compressed.size());
+        if (ZSTD_isError(result) || result != decompressed_size) {
+            LOG_ERROR(Common, "Failed to decompress seekable ZSTD block {}: {}", index,
+                      ZSTD_isError(result) ? ZSTD_getErrorName(result) : "truncated");
+            return nullptr;
+        }
+    }
+
+    std::scoped_lock lock{cache_mutex};
+    const auto [it, inserted] = cache.try_emplace(index);
+    if (!inserted) {
+        // Loaded by another thread in the meantime
+        return it->second.second;
+    }
+    lru.push_front(index);
+    it->second = {lru.begin(), block};
+    if (cache.size() > cache_capacity) {
+        cache.erase(lru.back());
+        lru.pop_back();
+    }
+    return block;
+}
+
+bool CompressSeekableZSTD(FileUtil::IOFile& source, FileUtil::IOFile& destination,
+                          s32 compression_level, const std::function<void(u64, u64)>& progress) {
+    compression_level = compression_level == 0
+                            ? ZSTD_CLEVEL_DEFAULT
+                            : std::clamp(compression_level, ZSTD_minCLevel(), ZSTD_maxCLevel());
+    const u64 size = source.GetSize();
+    const u64 num_blocks = (size + DEFAULT_BLOCK_SIZE - 1) / DEFAULT_BLOCK_SIZE;
+    if (num_blocks > std::numeric_limits<u32>::max()) {
+        LOG_ERROR(Common, "File too big to compress, size={}", size);
+        return false;
+    }
+
+    SeekableHeader header{};
+    if (!source.Seek(0, SEEK_SET) || !destination.Seek(0, SEEK_SET) ||
+        destination.WriteObject(header) != 1) {
+        return false;
+    }
+
+    // Blocks are compressed in batches, one per worker, then written in order
+    Common::ThreadWorker workers(std::max(std::thread::hardware_concurrency(), 1U),
+                                 "ZSTD compression", Common::ThreadRole::Background);
+    const std::size_t batch_size = workers.NumWorkers();
+    std::vector<std::vector<u8>> batch(batch_size);
+    std::vector<std::vector<u8>> compressed(batch_size);
+    std::vector<u64_le> index;
+    index.reserve(static_cast<std::size_t>(num_blocks));
+    u64 position = sizeof(SeekableHeader);
+
+    for (u64 block = 0; block < num_blocks; block += batch_size) {
+        const std::size_t count =
+            static_cast<std::size_t>(std::min<u64>(batch_size, num_blocks - block));
+        for (std::size_t i = 0; i < count; i++) {
+            const u64 offset = (block + i) * DEFAULT_BLOCK_SIZE;
+            const u64 block_size = std::min<u64>(DEFAULT_BLOCK_SIZE, size - offset);
+            batch[i].resize(static_cast<std::size_t>(block_size));
+            if (source.ReadBytes(batch[i].data(), batch[i].size()) != batch[i].size()) {
+                LOG_ERROR(Common, "Failed to read the file to compress at offset {}", offset);
+                return false;
+            }
+            workers.QueueWork([&input = batch[i], &output = compressed[i], compression_level] {
+                output = CompressDataZSTD(input, compression_level);
+            });
+        }
+        workers.WaitForRequests();
+
+        for (std::size_t i = 0; i < count; i++) {
+            // Store the blocks that compression does not shrink, the reader tells them apart by
+            // their size
+            const bool store = compressed[i].empty() || compressed[i].size() >= batch[i].size();
+            const std::vector<u8>& data = store ? batch[i] : compressed[i];
+            if (destination.WriteBytes(data.data(), data.size()) != data.size()) {
+                return false;
+            }
+            index.push_back(position);
+            position += data.size();
+        }
+        if (progress) {
+            progress(std::min<u64>((block + count) * DEFAULT_BLOCK_SIZE, size), size);
+        }
+    }
+
+    const std::size_t index_size = index.size() * sizeof(u64_le);
+    if (destination.WriteBytes(index.data(), index_size) != index_size) {
+        return false;
+    }
+
+    header.magic = SEEKABLE_MAGIC;
+    header.version = SEEKABLE_VERSION;
+    header.block_size = DEFAULT_BLOCK_SIZE;
+    header.num_blocks = static_cast<u32>(num_blocks);
+    header.size = size;
+    header.index_offset = position;
+    return destination.Seek(0, SEEK_SET) && destination.WriteObject(header) == 1 &&
+           destination.Flush();
+}
+
+} // namespace Common::Compression
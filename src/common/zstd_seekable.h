@@ -0,0 +1,104 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+
+struct ZSTD_DCtx_s;
+
+namespace FileUtil {
+class IOFile;
+}
+
+namespace Common::Compression {
+
+/**
+ * Reads a file in the seekable Zstandard format. The data is split in blocks of a fixed size, each
+ * compressed into its own frame, and an index of the blocks follows them. Any part of the data can
+ * then be read by decompressing only the blocks holding it.
+ *
+ * The decompressed blocks are cached. When a read needs several blocks that are not cached, they
+ * are decompressed in parallel. Reads may come from several threads.
+ */
+class SeekableZSTDReader {
+public:
+    /// Reads compressed data at an offset of the file and returns the amount read.
+    using Source = std::function<std::size_t(std::span<u8>, u64)>;
+
+    ~SeekableZSTDReader();
+
+    /**
+     * Opens a file in the seekable format.
+     *
+     * @param source reads from the file, must be callable from several threads at once.
+     *
+     * @return the reader, or nullptr if the file is not in the seekable format or is corrupted.
+     */
+    [[nodiscard]] static std::unique_ptr<SeekableZSTDReader> Open(Source source);
+
+    /// Returns the size of the decompressed data.
+    [[nodiscard]] u64 GetSize() const {
+        return size;
+    }
+
+    /// Reads decompressed data at an offset and returns the amount read.
+    std::size_t ReadAt(std::span<u8> data, u64 offset);
+
+private:
+    class Workers;
+    using Block = std::vector<u8>;
+
+    SeekableZSTDReader(Source source, u32 block_size, u64 size, std::vector<u64> block_offsets);
+
+    /// Returns a cached block, or nullptr if it is not cached.
+    std::shared_ptr<const Block> FindBlock(std::size_t index);
+
+    /// Reads and decompresses a block with a context if not null, caching it. Returns nullptr on
+    /// failure.
+    std::shared_ptr<const Block> LoadBlock(std::size_t index, ZSTD_DCtx_s* context);
+
+    Source source;
+    u32 block_size;
+    u64 size;
+    /// Offsets of the compressed blocks in the file, followed by the end of the last one
+    std::vector<u64> block_offsets;
+
+    std::mutex cache_mutex;
+    std::size_t cache_capacity;
+    /// Indices of the cached blocks, the most recently used first
+    std::list<std::size_t> lru;
+    std::unordered_map<std::size_t,
+                       std::pair<std::list<std::size_t>::iterator, std::shared_ptr<const Block>>>
+        cache;
+
+    /// Created on the first read needing several blocks
+    std::once_flag workers_flag;
+    std::unique_ptr<Workers> workers;
+};
+
+/**
+ * Compresses a whole file into the seekable Zstandard format.
+ *
+ * @param source the file to compress, read from its beginning.
+ * @param destination the file receiving the compressed data, written from its current position.
+ * @param compression_level the used compression level. Should be between 1 and 22, or 0 for the
+ *                          default level.
+ * @param progress called with the amount of data compressed and the total, may be empty.
+ *
+ * @return whether the file was compressed.
+ */
+[[nodiscard]] bool CompressSeekableZSTD(FileUtil::IOFile& source, FileUtil::IOFile& destination,
+                                        s32 compression_level,
+                                        const std::function<void(u64, u64)>& progress = {});
+
+} // namespace Common::Compression
@@ -26,42 +26,50 @@ public:
     ~DynarmicUserCallbacks() = default;
 
     std::uint8_t MemoryRead8(VAddr vaddr) override {
+        const auto lock = parent.system.AcquireCore(parent);
         return memory.Read8(vaddr);
     }
     std::uint16_t MemoryRead16(VAddr vaddr) override {
+        const auto lock = parent.system.AcquireCore(parent);
         return memory.Read16(vaddr);
     }
     std::uint32_t MemoryRead32(VAddr vaddr) override {
+        const auto lock = parent.system.AcquireCore(parent);
         return memory.Read32(vaddr);
     }
     std::uint64_t MemoryRead64(VAddr vaddr) override {
+        const auto lock = parent.system.AcquireCore(parent);
         return memory.Read64(vaddr);
     }
 
     void MemoryWrite8(VAddr vaddr, std::uint8_t value) override {
+        const auto lock = parent.system.AcquireCore(parent);
         memory.Write8(vaddr, value);
     }
     void MemoryWrite16(VAddr vaddr, std::uint16_t value) override {
+        const auto lock = parent.system.AcquireCore(parent);
         memory.Write16(vaddr, value);
     }
     void MemoryWrite32(VAddr vaddr, std::uint32_t value) override {
+        const auto lock = parent.system.AcquireCore(parent);
         memory.Write32(vaddr, value);
     }
     void MemoryWrite64(VAddr vaddr, std::uint64_t value) override {
+        const auto lock = parent.system.AcquireCore(parent);
         memory.Write64(vaddr, value);
     }
 
     bool MemoryWriteExclusive8(u32 vaddr, u8 value, u8 expected) override {
-        return memory.WriteExclusive8(vaddr, value, expected);
+        return WriteExclusive(vaddr, value, expected, &Memory::MemorySystem::WriteExclusive8);
     }
     bool MemoryWriteExclusive16(u32 vaddr, u16 value, u16 expected) override {
-        return memory.WriteExclusive16(vaddr, value, expected);
+        return WriteExclusive(vaddr, value, expected, &Memory::MemorySystem::WriteExclusive16);
     }
     bool MemoryWriteExclusive32(u32 vaddr, u32 value, u32 expected) override {
-        return memory.WriteExclusive32(vaddr, value, expected);
+        return WriteExclusive(vaddr, value, expected, &Memory::MemorySystem::WriteExclusive32);
     }
     bool MemoryWriteExclusive64(u32 vaddr, u64 value, u64 expected) override {
-        return memory.WriteExclusive64(vaddr, value, expected);
+        return WriteExclusive(vaddr, value, expected, &Memory::MemorySystem::WriteExclusive64);
     }
 
     void InterpreterFallback(VAddr pc, std::size_t num_instructions) override {
@@ -71,6 +79,10 @@ public:
     }
 
     void CallSVC(std::uint32_t swi) override {
+        if (svc_context.CallCoreLocalSVC(parent, swi)) {
+            return;
+        }
+        const auto lock = parent.system.AcquireCore(parent);
         svc_context.CallSVC(swi);
     }
 
@@ -114,6 +126,20 @@ public:
         return Core::TicksForInstruction(is_thumb, instruction);
     }
 
+    template <typename T>
+    bool WriteExclusive(VAddr vaddr, T value, T expected,
+                        bool (Memory::MemorySystem::*fallback)(VAddr, T, T)) {
+        // Guest spinlocks would otherwise make every core contend for the lock of the system.
+        if (parent.current_page_table) {
+            if (const auto result = DynarmicExclusiveMonitor::TryWriteExclusive(
+                    *parent.current_page_table, vaddr, value, expected)) {
+                return *result;
+            }
+        }
+        const auto lock = parent.system.AcquireCore(parent);
+        return (memory.*fallback)(vaddr, value, expected);
+    }
+
     ARM_Dynarmic& parent;
     Kernel::SVCContext svc_context;
     Memory::MemorySystem& memory;
@@ -133,7 +159,8 @@ ARM_Dynarmic::~ARM_Dynarmic() = default;
 MICROPROFILE_DEFINE(ARM_Jit, "ARM JIT", "ARM JIT", MP_RGB(255, 64, 64));
 
 void ARM_Dynarmic::Run() {
-    ASSERT(memory.GetCurrentPageTable() == current_page_table);
+    // With multi-core emulation the memory system follows whichever core last entered it.
+    ASSERT(system.IsMultiCoreRunning() || memory.GetCurrentPageTable() == current_page_table);
     MICROPROFILE_SCOPE(ARM_Jit);
 
     jit->Run();
@@ -272,6 +299,11 @@ std::shared_ptr<Memory::PageTable> ARM_Dynarmic::GetPageTable() const {
 }
 
 void ARM_Dynarmic::SetPageTable(const std::shared_ptr<Memory::PageTable>& page_table) {
+    // Switching to the running core on kernel entry re-applies its own page table. Avoid round
+    // tripping the context through the JIT in the middle of a block for that.
+    if (jit && page_table == current_page_table) {
+        return;
+    }
     current_page_table = page_table;
     ThreadContext ctx{};
     if (jit) {
@@ -303,6 +335,14 @@ std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
     config.callbacks = cb.get();
     if (current_page_table) {
         config.page_table = &current_page_table->GetPointerArray();
+        // Pages that are not mapped in the arena fault and are retried through the callbacks.
+        if (u8* fastmem_pointer = current_page_table->GetFastmemPointer()) {
+            config.fastmem_pointer = reinterpret_cast<uintptr_t>(fastmem_pointer);
+            // Exclusive stores become a compare-exchange on the arena, blocks that fault on it
+            // are recompiled to go through the callbacks.
+            config.fastmem_exclusive_access = true;
+            config.recompile_on_exclusive_fastmem_failure = true;
+        }
     }
     config.coprocessors[15] = std::make_shared<DynarmicCP15>(cp15_state);
     config.define_unpredictable_behaviour = true;
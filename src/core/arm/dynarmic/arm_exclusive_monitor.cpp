@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <atomic>
 #include "core/arm/dynarmic/arm_exclusive_monitor.h"
 #include "core/memory.h"
 
@@ -56,4 +57,28 @@ bool DynarmicExclusiveMonitor::ExclusiveWrite64(std::size_t core_index, VAddr va
     });
 }
 
+template <typename T>
+std::optional<bool> DynarmicExclusiveMonitor::TryWriteExclusive(Memory::PageTable& page_table,
+                                                                VAddr vaddr, T value, T expected) {
+    // Pages are host aligned, so an aligned guest address is aligned for the host atomic too.
+    if (vaddr % sizeof(T) != 0) {
+        return std::nullopt;
+    }
+    u8* page_pointer = page_table.GetPointerArray()[vaddr >> Memory::CITRA_PAGE_BITS];
+    if (!page_pointer) {
+        return std::nullopt;
+    }
+    T& target = *reinterpret_cast<T*>(page_pointer + (vaddr & Memory::CITRA_PAGE_MASK));
+    return std::atomic_ref<T>{target}.compare_exchange_strong(expected, value);
+}
+
+template std::optional<bool> DynarmicExclusiveMonitor::TryWriteExclusive<u8>(Memory::PageTable&,
+                                                                             VAddr, u8, u8);
+template std::optional<bool> DynarmicExclusiveMonitor::TryWriteExclusive<u16>(Memory::PageTable&,
+                                                                              VAddr, u16, u16);
+template std::optional<bool> DynarmicExclusiveMonitor::TryWriteExclusive<u32>(Memory::PageTable&,
+                                                                              VAddr, u32, u32);
+template std::optional<bool> DynarmicExclusiveMonitor::TryWriteExclusive<u64>(Memory::PageTable&,
+                                                                              VAddr, u64, u64);
+
 } // namespace Core
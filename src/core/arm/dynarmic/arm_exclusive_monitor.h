@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <optional>
 #include <dynarmic/interface/exclusive_monitor.h>
 
 #include "common/common_types.h"
@@ -10,8 +11,9 @@
 #include "core/arm/exclusive_monitor.h"
 
 namespace Memory {
+struct PageTable;
 class MemorySystem;
-}
+} // namespace Memory
 
 namespace Core {
 
@@ -31,6 +33,16 @@ public:
     bool ExclusiveWrite32(std::size_t core_index, VAddr vaddr, u32 value) override;
     bool ExclusiveWrite64(std::size_t core_index, VAddr vaddr, u64 value) override;
 
+    /**
+     * Performs the store of an exclusive write as a host compare-exchange on the page it maps
+     * to, without serializing the cores. Only naturally aligned accesses to pages with a host
+     * pointer are handled, others must go through the memory system.
+     * @returns Whether the value was exchanged, or nullopt if the access was not handled.
+     */
+    template <typename T>
+    static std::optional<bool> TryWriteExclusive(Memory::PageTable& page_table, VAddr vaddr,
+                                                 T value, T expected);
+
 private:
     friend class Core::ARM_Dynarmic;
     Dynarmic::ExclusiveMonitor monitor;
@@ -33,6 +33,7 @@ void ARM_DynCom::Step() {
 
 void ARM_DynCom::ClearInstructionCache() {
     state->instruction_cache.clear();
+    state->block_lookup.fill({});
     trans_cache_buf_top = 0;
 }
 
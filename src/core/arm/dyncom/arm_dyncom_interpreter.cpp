@@ -5,6 +5,7 @@
 #define CITRA_IGNORE_EXIT(x)
 
 #include <algorithm>
+#include <array>
 #include <cstdio>
 #include "common/common_types.h"
 #include "common/logging/log.h"
@@ -33,12 +34,8 @@
 #define ROTATE_RIGHT_32(n, i) ROTATE_RIGHT(n, i, 32)
 #define ROTATE_LEFT_32(n, i) ROTATE_LEFT(n, i, 32)
 
-static bool CondPassed(const ARMul_State* cpu, unsigned int cond) {
-    const bool n_flag = cpu->NFlag != 0;
-    const bool z_flag = cpu->ZFlag != 0;
-    const bool c_flag = cpu->CFlag != 0;
-    const bool v_flag = cpu->VFlag != 0;
-
+static constexpr bool EvaluateCondition(unsigned int cond, bool n_flag, bool z_flag, bool c_flag,
+                                        bool v_flag) {
     switch (cond) {
     case ConditionCode::EQ:
         return z_flag;
@@ -76,6 +73,28 @@ static bool CondPassed(const ARMul_State* cpu, unsigned int cond) {
     return false;
 }
 
+// Bit nzcv of the entry of a condition is set if the condition passes with the NZCV flags packed
+// as nzcv, which turns the evaluation of a condition into a table lookup.
+static constexpr std::array<u16, 16> CONDITION_TABLE = [] {
+    std::array<u16, 16> table{};
+    for (unsigned int cond = 0; cond < 16; cond++) {
+        for (unsigned int nzcv = 0; nzcv < 16; nzcv++) {
+            if (EvaluateCondition(cond, nzcv & 8, nzcv & 4, nzcv & 2, nzcv & 1)) {
+                table[cond] |= static_cast<u16>(1 << nzcv);
+            }
+        }
+    }
+    return table;
+}();
+
+static bool CondPassed(const ARMul_State* cpu, unsigned int cond) {
+    const unsigned int nzcv = (static_cast<unsigned int>(cpu->NFlag != 0) << 3) |
+                              (static_cast<unsigned int>(cpu->ZFlag != 0) << 2) |
+                              (static_cast<unsigned int>(cpu->CFlag != 0) << 1) |
+                              static_cast<unsigned int>(cpu->VFlag != 0);
+    return (CONDITION_TABLE[cond & 0xF] >> nzcv) & 1;
+}
+
 static unsigned int DPO(Immediate)(ARMul_State* cpu, unsigned int sht_oper) {
     unsigned int immed_8 = BITS(sht_oper, 0, 7);
     unsigned int rotate_imm = BITS(sht_oper, 8, 11);
@@ -922,6 +941,12 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     GDBStub::BreakpointAddress breakpoint_data;
     breakpoint_data.type = GDBStub::BreakpointType::None;
 
+#ifndef ANDROID
+    // Checked once per run rather than on every instruction. Without the stub, the thumb bit of
+    // the CPSR is only brought up to date when it can be observed: on SVCs and on exit.
+    const bool gdb_enabled = GDBStub::IsServerEnabled();
+#endif
+
 #undef RM
 #undef RS
 
@@ -952,9 +977,9 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
 #define GDB_BP_CHECK
 #else
 #define GDB_BP_CHECK                                                                               \
-    cpu->Cpsr &= ~(1 << 5);                                                                        \
-    cpu->Cpsr |= cpu->TFlag << 5;                                                                  \
-    if (GDBStub::IsServerEnabled()) {                                                              \
+    if (gdb_enabled) {                                                                             \
+        cpu->Cpsr &= ~(1 << 5);                                                                    \
+        cpu->Cpsr |= cpu->TFlag << 5;                                                              \
         if (GDBStub::IsMemoryBreak()) {                                                            \
             goto END;                                                                              \
         } else if (breakpoint_data.type != GDBStub::BreakpointType::None &&                        \
@@ -1640,20 +1665,27 @@ DISPATCH : {
         cpu->Reg[15] &= 0xfffffffc;
 
     // Find the cached instruction cream, otherwise translate it...
-    auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
-    if (itr != cpu->instruction_cache.end()) {
-        ptr = itr->second;
-    } else if (cpu->NumInstrsToExecute != 1) {
-        if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
+    auto& lookup = cpu->block_lookup[(cpu->Reg[15] >> 1) % cpu->block_lookup.size()];
+    if (lookup.pc == cpu->Reg[15]) {
+        ptr = lookup.ptr;
     } else {
-        if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
+        auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
+        if (itr != cpu->instruction_cache.end()) {
+            ptr = itr->second;
+        } else if (cpu->NumInstrsToExecute != 1) {
+            if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
+                goto END;
+        } else {
+            if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
+                goto END;
+        }
+        lookup.pc = cpu->Reg[15];
+        lookup.ptr = ptr;
     }
 
 #ifndef ANDROID
     // Find breakpoint if one exists within the block
-    if (GDBStub::IsConnected()) {
+    if (gdb_enabled && GDBStub::IsConnected()) {
         breakpoint_data =
             GDBStub::GetNextBreakpointFromAddress(cpu->Reg[15], GDBStub::BreakpointType::Execute);
     }
@@ -3869,6 +3901,7 @@ SWI_INST : {
         cpu->NumInstrsToExecute =
             num_instrs >= cpu->NumInstrsToExecute ? 0 : cpu->NumInstrsToExecute - num_instrs;
         num_instrs = 0;
+        cpu->Cpsr = (cpu->Cpsr & ~(1 << 5)) | (cpu->TFlag << 5);
         Kernel::SVCContext{cpu->system}.CallSVC(inst_cream->num & 0xFFFF);
         // The kernel would call ERET to get here, which clears exclusive memory state.
         cpu->UnsetExclusiveMemoryAddress();
@@ -256,6 +256,15 @@ public:
     // process for our purposes), not per ARMul_State (which tracks CPU core state).
     std::unordered_map<u32, std::size_t> instruction_cache;
 
+    struct BlockLookup {
+        u32 pc = 1; // Never matches, dispatched addresses are at least halfword aligned
+        std::size_t ptr = 0;
+    };
+
+    /// Direct-mapped cache in front of instruction_cache, which is searched on every branch.
+    /// Cleared together with instruction_cache.
+    std::array<BlockLookup, 1024> block_lookup{};
+
 private:
     void ResetMPCoreCP15Registers();
 
@@ -32,6 +32,9 @@
 
 #pragma once
 
+#include <bit>
+#include <cmath>
+#include <type_traits>
 #include "common/common_types.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/arm/skyeye_common/vfp/asm_vfp.h"
@@ -422,3 +425,107 @@ u32 vfp_double_multiply(vfp_double* vdd, vfp_double* vdn, vfp_double* vdm, u32 f
 u32 vfp_double_add(vfp_double* vdd, vfp_double* vdn, vfp_double* vdm, u32 fpscr);
 u32 vfp_double_normaliseround(ARMul_State* state, int dd, vfp_double* vd, u32 fpscr, u32 exceptions,
                               const char* func);
+
+/*
+ * Host floating point fast path for fadd, fsub, fmul and fdiv. In round to nearest mode, with
+ * operands and results well inside the normal range, the host FPU gives the same results as the
+ * soft-float code, which only differs from it in the handling of NaNs, infinities, denormals,
+ * flush-to-zero and the directed rounding modes. Inexactness is found from the exact error term
+ * of the operation, so that the cumulative exception flags match too. These return false when
+ * the operation has to go through the soft-float code, otherwise the result to write back.
+ */
+enum class VFPHostOp { Add, Sub, Mul, Div };
+
+template <typename T>
+inline bool vfp_host_arith(T a, T b, VFPHostOp op, T* result, bool* inexact) {
+    // The error terms of float operations are computed exactly as doubles
+    using Wide = std::conditional_t<std::is_same_v<T, float>, double, T>;
+    switch (op) {
+    case VFPHostOp::Sub:
+        b = -b;
+        [[fallthrough]];
+    case VFPHostOp::Add: {
+        // Knuth's TwoSum, err is the exact rounding error of a + b
+        const T sum = a + b;
+        const T b_virtual = sum - a;
+        const T err = (a - (sum - b_virtual)) + (b - b_virtual);
+        *result = sum;
+        *inexact = err != 0;
+        return true;
+    }
+    case VFPHostOp::Mul:
+        *result = a * b;
+        if constexpr (std::is_same_v<T, float>) {
+            *inexact = Wide(*result) != Wide(a) * Wide(b);
+        } else {
+            *inexact = std::fma(a, b, -*result) != 0;
+        }
+        return true;
+    case VFPHostOp::Div:
+        *result = a / b;
+        if constexpr (std::is_same_v<T, float>) {
+            *inexact = Wide(*result) * Wide(b) != Wide(a);
+        } else {
+            *inexact = std::fma(*result, b, -a) != 0;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Any normal single is accepted, but not results in the lowest binade, where the soft-float code
+// may raise an underflow for a tiny value that rounded up to the smallest normal.
+inline bool vfp_single_host_operand(u32 bits) {
+    const u32 exponent = (bits >> 23) & 0xFF;
+    return exponent != 0 && exponent != 0xFF;
+}
+
+inline bool vfp_single_host_result(u32 bits) {
+    const u32 exponent = (bits >> 23) & 0xFF;
+    return exponent > 1 && exponent != 0xFF;
+}
+
+inline bool vfp_single_host_op(s32 n, s32 m, u32 fpscr, VFPHostOp op, s32* result_bits,
+                               u32* exceptions) {
+    if ((fpscr & FPSCR_RMODE_MASK) != FPSCR_ROUND_NEAREST || !vfp_single_host_operand(n) ||
+        !vfp_single_host_operand(m)) {
+        return false;
+    }
+
+    float result;
+    bool inexact;
+    vfp_host_arith(std::bit_cast<float>(n), std::bit_cast<float>(m), op, &result, &inexact);
+    const u32 bits = std::bit_cast<u32>(result);
+    if (!vfp_single_host_result(bits)) {
+        return false;
+    }
+    *result_bits = static_cast<s32>(bits);
+    *exceptions = inexact ? FPSCR_IXC : 0;
+    return true;
+}
+
+// The error terms of double operations are computed in double precision, so the operands and
+// results are kept within 2^+-485, where those terms can't underflow.
+inline bool vfp_double_host_value(u64 bits) {
+    const u32 exponent = static_cast<u32>(bits >> 52) & 0x7FF;
+    return exponent >= 1023 - 485 && exponent <= 1023 + 485;
+}
+
+inline bool vfp_double_host_op(u64 n, u64 m, u32 fpscr, VFPHostOp op, u64* result_bits,
+                               u32* exceptions) {
+    if ((fpscr & FPSCR_RMODE_MASK) != FPSCR_ROUND_NEAREST || !vfp_double_host_value(n) ||
+        !vfp_double_host_value(m)) {
+        return false;
+    }
+
+    double result;
+    bool inexact;
+    vfp_host_arith(std::bit_cast<double>(n), std::bit_cast<double>(m), op, &result, &inexact);
+    const u64 bits = std::bit_cast<u64>(result);
+    if (!vfp_double_host_value(bits)) {
+        return false;
+    }
+    *result_bits = bits;
+    *exceptions = inexact ? FPSCR_IXC : 0;
+    return true;
+}
@@ -970,6 +970,13 @@ static u32 vfp_double_fmul(ARMul_State* state, int dd, int dn, int dm, u32 fpscr
     u32 exceptions = 0;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
+    u64 result;
+    if (vfp_double_host_op(vfp_get_double(state, dn), vfp_get_double(state, dm), fpscr,
+                           VFPHostOp::Mul, &result, &exceptions)) {
+        vfp_put_double(state, result, dd);
+        return exceptions;
+    }
+
     exceptions |= vfp_double_unpack(&vdn, vfp_get_double(state, dn), fpscr);
     if (vdn.exponent == 0 && vdn.significand)
         vfp_double_normalise_denormal(&vdn);
@@ -1012,6 +1019,13 @@ static u32 vfp_double_fadd(ARMul_State* state, int dd, int dn, int dm, u32 fpscr
     u32 exceptions = 0;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
+    u64 result;
+    if (vfp_double_host_op(vfp_get_double(state, dn), vfp_get_double(state, dm), fpscr,
+                           VFPHostOp::Add, &result, &exceptions)) {
+        vfp_put_double(state, result, dd);
+        return exceptions;
+    }
+
     exceptions |= vfp_double_unpack(&vdn, vfp_get_double(state, dn), fpscr);
     if (vdn.exponent == 0 && vdn.significand)
         vfp_double_normalise_denormal(&vdn);
@@ -1033,6 +1047,13 @@ static u32 vfp_double_fsub(ARMul_State* state, int dd, int dn, int dm, u32 fpscr
     u32 exceptions = 0;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
+    u64 result;
+    if (vfp_double_host_op(vfp_get_double(state, dn), vfp_get_double(state, dm), fpscr,
+                           VFPHostOp::Sub, &result, &exceptions)) {
+        vfp_put_double(state, result, dd);
+        return exceptions;
+    }
+
     exceptions |= vfp_double_unpack(&vdn, vfp_get_double(state, dn), fpscr);
     if (vdn.exponent == 0 && vdn.significand)
         vfp_double_normalise_denormal(&vdn);
@@ -1060,6 +1081,13 @@ static u32 vfp_double_fdiv(ARMul_State* state, int dd, int dn, int dm, u32 fpscr
     int tm, tn;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
+    u64 result;
+    if (vfp_double_host_op(vfp_get_double(state, dn), vfp_get_double(state, dm), fpscr,
+                           VFPHostOp::Div, &result, &exceptions)) {
+        vfp_put_double(state, result, dd);
+        return exceptions;
+    }
+
     exceptions |= vfp_double_unpack(&vdn, vfp_get_double(state, dn), fpscr);
     exceptions |= vfp_double_unpack(&vdm, vfp_get_double(state, dm), fpscr);
 
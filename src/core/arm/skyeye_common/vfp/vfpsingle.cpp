@@ -996,6 +996,12 @@ static u32 vfp_single_fmul(ARMul_State* state, int sd, int sn, s32 m, u32 fpscr)
 
     LOG_TRACE(Core_ARM11, "s{} = {:08x}", sn, n);
 
+    s32 result;
+    if (vfp_single_host_op(n, m, fpscr, VFPHostOp::Mul, &result, &exceptions)) {
+        vfp_put_float(state, result, sd);
+        return exceptions;
+    }
+
     exceptions |= vfp_single_unpack(&vsn, n, fpscr);
     if (vsn.exponent == 0 && vsn.significand)
         vfp_single_normalise_denormal(&vsn);
@@ -1041,6 +1047,12 @@ static u32 vfp_single_fadd(ARMul_State* state, int sd, int sn, s32 m, u32 fpscr)
 
     LOG_TRACE(Core_ARM11, "s{} = {:08x}", sn, n);
 
+    s32 result;
+    if (vfp_single_host_op(n, m, fpscr, VFPHostOp::Add, &result, &exceptions)) {
+        vfp_put_float(state, result, sd);
+        return exceptions;
+    }
+
     /*
      * Unpack and normalise denormals.
      */
@@ -1092,6 +1104,12 @@ static u32 vfp_single_fdiv(ARMul_State* state, int sd, int sn, s32 m, u32 fpscr)
 
     LOG_TRACE(Core_ARM11, "s{} = {:08x}", sn, n);
 
+    s32 result;
+    if (vfp_single_host_op(n, m, fpscr, VFPHostOp::Div, &result, &exceptions)) {
+        vfp_put_float(state, result, sd);
+        return exceptions;
+    }
+
     exceptions |= vfp_single_unpack(&vsn, n, fpscr);
     exceptions |= vfp_single_unpack(&vsm, m, fpscr);
 
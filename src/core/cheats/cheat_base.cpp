@@ -2,8 +2,31 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "core/cheats/cheat_base.h"
+#include "core/core.h"
 
 namespace Cheats {
+
+void WrittenRanges::Invalidate(Core::System& system) {
+    if (ranges.empty()) {
+        return;
+    }
+    std::sort(ranges.begin(), ranges.end(),
+              [](const Range& lhs, const Range& rhs) { return lhs.address < rhs.address; });
+    VAddr start = ranges[0].address;
+    u64 end = u64{start} + ranges[0].size;
+    for (std::size_t i = 1; i < ranges.size(); i++) {
+        if (ranges[i].address > end) {
+            system.InvalidateCacheRange(start, static_cast<std::size_t>(end - start));
+            start = ranges[i].address;
+            end = start;
+        }
+        end = std::max(end, u64{ranges[i].address} + ranges[i].size);
+    }
+    system.InvalidateCacheRange(start, static_cast<std::size_t>(end - start));
+    ranges.clear();
+}
+
 CheatBase::~CheatBase() = default;
 } // namespace Cheats
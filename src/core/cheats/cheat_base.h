@@ -5,16 +5,40 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include "common/common_types.h"
 
 namespace Core {
 class System;
 }
 
 namespace Cheats {
+
+/**
+ * Guest memory written by cheats. The cached code of the CPU cores is invalidated once for all
+ * the writes of the cheats run together, instead of after each write.
+ */
+class WrittenRanges {
+public:
+    void Add(VAddr address, u32 size) {
+        ranges.push_back({address, size});
+    }
+
+    /// Invalidates the cached code of the written ranges, merging the overlapping ones.
+    void Invalidate(Core::System& system);
+
+private:
+    struct Range {
+        VAddr address;
+        u32 size;
+    };
+    std::vector<Range> ranges;
+};
+
 class CheatBase {
 public:
     virtual ~CheatBase();
-    virtual void Execute(Core::System& system) const = 0;
+    virtual void Execute(Core::System& system, WrittenRanges& written) const = 0;
 
     virtual bool IsEnabled() const = 0;
     virtual void SetEnabled(bool enabled) = 0;
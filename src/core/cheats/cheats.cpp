@@ -107,10 +107,11 @@ void CheatEngine::RunCallback([[maybe_unused]] std::uintptr_t user_data, s64 cyc
         std::shared_lock lock{cheats_list_mutex};
         for (const auto& cheat : cheats_list) {
             if (cheat->IsEnabled()) {
-                cheat->Execute(system);
+                cheat->Execute(system, written_ranges);
             }
         }
     }
+    written_ranges.Invalidate(system);
     system.CoreTiming().ScheduleEvent(run_interval_ticks - cycles_late, event);
 }
 
@@ -10,6 +10,7 @@
 #include <span>
 #include <vector>
 #include "common/common_types.h"
+#include "core/cheats/cheat_base.h"
 
 namespace Core {
 class System;
@@ -22,8 +23,6 @@ struct EventType;
 
 namespace Cheats {
 
-class CheatBase;
-
 class CheatEngine {
 public:
     explicit CheatEngine(Core::System& system);
@@ -59,6 +58,8 @@ private:
     Core::TimingEventType* event;
     std::optional<u64> loaded_title_id;
     std::vector<std::shared_ptr<CheatBase>> cheats_list;
+    /// Memory written by the cheats of a run, kept to reuse its allocation
+    WrittenRanges written_ranges;
     mutable std::shared_mutex cheats_list_mutex;
 };
 } // namespace Cheats
@@ -3,7 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
-#include <cmath>
+#include <array>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <span>
@@ -26,46 +27,61 @@ struct State {
     u32 offset = 0;
     u32 if_flag = 0;
     u32 loop_count = 0;
-    std::size_t loop_back_line = 0;
-    std::size_t current_line_nr = 0;
+    std::size_t loop_back_instruction = 0;
+    std::size_t current_instruction = 0;
     bool loop_flag = false;
 };
 
-template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> WriteOp(const GatewayCheat::CheatLine& line,
-                                                              const State& state,
-                                                              ReadFunction read_func,
-                                                              WriteFunction write_func,
-                                                              Core::System& system) {
-    u32 addr = line.address + state.offset;
-    T val = read_func(addr);
-    if (val != static_cast<T>(line.value)) {
-        write_func(addr, static_cast<T>(line.value));
-        system.InvalidateCacheRange(addr, sizeof(T));
+template <typename T>
+static inline T ReadMemory(Memory::MemorySystem& memory, VAddr addr) {
+    if constexpr (sizeof(T) == 1) {
+        return memory.Read8(addr);
+    } else if constexpr (sizeof(T) == 2) {
+        return memory.Read16(addr);
+    } else {
+        return memory.Read32(addr);
+    }
+}
+
+/// Writes a value unless the memory already holds it, so that pinned values cost a read only.
+template <typename T>
+static inline void WriteOp(Memory::MemorySystem& memory, WrittenRanges& written, VAddr addr,
+                           T value) {
+    if (ReadMemory<T>(memory, addr) == value) {
+        return;
+    }
+    if constexpr (sizeof(T) == 1) {
+        memory.Write8(addr, value);
+    } else if constexpr (sizeof(T) == 2) {
+        memory.Write16(addr, value);
+    } else {
+        memory.Write32(addr, value);
     }
+    written.Add(addr, sizeof(T));
 }
 
-template <typename T, typename ReadFunction, typename CompareFunc>
-static inline std::enable_if_t<std::is_integral_v<T>> CompOp(const GatewayCheat::CheatLine& line,
-                                                             State& state, ReadFunction read_func,
-                                                             CompareFunc comp) {
-    u32 addr = line.address + state.offset;
-    T val = read_func(addr);
-    if (!comp(val)) {
+template <typename T, typename CompareFunc>
+static inline void CompOp(Memory::MemorySystem& memory, VAddr addr, State& state,
+                          CompareFunc comp) {
+    if (!comp(ReadMemory<T>(memory, addr))) {
         state.if_flag++;
     }
 }
 
-static inline void LoadOffsetOp(Memory::MemorySystem& memory, const GatewayCheat::CheatLine& line,
-                                State& state) {
-    u32 addr = line.address + state.offset;
-    state.offset = memory.Read32(addr);
+/// Compares the halfword at addr masked by the upper half of value with its lower half.
+template <typename CompareFunc>
+static inline void CompMaskedOp(Memory::MemorySystem& memory, VAddr addr, u32 value, State& state,
+                                CompareFunc comp) {
+    const auto mask = static_cast<u16>(~value >> 16);
+    const auto operand = static_cast<u16>(value);
+    CompOp<u16>(memory, addr, state,
+                [&](u16 val) { return comp(operand, static_cast<u16>(mask & val)); });
 }
 
-static inline void LoopOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.loop_flag = state.loop_count < line.value;
+static inline void LoopOp(u32 value, State& state) {
+    state.loop_flag = state.loop_count < value;
     state.loop_count++;
-    state.loop_back_line = state.current_line_nr;
+    state.loop_back_instruction = state.current_instruction;
 }
 
 static inline void TerminateOp(State& state) {
@@ -76,7 +92,7 @@ static inline void TerminateOp(State& state) {
 
 static inline void LoopExecuteVariantOp(State& state) {
     if (state.loop_flag) {
-        state.current_line_nr = state.loop_back_line - 1;
+        state.current_instruction = state.loop_back_instruction - 1;
     } else {
         state.loop_count = 0;
     }
@@ -84,7 +100,7 @@ static inline void LoopExecuteVariantOp(State& state) {
 
 static inline void FullTerminateOp(State& state) {
     if (state.loop_flag) {
-        state.current_line_nr = state.loop_back_line - 1;
+        state.current_instruction = state.loop_back_instruction - 1;
     } else {
         state.offset = 0;
         state.reg = 0;
@@ -94,90 +110,39 @@ static inline void FullTerminateOp(State& state) {
     }
 }
 
-static inline void SetOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.offset = line.value;
-}
-
-static inline void AddValueOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.reg += line.value;
-}
-
-static inline void SetValueOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.reg = line.value;
-}
-
-template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> IncrementiveWriteOp(
-    const GatewayCheat::CheatLine& line, State& state, ReadFunction read_func,
-    WriteFunction write_func, Core::System& system) {
-    u32 addr = line.value + state.offset;
-    T val = read_func(addr);
-    if (val != static_cast<T>(state.reg)) {
-        write_func(addr, static_cast<T>(state.reg));
-        system.InvalidateCacheRange(addr, sizeof(T));
-    }
+template <typename T>
+static inline void IncrementiveWriteOp(Memory::MemorySystem& memory, WrittenRanges& written,
+                                       u32 value, State& state) {
+    WriteOp<T>(memory, written, value + state.offset, static_cast<T>(state.reg));
     state.offset += sizeof(T);
 }
 
-template <typename T, typename ReadFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> LoadOp(const GatewayCheat::CheatLine& line,
-                                                             State& state, ReadFunction read_func) {
-
-    u32 addr = line.value + state.offset;
-    state.reg = read_func(addr);
-}
-
-static inline void AddOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.offset += line.value;
-}
-
-static inline void JokerOp(const GatewayCheat::CheatLine& line, State& state,
-                           const Core::System& system) {
+static inline void JokerOp(u32 value, State& state, const Core::System& system) {
     u32 pad_state = system.ServiceManager()
                         .GetService<Service::HID::Module::Interface>("hid:USER")
                         ->GetModule()
                         ->GetState()
                         .hex;
-    bool pressed = (pad_state & line.value) == line.value;
+    bool pressed = (pad_state & value) == value;
     if (!pressed) {
         state.if_flag++;
     }
 }
 
-static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Core::System& system,
-                           std::span<const GatewayCheat::CheatLine> cheat_lines) {
-    if (state.if_flag > 0) {
-        // Skip over the additional patch lines
-        state.current_line_nr += static_cast<int>(std::ceil(line.value / 8.0));
+static inline void PatchOp(Memory::MemorySystem& memory, WrittenRanges& written, VAddr addr,
+                           std::span<const u8> data) {
+    if (data.empty()) {
         return;
     }
-    u32 num_bytes = line.value;
-    u32 addr = line.address + state.offset;
-    system.InvalidateCacheRange(addr, num_bytes);
-
-    bool first = true;
-    u32 bit_offset = 0;
-    if (num_bytes > 0)
-        state.current_line_nr++; // skip over the current code
-    while (num_bytes >= 4) {
-        u32 tmp = first ? cheat_lines[state.current_line_nr].first
-                        : cheat_lines[state.current_line_nr].value;
-        if (!first && num_bytes > 4) {
-            state.current_line_nr++;
-        }
-        first = !first;
-        system.Memory().Write32(addr, tmp);
-        addr += 4;
-        num_bytes -= 4;
+    written.Add(addr, static_cast<u32>(data.size()));
+    std::size_t i = 0;
+    for (; i + 4 <= data.size(); i += 4) {
+        u32 word;
+        std::memcpy(&word, data.data() + i, sizeof(word));
+        memory.Write32(addr + static_cast<u32>(i), word);
     }
-    while (num_bytes > 0) {
-        u32 tmp = (first ? cheat_lines[state.current_line_nr].first
-                         : cheat_lines[state.current_line_nr].value) >>
-                  bit_offset;
-        system.Memory().Write8(addr, tmp);
-        addr += 1;
-        num_bytes -= 1;
-        bit_offset += 8;
+    for (; i < data.size(); i++) {
+        memory.Write8(addr + static_cast<u32>(i), data[i]);
     }
 }
 
@@ -212,6 +177,7 @@ GatewayCheat::CheatLine::CheatLine(const std::string& line) {
 GatewayCheat::GatewayCheat(std::string name_, std::vector<CheatLine> cheat_lines_,
                            std::string comments_)
     : name(std::move(name_)), cheat_lines(std::move(cheat_lines_)), comments(std::move(comments_)) {
+    Compile();
 }
 
 GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comments_)
@@ -225,26 +191,60 @@ GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comm
             temp_cheat_lines.emplace_back(line);
     }
     cheat_lines = std::move(temp_cheat_lines);
+    Compile();
 }
 
 GatewayCheat::~GatewayCheat() = default;
 
-void GatewayCheat::Execute(Core::System& system) const {
-    State state;
+void GatewayCheat::Compile() {
+    program.clear();
+    patch_data.clear();
+    program.reserve(cheat_lines.size());
 
+    for (std::size_t i = 0; i < cheat_lines.size(); i++) {
+        const CheatLine& line = cheat_lines[i];
+        if (!line.valid) {
+            program.push_back({CheatType::Null, 0, 0, 0});
+            continue;
+        }
+        if (line.type != CheatType::Patch) {
+            program.push_back({line.type, line.address, line.value, 0});
+            continue;
+        }
+
+        // EXXXXXXX YYYYYYYY is followed by the YYYYYYYY bytes to copy, stored as the words of the
+        // next lines in order, which are not executed
+        const auto data_offset = static_cast<u32>(patch_data.size());
+        const std::size_t num_lines = (std::size_t{line.value} + 7) / 8;
+        const std::size_t available = std::min(num_lines, cheat_lines.size() - i - 1);
+        u32 num_bytes = line.value;
+        if (available < num_lines) {
+            LOG_ERROR(Core_Cheats, "Cheat {} has a truncated patch: {}", name, line.cheat_line);
+            num_bytes = static_cast<u32>(available * 8);
+        }
+        for (std::size_t j = 1; j <= available; j++) {
+            const CheatLine& data_line = cheat_lines[i + j];
+            const std::array<u32, 2> words{data_line.valid ? data_line.first : 0,
+                                           data_line.valid ? data_line.value : 0};
+            const auto* bytes = reinterpret_cast<const u8*>(words.data());
+            patch_data.insert(patch_data.end(), bytes, bytes + sizeof(words));
+        }
+        patch_data.resize(data_offset + num_bytes);
+        program.push_back({CheatType::Patch, line.address, num_bytes, data_offset});
+        i += available;
+    }
+}
+
+void GatewayCheat::Execute(Core::System& system, WrittenRanges& written) const {
+    State state;
     Memory::MemorySystem& memory = system.Memory();
-    auto Read8 = [&memory](VAddr addr) { return memory.Read8(addr); };
-    auto Read16 = [&memory](VAddr addr) { return memory.Read16(addr); };
-    auto Read32 = [&memory](VAddr addr) { return memory.Read32(addr); };
-    auto Write8 = [&memory](VAddr addr, u8 value) { memory.Write8(addr, value); };
-    auto Write16 = [&memory](VAddr addr, u16 value) { memory.Write16(addr, value); };
-    auto Write32 = [&memory](VAddr addr, u32 value) { memory.Write32(addr, value); };
-
-    for (state.current_line_nr = 0; state.current_line_nr < cheat_lines.size();
-         state.current_line_nr++) {
-        auto line = cheat_lines[state.current_line_nr];
+
+    for (state.current_instruction = 0; state.current_instruction < program.size();
+         state.current_instruction++) {
+        const Instruction& instr = program[state.current_instruction];
+        const u32 value = instr.value;
         if (state.if_flag > 0) {
-            switch (line.type) {
+            switch (instr.type) {
             case CheatType::GreaterThan32:
             case CheatType::LessThan32:
             case CheatType::EqualTo32:
@@ -257,12 +257,6 @@ void GatewayCheat::Execute(Core::System& system) const {
                 // Increment the if_flag to handle the end if correctly
                 state.if_flag++;
                 break;
-            case CheatType::Patch:
-                // EXXXXXXX YYYYYYYY
-                // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-                // We need to call this here to skip the additional patch lines
-                PatchOp(line, state, system, cheat_lines);
-                break;
             case CheatType::Terminator:
                 // D0000000 00000000 - ENDIF
                 TerminateOp(state);
@@ -277,150 +271,131 @@ void GatewayCheat::Execute(Core::System& system) const {
             // Do not execute any other op code
             continue;
         }
-        switch (line.type) {
+        switch (instr.type) {
         case CheatType::Null:
             break;
         case CheatType::Write32:
             // 0XXXXXXX YYYYYYYY - word[XXXXXXX+offset] = YYYYYYYY
-            WriteOp<u32>(line, state, Read32, Write32, system);
+            WriteOp<u32>(memory, written, instr.address + state.offset, value);
             break;
         case CheatType::Write16:
             // 1XXXXXXX 0000YYYY - half[XXXXXXX+offset] = YYYY
-            WriteOp<u16>(line, state, Read16, Write16, system);
+            WriteOp<u16>(memory, written, instr.address + state.offset, static_cast<u16>(value));
             break;
         case CheatType::Write8:
             // 2XXXXXXX 000000YY - byte[XXXXXXX+offset] = YY
-            WriteOp<u8>(line, state, Read8, Write8, system);
+            WriteOp<u8>(memory, written, instr.address + state.offset, static_cast<u8>(value));
             break;
         case CheatType::GreaterThan32:
             // 3XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY > word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32, [&line](u32 val) -> bool { return line.value > val; });
+            CompOp<u32>(memory, instr.address + state.offset, state,
+                        [value](u32 val) { return value > val; });
             break;
         case CheatType::LessThan32:
             // 4XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY < word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32, [&line](u32 val) -> bool { return line.value < val; });
+            CompOp<u32>(memory, instr.address + state.offset, state,
+                        [value](u32 val) { return value < val; });
             break;
         case CheatType::EqualTo32:
             // 5XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY == word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32,
-                        [&line](u32 val) -> bool { return line.value == val; });
+            CompOp<u32>(memory, instr.address + state.offset, state,
+                        [value](u32 val) { return value == val; });
             break;
         case CheatType::NotEqualTo32:
             // 6XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY != word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32,
-                        [&line](u32 val) -> bool { return line.value != val; });
+            CompOp<u32>(memory, instr.address + state.offset, state,
+                        [value](u32 val) { return value != val; });
             break;
         case CheatType::GreaterThan16WithMask:
             // 7XXXXXXX ZZZZYYYY - Execute next block IF YYYY > ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) > (static_cast<u16>(~line.value >> 16) & val);
-            });
+            CompMaskedOp(memory, instr.address + state.offset, value, state, std::greater<u16>{});
             break;
         case CheatType::LessThan16WithMask:
             // 8XXXXXXX ZZZZYYYY - Execute next block IF YYYY < ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) < (static_cast<u16>(~line.value >> 16) & val);
-            });
+            CompMaskedOp(memory, instr.address + state.offset, value, state, std::less<u16>{});
             break;
         case CheatType::EqualTo16WithMask:
             // 9XXXXXXX ZZZZYYYY - Execute next block IF YYYY = ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) == (static_cast<u16>(~line.value >> 16) & val);
-            });
+            CompMaskedOp(memory, instr.address + state.offset, value, state,
+                         std::equal_to<u16>{});
             break;
         case CheatType::NotEqualTo16WithMask:
             // AXXXXXXX ZZZZYYYY - Execute next block IF YYYY <> ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) != (static_cast<u16>(~line.value >> 16) & val);
-            });
+            CompMaskedOp(memory, instr.address + state.offset, value, state,
+                         std::not_equal_to<u16>{});
             break;
         case CheatType::LoadOffset:
             // BXXXXXXX 00000000 - offset = word[XXXXXXX+offset]
-            LoadOffsetOp(system.Memory(), line, state);
+            state.offset = memory.Read32(instr.address + state.offset);
             break;
-        case CheatType::Loop: {
+        case CheatType::Loop:
             // C0000000 YYYYYYYY - LOOP next block YYYYYYYY times
             // TODO(B3N30): Support nested loops if necessary
-            LoopOp(line, state);
+            LoopOp(value, state);
             break;
-        }
-        case CheatType::Terminator: {
+        case CheatType::Terminator:
             // D0000000 00000000 - END IF
             TerminateOp(state);
             break;
-        }
-        case CheatType::LoopExecuteVariant: {
+        case CheatType::LoopExecuteVariant:
             // D1000000 00000000 - END LOOP
             LoopExecuteVariantOp(state);
             break;
-        }
-        case CheatType::FullTerminator: {
+        case CheatType::FullTerminator:
             // D2000000 00000000 - NEXT & Flush
             FullTerminateOp(state);
             break;
-        }
-        case CheatType::SetOffset: {
+        case CheatType::SetOffset:
             // D3000000 XXXXXXXX – Sets the offset to XXXXXXXX
-            SetOffsetOp(line, state);
+            state.offset = value;
             break;
-        }
-        case CheatType::AddValue: {
+        case CheatType::AddValue:
             // D4000000 XXXXXXXX – reg += XXXXXXXX
-            AddValueOp(line, state);
+            state.reg += value;
             break;
-        }
-        case CheatType::SetValue: {
+        case CheatType::SetValue:
             // D5000000 XXXXXXXX – reg = XXXXXXXX
-            SetValueOp(line, state);
+            state.reg = value;
             break;
-        }
-        case CheatType::IncrementiveWrite32: {
+        case CheatType::IncrementiveWrite32:
             // D6000000 XXXXXXXX – (32bit) [XXXXXXXX+offset] = reg ; offset += 4
-            IncrementiveWriteOp<u32>(line, state, Read32, Write32, system);
+            IncrementiveWriteOp<u32>(memory, written, value, state);
             break;
-        }
-        case CheatType::IncrementiveWrite16: {
+        case CheatType::IncrementiveWrite16:
             // D7000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xffff ; offset += 2
-            IncrementiveWriteOp<u16>(line, state, Read16, Write16, system);
+            IncrementiveWriteOp<u16>(memory, written, value, state);
             break;
-        }
-        case CheatType::IncrementiveWrite8: {
+        case CheatType::IncrementiveWrite8:
             // D8000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xff ; offset++
-            IncrementiveWriteOp<u8>(line, state, Read8, Write8, system);
+            IncrementiveWriteOp<u8>(memory, written, value, state);
             break;
-        }
-        case CheatType::Load32: {
+        case CheatType::Load32:
             // D9000000 XXXXXXXX – reg = [XXXXXXXX+offset]
-            LoadOp<u32>(line, state, Read32);
+            state.reg = ReadMemory<u32>(memory, value + state.offset);
             break;
-        }
-        case CheatType::Load16: {
+        case CheatType::Load16:
             // DA000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFFFF
-            LoadOp<u16>(line, state, Read16);
+            state.reg = ReadMemory<u16>(memory, value + state.offset);
             break;
-        }
-        case CheatType::Load8: {
+        case CheatType::Load8:
             // DB000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFF
-            LoadOp<u8>(line, state, Read8);
+            state.reg = ReadMemory<u8>(memory, value + state.offset);
             break;
-        }
-        case CheatType::AddOffset: {
+        case CheatType::AddOffset:
             // DC000000 XXXXXXXX – offset + XXXXXXXX
-            AddOffsetOp(line, state);
+            state.offset += value;
             break;
-        }
-        case CheatType::Joker: {
+        case CheatType::Joker:
             // DD000000 XXXXXXXX – if KEYPAD has value XXXXXXXX execute next block
-            JokerOp(line, state, system);
+            JokerOp(value, state, system);
             break;
-        }
-        case CheatType::Patch: {
+        case CheatType::Patch:
             // EXXXXXXX YYYYYYYY
             // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-            PatchOp(line, state, system, cheat_lines);
+            PatchOp(memory, written, instr.address + state.offset,
+                    std::span{patch_data}.subspan(instr.data_offset, value));
             break;
         }
-        }
     }
 }
 
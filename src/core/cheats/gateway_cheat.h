@@ -59,7 +59,7 @@ public:
     GatewayCheat(std::string name, std::string code, std::string comments);
     ~GatewayCheat();
 
-    void Execute(Core::System& system) const override;
+    void Execute(Core::System& system, WrittenRanges& written) const override;
 
     bool IsEnabled() const override;
     void SetEnabled(bool enabled) override;
@@ -80,9 +80,23 @@ public:
     static std::vector<std::shared_ptr<CheatBase>> LoadFile(const std::string& filepath);
 
 private:
+    /// Cheat line decoded for execution. Patches hold the data of the lines following them.
+    struct Instruction {
+        CheatType type;
+        u32 address;
+        u32 value;
+        /// Offset of the data of a patch in patch_data
+        u32 data_offset;
+    };
+
+    /// Decodes the cheat lines into the program executed every run.
+    void Compile();
+
     std::atomic<bool> enabled = false;
     const std::string name;
     std::vector<CheatLine> cheat_lines;
     const std::string comments;
+    std::vector<Instruction> program;
+    std::vector<u8> patch_data;
 };
 } // namespace Cheats
@@ -2,15 +2,21 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <ctime>
+#include <limits>
 #include <stdexcept>
 #include <utility>
 #include <boost/serialization/array.hpp>
+#include <fmt/chrono.h>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/hle/hle.h"
 #include "audio_core/lle/lle.h"
 #include "common/arch.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
+#include "common/thread_pool.h"
+#include "common/trace_recorder.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/exclusive_monitor.h"
 #include "core/hle/service/cam/cam.h"
@@ -23,10 +29,13 @@
 #include "core/cheats/cheats.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/cpu_threads.h"
 #include "core/dumping/backend.h"
+#include "core/file_sys/delay_generator.h"
 #include "core/frontend/image_interface.h"
 #include "core/gdbstub/gdbstub.h"
 #include "core/global.h"
+#include "core/guest_profiler.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/thread.h"
@@ -44,6 +53,8 @@
 #include "core/hw/aes/key.h"
 #include "core/loader/loader.h"
 #include "core/movie.h"
+#include "core/rewind.h"
+#include "core/savestate.h"
 #ifdef ENABLE_SCRIPTING
 #include "core/rpc/server.h"
 #endif
@@ -56,6 +67,7 @@
 namespace Core {
 
 /*static*/ System System::s_instance;
+/*static*/ thread_local System* System::current_instance = &System::s_instance;
 
 template <>
 Core::System& Global() {
@@ -74,7 +86,9 @@ Core::Timing& Global() {
 
 System::System() : movie{*this}, cheat_engine{*this} {}
 
-System::~System() = default;
+System::~System() {
+    WaitForSaveState();
+}
 
 System::ResultStatus System::RunLoop(bool tight_loop) {
     status = ResultStatus::Success;
@@ -135,7 +149,7 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         LOG_INFO(Core, "Begin save to slot {}", slot);
         try {
             System::SaveState(slot);
-            LOG_INFO(Core, "Save completed");
+            LOG_INFO(Core, "Save captured, writing it in the background");
         } catch (const std::exception& e) {
             LOG_ERROR(Core, "Error saving: {}", e.what());
             status_details = e.what();
@@ -144,7 +158,35 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         frame_limiter.WaitOnce();
         return ResultStatus::Success;
     }
+    case Signal::Rewind: {
+        if (!rewind_buffer) {
+            LOG_WARNING(Core, "Rewinding requires a rewind buffer size to be configured");
+            return ResultStatus::Success;
+        }
+        if (Network::GetRoomMember().lock()->IsConnected()) {
+            LOG_WARNING(Core, "Unable to rewind while connected to multiplayer");
+            return ResultStatus::Success;
+        }
+        try {
+            if (!rewind_buffer->Rewind()) {
+                LOG_INFO(Core, "No state left to rewind to");
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error rewinding: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+        frame_limiter.WaitOnce();
+        return ResultStatus::Success;
+    }
     default:
+        if (boot_snapshot_hash != 0 && !UpdateBootSnapshot()) {
+            status_details = "Could not load the boot snapshot";
+            return ResultStatus::ErrorSavestate;
+        }
+        if (rewind_buffer) {
+            rewind_buffer->Tick();
+        }
         break;
     }
 
@@ -187,6 +229,7 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
             current_core_to_execute->GetTimer().Idle();
             PrepareReschedule();
         } else {
+            PerfStats::ScopedFrameTimer timer{perf_stats.get(), PerfStats::FrameTimer::CpuSlices};
             if (tight_loop) {
                 current_core_to_execute->Run();
             } else {
@@ -206,27 +249,69 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
             kernel->GetThreadManager(cpu_core->GetID()).Reschedule();
             max_slice = std::min(max_slice, cpu_core->GetTimer().GetMaxSliceLength());
         }
-        for (auto& cpu_core : cpu_cores) {
-            cpu_core->GetTimer().SetNextSlice(max_slice);
-            auto start_ticks = cpu_core->GetTimer().GetTicks();
-            LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
-                      cpu_core->GetTimer().GetDowncount());
-            running_core = cpu_core.get();
-            kernel->SetRunningCPU(running_core);
-            // If we don't have a currently active thread then don't execute instructions,
-            // instead advance to the next event and try to yield to the next thread
-            if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
-                LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
+        const bool all_idle = std::ranges::all_of(cpu_cores, [this](const auto& cpu_core) {
+            return kernel->GetThreadManager(cpu_core->GetID()).GetCurrentThread() == nullptr;
+        });
+        if (all_idle && tight_loop) {
+            // Nothing can run until the next event wakes a thread up, so jump straight to it
+            // instead of idling through the wait one slice at a time.
+            s64 idle_slice = std::numeric_limits<s64>::max();
+            for (const auto& cpu_core : cpu_cores) {
+                idle_slice = std::min(idle_slice, cpu_core->GetTimer().GetMaxSliceLength());
+            }
+            LOG_TRACE(Core_ARM11, "All cores idling for {} ticks", idle_slice);
+            for (auto& cpu_core : cpu_cores) {
+                cpu_core->GetTimer().SetNextSlice(idle_slice);
                 cpu_core->GetTimer().Idle();
-                PrepareReschedule();
-            } else {
-                if (tight_loop) {
-                    cpu_core->Run();
+            }
+            PrepareReschedule();
+            if (perf_stats) {
+                perf_stats->AddSkippedIdleCycles(idle_slice);
+            }
+        } else if (cpu_threads && tight_loop && !GDBStub::IsServerEnabled()) {
+            // Every core runs the full slice in parallel. Cores that stop early are brought back
+            // in sync with the others by the delayed branch above on the next iteration.
+            for (auto& cpu_core : cpu_cores) {
+                cpu_core->GetTimer().SetNextSlice(max_slice);
+            }
+            PerfStats::ScopedFrameTimer timer{perf_stats.get(), PerfStats::FrameTimer::CpuSlices};
+            multi_core_running = true;
+            cpu_threads->RunSlice();
+            multi_core_running = false;
+        } else {
+            for (auto& cpu_core : cpu_cores) {
+                cpu_core->GetTimer().SetNextSlice(max_slice);
+                auto start_ticks = cpu_core->GetTimer().GetTicks();
+                LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
+                          cpu_core->GetTimer().GetDowncount());
+                running_core = cpu_core.get();
+                kernel->SetRunningCPU(running_core);
+                // If we don't have a currently active thread then don't execute instructions,
+                // instead advance to the next event and try to yield to the next thread
+                if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
+                    LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
+                    cpu_core->GetTimer().Idle();
+                    PrepareReschedule();
                 } else {
-                    cpu_core->Step();
+                    PerfStats::ScopedFrameTimer timer{perf_stats.get(),
+                                                      PerfStats::FrameTimer::CpuSlices};
+                    if (tight_loop) {
+                        cpu_core->Run();
+                    } else {
+                        cpu_core->Step();
+                    }
                 }
+                max_slice = cpu_core->GetTimer().GetTicks() - start_ticks;
             }
-            max_slice = cpu_core->GetTimer().GetTicks() - start_ticks;
+        }
+    }
+
+    if (guest_profiler) {
+        for (const auto& cpu_core : cpu_cores) {
+            const Kernel::Thread* thread =
+                kernel->GetThreadManager(cpu_core->GetID()).GetCurrentThread();
+            const auto process = thread ? thread->owner_process.lock() : nullptr;
+            guest_profiler->Sample(*cpu_core, process.get());
         }
     }
 
@@ -239,6 +324,41 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
     return status;
 }
 
+bool System::UpdateBootSnapshot() {
+    // Movies are recorded from a cold boot
+    if (movie.GetCurrentMovieID() != 0) {
+        boot_snapshot_hash = 0;
+        return true;
+    }
+
+    if (boot_snapshot_ticks == 0) {
+        try {
+            if (LoadBootSnapshot()) {
+                boot_snapshot_hash = 0;
+                return true;
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error loading the boot snapshot: {}", e.what());
+            boot_snapshot_hash = 0;
+            return false;
+        }
+        constexpr u64 frame_ticks = static_cast<u64>(BASE_CLOCK_RATE_ARM11 / SCREEN_REFRESH_RATE);
+        boot_snapshot_ticks = timing->GetGlobalTicks() +
+                              Settings::values.boot_snapshot_frames.GetValue() * frame_ticks;
+        return true;
+    }
+
+    if (timing->GetGlobalTicks() >= boot_snapshot_ticks) {
+        boot_snapshot_hash = 0;
+        try {
+            SaveBootSnapshot();
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error saving the boot snapshot: {}", e.what());
+        }
+    }
+    return true;
+}
+
 bool System::SendSignal(System::Signal signal, u32 param) {
     std::scoped_lock lock{signal_mutex};
     if (current_signal != signal && current_signal != Signal::None) {
@@ -340,6 +460,32 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
 
     perf_stats = std::make_unique<PerfStats>(title_id);
 
+    if (Settings::values.profile_guest_code) {
+        guest_profiler = std::make_unique<GuestProfiler>(title_id);
+        const auto& code = process->codeset->CodeSegment();
+        guest_profiler->RegisterModule(process->process_id, process->codeset->name, code.addr,
+                                       code.size);
+    }
+
+    if (Settings::values.record_trace) {
+        const std::time_t t = std::time(nullptr);
+        const std::string& path = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+        // %F Date format expanded is "%Y-%m-%d"
+        trace_recorder = std::make_unique<Common::TraceRecorder>(
+            fmt::format("{}/{:%F-%H-%M}_{:016X}.json", path, *std::localtime(&t), title_id));
+    }
+
+    if (Settings::values.rewind_buffer_size.GetValue() != 0) {
+        rewind_buffer = std::make_unique<RewindBuffer>(*this);
+    }
+
+    boot_snapshot_hash = 0;
+    boot_snapshot_ticks = 0;
+    if (Settings::values.use_boot_snapshot.GetValue()) {
+        boot_snapshot_hash = GetBootSnapshotHash(*this, filepath, title_id);
+    }
+
+    custom_tex_manager->ReadScaleConfig(title_id);
     if (Settings::values.dump_textures) {
         custom_tex_manager->PrepareDumping(title_id);
     }
@@ -359,20 +505,107 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
     return status;
 }
 
+System::ResultStatus System::InitForTracePlayback(Frontend::EmuWindow& emu_window) {
+    const ResultStatus init_result = Init(emu_window, nullptr, Kernel::MemoryMode::Prod,
+                                          Kernel::New3dsHwCapabilities{}, 2);
+    if (init_result != ResultStatus::Success) {
+        LOG_CRITICAL(Core, "Failed to initialize system (Error {})!",
+                     static_cast<u32>(init_result));
+        System::Shutdown();
+        return init_result;
+    }
+
+    title_id = 0;
+    perf_stats = std::make_unique<PerfStats>(title_id);
+    status = ResultStatus::Success;
+    m_emu_window = &emu_window;
+    m_secondary_window = nullptr;
+    return status;
+}
+
 void System::PrepareReschedule() {
     running_core->PrepareReschedule();
     reschedule_pending = true;
 }
 
 PerfStats::Results System::GetAndResetPerfStats() {
-    return (perf_stats && timing) ? perf_stats->GetAndResetStats(timing->GetGlobalTimeUs())
-                                  : PerfStats::Results{};
+    if (!perf_stats || !timing) {
+        return PerfStats::Results{};
+    }
+
+    auto results = perf_stats->GetAndResetStats(timing->GetGlobalTimeUs());
+    if (dsp_core) {
+        const auto audio = dsp_core->GetAndResetStats();
+        constexpr double sample_rate = AudioCore::native_sample_rate;
+        results.audio_fill = audio.mean_fill / sample_rate;
+        results.audio_min_fill = audio.min_fill / sample_rate;
+        results.audio_production_ratio =
+            audio.frames_consumed
+                ? static_cast<double>(audio.frames_produced) / audio.frames_consumed
+                : 0.0;
+        results.audio_stretch_ratio = audio.stretch_ratio;
+        results.audio_callback_jitter = audio.max_callback_jitter;
+        results.audio_frame_time = audio.mean_frame_time;
+        results.audio_underruns = dsp_core->GetUnderrunCount();
+        results.audio_overruns = dsp_core->GetOverrunCount();
+    }
+
+    const auto io_stats = Common::ThreadPool::Instance().GetAndResetIOStats();
+    using Seconds = std::chrono::duration<double>;
+    results.hle_io_latency = Seconds(io_stats.mean_latency).count();
+    results.hle_io_max_latency = Seconds(io_stats.max_latency).count();
+    return results;
 }
 
 PerfStats::Results System::GetLastPerfStats() {
     return perf_stats ? perf_stats->GetLastStats() : PerfStats::Results{};
 }
 
+PerfStats::FrameStats System::GetLastFrameStats() const {
+    if (!perf_stats) {
+        return PerfStats::FrameStats{};
+    }
+
+    auto stats = perf_stats->GetLastFrameStats();
+    if (dsp_core) {
+        stats.audio_fill = static_cast<double>(dsp_core->GetQueuedFrames()) /
+                           AudioCore::native_sample_rate;
+    }
+    return stats;
+}
+
+std::vector<double> System::GetFrametimeHistory() const {
+    return perf_stats ? perf_stats->GetFrametimeHistory() : std::vector<double>{};
+}
+
+void System::RunCoreSlice(ARM_Interface& cpu_core) {
+    LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core.GetID(),
+              cpu_core.GetTimer().GetDowncount());
+    {
+        // The current thread is changed by the kernel, which only runs under the core lock
+        const auto lock = AcquireCore(cpu_core);
+        if (kernel->GetThreadManager(cpu_core.GetID()).GetCurrentThread() == nullptr) {
+            LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core.GetID());
+            cpu_core.GetTimer().Idle();
+            PrepareReschedule();
+            return;
+        }
+    }
+    cpu_core.Run();
+}
+
+std::unique_lock<std::mutex> System::AcquireCore(ARM_Interface& core) {
+    if (!multi_core_running) {
+        return {};
+    }
+    std::unique_lock lock{core_mutex};
+    if (running_core != &core) {
+        running_core = &core;
+        kernel->SetRunningCPU(running_core);
+    }
+    return lock;
+}
+
 void System::Reschedule() {
     if (!reschedule_pending) {
         return;
@@ -426,6 +659,19 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
     kernel->SetCPUs(cpu_cores);
     kernel->SetRunningCPU(cpu_cores[0].get());
 
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+    // The interpreter does not route its kernel and memory accesses through AcquireCore. Service
+    // calls also reach the rasterizer from the core threads, which OpenGL cannot record from.
+    const bool gl_renderer =
+        Settings::values.graphics_api.GetValue() == Settings::GraphicsAPI::OpenGL;
+    if (Settings::values.use_multi_core && gl_renderer) {
+        LOG_WARNING(Core, "Multi-core CPU emulation is not supported by OpenGL, disabling");
+    } else if (Settings::values.use_multi_core && Settings::values.use_cpu_jit && num_cores > 1) {
+        cpu_threads = std::make_unique<CPUThreads>(
+            *this, cpu_cores, [this](ARM_Interface& cpu_core) { RunCoreSlice(cpu_core); });
+    }
+#endif
+
     const auto audio_emulation = Settings::values.audio_emulation.GetValue();
     if (audio_emulation == Settings::AudioEmulation::HLE) {
         dsp_core = std::make_unique<AudioCore::DspHle>(*this);
@@ -439,6 +685,7 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
     dsp_core->SetSink(Settings::values.output_type.GetValue(),
                       Settings::values.output_device.GetValue());
     dsp_core->EnableStretching(Settings::values.enable_audio_stretching.GetValue());
+    dsp_core->SetStretchingQuality(Settings::values.audio_stretching_quality.GetValue());
 
     telemetry_session = std::make_unique<Core::TelemetrySession>();
 
@@ -533,6 +780,14 @@ const Cheats::CheatEngine& System::CheatEngine() const {
     return cheat_engine;
 }
 
+void System::OnFrameEnd() {
+#ifdef ENABLE_SCRIPTING
+    if (rpc_server) {
+        rpc_server->PublishMemoryUpdates();
+    }
+#endif
+}
+
 void System::RegisterVideoDumper(std::shared_ptr<VideoDumper::Backend> dumper) {
     video_dumper = std::move(dumper);
 }
@@ -566,6 +821,10 @@ void System::RegisterImageInterface(std::shared_ptr<Frontend::ImageInterface> im
 }
 
 void System::Shutdown(bool is_deserializing) {
+    if (!is_deserializing) {
+        WaitForSaveState();
+    }
+
     // Log last frame performance stats
     const auto perf_results = GetAndResetPerfStats();
     constexpr auto performance = Common::Telemetry::FieldType::Performance;
@@ -577,6 +836,24 @@ void System::Shutdown(bool is_deserializing) {
     telemetry_session->AddField(performance, "Mean_Frametime_MS",
                                 perf_stats ? perf_stats->GetMeanFrametime() : 0);
 
+    // Report how long the title waited on the emulated filesystem latency
+    const u64 fs_delay_ms = FileSys::TakeEmulatedDelayTotal() / 1'000'000;
+    telemetry_session->AddField(performance, "Shutdown_EmulatedFsDelay", fs_delay_ms);
+    if (fs_delay_ms != 0) {
+        LOG_INFO(Core, "Emulated filesystem latency of {:016X}: {} ms", title_id, fs_delay_ms);
+    }
+
+    // Report the audio glitches of the session
+    if (dsp_core) {
+        const u64 underruns = dsp_core->GetUnderrunCount();
+        const u64 overruns = dsp_core->GetOverrunCount();
+        telemetry_session->AddField(performance, "Shutdown_AudioUnderruns", underruns);
+        telemetry_session->AddField(performance, "Shutdown_AudioOverruns", overruns);
+        if (underruns != 0 || overruns != 0) {
+            LOG_INFO(Core, "Audio output had {} underruns and {} overruns", underruns, overruns);
+        }
+    }
+
     // Shutdown emulation session
     is_powered_on = false;
 
@@ -584,6 +861,9 @@ void System::Shutdown(bool is_deserializing) {
     if (!is_deserializing) {
         GDBStub::Shutdown();
         perf_stats.reset();
+        guest_profiler.reset();
+        trace_recorder.reset();
+        rewind_buffer.reset();
         app_loader.reset();
     }
     custom_tex_manager.reset();
@@ -594,6 +874,7 @@ void System::Shutdown(bool is_deserializing) {
     archive_manager.reset();
     service_manager.reset();
     dsp_core.reset();
+    cpu_threads.reset();
     kernel.reset();
     cpu_cores.clear();
     exclusive_monitor.reset();
@@ -661,6 +942,7 @@ void System::ApplySettings() {
         dsp_core->SetSink(Settings::values.output_type.GetValue(),
                           Settings::values.output_device.GetValue());
         dsp_core->EnableStretching(Settings::values.enable_audio_stretching.GetValue());
+        dsp_core->SetStretchingQuality(Settings::values.audio_stretching_quality.GetValue());
 
         auto hid = Service::HID::GetModule(*this);
         if (hid) {
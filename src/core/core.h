@@ -5,6 +5,7 @@
 #pragma once
 
 #include <atomic>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -56,6 +57,10 @@ namespace VideoDumper {
 class Backend;
 }
 
+namespace Common {
+class TraceRecorder;
+}
+
 namespace VideoCore {
 class CustomTexManager;
 class GPU;
@@ -72,6 +77,9 @@ class AppLoader;
 namespace Core {
 
 class ARM_Interface;
+class CPUThreads;
+class GuestProfiler;
+class RewindBuffer;
 class TelemetrySession;
 class ExclusiveMonitor;
 class Timing;
@@ -79,13 +87,40 @@ class Timing;
 class System {
 public:
     /**
-     * Gets the instance of the System singleton class.
-     * @returns Reference to the instance of the System singleton class.
+     * Gets the system current on the calling thread, the process-wide one unless another was made
+     * current on it.
+     * @returns Reference to the current system.
      */
     [[nodiscard]] static System& GetInstance() {
-        return s_instance;
+        return *current_instance;
+    }
+
+    /// Makes a system current on the calling thread, for the threads owned by that system.
+    static void MakeCurrent(System& system) {
+        current_instance = &system;
     }
 
+    /**
+     * Makes a system current on the calling thread while in scope. Each system of a process runs
+     * on its own threads, which make it current so that the code still reaching it through
+     * GetInstance, like deserialization, finds the right one.
+     */
+    class ScopedCurrent {
+    public:
+        explicit ScopedCurrent(System& system) : previous{current_instance} {
+            current_instance = &system;
+        }
+        ~ScopedCurrent() {
+            current_instance = previous;
+        }
+
+        ScopedCurrent(const ScopedCurrent&) = delete;
+        ScopedCurrent& operator=(const ScopedCurrent&) = delete;
+
+    private:
+        System* previous;
+    };
+
     /// Enumeration representing the return values of the System Initialize and Load process.
     enum class ResultStatus : u32 {
         Success,                    ///< Succeeded
@@ -131,7 +166,7 @@ public:
     /// Shutdown and then load again
     void Reset();
 
-    enum class Signal : u32 { None, Shutdown, Reset, Save, Load };
+    enum class Signal : u32 { None, Shutdown, Reset, Save, Load, Rewind };
 
     bool SendSignal(Signal signal, u32 param = 0);
 
@@ -156,6 +191,14 @@ public:
     [[nodiscard]] ResultStatus Load(Frontend::EmuWindow& emu_window, const std::string& filepath,
                                     Frontend::EmuWindow* secondary_window = {});
 
+    /**
+     * Initializes the emulated system without loading an application, for replaying a CiTrace
+     * through the GPU.
+     * @param emu_window Reference to the host-system window used for video output.
+     * @returns ResultStatus code, indicating if the operation succeeded.
+     */
+    [[nodiscard]] ResultStatus InitForTracePlayback(Frontend::EmuWindow& emu_window);
+
     /**
      * Indicates if the emulated system is powered on (all subsystems initialized and able to run an
      * application).
@@ -180,6 +223,12 @@ public:
 
     [[nodiscard]] PerfStats::Results GetLastPerfStats();
 
+    /// Returns the breakdown of the previous system frame, with the audio queued for output
+    [[nodiscard]] PerfStats::FrameStats GetLastFrameStats() const;
+
+    /// Returns the frametimes of the system frames emulated so far, in milliseconds
+    [[nodiscard]] std::vector<double> GetFrametimeHistory() const;
+
     /**
      * Gets a reference to the emulated CPU.
      * @returns A reference to the emulated CPU.
@@ -189,6 +238,19 @@ public:
         return *running_core;
     };
 
+    /**
+     * Makes the given core the running one for a kernel or memory system access made on its
+     * behalf. While the cores run on separate host threads this also serializes those accesses.
+     * @param core The core performing the access.
+     * @returns A lock to hold for the duration of the access, empty when the cores run in turn.
+     */
+    [[nodiscard]] std::unique_lock<std::mutex> AcquireCore(ARM_Interface& core);
+
+    /// Returns true while the CPU cores are executing a slice on separate host threads.
+    [[nodiscard]] bool IsMultiCoreRunning() const {
+        return multi_core_running;
+    }
+
     /**
      * Gets a reference to the emulated CPU.
      * @param core_id The id of the core requested.
@@ -280,6 +342,19 @@ public:
     /// Gets a const reference to the movie recorder
     [[nodiscard]] const Core::Movie& Movie() const;
 
+    /// Gets the guest code profiler, or nullptr if profiling is disabled
+    [[nodiscard]] GuestProfiler* GetGuestProfiler() const {
+        return guest_profiler.get();
+    }
+
+    /// Gets the trace recorder, or nullptr if no trace is recorded
+    [[nodiscard]] Common::TraceRecorder* GetTraceRecorder() const {
+        return trace_recorder.get();
+    }
+
+    /// Runs the work due at the end of each emulated frame, called by the renderer.
+    void OnFrameEnd();
+
     /// Video Dumper interface
 
     void RegisterVideoDumper(std::shared_ptr<VideoDumper::Backend> video_dumper);
@@ -289,6 +364,10 @@ public:
     }
 
     std::unique_ptr<PerfStats> perf_stats;
+    std::unique_ptr<GuestProfiler> guest_profiler;
+    std::unique_ptr<Common::TraceRecorder> trace_recorder;
+    /// Recent states to rewind through, when a rewind buffer is configured
+    std::unique_ptr<RewindBuffer> rewind_buffer;
     FrameLimiter frame_limiter;
 
     void SetStatus(ResultStatus new_status, const char* details = nullptr) {
@@ -339,10 +418,20 @@ public:
                (mic_permission_granted = mic_permission_func());
     }
 
+    /**
+     * Saves the state of the emulation to a slot. The state is captured in memory before returning
+     * while it is compressed and written to the disk in the background.
+     */
     void SaveState(u32 slot) const;
 
     void LoadState(u32 slot);
 
+    /// Waits for the savestate being written in the background, if any, to reach the disk.
+    void WaitForSaveState() const;
+
+    /// Captures and writes a state to path, marked with the given boot snapshot fingerprint.
+    void WriteSaveState(const std::string& path, u64 content_hash) const;
+
     /// Self delete ncch
     bool SetSelfDelete(const std::string& file) {
         if (m_filepath == file) {
@@ -372,6 +461,24 @@ private:
     /// Reschedule the core emulation
     void Reschedule();
 
+    /// Runs a single slice on a core from its own host thread
+    void RunCoreSlice(ARM_Interface& cpu_core);
+
+    /// Saves the state of the booted title, to be loaded instead of booting it the next time.
+    void SaveBootSnapshot() const;
+
+    /**
+     * Loads the boot snapshot of the title, discarding it if it is outdated.
+     * @returns false if there was no valid snapshot to load.
+     */
+    bool LoadBootSnapshot();
+
+    /**
+     * Loads the boot snapshot on the first slice of the title, or captures one once it booted.
+     * @returns false if loading the snapshot failed, leaving the system unusable.
+     */
+    bool UpdateBootSnapshot();
+
     /// AppLoader used to load the current executing application
     std::unique_ptr<Loader::AppLoader> app_loader;
 
@@ -379,6 +486,11 @@ private:
     std::vector<std::shared_ptr<ARM_Interface>> cpu_cores;
     ARM_Interface* running_core = nullptr;
 
+    /// Host threads running the cores in parallel when multi-core emulation is enabled
+    std::unique_ptr<CPUThreads> cpu_threads;
+    std::mutex core_mutex;
+    bool multi_core_running{};
+
     /// DSP core
     std::unique_ptr<AudioCore::DspInterface> dsp_core;
 
@@ -427,6 +539,7 @@ private:
 
 private:
     static System s_instance;
+    static thread_local System* current_instance;
 
     std::atomic_bool is_powered_on{};
 
@@ -450,6 +563,15 @@ private:
     boost::optional<Service::APT::DeliverArg> restore_deliver_arg;
     boost::optional<Service::PLGLDR::PLG_LDR::PluginLoaderContext> restore_plugin_context;
 
+    /// Compresses and writes the last captured savestate
+    mutable std::future<void> save_state_task;
+
+    /// Fingerprint of the title for its boot snapshot, 0 once there is nothing left to do with it
+    u64 boot_snapshot_hash = 0;
+    /// Emulated time at which the boot snapshot is captured, 0 until the first slice
+    u64 boot_snapshot_ticks = 0;
+
+    friend class RewindBuffer;
     friend class boost::serialization::access;
     template <typename Archive>
     void serialize(Archive& ar, const unsigned int file_version);
@@ -6,6 +6,7 @@
 #include <random>
 #include <tuple>
 #include "common/assert.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "core/core_timing.h"
@@ -92,9 +93,7 @@ void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_
             if (!timer->is_timer_sane)
                 timer->ForceExceptionCheck(cycles_into_future);
 
-            timer->event_queue.emplace_back(
-                Event{timeout, timer->event_fifo_id++, user_data, event_type});
-            std::push_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
+            timer->PushEvent(Event{timeout, 0, user_data, event_type});
         } else {
             timer->ts_queue.Push(Event{static_cast<s64>(timer->GetTicks() + cycles_into_future), 0,
                                        user_data, event_type});
@@ -107,15 +106,7 @@ void Timing::UnscheduleEvent(const TimingEventType* event_type, std::uintptr_t u
         return;
     }
     for (auto timer : timers) {
-        auto itr = std::remove_if(
-            timer->event_queue.begin(), timer->event_queue.end(),
-            [&](const Event& e) { return e.type == event_type && e.user_data == user_data; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-        }
+        timer->Unschedule(event_type, user_data);
     }
     // TODO:remove events from ts_queue
 }
@@ -131,7 +122,7 @@ void Timing::RemoveEvent(const TimingEventType* event_type) {
         // Removing random items breaks the invariant so we have to re-establish it.
         if (itr != timer->event_queue.end()) {
             timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
+            timer->Compact();
         }
     }
     // TODO:remove events from ts_queue
@@ -193,10 +184,89 @@ void Timing::Timer::ForceExceptionCheck(s64 cycles) {
 
 void Timing::Timer::MoveEvents() {
     for (Event ev; ts_queue.Pop(ev);) {
-        ev.fifo_order = event_fifo_id++;
-        event_queue.emplace_back(std::move(ev));
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+        PushEvent(std::move(ev));
+    }
+}
+
+std::size_t Timing::Timer::EventKeyHash::operator()(const EventKey& key) const noexcept {
+    return static_cast<std::size_t>(
+        Common::HashCombine(reinterpret_cast<std::uintptr_t>(key.type), key.user_data));
+}
+
+void Timing::Timer::PushEvent(Event&& event) {
+    event.fifo_order = event_fifo_id++;
+    EventKeyState& state = event_keys[{event.type, event.user_data}];
+    ++state.queued;
+    ++state.live;
+    event_queue.emplace_back(std::move(event));
+    std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+}
+
+bool Timing::Timer::PopEvent(Event& event) {
+    std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+    event = std::move(event_queue.back());
+    event_queue.pop_back();
+
+    const auto it = event_keys.find({event.type, event.user_data});
+    ASSERT(it != event_keys.end());
+    EventKeyState& state = it->second;
+    const bool is_live = event.fifo_order >= state.cancelled_before;
+    if (is_live) {
+        --state.live;
+    } else {
+        --cancelled_events;
+    }
+    if (--state.queued == 0) {
+        event_keys.erase(it);
+    }
+    return is_live;
+}
+
+void Timing::Timer::DropCancelledFront() {
+    while (!event_queue.empty()) {
+        const Event& front = event_queue.front();
+        const auto it = event_keys.find({front.type, front.user_data});
+        if (front.fifo_order >= it->second.cancelled_before) {
+            break;
+        }
+        Event event;
+        PopEvent(event);
+    }
+}
+
+void Timing::Timer::Unschedule(const TimingEventType* event_type, std::uintptr_t user_data) {
+    const auto it = event_keys.find({event_type, user_data});
+    if (it == event_keys.end() || it->second.live == 0) {
+        return;
+    }
+
+    EventKeyState& state = it->second;
+    cancelled_events += state.live;
+    state.live = 0;
+    state.cancelled_before = event_fifo_id;
+
+    if (cancelled_events > event_queue.size() / 2) {
+        Compact();
+    } else {
+        DropCancelledFront();
+    }
+}
+
+void Timing::Timer::Compact() {
+    if (cancelled_events != 0) {
+        std::erase_if(event_queue, [this](const Event& e) {
+            return e.fifo_order < event_keys.at({e.type, e.user_data}).cancelled_before;
+        });
+    }
+    std::make_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+
+    event_keys.clear();
+    for (const Event& e : event_queue) {
+        EventKeyState& state = event_keys[{e.type, e.user_data}];
+        ++state.queued;
+        ++state.live;
     }
+    cancelled_events = 0;
 }
 
 s64 Timing::Timer::GetMaxSliceLength() const {
@@ -220,9 +290,9 @@ void Timing::Timer::Advance() {
     is_timer_sane = true;
 
     while (!event_queue.empty() && event_queue.front().time <= executed_ticks) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
+        Event evt;
+        PopEvent(evt);
+        DropCancelledFront();
         if (evt.type->callback != nullptr) {
             evt.type->callback(evt.user_data, static_cast<int>(executed_ticks - evt.time));
         } else {
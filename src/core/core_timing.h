@@ -209,11 +209,48 @@ public:
 
     private:
         friend class Timing;
+
+        struct EventKey {
+            const TimingEventType* type;
+            std::uintptr_t user_data;
+
+            bool operator==(const EventKey&) const = default;
+        };
+
+        struct EventKeyHash {
+            std::size_t operator()(const EventKey& key) const noexcept;
+        };
+
+        struct EventKeyState {
+            u32 queued = 0;           ///< Events with this key in the queue, including cancelled
+            u32 live = 0;             ///< Events with this key in the queue that still should run
+            u64 cancelled_before = 0; ///< Queued events with a lower fifo_order were unscheduled
+        };
+
+        /// Adds an event to the queue, assigning it the next fifo_order.
+        void PushEvent(Event&& event);
+
+        /// Removes the front event from the queue. Returns false if it was unscheduled.
+        bool PopEvent(Event& event);
+
+        /// Discards unscheduled events from the front, so the front is always due to run.
+        void DropCancelledFront();
+
+        /// Unschedules every queued event matching type and user data.
+        void Unschedule(const TimingEventType* event_type, std::uintptr_t user_data);
+
+        /// Physically removes unscheduled events from the queue and rebuilds the key index.
+        void Compact();
+
         // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
         // We don't use std::priority_queue because we need to be able to serialize, unserialize and
         // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
         // accommodated by the standard adaptor class.
+        // Unscheduled events are only marked as cancelled through event_keys and left in the heap
+        // until they reach the front or outnumber the live events, which keeps unscheduling O(1).
         std::vector<Event> event_queue;
+        std::unordered_map<EventKey, EventKeyState, EventKeyHash> event_keys;
+        std::size_t cancelled_events = 0;
         u64 event_fifo_id = 0;
         // the queue for storing the events from other threads threadsafe until they will be added
         // to the event_queue by the emu thread
@@ -239,12 +276,16 @@ public:
         template <class Archive>
         void serialize(Archive& ar, const unsigned int) {
             MoveEvents();
+            Compact();
             ar& event_queue;
             ar& event_fifo_id;
             ar& slice_length;
             ar& downcount;
             ar& executed_ticks;
             ar& idled_cycles;
+            if (Archive::is_loading::value) {
+                Compact();
+            }
         }
         friend class boost::serialization::access;
     };
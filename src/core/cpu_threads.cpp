@@ -0,0 +1,47 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <fmt/format.h>
+#include "common/microprofile.h"
+#include "core/arm/arm_interface.h"
+#include "core/core.h"
+#include "core/cpu_threads.h"
+
+namespace Core {
+
+CPUThreads::CPUThreads(System& system_, const std::vector<std::shared_ptr<ARM_Interface>>& cores_,
+                       RunFunction run_core_)
+    : system{system_}, cores{cores_}, run_core{std::move(run_core_)}, slice_start{cores_.size()},
+      slice_end{cores_.size()} {
+    workers.reserve(cores.size() - 1);
+    for (std::size_t i = 1; i < cores.size(); i++) {
+        workers.emplace_back([this, &core = *cores[i]](std::stop_token stop_token) {
+            WorkerLoop(stop_token, core);
+        });
+    }
+}
+
+CPUThreads::~CPUThreads() = default;
+
+void CPUThreads::RunSlice() {
+    slice_start.Sync();
+    run_core(*cores[0]);
+    slice_end.Sync();
+}
+
+void CPUThreads::WorkerLoop(std::stop_token stop_token, ARM_Interface& core) {
+    const std::string name = fmt::format("CPUCore_{}", core.GetID());
+    Common::SetCurrentThreadRole(Common::ThreadRole::Emulation, name.c_str());
+    MicroProfileOnThreadCreate(name.c_str());
+    System::ScopedCurrent current{system};
+
+    while (slice_start.Sync(stop_token)) {
+        run_core(core);
+        if (!slice_end.Sync(stop_token)) {
+            break;
+        }
+    }
+}
+
+} // namespace Core
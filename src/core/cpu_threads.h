@@ -0,0 +1,48 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "common/polyfill_thread.h"
+#include "common/thread.h"
+
+namespace Core {
+
+class ARM_Interface;
+class System;
+
+/**
+ * Runs the emulated CPU cores in parallel, each on its own host thread. The first core is run by
+ * the calling thread, every other core by a dedicated worker. All cores meet at the end of each
+ * timing slice, so anything outside of a slice may safely touch the state of every core.
+ */
+class CPUThreads {
+public:
+    using RunFunction = std::function<void(ARM_Interface&)>;
+
+    explicit CPUThreads(System& system, const std::vector<std::shared_ptr<ARM_Interface>>& cores,
+                        RunFunction run_core);
+    ~CPUThreads();
+
+    CPUThreads(const CPUThreads&) = delete;
+    CPUThreads& operator=(const CPUThreads&) = delete;
+
+    /// Runs one slice on every core and returns once all of them have reached its end.
+    void RunSlice();
+
+private:
+    void WorkerLoop(std::stop_token stop_token, ARM_Interface& core);
+
+    System& system;
+    const std::vector<std::shared_ptr<ARM_Interface>>& cores;
+    RunFunction run_core;
+    Common::Barrier slice_start;
+    Common::Barrier slice_end;
+    std::vector<std::jthread> workers;
+};
+
+} // namespace Core
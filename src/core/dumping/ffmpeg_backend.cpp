@@ -141,6 +141,20 @@ static AVPixelFormat GetPixelFormat(AVCodecContext* avctx, const AVPixelFormat*
     return AV_PIX_FMT_NONE;
 }
 
+// Hardware encoders that accept RGB input convert it to YUV on the device. Feeding them the
+// format of the dumped frames skips the software colour conversion of every frame.
+static AVPixelFormat GetHardwareInputFormat(const AVCodec* codec) {
+    if (!(codec->capabilities & AV_CODEC_CAP_HARDWARE) || !codec->pix_fmts) {
+        return AV_PIX_FMT_NONE;
+    }
+    for (int i = 0; codec->pix_fmts[i] != AV_PIX_FMT_NONE; i++) {
+        if (codec->pix_fmts[i] == AV_PIX_FMT_BGRA || codec->pix_fmts[i] == AV_PIX_FMT_BGR0) {
+            return codec->pix_fmts[i];
+        }
+    }
+    return AV_PIX_FMT_NONE;
+}
+
 bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout& layout_) {
     InitializeFFmpegLibraries();
 
@@ -175,6 +189,9 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
     auto pixel_format_opt = FFmpeg::av_dict_get(options, "pixel_format", nullptr, 0);
     if (pixel_format_opt) {
         sw_pixel_format = FFmpeg::av_get_pix_fmt(pixel_format_opt->value);
+    } else if (const auto input_format = GetHardwareInputFormat(codec);
+               input_format != AV_PIX_FMT_NONE) {
+        sw_pixel_format = input_format;
     } else if (codec->pix_fmts) {
         sw_pixel_format = GetPixelFormat(codec_context.get(), codec->pix_fmts);
     } else {
@@ -758,14 +775,16 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
         video_processing_thread.join();
     }
     video_processing_thread = std::thread([&] {
-        event1.Set();
         while (true) {
-            event2.Wait();
-            current_buffer = (current_buffer + 1) % 2;
-            next_buffer = (current_buffer + 1) % 2;
-            event1.Set();
+            VideoFrame frame;
+            {
+                std::unique_lock lock{video_frame_mutex};
+                video_frame_available.wait(lock, [&] { return !video_frame_queue.empty(); });
+                frame = std::move(video_frame_queue.front());
+                video_frame_queue.pop_front();
+            }
+            video_frame_space.notify_one();
             // Process this frame
-            auto& frame = video_frame_buffers[current_buffer];
             if (frame.width == 0 && frame.height == 0) {
                 // An empty frame marks the end of frame data
                 ffmpeg.FlushVideo();
@@ -803,9 +822,13 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
 }
 
 void FFmpegBackend::AddVideoFrame(VideoFrame frame) {
-    event1.Wait();
-    video_frame_buffers[next_buffer] = std::move(frame);
-    event2.Set();
+    {
+        std::unique_lock lock{video_frame_mutex};
+        video_frame_space.wait(lock,
+                               [&] { return video_frame_queue.size() < MaxQueuedVideoFrames; });
+        video_frame_queue.push_back(std::move(frame));
+    }
+    video_frame_available.notify_one();
 }
 
 void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <limits>
 #include <memory>
 #include <mutex>
@@ -181,7 +182,8 @@ private:
 
 /**
  * FFmpeg video dumping backend.
- * This class implements a double buffer.
+ * Video frames are handed to the encoding thread through a bounded queue, so that encoder spikes
+ * are absorbed without stalling emulation until the queue fills up.
  */
 class FFmpegBackend : public Backend {
 public:
@@ -203,10 +205,14 @@ private:
 
     FFmpegMuxer ffmpeg{};
 
+    /// Number of frames that may wait for the encoder before the dumper blocks
+    static constexpr std::size_t MaxQueuedVideoFrames = 4;
+
     Layout::FramebufferLayout video_layout;
-    std::array<VideoFrame, 2> video_frame_buffers;
-    u32 current_buffer = 0, next_buffer = 1;
-    Common::Event event1, event2;
+    std::deque<VideoFrame> video_frame_queue;
+    std::mutex video_frame_mutex;
+    std::condition_variable video_frame_available;
+    std::condition_variable video_frame_space;
     std::thread video_processing_thread;
 
     std::array<Common::SPSCQueue<VariableAudioFrame>, 2> audio_frame_queues;
@@ -188,12 +188,11 @@ public:
     virtual u64 GetFreeBytes() const = 0;
 
     u64 GetOpenDelayNs() {
-        if (delay_generator != nullptr) {
-            return delay_generator->GetOpenDelayNs();
+        if (delay_generator == nullptr) {
+            LOG_ERROR(Service_FS, "Delay generator was not initalized. Using default");
+            delay_generator = std::make_unique<DefaultDelayGenerator>();
         }
-        LOG_ERROR(Service_FS, "Delay generator was not initalized. Using default");
-        delay_generator = std::make_unique<DefaultDelayGenerator>();
-        return delay_generator->GetOpenDelayNs();
+        return EmulateDelay(delay_generator->GetOpenDelayNs());
     }
 
 protected:
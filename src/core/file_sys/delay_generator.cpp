@@ -3,7 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include "common/archives.h"
+#include "common/settings.h"
 #include "core/file_sys/delay_generator.h"
 
 SERIALIZE_EXPORT_IMPL(FileSys::DefaultDelayGenerator)
@@ -29,4 +31,18 @@ u64 DefaultDelayGenerator::GetOpenDelayNs() {
     return IPCDelayNanoseconds;
 }
 
+static std::atomic<u64> emulated_delay_total{0};
+
+u64 EmulateDelay(u64 delay_ns) {
+    if (!Settings::values.emulate_fs_delay.GetValue()) {
+        return 0;
+    }
+    emulated_delay_total.fetch_add(delay_ns, std::memory_order_relaxed);
+    return delay_ns;
+}
+
+u64 TakeEmulatedDelayTotal() {
+    return emulated_delay_total.exchange(0, std::memory_order_relaxed);
+}
+
 } // namespace FileSys
@@ -40,6 +40,16 @@ public:
     SERIALIZE_DELAY_GENERATOR
 };
 
+/**
+ * Returns the delay emulated for an operation taking delay_ns on the console. It is zero when the
+ * filesystem latency is not emulated for the running title, the operation then completes as soon
+ * as the host does it.
+ */
+u64 EmulateDelay(u64 delay_ns);
+
+/// Returns the total delay emulated by filesystem operations since the last call, in nanoseconds.
+u64 TakeEmulatedDelayTotal();
+
 } // namespace FileSys
 
 BOOST_CLASS_EXPORT_KEY(FileSys::DefaultDelayGenerator);
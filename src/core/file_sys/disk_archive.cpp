@@ -16,11 +16,19 @@ SERIALIZE_EXPORT_IMPL(FileSys::DiskDirectory)
 
 namespace FileSys {
 
+/// Maximum amount of data gathered by the write buffer of a DiskFile
+constexpr std::size_t WRITE_BUFFER_SIZE = 64 * 1024;
+
+DiskFile::~DiskFile() {
+    FlushWriteBuffer();
+}
+
 ResultVal<std::size_t> DiskFile::Read(const u64 offset, const std::size_t length,
                                       u8* buffer) const {
     if (!mode.read_flag)
         return ResultInvalidOpenFlags;
 
+    FlushWriteBuffer();
     file->Seek(offset, SEEK_SET);
     return file->ReadBytes(buffer, length);
 }
@@ -30,6 +38,18 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
     if (!mode.write_flag)
         return ResultInvalidOpenFlags;
 
+    const bool continues_buffer =
+        write_buffer.empty() || offset == write_buffer_offset + write_buffer.size();
+    if (!flush && continues_buffer && write_buffer.size() + length <= WRITE_BUFFER_SIZE) {
+        if (write_buffer.empty()) {
+            write_buffer.reserve(WRITE_BUFFER_SIZE);
+            write_buffer_offset = offset;
+        }
+        write_buffer.insert(write_buffer.end(), buffer, buffer + length);
+        return length;
+    }
+
+    FlushWriteBuffer();
     file->Seek(offset, SEEK_SET);
     std::size_t written = file->WriteBytes(buffer, length);
     if (flush)
@@ -38,19 +58,42 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
 }
 
 u64 DiskFile::GetSize() const {
+    FlushWriteBuffer();
     return file->GetSize();
 }
 
 bool DiskFile::SetSize(const u64 size) const {
+    FlushWriteBuffer();
     file->Resize(size);
     file->Flush();
     return true;
 }
 
 bool DiskFile::Close() const {
+    FlushWriteBuffer();
     return file->Close();
 }
 
+void DiskFile::Flush() const {
+    FlushWriteBuffer();
+    file->Flush();
+}
+
+bool DiskFile::FlushWriteBuffer() const {
+    if (write_buffer.empty()) {
+        return true;
+    }
+    file->Seek(write_buffer_offset, SEEK_SET);
+    const std::size_t written = file->WriteBytes(write_buffer.data(), write_buffer.size());
+    const bool success = written == write_buffer.size();
+    if (!success) {
+        LOG_ERROR(Service_FS, "Wrote {} of {} buffered bytes at offset {:#x}", written,
+                  write_buffer.size(), write_buffer_offset);
+    }
+    write_buffer.clear();
+    return success;
+}
+
 DiskDirectory::DiskDirectory(const std::string& path) {
     directory.size = FileUtil::ScanDirectoryTree(path, directory);
     directory.isDirectory = true;
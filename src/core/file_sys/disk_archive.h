@@ -29,16 +29,15 @@ public:
         mode.hex = mode_.hex;
     }
 
+    ~DiskFile() override;
+
     ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override;
     ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
                                  const u8* buffer) override;
     u64 GetSize() const override;
     bool SetSize(u64 size) const override;
     bool Close() const override;
-
-    void Flush() const override {
-        file->Flush();
-    }
+    void Flush() const override;
 
 protected:
     Mode mode;
@@ -47,8 +46,22 @@ protected:
 private:
     DiskFile() = default;
 
+    /// Writes the buffered data to the file, returns false if it could not be written entirely
+    bool FlushWriteBuffer() const;
+
+    /**
+     * Small writes without the flush flag are gathered here while each one continues the previous
+     * one, and written to the file together. Reads and anything else touching the file write them
+     * first.
+     */
+    mutable std::vector<u8> write_buffer;
+    mutable u64 write_buffer_offset{};
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
+        if (Archive::is_saving::value) {
+            FlushWriteBuffer();
+        }
         ar& boost::serialization::base_object<FileBackend>(*this);
         ar& mode.hex;
         ar& file;
@@ -45,21 +45,19 @@ public:
      * @return Nanoseconds for the delay
      */
     u64 GetReadDelayNs(std::size_t length) {
-        if (delay_generator != nullptr) {
-            return delay_generator->GetReadDelayNs(length);
+        if (delay_generator == nullptr) {
+            LOG_ERROR(Service_FS, "Delay generator was not initalized. Using default");
+            delay_generator = std::make_unique<DefaultDelayGenerator>();
         }
-        LOG_ERROR(Service_FS, "Delay generator was not initalized. Using default");
-        delay_generator = std::make_unique<DefaultDelayGenerator>();
-        return delay_generator->GetReadDelayNs(length);
+        return EmulateDelay(delay_generator->GetReadDelayNs(length));
     }
 
     u64 GetOpenDelayNs() {
-        if (delay_generator != nullptr) {
-            return delay_generator->GetOpenDelayNs();
+        if (delay_generator == nullptr) {
+            LOG_ERROR(Service_FS, "Delay generator was not initalized. Using default");
+            delay_generator = std::make_unique<DefaultDelayGenerator>();
         }
-        LOG_ERROR(Service_FS, "Delay generator was not initalized. Using default");
-        delay_generator = std::make_unique<DefaultDelayGenerator>();
-        return delay_generator->GetOpenDelayNs();
+        return EmulateDelay(delay_generator->GetOpenDelayNs());
     }
 
     /**
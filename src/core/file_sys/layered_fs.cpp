@@ -4,11 +4,13 @@
 
 #include <algorithm>
 #include <cstring>
+#include <fmt/format.h>
 #include "common/alignment.h"
 #include "common/archives.h"
 #include "common/assert.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/file_sys/layered_fs.h"
@@ -23,7 +25,8 @@ struct FileRelocationInfo {
     u64 original_offset;           // Type 0. Offset is absolute
     std::string replace_file_path; // Type 1
     std::vector<u8> patched_file;  // Type 2
-    u64 size;                      // Relocated file size
+    std::span<const u8> patched_data; // Type 2, in patched_file or in the index
+    u64 size;                         // Relocated file size
 };
 struct LayeredFS::File {
     std::string name;
@@ -54,6 +57,35 @@ struct FileMetadata {
 };
 static_assert(sizeof(FileMetadata) == 0x20, "Size of FileMetadata is not correct");
 
+constexpr u32 LAYERED_FS_INDEX_MAGIC = 0x4953'464C; // "LFSI"
+constexpr u32 LAYERED_FS_INDEX_VERSION = 1;
+
+/// Replacement files kept open between reads
+constexpr std::size_t MAX_OPEN_REPLACE_FILES = 32;
+
+struct LayeredFSIndexHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le key;
+    u64_le metadata_size; // The metadata follows the header
+    u64_le data_size;
+    u64_le num_entries; // The entries follow the metadata
+    // Followed by the paths and patched files the entries point to
+};
+static_assert(sizeof(LayeredFSIndexHeader) == 0x28, "Size of LayeredFSIndexHeader is not correct");
+
+struct LayeredFSIndexEntry {
+    u64_le data_offset;
+    u64_le size;
+    u64_le original_offset;
+    u64_le path_offset;
+    u64_le payload_offset; // Replacement file path, or patched file
+    u64_le payload_size;
+    u32_le path_length;
+    u32_le type;
+};
+static_assert(sizeof(LayeredFSIndexEntry) == 0x38, "Size of LayeredFSIndexEntry is not correct");
+
 LayeredFS::LayeredFS() = default;
 
 LayeredFS::LayeredFS(std::shared_ptr<RomFSReader> romfs_, std::string patch_path_,
@@ -68,6 +100,13 @@ void LayeredFS::Load() {
 
     ASSERT_MSG(header.header_length == sizeof(header), "Header size is incorrect");
 
+    // Computed before loading the relocations, which trim the extension path
+    const std::string index_path = GetIndexPath();
+    const std::optional<u64> index_key = load_relocations ? ComputeIndexKey() : std::nullopt;
+    if (index_key && LoadIndex(index_path, *index_key)) {
+        return;
+    }
+
     // TODO: is root always the first directory in table?
     root.parent = &root;
     LoadDirectory(root, 0);
@@ -78,6 +117,10 @@ void LayeredFS::Load() {
     }
 
     RebuildMetadata();
+
+    if (index_key) {
+        SaveIndex(index_path, *index_key);
+    }
 }
 
 LayeredFS::~LayeredFS() = default;
@@ -260,6 +303,7 @@ void LayeredFS::LoadExtRelocations() {
                 file.relocation.type = 2;
                 file.relocation.size = buffer.size();
                 file.relocation.patched_file = std::move(buffer);
+                file.relocation.patched_data = file.relocation.patched_file;
             } else {
                 LOG_ERROR(Service_FS, "LayeredFS failed to patch file {}", file_path);
             }
@@ -471,16 +515,231 @@ void LayeredFS::RebuildMetadata() {
         Common::AlignUp(header.file_metadata_table.offset + header.file_metadata_table.length, 16);
 
     // Write hash table and metadata table
-    metadata.resize(header.file_data_offset);
-    std::memcpy(metadata.data(), &header, header.header_length);
-    std::memcpy(metadata.data() + header.directory_hash_table.offset, directory_hash_table.data(),
-                header.directory_hash_table.length);
-    std::memcpy(metadata.data() + header.directory_metadata_table.offset,
+    metadata_buffer.resize(header.file_data_offset);
+    std::memcpy(metadata_buffer.data(), &header, header.header_length);
+    std::memcpy(metadata_buffer.data() + header.directory_hash_table.offset,
+                directory_hash_table.data(), header.directory_hash_table.length);
+    std::memcpy(metadata_buffer.data() + header.directory_metadata_table.offset,
                 directory_metadata_table.data(), header.directory_metadata_table.length);
-    std::memcpy(metadata.data() + header.file_hash_table.offset, file_hash_table.data(),
+    std::memcpy(metadata_buffer.data() + header.file_hash_table.offset, file_hash_table.data(),
                 header.file_hash_table.length);
-    std::memcpy(metadata.data() + header.file_metadata_table.offset, file_metadata_table.data(),
-                header.file_metadata_table.length);
+    std::memcpy(metadata_buffer.data() + header.file_metadata_table.offset,
+                file_metadata_table.data(), header.file_metadata_table.length);
+    metadata = metadata_buffer;
+}
+
+std::optional<u64> LayeredFS::ComputeIndexKey() const {
+    // The metadata and the size of the RomFS identify it, without hashing all the data
+    std::vector<u8> original_metadata(header.file_data_offset);
+    if (romfs->ReadFile(0, original_metadata.size(), original_metadata.data()) !=
+        original_metadata.size()) {
+        return std::nullopt;
+    }
+    u64 key = Common::ComputeHash64(original_metadata.data(), original_metadata.size());
+    key = Common::HashCombine(key, romfs->GetSize());
+
+    const auto hash_string = [](const std::string& string) {
+        return Common::ComputeHash64(string.data(), string.size());
+    };
+    bool complete = true;
+    const auto hash_tree = [&](const auto& self, const FileUtil::FSTEntry& parent) -> void {
+        for (const auto& entry : parent.children) {
+            key = Common::HashCombine(key, hash_string(entry.virtualName));
+            if (entry.isDirectory) {
+                self(self, entry);
+                continue;
+            }
+            const std::optional<s64> time = FileUtil::GetModificationTime(entry.physicalName);
+            complete &= time.has_value();
+            key = Common::HashCombine(key, entry.size);
+            key = Common::HashCombine(key, static_cast<u64>(time.value_or(0)));
+        }
+    };
+    for (std::string path : {patch_path, patch_ext_path}) {
+        key = Common::HashCombine(key, hash_string(path));
+        if (path.empty() || !FileUtil::Exists(path)) {
+            continue;
+        }
+        if (path.back() == '/' || path.back() == '\\') {
+            // ScanDirectoryTree expects a path without trailing '/'
+            path.pop_back();
+        }
+        FileUtil::FSTEntry tree;
+        FileUtil::ScanDirectoryTree(path, tree, 256);
+        hash_tree(hash_tree, tree);
+    }
+
+    if (!complete) {
+        LOG_DEBUG(Service_FS, "LayeredFS index unavailable, the mod modification times are unknown");
+        return std::nullopt;
+    }
+    return key;
+}
+
+std::string LayeredFS::GetIndexPath() const {
+    const std::string paths = patch_path + '\0' + patch_ext_path;
+    return fmt::format("{}layeredfs/{:016X}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::CacheDir),
+                       Common::ComputeHash64(paths.data(), paths.size()));
+}
+
+bool LayeredFS::LoadIndex(const std::string& path, u64 key) {
+    FileUtil::IOFile file(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(file.GetSize());
+    std::span<const u8> index;
+    index_mapping = Common::MappedFile(file, 0, size);
+    if (index_mapping.IsValid()) {
+        index = index_mapping.Data();
+    } else {
+        index_buffer.resize(size);
+        if (file.ReadAtBytes(index_buffer.data(), size, 0) != size) {
+            index_buffer.clear();
+            return false;
+        }
+        index = index_buffer;
+    }
+
+    const auto reset = [this] {
+        index_mapping = Common::MappedFile{};
+        index_buffer.clear();
+        indexed_files.clear();
+        data_offset_map.clear();
+        return false;
+    };
+
+    LayeredFSIndexHeader index_header;
+    if (index.size() < sizeof(index_header)) {
+        return reset();
+    }
+    std::memcpy(&index_header, index.data(), sizeof(index_header));
+    const u64 entries_offset = sizeof(index_header) + index_header.metadata_size;
+    if (index_header.magic != LAYERED_FS_INDEX_MAGIC ||
+        index_header.version != LAYERED_FS_INDEX_VERSION || index_header.key != key ||
+        index_header.metadata_size > index.size() - sizeof(index_header) ||
+        index_header.num_entries > (index.size() - entries_offset) / sizeof(LayeredFSIndexEntry)) {
+        LOG_INFO(Service_FS, "LayeredFS index is stale, rebuilding");
+        return reset();
+    }
+
+    const auto in_bounds = [&index](u64 offset, u64 length) {
+        return offset <= index.size() && length <= index.size() - offset;
+    };
+    for (u64 i = 0; i < index_header.num_entries; i++) {
+        LayeredFSIndexEntry entry;
+        std::memcpy(&entry, index.data() + entries_offset + i * sizeof(entry), sizeof(entry));
+        if (!in_bounds(entry.path_offset, entry.path_length) ||
+            !in_bounds(entry.payload_offset, entry.payload_size) || entry.type > 2) {
+            LOG_ERROR(Service_FS, "LayeredFS index is corrupted, rebuilding");
+            return reset();
+        }
+
+        auto file = std::make_unique<File>();
+        file->path.assign(reinterpret_cast<const char*>(index.data() + entry.path_offset),
+                          entry.path_length);
+        file->relocation.type = static_cast<int>(entry.type);
+        file->relocation.original_offset = entry.original_offset;
+        file->relocation.size = entry.size;
+        const auto payload = index.subspan(static_cast<std::size_t>(entry.payload_offset),
+                                           static_cast<std::size_t>(entry.payload_size));
+        if (entry.type == 1) {
+            file->relocation.replace_file_path.assign(
+                reinterpret_cast<const char*>(payload.data()), payload.size());
+        } else if (entry.type == 2) {
+            file->relocation.patched_data = payload;
+        }
+        data_offset_map.emplace(entry.data_offset, file.get());
+        indexed_files.emplace_back(std::move(file));
+    }
+
+    metadata = index.subspan(sizeof(index_header),
+                             static_cast<std::size_t>(index_header.metadata_size));
+    current_data_offset = index_header.data_size;
+    LOG_INFO(Service_FS, "LayeredFS loaded from index with {} files", indexed_files.size());
+    return true;
+}
+
+void LayeredFS::SaveIndex(const std::string& path, u64 key) const {
+    if (!FileUtil::CreateFullPath(path)) {
+        return;
+    }
+
+    // The paths and payloads are written in the order of the entries, after them
+    std::vector<LayeredFSIndexEntry> entries;
+    entries.reserve(data_offset_map.size());
+    u64 offset = sizeof(LayeredFSIndexHeader) + metadata.size() +
+                 data_offset_map.size() * sizeof(LayeredFSIndexEntry);
+    for (const auto& [data_offset, file] : data_offset_map) {
+        const auto& relocation = file->relocation;
+        LayeredFSIndexEntry& entry = entries.emplace_back();
+        entry.data_offset = data_offset;
+        entry.size = relocation.size;
+        entry.original_offset = relocation.original_offset;
+        entry.type = static_cast<u32>(relocation.type);
+        entry.path_offset = offset;
+        entry.path_length = static_cast<u32>(file->path.size());
+        offset += file->path.size();
+        entry.payload_offset = offset;
+        entry.payload_size = relocation.type == 1   ? relocation.replace_file_path.size()
+                             : relocation.type == 2 ? relocation.patched_data.size()
+                                                    : 0;
+        offset += entry.payload_size;
+    }
+
+    LayeredFSIndexHeader index_header{};
+    index_header.magic = LAYERED_FS_INDEX_MAGIC;
+    index_header.version = LAYERED_FS_INDEX_VERSION;
+    index_header.key = key;
+    index_header.metadata_size = metadata.size();
+    index_header.data_size = current_data_offset;
+    index_header.num_entries = entries.size();
+
+    FileUtil::IOFile file(path, "wb");
+    bool success = file.WriteObject(index_header) == 1 &&
+                   file.WriteBytes(metadata.data(), metadata.size()) == metadata.size() &&
+                   file.WriteArray(entries.data(), entries.size()) == entries.size();
+    for (const auto& [data_offset, indexed_file] : data_offset_map) {
+        if (!success) {
+            break;
+        }
+        const auto& relocation = indexed_file->relocation;
+        success = file.WriteString(indexed_file->path) == indexed_file->path.size();
+        if (relocation.type == 1) {
+            success &= file.WriteString(relocation.replace_file_path) ==
+                       relocation.replace_file_path.size();
+        } else if (relocation.type == 2) {
+            success &= file.WriteBytes(relocation.patched_data.data(),
+                                       relocation.patched_data.size()) ==
+                       relocation.patched_data.size();
+        }
+    }
+    if (!success) {
+        LOG_ERROR(Service_FS, "Could not write the LayeredFS index {}", path);
+        file.Close();
+        FileUtil::Delete(path);
+    }
+}
+
+FileUtil::IOFile* LayeredFS::OpenReplaceFile(File& file) {
+    const auto it = std::find_if(open_replace_files.begin(), open_replace_files.end(),
+                                 [&file](const auto& entry) { return entry.first == &file; });
+    if (it != open_replace_files.end()) {
+        open_replace_files.splice(open_replace_files.begin(), open_replace_files, it);
+        return &open_replace_files.front().second;
+    }
+
+    FileUtil::IOFile replace_file(file.relocation.replace_file_path, "rb");
+    if (!replace_file) {
+        return nullptr;
+    }
+    open_replace_files.emplace_front(&file, std::move(replace_file));
+    if (open_replace_files.size() > MAX_OPEN_REPLACE_FILES) {
+        open_replace_files.pop_back();
+    }
+    return &open_replace_files.front().second;
 }
 
 std::size_t LayeredFS::GetSize() const {
@@ -522,16 +781,14 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
             romfs->ReadFile(relocation.original_offset + relative_offset, to_read,
                             buffer + read_size);
         } else if (relocation.type == 1) { // replace
-            FileUtil::IOFile replace_file(relocation.replace_file_path, "rb");
-            if (replace_file) {
-                replace_file.Seek(relative_offset, SEEK_SET);
-                replace_file.ReadBytes(buffer + read_size, to_read);
+            if (FileUtil::IOFile* replace_file = OpenReplaceFile(*current->second)) {
+                replace_file->ReadAtBytes(buffer + read_size, to_read, relative_offset);
             } else {
                 LOG_ERROR(Service_FS, "Could not open replacement file for {}",
                           current->second->path);
             }
         } else if (relocation.type == 2) { // patch
-            std::memcpy(buffer + read_size, relocation.patched_file.data() + relative_offset,
+            std::memcpy(buffer + read_size, relocation.patched_data.data() + relative_offset,
                         to_read);
         } else {
             UNREACHABLE();
@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <list>
 #include <map>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -14,6 +17,8 @@
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/string.hpp>
 #include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/mapped_file.h"
 #include "common/swap.h"
 #include "core/file_sys/romfs_reader.h"
 
@@ -41,6 +46,10 @@ static_assert(sizeof(RomFSHeader) == 0x28, "Size of RomFSHeader is not correct")
  * patch_ext_path: Path for RomFS extensions. Files present in this path:
  *  - When with an extension of ".stub", remove the corresponding file in the RomFS.
  *  - When with an extension of ".ips" or ".bps", patch the file in the RomFS.
+ *
+ * The rebuilt metadata, the relocations and the patched files are saved to an index in the cache
+ * directory. Later boots map that index instead of rebuilding, as long as the RomFS metadata and
+ * the sizes and modification times of the mod files are unchanged.
  */
 class LayeredFS : public RomFSReader {
 public:
@@ -108,6 +117,20 @@ private:
 
     void Load();
 
+    // Hash of the RomFS metadata and of the names, sizes and modification times of the mod files.
+    // nullopt if a modification time is unknown, in which case no index is used.
+    std::optional<u64> ComputeIndexKey() const;
+
+    std::string GetIndexPath() const;
+
+    // Loads the metadata and relocations from the index. Returns false if it is missing or stale.
+    bool LoadIndex(const std::string& path, u64 key);
+
+    void SaveIndex(const std::string& path, u64 key) const;
+
+    // Returns the replacement file of a relocation, opening it on its first read
+    FileUtil::IOFile* OpenReplaceFile(File& file);
+
     std::shared_ptr<RomFSReader> romfs;
     std::string patch_path;
     std::string patch_ext_path;
@@ -118,7 +141,16 @@ private:
     std::unordered_map<std::string, File*> file_path_map;
     std::unordered_map<std::string, Directory*> directory_path_map;
     std::map<u64, File*> data_offset_map; // assigned data offset -> file
-    std::vector<u8> metadata;             // Includes header, hash table and metadata
+    std::span<const u8> metadata;         // Includes header, hash table and metadata
+    std::vector<u8> metadata_buffer;      // Backs metadata when it is rebuilt
+
+    // Loaded from the index, which backs the metadata and the patched files
+    Common::MappedFile index_mapping;
+    std::vector<u8> index_buffer; // Holds the index when it cannot be mapped
+    std::vector<std::unique_ptr<File>> indexed_files;
+
+    // Replacement files opened by reads, the most recently used first
+    std::list<std::pair<File*, FileUtil::IOFile>> open_replace_files;
 
     // Used for rebuilding header
     std::vector<u32_le> directory_hash_table;
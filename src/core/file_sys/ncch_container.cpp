@@ -9,7 +9,10 @@
 #include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
 #include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/mapped_file.h"
 #include "core/core.h"
 #include "core/file_sys/layered_fs.h"
 #include "core/file_sys/ncch_container.h"
@@ -20,6 +23,19 @@
 
 namespace FileSys {
 
+constexpr u32 CODE_CACHE_MAGIC = 0x4543'4443; // "CDCE"
+constexpr u32 CODE_CACHE_VERSION = 1;
+
+/// Header of a decompressed .code section saved to the cache
+struct CodeCacheHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le compressed_hash;   ///< Hash of the compressed section the code was decompressed from
+    u64_le decompressed_hash; ///< Hash of the code following the header
+    u64_le size;
+};
+static_assert(sizeof(CodeCacheHeader) == 0x20, "CodeCacheHeader has incorrect size");
+
 static const int kMaxSections = 8;   ///< Maximum number of sections (files) in an ExeFs
 static const int kBlockSize = 0x200; ///< Size of ExeFS blocks (in bytes)
 
@@ -61,8 +77,9 @@ static bool LZSS_Decompress(std::span<const u8> compressed, std::span<u8> decomp
     std::size_t index = compressed.size() - ((buffer_top_and_bottom >> 24) & 0xFF);
     std::size_t stop_index = compressed.size() - (buffer_top_and_bottom & 0xFFFFFF);
 
-    std::memset(decompressed.data(), 0, decompressed.size());
     std::memcpy(decompressed.data(), compressed.data(), compressed.size());
+    std::memset(decompressed.data() + compressed.size(), 0,
+                decompressed.size() - compressed.size());
 
     while (index > stop_index) {
         u8 control = compressed[--index];
@@ -86,17 +103,21 @@ static bool LZSS_Decompress(std::span<const u8> compressed, std::span<u8> decomp
                 segment_offset &= 0x0FFF;
                 segment_offset += 2;
 
-                // Check if compression is out of bounds
-                if (out < segment_size)
+                // Check if compression is out of bounds, the first byte copied is the furthest
+                if (out < segment_size || out + segment_offset >= decompressed.size())
                     return false;
 
-                for (unsigned j = 0; j < segment_size; j++) {
-                    // Check if compression is out of bounds
-                    if (out + segment_offset >= decompressed.size())
-                        return false;
-
-                    u8 data = decompressed[out + segment_offset];
-                    decompressed[--out] = data;
+                // The segment is copied backwards from segment_offset + 1 bytes after it. When
+                // the source does not overlap the destination, it is copied at once.
+                out -= segment_size;
+                u8* const dest = decompressed.data() + out;
+                const std::size_t distance = segment_offset + 1;
+                if (distance >= segment_size) {
+                    std::memcpy(dest, dest + distance, segment_size);
+                } else {
+                    for (std::size_t j = segment_size; j-- > 0;) {
+                        dest[j] = dest[j + distance];
+                    }
                 }
             } else {
                 // Check if compression is out of bounds
@@ -110,6 +131,58 @@ static bool LZSS_Decompress(std::span<const u8> compressed, std::span<u8> decomp
     return true;
 }
 
+static std::string GetCodeCachePath(u64 program_id) {
+    return fmt::format("{}code/{:016X}.bin", FileUtil::GetUserPath(FileUtil::UserPath::CacheDir),
+                       program_id);
+}
+
+/**
+ * Loads the decompressed .code section of a title from the cache
+ * @param program_id Program ID of the title
+ * @param compressed_hash Hash of the compressed section
+ * @param code Buffer receiving the decompressed section
+ * @return True if the cache held the section decompressed from the same data
+ */
+static bool LoadCachedCode(u64 program_id, u64 compressed_hash, std::vector<u8>& code) {
+    FileUtil::IOFile file(GetCodeCachePath(program_id), "rb");
+    CodeCacheHeader header;
+    if (!file || file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != CODE_CACHE_MAGIC || header.version != CODE_CACHE_VERSION ||
+        header.compressed_hash != compressed_hash ||
+        header.size != file.GetSize() - sizeof(header)) {
+        return false;
+    }
+
+    code.resize(header.size);
+    if (file.ReadBytes(code.data(), code.size()) != code.size() ||
+        Common::ComputeHash64(code.data(), code.size()) != header.decompressed_hash) {
+        LOG_WARNING(Service_FS, "Cached code of {:016X} is corrupted", program_id);
+        return false;
+    }
+    return true;
+}
+
+static void SaveCachedCode(u64 program_id, u64 compressed_hash, std::span<const u8> code) {
+    const std::string path = GetCodeCachePath(program_id);
+    if (!FileUtil::CreateFullPath(path)) {
+        return;
+    }
+
+    CodeCacheHeader header{};
+    header.magic = CODE_CACHE_MAGIC;
+    header.version = CODE_CACHE_VERSION;
+    header.compressed_hash = compressed_hash;
+    header.decompressed_hash = Common::ComputeHash64(code.data(), code.size());
+    header.size = code.size();
+
+    FileUtil::IOFile file(path, "wb");
+    if (file.WriteObject(header) != 1 || file.WriteBytes(code.data(), code.size()) != code.size()) {
+        LOG_ERROR(Service_FS, "Could not write the cached code {}", path);
+        file.Close();
+        FileUtil::Delete(path);
+    }
+}
+
 NCCHContainer::NCCHContainer(const std::string& filepath, u32 ncch_offset, u32 partition)
     : ncch_offset(ncch_offset), partition(partition), filepath(filepath) {
     file = FileUtil::IOFile(filepath, "rb");
@@ -525,40 +598,61 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 (section.offset + exefs_offset + sizeof(ExeFs_Header) + ncch_offset);
             exefs_file.Seek(section_offset, SEEK_SET);
 
-            std::array<u8, 16> key;
-            if (strcmp(section.name, "icon") == 0 || strcmp(section.name, "banner") == 0) {
-                key = primary_key;
-            } else {
-                key = secondary_key;
-            }
-
-            CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption dec(key.data(), key.size(),
-                                                              exefs_ctr.data());
-            dec.Seek(section.offset + sizeof(ExeFs_Header));
+            // Each section is decrypted in a single pass, so the key schedule only runs for
+            // encrypted titles
+            const auto decrypt = [&](u8* data) {
+                const std::array<u8, 16>& key =
+                    strcmp(section.name, "icon") == 0 || strcmp(section.name, "banner") == 0
+                        ? primary_key
+                        : secondary_key;
+                CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption dec(key.data(), key.size(),
+                                                                  exefs_ctr.data());
+                dec.Seek(section.offset + sizeof(ExeFs_Header));
+                dec.ProcessData(data, data, section.size);
+            };
 
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
-                // Section is compressed, read compressed .code section...
-                std::vector<u8> temp_buffer(section.size);
-                if (exefs_file.ReadBytes(temp_buffer.data(), temp_buffer.size()) !=
-                    temp_buffer.size())
-                    return Loader::ResultStatus::Error;
+                // Section is compressed, an unencrypted one is decompressed straight out of a
+                // mapping of the file...
+                Common::MappedFile mapping;
+                if (!is_encrypted) {
+                    mapping = Common::MappedFile(exefs_file, section_offset, section.size);
+                }
+                std::vector<u8> temp_buffer;
+                std::span<const u8> compressed = mapping.Data();
+                if (!mapping.IsValid()) {
+                    temp_buffer.resize(section.size);
+                    if (exefs_file.ReadBytes(temp_buffer.data(), temp_buffer.size()) !=
+                        temp_buffer.size())
+                        return Loader::ResultStatus::Error;
+
+                    if (is_encrypted) {
+                        decrypt(temp_buffer.data());
+                    }
+                    compressed = temp_buffer;
+                }
 
-                if (is_encrypted) {
-                    dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                // Decompression is skipped when it was done on a previous boot...
+                const u64 compressed_hash =
+                    Common::ComputeHash64(compressed.data(), compressed.size());
+                if (LoadCachedCode(ncch_header.program_id, compressed_hash, buffer)) {
+                    LOG_DEBUG(Service_FS, "Loaded cached decompressed .code");
+                    return Loader::ResultStatus::Success;
                 }
 
                 // Decompress .code section...
-                buffer.resize(LZSS_GetDecompressedSize(temp_buffer));
-                if (!LZSS_Decompress(temp_buffer, buffer)) {
+                buffer.resize(LZSS_GetDecompressedSize(compressed));
+                if (!LZSS_Decompress(compressed, buffer)) {
                     return Loader::ResultStatus::ErrorInvalidFormat;
                 }
+                SaveCachedCode(ncch_header.program_id, compressed_hash, buffer);
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
                 if (exefs_file.ReadBytes(buffer.data(), section.size) != section.size)
                     return Loader::ResultStatus::Error;
                 if (is_encrypted) {
-                    dec.ProcessData(buffer.data(), buffer.data(), section.size);
+                    decrypt(buffer.data());
                 }
             }
 
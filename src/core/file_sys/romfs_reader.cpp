@@ -1,112 +1,378 @@
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <unordered_map>
 #include <vector>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include "common/archives.h"
+#include "common/async_file_reader.h"
 #include "common/logging/log.h"
+#include "common/memory_budget.h"
+#include "common/settings.h"
 #include "core/file_sys/romfs_reader.h"
 
 SERIALIZE_EXPORT_IMPL(FileSys::DirectRomFSReader)
 
 namespace FileSys {
 
+namespace {
+
+/// Number of independently locked parts of the cache
+constexpr std::size_t NUM_CACHE_SHARDS = 16;
+
+/// Bounds of the data prefetched ahead of a sequential stream of reads
+constexpr std::size_t MIN_READAHEAD_SIZE = 64 * 1024;
+constexpr std::size_t MAX_READAHEAD_SIZE = 1024 * 1024;
+
+/// Number of consecutive sequential reads after which the data following them is prefetched
+constexpr std::size_t READAHEAD_THRESHOLD = 2;
+
+} // Anonymous namespace
+
+struct DirectRomFSReader::Line {
+    std::array<u8, cache_line_size> data;
+    /// Size of the valid data, shorter than a line at the end of the RomFS
+    std::size_t size;
+};
+
+/**
+ * LRU cache of the decrypted lines of the RomFS. Lines are spread over shards by their page, each
+ * with its own lock and LRU order. They are shared with the readers, so that evicting a line does
+ * not wait for the copies out of it.
+ */
+class DirectRomFSReader::Cache {
+public:
+    explicit Cache(std::size_t num_lines)
+        : shard_capacity{std::max<std::size_t>(num_lines / NUM_CACHE_SHARDS, 1)} {}
+
+    std::shared_ptr<const Line> Find(std::size_t page) {
+        Shard& shard = GetShard(page);
+        std::scoped_lock lock{shard.mutex};
+        const auto it = shard.lines.find(page);
+        if (it == shard.lines.end()) {
+            return nullptr;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second.first);
+        return it->second.second;
+    }
+
+    bool Contains(std::size_t page) {
+        Shard& shard = GetShard(page);
+        std::scoped_lock lock{shard.mutex};
+        return shard.lines.contains(page);
+    }
+
+    void Insert(std::size_t page, std::shared_ptr<const Line> line) {
+        Shard& shard = GetShard(page);
+        std::scoped_lock lock{shard.mutex};
+        const auto [it, inserted] = shard.lines.try_emplace(page);
+        if (!inserted) {
+            // Loaded by another thread in the meantime
+            return;
+        }
+        shard.lru.push_front(page);
+        it->second = {shard.lru.begin(), std::move(line)};
+        if (shard.lines.size() > shard_capacity) {
+            shard.lines.erase(shard.lru.back());
+            shard.lru.pop_back();
+        }
+    }
+
+    /// Drops all the lines, returns the number of bytes released
+    u64 Clear() {
+        u64 released = 0;
+        for (Shard& shard : shards) {
+            std::scoped_lock lock{shard.mutex};
+            released += shard.lines.size() * sizeof(Line);
+            shard.lines.clear();
+            shard.lru.clear();
+        }
+        return released;
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        /// Pages of the cached lines, the most recently used first
+        std::list<std::size_t> lru;
+        std::unordered_map<std::size_t,
+                           std::pair<std::list<std::size_t>::iterator, std::shared_ptr<const Line>>>
+            lines;
+    };
+
+    Shard& GetShard(std::size_t page) {
+        return shards[(page / cache_line_size) % NUM_CACHE_SHARDS];
+    }
+
+    std::size_t shard_capacity;
+    std::array<Shard, NUM_CACHE_SHARDS> shards;
+};
+
+/**
+ * AES-CTR decryptors keyed with the RomFS key. The key schedule runs once per decryptor instead of
+ * once per read, seeking a decryptor only resets its counter. A thread that decrypts while the
+ * others are busy gets a decryptor of its own, so the readahead never waits for the emulation.
+ */
+class DirectRomFSReader::DecryptorPool {
+public:
+    DecryptorPool(const std::array<u8, 16>& key_, const std::array<u8, 16>& ctr_)
+        : key{key_}, ctr{ctr_} {}
+
+    void Decrypt(u64 crypto_offset, u8* data, std::size_t length) {
+        std::unique_ptr<Decryptor> decryptor;
+        {
+            std::scoped_lock lock{mutex};
+            if (!idle.empty()) {
+                decryptor = std::move(idle.back());
+                idle.pop_back();
+            }
+        }
+        if (!decryptor) {
+            decryptor = std::make_unique<Decryptor>(key.data(), key.size(), ctr.data());
+        }
+
+        decryptor->Seek(crypto_offset);
+        decryptor->ProcessData(data, data, length);
+
+        std::scoped_lock lock{mutex};
+        idle.push_back(std::move(decryptor));
+    }
+
+private:
+    using Decryptor = CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption;
+
+    std::array<u8, 16> key;
+    std::array<u8, 16> ctr;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Decryptor>> idle;
+};
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file_, std::size_t file_offset_,
+                                     std::size_t data_size_)
+    : DirectRomFSReader() {
+    is_encrypted = false;
+    file = std::move(file_);
+    file_offset = file_offset_;
+    data_size = data_size_;
+    MapFile();
+}
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file_, std::size_t file_offset_,
+                                     std::size_t data_size_, const std::array<u8, 16>& key_,
+                                     const std::array<u8, 16>& ctr_, std::size_t crypto_offset_)
+    : DirectRomFSReader() {
+    is_encrypted = true;
+    file = std::move(file_);
+    key = key_;
+    ctr = ctr_;
+    file_offset = file_offset_;
+    crypto_offset = crypto_offset_;
+    data_size = data_size_;
+    ResetDecryptors();
+}
+
+DirectRomFSReader::DirectRomFSReader()
+    : is_encrypted{false}, file_offset{0}, crypto_offset{0}, data_size{0},
+      cache{std::make_unique<Cache>(std::size_t{Settings::values.romfs_cache_size.GetValue()} *
+                                    1024 * 1024 / cache_line_size)} {
+    // The lines are read again from the file, the cheapest cache to rebuild
+    memory_budget_handle = Common::MemoryBudget::Instance().AddCache(
+        "RomFS", Common::MemoryBudget::Priority::RomFS, [this](Common::MemoryPressure) {
+            std::scoped_lock lock{readahead_mutex};
+            return cache->Clear();
+        });
+}
+
+DirectRomFSReader::~DirectRomFSReader() {
+    Common::MemoryBudget::Instance().RemoveCache(memory_budget_handle);
+    std::scoped_lock lock{readahead_mutex};
+    WaitForReadaheads();
+}
+
 std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
     length = std::min(length, static_cast<std::size_t>(data_size) - offset);
     if (length == 0)
         return 0; // Crypto++ does not like zero size buffer
 
-    const auto segments = BreakupRead(offset, length);
-    std::size_t read_progress = 0;
+    Readahead(offset, length);
 
-    // Skip cache if the read is too big
-    if (segments.size() == 1 && segments[0].second > cache_line_size) {
-        length = file.ReadAtBytes(buffer, length, file_offset + offset);
-        if (is_encrypted) {
-            CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-            d.Seek(crypto_offset + offset);
-            d.ProcessData(buffer, buffer, length);
-        }
+    if (mapping.IsValid()) {
+        // The page cache of the host already caches the data
+        std::memcpy(buffer, mapping.Data().data() + offset, length);
+        LOG_TRACE(Service_FS, "RomFS mapped read: offset={}, length={}", offset, length);
+        return length;
+    }
+
+    // Skip cache if the read is too big, unless the readahead already cached all of it. Reads
+    // bigger than the cache line size will probably never hit again.
+    if (length > cache_line_size && !CacheReady(offset, length)) {
+        length = ReadDirect(offset, length, buffer);
         LOG_TRACE(Service_FS, "RomFS Cache SKIP: offset={}, length={}", offset, length);
         return length;
     }
 
-    // TODO(PabloMK7): Make cache thread safe, read the comment in CacheReady function.
-    // std::unique_lock<std::shared_mutex> read_guard(cache_mutex);
-    for (const auto& seg : segments) {
-        std::size_t read_size = cache_line_size;
-        std::size_t page = OffsetToPage(seg.first);
-        // Check if segment is in cache
-        auto cache_entry = cache.request(page);
-        if (!cache_entry.first) {
-            // If not found, read from disk and cache the data
-            read_size = file.ReadAtBytes(cache_entry.second.data(), read_size, file_offset + page);
-            if (is_encrypted && read_size) {
-                CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-                d.Seek(crypto_offset + page);
-                d.ProcessData(cache_entry.second.data(), cache_entry.second.data(), read_size);
-            }
-            LOG_TRACE(Service_FS, "RomFS Cache MISS: page={}, length={}, into={}", page, seg.second,
-                      (seg.first - page));
+    std::size_t read_progress = 0;
+    for (std::size_t page = OffsetToPage(offset); read_progress < length;
+         page += cache_line_size) {
+        std::shared_ptr<const Line> line = cache->Find(page);
+        if (!line) {
+            line = LoadLine(page);
+            LOG_TRACE(Service_FS, "RomFS Cache MISS: page={}", page);
         } else {
-            LOG_TRACE(Service_FS, "RomFS Cache HIT: page={}, length={}, into={}", page, seg.second,
-                      (seg.first - page));
+            LOG_TRACE(Service_FS, "RomFS Cache HIT: page={}", page);
+        }
+        const std::size_t line_offset = offset + read_progress - page;
+        if (line->size <= line_offset) {
+            break;
         }
-        std::size_t copy_amount =
-            (read_size > (seg.first - page))
-                ? std::min((seg.first - page) + seg.second, read_size) - (seg.first - page)
-                : 0;
-        std::memcpy(buffer + read_progress, cache_entry.second.data() + (seg.first - page),
-                    copy_amount);
+        const std::size_t copy_amount = std::min(line->size - line_offset, length - read_progress);
+        std::memcpy(buffer + read_progress, line->data.data() + line_offset, copy_amount);
         read_progress += copy_amount;
     }
     return read_progress;
 }
 
-bool DirectRomFSReader::AllowsCachedReads() const {
-    return true;
+std::size_t DirectRomFSReader::ReadDirect(std::size_t offset, std::size_t length, u8* buffer) {
+    return FinishRead(offset, length, file.ReadAtBytes(buffer, length, file_offset + offset),
+                      buffer);
 }
 
-bool DirectRomFSReader::CacheReady(std::size_t file_offset, std::size_t length) {
-    auto segments = BreakupRead(file_offset, length);
-    if (segments.size() == 1 && segments[0].second > cache_line_size) {
-        return false;
-    } else {
-        // TODO(PabloMK7): Since the LRU cache is not thread safe, a lock must be used.
-        // However, this completely breaks the point of using a cache, because
-        // smaller reads may be blocked by bigger reads. For now, always return
-        // data being in cache to prevent the need of a lock, and only read data
-        // asynchronously if it is too big to use the cache.
-        /*
-        std::shared_lock<std::shared_mutex> read_guard(cache_mutex);
-        for (auto it = segments.begin(); it != segments.end(); it++) {
-            if (!cache.contains(OffsetToPage(it->first)))
-                return false;
+std::size_t DirectRomFSReader::FinishRead(std::size_t offset, std::size_t length,
+                                          std::size_t read_size, u8* buffer) {
+    if (read_size > length) {
+        LOG_ERROR(Service_FS, "RomFS read failed: offset={}, length={}", offset, length);
+        return 0;
+    }
+    length = read_size;
+    if (is_encrypted && length) {
+        decryptors->Decrypt(crypto_offset + offset, buffer, length);
+    }
+    return length;
+}
+
+std::shared_ptr<const DirectRomFSReader::Line> DirectRomFSReader::LoadLine(std::size_t page) {
+    auto line = std::make_shared<Line>();
+    const std::size_t size = std::min<std::size_t>(cache_line_size, data_size - page);
+    line->size = ReadDirect(page, size, line->data.data());
+    if (line->size != 0) {
+        cache->Insert(page, line);
+    }
+    return line;
+}
+
+void DirectRomFSReader::Readahead(std::size_t offset, std::size_t length) {
+    std::scoped_lock lock{readahead_mutex};
+    const std::size_t read_end = offset + length;
+    // Titles read streams in chunks that may skip a little padding between them
+    const bool is_sequential =
+        offset >= next_sequential_offset && offset - next_sequential_offset < cache_line_size;
+    next_sequential_offset = read_end;
+    if (!is_sequential) {
+        sequential_reads = 0;
+        readahead_end = 0;
+        return;
+    }
+    if (++sequential_reads < READAHEAD_THRESHOLD) {
+        return;
+    }
+
+    const std::size_t distance = std::clamp(length * 4, MIN_READAHEAD_SIZE, MAX_READAHEAD_SIZE);
+    const std::size_t begin = std::max(OffsetToPage(read_end), readahead_end);
+    const std::size_t end = std::min<std::size_t>(read_end + distance, data_size);
+    if (begin >= end) {
+        return;
+    }
+    readahead_end = Common::AlignUp(end, cache_line_size);
+    if (mapping.IsValid()) {
+        // The kernel reads the pages in asynchronously
+        mapping.Prefetch(begin, end - begin);
+        return;
+    }
+
+    std::erase_if(pending_readaheads, [](const std::future<void>& future) {
+        return future.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+    });
+
+    // The missing lines are read at once, spread over the I/O threads
+    std::vector<std::pair<std::size_t, std::shared_ptr<Line>>> lines;
+    std::vector<FileUtil::AsyncFileReader::Request> requests;
+    for (std::size_t page = begin; page < end; page += cache_line_size) {
+        if (cache->Contains(page)) {
+            continue;
         }
-        */
-        return true;
+        auto& line = lines.emplace_back(page, std::make_shared<Line>()).second;
+        line->size = std::min<std::size_t>(cache_line_size, data_size - page);
+        requests.push_back({line->data.data(), line->size, file_offset + page});
+    }
+    if (requests.empty()) {
+        return;
     }
+    pending_readaheads.push_back(FileUtil::AsyncFileReader::Instance().ReadBatch(
+        file, std::move(requests),
+        [this, lines = std::move(lines)](std::size_t index, std::size_t read_size) {
+            const auto& [page, line] = lines[index];
+            line->size = FinishRead(page, line->size, read_size, line->data.data());
+            if (line->size != 0) {
+                cache->Insert(page, line);
+            }
+        }));
 }
 
-std::vector<std::pair<std::size_t, std::size_t>> DirectRomFSReader::BreakupRead(
-    std::size_t offset, std::size_t length) {
+void DirectRomFSReader::WaitForReadaheads() {
+    for (const auto& future : pending_readaheads) {
+        future.wait();
+    }
+    pending_readaheads.clear();
+}
 
-    std::vector<std::pair<std::size_t, std::size_t>> ret;
+void DirectRomFSReader::ResetCache() {
+    std::scoped_lock lock{readahead_mutex};
+    WaitForReadaheads();
+    cache = std::make_unique<Cache>(std::size_t{Settings::values.romfs_cache_size.GetValue()} *
+                                    1024 * 1024 / cache_line_size);
+    next_sequential_offset = 0;
+    sequential_reads = 0;
+    readahead_end = 0;
+}
 
-    // Reads bigger than the cache line size will probably never hit again
-    if (length > cache_line_size) {
-        ret.push_back(std::make_pair(offset, length));
-        return ret;
+void DirectRomFSReader::MapFile() {
+    if (is_encrypted) {
+        mapping = Common::MappedFile{};
+        return;
     }
+    mapping = Common::MappedFile(file, file_offset, data_size);
+    LOG_DEBUG(Service_FS, "RomFS mapped: {}", mapping.IsValid());
+}
 
-    std::size_t curr_offset = offset;
-    while (length) {
-        std::size_t next_page = OffsetToPage(curr_offset + cache_line_size);
-        std::size_t curr_page_len = std::min(length, next_page - curr_offset);
-        ret.push_back(std::make_pair(curr_offset, curr_page_len));
-        curr_offset = next_page;
-        length -= curr_page_len;
+void DirectRomFSReader::ResetDecryptors() {
+    if (is_encrypted) {
+        decryptors = std::make_unique<DecryptorPool>(key, ctr);
+    } else {
+        decryptors.reset();
     }
-    return ret;
+}
+
+bool DirectRomFSReader::AllowsCachedReads() const {
+    return true;
+}
+
+bool DirectRomFSReader::CacheReady(std::size_t file_offset, std::size_t length) {
+    if (mapping.IsValid()) {
+        return mapping.IsResident(file_offset, length);
+    }
+
+    // Reads that miss the cache are done asynchronously, not to stall the emulation on the disk
+    const std::size_t end = std::min<std::size_t>(file_offset + length, data_size);
+    for (std::size_t page = OffsetToPage(file_offset); page < end; page += cache_line_size) {
+        if (!cache->Contains(page)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 } // namespace FileSys
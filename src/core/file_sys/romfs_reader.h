@@ -1,14 +1,17 @@
 #pragma once
 
 #include <array>
-#include <shared_mutex>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/export.hpp>
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
-#include "common/static_lru_cache.h"
+#include "common/mapped_file.h"
 
 namespace FileSys {
 
@@ -31,21 +34,20 @@ private:
 };
 
 /**
- * A RomFS reader that directly reads the RomFS file.
+ * A RomFS reader that directly reads the RomFS file. Unencrypted RomFS are mapped into memory when
+ * the host allows it and read straight from the page cache. Otherwise small reads go through a
+ * cache of decrypted lines, sharded so that the reads of several threads rarely contend. When the
+ * title reads the RomFS sequentially, the data following its reads is prefetched in the background.
  */
 class DirectRomFSReader : public RomFSReader {
 public:
-    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size)
-        : is_encrypted(false), file(std::move(file)), file_offset(file_offset),
-          data_size(data_size) {}
+    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size);
 
     DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size,
                       const std::array<u8, 16>& key, const std::array<u8, 16>& ctr,
-                      std::size_t crypto_offset)
-        : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
-          crypto_offset(crypto_offset), data_size(data_size) {}
+                      std::size_t crypto_offset);
 
-    ~DirectRomFSReader() override = default;
+    ~DirectRomFSReader() override;
 
     std::size_t GetSize() const override {
         return data_size;
@@ -58,6 +60,10 @@ public:
     bool CacheReady(std::size_t file_offset, std::size_t length) override;
 
 private:
+    class Cache;
+    class DecryptorPool;
+    struct Line;
+
     bool is_encrypted;
     FileUtil::IOFile file;
     std::array<u8, 16> key;
@@ -66,25 +72,63 @@ private:
     u64 crypto_offset;
     u64 data_size;
 
-    // Total cache size: 128KB
     static constexpr std::size_t cache_line_size = (1 << 13); // About 8KB
-    static constexpr std::size_t cache_line_count = 16;
 
-    Common::StaticLRUCache<std::size_t, std::array<u8, cache_line_size>, cache_line_count> cache;
-    // TODO(PabloMK7): Make cache thread safe, read the comment in CacheReady function.
-    // std::shared_mutex cache_mutex;
+    std::unique_ptr<Cache> cache;
+
+    /// Keyed decryptors reused across reads, only present when the RomFS is encrypted
+    std::unique_ptr<DecryptorPool> decryptors;
+
+    /// Mapping of an unencrypted RomFS, reads bypass the cache when it is valid
+    Common::MappedFile mapping;
+
+    // Sequential access detection, the reads may come from several threads
+    std::mutex readahead_mutex;
+    std::size_t next_sequential_offset = 0;
+    std::size_t sequential_reads = 0;
+    std::size_t readahead_end = 0;
 
-    DirectRomFSReader() = default;
+    /// Batches of lines being read ahead, waited for before the file or the cache go away
+    std::vector<std::future<void>> pending_readaheads;
+
+    std::size_t memory_budget_handle{};
+
+    DirectRomFSReader();
 
     std::size_t OffsetToPage(std::size_t offset) {
         return Common::AlignDown<std::size_t>(offset, cache_line_size);
     }
 
-    std::vector<std::pair<std::size_t, std::size_t>> BreakupRead(std::size_t offset,
-                                                                 std::size_t length);
+    /// Reads and decrypts data straight from the file.
+    std::size_t ReadDirect(std::size_t offset, std::size_t length, u8* buffer);
+
+    /// Checks the size returned by a read from the file and decrypts the data read.
+    std::size_t FinishRead(std::size_t offset, std::size_t length, std::size_t read_size,
+                           u8* buffer);
+
+    /// Reads the cache line at a page, caching it.
+    std::shared_ptr<const Line> LoadLine(std::size_t page);
+
+    /// Prefetches the lines after a read that continues a sequential stream of reads.
+    void Readahead(std::size_t offset, std::size_t length);
+
+    /// Waits for the lines being read ahead. The readahead mutex must be held.
+    void WaitForReadaheads();
+
+    /// Waits for the readahead and drops the cached lines, before the file is replaced.
+    void ResetCache();
+
+    /// Recreates the decryptors for the current key and counter.
+    void ResetDecryptors();
+
+    /// Maps the RomFS into memory if it is not encrypted.
+    void MapFile();
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
+        if (Archive::is_loading::value) {
+            ResetCache();
+        }
         ar& boost::serialization::base_object<RomFSReader>(*this);
         ar& is_encrypted;
         ar& file;
@@ -93,6 +137,10 @@ private:
         ar& file_offset;
         ar& crypto_offset;
         ar& data_size;
+        if (Archive::is_loading::value) {
+            ResetDecryptors();
+            MapFile();
+        }
     }
     friend class boost::serialization::access;
 };
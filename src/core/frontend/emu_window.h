@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <utility>
 
@@ -66,6 +68,13 @@ public:
      * returns nullptr
      */
     virtual Frontend::Frame* TryGetPresentFrame(int timeout_ms) = 0;
+
+    /**
+     * Returns true when a released frame has not been picked up by the presentation thread yet
+     */
+    virtual bool IsPresentPending() {
+        return false;
+    }
 };
 
 /**
@@ -180,6 +189,15 @@ public:
         return nullptr;
     }
 
+    /**
+     * Returns the time of the latest vblank of the display showing the window, for frontends that
+     * track the display timeline. Returns a default time point otherwise.
+     * @note This method is thread-safe
+     */
+    virtual std::chrono::steady_clock::time_point GetLastVsync() const {
+        return {};
+    }
+
     /**
      * Save current GraphicsContext.
      */
@@ -240,9 +258,11 @@ public:
 
     /**
      * Gets the framebuffer layout (width, height, and screen regions)
-     * @note This method is thread-safe
+     * @note This method is thread-safe. The layout is returned by value because the GUI thread may
+     * change it while the render or present thread is drawing.
      */
-    const Layout::FramebufferLayout& GetFramebufferLayout() const {
+    Layout::FramebufferLayout GetFramebufferLayout() const {
+        std::scoped_lock lock{layout_mutex};
         return framebuffer_layout;
     }
 
@@ -282,6 +302,7 @@ protected:
      * @note EmuWindow implementations will usually use this in window resize event handlers.
      */
     void NotifyFramebufferLayoutChanged(const Layout::FramebufferLayout& layout) {
+        std::scoped_lock lock{layout_mutex};
         framebuffer_layout = layout;
     }
 
@@ -314,6 +335,7 @@ private:
                              unsigned framebuffer_y);
 
     Layout::FramebufferLayout framebuffer_layout; ///< Current framebuffer layout
+    mutable std::mutex layout_mutex;              ///< Guards framebuffer_layout across threads
 
     WindowConfig config{};        ///< Internal configuration (changes pending for being applied in
                                   /// ProcessConfigurationChanges)
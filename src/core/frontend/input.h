@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -15,6 +16,9 @@
 
 namespace Input {
 
+/// Clock of the host timestamps of the input changes
+using Clock = std::chrono::steady_clock;
+
 /// An abstract class template for an input device (a button, an analog input, etc.).
 template <typename StatusType>
 class InputDevice {
@@ -23,6 +27,12 @@ public:
     virtual StatusType GetStatus() const {
         return {};
     }
+
+    /// Returns when the host event behind the status was received, or the epoch of the clock
+    /// for the devices that do not timestamp their events.
+    virtual Clock::time_point GetChangeTime() const {
+        return {};
+    }
 };
 
 /// An abstract class template for a factory that can create input devices.
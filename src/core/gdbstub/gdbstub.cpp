@@ -6,12 +6,15 @@
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <csignal>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
 #include <map>
+#include <mutex>
 #include <numeric>
+#include <vector>
 #include <fcntl.h>
 #include <fmt/format.h>
 
@@ -31,6 +34,7 @@
 #endif
 
 #include "common/logging/log.h"
+#include "common/polyfill_thread.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
@@ -40,12 +44,15 @@
 
 namespace GDBStub {
 namespace {
-constexpr int GDB_BUFFER_SIZE = 10000;
+/// Large enough for the target xml, and for bulk memory transfers of 32 KiB in hex
+constexpr int GDB_BUFFER_SIZE = 0x10004;
 
 constexpr char GDB_STUB_START = '$';
 constexpr char GDB_STUB_END = '#';
 constexpr char GDB_STUB_ACK = '+';
 constexpr char GDB_STUB_NACK = '-';
+/// Escapes the next byte of binary data, which is xored with 0x20
+constexpr u8 GDB_STUB_ESCAPE = 0x7d;
 
 #ifndef SIGTRAP
 constexpr u32 SIGTRAP = 5;
@@ -55,9 +62,6 @@ constexpr u32 SIGTRAP = 5;
 constexpr u32 SIGTERM = 15;
 #endif
 
-#ifndef MSG_WAITALL
-constexpr u32 MSG_WAITALL = 8;
-#endif
 
 constexpr u32 SP_REGISTER = 13;
 constexpr u32 LR_REGISTER = 14;
@@ -122,6 +126,16 @@ constexpr char target_xml[] =
 int gdbserver_socket = -1;
 bool defer_start = false;
 
+// The socket is read by its own thread, so that polling an idle connection costs the emulation
+// thread no system call.
+std::jthread receive_thread;
+std::mutex receive_mutex;
+std::condition_variable receive_cv;
+std::vector<u8> receive_buffer;
+std::size_t receive_pos = 0;
+bool receive_closed = false;
+std::atomic<bool> data_available{false};
+
 u8 command_buffer[GDB_BUFFER_SIZE];
 u32 command_length;
 
@@ -356,15 +370,41 @@ static u64 GdbHexToLong(const u8* src) {
     return output;
 }
 
+/// Receive the data sent by the gdb client until the connection is closed.
+static void ReceiveLoop(int socket) {
+    std::array<char, 4096> buffer;
+    while (true) {
+        const auto received_size = recv(socket, buffer.data(), buffer.size(), 0);
+        std::scoped_lock lock{receive_mutex};
+        if (received_size <= 0) {
+            receive_closed = true;
+            receive_cv.notify_all();
+            return;
+        }
+        receive_buffer.insert(receive_buffer.end(), buffer.begin(),
+                              buffer.begin() + received_size);
+        data_available = true;
+        receive_cv.notify_all();
+    }
+}
+
 /// Read a byte from the gdb client.
 static u8 ReadByte() {
-    u8 c;
-    std::size_t received_size = recv(gdbserver_socket, reinterpret_cast<char*>(&c), 1, MSG_WAITALL);
-    if (received_size != 1) {
-        LOG_ERROR(Debug_GDBStub, "recv failed : {}", received_size);
+    std::unique_lock lock{receive_mutex};
+    receive_cv.wait(lock, [] { return receive_pos < receive_buffer.size() || receive_closed; });
+    if (receive_pos == receive_buffer.size()) {
+        lock.unlock();
+        LOG_ERROR(Debug_GDBStub, "recv failed : connection closed");
         Shutdown();
+        return 0;
     }
 
+    const u8 c = receive_buffer[receive_pos++];
+    if (receive_pos == receive_buffer.size()) {
+        receive_buffer.clear();
+        receive_pos = 0;
+        data_available = false;
+    }
     return c;
 }
 
@@ -529,8 +569,9 @@ static void HandleQuery() {
     if (strcmp(query, "TStatus") == 0) {
         SendReply("T0");
     } else if (strncmp(query, "Supported", strlen("Supported")) == 0) {
-        // PacketSize needs to be large enough for target xml
-        SendReply("PacketSize=2000;qXfer:features:read+;qXfer:threads:read+");
+        const std::string supported = fmt::format(
+            "PacketSize={:x};qXfer:features:read+;qXfer:threads:read+", GDB_BUFFER_SIZE - 4);
+        SendReply(supported.c_str());
     } else if (strncmp(query, "Xfer:features:read:target.xml:",
                        strlen("Xfer:features:read:target.xml:")) == 0) {
         SendReply(target_xml);
@@ -656,6 +697,10 @@ static void ReadCommand() {
     }
 
     while ((c = ReadByte()) != GDB_STUB_END) {
+        if (!IsConnected()) {
+            command_length = 0;
+            return;
+        }
         if (command_length >= sizeof(command_buffer)) {
             LOG_ERROR(Debug_GDBStub, "gdb: command_buffer overflow\n");
             SendPacket(GDB_STUB_NACK);
@@ -690,22 +735,13 @@ static bool IsDataAvailable() {
     if (!IsConnected()) {
         return false;
     }
-
-    fd_set fd_socket;
-
-    FD_ZERO(&fd_socket);
-    FD_SET(static_cast<u32>(gdbserver_socket), &fd_socket);
-
-    struct timeval t;
-    t.tv_sec = 0;
-    t.tv_usec = 0;
-
-    if (select(gdbserver_socket + 1, &fd_socket, nullptr, nullptr, &t) < 0) {
-        LOG_ERROR(Debug_GDBStub, "select failed");
-        return false;
+    if (data_available) {
+        return true;
     }
 
-    return FD_ISSET(gdbserver_socket, &fd_socket) != 0;
+    // Report a closed connection so that the read fails and the server is shut down
+    std::scoped_lock lock{receive_mutex};
+    return receive_closed;
 }
 
 /// Send requested register to gdb client.
@@ -834,8 +870,8 @@ static void ReadMemory() {
 
     LOG_DEBUG(Debug_GDBStub, "ReadMemory addr: {:08x} len: {:08x}", addr, len);
 
-    if (len * 2 > sizeof(reply)) {
-        SendReply("E01");
+    if (len * 2 >= sizeof(reply)) {
+        return SendReply("E01");
     }
 
     auto& memory = Core::System::GetInstance().Memory();
@@ -880,6 +916,45 @@ static void WriteMemory() {
     SendReply("OK");
 }
 
+/// Modify location in memory with binary data received from the gdb client.
+static void WriteMemoryBinary() {
+    auto start_offset = command_buffer + 1;
+    auto addr_pos = std::find(start_offset, command_buffer + command_length, ',');
+    VAddr addr = HexToInt(start_offset, static_cast<u32>(addr_pos - start_offset));
+
+    start_offset = addr_pos + 1;
+    auto len_pos = std::find(start_offset, command_buffer + command_length, ':');
+    u32 len = HexToInt(start_offset, static_cast<u32>(len_pos - start_offset));
+
+    // A zero length write is sent by gdb to probe whether binary transfers are supported
+    if (len == 0) {
+        return SendReply("OK");
+    }
+
+    auto& memory = Core::System::GetInstance().Memory();
+    if (!memory.IsValidVirtualAddress(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
+                                      addr)) {
+        return SendReply("E00");
+    }
+
+    std::vector<u8> data;
+    data.reserve(len);
+    for (const u8* src = len_pos + 1; src < command_buffer + command_length; src++) {
+        if (*src == GDB_STUB_ESCAPE && src + 1 < command_buffer + command_length) {
+            data.push_back(*++src ^ 0x20);
+        } else {
+            data.push_back(*src);
+        }
+    }
+    if (data.size() != len) {
+        return SendReply("E01");
+    }
+
+    memory.WriteBlock(addr, data.data(), len);
+    Core::GetRunningCore().ClearInstructionCache();
+    SendReply("OK");
+}
+
 void Break(bool is_memory_break) {
     send_trap = true;
 
@@ -1096,6 +1171,9 @@ void HandlePacket(Core::System& system) {
     case 'M':
         WriteMemory();
         break;
+    case 'X':
+        WriteMemoryBinary();
+        break;
     case 's':
         Step();
         return;
@@ -1211,6 +1289,12 @@ static void Init(u16 port) {
     } else {
         LOG_INFO(Debug_GDBStub, "Client connected.\n");
         saddr_client.sin_addr.s_addr = ntohl(saddr_client.sin_addr.s_addr);
+
+        receive_buffer.clear();
+        receive_pos = 0;
+        receive_closed = false;
+        data_available = false;
+        receive_thread = std::jthread([socket = gdbserver_socket] { ReceiveLoop(socket); });
     }
 
     // Clean up temporary socket if it's still alive at this point.
@@ -1234,6 +1318,10 @@ void Shutdown() {
         shutdown(gdbserver_socket, SHUT_RDWR);
         gdbserver_socket = -1;
     }
+    // Unblocked by the shutdown of the socket
+    if (receive_thread.joinable()) {
+        receive_thread.join();
+    }
 
 #ifdef _WIN32
     WSACleanup();
@@ -0,0 +1,119 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <ctime>
+#include <functional>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/arm/arm_interface.h"
+#include "core/guest_profiler.h"
+#include "core/hle/kernel/process.h"
+
+namespace Core {
+
+GuestProfiler::GuestProfiler(u64 title_id_) : title_id{title_id_} {}
+
+GuestProfiler::~GuestProfiler() {
+    if (title_id == 0) {
+        return;
+    }
+
+    const std::time_t t = std::time(nullptr);
+    const std::string& path = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+    // %F Date format expanded is "%Y-%m-%d"
+    const std::string prefix =
+        fmt::format("{}/{:%F-%H-%M}_{:016X}", path, *std::localtime(&t), title_id);
+
+    if (!samples.empty()) {
+        std::string profile;
+        for (const auto& [stack, ticks] : samples) {
+            profile += fmt::format("{};{} {}\n", FormatLocation(stack.first),
+                                   FormatLocation(stack.second), ticks);
+        }
+        const std::string filename = prefix + ".folded";
+        FileUtil::IOFile file(filename, "w");
+        file.WriteString(profile);
+        LOG_INFO(Core, "Guest profile written to {}", filename);
+    }
+
+    // The most called SVCs first
+    std::vector<std::pair<u64, std::size_t>> svcs;
+    for (std::size_t i = 0; i < NumSVCs; i++) {
+        if (const u64 calls = svc_calls[i].load(std::memory_order_relaxed); calls != 0) {
+            svcs.emplace_back(calls, i);
+        }
+    }
+    if (!svcs.empty()) {
+        std::sort(svcs.begin(), svcs.end(), std::greater{});
+        std::string counts;
+        for (const auto& [calls, svc] : svcs) {
+            counts += fmt::format("0x{:02X} {} {}\n", svc, svc_names[svc].load(), calls);
+        }
+        const std::string filename = prefix + ".svc";
+        FileUtil::IOFile file(filename, "w");
+        file.WriteString(counts);
+        LOG_INFO(Core, "SVC counts written to {}", filename);
+    }
+}
+
+void GuestProfiler::RegisterModule(u32 process_id, std::string name, VAddr address, u32 size) {
+    modules.push_back({process_id, std::move(name), address, size, true});
+}
+
+void GuestProfiler::UnregisterModule(u32 process_id, VAddr address) {
+    for (auto& module : modules) {
+        if (module.loaded && module.process_id == process_id && module.address == address) {
+            module.loaded = false;
+        }
+    }
+}
+
+void GuestProfiler::Sample(const ARM_Interface& core, const Kernel::Process* process) {
+    const u32 core_id = core.GetID();
+    if (core_id >= last_ticks.size()) {
+        last_ticks.resize(core_id + 1);
+    }
+
+    const u64 ticks = core.GetTimer().GetTicks();
+    const u64 elapsed = ticks - last_ticks[core_id];
+    last_ticks[core_id] = ticks;
+    if (!process || elapsed == 0) {
+        return;
+    }
+
+    // The LR only names the caller of a leaf function, it is stale inside non-leaf ones.
+    const Location pc = Resolve(process->process_id, core.GetPC());
+    const Location lr = Resolve(process->process_id, core.GetReg(14));
+    samples[{lr, pc}] += elapsed;
+}
+
+void GuestProfiler::CountSVC(u32 immediate, const char* name) {
+    if (immediate < NumSVCs) {
+        svc_names[immediate].store(name, std::memory_order_relaxed);
+        svc_calls[immediate].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+GuestProfiler::Location GuestProfiler::Resolve(u32 process_id, VAddr address) const {
+    for (u32 i = 0; i < static_cast<u32>(modules.size()); i++) {
+        const Module& module = modules[i];
+        if (module.loaded && module.process_id == process_id && address >= module.address &&
+            address - module.address < module.size) {
+            return {i, address - module.address};
+        }
+    }
+    return {UnknownModule, address};
+}
+
+std::string GuestProfiler::FormatLocation(Location location) const {
+    if (location.module == UnknownModule) {
+        return fmt::format("0x{:08X}", location.offset);
+    }
+    return fmt::format("{}+0x{:X}", modules[location.module].name, location.offset);
+}
+
+} // namespace Core
@@ -0,0 +1,82 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Kernel {
+class Process;
+}
+
+namespace Core {
+
+class ARM_Interface;
+
+/**
+ * Sampling profiler for guest code. The cores are sampled at the end of every timing slice, with
+ * each sample weighted by the ticks the core ran since its previous one, and the PC and LR are
+ * attributed to the loaded code modules. The profile is written as folded stacks, the input
+ * format of common flame graph tools, when the profiler is destroyed.
+ */
+class GuestProfiler {
+public:
+    explicit GuestProfiler(u64 title_id);
+    ~GuestProfiler();
+
+    /// Registers a range of code of a process, such as its executable or a CRO.
+    void RegisterModule(u32 process_id, std::string name, VAddr address, u32 size);
+
+    /// Unregisters the module loaded at address. Samples already taken keep their attribution.
+    void UnregisterModule(u32 process_id, VAddr address);
+
+    /**
+     * Samples a core at the end of a slice.
+     * @param core The core to sample.
+     * @param process The process of the thread running on the core, or nullptr if it is idle.
+     */
+    void Sample(const ARM_Interface& core, const Kernel::Process* process);
+
+    /// Counts a call of the SVC, the counts are written next to the profile. Thread safe.
+    void CountSVC(u32 immediate, const char* name);
+
+private:
+    static constexpr u32 UnknownModule = std::numeric_limits<u32>::max();
+    static constexpr std::size_t NumSVCs = 0x100;
+
+    struct Module {
+        u32 process_id;
+        std::string name;
+        VAddr address;
+        u32 size;
+        bool loaded;
+    };
+
+    /// A code address as an offset into a module, or an absolute address for UnknownModule.
+    struct Location {
+        u32 module;
+        u32 offset;
+
+        auto operator<=>(const Location&) const = default;
+    };
+
+    Location Resolve(u32 process_id, VAddr address) const;
+    std::string FormatLocation(Location location) const;
+
+    u64 title_id;
+    std::vector<Module> modules;
+    std::vector<u64> last_ticks;
+    std::map<std::pair<Location, Location>, u64> samples; ///< (caller, pc) to ticks spent
+    std::array<std::atomic<u64>, NumSVCs> svc_calls{};
+    std::array<std::atomic<const char*>, NumSVCs> svc_names{};
+};
+
+} // namespace Core
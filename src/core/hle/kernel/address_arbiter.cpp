@@ -25,51 +25,45 @@ namespace Kernel {
 void AddressArbiter::WaitThread(std::shared_ptr<Thread> thread, VAddr wait_address) {
     thread->wait_address = wait_address;
     thread->status = ThreadStatus::WaitArb;
-    waiting_threads.emplace_back(std::move(thread));
+    waiting_threads[wait_address].emplace_back(std::move(thread));
 }
 
 u64 AddressArbiter::ResumeAllThreads(VAddr address) {
-    // Determine which threads are waiting on this address, those should be woken up.
-    auto itr = std::stable_partition(waiting_threads.begin(), waiting_threads.end(),
-                                     [address](const auto& thread) {
-                                         ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                                                    "Inconsistent AddressArbiter state");
-                                         return thread->wait_address != address;
-                                     });
-
-    // Wake up all the found threads
-    const u64 num_threads = std::distance(itr, waiting_threads.end());
-    std::for_each(itr, waiting_threads.end(), [](auto& thread) { thread->ResumeFromWait(); });
-
-    // Remove the woken up threads from the wait list.
-    waiting_threads.erase(itr, waiting_threads.end());
-    return num_threads;
+    // Take the threads waiting on this address out of the arbiter, then wake them all up.
+    auto node = waiting_threads.extract(address);
+    if (node.empty()) {
+        return 0;
+    }
+
+    for (auto& thread : node.mapped()) {
+        ASSERT_MSG(thread->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
+        thread->ResumeFromWait();
+    }
+    return node.mapped().size();
 }
 
 bool AddressArbiter::ResumeHighestPriorityThread(VAddr address) {
-    // Determine which threads are waiting on this address, those should be considered for wakeup.
-    auto matches_start = std::stable_partition(
-        waiting_threads.begin(), waiting_threads.end(), [address](const auto& thread) {
-            ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                       "Inconsistent AddressArbiter state");
-            return thread->wait_address != address;
-        });
+    const auto bucket = waiting_threads.find(address);
+    if (bucket == waiting_threads.end()) {
+        return false;
+    }
 
     // Iterate through threads, find highest priority thread that is waiting to be arbitrated.
     // Note: The real kernel will pick the first thread in the list if more than one have the
     // same highest priority value. Lower priority values mean higher priority.
-    auto itr = std::min_element(matches_start, waiting_threads.end(),
+    auto& threads = bucket->second;
+    auto itr = std::min_element(threads.begin(), threads.end(),
                                 [](const auto& lhs, const auto& rhs) {
                                     return lhs->current_priority < rhs->current_priority;
                                 });
-
-    if (itr == waiting_threads.end()) {
-        return false;
-    }
+    ASSERT_MSG((*itr)->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
 
     auto thread = *itr;
+    threads.erase(itr);
+    if (threads.empty()) {
+        waiting_threads.erase(bucket);
+    }
     thread->ResumeFromWait();
-    waiting_threads.erase(itr);
 
     return true;
 }
@@ -111,8 +105,15 @@ void AddressArbiter::WakeUp(ThreadWakeupReason reason, std::shared_ptr<Thread> t
                             std::shared_ptr<WaitObject> object) {
     ASSERT(reason == ThreadWakeupReason::Timeout);
     // Remove the newly-awakened thread from the Arbiter's waiting list.
-    waiting_threads.erase(std::remove(waiting_threads.begin(), waiting_threads.end(), thread),
-                          waiting_threads.end());
+    const auto bucket = waiting_threads.find(thread->wait_address);
+    if (bucket == waiting_threads.end()) {
+        return;
+    }
+    auto& threads = bucket->second;
+    threads.erase(std::remove(threads.begin(), threads.end(), thread), threads.end());
+    if (threads.empty()) {
+        waiting_threads.erase(bucket);
+    }
 };
 
 Result AddressArbiter::ArbitrateAddress(std::shared_ptr<Thread> thread, ArbitrationType type,
@@ -190,13 +191,34 @@ Result AddressArbiter::ArbitrateAddress(std::shared_ptr<Thread> thread, Arbitrat
     return ResultSuccess;
 }
 
+// The waiters are stored as a single list, as they were before being bucketed, and rebucketed by
+// their wait address on load.
+template <class Archive>
+void AddressArbiter::save(Archive& ar, const unsigned int) const {
+    ar << boost::serialization::base_object<Object>(*this);
+    ar << name;
+    std::vector<std::shared_ptr<Thread>> threads;
+    for (const auto& [address, bucket] : waiting_threads) {
+        threads.insert(threads.end(), bucket.begin(), bucket.end());
+    }
+    ar << threads;
+    ar << timeout_callback;
+    ar << resource_limit;
+}
+
 template <class Archive>
-void AddressArbiter::serialize(Archive& ar, const unsigned int) {
-    ar& boost::serialization::base_object<Object>(*this);
-    ar& name;
-    ar& waiting_threads;
-    ar& timeout_callback;
-    ar& resource_limit;
+void AddressArbiter::load(Archive& ar, const unsigned int) {
+    ar >> boost::serialization::base_object<Object>(*this);
+    ar >> name;
+    std::vector<std::shared_ptr<Thread>> threads;
+    ar >> threads;
+    waiting_threads.clear();
+    for (auto& thread : threads) {
+        const VAddr address = thread->wait_address;
+        waiting_threads[address].push_back(std::move(thread));
+    }
+    ar >> timeout_callback;
+    ar >> resource_limit;
 }
 SERIALIZE_IMPL(AddressArbiter)
 
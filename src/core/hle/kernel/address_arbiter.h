@@ -5,8 +5,10 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <boost/serialization/export.hpp>
+#include <boost/serialization/split_member.hpp>
 #include "common/common_types.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/thread.h"
@@ -68,8 +70,10 @@ private:
     /// the resumed thread.
     bool ResumeHighestPriorityThread(VAddr address);
 
-    /// Threads waiting for the address arbiter to be signaled.
-    std::vector<std::shared_ptr<Thread>> waiting_threads;
+    /// Threads waiting for the address arbiter to be signaled, bucketed by the address they wait
+    /// on so that signaling an address only visits its own waiters. Each bucket is kept in wait
+    /// order, which breaks the ties between waiters of the same priority.
+    std::unordered_map<VAddr, std::vector<std::shared_ptr<Thread>>> waiting_threads;
 
     std::shared_ptr<Callback> timeout_callback;
 
@@ -78,7 +82,10 @@ private:
 
     friend class boost::serialization::access;
     template <class Archive>
-    void serialize(Archive& ar, const unsigned int);
+    void save(Archive& ar, const unsigned int) const;
+    template <class Archive>
+    void load(Archive& ar, const unsigned int);
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
 
 } // namespace Kernel
@@ -24,7 +24,7 @@ Event::~Event() {
 }
 
 std::shared_ptr<Event> KernelSystem::CreateEvent(ResetType reset_type, std::string name) {
-    auto event = std::make_shared<Event>(*this);
+    auto event = MakeObject<Event>(*this);
     event->signaled = false;
     event->reset_type = reset_type;
     event->name = std::move(name);
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 #include <boost/serialization/assume_abstract.hpp>
 #include <boost/serialization/shared_ptr.hpp>
@@ -15,6 +16,7 @@
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/ipc_debugger/profiler.h"
 #include "core/hle/kernel/ipc_debugger/recorder.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
@@ -27,6 +29,36 @@ SERIALIZE_EXPORT_IMPL(Kernel::HLERequestContext::ThreadCallback)
 
 namespace Kernel {
 
+namespace {
+
+/**
+ * Returns the host pointer of the guest range when it is backed by a single contiguous block,
+ * or nullptr when it has to be copied page by page. Rasterizer cached pages of the range are
+ * flushed with mode first, like ReadBlock and WriteBlock do.
+ */
+u8* GetContiguousPointer(Memory::MemorySystem& memory, Process& process, VAddr address,
+                         std::size_t size, Memory::FlushMode mode) {
+    if (size == 0) {
+        return nullptr;
+    }
+    auto blocks = process.vm_manager.GetBackingBlocksForRange(address, static_cast<u32>(size));
+    if (blocks.Failed() || blocks->size() != 1) {
+        return nullptr;
+    }
+
+    const auto& attributes = process.vm_manager.page_table->attributes;
+    const VAddr last_page = (address + static_cast<VAddr>(size) - 1) >> Memory::CITRA_PAGE_BITS;
+    for (VAddr page = address >> Memory::CITRA_PAGE_BITS; page <= last_page; page++) {
+        if (attributes[page] == Memory::PageType::RasterizerCachedMemory) {
+            memory.RasterizerFlushVirtualRegion(address, static_cast<u32>(size), mode);
+            break;
+        }
+    }
+    return blocks->front().first.GetPtr();
+}
+
+} // Anonymous namespace
+
 class HLERequestContext::ThreadCallback : public Kernel::WakeupCallback {
 
 public:
@@ -36,6 +68,11 @@ public:
     void WakeUp(ThreadWakeupReason reason, std::shared_ptr<Thread> thread,
                 std::shared_ptr<WaitObject> object) {
         ASSERT(thread->status == ThreadStatus::WaitHleEvent);
+        if (context->profile) {
+            const s64 slept = context->kernel.timing.GetGlobalTicks() - context->sleep_start_ticks;
+            context->kernel.GetIPCProfiler().RecordSleep(
+                context->profile, std::chrono::nanoseconds{cyclesToNs(slept)});
+        }
         if (callback) {
             callback->WakeUp(thread, *context, reason);
         }
@@ -110,6 +147,8 @@ std::shared_ptr<Event> HLERequestContext::SleepClientThread(
     // Put the client thread to sleep until the wait event is signaled or the timeout expires.
     thread->wakeup_callback = std::make_shared<ThreadCallback>(shared_from_this(), callback);
 
+    sleep_start_ticks = kernel.timing.GetGlobalTicks();
+
     auto event = kernel.CreateEvent(Kernel::ResetType::OneShot, "HLE Pause Event: " + reason);
     thread->status = ThreadStatus::WaitHleEvent;
     thread->wait_objects = {event};
@@ -204,9 +243,16 @@ Result HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* src_cm
             VAddr source_address = src_cmdbuf[i];
             IPC::StaticBufferDescInfo buffer_info{descriptor};
 
-            // Copy the input buffer into our own vector and store it.
-            std::vector<u8> data(buffer_info.size);
-            kernel.memory.ReadBlock(src_process, source_address, data.data(), data.size());
+            // Copy the input buffer into our own vector and store it, straight from the backing
+            // memory when it is contiguous.
+            std::vector<u8> data;
+            if (const u8* src = GetContiguousPointer(kernel.memory, src_process, source_address,
+                                                     buffer_info.size, Memory::FlushMode::Flush)) {
+                data.assign(src, src + buffer_info.size);
+            } else {
+                data.resize(buffer_info.size);
+                kernel.memory.ReadBlock(src_process, source_address, data.data(), data.size());
+            }
 
             AddStaticBuffer(buffer_info.buffer_id, std::move(data));
             cmd_buf[i++] = source_address;
@@ -287,7 +333,12 @@ Result HLERequestContext::WriteToOutgoingCommandBuffer(u32_le* dst_cmdbuf,
 
             ASSERT_MSG(target_descriptor.size >= data.size(), "Static buffer data is too big");
 
-            kernel.memory.WriteBlock(dst_process, target_address, data.data(), data.size());
+            if (u8* dst = GetContiguousPointer(kernel.memory, dst_process, target_address,
+                                               data.size(), Memory::FlushMode::Invalidate)) {
+                std::memcpy(dst, data.data(), data.size());
+            } else {
+                kernel.memory.WriteBlock(dst_process, target_address, data.data(), data.size());
+            }
 
             dst_cmdbuf[i++] = target_address;
             break;
@@ -355,4 +406,24 @@ void MappedBuffer::Write(const void* src_buffer, std::size_t offset, std::size_t
     memory->WriteBlock(*process, address + static_cast<VAddr>(offset), src_buffer, size);
 }
 
+std::span<const u8> MappedBuffer::ReadSpan(std::size_t offset, std::size_t size) {
+    ASSERT(perms & IPC::R);
+    if (offset + size > this->size) {
+        return {};
+    }
+    const u8* data = GetContiguousPointer(*memory, *process, address + static_cast<VAddr>(offset),
+                                          size, Memory::FlushMode::Flush);
+    return data ? std::span{data, size} : std::span<const u8>{};
+}
+
+std::span<u8> MappedBuffer::WriteSpan(std::size_t offset, std::size_t size) {
+    ASSERT(perms & IPC::W);
+    if (offset + size > this->size) {
+        return {};
+    }
+    u8* data = GetContiguousPointer(*memory, *process, address + static_cast<VAddr>(offset), size,
+                                    Memory::FlushMode::Invalidate);
+    return data ? std::span{data, size} : std::span<u8>{};
+}
+
 } // namespace Kernel
@@ -7,8 +7,10 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <functional>
 #include <future>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 #include <boost/container/small_vector.hpp>
@@ -16,6 +18,7 @@
 #include "common/common_types.h"
 #include "common/serialization/boost_small_vector.hpp"
 #include "common/swap.h"
+#include "common/thread_pool.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/server_session.h"
@@ -28,6 +31,10 @@ namespace Memory {
 class MemorySystem;
 }
 
+namespace IPCDebugger {
+struct CommandProfile;
+}
+
 namespace Kernel {
 
 class HandleTable;
@@ -126,6 +133,18 @@ public:
     // interface for service
     void Read(void* dest_buffer, std::size_t offset, std::size_t size);
     void Write(const void* src_buffer, std::size_t offset, std::size_t size);
+
+    /**
+     * Returns a view of size bytes at offset of the buffer directly in guest memory, avoiding the
+     * copy made by Read. The view is empty when the range is not contiguous in host memory or
+     * exceeds the buffer, in which case Read has to be used. It is only valid for the duration
+     * of the request.
+     */
+    std::span<const u8> ReadSpan(std::size_t offset, std::size_t size);
+
+    /// Same as ReadSpan, but the view is written to instead, as with Write.
+    std::span<u8> WriteSpan(std::size_t offset, std::size_t size);
+
     std::size_t GetSize() const {
         return size;
     }
@@ -248,6 +267,16 @@ public:
                                              std::chrono::nanoseconds timeout,
                                              std::shared_ptr<WakeupCallback> callback);
 
+    /// Sets the profile of the command being handled, which the client sleep time is added to.
+    void SetProfile(IPCDebugger::CommandProfile* profile_) {
+        profile = profile_;
+    }
+
+    /// Returns the kernel handling the request.
+    KernelSystem& Kernel() const {
+        return kernel;
+    }
+
 private:
     template <typename ResultFunctor>
     class AsyncWakeUpCallback : public WakeupCallback {
@@ -276,6 +305,34 @@ private:
         friend class boost::serialization::access;
     };
 
+    /// Implements RunAsync and RunAsyncIO, submit queues a task to the threads running the section
+    template <typename SubmitFunctor, typename AsyncFunctor, typename ResultFunctor>
+    void RunAsyncOn(SubmitFunctor submit, AsyncFunctor async_section,
+                    ResultFunctor result_function, bool really_async) {
+        if (really_async) {
+            std::promise<void> done;
+            auto future = done.get_future();
+            submit([this, async_section, done = std::move(done)]() mutable {
+                s64 sleep_for = async_section(*this);
+                this->thread->WakeAfterDelay(sleep_for, true);
+                done.set_value();
+            });
+            this->SleepClientThread("RunAsync", std::chrono::nanoseconds(-1),
+                                    std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
+                                        result_function, std::move(future)));
+        } else {
+            s64 sleep_for = async_section(*this);
+            if (sleep_for > 0) {
+                auto parallel_wakeup = std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
+                    result_function, std::move(std::future<void>()));
+                this->SleepClientThread("RunAsync", std::chrono::nanoseconds(sleep_for),
+                                        parallel_wakeup);
+            } else {
+                result_function(*this);
+            }
+        }
+    }
+
 public:
     /**
      * Puts the game thread to sleep and calls the specified async_section asynchronously.
@@ -290,32 +347,52 @@ public:
      * and can be used to set the IPC result.
      * @param really_async If set to false, it will call both async_section and result_function
      * from the emulator thread.
+     * The async section may wait without a bound, like on a socket, so it runs on a spare thread
+     * of the pool. Use RunAsyncIO instead for sections that only do I/O.
      */
     template <typename AsyncFunctor, typename ResultFunctor>
     void RunAsync(AsyncFunctor async_section, ResultFunctor result_function,
                   bool really_async = true) {
+        RunAsyncOn(
+            [](Common::ThreadPool::Task task) {
+                Common::ThreadPool::Instance().SubmitBlocking(std::move(task));
+            },
+            async_section, result_function, really_async);
+    }
 
-        if (really_async) {
-            this->SleepClientThread(
-                "RunAsync", std::chrono::nanoseconds(-1),
-                std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
-                    result_function,
-                    std::move(std::async(std::launch::async, [this, async_section] {
-                        s64 sleep_for = async_section(*this);
-                        this->thread->WakeAfterDelay(sleep_for, true);
-                    }))));
+    /**
+     * Like RunAsync, for async sections that only do I/O, like reading a file. They run on the
+     * bounded I/O threads of the pool, in the order they were requested on the session.
+     */
+    template <typename AsyncFunctor, typename ResultFunctor>
+    void RunAsyncIO(AsyncFunctor async_section, ResultFunctor result_function,
+                    bool really_async = true) {
+        RunAsyncOn(
+            [order_key = session.get()](Common::ThreadPool::Task task) {
+                Common::ThreadPool::Instance().SubmitIO(order_key, std::move(task));
+            },
+            async_section, result_function, really_async);
+    }
 
-        } else {
-            s64 sleep_for = async_section(*this);
-            if (sleep_for > 0) {
-                auto parallel_wakeup = std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
-                    result_function, std::move(std::future<void>()));
-                this->SleepClientThread("RunAsync", std::chrono::nanoseconds(sleep_for),
-                                        parallel_wakeup);
-            } else {
-                result_function(*this);
-            }
-        }
+    /**
+     * Puts the game thread to sleep until the operation it requested completes. Unlike RunAsync,
+     * no host thread is started: this is meant for operations driven by a thread that already
+     * exists, like an event loop, which calls the returned function once the operation is done.
+     * @param result_function Callable that takes Kernel::HLERequestContext& as argument
+     * and doesn't return anything. This callable is ran from the emulator thread once the
+     * operation completed, and can be used to set the IPC result.
+     * @returns Callable to invoke exactly once, from any thread, when the operation completed.
+     */
+    template <typename ResultFunctor>
+    std::function<void()> SleepUntilCompleted(ResultFunctor result_function) {
+        auto completed = std::make_shared<std::promise<void>>();
+        SleepClientThread("SleepUntilCompleted", std::chrono::nanoseconds(-1),
+                          std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
+                              result_function, completed->get_future()));
+        return [completed, thread = this->thread] {
+            completed->set_value();
+            thread->WakeAfterDelay(0, true);
+        };
     }
 
     /**
@@ -378,6 +455,9 @@ private:
     std::array<std::vector<u8>, IPC::MAX_STATIC_BUFFERS> static_buffers;
     // The mapped buffers will be created when the IPC request is translated
     boost::container::small_vector<MappedBuffer, 8> request_mapped_buffers;
+    // Not serialized, requests in flight when loading a savestate are not profiled.
+    IPCDebugger::CommandProfile* profile{};
+    s64 sleep_start_ticks{};
 
     HLERequestContext();
     template <class Archive>
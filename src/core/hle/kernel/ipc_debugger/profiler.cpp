@@ -0,0 +1,98 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include "core/hle/kernel/ipc_debugger/profiler.h"
+
+namespace IPCDebugger {
+
+CommandProfile* Profiler::GetProfile(const void* service, std::string_view service_name,
+                                     u32 command_id, std::string_view function_name) {
+    std::scoped_lock lock{mutex};
+    const auto [it, inserted] = profiles.try_emplace({service, command_id});
+    if (inserted) {
+        it->second.service_name = service_name;
+        it->second.function_name = function_name;
+        it->second.command_id = command_id;
+    }
+    return &it->second;
+}
+
+void Profiler::RecordCall(CommandProfile* profile, std::chrono::nanoseconds time) {
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+    const std::size_t bucket = std::min<std::size_t>(std::bit_width(static_cast<u64>(us)),
+                                                     CommandProfile::NUM_BUCKETS - 1);
+
+    std::scoped_lock lock{mutex};
+    profile->calls++;
+    profile->total_time += time;
+    profile->max_time = std::max(profile->max_time, time);
+    profile->histogram[bucket]++;
+}
+
+void Profiler::RecordSleep(CommandProfile* profile, std::chrono::nanoseconds time) {
+    std::scoped_lock lock{mutex};
+    profile->sleeps++;
+    profile->sleep_time += time;
+}
+
+std::vector<CommandProfile> Profiler::GetProfiles() const {
+    std::vector<CommandProfile> result;
+    {
+        std::scoped_lock lock{mutex};
+        result.reserve(profiles.size());
+        for (const auto& [key, profile] : profiles) {
+            if (profile.calls != 0) {
+                result.push_back(profile);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.total_time > rhs.total_time;
+    });
+    return result;
+}
+
+std::string Profiler::Dump() const {
+    using std::chrono::duration;
+    const auto to_us = [](std::chrono::nanoseconds time) {
+        return duration<double, std::micro>(time).count();
+    };
+
+    std::string out = fmt::format("{:<10} {:<40} {:>10} {:>12} {:>10} {:>10} {:>12}  {}\n",
+                                  "Service", "Command", "Calls", "Total (us)", "Mean (us)",
+                                  "Max (us)", "Asleep (us)", "Histogram (<1us, <2us, <4us...)");
+    for (const auto& profile : GetProfiles()) {
+        const std::string command =
+            fmt::format("{} ({:#06x})", profile.function_name, profile.command_id);
+        const auto last = std::find_if(profile.histogram.rbegin(), profile.histogram.rend(),
+                                       [](u64 count) { return count != 0; });
+        const auto histogram =
+            std::span{profile.histogram}.first(std::distance(last, profile.histogram.rend()));
+        out += fmt::format("{:<10} {:<40} {:>10} {:>12.1f} {:>10.2f} {:>10.1f} {:>12.1f}  {}\n",
+                           profile.service_name, command, profile.calls,
+                           to_us(profile.total_time), to_us(profile.total_time) / profile.calls,
+                           to_us(profile.max_time), to_us(profile.sleep_time),
+                           fmt::join(histogram, " "));
+    }
+    return out;
+}
+
+void Profiler::Reset() {
+    std::scoped_lock lock{mutex};
+    for (auto& [key, profile] : profiles) {
+        profile.calls = 0;
+        profile.sleeps = 0;
+        profile.total_time = {};
+        profile.max_time = {};
+        profile.sleep_time = {};
+        profile.histogram.fill(0);
+    }
+}
+
+} // namespace IPCDebugger
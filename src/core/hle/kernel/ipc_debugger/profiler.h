@@ -0,0 +1,77 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+namespace IPCDebugger {
+
+/**
+ * Statistics of the calls of a single command of an HLE service.
+ */
+struct CommandProfile {
+    /// Bucket i counts the calls handled in less than 2^i microseconds, the last one the rest
+    static constexpr std::size_t NUM_BUCKETS = 16;
+
+    std::string service_name;
+    std::string function_name;
+    u32 command_id{};
+    u64 calls{};
+    u64 sleeps{};
+    std::chrono::nanoseconds total_time{};
+    std::chrono::nanoseconds max_time{};
+    /// Emulated time the client threads were put to sleep for by the handler
+    std::chrono::nanoseconds sleep_time{};
+    std::array<u64, NUM_BUCKETS> histogram{};
+};
+
+/**
+ * Always enabled profiler of HLE service calls. Counts the calls of every command and how long
+ * their handlers took on the host, along with the time the client was asleep waiting for the
+ * reply. Commands are profiled by the emulation thread, the results may be read from any thread.
+ */
+class Profiler {
+public:
+    /**
+     * Returns the profile of a command, creating it on first use. The returned pointer stays
+     * valid for the lifetime of the profiler.
+     */
+    CommandProfile* GetProfile(const void* service, std::string_view service_name, u32 command_id,
+                               std::string_view function_name);
+
+    /// Records a call of a command that was handled in time.
+    void RecordCall(CommandProfile* profile, std::chrono::nanoseconds time);
+
+    /// Records the time the client thread of a call slept for before getting the reply.
+    void RecordSleep(CommandProfile* profile, std::chrono::nanoseconds time);
+
+    /// Returns a copy of the profiles of the called commands, the most expensive first.
+    std::vector<CommandProfile> GetProfiles() const;
+
+    /// Formats the profiles as a table.
+    std::string Dump() const;
+
+    /// Clears the statistics of all commands.
+    void Reset();
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const std::pair<const void*, u32>& key) const noexcept {
+            return std::hash<const void*>{}(key.first) ^ (std::size_t{key.second} << 1);
+        }
+    };
+
+    std::unordered_map<std::pair<const void*, u32>, CommandProfile, KeyHash> profiles;
+    mutable std::mutex mutex;
+};
+
+} // namespace IPCDebugger
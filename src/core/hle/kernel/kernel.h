@@ -12,9 +12,11 @@
 #include <span>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <boost/serialization/export.hpp>
 #include "common/common_types.h"
+#include "common/slab_allocator.h"
 #include "core/hle/kernel/memory.h"
 #include "core/hle/result.h"
 #include "core/memory.h"
@@ -37,8 +39,9 @@ class Timing;
 } // namespace Core
 
 namespace IPCDebugger {
+class Profiler;
 class Recorder;
-}
+} // namespace IPCDebugger
 
 namespace Kernel {
 
@@ -299,6 +302,9 @@ public:
     IPCDebugger::Recorder& GetIPCRecorder();
     const IPCDebugger::Recorder& GetIPCRecorder() const;
 
+    IPCDebugger::Profiler& GetIPCProfiler();
+    const IPCDebugger::Profiler& GetIPCProfiler() const;
+
     std::shared_ptr<MemoryRegionInfo> GetMemoryRegion(MemoryRegion region);
 
     void HandleSpecialMapping(VMManager& address_space, const AddressMapping& mapping);
@@ -346,6 +352,16 @@ public:
         return main_thread_extended_sleep;
     }
 
+    /**
+     * Creates a kernel object of a frequently created type in the kernel object heap, which keeps
+     * the object and its reference count in one recycled block.
+     */
+    template <typename T, typename... Args>
+    std::shared_ptr<T> MakeObject(Args&&... args) {
+        return std::allocate_shared<T>(Common::SlabAllocator<T>{object_heap},
+                                       std::forward<Args>(args)...);
+    }
+
 private:
     void MemoryInit(MemoryMode memory_mode, New3dsMemoryMode n3ds_mode, u64 override_init_time);
 
@@ -354,6 +370,9 @@ private:
     std::unique_ptr<ResourceLimitList> resource_limits;
     std::atomic<u32> next_object_id{0};
 
+    // Shared by the objects allocated from it, which keep it alive past the kernel
+    std::shared_ptr<Common::SlabHeap> object_heap = std::make_shared<Common::SlabHeap>();
+
     // Note: keep the member order below in order to perform correct destruction.
     // Thread manager is destructed before process list in order to Stop threads and clear thread
     // info from their parent processes first. Timer manager is destructed after process list
@@ -379,6 +398,7 @@ private:
     std::shared_ptr<SharedPage::Handler> shared_page_handler;
 
     std::unique_ptr<IPCDebugger::Recorder> ipc_recorder;
+    std::unique_ptr<IPCDebugger::Profiler> ipc_profiler;
 
     u32 next_thread_id;
 
@@ -37,7 +37,7 @@ Mutex::~Mutex() {
 }
 
 std::shared_ptr<Mutex> KernelSystem::CreateMutex(bool initial_locked, std::string name) {
-    auto mutex = std::make_shared<Mutex>(*this);
+    auto mutex = MakeObject<Mutex>(*this);
     mutex->lock_count = 0;
     mutex->name = std::move(name);
     mutex->holding_thread = nullptr;
@@ -88,7 +88,7 @@ std::shared_ptr<T> SharedFrom(T* raw) {
 template <typename T>
 inline std::shared_ptr<T> DynamicObjectCast(std::shared_ptr<Object> object) {
     if (object != nullptr && object->GetHandleType() == T::HANDLE_TYPE) {
-        return std::static_pointer_cast<T>(object);
+        return std::static_pointer_cast<T>(std::move(object));
     }
     return nullptr;
 }
@@ -32,7 +32,7 @@ ResultVal<std::shared_ptr<Semaphore>> KernelSystem::CreateSemaphore(s32 initial_
 
     // When the semaphore is created, some slots are reserved for other threads,
     // and the rest is reserved for the caller thread
-    auto semaphore = std::make_shared<Semaphore>(*this);
+    auto semaphore = MakeObject<Semaphore>(*this);
     semaphore->max_count = max_count;
     semaphore->available_count = initial_count;
     semaphore->name = std::move(name);
@@ -13,6 +13,7 @@
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/gdbstub/hio.h"
+#include "core/guest_profiler.h"
 #include "core/hle/kernel/address_arbiter.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/client_session.h"
@@ -351,6 +352,7 @@ class SVC : public SVCWrapper<SVC> {
 public:
     SVC(Core::System& system);
     void CallSVC(u32 immediate);
+    bool CallCoreLocalSVC(Core::ARM_Interface& core, u32 immediate);
 
 private:
     Core::System& system;
@@ -1538,15 +1540,20 @@ void SVC::SleepThread(s64 nanoseconds) {
 }
 
 /// This returns the total CPU ticks elapsed since the CPU was powered-on
-s64 SVC::GetSystemTick() {
+/// Returns the ticks of the core, advancing them by the cost of the SVC
+static s64 GetCoreTick(Core::ARM_Interface& core) {
     // TODO: Use globalTicks here?
-    s64 result = system.GetRunningCore().GetTimer().GetTicks();
+    s64 result = core.GetTimer().GetTicks();
     // Advance time to defeat dumb games (like Cubic Ninja) that busy-wait for the frame to end.
     // Measured time between two calls on a 9.2 o3DS with Ninjhax 1.1b
-    system.GetRunningCore().GetTimer().AddTicks(150);
+    core.GetTimer().AddTicks(150);
     return result;
 }
 
+s64 SVC::GetSystemTick() {
+    return GetCoreTick(system.GetRunningCore());
+}
+
 // Returns information of the specified handle
 Result SVC::GetHandleInfo(s64* out, Handle handle, u32 type) {
     std::shared_ptr<Object> object = kernel.GetCurrentProcess()->handle_table.GetGeneric(handle);
@@ -2247,6 +2254,9 @@ void SVC::CallSVC(u32 immediate) {
     const FunctionDef* info = GetSVCInfo(immediate);
     LOG_TRACE(Kernel_SVC, "calling {}", info->name);
     if (info) {
+        if (auto profiler = system.GetGuestProfiler()) {
+            profiler->CountSVC(immediate, info->name);
+        }
         if (info->func) {
             (this->*(info->func))();
         } else {
@@ -2255,6 +2265,21 @@ void SVC::CallSVC(u32 immediate) {
     }
 }
 
+bool SVC::CallCoreLocalSVC(Core::ARM_Interface& core, u32 immediate) {
+    // Games poll the tick in tight loops, taking the kernel lock for each call would have the
+    // cores contend for it
+    if (immediate != 0x28) {
+        return false;
+    }
+    if (auto profiler = system.GetGuestProfiler()) {
+        profiler->CountSVC(immediate, "GetSystemTick");
+    }
+    const u64 ticks = static_cast<u64>(GetCoreTick(core));
+    core.SetReg(0, static_cast<u32>(ticks));
+    core.SetReg(1, static_cast<u32>(ticks >> 32));
+    return true;
+}
+
 SVC::SVC(Core::System& system) : system(system), kernel(system.Kernel()), memory(system.Memory()) {}
 
 u32 SVC::GetReg(std::size_t n) {
@@ -2272,6 +2297,10 @@ void SVCContext::CallSVC(u32 immediate) {
     impl->CallSVC(immediate);
 }
 
+bool SVCContext::CallCoreLocalSVC(Core::ARM_Interface& core, u32 immediate) {
+    return impl->CallCoreLocalSVC(core, immediate);
+}
+
 } // namespace Kernel
 
 SERIALIZE_EXPORT_IMPL(Kernel::SVC_SyncCallback)
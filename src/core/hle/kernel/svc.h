@@ -9,6 +9,7 @@
 #include "common/common_types.h"
 
 namespace Core {
+class ARM_Interface;
 class System;
 } // namespace Core
 
@@ -22,6 +23,13 @@ public:
     ~SVCContext();
     void CallSVC(u32 immediate);
 
+    /**
+     * Runs the SVC if it only touches the registers and the timer of the calling core, which
+     * needs neither the kernel lock nor the core to be made the running one.
+     * @returns True if the SVC was run, false if it has to go through CallSVC
+     */
+    bool CallCoreLocalSVC(Core::ARM_Interface& core, u32 immediate);
+
 private:
     std::unique_ptr<SVC> impl;
 };
@@ -146,7 +146,7 @@ private:
     Core::ARM_Interface* cpu;
 
     std::shared_ptr<Thread> current_thread;
-    Common::ThreadQueueList<Thread*, ThreadPrioLowest + 1> ready_queue;
+    Common::ThreadQueueList<Thread, ThreadPrioLowest + 1> ready_queue;
     std::deque<Thread*> unscheduled_ready_queue;
     std::unordered_map<u64, Thread*> wakeup_callback_table;
 
@@ -294,6 +294,9 @@ public:
     u32 nominal_priority; ///< Nominal thread priority, as set by the emulated application
     u32 current_priority; ///< Current thread priority, can be temporarily changed
 
+    /// Links of the thread in the ready queue, rebuilt by the queue when loading a savestate
+    Common::ThreadQueueNode<Thread> queue_node;
+
     u64 last_running_ticks; ///< CPU tick when thread was last running
 
     s32 processor_id;
@@ -31,7 +31,7 @@ Timer::~Timer() {
 }
 
 std::shared_ptr<Timer> KernelSystem::CreateTimer(ResetType reset_type, std::string name) {
-    auto timer = std::make_shared<Timer>(*this);
+    auto timer = MakeObject<Timer>(*this);
     timer->reset_type = reset_type;
     timer->signaled = false;
     timer->name = std::move(name);
@@ -72,6 +72,7 @@ void VMManager::Reset() {
     page_table->Clear();
 
     UpdatePageTableForVMA(initial_vma);
+    NotifyMemoryChanged();
 }
 
 VMManager::VMAHandle VMManager::FindVMA(VAddr target) const {
@@ -86,8 +87,8 @@ ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size,
                                                    u32 size, MemoryState state) {
     ASSERT(!is_locked);
 
-    // Find the first Free VMA.
-    VMAHandle vma_handle = std::find_if(vma_map.begin(), vma_map.end(), [&](const auto& vma) {
+    // Find the first Free VMA. VMAs ending before the base can't fit, so start from its VMA.
+    VMAHandle vma_handle = std::find_if(FindVMA(base), vma_map.cend(), [&](const auto& vma) {
         if (vma.second.type != VMAType::Free)
             return false;
 
@@ -95,14 +96,14 @@ ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size,
         return vma_end > base && vma_end >= base + size;
     });
 
-    VAddr target = std::max(base, vma_handle->second.base);
-
     // Do not try to allocate the block if there are no available addresses within the desired
     // region.
-    if (vma_handle == vma_map.end() || target + size > base + region_size) {
+    if (vma_handle == vma_map.end() ||
+        std::max(base, vma_handle->second.base) + size > base + region_size) {
         return Result(ErrorDescription::OutOfMemory, ErrorModule::Kernel,
                       ErrorSummary::OutOfResource, ErrorLevel::Permanent);
     }
+    const VAddr target = std::max(base, vma_handle->second.base);
 
     auto result = MapBackingMemory(target, memory, size, state);
 
@@ -127,6 +128,7 @@ ResultVal<VMManager::VMAHandle> VMManager::MapBackingMemory(VAddr target, Memory
     final_vma.meminfo_state = state;
     final_vma.backing_memory = memory;
     UpdatePageTableForVMA(final_vma);
+    NotifyMemoryChanged();
 
     return MergeAdjacent(vma_handle);
 }
@@ -160,13 +162,14 @@ Result VMManager::ChangeMemoryState(VAddr target, u32 size, MemoryState expected
 
     const VMAIter end = vma_map.end();
     // The comparison against the end of the range must be done using addresses since VMAs can be
-    // merged during this process, causing invalidation of the iterators.
+    // merged during this process, causing invalidation of the iterators. The page table does not
+    // hold permissions nor states, so the pages are left as they are.
     while (vma != end && vma->second.base < target_end) {
         vma->second.permissions = new_perms;
         vma->second.meminfo_state = new_state;
-        UpdatePageTableForVMA(vma->second);
         vma = std::next(MergeAdjacent(vma));
     }
+    NotifyMemoryChanged();
 
     return ResultSuccess;
 }
@@ -180,8 +183,6 @@ VMManager::VMAIter VMManager::Unmap(VMAIter vma_handle) {
     vma.meminfo_state = MemoryState::Free;
     vma.backing_memory = nullptr;
 
-    UpdatePageTableForVMA(vma);
-
     return MergeAdjacent(vma_handle);
 }
 
@@ -198,6 +199,10 @@ Result VMManager::UnmapRange(VAddr target, u32 size) {
         vma = std::next(Unmap(vma));
     }
 
+    // Unmap the whole range at once instead of once per VMA
+    memory.UnmapRegion(*page_table, target, size);
+    NotifyMemoryChanged();
+
     ASSERT(FindVMA(target)->second.size >= size);
     return ResultSuccess;
 }
@@ -207,9 +212,8 @@ VMManager::VMAHandle VMManager::Reprotect(VMAHandle vma_handle, VMAPermission ne
 
     VMAIter iter = StripIterConstness(vma_handle);
 
-    VirtualMemoryArea& vma = iter->second;
-    vma.permissions = new_perms;
-    UpdatePageTableForVMA(vma);
+    iter->second.permissions = new_perms;
+    NotifyMemoryChanged();
 
     return MergeAdjacent(iter);
 }
@@ -224,8 +228,10 @@ Result VMManager::ReprotectRange(VAddr target, u32 size, VMAPermission new_perms
     // The comparison against the end of the range must be done using addresses since VMAs can be
     // merged during this process, causing invalidation of the iterators.
     while (vma != end && vma->second.base < target_end) {
-        vma = std::next(StripIterConstness(Reprotect(vma, new_perms)));
+        vma->second.permissions = new_perms;
+        vma = std::next(MergeAdjacent(vma));
     }
+    NotifyMemoryChanged();
 
     return ResultSuccess;
 }
@@ -370,7 +376,9 @@ void VMManager::UpdatePageTableForVMA(const VirtualMemoryArea& vma) {
         memory.MapMemoryRegion(*page_table, vma.base, vma.size, vma.backing_memory);
         break;
     }
+}
 
+void VMManager::NotifyMemoryChanged() {
     auto plgldr = Service::PLGLDR::GetService(Core::System::GetInstance());
     if (plgldr)
         plgldr->OnMemoryChanged(process, Core::System::GetInstance().Kernel());
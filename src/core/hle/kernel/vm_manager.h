@@ -191,7 +191,7 @@ private:
     /// Converts a VMAHandle to a mutable VMAIter.
     VMAIter StripIterConstness(const VMAHandle& iter);
 
-    /// Unmaps the given VMA.
+    /// Marks the given VMA as free, leaving the page table to be updated by the caller.
     VMAIter Unmap(VMAIter vma);
 
     /**
@@ -221,6 +221,9 @@ private:
     /// Updates the pages corresponding to this VMA so they match the VMA's attributes.
     void UpdatePageTableForVMA(const VirtualMemoryArea& vma);
 
+    /// Signals the plugin loader that the address space changed, once per operation.
+    void NotifyMemoryChanged();
+
     Memory::MemorySystem& memory;
     Kernel::Process& process;
 
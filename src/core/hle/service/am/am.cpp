@@ -5,8 +5,11 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <thread>
+#include <unordered_map>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
+#include <cryptopp/sha.h>
 #include <fmt/format.h>
 #include "common/alignment.h"
 #include "common/archives.h"
@@ -14,6 +17,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/ncch_container.h"
@@ -80,14 +84,92 @@ struct TicketInfo {
 
 static_assert(sizeof(TicketInfo) == 0x18, "Ticket info structure size is wrong");
 
-class CIAFile::DecryptionState {
+/// Maximum number of threads decrypting, hashing and writing the contents of a CIA
+constexpr std::size_t MAX_CONTENT_WORKERS = 4;
+
+/// Amount of content data queued on a worker after which the caller waits for it to catch up
+constexpr std::size_t MAX_PENDING_CONTENT_DATA = 32 * 1024 * 1024;
+
+/**
+ * Decrypts, hashes and writes the contents of a CIA on worker threads, while the caller goes on
+ * reading the CIA. Each content goes to one worker which processes its chunks in order, different
+ * contents are processed in parallel.
+ */
+class CIAFile::ContentWriter {
 public:
+    void Start(std::size_t content_count) {
+        Finish();
+        hashes = std::vector<CryptoPP::SHA256>(content_count);
+        const std::size_t num_workers = std::clamp<std::size_t>(
+            std::min<std::size_t>(std::thread::hardware_concurrency(), MAX_CONTENT_WORKERS), 1,
+            std::max<std::size_t>(content_count, 1));
+        workers.clear();
+        pending = std::make_unique<std::atomic<std::size_t>[]>(num_workers);
+        for (std::size_t i = 0; i < num_workers; i++) {
+            workers.push_back(std::make_unique<Common::ThreadWorker>(1, "CIA installation",
+                                                                     Common::ThreadRole::Background));
+        }
+    }
+
+    /// Processes a chunk of a content once the previous chunks of that content are processed.
+    void Queue(std::size_t index, bool encrypted, std::vector<u8>&& chunk) {
+        const std::size_t worker = index % workers.size();
+        pending[worker] += chunk.size();
+        workers[worker]->QueueWork(
+            [this, index, worker, encrypted, chunk = std::move(chunk)]() mutable {
+                if (encrypted) {
+                    content[index].ProcessData(chunk.data(), chunk.data(), chunk.size());
+                }
+                hashes[index].Update(chunk.data(), chunk.size());
+                if (files[index].WriteBytes(chunk.data(), chunk.size()) != chunk.size()) {
+                    LOG_ERROR(Service_AM, "Could not write content {}", index);
+                    failed = true;
+                }
+                pending[worker] -= chunk.size();
+            });
+        if (pending[worker] > MAX_PENDING_CONTENT_DATA) {
+            workers[worker]->WaitForRequests();
+        }
+    }
+
+    /// Waits for all the queued chunks to be processed.
+    void Finish() {
+        for (auto& worker : workers) {
+            worker->WaitForRequests();
+        }
+    }
+
+    /// Closes the content files once the install is completed.
+    void Close() {
+        Finish();
+        for (auto& file : files) {
+            file.Close();
+        }
+    }
+
+    /// Returns whether the decrypted content has the hash given by the title metadata.
+    bool VerifyHash(std::size_t index, const std::array<u8, 0x20>& expected) {
+        std::array<u8, CryptoPP::SHA256::DIGESTSIZE> digest;
+        hashes[index].Final(digest.data());
+        return digest == expected;
+    }
+
+    std::vector<FileUtil::IOFile> files;
+    /// Decryption of the contents, empty if none are encrypted
     std::vector<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption> content;
+    std::vector<CryptoPP::SHA256> hashes;
+    std::atomic<bool> failed{false};
+    /// Set once the install is completed, with whether the contents were written correctly
+    std::optional<bool> verified;
+
+private:
+    std::vector<std::unique_ptr<Common::ThreadWorker>> workers;
+    /// Size of the chunks queued on each worker and not yet written
+    std::unique_ptr<std::atomic<std::size_t>[]> pending;
 };
 
 CIAFile::CIAFile(Core::System& system_, Service::FS::MediaType media_type)
-    : system(system_), media_type(media_type),
-      decryption_state(std::make_unique<DecryptionState>()) {}
+    : system(system_), media_type(media_type), content_writer(std::make_unique<ContentWriter>()) {}
 
 CIAFile::~CIAFile() {
     Close();
@@ -156,10 +238,11 @@ Result CIAFile::WriteTitleMetadata() {
     auto content_count = container.GetTitleMetadata().GetContentCount();
     content_written.resize(content_count);
 
-    content_files.clear();
+    content_writer->Start(content_count);
+    content_writer->files.clear();
     for (std::size_t i = 0; i < content_count; i++) {
         auto path = GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update);
-        auto& file = content_files.emplace_back(path, "wb");
+        auto& file = content_writer->files.emplace_back(path, "wb");
         if (!file.IsOpen()) {
             LOG_ERROR(Service_AM, "Could not open output file '{}' for content {}.", path, i);
             // TODO: Correct error code.
@@ -169,11 +252,11 @@ Result CIAFile::WriteTitleMetadata() {
 
     if (container.GetTitleMetadata().HasEncryptedContent()) {
         if (auto title_key = container.GetTicket().GetTitleKey()) {
-            decryption_state->content.resize(content_count);
+            content_writer->content.resize(content_count);
             for (std::size_t i = 0; i < content_count; ++i) {
                 auto ctr = tmd.GetContentCTRByIndex(i);
-                decryption_state->content[i].SetKeyWithIV(title_key->data(), title_key->size(),
-                                                          ctr.data());
+                content_writer->content[i].SetKeyWithIV(title_key->data(), title_key->size(),
+                                                        ctr.data());
             }
         } else {
             LOG_ERROR(Service_AM, "Could not read title key from ticket for encrypted CIA.");
@@ -212,18 +295,14 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
             const u64 available_to_write = std::min(offset_max, range_max) - range_min;
 
             // Since the incoming TMD has already been written, we can use GetTitleContentPath
-            // to get the content paths to write to.
+            // to get the content paths to write to. The data is decrypted and written on the
+            // content writer threads.
             FileSys::TitleMetadata tmd = container.GetTitleMetadata();
-            auto& file = content_files[i];
-
+            const bool encrypted =
+                (tmd.GetContentTypeByIndex(i) & FileSys::TMDContentTypeFlag::Encrypted) != 0;
             std::vector<u8> temp(buffer + (range_min - offset),
                                  buffer + (range_min - offset) + available_to_write);
-
-            if ((tmd.GetContentTypeByIndex(i) & FileSys::TMDContentTypeFlag::Encrypted) != 0) {
-                decryption_state->content[i].ProcessData(temp.data(), temp.data(), temp.size());
-            }
-
-            file.WriteBytes(temp.data(), temp.size());
+            content_writer->Queue(i, encrypted, std::move(temp));
 
             // Keep tabs on how much of this content ID has been written so new range_min
             // values can be calculated.
@@ -319,6 +398,8 @@ bool CIAFile::SetSize(u64 size) const {
 }
 
 bool CIAFile::Close() const {
+    content_writer->Finish();
+
     bool complete =
         install_state >= CIAInstallState::TMDLoaded &&
         content_written.size() == container.GetTitleMetadata().GetContentCount() &&
@@ -334,6 +415,27 @@ bool CIAFile::Close() const {
         return true;
     }
 
+    // Check the contents against the hashes of the title metadata once
+    if (!content_writer->verified) {
+        const FileSys::TitleMetadata& tmd = container.GetTitleMetadata();
+        bool verified = !content_writer->failed;
+        for (std::size_t i = 0; i < content_written.size() && verified; i++) {
+            if (container.GetContentSize(i) != 0 &&
+                !content_writer->VerifyHash(i, tmd.GetContentHashByIndex(i))) {
+                LOG_ERROR(Service_AM, "Hash mismatch for content {} of {:016X}", i,
+                          tmd.GetTitleID());
+                verified = false;
+            }
+        }
+        content_writer->Close();
+        content_writer->verified = verified;
+    }
+    if (!*content_writer->verified) {
+        LOG_ERROR(Service_AM, "CIA contents could not be installed, aborting install...");
+        FileUtil::DeleteDir(GetTitlePath(media_type, container.GetTitleMetadata().GetTitleID()));
+        return false;
+    }
+
     // Clean up older content data if we installed newer content on top
     std::string old_tmd_path =
         GetTitleMetadataPath(media_type, container.GetTitleMetadata().GetTitleID(), false);
@@ -445,7 +547,8 @@ InstallStatus InstallCIA(const std::string& path,
             return InstallStatus::ErrorFailedToOpenFile;
         }
 
-        std::array<u8, 0x10000> buffer;
+        // The contents are processed on other threads while the next chunk is read
+        std::vector<u8> buffer(0x100000);
         auto file_size = file.GetSize();
         std::size_t total_bytes_read = 0;
         while (total_bytes_read != file_size) {
@@ -463,7 +566,10 @@ InstallStatus InstallCIA(const std::string& path,
             }
             total_bytes_read += bytes_read;
         }
-        installFile.Close();
+        if (!installFile.Close()) {
+            LOG_ERROR(Service_AM, "CIA file {} has corrupted contents!", path);
+            return InstallStatus::ErrorInvalid;
+        }
 
         LOG_INFO(Service_AM, "Installed {} successfully.", path);
 
@@ -508,12 +614,13 @@ InstallStatus InstallFromNus(u64 title_id, int version) {
     LOG_DEBUG(Service_AM, "Downloading {:X}", title_id);
 
     CIAFile install_file{Core::System::GetInstance(), GetTitleMediaType(title_id)};
+    Core::NUS::Downloader downloader;
 
     std::string path = fmt::format("/ccs/download/{:016X}/tmd", title_id);
     if (version != -1) {
         path += fmt::format(".{}", version);
     }
-    auto tmd_response = Core::NUS::Download(path);
+    auto tmd_response = downloader.Download(path);
     if (!tmd_response) {
         LOG_ERROR(Service_AM, "Failed to download tmd for {:016X}", title_id);
         return InstallStatus::ErrorFileNotFound;
@@ -522,25 +629,13 @@ InstallStatus InstallFromNus(u64 title_id, int version) {
     tmd.Load(*tmd_response);
 
     path = fmt::format("/ccs/download/{:016X}/cetk", title_id);
-    auto cetk_response = Core::NUS::Download(path);
+    auto cetk_response = downloader.Download(path);
     if (!cetk_response) {
         LOG_ERROR(Service_AM, "Failed to download cetk for {:016X}", title_id);
         return InstallStatus::ErrorFileNotFound;
     }
 
-    std::vector<u8> content;
     const auto content_count = tmd.GetContentCount();
-    for (std::size_t i = 0; i < content_count; ++i) {
-        const std::string filename = fmt::format("{:08x}", tmd.GetContentIDByIndex(i));
-        path = fmt::format("/ccs/download/{:016X}/{}", title_id, filename);
-        const auto temp_response = Core::NUS::Download(path);
-        if (!temp_response) {
-            LOG_ERROR(Service_AM, "Failed to download content for {:016X}", title_id);
-            return InstallStatus::ErrorFileNotFound;
-        }
-        content.insert(content.end(), temp_response->begin(), temp_response->end());
-    }
-
     FileSys::CIAContainer::Header fake_header{
         .header_size = sizeof(FileSys::CIAContainer::Header),
         .type = 0,
@@ -557,10 +652,7 @@ InstallStatus InstallFromNus(u64 title_id, int version) {
     std::memcpy(header_data.data(), &fake_header, sizeof(fake_header));
 
     std::size_t current_offset = 0;
-    const auto write_to_cia_file_aligned = [&install_file, &current_offset](std::vector<u8>& data) {
-        const u64 offset =
-            Common::AlignUp(current_offset + data.size(), FileSys::CIA_SECTION_ALIGNMENT);
-        data.resize(offset - current_offset, 0);
+    const auto write_to_cia_file = [&install_file, &current_offset](std::span<const u8> data) {
         const auto result = install_file.Write(current_offset, data.size(), true, data.data());
         if (result.Failed()) {
             LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
@@ -570,6 +662,13 @@ InstallStatus InstallFromNus(u64 title_id, int version) {
         current_offset += data.size();
         return InstallStatus::Success;
     };
+    const auto write_to_cia_file_aligned = [&write_to_cia_file,
+                                            &current_offset](std::vector<u8>& data) {
+        const u64 offset =
+            Common::AlignUp(current_offset + data.size(), FileSys::CIA_SECTION_ALIGNMENT);
+        data.resize(offset - current_offset, 0);
+        return write_to_cia_file(data);
+    };
 
     auto result = write_to_cia_file_aligned(header_data);
     if (result != InstallStatus::Success) {
@@ -586,9 +685,28 @@ InstallStatus InstallFromNus(u64 title_id, int version) {
         return result;
     }
 
-    result = write_to_cia_file_aligned(content);
-    if (result != InstallStatus::Success) {
-        return result;
+    // The contents are written to the CIA file as they are downloaded, it decrypts and hashes
+    // them on its own threads.
+    for (std::size_t i = 0; i < content_count; ++i) {
+        const std::string filename = fmt::format("{:08x}", tmd.GetContentIDByIndex(i));
+        path = fmt::format("/ccs/download/{:016X}/{}", title_id, filename);
+        const bool downloaded = downloader.Download(
+            path, tmd.GetContentSizeByIndex(i), [&write_to_cia_file, &result](auto data) {
+                result = write_to_cia_file(data);
+                return result == InstallStatus::Success;
+            });
+        if (result != InstallStatus::Success) {
+            return result;
+        }
+        if (!downloaded) {
+            LOG_ERROR(Service_AM, "Failed to download content for {:016X}", title_id);
+            return InstallStatus::ErrorFileNotFound;
+        }
+    }
+
+    if (!install_file.Close()) {
+        LOG_ERROR(Service_AM, "Title {:016X} has corrupted contents!", title_id);
+        return InstallStatus::ErrorInvalid;
     }
     return InstallStatus::Success;
 }
@@ -730,10 +848,167 @@ std::string GetMediaTitlePath(Service::FS::MediaType media_type) {
     return "";
 }
 
+namespace {
+
+constexpr u32 TITLE_INDEX_MAGIC = 0x5844'4954; // "TIDX"
+constexpr u32 TITLE_INDEX_VERSION = 1;
+
+struct TitleIndexHeader {
+    u32_le magic;
+    u32_le version;
+    u32_le num_entries;
+    u32_le title_path_size;
+};
+
+/// Indexed state of the files of a title, followed by its content path
+struct TitleIndexEntry {
+    u64_le title_id;
+    s64_le content_dir_time;
+    s64_le content_time;
+    u64_le content_size;
+    u32_le content_path_size;
+    u32_le is_loadable;
+};
+static_assert(sizeof(TitleIndexEntry) == 0x28, "TitleIndexEntry has incorrect size");
+
+/// Result of checking an installed title, valid while the files it was checked from are unchanged
+struct IndexedTitle {
+    s64 content_dir_time;
+    s64 content_time;
+    u64 content_size;
+    std::string content_path;
+    bool is_loadable;
+};
+
+using TitleIndex = std::unordered_map<u64, IndexedTitle>;
+
+std::string GetTitleIndexPath(Service::FS::MediaType media_type) {
+    return fmt::format("{}title_index" DIR_SEP "{}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::CacheDir),
+                       media_type == Service::FS::MediaType::NAND ? "nand" : "sdmc");
+}
+
+s64 GetFileTime(const std::string& path) {
+    return FileUtil::Exists(path) ? FileUtil::GetModificationTime(path).value_or(-1) : -1;
+}
+
+TitleIndex LoadTitleIndex(Service::FS::MediaType media_type, const std::string& title_path) {
+    FileUtil::IOFile file(GetTitleIndexPath(media_type), "rb");
+    TitleIndexHeader header;
+    if (!file.IsOpen() || file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != TITLE_INDEX_MAGIC || header.version != TITLE_INDEX_VERSION ||
+        header.title_path_size != title_path.size()) {
+        return {};
+    }
+    // The index of another user directory does not apply
+    std::string indexed_path(header.title_path_size, '\0');
+    if (file.ReadBytes(indexed_path.data(), indexed_path.size()) != indexed_path.size() ||
+        indexed_path != title_path) {
+        return {};
+    }
+
+    const u64 file_size = file.GetSize();
+    TitleIndex index;
+    for (u32 i = 0; i < header.num_entries; i++) {
+        TitleIndexEntry entry;
+        if (file.ReadBytes(&entry, sizeof(entry)) != sizeof(entry) ||
+            entry.content_path_size > file_size) {
+            break;
+        }
+        IndexedTitle title{
+            .content_dir_time = entry.content_dir_time,
+            .content_time = entry.content_time,
+            .content_size = entry.content_size,
+            .content_path = std::string(entry.content_path_size, '\0'),
+            .is_loadable = entry.is_loadable != 0,
+        };
+        if (file.ReadBytes(title.content_path.data(), title.content_path.size()) !=
+            title.content_path.size()) {
+            break;
+        }
+        index.insert_or_assign(entry.title_id, std::move(title));
+    }
+    return index;
+}
+
+void SaveTitleIndex(Service::FS::MediaType media_type, const std::string& title_path,
+                    const TitleIndex& index) {
+    const std::string index_path = GetTitleIndexPath(media_type);
+    if (!FileUtil::CreateFullPath(index_path)) {
+        return;
+    }
+
+    FileUtil::IOFile file(index_path, "wb");
+    TitleIndexHeader header{};
+    header.magic = TITLE_INDEX_MAGIC;
+    header.version = TITLE_INDEX_VERSION;
+    header.num_entries = static_cast<u32>(index.size());
+    header.title_path_size = static_cast<u32>(title_path.size());
+    bool success =
+        file.WriteObject(header) == 1 && file.WriteString(title_path) == title_path.size();
+    for (const auto& [title_id, title] : index) {
+        if (!success) {
+            break;
+        }
+        TitleIndexEntry entry{};
+        entry.title_id = title_id;
+        entry.content_dir_time = title.content_dir_time;
+        entry.content_time = title.content_time;
+        entry.content_size = title.content_size;
+        entry.content_path_size = static_cast<u32>(title.content_path.size());
+        entry.is_loadable = title.is_loadable ? 1 : 0;
+        success = file.WriteObject(entry) == 1 &&
+                  file.WriteString(title.content_path) == title.content_path.size();
+    }
+    if (!success) {
+        LOG_ERROR(Service_AM, "Could not write the title index {}", index_path);
+        file.Close();
+        FileUtil::Delete(index_path);
+    }
+}
+
+/**
+ * Returns true if the main content of the title can be loaded. The content is only parsed when
+ * the files of the title changed since it was indexed: installing or deleting contents and
+ * metadata changes the modification time of the content directory, while contents replaced in
+ * place change their own size or modification time.
+ */
+bool IsTitleLoadable(Service::FS::MediaType media_type, u64 tid, const TitleIndex& index,
+                     TitleIndex& new_index, bool& index_changed) {
+    const s64 content_dir_time = GetFileTime(GetTitlePath(media_type, tid) + "content/");
+    if (const auto it = index.find(tid); it != index.end() && content_dir_time != -1) {
+        const IndexedTitle& title = it->second;
+        if (title.content_dir_time == content_dir_time &&
+            title.content_time == GetFileTime(title.content_path) &&
+            title.content_size == FileUtil::GetSize(title.content_path)) {
+            new_index.insert_or_assign(tid, title);
+            return title.is_loadable;
+        }
+    }
+
+    IndexedTitle title{
+        .content_dir_time = content_dir_time,
+        .content_path = GetTitleContentPath(media_type, tid),
+    };
+    title.content_time = GetFileTime(title.content_path);
+    title.content_size = title.content_time != -1 ? FileUtil::GetSize(title.content_path) : 0;
+    FileSys::NCCHContainer container(title.content_path);
+    title.is_loadable = container.Load() == Loader::ResultStatus::Success;
+    const bool is_loadable = title.is_loadable;
+    new_index.insert_or_assign(tid, std::move(title));
+    index_changed = true;
+    return is_loadable;
+}
+
+} // Anonymous namespace
+
 void Module::ScanForTitles(Service::FS::MediaType media_type) {
     am_title_list[static_cast<u32>(media_type)].clear();
 
     std::string title_path = GetMediaTitlePath(media_type);
+    const TitleIndex index = LoadTitleIndex(media_type, title_path);
+    TitleIndex new_index;
+    bool index_changed = false;
 
     FileUtil::FSTEntry entries;
     FileUtil::ScanDirectoryTree(title_path, entries, 1);
@@ -751,15 +1026,17 @@ void Module::ScanForTitles(Service::FS::MediaType media_type) {
                     if (FileUtil::Exists(GetTitleContentPath(media_type, tid))) {
                         am_title_list[static_cast<u32>(media_type)].push_back(tid);
                     }
-                } else {
-                    FileSys::NCCHContainer container(GetTitleContentPath(media_type, tid));
-                    if (container.Load() == Loader::ResultStatus::Success) {
-                        am_title_list[static_cast<u32>(media_type)].push_back(tid);
-                    }
+                } else if (IsTitleLoadable(media_type, tid, index, new_index, index_changed)) {
+                    am_title_list[static_cast<u32>(media_type)].push_back(tid);
                 }
             }
         }
     }
+
+    // Titles that were deleted are dropped from the index as well
+    if (index_changed || new_index.size() != index.size()) {
+        SaveTitleIndex(media_type, title_path, new_index);
+    }
 }
 
 void Module::ScanForAllTitles() {
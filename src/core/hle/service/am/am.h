@@ -107,11 +107,10 @@ private:
     FileSys::CIAContainer container;
     std::vector<u8> data;
     std::vector<u64> content_written;
-    std::vector<FileUtil::IOFile> content_files;
     Service::FS::MediaType media_type;
 
-    class DecryptionState;
-    std::unique_ptr<DecryptionState> decryption_state;
+    class ContentWriter;
+    std::unique_ptr<ContentWriter> content_writer;
 };
 
 // A file handled returned for Tickets to be written into and subsequently installed.
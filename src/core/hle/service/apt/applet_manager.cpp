@@ -398,6 +398,10 @@ Result AppletManager::Enable(AppletAttributes attributes) {
     auto slot_data = GetAppletSlot(slot);
     slot_data->registered = true;
 
+    if (slot == AppletSlot::Application && Settings::values.lle_applets && !applets_prewarmed) {
+        PrewarmLibraryApplets();
+    }
+
     if (slot_data->attributes.applet_pos == AppletPos::System &&
         slot_data->attributes.is_home_menu) {
         slot_data->attributes.raw |= attributes.raw;
@@ -1477,6 +1481,16 @@ static void CaptureFrameBuffer(Core::System& system, u32 capture_offset, VAddr s
         dst_vaddr, GSP::FRAMEBUFFER_WIDTH_POW2 * height * bpp, Memory::FlushMode::Invalidate);
 }
 
+void AppletManager::PrewarmLibraryApplets() {
+    applets_prewarmed = true;
+    auto cfg = Service::CFG::GetModule(system);
+    const u32 region_value = cfg->GetRegionValue();
+    for (const AppletId applet_id : {AppletId::SoftwareKeyboard1, AppletId::Ed1, AppletId::Error,
+                                     AppletId::HomeMenu}) {
+        NS::PrewarmTitle(FS::MediaType::NAND, GetTitleIdForApplet(applet_id, region_value));
+    }
+}
+
 void AppletManager::CaptureFrameBuffers() {
     CaptureFrameBuffer(system, capture_info->bottom_screen_left_offset,
                        GSP::FRAMEBUFFER_SAVE_AREA_BOTTOM, GSP::BOTTOM_FRAMEBUFFER_HEIGHT,
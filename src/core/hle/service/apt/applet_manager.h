@@ -493,6 +493,7 @@ private:
     std::unique_ptr<Input::ButtonDevice> power_button;
     bool last_home_button_state = false;
     bool last_power_button_state = false;
+    bool applets_prewarmed = false;
 
     Core::System& system;
 
@@ -516,6 +517,9 @@ private:
 
     void EnsureHomeMenuLoaded();
 
+    /// Reads the applets the applications launch the most ahead of time, with LLE applets enabled.
+    void PrewarmLibraryApplets();
+
     void CaptureFrameBuffers();
 
     Result CreateHLEApplet(AppletId id, AppletId parent, bool preload);
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/thread_pool.h"
 #include "core/core.h"
+#include "core/file_sys/ncch_container.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/apt/ns.h"
 #include "core/loader/loader.h"
@@ -29,6 +31,24 @@ std::shared_ptr<Kernel::Process> LaunchTitle(FS::MediaType media_type, u64 title
     return process;
 }
 
+void PrewarmTitle(FS::MediaType media_type, u64 title_id) {
+    std::string path = AM::GetTitleContentPath(media_type, title_id);
+    if (path.empty() || !FileUtil::Exists(path)) {
+        return;
+    }
+
+    // The titles are read one at a time, so that they do not take all the I/O threads
+    static constexpr int order_key = 0;
+    Common::ThreadPool::Instance().SubmitIO(&order_key, [path = std::move(path), title_id] {
+        FileSys::NCCHContainer ncch(path);
+        std::vector<u8> code;
+        if (ncch.Load() != Loader::ResultStatus::Success ||
+            ncch.LoadSectionExeFS(".code", code) != Loader::ResultStatus::Success) {
+            LOG_DEBUG(Service_NS, "Could not prewarm title 0x{:016x}", title_id);
+        }
+    });
+}
+
 void RebootToTitle(Core::System& system, FS::MediaType media_type, u64 title_id) {
     auto new_path = AM::GetTitleContentPath(media_type, title_id);
     if (new_path.empty() || !FileUtil::Exists(new_path)) {
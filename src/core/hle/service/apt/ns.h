@@ -18,6 +18,12 @@ namespace Service::NS {
 /// Loads and launches the title identified by title_id in the specified media type.
 std::shared_ptr<Kernel::Process> LaunchTitle(FS::MediaType media_type, u64 title_id);
 
+/**
+ * Reads the title identified by title_id ahead of its launch on an I/O thread, so that the launch
+ * finds its decompressed code in the cache and its file in the cache of the host.
+ */
+void PrewarmTitle(FS::MediaType media_type, u64 title_id);
+
 /// Reboots the system to the specified title.
 void RebootToTitle(Core::System& system, FS::MediaType media_type, u64 title_id);
 
@@ -58,6 +58,8 @@ Result OnlineService::InitializeSession(u64 init_program_id) {
     // 0xC00(BOSS_SS and BOSS_SV) entries.
 
     current_props = BossTaskProperties();
+    // The SpotPass data may have been updated since the last session
+    ns_data_entries.reset();
 
     if (init_program_id == 0) {
         init_program_id = program_id;
@@ -244,13 +246,17 @@ std::vector<FileSys::Entry> OnlineService::GetBossExtDataFiles(
     return boss_files;
 }
 
-std::vector<NsDataEntry> OnlineService::GetNsDataEntries() {
+const std::vector<NsDataEntry>& OnlineService::GetNsDataEntries() {
+    if (ns_data_entries) {
+        return *ns_data_entries;
+    }
+    std::vector<NsDataEntry>& ns_data = ns_data_entries.emplace();
+
     auto boss_archive = OpenBossExtData();
     if (!boss_archive) {
-        return {};
+        return ns_data;
     }
 
-    std::vector<NsDataEntry> ns_data;
     const auto boss_files = GetBossExtDataFiles(boss_archive.get());
     for (const auto& current_file : boss_files) {
         constexpr u32 boss_header_length = 0x34;
@@ -306,7 +312,7 @@ std::vector<NsDataEntry> OnlineService::GetNsDataEntries() {
 
 u16 OnlineService::GetNsDataIdList(const u32 filter, const u32 max_entries,
                                    Kernel::MappedBuffer& buffer) {
-    std::vector<NsDataEntry> ns_data = GetNsDataEntries();
+    const std::vector<NsDataEntry>& ns_data = GetNsDataEntries();
     std::vector<u32> output_entries;
     for (const auto& current_entry : ns_data) {
         const u32 datatype_raw = static_cast<u32>(current_entry.header.datatype);
@@ -332,7 +338,7 @@ u16 OnlineService::GetNsDataIdList(const u32 filter, const u32 max_entries,
 }
 
 std::optional<NsDataEntry> OnlineService::GetNsDataEntryFromId(const u32 ns_data_id) {
-    std::vector<NsDataEntry> ns_data = GetNsDataEntries();
+    const std::vector<NsDataEntry>& ns_data = GetNsDataEntries();
     const auto entry_iter = std::find_if(ns_data.begin(), ns_data.end(), [ns_data_id](auto entry) {
         return entry.header.ns_data_id == ns_data_id;
     });
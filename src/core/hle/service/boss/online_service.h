@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
@@ -197,10 +198,13 @@ private:
     std::unique_ptr<FileSys::ArchiveBackend> OpenBossExtData();
     std::vector<FileSys::Entry> GetBossExtDataFiles(FileSys::ArchiveBackend* boss_archive);
     FileSys::Path GetBossDataDir();
-    std::vector<NsDataEntry> GetNsDataEntries();
+    /// Returns the NsData of the title, read from its SpotPass ext data on the first call only
+    const std::vector<NsDataEntry>& GetNsDataEntries();
 
     BossTaskProperties current_props;
     std::map<std::string, BossTaskProperties> task_id_list;
+    /// NsData found in the SpotPass ext data, so that the polling titles are answered from memory
+    std::optional<std::vector<NsDataEntry>> ns_data_entries;
 
     u64 program_id;
     u64 extdata_id;
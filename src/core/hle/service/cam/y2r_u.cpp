@@ -7,7 +7,9 @@
 #include "common/archives.h"
 #include "common/common_funcs.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/process.h"
@@ -21,6 +23,10 @@ namespace Service::Y2R {
 
 template <class Archive>
 void Y2R_U::serialize(Archive& ar, const unsigned int) {
+    if constexpr (Archive::is_saving::value) {
+        // The completion event is saved with the timing events, but the output must be written
+        WaitForConversion();
+    }
     ar& boost::serialization::base_object<Kernel::SessionRequestHandler>(*this);
     ar& completion_event;
     ar& conversion;
@@ -30,6 +36,10 @@ void Y2R_U::serialize(Archive& ar, const unsigned int) {
     ar& spacial_dithering_enabled;
 }
 
+/// Emulated duration of a conversion per pixel. This estimates the hardware at about one pixel per
+/// ARM11 cycle, which gives the worker thread time to convert alongside the emulation.
+constexpr s64 CyclesPerPixel = 1;
+
 constexpr std::array<CoefficientSet, 4> standard_coefficients{{
     {{0x100, 0x166, 0xB6, 0x58, 0x1C5, -0x166F, 0x10EE, -0x1C5B}}, // ITU_Rec601
     {{0x100, 0x193, 0x77, 0x2F, 0x1DB, -0x1933, 0xA7C, -0x1D51}},  // ITU_Rec709
@@ -514,15 +524,34 @@ void Y2R_U::GetDitheringWeightParams(Kernel::HLERequestContext& ctx) {
 void Y2R_U::StartConversion(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx);
 
-    // dst_image_size would seem to be perfect for this, but it doesn't include the gap :(
-    u32 total_output_size =
-        conversion.input_lines * (conversion.dst.transfer_unit + conversion.dst.gap);
-    system.Memory().RasterizerFlushVirtualRegion(conversion.dst.address, total_output_size,
-                                                 Memory::FlushMode::FlushAndInvalidate);
+    // The previous conversion would be done by now on hardware
+    if (is_converting) {
+        system.CoreTiming().UnscheduleEvent(completion_event_callback, 0);
+        CompleteConversion(0, 0);
+    }
 
-    HW::Y2R::PerformConversion(system.Memory(), conversion);
+    // The host GPU converts straight into the cached texture, which is only written back to
+    // memory if the guest reads it
+    if (!Settings::values.gpu_y2r_conversion.GetValue() ||
+        !HW::Y2R::AccelerateConversion(system, conversion)) {
+        // dst_image_size would seem to be perfect for this, but it doesn't include the gap :(
+        u32 total_output_size =
+            conversion.input_lines * (conversion.dst.transfer_unit + conversion.dst.gap);
+        system.Memory().RasterizerFlushVirtualRegion(conversion.dst.address, total_output_size,
+                                                     Memory::FlushMode::FlushAndInvalidate);
+
+        // The conversion runs on the worker thread, and the transfer end event is signalled once
+        // it would have finished on hardware
+        std::packaged_task<void()> task{[&memory = system.Memory(), config = conversion] {
+            HW::Y2R::PerformConversion(memory, config);
+        }};
+        conversion_result = task.get_future();
+        conversion_worker.QueueWork(std::move(task));
+    }
+    is_converting = true;
 
-    completion_event->Signal();
+    const s64 num_pixels = conversion.input_line_width * conversion.input_lines;
+    system.CoreTiming().ScheduleEvent(num_pixels * CyclesPerPixel, completion_event_callback);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(ResultSuccess);
@@ -533,6 +562,12 @@ void Y2R_U::StartConversion(Kernel::HLERequestContext& ctx) {
 void Y2R_U::StopConversion(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx);
 
+    if (is_converting) {
+        system.CoreTiming().UnscheduleEvent(completion_event_callback, 0);
+        WaitForConversion();
+        is_converting = false;
+    }
+
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(ResultSuccess);
 
@@ -544,11 +579,23 @@ void Y2R_U::IsBusyConversion(Kernel::HLERequestContext& ctx) {
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
     rb.Push(ResultSuccess);
-    rb.Push<u8>(0); // StartConversion always finishes immediately
+    rb.Push<u8>(is_converting);
 
     LOG_DEBUG(Service_Y2R, "called");
 }
 
+void Y2R_U::CompleteConversion(std::uintptr_t user_data, s64 cycles_late) {
+    WaitForConversion();
+    is_converting = false;
+    completion_event->Signal();
+}
+
+void Y2R_U::WaitForConversion() {
+    if (conversion_result.valid()) {
+        conversion_result.get();
+    }
+}
+
 void Y2R_U::SetPackageParameter(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx);
     auto params = rp.PopRaw<ConversionParameters>();
@@ -697,9 +744,15 @@ Y2R_U::Y2R_U(Core::System& system) : ServiceFramework("y2r:u", 1), system(system
     RegisterHandlers(functions);
 
     completion_event = system.Kernel().CreateEvent(Kernel::ResetType::OneShot, "Y2R:Completed");
+    completion_event_callback = system.CoreTiming().RegisterEvent(
+        "Y2R::CompleteConversion", [this](std::uintptr_t user_data, s64 cycles_late) {
+            CompleteConversion(user_data, cycles_late);
+        });
 }
 
-Y2R_U::~Y2R_U() = default;
+Y2R_U::~Y2R_U() {
+    WaitForConversion();
+}
 
 void InstallInterfaces(Core::System& system) {
     auto& service_manager = system.ServiceManager();
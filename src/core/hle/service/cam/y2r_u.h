@@ -5,16 +5,19 @@
 #pragma once
 
 #include <array>
+#include <future>
 #include <memory>
 #include <string>
 #include <boost/serialization/array.hpp>
 #include "common/common_types.h"
+#include "common/thread_worker.h"
 #include "core/hle/result.h"
 #include "core/hle/service/service.h"
 
 namespace Core {
 class System;
-}
+struct TimingEventType;
+} // namespace Core
 
 namespace Kernel {
 class Event;
@@ -346,6 +349,12 @@ private:
     void DriverFinalize(Kernel::HLERequestContext& ctx);
     void GetPackageParameter(Kernel::HLERequestContext& ctx);
 
+    /// Completes the conversion once its emulated duration has passed.
+    void CompleteConversion(std::uintptr_t user_data, s64 cycles_late);
+
+    /// Waits for the worker thread to finish writing the output of the conversion.
+    void WaitForConversion();
+
     Core::System& system;
 
     std::shared_ptr<Kernel::Event> completion_event;
@@ -355,6 +364,12 @@ private:
     bool transfer_end_interrupt_enabled = false;
     bool spacial_dithering_enabled = false;
 
+    Core::TimingEventType* completion_event_callback;
+    /// Converts the images, so that the emulation goes on while a frame is converted
+    Common::ThreadWorker conversion_worker{1, "Y2R", Common::ThreadRole::Emulation};
+    std::future<void> conversion_result;
+    bool is_converting = false;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int);
     friend class boost::serialization::access;
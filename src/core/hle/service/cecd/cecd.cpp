@@ -72,9 +72,10 @@ void Module::Interface::Open(Kernel::HLERequestContext& ctx) {
     case CecDataPathType::MboxDir:
     case CecDataPathType::InboxDir:
     case CecDataPathType::OutboxDir: {
-        auto dir_result = cecd->cecd_system_save_data_archive->OpenDirectory(path);
-        if (dir_result.Failed()) {
+        const std::optional<u32> entry_count = cecd->GetCachedEntryCount(path);
+        if (!entry_count) {
             if (open_mode.create) {
+                cecd->InvalidateCache();
                 cecd->cecd_system_save_data_archive->CreateDirectory(path);
                 rb.Push(ResultSuccess);
             } else {
@@ -84,22 +85,18 @@ void Module::Interface::Open(Kernel::HLERequestContext& ctx) {
             }
             rb.Push<u32>(0); // Zero entries
         } else {
-            constexpr u32 max_entries = 32; // reasonable value, just over max boxes 24
-            auto directory = std::move(dir_result).Unwrap();
-
-            // Actual reading into vector seems to be required for entry count
-            std::vector<FileSys::Entry> entries(max_entries);
-            const u32 entry_count = directory->Read(max_entries, entries.data());
-
-            LOG_DEBUG(Service_CECD, "Number of entries found: {}", entry_count);
+            LOG_DEBUG(Service_CECD, "Number of entries found: {}", *entry_count);
 
             rb.Push(ResultSuccess);
-            rb.Push<u32>(entry_count); // Entry count
-            directory->Close();
+            rb.Push<u32>(*entry_count); // Entry count
         }
         break;
     }
     default: { // If not directory, then it is a file
+        // The file is created when it is missing
+        if (!cecd->cached_files.contains(path.AsString())) {
+            cecd->InvalidateCache();
+        }
         auto file_result = cecd->cecd_system_save_data_archive->OpenFile(path, mode);
         if (file_result.Failed()) {
             LOG_DEBUG(Service_CECD, "Failed to open file: {}", path.AsString());
@@ -116,6 +113,7 @@ void Module::Interface::Open(Kernel::HLERequestContext& ctx) {
             std::vector<u8> program_id(8);
             u64_le le_program_id = cecd->system.Kernel().GetCurrentProcess()->codeset->program_id;
             std::memcpy(program_id.data(), &le_program_id, sizeof(u64));
+            cecd->InvalidateCache();
             session_data->file->Write(0, sizeof(u64), true, program_id.data());
             session_data->file->Close();
         }
@@ -181,9 +179,6 @@ void Module::Interface::ReadMessage(Kernel::HLERequestContext& ctx) {
     auto& message_id_buffer = rp.PopMappedBuffer();
     auto& write_buffer = rp.PopMappedBuffer();
 
-    FileSys::Mode mode;
-    mode.read_flag.Assign(1);
-
     std::vector<u8> id_buffer(message_id_size);
     message_id_buffer.Read(id_buffer.data(), 0, message_id_size);
 
@@ -193,17 +188,15 @@ void Module::Interface::ReadMessage(Kernel::HLERequestContext& ctx) {
                                          ncch_program_id, id_buffer)
             .data();
 
-    auto message_result = cecd->cecd_system_save_data_archive->OpenFile(message_path, mode);
+    const std::vector<u8>* message = cecd->ReadCachedFile(message_path);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 4);
-    if (message_result.Succeeded()) {
-        auto message = std::move(message_result).Unwrap();
+    if (message) {
         std::vector<u8> buffer(buffer_size);
-
         const u32 bytes_read =
-            static_cast<u32>(message->Read(0, buffer_size, buffer.data()).Unwrap());
+            static_cast<u32>(std::min<std::size_t>(buffer_size, message->size()));
+        std::memcpy(buffer.data(), message->data(), bytes_read);
         write_buffer.Write(buffer.data(), 0, buffer_size);
-        message->Close();
 
         CecMessageHeader msg_header;
         std::memcpy(&msg_header, buffer.data(), sizeof(CecMessageHeader));
@@ -251,9 +244,6 @@ void Module::Interface::ReadMessageWithHMAC(Kernel::HLERequestContext& ctx) {
     auto& hmac_key_buffer = rp.PopMappedBuffer();
     auto& write_buffer = rp.PopMappedBuffer();
 
-    FileSys::Mode mode;
-    mode.read_flag.Assign(1);
-
     std::vector<u8> id_buffer(message_id_size);
     message_id_buffer.Read(id_buffer.data(), 0, message_id_size);
 
@@ -263,17 +253,15 @@ void Module::Interface::ReadMessageWithHMAC(Kernel::HLERequestContext& ctx) {
                                          ncch_program_id, id_buffer)
             .data();
 
-    auto message_result = cecd->cecd_system_save_data_archive->OpenFile(message_path, mode);
+    const std::vector<u8>* message = cecd->ReadCachedFile(message_path);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 6);
-    if (message_result.Succeeded()) {
-        auto message = std::move(message_result).Unwrap();
+    if (message) {
         std::vector<u8> buffer(buffer_size);
-
         const u32 bytes_read =
-            static_cast<u32>(message->Read(0, buffer_size, buffer.data()).Unwrap());
+            static_cast<u32>(std::min<std::size_t>(buffer_size, message->size()));
+        std::memcpy(buffer.data(), message->data(), bytes_read);
         write_buffer.Write(buffer.data(), 0, buffer_size);
-        message->Close();
 
         CecMessageHeader msg_header;
         std::memcpy(&msg_header, buffer.data(), sizeof(CecMessageHeader));
@@ -363,6 +351,7 @@ void Module::Interface::Write(Kernel::HLERequestContext& ctx) {
         std::vector<u8> buffer(read_buffer_size);
         read_buffer.Read(buffer.data(), 0, read_buffer_size);
 
+        cecd->InvalidateCache();
         if (session_data->file->GetSize() != read_buffer_size) {
             session_data->file->SetSize(read_buffer_size);
         }
@@ -405,6 +394,7 @@ void Module::Interface::WriteMessage(Kernel::HLERequestContext& ctx) {
                                          ncch_program_id, id_buffer)
             .data();
 
+    cecd->InvalidateCache();
     auto message_result = cecd->cecd_system_save_data_archive->OpenFile(message_path, mode);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 4);
@@ -476,6 +466,7 @@ void Module::Interface::WriteMessageWithHMAC(Kernel::HLERequestContext& ctx) {
                                          ncch_program_id, id_buffer)
             .data();
 
+    cecd->InvalidateCache();
     auto message_result = cecd->cecd_system_save_data_archive->OpenFile(message_path, mode);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 6);
@@ -553,6 +544,7 @@ void Module::Interface::Delete(Kernel::HLERequestContext& ctx) {
     FileSys::Mode mode;
     mode.write_flag.Assign(1);
 
+    cecd->InvalidateCache();
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     switch (path_type) {
     case CecDataPathType::RootDir:
@@ -599,6 +591,7 @@ void Module::Interface::SetData(Kernel::HLERequestContext& ctx) {
         mode.write_flag.Assign(1);
         mode.create_flag.Assign(1);
 
+        cecd->InvalidateCache();
         auto file_result = cecd->cecd_system_save_data_archive->OpenFile(path, mode);
         if (file_result.Succeeded()) {
             auto file = std::move(file_result).Unwrap();
@@ -749,6 +742,7 @@ void Module::Interface::OpenAndWrite(Kernel::HLERequestContext& ctx) {
                        ErrorLevel::Status));
         break;
     default: // If not directory, then it is a file
+        cecd->InvalidateCache();
         auto file_result = cecd->cecd_system_save_data_archive->OpenFile(path, mode);
         if (file_result.Succeeded()) {
             auto file = std::move(file_result).Unwrap();
@@ -795,8 +789,6 @@ void Module::Interface::OpenAndRead(Kernel::HLERequestContext& ctx) {
     auto& write_buffer = rp.PopMappedBuffer();
 
     FileSys::Path path(cecd->GetCecDataPathTypeAsString(path_type, ncch_program_id).data());
-    FileSys::Mode mode;
-    mode.read_flag.Assign(1);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
     switch (path_type) {
@@ -809,15 +801,12 @@ void Module::Interface::OpenAndRead(Kernel::HLERequestContext& ctx) {
         rb.Push<u32>(0); // No entries read
         break;
     default: // If not directory, then it is a file
-        auto file_result = cecd->cecd_system_save_data_archive->OpenFile(path, mode);
-        if (file_result.Succeeded()) {
-            auto file = std::move(file_result).Unwrap();
+        if (const std::vector<u8>* contents = cecd->ReadCachedFile(path)) {
             std::vector<u8> buffer(buffer_size);
-
             const u32 bytes_read =
-                static_cast<u32>(file->Read(0, buffer_size, buffer.data()).Unwrap());
+                static_cast<u32>(std::min<std::size_t>(buffer_size, contents->size()));
+            std::memcpy(buffer.data(), contents->data(), bytes_read);
             write_buffer.Write(buffer.data(), 0, buffer_size);
-            file->Close();
 
             rb.Push(ResultSuccess);
             rb.Push<u32>(bytes_read);
@@ -1388,6 +1377,65 @@ Module::SessionData::~SessionData() {
 Module::Interface::Interface(std::shared_ptr<Module> cecd, const char* name, u32 max_session)
     : ServiceFramework(name, max_session), cecd(std::move(cecd)) {}
 
+const std::vector<u8>* Module::ReadCachedFile(const FileSys::Path& path) {
+    std::string key = path.AsString();
+    if (const auto it = cached_files.find(key); it != cached_files.end()) {
+        return &it->second;
+    }
+
+    FileSys::Mode mode;
+    mode.read_flag.Assign(1);
+    auto file_result = cecd_system_save_data_archive->OpenFile(path, mode);
+    if (file_result.Failed()) {
+        return nullptr;
+    }
+    auto file = std::move(file_result).Unwrap();
+    std::vector<u8> contents(file->GetSize());
+    const auto read_result = file->Read(0, contents.size(), contents.data());
+    file->Close();
+    if (read_result.Failed()) {
+        return nullptr;
+    }
+    contents.resize(read_result.Unwrap());
+
+    // The boxes hold a few messages at most, this only bounds the memory of a corrupted save
+    constexpr std::size_t max_cached_files_size = 8 * 1024 * 1024;
+    if (cached_files_size + contents.size() > max_cached_files_size) {
+        cached_files.clear();
+        cached_files_size = 0;
+    }
+    cached_files_size += contents.size();
+    return &cached_files.emplace(std::move(key), std::move(contents)).first->second;
+}
+
+std::optional<u32> Module::GetCachedEntryCount(const FileSys::Path& path) {
+    std::string key = path.AsString();
+    if (const auto it = cached_entry_counts.find(key); it != cached_entry_counts.end()) {
+        return it->second;
+    }
+
+    auto dir_result = cecd_system_save_data_archive->OpenDirectory(path);
+    if (dir_result.Failed()) {
+        return std::nullopt;
+    }
+    constexpr u32 max_entries = 32; // reasonable value, just over max boxes 24
+    auto directory = std::move(dir_result).Unwrap();
+
+    // Actual reading into vector seems to be required for entry count
+    std::vector<FileSys::Entry> entries(max_entries);
+    const u32 entry_count = directory->Read(max_entries, entries.data());
+    directory->Close();
+
+    cached_entry_counts.emplace(std::move(key), entry_count);
+    return entry_count;
+}
+
+void Module::InvalidateCache() {
+    cached_files.clear();
+    cached_files_size = 0;
+    cached_entry_counts.clear();
+}
+
 Module::Module(Core::System& system) : system(system) {
     using namespace Kernel;
     cecinfo_event = system.Kernel().CreateEvent(Kernel::ResetType::OneShot, "CECD::cecinfo_event");
@@ -5,7 +5,11 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "common/bit_field.h"
 #include "common/common_funcs.h"
 #include "core/hle/kernel/event.h"
@@ -622,8 +626,27 @@ private:
     void CheckAndUpdateFile(const CecDataPathType path_type, const u32 ncch_program_id,
                             std::vector<u8>& file_buffer);
 
+    /**
+     * Returns the contents of a file of the save data. The file is only read on the first call,
+     * so that the titles polling their boxes are answered from memory.
+     * @returns Nullptr if the file could not be opened
+     */
+    const std::vector<u8>* ReadCachedFile(const FileSys::Path& path);
+
+    /// Returns the number of entries of a directory of the save data, listed on the first call only
+    std::optional<u32> GetCachedEntryCount(const FileSys::Path& path);
+
+    /// Drops the cached contents, to be called before modifying the save data
+    void InvalidateCache();
+
     std::unique_ptr<FileSys::ArchiveBackend> cecd_system_save_data_archive;
 
+    /// Contents of the files read from the save data, by path
+    std::unordered_map<std::string, std::vector<u8>> cached_files;
+    std::size_t cached_files_size = 0;
+    /// Entry counts of the directories listed from the save data, by path
+    std::unordered_map<std::string, u32> cached_entry_counts;
+
     std::shared_ptr<Kernel::Event> cecinfo_event;
     std::shared_ptr<Kernel::Event> cecinfosys_event;
     std::shared_ptr<Kernel::Event> change_state_event;
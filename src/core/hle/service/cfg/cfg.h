@@ -580,6 +580,14 @@ public:
      */
     void SaveMCUConfig();
 
+    /**
+     * Gets the config savegame memory buffer, which holds every config block
+     * @returns The contents of the config savegame
+     */
+    std::span<const u8> GetConfigSavegame() const {
+        return cfg_config_file_buffer;
+    }
+
 private:
     void UpdatePreferredRegionCode();
     SystemLanguage GetRawSystemLanguage();
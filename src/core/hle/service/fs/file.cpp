@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <boost/serialization/unique_ptr.hpp>
 #include "common/archives.h"
 #include "common/logging/log.h"
@@ -20,6 +23,27 @@ SERIALIZE_EXPORT_IMPL(Service::FS::FileSessionSlot)
 
 namespace Service::FS {
 
+/// Largest read the queued reads continuing each other are merged into
+constexpr std::size_t MaxMergedReadSize = 1024 * 1024;
+
+/// Read waiting for the I/O threads, possibly read along with earlier reads continuing it
+struct File::QueuedRead {
+    // Input
+    Kernel::MappedBuffer* buffer;
+    u64 offset;
+    u32 length;
+    std::chrono::steady_clock::time_point queued;
+
+    // Output
+    bool taken = false; ///< Whether the read is part of a run being read, guarded by the queue
+    std::promise<void> promise;
+    std::shared_future<void> done;
+    Result ret{0};
+    std::shared_ptr<std::vector<u8>> data;
+    std::size_t data_offset = 0;
+    std::size_t read_size = 0;
+};
+
 template <class Archive>
 void File::serialize(Archive& ar, const unsigned int) {
     ar& boost::serialization::base_object<Kernel::SessionRequestHandler>(*this);
@@ -75,17 +99,25 @@ void File::Read(Kernel::HLERequestContext& ctx) {
                   offset, length, backend->GetSize());
     }
 
-    // Conventional reading if the backend does not support cache.
-    if (!backend->AllowsCachedReads()) {
+    // Conventional reading if the backend does not support cache, or the data is cached already.
+    if (!backend->AllowsCachedReads() || backend->CacheReady(offset, length)) {
         auto& buffer = rp.PopMappedBuffer();
         IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-        std::unique_ptr<u8*> data = std::make_unique<u8*>(static_cast<u8*>(operator new(length)));
-        const auto read = backend->Read(offset, length, *data);
+
+        // Read straight into the guest buffer when it is contiguous in host memory
+        const std::span<u8> view = buffer.WriteSpan(0, length);
+        std::vector<u8> data;
+        if (view.empty()) {
+            data.resize(length);
+        }
+        const auto read = backend->Read(offset, length, view.empty() ? data.data() : view.data());
         if (read.Failed()) {
             rb.Push(read.Code());
             rb.Push<u32>(0);
         } else {
-            buffer.Write(*data, 0, *read);
+            if (view.empty()) {
+                buffer.Write(data.data(), 0, *read);
+            }
             rb.Push(ResultSuccess);
             rb.Push<u32>(static_cast<u32>(*read));
         }
@@ -96,73 +128,99 @@ void File::Read(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    struct AsyncData {
-        // Input
-        u32 length;
-        u64 offset;
-        std::chrono::steady_clock::time_point pre_timer;
-        bool cache_ready;
-
-        // Output
-        Result ret{0};
-        Kernel::MappedBuffer* buffer;
-        std::unique_ptr<u8*> data;
-        std::size_t read_size;
-    };
-
-    auto async_data = std::make_shared<AsyncData>();
-    async_data->buffer = &rp.PopMappedBuffer();
-    async_data->length = length;
-    async_data->offset = offset;
-    async_data->cache_ready = backend->CacheReady(offset, length);
-    if (!async_data->cache_ready) {
-        async_data->pre_timer = std::chrono::steady_clock::now();
+    auto read = std::make_shared<QueuedRead>();
+    read->buffer = &rp.PopMappedBuffer();
+    read->offset = offset;
+    read->length = length;
+    read->queued = std::chrono::steady_clock::now();
+    read->done = read->promise.get_future().share();
+    {
+        std::scoped_lock lock{queued_reads_mutex};
+        queued_reads.push_back(read);
     }
 
-    // LOG_DEBUG(Service_FS, "cache={}, offset={}, length={}", cache_ready, offset, length);
-    ctx.RunAsync(
-        [this, async_data](Kernel::HLERequestContext& ctx) {
-            async_data->data =
-                std::make_unique<u8*>(static_cast<u8*>(operator new(async_data->length)));
-            const auto read =
-                backend->Read(async_data->offset, async_data->length, *async_data->data);
-            if (read.Failed()) {
-                async_data->ret = read.Code();
-                async_data->read_size = 0;
-            } else {
-                async_data->ret = ResultSuccess;
-                async_data->read_size = *read;
-            }
-
-            const auto read_delay = static_cast<s64>(backend->GetReadDelayNs(async_data->length));
-            if (!async_data->cache_ready) {
-                const auto time_took = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                                           std::chrono::steady_clock::now() - async_data->pre_timer)
-                                           .count();
-                /*
-                if (time_took > read_delay) {
-                    LOG_DEBUG(Service_FS, "Took longer! length={}, time_took={}, read_delay={}",
-                              async_data->length, time_took, read_delay);
+    ctx.RunAsyncIO(
+        [this, read](Kernel::HLERequestContext& ctx) {
+            std::vector<std::shared_ptr<QueuedRead>> run;
+            {
+                std::scoped_lock lock{queued_reads_mutex};
+                // Otherwise the read was merged into an earlier one, which may still be running
+                if (!read->taken) {
+                    run = TakeReadRun(read);
                 }
-                */
-                return static_cast<s64>((read_delay > time_took) ? (read_delay - time_took) : 0);
-            } else {
-                return static_cast<s64>(read_delay);
             }
+            if (!run.empty()) {
+                ReadRun(run);
+            }
+            read->done.wait();
+
+            // The time spent waiting for the disk counts towards the emulated read delay
+            const auto read_delay = static_cast<s64>(backend->GetReadDelayNs(read->length));
+            const auto time_took = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - read->queued)
+                                       .count();
+            return static_cast<s64>((read_delay > time_took) ? (read_delay - time_took) : 0);
         },
-        [async_data](Kernel::HLERequestContext& ctx) {
+        [read](Kernel::HLERequestContext& ctx) {
             IPC::RequestBuilder rb(ctx, 0x0802, 2, 2);
-            if (async_data->ret.IsError()) {
-                rb.Push(async_data->ret);
+            if (read->ret.IsError()) {
+                rb.Push(read->ret);
                 rb.Push<u32>(0);
             } else {
-                async_data->buffer->Write(*async_data->data, 0, async_data->read_size);
+                read->buffer->Write(read->data->data() + read->data_offset, 0, read->read_size);
                 rb.Push(ResultSuccess);
-                rb.Push<u32>(static_cast<u32>(async_data->read_size));
+                rb.Push<u32>(static_cast<u32>(read->read_size));
             }
-            rb.PushMappedBuffer(*async_data->buffer);
-        },
-        !async_data->cache_ready);
+            rb.PushMappedBuffer(*read->buffer);
+        });
+}
+
+std::vector<std::shared_ptr<File::QueuedRead>> File::TakeReadRun(
+    std::shared_ptr<QueuedRead> first) {
+    std::vector<std::shared_ptr<QueuedRead>> run{first};
+    first->taken = true;
+    u64 run_end = first->offset + first->length;
+    std::size_t run_size = first->length;
+    // Titles streaming a file from several threads queue reads continuing each other
+    for (bool extended = true; extended;) {
+        extended = false;
+        for (const auto& read : queued_reads) {
+            if (!read->taken && read->offset == run_end &&
+                run_size + read->length <= MaxMergedReadSize) {
+                read->taken = true;
+                run.push_back(read);
+                run_end += read->length;
+                run_size += read->length;
+                extended = true;
+            }
+        }
+    }
+    std::erase_if(queued_reads, [](const auto& read) { return read->taken; });
+    return run;
+}
+
+void File::ReadRun(std::span<const std::shared_ptr<QueuedRead>> run) {
+    const u64 run_offset = run.front()->offset;
+    const u64 run_size = run.back()->offset + run.back()->length - run_offset;
+    auto data = std::make_shared<std::vector<u8>>(run_size);
+    const auto read = backend->Read(run_offset, run_size, data->data());
+    if (run.size() > 1) {
+        LOG_TRACE(Service_FS, "Merged {} reads: offset=0x{:x} length=0x{:x}", run.size(),
+                  run_offset, run_size);
+    }
+    for (const auto& queued : run) {
+        if (read.Failed()) {
+            queued->ret = read.Code();
+            queued->read_size = 0;
+        } else {
+            queued->ret = ResultSuccess;
+            queued->data = data;
+            queued->data_offset = queued->offset - run_offset;
+            queued->read_size =
+                std::min<std::size_t>(queued->length, *read - std::min(*read, queued->data_offset));
+        }
+        queued->promise.set_value();
+    }
 }
 
 void File::Write(Kernel::HLERequestContext& ctx) {
@@ -186,9 +244,15 @@ void File::Write(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    std::vector<u8> data(length);
-    buffer.Read(data.data(), 0, data.size());
-    ResultVal<std::size_t> written = backend->Write(offset, data.size(), flush != 0, data.data());
+    // Write straight from the guest buffer when it is contiguous in host memory
+    const std::span<const u8> view = buffer.ReadSpan(0, length);
+    std::vector<u8> data;
+    if (view.empty()) {
+        data.resize(length);
+        buffer.Read(data.data(), 0, data.size());
+    }
+    ResultVal<std::size_t> written =
+        backend->Write(offset, length, flush != 0, view.empty() ? data.data() : view.data());
 
     // Update file size
     file->size = backend->GetSize();
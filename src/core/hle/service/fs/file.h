@@ -5,6 +5,9 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
 #include <boost/serialization/base_object.hpp>
 #include "core/file_sys/archive_backend.h"
 #include "core/global.h"
@@ -73,8 +76,23 @@ private:
     void OpenLinkFile(Kernel::HLERequestContext& ctx);
     void OpenSubFile(Kernel::HLERequestContext& ctx);
 
+    struct QueuedRead;
+
+    /**
+     * Takes a queued read along with the queued reads continuing it, so that they are read from
+     * the backend at once. Must be called with the queued reads locked.
+     */
+    std::vector<std::shared_ptr<QueuedRead>> TakeReadRun(std::shared_ptr<QueuedRead> first);
+
+    /// Reads a run of contiguous queued reads from the backend and completes them.
+    void ReadRun(std::span<const std::shared_ptr<QueuedRead>> run);
+
     Kernel::KernelSystem& kernel;
 
+    /// Uncached reads waiting for the I/O threads
+    std::mutex queued_reads_mutex;
+    std::vector<std::shared_ptr<QueuedRead>> queued_reads;
+
     File(Kernel::KernelSystem& kernel);
     File();
 
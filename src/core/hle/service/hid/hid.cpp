@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <utility>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/unique_ptr.hpp>
@@ -168,6 +169,30 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
     // Compute bitmask with 1s for bits different from the old state
     PadState changed = {{(state.hex ^ old_state.hex)}};
 
+    // The input latency is measured from the earliest host event received since the previous
+    // update, among the inputs that changed. Analog inputs jitter without changing the pad.
+    const Input::Clock::time_point now = Input::Clock::now();
+    Input::Clock::time_point earliest_change = now;
+    const auto add_change = [&](Input::Clock::time_point change_time) {
+        if (change_time > last_pad_update) {
+            earliest_change = std::min(earliest_change, change_time);
+        }
+    };
+    for (std::size_t i = 0; i < buttons.size(); i++) {
+        const bool status = buttons[i]->GetStatus();
+        if (std::exchange(last_button_status[i], status) != status) {
+            add_change(buttons[i]->GetChangeTime());
+        }
+    }
+    const PadDataEntry& old_entry = mem->pad.entries[last_entry_index];
+    if (circle_pad_x != old_entry.circle_pad_x || circle_pad_y != old_entry.circle_pad_y) {
+        add_change(circle_pad->GetChangeTime());
+    }
+    last_pad_update = now;
+    if (changed.hex != 0 && system.perf_stats) {
+        system.perf_stats->RecordInputSample(now - earliest_change);
+    }
+
     // Get the current Pad entry
     PadDataEntry& pad_entry = mem->pad.entries[mem->pad.index];
 
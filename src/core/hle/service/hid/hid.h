@@ -335,6 +335,11 @@ private:
     std::vector<s16> circle_pad_old_x = std::vector<s16>(CIRCLE_PAD_AVERAGING - 1, 0);
     std::vector<s16> circle_pad_old_y = std::vector<s16>(CIRCLE_PAD_AVERAGING - 1, 0);
 
+    /// Host time of the previous pad update, the input events received after it are new
+    Input::Clock::time_point last_pad_update{};
+    /// Status of the buttons at the previous pad update
+    std::array<bool, Settings::NativeButton::NUM_BUTTONS_HID> last_button_status{};
+
     u32 next_pad_index = 0;
     u32 next_touch_index = 0;
     u32 next_accelerometer_index = 0;
@@ -179,7 +179,26 @@ static std::size_t HandleHeaderWrite(std::vector<Context::RequestHeader>& pendin
     return WriteHeaders(strm, final_headers);
 };
 
-void Context::MakeRequest() {
+std::unique_ptr<httplib::ClientImpl> ClientPool::Acquire(const Key& key) {
+    std::scoped_lock lock{mutex};
+    const auto it = idle_clients.find(key);
+    if (it == idle_clients.end() || it->second.empty()) {
+        return nullptr;
+    }
+    auto client = std::move(it->second.back());
+    it->second.pop_back();
+    return client;
+}
+
+void ClientPool::Release(const Key& key, std::unique_ptr<httplib::ClientImpl> client) {
+    std::scoped_lock lock{mutex};
+    auto& clients = idle_clients[key];
+    if (clients.size() < MaxIdlePerHost) {
+        clients.push_back(std::move(client));
+    }
+}
+
+void Context::MakeRequest(ClientPool& client_pool) {
     ASSERT(state == RequestState::NotStarted);
 
     static const std::unordered_map<RequestMethod, std::string> request_method_strings{
@@ -220,37 +239,50 @@ void Context::MakeRequest() {
 
     state = RequestState::InProgress;
 
-    if (url_info.is_https) {
-        MakeRequestSSL(request, url_info, pending_headers);
-    } else {
-        MakeRequestNonSSL(request, url_info, pending_headers);
-    }
-}
+    // Clients with a certificate of the application are not shared, the certificate context may be
+    // closed or reused for another certificate at any time.
+    const bool has_own_client_cert =
+        url_info.is_https && !uses_default_client_cert && !ssl_config.client_cert_ctx.expired();
+    const ClientPool::Key key{url_info.is_https, url_info.host, url_info.port,
+                              url_info.is_https && uses_default_client_cert};
 
-void Context::MakeRequestNonSSL(httplib::Request& request, const URLInfo& url_info,
-                                std::vector<Context::RequestHeader>& pending_headers) {
-    httplib::Error error{-1};
-    std::unique_ptr<httplib::Client> client =
-        std::make_unique<httplib::Client>(url_info.host, url_info.port);
+    std::unique_ptr<httplib::ClientImpl> client;
+    if (!has_own_client_cert) {
+        client = client_pool.Acquire(key);
+    }
+    if (!client) {
+        client = url_info.is_https ? MakeClientSSL(url_info) : MakeClientNonSSL(url_info);
+        client->set_keep_alive(!has_own_client_cert);
+    }
 
     client->set_header_writer(
         [&pending_headers](httplib::Stream& strm, httplib::Headers& httplib_headers) {
             return HandleHeaderWrite(pending_headers, strm, httplib_headers);
         });
 
+    httplib::Error error{-1};
     if (!client->send(request, response, error)) {
         LOG_ERROR(Service_HTTP, "Request failed: {}: {}", error, httplib::to_string(error));
         state = RequestState::TimedOut;
-    } else {
-        LOG_DEBUG(Service_HTTP, "Request successful");
-        // TODO(B3N30): Verify this state on HW
-        state = RequestState::ReadyToDownloadContent;
+        return;
+    }
+
+    LOG_DEBUG(Service_HTTP, "Request successful");
+    // TODO(B3N30): Verify this state on HW
+    state = RequestState::ReadyToDownloadContent;
+
+    if (!has_own_client_cert) {
+        // The header writer refers to the headers of this request
+        client->set_header_writer(httplib::detail::write_headers);
+        client_pool.Release(key, std::move(client));
     }
 }
 
-void Context::MakeRequestSSL(httplib::Request& request, const URLInfo& url_info,
-                             std::vector<Context::RequestHeader>& pending_headers) {
-    httplib::Error error{-1};
+std::unique_ptr<httplib::ClientImpl> Context::MakeClientNonSSL(const URLInfo& url_info) {
+    return std::make_unique<httplib::ClientImpl>(url_info.host, url_info.port);
+}
+
+std::unique_ptr<httplib::ClientImpl> Context::MakeClientSSL(const URLInfo& url_info) {
     X509* cert = nullptr;
     EVP_PKEY* key = nullptr;
     const unsigned char* cert_data = nullptr;
@@ -292,19 +324,14 @@ void Context::MakeRequestSSL(httplib::Request& request, const URLInfo& url_info,
     // Hack: Since for now RootCerts are not implemented we set the VerifyMode to None.
     client->enable_server_certificate_verification(false);
 
-    client->set_header_writer(
-        [&pending_headers](httplib::Stream& strm, httplib::Headers& httplib_headers) {
-            return HandleHeaderWrite(pending_headers, strm, httplib_headers);
-        });
+    return client;
+}
 
-    if (!client->send(request, response, error)) {
-        LOG_ERROR(Service_HTTP, "Request failed: {}: {}", error, httplib::to_string(error));
-        state = RequestState::TimedOut;
-    } else {
-        LOG_DEBUG(Service_HTTP, "Request successful");
-        // TODO(B3N30): Verify this state on HW
-        state = RequestState::ReadyToDownloadContent;
-    }
+void HTTP_C::QueueRequest(Context& http_context) {
+    std::packaged_task<void()> task{
+        [this, &http_context] { http_context.MakeRequest(client_pool); }};
+    http_context.request_future = task.get_future();
+    request_workers.QueueWork(std::move(task));
 }
 
 void HTTP_C::Initialize(Kernel::HLERequestContext& ctx) {
@@ -397,10 +424,9 @@ void HTTP_C::BeginRequest(Kernel::HLERequestContext& ctx) {
     // trying to enqueue any more will either fail (BeginRequestAsync), or block (BeginRequest)
     // Note that you only can have 8 Contexts at a time. So this difference shouldn't matter
     // Then there are 3? worker threads that pop the requests from the queue and send them
-    // For now make every request async in it's own thread.
-
-    http_context.request_future =
-        std::async(std::launch::async, &Context::MakeRequest, std::ref(http_context));
+    // We queue the requests on a pool of workers with a worker per context, so that a request
+    // never waits behind long downloads.
+    QueueRequest(http_context);
     http_context.current_copied_data = 0;
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -432,10 +458,9 @@ void HTTP_C::BeginRequestAsync(Kernel::HLERequestContext& ctx) {
     // trying to enqueue any more will either fail (BeginRequestAsync), or block (BeginRequest)
     // Note that you only can have 8 Contexts at a time. So this difference shouldn't matter
     // Then there are 3? worker threads that pop the requests from the queue and send them
-    // For now make every request async in it's own thread.
-
-    http_context.request_future =
-        std::async(std::launch::async, &Context::MakeRequest, std::ref(http_context));
+    // We queue the requests on a pool of workers with a worker per context, so that a request
+    // never waits behind long downloads.
+    QueueRequest(http_context);
     http_context.current_copied_data = 0;
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1355,7 +1380,12 @@ void HTTP_C::DecryptClCertA() {
     ClCertA.init = true;
 }
 
-HTTP_C::HTTP_C() : ServiceFramework("http:C", 32) {
+/// Requests sent at the same time, as many as the HTTP contexts a session can have open
+constexpr std::size_t NumRequestWorkers = 8;
+
+HTTP_C::HTTP_C()
+    : ServiceFramework("http:C", 32),
+      request_workers{NumRequestWorkers, "HTTP request", Common::ThreadRole::Background} {
     static const FunctionInfo functions[] = {
         // clang-format off
         {0x0001, &HTTP_C::Initialize, "Initialize"},
@@ -5,7 +5,9 @@
 #pragma once
 
 #include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -21,6 +23,7 @@
 #include <ifaddrs.h>
 #endif
 #include <httplib.h>
+#include "common/thread_worker.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/service/service.h"
@@ -68,6 +71,37 @@ struct URLInfo {
     std::string path;
 };
 
+/**
+ * Keeps the clients of finished requests with their connection open, so that the next request to
+ * the same host reuses it instead of connecting and doing a TLS handshake again. A client is only
+ * used by one request at a time: it is taken out of the pool while the request runs.
+ */
+class ClientPool final {
+public:
+    struct Key {
+        bool is_https;
+        std::string host;
+        int port;
+        /// Whether the client authenticates with the default client certificate (ClCertA)
+        bool default_client_cert;
+
+        auto operator<=>(const Key&) const = default;
+    };
+
+    /// Takes an idle client connected to the host out of the pool, or returns nullptr.
+    std::unique_ptr<httplib::ClientImpl> Acquire(const Key& key);
+
+    /// Puts a client back into the pool once its request is done.
+    void Release(const Key& key, std::unique_ptr<httplib::ClientImpl> client);
+
+private:
+    /// Idle clients kept per host, the ones beyond it are closed
+    static constexpr std::size_t MaxIdlePerHost = 4;
+
+    std::mutex mutex;
+    std::map<Key, std::vector<std::unique_ptr<httplib::ClientImpl>>> idle_clients;
+};
+
 /// Represents a client certificate along with its private key, stored as a byte array of DER data.
 /// There can only be at most one client certificate context attached to an HTTP context at any
 /// given time.
@@ -221,11 +255,9 @@ public:
     bool uses_default_client_cert{};
     httplib::Response response;
 
-    void MakeRequest();
-    void MakeRequestNonSSL(httplib::Request& request, const URLInfo& url_info,
-                           std::vector<Context::RequestHeader>& pending_headers);
-    void MakeRequestSSL(httplib::Request& request, const URLInfo& url_info,
-                        std::vector<Context::RequestHeader>& pending_headers);
+    void MakeRequest(ClientPool& client_pool);
+    std::unique_ptr<httplib::ClientImpl> MakeClientNonSSL(const URLInfo& url_info);
+    std::unique_ptr<httplib::ClientImpl> MakeClientSSL(const URLInfo& url_info);
 };
 
 struct SessionData : public Kernel::SessionRequestHandler::SessionDataBase {
@@ -622,6 +654,15 @@ private:
 
     ClCertAData ClCertA;
 
+    /// Starts a request of a context on the request workers.
+    void QueueRequest(Context& http_context);
+
+    ClientPool client_pool;
+
+    /// Sends the requests, like the few HTTP worker threads of the 3DS. Declared last, so that the
+    /// requests still running finish before the contexts and the clients are destroyed.
+    Common::ThreadWorker request_workers;
+
 private:
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
@@ -21,6 +22,52 @@ static constexpr Result CROFormatError(u32 description) {
                   ErrorSummary::WrongArgument, ErrorLevel::Permanent);
 }
 
+namespace {
+
+/**
+ * Collects the words patched by a run of relocations and invalidates the instruction cache for
+ * them once it goes out of scope. Relocation tables mostly patch consecutive words, so merging
+ * them saves one invalidation of every core per relocation.
+ */
+class RelocationInvalidator {
+public:
+    explicit RelocationInvalidator(Core::System& system_,
+                                   std::vector<std::pair<VAddr, u32>>* patched_ranges_)
+        : system{system_}, patched_ranges{patched_ranges_} {}
+
+    ~RelocationInvalidator() {
+        Flush();
+    }
+
+    void Add(VAddr address) {
+        if (size != 0 && address >= start && address <= start + size) {
+            size = std::max<u32>(size, address + sizeof(u32) - start);
+            return;
+        }
+        Flush();
+        start = address;
+        size = sizeof(u32);
+    }
+
+private:
+    void Flush() {
+        if (size != 0) {
+            system.InvalidateCacheRange(start, size);
+            if (patched_ranges) {
+                patched_ranges->emplace_back(start, size);
+            }
+            size = 0;
+        }
+    }
+
+    Core::System& system;
+    std::vector<std::pair<VAddr, u32>>* patched_ranges;
+    VAddr start{};
+    u32 size{};
+};
+
+} // Anonymous namespace
+
 const std::array<int, 17> CROHelper::ENTRY_SIZE{{
     1, // code
     1, // data
@@ -72,11 +119,9 @@ Result CROHelper::ApplyRelocation(VAddr target_address, RelocationType relocatio
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
         system.Memory().Write32(target_address, symbol_address + addend);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::RelativeAddress:
         system.Memory().Write32(target_address, symbol_address + addend - target_future_address);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -99,7 +144,6 @@ Result CROHelper::ClearRelocation(VAddr target_address, RelocationType relocatio
     case RelocationType::AbsoluteAddress2:
     case RelocationType::RelativeAddress:
         system.Memory().Write32(target_address, 0);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -118,6 +162,7 @@ Result CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool res
     if (symbol_address == 0 && !reset)
         return CROFormatError(0x10);
 
+    RelocationInvalidator invalidator{system, patched_ranges};
     VAddr relocation_address = batch;
     while (true) {
         RelocationEntry relocation;
@@ -129,6 +174,7 @@ Result CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool res
             return CROFormatError(0x12);
         }
 
+        invalidator.Add(relocation_target);
         Result result = ApplyRelocation(relocation_target, relocation.type, relocation.addend,
                                         symbol_address, relocation_target);
         if (result.IsError()) {
@@ -482,6 +528,7 @@ Result CROHelper::ResetExternalRelocations() {
         return CROFormatError(0x12);
     }
 
+    RelocationInvalidator invalidator{system, patched_ranges};
     bool batch_begin = true;
     for (u32 i = 0; i < external_relocation_num; ++i) {
         GetEntry(system.Memory(), i, relocation);
@@ -491,6 +538,7 @@ Result CROHelper::ResetExternalRelocations() {
             return CROFormatError(0x12);
         }
 
+        invalidator.Add(relocation_target);
         Result result = ApplyRelocation(relocation_target, relocation.type, relocation.addend,
                                         unresolved_symbol, relocation_target);
         if (result.IsError()) {
@@ -515,6 +563,7 @@ Result CROHelper::ClearExternalRelocations() {
     u32 external_relocation_num = GetField(ExternalRelocationNum);
     ExternalRelocationEntry relocation;
 
+    RelocationInvalidator invalidator{system, patched_ranges};
     bool batch_begin = true;
     for (u32 i = 0; i < external_relocation_num; ++i) {
         GetEntry(system.Memory(), i, relocation);
@@ -524,6 +573,7 @@ Result CROHelper::ClearExternalRelocations() {
             return CROFormatError(0x12);
         }
 
+        invalidator.Add(relocation_target);
         Result result = ClearRelocation(relocation_target, relocation.type);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error clearing relocation {:08X}", result.raw);
@@ -578,6 +628,7 @@ Result CROHelper::ApplyStaticAnonymousSymbolToCRS(VAddr crs_address) {
 Result CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
     u32 segment_num = GetField(SegmentNum);
     u32 internal_relocation_num = GetField(InternalRelocationNum);
+    RelocationInvalidator invalidator{system, patched_ranges};
     for (u32 i = 0; i < internal_relocation_num; ++i) {
         InternalRelocationEntry relocation;
         GetEntry(system.Memory(), i, relocation);
@@ -606,6 +657,7 @@ Result CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
         GetEntry(system.Memory(), relocation.symbol_segment, symbol_segment);
         LOG_TRACE(Service_LDR, "Internally relocates 0x{:08X} with 0x{:08X}", target_address,
                   symbol_segment.offset);
+        invalidator.Add(target_address);
         Result result = ApplyRelocation(target_address, relocation.type, relocation.addend,
                                         symbol_segment.offset, target_addressB);
         if (result.IsError()) {
@@ -618,6 +670,7 @@ Result CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
 
 Result CROHelper::ClearInternalRelocations() {
     u32 internal_relocation_num = GetField(InternalRelocationNum);
+    RelocationInvalidator invalidator{system, patched_ranges};
     for (u32 i = 0; i < internal_relocation_num; ++i) {
         InternalRelocationEntry relocation;
         GetEntry(system.Memory(), i, relocation);
@@ -627,6 +680,7 @@ Result CROHelper::ClearInternalRelocations() {
             return CROFormatError(0x15);
         }
 
+        invalidator.Add(target_address);
         Result result = ClearRelocation(target_address, relocation.type);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error clearing relocation {:08X}", result.raw);
@@ -1122,6 +1176,19 @@ static Result VerifyStringTableLength(Memory::MemorySystem& memory, VAddr addres
 Result CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment_addresss,
                          u32 data_segment_size, VAddr bss_segment_address, u32 bss_segment_size,
                          bool is_crs) {
+    Result result = RebaseImage(cro_size, data_segment_addresss, data_segment_size,
+                                bss_segment_address, bss_segment_size, is_crs);
+    if (result.IsError() || is_crs) {
+        return result;
+    }
+    return RebaseImports(crs_address);
+}
+
+Result CROHelper::RebaseImage(u32 cro_size, VAddr data_segment_addresss, u32 data_segment_size,
+                              VAddr bss_segment_address, u32 bss_segment_size, bool is_crs,
+                              std::vector<std::pair<VAddr, u32>>* patched_ranges_) {
+    patched_ranges = patched_ranges_;
+    SCOPE_EXIT({ patched_ranges = nullptr; });
 
     Result result = RebaseHeader(cro_size);
     if (result.IsError()) {
@@ -1203,26 +1270,28 @@ Result CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment_add
         return result;
     }
 
-    if (!is_crs) {
-        result = ApplyStaticAnonymousSymbolToCRS(crs_address);
-        if (result.IsError()) {
-            LOG_ERROR(Service_LDR, "Error applying offset export to CRS {:08X}", result.raw);
-            return result;
-        }
-    }
-
     result = ApplyInternalRelocations(prev_data_segment_address);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error applying internal relocations {:08X}", result.raw);
         return result;
     }
 
-    if (!is_crs) {
-        result = ApplyExitRelocations(crs_address);
-        if (result.IsError()) {
-            LOG_ERROR(Service_LDR, "Error applying exit relocations {:08X}", result.raw);
-            return result;
-        }
+    return ResultSuccess;
+}
+
+Result CROHelper::RebaseImports(VAddr crs_address) {
+    // Internal relocations never patch the static module nor the imported symbols, so these can
+    // run after them
+    Result result = ApplyStaticAnonymousSymbolToCRS(crs_address);
+    if (result.IsError()) {
+        LOG_ERROR(Service_LDR, "Error applying offset export to CRS {:08X}", result.raw);
+        return result;
+    }
+
+    result = ApplyExitRelocations(crs_address);
+    if (result.IsError()) {
+        LOG_ERROR(Service_LDR, "Error applying exit relocations {:08X}", result.raw);
+        return result;
     }
 
     return ResultSuccess;
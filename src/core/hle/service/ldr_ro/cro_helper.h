@@ -6,6 +6,8 @@
 
 #include <array>
 #include <tuple>
+#include <utility>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
@@ -57,6 +59,26 @@ public:
                   u32 data_segment_size, VAddr bss_segment_address, u32 bss_segment_size,
                   bool is_crs);
 
+    /**
+     * Runs the steps of Rebase that only depend on the module data and the buffer addresses,
+     * leaving out the ones importing from the other modules. Their result can be cached and
+     * restored in place of running them again.
+     * @param patched_ranges if not null, receives the (address, size) of the ranges patched by
+     *                       relocations, which can lie outside of the module
+     * @returns Result ResultSuccess on success, otherwise error code.
+     */
+    Result RebaseImage(u32 cro_size, VAddr data_segment_address, u32 data_segment_size,
+                       VAddr bss_segment_address, u32 bss_segment_size, bool is_crs,
+                       std::vector<std::pair<VAddr, u32>>* patched_ranges = nullptr);
+
+    /**
+     * Runs the steps of Rebase left out by RebaseImage, which export to the static module and
+     * import the exit function from the auto-link modules.
+     * @param crs_address the virtual address of the static module
+     * @returns Result ResultSuccess on success, otherwise error code.
+     */
+    Result RebaseImports(VAddr crs_address);
+
     /**
      * Unrebases the module.
      * @param is_crs true if the module itself is the static module
@@ -142,6 +164,8 @@ private:
     const VAddr module_address; ///< the virtual address of this module
     Kernel::Process& process;   ///< the owner process of this module
     Core::System& system;
+    /// Receives the ranges patched by relocations while RebaseImage runs
+    std::vector<std::pair<VAddr, u32>>* patched_ranges = nullptr;
 
     /**
      * Each item in this enum represents a u32 field in the header begin from address+0x80,
@@ -492,6 +516,7 @@ private:
      * @param target_future_address the future address of the target.
      *        Usually equals to target_address, but will be different for a target in .data segment
      * @returns Result ResultSuccess on success, otherwise error code.
+     * @note The caller must invalidate the instruction cache for the patched word.
      */
     Result ApplyRelocation(VAddr target_address, RelocationType relocation_type, u32 addend,
                            u32 symbol_address, u32 target_future_address);
@@ -501,6 +526,7 @@ private:
      * @param target_address where to apply the relocation
      * @param relocation_type the type of the relocation
      * @returns Result ResultSuccess on success, otherwise error code.
+     * @note The caller must invalidate the instruction cache for the patched word.
      */
     Result ClearRelocation(VAddr target_address, RelocationType relocation_type);
 
@@ -2,12 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <limits>
 #include "common/alignment.h"
 #include "common/archives.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
+#include "core/guest_profiler.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/service/ldr_ro/cro_helper.h"
@@ -19,6 +23,9 @@ SERIALIZE_EXPORT_IMPL(Service::LDR::ClientSlot)
 
 namespace Service::LDR {
 
+/// Bytes of rebased modules kept to load the same modules again
+constexpr std::size_t MAX_REBASED_IMAGES_SIZE = 64 * 1024 * 1024;
+
 static const Result ERROR_ALREADY_INITIALIZED = // 0xD9612FF9
     Result(ErrorDescription::AlreadyInitialized, ErrorModule::RO, ErrorSummary::Internal,
            ErrorLevel::Permanent);
@@ -273,8 +280,9 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
         return;
     }
 
-    result = cro.Rebase(slot->loaded_crs, cro_size, data_segment_address, data_segment_size,
-                        bss_segment_address, bss_segment_size, false);
+    result = RebaseCRO(cro, *process, slot->loaded_crs, cro_address, cro_size,
+                       data_segment_address, data_segment_size, bss_segment_address,
+                       bss_segment_size);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error rebasing CRO {:08X}", result.raw);
         process->Unmap(cro_address, cro_buffer_ptr, cro_size, Kernel::VMAPermission::ReadWrite,
@@ -327,6 +335,10 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
 
     system.InvalidateCacheRange(cro_address, cro_size);
 
+    if (auto profiler = system.GetGuestProfiler()) {
+        profiler->RegisterModule(process->process_id, cro.ModuleName(), cro_address, fix_size);
+    }
+
     LOG_INFO(Service_LDR, "CRO \"{}\" loaded at 0x{:08X}, fixed_end=0x{:08X}", cro.ModuleName(),
              cro_address, cro_address + fix_size);
 
@@ -400,6 +412,10 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
 
     system.InvalidateCacheRange(cro_address, fixed_size);
 
+    if (auto profiler = system.GetGuestProfiler()) {
+        profiler->UnregisterModule(process->process_id, cro_address);
+    }
+
     rb.Push(result);
 }
 
@@ -514,6 +530,68 @@ void RO::Shutdown(Kernel::HLERequestContext& ctx) {
     rb.Push(result);
 }
 
+Result RO::RebaseCRO(CROHelper& cro, Kernel::Process& process, VAddr crs_address,
+                     VAddr cro_address, u32 cro_size, VAddr data_segment_address,
+                     u32 data_segment_size, VAddr bss_segment_address, u32 bss_segment_size) {
+    auto& memory = system.Memory();
+    std::vector<u8> image(cro_size);
+    memory.ReadBlock(process, cro_address, image.data(), image.size());
+
+    // Rebasing only depends on the module data and where its buffers are
+    u64 key = Common::ComputeHash64(image.data(), image.size());
+    for (const u32 value : {cro_address, cro_size, data_segment_address, data_segment_size,
+                            bss_segment_address, bss_segment_size}) {
+        key = Common::HashCombine(key, value);
+    }
+
+    if (const auto it = rebased_images.find(key); it != rebased_images.end()) {
+        const RebasedImage& rebased = it->second;
+        memory.WriteBlock(process, cro_address, rebased.image.data(), rebased.image.size());
+        // The module itself is invalidated once loaded
+        VAddr patches_begin = std::numeric_limits<VAddr>::max();
+        VAddr patches_end = 0;
+        for (const auto& [address, data] : rebased.patches) {
+            memory.WriteBlock(process, address, data.data(), data.size());
+            patches_begin = std::min(patches_begin, address);
+            patches_end = std::max<VAddr>(patches_end, address + static_cast<u32>(data.size()));
+        }
+        if (patches_begin < patches_end) {
+            system.InvalidateCacheRange(patches_begin, patches_end - patches_begin);
+        }
+        LOG_DEBUG(Service_LDR, "Restored rebased CRO at 0x{:08X}", cro_address);
+        return cro.RebaseImports(crs_address);
+    }
+
+    std::vector<std::pair<VAddr, u32>> patched_ranges;
+    Result result = cro.RebaseImage(cro_size, data_segment_address, data_segment_size,
+                                    bss_segment_address, bss_segment_size, false, &patched_ranges);
+    if (result.IsError()) {
+        return result;
+    }
+
+    RebasedImage rebased{.image = std::move(image)};
+    memory.ReadBlock(process, cro_address, rebased.image.data(), rebased.image.size());
+    std::size_t size = rebased.image.size();
+    for (const auto& [address, range_size] : patched_ranges) {
+        if (address >= cro_address && address + range_size <= cro_address + cro_size) {
+            continue;
+        }
+        auto& [patch_address, data] = rebased.patches.emplace_back(address, range_size);
+        memory.ReadBlock(process, patch_address, data.data(), data.size());
+        size += data.size();
+    }
+    if (rebased_images_size + size > MAX_REBASED_IMAGES_SIZE) {
+        rebased_images.clear();
+        rebased_images_size = 0;
+    }
+    if (size <= MAX_REBASED_IMAGES_SIZE) {
+        rebased_images.emplace(key, std::move(rebased));
+        rebased_images_size += size;
+    }
+
+    return cro.RebaseImports(crs_address);
+}
+
 RO::RO(Core::System& system) : ServiceFramework("ldr:ro", 2), system(system) {
     static const FunctionInfo functions[] = {
         // clang-format off
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "core/hle/service/service.h"
 
 namespace Core {
@@ -12,6 +15,8 @@ class System;
 
 namespace Service::LDR {
 
+class CROHelper;
+
 struct ClientSlot : public Kernel::SessionRequestHandler::SessionDataBase {
     VAddr loaded_crs = 0; ///< the virtual address of the static module
 
@@ -159,7 +164,24 @@ private:
      */
     void Shutdown(Kernel::HLERequestContext& self);
 
+    /// Module data after CROHelper::RebaseImage, with the ranges it patched outside of the module
+    struct RebasedImage {
+        std::vector<u8> image;
+        std::vector<std::pair<VAddr, std::vector<u8>>> patches;
+    };
+
+    /**
+     * Rebases a newly mapped CRO. Titles often unload and load the same modules again on scene
+     * transitions, so the rebased module is cached by its data and buffer addresses, and restored
+     * with a few block copies instead of resolving every relocation again.
+     */
+    Result RebaseCRO(CROHelper& cro, Kernel::Process& process, VAddr crs_address,
+                     VAddr cro_address, u32 cro_size, VAddr data_segment_address,
+                     u32 data_segment_size, VAddr bss_segment_address, u32 bss_segment_size);
+
     Core::System& system;
+    std::unordered_map<u64, RebasedImage> rebased_images;
+    std::size_t rebased_images_size = 0;
 
 private:
     template <class Archive>
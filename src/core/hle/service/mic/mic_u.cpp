@@ -180,7 +180,7 @@ struct MIC_U::Impl {
             CreateMic();
         }
 
-        AudioCore::Samples samples = mic->Read();
+        mic->Read(samples);
         if (!samples.empty()) {
             // write the samples to sharedmem page
             state.WriteSamples(samples);
@@ -392,6 +392,8 @@ struct MIC_U::Impl {
     bool allow_shell_closed = false;
     bool clamp = false;
     std::unique_ptr<AudioCore::Input> mic;
+    /// Samples read from the mic on each buffer update, kept so that its storage is reused
+    AudioCore::Samples samples;
     Core::System& system;
     Core::Timing& timing;
     State state{};
@@ -0,0 +1,203 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include "common/dynamic_library/ffmpeg.h"
+#include "common/logging/log.h"
+#include "core/hle/service/mvd/mvd_decoder.h"
+
+namespace Service::MVD {
+
+namespace FFmpeg = DynamicLibrary::FFmpeg;
+
+constexpr std::array<u8, 4> StartCode{0, 0, 0, 1};
+
+/// Returns whether the data begins with a three or four byte Annex B start code.
+static bool HasStartCode(std::span<const u8> data) {
+    if (data.size() >= 3 && data[0] == 0 && data[1] == 0 && data[2] == 1) {
+        return true;
+    }
+    return data.size() >= 4 && data[0] == 0 && data[1] == 0 && data[2] == 0 && data[3] == 1;
+}
+
+/// Copies the lines of a plane into a tightly packed buffer.
+static void CopyPlane(const u8* source, int linesize, u32 width, u32 height, u8* dest) {
+    for (u32 y = 0; y < height; y++) {
+        std::memcpy(dest + y * width, source + y * linesize, width);
+    }
+}
+
+struct H264Decoder::Impl {
+    Impl() {
+        if (!FFmpeg::LoadFFmpeg()) {
+            LOG_ERROR(Service_MVD, "FFmpeg could not be loaded, videos will not be decoded");
+            return;
+        }
+
+        const AVCodec* codec = FFmpeg::avcodec_find_decoder(AV_CODEC_ID_H264);
+        if (!codec) {
+            LOG_ERROR(Service_MVD, "FFmpeg has no H.264 decoder");
+            return;
+        }
+        context = FFmpeg::avcodec_alloc_context3(codec);
+        if (!context) {
+            LOG_ERROR(Service_MVD, "Could not allocate the H.264 decoder context");
+            return;
+        }
+
+        // Each NAL unit is answered on its own, so pictures must come out as soon as possible
+        context->flags |= AV_CODEC_FLAG_LOW_DELAY;
+        context->thread_type = FF_THREAD_SLICE;
+        InitHardwareDevice(codec);
+
+        if (FFmpeg::avcodec_open2(context, codec, nullptr) < 0) {
+            LOG_ERROR(Service_MVD, "Could not open the H.264 decoder");
+            FFmpeg::avcodec_free_context(&context);
+            FFmpeg::av_buffer_unref(&hw_device);
+            return;
+        }
+        packet = FFmpeg::av_packet_alloc();
+        frame = FFmpeg::av_frame_alloc();
+        sw_frame = FFmpeg::av_frame_alloc();
+    }
+
+    ~Impl() {
+        if (!context) {
+            return;
+        }
+        FFmpeg::av_frame_free(&sw_frame);
+        FFmpeg::av_frame_free(&frame);
+        FFmpeg::av_packet_free(&packet);
+        FFmpeg::avcodec_free_context(&context);
+        FFmpeg::av_buffer_unref(&hw_device);
+    }
+
+    /// Attaches the first hardware device able to decode H.264. Without one, the decoder falls
+    /// back to software decoding.
+    void InitHardwareDevice(const AVCodec* codec) {
+        for (int i = 0;; i++) {
+            const AVCodecHWConfig* config = FFmpeg::avcodec_get_hw_config(codec, i);
+            if (!config) {
+                LOG_INFO(Service_MVD, "No hardware H.264 decoder available, decoding on the CPU");
+                return;
+            }
+            if (!(config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) ||
+                FFmpeg::av_hwdevice_ctx_create(&hw_device, config->device_type, nullptr, nullptr,
+                                               0) < 0) {
+                continue;
+            }
+
+            context->hw_device_ctx = FFmpeg::av_buffer_ref(hw_device);
+            hw_pixel_format = config->pix_fmt;
+            LOG_INFO(Service_MVD, "Decoding H.264 on the {} hardware decoder",
+                     FFmpeg::av_get_pix_fmt_name(config->pix_fmt));
+            return;
+        }
+    }
+
+    bool Decode(std::span<const u8> nal_unit) {
+        if (!context) {
+            return false;
+        }
+
+        // The decoder reads an Annex B stream, padded as FFmpeg requires
+        data.clear();
+        if (!HasStartCode(nal_unit)) {
+            data.insert(data.end(), StartCode.begin(), StartCode.end());
+        }
+        data.insert(data.end(), nal_unit.begin(), nal_unit.end());
+        const std::size_t size = data.size();
+        data.resize(size + AV_INPUT_BUFFER_PADDING_SIZE);
+
+        packet->data = data.data();
+        packet->size = static_cast<int>(size);
+        if (FFmpeg::avcodec_send_packet(context, packet) < 0) {
+            LOG_ERROR(Service_MVD, "Could not decode a NAL unit of {} bytes", nal_unit.size());
+            return false;
+        }
+
+        bool decoded = false;
+        while (FFmpeg::avcodec_receive_frame(context, frame) >= 0) {
+            decoded |= CopyPicture();
+            FFmpeg::av_frame_unref(frame);
+        }
+        return decoded;
+    }
+
+    /// Copies the decoded frame to the picture, downloading it from the hardware decoder first.
+    bool CopyPicture() {
+        const AVFrame* source = frame;
+        if (frame->format == hw_pixel_format) {
+            FFmpeg::av_frame_unref(sw_frame);
+            if (FFmpeg::av_hwframe_transfer_data(sw_frame, frame, 0) < 0) {
+                LOG_ERROR(Service_MVD, "Could not download a picture from the hardware decoder");
+                return false;
+            }
+            source = sw_frame;
+        }
+
+        const u32 width = static_cast<u32>(source->width);
+        const u32 height = static_cast<u32>(source->height);
+        const u32 chroma_width = (width + 1) / 2;
+        const u32 chroma_height = (height + 1) / 2;
+        picture.width = width;
+        picture.height = height;
+        picture.y.resize(width * height);
+        picture.u.resize(chroma_width * chroma_height);
+        picture.v.resize(chroma_width * chroma_height);
+
+        CopyPlane(source->data[0], source->linesize[0], width, height, picture.y.data());
+        switch (source->format) {
+        case AV_PIX_FMT_YUV420P:
+        case AV_PIX_FMT_YUVJ420P:
+            CopyPlane(source->data[1], source->linesize[1], chroma_width, chroma_height,
+                      picture.u.data());
+            CopyPlane(source->data[2], source->linesize[2], chroma_width, chroma_height,
+                      picture.v.data());
+            return true;
+        case AV_PIX_FMT_NV12:
+            for (u32 y = 0; y < chroma_height; y++) {
+                const u8* line = source->data[1] + y * source->linesize[1];
+                for (u32 x = 0; x < chroma_width; x++) {
+                    picture.u[y * chroma_width + x] = line[x * 2];
+                    picture.v[y * chroma_width + x] = line[x * 2 + 1];
+                }
+            }
+            return true;
+        default:
+            LOG_ERROR(Service_MVD, "Unsupported decoded pixel format {}",
+                      FFmpeg::av_get_pix_fmt_name(static_cast<AVPixelFormat>(source->format)));
+            return false;
+        }
+    }
+
+    AVCodecContext* context = nullptr;
+    AVBufferRef* hw_device = nullptr;
+    AVPixelFormat hw_pixel_format = AV_PIX_FMT_NONE;
+    AVPacket* packet = nullptr;
+    AVFrame* frame = nullptr;
+    AVFrame* sw_frame = nullptr;
+    std::vector<u8> data;
+    Picture picture;
+};
+
+H264Decoder::H264Decoder() : impl{std::make_unique<Impl>()} {}
+
+H264Decoder::~H264Decoder() = default;
+
+bool H264Decoder::IsValid() const {
+    return impl->context != nullptr;
+}
+
+bool H264Decoder::Decode(std::span<const u8> nal_unit) {
+    return impl->Decode(nal_unit);
+}
+
+const Picture& H264Decoder::GetPicture() const {
+    return impl->picture;
+}
+
+} // namespace Service::MVD
@@ -0,0 +1,50 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Service::MVD {
+
+/// A decoded picture, as 8-bit Y, U and V planes with 4:2:0 subsampling
+struct Picture {
+    u32 width = 0;
+    u32 height = 0;
+    std::vector<u8> y;
+    std::vector<u8> u; ///< (width + 1) / 2 samples per line
+    std::vector<u8> v; ///< (width + 1) / 2 samples per line
+};
+
+/**
+ * Decodes H.264 NAL units with FFmpeg, on a hardware decoder when the host has one. The decoded
+ * pictures are copied to host memory, so that they can be converted to the layout requested by
+ * the guest.
+ */
+class H264Decoder {
+public:
+    H264Decoder();
+    ~H264Decoder();
+
+    /// Returns false if FFmpeg could not be loaded or has no H.264 decoder.
+    bool IsValid() const;
+
+    /**
+     * Decodes a NAL unit, with or without its Annex B start code.
+     * @returns Whether a new picture was decoded, in which case it replaces the previous one.
+     */
+    bool Decode(std::span<const u8> nal_unit);
+
+    /// Returns the last decoded picture.
+    const Picture& GetPicture() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace Service::MVD
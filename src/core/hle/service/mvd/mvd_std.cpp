@@ -2,33 +2,366 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+#include <boost/serialization/binary_object.hpp>
 #include "common/archives.h"
+#include "common/logging/log.h"
+#include "core/core.h"
 #include "core/hle/ipc_helpers.h"
+#include "core/hle/service/mvd/mvd_decoder.h"
 #include "core/hle/service/mvd/mvd_std.h"
+#include "core/memory.h"
+#include "video_core/gpu.h"
 
+SERVICE_CONSTRUCT_IMPL(Service::MVD::MVD_STD)
 SERIALIZE_EXPORT_IMPL(Service::MVD::MVD_STD)
 
 namespace Service::MVD {
 
-MVD_STD::MVD_STD() : ServiceFramework("mvd:std", 1) {
+// Statuses of the decoder, returned as the result of ProcessNALUnit
+constexpr Result StatusOk{0x17000};
+constexpr Result StatusParamSet{0x17001};
+constexpr Result StatusFrameReady{0x17003};
+
+constexpr u32 WorkBufSize = 0x9006C8;
+
+constexpr u8 NalUnitTypeSPS = 7;
+constexpr u8 NalUnitTypePPS = 8;
+
+/// Returns the type of a NAL unit, skipping its Annex B start code if it has one.
+static u8 GetNalUnitType(std::span<const u8> nal_unit) {
+    std::size_t offset = 0;
+    while (offset < nal_unit.size() && nal_unit[offset] == 0) {
+        offset++;
+    }
+    if (offset >= 2 && offset + 1 < nal_unit.size() && nal_unit[offset] == 1) {
+        offset++;
+    } else {
+        offset = 0;
+    }
+    return offset < nal_unit.size() ? nal_unit[offset] & 0x1F : 0;
+}
+
+/// Converts a BT.601 limited range color to 8-bit RGB.
+static std::array<u8, 3> YUVToRGB(u8 y, u8 u, u8 v) {
+    const int c = 298 * (y - 16);
+    const int d = u - 128;
+    const int e = v - 128;
+    return {
+        static_cast<u8>(std::clamp((c + 409 * e + 128) >> 8, 0, 255)),
+        static_cast<u8>(std::clamp((c - 100 * d - 208 * e + 128) >> 8, 0, 255)),
+        static_cast<u8>(std::clamp((c + 516 * d + 128) >> 8, 0, 255)),
+    };
+}
+
+template <class Archive>
+void MVD_STD::serialize(Archive& ar, const unsigned int) {
+    if constexpr (Archive::is_saving::value) {
+        // The client threads waiting on the worker are woken up by it, so it must be done
+        worker.WaitForRequests();
+    }
+    ar& boost::serialization::base_object<Kernel::SessionRequestHandler>(*this);
+    ar& boost::serialization::make_binary_object(&config, sizeof(config));
+    ar& initialized;
+    // The decoder state is not saved, a loaded stream resumes at its next parameter sets
+}
+
+void MVD_STD::Initialize(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+    const u32 workbuf_addr = rp.Pop<u32>();
+    const u32 workbuf_size = rp.Pop<u32>();
+    rp.PopPID();
+
+    worker.WaitForRequests();
+    decoder = std::make_unique<H264Decoder>();
+    initialized = true;
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
+    rb.Push(ResultSuccess);
+
+    LOG_DEBUG(Service_MVD, "called, workbuf_addr=0x{:08X}, workbuf_size=0x{:X}", workbuf_addr,
+              workbuf_size);
+}
+
+void MVD_STD::Shutdown(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+
+    worker.WaitForRequests();
+    decoder.reset();
+    initialized = false;
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
+    rb.Push(ResultSuccess);
+
+    LOG_DEBUG(Service_MVD, "called");
+}
+
+void MVD_STD::CalculateWorkBufSize(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+    rp.Skip(12, false);
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
+    rb.Push(ResultSuccess);
+    rb.Push(WorkBufSize);
+
+    LOG_DEBUG(Service_MVD, "called");
+}
+
+void MVD_STD::ProcessNALUnit(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+    const u32 vaddr = rp.Pop<u32>();
+    const u32 paddr = rp.Pop<u32>();
+    const u32 size = rp.Pop<u32>();
+    [[maybe_unused]] const u32 frame_id = rp.Pop<u32>();
+    [[maybe_unused]] const u8 flag = rp.Pop<u8>();
+    rp.PopPID();
+
+    LOG_TRACE(Service_MVD, "called, paddr=0x{:08X}, size=0x{:X}, frame_id={}, flag={}", paddr,
+              size, frame_id, flag);
+
+    const auto respond = [vaddr, paddr, size](std::shared_ptr<Result> status) {
+        return [vaddr, paddr, size, status](Kernel::HLERequestContext& ctx) {
+            IPC::RequestBuilder rb(ctx, 0x08, 4, 0);
+            rb.Push(*status);
+            rb.Push(vaddr + size);
+            rb.Push(paddr + size);
+            rb.Push<u32>(0);
+        };
+    };
+
+    auto& memory = system.Memory();
+    if (!memory.IsValidPhysicalAddress(paddr) || !memory.IsValidPhysicalAddress(paddr + size)) {
+        LOG_ERROR(Service_MVD, "Invalid NAL unit at 0x{:08X} with size 0x{:X}", paddr, size);
+        respond(std::make_shared<Result>(StatusOk))(ctx);
+        return;
+    }
+    if (!decoder) {
+        // Loaded from a savestate, the decoder was not saved
+        decoder = std::make_unique<H264Decoder>();
+    }
+
+    // The NAL unit is copied here, so that the worker never touches emulated memory
+    const u8* data = memory.GetPhysicalRef(paddr).GetPtr();
+    std::vector<u8> nal_unit(data, data + size);
+
+    auto status = std::make_shared<Result>(StatusOk);
+    worker.QueueWork([this, nal_unit = std::move(nal_unit), status,
+                      wake_up = ctx.SleepUntilCompleted(respond(status))] {
+        const u8 type = GetNalUnitType(nal_unit);
+        if (decoder->Decode(nal_unit)) {
+            *status = StatusFrameReady;
+        } else if (type == NalUnitTypeSPS || type == NalUnitTypePPS) {
+            *status = StatusParamSet;
+        }
+        wake_up();
+    });
+}
+
+void MVD_STD::ControlFrameRendering(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+    const s8 control = rp.PopRaw<s8>();
+    rp.PopPID();
+
+    LOG_TRACE(Service_MVD, "called, control={}", control);
+
+    if (control != 0 || !decoder) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
+        rb.Push(ResultSuccess);
+        return;
+    }
+
+    auto output = std::make_shared<std::vector<u8>>();
+    const auto respond = [this, output, paddr = config.physaddr_outdata0](
+                             Kernel::HLERequestContext& ctx) {
+        const u32 size = static_cast<u32>(output->size());
+        auto& memory = system.Memory();
+        if (size != 0 && memory.IsValidPhysicalAddress(paddr) &&
+            memory.IsValidPhysicalAddress(paddr + size - 1)) {
+            // Write over the cached surfaces of the buffer, the guest may display it as a texture
+            system.GPU().FlushAndInvalidateRegion(paddr, size);
+            std::memcpy(memory.GetPhysicalPointer(paddr), output->data(), size);
+        } else if (size != 0) {
+            LOG_ERROR(Service_MVD, "Invalid output buffer at 0x{:08X} with size 0x{:X}", paddr,
+                      size);
+        }
+
+        IPC::RequestBuilder rb(ctx, 0x09, 1, 0);
+        rb.Push(ResultSuccess);
+    };
+
+    worker.QueueWork(
+        [this, output, render_config = config, wake_up = ctx.SleepUntilCompleted(respond)] {
+            *output = RenderPicture(render_config);
+            wake_up();
+        });
+}
+
+void MVD_STD::GetStatus(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
+    rb.Push(ResultSuccess);
+    // Requests only complete once the worker is done with them
+    rb.Push<u32>(0);
+
+    LOG_DEBUG(Service_MVD, "called");
+}
+
+void MVD_STD::GetConfig(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+    const u32 size = rp.Pop<u32>();
+    rp.PopPID();
+    auto& buffer = rp.PopMappedBuffer();
+
+    buffer.Write(&config, 0, std::min<std::size_t>({size, sizeof(config), buffer.GetSize()}));
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+    rb.Push(ResultSuccess);
+    rb.PushMappedBuffer(buffer);
+
+    LOG_DEBUG(Service_MVD, "called, size=0x{:X}", size);
+}
+
+void MVD_STD::SetConfig(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+    const u32 size = rp.Pop<u32>();
+    rp.PopPID();
+    auto& buffer = rp.PopMappedBuffer();
+
+    buffer.Read(&config, 0, std::min<std::size_t>({size, sizeof(config), buffer.GetSize()}));
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+    rb.Push(ResultSuccess);
+    rb.PushMappedBuffer(buffer);
+
+    LOG_DEBUG(Service_MVD,
+              "called, input_type=0x{:08X}, output_type=0x{:08X}, outwidth={}, outheight={}",
+              static_cast<u32>(config.input_type), static_cast<u32>(config.output_type),
+              config.outwidth, config.outheight);
+}
+
+void MVD_STD::SetOutputBuffer(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+    const u32 size = rp.Pop<u32>();
+    rp.PopPID();
+    auto& buffer = rp.PopMappedBuffer();
+
+    // The pictures are rendered to the output buffers of the configuration
+    IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+    rb.Push(ResultSuccess);
+    rb.PushMappedBuffer(buffer);
+
+    LOG_WARNING(Service_MVD, "(STUBBED) called, size=0x{:X}", size);
+}
+
+void MVD_STD::OverrideOutputBuffers(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx);
+    const u32 cur_outdata0 = rp.Pop<u32>();
+    const u32 cur_outdata1 = rp.Pop<u32>();
+    const u32 new_outdata0 = rp.Pop<u32>();
+    const u32 new_outdata1 = rp.Pop<u32>();
+
+    if (config.physaddr_outdata0 == cur_outdata0) {
+        config.physaddr_outdata0 = new_outdata0;
+    }
+    if (config.physaddr_outdata1 == cur_outdata1) {
+        config.physaddr_outdata1 = new_outdata1;
+    }
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
+    rb.Push(ResultSuccess);
+
+    LOG_DEBUG(Service_MVD, "called, new_outdata0=0x{:08X}, new_outdata1=0x{:08X}", new_outdata0,
+              new_outdata1);
+}
+
+std::vector<u8> MVD_STD::RenderPicture(const Config& render_config) const {
+    const Picture& picture = decoder->GetPicture();
+    const u32 width = render_config.outwidth;
+    const u32 height = render_config.outheight;
+    std::vector<u8> output(static_cast<std::size_t>(width) * height * 2);
+    if (picture.width == 0) {
+        return output;
+    }
+
+    u32 src_x = 0;
+    u32 src_y = 0;
+    if (render_config.enable_cropping) {
+        src_x = render_config.crop_x;
+        src_y = render_config.crop_y;
+    }
+    const u32 chroma_stride = (picture.width + 1) / 2;
+    const auto sample = [&](u32 x, u32 y) -> std::array<u8, 3> {
+        x += src_x;
+        y += src_y;
+        if (x >= picture.width || y >= picture.height) {
+            return {16, 128, 128};
+        }
+        const std::size_t chroma = (y / 2) * chroma_stride + x / 2;
+        return {picture.y[y * picture.width + x], picture.u[chroma], picture.v[chroma]};
+    };
+
+    u8* dest = output.data();
+    switch (render_config.output_type) {
+    case OutputFormat::YUYV422:
+        for (u32 y = 0; y < height; y++) {
+            for (u32 x = 0; x + 1 < width; x += 2) {
+                const auto [y0, u, v] = sample(x, y);
+                const u8 y1 = sample(x + 1, y)[0];
+                *dest++ = y0;
+                *dest++ = u;
+                *dest++ = y1;
+                *dest++ = v;
+            }
+        }
+        break;
+    case OutputFormat::RGB565:
+    case OutputFormat::BGR565: {
+        const bool swap = render_config.output_type == OutputFormat::BGR565;
+        for (u32 y = 0; y < height; y++) {
+            for (u32 x = 0; x < width; x++) {
+                const auto [luma, u, v] = sample(x, y);
+                auto [r, g, b] = YUVToRGB(luma, u, v);
+                if (swap) {
+                    std::swap(r, b);
+                }
+                const u16 pixel = static_cast<u16>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+                std::memcpy(dest, &pixel, sizeof(pixel));
+                dest += sizeof(pixel);
+            }
+        }
+        break;
+    }
+    default:
+        LOG_ERROR(Service_MVD, "Unimplemented output format 0x{:08X}",
+                  static_cast<u32>(render_config.output_type));
+        return {};
+    }
+    return output;
+}
+
+MVD_STD::MVD_STD(Core::System& system) : ServiceFramework("mvd:std", 1), system(system) {
     static const FunctionInfo functions[] = {
         // clang-format off
-        {0x0001, nullptr, "Initialize"},
-        {0x0002, nullptr, "Shutdown"},
-        {0x0003, nullptr, "CalculateWorkBufSize"},
+        {0x0001, &MVD_STD::Initialize, "Initialize"},
+        {0x0002, &MVD_STD::Shutdown, "Shutdown"},
+        {0x0003, &MVD_STD::CalculateWorkBufSize, "CalculateWorkBufSize"},
         {0x0004, nullptr, "CalculateImageSize"},
-        {0x0008, nullptr, "ProcessNALUnit"},
-        {0x0009, nullptr, "ControlFrameRendering"},
-        {0x000A, nullptr, "GetStatus"},
+        {0x0008, &MVD_STD::ProcessNALUnit, "ProcessNALUnit"},
+        {0x0009, &MVD_STD::ControlFrameRendering, "ControlFrameRendering"},
+        {0x000A, &MVD_STD::GetStatus, "GetStatus"},
         {0x000B, nullptr, "GetStatusOther"},
-        {0x001D, nullptr, "GetConfig"},
-        {0x001E, nullptr, "SetConfig"},
-        {0x001F, nullptr, "SetOutputBuffer"},
-        {0x0021, nullptr, "OverrideOutputBuffers"}
+        {0x001D, &MVD_STD::GetConfig, "GetConfig"},
+        {0x001E, &MVD_STD::SetConfig, "SetConfig"},
+        {0x001F, &MVD_STD::SetOutputBuffer, "SetOutputBuffer"},
+        {0x0021, &MVD_STD::OverrideOutputBuffers, "OverrideOutputBuffers"}
         // clang-format on
     };
 
     RegisterHandlers(functions);
-};
+}
+
+MVD_STD::~MVD_STD() = default;
 
 } // namespace Service::MVD
@@ -4,19 +4,188 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+#include "common/common_funcs.h"
+#include "common/thread_worker.h"
 #include "core/hle/service/service.h"
 
+namespace Core {
+class System;
+}
+
 namespace Service::MVD {
 
+class H264Decoder;
+
 class MVD_STD final : public ServiceFramework<MVD_STD> {
 public:
-    MVD_STD();
-    ~MVD_STD() = default;
+    explicit MVD_STD(Core::System& system);
+    ~MVD_STD();
+
+    enum class InputFormat : u32 {
+        YUYV422 = 0x00010001,
+        H264 = 0x00020001,
+    };
+
+    enum class OutputFormat : u32 {
+        YUYV422 = 0x00010001,
+        BGR565 = 0x00040002,
+        RGB565 = 0x00040004,
+    };
+
+    struct Config {
+        InputFormat input_type;
+        INSERT_PADDING_WORDS(2);
+        u32 inwidth;
+        u32 inheight;
+        u32 physaddr_colorconv_indata;
+        INSERT_PADDING_WORDS(10);
+        u32 enable_cropping;
+        u32 crop_x;
+        u32 crop_y;
+        u32 crop_height;
+        u32 crop_width;
+        INSERT_PADDING_WORDS(1);
+        OutputFormat output_type;
+        u32 outwidth;
+        u32 outheight;
+        u32 physaddr_outdata0;
+        u32 physaddr_outdata1;
+        INSERT_PADDING_WORDS(0x2C);
+    };
+    static_assert(sizeof(Config) == 0x11C, "Config structure size is wrong");
 
 private:
-    SERVICE_SERIALIZATION_SIMPLE
+    /**
+     * MVD_STD::Initialize service function
+     *  Inputs:
+     *      1 : Physical address of the work buffer
+     *      2 : Size of the work buffer
+     *      3-4 : ProcessId descriptor
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     */
+    void Initialize(Kernel::HLERequestContext& ctx);
+
+    /**
+     * MVD_STD::Shutdown service function
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     */
+    void Shutdown(Kernel::HLERequestContext& ctx);
+
+    /**
+     * MVD_STD::CalculateWorkBufSize service function
+     *  Inputs:
+     *      1-12 : Work buffer parameters
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     *      2 : Size of the work buffer
+     */
+    void CalculateWorkBufSize(Kernel::HLERequestContext& ctx);
+
+    /**
+     * MVD_STD::ProcessNALUnit service function
+     * The NAL unit is decoded on a worker thread while the client thread sleeps.
+     *  Inputs:
+     *      1 : Virtual address of the NAL unit
+     *      2 : Physical address of the NAL unit
+     *      3 : Size of the NAL unit
+     *      4 : Frame id
+     *      5 : Flag
+     *      6-7 : ProcessId descriptor
+     *  Outputs:
+     *      1 : Status of the decoder, as a result code
+     *      2 : Virtual address of the end of the NAL unit
+     *      3 : Physical address of the end of the NAL unit
+     *      4 : Unknown, always 0
+     */
+    void ProcessNALUnit(Kernel::HLERequestContext& ctx);
+
+    /**
+     * MVD_STD::ControlFrameRendering service function
+     * Renders the last decoded picture to the output buffer, in the output format.
+     *  Inputs:
+     *      1 : Control type, 0 to render the picture
+     *      2-3 : ProcessId descriptor
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     */
+    void ControlFrameRendering(Kernel::HLERequestContext& ctx);
+
+    /**
+     * MVD_STD::GetStatus service function
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     *      2 : Whether the decoder is busy
+     */
+    void GetStatus(Kernel::HLERequestContext& ctx);
+
+    /**
+     * MVD_STD::GetConfig service function
+     *  Inputs:
+     *      1 : Size of the configuration
+     *      2-3 : ProcessId descriptor
+     *      4-5 : Buffer descriptor of the configuration to write
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     */
+    void GetConfig(Kernel::HLERequestContext& ctx);
+
+    /**
+     * MVD_STD::SetConfig service function
+     *  Inputs:
+     *      1 : Size of the configuration
+     *      2-3 : ProcessId descriptor
+     *      4-5 : Buffer descriptor of the configuration to read
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     */
+    void SetConfig(Kernel::HLERequestContext& ctx);
+
+    /**
+     * MVD_STD::SetOutputBuffer service function
+     *  Inputs:
+     *      1 : Size of the output buffer list
+     *      2-3 : ProcessId descriptor
+     *      4-5 : Buffer descriptor of the output buffer list
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     */
+    void SetOutputBuffer(Kernel::HLERequestContext& ctx);
+
+    /**
+     * MVD_STD::OverrideOutputBuffers service function
+     *  Inputs:
+     *      1 : Physical address of the current luma output buffer
+     *      2 : Physical address of the current chroma output buffer
+     *      3 : Physical address of the new luma output buffer
+     *      4 : Physical address of the new chroma output buffer
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     */
+    void OverrideOutputBuffers(Kernel::HLERequestContext& ctx);
+
+    /// Converts the last decoded picture to the output format. Runs on the worker thread.
+    std::vector<u8> RenderPicture(const Config& render_config) const;
+
+    Core::System& system;
+
+    Config config{};
+    bool initialized = false;
+
+    /// Only used by the worker thread once a request was queued
+    std::unique_ptr<H264Decoder> decoder;
+    /// Decodes and converts the pictures, so that the emulation goes on meanwhile
+    Common::ThreadWorker worker{1, "MVD", Common::ThreadRole::Emulation};
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int);
+    friend class boost::serialization::access;
 };
 
 } // namespace Service::MVD
 
+SERVICE_CONSTRUCT(Service::MVD::MVD_STD)
 BOOST_CLASS_EXPORT_KEY(Service::MVD::MVD_STD)
@@ -72,14 +72,33 @@ std::list<Network::WifiPacket> NWM_UDS::GetReceivedBeacons(const MacAddress& sen
     return std::move(received_beacons);
 }
 
+/**
+ * Returns whether a frame has to reach the room. Beacons are repeated every ~100 ms and
+ * application data is lossy on real hardware as well, so a late one is better dropped than
+ * allowed to hold up the frames after it. Connection management frames, including EAPoL, have to
+ * arrive.
+ */
+static bool IsReliableFrame(const Network::WifiPacket& packet) {
+    switch (packet.type) {
+    case Network::WifiPacket::PacketType::Beacon:
+        return false;
+    case Network::WifiPacket::PacketType::Data:
+        return packet.data.size() < sizeof(LLCHeader) ||
+               GetFrameEtherType(packet.data) != EtherType::SecureData;
+    default:
+        return true;
+    }
+}
+
 /// Sends a WifiPacket to the room we're currently connected to.
-void SendPacket(Network::WifiPacket& packet) {
+void SendPacket(Network::WifiPacket packet) {
     if (auto room_member = Network::GetRoomMember().lock()) {
         if (room_member->GetState() == Network::RoomMember::State::Joined ||
             room_member->GetState() == Network::RoomMember::State::Moderator) {
 
             packet.transmitter_address = room_member->GetMacAddress();
-            room_member->SendWifiPacket(packet);
+            const bool reliable = IsReliableFrame(packet);
+            room_member->SendWifiPacket(std::move(packet), reliable);
         }
     }
 }
@@ -354,7 +373,7 @@ void NWM_UDS::HandleSecureDataPacket(const Network::WifiPacket& packet) {
             // multicast? Perhaps this is a way to allow spectators to see some of the packets.
             Network::WifiPacket out_packet = packet;
             out_packet.destination_address = Network::BroadcastMac;
-            SendPacket(out_packet);
+            SendPacket(std::move(out_packet));
         }
         return;
     }
@@ -1163,7 +1182,7 @@ void NWM_UDS::SendTo(Kernel::HLERequestContext& ctx) {
     packet.data = std::move(data_payload);
     packet.type = Network::WifiPacket::PacketType::Data;
 
-    SendPacket(packet);
+    SendPacket(std::move(packet));
 
     rb.Push(ResultSuccess);
 }
@@ -1450,7 +1469,7 @@ void NWM_UDS::BeaconBroadcastCallback(std::uintptr_t user_data, s64 cycles_late)
     packet.destination_address = Network::BroadcastMac;
     packet.channel = network_channel;
 
-    SendPacket(packet);
+    SendPacket(std::move(packet));
 
     // Start broadcasting the network, send a beacon frame every 102.4ms.
     system.CoreTiming().ScheduleEvent(msToCycles(DefaultBeaconInterval * MillisecondsPerTU) -
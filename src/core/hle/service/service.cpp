@@ -3,13 +3,16 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/core.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/handle_table.h"
+#include "core/hle/kernel/ipc_debugger/profiler.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/server_port.h"
 #include "core/hle/kernel/server_session.h"
@@ -125,7 +128,11 @@ const std::array<ServiceModuleInfo, 41> service_module_map{
 
 ServiceFrameworkBase::ServiceFrameworkBase(const char* service_name, u32 max_sessions,
                                            InvokerFn* handler_invoker)
-    : service_name(service_name), max_sessions(max_sessions), handler_invoker(handler_invoker) {}
+    : service_name(service_name), max_sessions(max_sessions), handler_invoker(handler_invoker) {
+#if MICROPROFILE_ENABLED
+    profile_token = MicroProfileGetToken("HLE Service", service_name, MP_RGB(160, 120, 200));
+#endif
+}
 
 ServiceFrameworkBase::~ServiceFrameworkBase() = default;
 
@@ -182,7 +189,17 @@ void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context)
 
     LOG_TRACE(Service, "{}",
               MakeFunctionString(info->name, GetServiceName(), context.CommandBuffer()));
-    handler_invoker(this, info->handler_callback, context);
+
+    auto& profiler = context.Kernel().GetIPCProfiler();
+    auto* profile = profiler.GetProfile(this, service_name, info->command_id, info->name);
+    context.SetProfile(profile);
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        MICROPROFILE_SCOPE_TOKEN(profile_token);
+        handler_invoker(this, info->handler_callback, context);
+    }
+    profiler.RecordCall(profile, std::chrono::steady_clock::now() - start);
 }
 
 std::string ServiceFrameworkBase::GetFunctionName(IPC::Header header) const {
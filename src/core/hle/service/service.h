@@ -103,6 +103,8 @@ private:
     /// Function used to safely up-cast pointers to the derived class before invoking a handler.
     InvokerFn* handler_invoker;
     boost::container::flat_map<u32, FunctionInfoBase> handlers;
+    /// MicroProfileToken timing the calls of this service.
+    u64 profile_token{};
 };
 
 /**
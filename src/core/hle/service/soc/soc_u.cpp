@@ -19,6 +19,7 @@
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/result.h"
 #include "core/hle/service/soc/soc_u.h"
+#include "core/hle/service/soc/socket_event_loop.h"
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -73,6 +74,21 @@ namespace Service::SOC {
 
 const s32 SOCKET_ERROR_VALUE = -1;
 
+/// Returns true if a host error means that the operation would have blocked.
+static bool IsWouldBlockError(int error) {
+    return error == ERRNO(EWOULDBLOCK) || error == ERRNO(EAGAIN);
+}
+
+/// Host sockets are never blocking, blocking guest calls wait for them in the event loop instead.
+static void SetHostSocketNonBlocking(decltype(SocketHolder::socket_fd) fd) {
+#ifdef _WIN32
+    unsigned long nonblocking = 1;
+    ioctlsocket(fd, FIONBIO, &nonblocking);
+#else
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#endif
+}
+
 static u32 SocketProtocolToPlatform(u32 protocol) {
     switch (protocol) {
     case 0:
@@ -390,36 +406,9 @@ bool SOC_U::GetSocketBlocking(const SocketHolder& socket_holder) {
     return socket_holder.blocking;
 }
 u32 SOC_U::SetSocketBlocking(SocketHolder& socket_holder, bool blocking) {
-    u32 posix_ret = 0;
-#ifdef _WIN32
-    unsigned long nonblocking = (blocking) ? 0 : 1;
-    int ret = ioctlsocket(socket_holder.socket_fd, FIONBIO, &nonblocking);
-    if (ret == SOCKET_ERROR_VALUE) {
-        posix_ret = TranslateError(GET_ERRNO);
-        return posix_ret;
-    }
-    socket_holder.blocking = blocking;
-#else
-    int flags = ::fcntl(socket_holder.socket_fd, F_GETFL, 0);
-    if (flags == SOCKET_ERROR_VALUE) {
-        posix_ret = TranslateError(GET_ERRNO);
-        return posix_ret;
-    }
-
-    flags &= ~O_NONBLOCK;
-    if (!blocking) { // O_NONBLOCK
-        flags |= O_NONBLOCK;
-    }
-
+    // The host socket stays non-blocking, the mode only decides whether guest calls wait for it
     socket_holder.blocking = blocking;
-
-    const int ret = ::fcntl(socket_holder.socket_fd, F_SETFL, flags);
-    if (ret == SOCKET_ERROR_VALUE) {
-        posix_ret = TranslateError(GET_ERRNO);
-        return posix_ret;
-    }
-#endif
-    return posix_ret;
+    return 0;
 }
 
 std::optional<std::reference_wrapper<SocketHolder>> SOC_U::GetSocketHolder(u32 ctr_socket_fd,
@@ -449,8 +438,11 @@ std::optional<std::reference_wrapper<SocketHolder>> SOC_U::GetSocketHolder(u32 c
 }
 
 void SOC_U::CloseAndDeleteAllSockets(s32 process_id) {
-    std::erase_if(created_sockets, [process_id](const auto& entry) {
+    std::erase_if(created_sockets, [this, process_id](const auto& entry) {
         if (process_id == -1 || entry.second.ownerProcess == static_cast<u32>(process_id)) {
+            if (event_loop) {
+                event_loop->Cancel(entry.second.socket_fd);
+            }
             closesocket(entry.second.socket_fd);
             return true;
         }
@@ -803,6 +795,7 @@ void SOC_U::Socket(Kernel::HLERequestContext& ctx) {
             .shutdown_rd = false,
             .ownerProcess = pid,
         };
+        SetHostSocketNonBlocking(static_cast<decltype(SocketHolder::socket_fd)>(ret));
 #if _WIN32
         // Disable UDP connection reset
         int new_behavior = 0;
@@ -946,49 +939,59 @@ void SOC_U::Accept(Kernel::HLERequestContext& ctx) {
     async_data->pid = pid;
     async_data->socket_handle = socket_handle;
 
-    ctx.RunAsync(
-        [async_data](Kernel::HLERequestContext& ctx) {
-            socklen_t addr_len = sizeof(async_data->addr);
-            async_data->ret = static_cast<u32>(
-                ::accept(async_data->fd_info->socket_fd, &async_data->addr, &addr_len));
-            async_data->accept_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-            return 0;
-        },
-        [this, async_data](Kernel::HLERequestContext& ctx) {
-            if (static_cast<s32>(async_data->ret) != SOCKET_ERROR_VALUE) {
-                u32 socketID = GetNextSocketID();
-                created_sockets[socketID] = {
-                    .socket_fd = static_cast<decltype(SocketHolder::socket_fd)>(async_data->ret),
-                    .blocking = true,
-                    .isGlobal = false,
-                    .shutdown_rd = false,
-                    .ownerProcess = async_data->pid,
-                };
-                async_data->ret = socketID;
-            }
+    // Accepts from the non-blocking host socket, returns true if it would have blocked
+    const auto accept = [async_data] {
+        socklen_t addr_len = sizeof(async_data->addr);
+        async_data->ret = static_cast<u32>(
+            ::accept(async_data->fd_info->socket_fd, &async_data->addr, &addr_len));
+        async_data->accept_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
+        return async_data->ret == SOCKET_ERROR_VALUE &&
+               IsWouldBlockError(async_data->accept_error);
+    };
 
-            CTRSockAddr ctr_addr;
-            std::vector<u8> ctr_addr_buf(sizeof(ctr_addr));
-            if (static_cast<s32>(async_data->ret) == SOCKET_ERROR_VALUE) {
-                async_data->ret = TranslateError(async_data->accept_error);
-            } else {
-                ctr_addr = CTRSockAddr::FromPlatform(async_data->addr);
-                std::memcpy(ctr_addr_buf.data(), &ctr_addr, sizeof(ctr_addr));
-            }
+    const auto respond = [this, async_data](Kernel::HLERequestContext& ctx) {
+        if (static_cast<s32>(async_data->ret) != SOCKET_ERROR_VALUE) {
+            u32 socketID = GetNextSocketID();
+            const auto socket_fd = static_cast<decltype(SocketHolder::socket_fd)>(async_data->ret);
+            created_sockets[socketID] = {
+                .socket_fd = socket_fd,
+                .blocking = true,
+                .isGlobal = false,
+                .shutdown_rd = false,
+                .ownerProcess = async_data->pid,
+            };
+            SetHostSocketNonBlocking(socket_fd);
+            async_data->ret = socketID;
+        }
 
-            if (ctr_addr_buf.size() > async_data->max_addr_len) {
-                LOG_WARNING(Frontend, "CTRSockAddr is too long, truncating data.");
-                ctr_addr_buf.resize(async_data->max_addr_len);
-            }
+        CTRSockAddr ctr_addr;
+        std::vector<u8> ctr_addr_buf(sizeof(ctr_addr));
+        if (static_cast<s32>(async_data->ret) == SOCKET_ERROR_VALUE) {
+            async_data->ret = TranslateError(async_data->accept_error);
+        } else {
+            ctr_addr = CTRSockAddr::FromPlatform(async_data->addr);
+            std::memcpy(ctr_addr_buf.data(), &ctr_addr, sizeof(ctr_addr));
+        }
 
-            LOG_DEBUG(Service_SOC, "called, pid={}, fd={}, ret={}", async_data->socket_handle,
-                      static_cast<s32>(async_data->ret));
+        if (ctr_addr_buf.size() > async_data->max_addr_len) {
+            LOG_WARNING(Frontend, "CTRSockAddr is too long, truncating data.");
+            ctr_addr_buf.resize(async_data->max_addr_len);
+        }
 
-            IPC::RequestBuilder rb(ctx, 0x04, 2, 2);
-            rb.Push(ResultSuccess);
-            rb.Push(async_data->ret);
-            rb.PushStaticBuffer(std::move(ctr_addr_buf), 0);
-        });
+        LOG_DEBUG(Service_SOC, "called, pid={}, fd={}, ret={}", async_data->socket_handle,
+                  static_cast<s32>(async_data->ret));
+
+        IPC::RequestBuilder rb(ctx, 0x04, 2, 2);
+        rb.Push(ResultSuccess);
+        rb.Push(async_data->ret);
+        rb.PushStaticBuffer(std::move(ctr_addr_buf), 0);
+    };
+
+    if (accept() && GetSocketBlocking(holder)) {
+        RetryWhenReady(holder, POLLIN, accept, ctx.SleepUntilCompleted(respond));
+        return;
+    }
+    respond(ctx);
 }
 
 void SOC_U::SockAtMark(Kernel::HLERequestContext& ctx) {
@@ -1058,6 +1061,9 @@ void SOC_U::Close(Kernel::HLERequestContext& ctx) {
     }
     SocketHolder& holder = socket_holder_optional->get();
 
+    // Complete the guest calls still waiting on the socket before it goes away
+    event_loop->Cancel(holder.socket_fd);
+
     s32 ret = 0;
     ret = closesocket(holder.socket_fd);
 
@@ -1088,47 +1094,11 @@ void SOC_U::SendToOther(Kernel::HLERequestContext& ctx) {
     }
     SocketHolder& holder = socket_holder_optional->get();
 
-    bool dont_wait = (flags & MSGCUSTOM_HANDLE_DONTWAIT) != 0;
-    flags &= ~MSGCUSTOM_HANDLE_DONTWAIT;
-#ifdef _WIN32
-    bool was_blocking = GetSocketBlocking(holder);
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(holder, false);
-    }
-#else
-    if (dont_wait) {
-        flags |= MSG_DONTWAIT;
-    }
-#endif // _WIN32
     std::vector<u8> input_buff(len);
     input_mapped_buff.Read(input_buff.data(), 0,
                            std::min(input_mapped_buff.GetSize(), static_cast<std::size_t>(len)));
 
-    s32 ret = -1;
-    if (addr_len > 0) {
-        CTRSockAddr ctr_dest_addr;
-        std::memcpy(&ctr_dest_addr, dest_addr_buffer.data(), sizeof(ctr_dest_addr));
-        sockaddr dest_addr = CTRSockAddr::ToPlatform(ctr_dest_addr);
-        ret = static_cast<s32>(::sendto(holder.socket_fd,
-                                        reinterpret_cast<const char*>(input_buff.data()), len,
-                                        flags, &dest_addr, sizeof(dest_addr)));
-    } else {
-        ret = static_cast<s32>(::sendto(holder.socket_fd,
-                                        reinterpret_cast<const char*>(input_buff.data()), len,
-                                        flags, nullptr, 0));
-    }
-
-    const auto send_error = (ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-
-#ifdef _WIN32
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(holder, true);
-    }
-#endif
-
-    if (ret == SOCKET_ERROR_VALUE) {
-        ret = TranslateError(send_error);
-    }
+    s32 ret = SendToImpl(holder, len, flags, addr_len, input_buff, dest_addr_buffer.data());
 
     LOG_SEND_RECV(Service_SOC, "called, fd={}, ret={}", socket_handle, static_cast<s32>(ret));
 
@@ -1142,43 +1112,48 @@ s32 SOC_U::SendToImpl(SocketHolder& holder, u32 len, u32 flags, u32 addr_len,
 
     bool dont_wait = (flags & MSGCUSTOM_HANDLE_DONTWAIT) != 0;
     flags &= ~MSGCUSTOM_HANDLE_DONTWAIT;
-#ifdef _WIN32
-    bool was_blocking = GetSocketBlocking(holder);
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(holder, false);
-    }
-#else
-    if (dont_wait) {
-        flags |= MSG_DONTWAIT;
-    }
-#endif // _WIN32
 
-    s32 ret = -1;
+    sockaddr dest_addr{};
+    socklen_t dest_addr_len = 0;
     if (addr_len > 0) {
         CTRSockAddr ctr_dest_addr;
         std::memcpy(&ctr_dest_addr, dest_addr_buff, sizeof(ctr_dest_addr));
-        sockaddr dest_addr = CTRSockAddr::ToPlatform(ctr_dest_addr);
-        ret = static_cast<s32>(::sendto(holder.socket_fd,
-                                        reinterpret_cast<const char*>(input_buff.data()), len,
-                                        flags, &dest_addr, sizeof(dest_addr)));
-    } else {
-        ret = static_cast<s32>(::sendto(holder.socket_fd,
-                                        reinterpret_cast<const char*>(input_buff.data()), len,
-                                        flags, nullptr, 0));
+        dest_addr = CTRSockAddr::ToPlatform(ctr_dest_addr);
+        dest_addr_len = sizeof(dest_addr);
     }
 
-    auto send_error = (ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-
-#ifdef _WIN32
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(holder, true);
+    // Host sockets are non-blocking, so a stream may take only part of the data. A blocking
+    // guest call only returns once all of it is sent, waiting for room in the send buffer of the
+    // host meanwhile.
+    const bool wait = !dont_wait && GetSocketBlocking(holder);
+    u32 sent = 0;
+    int send_error = 0;
+    while (true) {
+        const s32 ret = static_cast<s32>(
+            ::sendto(holder.socket_fd, reinterpret_cast<const char*>(input_buff.data() + sent),
+                     len - sent, flags, dest_addr_len > 0 ? &dest_addr : nullptr, dest_addr_len));
+        if (ret != SOCKET_ERROR_VALUE) {
+            sent += static_cast<u32>(ret);
+            if (!wait || sent == len) {
+                break;
+            }
+        } else {
+            send_error = GET_ERRNO;
+            if (!IsWouldBlockError(send_error) || !wait) {
+                break;
+            }
+        }
+        pollfd poll_fd{};
+        poll_fd.fd = holder.socket_fd;
+        poll_fd.events = POLLOUT;
+        ::poll(&poll_fd, 1, -1);
     }
-#endif
-
-    if (ret == SOCKET_ERROR_VALUE)
-        ret = TranslateError(send_error);
 
-    return ret;
+    // Like a host send, an error after part of the data was sent reports the sent part
+    if (sent == 0 && send_error != 0) {
+        return TranslateError(send_error);
+    }
+    return static_cast<s32>(sent);
 }
 
 void SOC_U::SendToSingle(Kernel::HLERequestContext& ctx) {
@@ -1206,22 +1181,19 @@ void SOC_U::SendToSingle(Kernel::HLERequestContext& ctx) {
     rb.Push(ret);
 }
 
-// A poll busy loop has to be used when recieving from a blocking socket
-// because calling shutdown on a socket that's currently in a blocking
-// recv call does not make it return, which causes some games to hang.
-void SOC_U::RecvBusyWaitForEvent(SocketHolder& holder) {
-    constexpr int timeout_ms = 100;
-
-    while (true) {
-        pollfd poll_fd{};
-        poll_fd.fd = holder.socket_fd;
-        poll_fd.events = POLLIN; // Check for available data.
-        int res = ::poll(&poll_fd, 1, timeout_ms);
-        // Break if there is any event, error or socket RD shutdown.
-        if (res != 0 || holder.shutdown_rd) {
-            break;
-        }
-    }
+void SOC_U::RetryWhenReady(SocketHolder& holder, short events, std::function<bool()> operation,
+                           std::function<void()> completed) {
+    event_loop->Wait(holder.socket_fd, events,
+                     [this, &holder, events, operation = std::move(operation),
+                      completed = std::move(completed)](short revents) mutable {
+                         // A cancelled wait completes with the result of the last attempt
+                         if (revents != 0 && operation()) {
+                             RetryWhenReady(holder, events, std::move(operation),
+                                            std::move(completed));
+                             return;
+                         }
+                         completed();
+                     });
 }
 
 void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
@@ -1241,18 +1213,7 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
 
     bool dont_wait = (flags & MSGCUSTOM_HANDLE_DONTWAIT) != 0;
     flags &= ~MSGCUSTOM_HANDLE_DONTWAIT;
-#ifdef _WIN32
-    bool was_blocking = GetSocketBlocking(holder);
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(holder, false);
-    }
-#else
-    if (dont_wait) {
-        flags |= MSG_DONTWAIT;
-    }
-#endif // _WIN32
 
-    bool needs_async = GetSocketBlocking(holder) && !dont_wait;
     struct AsyncData {
         // Input
         u32 len{};
@@ -1260,11 +1221,6 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
         u32 addr_len{};
         SocketHolder* fd_info;
         u32 socket_handle;
-#ifdef _WIN32
-        bool dont_wait;
-        bool was_blocking;
-#endif
-        bool is_blocking;
 
         // Output
         s32 ret{};
@@ -1284,63 +1240,57 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
     async_data->addr_buff.resize(addr_len);
     async_data->fd_info = &holder;
     async_data->socket_handle = socket_handle;
-#ifdef _WIN32
-    async_data->dont_wait = dont_wait;
-    async_data->was_blocking = was_blocking;
-#endif
-    async_data->is_blocking = needs_async;
 
-    ctx.RunAsync(
-        [async_data](Kernel::HLERequestContext& ctx) {
-            sockaddr src_addr;
-            socklen_t src_addr_len = sizeof(src_addr);
-            CTRSockAddr ctr_src_addr;
-            // Windows, why do you have to be so special...
-            if (async_data->is_blocking) {
-                RecvBusyWaitForEvent(*async_data->fd_info);
-            }
-            if (async_data->addr_len > 0) {
-                async_data->ret = static_cast<s32>(
-                    ::recvfrom(async_data->fd_info->socket_fd,
-                               reinterpret_cast<char*>(async_data->output_buff.data()),
-                               async_data->len, async_data->flags, &src_addr, &src_addr_len));
-                if (async_data->ret >= 0 && src_addr_len > 0) {
-                    ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
-                    std::memcpy(async_data->addr_buff.data(), &ctr_src_addr, async_data->addr_len);
-                }
-            } else {
-                async_data->ret = static_cast<s32>(
-                    ::recvfrom(async_data->fd_info->socket_fd,
-                               reinterpret_cast<char*>(async_data->output_buff.data()),
-                               async_data->len, async_data->flags, NULL, 0));
-                async_data->addr_buff.resize(0);
-            }
-            async_data->recv_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-            return 0;
-        },
-        [this, async_data](Kernel::HLERequestContext& ctx) {
-            if (async_data->ret == SOCKET_ERROR_VALUE) {
-                async_data->ret = TranslateError(async_data->recv_error);
-            } else {
-                async_data->buffer->Write(async_data->output_buff.data(), 0, async_data->ret);
-            }
-#ifdef _WIN32
-            if (async_data->dont_wait && async_data->was_blocking) {
-                SetSocketBlocking(*async_data->fd_info, true);
+    // Receives from the non-blocking host socket, returns true if it would have blocked
+    const auto receive = [async_data] {
+        sockaddr src_addr;
+        socklen_t src_addr_len = sizeof(src_addr);
+        CTRSockAddr ctr_src_addr;
+        if (async_data->addr_len > 0) {
+            async_data->ret = static_cast<s32>(
+                ::recvfrom(async_data->fd_info->socket_fd,
+                           reinterpret_cast<char*>(async_data->output_buff.data()),
+                           async_data->len, async_data->flags, &src_addr, &src_addr_len));
+            if (async_data->ret >= 0 && src_addr_len > 0) {
+                ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
+                std::memcpy(async_data->addr_buff.data(), &ctr_src_addr, async_data->addr_len);
             }
-#else
-            (void)this;
-#endif
-            LOG_SEND_RECV(Service_SOC, "called, fd={}, ret={}", async_data->socket_handle,
-                          static_cast<s32>(async_data->ret));
+        } else {
+            async_data->ret = static_cast<s32>(
+                ::recvfrom(async_data->fd_info->socket_fd,
+                           reinterpret_cast<char*>(async_data->output_buff.data()),
+                           async_data->len, async_data->flags, NULL, 0));
+            async_data->addr_buff.resize(0);
+        }
+        async_data->recv_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
+        return async_data->ret == SOCKET_ERROR_VALUE && IsWouldBlockError(async_data->recv_error);
+    };
 
-            IPC::RequestBuilder rb(ctx, 0x07, 2, 4);
-            rb.Push(ResultSuccess);
-            rb.Push(async_data->ret);
-            rb.PushStaticBuffer(std::move(async_data->addr_buff), 0);
-            rb.PushMappedBuffer(*async_data->buffer);
-        },
-        needs_async);
+    const auto respond = [async_data](Kernel::HLERequestContext& ctx) {
+        if (async_data->ret == SOCKET_ERROR_VALUE && IsWouldBlockError(async_data->recv_error) &&
+            async_data->fd_info->shutdown_rd) {
+            // Nothing is left to receive from a socket shut down for reading
+            async_data->ret = 0;
+        } else if (async_data->ret == SOCKET_ERROR_VALUE) {
+            async_data->ret = TranslateError(async_data->recv_error);
+        } else {
+            async_data->buffer->Write(async_data->output_buff.data(), 0, async_data->ret);
+        }
+        LOG_SEND_RECV(Service_SOC, "called, fd={}, ret={}", async_data->socket_handle,
+                      static_cast<s32>(async_data->ret));
+
+        IPC::RequestBuilder rb(ctx, 0x07, 2, 4);
+        rb.Push(ResultSuccess);
+        rb.Push(async_data->ret);
+        rb.PushStaticBuffer(std::move(async_data->addr_buff), 0);
+        rb.PushMappedBuffer(*async_data->buffer);
+    };
+
+    if (receive() && GetSocketBlocking(holder) && !dont_wait && !holder.shutdown_rd) {
+        RetryWhenReady(holder, POLLIN, receive, ctx.SleepUntilCompleted(respond));
+        return;
+    }
+    respond(ctx);
 }
 
 void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
@@ -1359,18 +1309,7 @@ void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
 
     bool dont_wait = (flags & MSGCUSTOM_HANDLE_DONTWAIT) != 0;
     flags &= ~MSGCUSTOM_HANDLE_DONTWAIT;
-#ifdef _WIN32
-    bool was_blocking = GetSocketBlocking(holder);
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(holder, false);
-    }
-#else
-    if (dont_wait) {
-        flags |= MSG_DONTWAIT;
-    }
-#endif // _WIN32
 
-    bool needs_async = GetSocketBlocking(holder) && !dont_wait;
     struct AsyncData {
         // Input
         u32 len{};
@@ -1378,11 +1317,6 @@ void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
         u32 addr_len{};
         SocketHolder* fd_info;
         u32 socket_handle;
-#ifdef _WIN32
-        bool dont_wait;
-        bool was_blocking;
-#endif
-        bool is_blocking;
 
         // Output
         s32 ret{};
@@ -1400,69 +1334,64 @@ void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
     async_data->addr_buff.resize(addr_len);
     async_data->fd_info = &holder;
     async_data->socket_handle = socket_handle;
-#ifdef _WIN32
-    async_data->dont_wait = dont_wait;
-    async_data->was_blocking = was_blocking;
-#endif
-    async_data->is_blocking = needs_async;
 
-    ctx.RunAsync(
-        [async_data](Kernel::HLERequestContext& ctx) {
-            sockaddr src_addr;
-            socklen_t src_addr_len = sizeof(src_addr);
-            CTRSockAddr ctr_src_addr;
-            if (async_data->is_blocking) {
-                RecvBusyWaitForEvent(*async_data->fd_info);
+    // Receives from the non-blocking host socket, returns true if it would have blocked
+    const auto receive = [async_data] {
+        sockaddr src_addr;
+        socklen_t src_addr_len = sizeof(src_addr);
+        CTRSockAddr ctr_src_addr;
+        if (async_data->addr_len > 0) {
+            // Only get src adr if input adr available
+            async_data->ret = static_cast<s32>(
+                ::recvfrom(async_data->fd_info->socket_fd,
+                           reinterpret_cast<char*>(async_data->output_buff.data()),
+                           async_data->len, async_data->flags, &src_addr, &src_addr_len));
+            if (async_data->ret >= 0 && src_addr_len > 0) {
+                ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
+                std::memcpy(async_data->addr_buff.data(), &ctr_src_addr, async_data->addr_len);
             }
-            if (async_data->addr_len > 0) {
-                // Only get src adr if input adr available
-                async_data->ret = static_cast<s32>(
-                    ::recvfrom(async_data->fd_info->socket_fd,
-                               reinterpret_cast<char*>(async_data->output_buff.data()),
-                               async_data->len, async_data->flags, &src_addr, &src_addr_len));
-                if (async_data->ret >= 0 && src_addr_len > 0) {
-                    ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
-                    std::memcpy(async_data->addr_buff.data(), &ctr_src_addr, async_data->addr_len);
-                }
-            } else {
-                async_data->ret = static_cast<s32>(
-                    ::recvfrom(async_data->fd_info->socket_fd,
-                               reinterpret_cast<char*>(async_data->output_buff.data()),
-                               async_data->len, async_data->flags, NULL, 0));
-                async_data->addr_buff.resize(0);
-            }
-            async_data->recv_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-            return 0;
-        },
-        [this, async_data](Kernel::HLERequestContext& ctx) {
+        } else {
+            async_data->ret = static_cast<s32>(
+                ::recvfrom(async_data->fd_info->socket_fd,
+                           reinterpret_cast<char*>(async_data->output_buff.data()),
+                           async_data->len, async_data->flags, NULL, 0));
+            async_data->addr_buff.resize(0);
+        }
+        async_data->recv_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
+        return async_data->ret == SOCKET_ERROR_VALUE && IsWouldBlockError(async_data->recv_error);
+    };
 
-#ifdef _WIN32
-            if (async_data->dont_wait && async_data->was_blocking) {
-                SetSocketBlocking(*async_data->fd_info, true);
-            }
-#else
-            (void)this;
-#endif
-            s32 total_received = async_data->ret;
-            if (async_data->ret == SOCKET_ERROR_VALUE) {
-                async_data->ret = TranslateError(async_data->recv_error);
-                total_received = 0;
-            }
+    const auto respond = [async_data](Kernel::HLERequestContext& ctx) {
+        s32 total_received = async_data->ret;
+        if (async_data->ret == SOCKET_ERROR_VALUE && IsWouldBlockError(async_data->recv_error) &&
+            async_data->fd_info->shutdown_rd) {
+            // Nothing is left to receive from a socket shut down for reading
+            async_data->ret = 0;
+            total_received = 0;
+        } else if (async_data->ret == SOCKET_ERROR_VALUE) {
+            async_data->ret = TranslateError(async_data->recv_error);
+            total_received = 0;
+        }
 
-            // Write only the data we received to avoid overwriting parts of the buffer with zeros
-            async_data->output_buff.resize(total_received);
+        // Write only the data we received to avoid overwriting parts of the buffer with zeros
+        async_data->output_buff.resize(total_received);
 
-            LOG_SEND_RECV(Service_SOC, "called, fd={}, ret={}", async_data->socket_handle,
-                          static_cast<s32>(async_data->ret));
+        LOG_SEND_RECV(Service_SOC, "called, fd={}, ret={}", async_data->socket_handle,
+                      static_cast<s32>(async_data->ret));
 
-            IPC::RequestBuilder rb(ctx, 0x08, 3, 4);
-            rb.Push(ResultSuccess);
-            rb.Push(async_data->ret);
-            rb.Push(total_received);
-            rb.PushStaticBuffer(std::move(async_data->output_buff), 0);
-            rb.PushStaticBuffer(std::move(async_data->addr_buff), 1);
-        },
-        needs_async);
+        IPC::RequestBuilder rb(ctx, 0x08, 3, 4);
+        rb.Push(ResultSuccess);
+        rb.Push(async_data->ret);
+        rb.Push(total_received);
+        rb.PushStaticBuffer(std::move(async_data->output_buff), 0);
+        rb.PushStaticBuffer(std::move(async_data->addr_buff), 1);
+    };
+
+    if (receive() && GetSocketBlocking(holder) && !dont_wait && !holder.shutdown_rd) {
+        RetryWhenReady(holder, POLLIN, receive, ctx.SleepUntilCompleted(respond));
+        return;
+    }
+    respond(ctx);
 }
 
 void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
@@ -1506,12 +1435,21 @@ void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
             CTRPollFD::ToPlatform(*this, async_data->ctr_fds[i], async_data->has_libctru_bug[i]);
     }
 
+    // Most polls find a socket ready right away, those are answered without starting a thread
+    async_data->ret = ::poll(async_data->platform_pollfd.data(), async_data->nfds, 0);
+    if (async_data->ret == SOCKET_ERROR_VALUE) {
+        async_data->poll_error = GET_ERRNO;
+    }
+    const bool needs_async = async_data->ret == 0 && timeout != 0;
+
     ctx.RunAsync(
         [async_data](Kernel::HLERequestContext& ctx) {
-            async_data->ret =
-                ::poll(async_data->platform_pollfd.data(), async_data->nfds, async_data->timeout);
-            if (async_data->ret == SOCKET_ERROR_VALUE) {
-                async_data->poll_error = GET_ERRNO;
+            if (async_data->ret == 0 && async_data->timeout != 0) {
+                async_data->ret = ::poll(async_data->platform_pollfd.data(), async_data->nfds,
+                                         async_data->timeout);
+                if (async_data->ret == SOCKET_ERROR_VALUE) {
+                    async_data->poll_error = GET_ERRNO;
+                }
             }
             return 0;
         },
@@ -1539,7 +1477,7 @@ void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
             LOG_POLL(Service_SOC, "called, fd_count={}, ret={}", async_data->nfds,
                      static_cast<s32>(async_data->ret));
         },
-        timeout != 0);
+        needs_async);
 }
 
 void SOC_U::GetSockName(Kernel::HLERequestContext& ctx) {
@@ -1597,6 +1535,7 @@ void SOC_U::Shutdown(Kernel::HLERequestContext& ctx) {
     } else {
         if (how == SHUT_RD || how == SHUT_RDWR) {
             holder.shutdown_rd = true;
+            event_loop->Cancel(holder.socket_fd);
         }
     }
 
@@ -1756,25 +1695,43 @@ void SOC_U::Connect(Kernel::HLERequestContext& ctx) {
     async_data->input_addr = CTRSockAddr::ToPlatform(ctr_input_addr);
     async_data->socket_handle = socket_handle;
 
-    ctx.RunAsync(
-        [async_data](Kernel::HLERequestContext& ctx) {
-            async_data->ret = ::connect(async_data->fd_info->socket_fd, &async_data->input_addr,
-                                        sizeof(async_data->input_addr));
-            async_data->connect_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-            return 0;
-        },
-        [async_data](Kernel::HLERequestContext& ctx) {
-            if (async_data->ret != 0) {
-                async_data->ret = TranslateError(async_data->connect_error);
-            }
+    async_data->ret = ::connect(holder.socket_fd, &async_data->input_addr,
+                                sizeof(async_data->input_addr));
+    async_data->connect_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
 
-            LOG_DEBUG(Service_SOC, "called, pid={}, fd={}, ret={}", async_data->pid,
-                      async_data->socket_handle, static_cast<s32>(async_data->ret));
+    const auto respond = [async_data](Kernel::HLERequestContext& ctx) {
+        if (async_data->ret != 0) {
+            async_data->ret = TranslateError(async_data->connect_error);
+        }
 
-            IPC::RequestBuilder rb(ctx, 0x06, 2, 0);
-            rb.Push(ResultSuccess);
-            rb.Push(async_data->ret);
-        });
+        LOG_DEBUG(Service_SOC, "called, pid={}, fd={}, ret={}", async_data->pid,
+                  async_data->socket_handle, static_cast<s32>(async_data->ret));
+
+        IPC::RequestBuilder rb(ctx, 0x06, 2, 0);
+        rb.Push(ResultSuccess);
+        rb.Push(async_data->ret);
+    };
+
+    const bool in_progress =
+        async_data->ret == SOCKET_ERROR_VALUE && (async_data->connect_error == ERRNO(EINPROGRESS) ||
+                                                  IsWouldBlockError(async_data->connect_error));
+    if (in_progress && GetSocketBlocking(holder)) {
+        // The socket becomes writable once connected, the outcome is its pending error
+        const auto finish = [async_data] {
+            int error = 0;
+            socklen_t error_len = sizeof(error);
+            if (::getsockopt(async_data->fd_info->socket_fd, SOL_SOCKET, SO_ERROR,
+                             reinterpret_cast<char*>(&error), &error_len) != 0) {
+                error = GET_ERRNO;
+            }
+            async_data->ret = error != 0 ? SOCKET_ERROR_VALUE : 0;
+            async_data->connect_error = error;
+            return false;
+        };
+        RetryWhenReady(holder, POLLOUT, finish, ctx.SleepUntilCompleted(respond));
+        return;
+    }
+    respond(ctx);
 }
 
 void SOC_U::InitializeSockets(Kernel::HLERequestContext& ctx) {
@@ -2182,9 +2139,13 @@ SOC_U::SOC_U() : ServiceFramework("soc:U", 18) {
     WSADATA data;
     WSAStartup(MAKEWORD(2, 2), &data);
 #endif
+
+    event_loop = std::make_unique<SocketEventLoop>();
 }
 
 SOC_U::~SOC_U() {
+    // The guest threads still waiting are torn down with the kernel, do not wake them up
+    event_loop.reset();
     CloseAndDeleteAllSockets();
 #ifdef _WIN32
     WSACleanup();
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <boost/serialization/set.hpp>
@@ -21,6 +23,8 @@ class RequestParser;
 
 namespace Service::SOC {
 
+class SocketEventLoop;
+
 /// Holds information about a particular socket
 struct SocketHolder {
 #ifdef _WIN32
@@ -30,7 +34,7 @@ struct SocketHolder {
     int socket_fd; ///< The socket descriptor
 #endif // _WIN32
 
-    bool blocking = true; ///< Whether the socket is blocking or not.
+    bool blocking = true; ///< Whether the socket is blocking for the guest, the host one never is.
     bool isGlobal = false;
     bool shutdown_rd = false;
 
@@ -98,7 +102,16 @@ private:
     s32 SendToImpl(SocketHolder& holder, u32 len, u32 flags, u32 addr_len,
                    const std::vector<u8>& input_buff, const u8* dest_addr_buff);
 
-    static void RecvBusyWaitForEvent(SocketHolder& holder);
+    /**
+     * Waits in the event loop for an event on a socket, then retries an operation that would have
+     * blocked, until it completes or the wait is cancelled.
+     * @param holder The socket the operation is done on
+     * @param events The poll events after which the operation is retried
+     * @param operation Retries the operation, returns true if it would still block
+     * @param completed Called once the operation completed or was cancelled
+     */
+    void RetryWhenReady(SocketHolder& holder, short events, std::function<bool()> operation,
+                        std::function<void()> completed);
 
     // From
     // https://github.com/devkitPro/libctru/blob/1de86ea38aec419744149daf692556e187d4678a/libctru/include/3ds/services/soc.h#L15
@@ -160,6 +173,9 @@ private:
     std::unordered_map<u32, SocketHolder> created_sockets;
     std::set<u32> initialized_processes;
 
+    /// Waits for the sockets of the blocking guest calls that could not complete right away
+    std::unique_ptr<SocketEventLoop> event_loop;
+
     /// Cache interface info for the current session
     /// These two fields are not saved to savestates on purpose
     /// as network interfaces may change and it's better to.
@@ -0,0 +1,192 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "core/hle/service/soc/socket_event_loop.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#define poll(x, y, z) WSAPoll(x, y, z)
+#else
+#define closesocket(x) close(x)
+#endif
+
+namespace Service::SOC {
+
+/// Poll timeout used when the wake socket could not be created, to still notice new waits
+constexpr int FallbackTimeoutMs = 100;
+
+/// Creates a non-blocking UDP socket on the loopback interface, connected to itself.
+static bool CreateWakeSocket(SocketEventLoop::SocketFd& out_fd) {
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+#ifdef _WIN32
+    if (fd == INVALID_SOCKET) {
+        return false;
+    }
+#else
+    if (fd < 0) {
+        return false;
+    }
+#endif
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0 ||
+        ::connect(fd, reinterpret_cast<sockaddr*>(&addr), addr_len) != 0) {
+        closesocket(fd);
+        return false;
+    }
+
+#ifdef _WIN32
+    unsigned long nonblocking = 1;
+    ioctlsocket(fd, FIONBIO, &nonblocking);
+#else
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    out_fd = static_cast<SocketEventLoop::SocketFd>(fd);
+    return true;
+}
+
+SocketEventLoop::SocketEventLoop() {
+    has_wake_fd = CreateWakeSocket(wake_fd);
+    if (!has_wake_fd) {
+        LOG_ERROR(Service_SOC, "Could not create the wake socket of the event loop");
+    }
+    thread = std::thread([this] { Loop(); });
+}
+
+SocketEventLoop::~SocketEventLoop() {
+    {
+        std::scoped_lock lock{mutex};
+        stop = true;
+    }
+    Interrupt();
+    thread.join();
+
+    // The guest threads still waiting are torn down with the kernel, their callbacks are dropped
+    waits.clear();
+    if (has_wake_fd) {
+        closesocket(wake_fd);
+    }
+}
+
+void SocketEventLoop::Wait(SocketFd fd, short events, Callback callback) {
+    {
+        std::scoped_lock lock{mutex};
+        waits.push_back({next_wait_id++, fd, events, std::move(callback)});
+    }
+    Interrupt();
+}
+
+void SocketEventLoop::Cancel(SocketFd fd) {
+    std::vector<Callback> cancelled;
+    {
+        std::scoped_lock callback_lock{callback_mutex};
+        {
+            std::scoped_lock lock{mutex};
+            for (auto& wait : waits) {
+                if (wait.fd == fd) {
+                    cancelled.push_back(std::move(wait.callback));
+                }
+            }
+            std::erase_if(waits, [fd](const PendingWait& wait) { return wait.fd == fd; });
+        }
+        for (auto& callback : cancelled) {
+            callback(0);
+        }
+    }
+    if (!cancelled.empty()) {
+        Interrupt();
+    }
+}
+
+void SocketEventLoop::Interrupt() {
+    if (has_wake_fd) {
+        const char byte = 0;
+        ::send(wake_fd, &byte, sizeof(byte), 0);
+    }
+}
+
+void SocketEventLoop::Loop() {
+    Common::SetCurrentThreadName("SocketEventLoop");
+
+    std::vector<pollfd> poll_fds;
+    std::vector<u64> poll_ids;
+    std::vector<std::pair<Callback, short>> ready;
+    while (true) {
+        poll_fds.clear();
+        poll_ids.clear();
+        {
+            std::scoped_lock lock{mutex};
+            if (stop) {
+                return;
+            }
+            if (has_wake_fd) {
+                poll_fds.push_back({.fd = wake_fd, .events = POLLIN, .revents = 0});
+                poll_ids.push_back(0);
+            }
+            for (const auto& wait : waits) {
+                poll_fds.push_back({.fd = wait.fd, .events = wait.events, .revents = 0});
+                poll_ids.push_back(wait.id);
+            }
+        }
+
+        const int timeout = has_wake_fd ? -1 : FallbackTimeoutMs;
+        if (::poll(poll_fds.data(), static_cast<u32>(poll_fds.size()), timeout) <= 0) {
+            continue;
+        }
+
+        std::size_t first_wait = 0;
+        if (has_wake_fd) {
+            first_wait = 1;
+            if (poll_fds[0].revents != 0) {
+                char buffer[64];
+                while (::recv(wake_fd, buffer, sizeof(buffer), 0) > 0) {
+                }
+            }
+        }
+
+        std::scoped_lock callback_lock{callback_mutex};
+        {
+            // The waits may have been cancelled while polling, only the ones still there run
+            std::scoped_lock lock{mutex};
+            for (std::size_t i = first_wait; i < poll_fds.size(); i++) {
+                if (poll_fds[i].revents == 0) {
+                    continue;
+                }
+                const auto wait = std::find_if(waits.begin(), waits.end(), [&](const auto& wait) {
+                    return wait.id == poll_ids[i];
+                });
+                if (wait != waits.end()) {
+                    ready.emplace_back(std::move(wait->callback), poll_fds[i].revents);
+                    waits.erase(wait);
+                }
+            }
+        }
+        for (auto& [callback, revents] : ready) {
+            callback(revents);
+        }
+        ready.clear();
+    }
+}
+
+} // namespace Service::SOC
@@ -0,0 +1,81 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Service::SOC {
+
+/**
+ * Waits for events on host sockets on a single thread. The host sockets of the guest are never
+ * blocking: a blocking guest call that cannot complete right away registers a wait here and only
+ * puts its client thread to sleep, so that neither the emulation nor a host thread per call is
+ * blocked on the network.
+ */
+class SocketEventLoop {
+public:
+#ifdef _WIN32
+    using SocketFd = unsigned long long;
+#else
+    using SocketFd = int;
+#endif
+
+    /// Called with the events that occurred on the socket, or with 0 if the wait was cancelled.
+    using Callback = std::function<void(short revents)>;
+
+    SocketEventLoop();
+    ~SocketEventLoop();
+
+    SocketEventLoop(const SocketEventLoop&) = delete;
+    SocketEventLoop& operator=(const SocketEventLoop&) = delete;
+
+    /**
+     * Calls a callback from the event loop thread once a socket has one of the given events.
+     * @param fd The host socket to wait on
+     * @param events The poll events to wait for, like POLLIN or POLLOUT
+     * @param callback Callback to call once, from the event loop thread
+     */
+    void Wait(SocketFd fd, short events, Callback callback);
+
+    /**
+     * Cancels the waits on a socket, calling their callbacks with no events from the calling
+     * thread. Once it returns, no callback of the socket is running anymore, so that the socket
+     * can be closed.
+     */
+    void Cancel(SocketFd fd);
+
+private:
+    struct PendingWait {
+        u64 id;
+        SocketFd fd;
+        short events;
+        Callback callback;
+    };
+
+    void Loop();
+
+    /// Wakes the event loop up, so that it polls the new set of waits.
+    void Interrupt();
+
+    std::mutex mutex; ///< Protects waits and stop
+    std::vector<PendingWait> waits;
+    u64 next_wait_id = 0;
+    bool stop = false;
+
+    /// Held while callbacks run, so that Cancel can wait for them
+    std::mutex callback_mutex;
+
+    /// Loopback socket connected to itself, written to interrupt the poll of the loop
+    SocketFd wake_fd;
+    bool has_wake_fd = false;
+
+    std::thread thread;
+};
+
+} // namespace Service::SOC
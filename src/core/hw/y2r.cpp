@@ -5,74 +5,81 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <memory>
 #include "common/assert.h"
-#include "common/color.h"
 #include "common/common_types.h"
 #include "common/microprofile.h"
-#include "common/vector_math.h"
+#include "common/swap.h"
 #include "core/core.h"
 #include "core/hle/service/cam/y2r_u.h"
 #include "core/hw/y2r.h"
 #include "core/memory.h"
+#include "video_core/gpu.h"
+#include "video_core/rasterizer_cache/utils.h"
 
 namespace HW::Y2R {
 
 using namespace Service::Y2R;
 
-static const std::size_t MAX_TILES = 1024 / 8;
+static const std::size_t MAX_WIDTH = 1024;
+static const std::size_t MAX_TILES = MAX_WIDTH / 8;
 static const std::size_t TILE_SIZE = 8 * 8;
 using ImageTile = std::array<u32, TILE_SIZE>;
 
-/// Converts a image strip from the source YUV format into individual 8x8 RGB32 tiles.
+/// Converts a image strip from the source YUV format into lines of RGB32 pixels.
 template <InputFormat input_format>
-static void ConvertYUVToRGB(const u8* input_Y, const u8* input_U, const u8* input_V,
-                            ImageTile output[], unsigned int width, unsigned int height,
+static void ConvertYUVToRGB(const u8* input_Y, const u8* input_U, const u8* input_V, u32* output,
+                            unsigned int width, unsigned int height,
                             const CoefficientSet& coefficients) {
+    // The components of a line are unpacked first, so that the conversion itself is a straight
+    // loop over the line that the compiler vectorizes.
+    std::array<s32, MAX_WIDTH> line_Y;
+    std::array<s32, MAX_WIDTH> line_U;
+    std::array<s32, MAX_WIDTH> line_V;
 
     for (unsigned int y = 0; y < height; ++y) {
-        for (unsigned int x = 0; x < width; ++x) {
-            s32 Y;
-            s32 U;
-            s32 V;
-            if constexpr (input_format == InputFormat::YUV422_Indiv8 ||
-                          input_format == InputFormat::YUV422_Indiv16) {
-                Y = input_Y[y * width + x];
-                U = input_U[(y * width + x) / 2];
-                V = input_V[(y * width + x) / 2];
-            } else if constexpr (input_format == InputFormat::YUV420_Indiv8 ||
-                                 input_format == InputFormat::YUV420_Indiv16) {
-                Y = input_Y[y * width + x];
-                U = input_U[((y / 2) * width + x) / 2];
-                V = input_V[((y / 2) * width + x) / 2];
-            } else if constexpr (input_format == InputFormat::YUYV422_Interleaved) {
-                Y = input_Y[(y * width + x) * 2];
-                U = input_Y[(y * width + (x / 2) * 2) * 2 + 1];
-                V = input_Y[(y * width + (x / 2) * 2) * 2 + 3];
-            } else {
-                UNREACHABLE_MSG("Unknown Y2R input format {}", input_format);
-                return;
+        if constexpr (input_format == InputFormat::YUV422_Indiv8 ||
+                      input_format == InputFormat::YUV422_Indiv16 ||
+                      input_format == InputFormat::YUV420_Indiv8 ||
+                      input_format == InputFormat::YUV420_Indiv16) {
+            constexpr bool is_420 = input_format == InputFormat::YUV420_Indiv8 ||
+                                    input_format == InputFormat::YUV420_Indiv16;
+            const u8* row_Y = input_Y + y * width;
+            const u8* row_U = input_U + (is_420 ? y / 2 : y) * width / 2;
+            const u8* row_V = input_V + (is_420 ? y / 2 : y) * width / 2;
+            for (unsigned int x = 0; x < width; ++x) {
+                line_Y[x] = row_Y[x];
+                line_U[x] = row_U[x / 2];
+                line_V[x] = row_V[x / 2];
+            }
+        } else if constexpr (input_format == InputFormat::YUYV422_Interleaved) {
+            const u8* row = input_Y + y * width * 2;
+            for (unsigned int x = 0; x < width; ++x) {
+                line_Y[x] = row[x * 2];
+                line_U[x] = row[(x / 2) * 4 + 1];
+                line_V[x] = row[(x / 2) * 4 + 3];
             }
+        } else {
+            UNREACHABLE_MSG("Unknown Y2R input format {}", input_format);
+            return;
+        }
 
-            // This conversion process is bit-exact with hardware, as far as could be tested.
-            auto& c = coefficients;
-            s32 cY = c[0] * Y;
-
-            s32 r = cY + c[1] * V;
-            s32 g = cY - c[2] * V - c[3] * U;
-            s32 b = cY + c[4] * U;
-
-            const s32 rounding_offset = 0x18;
-            r = (r >> 3) + c[5] + rounding_offset;
-            g = (g >> 3) + c[6] + rounding_offset;
-            b = (b >> 3) + c[7] + rounding_offset;
-
-            unsigned int tile = x / 8;
-            unsigned int tile_x = x % 8;
-            u32* out = &output[tile][y * 8 + tile_x];
-            *out = ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) |
-                   ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) |
-                   ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
+        // This conversion process is bit-exact with hardware, as far as could be tested.
+        const auto& c = coefficients;
+        const s32 rounding_offset = 0x18;
+        u32* out = output + y * width;
+        for (unsigned int x = 0; x < width; ++x) {
+            const s32 cY = c[0] * line_Y[x];
+
+            const s32 r = ((cY + c[1] * line_V[x]) >> 3) + c[5] + rounding_offset;
+            const s32 g =
+                ((cY - c[2] * line_V[x] - c[3] * line_U[x]) >> 3) + c[6] + rounding_offset;
+            const s32 b = ((cY + c[4] * line_U[x]) >> 3) + c[7] + rounding_offset;
+
+            out[x] = (static_cast<u32>(std::clamp(r >> 5, 0, 0xFF)) << 24) |
+                     (static_cast<u32>(std::clamp(g >> 5, 0, 0xFF)) << 16) |
+                     (static_cast<u32>(std::clamp(b >> 5, 0, 0xFF)) << 8);
         }
     }
 }
@@ -88,8 +95,12 @@ static void ReceiveData(Memory::MemorySystem& memory, u8* output, ConversionBuff
     ASSERT(amount_of_data % output_unit == 0);
 
     while (amount_of_data > 0) {
-        for (std::size_t i = 0; i < output_unit; ++i) {
-            output[i] = input[i * N];
+        if constexpr (N == 1) {
+            std::memcpy(output, input, output_unit);
+        } else {
+            for (std::size_t i = 0; i < output_unit; ++i) {
+                output[i] = input[i * N];
+            }
         }
 
         output += output_unit;
@@ -101,40 +112,52 @@ static void ReceiveData(Memory::MemorySystem& memory, u8* output, ConversionBuff
     }
 }
 
+/// Encodes a RGB32 pixel, laid out as 0xRRGGBB00, to the output format.
+template <OutputFormat output_format>
+static void EncodePixel(u32 color, u8 alpha, u8* output) {
+    const u32 r = color >> 24;
+    const u32 g = (color >> 16) & 0xFF;
+    const u32 b = (color >> 8) & 0xFF;
+
+    if constexpr (output_format == OutputFormat::RGBA8) {
+        const u32_le data = color | alpha;
+        std::memcpy(output, &data, sizeof(data));
+    } else if constexpr (output_format == OutputFormat::RGB8) {
+        output[0] = static_cast<u8>(b);
+        output[1] = static_cast<u8>(g);
+        output[2] = static_cast<u8>(r);
+    } else if constexpr (output_format == OutputFormat::RGB5A1) {
+        const u16_le data =
+            static_cast<u16>(((r >> 3) << 11) | ((g >> 3) << 6) | ((b >> 3) << 1) | (alpha >> 7));
+        std::memcpy(output, &data, sizeof(data));
+    } else if constexpr (output_format == OutputFormat::RGB565) {
+        const u16_le data = static_cast<u16>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+        std::memcpy(output, &data, sizeof(data));
+    } else {
+        UNREACHABLE_MSG("Unknown Y2R output format {}", output_format);
+    }
+}
+
 /// Convert intermediate RGB32 format to the final output format while simulating an outgoing CDMA
 /// transfer.
 template <OutputFormat output_format>
 static void SendData(Memory::MemorySystem& memory, const u32* input, ConversionBuffer& buf,
                      int amount_of_data, u8 alpha) {
+    constexpr std::size_t bytes_per_pixel = output_format == OutputFormat::RGBA8  ? 4
+                                            : output_format == OutputFormat::RGB8 ? 3
+                                                                                  : 2;
+    const std::size_t unit_pixels = (buf.transfer_unit + bytes_per_pixel - 1) / bytes_per_pixel;
 
     u8* output = memory.GetPointer(buf.address);
 
     while (amount_of_data > 0) {
-        u8* unit_end = output + buf.transfer_unit;
-        while (output < unit_end) {
-            u32 color = *input++;
-            Common::Vec4<u8> col_vec{(u8)(color >> 24), (u8)(color >> 16), (u8)(color >> 8), alpha};
-
-            if constexpr (output_format == OutputFormat::RGBA8) {
-                Common::Color::EncodeRGBA8(col_vec, output);
-                output += 4;
-            } else if constexpr (output_format == OutputFormat::RGB8) {
-                Common::Color::EncodeRGB8(col_vec, output);
-                output += 3;
-            } else if constexpr (output_format == OutputFormat::RGB5A1) {
-                Common::Color::EncodeRGB5A1(col_vec, output);
-                output += 2;
-            } else if constexpr (output_format == OutputFormat::RGB565) {
-                Common::Color::EncodeRGB565(col_vec, output);
-                output += 2;
-            } else {
-                UNREACHABLE_MSG("Unknown Y2R output format {}", output_format);
-            }
-
-            amount_of_data -= 1;
+        for (std::size_t i = 0; i < unit_pixels; ++i) {
+            EncodePixel<output_format>(input[i], alpha, output + i * bytes_per_pixel);
         }
+        input += unit_pixels;
+        amount_of_data -= static_cast<int>(unit_pixels);
 
-        output += buf.gap;
+        output += unit_pixels * bytes_per_pixel + buf.gap;
         buf.address += buf.transfer_unit + buf.gap;
         buf.image_size -= buf.transfer_unit;
     }
@@ -272,8 +295,9 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration cvt
 
     // Buffer used as a CDMA source/target.
     std::unique_ptr<u8[]> data_buffer(new u8[cvt.input_line_width * 8 * 4]);
-    // Intermediate storage for decoded 8x8 image tiles. Always stored as RGB32.
-    std::unique_ptr<ImageTile[]> tiles(new ImageTile[num_tiles]);
+    // Converted strip, always stored as lines of RGB32.
+    std::unique_ptr<u32[]> strip(new u32[cvt.input_line_width * 8]);
+    ImageTile tile;
     ImageTile tmp_tile;
 
     // LUT used to remap writes to a tile. Used to allow linear or swizzled output without
@@ -288,6 +312,14 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration cvt
         break;
     }
 
+    // Linear output without rotation is laid out like the converted strip
+    const bool send_strip =
+        cvt.rotation == Rotation::None && cvt.block_alignment == BlockAlignment::Linear;
+    // For 180 and 270 degree rotations we also invert the order of tiles in the strip, since the
+    // rotates are done individually on each tile.
+    const bool reverse_tiles =
+        cvt.rotation == Rotation::Clockwise_180 || cvt.rotation == Rotation::Clockwise_270;
+
     for (unsigned int y = 0; y < cvt.input_lines; y += 8) {
         unsigned int row_height = std::min(cvt.input_lines - y, 8u);
 
@@ -303,7 +335,7 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration cvt
             ReceiveData<1>(memory, input_Y, cvt.src_Y, row_data_size);
             ReceiveData<1>(memory, input_U, cvt.src_U, row_data_size / 2);
             ReceiveData<1>(memory, input_V, cvt.src_V, row_data_size / 2);
-            ConvertYUVToRGB<InputFormat::YUV422_Indiv8>(input_Y, input_U, input_V, tiles.get(),
+            ConvertYUVToRGB<InputFormat::YUV422_Indiv8>(input_Y, input_U, input_V, strip.get(),
                                                         cvt.input_line_width, row_height,
                                                         cvt.coefficients);
             break;
@@ -311,7 +343,7 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration cvt
             ReceiveData<1>(memory, input_Y, cvt.src_Y, row_data_size);
             ReceiveData<1>(memory, input_U, cvt.src_U, row_data_size / 4);
             ReceiveData<1>(memory, input_V, cvt.src_V, row_data_size / 4);
-            ConvertYUVToRGB<InputFormat::YUV420_Indiv8>(input_Y, input_U, input_V, tiles.get(),
+            ConvertYUVToRGB<InputFormat::YUV420_Indiv8>(input_Y, input_U, input_V, strip.get(),
                                                         cvt.input_line_width, row_height,
                                                         cvt.coefficients);
             break;
@@ -319,7 +351,7 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration cvt
             ReceiveData<2>(memory, input_Y, cvt.src_Y, row_data_size);
             ReceiveData<2>(memory, input_U, cvt.src_U, row_data_size / 2);
             ReceiveData<2>(memory, input_V, cvt.src_V, row_data_size / 2);
-            ConvertYUVToRGB<InputFormat::YUV422_Indiv16>(input_Y, input_U, input_V, tiles.get(),
+            ConvertYUVToRGB<InputFormat::YUV422_Indiv16>(input_Y, input_U, input_V, strip.get(),
                                                          cvt.input_line_width, row_height,
                                                          cvt.coefficients);
             break;
@@ -327,7 +359,7 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration cvt
             ReceiveData<2>(memory, input_Y, cvt.src_Y, row_data_size);
             ReceiveData<2>(memory, input_U, cvt.src_U, row_data_size / 4);
             ReceiveData<2>(memory, input_V, cvt.src_V, row_data_size / 4);
-            ConvertYUVToRGB<InputFormat::YUV420_Indiv16>(input_Y, input_U, input_V, tiles.get(),
+            ConvertYUVToRGB<InputFormat::YUV420_Indiv16>(input_Y, input_U, input_V, strip.get(),
                                                          cvt.input_line_width, row_height,
                                                          cvt.coefficients);
             break;
@@ -336,7 +368,7 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration cvt
             input_V = nullptr;
             ReceiveData<1>(memory, input_Y, cvt.src_YUYV, row_data_size * 2);
             ConvertYUVToRGB<InputFormat::YUYV422_Interleaved>(input_Y, input_U, input_V,
-                                                              tiles.get(), cvt.input_line_width,
+                                                              strip.get(), cvt.input_line_width,
                                                               row_height, cvt.coefficients);
             break;
         default:
@@ -344,69 +376,71 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration cvt
             return;
         }
 
-        u32* output_buffer = reinterpret_cast<u32*>(data_buffer.get());
-
-        for (std::size_t i = 0; i < num_tiles; ++i) {
-            int image_strip_width = 0;
-            int output_stride = 0;
-
-            switch (cvt.rotation) {
-            case Rotation::None:
-                RotateTile0(tiles[i], tmp_tile, row_height, tile_remap);
-                image_strip_width = cvt.input_line_width;
-                output_stride = 8;
-                break;
-            case Rotation::Clockwise_90:
-                RotateTile90(tiles[i], tmp_tile, row_height, tile_remap);
-                image_strip_width = 8;
-                output_stride = 8 * row_height;
-                break;
-            case Rotation::Clockwise_180:
-                // For 180 and 270 degree rotations we also invert the order of tiles in the strip,
-                // since the rotates are done individually on each tile.
-                RotateTile180(tiles[num_tiles - i - 1], tmp_tile, row_height, tile_remap);
-                image_strip_width = cvt.input_line_width;
-                output_stride = 8;
-                break;
-            case Rotation::Clockwise_270:
-                RotateTile270(tiles[num_tiles - i - 1], tmp_tile, row_height, tile_remap);
-                image_strip_width = 8;
-                output_stride = 8 * row_height;
-                break;
-            }
-
-            switch (cvt.block_alignment) {
-            case BlockAlignment::Linear:
-                WriteTileToOutput(output_buffer, tmp_tile, row_height, image_strip_width);
-                output_buffer += output_stride;
-                break;
-            case BlockAlignment::Block8x8:
-                WriteTileToOutput(output_buffer, tmp_tile, 8, 8);
-                output_buffer += TILE_SIZE;
-                break;
+        const u32* send_buffer = strip.get();
+        if (!send_strip) {
+            u32* output_buffer = reinterpret_cast<u32*>(data_buffer.get());
+            send_buffer = output_buffer;
+
+            for (std::size_t i = 0; i < num_tiles; ++i) {
+                int image_strip_width = 0;
+                int output_stride = 0;
+
+                const std::size_t tile_x = 8 * (reverse_tiles ? num_tiles - i - 1 : i);
+                for (unsigned int line = 0; line < row_height; ++line) {
+                    std::memcpy(&tile[line * 8], &strip[line * cvt.input_line_width + tile_x],
+                                8 * sizeof(u32));
+                }
+
+                switch (cvt.rotation) {
+                case Rotation::None:
+                    RotateTile0(tile, tmp_tile, row_height, tile_remap);
+                    image_strip_width = cvt.input_line_width;
+                    output_stride = 8;
+                    break;
+                case Rotation::Clockwise_90:
+                    RotateTile90(tile, tmp_tile, row_height, tile_remap);
+                    image_strip_width = 8;
+                    output_stride = 8 * row_height;
+                    break;
+                case Rotation::Clockwise_180:
+                    RotateTile180(tile, tmp_tile, row_height, tile_remap);
+                    image_strip_width = cvt.input_line_width;
+                    output_stride = 8;
+                    break;
+                case Rotation::Clockwise_270:
+                    RotateTile270(tile, tmp_tile, row_height, tile_remap);
+                    image_strip_width = 8;
+                    output_stride = 8 * row_height;
+                    break;
+                }
+
+                switch (cvt.block_alignment) {
+                case BlockAlignment::Linear:
+                    WriteTileToOutput(output_buffer, tmp_tile, row_height, image_strip_width);
+                    output_buffer += output_stride;
+                    break;
+                case BlockAlignment::Block8x8:
+                    WriteTileToOutput(output_buffer, tmp_tile, 8, 8);
+                    output_buffer += TILE_SIZE;
+                    break;
+                }
             }
         }
 
+        const auto amount_of_data = static_cast<int>(row_data_size);
+        const auto alpha = static_cast<u8>(cvt.alpha);
         switch (cvt.output_format) {
         case OutputFormat::RGBA8:
-            SendData<OutputFormat::RGBA8>(memory, reinterpret_cast<u32*>(data_buffer.get()),
-                                          cvt.dst, static_cast<int>(row_data_size),
-                                          static_cast<u8>(cvt.alpha));
+            SendData<OutputFormat::RGBA8>(memory, send_buffer, cvt.dst, amount_of_data, alpha);
             break;
         case OutputFormat::RGB8:
-            SendData<OutputFormat::RGB8>(memory, reinterpret_cast<u32*>(data_buffer.get()), cvt.dst,
-                                         static_cast<int>(row_data_size),
-                                         static_cast<u8>(cvt.alpha));
+            SendData<OutputFormat::RGB8>(memory, send_buffer, cvt.dst, amount_of_data, alpha);
             break;
         case OutputFormat::RGB5A1:
-            SendData<OutputFormat::RGB5A1>(memory, reinterpret_cast<u32*>(data_buffer.get()),
-                                           cvt.dst, static_cast<int>(row_data_size),
-                                           static_cast<u8>(cvt.alpha));
+            SendData<OutputFormat::RGB5A1>(memory, send_buffer, cvt.dst, amount_of_data, alpha);
             break;
         case OutputFormat::RGB565:
-            SendData<OutputFormat::RGB565>(memory, reinterpret_cast<u32*>(data_buffer.get()),
-                                           cvt.dst, static_cast<int>(row_data_size),
-                                           static_cast<u8>(cvt.alpha));
+            SendData<OutputFormat::RGB565>(memory, send_buffer, cvt.dst, amount_of_data, alpha);
             break;
         default:
             UNREACHABLE_MSG("Unknown Y2R output format {}", cvt.output_format);
@@ -414,4 +448,84 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration cvt
         }
     }
 }
+/// Returns the physical address of a contiguous region of the linear heap or VRAM, or 0.
+static PAddr LinearToPhysical(VAddr addr, u32 size) {
+    const auto in_region = [&](VAddr region_start, VAddr region_end) {
+        return addr >= region_start && addr + size <= region_end;
+    };
+    if (in_region(Memory::LINEAR_HEAP_VADDR, Memory::LINEAR_HEAP_VADDR_END)) {
+        return addr - Memory::LINEAR_HEAP_VADDR + Memory::FCRAM_PADDR;
+    }
+    if (in_region(Memory::NEW_LINEAR_HEAP_VADDR, Memory::NEW_LINEAR_HEAP_VADDR_END)) {
+        return addr - Memory::NEW_LINEAR_HEAP_VADDR + Memory::FCRAM_PADDR;
+    }
+    if (in_region(Memory::VRAM_VADDR, Memory::VRAM_VADDR_END)) {
+        return addr - Memory::VRAM_VADDR + Memory::VRAM_PADDR;
+    }
+    return 0;
+}
+
+bool AccelerateConversion(Core::System& system, const ConversionConfiguration& cvt) {
+    using Y2RConfig = VideoCore::Y2RConfig;
+
+    if (cvt.rotation != Rotation::None || cvt.block_alignment != BlockAlignment::Block8x8 ||
+        cvt.input_lines % 8 != 0 || cvt.dst.gap != 0) {
+        return false;
+    }
+
+    Y2RConfig config{
+        .width = cvt.input_line_width,
+        .height = cvt.input_lines,
+    };
+    const u32 num_pixels = config.width * config.height;
+
+    switch (cvt.output_format) {
+    case OutputFormat::RGBA8:
+        config.output_format = VideoCore::PixelFormat::RGBA8;
+        config.alpha = cvt.alpha & 0xFF;
+        config.dst_addr = LinearToPhysical(cvt.dst.address, num_pixels * 4);
+        break;
+    case OutputFormat::RGB8:
+        config.output_format = VideoCore::PixelFormat::RGB8;
+        config.alpha = 0xFF;
+        config.dst_addr = LinearToPhysical(cvt.dst.address, num_pixels * 3);
+        break;
+    default:
+        return false;
+    }
+    std::copy(cvt.coefficients.begin(), cvt.coefficients.end(), config.coefficients.begin());
+
+    const auto set_plane = [&](std::size_t index, const ConversionBuffer& buf, u32 size) {
+        config.planes[index] = {LinearToPhysical(buf.address, size), size};
+        return buf.gap == 0 && config.planes[index].addr != 0;
+    };
+    bool planes_contiguous = false;
+    switch (cvt.input_format) {
+    case InputFormat::YUV422_Indiv8:
+        config.input_format = Y2RConfig::InputFormat::YUV422;
+        planes_contiguous = set_plane(0, cvt.src_Y, num_pixels) &&
+                            set_plane(1, cvt.src_U, num_pixels / 2) &&
+                            set_plane(2, cvt.src_V, num_pixels / 2);
+        break;
+    case InputFormat::YUV420_Indiv8:
+        config.input_format = Y2RConfig::InputFormat::YUV420;
+        planes_contiguous = set_plane(0, cvt.src_Y, num_pixels) &&
+                            set_plane(1, cvt.src_U, num_pixels / 4) &&
+                            set_plane(2, cvt.src_V, num_pixels / 4);
+        break;
+    case InputFormat::YUYV422_Interleaved:
+        config.input_format = Y2RConfig::InputFormat::YUYV422;
+        planes_contiguous = set_plane(0, cvt.src_YUYV, num_pixels * 2);
+        break;
+    default:
+        // The 16-bit formats are left to the CPU
+        return false;
+    }
+    if (!planes_contiguous || config.dst_addr == 0) {
+        return false;
+    }
+
+    return system.GPU().AccelerateY2R(config);
+}
+
 } // namespace HW::Y2R
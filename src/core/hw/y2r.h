@@ -4,6 +4,10 @@
 
 #pragma once
 
+namespace Core {
+class System;
+}
+
 namespace Memory {
 class MemorySystem;
 }
@@ -14,4 +18,12 @@ struct ConversionConfiguration;
 
 namespace HW::Y2R {
 void PerformConversion(Memory::MemorySystem& memory, Service::Y2R::ConversionConfiguration cvt);
+
+/**
+ * Attempts to perform a conversion on the host GPU, into the rasterizer cache surface at the
+ * destination. Only contiguous 8-bit input converted to a tiled RGBA8 or RGB8 image without
+ * rotation is supported.
+ * @returns false if the conversion must be performed with PerformConversion instead.
+ */
+bool AccelerateConversion(Core::System& system, const Service::Y2R::ConversionConfiguration& cvt);
 } // namespace HW::Y2R
@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstring>
+#include <mutex>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/binary_object.hpp>
 #include "audio_core/dsp_interface.h"
@@ -32,8 +35,74 @@ namespace Memory {
 
 void PageTable::Clear() {
     pointers.raw.fill(nullptr);
-    pointers.refs.fill(MemoryRef());
-    attributes.fill(PageType::Unmapped);
+    pointers.refs.Clear();
+    attributes.Clear();
+    if (fastmem_arena) {
+        fastmem_arena->Unmap(0, std::size_t{1} << 32);
+    }
+}
+
+std::optional<std::size_t> PageTable::Pointers::HostOffset(VAddr idx) const {
+    const auto offset = raw[idx] ? host_memory->OffsetOf(raw[idx]) : std::nullopt;
+    if (offset && (*offset & CITRA_PAGE_MASK) == 0) {
+        return offset;
+    }
+    return std::nullopt;
+}
+
+void PageTable::Pointers::UpdateFastmem(VAddr idx) {
+    const std::size_t vaddr = static_cast<std::size_t>(idx) << CITRA_PAGE_BITS;
+    if (const auto offset = HostOffset(idx)) {
+        fastmem_arena->Map(vaddr, *offset, CITRA_PAGE_SIZE);
+    } else {
+        fastmem_arena->Unmap(vaddr, CITRA_PAGE_SIZE);
+    }
+}
+
+void PageTable::UpdateFastmem(VAddr base, u32 num_pages) {
+    if (!fastmem_arena) {
+        return;
+    }
+
+    const VAddr end = base + num_pages;
+    while (base != end) {
+        // Extend the run while the pages are backed by consecutive host pages, or by none at all
+        const auto offset = pointers.HostOffset(base);
+        VAddr run_end = base + 1;
+        for (; run_end != end; run_end++) {
+            const auto next = pointers.HostOffset(run_end);
+            if (offset ? next != *offset + std::size_t{run_end - base} * CITRA_PAGE_SIZE
+                       : next.has_value()) {
+                break;
+            }
+        }
+
+        const std::size_t vaddr = static_cast<std::size_t>(base) << CITRA_PAGE_BITS;
+        const std::size_t length = static_cast<std::size_t>(run_end - base) << CITRA_PAGE_BITS;
+        if (offset) {
+            fastmem_arena->Map(vaddr, *offset, length);
+        } else {
+            fastmem_arena->Unmap(vaddr, length);
+        }
+        base = run_end;
+    }
+}
+
+void PageTable::EnableFastmem(Common::HostMemory& host_memory) {
+    if (fastmem_arena) {
+        UpdateFastmem(0, static_cast<u32>(PAGE_TABLE_NUM_ENTRIES));
+        return;
+    }
+
+    auto arena = std::make_unique<Common::VirtualArena>(host_memory, std::size_t{1} << 32);
+    if (!arena->IsValid()) {
+        return;
+    }
+
+    fastmem_arena = std::move(arena);
+    pointers.host_memory = &host_memory;
+    pointers.fastmem_arena = fastmem_arena.get();
+    UpdateFastmem(0, static_cast<u32>(PAGE_TABLE_NUM_ENTRIES));
 }
 
 class RasterizerCacheMarker {
@@ -86,17 +155,36 @@ private:
 
 class MemorySystem::Impl {
 public:
-    // Visual Studio would try to allocate these on compile time
-    // if they are std::array which would exceed the memory limit.
-    std::unique_ptr<u8[]> fcram = std::make_unique<u8[]>(Memory::FCRAM_N3DS_SIZE);
-    std::unique_ptr<u8[]> vram = std::make_unique<u8[]>(Memory::VRAM_SIZE);
-    std::unique_ptr<u8[]> n3ds_extra_ram = std::make_unique<u8[]>(Memory::N3DS_EXTRA_RAM_SIZE);
+    static constexpr std::size_t BackingSize =
+        Memory::FCRAM_N3DS_SIZE + Memory::VRAM_SIZE + Memory::N3DS_EXTRA_RAM_SIZE;
+
+    // All emulated RAM lives in one block, which is shared host memory when fastmem is enabled
+    // so that it can also be mapped into the address space of each process. Either way it is
+    // backed by huge pages where possible, as the guest and the rasterizer cache access it
+    // randomly.
+    std::unique_ptr<Common::HostMemory> host_memory;
+    std::unique_ptr<Common::LargePageBuffer> heap_memory;
+    u8* fcram{};
+    u8* vram{};
+    u8* n3ds_extra_ram{};
 
     Core::System& system;
     std::shared_ptr<PageTable> current_page_table = nullptr;
     RasterizerCacheMarker cache_marker;
+    RasterizerCacheMarker dirty_marker;
     std::vector<std::shared_ptr<PageTable>> page_table_list;
 
+    /// A rasterizer mark queued by the GPU thread
+    struct PendingMark {
+        void (MemorySystem::*mark)(PAddr start, u32 size, bool value);
+        PAddr start;
+        u32 size;
+        bool value;
+    };
+    std::mutex pending_marks_mutex;
+    std::vector<PendingMark> pending_marks;
+    std::atomic_bool has_pending_marks{};
+
     AudioCore::DspInterface* dsp = nullptr;
 
     std::shared_ptr<BackingMem> fcram_mem;
@@ -109,13 +197,13 @@ public:
     const u8* GetPtr(Region r) const {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -124,13 +212,13 @@ public:
     u8* GetPtr(Region r) {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -155,102 +243,118 @@ public:
         return system.GetRunningCore().GetPC();
     }
 
-    template <bool UNSAFE>
-    void ReadBlockImpl(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
-                       const std::size_t size) {
-        auto& page_table = *process.vm_manager.page_table;
+    /// Returns the host memory backing the page at page_index, or null if it is unmapped.
+    u8* GetHostPage(PageTable& page_table, PageType type, std::size_t page_index) const {
+        switch (type) {
+        case PageType::Memory:
+            DEBUG_ASSERT(page_table.pointers[page_index]);
+            return page_table.pointers[page_index];
+        case PageType::RasterizerCachedMemory:
+            return GetPointerForRasterizerCache(static_cast<VAddr>(page_index << CITRA_PAGE_BITS))
+                .GetPtr();
+        default:
+            return nullptr;
+        }
+    }
 
+    /**
+     * Splits a virtual range into runs of pages of the same type that are also contiguous in host
+     * memory, such as a linear heap buffer, so that each run is transferred with a single memcpy
+     * and flushed from the rasterizer cache with a single call.
+     * @param func Called as func(type, vaddr, host_pointer, size) for each run, with a null
+     *             host_pointer for unmapped runs.
+     */
+    template <typename Func>
+    void ForEachRun(PageTable& page_table, VAddr addr, std::size_t size, Func&& func) const {
         std::size_t remaining_size = size;
-        std::size_t page_index = src_addr >> CITRA_PAGE_BITS;
-        std::size_t page_offset = src_addr & CITRA_PAGE_MASK;
+        std::size_t page_index = addr >> CITRA_PAGE_BITS;
+        std::size_t page_offset = addr & CITRA_PAGE_MASK;
 
         while (remaining_size > 0) {
-            const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-            const VAddr current_vaddr =
-                static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case PageType::Unmapped: {
-                LOG_ERROR(
-                    HW_Memory,
-                    "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                    "0x{:08X}",
-                    current_vaddr, src_addr, size, GetPC());
-                std::memset(dest_buffer, 0, copy_amount);
-                break;
-            }
-            case PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-                std::memcpy(dest_buffer, src_ptr, copy_amount);
-                break;
-            }
-            case PageType::RasterizerCachedMemory: {
-                if constexpr (!UNSAFE) {
-                    RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                                 FlushMode::Flush);
+            const PageType type = page_table.attributes[page_index];
+            u8* const host_page = GetHostPage(page_table, type, page_index);
+            std::size_t run_size = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
+            std::size_t run_pages = 1;
+            while (run_size < remaining_size) {
+                const std::size_t next_page = page_index + run_pages;
+                u8* const expected = host_page ? host_page + run_pages * CITRA_PAGE_SIZE : nullptr;
+                if (page_table.attributes[next_page] != type ||
+                    GetHostPage(page_table, type, next_page) != expected) {
+                    break;
                 }
-                std::memcpy(dest_buffer, GetPointerForRasterizerCache(current_vaddr), copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
+                run_size += std::min<std::size_t>(CITRA_PAGE_SIZE, remaining_size - run_size);
+                run_pages++;
             }
 
-            page_index++;
+            const VAddr run_vaddr =
+                static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
+            func(type, run_vaddr, host_page ? host_page + page_offset : nullptr, run_size);
+
+            page_index += run_pages;
             page_offset = 0;
-            dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-            remaining_size -= copy_amount;
+            remaining_size -= run_size;
         }
     }
 
+    template <bool UNSAFE>
+    void ReadBlockImpl(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
+                       const std::size_t size) {
+        auto* dest = static_cast<u8*>(dest_buffer);
+        ForEachRun(*process.vm_manager.page_table, src_addr, size,
+                   [&](PageType type, VAddr vaddr, const u8* src_ptr, std::size_t run_size) {
+                       switch (type) {
+                       case PageType::Unmapped:
+                           LOG_ERROR(HW_Memory,
+                                     "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                     "size = {}) at PC 0x{:08X}",
+                                     vaddr, src_addr, size, GetPC());
+                           std::memset(dest, 0, run_size);
+                           break;
+                       case PageType::Memory:
+                           std::memcpy(dest, src_ptr, run_size);
+                           break;
+                       case PageType::RasterizerCachedMemory:
+                           if constexpr (!UNSAFE) {
+                               RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(run_size),
+                                                            FlushMode::Flush);
+                           }
+                           std::memcpy(dest, src_ptr, run_size);
+                           break;
+                       default:
+                           UNREACHABLE();
+                       }
+                       dest += run_size;
+                   });
+    }
+
     template <bool UNSAFE>
     void WriteBlockImpl(const Kernel::Process& process, const VAddr dest_addr,
                         const void* src_buffer, const std::size_t size) {
-        auto& page_table = *process.vm_manager.page_table;
-        std::size_t remaining_size = size;
-        std::size_t page_index = dest_addr >> CITRA_PAGE_BITS;
-        std::size_t page_offset = dest_addr & CITRA_PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-            const VAddr current_vaddr =
-                static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case PageType::Unmapped: {
-                LOG_ERROR(
-                    HW_Memory,
-                    "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                    "0x{:08X}",
-                    current_vaddr, dest_addr, size, GetPC());
-                break;
-            }
-            case PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-                std::memcpy(dest_ptr, src_buffer, copy_amount);
-                break;
-            }
-            case PageType::RasterizerCachedMemory: {
-                if constexpr (!UNSAFE) {
-                    RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                                 FlushMode::Invalidate);
-                }
-                std::memcpy(GetPointerForRasterizerCache(current_vaddr), src_buffer, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
-            }
-
-            page_index++;
-            page_offset = 0;
-            src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-            remaining_size -= copy_amount;
-        }
+        const auto* src = static_cast<const u8*>(src_buffer);
+        ForEachRun(*process.vm_manager.page_table, dest_addr, size,
+                   [&](PageType type, VAddr vaddr, u8* dest_ptr, std::size_t run_size) {
+                       switch (type) {
+                       case PageType::Unmapped:
+                           LOG_ERROR(HW_Memory,
+                                     "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                     "size = {}) at PC 0x{:08X}",
+                                     vaddr, dest_addr, size, GetPC());
+                           break;
+                       case PageType::Memory:
+                           std::memcpy(dest_ptr, src, run_size);
+                           break;
+                       case PageType::RasterizerCachedMemory:
+                           if constexpr (!UNSAFE) {
+                               RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(run_size),
+                                                            FlushMode::Invalidate);
+                           }
+                           std::memcpy(dest_ptr, src, run_size);
+                           break;
+                       default:
+                           UNREACHABLE();
+                       }
+                       src += run_size;
+                   });
     }
 
     MemoryRef GetPointerForRasterizerCache(VAddr addr) const {
@@ -275,7 +379,27 @@ public:
         return MemoryRef{};
     }
 
+    /// Returns true if the region may hold GPU writes that have not been flushed back yet.
+    bool HasPendingGPUWrites(VAddr start, u32 size) {
+        const VAddr end = start + size;
+        for (VAddr page = start & ~CITRA_PAGE_MASK; page < end; page += CITRA_PAGE_SIZE) {
+            if (dirty_marker.IsCached(page)) {
+                return true;
+            }
+        }
+
+        // Until the GPU thread catches up the dirty marks may be missing writes it has queued, or
+        // writes it has already made but only queued the marks for.
+        return !system.GPU().IsIdle() || has_pending_marks.load(std::memory_order::acquire);
+    }
+
     void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
+        // Cached pages behave as if read-only protected: reads only have to reach the rasterizer
+        // when it holds writes that have not been flushed back, while writes always invalidate.
+        if (mode == FlushMode::Flush && !HasPendingGPUWrites(start, size)) {
+            return;
+        }
+
         const VAddr end = start + size;
 
         auto CheckRegion = [&](VAddr region_start, VAddr region_end, PAddr paddr_region_start) {
@@ -284,22 +408,22 @@ public:
                 return;
             }
 
-            auto& renderer = system.GPU().Renderer();
             VAddr overlap_start = std::max(start, region_start);
             VAddr overlap_end = std::min(end, region_end);
             PAddr physical_start = paddr_region_start + (overlap_start - region_start);
             u32 overlap_size = overlap_end - overlap_start;
 
-            auto* rasterizer = renderer.Rasterizer();
+            // Go through the GPU so that pending work on the GPU thread is fenced.
+            auto& gpu = system.GPU();
             switch (mode) {
             case FlushMode::Flush:
-                rasterizer->FlushRegion(physical_start, overlap_size);
+                gpu.FlushRegion(physical_start, overlap_size);
                 break;
             case FlushMode::Invalidate:
-                rasterizer->InvalidateRegion(physical_start, overlap_size);
+                gpu.InvalidateRegion(physical_start, overlap_size);
                 break;
             case FlushMode::FlushAndInvalidate:
-                rasterizer->FlushAndInvalidateRegion(physical_start, overlap_size);
+                gpu.FlushAndInvalidateRegion(physical_start, overlap_size);
                 break;
             }
         };
@@ -319,11 +443,11 @@ private:
     void serialize(Archive& ar, const unsigned int file_version) {
         bool save_n3ds_ram = Settings::values.is_new_3ds.GetValue();
         ar& save_n3ds_ram;
-        ar& boost::serialization::make_binary_object(vram.get(), Memory::VRAM_SIZE);
+        ar& boost::serialization::make_binary_object(vram, Memory::VRAM_SIZE);
         ar& boost::serialization::make_binary_object(
-            fcram.get(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
+            fcram, save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
         ar& boost::serialization::make_binary_object(
-            n3ds_extra_ram.get(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+            n3ds_extra_ram, save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
         ar& cache_marker;
         ar& page_table_list;
         // dsp is set from Core::System at startup
@@ -332,6 +456,17 @@ private:
         ar& vram_mem;
         ar& n3ds_extra_ram_mem;
         ar& dsp_mem;
+        // The loaded page tables are new objects, their pages have to be mirrored again.
+        if (Archive::is_loading::value && host_memory) {
+            for (const auto& page_table : page_table_list) {
+                page_table->EnableFastmem(*host_memory);
+            }
+            if (current_page_table &&
+                std::find(page_table_list.begin(), page_table_list.end(), current_page_table) ==
+                    page_table_list.end()) {
+                current_page_table->EnableFastmem(*host_memory);
+            }
+        }
     }
 };
 
@@ -366,7 +501,28 @@ MemorySystem::Impl::Impl(Core::System& system_)
     : system{system_}, fcram_mem(std::make_shared<BackingMemImpl<Region::FCRAM>>(*this)),
       vram_mem(std::make_shared<BackingMemImpl<Region::VRAM>>(*this)),
       n3ds_extra_ram_mem(std::make_shared<BackingMemImpl<Region::N3DS>>(*this)),
-      dsp_mem(std::make_shared<BackingMemImpl<Region::DSP>>(*this)) {}
+      dsp_mem(std::make_shared<BackingMemImpl<Region::DSP>>(*this)) {
+    if (Settings::values.use_fastmem.GetValue() && sizeof(void*) == 8) {
+        host_memory = std::make_unique<Common::HostMemory>(BackingSize);
+        if (!host_memory->IsValid()) {
+            LOG_WARNING(HW_Memory, "Fastmem is unavailable on this host, falling back to the "
+                                   "page table for JIT memory accesses");
+            host_memory.reset();
+        }
+    }
+
+    u8* base;
+    if (host_memory) {
+        base = host_memory->BackingBasePointer();
+    } else {
+        heap_memory = std::make_unique<Common::LargePageBuffer>(BackingSize);
+        ASSERT_MSG(heap_memory->IsValid(), "Unable to allocate the emulated RAM");
+        base = heap_memory->Data();
+    }
+    fcram = base;
+    vram = fcram + Memory::FCRAM_N3DS_SIZE;
+    n3ds_extra_ram = vram + Memory::VRAM_SIZE;
+}
 
 MemorySystem::MemorySystem(Core::System& system) : impl(std::make_unique<Impl>(system)) {}
 MemorySystem::~MemorySystem() = default;
@@ -400,23 +556,27 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef
                                      FlushMode::FlushAndInvalidate);
     }
 
+    const u32 first = base;
     u32 end = base + size;
     while (base != end) {
         ASSERT_MSG(base < PAGE_TABLE_NUM_ENTRIES, "out of range mapping at {:08X}", base);
 
-        page_table.attributes[base] = type;
-        page_table.pointers[base] = memory;
-
         // If the memory to map is already rasterizer-cached, mark the page
         if (type == PageType::Memory && impl->cache_marker.IsCached(base * CITRA_PAGE_SIZE)) {
-            page_table.attributes[base] = PageType::RasterizerCachedMemory;
-            page_table.pointers[base] = nullptr;
+            page_table.attributes.Set(base, PageType::RasterizerCachedMemory);
+            page_table.SetPointerDeferred(base, nullptr);
+        } else {
+            page_table.attributes.Set(base, type);
+            page_table.SetPointerDeferred(base, memory);
         }
 
         base += 1;
         if (memory != nullptr && memory.GetSize() > CITRA_PAGE_SIZE)
             memory += CITRA_PAGE_SIZE;
     }
+
+    // Mirror the whole range into fastmem at once rather than with a call per page
+    page_table.UpdateFastmem(first, size);
 }
 
 void MemorySystem::MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, MemoryRef target) {
@@ -437,6 +597,9 @@ MemoryRef MemorySystem::GetPointerForRasterizerCache(VAddr addr) const {
 }
 
 void MemorySystem::RegisterPageTable(std::shared_ptr<PageTable> page_table) {
+    if (impl->host_memory) {
+        page_table->EnableFastmem(*impl->host_memory);
+    }
     impl->page_table_list.push_back(page_table);
 }
 
@@ -715,11 +878,50 @@ std::vector<VAddr> MemorySystem::PhysicalToVirtualAddressForRasterizer(PAddr add
     return {};
 }
 
+/// The memory system whose rasterizer marks the current thread queues
+static thread_local const MemorySystem* deferring_memory{};
+
+void MemorySystem::RasterizerMarkRegionDirty(PAddr start, u32 size, bool dirty) {
+    if (start == 0) {
+        return;
+    }
+
+    // Finding the virtual addresses of the region looks up services, which belong to the
+    // emulation thread as well.
+    if (deferring_memory == this) {
+        std::scoped_lock lock{impl->pending_marks_mutex};
+        impl->pending_marks.push_back(
+            {&MemorySystem::RasterizerMarkRegionDirty, start, size, dirty});
+        impl->has_pending_marks.store(true, std::memory_order::release);
+        return;
+    }
+
+    u32 num_pages = ((start + size - 1) >> CITRA_PAGE_BITS) - (start >> CITRA_PAGE_BITS) + 1;
+    PAddr paddr = start;
+
+    for (unsigned i = 0; i < num_pages; ++i, paddr += CITRA_PAGE_SIZE) {
+        for (VAddr vaddr : PhysicalToVirtualAddressForRasterizer(paddr)) {
+            impl->dirty_marker.Mark(vaddr, dirty);
+        }
+    }
+}
+
 void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached) {
     if (start == 0) {
         return;
     }
 
+    // The emulation thread walks the page tables without locking, so the GPU thread leaves them
+    // alone. Its marks only need to land before the guest learns the GPU work is done, which the
+    // emulation thread can only do after applying them.
+    if (deferring_memory == this) {
+        std::scoped_lock lock{impl->pending_marks_mutex};
+        impl->pending_marks.push_back(
+            {&MemorySystem::RasterizerMarkRegionCached, start, size, cached});
+        impl->has_pending_marks.store(true, std::memory_order::release);
+        return;
+    }
+
     u32 num_pages = ((start + size - 1) >> CITRA_PAGE_BITS) - (start >> CITRA_PAGE_BITS) + 1;
     PAddr paddr = start;
 
@@ -727,7 +929,8 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
         for (VAddr vaddr : PhysicalToVirtualAddressForRasterizer(paddr)) {
             impl->cache_marker.Mark(vaddr, cached);
             for (auto& page_table : impl->page_table_list) {
-                PageType& page_type = page_table->attributes[vaddr >> CITRA_PAGE_BITS];
+                const VAddr page = vaddr >> CITRA_PAGE_BITS;
+                const PageType page_type = page_table->attributes[page];
 
                 if (cached) {
                     // Switch page type to cached if now cached
@@ -737,8 +940,8 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
                         // address space, for example, a system module need not have a VRAM mapping.
                         break;
                     case PageType::Memory:
-                        page_type = PageType::RasterizerCachedMemory;
-                        page_table->pointers[vaddr >> CITRA_PAGE_BITS] = nullptr;
+                        page_table->attributes.Set(page, PageType::RasterizerCachedMemory);
+                        page_table->pointers[page] = nullptr;
                         break;
                     default:
                         UNREACHABLE();
@@ -751,8 +954,8 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
                         // address space, for example, a system module need not have a VRAM mapping.
                         break;
                     case PageType::RasterizerCachedMemory: {
-                        page_type = PageType::Memory;
-                        page_table->pointers[vaddr >> CITRA_PAGE_BITS] =
+                        page_table->attributes.Set(page, PageType::Memory);
+                        page_table->pointers[page] =
                             GetPointerForRasterizerCache(vaddr & ~CITRA_PAGE_MASK);
                         break;
                     }
@@ -765,6 +968,26 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
     }
 }
 
+void MemorySystem::DeferRasterizerMarks() {
+    deferring_memory = this;
+}
+
+void MemorySystem::ApplyPendingRasterizerMarks() {
+    if (!impl->has_pending_marks.load(std::memory_order::acquire)) {
+        return;
+    }
+
+    std::vector<Impl::PendingMark> marks;
+    {
+        std::scoped_lock lock{impl->pending_marks_mutex};
+        marks.swap(impl->pending_marks);
+        impl->has_pending_marks.store(false, std::memory_order::relaxed);
+    }
+    for (const auto& mark : marks) {
+        (this->*mark.mark)(mark.start, mark.size, mark.value);
+    }
+}
+
 u8 MemorySystem::Read8(const VAddr addr) {
     return Read<u8>(addr);
 }
@@ -836,45 +1059,27 @@ void MemorySystem::WriteBlock(const VAddr dest_addr, const void* src_buffer,
 
 void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_addr,
                              const std::size_t size) {
-    auto& page_table = *process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = dest_addr >> CITRA_PAGE_BITS;
-    std::size_t page_offset = dest_addr & CITRA_PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr =
-            static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                      "0x{:08X}",
-                      current_vaddr, dest_addr, size, impl->GetPC());
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-            std::memset(dest_ptr, 0, copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Invalidate);
-            std::memset(GetPointerForRasterizerCache(current_vaddr), 0, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        remaining_size -= copy_amount;
-    }
+    impl->ForEachRun(*process.vm_manager.page_table, dest_addr, size,
+                     [&](PageType type, VAddr vaddr, u8* dest_ptr, std::size_t run_size) {
+                         switch (type) {
+                         case PageType::Unmapped:
+                             LOG_ERROR(HW_Memory,
+                                       "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                       "size = {}) at PC 0x{:08X}",
+                                       vaddr, dest_addr, size, impl->GetPC());
+                             break;
+                         case PageType::Memory:
+                             std::memset(dest_ptr, 0, run_size);
+                             break;
+                         case PageType::RasterizerCachedMemory:
+                             RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(run_size),
+                                                          FlushMode::Invalidate);
+                             std::memset(dest_ptr, 0, run_size);
+                             break;
+                         default:
+                             UNREACHABLE();
+                         }
+                     });
 }
 
 void MemorySystem::CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
@@ -885,63 +1090,45 @@ void MemorySystem::CopyBlock(const Kernel::Process& process, VAddr dest_addr, VA
 void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
                              const Kernel::Process& src_process, VAddr dest_addr, VAddr src_addr,
                              std::size_t size) {
-    auto& page_table = *src_process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> CITRA_PAGE_BITS;
-    std::size_t page_offset = src_addr & CITRA_PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr =
-            static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                      "0x{:08X}",
-                      current_vaddr, src_addr, size, impl->GetPC());
-            ZeroBlock(dest_process, dest_addr, copy_amount);
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            WriteBlock(dest_process, dest_addr, GetPointerForRasterizerCache(current_vaddr),
-                       copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
-    }
+    // Each contiguous source run is written in turn, which splits it again over the destination
+    impl->ForEachRun(*src_process.vm_manager.page_table, src_addr, size,
+                     [&](PageType type, VAddr vaddr, const u8* src_ptr, std::size_t run_size) {
+                         const VAddr run_dest = dest_addr + (vaddr - src_addr);
+                         switch (type) {
+                         case PageType::Unmapped:
+                             LOG_ERROR(HW_Memory,
+                                       "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                       "size = {}) at PC 0x{:08X}",
+                                       vaddr, src_addr, size, impl->GetPC());
+                             ZeroBlock(dest_process, run_dest, run_size);
+                             break;
+                         case PageType::Memory:
+                             WriteBlock(dest_process, run_dest, src_ptr, run_size);
+                             break;
+                         case PageType::RasterizerCachedMemory:
+                             RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(run_size),
+                                                          FlushMode::Flush);
+                             WriteBlock(dest_process, run_dest, src_ptr, run_size);
+                             break;
+                         default:
+                             UNREACHABLE();
+                         }
+                     });
 }
 
 u32 MemorySystem::GetFCRAMOffset(const u8* pointer) const {
-    ASSERT(pointer >= impl->fcram.get() && pointer <= impl->fcram.get() + Memory::FCRAM_N3DS_SIZE);
-    return static_cast<u32>(pointer - impl->fcram.get());
+    ASSERT(pointer >= impl->fcram && pointer <= impl->fcram + Memory::FCRAM_N3DS_SIZE);
+    return static_cast<u32>(pointer - impl->fcram);
 }
 
 u8* MemorySystem::GetFCRAMPointer(std::size_t offset) {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 const u8* MemorySystem::GetFCRAMPointer(std::size_t offset) const {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 MemoryRef MemorySystem::GetFCRAMRef(std::size_t offset) const {
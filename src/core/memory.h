@@ -3,12 +3,18 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <memory>
+#include <optional>
 #include <string>
+#include <type_traits>
 #include <boost/serialization/array.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
+#include "common/host_memory.h"
 #include "common/memory_ref.h"
 
 namespace Kernel {
@@ -44,6 +50,91 @@ enum class PageType {
     RasterizerCachedMemory,
 };
 
+/**
+ * Two-level table of per-page values. The address space is split in regions of
+ * 2^REGION_BITS pages whose tables are only allocated once one of their pages is set to a
+ * non-default value, so that the sparse address space of a process costs memory proportional to
+ * what it actually maps. Pages of regions without a table read as the default value.
+ */
+template <typename T>
+class SparsePageArray {
+public:
+    static constexpr std::size_t REGION_BITS = 10;
+    static constexpr std::size_t REGION_PAGES = std::size_t{1} << REGION_BITS;
+    static constexpr std::size_t NUM_REGIONS = PAGE_TABLE_NUM_ENTRIES >> REGION_BITS;
+
+    const T& operator[](std::size_t idx) const {
+        const auto& region = regions[idx >> REGION_BITS];
+        return region ? (*region)[idx & (REGION_PAGES - 1)] : default_value;
+    }
+
+    void Set(std::size_t idx, T value) {
+        auto& region = regions[idx >> REGION_BITS];
+        if (!region) {
+            if (IsDefault(value)) {
+                return;
+            }
+            region = std::make_unique<Region>();
+        }
+        (*region)[idx & (REGION_PAGES - 1)] = std::move(value);
+    }
+
+    /// Frees all regions, resetting every page to the default value.
+    void Clear() {
+        for (auto& region : regions) {
+            region.reset();
+        }
+    }
+
+    /// Returns the number of regions that have a table allocated.
+    std::size_t AllocatedRegions() const {
+        return static_cast<std::size_t>(std::count_if(
+            regions.begin(), regions.end(), [](const auto& region) { return region != nullptr; }));
+    }
+
+private:
+    using Region = std::array<T, REGION_PAGES>;
+
+    static bool IsDefault(const T& value) {
+        if constexpr (std::is_same_v<T, MemoryRef>) {
+            return !value;
+        } else {
+            return value == T{};
+        }
+    }
+
+    std::array<std::unique_ptr<Region>, NUM_REGIONS> regions{};
+    static inline const T default_value{};
+
+    template <class Archive>
+    void save(Archive& ar, const unsigned int) const {
+        for (const auto& region : regions) {
+            const bool allocated = region != nullptr;
+            ar << allocated;
+            if (allocated) {
+                ar << *region;
+            }
+        }
+    }
+
+    template <class Archive>
+    void load(Archive& ar, const unsigned int) {
+        for (auto& region : regions) {
+            bool allocated;
+            ar >> allocated;
+            if (allocated) {
+                region = std::make_unique<Region>();
+                ar >> *region;
+            } else {
+                region.reset();
+            }
+        }
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+    friend class boost::serialization::access;
+};
+
 /**
  * A (reasonably) fast way of allowing switchable and remappable process address spaces. It loosely
  * mimics the way a real CPU page table works, but instead is optimized for minimal decoding and
@@ -57,15 +148,18 @@ struct PageTable {
      */
 
     // The reason for this rigmarole is to keep the 'raw' and 'refs' arrays in sync.
-    // We need 'raw' for dynarmic and 'refs' for serialization
+    // We need 'raw' for dynarmic and 'refs' for serialization. Only 'raw' is flat since dynarmic
+    // indexes it directly, 'refs' is by far the largest and is only allocated where mapped.
     struct Pointers {
 
         struct Entry {
             Entry(Pointers& pointers_, VAddr idx_) : pointers(pointers_), idx(idx_) {}
 
             Entry& operator=(MemoryRef value) {
-                pointers.raw[idx] = value.GetPtr();
-                pointers.refs[idx] = std::move(value);
+                pointers.Set(idx, std::move(value));
+                if (pointers.fastmem_arena) {
+                    pointers.UpdateFastmem(idx);
+                }
                 return *this;
             }
 
@@ -83,8 +177,22 @@ struct PageTable {
         }
 
     private:
+        /// Sets the pointer of the page at idx, leaving the fastmem arena untouched.
+        void Set(VAddr idx, MemoryRef value) {
+            raw[idx] = value.GetPtr();
+            refs.Set(idx, std::move(value));
+        }
+
+        /// Returns the offset in host memory of the page at idx if it can be mirrored by fastmem.
+        std::optional<std::size_t> HostOffset(VAddr idx) const;
+
+        /// Mirrors the page at idx into the fastmem arena, or makes it fault if it has no pointer.
+        void UpdateFastmem(VAddr idx);
+
         std::array<u8*, PAGE_TABLE_NUM_ENTRIES> raw;
-        std::array<MemoryRef, PAGE_TABLE_NUM_ENTRIES> refs;
+        SparsePageArray<MemoryRef> refs;
+        const Common::HostMemory* host_memory{};
+        Common::VirtualArena* fastmem_arena{};
         friend struct PageTable;
     };
 
@@ -94,21 +202,45 @@ struct PageTable {
      * Array of fine grained page attributes. If it is set to any value other than `Memory`, then
      * the corresponding entry in `pointers` MUST be set to null.
      */
-    std::array<PageType, PAGE_TABLE_NUM_ENTRIES> attributes;
+    SparsePageArray<PageType> attributes;
 
     std::array<u8*, PAGE_TABLE_NUM_ENTRIES>& GetPointerArray() {
         return pointers.raw;
     }
 
+    /// Returns the base of the flat host view of this address space, null if fastmem is disabled.
+    u8* GetFastmemPointer() {
+        return fastmem_arena ? fastmem_arena->VirtualBasePointer() : nullptr;
+    }
+
+    /**
+     * Creates the fastmem arena for this page table and maps all pages that are already mapped.
+     * If the arena already exists, its mappings are brought up to date with the pointers instead.
+     */
+    void EnableFastmem(Common::HostMemory& host_memory);
+
+    /**
+     * Sets the pointer of a page without mirroring it into the fastmem arena. Used when setting
+     * a range of pages, which must then be brought up to date at once with UpdateFastmem.
+     */
+    void SetPointerDeferred(VAddr page, MemoryRef memory) {
+        pointers.Set(page, std::move(memory));
+    }
+
+    /// Mirrors a range of pages into the fastmem arena, with one call per contiguous run.
+    void UpdateFastmem(VAddr base, u32 num_pages);
+
     void Clear();
 
 private:
+    std::unique_ptr<Common::VirtualArena> fastmem_arena;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
         ar& pointers.refs;
         ar& attributes;
         for (std::size_t i = 0; i < PAGE_TABLE_NUM_ENTRIES; i++) {
-            pointers.raw[i] = pointers.refs[i].GetPtr();
+            pointers.raw[i] = const_cast<u8*>(pointers.refs[i].GetPtr());
         }
     }
     friend class boost::serialization::access;
@@ -516,6 +648,26 @@ public:
      */
     void RasterizerMarkRegionCached(PAddr start, u32 size, bool cached);
 
+    /**
+     * Makes the calling thread queue its RasterizerMarkRegionCached and RasterizerMarkRegionDirty
+     * calls instead of applying them, as the page tables belong to the emulation thread. Used by
+     * the GPU thread.
+     */
+    void DeferRasterizerMarks();
+
+    /// Applies the rasterizer marks queued by the GPU thread. Called from the emulation thread.
+    void ApplyPendingRasterizerMarks();
+
+    /**
+     * Marks each page within the specified address range as holding GPU writes that have not
+     * been flushed back yet. Reads from cached pages that are not dirty skip the rasterizer flush.
+     *
+     * @param start The physical address indicating the start of the address range.
+     * @param size  The size of the address range in bytes.
+     * @param dirty Whether or not any pages within the address range hold unflushed GPU writes.
+     */
+    void RasterizerMarkRegionDirty(PAddr start, u32 size, bool dirty);
+
     /// For a rasterizer-accessible PAddr, gets a list of all possible VAddr
     std::vector<VAddr> PhysicalToVirtualAddressForRasterizer(PAddr addr);
 
@@ -3,7 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
+#include <deque>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -14,6 +18,7 @@
 #include "common/bit_field.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/polyfill_thread.h"
 #include "common/scm_rev.h"
 #include "common/swap.h"
 #include "common/timer.h"
@@ -127,6 +132,90 @@ struct CTMHeader {
 static_assert(sizeof(CTMHeader) == 256, "CTMHeader should be 256 bytes");
 #pragma pack(pop)
 
+/// Recorded input handed to the writer once this much of it is pending, every few seconds
+constexpr std::size_t FLUSH_SIZE = 16 * 1024;
+
+/**
+ * Writes the movie file of a recording on a background thread. The input is appended in chunks,
+ * each followed by a rewrite of the header with the matching input count, so that the file is a
+ * valid movie after every flush.
+ */
+class MovieWriter {
+public:
+    explicit MovieWriter(const std::string& path) : file{path, "wb"} {
+        if (!file.IsGood()) {
+            LOG_ERROR(Movie, "Unable to open file to save movie");
+        }
+        thread = std::jthread([this](std::stop_token stop_token) { WriterLoop(stop_token); });
+    }
+
+    ~MovieWriter() {
+        Wait();
+    }
+
+    /// Queues the write of the input from offset on, truncating the file past it.
+    void Write(const CTMHeader& header, std::size_t offset, std::vector<u8> data) {
+        {
+            std::scoped_lock lock{mutex};
+            chunks.push_back({header, offset, std::move(data)});
+        }
+        chunk_cv.notify_one();
+    }
+
+    /// Waits for the queued writes. Returns false if any of them failed.
+    bool Wait() {
+        std::unique_lock lock{mutex};
+        done_cv.wait(lock, [this] { return chunks.empty() && !writing; });
+        return file.IsGood();
+    }
+
+private:
+    struct Chunk {
+        CTMHeader header;
+        std::size_t offset;
+        std::vector<u8> data;
+    };
+
+    void WriterLoop(std::stop_token stop_token) {
+        while (true) {
+            std::unique_lock lock{mutex};
+            Common::CondvarWait(chunk_cv, lock, stop_token, [this] { return !chunks.empty(); });
+            if (chunks.empty()) {
+                return;
+            }
+            Chunk chunk = std::move(chunks.front());
+            chunks.pop_front();
+            writing = true;
+            lock.unlock();
+
+            const u64 input_end = sizeof(CTMHeader) + chunk.offset + chunk.data.size();
+            file.Seek(sizeof(CTMHeader) + chunk.offset, SEEK_SET);
+            file.WriteBytes(chunk.data.data(), chunk.data.size());
+            if (file.GetSize() > input_end) {
+                file.Resize(input_end);
+            }
+            file.Seek(0, SEEK_SET);
+            file.WriteBytes(&chunk.header, sizeof(CTMHeader));
+            file.Flush();
+            if (!file.IsGood()) {
+                LOG_ERROR(Movie, "Error saving movie");
+            }
+
+            lock.lock();
+            writing = false;
+            done_cv.notify_all();
+        }
+    }
+
+    FileUtil::IOFile file;
+    std::mutex mutex;
+    std::condition_variable_any chunk_cv;
+    std::condition_variable done_cv;
+    std::deque<Chunk> chunks;
+    bool writing = false;
+    std::jthread thread;
+};
+
 static u64 GetInputCount(std::span<const u8> input) {
     u64 input_count = 0;
     for (std::size_t pos = 0; pos < input.size(); pos += sizeof(ControllerState)) {
@@ -181,6 +270,9 @@ void Movie::serialize(Archive& ar, const unsigned int file_version) {
 
     if (Archive::is_loading::value && id != 0) {
         if (!read_only) {
+            // Rewrite the movie file from where the timeline of the state diverges
+            const auto common_end = std::ranges::mismatch(recorded_input, recorded_input_).in1;
+            flushed_byte = std::min<std::size_t>(flushed_byte, common_end - recorded_input.begin());
             recorded_input = std::move(recorded_input_);
         }
 
@@ -192,6 +284,7 @@ void Movie::serialize(Archive& ar, const unsigned int file_version) {
         if (read_only) {
             if (play_mode == PlayMode::Recording) {
                 SaveMovie();
+                writer.reset();
             }
             if (recorded_input_.size() >= recorded_input.size()) {
                 throw std::runtime_error("Future event savestate not allowed in R/O mode");
@@ -206,8 +299,13 @@ void Movie::serialize(Archive& ar, const unsigned int file_version) {
             play_mode = PlayMode::Playing;
             total_input = GetInputCount(recorded_input);
         } else {
-            play_mode = PlayMode::Recording;
             rerecord_count++;
+            if (play_mode == PlayMode::Recording) {
+                FlushRecording(GetInputCount(recorded_input));
+            } else {
+                play_mode = PlayMode::Recording;
+                StartWriter();
+            }
         }
     }
 }
@@ -361,6 +459,10 @@ void Movie::Record(const ControllerState& controller_state) {
     recorded_input.resize(current_byte + sizeof(ControllerState));
     std::memcpy(&recorded_input[current_byte], &controller_state, sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
+
+    if (current_byte - flushed_byte >= FLUSH_SIZE) {
+        FlushRecording(current_input);
+    }
 }
 
 void Movie::Record(const Service::HID::PadState& pad_state, const s16& circle_pad_x,
@@ -480,15 +582,7 @@ Movie::ValidationResult Movie::ValidateInput(std::span<const u8> input, u64 expe
                                                   : ValidationResult::InputCountDismatch;
 }
 
-void Movie::SaveMovie() {
-    LOG_INFO(Movie, "Saving recorded movie to '{}'", record_movie_file);
-    FileUtil::IOFile save_record(record_movie_file, "wb");
-
-    if (!save_record.IsGood()) {
-        LOG_ERROR(Movie, "Unable to open file to save movie");
-        return;
-    }
-
+CTMHeader Movie::MakeHeader(u64 input_count) const {
     CTMHeader header = {};
     header.filetype = header_magic_bytes;
     header.program_id = program_id;
@@ -500,17 +594,35 @@ void Movie::SaveMovie() {
                 std::min(header.author.size(), record_movie_author.size()));
 
     header.rerecord_count = rerecord_count;
-    header.input_count = GetInputCount(recorded_input);
+    header.input_count = input_count;
 
     std::string rev_bytes;
     CryptoPP::StringSource(Common::g_scm_rev, true,
                            new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
     std::memcpy(header.revision.data(), rev_bytes.data(), sizeof(CTMHeader::revision));
+    return header;
+}
 
-    save_record.WriteBytes(&header, sizeof(CTMHeader));
-    save_record.WriteBytes(recorded_input.data(), recorded_input.size());
+void Movie::StartWriter() {
+    writer = std::make_unique<MovieWriter>(record_movie_file);
+    flushed_byte = 0;
+    FlushRecording(GetInputCount(recorded_input));
+}
+
+void Movie::FlushRecording(u64 input_count) {
+    std::vector<u8> data(recorded_input.begin() + flushed_byte, recorded_input.end());
+    writer->Write(MakeHeader(input_count), flushed_byte, std::move(data));
+    flushed_byte = recorded_input.size();
+}
 
-    if (!save_record.IsGood()) {
+void Movie::SaveMovie() {
+    LOG_INFO(Movie, "Saving recorded movie to '{}'", record_movie_file);
+    if (!writer) {
+        StartWriter();
+    } else {
+        FlushRecording(GetInputCount(recorded_input));
+    }
+    if (!writer->Wait()) {
         LOG_ERROR(Movie, "Error saving movie");
     }
 }
@@ -567,6 +679,8 @@ void Movie::StartRecording(const std::string& movie_file, const std::string& aut
     program_id = 0;
     system.GetAppLoader().ReadProgramId(program_id);
 
+    StartWriter();
+
     LOG_INFO(Movie, "Enabling Movie recording, ID: {:016X}", id);
 }
 
@@ -665,6 +779,7 @@ void Movie::Shutdown() {
         SaveMovie();
     }
 
+    writer.reset();
     play_mode = PlayMode::None;
     recorded_input.resize(0);
     record_movie_file.clear();
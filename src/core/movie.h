@@ -5,6 +5,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <span>
 #include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
@@ -25,6 +26,7 @@ union PadState;
 namespace Core {
 
 class System;
+class MovieWriter;
 struct CTMHeader;
 struct ControllerState;
 
@@ -135,7 +137,8 @@ public:
 
     /**
      * Saves the movie immediately, in its current state.
-     * This is called in Shutdown.
+     * This is called in Shutdown. While recording, the input is also appended to the movie file
+     * periodically, so that a crash only loses the last few seconds of it.
      */
     void SaveMovie();
 
@@ -161,6 +164,10 @@ private:
     void Record(const Service::IR::PadState& pad_state, const s16& c_stick_x, const s16& c_stick_y);
     void Record(const Service::IR::ExtraHIDResponse& extra_hid_response);
 
+    CTMHeader MakeHeader(u64 input_count) const;
+    void StartWriter();
+    void FlushRecording(u64 input_count);
+
     ValidationResult ValidateHeader(const CTMHeader& header) const;
     ValidationResult ValidateInput(std::span<const u8> input, u64 expected_count) const;
 
@@ -176,6 +183,10 @@ private:
 
     std::vector<u8> recorded_input;
     std::size_t current_byte = 0;
+    /// Appends the recorded input to the movie file while recording
+    std::unique_ptr<MovieWriter> writer;
+    /// Size of the recorded input already handed to the writer
+    std::size_t flushed_byte = 0;
     u64 current_input = 0;
     // Total input count of the current movie being played. Not used for recording.
     u64 total_input = 0;
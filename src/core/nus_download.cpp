@@ -2,22 +2,162 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <deque>
+#include <future>
 #include <memory>
 #include <httplib.h>
+#include "common/literals.h"
 #include "common/logging/log.h"
+#include "common/thread_worker.h"
 #include "core/nus_download.h"
 
 namespace Core::NUS {
 
-std::optional<std::vector<u8>> Download(const std::string& path) {
-    constexpr auto HOST = "http://nus.cdn.c.shop.nintendowifi.net";
+using namespace Common::Literals;
 
-    std::unique_ptr<httplib::Client> client = std::make_unique<httplib::Client>(HOST);
-    if (client == nullptr) {
-        LOG_ERROR(WebService, "Invalid URL {}{}", HOST, path);
-        return {};
+constexpr auto HOST = "http://nus.cdn.c.shop.nintendowifi.net";
+
+/// Size of the range requests that large files are split into
+constexpr u64 ChunkSize = 1_MiB;
+/// Number of connections downloading the chunks of a file at the same time
+constexpr std::size_t NumConnections = 4;
+/// Chunks downloaded ahead of the one being received, which bounds the memory used
+constexpr std::size_t MaxChunksAhead = 2 * NumConnections;
+
+using Chunk = std::optional<std::vector<u8>>;
+
+static std::unique_ptr<httplib::Client> MakeClient() {
+    auto client = std::make_unique<httplib::Client>(HOST);
+    client->set_follow_location(true);
+    client->set_keep_alive(true);
+    return client;
+}
+
+/// Downloads a range of a file, retrying once if the transfer is interrupted.
+static Chunk DownloadRange(httplib::Client& client, const std::string& path, u64 offset,
+                           u64 size) {
+    const httplib::Headers headers{httplib::make_range_header(
+        {{static_cast<ssize_t>(offset), static_cast<ssize_t>(offset + size - 1)}})};
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        std::vector<u8> data;
+        data.reserve(size);
+        int status = 0;
+        const auto result = client.Get(
+            path, headers,
+            [&status](const httplib::Response& response) {
+                // Don't receive the whole file if the server ignores the range
+                status = response.status;
+                return status == 206;
+            },
+            [&data](const char* chunk, std::size_t length) {
+                data.insert(data.end(), chunk, chunk + length);
+                return true;
+            });
+        if (status != 0 && status != 206) {
+            LOG_ERROR(WebService, "GET of range {:x}+{:x} of {}{} returned status code: {}",
+                      offset, size, HOST, path, status);
+            return std::nullopt;
+        }
+        if (result && data.size() == size) {
+            return data;
+        }
+        LOG_WARNING(WebService, "GET of range {:x}+{:x} of {}{} was interrupted", offset, size,
+                    HOST, path);
+    }
+    return std::nullopt;
+}
+
+struct Downloader::Impl {
+    using Workers = Common::StatefulThreadWorker<std::unique_ptr<httplib::Client>>;
+
+    bool Stream(const std::string& path, u64 size, const Receiver& receiver) {
+        u64 received = 0;
+        const auto result = client->Get(
+            path,
+            [&path](const httplib::Response& response) {
+                if (response.status >= 400) {
+                    LOG_ERROR(WebService, "GET to {}{} returned error status code: {}", HOST,
+                              path, response.status);
+                    return false;
+                }
+                return true;
+            },
+            [&received, &receiver](const char* data, std::size_t length) {
+                received += length;
+                return receiver({reinterpret_cast<const u8*>(data), length});
+            });
+        if (!result) {
+            LOG_ERROR(WebService, "GET to {}{} returned null", HOST, path);
+            return false;
+        }
+        if (received != size) {
+            LOG_ERROR(WebService, "GET to {}{} returned {:x} bytes instead of {:x}", HOST, path,
+                      received, size);
+            return false;
+        }
+        return true;
     }
 
+    bool StreamChunked(const std::string& path, u64 size, const Receiver& receiver) {
+        if (!workers) {
+            workers = std::make_unique<Workers>(NumConnections, "NUS download",
+                                                Common::ThreadRole::Background,
+                                                [](std::size_t) { return MakeClient(); });
+        }
+
+        const u64 num_chunks = (size + ChunkSize - 1) / ChunkSize;
+        u64 next_chunk = 0;
+        std::deque<std::future<Chunk>> pending;
+        const auto queue_chunk = [&] {
+            const u64 offset = next_chunk++ * ChunkSize;
+            const u64 chunk_size = std::min(ChunkSize, size - offset);
+            std::promise<Chunk> promise;
+            pending.push_back(promise.get_future());
+            workers->QueueWork([promise = std::move(promise), path, offset,
+                                chunk_size](std::unique_ptr<httplib::Client>* client) mutable {
+                promise.set_value(DownloadRange(**client, path, offset, chunk_size));
+            });
+        };
+
+        while (next_chunk < num_chunks && pending.size() < MaxChunksAhead) {
+            queue_chunk();
+        }
+        bool first_chunk = true;
+        while (!pending.empty()) {
+            const Chunk chunk = pending.front().get();
+            pending.pop_front();
+            if (!chunk && first_chunk) {
+                // Nothing was received yet, so the file can still be downloaded in one request
+                LOG_WARNING(WebService, "Range requests failed, downloading {}{} at once", HOST,
+                            path);
+                supports_ranges = false;
+                return Stream(path, size, receiver);
+            }
+            if (!chunk || !receiver(*chunk)) {
+                return false;
+            }
+            first_chunk = false;
+            if (next_chunk < num_chunks) {
+                queue_chunk();
+            }
+        }
+        return true;
+    }
+
+    /// Connection used for the small files, on the calling thread
+    std::unique_ptr<httplib::Client> client = MakeClient();
+    /// Downloads the chunks of large files, each worker with a connection of its own
+    std::unique_ptr<Workers> workers;
+    bool supports_ranges = true;
+};
+
+Downloader::Downloader() : impl{std::make_unique<Impl>()} {}
+
+Downloader::~Downloader() = default;
+
+std::optional<std::vector<u8>> Downloader::Download(const std::string& path) {
     httplib::Request request{
         .method = "GET",
         .path = path,
@@ -25,8 +165,7 @@ std::optional<std::vector<u8>> Download(const std::string& path) {
         .matches = httplib::Match(),
     };
 
-    client->set_follow_location(true);
-    const auto result = client->send(request);
+    const auto result = impl->client->send(request);
     if (!result) {
         LOG_ERROR(WebService, "GET to {}{} returned null", HOST, path);
         return {};
@@ -46,4 +185,11 @@ std::optional<std::vector<u8>> Download(const std::string& path) {
     return std::vector<u8>(response.body.begin(), response.body.end());
 }
 
+bool Downloader::Download(const std::string& path, u64 size, const Receiver& receiver) {
+    if (size <= ChunkSize || !impl->supports_ranges) {
+        return impl->Stream(path, size, receiver);
+    }
+    return impl->StreamChunked(path, size, receiver);
+}
+
 } // namespace Core::NUS
@@ -4,12 +4,44 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <optional>
+#include <span>
+#include <string>
 #include <vector>
 #include "common/common_types.h"
 
 namespace Core::NUS {
 
-std::optional<std::vector<u8>> Download(const std::string& path);
+/**
+ * Downloads the files of a title from the Nintendo Update Server. The connections are kept open
+ * between the files, and large files are downloaded as several range requests at the same time.
+ */
+class Downloader {
+public:
+    /// Called with consecutive parts of a file, returns false to abort the download
+    using Receiver = std::function<bool(std::span<const u8>)>;
+
+    Downloader();
+    ~Downloader();
+
+    /// Downloads a small file, like a title metadata or a ticket, into memory.
+    std::optional<std::vector<u8>> Download(const std::string& path);
+
+    /**
+     * Downloads a file, passing its data in order to a receiver as it arrives instead of
+     * buffering the whole file.
+     * @param path Path of the file on the server
+     * @param size Size of the file, as given by the title metadata
+     * @param receiver Receiver of the data
+     * @return Whether the whole file was downloaded and received
+     */
+    bool Download(const std::string& path, u64 size, const Receiver& receiver);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
 
 } // namespace Core::NUS
@@ -67,6 +67,16 @@ void PerfStats::EndSystemFrame() {
 
     previous_frame_length = frame_end - previous_frame_end;
     previous_frame_end = frame_end;
+    previous_frame_time = frame_time;
+
+    last_frame_stats.frametime = frame_time;
+    for (std::size_t i = 0; i < NumFrameTimers; i++) {
+        last_frame_stats.times[i] =
+            std::chrono::nanoseconds{frame_times[i].exchange(0, std::memory_order_relaxed)};
+    }
+    for (std::size_t i = 0; i < NumFrameCounters; i++) {
+        last_frame_stats.counts[i] = frame_counts[i].exchange(0, std::memory_order_relaxed);
+    }
 }
 
 void PerfStats::EndGameFrame() {
@@ -75,6 +85,54 @@ void PerfStats::EndGameFrame() {
     game_frames += 1;
 }
 
+void PerfStats::AddSkippedIdleCycles(s64 cycles) {
+    std::scoped_lock lock{object_mutex};
+
+    skipped_idle_cycles += cycles;
+}
+
+void PerfStats::RecordInputSample(Clock::duration input_age) {
+    std::scoped_lock lock{object_mutex};
+
+    if (!pending_input_sample) {
+        pending_input_sample = Clock::now() - input_age;
+    }
+}
+
+void PerfStats::RecordFramePresented() {
+    std::scoped_lock lock{object_mutex};
+
+    if (!pending_input_sample) {
+        return;
+    }
+    accumulated_input_latency += Clock::now() - *pending_input_sample;
+    ++input_latency_samples;
+    pending_input_sample.reset();
+}
+
+void PerfStats::RecordDisplayLatency(Clock::duration latency) {
+    std::scoped_lock lock{object_mutex};
+
+    accumulated_display_latency += latency;
+    ++display_latency_samples;
+}
+
+void PerfStats::AddFrameTime(FrameTimer timer, Clock::duration time) {
+    frame_times[static_cast<std::size_t>(timer)].fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+        std::memory_order_relaxed);
+}
+
+void PerfStats::CountFrameEvent(FrameCounter counter, u32 count) {
+    frame_counts[static_cast<std::size_t>(counter)].fetch_add(count, std::memory_order_relaxed);
+}
+
+PerfStats::FrameStats PerfStats::GetLastFrameStats() const {
+    std::scoped_lock lock{object_mutex};
+
+    return last_frame_stats;
+}
+
 double PerfStats::GetMeanFrametime() const {
     std::scoped_lock lock{object_mutex};
 
@@ -87,6 +145,15 @@ double PerfStats::GetMeanFrametime() const {
     return sum / static_cast<double>(current_index - IgnoreFrames);
 }
 
+std::vector<double> PerfStats::GetFrametimeHistory() const {
+    std::scoped_lock lock{object_mutex};
+
+    if (current_index <= IgnoreFrames) {
+        return {};
+    }
+    return {perf_history.begin() + IgnoreFrames, perf_history.begin() + current_index};
+}
+
 PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us) {
     std::scoped_lock lock{object_mutex};
 
@@ -101,6 +168,20 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     last_stats.frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                            static_cast<double>(system_frames);
     last_stats.emulation_speed = system_us_per_second.count() / 1'000'000.0;
+    const auto system_us = current_system_time_us - reset_point_system_us;
+    last_stats.idle_skipped =
+        system_us.count() > 0
+            ? static_cast<double>(cyclesToUs(skipped_idle_cycles)) / system_us.count()
+            : 0.0;
+    last_stats.input_latency =
+        input_latency_samples > 0
+            ? duration_cast<DoubleSecs>(accumulated_input_latency).count() / input_latency_samples
+            : 0.0;
+    last_stats.display_latency =
+        display_latency_samples > 0
+            ? duration_cast<DoubleSecs>(accumulated_display_latency).count() /
+                  display_latency_samples
+            : 0.0;
 
     // Reset counters
     reset_point = now;
@@ -108,6 +189,11 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
+    skipped_idle_cycles = 0;
+    accumulated_input_latency = Clock::duration::zero();
+    input_latency_samples = 0;
+    accumulated_display_latency = Clock::duration::zero();
+    display_latency_samples = 0;
 
     return last_stats;
 }
@@ -125,6 +211,13 @@ double PerfStats::GetLastFrameTimeScale() const {
     return duration_cast<DoubleSecs>(previous_frame_length).count() / FRAME_LENGTH;
 }
 
+std::pair<PerfStats::Clock::time_point, PerfStats::Clock::duration>
+PerfStats::GetLastFrameWorkTime() const {
+    std::scoped_lock lock{object_mutex};
+
+    return {previous_frame_end, previous_frame_time};
+}
+
 void FrameLimiter::WaitOnce() {
     if (frame_advancing_enabled) {
         // Frame advancing is enabled: wait on event instead of doing framelimiting
@@ -144,7 +237,7 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
     auto now = Clock::now();
     double sleep_scale = Settings::values.frame_limit.GetValue() / 100.0;
 
-    if (Settings::values.frame_limit.GetValue() == 0) {
+    if (Settings::values.frame_limit.GetValue() == 0 || Settings::values.turbo_mode.GetValue()) {
         return;
     }
 
@@ -9,6 +9,9 @@
 #include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 #include "common/common_types.h"
 #include "common/thread.h"
 
@@ -34,12 +37,127 @@ public:
         double frametime;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Fraction of emulated time skipped because every CPU core was idle
+        double idle_skipped;
+        /// Mean walltime from the host receiving an input change sampled by the guest to the
+        /// next frame presented, in seconds
+        double input_latency;
+        /// Mean walltime from presenting a frame to the display showing it, in seconds, 0 when
+        /// the presentation engine does not report it
+        double display_latency;
+
+        // Audio output statistics, only filled in by System::GetAndResetPerfStats
+        /// Mean and lowest amount of audio queued for output, in seconds
+        double audio_fill;
+        double audio_min_fill;
+        /// Ratio of the audio produced by the DSP to the audio played by the sink
+        double audio_production_ratio;
+        /// Queued audio consumed per second played by the time stretcher, 0 when not stretching
+        double audio_stretch_ratio;
+        /// Largest jitter of the audio output callbacks, in seconds
+        double audio_callback_jitter;
+        /// Mean walltime spent generating a DSP frame, in seconds, 0 if it is not measured
+        double audio_frame_time;
+        /// Times the audio output ran out of audio or dropped audio since boot
+        u64 audio_underruns;
+        u64 audio_overruns;
+
+        // HLE I/O statistics, only filled in by System::GetAndResetPerfStats
+        /// Mean and largest walltime of the asynchronous HLE I/O requests, from their submission
+        /// to their completion, in seconds
+        double hle_io_latency;
+        double hle_io_max_latency;
+    };
+
+    /// Parts of a frame whose walltime is measured in FrameStats
+    enum class FrameTimer : u32 {
+        CpuSlices,    ///< Running the emulated ARM11 cores, the work of their HLE calls included
+        GpuCommands,  ///< Processing PICA command lists, on the GPU thread if there is one
+        GpuExecution, ///< Executing the frame on the host GPU, measured with timestamp queries
+        PresentWait,  ///< Waiting for a free presentation frame or swapchain image
+        Count,
+    };
+
+    /// Events counted per frame in FrameStats
+    enum class FrameCounter : u32 {
+        ShaderCompiles,   ///< Host shaders compiled, the ones loaded from disk excluded
+        PipelineCompiles, ///< Host pipelines or programs linked
+        CacheFlushes,     ///< Rasterizer cache regions flushed to emulated memory
+        CacheDownloads,   ///< Surfaces downloaded from the host GPU
+        Count,
+    };
+
+    static constexpr std::size_t NumFrameTimers = static_cast<std::size_t>(FrameTimer::Count);
+    static constexpr std::size_t NumFrameCounters = static_cast<std::size_t>(FrameCounter::Count);
+
+    /// Breakdown of a single system frame
+    struct FrameStats {
+        /// Walltime of the frame, excluding frame limiting
+        Clock::duration frametime;
+        /// Walltime of each part of the frame, indexed by FrameTimer. The parts run on different
+        /// threads, so they may add up to more than the frametime.
+        std::array<Clock::duration, NumFrameTimers> times;
+        /// Number of events of the frame, indexed by FrameCounter
+        std::array<u32, NumFrameCounters> counts;
+        /// Audio queued for output at the end of the frame, in seconds. Only filled in by
+        /// System::GetLastFrameStats
+        double audio_fill;
+
+        [[nodiscard]] Clock::duration Time(FrameTimer timer) const {
+            return times[static_cast<std::size_t>(timer)];
+        }
+
+        [[nodiscard]] u32 Count(FrameCounter counter) const {
+            return counts[static_cast<std::size_t>(counter)];
+        }
+    };
+
+    /// Adds the walltime of its scope to a timer of the current frame
+    class ScopedFrameTimer {
+    public:
+        explicit ScopedFrameTimer(PerfStats* perf_stats_, FrameTimer timer_)
+            : perf_stats{perf_stats_}, timer{timer_}, start{Clock::now()} {}
+
+        ~ScopedFrameTimer() {
+            if (perf_stats) {
+                perf_stats->AddFrameTime(timer, Clock::now() - start);
+            }
+        }
+
+    private:
+        PerfStats* perf_stats;
+        FrameTimer timer;
+        Clock::time_point start;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
+    /// Records emulated cycles that were fast-forwarded because every CPU core was idle.
+    void AddSkippedIdleCycles(s64 cycles);
+
+    /**
+     * Records that the guest sampled an input change, starting an input latency measurement.
+     * @param input_age Time elapsed since the host received the input event, if known
+     */
+    void RecordInputSample(Clock::duration input_age = Clock::duration::zero());
+
+    /// Records that a frame reached the presentation engine, ending the pending measurement.
+    void RecordFramePresented();
+
+    /// Records the time between presenting a frame and the display showing it.
+    void RecordDisplayLatency(Clock::duration latency);
+
+    /// Adds walltime spent on a part of the current frame. Lock free, called from any thread.
+    void AddFrameTime(FrameTimer timer, Clock::duration time);
+
+    /// Counts events of the current frame. Lock free, called from any thread.
+    void CountFrameEvent(FrameCounter counter, u32 count = 1);
+
+    /// Returns the breakdown of the previous system frame.
+    FrameStats GetLastFrameStats() const;
+
     Results GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
     Results GetLastStats();
@@ -49,12 +167,24 @@ public:
      */
     double GetMeanFrametime() const;
 
+    /**
+     * Returns the frametime of every system frame stored in the performance history, in
+     * milliseconds, excluding the frames spent booting.
+     */
+    std::vector<double> GetFrametimeHistory() const;
+
     /**
      * Gets the ratio between walltime and the emulated time of the previous system frame. This is
      * useful for scaling inputs or outputs moving between the two time domains.
      */
     double GetLastFrameTimeScale() const;
 
+    /**
+     * Returns when the previous system frame ended and how long it took to emulate, excluding
+     * frame limiting. The latter is the work the host has to fit in each frame.
+     */
+    std::pair<Clock::time_point, Clock::duration> GetLastFrameWorkTime() const;
+
 private:
     mutable std::mutex object_mutex;
 
@@ -77,6 +207,18 @@ private:
     u32 system_frames = 0;
     /// Cumulative number of game frames (GSP frame submissions) since last reset
     u32 game_frames = 0;
+    /// Cumulative number of emulated cycles skipped with every CPU core idle since last reset
+    s64 skipped_idle_cycles = 0;
+    /// Cumulative input latency of the measurements completed since last reset
+    Clock::duration accumulated_input_latency = Clock::duration::zero();
+    /// Number of input latency measurements completed since last reset
+    u32 input_latency_samples = 0;
+    /// Accumulated present to display latency since last reset
+    Clock::duration accumulated_display_latency = Clock::duration::zero();
+    /// Number of display latency measurements since last reset
+    u32 display_latency_samples = 0;
+    /// Point when the oldest input change not yet presented was sampled, if any
+    std::optional<Clock::time_point> pending_input_sample;
 
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end = reset_point;
@@ -84,6 +226,15 @@ private:
     Clock::time_point frame_begin = reset_point;
     /// Total visible duration (including frame-limiting, etc.) of the previous system frame
     Clock::duration previous_frame_length = Clock::duration::zero();
+    /// Time spent emulating the previous system frame, excluding frame-limiting
+    Clock::duration previous_frame_time = Clock::duration::zero();
+
+    /// Timers of the current frame in nanoseconds and its event counts, indexed by FrameTimer and
+    /// FrameCounter. They are updated without the lock by the threads doing the work.
+    std::array<std::atomic<s64>, NumFrameTimers> frame_times{};
+    std::array<std::atomic<u32>, NumFrameCounters> frame_counts{};
+    /// Breakdown of the previous system frame
+    FrameStats last_frame_stats{};
 
     /// Last recorded performance statistics.
     Results last_stats;
@@ -0,0 +1,299 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include "common/archives.h"
+#include "common/assert.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "common/zstd_compression.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/memory.h"
+#include "core/rewind.h"
+
+namespace Core {
+
+namespace {
+
+constexpr std::size_t PAGE_SIZE = Memory::CITRA_PAGE_SIZE;
+
+/// Maximum number of states captured against a keyframe before the next one
+constexpr u32 KEYFRAME_INTERVAL = 30;
+
+/// States are compressed on the emulation thread, which favours speed over ratio
+constexpr s32 COMPRESSION_LEVEL = 1;
+
+struct MemoryRegion {
+    const u8* data;
+    std::size_t size;
+};
+
+/**
+ * Output buffer collecting a serialized state. Writes of the contents of an emulated memory
+ * region are only recorded rather than copied, as they are stored page by page instead.
+ */
+class CaptureStreamBuf final : public std::streambuf {
+public:
+    struct RegionWrite {
+        std::size_t state_offset;
+        const u8* data;
+        std::size_t size;
+    };
+
+    explicit CaptureStreamBuf(std::span<const MemoryRegion> regions_) : regions{regions_} {}
+
+    std::vector<u8> state;
+    std::vector<RegionWrite> region_writes;
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize count) override {
+        const auto* data = reinterpret_cast<const u8*>(s);
+        const auto size = static_cast<std::size_t>(count);
+        const bool is_region = size != 0 && size % PAGE_SIZE == 0 &&
+                               std::ranges::any_of(regions, [&](const MemoryRegion& region) {
+                                   return region.data == data && size <= region.size;
+                               });
+        if (is_region) {
+            region_writes.push_back({state.size(), data, size});
+        } else {
+            state.insert(state.end(), data, data + size);
+        }
+        return count;
+    }
+
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            state.push_back(static_cast<u8>(traits_type::to_char_type(ch)));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+private:
+    std::span<const MemoryRegion> regions;
+};
+
+/// Input buffer reading a serialized state from a sequence of memory spans.
+class RestoreStreamBuf final : public std::streambuf {
+public:
+    explicit RestoreStreamBuf(std::vector<std::span<const u8>> segments_)
+        : segments{std::move(segments_)} {}
+
+protected:
+    int_type underflow() override {
+        while (next_segment < segments.size()) {
+            const auto segment = segments[next_segment++];
+            if (!segment.empty()) {
+                char* const begin =
+                    const_cast<char*>(reinterpret_cast<const char*>(segment.data()));
+                setg(begin, begin, begin + segment.size());
+                return traits_type::to_int_type(*gptr());
+            }
+        }
+        return traits_type::eof();
+    }
+
+private:
+    std::vector<std::span<const u8>> segments;
+    std::size_t next_segment = 0;
+};
+
+/// Compresses a sequence of spans into a single buffer.
+template <typename Func>
+std::vector<u8> CompressSpans(Func&& for_each_span) {
+    std::vector<u8> result;
+    Common::Compression::ZSTDCompressStreamBuf buffer{
+        [&result](std::span<const u8> data) {
+            result.insert(result.end(), data.begin(), data.end());
+            return true;
+        },
+        COMPRESSION_LEVEL, 0};
+    for_each_span([&buffer](std::span<const u8> data) {
+        buffer.sputn(reinterpret_cast<const char*>(data.data()),
+                     static_cast<std::streamsize>(data.size()));
+    });
+    if (!buffer.Finish()) {
+        throw std::runtime_error("Could not compress the rewind state");
+    }
+    result.shrink_to_fit();
+    return result;
+}
+
+} // Anonymous namespace
+
+RewindBuffer::RewindBuffer(System& system_)
+    : system{system_},
+      memory_budget{std::size_t{Settings::values.rewind_buffer_size.GetValue()} * 1024 * 1024},
+      interval{msToCycles(static_cast<int>(Settings::values.rewind_interval.GetValue()))} {}
+
+RewindBuffer::~RewindBuffer() = default;
+
+void RewindBuffer::Tick() {
+    const u64 ticks = system.CoreTiming().GetGlobalTicks();
+    if (ticks < next_capture_ticks) {
+        return;
+    }
+    next_capture_ticks = ticks + interval;
+    try {
+        Capture();
+    } catch (const std::exception& e) {
+        LOG_ERROR(Core, "Could not capture a rewind state: {}", e.what());
+    }
+}
+
+bool RewindBuffer::Rewind() {
+    if (snapshots.empty()) {
+        return false;
+    }
+    Restore(snapshots.back());
+
+    // The next capture is a full interval away from the restored state
+    next_capture_ticks = system.CoreTiming().GetGlobalTicks() + interval;
+    if (snapshots.back().keyframe) {
+        keyframe_hashes.clear();
+    }
+    memory_usage -= snapshots.back().MemoryUsage();
+    snapshots.pop_back();
+    return true;
+}
+
+void RewindBuffer::Clear() {
+    snapshots.clear();
+    memory_usage = 0;
+    keyframe_hashes.clear();
+    states_since_keyframe = 0;
+}
+
+void RewindBuffer::Capture() {
+    auto& memory = system.Memory();
+    const std::array regions{
+        MemoryRegion{memory.GetFCRAMPointer(0), Memory::FCRAM_N3DS_SIZE},
+        MemoryRegion{memory.GetPhysicalPointer(Memory::VRAM_PADDR), Memory::VRAM_SIZE},
+        MemoryRegion{memory.GetPhysicalPointer(Memory::N3DS_EXTRA_RAM_PADDR),
+                     Memory::N3DS_EXTRA_RAM_SIZE},
+    };
+
+    CaptureStreamBuf buffer{regions};
+    {
+        std::ostream stream{&buffer};
+        oarchive oa{stream};
+        oa& system;
+    }
+
+    Snapshot snapshot{};
+    snapshot.state_size = buffer.state.size();
+    snapshot.state = Common::Compression::CompressDataZSTD(buffer.state, COMPRESSION_LEVEL);
+    buffer.state = {};
+
+    // Pages are indexed in the memory image, the regions laid out in the order they were written
+    std::vector<const u8*> page_pointers;
+    std::vector<u64> hashes;
+    for (const auto& write : buffer.region_writes) {
+        snapshot.placements.push_back({write.state_offset, snapshot.image_size, write.size});
+        snapshot.image_size += write.size;
+        for (std::size_t offset = 0; offset < write.size; offset += PAGE_SIZE) {
+            page_pointers.push_back(write.data + offset);
+            hashes.push_back(Common::ComputeFastHash64(write.data + offset, PAGE_SIZE));
+        }
+    }
+
+    snapshot.keyframe =
+        keyframe_hashes.size() != hashes.size() || states_since_keyframe >= KEYFRAME_INTERVAL;
+    if (!snapshot.keyframe) {
+        for (u32 page = 0; page < hashes.size(); page++) {
+            if (hashes[page] != keyframe_hashes[page]) {
+                snapshot.pages.push_back(page);
+            }
+        }
+        // A state that changed most of the memory is cheaper to keep as a keyframe
+        snapshot.keyframe = snapshot.pages.size() > hashes.size() / 2;
+    }
+
+    if (snapshot.keyframe) {
+        snapshot.pages = {};
+        snapshot.data = CompressSpans([&](auto&& write) {
+            for (const auto& region : buffer.region_writes) {
+                write(std::span{region.data, region.size});
+            }
+        });
+        keyframe_hashes = std::move(hashes);
+        states_since_keyframe = 0;
+    } else {
+        snapshot.data = CompressSpans([&](auto&& write) {
+            for (const u32 page : snapshot.pages) {
+                write(std::span{page_pointers[page], PAGE_SIZE});
+            }
+        });
+        snapshot.pages.shrink_to_fit();
+        states_since_keyframe++;
+    }
+    Push(std::move(snapshot));
+}
+
+void RewindBuffer::Restore(const Snapshot& snapshot) {
+    const auto keyframe = std::find_if(snapshots.rbegin(), snapshots.rend(),
+                                       [&](const Snapshot& other) { return other.keyframe; });
+    ASSERT(keyframe != snapshots.rend());
+
+    const std::vector<u8> state = Common::Compression::DecompressDataZSTD(snapshot.state);
+    std::vector<u8> image = Common::Compression::DecompressDataZSTD(keyframe->data);
+    if (state.size() != snapshot.state_size || image.size() != snapshot.image_size) {
+        throw std::runtime_error("Corrupted rewind state");
+    }
+    if (!snapshot.keyframe) {
+        const std::vector<u8> data = Common::Compression::DecompressDataZSTD(snapshot.data);
+        if (data.size() != snapshot.pages.size() * PAGE_SIZE) {
+            throw std::runtime_error("Corrupted rewind state");
+        }
+        for (std::size_t i = 0; i < snapshot.pages.size(); i++) {
+            std::memcpy(image.data() + std::size_t{snapshot.pages[i]} * PAGE_SIZE,
+                        data.data() + i * PAGE_SIZE, PAGE_SIZE);
+        }
+    }
+
+    // Interleave the memory regions back into the serialized state
+    std::vector<std::span<const u8>> segments;
+    std::size_t state_offset = 0;
+    for (const auto& placement : snapshot.placements) {
+        segments.emplace_back(state.data() + state_offset, placement.state_offset - state_offset);
+        segments.emplace_back(image.data() + placement.image_offset, placement.size);
+        state_offset = placement.state_offset;
+    }
+    segments.emplace_back(state.data() + state_offset, state.size() - state_offset);
+
+    RestoreStreamBuf buffer{std::move(segments)};
+    std::istream stream{&buffer};
+    iarchive ia{stream};
+    ia& system;
+}
+
+void RewindBuffer::Push(Snapshot snapshot) {
+    memory_usage += snapshot.MemoryUsage();
+    snapshots.push_back(std::move(snapshot));
+    while (memory_usage > memory_budget && PopFront()) {
+    }
+}
+
+bool RewindBuffer::PopFront() {
+    // The states following a keyframe can't be restored without it, so they are dropped along
+    // with it. The latest keyframe is always kept.
+    const auto next_keyframe = std::find_if(std::next(snapshots.begin()), snapshots.end(),
+                                            [](const Snapshot& other) { return other.keyframe; });
+    if (next_keyframe == snapshots.end()) {
+        return false;
+    }
+    for (auto it = snapshots.begin(); it != next_keyframe; ++it) {
+        memory_usage -= it->MemoryUsage();
+    }
+    snapshots.erase(snapshots.begin(), next_keyframe);
+    return true;
+}
+
+} // namespace Core
@@ -0,0 +1,95 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Core {
+
+class System;
+
+/**
+ * Ring of recent states of the emulation kept in memory, which the emulation can be rewound
+ * through. States are captured through the savestate serialization at a fixed interval of
+ * emulated time. The emulated memory, the bulk of a state, is split into pages: keyframes hold
+ * all of them, the states in between only the pages that changed since their keyframe. The
+ * oldest states are dropped to stay within the configured memory budget.
+ * All functions must be called from the emulation thread.
+ */
+class RewindBuffer {
+public:
+    explicit RewindBuffer(System& system);
+    ~RewindBuffer();
+
+    /// Captures a state if the rewind interval has elapsed since the previous one.
+    void Tick();
+
+    /**
+     * Restores the most recent state and removes it from the buffer, so that calling it again
+     * steps further back.
+     * @returns false if no states are left.
+     */
+    bool Rewind();
+
+    /// Drops all captured states.
+    void Clear();
+
+    /// Returns the number of captured states.
+    [[nodiscard]] std::size_t Size() const {
+        return snapshots.size();
+    }
+
+    /// Returns the memory used by the captured states in bytes.
+    [[nodiscard]] std::size_t MemoryUsage() const {
+        return memory_usage;
+    }
+
+private:
+    /// Position of an emulated memory region in the serialized state.
+    struct Placement {
+        std::size_t state_offset;
+        std::size_t image_offset;
+        std::size_t size;
+    };
+
+    struct Snapshot {
+        /// Compressed serialized state, without the emulated memory regions
+        std::vector<u8> state;
+        std::size_t state_size;
+        std::vector<Placement> placements;
+        /// Size of the memory image, the regions in the order they are serialized
+        std::size_t image_size;
+        /// Indices of the pages held, unused by keyframes which hold every page
+        std::vector<u32> pages;
+        /// Compressed contents of the held pages
+        std::vector<u8> data;
+        bool keyframe;
+
+        [[nodiscard]] std::size_t MemoryUsage() const {
+            return state.size() + data.size() + pages.size() * sizeof(u32);
+        }
+    };
+
+    void Capture();
+    void Restore(const Snapshot& snapshot);
+    void Push(Snapshot snapshot);
+    bool PopFront();
+
+    System& system;
+    std::deque<Snapshot> snapshots;
+    std::size_t memory_usage = 0;
+    std::size_t memory_budget;
+    s64 interval;
+    u64 next_capture_ticks = 0;
+
+    /// Page hashes of the latest keyframe, empty when the next state must be a keyframe
+    std::vector<u64> keyframe_hashes;
+    u32 states_since_keyframe = 0;
+};
+
+} // namespace Core
@@ -3,16 +3,16 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
-#include <cstring>
 #include "core/rpc/packet.h"
 
 namespace Core::RPC {
 
-Packet::Packet(const PacketHeader& header_, u8* data,
-               std::function<void(Packet&)> send_reply_callback_)
-    : header{header_}, send_reply_callback{std::move(send_reply_callback_)} {
-    std::memcpy(packet_data.data(), data, std::min(header.packet_size, MAX_PACKET_DATA_SIZE));
-}
+Packet::Packet(const PacketHeader& header_, std::span<const u8> data, u64 client_id_,
+               ReplyCallback send_reply_callback_)
+    : header{header_},
+      packet_data(data.begin(),
+                  data.begin() + std::min<std::size_t>(header.packet_size, data.size())),
+      client_id{client_id_}, send_reply_callback{std::move(send_reply_callback_)} {}
 
 Packet::~Packet() = default;
 
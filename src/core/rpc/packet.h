@@ -4,9 +4,9 @@
 
 #pragma once
 
-#include <array>
 #include <functional>
 #include <span>
+#include <vector>
 #include "common/common_types.h"
 
 namespace Core::RPC {
@@ -15,6 +15,16 @@ enum class PacketType : u32 {
     Undefined = 0,
     ReadMemory = 1,
     WriteMemory = 2,
+    /// Reads a list of {u32 address, u32 size} ranges, replying with their concatenated contents
+    ReadMemoryBatch = 3,
+    /// Writes a list of {u32 address, u32 size, u8 data[size]} ranges
+    WriteMemoryBatch = 4,
+    /// Watches a list of {u32 address, u32 size} ranges, replacing the ranges previously watched
+    /// by the client. An empty list ends the subscription.
+    Subscribe = 5,
+    /// Pushed to subscribed clients at the end of each frame changing watched memory, with the
+    /// frame number as id and the changes as a list of {u32 address, u32 size, u8 data[size]}
+    MemoryUpdate = 6,
 };
 
 struct PacketHeader {
@@ -24,16 +34,20 @@ struct PacketHeader {
     u32 packet_size;
 };
 
-constexpr u32 CURRENT_VERSION = 1;
+constexpr u32 CURRENT_VERSION = 2;
 constexpr u32 MIN_PACKET_SIZE = sizeof(PacketHeader);
-constexpr u32 MAX_PACKET_DATA_SIZE = 32;
+/// Largest data of a version 1 packet
+constexpr u32 MAX_PACKET_DATA_SIZE_V1 = 32;
+/// Largest data of a packet from version 2 on, keeping the datagrams within the UDP limits
+constexpr u32 MAX_PACKET_DATA_SIZE = 32 * 1024;
 constexpr u32 MAX_PACKET_SIZE = MIN_PACKET_SIZE + MAX_PACKET_DATA_SIZE;
-constexpr u32 MAX_READ_SIZE = MAX_PACKET_DATA_SIZE;
 
 class Packet {
 public:
-    explicit Packet(const PacketHeader& header, u8* data,
-                    std::function<void(Packet&)> send_reply_callback);
+    using ReplyCallback = std::function<void(Packet&)>;
+
+    explicit Packet(const PacketHeader& header, std::span<const u8> data, u64 client_id,
+                    ReplyCallback send_reply_callback);
     ~Packet();
 
     u32 GetVersion() const {
@@ -56,12 +70,28 @@ public:
         return header;
     }
 
-    std::span<u8, MAX_PACKET_DATA_SIZE> GetPacketData() {
+    /// Returns the largest data size of a packet of the version of this one.
+    u32 GetMaxPacketDataSize() const {
+        return header.version >= 2 ? MAX_PACKET_DATA_SIZE : MAX_PACKET_DATA_SIZE_V1;
+    }
+
+    /// Identifies the client that sent the packet, or the one it is sent to.
+    u64 GetClientId() const {
+        return client_id;
+    }
+
+    const ReplyCallback& GetReplyCallback() const {
+        return send_reply_callback;
+    }
+
+    std::span<u8> GetPacketData() {
         return packet_data;
     }
 
+    /// Sets the size of the data, which is kept up to the size and zero filled past it.
     void SetPacketDataSize(u32 size) {
         header.packet_size = size;
+        packet_data.resize(size);
     }
 
     void SendReply() {
@@ -69,13 +99,11 @@ public:
     }
 
 private:
-    void HandleReadMemory(u32 address, u32 data_size);
-    void HandleWriteMemory(u32 address, std::span<const u8> data);
-
     struct PacketHeader header;
-    std::array<u8, MAX_PACKET_DATA_SIZE> packet_data;
+    std::vector<u8> packet_data;
+    u64 client_id;
 
-    std::function<void(Packet&)> send_reply_callback;
+    ReplyCallback send_reply_callback;
 };
 
 } // namespace Core::RPC
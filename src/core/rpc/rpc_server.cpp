@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include "common/logging/log.h"
 #include "core/core.h"
 #include "core/memory.h"
@@ -10,6 +13,73 @@
 
 namespace Core::RPC {
 
+namespace {
+
+/// Size of a {u32 address, u32 size} range descriptor
+constexpr u32 RANGE_SIZE = sizeof(u32) * 2;
+
+/// Memory watched by a single client, bounding the work done at the end of each frame
+constexpr u32 MAX_WATCHED_SIZE = 1024 * 1024;
+
+/// Granularity at which watched memory is compared to find its changes
+constexpr u32 DIFF_GRANULE = 16;
+
+struct Range {
+    u32 address;
+    u32 size;
+};
+
+/// Parses a list of range descriptors, returning false if it is malformed.
+bool ParseRanges(std::span<const u8> data, std::vector<Range>& ranges) {
+    if (data.size() % RANGE_SIZE != 0) {
+        return false;
+    }
+    ranges.resize(data.size() / RANGE_SIZE);
+    std::memcpy(ranges.data(), data.data(), data.size());
+    return true;
+}
+
+/// Packs {u32 address, u32 size, u8 data[size]} entries into packets, sending the full ones.
+class UpdateWriter {
+public:
+    UpdateWriter(const Packet::ReplyCallback& send_, u32 frame_number_)
+        : send{send_}, frame_number{frame_number_} {}
+
+    void Add(u32 address, std::span<const u8> data) {
+        while (!data.empty()) {
+            if (buffer.size() + RANGE_SIZE + DIFF_GRANULE > MAX_PACKET_DATA_SIZE) {
+                Flush();
+            }
+            const std::size_t space = MAX_PACKET_DATA_SIZE - buffer.size() - RANGE_SIZE;
+            const auto size = static_cast<u32>(std::min(data.size(), space));
+            const std::array<u32, 2> descriptor{address, size};
+            const auto* descriptor_bytes = reinterpret_cast<const u8*>(descriptor.data());
+            buffer.insert(buffer.end(), descriptor_bytes, descriptor_bytes + RANGE_SIZE);
+            buffer.insert(buffer.end(), data.begin(), data.begin() + size);
+            address += size;
+            data = data.subspan(size);
+        }
+    }
+
+    void Flush() {
+        if (buffer.empty()) {
+            return;
+        }
+        const PacketHeader header{CURRENT_VERSION, frame_number, PacketType::MemoryUpdate,
+                                  static_cast<u32>(buffer.size())};
+        Packet packet{header, buffer, 0, send};
+        packet.SendReply();
+        buffer.clear();
+    }
+
+private:
+    const Packet::ReplyCallback& send;
+    u32 frame_number;
+    std::vector<u8> buffer;
+};
+
+} // Anonymous namespace
+
 RPCServer::RPCServer(Core::System& system_) : system{system_} {
     LOG_INFO(RPC_Server, "Starting RPC server.");
     request_handler_thread =
@@ -19,17 +89,145 @@ RPCServer::RPCServer(Core::System& system_) : system{system_} {
 RPCServer::~RPCServer() = default;
 
 void RPCServer::HandleReadMemory(Packet& packet, u32 address, u32 data_size) {
-    if (data_size > MAX_READ_SIZE) {
-        return;
-    }
-
     // Note: Memory read occurs asynchronously from the state of the emulator
-    system.Memory().ReadBlock(address, packet.GetPacketData().data(), data_size);
     packet.SetPacketDataSize(data_size);
+    system.Memory().ReadBlock(address, packet.GetPacketData().data(), data_size);
     packet.SendReply();
 }
 
 void RPCServer::HandleWriteMemory(Packet& packet, u32 address, std::span<const u8> data) {
+    WriteMemory(address, data);
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+}
+
+bool RPCServer::HandleReadMemoryBatch(Packet& packet) {
+    std::vector<Range> ranges;
+    if (!ParseRanges(packet.GetPacketData(), ranges)) {
+        return false;
+    }
+    u64 total_size = 0;
+    for (const auto& range : ranges) {
+        total_size += range.size;
+    }
+    if (total_size > MAX_PACKET_DATA_SIZE) {
+        return false;
+    }
+
+    // Note: Memory read occurs asynchronously from the state of the emulator
+    packet.SetPacketDataSize(static_cast<u32>(total_size));
+    u8* dest = packet.GetPacketData().data();
+    for (const auto& range : ranges) {
+        system.Memory().ReadBlock(range.address, dest, range.size);
+        dest += range.size;
+    }
+    packet.SendReply();
+    return true;
+}
+
+bool RPCServer::HandleWriteMemoryBatch(Packet& packet) {
+    // Validate the whole list before writing anything
+    const std::span<const u8> data = packet.GetPacketData();
+    std::vector<std::pair<u32, std::span<const u8>>> writes;
+    for (std::size_t offset = 0; offset < data.size();) {
+        if (data.size() - offset < RANGE_SIZE) {
+            return false;
+        }
+        Range range;
+        std::memcpy(&range, data.data() + offset, RANGE_SIZE);
+        offset += RANGE_SIZE;
+        if (data.size() - offset < range.size) {
+            return false;
+        }
+        writes.emplace_back(range.address, data.subspan(offset, range.size));
+        offset += range.size;
+    }
+
+    for (const auto& [address, contents] : writes) {
+        WriteMemory(address, contents);
+    }
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+    return true;
+}
+
+bool RPCServer::HandleSubscribe(Packet& packet) {
+    std::vector<Range> ranges;
+    if (!ParseRanges(packet.GetPacketData(), ranges)) {
+        return false;
+    }
+    u64 total_size = 0;
+    for (const auto& range : ranges) {
+        total_size += range.size;
+    }
+    if (total_size > MAX_WATCHED_SIZE) {
+        return false;
+    }
+
+    {
+        std::scoped_lock lock{subscriptions_mutex};
+        if (ranges.empty()) {
+            subscriptions.erase(packet.GetClientId());
+        } else {
+            // The first update after subscribing holds the whole watched memory
+            auto& subscription = subscriptions[packet.GetClientId()];
+            subscription.send_update = packet.GetReplyCallback();
+            subscription.ranges.clear();
+            for (const auto& range : ranges) {
+                subscription.ranges.push_back({range.address, range.size, {}});
+            }
+        }
+    }
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+    return true;
+}
+
+void RPCServer::PublishMemoryUpdates() {
+    std::scoped_lock lock{subscriptions_mutex};
+    frame_number++;
+    if (subscriptions.empty()) {
+        return;
+    }
+
+    std::vector<u8> current;
+    for (auto& [client_id, subscription] : subscriptions) {
+        UpdateWriter writer{subscription.send_update, frame_number};
+        for (auto& range : subscription.ranges) {
+            current.resize(range.size);
+            system.Memory().ReadBlock(range.address, current.data(), range.size);
+            if (range.contents.size() != range.size) {
+                writer.Add(range.address, current);
+                range.contents = current;
+                continue;
+            }
+
+            // Send the runs of changed granules
+            u32 run_start = 0;
+            bool in_run = false;
+            for (u32 offset = 0; offset < range.size; offset += DIFF_GRANULE) {
+                const u32 size = std::min(DIFF_GRANULE, range.size - offset);
+                const bool changed =
+                    std::memcmp(current.data() + offset, range.contents.data() + offset, size) != 0;
+                if (changed && !in_run) {
+                    run_start = offset;
+                    in_run = true;
+                } else if (!changed && in_run) {
+                    writer.Add(range.address + run_start,
+                               std::span{current}.subspan(run_start, offset - run_start));
+                    in_run = false;
+                }
+            }
+            if (in_run) {
+                writer.Add(range.address + run_start, std::span{current}.subspan(run_start));
+            }
+            std::swap(range.contents, current);
+        }
+        writer.Flush();
+    }
+}
+
+void RPCServer::WriteMemory(u32 address, std::span<const u8> data) {
     // Only allow writing to certain memory regions
     if ((address >= Memory::PROCESS_IMAGE_VADDR && address <= Memory::PROCESS_IMAGE_VADDR_END) ||
         (address >= Memory::HEAP_VADDR && address <= Memory::HEAP_VADDR_END) ||
@@ -41,51 +239,68 @@ void RPCServer::HandleWriteMemory(Packet& packet, u32 address, std::span<const u
         // Is current core correct here?
         system.InvalidateCacheRange(address, data.size());
     }
-    packet.SetPacketDataSize(0);
-    packet.SendReply();
 }
 
 bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
-    if (packet_header.version <= CURRENT_VERSION) {
-        switch (packet_header.packet_type) {
-        case PacketType::ReadMemory:
-        case PacketType::WriteMemory:
-            if (packet_header.packet_size >= (sizeof(u32) * 2)) {
-                return true;
-            }
-            break;
-        default:
-            break;
-        }
+    if (packet_header.version > CURRENT_VERSION) {
+        return false;
+    }
+    const u32 max_data_size =
+        packet_header.version >= 2 ? MAX_PACKET_DATA_SIZE : MAX_PACKET_DATA_SIZE_V1;
+    if (packet_header.packet_size > max_data_size) {
+        return false;
+    }
+    switch (packet_header.packet_type) {
+    case PacketType::ReadMemory:
+    case PacketType::WriteMemory:
+        return packet_header.packet_size >= RANGE_SIZE;
+    case PacketType::ReadMemoryBatch:
+    case PacketType::WriteMemoryBatch:
+    case PacketType::Subscribe:
+        return packet_header.version >= 2;
+    default:
+        return false;
     }
-    return false;
 }
 
 void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
     bool success = false;
-    const auto packet_data = request_packet->GetPacketData();
 
     if (ValidatePacket(request_packet->GetHeader())) {
-        // Currently, all request types use the address/data_size wire format
+        const auto packet_data = request_packet->GetPacketData();
+        const u32 max_data_size = request_packet->GetMaxPacketDataSize();
+
+        // The single range requests use the address/data_size wire format
         u32 address = 0;
         u32 data_size = 0;
-        std::memcpy(&address, packet_data.data(), sizeof(address));
-        std::memcpy(&data_size, packet_data.data() + sizeof(address), sizeof(data_size));
+        if (packet_data.size() >= RANGE_SIZE) {
+            std::memcpy(&address, packet_data.data(), sizeof(address));
+            std::memcpy(&data_size, packet_data.data() + sizeof(address), sizeof(data_size));
+        }
 
         switch (request_packet->GetPacketType()) {
         case PacketType::ReadMemory:
-            if (data_size > 0 && data_size <= MAX_READ_SIZE) {
+            if (data_size > 0 && data_size <= max_data_size) {
                 HandleReadMemory(*request_packet, address, data_size);
                 success = true;
             }
             break;
         case PacketType::WriteMemory:
-            if (data_size > 0 && data_size <= MAX_PACKET_DATA_SIZE - (sizeof(u32) * 2)) {
-                const auto data = packet_data.subspan(sizeof(u32) * 2, data_size);
+            if (data_size > 0 && data_size <= packet_data.size() - RANGE_SIZE) {
+                const auto data = packet_data.subspan(RANGE_SIZE, data_size);
                 HandleWriteMemory(*request_packet, address, data);
                 success = true;
             }
             break;
+        case PacketType::ReadMemoryBatch:
+            success = HandleReadMemoryBatch(*request_packet);
+            break;
+        case PacketType::WriteMemoryBatch:
+            success = HandleWriteMemoryBatch(*request_packet);
+            break;
+        case PacketType::Subscribe:
+            success = HandleSubscribe(*request_packet);
+            break;
         default:
             break;
         }
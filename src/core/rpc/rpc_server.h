@@ -6,9 +6,13 @@
 
 #include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <span>
+#include <unordered_map>
+#include <vector>
 #include "common/polyfill_thread.h"
 #include "common/threadsafe_queue.h"
+#include "core/rpc/packet.h"
 
 namespace Core {
 class System;
@@ -16,9 +20,6 @@ class System;
 
 namespace Core::RPC {
 
-class Packet;
-struct PacketHeader;
-
 class RPCServer {
 public:
     explicit RPCServer(Core::System& system);
@@ -26,9 +27,29 @@ public:
 
     void QueueRequest(std::unique_ptr<RPC::Packet> request);
 
+    /// Sends the changes of the watched memory to the subscribed clients. Called from the
+    /// emulation thread at the end of each frame, so that the updates are consistent.
+    void PublishMemoryUpdates();
+
 private:
+    /// Memory range watched by a client, with its contents as of the last update sent
+    struct WatchedRange {
+        u32 address;
+        u32 size;
+        std::vector<u8> contents;
+    };
+
+    struct Subscription {
+        Packet::ReplyCallback send_update;
+        std::vector<WatchedRange> ranges;
+    };
+
     void HandleReadMemory(Packet& packet, u32 address, u32 data_size);
     void HandleWriteMemory(Packet& packet, u32 address, std::span<const u8> data);
+    bool HandleReadMemoryBatch(Packet& packet);
+    bool HandleWriteMemoryBatch(Packet& packet);
+    bool HandleSubscribe(Packet& packet);
+    void WriteMemory(u32 address, std::span<const u8> data);
     bool ValidatePacket(const PacketHeader& packet_header);
     void HandleSingleRequest(std::unique_ptr<Packet> request);
     void HandleRequestsLoop(std::stop_token stop_token);
@@ -37,6 +58,10 @@ private:
     Core::System& system;
     Common::SPSCQueue<std::unique_ptr<Packet>, true> request_queue;
     std::jthread request_handler_thread;
+
+    std::mutex subscriptions_mutex;
+    std::unordered_map<u64, Subscription> subscriptions;
+    u32 frame_number = 0;
 };
 
 } // namespace Core::RPC
@@ -23,6 +23,9 @@ public:
 
     void NewRequestCallback(std::unique_ptr<Packet> new_request);
 
+    /// Sends the changes of the watched memory to the subscribed clients, once per frame.
+    void PublishMemoryUpdates();
+
 private:
     RPCServer rpc_server;
     std::unique_ptr<UDPServer> udp_server;
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <span>
 #include <thread>
 #include <boost/asio.hpp>
 #include "common/common_types.h"
@@ -43,11 +44,13 @@ private:
             PacketHeader header;
             std::memcpy(&header, request_buffer.data(), sizeof(header));
             if ((size - MIN_PACKET_SIZE) == header.packet_size) {
-                u8* data = request_buffer.data() + MIN_PACKET_SIZE;
-                std::function<void(Packet&)> send_reply_callback =
+                const std::span data{request_buffer.data() + MIN_PACKET_SIZE, header.packet_size};
+                const u64 client_id = (u64{remote_endpoint.address().to_v4().to_uint()} << 16) |
+                                      remote_endpoint.port();
+                Packet::ReplyCallback send_reply_callback =
                     std::bind(&Impl::SendReply, this, remote_endpoint, std::placeholders::_1);
                 std::unique_ptr<Packet> new_packet =
-                    std::make_unique<Packet>(header, data, send_reply_callback);
+                    std::make_unique<Packet>(header, data, client_id, send_reply_callback);
 
                 // Send the request to the upper layer for handling
                 new_request_callback(std::move(new_packet));
@@ -72,9 +75,9 @@ private:
         if (error) {
             LOG_WARNING(RPC_Server, "Failed to send reply: {}", error.message());
         } else {
-            LOG_INFO(RPC_Server, "Sent reply version({}) id=({}) type=({}) size=({})",
-                     reply_packet.GetVersion(), reply_packet.GetId(), reply_packet.GetPacketType(),
-                     reply_packet.GetPacketDataSize());
+            LOG_DEBUG(RPC_Server, "Sent reply version({}) id=({}) type=({}) size=({})",
+                      reply_packet.GetVersion(), reply_packet.GetId(), reply_packet.GetPacketType(),
+                      reply_packet.GetPacketDataSize());
         }
     }
 
@@ -2,17 +2,26 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
-#include <sstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <thread>
 #include <cryptopp/hex.h>
 #include <fmt/format.h>
 #include "common/archives.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
+#include "common/settings.h"
 #include "common/swap.h"
 #include "common/zstd_compression.h"
 #include "core/core.h"
+#include "core/hle/service/am/am.h"
+#include "core/hle/service/cfg/cfg.h"
 #include "core/movie.h"
 #include "core/savestate.h"
 #include "core/savestate_data.h"
@@ -28,8 +37,9 @@ struct CSTHeader {
     u64_le time;                   /// The time when this save state was created
     std::array<u8, 20> build_name; /// The build name (Canary/Nightly) with the version number
     u32_le zero = 0;               /// Should be zero, just in case.
+    u64_le content_hash;           /// Fingerprint of the title for boot snapshots, otherwise zero
 
-    std::array<u8, 192> reserved{}; /// Make heading 256 bytes so it has consistent size
+    std::array<u8, 184> reserved{}; /// Make heading 256 bytes so it has consistent size
 };
 static_assert(sizeof(CSTHeader) == 256, "CSTHeader should be 256 bytes");
 #pragma pack(pop)
@@ -121,30 +131,161 @@ std::vector<SaveStateInfo> ListSaveStates(u64 program_id, u64 movie_id) {
     return result;
 }
 
-void System::SaveState(u32 slot) const {
-    std::ostringstream sstream{std::ios_base::binary};
-    // Serialize
-    oarchive oa{sstream};
-    oa&* this;
+/// Number of threads compressing a savestate alongside the thread writing it.
+static u32 GetSaveStateCompressionWorkers() {
+    return std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+}
 
-    const std::string& str{sstream.str()};
-    const auto data = std::span<const u8>{reinterpret_cast<const u8*>(str.data()), str.size()};
-    auto buffer = Common::Compression::CompressDataZSTDDefault(data);
+namespace {
 
-    const u64 movie_id = movie.GetCurrentMovieID();
-    const auto path = GetSaveStatePath(title_id, movie_id, slot);
-    if (!FileUtil::CreateFullPath(path)) {
-        throw std::runtime_error("Could not create path " + path);
+/**
+ * Output buffer holding the uncompressed state in fixed size chunks. Capturing a state into it
+ * costs little more than copying the emulated memory, and the chunks are released one by one
+ * as they are compressed so that the capture is never held twice.
+ */
+class SnapshotStreamBuf final : public std::streambuf {
+public:
+    static constexpr std::size_t CHUNK_SIZE = 16 * 1024 * 1024;
+
+    /// Passes the captured data to func chunk by chunk, freeing each chunk after its call.
+    template <typename Func>
+    bool Drain(Func&& func) {
+        const std::size_t last_size = pptr() - pbase();
+        for (std::size_t i = 0; i < chunks.size(); i++) {
+            const std::size_t size = i + 1 == chunks.size() ? last_size : CHUNK_SIZE;
+            if (!func(std::span<const u8>{chunks[i].get(), size})) {
+                return false;
+            }
+            chunks[i].reset();
+        }
+        chunks.clear();
+        setp(nullptr, nullptr);
+        return true;
     }
 
-    FileUtil::IOFile file(path, "wb");
+protected:
+    int_type overflow(int_type ch) override {
+        chunks.push_back(std::make_unique_for_overwrite<u8[]>(CHUNK_SIZE));
+        char* const begin = reinterpret_cast<char*>(chunks.back().get());
+        setp(begin, begin + CHUNK_SIZE);
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+private:
+    std::vector<std::unique_ptr<u8[]>> chunks;
+};
+
+} // Anonymous namespace
+
+static std::string GetBootSnapshotPath(u64 program_id) {
+    return fmt::format("{}{:016X}.boot.cst",
+                       FileUtil::GetUserPath(FileUtil::UserPath::StatesDir), program_id);
+}
+
+/// Hashes up to max_size bytes from the start of a file, together with its size
+static u64 HashFileStart(const std::string& path, std::size_t max_size) {
+    FileUtil::IOFile file(path, "rb");
     if (!file) {
-        throw std::runtime_error("Could not open file " + path);
+        return 0;
+    }
+    std::vector<u8> data(std::min<u64>(max_size, file.GetSize()));
+    data.resize(file.ReadBytes(data.data(), data.size()));
+    return Common::HashCombine(Common::ComputeHash64(data.data(), data.size()), file.GetSize());
+}
+
+/// Hashes the paths, sizes and modification times of the files below a directory
+static u64 HashDirectoryTree(const std::string& directory) {
+    if (!FileUtil::IsDirectory(directory)) {
+        return 0;
+    }
+    FileUtil::FSTEntry root;
+    FileUtil::ScanDirectoryTree(directory, root, 16);
+    std::vector<FileUtil::FSTEntry> files;
+    FileUtil::GetAllFilesFromNestedEntries(root, files);
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+        return a.physicalName < b.physicalName;
+    });
+
+    u64 hash = Common::ComputeHash64(directory.data(), directory.size());
+    for (const auto& file : files) {
+        const s64 modified = FileUtil::GetModificationTime(file.physicalName).value_or(0);
+        hash = Common::HashCombine(hash, Common::ComputeHash64(file.physicalName.data(),
+                                                               file.physicalName.size()));
+        hash = Common::HashCombine(hash, file.size);
+        hash = Common::HashCombine(hash, static_cast<u64>(modified));
+    }
+    return hash;
+}
+
+u64 GetBootSnapshotHash(System& system, const std::string& filepath, u64 program_id) {
+    // The headers at the start of every supported format hold the hashes of the contents, which
+    // makes them a cheap fingerprint of the whole title.
+    constexpr std::size_t FINGERPRINT_SIZE = 1024 * 1024;
+    const u64 title_hash = HashFileStart(filepath, FINGERPRINT_SIZE);
+    if (title_hash == 0) {
+        return 0;
+    }
+
+    // The title metadata of the update and DLC holds their version and the hashes of their
+    // contents, while the installed files show which of the contents are present.
+    constexpr u64 UPDATE_MASK = 0x0000000e'00000000;
+    constexpr u64 DLC_TID_HIGH = 0x0004008c'00000000;
+    const u64 update_id = program_id | UPDATE_MASK;
+    const u64 dlc_id = (program_id & 0xffffffff) | DLC_TID_HIGH;
+    constexpr auto sdmc = Service::FS::MediaType::SDMC;
+    constexpr std::size_t TMD_MAX_SIZE = 64 * 1024;
+
+    // Mods and the overrides next to the title replace its code and files, and the system
+    // configuration is read by it.
+    const auto mods_path = fmt::format(
+        "{}mods/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::LoadDir), program_id);
+    const auto cfg = Service::CFG::GetModule(system);
+    const auto config = cfg ? cfg->GetConfigSavegame() : std::span<const u8>{};
+
+    const std::array<u64, 13> extra{
+        Settings::values.is_new_3ds.GetValue(),
+        static_cast<u64>(Settings::values.region_value.GetValue()),
+        Settings::values.lle_applets.GetValue(),
+        HashFileStart(Service::AM::GetTitleMetadataPath(sdmc, update_id), TMD_MAX_SIZE),
+        HashDirectoryTree(Service::AM::GetTitlePath(sdmc, update_id)),
+        HashFileStart(Service::AM::GetTitleMetadataPath(sdmc, dlc_id), TMD_MAX_SIZE),
+        HashDirectoryTree(Service::AM::GetTitlePath(sdmc, dlc_id)),
+        HashDirectoryTree(mods_path),
+        HashFileStart(filepath + ".exheader", TMD_MAX_SIZE),
+        HashFileStart(filepath + ".romfs", FINGERPRINT_SIZE),
+        HashFileStart(filepath + ".exefs", FINGERPRINT_SIZE),
+        HashDirectoryTree(filepath + ".exefsdir/"),
+        Common::ComputeHash64(config.data(), config.size()),
+    };
+    return Common::HashCombine(title_hash, Common::ComputeHash64(extra.data(), sizeof(extra)));
+}
+
+void System::SaveState(u32 slot) const {
+    const u64 movie_id = movie.GetCurrentMovieID();
+    WriteSaveState(GetSaveStatePath(title_id, movie_id, slot), 0);
+}
+
+void System::SaveBootSnapshot() const {
+    LOG_INFO(Core, "Capturing the boot snapshot of {:016X}", title_id);
+    WriteSaveState(GetBootSnapshotPath(title_id), boot_snapshot_hash);
+}
+
+void System::WriteSaveState(const std::string& path, u64 content_hash) const {
+    // Only one state is written at a time, so that a slot is never written twice at once
+    WaitForSaveState();
+
+    if (!FileUtil::CreateFullPath(path)) {
+        throw std::runtime_error("Could not create path " + path);
     }
 
     CSTHeader header{};
     header.filetype = header_magic_bytes;
     header.program_id = title_id;
+    header.content_hash = content_hash;
     std::string rev_bytes;
     CryptoPP::StringSource ss(Common::g_scm_rev, true,
                               new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
@@ -157,9 +298,56 @@ void System::SaveState(u32 slot) const {
     std::memcpy(header.build_name.data(), build_fullname.c_str(),
                 std::min(build_fullname.length(), sizeof(header.build_name) - 1));
 
-    if (file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
-        file.WriteBytes(buffer.data(), buffer.size()) != buffer.size()) {
-        throw std::runtime_error("Could not write to file " + path);
+    // The emulation is only paused while the state is captured uncompressed in memory
+    auto snapshot = std::make_shared<SnapshotStreamBuf>();
+    {
+        std::ostream stream{snapshot.get()};
+        oarchive oa{stream};
+        oa&* this;
+        if (!stream.good()) {
+            throw std::runtime_error("Could not capture the state for " + path);
+        }
+    }
+
+    // It is compressed and written by a background thread. The state goes to a temporary file
+    // renamed on completion, a failed save must not leave a truncated state behind.
+    save_state_task = std::async(std::launch::async, [snapshot, header, path] {
+        const std::string temp_path = path + ".tmp";
+        bool written = false;
+        {
+            FileUtil::IOFile file(temp_path, "wb");
+            if (file && file.WriteBytes(&header, sizeof(header)) == sizeof(header)) {
+                Common::Compression::ZSTDCompressStreamBuf buffer{
+                    [&file](std::span<const u8> data) {
+                        return file.WriteBytes(data.data(), data.size()) == data.size();
+                    },
+                    0, GetSaveStateCompressionWorkers()};
+                written = snapshot->Drain([&buffer](std::span<const u8> data) {
+                    return buffer.sputn(reinterpret_cast<const char*>(data.data()),
+                                        static_cast<std::streamsize>(data.size())) ==
+                           static_cast<std::streamsize>(data.size());
+                }) && buffer.Finish();
+            }
+            written = file.Close() && written;
+        }
+        // The previous state of the slot is only replaced once the new one is complete
+        if (!written || !FileUtil::RenameReplacing(temp_path, path)) {
+            LOG_ERROR(Core, "Could not write savestate {}", path);
+            FileUtil::Delete(temp_path);
+            return;
+        }
+        LOG_INFO(Core, "Save to {} completed", path);
+    });
+}
+
+void System::WaitForSaveState() const {
+    if (!save_state_task.valid()) {
+        return;
+    }
+    try {
+        save_state_task.get();
+    } catch (const std::exception& e) {
+        LOG_ERROR(Core, "Error writing savestate: {}", e.what());
     }
 }
 
@@ -168,41 +356,71 @@ void System::LoadState(u32 slot) {
         throw std::runtime_error("Unable to load while connected to multiplayer");
     }
 
+    // The slot may still be in the process of being written
+    WaitForSaveState();
+
     const u64 movie_id = movie.GetCurrentMovieID();
     const auto path = GetSaveStatePath(title_id, movie_id, slot);
 
-    std::vector<u8> decompressed;
-    {
-        std::vector<u8> buffer(FileUtil::GetSize(path) - sizeof(CSTHeader));
-
-        FileUtil::IOFile file(path, "rb");
-
-        // load header
-        CSTHeader header;
-        if (file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
-            throw std::runtime_error("Could not read from file at " + path);
-        }
+    FileUtil::IOFile file(path, "rb");
 
-        // validate header
-        SaveStateInfo info;
-        info.slot = slot;
-        if (!ValidateSaveState(header, info, title_id, movie_id)) {
-            throw std::runtime_error("Invalid savestate");
-        }
+    // load header
+    CSTHeader header;
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
+        throw std::runtime_error("Could not read from file at " + path);
+    }
 
-        if (file.ReadBytes(buffer.data(), buffer.size()) != buffer.size()) {
-            throw std::runtime_error("Could not read from file at " + path);
-        }
-        decompressed = Common::Compression::DecompressDataZSTD(buffer);
+    // validate header
+    SaveStateInfo info;
+    info.slot = slot;
+    if (!ValidateSaveState(header, info, title_id, movie_id)) {
+        throw std::runtime_error("Invalid savestate");
     }
-    std::istringstream sstream{
-        std::string{reinterpret_cast<char*>(decompressed.data()), decompressed.size()},
-        std::ios_base::binary};
-    decompressed.clear();
+
+    // Decompress while deserializing, reading the file chunk by chunk
+    Common::Compression::ZSTDDecompressStreamBuf buffer{
+        [&file](std::span<u8> data) { return file.ReadBytes(data.data(), data.size()); }};
+    std::istream stream{&buffer};
 
     // Deserialize
-    iarchive ia{sstream};
+    iarchive ia{stream};
     ia&* this;
 }
 
+bool System::LoadBootSnapshot() {
+    const auto path = GetBootSnapshotPath(title_id);
+    FileUtil::IOFile file(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    // Unlike savestates, boot snapshots are only used by the same build on the same contents
+    CSTHeader header;
+    const bool valid = file.ReadBytes(&header, sizeof(header)) == sizeof(header) &&
+                       header.filetype == header_magic_bytes && header.program_id == title_id &&
+                       header.content_hash == boot_snapshot_hash &&
+                       fmt::format("{:02x}", fmt::join(header.revision, "")) == Common::g_scm_rev;
+    if (!valid) {
+        LOG_INFO(Core, "Discarding the outdated boot snapshot {}", path);
+        file.Close();
+        FileUtil::Delete(path);
+        return false;
+    }
+
+    LOG_INFO(Core, "Loading the boot snapshot {}", path);
+    try {
+        Common::Compression::ZSTDDecompressStreamBuf buffer{
+            [&file](std::span<u8> data) { return file.ReadBytes(data.data(), data.size()); }};
+        std::istream stream{&buffer};
+        iarchive ia{stream};
+        ia&* this;
+    } catch (...) {
+        // Boot normally the next time
+        file.Close();
+        FileUtil::Delete(path);
+        throw;
+    }
+    return true;
+}
+
 } // namespace Core
@@ -24,4 +24,11 @@ constexpr u32 SaveStateSlotCount = 10; // Maximum count of savestate slots
 
 std::vector<SaveStateInfo> ListSaveStates(u64 program_id, u64 movie_id);
 
+/**
+ * Returns the fingerprint validating the boot snapshot of a title, 0 if it could not be read.
+ * Besides the title itself it covers what else is loaded at boot: its update and DLC, its mods
+ * and the system configuration.
+ */
+u64 GetBootSnapshotHash(System& system, const std::string& filepath, u64 program_id);
+
 } // namespace Core
@@ -0,0 +1,161 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/memory.h"
+#include "core/tracer/player.h"
+#include "video_core/gpu.h"
+#include "video_core/pica/pica_core.h"
+#include "video_core/renderer_base.h"
+
+namespace CiTrace {
+
+Player::Player(Core::System& system_) : system{system_} {}
+
+Player::~Player() = default;
+
+bool Player::Load(const std::string& filename) {
+    FileUtil::IOFile trace_file(filename, "rb");
+    if (!trace_file.IsOpen()) {
+        LOG_ERROR(HW_GPU, "Failed to open CiTrace {}", filename);
+        return false;
+    }
+    file.resize(trace_file.GetSize());
+    if (trace_file.ReadBytes(file.data(), file.size()) != file.size() ||
+        file.size() < sizeof(CTHeader)) {
+        LOG_ERROR(HW_GPU, "Failed to read CiTrace {}", filename);
+        return false;
+    }
+
+    std::memcpy(&header, file.data(), sizeof(CTHeader));
+    if (std::memcmp(header.magic, CTHeader::ExpectedMagicWord(), sizeof(header.magic)) != 0 ||
+        header.version != CTHeader::ExpectedVersion()) {
+        LOG_ERROR(HW_GPU, "{} is not a CiTrace of version {}", filename,
+                  CTHeader::ExpectedVersion());
+        return false;
+    }
+    const u64 stream_end =
+        header.stream_offset + static_cast<u64>(header.stream_size) * sizeof(CTStreamElement);
+    if (stream_end > file.size()) {
+        LOG_ERROR(HW_GPU, "CiTrace {} is truncated", filename);
+        return false;
+    }
+
+    stream = {reinterpret_cast<const CTStreamElement*>(file.data() + header.stream_offset),
+              header.stream_size};
+    num_frames = std::ranges::count_if(
+        stream, [](const CTStreamElement& element) { return element.type == FrameMarker; });
+    position = 0;
+    return true;
+}
+
+void Player::Reset() {
+    auto& gpu = system.GPU();
+    auto& pica = gpu.PicaCore();
+    gpu.Sync();
+
+    const auto& initial = header.initial_state_offsets;
+    const auto copy = [this](auto& dest, u32 offset, u32 size) {
+        const auto words = InitialState(offset, size);
+        std::memcpy(std::addressof(dest), words.data(),
+                    std::min(sizeof(dest), words.size_bytes()));
+    };
+    copy(pica.regs.reg_array, initial.pica_registers, initial.pica_registers_size);
+    copy(pica.regs_lcd, initial.lcd_registers, initial.lcd_registers_size);
+    copy(pica.vs_setup.program_code, initial.vs_program_binary, initial.vs_program_binary_size);
+    copy(pica.vs_setup.swizzle_data, initial.vs_swizzle_data, initial.vs_swizzle_data_size);
+    pica.vs_setup.MarkProgramCodeDirty();
+    pica.vs_setup.MarkSwizzleDataDirty();
+
+    // Vectors are stored as four float24 words each
+    const auto default_attributes =
+        InitialState(initial.default_attributes, initial.default_attributes_size);
+    for (std::size_t i = 0; i < std::min<std::size_t>(pica.input_default_attributes.size(),
+                                                      default_attributes.size() / 4);
+         i++) {
+        for (std::size_t comp = 0; comp < 4; comp++) {
+            pica.input_default_attributes[i][comp] =
+                Pica::f24::FromRaw(default_attributes[4 * i + comp]);
+        }
+    }
+    const auto float_uniforms =
+        InitialState(initial.vs_float_uniforms, initial.vs_float_uniforms_size);
+    auto& uniforms = pica.vs_setup.uniforms.f;
+    for (std::size_t i = 0; i < std::min(uniforms.size(), float_uniforms.size() / 4); i++) {
+        for (std::size_t comp = 0; comp < 4; comp++) {
+            uniforms[i][comp] = Pica::f24::FromRaw(float_uniforms[4 * i + comp]);
+        }
+    }
+
+    // The registers were replaced behind the rasterizer's back
+    auto* rasterizer = gpu.Renderer().Rasterizer();
+    rasterizer->ClearAll(false);
+    rasterizer->SyncEntireState();
+    position = 0;
+}
+
+bool Player::PlayFrame() {
+    while (position < stream.size()) {
+        const CTStreamElement& element = stream[position++];
+        switch (element.type) {
+        case FrameMarker:
+            system.GPU().Renderer().SwapBuffers();
+            return true;
+        case MemoryLoad:
+            LoadMemory(element.memory_load);
+            break;
+        case RegisterWrite:
+            WriteRegister(element.register_write);
+            break;
+        default:
+            LOG_ERROR(HW_GPU, "Unknown CiTrace stream element {:#x}",
+                      static_cast<u32>(element.type));
+            break;
+        }
+    }
+    return false;
+}
+
+std::span<const u32> Player::InitialState(u32 offset, u32 size) const {
+    if (offset + static_cast<u64>(size) * sizeof(u32) > file.size()) {
+        return {};
+    }
+    return {reinterpret_cast<const u32*>(file.data() + offset), size};
+}
+
+void Player::LoadMemory(const CTMemoryLoad& load) {
+    auto& memory = system.Memory();
+    u8* dest = memory.GetPhysicalPointer(load.physical_address);
+    if (!dest || load.size == 0 ||
+        !memory.IsValidPhysicalAddress(load.physical_address + load.size - 1) ||
+        load.file_offset + static_cast<u64>(load.size) > file.size()) {
+        LOG_ERROR(HW_GPU, "Invalid CiTrace memory load of {} bytes at {:#010X}", load.size,
+                  load.physical_address);
+        return;
+    }
+
+    // Loads repeat on every access, only invalidate cached surfaces when the data did change
+    const u8* source = file.data() + load.file_offset;
+    if (std::memcmp(dest, source, load.size) == 0) {
+        return;
+    }
+    std::memcpy(dest, source, load.size);
+    system.GPU().Renderer().Rasterizer()->InvalidateRegion(load.physical_address, load.size);
+}
+
+void Player::WriteRegister(const CTRegisterWrite& write) {
+    if (write.physical_address < Memory::IO_AREA_PADDR ||
+        write.physical_address >= Memory::IO_AREA_PADDR_END) {
+        LOG_ERROR(HW_GPU, "Invalid CiTrace register write at {:#010X}", write.physical_address);
+        return;
+    }
+    const VAddr addr = write.physical_address - Memory::IO_AREA_PADDR + Memory::IO_AREA_VADDR;
+    system.GPU().WriteReg(addr, write.value);
+}
+
+} // namespace CiTrace
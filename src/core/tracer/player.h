@@ -0,0 +1,65 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "core/tracer/citrace.h"
+
+namespace Core {
+class System;
+}
+
+namespace CiTrace {
+
+/**
+ * Replays a recorded CiTrace through the emulated GPU. Memory loads are written to guest memory,
+ * register writes go through the GPU register interface so they trigger the same command list
+ * processing, fills and transfers as during recording.
+ */
+class Player {
+public:
+    explicit Player(Core::System& system);
+    ~Player();
+
+    /**
+     * Loads the trace at the given path.
+     * @returns False if the file could not be read or is not a valid CiTrace.
+     */
+    [[nodiscard]] bool Load(const std::string& filename);
+
+    /// Applies the initial GPU state of the trace and rewinds the stream to its start
+    void Reset();
+
+    /**
+     * Replays the stream up to and including the next frame marker, which presents the frame.
+     * @returns False if the stream ended before a frame marker was reached.
+     */
+    bool PlayFrame();
+
+    /// Returns the number of frames in the trace
+    [[nodiscard]] std::size_t NumFrames() const {
+        return num_frames;
+    }
+
+private:
+    /// Returns the words of the initial state block at offset
+    [[nodiscard]] std::span<const u32> InitialState(u32 offset, u32 size) const;
+
+    void LoadMemory(const CTMemoryLoad& load);
+    void WriteRegister(const CTRegisterWrite& write);
+
+private:
+    Core::System& system;
+    std::vector<u8> file;
+    CTHeader header{};
+    std::span<const CTStreamElement> stream;
+    std::size_t position{};
+    std::size_t num_frames{};
+};
+
+} // namespace CiTrace
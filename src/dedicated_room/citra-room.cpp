@@ -9,6 +9,8 @@
 #include <string>
 #include <thread>
 #include <cryptopp/base64.h>
+#include <fmt/format.h>
+#include <httplib.h>
 
 #ifdef _WIN32
 // windows.h needs to be included before shellapi.h
@@ -57,6 +59,7 @@ static void PrintHelp(const char* argv0) {
                  "--ban-list-file     The file for storing the room ban list\n"
                  "--log-file          The file for storing the room log\n"
                  "--enable-citra-mods Allow Citra Community Moderators to moderate on your room\n"
+                 "--metrics-port      Serve room metrics in Prometheus format on this port\n"
                  "-h, --help          Display this help and exit\n"
                  "-v, --version       Output version information and exit\n";
 }
@@ -149,6 +152,64 @@ static void SaveBanList(const Network::Room::BanList& ban_list, const std::strin
     file.flush();
 }
 
+/// Escapes a Prometheus label value.
+static std::string EscapeLabel(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (const char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/// Formats the metrics of the room in the Prometheus text exposition format.
+static std::string FormatMetrics(const Network::Room& room) {
+    const auto members = room.GetRoomMemberList();
+    const auto stats = room.GetStatistics();
+
+    std::string out;
+    const auto metric = [&out](const char* name, const char* type, const char* help, auto value) {
+        out += fmt::format("# HELP {0} {1}\n# TYPE {0} {2}\n{0} {3}\n", name, help, type, value);
+    };
+    metric("citra_room_members", "gauge", "Members in the room.", members.size());
+    metric("citra_room_member_slots", "gauge", "Maximum number of members in the room.",
+           room.GetRoomInformation().member_slots);
+    metric("citra_room_pending_joins", "gauge",
+           "Join requests waiting for the verification of the user.", stats.pending_joins);
+    metric("citra_room_wifi_packets_received_total", "counter",
+           "WifiPackets received from the members.", stats.wifi_packets_received);
+    metric("citra_room_wifi_bytes_received_total", "counter",
+           "Size of the WifiPackets received from the members.", stats.wifi_bytes_received);
+    metric("citra_room_wifi_packets_relayed_total", "counter",
+           "WifiPackets queued for a recipient, once per recipient.", stats.wifi_packets_relayed);
+    metric("citra_room_wifi_bytes_relayed_total", "counter",
+           "Size of the WifiPackets queued for a recipient.", stats.wifi_bytes_relayed);
+    metric("citra_room_wifi_packets_dropped_total", "counter",
+           "WifiPackets that were truncated or had no recipient.", stats.wifi_packets_dropped);
+
+    out += "# HELP citra_room_member_rtt_seconds Mean round trip time to the member.\n"
+           "# TYPE citra_room_member_rtt_seconds gauge\n";
+    for (const auto& member : members) {
+        out += fmt::format("citra_room_member_rtt_seconds{{nickname=\"{}\"}} {}\n",
+                           EscapeLabel(member.nickname), member.round_trip_time / 1000.0);
+    }
+    out += "# HELP citra_room_member_packet_loss Recent fraction of the packets to the member that "
+           "were lost and sent again.\n"
+           "# TYPE citra_room_member_packet_loss gauge\n";
+    for (const auto& member : members) {
+        out += fmt::format("citra_room_member_packet_loss{{nickname=\"{}\"}} {}\n",
+                           EscapeLabel(member.nickname), member.packet_loss);
+    }
+    return out;
+}
+
 static void InitializeLogging(const std::string& log_file) {
     Common::Log::Initialize(log_file);
     Common::Log::SetColorConsoleBackendEnabled(true);
@@ -173,6 +234,7 @@ int main(int argc, char** argv) {
     u16 port = Network::DefaultRoomPort;
     u32 max_members = 16;
     bool enable_citra_mods = false;
+    u16 metrics_port = 0;
 
     static struct option long_options[] = {
         {"room-name", required_argument, 0, 'n'},
@@ -188,6 +250,7 @@ int main(int argc, char** argv) {
         {"ban-list-file", required_argument, 0, 'b'},
         {"log-file", required_argument, 0, 'l'},
         {"enable-citra-mods", no_argument, 0, 'e'},
+        {"metrics-port", required_argument, 0, 'r'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
@@ -236,6 +299,9 @@ int main(int argc, char** argv) {
             case 'e':
                 enable_citra_mods = true;
                 break;
+            case 'r':
+                metrics_port = static_cast<u16>(strtoul(optarg, &endarg, 0));
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -338,6 +404,22 @@ int main(int argc, char** argv) {
         if (announce) {
             announce_session->Start();
         }
+
+        httplib::Server metrics_server;
+        std::thread metrics_thread;
+        if (metrics_port != 0) {
+            metrics_server.Get("/metrics", [&room](const httplib::Request&,
+                                                   httplib::Response& response) {
+                response.set_content(FormatMetrics(*room), "text/plain; version=0.0.4");
+            });
+            if (metrics_server.bind_to_port("0.0.0.0", metrics_port)) {
+                metrics_thread =
+                    std::thread([&metrics_server] { metrics_server.listen_after_bind(); });
+                std::cout << "Serving metrics on port " << metrics_port << "\n\n";
+            } else {
+                std::cout << "Could not serve metrics on port " << metrics_port << "\n\n";
+            }
+        }
         while (room->GetState() == Network::Room::State::Open) {
             std::string in;
             std::cin >> in;
@@ -346,6 +428,10 @@ int main(int argc, char** argv) {
             }
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+        if (metrics_thread.joinable()) {
+            metrics_server.stop();
+            metrics_thread.join();
+        }
         if (announce) {
             announce_session->Stop();
         }
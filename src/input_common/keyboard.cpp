@@ -11,26 +11,39 @@
 
 namespace InputCommon {
 
+struct KeyButtonPair {
+    explicit KeyButtonPair(int key_code_) : key_code(key_code_) {}
+
+    void SetStatus(bool pressed) {
+        if (status.exchange(pressed) != pressed) {
+            change_time.store(Input::Clock::now().time_since_epoch().count());
+        }
+    }
+
+    int key_code;
+    std::atomic<bool> status{false};
+    /// Host time of the last key event that changed the status, in ticks of the input clock
+    std::atomic<Input::Clock::rep> change_time{0};
+};
+
 class KeyButton final : public Input::ButtonDevice {
 public:
-    explicit KeyButton(std::atomic<bool>& status_) : status(status_) {}
+    explicit KeyButton(KeyButtonPair& pair_) : pair(pair_) {}
 
     ~KeyButton() override = default;
 
     bool GetStatus() const override {
-        return status.load();
+        return pair.status.load();
+    }
+
+    Input::Clock::time_point GetChangeTime() const override {
+        return Input::Clock::time_point{Input::Clock::duration{pair.change_time.load()}};
     }
 
     friend class KeyButtonList;
 
 private:
-    std::atomic<bool>& status;
-};
-
-struct KeyButtonPair {
-    explicit KeyButtonPair(int key_code_) : key_code(key_code_) {}
-    int key_code;
-    std::atomic<bool> status{false};
+    KeyButtonPair& pair;
 };
 
 class KeyButtonList {
@@ -50,14 +63,14 @@ public:
         std::lock_guard guard{mutex};
         for (KeyButtonPair& pair : list) {
             if (pair.key_code == key_code)
-                pair.status.store(pressed);
+                pair.SetStatus(pressed);
         }
     }
 
     void ChangeAllKeyStatus(bool pressed) {
         std::lock_guard guard{mutex};
         for (KeyButtonPair& pair : list) {
-            pair.status.store(pressed);
+            pair.SetStatus(pressed);
         }
     }
 
@@ -71,7 +84,7 @@ Keyboard::Keyboard() : key_button_list{std::make_shared<KeyButtonList>()} {}
 std::unique_ptr<Input::ButtonDevice> Keyboard::Create(const Common::ParamPackage& params) {
     int key_code = params.Get("code", 0);
     auto& pair = key_button_list->AddKeyButton(key_code);
-    return std::make_unique<KeyButton>(pair.status);
+    return std::make_unique<KeyButton>(pair);
 }
 
 void Keyboard::PressKey(int key_code) {
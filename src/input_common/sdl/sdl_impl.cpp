@@ -184,7 +184,9 @@ public:
 
     void SetButton(int button, bool value) {
         std::lock_guard lock{mutex};
-        state.buttons[button] = value;
+        if (std::exchange(state.buttons[button], value) != value) {
+            state.button_times[button] = Input::Clock::now();
+        }
     }
 
     bool GetButton(int button) const {
@@ -192,9 +194,16 @@ public:
         return state.buttons.at(button);
     }
 
+    Input::Clock::time_point GetButtonChangeTime(int button) const {
+        std::lock_guard lock{mutex};
+        return GetChangeTime(state.button_times, button);
+    }
+
     void SetAxis(int axis, Sint16 value) {
         std::lock_guard lock{mutex};
-        state.axes[axis] = value;
+        if (std::exchange(state.axes[axis], value) != value) {
+            state.axis_times[axis] = Input::Clock::now();
+        }
     }
 
     float GetAxis(int axis) const {
@@ -202,6 +211,11 @@ public:
         return state.axes.at(axis) / 32767.0f;
     }
 
+    Input::Clock::time_point GetAxisChangeTime(int axis) const {
+        std::lock_guard lock{mutex};
+        return GetChangeTime(state.axis_times, axis);
+    }
+
     std::tuple<float, float> GetAnalog(int axis_x, int axis_y) const {
         float x = GetAxis(axis_x);
         float y = GetAxis(axis_y);
@@ -221,7 +235,9 @@ public:
 
     void SetHat(int hat, Uint8 direction) {
         std::lock_guard lock{mutex};
-        state.hats[hat] = direction;
+        if (std::exchange(state.hats[hat], direction) != direction) {
+            state.hat_times[hat] = Input::Clock::now();
+        }
     }
 
     bool GetHatDirection(int hat, Uint8 direction) const {
@@ -229,6 +245,11 @@ public:
         return (state.hats.at(hat) & direction) != 0;
     }
 
+    Input::Clock::time_point GetHatChangeTime(int hat) const {
+        std::lock_guard lock{mutex};
+        return GetChangeTime(state.hat_times, hat);
+    }
+
     void SetAccel(const float x, const float y, const float z) {
         std::lock_guard lock{mutex};
         state.accel.x = x;
@@ -274,12 +295,23 @@ public:
     }
 
 private:
+    using ChangeTimes = std::unordered_map<int, Input::Clock::time_point>;
+
+    static Input::Clock::time_point GetChangeTime(const ChangeTimes& times, int index) {
+        const auto it = times.find(index);
+        return it != times.end() ? it->second : Input::Clock::time_point{};
+    }
+
     struct State {
         std::unordered_map<int, bool> buttons;
         std::unordered_map<int, Sint16> axes;
         std::unordered_map<int, Uint8> hats;
         Common::Vec3<float> accel;
         Common::Vec3<float> gyro;
+        /// Host times of the events that last changed the buttons, axes and hats
+        ChangeTimes button_times;
+        ChangeTimes axis_times;
+        ChangeTimes hat_times;
     } state;
     std::string guid;
     int port;
@@ -614,6 +646,10 @@ public:
         return joystick->GetButton(button);
     }
 
+    Input::Clock::time_point GetChangeTime() const override {
+        return joystick->GetButtonChangeTime(button);
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int button;
@@ -628,6 +664,10 @@ public:
         return joystick->GetHatDirection(hat, direction);
     }
 
+    Input::Clock::time_point GetChangeTime() const override {
+        return joystick->GetHatChangeTime(hat);
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int hat;
@@ -648,6 +688,10 @@ public:
         return axis_value < threshold;
     }
 
+    Input::Clock::time_point GetChangeTime() const override {
+        return joystick->GetAxisChangeTime(axis);
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int axis;
@@ -670,6 +714,10 @@ public:
         return std::make_tuple<float, float>(0.0f, 0.0f);
     }
 
+    Input::Clock::time_point GetChangeTime() const override {
+        return std::max(joystick->GetAxisChangeTime(axis_x), joystick->GetAxisChangeTime(axis_y));
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     const int axis_x;
@@ -853,10 +901,14 @@ SDLState::SDLState() {
     initialized = true;
     if (start_thread) {
         poll_thread = std::thread([this] {
-            using namespace std::chrono_literals;
+            // Waiting for the events, instead of pumping them periodically, hands them to the
+            // event watcher as soon as they arrive. The timeout only bounds the shutdown.
+            SDL_Event event;
             while (initialized) {
-                SDL_PumpEvents();
-                std::this_thread::sleep_for(10ms);
+                if (SDL_WaitEventTimeout(&event, 10)) {
+                    while (SDL_PollEvent(&event)) {
+                    }
+                }
             }
         });
     }
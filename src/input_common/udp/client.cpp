@@ -17,6 +17,75 @@ using boost::asio::ip::udp;
 
 namespace InputCommon::CemuhookUDP {
 
+namespace {
+
+/// Growth of the device clock offset estimate per sample, so that it follows the clock drift
+constexpr auto DEVICE_OFFSET_DRIFT = std::chrono::microseconds{1};
+
+/// Longest time the motion is extrapolated past the newest sample
+constexpr auto MAX_EXTRAPOLATION = std::chrono::milliseconds{8};
+
+} // Anonymous namespace
+
+void MotionHistory::Push(u64 device_timestamp, Input::Clock::time_point receive_time,
+                         const Common::Vec3f& accel, const Common::Vec3f& gyro) {
+    Input::Clock::time_point time = receive_time;
+    if (device_timestamp > last_device_timestamp) {
+        // The offset with the least network delay is the smallest one. The samples are stamped
+        // with the device time shifted by it, which keeps their spacing free of network jitter.
+        const Input::Clock::time_point device_time{std::chrono::microseconds{device_timestamp}};
+        const Input::Clock::duration offset = receive_time - device_time;
+        device_offset =
+            device_offset ? std::min(*device_offset + DEVICE_OFFSET_DRIFT, offset) : offset;
+        time = device_time + *device_offset;
+    } else {
+        // The server does not send timestamps, or the device restarted
+        device_offset.reset();
+    }
+    last_device_timestamp = device_timestamp;
+
+    if (num_samples != 0) {
+        time = std::max(time, samples[newest].time);
+        newest = (newest + 1) % MaxSamples;
+    }
+    samples[newest] = {time, accel, gyro};
+    num_samples = std::min(num_samples + 1, MaxSamples);
+}
+
+std::tuple<Common::Vec3f, Common::Vec3f> MotionHistory::GetMotion(
+    Input::Clock::time_point time) const {
+    if (num_samples == 0) {
+        return {};
+    }
+    const auto sample_at_age = [this](std::size_t age) -> const Sample& {
+        return samples[(newest + MaxSamples - age) % MaxSamples];
+    };
+    const auto blend = [](const Sample& a, const Sample& b, Input::Clock::duration elapsed) {
+        const float t = static_cast<float>(elapsed.count()) / (b.time - a.time).count();
+        return std::make_tuple(a.accel + (b.accel - a.accel) * t, a.gyro + (b.gyro - a.gyro) * t);
+    };
+
+    const Sample& last = sample_at_age(0);
+    if (time >= last.time) {
+        if (num_samples == 1 || sample_at_age(1).time == last.time) {
+            return {last.accel, last.gyro};
+        }
+        // Extrapolated along the two newest samples, by at most one packet interval
+        const Sample& previous = sample_at_age(1);
+        const auto ahead = std::min({time - last.time, last.time - previous.time,
+                                     Input::Clock::duration{MAX_EXTRAPOLATION}});
+        return blend(previous, last, last.time - previous.time + ahead);
+    }
+    for (std::size_t age = 1; age < num_samples; age++) {
+        const Sample& older = sample_at_age(age);
+        if (older.time <= time) {
+            return blend(older, sample_at_age(age - 1), time - older.time);
+        }
+    }
+    const Sample& oldest = sample_at_age(num_samples - 1);
+    return {oldest.accel, oldest.gyro};
+}
+
 struct SocketCallback {
     std::function<void(Response::Version)> version;
     std::function<void(Response::PortInfo)> port_info;
@@ -174,7 +243,7 @@ void Client::OnPadData(Response::PadData data) {
     {
         std::lock_guard guard(status->update_mutex);
 
-        status->motion_status = {accel, gyro};
+        status->motion_history.Push(data.motion_timestamp, Input::Clock::now(), accel, gyro);
 
         // TODO: add a setting for "click" touch. Click touch refers to a device that differentiates
         // between a simple "tap" and a hard press that causes the touch screen to click.
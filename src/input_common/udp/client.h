@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -14,6 +15,7 @@
 #include "common/common_types.h"
 #include "common/thread.h"
 #include "common/vector_math.h"
+#include "core/frontend/input.h"
 
 namespace InputCommon::CemuhookUDP {
 
@@ -28,9 +30,48 @@ struct PortInfo;
 struct Version;
 } // namespace Response
 
+/**
+ * Recent motion samples of a pad, stamped with host times derived from the timestamps of the
+ * device. The motion is then resampled at the time the HID module reads it, instead of handing it
+ * the last packet received, which jitters and goes stale when the packet and HID rates differ.
+ */
+class MotionHistory {
+public:
+    /**
+     * Adds a sample.
+     * @param device_timestamp Time the device measured the sample at, in microseconds, or 0 if the
+     *     server does not provide it
+     * @param receive_time Host time the sample was received at
+     */
+    void Push(u64 device_timestamp, Input::Clock::time_point receive_time,
+              const Common::Vec3f& accel, const Common::Vec3f& gyro);
+
+    /// Returns the accelerometer and gyroscope values at a host time, interpolated between the
+    /// samples around it, or extrapolated a little from the newest samples.
+    std::tuple<Common::Vec3f, Common::Vec3f> GetMotion(Input::Clock::time_point time) const;
+
+private:
+    struct Sample {
+        Input::Clock::time_point time;
+        Common::Vec3f accel;
+        Common::Vec3f gyro;
+    };
+
+    static constexpr std::size_t MaxSamples = 8;
+
+    std::array<Sample, MaxSamples> samples{};
+    std::size_t num_samples = 0;
+    /// Index of the newest sample
+    std::size_t newest = 0;
+
+    /// Estimate of the host time minus the device time, the smallest one seen
+    std::optional<Input::Clock::duration> device_offset;
+    u64 last_device_timestamp = 0;
+};
+
 struct DeviceStatus {
     std::mutex update_mutex;
-    std::tuple<Common::Vec3<float>, Common::Vec3<float>> motion_status;
+    MotionHistory motion_history;
     std::tuple<float, float, bool> touch_status;
 
     // calibration data for scaling the device's touch area to 3ds
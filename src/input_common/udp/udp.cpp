@@ -29,8 +29,10 @@ class UDPMotionDevice final : public Input::MotionDevice {
 public:
     explicit UDPMotionDevice(std::shared_ptr<DeviceStatus> status_) : status(std::move(status_)) {}
     std::tuple<Common::Vec3<float>, Common::Vec3<float>> GetStatus() const override {
+        // Resampled at the time the HID module reads it
+        const Input::Clock::time_point now = Input::Clock::now();
         std::lock_guard guard(status->update_mutex);
-        return status->motion_status;
+        return status->motion_history.GetMotion(now);
     }
 
 private:
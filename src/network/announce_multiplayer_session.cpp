@@ -61,6 +61,8 @@ void AnnounceMultiplayerSession::Start() {
 void AnnounceMultiplayerSession::Stop() {
     if (announce_multiplayer_thread) {
         shutdown_event.Set();
+        // Don't wait for the announce service to answer a request in progress
+        backend->Interrupt();
         announce_multiplayer_thread->join();
         announce_multiplayer_thread.reset();
         backend->Delete();
@@ -111,7 +113,9 @@ void AnnounceMultiplayerSession::AnnounceMultiplayerLoop() {
     if (!registered) {
         Common::WebResult result = Register();
         if (result.result_code != Common::WebResult::Code::Success) {
-            ErrorCallback(result);
+            if (!shutdown_event.IsSet()) {
+                ErrorCallback(result);
+            }
             return;
         }
     }
@@ -129,6 +133,10 @@ void AnnounceMultiplayerSession::AnnounceMultiplayerLoop() {
         }
         UpdateBackendData(room);
         Common::WebResult result = backend->Update();
+        if (shutdown_event.IsSet()) {
+            // The update was interrupted by Stop, its failure is not an error
+            break;
+        }
         if (result.result_code != Common::WebResult::Code::Success) {
             ErrorCallback(result);
         }
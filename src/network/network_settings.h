@@ -14,6 +14,11 @@ struct Values {
     std::string web_api_url;
     std::string citra_username;
     std::string citra_token;
+
+    // Multiplayer
+    /// Wi-Fi frames to the same peer queued within this many microseconds are sent to the room as a
+    /// single packet. 0 sends every frame on its own.
+    unsigned int wifi_coalescing_window_us;
 } extern values;
 
 } // namespace NetSettings
@@ -9,6 +9,7 @@
 #endif
 #include <cstring>
 #include <string>
+#include <utility>
 #include "network/packet.h"
 
 namespace Network {
@@ -25,8 +26,58 @@ u64 ntohll(u64 x) {
 }
 #endif
 
+namespace {
+
+/// Maximum number of buffers kept by the pool of a thread
+constexpr std::size_t MaxPooledBuffers = 16;
+/// Buffers larger than this are freed instead of being kept in the pool
+constexpr std::size_t MaxPooledCapacity = 0x10000;
+
+struct BufferPool {
+    ~BufferPool();
+
+    std::vector<std::vector<char>> buffers;
+};
+
+// Packets may be destroyed after the pool of their thread, at exit. The flag is trivially
+// destructible, so it can still be checked then.
+thread_local bool buffer_pool_destroyed = false;
+thread_local BufferPool buffer_pool;
+
+BufferPool::~BufferPool() {
+    buffer_pool_destroyed = true;
+}
+
+} // Anonymous namespace
+
+Packet::Packet() {
+    if (!buffer_pool_destroyed && !buffer_pool.buffers.empty()) {
+        data = std::move(buffer_pool.buffers.back());
+        buffer_pool.buffers.pop_back();
+    }
+}
+
+Packet::Packet(const void* in_data, std::size_t size_in_bytes)
+    : external_data{static_cast<const char*>(in_data)}, external_size{size_in_bytes} {}
+
+Packet::~Packet() {
+    const std::size_t capacity = data.capacity();
+    if (capacity == 0 || capacity > MaxPooledCapacity || buffer_pool_destroyed ||
+        buffer_pool.buffers.size() >= MaxPooledBuffers) {
+        return;
+    }
+    data.clear();
+    buffer_pool.buffers.push_back(std::move(data));
+}
+
 void Packet::Append(const void* in_data, std::size_t size_in_bytes) {
     if (in_data && (size_in_bytes > 0)) {
+        // Own the external data before writing after it
+        if (external_data) {
+            data.assign(external_data, external_data + external_size);
+            external_data = nullptr;
+            external_size = 0;
+        }
         std::size_t start = data.size();
         data.resize(start + size_in_bytes);
         std::memcpy(&data[start], in_data, size_in_bytes);
@@ -35,19 +86,21 @@ void Packet::Append(const void* in_data, std::size_t size_in_bytes) {
 
 void Packet::Read(void* out_data, std::size_t size_in_bytes) {
     if (out_data && CheckSize(size_in_bytes)) {
-        std::memcpy(out_data, &data[read_pos], size_in_bytes);
+        std::memcpy(out_data, Bytes() + read_pos, size_in_bytes);
         read_pos += size_in_bytes;
     }
 }
 
 void Packet::Clear() {
     data.clear();
+    external_data = nullptr;
+    external_size = 0;
     read_pos = 0;
     is_valid = true;
 }
 
 const void* Packet::GetData() const {
-    return !data.empty() ? &data[0] : nullptr;
+    return Size() > 0 ? Bytes() : nullptr;
 }
 
 void Packet::IgnoreBytes(u32 length) {
@@ -55,11 +108,11 @@ void Packet::IgnoreBytes(u32 length) {
 }
 
 std::size_t Packet::GetDataSize() const {
-    return data.size();
+    return Size();
 }
 
 bool Packet::EndOfPacket() const {
-    return read_pos >= data.size();
+    return read_pos >= Size();
 }
 
 Packet::operator bool() const {
@@ -143,7 +196,7 @@ Packet& Packet::operator>>(char* out_data) {
 
     if ((length > 0) && CheckSize(length)) {
         // Then extract characters
-        std::memcpy(out_data, &data[read_pos], length);
+        std::memcpy(out_data, Bytes() + read_pos, length);
         out_data[length] = '\0';
 
         // Update reading position
@@ -161,7 +214,7 @@ Packet& Packet::operator>>(std::string& out_data) {
     out_data.clear();
     if ((length > 0) && CheckSize(length)) {
         // Then extract characters
-        out_data.assign(&data[read_pos], length);
+        out_data.assign(Bytes() + read_pos, length);
 
         // Update reading position
         read_pos += length;
@@ -255,7 +308,7 @@ Packet& Packet::operator<<(const std::string& in_data) {
 }
 
 bool Packet::CheckSize(std::size_t size) {
-    is_valid = is_valid && (read_pos + size <= data.size());
+    is_valid = is_valid && (read_pos + size <= Size());
 
     return is_valid;
 }
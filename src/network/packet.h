@@ -5,16 +5,39 @@
 #pragma once
 
 #include <array>
+#include <cstring>
+#include <string>
+#include <type_traits>
 #include <vector>
 #include "common/common_types.h"
 
 namespace Network {
 
-/// A class that serializes data for network transfer. It also handles endianess
+/**
+ * A class that serializes data for network transfer. It also handles endianess
+ *
+ * The buffers of destroyed packets are kept in a small pool of the thread, and reused by the next
+ * packets built on it, so that the steady traffic of a connection does not allocate.
+ */
 class Packet {
 public:
-    Packet() = default;
-    ~Packet() = default;
+    Packet();
+
+    /**
+     * Creates a packet reading from a buffer owned by the caller, like the data of a received ENet
+     * packet, without copying it. The buffer must outlive the packet, or be copied by appending
+     * data to the packet.
+     * @param data        Pointer to the bytes to read from
+     * @param size_in_bytes Number of bytes in the buffer
+     */
+    Packet(const void* data, std::size_t size_in_bytes);
+
+    ~Packet();
+
+    Packet(const Packet&) = default;
+    Packet& operator=(const Packet&) = default;
+    Packet(Packet&&) noexcept = default;
+    Packet& operator=(Packet&&) noexcept = default;
 
     /**
      * Append data to the end of the packet
@@ -111,10 +134,27 @@ private:
      */
     bool CheckSize(std::size_t size);
 
+    /// Returns the bytes of the packet, from the external buffer if there is one.
+    const char* Bytes() const {
+        return external_data ? external_data : data.data();
+    }
+
+    /// Returns the number of bytes of the packet.
+    std::size_t Size() const {
+        return external_data ? external_size : data.size();
+    }
+
+    /// Whether vectors of T are read and written as raw bytes
+    template <typename T>
+    static constexpr bool IsByte =
+        sizeof(T) == 1 && std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
     // Member data
-    std::vector<char> data;   ///< Data stored in the packet
-    std::size_t read_pos = 0; ///< Current reading position in the packet
-    bool is_valid = true;     ///< Reading state of the packet
+    std::vector<char> data;              ///< Data stored in the packet
+    const char* external_data = nullptr; ///< Buffer read from instead of data, if any
+    std::size_t external_size = 0;       ///< Size of the external buffer
+    std::size_t read_pos = 0;            ///< Current reading position in the packet
+    bool is_valid = true;                ///< Reading state of the packet
 };
 
 template <typename T>
@@ -122,13 +162,25 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
     // First extract the size
     u32 size = 0;
     *this >> size;
-    out_data.resize(size);
 
-    // Then extract the data
-    for (std::size_t i = 0; i < out_data.size(); ++i) {
-        T character;
-        *this >> character;
-        out_data[i] = character;
+    // Bytes are copied at once, after checking that the packet really has that many
+    if constexpr (IsByte<T>) {
+        if (CheckSize(size)) {
+            out_data.resize(size);
+            std::memcpy(out_data.data(), Bytes() + read_pos, size);
+            read_pos += size;
+        } else {
+            out_data.clear();
+        }
+    } else {
+        out_data.resize(size);
+
+        // Then extract the data
+        for (std::size_t i = 0; i < out_data.size(); ++i) {
+            T character;
+            *this >> character;
+            out_data[i] = character;
+        }
     }
     return *this;
 }
@@ -149,8 +201,12 @@ Packet& Packet::operator<<(const std::vector<T>& in_data) {
     *this << static_cast<u32>(in_data.size());
 
     // Then insert the data
-    for (std::size_t i = 0; i < in_data.size(); ++i) {
-        *this << in_data[i];
+    if constexpr (IsByte<T>) {
+        Append(in_data.data(), in_data.size());
+    } else {
+        for (std::size_t i = 0; i < in_data.size(); ++i) {
+            *this << in_data[i];
+        }
     }
     return *this;
 }
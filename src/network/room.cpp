@@ -4,12 +4,17 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstring>
 #include <mutex>
 #include <random>
 #include <regex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include "common/logging/log.h"
+#include "common/thread_worker.h"
+#include "common/threadsafe_queue.h"
 #include "enet/enet.h"
 #include "network/packet.h"
 #include "network/room.h"
@@ -41,10 +46,24 @@ public:
         /// Data of the user, often including authenticated forum username.
         VerifyUser::UserData user_data;
         ENetPeer* peer; ///< The remote peer.
+        /// Connection statistics, copied from the peer by the server loop
+        u32 round_trip_time = 0;
+        double packet_loss = 0.0;
     };
     using MemberList = std::vector<Member>;
     MemberList members;              ///< Information about the members of this room
     mutable std::mutex member_mutex; ///< Mutex for locking the members list
+
+    struct MacAddressHash {
+        std::size_t operator()(const MacAddress& mac) const noexcept {
+            u64 value = 0;
+            std::memcpy(&value, mac.data(), mac.size());
+            return std::hash<u64>{}(value);
+        }
+    };
+    /// Peer of each member by MAC address, to relay packets without scanning the members list.
+    /// Kept in sync with members and locked by member_mutex.
+    std::unordered_map<MacAddress, ENetPeer*, MacAddressHash> member_peers;
     /// This should be a std::shared_mutex as soon as C++17 is supported
 
     UsernameBanList username_ban_list; ///< List of banned usernames
@@ -60,17 +79,47 @@ public:
     /// Verification backend of the room
     std::unique_ptr<VerifyUser::Backend> verify_backend;
 
+    /// A join request whose user data is being loaded by the verification worker
+    struct PendingJoin {
+        Member member;
+        bool generated_mac; ///< Whether the MAC address was assigned by the room
+        u32 connect_id;     ///< ENet connection the request was received on
+    };
+    /// Joins verified by the worker, completed by the server loop
+    Common::SPSCQueue<PendingJoin> verified_joins;
+    /// Number of joins queued to the worker and not completed yet
+    std::atomic<std::size_t> pending_joins = 0;
+
+    /// Traffic counters, updated by the server loop
+    std::atomic<u64> wifi_packets_received = 0;
+    std::atomic<u64> wifi_bytes_received = 0;
+    std::atomic<u64> wifi_packets_relayed = 0;
+    std::atomic<u64> wifi_bytes_relayed = 0;
+    std::atomic<u64> wifi_packets_dropped = 0;
+    /// When the server loop last copied the connection statistics of the peers
+    std::chrono::steady_clock::time_point peer_stats_time{};
+    /// Loads the user data of joining clients, which may query the web service, so that it does
+    /// not hold up the packets relayed by the server loop
+    Common::ThreadWorker verify_worker{1, "Room verification", Common::ThreadRole::Background};
+
     /// Thread function that will receive and dispatch messages until the room is destroyed.
     void ServerLoop();
     void StartLoop();
 
     /**
-     * Parses and answers a room join request from a client.
+     * Parses a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
-     * that the client will use for the remainder of the connection.
+     * that the client will use for the remainder of the connection, then queues the
+     * verification of the user.
      */
     void HandleJoinRequest(const ENetEvent* event);
 
+    /**
+     * Adds a verified client to the room and answers its join request, unless it disconnected
+     * or another client took its name, MAC address or console while it was verified.
+     */
+    void FinishJoinRequest(PendingJoin& join);
+
     /**
      * Parses and answers a kick request from a client.
      * Validates the permissions and that the given user exists and then kicks the member.
@@ -244,13 +293,32 @@ public:
      * to all other clients.
      */
     void HandleClientDisconnection(ENetPeer* client);
+
+    /// Copies the connection statistics of the peers to the members, as ENet is only used by the
+    /// server loop.
+    void UpdatePeerStatistics();
+
+    /// Removes a member from the members list and the peer lookup. member_mutex must be held.
+    void EraseMember(MemberList::iterator member);
 };
 
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
+        PendingJoin join;
+        while (verified_joins.Pop(join)) {
+            pending_joins--;
+            FinishJoinRequest(join);
+        }
+
+        if (std::chrono::steady_clock::now() - peer_stats_time >= std::chrono::seconds(1)) {
+            UpdatePeerStatistics();
+        }
+
+        // Poll more often while joins are being verified, to answer them soon after
+        const u32 timeout = pending_joins > 0 ? 1 : 16;
         ENetEvent event;
-        if (enet_host_service(server, &event, 16) > 0) {
+        if (enet_host_service(server, &event, timeout) > 0) {
             switch (event.type) {
             case ENET_EVENT_TYPE_RECEIVE:
                 switch (event.packet->data[0]) {
@@ -261,6 +329,7 @@ void Room::RoomImpl::ServerLoop() {
                     HandleGameNamePacket(&event);
                     break;
                 case IdWifiPacket:
+                case IdWifiPacketBatch:
                     HandleWifiPacket(&event);
                     break;
                 case IdChatMessage:
@@ -280,7 +349,10 @@ void Room::RoomImpl::ServerLoop() {
                     HandleModGetBanListPacket(&event);
                     break;
                 }
-                enet_packet_destroy(event.packet);
+                // Packets relayed to other members are freed by ENet once they have been sent
+                if (event.packet->referenceCount == 0) {
+                    enet_packet_destroy(event.packet);
+                }
                 break;
             case ENET_EVENT_TYPE_DISCONNECT:
                 HandleClientDisconnection(event.peer);
@@ -307,8 +379,7 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
             return;
         }
     }
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string nickname;
     packet >> nickname;
@@ -338,7 +409,8 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
         return;
     }
 
-    if (preferred_mac != NoPreferredMac) {
+    const bool generated_mac = preferred_mac == NoPreferredMac;
+    if (!generated_mac) {
         // Verify if the preferred mac is available
         if (!IsValidMacAddress(preferred_mac)) {
             SendMacCollision(event->peer);
@@ -359,7 +431,7 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
         return;
     }
 
-    // At this point the client is ready to be added to the room.
+    // At this point the client is ready to be verified.
     Member member{};
     member.mac_address = preferred_mac;
     member.console_id_hash = console_id_hash;
@@ -371,7 +443,51 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
         std::lock_guard lock(verify_UID_mutex);
         uid = verify_UID;
     }
-    member.user_data = verify_backend->LoadUserData(uid, token);
+
+    pending_joins++;
+    verify_worker.QueueWork([this, member = std::move(member), generated_mac, uid = std::move(uid),
+                             token = std::move(token),
+                             connect_id = event->peer->connectID]() mutable {
+        member.user_data = verify_backend->LoadUserData(uid, token);
+        verified_joins.Push(PendingJoin{std::move(member), generated_mac, connect_id});
+    });
+}
+
+void Room::RoomImpl::FinishJoinRequest(PendingJoin& join) {
+    Member& member = join.member;
+    ENetPeer* peer = member.peer;
+
+    // The client may have disconnected during the verification, and its peer been reused since
+    if (peer->state != ENET_PEER_STATE_CONNECTED || peer->connectID != join.connect_id) {
+        return;
+    }
+
+    // Check again what other clients may have taken since the request was received
+    {
+        std::lock_guard lock(member_mutex);
+        if (members.size() >= room_information.member_slots) {
+            SendRoomIsFull(peer);
+            return;
+        }
+    }
+
+    if (!IsValidNickname(member.nickname)) {
+        SendNameCollision(peer);
+        return;
+    }
+
+    if (!IsValidMacAddress(member.mac_address)) {
+        if (!join.generated_mac) {
+            SendMacCollision(peer);
+            return;
+        }
+        member.mac_address = GenerateMacAddress();
+    }
+
+    if (!IsValidConsoleId(member.console_id_hash)) {
+        SendConsoleIdCollision(peer);
+        return;
+    }
 
     std::string ip;
     {
@@ -382,17 +498,17 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
             std::find(username_ban_list.begin(), username_ban_list.end(),
                       member.user_data.username) != username_ban_list.end()) {
 
-            SendUserBanned(event->peer);
+            SendUserBanned(peer);
             return;
         }
 
         // Check IP ban
         char ip_raw[256];
-        enet_address_get_host_ip(&event->peer->address, ip_raw, sizeof(ip_raw) - 1);
+        enet_address_get_host_ip(&peer->address, ip_raw, sizeof(ip_raw) - 1);
         ip = ip_raw;
 
         if (std::find(ip_ban_list.begin(), ip_ban_list.end(), ip) != ip_ban_list.end()) {
-            SendUserBanned(event->peer);
+            SendUserBanned(peer);
             return;
         }
     }
@@ -400,17 +516,19 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     // Notify everyone that the user has joined.
     SendStatusMessage(IdMemberJoin, member.nickname, member.user_data.username, ip);
 
+    const MacAddress mac_address = member.mac_address;
     {
         std::lock_guard lock(member_mutex);
+        member_peers.emplace(member.mac_address, member.peer);
         members.push_back(std::move(member));
     }
 
     // Notify everyone that the room information has changed.
     BroadcastRoomInformation();
-    if (HasModPermission(event->peer)) {
-        SendJoinSuccessAsMod(event->peer, preferred_mac);
+    if (HasModPermission(peer)) {
+        SendJoinSuccessAsMod(peer, mac_address);
     } else {
-        SendJoinSuccess(event->peer, preferred_mac);
+        SendJoinSuccess(peer, mac_address);
     }
 }
 
@@ -420,8 +538,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string nickname;
@@ -448,7 +565,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         ip = ip_raw;
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        EraseMember(target_member);
     }
 
     // Announce the change to all clients.
@@ -462,8 +579,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string nickname;
@@ -491,7 +607,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         ip = ip_raw;
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        EraseMember(target_member);
     }
 
     {
@@ -523,8 +639,7 @@ void Room::RoomImpl::HandleModUnbanPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string address;
@@ -846,56 +961,61 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
 }
 
 void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8));         // Message type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
-    in_packet.IgnoreBytes(sizeof(MacAddress)); // WifiPacket Transmitter Address
+    ENetPacket* enet_packet = event->packet;
+    wifi_packets_received.fetch_add(1, std::memory_order_relaxed);
+    wifi_bytes_received.fetch_add(enet_packet->dataLength, std::memory_order_relaxed);
+
+    // Read the destination in place, after the message type, the WifiPacket type and channel (or
+    // the frame count of a batch), and the transmitter address
+    constexpr std::size_t destination_offset = 3 * sizeof(u8) + sizeof(MacAddress);
+    if (enet_packet->dataLength < destination_offset + sizeof(MacAddress)) {
+        LOG_ERROR(Network, "Received a truncated WifiPacket of {} bytes", enet_packet->dataLength);
+        wifi_packets_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
     MacAddress destination_address;
-    in_packet >> destination_address;
+    std::memcpy(destination_address.data(), enet_packet->data + destination_offset,
+                destination_address.size());
 
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    // The received packet is relayed as is, on the channel and with the reliability it was sent
+    // with. ENet counts the recipients it was queued for, and the server loop only frees it if it
+    // was not queued for any.
+    const u8 channel = event->channelID;
 
+    u64 recipients = 0;
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
         std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
-        for (const auto& member : members) {
-            if (member.peer != event->peer) {
-                sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
+        for (const auto& [mac_address, peer] : member_peers) {
+            if (peer != event->peer && enet_peer_send(peer, channel, enet_packet) == 0) {
+                recipients++;
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
         std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member) -> bool {
-                                       return member.mac_address == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+        const auto member = member_peers.find(destination_address);
+        if (member != member_peers.end()) {
+            if (enet_peer_send(member->second, channel, enet_packet) == 0) {
+                recipients++;
+            }
         } else {
             LOG_ERROR(Network,
                       "Attempting to send to unknown MAC address: "
                       "{:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3], destination_address[4], destination_address[5]);
-            enet_packet_destroy(enet_packet);
         }
     }
+
+    if (recipients == 0) {
+        wifi_packets_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    wifi_packets_relayed.fetch_add(recipients, std::memory_order_relaxed);
+    wifi_bytes_relayed.fetch_add(recipients * enet_packet->dataLength, std::memory_order_relaxed);
     enet_host_flush(server);
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
+    Packet in_packet(event->packet->data, event->packet->dataLength);
 
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string message;
@@ -944,8 +1064,7 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
 }
 
 void Room::RoomImpl::HandleGameNamePacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
+    Packet in_packet(event->packet->data, event->packet->dataLength);
 
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     GameInfo game_info;
@@ -976,6 +1095,21 @@ void Room::RoomImpl::HandleGameNamePacket(const ENetEvent* event) {
     BroadcastRoomInformation();
 }
 
+void Room::RoomImpl::UpdatePeerStatistics() {
+    std::lock_guard lock(member_mutex);
+    for (auto& member : members) {
+        member.round_trip_time = member.peer->roundTripTime;
+        member.packet_loss =
+            static_cast<double>(member.peer->packetLoss) / ENET_PEER_PACKET_LOSS_SCALE;
+    }
+    peer_stats_time = std::chrono::steady_clock::now();
+}
+
+void Room::RoomImpl::EraseMember(MemberList::iterator member) {
+    member_peers.erase(member->mac_address);
+    members.erase(member);
+}
+
 void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
     // Remove the client from the members list.
     std::string nickname, username, ip;
@@ -992,7 +1126,7 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
             enet_address_get_host_ip(&member->peer->address, ip_raw, sizeof(ip_raw) - 1);
             ip = ip_raw;
 
-            members.erase(member);
+            EraseMember(member);
         }
     }
 
@@ -1041,6 +1175,11 @@ bool Room::Create(const std::string& name, const std::string& description,
     room_impl->verify_backend = std::move(verify_backend);
     room_impl->username_ban_list = ban_list.first;
     room_impl->ip_ban_list = ban_list.second;
+    room_impl->wifi_packets_received = 0;
+    room_impl->wifi_bytes_received = 0;
+    room_impl->wifi_packets_relayed = 0;
+    room_impl->wifi_bytes_relayed = 0;
+    room_impl->wifi_packets_dropped = 0;
 
     room_impl->StartLoop();
     return true;
@@ -1075,11 +1214,24 @@ std::vector<Room::Member> Room::GetRoomMemberList() const {
         member.avatar_url = member_impl.user_data.avatar_url;
         member.mac_address = member_impl.mac_address;
         member.game_info = member_impl.game_info;
+        member.round_trip_time = member_impl.round_trip_time;
+        member.packet_loss = member_impl.packet_loss;
         member_list.push_back(member);
     }
     return member_list;
 }
 
+Room::Statistics Room::GetStatistics() const {
+    return {
+        .wifi_packets_received = room_impl->wifi_packets_received.load(std::memory_order_relaxed),
+        .wifi_bytes_received = room_impl->wifi_bytes_received.load(std::memory_order_relaxed),
+        .wifi_packets_relayed = room_impl->wifi_packets_relayed.load(std::memory_order_relaxed),
+        .wifi_bytes_relayed = room_impl->wifi_bytes_relayed.load(std::memory_order_relaxed),
+        .wifi_packets_dropped = room_impl->wifi_packets_dropped.load(std::memory_order_relaxed),
+        .pending_joins = room_impl->pending_joins.load(std::memory_order_relaxed),
+    };
+}
+
 bool Room::HasPassword() const {
     return !room_impl->password.empty();
 }
@@ -1094,6 +1246,13 @@ void Room::Destroy() {
     room_impl->room_thread->join();
     room_impl->room_thread.reset();
 
+    // Drop the joins that were still being verified
+    room_impl->verify_worker.WaitForRequests();
+    RoomImpl::PendingJoin join;
+    while (room_impl->verified_joins.Pop(join)) {
+    }
+    room_impl->pending_joins = 0;
+
     if (room_impl->server) {
         enet_host_destroy(room_impl->server);
     }
@@ -1102,6 +1261,7 @@ void Room::Destroy() {
     {
         std::lock_guard lock(room_impl->member_mutex);
         room_impl->members.clear();
+        room_impl->member_peers.clear();
     }
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
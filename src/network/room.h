@@ -13,7 +13,7 @@
 
 namespace Network {
 
-constexpr u32 network_version = 4; ///< The version of this Room and RoomMember
+constexpr u32 network_version = 6; ///< The version of this Room and RoomMember
 
 constexpr u16 DefaultRoomPort = 24872;
 
@@ -22,7 +22,12 @@ constexpr u32 MaxMessageSize = 500;
 /// Maximum number of concurrent connections allowed to this room.
 static constexpr u32 MaxConcurrentConnections = 254;
 
-constexpr std::size_t NumChannels = 1; // Number of channels used for the connection
+constexpr std::size_t NumChannels = 2; // Number of channels used for the connection
+
+/// Channel of the reliable messages, including the WifiPackets that have to arrive
+constexpr u8 ReliableChannel = 0;
+/// Channel of the WifiPackets sent unreliably, whose loss matters less than delaying the next ones
+constexpr u8 UnreliableChannel = 1;
 
 struct RoomInformation {
     std::string name;           ///< Name of the server
@@ -76,6 +81,8 @@ enum RoomMessageTypes : u8 {
     IdModPermissionDenied,
     IdModNoSuchUser,
     IdJoinSuccessAsMod,
+    /// Several WifiPackets with the same transmitter and destination
+    IdWifiPacketBatch,
 };
 
 /// Types of system status messages
@@ -102,6 +109,18 @@ public:
         std::string avatar_url;   ///< Url to the member's avatar. Can be empty.
         GameInfo game_info;       ///< The current game of the member
         MacAddress mac_address;   ///< The assigned mac address of the member.
+        u32 round_trip_time;      ///< Mean round trip time to the member, in milliseconds.
+        double packet_loss;       ///< Recent fraction of the packets to the member that were lost.
+    };
+
+    /// Traffic handled by the room since it was created.
+    struct Statistics {
+        u64 wifi_packets_received; ///< WifiPackets received from the members
+        u64 wifi_bytes_received;   ///< Size of the WifiPackets received from the members
+        u64 wifi_packets_relayed;  ///< WifiPackets queued for a recipient, once per recipient
+        u64 wifi_bytes_relayed;    ///< Size of the WifiPackets queued for a recipient
+        u64 wifi_packets_dropped;  ///< WifiPackets that were truncated or had no recipient
+        u64 pending_joins;         ///< Join requests waiting for the verification of the user
     };
 
     Room();
@@ -127,6 +146,11 @@ public:
      */
     std::vector<Member> GetRoomMemberList() const;
 
+    /**
+     * Gets the traffic handled by the room.
+     */
+    Statistics GetStatistics() const;
+
     /**
      * Checks if the room is password protected
      */
@@ -4,12 +4,18 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <iterator>
+#include <limits>
 #include <list>
 #include <mutex>
 #include <set>
 #include <thread>
+#include <vector>
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "enet/enet.h"
+#include "network/network_settings.h"
 #include "network/packet.h"
 #include "network/room_member.h"
 
@@ -17,6 +23,12 @@ namespace Network {
 
 constexpr u32 ConnectionTimeoutMs = 5000;
 
+/// How long the member loop waits for incoming data before sending the queued packets
+constexpr u32 PollTimeoutMs = 1;
+
+/// Size above which a batch of WifiPackets is sent, so that it fits in one ENet fragment
+constexpr std::size_t MaxWifiBatchSize = 1200;
+
 class RoomMember::RoomMemberImpl {
 public:
     ENetHost* client = nullptr; ///< ENet network interface.
@@ -45,8 +57,24 @@ public:
     std::mutex network_mutex; ///< Mutex that controls access to the `client` variable.
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> loop_thread;
-    std::mutex send_list_mutex;  ///< Mutex that controls access to the `send_list` variable.
-    std::list<Packet> send_list; ///< A list that stores all packets to send the async
+    struct OutgoingPacket {
+        Packet packet;
+        bool reliable;
+    };
+    struct OutgoingWifiPacket {
+        WifiPacket packet;
+        bool reliable;
+        std::chrono::steady_clock::time_point queue_time;
+    };
+    std::mutex send_list_mutex; ///< Mutex that controls access to the send lists.
+    std::list<OutgoingPacket> send_list; ///< A list that stores all packets to send the async
+    /// WifiPackets waiting to be coalesced, in the order they were queued
+    std::vector<OutgoingWifiPacket> wifi_send_list;
+    /// WifiPackets being sent by the member loop, kept to reuse its storage
+    std::vector<OutgoingWifiPacket> wifi_flush_list;
+
+    /// Last WifiPacket received, reused so that receiving frames does not allocate
+    WifiPacket received_wifi_packet;
 
     template <typename T>
     using CallbackSet = std::set<CallbackHandle<T>>;
@@ -73,10 +101,23 @@ public:
     void StartLoop();
 
     /**
-     * Sends data to the room. It will be send on channel 0 with flag RELIABLE
+     * Sends data to the room. Reliable data is sent on ReliableChannel with flag RELIABLE, the
+     * rest on UnreliableChannel.
      * @param packet The data to send
+     * @param reliable Whether the data is resent until it arrives
+     */
+    void Send(Packet&& packet, bool reliable = true);
+
+    /// Queues a WifiPacket, to be sent with the others to the same destination queued shortly after.
+    void SendWifiPacket(WifiPacket&& wifi_packet, bool reliable);
+
+    /**
+     * Sends queued WifiPackets to the room. Consecutive packets with the same transmitter,
+     * destination and reliability are coalesced into IdWifiPacketBatch messages.
+     * @param wifi_packets The packets to send, in the order they were queued
+     * @param coalesce Whether packets may be coalesced, otherwise each one is sent on its own
      */
-    void Send(Packet&& packet);
+    void FlushWifiPackets(const std::vector<OutgoingWifiPacket>& wifi_packets, bool coalesce);
 
     /**
      * Sends a request to the server, asking for permission to join a room with the specified
@@ -108,6 +149,12 @@ public:
      */
     void HandleWifiPackets(const ENetEvent* event);
 
+    /**
+     * Splits a batch of WifiPackets from a received ENet packet.
+     * @param event The ENet event that was received.
+     */
+    void HandleWifiPacketBatch(const ENetEvent* event);
+
     /**
      * Extracts a chat entry from a received ENet packet and adds it to the chat queue.
      * @param event The ENet event that was received.
@@ -160,13 +207,16 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
     while (IsConnected()) {
         std::lock_guard network_lock(network_mutex);
         ENetEvent event;
-        if (enet_host_service(client, &event, 16) > 0) {
+        if (enet_host_service(client, &event, PollTimeoutMs) > 0) {
             switch (event.type) {
             case ENET_EVENT_TYPE_RECEIVE:
                 switch (event.packet->data[0]) {
                 case IdWifiPacket:
                     HandleWifiPackets(&event);
                     break;
+                case IdWifiPacketBatch:
+                    HandleWifiPacketBatch(&event);
+                    break;
                 case IdChatMessage:
                     HandleChatPacket(&event);
                     break;
@@ -253,16 +303,26 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
             }
         }
 
-        std::list<Packet> packets;
+        // WifiPackets are held until the oldest one has waited for the coalescing window, so that
+        // the frames a game sends in a burst leave as a few ENet packets.
+        const std::chrono::microseconds window{NetSettings::values.wifi_coalescing_window_us};
+        std::list<OutgoingPacket> packets;
         {
             std::lock_guard send_list_lock(send_list_mutex);
             packets.swap(send_list);
+            if (!wifi_send_list.empty() &&
+                std::chrono::steady_clock::now() - wifi_send_list.front().queue_time >= window) {
+                wifi_flush_list.swap(wifi_send_list);
+            }
         }
-        for (const auto& packet : packets) {
-            ENetPacket* enetPacket = enet_packet_create(packet.GetData(), packet.GetDataSize(),
-                                                        ENET_PACKET_FLAG_RELIABLE);
-            enet_peer_send(server, 0, enetPacket);
+        for (const auto& [packet, reliable] : packets) {
+            ENetPacket* enetPacket =
+                enet_packet_create(packet.GetData(), packet.GetDataSize(),
+                                   reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
+            enet_peer_send(server, reliable ? ReliableChannel : UnreliableChannel, enetPacket);
         }
+        FlushWifiPackets(wifi_flush_list, window.count() > 0);
+        wifi_flush_list.clear();
         enet_host_flush(client);
     }
     Disconnect();
@@ -272,9 +332,67 @@ void RoomMember::RoomMemberImpl::StartLoop() {
     loop_thread = std::make_unique<std::thread>(&RoomMember::RoomMemberImpl::MemberLoop, this);
 }
 
-void RoomMember::RoomMemberImpl::Send(Packet&& packet) {
+void RoomMember::RoomMemberImpl::Send(Packet&& packet, bool reliable) {
+    std::lock_guard lock(send_list_mutex);
+    send_list.push_back({std::move(packet), reliable});
+}
+
+void RoomMember::RoomMemberImpl::SendWifiPacket(WifiPacket&& wifi_packet, bool reliable) {
     std::lock_guard lock(send_list_mutex);
-    send_list.push_back(std::move(packet));
+    wifi_send_list.push_back({std::move(wifi_packet), reliable, std::chrono::steady_clock::now()});
+}
+
+void RoomMember::RoomMemberImpl::FlushWifiPackets(
+    const std::vector<OutgoingWifiPacket>& wifi_packets, bool coalesce) {
+    const auto send = [this](const Packet& packet, bool reliable) {
+        ENetPacket* enet_packet = enet_packet_create(packet.GetData(), packet.GetDataSize(),
+                                                     reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
+        enet_peer_send(server, reliable ? ReliableChannel : UnreliableChannel, enet_packet);
+    };
+
+    // Serialized size of a WifiPacket in a batch: its type, channel, data size and data
+    const auto frame_size = [](const WifiPacket& wifi_packet) {
+        return 2 * sizeof(u8) + sizeof(u32) + wifi_packet.data.size();
+    };
+
+    auto begin = wifi_packets.begin();
+    while (begin != wifi_packets.end()) {
+        const WifiPacket& first = begin->packet;
+        auto end = std::next(begin);
+        std::size_t batch_size = frame_size(first);
+        while (coalesce && end != wifi_packets.end() && end->reliable == begin->reliable &&
+               end->packet.transmitter_address == first.transmitter_address &&
+               end->packet.destination_address == first.destination_address &&
+               batch_size + frame_size(end->packet) <= MaxWifiBatchSize &&
+               std::distance(begin, end) < std::numeric_limits<u16>::max()) {
+            batch_size += frame_size(end->packet);
+            ++end;
+        }
+
+        Packet packet;
+        if (std::next(begin) == end) {
+            packet << static_cast<u8>(IdWifiPacket);
+            packet << static_cast<u8>(first.type);
+            packet << first.channel;
+            packet << first.transmitter_address;
+            packet << first.destination_address;
+            packet << first.data;
+        } else {
+            // The header has the size of the one of a WifiPacket, so that the room finds the
+            // destination at the same place.
+            packet << static_cast<u8>(IdWifiPacketBatch);
+            packet << static_cast<u16>(std::distance(begin, end));
+            packet << first.transmitter_address;
+            packet << first.destination_address;
+            for (auto it = begin; it != end; ++it) {
+                packet << static_cast<u8>(it->packet.type);
+                packet << it->packet.channel;
+                packet << it->packet.data;
+            }
+        }
+        send(packet, begin->reliable);
+        begin = end;
+    }
 }
 
 void RoomMember::RoomMemberImpl::SendJoinRequest(const std::string& nickname,
@@ -294,8 +412,7 @@ void RoomMember::RoomMemberImpl::SendJoinRequest(const std::string& nickname,
 }
 
 void RoomMember::RoomMemberImpl::HandleRoomInformationPacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
@@ -338,8 +455,7 @@ void RoomMember::RoomMemberImpl::HandleRoomInformationPacket(const ENetEvent* ev
 }
 
 void RoomMember::RoomMemberImpl::HandleJoinPacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
@@ -349,9 +465,8 @@ void RoomMember::RoomMemberImpl::HandleJoinPacket(const ENetEvent* event) {
 }
 
 void RoomMember::RoomMemberImpl::HandleWifiPackets(const ENetEvent* event) {
-    WifiPacket wifi_packet{};
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    WifiPacket& wifi_packet = received_wifi_packet;
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
@@ -370,9 +485,38 @@ void RoomMember::RoomMemberImpl::HandleWifiPackets(const ENetEvent* event) {
     Invoke<WifiPacket>(wifi_packet);
 }
 
+void RoomMember::RoomMemberImpl::HandleWifiPacketBatch(const ENetEvent* event) {
+    Packet packet(event->packet->data, event->packet->dataLength);
+
+    // Ignore the first byte, which is the message id.
+    packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
+
+    u16 num_frames;
+    MacAddress transmitter_address;
+    MacAddress destination_address;
+    packet >> num_frames;
+    packet >> transmitter_address;
+    packet >> destination_address;
+
+    WifiPacket& wifi_packet = received_wifi_packet;
+    for (u16 i = 0; i < num_frames; i++) {
+        u8 frame_type;
+        packet >> frame_type;
+        wifi_packet.type = static_cast<WifiPacket::PacketType>(frame_type);
+        packet >> wifi_packet.channel;
+        packet >> wifi_packet.data;
+        if (!packet) {
+            LOG_ERROR(Network, "Received a truncated batch of WifiPackets");
+            return;
+        }
+        wifi_packet.transmitter_address = transmitter_address;
+        wifi_packet.destination_address = destination_address;
+        Invoke<WifiPacket>(wifi_packet);
+    }
+}
+
 void RoomMember::RoomMemberImpl::HandleChatPacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8));
@@ -386,8 +530,7 @@ void RoomMember::RoomMemberImpl::HandleChatPacket(const ENetEvent* event) {
 }
 
 void RoomMember::RoomMemberImpl::HandleStatusMessagePacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8));
@@ -402,8 +545,7 @@ void RoomMember::RoomMemberImpl::HandleStatusMessagePacket(const ENetEvent* even
 }
 
 void RoomMember::RoomMemberImpl::HandleModBanListResponsePacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8));
@@ -586,15 +728,12 @@ bool RoomMember::IsConnected() const {
     return room_member_impl->IsConnected();
 }
 
-void RoomMember::SendWifiPacket(const WifiPacket& wifi_packet) {
-    Packet packet;
-    packet << static_cast<u8>(IdWifiPacket);
-    packet << static_cast<u8>(wifi_packet.type);
-    packet << wifi_packet.channel;
-    packet << wifi_packet.transmitter_address;
-    packet << wifi_packet.destination_address;
-    packet << wifi_packet.data;
-    room_member_impl->Send(std::move(packet));
+void RoomMember::SendWifiPacket(const WifiPacket& wifi_packet, bool reliable) {
+    room_member_impl->SendWifiPacket(WifiPacket{wifi_packet}, reliable);
+}
+
+void RoomMember::SendWifiPacket(WifiPacket&& wifi_packet, bool reliable) {
+    room_member_impl->SendWifiPacket(std::move(wifi_packet), reliable);
 }
 
 void RoomMember::SendChatMessage(const std::string& message) {
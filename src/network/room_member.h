@@ -169,8 +169,13 @@ public:
     /**
      * Sends a WiFi packet to the room.
      * @param packet The WiFi packet to send.
+     * @param reliable Whether the packet is resent until it arrives. Unreliable packets are still
+     * delivered in order, but a late one is dropped instead of holding up the ones after it.
      */
-    void SendWifiPacket(const WifiPacket& packet);
+    void SendWifiPacket(const WifiPacket& packet, bool reliable = true);
+
+    /// Sends a WiFi packet to the room, without copying its data.
+    void SendWifiPacket(WifiPacket&& packet, bool reliable = true);
 
     /**
      * Sends a chat message to the room.
@@ -0,0 +1,127 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <random>
+#include "audio_core/hle/mix.h"
+
+using namespace AudioCore;
+using namespace AudioCore::HLE;
+
+namespace {
+
+s16 ClampToS16(s32 value) {
+    return static_cast<s16>(std::clamp(value, -32768, 32767));
+}
+
+/// The scalar mixing the HLE DSP did before the vector kernels
+void ReferenceMixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& samples,
+                                const std::array<float, 4>& gains) {
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        dest[i][0] += static_cast<s32>(gains[0] * samples[i][0]);
+        dest[i][1] += static_cast<s32>(gains[1] * samples[i][1]);
+        dest[i][2] += static_cast<s32>(gains[2] * samples[i][0]);
+        dest[i][3] += static_cast<s32>(gains[3] * samples[i][1]);
+    }
+}
+
+void ReferenceDownmixQuadIntoStereo(StereoFrame16& dest, const QuadFrame32& samples, float gain) {
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        const s16 left = ClampToS16(static_cast<s32>(gain * samples[i][0] + gain * samples[i][2]));
+        const s16 right = ClampToS16(static_cast<s32>(gain * samples[i][1] + gain * samples[i][3]));
+        dest[i][0] = ClampToS16(dest[i][0] + left);
+        dest[i][1] = ClampToS16(dest[i][1] + right);
+    }
+}
+
+StereoFrame16 RandomStereoFrame(std::mt19937& rng) {
+    std::uniform_int_distribution<s32> distribution(-32768, 32767);
+    StereoFrame16 frame;
+    for (auto& sample : frame) {
+        sample = {static_cast<s16>(distribution(rng)), static_cast<s16>(distribution(rng))};
+    }
+    return frame;
+}
+
+QuadFrame32 RandomQuadFrame(std::mt19937& rng) {
+    // Up to 24 full scale sources mixed together
+    std::uniform_int_distribution<s32> distribution(-32768 * 24, 32767 * 24);
+    QuadFrame32 frame;
+    for (auto& sample : frame) {
+        for (auto& channel : sample) {
+            channel = distribution(rng);
+        }
+    }
+    return frame;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MixStereoIntoQuad", "[audio_core][hle]") {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> gain_distribution(-2.f, 2.f);
+    for (int i = 0; i < 100; i++) {
+        const StereoFrame16 samples = RandomStereoFrame(rng);
+        const std::array<float, 4> gains{gain_distribution(rng), gain_distribution(rng),
+                                         gain_distribution(rng), gain_distribution(rng)};
+        QuadFrame32 expected = RandomQuadFrame(rng);
+        QuadFrame32 result = expected;
+        ReferenceMixStereoIntoQuad(expected, samples, gains);
+        MixStereoIntoQuad(result, samples, gains);
+        REQUIRE(result == expected);
+    }
+}
+
+TEST_CASE("DownmixQuadIntoStereo", "[audio_core][hle]") {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> gain_distribution(0.f, 1.5f);
+    for (int i = 0; i < 100; i++) {
+        const QuadFrame32 samples = RandomQuadFrame(rng);
+        const float gain = gain_distribution(rng);
+        StereoFrame16 expected = RandomStereoFrame(rng);
+        StereoFrame16 result = expected;
+        ReferenceDownmixQuadIntoStereo(expected, samples, gain);
+        DownmixQuadIntoStereo(result, samples, gain);
+        REQUIRE(result == expected);
+    }
+}
+
+TEST_CASE("HLE DSP mixing[Benchmark]", "[.][benchmark]") {
+    std::mt19937 rng(3);
+    const StereoFrame16 stereo = RandomStereoFrame(rng);
+    const QuadFrame32 quad = RandomQuadFrame(rng);
+    const std::array<float, 4> gains{0.5f, 0.5f, 0.25f, 0.25f};
+
+    BENCHMARK("Mix 24 sources (reference)") {
+        QuadFrame32 dest{};
+        for (std::size_t source = 0; source < 24; source++) {
+            ReferenceMixStereoIntoQuad(dest, stereo, gains);
+        }
+        return dest;
+    };
+    BENCHMARK("Mix 24 sources") {
+        QuadFrame32 dest{};
+        for (std::size_t source = 0; source < 24; source++) {
+            MixStereoIntoQuad(dest, stereo, gains);
+        }
+        return dest;
+    };
+    BENCHMARK("Downmix 3 intermediate mixes (reference)") {
+        StereoFrame16 dest{};
+        for (std::size_t mix = 0; mix < 3; mix++) {
+            ReferenceDownmixQuadIntoStereo(dest, quad, 0.8f);
+        }
+        return dest;
+    };
+    BENCHMARK("Downmix 3 intermediate mixes") {
+        StereoFrame16 dest{};
+        for (std::size_t mix = 0; mix < 3; mix++) {
+            DownmixQuadIntoStereo(dest, quad, 0.8f);
+        }
+        return dest;
+    };
+}
@@ -0,0 +1,42 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio_core/interpolate.h"
+
+using namespace AudioCore;
+
+TEST_CASE("Polyphase keeps a constant input constant", "[audio_core][interpolate]") {
+    AudioInterp::State state;
+    StereoBuffer16 input(1000, {1234, -32768});
+    StereoFrame16 output{};
+    std::size_t outputi = 0;
+    AudioInterp::Polyphase(state, input, 0.73f, output, outputi);
+
+    REQUIRE(outputi == output.size());
+    // Skip the first samples, which are filtered with the zeroed history
+    for (std::size_t i = 5; i < output.size(); i++) {
+        REQUIRE(output[i] == std::array<s16, 2>{1234, -32768});
+    }
+}
+
+TEST_CASE("Polyphase passes samples through at the native rate", "[audio_core][interpolate]") {
+    AudioInterp::State state;
+    StereoBuffer16 input;
+    for (s16 i = 0; i < 400; i++) {
+        input.push_back({static_cast<s16>(i * 50), static_cast<s16>(-i)});
+    }
+    StereoFrame16 output{};
+    std::size_t outputi = 0;
+    AudioInterp::Polyphase(state, input, 1.0f, output, outputi);
+
+    REQUIRE(outputi == output.size());
+    // There is a two-sample predelay
+    for (std::size_t i = 2; i < output.size(); i++) {
+        const s16 sample = static_cast<s16>(i - 2);
+        REQUIRE(output[i] == std::array<s16, 2>{static_cast<s16>(sample * 50),
+                                                static_cast<s16>(-sample)});
+    }
+}
@@ -0,0 +1,60 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio_core/audio_types.h"
+#include "audio_core/wsola_stretcher.h"
+
+using namespace AudioCore;
+
+namespace {
+
+/// Stretches a 440 Hz tone played at `speed` and returns the frequency of the steady output
+double StretchedFrequency(const WsolaStretcher::Parameters& parameters, double speed) {
+    WsolaStretcher stretcher(parameters);
+    constexpr std::size_t num_out = 256;
+    const auto num_in = static_cast<std::size_t>(num_out * speed);
+    std::vector<s16> in(2 * num_in);
+    std::vector<s16> out(2 * num_out);
+
+    double phase = 0.0;
+    std::size_t frames = 0;
+    std::size_t crossings = 0;
+    s16 last = 0;
+    for (int call = 0; call < 600; call++) {
+        for (std::size_t i = 0; i < num_in; i++) {
+            in[2 * i] = in[2 * i + 1] = static_cast<s16>(10000 * std::sin(phase));
+            phase += 2 * std::numbers::pi * 440.0 / native_sample_rate;
+        }
+        const std::size_t written = stretcher.Process(in.data(), num_in, out.data(), num_out);
+
+        // Let the stretch ratio settle first
+        if (call < 300) {
+            continue;
+        }
+        REQUIRE(written == num_out);
+        for (std::size_t i = 0; i < written; i++) {
+            crossings += last < 0 && out[2 * i] >= 0;
+            last = out[2 * i];
+        }
+        frames += written;
+    }
+    return static_cast<double>(crossings) * native_sample_rate / static_cast<double>(frames);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("WSOLA keeps the pitch when stretching", "[audio_core][time_stretch]") {
+    for (const auto& parameters : {WsolaStretcher::LowLatency, WsolaStretcher::Balanced}) {
+        for (const double speed : {0.5, 1.0, 1.5}) {
+            const double frequency = StretchedFrequency(parameters, speed);
+            REQUIRE(frequency > 435.0);
+            REQUIRE(frequency < 445.0);
+        }
+    }
+}
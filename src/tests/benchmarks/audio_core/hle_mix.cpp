@@ -0,0 +1,40 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "audio_core/hle/mix.h"
+#include "audio_core/hle/mixers.h"
+
+using namespace AudioCore;
+using namespace AudioCore::HLE;
+
+TEST_CASE("HLE DSP frame mixing[Benchmark]", "[benchmark][audio_core]") {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<s32> distribution(-32768, 32767);
+    StereoFrame16 source_frame;
+    for (auto& sample : source_frame) {
+        sample = {static_cast<s16>(distribution(rng)), static_cast<s16>(distribution(rng))};
+    }
+    const std::array<float, 4> gains{0.5f, 0.5f, 0.25f, 0.25f};
+
+    Mixers mixers;
+    DspConfiguration config{};
+    IntermediateMixSamples read_samples{};
+    IntermediateMixSamples write_samples{};
+
+    // What the DSP does every 5 ms with all the sources playing: each source is mixed into the
+    // three intermediate mixes, which are then downmixed into the output frame.
+    BENCHMARK("Mix a frame of 24 sources") {
+        std::array<QuadFrame32, 3> intermediate_mixes{};
+        for (std::size_t source = 0; source < 24; source++) {
+            for (auto& mix : intermediate_mixes) {
+                MixStereoIntoQuad(mix, source_frame, gains);
+            }
+        }
+        mixers.Tick(config, read_samples, write_samples, intermediate_mixes);
+        return mixers.GetOutput()[0][0];
+    };
+}
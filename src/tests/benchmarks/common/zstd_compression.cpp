@@ -0,0 +1,71 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "common/zstd_compression.h"
+
+namespace {
+
+/// Data shaped like a savestate: FCRAM is mostly untouched zero pages, with game data in between.
+std::vector<u8> MakeSaveStateData(std::size_t size) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<u32> distribution(0, 255);
+    std::vector<u8> data(size);
+    constexpr std::size_t page_size = 0x1000;
+    for (std::size_t page = 0; page < size; page += page_size) {
+        if (page / page_size % 4 != 0) {
+            continue;
+        }
+        // Small values, like the vertex data and structures of the games
+        for (std::size_t i = page; i < std::min(page + page_size, size); i++) {
+            data[i] = static_cast<u8>(distribution(rng) & 0x0F);
+        }
+    }
+    return data;
+}
+
+std::vector<u8> Compress(std::span<const u8> data, u32 num_workers) {
+    std::vector<u8> compressed;
+    Common::Compression::ZSTDCompressStreamBuf buffer{
+        [&compressed](std::span<const u8> chunk) {
+            compressed.insert(compressed.end(), chunk.begin(), chunk.end());
+            return true;
+        },
+        0, num_workers};
+    buffer.sputn(reinterpret_cast<const char*>(data.data()),
+                 static_cast<std::streamsize>(data.size()));
+    REQUIRE(buffer.Finish());
+    return compressed;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Savestate compression[Benchmark]", "[benchmark][common]") {
+    const std::vector<u8> data = MakeSaveStateData(16 * 1024 * 1024);
+
+    BENCHMARK("Compress 16 MiB") {
+        return Compress(data, 0).size();
+    };
+    BENCHMARK("Compress 16 MiB on 4 workers") {
+        return Compress(data, 4).size();
+    };
+
+    const std::vector<u8> compressed = Compress(data, 0);
+    std::vector<char> decompressed(data.size());
+    BENCHMARK("Decompress 16 MiB") {
+        std::size_t offset = 0;
+        Common::Compression::ZSTDDecompressStreamBuf buffer{[&](std::span<u8> chunk) {
+            const std::size_t size = std::min(chunk.size(), compressed.size() - offset);
+            std::memcpy(chunk.data(), compressed.data() + offset, size);
+            offset += size;
+            return size;
+        }};
+        return buffer.sgetn(decompressed.data(), static_cast<std::streamsize>(decompressed.size()));
+    };
+}
@@ -0,0 +1,39 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "core/core.h"
+#include "core/core_timing.h"
+
+namespace {
+constexpr s64 SliceLength = BASE_CLOCK_RATE_ARM11 / 234; // Copied from CoreTiming internals
+} // Anonymous namespace
+
+TEST_CASE("CoreTiming[Benchmark]", "[benchmark][core]") {
+    Core::Timing timing(1, 100);
+    Core::TimingEventType* event = timing.RegisterEvent("benchmark", [](std::uintptr_t, s64) {});
+    auto* timer = timing.GetTimer(0).get();
+    timer->Advance();
+    timer->SetNextSlice();
+
+    BENCHMARK("Schedule and remove 64 events") {
+        for (u64 i = 0; i < 64; i++) {
+            timing.ScheduleEvent(SliceLength * 100 + i * 1000, event, i, 0);
+        }
+        timing.RemoveEvent(event);
+    };
+
+    // Events that fire within the slice, like the GSP and DSP interrupts of a busy frame
+    BENCHMARK("Schedule and dispatch 64 events") {
+        for (u64 i = 0; i < 64; i++) {
+            timing.ScheduleEvent(i * (SliceLength / 64), event, i, 0);
+        }
+        for (u64 i = 0; i < 64; i++) {
+            timer->AddTicks(SliceLength / 64);
+            timer->Advance();
+            timer->SetNextSlice();
+        }
+    };
+}
@@ -0,0 +1,55 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+
+TEST_CASE("MemorySystem::ReadBlock[Benchmark]", "[benchmark][core]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    auto& vm_manager = process->vm_manager;
+
+    // A contiguous heap block, and the same amount of memory backed page by page like a heap
+    // grown over time
+    constexpr u32 page_size = Memory::CITRA_PAGE_SIZE;
+    constexpr u32 block_size = 64 * page_size;
+    constexpr VAddr contiguous_addr = Memory::HEAP_VADDR;
+    constexpr VAddr fragmented_addr = Memory::HEAP_VADDR + block_size;
+    MemoryRef contiguous{std::make_shared<BufferMem>(block_size)};
+    REQUIRE(vm_manager
+                .MapBackingMemory(contiguous_addr, contiguous, block_size,
+                                  Kernel::MemoryState::Private)
+                .Succeeded());
+    for (u32 offset = 0; offset < block_size; offset += page_size) {
+        MemoryRef page{std::make_shared<BufferMem>(page_size)};
+        REQUIRE(vm_manager
+                    .MapBackingMemory(fragmented_addr + offset, page, page_size,
+                                      Kernel::MemoryState::Private)
+                    .Succeeded());
+    }
+
+    std::vector<u8> buffer(block_size);
+    BENCHMARK("Read 256 KiB contiguous") {
+        memory.ReadBlock(*process, contiguous_addr, buffer.data(), buffer.size());
+        return buffer[0];
+    };
+    BENCHMARK("Read 256 KiB page by page") {
+        memory.ReadBlock(*process, fragmented_addr, buffer.data(), buffer.size());
+        return buffer[0];
+    };
+    BENCHMARK("Read 64 bytes") {
+        memory.ReadBlock(*process, contiguous_addr + 0x100, buffer.data(), 64);
+        return buffer[0];
+    };
+}
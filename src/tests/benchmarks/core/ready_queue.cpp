@@ -0,0 +1,45 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "common/thread_queue_list.h"
+#include "core/hle/kernel/thread.h"
+
+namespace {
+
+struct FakeThread {
+    u32 priority{};
+    Common::ThreadQueueNode<FakeThread> queue_node;
+};
+
+using ReadyQueue = Common::ThreadQueueList<FakeThread, Kernel::ThreadPrioLowest + 1>;
+
+} // Anonymous namespace
+
+TEST_CASE("ThreadQueueList[Benchmark]", "[benchmark][core]") {
+    ReadyQueue queue;
+
+    // A typical title keeps a few dozen threads spread over the userland priorities
+    std::array<FakeThread, 32> threads{};
+    for (std::size_t i = 0; i < threads.size(); i++) {
+        threads[i].priority = Kernel::ThreadPrioUserlandMax + static_cast<u32>(i % 8) * 4;
+        queue.push_back(threads[i].priority, &threads[i]);
+    }
+
+    BENCHMARK("Reschedule to the best ready thread") {
+        FakeThread* next = queue.pop_first();
+        queue.push_back(next->priority, next);
+        return next;
+    };
+
+    BENCHMARK("Preempt with a boosted thread") {
+        FakeThread& thread = threads[threads.size() - 1];
+        queue.move(&thread, thread.priority, Kernel::ThreadPrioHighest);
+        FakeThread* next = queue.pop_first_better(Kernel::ThreadPrioDefault);
+        queue.push_back(thread.priority, next);
+        return next;
+    };
+}
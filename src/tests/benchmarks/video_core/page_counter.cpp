@@ -0,0 +1,87 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include <vector>
+#include <boost/icl/interval_map.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/page_counter.h"
+
+using VideoCore::PageCounter;
+
+namespace {
+
+using Range = std::pair<PAddr, u32>;
+
+/// The interval map based counting the rasterizer cache used before PageCounter
+class IntervalPageCounter {
+    using PageMap = boost::icl::interval_map<u32, int>;
+
+public:
+    template <typename Func>
+    void Update(PAddr addr, u32 size, int delta, Func&& func) {
+        const u32 page_start = addr >> Memory::CITRA_PAGE_BITS;
+        const u32 page_end = ((addr + size - 1) >> Memory::CITRA_PAGE_BITS) + 1;
+        const auto pages_interval = PageMap::interval_type::right_open(page_start, page_end);
+        if (delta > 0) {
+            cached_pages.add({pages_interval, delta});
+        }
+        const auto [begin, end] = cached_pages.equal_range(pages_interval);
+        for (auto it = begin; it != end; ++it) {
+            const auto interval = it->first & pages_interval;
+            const int count = it->second;
+            if ((delta > 0 && count == delta) || (delta < 0 && count == -delta)) {
+                const PAddr start = boost::icl::first(interval) << Memory::CITRA_PAGE_BITS;
+                const PAddr end_addr = boost::icl::last_next(interval) << Memory::CITRA_PAGE_BITS;
+                func(start, end_addr - start);
+            }
+        }
+        if (delta < 0) {
+            cached_pages.add({pages_interval, delta});
+        }
+    }
+
+private:
+    PageMap cached_pages;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("PageCounter[Benchmark]", "[benchmark][video_core]") {
+    // Surfaces of a typical frame: framebuffers, render targets and a spread of textures.
+    std::vector<Range> surfaces;
+    for (u32 i = 0; i < 4; i++) {
+        surfaces.emplace_back(0x18000000 + i * 0x60000, 0x5DC00);
+    }
+    for (u32 i = 0; i < 256; i++) {
+        surfaces.emplace_back(0x20000000 + i * 0x9000, 0x8000);
+    }
+
+    u64 marked = 0;
+    const auto on_transition = [&marked](PAddr, u32 size) { marked += size; };
+
+    // Every iteration leaves the counters empty again, so they are reused.
+    PageCounter page_counter;
+    BENCHMARK("PageCounter register and unregister") {
+        for (const auto& [addr, size] : surfaces) {
+            page_counter.Update(addr, size, 1, on_transition);
+        }
+        for (const auto& [addr, size] : surfaces) {
+            page_counter.Update(addr, size, -1, on_transition);
+        }
+        return marked;
+    };
+
+    IntervalPageCounter interval_counter;
+    BENCHMARK("Interval map register and unregister") {
+        for (const auto& [addr, size] : surfaces) {
+            interval_counter.Update(addr, size, 1, on_transition);
+        }
+        for (const auto& [addr, size] : surfaces) {
+            interval_counter.Update(addr, size, -1, on_transition);
+        }
+        return marked;
+    };
+}
@@ -0,0 +1,108 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/arch.h"
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <nihstro/inline_assembly.h>
+#include "video_core/pica/shader_setup.h"
+#include "video_core/pica/shader_unit.h"
+#include "video_core/shader/shader_interpreter.h"
+#if CITRA_ARCH(x86_64)
+#include "video_core/shader/shader_jit_x64_compiler.h"
+#elif CITRA_ARCH(arm64)
+#include "video_core/shader/shader_jit_a64_compiler.h"
+#endif
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+
+namespace {
+
+/// Vertices processed per benchmark run, a typical batch of the GPU
+constexpr std::size_t NumVertices = 64;
+
+/// A transform shader: the position by a 4x4 matrix, the color by a tint plus an offset
+std::unique_ptr<Pica::ShaderSetup> MakeTransformShader() {
+    const auto position = SourceRegister::MakeInput(0);
+    const auto color = SourceRegister::MakeInput(1);
+    const auto out_position = DestRegister::MakeOutput(0);
+    const auto out_color = DestRegister::MakeOutput(1);
+
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary({
+        {OpCode::Id::DP4, out_position, "x", SourceRegister::MakeFloat(0), "xyzw", position,
+         "xyzw"},
+        {OpCode::Id::DP4, out_position, "y", SourceRegister::MakeFloat(1), "xyzw", position,
+         "xyzw"},
+        {OpCode::Id::DP4, out_position, "z", SourceRegister::MakeFloat(2), "xyzw", position,
+         "xyzw"},
+        {OpCode::Id::DP4, out_position, "w", SourceRegister::MakeFloat(3), "xyzw", position,
+         "xyzw"},
+        {OpCode::Id::MUL, out_color, "xyzw", SourceRegister::MakeFloat(4), "xyzw", color, "xyzw"},
+        {OpCode::Id::MAX, out_color, "xyzw", SourceRegister::MakeFloat(5), "xyzw", color, "xyzw"},
+        {OpCode::Id::END},
+    });
+
+    auto shader = std::make_unique<Pica::ShaderSetup>();
+    std::transform(shbin.program.begin(), shbin.program.end(), shader->program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
+                   shader->swizzle_data.begin(), [](const auto& x) { return x.hex; });
+    for (u32 i = 0; i < 6; i++) {
+        const auto value = Pica::f24::FromFloat32(0.5f + i);
+        shader->uniforms.f[i] = Common::Vec4<Pica::f24>::AssignToAll(value);
+    }
+    return shader;
+}
+
+std::array<Pica::ShaderUnit, NumVertices> MakeUnits() {
+    std::array<Pica::ShaderUnit, NumVertices> units;
+    for (std::size_t i = 0; i < units.size(); i++) {
+        const auto value = Pica::f24::FromFloat32(static_cast<float>(i) / NumVertices);
+        units[i].input[0] = Common::Vec4<Pica::f24>::AssignToAll(value);
+        units[i].input[1] = Common::Vec4<Pica::f24>::AssignToAll(value);
+    }
+    return units;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ShaderEngine[Benchmark]", "[benchmark][video_core]") {
+    const auto setup = MakeTransformShader();
+    auto units = MakeUnits();
+
+    Pica::Shader::InterpreterEngine interpreter;
+    BENCHMARK("Interpreter 64 vertices") {
+        for (auto& unit : units) {
+            interpreter.Run(*setup, unit);
+        }
+        return units[0].output[0].x.ToFloat32();
+    };
+
+    Pica::Shader::JitShader jit;
+    jit.Compile(&setup->program_code, &setup->swizzle_data);
+    BENCHMARK("JIT 64 vertices") {
+        for (auto& unit : units) {
+            jit.Run(*setup, unit, 0);
+        }
+        return units[0].output[0].x.ToFloat32();
+    };
+    BENCHMARK("JIT 64 vertices batched") {
+        jit.RunBatch(*setup, units, 0);
+        return units[0].output[0].x.ToFloat32();
+    };
+
+    BENCHMARK("JIT compilation") {
+        Pica::Shader::JitShader shader;
+        shader.Compile(&setup->program_code, &setup->swizzle_data);
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/surface_params.h"
+#include "video_core/rasterizer_cache/utils.h"
+
+using VideoCore::PixelFormat;
+using VideoCore::SurfaceParams;
+
+namespace {
+
+constexpr PAddr SurfaceAddress = 0x18000000;
+
+SurfaceParams MakeSurface(PixelFormat format, u32 size, bool is_tiled) {
+    SurfaceParams params;
+    params.addr = SurfaceAddress;
+    params.width = size;
+    params.height = size;
+    params.is_tiled = is_tiled;
+    params.pixel_format = format;
+    params.UpdateParams();
+    return params;
+}
+
+std::vector<u8> MakeData(std::size_t size) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<u32> distribution(0, 255);
+    std::vector<u8> data(size);
+    for (u8& value : data) {
+        value = static_cast<u8>(distribution(rng));
+    }
+    return data;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DecodeTexture[Benchmark]", "[benchmark][video_core]") {
+    // Decoded texels are at most 4 bytes
+    std::vector<u8> decoded(256 * 256 * 4);
+
+    const SurfaceParams rgba8 = MakeSurface(PixelFormat::RGBA8, 256, true);
+    std::vector<u8> rgba8_data = MakeData(rgba8.size);
+    BENCHMARK("Decode tiled RGBA8 256x256") {
+        VideoCore::DecodeTexture(rgba8, rgba8.addr, rgba8.end, rgba8_data, decoded);
+        return decoded[0];
+    };
+    BENCHMARK("Decode tiled RGBA8 256x256 converted") {
+        VideoCore::DecodeTexture(rgba8, rgba8.addr, rgba8.end, rgba8_data, decoded, true);
+        return decoded[0];
+    };
+
+    const SurfaceParams rgb565 = MakeSurface(PixelFormat::RGB565, 256, true);
+    std::vector<u8> rgb565_data = MakeData(rgb565.size);
+    BENCHMARK("Decode tiled RGB565 256x256") {
+        VideoCore::DecodeTexture(rgb565, rgb565.addr, rgb565.end, rgb565_data, decoded);
+        return decoded[0];
+    };
+
+    const SurfaceParams linear = MakeSurface(PixelFormat::RGBA8, 256, false);
+    std::vector<u8> linear_data = MakeData(linear.size);
+    BENCHMARK("Decode linear RGBA8 256x256") {
+        VideoCore::DecodeTexture(linear, linear.addr, linear.end, linear_data, decoded);
+        return decoded[0];
+    };
+}
+
+TEST_CASE("DecodeTexture[ETC1][Benchmark]", "[benchmark][video_core]") {
+    std::vector<u8> decoded(256 * 256 * 4);
+
+    const SurfaceParams etc1 = MakeSurface(PixelFormat::ETC1, 256, true);
+    std::vector<u8> etc1_data = MakeData(etc1.size);
+    BENCHMARK("Decode ETC1 256x256") {
+        VideoCore::DecodeTexture(etc1, etc1.addr, etc1.end, etc1_data, decoded);
+        return decoded[0];
+    };
+
+    const SurfaceParams etc1a4 = MakeSurface(PixelFormat::ETC1A4, 256, true);
+    std::vector<u8> etc1a4_data = MakeData(etc1a4.size);
+    BENCHMARK("Decode ETC1A4 256x256") {
+        VideoCore::DecodeTexture(etc1a4, etc1a4.addr, etc1a4.end, etc1a4_data, decoded);
+        return decoded[0];
+    };
+}
+
+TEST_CASE("EncodeTexture[Benchmark]", "[benchmark][video_core]") {
+    // Flushes of render targets back to guest memory
+    const SurfaceParams rgba8 = MakeSurface(PixelFormat::RGBA8, 256, true);
+    std::vector<u8> rgba8_linear = MakeData(256 * 256 * 4);
+    std::vector<u8> rgba8_tiled(rgba8.size);
+    BENCHMARK("Encode tiled RGBA8 256x256") {
+        VideoCore::EncodeTexture(rgba8, rgba8.addr, rgba8.end, rgba8_linear, rgba8_tiled);
+        return rgba8_tiled[0];
+    };
+    BENCHMARK("Encode tiled RGBA8 256x256 converted") {
+        VideoCore::EncodeTexture(rgba8, rgba8.addr, rgba8.end, rgba8_linear, rgba8_tiled, true);
+        return rgba8_tiled[0];
+    };
+
+    const SurfaceParams d24s8 = MakeSurface(PixelFormat::D24S8, 256, true);
+    std::vector<u8> d24s8_linear = MakeData(256 * 256 * 4);
+    std::vector<u8> d24s8_tiled(d24s8.size);
+    BENCHMARK("Encode tiled D24S8 256x256") {
+        VideoCore::EncodeTexture(d24s8, d24s8.addr, d24s8.end, d24s8_linear, d24s8_tiled);
+        return d24s8_tiled[0];
+    };
+}
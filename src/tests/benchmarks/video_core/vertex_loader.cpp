@@ -0,0 +1,72 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "core/core.h"
+#include "core/memory.h"
+#include "video_core/pica/vertex_loader.h"
+
+using Format = Pica::PipelineRegs::VertexAttributeFormat;
+
+namespace {
+
+/// Interleaved vertex of a textured mesh: float position, byte color and short texcoord
+struct Vertex {
+    std::array<f32, 3> position;
+    std::array<u8, 4> color;
+    std::array<s16, 2> texcoord;
+};
+static_assert(sizeof(Vertex) == 20);
+
+constexpr std::size_t NumVertices = 1024;
+
+Pica::PipelineRegs MakeRegs() {
+    Pica::PipelineRegs regs{};
+    auto& attributes = regs.vertex_attributes;
+    attributes.format0.Assign(Format::FLOAT);
+    attributes.size0.Assign(2);
+    attributes.format1.Assign(Format::UBYTE);
+    attributes.size1.Assign(3);
+    attributes.format2.Assign(Format::SHORT);
+    attributes.size2.Assign(1);
+    attributes.max_attribute_index.Assign(2);
+
+    auto& loader = attributes.attribute_loaders[0];
+    loader.comp0.Assign(0);
+    loader.comp1.Assign(1);
+    loader.comp2.Assign(2);
+    loader.byte_count.Assign(sizeof(Vertex));
+    loader.component_count.Assign(3);
+    return regs;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("VertexLoader[Benchmark]", "[benchmark][video_core]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+
+    for (std::size_t i = 0; i < NumVertices; i++) {
+        const Vertex vertex{
+            .position = {static_cast<f32>(i), 1.0f, -1.0f},
+            .color = {static_cast<u8>(i), 0x80, 0x40, 0xFF},
+            .texcoord = {static_cast<s16>(i), static_cast<s16>(-i)},
+        };
+        std::memcpy(memory.GetFCRAMPointer(i * sizeof(Vertex)), &vertex, sizeof(Vertex));
+    }
+
+    const Pica::PipelineRegs regs = MakeRegs();
+    const Pica::VertexLoader loader{memory, regs};
+    Pica::AttributeBuffer input{};
+    Pica::AttributeBuffer default_attributes{};
+
+    BENCHMARK("Load 1024 vertices") {
+        for (u32 vertex = 0; vertex < NumVertices; vertex++) {
+            loader.LoadVertex(Memory::FCRAM_PADDR, vertex, vertex, input, default_attributes);
+        }
+        return input[0].x.ToFloat32();
+    };
+}
@@ -0,0 +1,66 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/async_file_reader.h"
+#include "common/file_util.h"
+
+TEST_CASE("AsyncFileReader: Batched reads", "[common]") {
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string path = (directory / "citra_async_file_reader.bin").string();
+
+    std::vector<u8> data(256 * 1024 + 77);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<u8>(i * 31 + i / 256);
+    }
+    {
+        FileUtil::IOFile file(path, "wb");
+        REQUIRE(file.WriteBytes(data.data(), data.size()) == data.size());
+    }
+
+    FileUtil::IOFile file(path, "rb");
+    REQUIRE(file.IsOpen());
+    FileUtil::AsyncFileReader reader{3, "Test I/O"};
+
+    constexpr std::size_t ChunkSize = 4096;
+    const std::size_t num_chunks = (data.size() + ChunkSize - 1) / ChunkSize;
+    std::vector<u8> buffer(num_chunks * ChunkSize);
+    std::vector<FileUtil::AsyncFileReader::Request> requests;
+    for (std::size_t i = 0; i < num_chunks; i++) {
+        requests.push_back({buffer.data() + i * ChunkSize, ChunkSize, i * ChunkSize});
+    }
+    std::vector<std::size_t> read_sizes(num_chunks);
+    std::atomic<std::size_t> num_callbacks{0};
+    reader
+        .ReadBatch(file, std::move(requests),
+                   [&](std::size_t index, std::size_t read_size) {
+                       read_sizes[index] = read_size;
+                       ++num_callbacks;
+                   })
+        .wait();
+
+    REQUIRE(num_callbacks == num_chunks);
+    for (std::size_t i = 0; i + 1 < num_chunks; i++) {
+        REQUIRE(read_sizes[i] == ChunkSize);
+    }
+    // The last read stops at the end of the file
+    REQUIRE(read_sizes.back() == data.size() - (num_chunks - 1) * ChunkSize);
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.begin()));
+
+    std::vector<u8> single(100);
+    REQUIRE(reader.ReadAt(file, single.data(), single.size(), 1000).get() == single.size());
+    REQUIRE(std::equal(single.begin(), single.end(), data.begin() + 1000));
+
+    REQUIRE(reader.ReadBatch(file, {}, {}).wait_for(std::chrono::seconds{0}) ==
+            std::future_status::ready);
+
+    file.Close();
+    FileUtil::Delete(path);
+}
@@ -3,7 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <string>
+#include <thread>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -24,3 +28,53 @@ TEST_CASE("SplitFilename83 Sanity", "[common]") {
     REQUIRE(std::memcmp(short_name.data(), expected_short_name.data(), short_name.size()) == 0);
     REQUIRE(std::memcmp(extension.data(), expected_extension.data(), extension.size()) == 0);
 }
+
+TEST_CASE("IOFile: Appends under a lock do not interleave", "[common]") {
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string path = (directory / "citra_file_lock.bin").string();
+    FileUtil::Delete(path);
+
+    // Separate handles lock like separate processes would
+    FileUtil::IOFile writer(path, "ab");
+    FileUtil::IOFile reader(path, "rb");
+    REQUIRE(writer.IsOpen());
+    REQUIRE(reader.IsOpen());
+
+    std::atomic<bool> read{false};
+    std::thread reader_thread;
+    {
+        FileUtil::ScopedFileLock lock{writer, true};
+        REQUIRE(lock.IsLocked());
+        reader_thread = std::thread([&] {
+            FileUtil::ScopedFileLock read_lock{reader, false};
+            REQUIRE(reader.GetSize() == 8);
+            read = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        REQUIRE(!read);
+        REQUIRE(writer.WriteObject(u32{1}) == 1);
+        REQUIRE(writer.WriteObject(u32{2}) == 1);
+        REQUIRE(writer.Flush());
+    }
+    reader_thread.join();
+    REQUIRE(read);
+}
+
+TEST_CASE("RenameReplacing replaces the destination", "[common]") {
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string source = (directory / "citra_rename_source.bin").string();
+    const std::string destination = (directory / "citra_rename_destination.bin").string();
+    for (const auto& [path, value] : {std::pair{source, u32{1}}, std::pair{destination, u32{2}}}) {
+        FileUtil::IOFile file(path, "wb");
+        REQUIRE(file.WriteObject(value) == 1);
+    }
+
+    REQUIRE(FileUtil::RenameReplacing(source, destination));
+    REQUIRE(!FileUtil::Exists(source));
+    FileUtil::IOFile file(destination, "rb");
+    u32 value{};
+    REQUIRE(file.ReadBytes(&value, sizeof(value)) == sizeof(value));
+    REQUIRE(value == 1);
+    file.Close();
+    FileUtil::Delete(destination);
+}
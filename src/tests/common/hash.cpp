@@ -0,0 +1,84 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <unordered_set>
+#include <vector>
+#include "common/hash.h"
+
+namespace {
+
+std::vector<u8> MakeData(std::size_t size) {
+    std::vector<u8> data(size);
+    u32 state = 0x12345678;
+    for (u8& byte : data) {
+        // Xorshift, so that the data is the same on every run
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<u8>(state);
+    }
+    return data;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ComputeFastHash64 is deterministic", "[common]") {
+    for (const std::size_t size : {0, 3, 16, 100, 128, 129, 1024, 1025, 65536}) {
+        const std::vector<u8> data = MakeData(size);
+        const std::vector<u8> copy = data;
+        REQUIRE(Common::ComputeFastHash64(data.data(), data.size()) ==
+                Common::ComputeFastHash64(copy.data(), copy.size()));
+    }
+}
+
+TEST_CASE("ComputeFastHash64 depends on the length", "[common]") {
+    const std::vector<u8> data(300, 0);
+    std::unordered_set<u64> hashes;
+    for (std::size_t len = 0; len <= data.size(); len++) {
+        hashes.insert(Common::ComputeFastHash64(data.data(), len));
+    }
+    REQUIRE(hashes.size() == data.size() + 1);
+}
+
+TEST_CASE("ComputeFastHash64 depends on every bit", "[common]") {
+    // Covers the short, medium and long paths, including a partial last block
+    for (const std::size_t size : {1, 7, 12, 48, 128, 200, 2000}) {
+        std::vector<u8> data = MakeData(size);
+        const u64 hash = Common::ComputeFastHash64(data.data(), data.size());
+        for (std::size_t bit = 0; bit < size * 8; bit++) {
+            data[bit / 8] ^= static_cast<u8>(1 << (bit % 8));
+            REQUIRE(Common::ComputeFastHash64(data.data(), data.size()) != hash);
+            data[bit / 8] ^= static_cast<u8>(1 << (bit % 8));
+        }
+    }
+}
+
+TEST_CASE("ComputeFastHash64[Benchmark]", "[.][benchmark]") {
+    // Texture uploads of 128x128, 256x256 and 512x512 RGBA8 surfaces
+    const std::vector<u8> small = MakeData(128 * 128 * 4);
+    const std::vector<u8> medium = MakeData(256 * 256 * 4);
+    const std::vector<u8> large = MakeData(512 * 512 * 4);
+
+    BENCHMARK("CityHash 64 KiB") {
+        return Common::ComputeHash64(small.data(), small.size());
+    };
+    BENCHMARK("Fast hash 64 KiB") {
+        return Common::ComputeFastHash64(small.data(), small.size());
+    };
+    BENCHMARK("CityHash 256 KiB") {
+        return Common::ComputeHash64(medium.data(), medium.size());
+    };
+    BENCHMARK("Fast hash 256 KiB") {
+        return Common::ComputeFastHash64(medium.data(), medium.size());
+    };
+    BENCHMARK("CityHash 1 MiB") {
+        return Common::ComputeHash64(large.data(), large.size());
+    };
+    BENCHMARK("Fast hash 1 MiB") {
+        return Common::ComputeFastHash64(large.data(), large.size());
+    };
+}
@@ -0,0 +1,71 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "common/host_memory.h"
+#include "common/logging/backend.h"
+
+namespace Common {
+
+constexpr std::size_t BackingSize = 0x10000;
+constexpr std::size_t VirtualSize = 0x100000;
+
+TEST_CASE("HostMemory: Aliased pages", "[common]") {
+    Common::Log::DisableLoggingInTests();
+    HostMemory backing{BackingSize};
+    if (!backing.IsValid()) {
+        SKIP("Aliased host memory is not supported on this host");
+    }
+
+    VirtualArena arena{backing, VirtualSize};
+    REQUIRE(arena.IsValid());
+
+    arena.Map(0x3000, 0x1000, 0x1000);
+    arena.Map(0x8000, 0x1000, 0x1000);
+
+    u8* const base = arena.VirtualBasePointer();
+    backing.BackingBasePointer()[0x1004] = 0xAB;
+    REQUIRE(base[0x3004] == 0xAB);
+    REQUIRE(base[0x8004] == 0xAB);
+
+    base[0x8008] = 0xCD;
+    REQUIRE(backing.BackingBasePointer()[0x1008] == 0xCD);
+    REQUIRE(base[0x3008] == 0xCD);
+
+    arena.Unmap(0x3000, 0x1000);
+    REQUIRE(base[0x8004] == 0xAB);
+}
+
+TEST_CASE("HostMemory: OffsetOf", "[common]") {
+    Common::Log::DisableLoggingInTests();
+    HostMemory backing{BackingSize};
+    if (!backing.IsValid()) {
+        SKIP("Aliased host memory is not supported on this host");
+    }
+
+    const u8* const base = backing.BackingBasePointer();
+    REQUIRE(backing.OffsetOf(base) == 0);
+    REQUIRE(backing.OffsetOf(base + 0x2000) == 0x2000);
+    REQUIRE(!backing.OffsetOf(base + BackingSize).has_value());
+}
+
+TEST_CASE("LargePageBuffer: Zeroed and writable", "[common]") {
+    Common::Log::DisableLoggingInTests();
+    // Not a multiple of the huge page size, like the emulated RAM
+    constexpr std::size_t Size = 0x1080000;
+    LargePageBuffer buffer{Size};
+    REQUIRE(buffer.IsValid());
+    REQUIRE(buffer.Size() == Size);
+
+    u8* const data = buffer.Data();
+    for (std::size_t offset = 0; offset < Size; offset += 0x1000) {
+        REQUIRE(data[offset] == 0);
+        data[offset] = static_cast<u8>(offset >> 12);
+    }
+    data[Size - 1] = 0xEF;
+    REQUIRE(data[0x5000] == 0x05);
+    REQUIRE(data[Size - 1] == 0xEF);
+}
+
+} // namespace Common
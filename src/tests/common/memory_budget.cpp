@@ -0,0 +1,65 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+#include "common/memory_budget.h"
+
+using Common::MemoryBudget;
+using Common::MemoryPressure;
+
+TEST_CASE("MemoryBudget trims the caches in priority order", "[common]") {
+    MemoryBudget& budget = MemoryBudget::Instance();
+    REQUIRE(budget.CacheBudget() != 0);
+
+    std::vector<MemoryBudget::Priority> trimmed;
+    const auto add_cache = [&](MemoryBudget::Priority priority) {
+        return budget.AddCache("test", priority, [&trimmed, priority](MemoryPressure pressure) {
+            REQUIRE(pressure == MemoryPressure::Critical);
+            trimmed.push_back(priority);
+            return u64{0};
+        });
+    };
+    const std::size_t surfaces = add_cache(MemoryBudget::Priority::Surfaces);
+    const std::size_t romfs = add_cache(MemoryBudget::Priority::RomFS);
+    const std::size_t custom_textures = add_cache(MemoryBudget::Priority::CustomTextures);
+
+    budget.ReportPressure(MemoryPressure::Moderate);
+    budget.ReportPressure(MemoryPressure::Critical);
+    budget.Update();
+    REQUIRE(budget.Pressure() == MemoryPressure::Critical);
+    REQUIRE(trimmed == std::vector{MemoryBudget::Priority::RomFS,
+                                   MemoryBudget::Priority::CustomTextures,
+                                   MemoryBudget::Priority::Surfaces});
+
+    budget.RemoveCache(surfaces);
+    budget.RemoveCache(romfs);
+    budget.RemoveCache(custom_textures);
+}
+
+TEST_CASE("MemoryBudget stops once moderate pressure is relieved", "[common]") {
+    MemoryBudget& budget = MemoryBudget::Instance();
+
+    bool surfaces_trimmed = false;
+    const std::size_t romfs = budget.AddCache(
+        "test", MemoryBudget::Priority::RomFS,
+        [&budget](MemoryPressure pressure) -> u64 {
+            // Enough to relieve moderate pressure, but not critical pressure
+            return pressure == MemoryPressure::Moderate ? budget.CacheBudget() : 0;
+        });
+    const std::size_t surfaces =
+        budget.AddCache("test", MemoryBudget::Priority::Surfaces, [&](MemoryPressure) {
+            surfaces_trimmed = true;
+            return u64{0};
+        });
+
+    budget.ReportPressure(MemoryPressure::Moderate);
+    budget.Update();
+    // The host may be under critical pressure itself, which trims every cache
+    REQUIRE(surfaces_trimmed == (budget.Pressure() == MemoryPressure::Critical));
+
+    budget.RemoveCache(romfs);
+    budget.RemoveCache(surfaces);
+}
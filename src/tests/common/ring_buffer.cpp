@@ -0,0 +1,50 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include "common/common_types.h"
+#include "common/ring_buffer.h"
+
+namespace Common {
+
+TEST_CASE("RingBuffer: Push and Pop wrap around", "[common]") {
+    RingBuffer<s16, 4, 2> buffer;
+    const std::array<s16, 6> first{1, 2, 3, 4, 5, 6};
+    REQUIRE(buffer.Push(first.data(), 3) == 3);
+
+    std::array<s16, 4> out{};
+    REQUIRE(buffer.Pop(out.data(), 2) == 2);
+    REQUIRE(out == std::array<s16, 4>{1, 2, 3, 4});
+
+    // Only three slots are free, the last one is rejected
+    const std::array<s16, 8> second{7, 8, 9, 10, 11, 12, 13, 14};
+    REQUIRE(buffer.Push(second.data(), 4) == 3);
+    REQUIRE(buffer.Size() == 4);
+
+    std::array<s16, 8> rest{};
+    REQUIRE(buffer.Pop(rest.data(), 4) == 4);
+    REQUIRE(rest == std::array<s16, 8>{5, 6, 7, 8, 9, 10, 11, 12});
+    REQUIRE(buffer.Size() == 0);
+}
+
+TEST_CASE("RingBuffer: Discard drops the oldest slots", "[common]") {
+    RingBuffer<s16, 8, 2> buffer;
+    const std::array<s16, 10> in{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    REQUIRE(buffer.Push(in.data(), 5) == 5);
+
+    REQUIRE(buffer.Discard(3) == 3);
+    REQUIRE(buffer.Size() == 2);
+
+    std::array<s16, 4> out{};
+    REQUIRE(buffer.Pop(out.data(), 2) == 2);
+    REQUIRE(out == std::array<s16, 4>{7, 8, 9, 10});
+
+    // Discarding more than is queued only empties the buffer
+    REQUIRE(buffer.Push(in.data(), 1) == 1);
+    REQUIRE(buffer.Discard(4) == 1);
+    REQUIRE(buffer.Size() == 0);
+}
+
+} // namespace Common
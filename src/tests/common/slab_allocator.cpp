@@ -0,0 +1,56 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <catch2/catch_test_macros.hpp>
+#include "common/common_types.h"
+#include "common/slab_allocator.h"
+
+namespace {
+
+struct Object {
+    explicit Object(int value_) : value(value_) {}
+    int value;
+    std::array<u8, 100> payload{};
+};
+
+} // Anonymous namespace
+
+TEST_CASE("SlabHeap[Reuse]", "[common]") {
+    Common::SlabHeap heap;
+    void* first = heap.Allocate(24);
+    void* second = heap.Allocate(24);
+    REQUIRE(first != second);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(first) % Common::SlabHeap::BLOCK_ALIGNMENT == 0);
+
+    // Freed blocks are handed out again for the same size
+    heap.Deallocate(first, 24);
+    REQUIRE(heap.Allocate(24) == first);
+    heap.Deallocate(second, 24);
+}
+
+TEST_CASE("SlabAllocator[SharedPtr]", "[common]") {
+    auto heap = std::make_shared<Common::SlabHeap>();
+    std::weak_ptr<Common::SlabHeap> weak_heap = heap;
+
+    auto object = std::allocate_shared<Object>(Common::SlabAllocator<Object>{heap}, 42);
+    REQUIRE(object->value == 42);
+
+    // The objects keep the heap alive until the last of them is gone
+    heap.reset();
+    REQUIRE(!weak_heap.expired());
+    object.reset();
+    REQUIRE(weak_heap.expired());
+
+    // The block of a destroyed object, holding its control block too, is reused by the next one
+    heap = std::make_shared<Common::SlabHeap>();
+    object = std::allocate_shared<Object>(Common::SlabAllocator<Object>{heap}, 1);
+    const Object* first = object.get();
+    object.reset();
+    object = std::allocate_shared<Object>(Common::SlabAllocator<Object>{heap}, 2);
+    REQUIRE(object.get() == first);
+    REQUIRE(object->value == 2);
+}
@@ -0,0 +1,144 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/thread_pool.h"
+
+TEST_CASE("ThreadPool: Task groups wait for their tasks", "[common]") {
+    Common::ThreadPool pool{3, 1};
+    Common::TaskGroup frame_group{Common::TaskPriority::FrameCritical, pool};
+    Common::TaskGroup background_group{Common::TaskPriority::Background, pool};
+
+    std::atomic<u32> frame_tasks{0};
+    std::atomic<u32> background_tasks{0};
+    for (u32 i = 0; i < 64; i++) {
+        frame_group.QueueWork([&frame_tasks] { ++frame_tasks; });
+        background_group.QueueWork([&background_tasks] { ++background_tasks; });
+    }
+    frame_group.WaitForRequests();
+    REQUIRE(frame_tasks == 64);
+    background_group.WaitForRequests();
+    REQUIRE(background_tasks == 64);
+}
+
+TEST_CASE("ThreadPool: Tasks queued from workers", "[common]") {
+    Common::ThreadPool pool{2, 1};
+    Common::TaskGroup group{Common::TaskPriority::FrameCritical, pool};
+
+    // Workers waiting on nested tasks run them themselves instead of deadlocking
+    std::atomic<u32> leaves{0};
+    for (u32 i = 0; i < 8; i++) {
+        group.QueueWork([&pool, &leaves] {
+            Common::TaskGroup nested{Common::TaskPriority::FrameCritical, pool};
+            for (u32 j = 0; j < 8; j++) {
+                nested.QueueWork([&leaves] { ++leaves; });
+            }
+            nested.WaitForRequests();
+        });
+    }
+    group.WaitForRequests();
+    REQUIRE(leaves == 64);
+}
+
+TEST_CASE("ThreadPool: Urgent tasks run first", "[common]") {
+    Common::ThreadPool pool{1, 1};
+    Common::TaskGroup group{Common::TaskPriority::Background, pool};
+    std::promise<void> started;
+    std::promise<void> release;
+    group.QueueWork([&started, released = release.get_future()] {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+
+    // The worker is busy, so the tasks are left to this thread in order of priority
+    std::vector<Common::TaskPriority> order;
+    for (const auto priority : {Common::TaskPriority::Prefetch, Common::TaskPriority::Background,
+                                Common::TaskPriority::FrameCritical}) {
+        group.QueueWork([&order, priority] { order.push_back(priority); }, priority);
+    }
+    while (pool.RunPendingTask(Common::TaskPriority::Prefetch)) {
+    }
+    REQUIRE(order == std::vector{Common::TaskPriority::FrameCritical,
+                                 Common::TaskPriority::Background,
+                                 Common::TaskPriority::Prefetch});
+
+    release.set_value();
+    group.WaitForRequests();
+}
+
+TEST_CASE("ThreadPool: Blocking tasks do not hold up the workers", "[common]") {
+    Common::ThreadPool pool{1, 1};
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+
+    std::vector<std::future<void>> blocked;
+    for (u32 i = 0; i < 4; i++) {
+        std::promise<void> done;
+        blocked.push_back(done.get_future());
+        pool.SubmitBlocking([released, done = std::move(done)]() mutable {
+            released.wait();
+            done.set_value();
+        });
+    }
+
+    Common::TaskGroup group{Common::TaskPriority::LatencyCritical, pool};
+    std::atomic<bool> ran{false};
+    group.QueueWork([&ran] { ran = true; });
+    group.WaitForRequests();
+    REQUIRE(ran);
+
+    release.set_value();
+    for (auto& future : blocked) {
+        future.wait();
+    }
+}
+
+TEST_CASE("ThreadPool: I/O tasks run in order per key", "[common]") {
+    Common::ThreadPool pool{1, 3};
+    constexpr u32 NumTasks = 64;
+    std::array<int, 2> keys{};
+    std::array<std::vector<u32>, 2> order;
+    std::array<std::atomic<bool>, 2> running{};
+    std::atomic<bool> overlapped{false};
+
+    std::vector<std::future<void>> done;
+    for (u32 i = 0; i < NumTasks; i++) {
+        const std::size_t key = i % 2;
+        std::promise<void> promise;
+        done.push_back(promise.get_future());
+        pool.SubmitIO(&keys[key], [&, key, i, promise = std::move(promise)]() mutable {
+            if (running[key].exchange(true)) {
+                overlapped = true;
+            }
+            order[key].push_back(i);
+            running[key] = false;
+            promise.set_value();
+        });
+    }
+    for (auto& future : done) {
+        future.wait();
+    }
+
+    REQUIRE(!overlapped);
+    for (std::size_t key = 0; key < 2; key++) {
+        REQUIRE(order[key].size() == NumTasks / 2);
+        REQUIRE(std::is_sorted(order[key].begin(), order[key].end()));
+    }
+    // The latency of a task is recorded just after it returns
+    u64 num_tasks = 0;
+    while (num_tasks < NumTasks) {
+        const auto stats = pool.GetAndResetIOStats();
+        REQUIRE(stats.max_latency >= stats.mean_latency);
+        num_tasks += stats.num_tasks;
+        std::this_thread::yield();
+    }
+    REQUIRE(num_tasks == NumTasks);
+}
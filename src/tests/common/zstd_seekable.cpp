@@ -0,0 +1,64 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/zstd_seekable.h"
+
+TEST_CASE("SeekableZSTD: Round trip through IOFile", "[common]") {
+    Common::Log::DisableLoggingInTests();
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string source_path = (directory / "citra_zstd_seekable.cci").string();
+    const std::string compressed_path = (directory / "citra_zstd_seekable.zcci").string();
+
+    // Compressible data followed by data that does not compress, spanning several blocks and
+    // ending in a partial one
+    std::vector<u8> data(1024 * 1024 + 123);
+    u32 state = 1;
+    for (std::size_t i = 0; i < data.size(); i++) {
+        state = state * 1664525 + 1013904223;
+        data[i] = i < data.size() / 2 ? static_cast<u8>(i / 1000) : static_cast<u8>(state >> 24);
+    }
+
+    {
+        FileUtil::IOFile source(source_path, "wb");
+        REQUIRE(source.WriteBytes(data.data(), data.size()) == data.size());
+    }
+    {
+        FileUtil::IOFile source(source_path, "rb");
+        REQUIRE_FALSE(source.IsCompressed());
+        FileUtil::IOFile compressed(compressed_path, "wb");
+        REQUIRE(Common::Compression::CompressSeekableZSTD(source, compressed, 0));
+    }
+
+    FileUtil::IOFile file(compressed_path, "rb");
+    REQUIRE(file.IsCompressed());
+    REQUIRE(file.GetSize() == data.size());
+
+    std::vector<u8> read(data.size());
+    REQUIRE(file.ReadAtBytes(read.data(), read.size(), 0) == read.size());
+    REQUIRE(read == data);
+
+    // Sequential reads crossing block boundaries
+    constexpr std::size_t offset = 200 * 1024 + 7;
+    std::vector<u8> part(300 * 1024);
+    REQUIRE(file.Seek(offset, SEEK_SET));
+    REQUIRE(file.ReadBytes(part.data(), part.size()) == part.size());
+    REQUIRE(std::equal(part.begin(), part.end(), data.begin() + offset));
+    REQUIRE(file.Tell() == offset + part.size());
+
+    // Reads past the end are truncated
+    REQUIRE(file.Seek(-10, SEEK_END));
+    REQUIRE(file.ReadBytes(part.data(), part.size()) == 10);
+    REQUIRE(std::equal(part.begin(), part.begin() + 10, data.end() - 10));
+
+    file.Close();
+    FileUtil::Delete(source_path);
+    FileUtil::Delete(compressed_path);
+}
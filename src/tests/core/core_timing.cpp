@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include <array>
@@ -196,4 +197,61 @@ TEST_CASE("CoreTiming[ChainScheduling]", "[core]") {
     REQUIRE(MAX_SLICE_LENGTH == timing.GetTimer(0)->GetDowncount());
 }
 
+TEST_CASE("CoreTiming[Unschedule]", "[core]") {
+    Core::Timing timing(1, 100);
+
+    Core::TimingEventType* cb_a = timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+    Core::TimingEventType* cb_b = timing.RegisterEvent("callbackB", CallbackTemplate<1>);
+    Core::TimingEventType* cb_c = timing.RegisterEvent("callbackC", CallbackTemplate<2>);
+
+    // Enter slice 0
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+
+    timing.ScheduleEvent(100, cb_a, CB_IDS[0], 0);
+    timing.ScheduleEvent(200, cb_b, CB_IDS[1], 0);
+    timing.ScheduleEvent(300, cb_c, CB_IDS[2], 0);
+    REQUIRE(100 == timing.GetTimer(0)->GetDowncount());
+
+    // Unscheduling the front event moves the next slice boundary to the following one.
+    timing.UnscheduleEvent(cb_a, CB_IDS[0]);
+    timing.UnscheduleEvent(cb_c, CB_IDS[2]);
+
+    // Events scheduled again after being unscheduled still run.
+    timing.ScheduleEvent(400, cb_c, CB_IDS[2], 0);
+
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+    REQUIRE(200 == timing.GetTimer(0)->GetDowncount());
+
+    AdvanceAndCheck(timing, 1, 200);              // cb_b
+    AdvanceAndCheck(timing, 2, MAX_SLICE_LENGTH); // cb_c
+}
+
+TEST_CASE("CoreTiming[UnscheduleManyEvents]", "[.][benchmark]") {
+    Core::Timing timing(1, 100);
+
+    Core::TimingEventType* cb = timing.RegisterEvent("callback", [](std::uintptr_t, s64) {});
+
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+
+    // Keep thousands of long running timers in flight, like the network, audio and GSP services.
+    constexpr std::size_t in_flight = 4000;
+    for (std::size_t i = 0; i < in_flight; i++) {
+        timing.ScheduleEvent(MAX_SLICE_LENGTH * 100 + i, cb, i, 0);
+    }
+
+    BENCHMARK("Schedule and unschedule a thread wakeup") {
+        timing.ScheduleEvent(MAX_SLICE_LENGTH, cb, in_flight, 0);
+        timing.UnscheduleEvent(cb, in_flight);
+    };
+
+    BENCHMARK("Advance a slice") {
+        timing.GetTimer(0)->AddTicks(MAX_SLICE_LENGTH / 100);
+        timing.GetTimer(0)->Advance();
+        timing.GetTimer(0)->SetNextSlice();
+    };
+}
+
 // TODO: Add tests for multiple timers
@@ -189,6 +189,12 @@ TEST_CASE("HLERequestContext::PopulateFromIncomingCommandBuffer", "[core][kernel
 
         CHECK(other_buffer == mem->Vector());
 
+        // The contiguous buffer is viewed in place instead of being copied
+        const auto view = context.GetMappedBuffer(0).ReadSpan(0x10, 0x20);
+        CHECK(view.data() == buffer.GetPtr() + 0x10);
+        CHECK(view.size() == 0x20);
+        CHECK(context.GetMappedBuffer(0).ReadSpan(0, buffer.GetSize() + 1).empty());
+
         REQUIRE(process->vm_manager.UnmapRange(
                     target_address, static_cast<u32>(buffer.GetSize())) == ResultSuccess);
     }
@@ -0,0 +1,54 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include "common/thread_queue_list.h"
+#include "core/hle/kernel/thread.h"
+
+namespace {
+
+struct FakeThread {
+    u32 priority{};
+    Common::ThreadQueueNode<FakeThread> queue_node;
+};
+
+using ReadyQueue = Common::ThreadQueueList<FakeThread, Kernel::ThreadPrioLowest + 1>;
+
+} // Anonymous namespace
+
+TEST_CASE("ThreadQueueList[Order]", "[core][kernel]") {
+    ReadyQueue queue;
+    std::array<FakeThread, 4> threads{};
+    threads[0].priority = 48;
+    threads[1].priority = 24;
+    threads[2].priority = 48;
+    threads[3].priority = 63;
+
+    REQUIRE(queue.get_first() == nullptr);
+    for (auto& thread : threads) {
+        queue.push_back(thread.priority, &thread);
+    }
+
+    // The best level comes first, threads of a level in insertion order
+    REQUIRE(queue.get_first() == &threads[1]);
+    REQUIRE(queue.pop_first() == &threads[1]);
+    REQUIRE(queue.empty(24));
+    REQUIRE(queue.pop_first_better(48) == nullptr);
+    REQUIRE(queue.pop_first_better(49) == &threads[0]);
+
+    queue.push_front(48, &threads[0]);
+    queue.rotate(48);
+    REQUIRE(queue.contains(&threads[0]) == 48);
+    REQUIRE(queue.pop_first() == &threads[2]);
+
+    // Removing a thread that is not queued does nothing
+    queue.remove(48, &threads[2]);
+    queue.move(&threads[3], 63, 0);
+    REQUIRE(queue.empty(63));
+    REQUIRE(queue.pop_first() == &threads[3]);
+    REQUIRE(queue.pop_first() == &threads[0]);
+    REQUIRE(queue.pop_first() == nullptr);
+    REQUIRE(queue.contains(&threads[0]) == static_cast<ReadyQueue::Priority>(-1));
+}
@@ -2,7 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <sstream>
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
+#include "common/archives.h"
+#include "common/settings.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/kernel/process.h"
@@ -55,3 +59,107 @@ TEST_CASE("memory.IsValidVirtualAddress", "[core][memory]") {
         CHECK(memory.IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+TEST_CASE("memory.SparsePageTable", "[core][memory]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    const auto& page_table = *process->vm_manager.page_table;
+
+    // Only the regions holding mapped pages are allocated
+    CHECK(page_table.attributes.AllocatedRegions() == 0);
+    kernel.MapSharedPages(process->vm_manager);
+    CHECK(page_table.attributes.AllocatedRegions() == 1);
+    CHECK(page_table.attributes[Memory::SHARED_PAGE_VADDR >> Memory::CITRA_PAGE_BITS] ==
+          Memory::PageType::Memory);
+    CHECK(page_table.attributes[Memory::HEAP_VADDR >> Memory::CITRA_PAGE_BITS] ==
+          Memory::PageType::Unmapped);
+
+    process->vm_manager.page_table->Clear();
+    CHECK(page_table.attributes.AllocatedRegions() == 0);
+}
+
+TEST_CASE("memory.BlockRuns", "[core][memory]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    // Two contiguous pages followed by one backed by an unrelated block and an unmapped one
+    constexpr u32 page_size = Memory::CITRA_PAGE_SIZE;
+    MemoryRef contiguous{std::make_shared<BufferMem>(2 * page_size)};
+    MemoryRef other{std::make_shared<BufferMem>(page_size)};
+    auto& vm_manager = process->vm_manager;
+    REQUIRE(vm_manager
+                .MapBackingMemory(Memory::HEAP_VADDR, contiguous, 2 * page_size,
+                                  Kernel::MemoryState::Private)
+                .Succeeded());
+    REQUIRE(vm_manager
+                .MapBackingMemory(Memory::HEAP_VADDR + 2 * page_size, other, page_size,
+                                  Kernel::MemoryState::Private)
+                .Succeeded());
+
+    std::vector<u8> data(3 * page_size - 0x20);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<u8>(i * 7);
+    }
+    memory.WriteBlock(*process, Memory::HEAP_VADDR + 0x10, data.data(), data.size());
+    CHECK(contiguous.GetPtr()[0x10] == data[0]);
+    CHECK(other.GetPtr()[0] == data[2 * page_size - 0x10]);
+
+    std::vector<u8> read(data.size());
+    memory.ReadBlock(*process, Memory::HEAP_VADDR + 0x10, read.data(), read.size());
+    CHECK(read == data);
+
+    // The unmapped tail reads as zeros
+    std::vector<u8> tail(2 * page_size, 0xFF);
+    memory.ReadBlock(*process, Memory::HEAP_VADDR + 2 * page_size, tail.data(), tail.size());
+    CHECK(tail[0] == data[2 * page_size - 0x10]);
+    CHECK(tail[page_size] == 0);
+    CHECK(tail.back() == 0);
+
+    memory.CopyBlock(*process, Memory::HEAP_VADDR, Memory::HEAP_VADDR + page_size, page_size);
+    CHECK(contiguous.GetPtr()[0] == read[page_size - 0x10]);
+}
+
+TEST_CASE("memory.FastmemAfterLoad", "[core][memory]") {
+    Settings::values.use_fastmem.SetValue(true);
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Settings::values.use_fastmem.SetValue(false);
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.MapSharedPages(process->vm_manager);
+    memory.SetCurrentPageTable(process->vm_manager.page_table);
+    if (!memory.GetCurrentPageTable()->GetFastmemPointer()) {
+        SKIP("Fastmem is not supported on this host");
+    }
+
+    std::stringstream stream;
+    {
+        oarchive oa{stream};
+        oa << memory;
+    }
+    {
+        iarchive ia{stream};
+        ia >> memory;
+    }
+
+    // The loaded page table is a new object, which must still mirror its pages into the arena
+    const auto page_table = memory.GetCurrentPageTable();
+    REQUIRE(page_table != process->vm_manager.page_table);
+    u8* fastmem_pointer = page_table->GetFastmemPointer();
+    REQUIRE(fastmem_pointer != nullptr);
+    memory.Write8(Memory::SHARED_PAGE_VADDR, 0x5A);
+    CHECK(fastmem_pointer[Memory::SHARED_PAGE_VADDR] == 0x5A);
+}
@@ -53,6 +53,33 @@ TEST_CASE("Memory Basics", "[kernel][memory]") {
         CHECK(vma->second.backing_memory.GetPtr() == nullptr);
     }
 
+    SECTION("mapping and unmapping adjacent memory") {
+        // Because of the PageTable, Kernel::VMManager is too big to be created on the stack.
+        auto manager = std::make_unique<Kernel::VMManager>(memory, process);
+        MemoryRef other_block{std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE)};
+        auto result =
+            manager->MapBackingMemory(Memory::HEAP_VADDR, block, static_cast<u32>(block.GetSize()),
+                                      Kernel::MemoryState::Private);
+        REQUIRE(result.Code() == ResultSuccess);
+        auto target = manager->MapBackingMemoryToBase(
+            Memory::HEAP_VADDR, Memory::HEAP_SIZE, other_block,
+            static_cast<u32>(other_block.GetSize()), Kernel::MemoryState::Private);
+        REQUIRE(target.Succeeded());
+        CHECK(*target == Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE);
+
+        const auto& attributes = manager->page_table->attributes;
+        const VAddr first_page = Memory::HEAP_VADDR >> Memory::CITRA_PAGE_BITS;
+        CHECK(attributes[first_page + 1] == Memory::PageType::Memory);
+        CHECK(manager->page_table->GetPointerArray()[first_page + 1] == other_block.GetPtr());
+
+        // A range spanning both areas is unmapped at once
+        Result code = manager->UnmapRange(Memory::HEAP_VADDR, 2 * Memory::CITRA_PAGE_SIZE);
+        REQUIRE(code == ResultSuccess);
+        CHECK(attributes[first_page] == Memory::PageType::Unmapped);
+        CHECK(attributes[first_page + 1] == Memory::PageType::Unmapped);
+        CHECK(manager->page_table->GetPointerArray()[first_page + 1] == nullptr);
+    }
+
     SECTION("changing memory permissions") {
         // Because of the PageTable, Kernel::VMManager is too big to be created on the stack.
         auto manager = std::make_unique<Kernel::VMManager>(memory, process);
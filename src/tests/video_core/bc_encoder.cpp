@@ -0,0 +1,63 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/custom_textures/bc_encoder.h"
+
+using namespace VideoCore;
+
+namespace {
+
+/// Decodes the first pixel of a BC3 block to RGBA8.
+std::array<u8, 4> DecodeFirstPixel(const std::array<u8, 16>& block) {
+    u16 color0, color1;
+    std::memcpy(&color0, block.data() + 8, sizeof(color0));
+    std::memcpy(&color1, block.data() + 10, sizeof(color1));
+    const u32 index = block[12] & 3;
+    const u16 color = index == 1 ? color1 : color0;
+    const u8 r = static_cast<u8>(((color >> 11) & 0x1F) << 3);
+    const u8 g = static_cast<u8>(((color >> 5) & 0x3F) << 2);
+    const u8 b = static_cast<u8>((color & 0x1F) << 3);
+    const u8 alpha_index = block[2] & 7;
+    const u8 a = alpha_index == 1 ? block[1] : block[0];
+    return {r, g, b, a};
+}
+
+} // Anonymous namespace
+
+TEST_CASE("EncodeBC3[Solid]", "[video_core][bc_encoder]") {
+    std::array<u8, 4 * 4 * 4> pixels;
+    for (std::size_t i = 0; i < pixels.size(); i += 4) {
+        pixels[i + 0] = 0xF8;
+        pixels[i + 1] = 0x80;
+        pixels[i + 2] = 0x08;
+        pixels[i + 3] = 0x40;
+    }
+
+    std::array<u8, 16> block{};
+    REQUIRE(BC3EncodedSize(4, 4) == block.size());
+    EncodeBC3(pixels, 4, 4, block);
+
+    constexpr std::array<u8, 4> expected = {0xF8, 0x80, 0x08, 0x40};
+    REQUIRE(DecodeFirstPixel(block) == expected);
+}
+
+TEST_CASE("EncodeBC3[Endpoints]", "[video_core][bc_encoder]") {
+    // Half the block is opaque white and half transparent black.
+    std::array<u8, 4 * 4 * 4> pixels{};
+    for (std::size_t i = 0; i < pixels.size() / 2; i++) {
+        pixels[i] = 0xFF;
+    }
+
+    std::array<u8, 16> block{};
+    EncodeBC3(pixels, 4, 4, block);
+
+    REQUIRE(block[0] == 0xFF);
+    REQUIRE(block[1] == 0x00);
+    const auto pixel = DecodeFirstPixel(block);
+    REQUIRE(pixel[3] == 0xFF);
+    REQUIRE(pixel[0] >= 0xF0);
+}
@@ -0,0 +1,66 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/dynamic_resolution.h"
+
+using namespace std::chrono_literals;
+using VideoCore::DynamicResolution;
+
+namespace {
+
+constexpr auto TargetFrameTime = 16'666'667ns;
+
+/// Feeds frames whose GPU time grows with the square of the scale, returns the scale changes.
+u32 RunFrames(DynamicResolution& controller, std::chrono::nanoseconds cost_per_pixel_scale,
+              u32 num_frames) {
+    u32 changes = 0;
+    for (u32 i = 0; i < num_frames; i++) {
+        const u32 scale = controller.Scale();
+        changes += controller.OnFrame(cost_per_pixel_scale * scale * scale) ? 1 : 0;
+    }
+    return changes;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DynamicResolution[Downscale]", "[video_core][dynamic_resolution]") {
+    DynamicResolution controller;
+    controller.SetMaxScale(4);
+    controller.SetTargetFrameTime(TargetFrameTime);
+    REQUIRE(controller.Scale() == 4);
+
+    // 32ms at 4x and 18ms at 3x overrun the budget, 8ms at 2x fits but 3x is not predicted to.
+    REQUIRE(RunFrames(controller, 2ms, 50) == 2);
+    REQUIRE(controller.Scale() == 2);
+    REQUIRE(RunFrames(controller, 2ms, 500) == 0);
+}
+
+TEST_CASE("DynamicResolution[Upscale]", "[video_core][dynamic_resolution]") {
+    DynamicResolution controller;
+    controller.SetMaxScale(4);
+    controller.SetTargetFrameTime(TargetFrameTime);
+    RunFrames(controller, 2ms, 50);
+    REQUIRE(controller.Scale() == 2);
+
+    // A lighter scene is given a streak of frames before the scale grows back.
+    REQUIRE(RunFrames(controller, 1ms, 60) == 0);
+    REQUIRE(RunFrames(controller, 1ms, 500) == 1);
+    REQUIRE(controller.Scale() == 3);
+
+    // A new maximum starts over at full size.
+    controller.SetMaxScale(2);
+    REQUIRE(controller.Scale() == 2);
+}
+
+TEST_CASE("DynamicResolution[NoTarget]", "[video_core][dynamic_resolution]") {
+    DynamicResolution controller;
+    controller.SetMaxScale(3);
+
+    // An unlimited frame rate has no budget to fit in, the configured scale is kept.
+    REQUIRE(RunFrames(controller, 10ms, 100) == 0);
+    controller.SetTargetFrameTime(TargetFrameTime);
+    REQUIRE(RunFrames(controller, 0ns, 100) == 0);
+    REQUIRE(controller.Scale() == 3);
+}
@@ -0,0 +1,108 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/color.h"
+#include "video_core/rasterizer_cache/surface_params.h"
+#include "video_core/rasterizer_cache/utils.h"
+#include "video_core/texture/etc1.h"
+
+using VideoCore::PixelFormat;
+using VideoCore::SurfaceParams;
+
+namespace {
+
+std::vector<u8> MakeData(std::size_t size) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<u32> distribution(0, 255);
+    std::vector<u8> data(size);
+    for (u8& value : data) {
+        value = static_cast<u8>(distribution(rng));
+    }
+    return data;
+}
+
+/// Decodes the texture one texel at a time, the linear rows stored from the bottom up
+std::vector<u8> DecodeReference(const SurfaceParams& params, std::span<const u8> data) {
+    const bool has_alpha = params.pixel_format == PixelFormat::ETC1A4;
+    const std::size_t subtile_size = has_alpha ? 16 : 8;
+    std::vector<u8> decoded(params.width * params.height * 4);
+    for (u32 y = 0; y < params.height; y++) {
+        for (u32 x = 0; x < params.width; x++) {
+            const u32 tile_index = (y / 8) * (params.width / 8) + x / 8;
+            const u32 subtile_index = ((x % 8) / 4) + 2 * ((y % 8) / 4);
+            const u8* subtile = &data[(tile_index * 4 + subtile_index) * subtile_size];
+
+            u8 alpha = 255;
+            if (has_alpha) {
+                u64 packed_alpha;
+                std::memcpy(&packed_alpha, subtile, sizeof(u64));
+                subtile += sizeof(u64);
+                const u32 shift = 4 * ((x % 4) * 4 + y % 4);
+                alpha = Common::Color::Convert4To8((packed_alpha >> shift) & 0xF);
+            }
+            u64 value;
+            std::memcpy(&value, subtile, sizeof(u64));
+            const auto rgb = Pica::Texture::SampleETC1Subtile(value, x % 4, y % 4);
+
+            u8* texel = &decoded[((params.height - 1 - y) * params.width + x) * 4];
+            std::memcpy(texel, rgb.AsArray(), 3);
+            texel[3] = alpha;
+        }
+    }
+    return decoded;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ETC1[DecodeETC1Subtile]", "[video_core]") {
+    std::mt19937_64 rng(1);
+    std::array<u8, Pica::Texture::ETC1SubtileDecodedSize> texels;
+    for (u32 i = 0; i < 4096; i++) {
+        const u64 value = rng();
+        Pica::Texture::DecodeETC1Subtile(value, texels);
+        for (u32 y = 0; y < 4; y++) {
+            for (u32 x = 0; x < 4; x++) {
+                const auto rgb = Pica::Texture::SampleETC1Subtile(value, x, y);
+                const u8* texel = &texels[(y * 4 + x) * 4];
+                REQUIRE(texel[0] == rgb.r());
+                REQUIRE(texel[1] == rgb.g());
+                REQUIRE(texel[2] == rgb.b());
+                REQUIRE(texel[3] == 255);
+            }
+        }
+    }
+}
+
+TEST_CASE("ETC1[DecodeTexture]", "[video_core]") {
+    for (const PixelFormat format : {PixelFormat::ETC1, PixelFormat::ETC1A4}) {
+        SurfaceParams params;
+        params.addr = 0x18000000;
+        params.width = 256;
+        params.height = 128;
+        params.is_tiled = true;
+        params.pixel_format = format;
+        params.UpdateParams();
+
+        std::vector<u8> data = MakeData(params.size);
+        const std::vector<u8> expected = DecodeReference(params, data);
+
+        // The whole texture is decoded in parallel
+        std::vector<u8> decoded(expected.size());
+        VideoCore::DecodeTexture(params, params.addr, params.end, data, decoded);
+        REQUIRE(decoded == expected);
+
+        // Part of it is decoded on the calling thread
+        std::vector<u8> partial(expected.size());
+        const u32 half = params.BytesInPixels(params.width * params.height / 2);
+        VideoCore::DecodeTexture(params, params.addr, params.addr + half, data, partial);
+        const std::size_t decoded_half = expected.size() / 2;
+        REQUIRE(std::equal(partial.begin() + decoded_half, partial.end(),
+                           expected.begin() + decoded_half));
+    }
+}
@@ -0,0 +1,87 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/frame_pacer.h"
+
+using namespace std::chrono_literals;
+using VideoCore::FramePacer;
+
+namespace {
+constexpr auto GuestInterval = 16'666'667ns;
+constexpr auto RefreshInterval = 8'333'333ns;
+} // Anonymous namespace
+
+TEST_CASE("FramePacer[ReportedInterval]", "[video_core][frame_pacer]") {
+    FramePacer pacer;
+    pacer.SetRefreshInterval(RefreshInterval);
+
+    auto time = FramePacer::Clock::now();
+    for (int i = 0; i < 4; i++) {
+        pacer.OnGuestFrame(time);
+        pacer.OnPresent(time);
+        time += GuestInterval;
+    }
+    time -= GuestInterval;
+
+    REQUIRE(pacer.RefreshInterval() == RefreshInterval);
+    REQUIRE(pacer.GuestInterval() == GuestInterval);
+    REQUIRE(pacer.IsActive(time));
+    REQUIRE(pacer.NextPresentDeadline() == time + RefreshInterval - RefreshInterval / 4);
+    REQUIRE(pacer.Phase(time + RefreshInterval) == Catch::Approx(0.5f).epsilon(0.001));
+
+    // Pacing stops once the guest stops producing frames.
+    REQUIRE(!pacer.IsActive(time + 1s));
+}
+
+TEST_CASE("FramePacer[MeasuredInterval]", "[video_core][frame_pacer]") {
+    FramePacer pacer;
+    pacer.SetRefreshInterval(0ns);
+
+    auto time = FramePacer::Clock::now();
+    pacer.OnGuestFrame(time);
+    REQUIRE(pacer.IsActive(time));
+
+    // Refreshes throttled by vblank, with an occasional missed one, converge to the display rate.
+    for (int i = 0; i < 64; i++) {
+        pacer.OnPresent(time);
+        time += i % 8 == 7 ? RefreshInterval * 2 : RefreshInterval;
+    }
+    REQUIRE(pacer.RefreshInterval() == RefreshInterval);
+
+    // Guest frames at the display rate leave nothing to pace.
+    for (int i = 0; i < 64; i++) {
+        pacer.OnGuestFrame(time);
+        time += RefreshInterval;
+    }
+    REQUIRE(!pacer.IsActive(time - RefreshInterval));
+}
+
+TEST_CASE("FramePacer[VsyncTimeline]", "[video_core][frame_pacer]") {
+    FramePacer pacer;
+    pacer.SetRefreshInterval(0ns);
+
+    // Vblanks reported by the frontend define both the interval and the phase of the refreshes.
+    auto vsync = FramePacer::Clock::now();
+    for (int i = 0; i < 64; i++) {
+        pacer.OnVsync(vsync);
+        vsync += RefreshInterval;
+    }
+    vsync -= RefreshInterval;
+    REQUIRE(pacer.RefreshInterval() == RefreshInterval);
+    REQUIRE(pacer.NextVsync(vsync + 1ms) == vsync + RefreshInterval);
+
+    // Presents submitted early or late for a vblank are followed by the one for the next vblank.
+    const auto slack = RefreshInterval / 4;
+    pacer.OnPresent(vsync - 3ms);
+    REQUIRE(pacer.NextPresentDeadline() == vsync + RefreshInterval - slack);
+    pacer.OnPresent(vsync + 2ms);
+    REQUIRE(pacer.NextPresentDeadline() == vsync + RefreshInterval - slack);
+
+    // The presentation engine reports when images were displayed.
+    pacer.OnDisplayed(vsync - 3ms, vsync + RefreshInterval);
+    REQUIRE(pacer.DisplayLatency() == RefreshInterval + 3ms);
+    REQUIRE(pacer.NextVsync(vsync + RefreshInterval + 1ms) == vsync + RefreshInterval * 2);
+}
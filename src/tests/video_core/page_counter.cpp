@@ -0,0 +1,59 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/page_counter.h"
+
+using VideoCore::PageCounter;
+
+namespace {
+
+using Range = std::pair<PAddr, u32>;
+
+std::vector<Range> Update(PageCounter& counter, PAddr addr, u32 size, int delta) {
+    std::vector<Range> ranges;
+    counter.Update(addr, size, delta, [&ranges](PAddr run_addr, u32 run_size) {
+        ranges.emplace_back(run_addr, run_size);
+    });
+    return ranges;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("PageCounter[Transitions]", "[video_core][page_counter]") {
+    PageCounter counter;
+
+    // A new surface marks all of the pages it touches.
+    REQUIRE(Update(counter, 0x18000800, 0x2000, 1) == std::vector<Range>{{0x18000000, 0x3000}});
+    REQUIRE(counter.Count(0x18002FFF) == 1);
+    REQUIRE(counter.Count(0x18003000) == 0);
+
+    // An overlapping surface only reports the pages that were not cached yet.
+    REQUIRE(Update(counter, 0x18002000, 0x2000, 1) == std::vector<Range>{{0x18003000, 0x1000}});
+    REQUIRE(counter.Count(0x18002000) == 2);
+
+    // Removing the first surface only unmarks the pages no other surface touches.
+    REQUIRE(Update(counter, 0x18000800, 0x2000, -1) == std::vector<Range>{{0x18000000, 0x2000}});
+    REQUIRE(Update(counter, 0x18002000, 0x2000, -1) == std::vector<Range>{{0x18002000, 0x2000}});
+    REQUIRE(counter.Count(0x18002000) == 0);
+}
+
+TEST_CASE("PageCounter[SplitRuns]", "[video_core][page_counter]") {
+    PageCounter counter;
+    Update(counter, 0x20001000, 0x1000, 1);
+
+    // The already cached page in the middle splits the newly cached pages in two runs.
+    const std::vector<Range> expected{{0x20000000, 0x1000}, {0x20002000, 0x1000}};
+    REQUIRE(Update(counter, 0x20000000, 0x3000, 1) == expected);
+
+    std::vector<Range> cached;
+    counter.ForEachCachedRange(
+        [&cached](PAddr addr, u32 size) { cached.emplace_back(addr, size); });
+    REQUIRE(cached == std::vector<Range>{{0x20000000, 0x3000}});
+
+    counter.Clear();
+    REQUIRE(counter.Count(0x20001000) == 0);
+}
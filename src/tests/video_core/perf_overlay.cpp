@@ -0,0 +1,33 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/perf_overlay.h"
+
+using VideoCore::PerfOverlay;
+
+TEST_CASE("PerfOverlay[Refresh]", "[video_core][perf_overlay]") {
+    PerfOverlay overlay;
+    REQUIRE(overlay.Pixels().size() == PerfOverlay::Width * PerfOverlay::Height * 4);
+    const std::vector<u8> background(overlay.Pixels().begin(), overlay.Pixels().end());
+
+    // The first frame is shown right away, the following ones wait for the refresh interval.
+    Core::PerfStats::FrameStats stats{};
+    stats.frametime = std::chrono::milliseconds{16};
+    REQUIRE(overlay.AddFrame(stats));
+    REQUIRE(!overlay.AddFrame(stats));
+    REQUIRE(!std::equal(background.begin(), background.end(), overlay.Pixels().begin()));
+
+    // Every pixel is opaque, so the overlay needs no blending.
+    for (std::size_t i = 3; i < overlay.Pixels().size(); i += 4) {
+        REQUIRE(overlay.Pixels()[i] == 0xFF);
+    }
+}
+
+TEST_CASE("PerfOverlay[Scale]", "[video_core][perf_overlay]") {
+    REQUIRE(PerfOverlay::GetScale(480) == 1);
+    REQUIRE(PerfOverlay::GetScale(1080) == 3);
+    REQUIRE(PerfOverlay::GetScale(2160) == 6);
+}
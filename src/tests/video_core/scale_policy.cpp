@@ -0,0 +1,47 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/scale_policy.h"
+
+using VideoCore::ScaleConfig;
+using VideoCore::ScalePolicy;
+
+TEST_CASE("ScalePolicy[Heuristics]", "[video_core][scale_policy]") {
+    const ScaleConfig config{};
+    ScalePolicy policy{config};
+
+    // Without heuristics every target uses the configured scale.
+    REQUIRE(policy.TargetScale(0x18100000, 8, 8, 4) == 4);
+
+    policy.SetHeuristicsEnabled(true);
+    REQUIRE(policy.TargetScale(0x18000000, 400, 240, 4) == 4);
+    REQUIRE(policy.TargetScale(0x18100000, 8, 8, 4) == 1);
+    REQUIRE(policy.TargetScale(0x18100000, 64, 256, 4) == 4);
+
+    // Targets read back often enough drop to native resolution.
+    for (u32 i = 0; i < config.readback_threshold; i++) {
+        REQUIRE(policy.TargetScale(0x18200000, 256, 256, 4) == 4);
+        policy.OnReadback(0x18200000);
+    }
+    REQUIRE(policy.TargetScale(0x18200000, 256, 256, 4) == 1);
+
+    policy.Reset();
+    REQUIRE(policy.TargetScale(0x18200000, 256, 256, 4) == 4);
+}
+
+TEST_CASE("ScalePolicy[Overrides]", "[video_core][scale_policy]") {
+    ScaleConfig config{};
+    config.targets.emplace(0x18000000, 2);
+    config.targets.emplace(0x18100000, 0);
+    config.targets.emplace(0x18200000, 8);
+    ScalePolicy policy{config};
+    policy.SetHeuristicsEnabled(true);
+
+    // Overrides win over the heuristics and never exceed the configured scale.
+    REQUIRE(policy.TargetScale(0x18000000, 400, 240, 4) == 2);
+    REQUIRE(policy.TargetScale(0x18100000, 8, 8, 4) == 4);
+    REQUIRE(policy.TargetScale(0x18200000, 400, 240, 4) == 4);
+    REQUIRE(policy.TargetScale(0x18000000, 400, 240, 1) == 1);
+}
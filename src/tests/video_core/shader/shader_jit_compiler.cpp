@@ -6,6 +6,7 @@
 #if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
 #include <span>
@@ -197,6 +198,28 @@ TEST_CASE("CALL", "[video_core][shader][shader_jit]") {
     REQUIRE(shader.Run(0.f).x == Catch::Approx(1.f));
 }
 
+TEST_CASE("Batch", "[video_core][shader][shader_jit]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto shader = ShaderTest({
+        {OpCode::Id::EX2, sh_output, sh_input},
+        {OpCode::Id::END},
+    });
+
+    std::array<Pica::ShaderUnit, 4> shader_units;
+    for (std::size_t i = 0; i < shader_units.size(); ++i) {
+        shader_units[i].input[0] =
+            Common::Vec4<Pica::f24>::AssignToAll(Pica::f24::FromFloat32(static_cast<float>(i)));
+    }
+    shader.shader_jit.RunBatch(*shader.shader_setup, shader_units, 0);
+
+    for (std::size_t i = 0; i < shader_units.size(); ++i) {
+        REQUIRE(shader_units[i].output[0].x.ToFloat32() ==
+                Catch::Approx(std::exp2(static_cast<float>(i))));
+    }
+}
+
 TEST_CASE("DP3", "[video_core][shader][shader_jit]") {
     const auto sh_input1 = SourceRegister::MakeInput(0);
     const auto sh_input2 = SourceRegister::MakeInput(1);
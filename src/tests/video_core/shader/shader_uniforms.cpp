@@ -0,0 +1,55 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <bit>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/pica/regs_shader.h"
+#include "video_core/pica/shader_setup.h"
+#include "video_core/shader/generator/shader_uniforms.h"
+
+using Pica::ShaderRegs;
+using Pica::ShaderSetup;
+using Pica::Shader::Generator::PicaUniformsData;
+
+namespace {
+
+/// Writes a float uniform the way the PICA command list does, in float32 mode
+void WriteUniform(ShaderSetup& setup, ShaderRegs& regs, u32 index, float value) {
+    regs.uniform_setup.index.Assign(index);
+    regs.uniform_setup.format.Assign(decltype(regs.uniform_setup)::Format::Float32);
+    for (u32 i = 0; i < 4; i++) {
+        setup.WriteUniformFloatReg(regs, std::bit_cast<u32>(value));
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("PicaUniformsData[Update]", "[video_core][shader]") {
+    ShaderRegs regs{};
+    ShaderSetup setup;
+    setup.uniforms = {};
+    PicaUniformsData data{};
+
+    // Every uniform is converted the first time
+    REQUIRE(data.Update(regs, setup));
+    REQUIRE(!data.Update(regs, setup));
+
+    WriteUniform(setup, regs, 10, 2.0f);
+    WriteUniform(setup, regs, 3, 1.0f);
+    REQUIRE(setup.ConsumeDirtyFloatUniforms() == std::pair<u32, u32>{3, 11});
+
+    WriteUniform(setup, regs, 7, 4.0f);
+    REQUIRE(data.Update(regs, setup));
+    REQUIRE(data.f[7] == Common::Vec4f{4.0f, 4.0f, 4.0f, 4.0f});
+
+    // Writing the same values again does not mark them
+    WriteUniform(setup, regs, 7, 4.0f);
+    REQUIRE(!data.Update(regs, setup));
+
+    setup.WriteUniformBoolReg(0x5);
+    REQUIRE(data.Update(regs, setup));
+    REQUIRE(data.bools[0].b == 1);
+    REQUIRE(data.bools[1].b == 0);
+    REQUIRE(data.bools[2].b == 1);
+}
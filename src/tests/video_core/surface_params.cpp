@@ -0,0 +1,109 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/surface_params.h"
+#include "video_core/utils.h"
+
+using VideoCore::PixelFormat;
+using VideoCore::SurfaceInterval;
+using VideoCore::SurfaceParams;
+
+namespace {
+
+SurfaceParams MakeParams(u32 width, u32 height, PixelFormat format, bool is_tiled) {
+    SurfaceParams params;
+    params.addr = 0x18000000;
+    params.width = width;
+    params.height = height;
+    params.pixel_format = format;
+    params.is_tiled = is_tiled;
+    params.UpdateParams();
+    return params;
+}
+
+/// Returns the row of the pixel at index counted from the bottom, as in the surface rectangles
+std::pair<u32, u32> PixelPosition(const SurfaceParams& params, u32 index) {
+    if (!params.is_tiled) {
+        return {index % params.stride, index / params.stride};
+    }
+    const u32 tile = index / 64;
+    const u32 tile_x = (tile % (params.stride / 8)) * 8;
+    const u32 tile_y = (tile / (params.stride / 8)) * 8;
+    for (u32 y = 0; y < 8; y++) {
+        for (u32 x = 0; x < 8; x++) {
+            if (VideoCore::MortonInterleave(x, y) == index % 64) {
+                return {tile_x + x, params.height - 1 - (tile_y + y)};
+            }
+        }
+    }
+    return {};
+}
+
+/// Checks that the rectangles cover the pixels of interval exactly once, and nothing else
+void CheckCoverage(const SurfaceParams& params, SurfaceInterval interval) {
+    const auto rects = params.SplitIntoRects(interval);
+    REQUIRE(!rects.empty());
+
+    std::vector<u32> covered(params.width * params.height);
+    for (const auto& sub_rect : rects) {
+        const u32 first_index = params.PixelsInBytes(sub_rect.addr - params.addr);
+        const auto [first_x, first_y] = PixelPosition(params, first_index);
+        REQUIRE(first_x == sub_rect.rect.left);
+        REQUIRE(first_y == (params.is_tiled ? sub_rect.rect.top - 1 : sub_rect.rect.bottom));
+        for (u32 y = sub_rect.rect.bottom; y < sub_rect.rect.top; y++) {
+            for (u32 x = sub_rect.rect.left; x < sub_rect.rect.right; x++) {
+                covered[y * params.width + x]++;
+            }
+        }
+    }
+
+    std::vector<u32> expected(params.width * params.height);
+    const u32 first = params.PixelsInBytes(interval.lower() - params.addr);
+    const u32 last = params.PixelsInBytes(interval.upper() - params.addr);
+    for (u32 index = first; index < last; index++) {
+        const auto [x, y] = PixelPosition(params, index);
+        expected[y * params.width + x]++;
+    }
+    REQUIRE(covered == expected);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SurfaceParams[SplitIntoRects]", "[video_core][rasterizer_cache]") {
+    SECTION("Linear rows") {
+        const SurfaceParams params = MakeParams(16, 4, PixelFormat::RGBA8, false);
+        const SurfaceInterval interval{params.addr + 5 * 4, params.addr + (3 * 16 + 3) * 4};
+        const auto rects = params.SplitIntoRects(interval);
+        REQUIRE(rects.size() == 3);
+        REQUIRE(rects[0].rect == Common::Rectangle<u32>{5, 1, 16, 0});
+        REQUIRE(rects[1].rect == Common::Rectangle<u32>{0, 3, 16, 1});
+        REQUIRE(rects[1].addr == params.addr + 16 * 4);
+        REQUIRE(rects[2].rect == Common::Rectangle<u32>{0, 4, 3, 3});
+        CheckCoverage(params, interval);
+    }
+
+    SECTION("Tiled blocks") {
+        const SurfaceParams params = MakeParams(32, 24, PixelFormat::RGB565, true);
+        const u32 bytes_per_tile = params.BytesInPixels(64);
+        // Whole strips and tiles only
+        const auto strips = params.SplitIntoRects({params.addr, params.addr + 5 * bytes_per_tile});
+        REQUIRE(strips.size() == 2);
+        REQUIRE(strips[0].rect == Common::Rectangle<u32>{0, 24, 32, 16});
+        REQUIRE(strips[1].rect == Common::Rectangle<u32>{0, 16, 8, 8});
+
+        for (u32 first = 0; first < 3 * 64; first += 7) {
+            for (u32 last = first + 1; last <= 3 * 64 + 40; last += 13) {
+                CheckCoverage(params, {params.addr + params.BytesInPixels(first),
+                                       params.addr + params.BytesInPixels(last)});
+            }
+        }
+    }
+
+    SECTION("Split pixels") {
+        const SurfaceParams params = MakeParams(8, 8, PixelFormat::RGB8, false);
+        REQUIRE(params.SplitIntoRects({params.addr + 1, params.addr + 9}).empty());
+    }
+}
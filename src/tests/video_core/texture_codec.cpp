@@ -0,0 +1,83 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+#include "common/arch.h"
+#include "video_core/rasterizer_cache/texture_codec.h"
+
+#if CITRA_ARCH(x86_64)
+
+using VideoCore::PixelFormat;
+
+namespace {
+
+constexpr u32 Stride = 16;
+constexpr u32 TileSize = 64 * 4;
+constexpr u32 LinearSize = (7 * Stride + 8) * 4;
+
+template <std::size_t size>
+std::array<u8, size> MakeData(u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<u32> distribution(0, 255);
+    std::array<u8, size> data;
+    for (u8& value : data) {
+        value = static_cast<u8>(distribution(rng));
+    }
+    return data;
+}
+
+/// Converts the tile one pixel at a time like the scalar path of MortonCopyTile
+template <bool morton_to_linear, PixelFormat format, bool converted>
+void ScalarCopyTile(u8* tile, u8* linear) {
+    for (u32 y = 0; y < 8; y++) {
+        for (u32 x = 0; x < 8; x++) {
+            u8* tiled_pixel = tile + VideoCore::MortonInterleave(x, y) * 4;
+            u8* linear_pixel = linear + ((7 - y) * Stride + x) * 4;
+            if constexpr (morton_to_linear) {
+                VideoCore::DecodePixel<format, converted>(tiled_pixel, linear_pixel);
+            } else {
+                VideoCore::EncodePixel<format, converted>(linear_pixel, tiled_pixel);
+            }
+        }
+    }
+}
+
+template <PixelFormat format, bool converted>
+void CheckMatchesScalar() {
+    // Linear to Morton
+    {
+        auto linear = MakeData<LinearSize>(1);
+        std::array<u8, TileSize> expected{};
+        std::array<u8, TileSize> result{};
+        ScalarCopyTile<false, format, converted>(expected.data(), linear.data());
+        VideoCore::MortonCopyTile<false, format, converted>(Stride, result, linear);
+        REQUIRE(result == expected);
+    }
+
+    // Morton to linear, leaving the bytes between the rows alone
+    {
+        auto tile = MakeData<TileSize>(2);
+        auto expected = MakeData<LinearSize>(3);
+        auto result = expected;
+        ScalarCopyTile<true, format, converted>(tile.data(), expected.data());
+        VideoCore::MortonCopyTile<true, format, converted>(Stride, tile, result);
+        REQUIRE(result == expected);
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MortonCopyTile[SIMD]", "[video_core][texture_codec]") {
+    if (!VideoCore::HasSIMDMortonCopy()) {
+        SKIP("The host CPU does not support SSSE3");
+    }
+
+    CheckMatchesScalar<PixelFormat::RGBA8, true>();
+    CheckMatchesScalar<PixelFormat::D24S8, false>();
+    CheckMatchesScalar<PixelFormat::D24S8, true>();
+}
+
+#endif
@@ -0,0 +1,147 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include "common/assert.h"
+#include "video_core/custom_textures/bc_encoder.h"
+
+namespace VideoCore {
+
+namespace {
+
+constexpr u32 BlockSize = 4;
+constexpr u32 BlockPixels = BlockSize * BlockSize;
+
+using Block = std::array<std::array<u8, 4>, BlockPixels>;
+
+u16 ToRGB565(const std::array<u8, 4>& color) {
+    return static_cast<u16>(((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3));
+}
+
+std::array<s32, 3> FromRGB565(u16 color) {
+    const s32 r = (color >> 11) & 0x1F;
+    const s32 g = (color >> 5) & 0x3F;
+    const s32 b = color & 0x1F;
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+void EncodeAlphaBlock(const Block& block, u8* output) {
+    u8 min_alpha = 255;
+    u8 max_alpha = 0;
+    for (const auto& pixel : block) {
+        min_alpha = std::min(min_alpha, pixel[3]);
+        max_alpha = std::max(max_alpha, pixel[3]);
+    }
+
+    // With alpha0 > alpha1 the palette interpolates six values between the endpoints.
+    output[0] = max_alpha;
+    output[1] = min_alpha;
+    u64 indices{};
+    if (max_alpha != min_alpha) {
+        std::array<s32, 8> palette{max_alpha, min_alpha};
+        for (s32 i = 1; i < 7; i++) {
+            palette[i + 1] = ((7 - i) * max_alpha + i * min_alpha) / 7;
+        }
+        for (u32 i = 0; i < BlockPixels; i++) {
+            const s32 alpha = block[i][3];
+            u64 best = 0;
+            s32 best_error = std::abs(palette[0] - alpha);
+            for (u32 j = 1; j < palette.size(); j++) {
+                const s32 error = std::abs(palette[j] - alpha);
+                if (error < best_error) {
+                    best = j;
+                    best_error = error;
+                }
+            }
+            indices |= best << (3 * i);
+        }
+    }
+    for (u32 i = 0; i < 6; i++) {
+        output[2 + i] = static_cast<u8>(indices >> (8 * i));
+    }
+}
+
+void EncodeColorBlock(const Block& block, u8* output) {
+    std::array<u8, 4> min_color{255, 255, 255, 0};
+    std::array<u8, 4> max_color{0, 0, 0, 0};
+    for (const auto& pixel : block) {
+        for (u32 c = 0; c < 3; c++) {
+            min_color[c] = std::min(min_color[c], pixel[c]);
+            max_color[c] = std::max(max_color[c], pixel[c]);
+        }
+    }
+
+    // Pull the endpoints slightly inwards, the bounding box corners are rarely hit exactly.
+    for (u32 c = 0; c < 3; c++) {
+        const u8 inset = (max_color[c] - min_color[c]) >> 4;
+        min_color[c] += inset;
+        max_color[c] -= inset;
+    }
+
+    // Keep color0 > color1 to select the four colour mode.
+    u16 color0 = ToRGB565(max_color);
+    u16 color1 = ToRGB565(min_color);
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    u32 indices{};
+    if (color0 != color1) {
+        const auto end0 = FromRGB565(color0);
+        const auto end1 = FromRGB565(color1);
+        std::array<std::array<s32, 3>, 4> palette{end0, end1};
+        for (u32 c = 0; c < 3; c++) {
+            palette[2][c] = (2 * end0[c] + end1[c]) / 3;
+            palette[3][c] = (end0[c] + 2 * end1[c]) / 3;
+        }
+        for (u32 i = 0; i < BlockPixels; i++) {
+            u32 best = 0;
+            s32 best_error = std::numeric_limits<s32>::max();
+            for (u32 j = 0; j < palette.size(); j++) {
+                s32 error = 0;
+                for (u32 c = 0; c < 3; c++) {
+                    const s32 delta = palette[j][c] - block[i][c];
+                    error += delta * delta;
+                }
+                if (error < best_error) {
+                    best = j;
+                    best_error = error;
+                }
+            }
+            indices |= best << (2 * i);
+        }
+    }
+
+    std::memcpy(output, &color0, sizeof(color0));
+    std::memcpy(output + 2, &color1, sizeof(color1));
+    std::memcpy(output + 4, &indices, sizeof(indices));
+}
+
+} // Anonymous namespace
+
+void EncodeBC3(std::span<const u8> rgba, u32 width, u32 height, std::span<u8> output) {
+    ASSERT(width % BlockSize == 0 && height % BlockSize == 0);
+    ASSERT(rgba.size() >= static_cast<std::size_t>(width) * height * 4);
+    ASSERT(output.size() >= BC3EncodedSize(width, height));
+
+    u8* out = output.data();
+    Block block;
+    for (u32 y = 0; y < height; y += BlockSize) {
+        for (u32 x = 0; x < width; x += BlockSize) {
+            for (u32 row = 0; row < BlockSize; row++) {
+                const std::size_t offset = (static_cast<std::size_t>(y + row) * width + x) * 4;
+                std::memcpy(block[row * BlockSize].data(), rgba.data() + offset, BlockSize * 4);
+            }
+            EncodeAlphaBlock(block, out);
+            EncodeColorBlock(block, out + 8);
+            out += 16;
+        }
+    }
+}
+
+} // namespace VideoCore
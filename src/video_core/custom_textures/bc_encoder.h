@@ -0,0 +1,24 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/// Size in bytes of an encoded BC3 texture with the provided dimensions.
+[[nodiscard]] constexpr std::size_t BC3EncodedSize(u32 width, u32 height) {
+    return static_cast<std::size_t>(width / 4) * (height / 4) * 16;
+}
+
+/**
+ * Encodes RGBA8 pixels to BC3 (DXT5) blocks. The encoder fits colour endpoints to the block's
+ * bounding box, which trades some quality for speed so whole packs can be transcoded in the
+ * background. Width and height must be multiples of four.
+ */
+void EncodeBC3(std::span<const u8> rgba, u32 width, u32 height, std::span<u8> output);
+
+} // namespace VideoCore
@@ -2,9 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <json.hpp>
 #include "common/file_util.h"
 #include "common/literals.h"
+#include "common/memory_budget.h"
 #include "common/memory_detect.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
@@ -15,6 +17,7 @@
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
 #include "video_core/custom_textures/custom_tex_manager.h"
+#include "video_core/custom_textures/texture_pack.h"
 #include "video_core/rasterizer_cache/surface_params.h"
 #include "video_core/rasterizer_cache/utils.h"
 
@@ -27,8 +30,22 @@ MICROPROFILE_DEFINE(CustomTexManager_TickFrame, "CustomTexManager", "TickFrame",
 
 constexpr std::size_t MAX_UPLOADS_PER_TICK = 8;
 
+/// Number of frames between two checks of the decoded textures against their budget
+constexpr u64 EVICTION_INTERVAL = 60;
+
 using namespace Common::Literals;
 
+/// Bytes of texture data waiting to be dumped above which new dumps are dropped
+constexpr std::size_t MAX_PENDING_DUMP_BYTES = 64_MiB;
+
+/// Number of staging buffers kept around for texture dumps
+constexpr std::size_t MAX_DUMP_BUFFERS = 16;
+
+std::string GetPackPath(u64 title_id) {
+    return fmt::format("{}textures/{:016X}.pack", GetUserPath(FileUtil::UserPath::LoadDir),
+                       title_id);
+}
+
 bool IsPow2(u32 value) {
     return value != 0 && (value & (value - 1)) == 0;
 }
@@ -56,15 +73,29 @@ MapType MakeMapType(std::string_view ext) {
 
 CustomTexManager::CustomTexManager(Core::System& system_)
     : system{system_}, image_interface{*system.GetImageInterface()},
-      async_custom_loading{Settings::values.async_custom_loading.GetValue()} {}
+      async_custom_loading{Settings::values.async_custom_loading.GetValue()} {
+    memory_budget_handle = Common::MemoryBudget::Instance().AddCache(
+        "custom textures", Common::MemoryBudget::Priority::CustomTextures,
+        [this](Common::MemoryPressure) { return EvictDecodedTextures(0); });
+}
 
-CustomTexManager::~CustomTexManager() = default;
+CustomTexManager::~CustomTexManager() {
+    if (dump_workers) {
+        dump_workers->WaitForRequests();
+    }
+    Common::MemoryBudget::Instance().RemoveCache(memory_budget_handle);
+}
 
 void CustomTexManager::TickFrame() {
     MICROPROFILE_SCOPE(CustomTexManager_TickFrame);
     if (!textures_loaded) {
         return;
     }
+    // Streamed textures are kept decoded within a share of the cache budget, so that surfaces
+    // created again do not read them back, while large packs do not fill the memory
+    if (++frame_tick % EVICTION_INTERVAL == 0 && !textures_preloaded) {
+        EvictDecodedTextures(Common::MemoryBudget::Instance().CacheBudget() / 2);
+    }
     std::size_t num_uploads = 0;
     for (auto it = async_uploads.begin(); it != async_uploads.end();) {
         if (num_uploads >= MAX_UPLOADS_PER_TICK) {
@@ -94,12 +125,27 @@ void CustomTexManager::FindCustomTextures() {
     }
 
     const u64 title_id = system.Kernel().GetCurrentProcess()->codeset->program_id;
-    const auto textures = GetTextures(title_id);
-    if (!ReadConfig(title_id)) {
+    auto pack = std::make_unique<TexturePack>();
+    const bool use_pack = pack->Open(GetPackPath(title_id));
+    const bool has_config = use_pack ? ParseConfig(pack->Config(), true) : ReadConfig(title_id);
+    if (!has_config) {
         use_new_hash = false;
         skip_mipmap = true;
     }
 
+    // Transcoded textures cannot have mipmaps generated for them, so legacy packs keep RGBA8.
+    if (Settings::values.compress_custom_textures && !skip_mipmap) {
+        transcode_cache = std::make_unique<TranscodeCache>(title_id);
+    }
+
+    // The materials of a pack file are created when they are first looked up
+    if (use_pack) {
+        texture_pack = std::move(pack);
+        textures_loaded = true;
+        return;
+    }
+
+    const auto textures = GetTextures(title_id);
     custom_textures.reserve(textures.size());
     for (const FileUtil::FSTEntry& file : textures) {
         if (file.isDirectory) {
@@ -216,6 +262,14 @@ void CustomTexManager::PreloadTextures(const std::atomic_bool& stop_run,
     const u64 max_mem =
         (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
 
+    if (texture_pack) {
+        for (const TexturePack::Slot& slot : texture_pack->Slots()) {
+            if (!material_map.contains(slot.hash)) {
+                CreatePackMaterial(slot.hash);
+            }
+        }
+    }
+
     workers->QueueWork([&]() {
         for (auto& [hash, material] : material_map) {
             if (size_sum > max_mem) {
@@ -225,7 +279,7 @@ void CustomTexManager::PreloadTextures(const std::atomic_bool& stop_run,
             if (stop_run) {
                 return;
             }
-            material->LoadFromDisk(flip_png_files);
+            material->LoadFromDisk(flip_png_files, transcode_cache.get());
             size_sum += material->size;
             if (callback) {
                 callback(VideoCore::LoadCallbackStage::Preload, preloaded, custom_textures.size());
@@ -235,74 +289,179 @@ void CustomTexManager::PreloadTextures(const std::atomic_bool& stop_run,
     });
     workers->WaitForRequests();
     async_custom_loading = false;
+    textures_preloaded = true;
 }
 
 void CustomTexManager::DumpTexture(const SurfaceParams& params, u32 level, std::span<u8> data,
                                    u64 data_hash) {
-    const u64 program_id = system.Kernel().GetCurrentProcess()->codeset->program_id;
-    const u32 data_size = static_cast<u32>(data.size());
-    const u32 width = params.width;
-    const u32 height = params.height;
-    const PixelFormat format = params.pixel_format;
-
-    std::string dump_path = fmt::format(
-        "{}textures/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::DumpDir), program_id);
-    if (!FileUtil::CreateFullPath(dump_path)) {
-        LOG_ERROR(Render, "Unable to create {}", dump_path);
-        return;
-    }
-
-    dump_path +=
-        fmt::format("tex1_{}x{}_{:016X}_{}_mip{}.png", width, height, data_hash, format, level);
-    if (dumped_textures.contains(data_hash) || FileUtil::Exists(dump_path)) {
+    // Titles upload the same textures over and over, filter those before doing any work
+    if (!dumped_textures.insert(data_hash).second) {
         return;
     }
 
     // Make sure the texture size is a power of 2.
     // If not, the surface is probably a framebuffer
+    const u32 width = params.width;
+    const u32 height = params.height;
     if (!IsPow2(width) || !IsPow2(height)) {
         LOG_WARNING(Render, "Not dumping {:016X} because size isn't a power of 2 ({}x{})",
                     data_hash, width, height);
         return;
     }
 
-    const u32 decoded_size = width * height * 4;
-    std::vector<u8> pixels(data_size + decoded_size);
-    std::memcpy(pixels.data(), data.data(), data_size);
+    // Dumping must not stall emulation, when the dumper falls behind the texture is dropped
+    // and dumped on one of its next uploads instead.
+    const std::size_t data_size = data.size();
+    const std::size_t buffer_size = data_size + width * height * 4;
+    if (pending_dump_bytes + buffer_size > MAX_PENDING_DUMP_BYTES) {
+        MICROPROFILE_META_CPU("Dropped Texture Dumps", 1);
+        dumped_textures.erase(data_hash);
+        return;
+    }
+
+    if (dump_path.empty()) {
+        const u64 program_id = system.Kernel().GetCurrentProcess()->codeset->program_id;
+        const std::string path = fmt::format(
+            "{}textures/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::DumpDir), program_id);
+        if (!FileUtil::CreateFullPath(path)) {
+            LOG_ERROR(Render, "Unable to create {}", path);
+            return;
+        }
+        dump_path = path;
+    }
+    if (!dump_workers) {
+        dump_workers = std::make_unique<Common::ThreadWorker>(
+            std::clamp(std::thread::hardware_concurrency() / 4, 1U, 2U), "Texture dumper",
+            Common::ThreadRole::Background);
+    }
 
-    auto dump = [this, width, height, params, data_size, decoded_size, pixels = std::move(pixels),
-                 dump_path = std::move(dump_path)]() mutable {
-        const std::span encoded = std::span{pixels}.first(data_size);
-        const std::span decoded = std::span{pixels}.last(decoded_size);
-        DecodeTexture(params, params.addr, params.end, encoded, decoded,
-                      params.type == SurfaceType::Color);
-        Common::FlipRGBA8Texture(decoded, width, height);
-        image_interface.EncodePNG(dump_path, width, height, decoded);
+    std::vector<u8> buffer = AcquireDumpBuffer(buffer_size);
+    std::memcpy(buffer.data(), data.data(), data_size);
+    pending_dump_bytes += buffer_size;
+
+    auto dump = [this, params, level, data_hash, data_size, buffer = std::move(buffer)]() mutable {
+        const std::string path =
+            fmt::format("{}tex1_{}x{}_{:016X}_{}_mip{}.png", dump_path, params.width,
+                        params.height, data_hash, params.pixel_format, level);
+        if (!FileUtil::Exists(path)) {
+            const std::span encoded = std::span{buffer}.first(data_size);
+            const std::span decoded = std::span{buffer}.subspan(data_size);
+            DecodeTexture(params, params.addr, params.end, encoded, decoded,
+                          params.type == SurfaceType::Color);
+            Common::FlipRGBA8Texture(decoded, params.width, params.height);
+            image_interface.EncodePNG(path, params.width, params.height, decoded);
+        }
+        pending_dump_bytes -= buffer.size();
+        ReleaseDumpBuffer(std::move(buffer));
     };
-    if (!workers) {
-        CreateWorkers();
+    dump_workers->QueueWork(std::move(dump));
+}
+
+std::vector<u8> CustomTexManager::AcquireDumpBuffer(std::size_t size) {
+    std::vector<u8> buffer;
+    {
+        std::scoped_lock lock{dump_buffers_mutex};
+        if (!dump_buffers.empty()) {
+            buffer = std::move(dump_buffers.back());
+            dump_buffers.pop_back();
+        }
+    }
+    buffer.resize(size);
+    return buffer;
+}
+
+void CustomTexManager::ReleaseDumpBuffer(std::vector<u8>&& buffer) {
+    std::scoped_lock lock{dump_buffers_mutex};
+    if (dump_buffers.size() < MAX_DUMP_BUFFERS) {
+        dump_buffers.push_back(std::move(buffer));
     }
-    workers->QueueWork(std::move(dump));
-    dumped_textures.insert(data_hash);
 }
 
 Material* CustomTexManager::GetMaterial(u64 data_hash) {
     const auto it = material_map.find(data_hash);
-    if (it == material_map.end()) {
-        LOG_WARNING(Render, "Unable to find replacement for surface with hash {:016X}", data_hash);
+    if (it != material_map.end()) {
+        return it->second.get();
+    }
+    if (Material* material = texture_pack ? CreatePackMaterial(data_hash) : nullptr) {
+        return material;
+    }
+    LOG_WARNING(Render, "Unable to find replacement for surface with hash {:016X}", data_hash);
+    return nullptr;
+}
+
+Material* CustomTexManager::CreatePackMaterial(u64 hash) {
+    const TexturePack::Slot* slot = texture_pack->Find(hash);
+    if (!slot) {
         return nullptr;
     }
-    return it->second.get();
+    auto& material = material_map[hash];
+    material = std::make_unique<Material>();
+    material->hash = hash;
+    for (const u32 file : slot->files) {
+        if (file == TexturePack::NoFile) {
+            continue;
+        }
+        // Textures are shared by the materials of all the hashes they are mapped to
+        auto [it, is_new] = pack_textures.try_emplace(file);
+        if (is_new) {
+            const TexturePack::FileEntry& entry = texture_pack->GetFile(file);
+            auto& texture = custom_textures.emplace_back(
+                std::make_unique<CustomTexture>(image_interface));
+            texture->path = texture_pack->GetFileName(file);
+            texture->file_format = entry.format;
+            texture->type = entry.type;
+            texture->pack = texture_pack.get();
+            texture->pack_file = file;
+            it->second = texture.get();
+        }
+        it->second->hashes.push_back(hash);
+        material->AddMapTexture(it->second);
+    }
+    return material.get();
+}
+
+bool CustomTexManager::BuildTexturePack(u64 title_id) {
+    const auto files = GetTextures(title_id);
+    path_to_hash_map.clear();
+    const std::string config = ReadConfigFile(title_id);
+    if (!ParseConfig(config, false)) {
+        skip_mipmap = true;
+    }
+    std::vector<TexturePack::SourceFile> sources;
+    sources.reserve(files.size());
+    for (const FileUtil::FSTEntry& file : files) {
+        CustomTexture texture{image_interface};
+        if (file.isDirectory || !ParseFilename(file, &texture)) {
+            continue;
+        }
+        sources.push_back({
+            .path = texture.path,
+            .name = file.virtualName,
+            .format = texture.file_format,
+            .type = texture.type,
+            .hashes = std::move(texture.hashes),
+        });
+    }
+    if (sources.empty()) {
+        LOG_ERROR(Render, "No custom textures to pack for title {:016X}", title_id);
+        return false;
+    }
+    return TexturePack::Build(GetPackPath(title_id), config, sources);
 }
 
 bool CustomTexManager::Decode(Material* material, std::function<bool()>&& upload) {
+    material->last_use_frame = frame_tick;
     if (!async_custom_loading) {
-        material->LoadFromDisk(flip_png_files);
+        material->LoadFromDisk(flip_png_files, transcode_cache.get());
         return upload();
     }
     if (material->IsUnloaded()) {
         material->state = DecodeState::Pending;
-        workers->QueueWork([material, this] { material->LoadFromDisk(flip_png_files); });
+        {
+            std::scoped_lock lock{decode_queue_mutex};
+            decode_queue.push_back(material);
+        }
+        workers->QueueWork([this] { DecodeNextMaterial(); });
     }
     async_uploads.push_back({
         .material = material,
@@ -311,7 +470,81 @@ bool CustomTexManager::Decode(Material* material, std::function<bool()>&& upload
     return false;
 }
 
+void CustomTexManager::DecodeNextMaterial() {
+    Material* material;
+    {
+        // Textures bound in the current frame go before the ones queued in earlier frames, which
+        // may not even be used anymore. Materials requested again move up with their frame.
+        std::scoped_lock lock{decode_queue_mutex};
+        const auto it = std::ranges::max_element(decode_queue, {}, [](const Material* queued) {
+            return queued->last_use_frame.load();
+        });
+        material = *it;
+        decode_queue.erase(it);
+    }
+    material->LoadFromDisk(flip_png_files, transcode_cache.get());
+}
+
+u64 CustomTexManager::EvictDecodedTextures(u64 budget) {
+    // Textures are shared between materials, so they are only released when none of their
+    // materials is decoding or waiting for its upload. They age with their latest material.
+    std::unordered_set<const Material*> uploading;
+    for (const AsyncUpload& upload : async_uploads) {
+        uploading.insert(upload.material);
+    }
+    u64 resident = 0;
+    std::vector<std::pair<u64, CustomTexture*>> candidates;
+    for (const auto& texture : custom_textures) {
+        std::unique_lock lock{texture->decode_mutex, std::try_to_lock};
+        if (!lock || !texture->IsLoaded()) {
+            continue;
+        }
+        resident += texture->data.size();
+        u64 last_use_frame = 0;
+        bool in_use = false;
+        for (const u64 hash : texture->hashes) {
+            const auto it = material_map.find(hash);
+            if (it == material_map.end()) {
+                continue;
+            }
+            const Material* material = it->second.get();
+            in_use |= material->IsPending() || uploading.contains(material);
+            last_use_frame = std::max(last_use_frame, material->last_use_frame.load());
+        }
+        if (!in_use) {
+            candidates.emplace_back(last_use_frame, texture.get());
+        }
+    }
+    if (resident <= budget) {
+        return 0;
+    }
+
+    std::ranges::sort(candidates, {}, &std::pair<u64, CustomTexture*>::first);
+    u64 released = 0;
+    for (const auto& [last_use_frame, texture] : candidates) {
+        if (resident - released <= budget) {
+            break;
+        }
+        std::scoped_lock lock{texture->decode_mutex};
+        released += texture->data.size();
+        std::vector<u8>().swap(texture->data);
+        for (const u64 hash : texture->hashes) {
+            const auto it = material_map.find(hash);
+            if (it != material_map.end() && it->second->IsDecoded()) {
+                it->second->size = 0;
+                it->second->state = DecodeState::None;
+            }
+        }
+    }
+    LOG_DEBUG(Render, "Evicted {} bytes of decoded custom textures", released);
+    return released;
+}
+
 bool CustomTexManager::ReadConfig(u64 title_id, bool options_only) {
+    return ParseConfig(ReadConfigFile(title_id), options_only);
+}
+
+std::string CustomTexManager::ReadConfigFile(u64 title_id) {
     const std::string load_path =
         fmt::format("{}textures/{:016X}/", GetUserPath(FileUtil::UserPath::LoadDir), title_id);
     if (!FileUtil::Exists(load_path)) {
@@ -322,11 +555,15 @@ bool CustomTexManager::ReadConfig(u64 title_id, bool options_only) {
     FileUtil::IOFile config_file{config_path, "r"};
     if (!config_file.IsOpen()) {
         LOG_INFO(Render, "Unable to find pack config file, using legacy defaults");
-        return false;
+        return {};
     }
     std::string config(config_file.GetSize(), '\0');
-    const std::size_t read_size = config_file.ReadBytes(config.data(), config.size());
-    if (!read_size) {
+    config.resize(config_file.ReadBytes(config.data(), config.size()));
+    return config;
+}
+
+bool CustomTexManager::ParseConfig(std::string_view config, bool options_only) {
+    if (config.empty()) {
         return false;
     }
 
@@ -370,6 +607,45 @@ bool CustomTexManager::ReadConfig(u64 title_id, bool options_only) {
     return true;
 }
 
+void CustomTexManager::ReadScaleConfig(u64 title_id) {
+    scale_config = {};
+    const std::string config_path = fmt::format(
+        "{}textures/{:016X}/scale.json", GetUserPath(FileUtil::UserPath::LoadDir), title_id);
+    FileUtil::IOFile config_file{config_path, "r"};
+    if (!config_file.IsOpen()) {
+        return;
+    }
+    std::string config(config_file.GetSize(), '\0');
+    if (!config_file.ReadBytes(config.data(), config.size())) {
+        return;
+    }
+
+    const nlohmann::json json = nlohmann::json::parse(config, nullptr, false, true);
+    if (json.is_discarded()) {
+        LOG_ERROR(Render, "Scale config {} is not valid json", config_path);
+        return;
+    }
+    scale_config.small_target_size =
+        json.value("small_target_size", scale_config.small_target_size);
+    scale_config.readback_threshold =
+        json.value("readback_threshold", scale_config.readback_threshold);
+
+    const auto targets = json.find("targets");
+    if (targets == json.end()) {
+        return;
+    }
+    for (const auto& target : targets->items()) {
+        std::size_t idx{};
+        const PAddr addr = static_cast<PAddr>(std::stoul(target.key(), &idx, 16));
+        if (!idx || !target.value().is_number_unsigned()) {
+            LOG_ERROR(Render, "Scale override {} is invalid, skipping", target.key());
+            continue;
+        }
+        scale_config.targets.emplace(addr, target.value().get<u32>());
+    }
+    LOG_INFO(Render, "Loaded {} render target scale overrides", scale_config.targets.size());
+}
+
 std::vector<FileUtil::FSTEntry> CustomTexManager::GetTextures(u64 title_id) {
     const std::string load_path =
         fmt::format("{}textures/{:016X}/", GetUserPath(FileUtil::UserPath::LoadDir), title_id);
@@ -385,8 +661,7 @@ std::vector<FileUtil::FSTEntry> CustomTexManager::GetTextures(u64 title_id) {
 }
 
 void CustomTexManager::CreateWorkers() {
-    const std::size_t num_workers = std::max(std::thread::hardware_concurrency(), 2U) - 1;
-    workers = std::make_unique<Common::ThreadWorker>(num_workers, "Custom textures");
+    workers = std::make_unique<Common::TaskGroup>(Common::TaskPriority::Background);
 }
 
 } // namespace VideoCore
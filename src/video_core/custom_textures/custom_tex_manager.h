@@ -5,11 +5,15 @@
 #pragma once
 
 #include <list>
+#include <mutex>
 #include <span>
 #include <unordered_map>
 #include <unordered_set>
+#include "common/thread_pool.h"
 #include "common/thread_worker.h"
 #include "video_core/custom_textures/material.h"
+#include "video_core/custom_textures/transcode_cache.h"
+#include "video_core/rasterizer_cache/scale_policy.h"
 #include "video_core/rasterizer_interface.h"
 
 namespace Core {
@@ -23,6 +27,7 @@ struct FSTEntry;
 namespace VideoCore {
 
 class SurfaceParams;
+class TexturePack;
 
 struct AsyncUpload {
     const Material* material;
@@ -43,6 +48,15 @@ public:
     /// Reads the pack configuration file
     bool ReadConfig(u64 title_id, bool options_only = false);
 
+    /**
+     * Writes the custom textures in the load directory of the title to a single pack file, which
+     * is loaded instead of the directory from then on.
+     */
+    bool BuildTexturePack(u64 title_id);
+
+    /// Reads the render target scale overrides of the title, if it has any
+    void ReadScaleConfig(u64 title_id);
+
     /// Saves the pack configuration file template to the dump directory if it doesn't exist.
     void PrepareDumping(u64 title_id);
 
@@ -50,7 +64,7 @@ public:
     void PreloadTextures(const std::atomic_bool& stop_run,
                          const VideoCore::DiskResourceLoadCallback& callback);
 
-    /// Saves the provided pixel data described by params to disk as png
+    /// Queues the provided pixel data described by params to be saved to disk as png
     void DumpTexture(const SurfaceParams& params, u32 level, std::span<u8> data, u64 data_hash);
 
     /// Returns the material assigned to the provided data hash
@@ -69,16 +83,46 @@ public:
         return use_new_hash;
     }
 
+    /// Returns the render target scale overrides of the running title
+    const ScaleConfig& GetScaleConfig() const noexcept {
+        return scale_config;
+    }
+
 private:
     /// Parses the custom texture filename (hash, material type, etc).
     bool ParseFilename(const FileUtil::FSTEntry& file, CustomTexture* texture);
 
+    /// Returns the contents of the pack configuration file, empty if there is none.
+    std::string ReadConfigFile(u64 title_id);
+
+    /// Applies a pack configuration, returns false if it is empty.
+    bool ParseConfig(std::string_view config, bool options_only);
+
+    /// Creates the material of a hash from the pack file, returns nullptr if it is not in the pack.
+    Material* CreatePackMaterial(u64 hash);
+
     /// Returns a vector of all custom texture files.
     std::vector<FileUtil::FSTEntry> GetTextures(u64 title_id);
 
     /// Creates the thread workers.
     void CreateWorkers();
 
+    /// Decodes the queued material requested most recently. Runs on a worker thread.
+    void DecodeNextMaterial();
+
+    /// Returns a staging buffer of a texture dump, reusing a released one when possible.
+    std::vector<u8> AcquireDumpBuffer(std::size_t size);
+
+    /// Returns the staging buffer of a finished texture dump to the pool.
+    void ReleaseDumpBuffer(std::vector<u8>&& buffer);
+
+    /**
+     * Frees the decoded data of the least recently used textures, until the decoded textures fit
+     * in the budget. The uploaded surfaces keep their copy, the materials are decoded again when
+     * requested. Returns the number of bytes released.
+     */
+    u64 EvictDecodedTextures(u64 budget);
+
 private:
     Core::System& system;
     Frontend::ImageInterface& image_interface;
@@ -86,13 +130,27 @@ private:
     std::unordered_map<u64, std::unique_ptr<Material>> material_map;
     std::unordered_map<std::string, std::vector<u64>> path_to_hash_map;
     std::vector<std::unique_ptr<CustomTexture>> custom_textures;
+    std::unique_ptr<TexturePack> texture_pack;
+    std::unordered_map<u32, CustomTexture*> pack_textures;
     std::list<AsyncUpload> async_uploads;
-    std::unique_ptr<Common::ThreadWorker> workers;
+    std::mutex decode_queue_mutex;
+    std::vector<Material*> decode_queue;
+    std::unique_ptr<Common::TaskGroup> workers;
+    std::unique_ptr<TranscodeCache> transcode_cache;
+    std::string dump_path;
+    std::mutex dump_buffers_mutex;
+    std::vector<std::vector<u8>> dump_buffers;
+    std::atomic<std::size_t> pending_dump_bytes{};
+    std::unique_ptr<Common::ThreadWorker> dump_workers;
+    ScaleConfig scale_config;
+    u64 frame_tick{};
     bool textures_loaded{false};
+    bool textures_preloaded{false};
     bool async_custom_loading{true};
     bool skip_mipmap{false};
     bool flip_png_files{true};
     bool use_new_hash{true};
+    std::size_t memory_budget_handle{};
 };
 
 } // namespace VideoCore
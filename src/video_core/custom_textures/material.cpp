@@ -7,6 +7,8 @@
 #include "common/texture.h"
 #include "core/frontend/image_interface.h"
 #include "video_core/custom_textures/material.h"
+#include "video_core/custom_textures/texture_pack.h"
+#include "video_core/custom_textures/transcode_cache.h"
 
 namespace VideoCore {
 
@@ -54,21 +56,37 @@ CustomTexture::CustomTexture(Frontend::ImageInterface& image_interface_)
 
 CustomTexture::~CustomTexture() = default;
 
-void CustomTexture::LoadFromDisk(bool flip_png) {
+void CustomTexture::LoadFromDisk(bool flip_png, const TranscodeCache* cache) {
     std::scoped_lock lock{decode_mutex};
     if (IsLoaded()) {
         return;
     }
+    // The transcode cache tracks the source files by their modification time
+    const bool use_cache = cache && file_format == CustomFileFormat::PNG && !pack;
+    if (use_cache && cache->Load(*this, flip_png)) {
+        return;
+    }
 
-    FileUtil::IOFile file{path, "rb"};
-    std::vector<u8> input(file.GetSize());
-    if (file.ReadBytes(input.data(), input.size()) != input.size()) {
+    std::vector<u8> input;
+    if (pack) {
+        input = pack->ReadFile(pack_file);
+    } else {
+        FileUtil::IOFile file{path, "rb"};
+        input.resize(file.GetSize());
+        if (file.ReadBytes(input.data(), input.size()) != input.size()) {
+            input.clear();
+        }
+    }
+    if (input.empty()) {
         LOG_CRITICAL(Render, "Failed to open custom texture: {}", path);
         return;
     }
     switch (file_format) {
     case CustomFileFormat::PNG:
         LoadPNG(input, flip_png);
+        if (use_cache && IsLoaded()) {
+            cache->Store(*this, flip_png);
+        }
         break;
     case CustomFileFormat::DDS:
     case CustomFileFormat::KTX:
@@ -96,7 +114,7 @@ void CustomTexture::LoadDDS(std::span<const u8> input) {
     format = ToCustomPixelFormat(dds_format);
 }
 
-void Material::LoadFromDisk(bool flip_png) noexcept {
+void Material::LoadFromDisk(bool flip_png, const TranscodeCache* cache) noexcept {
     if (IsDecoded()) {
         return;
     }
@@ -104,7 +122,7 @@ void Material::LoadFromDisk(bool flip_png) noexcept {
         if (!texture || texture->IsLoaded()) {
             continue;
         }
-        texture->LoadFromDisk(flip_png);
+        texture->LoadFromDisk(flip_png, cache);
         size += texture->data.size();
         LOG_DEBUG(Render, "Loading {} map {}", MapTypeName(texture->type), texture->path);
     }
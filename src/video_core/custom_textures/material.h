@@ -18,6 +18,9 @@ class ImageInterface;
 
 namespace VideoCore {
 
+class TexturePack;
+class TranscodeCache;
+
 enum class MapType : u32 {
     Color = 0,
     Normal = 1,
@@ -37,7 +40,8 @@ public:
     explicit CustomTexture(Frontend::ImageInterface& image_interface);
     ~CustomTexture();
 
-    void LoadFromDisk(bool flip_png);
+    /// Loads the texture, going through the transcode cache for PNG files when provided.
+    void LoadFromDisk(bool flip_png, const TranscodeCache* cache = nullptr);
 
     [[nodiscard]] bool IsParsed() const noexcept {
         return file_format != CustomFileFormat::None && !hashes.empty();
@@ -63,6 +67,9 @@ public:
     CustomFileFormat file_format;
     std::vector<u8> data;
     MapType type;
+    /// Pack file the texture is read from, instead of its own file at path
+    const TexturePack* pack{};
+    u32 pack_file{};
 };
 
 struct Material {
@@ -73,8 +80,10 @@ struct Material {
     CustomPixelFormat format;
     std::array<CustomTexture*, MAX_MAPS> textures;
     std::atomic<DecodeState> state{};
+    /// Frame the material was last requested in, which orders its decoding and eviction
+    std::atomic<u64> last_use_frame{};
 
-    void LoadFromDisk(bool flip_png) noexcept;
+    void LoadFromDisk(bool flip_png, const TranscodeCache* cache = nullptr) noexcept;
 
     void AddMapTexture(CustomTexture* texture) noexcept;
 
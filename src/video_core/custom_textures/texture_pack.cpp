@@ -0,0 +1,269 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+#include "common/alignment.h"
+#include "common/logging/log.h"
+#include "common/zstd_compression.h"
+#include "video_core/custom_textures/texture_pack.h"
+
+namespace VideoCore {
+
+namespace {
+
+constexpr u32 PackMagic = 0x4B505443; // CTPK
+constexpr u32 PackVersion = 1;
+
+/// The index follows the texture files, it holds the file entries, the slots and then the names
+struct PackHeader {
+    u32 magic;
+    u32 version;
+    u32 num_files;
+    u32 num_slots;
+    u64 config_offset;
+    u64 config_size;
+    u64 index_offset;
+    u64 names_size;
+};
+static_assert(sizeof(PackHeader) == 48);
+
+std::size_t SlotIndex(u64 hash, std::size_t mask) {
+    return static_cast<std::size_t>(hash ^ (hash >> 32)) & mask;
+}
+
+bool IsEmpty(const TexturePack::Slot& slot) {
+    return std::ranges::all_of(slot.files, [](u32 file) { return file == TexturePack::NoFile; });
+}
+
+} // Anonymous namespace
+
+TexturePack::TexturePack() = default;
+
+TexturePack::~TexturePack() = default;
+
+bool TexturePack::Open(const std::string& path_) {
+    path = path_;
+    file = FileUtil::IOFile{path, "rb"};
+    if (!file.IsOpen()) {
+        return false;
+    }
+    PackHeader header{};
+    const u64 file_size = file.GetSize();
+    if (file.ReadAtBytes(&header, sizeof(header), 0) != sizeof(header) ||
+        header.magic != PackMagic || header.version != PackVersion) {
+        LOG_ERROR(Render, "{} is not a custom texture pack of this version", path);
+        return false;
+    }
+    const u64 index_size = u64{header.num_files} * sizeof(FileEntry) +
+                           u64{header.num_slots} * sizeof(Slot) + header.names_size;
+    if (header.config_offset + header.config_size > file_size ||
+        header.index_offset + index_size > file_size || header.index_offset % 8 != 0 ||
+        !std::has_single_bit(header.num_slots)) {
+        LOG_ERROR(Render, "Custom texture pack {} is corrupted", path);
+        return false;
+    }
+
+    // The mapping only fails on platforms without one, the reads then go through the file
+    mapping = Common::MappedFile(file, 0, file_size);
+    std::vector<u8> config_buffer;
+    const auto config_data = ReadRange(header.config_offset, header.config_size, config_buffer);
+    config.assign(config_data.begin(), config_data.end());
+
+    const auto index = ReadRange(header.index_offset, index_size, index_buffer);
+    if (index.size() != index_size) {
+        LOG_ERROR(Render, "Unable to read the index of custom texture pack {}", path);
+        return false;
+    }
+    files = {reinterpret_cast<const FileEntry*>(index.data()), header.num_files};
+    slots = {reinterpret_cast<const Slot*>(index.data() + files.size_bytes()), header.num_slots};
+    names = {reinterpret_cast<const char*>(index.data() + files.size_bytes() + slots.size_bytes()),
+             header.names_size};
+    const bool is_valid = std::ranges::all_of(files, [&](const FileEntry& entry) {
+        return entry.offset + entry.size <= file_size &&
+               u64{entry.name_offset} + entry.name_size <= names.size();
+    });
+    if (!is_valid) {
+        LOG_ERROR(Render, "Custom texture pack {} is corrupted", path);
+        files = {};
+        slots = {};
+        return false;
+    }
+    LOG_INFO(Render, "Opened custom texture pack {} with {} textures", path, files.size());
+    return true;
+}
+
+const TexturePack::Slot* TexturePack::Find(u64 hash) const {
+    const std::size_t mask = slots.size() - 1;
+    std::size_t index = SlotIndex(hash, mask);
+    for (std::size_t probe = 0; probe < slots.size(); probe++) {
+        const Slot& slot = slots[index];
+        if (IsEmpty(slot)) {
+            return nullptr;
+        }
+        if (slot.hash == hash) {
+            return &slot;
+        }
+        index = (index + 1) & mask;
+    }
+    return nullptr;
+}
+
+std::string TexturePack::GetFileName(u32 index) const {
+    const FileEntry& entry = files[index];
+    return std::string{names.subspan(entry.name_offset, entry.name_size).data(), entry.name_size};
+}
+
+std::vector<u8> TexturePack::ReadFile(u32 index) const {
+    const FileEntry& entry = files[index];
+    std::vector<u8> buffer;
+    const auto data = ReadRange(entry.offset, entry.size, buffer);
+    if (data.size() != entry.size) {
+        LOG_ERROR(Render, "Unable to read {} from custom texture pack {}", GetFileName(index),
+                  path);
+        return {};
+    }
+    if (entry.decompressed_size != 0) {
+        auto decompressed = Common::Compression::DecompressDataZSTD(data);
+        if (decompressed.size() != entry.decompressed_size) {
+            LOG_ERROR(Render, "Unable to decompress {} from custom texture pack {}",
+                      GetFileName(index), path);
+            return {};
+        }
+        return decompressed;
+    }
+    if (buffer.empty()) {
+        buffer.assign(data.begin(), data.end());
+    }
+    return buffer;
+}
+
+std::span<const u8> TexturePack::ReadRange(u64 offset, u64 size, std::vector<u8>& buffer) const {
+    if (mapping.IsValid()) {
+        return mapping.Data().subspan(offset, size);
+    }
+    buffer.resize(size);
+    buffer.resize(std::min<std::size_t>(file.ReadAtBytes(buffer.data(), size, offset), size));
+    return buffer;
+}
+
+bool TexturePack::Build(const std::string& path, std::string_view config,
+                        std::span<const SourceFile> sources) {
+    // Each hash gets the files of its maps, the later duplicates are ignored like in directories
+    std::unordered_map<u64, std::array<u32, MAX_MAPS>> materials;
+    for (u32 i = 0; i < static_cast<u32>(sources.size()); i++) {
+        for (const u64 hash : sources[i].hashes) {
+            auto [it, is_new] = materials.try_emplace(hash);
+            if (is_new) {
+                it->second.fill(NoFile);
+            }
+            u32& file = it->second[static_cast<std::size_t>(sources[i].type)];
+            if (file != NoFile) {
+                LOG_ERROR(Render, "Textures {} and {} are assigned to the same material, ignoring!",
+                          sources[file].name, sources[i].name);
+                continue;
+            }
+            file = i;
+        }
+    }
+
+    // The table is kept at most half full, so that lookups only probe a few slots
+    const std::size_t num_slots = std::bit_ceil(std::max<std::size_t>(materials.size() * 2, 1));
+    std::vector<Slot> slots(num_slots, Slot{0, {}});
+    for (Slot& slot : slots) {
+        slot.files.fill(NoFile);
+    }
+    for (const auto& [hash, files] : materials) {
+        std::size_t index = SlotIndex(hash, num_slots - 1);
+        while (!IsEmpty(slots[index])) {
+            index = (index + 1) & (num_slots - 1);
+        }
+        slots[index] = {hash, files};
+    }
+
+    const std::string temp_path = path + ".tmp";
+    FileUtil::IOFile file{temp_path, "wb"};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render, "Unable to create custom texture pack {}", temp_path);
+        return false;
+    }
+    const auto fail = [&] {
+        file.Close();
+        FileUtil::Delete(temp_path);
+        return false;
+    };
+
+    PackHeader header = {
+        .magic = PackMagic,
+        .version = PackVersion,
+        .num_files = static_cast<u32>(sources.size()),
+        .num_slots = static_cast<u32>(num_slots),
+        .config_offset = sizeof(PackHeader),
+        .config_size = config.size(),
+    };
+    file.WriteObject(header);
+    file.WriteString(config);
+
+    std::vector<FileEntry> entries;
+    entries.reserve(sources.size());
+    std::string names;
+    for (const SourceFile& source : sources) {
+        FileUtil::IOFile source_file{source.path, "rb"};
+        std::vector<u8> data(source_file.GetSize());
+        if (source_file.ReadBytes(data.data(), data.size()) != data.size()) {
+            LOG_ERROR(Render, "Unable to read custom texture {}", source.path);
+            return fail();
+        }
+        FileEntry& entry = entries.emplace_back(FileEntry{
+            .offset = file.Tell(),
+            .size = data.size(),
+            .decompressed_size = 0,
+            .name_offset = static_cast<u32>(names.size()),
+            .name_size = static_cast<u32>(source.name.size()),
+            .format = source.format,
+            .type = source.type,
+        });
+        names += source.name;
+
+        // PNG files are compressed already, the block data of DDS and KTX files usually is not
+        if (source.format != CustomFileFormat::PNG) {
+            auto compressed = Common::Compression::CompressDataZSTDDefault(data);
+            if (!compressed.empty() && compressed.size() < data.size() - data.size() / 8) {
+                entry.size = compressed.size();
+                entry.decompressed_size = data.size();
+                data = std::move(compressed);
+            }
+        }
+        if (file.WriteBytes(data.data(), data.size()) != data.size()) {
+            LOG_ERROR(Render, "Unable to write custom texture pack {}", temp_path);
+            return fail();
+        }
+    }
+
+    const std::array<u8, 8> padding{};
+    file.WriteBytes(padding.data(), Common::AlignUp<u64>(file.Tell(), 8) - file.Tell());
+    header.index_offset = file.Tell();
+    header.names_size = names.size();
+    file.WriteBytes(entries.data(), entries.size() * sizeof(FileEntry));
+    file.WriteBytes(slots.data(), slots.size() * sizeof(Slot));
+    file.WriteString(names);
+    if (!file.Seek(0, SEEK_SET) || file.WriteObject(header) != 1 || !file.IsGood()) {
+        LOG_ERROR(Render, "Unable to write custom texture pack {}", temp_path);
+        return fail();
+    }
+    file.Close();
+
+    FileUtil::Delete(path);
+    if (!FileUtil::Rename(temp_path, path)) {
+        LOG_ERROR(Render, "Unable to move custom texture pack to {}", path);
+        FileUtil::Delete(temp_path);
+        return false;
+    }
+    LOG_INFO(Render, "Wrote {} custom textures for {} hashes to {}", sources.size(),
+             materials.size(), path);
+    return true;
+}
+
+} // namespace VideoCore
@@ -0,0 +1,111 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/mapped_file.h"
+#include "video_core/custom_textures/material.h"
+
+namespace VideoCore {
+
+/**
+ * Single file container of a custom texture pack, so that large packs are not scanned and parsed
+ * file by file on every boot. It holds the pack configuration, the texture files as encoded in the
+ * pack, compressed with zstd when that pays off, and an open addressing table from the texture
+ * hashes to their files. The table is looked up in place in the memory mapping of the file.
+ */
+class TexturePack {
+public:
+    static constexpr u32 NoFile = 0xFFFFFFFF;
+
+    /// Files of the maps of a material, indexed by MapType
+    struct Slot {
+        u64 hash;
+        std::array<u32, MAX_MAPS> files;
+    };
+    static_assert(sizeof(Slot) == 16);
+
+    struct FileEntry {
+        u64 offset;
+        u64 size;
+        /// Size of the file before compression, 0 if it is stored as is
+        u64 decompressed_size;
+        u32 name_offset;
+        u32 name_size;
+        CustomFileFormat format;
+        MapType type;
+    };
+    static_assert(sizeof(FileEntry) == 40);
+
+    /// A texture file of the directory layout to write to a pack
+    struct SourceFile {
+        std::string path;
+        std::string name;
+        CustomFileFormat format;
+        MapType type;
+        std::vector<u64> hashes;
+    };
+
+    TexturePack();
+    ~TexturePack();
+
+    /// Opens a pack file. Returns false if it does not exist or is not a valid pack.
+    bool Open(const std::string& path);
+
+    /// Returns the files of the material with a hash, or nullptr if the pack does not replace it.
+    [[nodiscard]] const Slot* Find(u64 hash) const;
+
+    /// Returns all the slots of the table, the empty ones included.
+    [[nodiscard]] std::span<const Slot> Slots() const noexcept {
+        return slots;
+    }
+
+    /// Returns the contents of the pack.json of the pack, empty if it had none.
+    [[nodiscard]] std::string_view Config() const noexcept {
+        return config;
+    }
+
+    [[nodiscard]] const FileEntry& GetFile(u32 index) const {
+        return files[index];
+    }
+
+    /// Returns the name the file had in the directory layout.
+    [[nodiscard]] std::string GetFileName(u32 index) const;
+
+    /// Reads and decompresses a file. Returns an empty vector on failure.
+    [[nodiscard]] std::vector<u8> ReadFile(u32 index) const;
+
+    /**
+     * Writes a pack file.
+     * @param path Path of the pack file to create
+     * @param config Contents of the pack.json of the pack
+     * @param sources Texture files of the pack
+     */
+    static bool Build(const std::string& path, std::string_view config,
+                      std::span<const SourceFile> sources);
+
+private:
+    /// Reads a range of the file, from the mapping when there is one.
+    std::span<const u8> ReadRange(u64 offset, u64 size, std::vector<u8>& buffer) const;
+
+    std::string path;
+    /// Only read with positional reads, from several threads
+    mutable FileUtil::IOFile file;
+    Common::MappedFile mapping;
+    std::string config;
+    std::span<const FileEntry> files;
+    std::span<const Slot> slots;
+    std::span<const char> names;
+    /// Copy of the index when the file could not be mapped
+    std::vector<u8> index_buffer;
+};
+
+} // namespace VideoCore
@@ -0,0 +1,140 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <filesystem>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "video_core/custom_textures/bc_encoder.h"
+#include "video_core/custom_textures/material.h"
+#include "video_core/custom_textures/transcode_cache.h"
+
+namespace VideoCore {
+
+namespace {
+
+constexpr u32 CacheMagic = 0x43585443; // CTXC
+constexpr u32 CacheVersion = 1;
+
+enum CacheFlags : u32 {
+    Flipped = 1 << 0,
+};
+
+struct CacheHeader {
+    u32 magic;
+    u32 version;
+    u32 width;
+    u32 height;
+    CustomPixelFormat format;
+    u32 flags;
+    u64 source_size;
+    s64 source_time;
+    u64 data_size;
+    std::array<u8, 16> reserved;
+};
+static_assert(sizeof(CacheHeader) == 64, "Block data must stay 16 byte aligned");
+
+/// Returns the size and modification time identifying the contents of the source file.
+std::pair<u64, s64> SourceIdentity(const std::string& path) {
+    std::error_code error;
+    const auto time = std::filesystem::last_write_time(path, error);
+    const s64 ticks = error ? 0 : static_cast<s64>(time.time_since_epoch().count());
+    return {FileUtil::GetSize(path), ticks};
+}
+
+} // Anonymous namespace
+
+TranscodeCache::TranscodeCache(u64 title_id)
+    : cache_dir{fmt::format("{}custom_textures/{:016X}/",
+                            FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), title_id)} {
+    if (!FileUtil::CreateFullPath(cache_dir)) {
+        LOG_ERROR(Render, "Unable to create custom texture cache directory {}", cache_dir);
+    }
+}
+
+TranscodeCache::~TranscodeCache() = default;
+
+bool TranscodeCache::Load(CustomTexture& texture, bool flip_png) const {
+    FileUtil::IOFile file{EntryPath(texture), "rb"};
+    if (!file.IsOpen()) {
+        return false;
+    }
+
+    CacheHeader header{};
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    const auto [source_size, source_time] = SourceIdentity(texture.path);
+    const u32 flags = flip_png ? CacheFlags::Flipped : 0;
+    if (header.magic != CacheMagic || header.version != CacheVersion || header.flags != flags ||
+        header.source_size != source_size || header.source_time != source_time ||
+        header.data_size != file.GetSize() - sizeof(header)) {
+        LOG_DEBUG(Render, "Cache entry of {} is stale", texture.path);
+        return false;
+    }
+
+    texture.data.resize(header.data_size);
+    if (file.ReadBytes(texture.data.data(), texture.data.size()) != texture.data.size()) {
+        texture.data.clear();
+        return false;
+    }
+    texture.width = header.width;
+    texture.height = header.height;
+    texture.format = header.format;
+    return true;
+}
+
+void TranscodeCache::Store(CustomTexture& texture, bool flip_png) const {
+    if (texture.format != CustomPixelFormat::RGBA8 || texture.width % 4 != 0 ||
+        texture.height % 4 != 0) {
+        return;
+    }
+
+    std::vector<u8> encoded(BC3EncodedSize(texture.width, texture.height));
+    EncodeBC3(texture.data, texture.width, texture.height, encoded);
+
+    const auto [source_size, source_time] = SourceIdentity(texture.path);
+    const CacheHeader header = {
+        .magic = CacheMagic,
+        .version = CacheVersion,
+        .width = texture.width,
+        .height = texture.height,
+        .format = CustomPixelFormat::BC3,
+        .flags = flip_png ? CacheFlags::Flipped : 0u,
+        .source_size = source_size,
+        .source_time = source_time,
+        .data_size = encoded.size(),
+        .reserved = {},
+    };
+
+    // Write to a temporary file first so an interrupted write never leaves a valid looking entry.
+    const std::string path = EntryPath(texture);
+    const std::string temp_path = path + ".tmp";
+    {
+        FileUtil::IOFile file{temp_path, "wb"};
+        if (file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
+            file.WriteBytes(encoded.data(), encoded.size()) != encoded.size()) {
+            LOG_ERROR(Render, "Unable to write custom texture cache entry {}", temp_path);
+            file.Close();
+            FileUtil::Delete(temp_path);
+            return;
+        }
+    }
+    FileUtil::Delete(path);
+    if (!FileUtil::Rename(temp_path, path)) {
+        LOG_ERROR(Render, "Unable to move custom texture cache entry to {}", path);
+    }
+
+    texture.data = std::move(encoded);
+    texture.format = CustomPixelFormat::BC3;
+}
+
+std::string TranscodeCache::EntryPath(const CustomTexture& texture) const {
+    const u64 hash = Common::ComputeHash64(texture.path.data(), texture.path.size());
+    return fmt::format("{}{:016X}.ctex", cache_dir, hash);
+}
+
+} // namespace VideoCore
@@ -0,0 +1,38 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+class CustomTexture;
+
+/**
+ * Stores PNG custom textures transcoded to a GPU native compressed format, so later runs can
+ * upload them directly instead of decoding the PNG and uploading RGBA8. Each entry is a small
+ * header followed by the raw block data, and can be memory mapped as is. Entries remember the
+ * size and modification time of their source file, and are rebuilt when the source changes.
+ */
+class TranscodeCache {
+public:
+    explicit TranscodeCache(u64 title_id);
+    ~TranscodeCache();
+
+    /// Loads the transcoded data of texture if an up to date cache entry exists.
+    bool Load(CustomTexture& texture, bool flip_png) const;
+
+    /// Transcodes the decoded RGBA8 data of texture in place and writes it to the cache.
+    void Store(CustomTexture& texture, bool flip_png) const;
+
+private:
+    /// Returns the path of the cache entry for texture.
+    std::string EntryPath(const CustomTexture& texture) const;
+
+    std::string cache_dir;
+};
+
+} // namespace VideoCore
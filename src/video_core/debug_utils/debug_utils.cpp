@@ -257,7 +257,7 @@ void DumpShader(const std::string& filename, const ShaderRegs& config, const Sha
 
 static std::unique_ptr<PicaTrace> pica_trace;
 static std::mutex pica_trace_mutex;
-bool g_is_pica_tracing = false;
+std::atomic_bool g_is_pica_tracing = false;
 
 void StartPicaTracing() {
     if (g_is_pica_tracing) {
@@ -272,6 +272,11 @@ void StartPicaTracing() {
 }
 
 void OnPicaRegWrite(u16 cmd_id, u16 mask, u32 value) {
+    // Called for every command list word, so avoid taking the lock while not tracing.
+    if (!IsPicaTracing()) {
+        return;
+    }
+
     std::lock_guard lock(pica_trace_mutex);
 
     if (!g_is_pica_tracing)
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <iterator>
 #include <list>
@@ -187,11 +188,11 @@ struct PicaTrace {
     std::vector<Write> writes;
 };
 
-extern bool g_is_pica_tracing;
+extern std::atomic_bool g_is_pica_tracing;
 
 void StartPicaTracing();
 inline bool IsPicaTracing() {
-    return g_is_pica_tracing;
+    return g_is_pica_tracing.load(std::memory_order::relaxed);
 }
 void OnPicaRegWrite(u16 cmd_id, u16 mask, u32 value);
 std::unique_ptr<PicaTrace> FinishPicaTracing();
@@ -0,0 +1,82 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+
+#include "video_core/dynamic_resolution.h"
+
+namespace VideoCore {
+
+namespace {
+
+/// Weight of a new sample in the running frame time estimate, as a divisor.
+constexpr s64 EstimateWeight = 8;
+
+/// A higher scale is only picked when its predicted frame time stays under this share of the
+/// target, which leaves room for scenes heavier than the ones it was predicted from.
+constexpr s64 UpscaleHeadroomNum = 3;
+constexpr s64 UpscaleHeadroomDen = 4;
+
+/// Returns the frame time estimate of rendering at to_scale, given the time at from_scale.
+std::chrono::nanoseconds Rescale(std::chrono::nanoseconds time, u32 from_scale, u32 to_scale) {
+    return time * (to_scale * to_scale) / (from_scale * from_scale);
+}
+
+} // Anonymous namespace
+
+void DynamicResolution::SetMaxScale(u32 new_max_scale) {
+    new_max_scale = std::max(new_max_scale, 1U);
+    if (max_scale == new_max_scale) {
+        return;
+    }
+    // A new configured scale is tried at full size first.
+    max_scale = new_max_scale;
+    scale = new_max_scale;
+    average_frame_time = {};
+    over_budget_frames = 0;
+    under_budget_frames = 0;
+}
+
+bool DynamicResolution::OnFrame(std::chrono::nanoseconds gpu_time) {
+    // Without a frame limit or a measurement there is nothing to adapt to.
+    if (target_frame_time <= std::chrono::nanoseconds::zero() ||
+        gpu_time <= std::chrono::nanoseconds::zero()) {
+        return false;
+    }
+    if (average_frame_time == std::chrono::nanoseconds::zero()) {
+        average_frame_time = gpu_time;
+    } else {
+        average_frame_time += (gpu_time - average_frame_time) / EstimateWeight;
+    }
+
+    u32 new_scale = scale;
+    if (average_frame_time > target_frame_time) {
+        under_budget_frames = 0;
+        if (scale > 1 && ++over_budget_frames >= DownscaleFrames) {
+            new_scale = scale - 1;
+        }
+    } else if (scale < max_scale &&
+               Rescale(average_frame_time, scale, scale + 1) * UpscaleHeadroomDen <
+                   target_frame_time * UpscaleHeadroomNum) {
+        over_budget_frames = 0;
+        if (++under_budget_frames >= UpscaleFrames) {
+            new_scale = scale + 1;
+        }
+    } else {
+        over_budget_frames = 0;
+        under_budget_frames = 0;
+    }
+    if (new_scale == scale) {
+        return false;
+    }
+
+    // Carry the estimate over so the next decision does not wait for it to settle again.
+    average_frame_time = Rescale(average_frame_time, scale, new_scale);
+    scale = new_scale;
+    over_budget_frames = 0;
+    under_budget_frames = 0;
+    return true;
+}
+
+} // namespace VideoCore
@@ -0,0 +1,57 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * The DynamicResolution controller picks the resolution scale the rasterizer renders at from the
+ * measured GPU time of every frame. The scale drops as soon as frames steadily overrun the frame
+ * time budget and only grows back once the higher scale is predicted to fit comfortably, since
+ * the cost of a frame grows with the square of the scale. Waiting for a streak of frames on either
+ * side keeps it from oscillating on single slow frames.
+ */
+class DynamicResolution {
+public:
+    /// Sets the highest scale the controller may pick. The current scale is clamped to it.
+    void SetMaxScale(u32 scale);
+
+    /// Sets the GPU time every frame should complete in.
+    void SetTargetFrameTime(std::chrono::nanoseconds target) noexcept {
+        target_frame_time = target;
+    }
+
+    /// Returns the scale the next frames should be rendered at.
+    [[nodiscard]] u32 Scale() const noexcept {
+        return scale;
+    }
+
+    /// Returns the smoothed GPU time of the recent frames.
+    [[nodiscard]] std::chrono::nanoseconds AverageFrameTime() const noexcept {
+        return average_frame_time;
+    }
+
+    /// Records the GPU time of the last frame. Returns true when the scale changed.
+    bool OnFrame(std::chrono::nanoseconds gpu_time);
+
+private:
+    /// Frames over budget before the scale drops.
+    static constexpr u32 DownscaleFrames = 8;
+    /// Frames with enough headroom before the scale grows.
+    static constexpr u32 UpscaleFrames = 120;
+
+    std::chrono::nanoseconds target_frame_time{};
+    std::chrono::nanoseconds average_frame_time{};
+    u32 max_scale{1};
+    u32 scale{1};
+    u32 over_budget_frames{};
+    u32 under_budget_frames{};
+};
+
+} // namespace VideoCore
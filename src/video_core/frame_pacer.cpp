@@ -0,0 +1,132 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+
+#include "video_core/frame_pacer.h"
+
+namespace VideoCore {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// Intervals outside this range are pauses or bursts, not display or guest cadence.
+constexpr std::chrono::nanoseconds MinInterval = 2ms;
+constexpr std::chrono::nanoseconds MaxInterval = 100ms;
+
+/// Weight of a new sample in the running interval estimates, as a divisor.
+constexpr s64 EstimateWeight = 8;
+
+std::chrono::nanoseconds Blend(std::chrono::nanoseconds estimate,
+                               std::chrono::nanoseconds sample) {
+    if (estimate == std::chrono::nanoseconds::zero()) {
+        return sample;
+    }
+    return estimate + (sample - estimate) / EstimateWeight;
+}
+
+bool IsPlausible(std::chrono::nanoseconds interval) {
+    return interval >= MinInterval && interval <= MaxInterval;
+}
+
+} // Anonymous namespace
+
+void FramePacer::SetRefreshInterval(std::chrono::nanoseconds interval) {
+    // An unknown interval is measured again from the present cadence.
+    reported_interval = IsPlausible(interval);
+    refresh_interval = reported_interval ? interval : std::chrono::nanoseconds::zero();
+}
+
+bool FramePacer::IsActive(Clock::time_point now) const noexcept {
+    if (now - last_guest_frame > MaxInterval) {
+        return false;
+    }
+    if (refresh_interval == std::chrono::nanoseconds::zero()) {
+        return true;
+    }
+    // Only pace when at least one repeated refresh fits between guest frames.
+    return refresh_interval * 3 / 2 <= guest_interval;
+}
+
+void FramePacer::OnGuestFrame(Clock::time_point time) {
+    const auto delta =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time - last_guest_frame);
+    if (last_guest_frame != Clock::time_point{} && IsPlausible(delta)) {
+        guest_interval = Blend(guest_interval, delta);
+    }
+    last_guest_frame = time;
+}
+
+void FramePacer::OnPresent(Clock::time_point time) {
+    const auto delta = std::chrono::duration_cast<std::chrono::nanoseconds>(time - last_present);
+    last_present = time;
+    if (reported_interval || last_vsync != Clock::time_point{} || !IsPlausible(delta)) {
+        return;
+    }
+
+    // Without a reported interval or vblank times estimate it from the present cadence. Once the
+    // swapchain is saturated presents are throttled by vblank, so keep the estimate locked onto the
+    // shortest cadence seen and ignore refreshes that were skipped because no frame was ready.
+    if (refresh_interval == std::chrono::nanoseconds::zero() ||
+        delta < refresh_interval * 3 / 2) {
+        refresh_interval = Blend(refresh_interval, delta);
+    }
+}
+
+void FramePacer::OnVsync(Clock::time_point time) {
+    if (time <= last_vsync) {
+        return;
+    }
+    const auto delta = std::chrono::duration_cast<std::chrono::nanoseconds>(time - last_vsync);
+    const bool is_consecutive = last_vsync != Clock::time_point{} && IsPlausible(delta) &&
+                                (refresh_interval == std::chrono::nanoseconds::zero() ||
+                                 delta < refresh_interval * 3 / 2);
+    last_vsync = time;
+
+    // Vblank timestamps are far more regular than present cadence, prefer them for the estimate.
+    if (!reported_interval && is_consecutive) {
+        refresh_interval = Blend(refresh_interval, delta);
+    }
+}
+
+void FramePacer::OnDisplayed(Clock::time_point present_time, Clock::time_point display_time) {
+    const auto latency =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(display_time - present_time);
+    if (latency < std::chrono::nanoseconds::zero() || latency > MaxInterval * 2) {
+        return;
+    }
+    display_latency = Blend(display_latency, latency);
+    OnVsync(display_time);
+}
+
+FramePacer::Clock::time_point FramePacer::NextVsync(Clock::time_point time) const {
+    if (last_vsync == Clock::time_point{} || refresh_interval == std::chrono::nanoseconds::zero()) {
+        return time;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - last_vsync);
+    const s64 intervals =
+        elapsed < std::chrono::nanoseconds::zero() ? 0 : elapsed / refresh_interval + 1;
+    return last_vsync + refresh_interval * intervals;
+}
+
+FramePacer::Clock::time_point FramePacer::NextPresentDeadline() const {
+    const auto slack = refresh_interval / DeadlineSlackDivisor;
+    if (last_vsync == Clock::time_point{}) {
+        return last_present + refresh_interval - slack;
+    }
+    // The last refresh went out for the vblank closest to it, target the one after
+    return NextVsync(last_present + refresh_interval / 2) - slack;
+}
+
+float FramePacer::Phase(Clock::time_point time) const {
+    if (guest_interval == std::chrono::nanoseconds::zero()) {
+        return 0.0f;
+    }
+    const auto elapsed = std::chrono::duration<float>(time - last_guest_frame);
+    const auto interval = std::chrono::duration<float>(guest_interval);
+    return std::clamp(elapsed / interval, 0.0f, 1.0f);
+}
+
+} // namespace VideoCore
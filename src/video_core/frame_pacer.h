@@ -0,0 +1,88 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * The FramePacer schedules presentation on display refresh boundaries rather than whenever a
+ * guest frame happens to be ready. When the host display refreshes faster than the guest renders
+ * (60 fps content on a 120 Hz panel) the present thread asks it when the next refresh must be
+ * submitted, and repeats (or interpolates) the last guest frame on refreshes without a new one.
+ * This keeps a steady cadence while a new guest frame still goes out on the very next refresh.
+ * When the frontend or the presentation engine report when vblanks happen, refreshes are aligned
+ * to that timeline instead of the times presents happened to return.
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Sets the refresh interval reported by the presentation engine, or zero if unknown.
+    void SetRefreshInterval(std::chrono::nanoseconds interval);
+
+    /// Returns the known or estimated refresh interval of the host display.
+    [[nodiscard]] std::chrono::nanoseconds RefreshInterval() const noexcept {
+        return refresh_interval;
+    }
+
+    /// Returns the estimated interval between guest frames.
+    [[nodiscard]] std::chrono::nanoseconds GuestInterval() const noexcept {
+        return guest_interval;
+    }
+
+    /**
+     * Returns true when refreshes without a new guest frame should be filled in. This is the case
+     * while the refresh interval is still being measured, or when the display refreshes enough
+     * faster than the guest renders. Pacing stops when the guest has not produced a frame lately.
+     */
+    [[nodiscard]] bool IsActive(Clock::time_point now) const noexcept;
+
+    /// Records that a new guest frame was submitted for presentation at time.
+    void OnGuestFrame(Clock::time_point time);
+
+    /// Records that a refresh (either a new or a repeated frame) was presented at time.
+    void OnPresent(Clock::time_point time);
+
+    /// Records a vblank of the host display, as reported by the frontend.
+    void OnVsync(Clock::time_point time);
+
+    /// Records that an image presented at present_time was first displayed at display_time.
+    void OnDisplayed(Clock::time_point present_time, Clock::time_point display_time);
+
+    /// Returns the estimated time between presenting an image and the display showing it.
+    [[nodiscard]] std::chrono::nanoseconds DisplayLatency() const noexcept {
+        return display_latency;
+    }
+
+    /// Returns the first vblank after time, or time itself if the vblank timeline is unknown.
+    [[nodiscard]] Clock::time_point NextVsync(Clock::time_point time) const;
+
+    /// Returns the latest time the next refresh can be submitted without missing its vblank.
+    [[nodiscard]] Clock::time_point NextPresentDeadline() const;
+
+    /**
+     * Returns how far the refresh presented at time lies between the last guest frame and the
+     * next expected one, in the range [0, 1]. Interpolation hooks use this as their blend factor.
+     */
+    [[nodiscard]] float Phase(Clock::time_point time) const;
+
+private:
+    /// Refreshes are submitted this fraction of an interval before the expected vblank.
+    static constexpr s64 DeadlineSlackDivisor = 4;
+
+    std::chrono::nanoseconds refresh_interval{};
+    std::chrono::nanoseconds guest_interval{};
+    std::chrono::nanoseconds display_latency{};
+    Clock::time_point last_present{};
+    Clock::time_point last_guest_frame{};
+    Clock::time_point last_vsync{};
+    bool reported_interval{};
+};
+
+} // namespace VideoCore
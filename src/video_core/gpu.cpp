@@ -2,15 +2,21 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/alignment.h"
 #include "common/archives.h"
+#include "common/memory_budget.h"
 #include "common/microprofile.h"
+#include "common/settings.h"
+#include "common/trace_recorder.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/service/gsp/gsp_gpu.h"
 #include "core/hle/service/plgldr/plgldr.h"
+#include "core/tracer/recorder.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/gpu.h"
 #include "video_core/gpu_debugger.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/pica/pica_core.h"
 #include "video_core/pica/regs_lcd.h"
 #include "video_core/renderer_base.h"
@@ -21,6 +27,8 @@ namespace VideoCore {
 
 constexpr VAddr VADDR_LCD = 0x1ED02000;
 constexpr VAddr VADDR_GPU = 0x1EF00000;
+constexpr PAddr PADDR_LCD = 0x10202000;
+constexpr PAddr PADDR_GPU = 0x10400000;
 
 MICROPROFILE_DEFINE(GPU_DisplayTransfer, "GPU", "DisplayTransfer", MP_RGB(100, 100, 255));
 MICROPROFILE_DEFINE(GPU_CmdlistProcessing, "GPU", "Cmdlist Processing", MP_RGB(100, 255, 100));
@@ -36,7 +44,11 @@ struct GPU::Impl {
     RasterizerInterface* rasterizer;
     std::unique_ptr<SwRenderer::SwBlitter> sw_blitter;
     Core::TimingEventType* vblank_event;
+    Core::TimingEventType* interrupt_event;
     Service::GSP::InterruptHandler signal_interrupt;
+    Service::GSP::InterruptHandler async_interrupt;
+    std::unique_ptr<GPUThread> gpu_thread;
+    u32 skipped_frames{};
 
     explicit Impl(Core::System& system, Frontend::EmuWindow& emu_window,
                   Frontend::EmuWindow* secondary_window)
@@ -46,6 +58,43 @@ struct GPU::Impl {
           rasterizer{renderer->Rasterizer()}, sw_blitter{std::make_unique<SwRenderer::SwBlitter>(
                                                   memory, rasterizer)} {}
     ~Impl() = default;
+
+    /// Returns true when GPU work is queued to the GPU thread instead of run in place
+    bool IsPipelined() const {
+        return gpu_thread && !Recorder();
+    }
+
+    /// Signals an interrupt, through the timing queue when raised on the GPU thread
+    void SignalInterrupt(Service::GSP::InterruptId interrupt_id) {
+        if (gpu_thread && gpu_thread->IsGPUThread()) {
+            async_interrupt(interrupt_id);
+        } else {
+            signal_interrupt(interrupt_id);
+        }
+    }
+
+    /// Returns the CiTrace recorder when a trace is being recorded
+    CiTrace::Recorder* Recorder() const {
+        return debug_context ? debug_context->recorder.get() : nullptr;
+    }
+
+    /// Records writes of the given values to the GPU registers starting at index
+    void RecordRegisters(std::size_t index, std::span<const u32> values) const {
+        if (auto* recorder = Recorder()) {
+            for (std::size_t i = 0; i < values.size(); i++) {
+                recorder->RegisterWritten(PADDR_GPU + static_cast<u32>((index + i) * sizeof(u32)),
+                                          values[i]);
+            }
+        }
+    }
+
+    /// Returns the register words of a GPU configuration block
+    template <typename Config>
+    static std::array<u32, sizeof(Config) / sizeof(u32)> RegisterValues(const Config& config) {
+        std::array<u32, sizeof(Config) / sizeof(u32)> values;
+        std::memcpy(values.data(), &config, sizeof(config));
+        return values;
+    }
 };
 
 GPU::GPU(Core::System& system, Frontend::EmuWindow& emu_window,
@@ -55,9 +104,28 @@ GPU::GPU(Core::System& system, Frontend::EmuWindow& emu_window,
         "GPU::VBlankCallback",
         [this](uintptr_t user_data, s64 cycles_late) { VBlankCallback(user_data, cycles_late); });
     impl->timing.ScheduleEvent(FRAME_TICKS, impl->vblank_event);
+    impl->interrupt_event = impl->timing.RegisterEvent(
+        "GPU::InterruptCallback", [this](uintptr_t user_data, s64) {
+            // The guest may touch the memory of the finished work right away
+            impl->memory.ApplyPendingRasterizerMarks();
+            impl->signal_interrupt(static_cast<Service::GSP::InterruptId>(user_data));
+        });
 
     // Bind the rasterizer to the PICA GPU
     impl->pica.BindRasterizer(impl->rasterizer);
+
+    // The OpenGL context is owned by the emulation thread, so the GPU thread
+    // is only available to backends that are free to record from any thread.
+    const bool async_gpu = Settings::values.async_gpu.GetValue();
+    if (async_gpu && Settings::values.graphics_api.GetValue() == Settings::GraphicsAPI::OpenGL) {
+        LOG_WARNING(HW_GPU, "Asynchronous GPU emulation is not supported by OpenGL, disabling");
+    } else if (async_gpu) {
+        impl->gpu_thread = std::make_unique<GPUThread>(impl->system.perf_stats, impl->pica);
+        impl->gpu_thread->SubmitTask([&system = impl->system] {
+            Core::System::MakeCurrent(system);
+            system.Memory().DeferRasterizerMarks();
+        });
+    }
 }
 
 GPU::~GPU() = default;
@@ -89,27 +157,76 @@ PAddr GPU::VirtualToPhysicalAddress(VAddr addr) {
 
 void GPU::SetInterruptHandler(Service::GSP::InterruptHandler handler) {
     impl->signal_interrupt = handler;
-    impl->pica.SetInterruptHandler(handler);
+    if (!impl->gpu_thread) {
+        impl->pica.SetInterruptHandler(handler);
+        return;
+    }
+
+    // Interrupts raised by command lists on the GPU thread are forwarded to the
+    // emulation thread through the timing queue, as the kernel is not thread safe.
+    impl->async_interrupt = [this](Service::GSP::InterruptId interrupt_id) {
+        impl->timing.ScheduleEvent(0, impl->interrupt_event,
+                                   static_cast<std::uintptr_t>(interrupt_id), 0, true);
+    };
+    impl->pica.SetInterruptHandler(impl->async_interrupt);
 }
 
 void GPU::FlushRegion(PAddr addr, u32 size) {
+    WaitIdle();
     impl->rasterizer->FlushRegion(addr, size);
 }
 
 void GPU::InvalidateRegion(PAddr addr, u32 size) {
+    WaitIdle();
     impl->rasterizer->InvalidateRegion(addr, size);
 }
 
+void GPU::FlushAndInvalidateRegion(PAddr addr, u32 size) {
+    WaitIdle();
+    impl->rasterizer->FlushAndInvalidateRegion(addr, size);
+}
+
+bool GPU::AccelerateY2R(const Y2RConfig& config) {
+    WaitIdle();
+    return impl->rasterizer->AccelerateY2R(config);
+}
+
 void GPU::ClearAll(bool flush) {
+    WaitIdle();
     impl->rasterizer->ClearAll(flush);
 }
 
+void GPU::WaitIdle() {
+    if (impl->gpu_thread) {
+        impl->gpu_thread->WaitIdle();
+        impl->memory.ApplyPendingRasterizerMarks();
+    }
+}
+
+void GPU::RunPipelined(std::function<void()>&& task) {
+    if (impl->IsPipelined()) {
+        impl->gpu_thread->SubmitTask(std::move(task));
+        return;
+    }
+    WaitIdle();
+    task();
+}
+
+bool GPU::IsAsync() const {
+    return impl->gpu_thread != nullptr;
+}
+
+bool GPU::IsIdle() const {
+    return !impl->gpu_thread || impl->gpu_thread->IsIdle();
+}
+
 void GPU::Execute(const Service::GSP::Command& command) {
     using Service::GSP::CommandId;
-    auto& regs = impl->pica.regs;
 
     switch (command.id) {
     case CommandId::RequestDma: {
+        // The copy goes through the process mappings, which belong to the emulation thread
+        WaitIdle();
         impl->system.Memory().RasterizerFlushVirtualRegion(
             command.dma_request.source_address, command.dma_request.size, Memory::FlushMode::Flush);
         impl->system.Memory().RasterizerFlushVirtualRegion(command.dma_request.dest_address,
@@ -125,70 +242,82 @@ void GPU::Execute(const Service::GSP::Command& command) {
         break;
     }
     case CommandId::SubmitCmdList: {
-        auto& params = command.submit_gpu_cmdlist;
-        auto& cmdbuffer = regs.internal.pipeline.command_buffer;
-
-        // Write to the command buffer GPU registers
-        cmdbuffer.addr[0].Assign(VirtualToPhysicalAddress(params.address) >> 3);
-        cmdbuffer.size[0].Assign(params.size >> 3);
-        cmdbuffer.trigger[0] = 1;
-
-        // Trigger processing of the command list
-        SubmitCmdList(0);
+        const auto& params = command.submit_gpu_cmdlist;
+        const PAddr address = VirtualToPhysicalAddress(params.address);
+        RunPipelined([this, params, address] {
+            // Write to the command buffer GPU registers
+            auto& cmdbuffer = impl->pica.regs.internal.pipeline.command_buffer;
+            cmdbuffer.addr[0].Assign(address >> 3);
+            cmdbuffer.size[0].Assign(params.size >> 3);
+            cmdbuffer.trigger[0] = 1;
+
+            // Trigger processing of the command list
+            SubmitCmdList(0);
+        });
         break;
     }
     case CommandId::MemoryFill: {
-        auto& params = command.memory_fill;
-        auto& memfill = regs.memory_fill_config;
-
-        // Write to the memory fill GPU registers.
-        if (params.start1 != 0) {
-            memfill[0].address_start = VirtualToPhysicalAddress(params.start1) >> 3;
-            memfill[0].address_end = VirtualToPhysicalAddress(params.end1) >> 3;
-            memfill[0].value_32bit = params.value1;
-            memfill[0].control = params.control1;
-            MemoryFill(0);
-        }
-        if (params.start2 != 0) {
-            memfill[1].address_start = VirtualToPhysicalAddress(params.start2) >> 3;
-            memfill[1].address_end = VirtualToPhysicalAddress(params.end2) >> 3;
-            memfill[1].value_32bit = params.value2;
-            memfill[1].control = params.control2;
-            MemoryFill(1);
-        }
+        const auto& params = command.memory_fill;
+        const std::array<PAddr, 4> addresses{
+            VirtualToPhysicalAddress(params.start1), VirtualToPhysicalAddress(params.end1),
+            VirtualToPhysicalAddress(params.start2), VirtualToPhysicalAddress(params.end2)};
+        RunPipelined([this, params, addresses] {
+            // Write to the memory fill GPU registers.
+            auto& memfill = impl->pica.regs.memory_fill_config;
+            if (params.start1 != 0) {
+                memfill[0].address_start = addresses[0] >> 3;
+                memfill[0].address_end = addresses[1] >> 3;
+                memfill[0].value_32bit = params.value1;
+                memfill[0].control = params.control1;
+                MemoryFill(0);
+            }
+            if (params.start2 != 0) {
+                memfill[1].address_start = addresses[2] >> 3;
+                memfill[1].address_end = addresses[3] >> 3;
+                memfill[1].value_32bit = params.value2;
+                memfill[1].control = params.control2;
+                MemoryFill(1);
+            }
+        });
         break;
     }
     case CommandId::DisplayTransfer: {
-        auto& params = command.display_transfer;
-        auto& display_transfer = regs.display_transfer_config;
-
-        // Write to the transfer engine GPU registers.
-        display_transfer.input_address = VirtualToPhysicalAddress(params.in_buffer_address) >> 3;
-        display_transfer.output_address = VirtualToPhysicalAddress(params.out_buffer_address) >> 3;
-        display_transfer.input_size = params.in_buffer_size;
-        display_transfer.output_size = params.out_buffer_size;
-        display_transfer.flags = params.flags;
-        display_transfer.trigger.Assign(1);
-
-        // Trigger the display transfer.
-        MemoryTransfer();
+        const auto& params = command.display_transfer;
+        const PAddr input_address = VirtualToPhysicalAddress(params.in_buffer_address);
+        const PAddr output_address = VirtualToPhysicalAddress(params.out_buffer_address);
+        RunPipelined([this, params, input_address, output_address] {
+            // Write to the transfer engine GPU registers.
+            auto& display_transfer = impl->pica.regs.display_transfer_config;
+            display_transfer.input_address = input_address >> 3;
+            display_transfer.output_address = output_address >> 3;
+            display_transfer.input_size = params.in_buffer_size;
+            display_transfer.output_size = params.out_buffer_size;
+            display_transfer.flags = params.flags;
+            display_transfer.trigger.Assign(1);
+
+            // Trigger the display transfer.
+            MemoryTransfer();
+        });
         break;
     }
     case CommandId::TextureCopy: {
-        auto& params = command.texture_copy;
-        auto& texture_copy = regs.display_transfer_config;
-
-        // Write to the transfer engine GPU registers.
-        texture_copy.input_address = VirtualToPhysicalAddress(params.in_buffer_address) >> 3;
-        texture_copy.output_address = VirtualToPhysicalAddress(params.out_buffer_address) >> 3;
-        texture_copy.texture_copy.size = params.size;
-        texture_copy.texture_copy.input_size = params.in_width_gap;
-        texture_copy.texture_copy.output_size = params.out_width_gap;
-        texture_copy.flags = params.flags;
-        texture_copy.trigger.Assign(1);
-
-        // Trigger the texture copy.
-        MemoryTransfer();
+        const auto& params = command.texture_copy;
+        const PAddr input_address = VirtualToPhysicalAddress(params.in_buffer_address);
+        const PAddr output_address = VirtualToPhysicalAddress(params.out_buffer_address);
+        RunPipelined([this, params, input_address, output_address] {
+            // Write to the transfer engine GPU registers.
+            auto& texture_copy = impl->pica.regs.display_transfer_config;
+            texture_copy.input_address = input_address >> 3;
+            texture_copy.output_address = output_address >> 3;
+            texture_copy.texture_copy.size = params.size;
+            texture_copy.texture_copy.input_size = params.in_width_gap;
+            texture_copy.texture_copy.output_size = params.out_width_gap;
+            texture_copy.flags = params.flags;
+            texture_copy.trigger.Assign(1);
+
+            // Trigger the texture copy.
+            MemoryTransfer();
+        });
         break;
     }
     case CommandId::CacheFlush: {
@@ -207,6 +336,7 @@ void GPU::Execute(const Service::GSP::Command& command) {
 }
 
 void GPU::SetBufferSwap(u32 screen_id, const Service::GSP::FrameBufferInfo& info) {
+    WaitIdle();
     const PAddr phys_address_left = VirtualToPhysicalAddress(info.address_left);
     const PAddr phys_address_right = VirtualToPhysicalAddress(info.address_right);
 
@@ -223,6 +353,9 @@ void GPU::SetBufferSwap(u32 screen_id, const Service::GSP::FrameBufferInfo& info
     framebuffer.stride = info.stride;
     framebuffer.format = info.format;
     framebuffer.active_fb = info.shown_fb;
+    impl->RecordRegisters(GPU_REG_INDEX(framebuffer_config) +
+                              screen_id * sizeof(framebuffer) / sizeof(u32),
+                          Impl::RegisterValues(framebuffer));
 
     // Notify debugger about the buffer swap.
     if (impl->debug_context) {
@@ -231,16 +364,21 @@ void GPU::SetBufferSwap(u32 screen_id, const Service::GSP::FrameBufferInfo& info
 
     if (screen_id == 0) {
         MicroProfileFlip();
+        if (auto* trace_recorder = impl->system.GetTraceRecorder()) {
+            trace_recorder->RecordFrame();
+        }
         impl->system.perf_stats->EndGameFrame();
     }
 }
 
 void GPU::SetColorFill(const Pica::ColorFill& fill) {
+    WaitIdle();
     impl->pica.regs_lcd.color_fill_top = fill;
     impl->pica.regs_lcd.color_fill_bottom = fill;
 }
 
 u32 GPU::ReadReg(VAddr addr) {
+    WaitIdle();
     switch (addr & 0xFFFFF000) {
     case VADDR_LCD: {
         const u32 offset = addr - VADDR_LCD;
@@ -263,6 +401,7 @@ u32 GPU::ReadReg(VAddr addr) {
 }
 
 void GPU::WriteReg(VAddr addr, u32 data) {
+    WaitIdle();
     switch (addr & 0xFFFFF000) {
     case VADDR_LCD: {
         const u32 offset = addr - VADDR_LCD;
@@ -270,6 +409,9 @@ void GPU::WriteReg(VAddr addr, u32 data) {
         ASSERT(addr % sizeof(u32) == 0);
         ASSERT(index < Pica::RegsLcd::NumIds());
         impl->pica.regs_lcd[index] = data;
+        if (auto* recorder = impl->Recorder()) {
+            recorder->RegisterWritten(PADDR_LCD + offset, data);
+        }
         break;
     }
     case VADDR_GPU:
@@ -299,6 +441,8 @@ void GPU::WriteReg(VAddr addr, u32 data) {
             SubmitCmdList(1);
             break;
         default:
+            // Triggers are recorded by their actions, once the memory they read is recorded.
+            impl->RecordRegisters(index, std::array{data});
             break;
         }
         break;
@@ -309,6 +453,7 @@ void GPU::WriteReg(VAddr addr, u32 data) {
 }
 
 void GPU::Sync() {
+    WaitIdle();
     impl->renderer->Sync();
 }
 
@@ -339,13 +484,21 @@ void GPU::SubmitCmdList(u32 index) {
         return;
     }
 
-    MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
-
     // Forward command list processing to the PICA core.
     const PAddr addr = config.GetPhysicalAddress(index);
     const u32 size = config.GetSize(index);
-    impl->pica.ProcessCmdList(addr, size);
+    const auto trigger_values = Impl::RegisterValues(config);
     config.trigger[index] = 0;
+    if (impl->IsPipelined() && !impl->gpu_thread->IsGPUThread()) {
+        impl->gpu_thread->SubmitList(addr, size);
+        return;
+    }
+
+    MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
+    Core::PerfStats::ScopedFrameTimer timer{impl->system.perf_stats.get(),
+                                            Core::PerfStats::FrameTimer::GpuCommands};
+    impl->pica.ProcessCmdList(addr, size);
+    impl->RecordRegisters(GPU_REG_INDEX(internal.pipeline.command_buffer), trigger_values);
 }
 
 void GPU::MemoryFill(u32 index) {
@@ -356,17 +509,20 @@ void GPU::MemoryFill(u32 index) {
     }
 
     // Perform memory fill.
+    const auto trigger_values = Impl::RegisterValues(config);
     if (!impl->rasterizer->AccelerateFill(config)) {
         impl->sw_blitter->MemoryFill(config);
     }
+    impl->RecordRegisters(GPU_REG_INDEX(memory_fill_config) + index * sizeof(config) / sizeof(u32),
+                          trigger_values);
 
     // It seems that it won't signal interrupt if "address_start" is zero.
     // TODO: hwtest this
     if (config.GetStartAddress() != 0) {
         if (!index) {
-            impl->signal_interrupt(Service::GSP::InterruptId::PSC0);
+            impl->SignalInterrupt(Service::GSP::InterruptId::PSC0);
         } else {
-            impl->signal_interrupt(Service::GSP::InterruptId::PSC1);
+            impl->SignalInterrupt(Service::GSP::InterruptId::PSC1);
         }
     }
 
@@ -390,36 +546,74 @@ void GPU::MemoryTransfer() {
         impl->debug_context->OnEvent(Pica::DebugContext::Event::IncomingDisplayTransfer, nullptr);
     }
 
+    // Record the memory read by the transfer, the trace replays it on the destination.
+    const auto trigger_values = Impl::RegisterValues(config);
+    if (impl->Recorder()) {
+        u32 input_size{};
+        if (config.is_texture_copy) {
+            const u32 size = Common::AlignDown(config.texture_copy.size, 16);
+            const u32 input_gap = config.texture_copy.input_gap * 16;
+            const u32 input_width = config.texture_copy.input_width * 16;
+            input_size = input_gap == 0 || input_width == 0
+                             ? size
+                             : size / input_width * (input_width + input_gap) + size % input_width;
+        } else {
+            input_size = config.input_width * config.input_height *
+                         Pica::BytesPerPixel(config.input_format);
+        }
+        impl->pica.RecordMemory(config.GetPhysicalInputAddress(), input_size);
+    }
+
     // Perform memory transfer
+    // Transfers the rasterizer cannot perform on the host GPU are counted, as each one flushes the
+    // cached source region and invalidates the cached destination.
     if (config.is_texture_copy) {
         if (!impl->rasterizer->AccelerateTextureCopy(config)) {
+            MICROPROFILE_META_CPU("CPU Texture Copies", 1);
             impl->sw_blitter->TextureCopy(config);
         }
     } else {
         if (!impl->rasterizer->AccelerateDisplayTransfer(config)) {
+            MICROPROFILE_META_CPU("CPU Display Transfers", 1);
             impl->sw_blitter->DisplayTransfer(config);
         }
     }
 
+    impl->RecordRegisters(GPU_REG_INDEX(display_transfer_config), trigger_values);
+
     // Complete transfer.
     config.trigger.Assign(0);
-    impl->signal_interrupt(Service::GSP::InterruptId::PPF);
+    impl->SignalInterrupt(Service::GSP::InterruptId::PPF);
 }
 
 void GPU::VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
     // Present renderered frame.
+    WaitIdle();
+    if (auto* recorder = impl->Recorder()) {
+        recorder->FrameFinished();
+    }
     impl->renderer->SwapBuffers();
 
+    // Draws are dropped for frame_skip frames after each rendered one.
+    const u32 frame_skip = Settings::values.frame_skip.GetValue();
+    const bool skip_draws = impl->skipped_frames < frame_skip;
+    impl->skipped_frames = skip_draws ? impl->skipped_frames + 1 : 0;
+    impl->pica.SetSkipDraws(skip_draws);
+
     // Signal to GSP that GPU interrupt has occurred
     impl->signal_interrupt(Service::GSP::InterruptId::PDC0);
     impl->signal_interrupt(Service::GSP::InterruptId::PDC1);
 
+    // The GPU thread is idle, so the caches can be trimmed if memory runs low
+    Common::MemoryBudget::Instance().Update();
+
     // Reschedule recurrent event
     impl->timing.ScheduleEvent(FRAME_TICKS - cycles_late, impl->vblank_event);
 }
 
 template <class Archive>
 void GPU::serialize(Archive& ar, const u32 file_version) {
+    WaitIdle();
     ar & impl->pica;
 }
 
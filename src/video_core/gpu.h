@@ -37,6 +37,7 @@ constexpr u64 FRAME_TICKS = 2240568ull;
 
 class GraphicsDebugger;
 class RendererBase;
+struct Y2RConfig;
 
 /**
  * The GPU class is the high level interface to the video_core for core services.
@@ -56,9 +57,28 @@ public:
     /// Notify rasterizer that any caches of the specified region should be invalidated
     void InvalidateRegion(PAddr addr, u32 size);
 
+    /// Notify rasterizer that any caches of the specified region should be flushed and invalidated
+    void FlushAndInvalidateRegion(PAddr addr, u32 size);
+
+    /**
+     * Attempts to perform a Y2R conversion on the host GPU, directly into the rasterizer cache
+     * surface at its destination. The converted image is only written back to emulated memory if
+     * the guest reads it.
+     */
+    bool AccelerateY2R(const Y2RConfig& config);
+
     /// Flushes and invalidates all memory in the rasterizer cache and removes any leftover state.
     void ClearAll(bool flush);
 
+    /// Blocks until the GPU thread, when enabled, has processed all submitted command lists.
+    void WaitIdle();
+
+    /// Returns true when command lists are processed on a dedicated GPU thread.
+    [[nodiscard]] bool IsAsync() const;
+
+    /// Returns true if no submitted command lists are still waiting on the GPU thread.
+    [[nodiscard]] bool IsIdle() const;
+
     /// Executes the provided GSP command.
     void Execute(const Service::GSP::Command& command);
 
@@ -99,6 +119,9 @@ private:
 
     void MemoryTransfer();
 
+    /// Queues GPU work behind the pending command lists, or runs it once they are done
+    void RunPipelined(std::function<void()>&& task);
+
     void VBlankCallback(uintptr_t user_data, s64 cycles_late);
 
     friend class boost::serialization::access;
@@ -0,0 +1,38 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/settings.h"
+#include "video_core/gpu_profiler.h"
+
+namespace VideoCore {
+
+bool GpuProfiler::IsEnabled() const {
+    return Settings::values.gpu_profiling.GetValue();
+}
+
+void GpuProfiler::AddSample(const char* name, std::chrono::nanoseconds time) {
+    std::scoped_lock lock{mutex};
+    const auto it = std::ranges::find(current, name, &Entry::name);
+    if (it == current.end()) {
+        current.push_back({name, time, 1});
+        return;
+    }
+    it->time += time;
+    it->count++;
+}
+
+void GpuProfiler::EndFrame() {
+    std::scoped_lock lock{mutex};
+    std::ranges::sort(current, std::ranges::greater{}, &Entry::time);
+    last_frame.swap(current);
+    current.clear();
+}
+
+std::vector<GpuProfiler::Entry> GpuProfiler::LastFrame() const {
+    std::scoped_lock lock{mutex};
+    return last_frame;
+}
+
+} // namespace VideoCore
@@ -0,0 +1,47 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * The GpuProfiler sums the GPU time of the operations the hardware renderers wrap in timestamp
+ * queries. Samples arrive once the GPU has completed the queries, usually a few frames after the
+ * operation was recorded, and are accumulated by name until the end of the frame. Scope names
+ * must be string literals, they are compared by address.
+ */
+class GpuProfiler {
+public:
+    struct Entry {
+        const char* name;
+        std::chrono::nanoseconds time;
+        u32 count;
+    };
+
+    /// Returns true when the renderers should record timestamp queries.
+    [[nodiscard]] bool IsEnabled() const;
+
+    /// Adds the GPU time of one completed operation.
+    void AddSample(const char* name, std::chrono::nanoseconds time);
+
+    /// Publishes the samples received since the previous frame.
+    void EndFrame();
+
+    /// Returns the operations measured during the last frame, the most expensive first.
+    [[nodiscard]] std::vector<Entry> LastFrame() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<Entry> current;
+    std::vector<Entry> last_frame;
+};
+
+} // namespace VideoCore
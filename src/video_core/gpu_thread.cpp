@@ -0,0 +1,114 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "common/bounded_threadsafe_queue.h"
+#include "common/microprofile.h"
+#include "common/polyfill_thread.h"
+#include "common/thread.h"
+#include "core/perf_stats.h"
+#include "video_core/gpu_thread.h"
+#include "video_core/pica/pica_core.h"
+
+namespace VideoCore {
+
+MICROPROFILE_DEFINE(GPU_ThreadCmdlist, "GPU", "Threaded Cmdlist Processing",
+                    MP_RGB(100, 255, 150));
+MICROPROFILE_DEFINE(GPU_ThreadWaitIdle, "GPU", "Wait for GPU thread", MP_RGB(255, 100, 100));
+
+struct GPUThread::Impl {
+    /// A command list, or a task when one is set
+    struct CommandList {
+        PAddr addr;
+        u32 size;
+        std::function<void()> task;
+    };
+
+    static constexpr std::size_t QueueCapacity = 64;
+
+    /// Owned by the system, which replaces it for every title
+    const std::unique_ptr<Core::PerfStats>& perf_stats;
+    Pica::PicaCore& pica;
+    Common::SPSCQueue<CommandList, QueueCapacity> queue;
+    u64 submitted_lists{};
+    std::atomic<u64> completed_lists{};
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+    std::jthread thread;
+
+    explicit Impl(const std::unique_ptr<Core::PerfStats>& perf_stats_, Pica::PicaCore& pica_)
+        : perf_stats{perf_stats_}, pica{pica_} {
+        thread = std::jthread([this](std::stop_token stop_token) { ThreadLoop(stop_token); });
+    }
+
+    bool IsIdle() const {
+        return completed_lists.load(std::memory_order::acquire) == submitted_lists;
+    }
+
+    void ThreadLoop(std::stop_token stop_token) {
+        Common::SetCurrentThreadRole(Common::ThreadRole::Render, "GPUThread");
+        MicroProfileOnThreadCreate("GPUThread");
+
+        while (!stop_token.stop_requested()) {
+            CommandList list{};
+            queue.PopWait(list, stop_token);
+            if (stop_token.stop_requested()) {
+                break;
+            }
+
+            if (list.task) {
+                list.task();
+            } else {
+                MICROPROFILE_SCOPE(GPU_ThreadCmdlist);
+                Core::PerfStats::ScopedFrameTimer timer{perf_stats.get(),
+                                                        Core::PerfStats::FrameTimer::GpuCommands};
+                pica.ProcessCmdList(list.addr, list.size);
+            }
+
+            {
+                std::scoped_lock lock{idle_mutex};
+                completed_lists.fetch_add(1, std::memory_order::release);
+            }
+            idle_cv.notify_all();
+        }
+    }
+};
+
+GPUThread::GPUThread(const std::unique_ptr<Core::PerfStats>& perf_stats, Pica::PicaCore& pica)
+    : impl{std::make_unique<Impl>(perf_stats, pica)} {}
+
+GPUThread::~GPUThread() = default;
+
+void GPUThread::SubmitList(PAddr addr, u32 size) {
+    ++impl->submitted_lists;
+    impl->queue.EmplaceWait(Impl::CommandList{addr, size, {}});
+}
+
+void GPUThread::SubmitTask(std::function<void()> task) {
+    ++impl->submitted_lists;
+    impl->queue.EmplaceWait(Impl::CommandList{0, 0, std::move(task)});
+}
+
+void GPUThread::WaitIdle() {
+    if (IsGPUThread() || impl->IsIdle()) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(GPU_ThreadWaitIdle);
+    std::unique_lock lock{impl->idle_mutex};
+    impl->idle_cv.wait(lock, [this] { return impl->IsIdle(); });
+}
+
+bool GPUThread::IsIdle() const {
+    return impl->IsIdle();
+}
+
+bool GPUThread::IsGPUThread() const {
+    return std::this_thread::get_id() == impl->thread.get_id();
+}
+
+} // namespace VideoCore
@@ -0,0 +1,53 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "common/common_types.h"
+
+namespace Core {
+class PerfStats;
+}
+
+namespace Pica {
+class PicaCore;
+}
+
+namespace VideoCore {
+
+/**
+ * The GPUThread processes PICA command lists on a dedicated host thread so that register
+ * syncing, shader setup and draw submission overlap with ARM11 emulation. Other GPU work, like
+ * memory fills and transfers, can be queued behind the lists it depends on. Every operation
+ * that touches GPU state from the emulation thread must call WaitIdle first.
+ */
+class GPUThread {
+public:
+    explicit GPUThread(const std::unique_ptr<Core::PerfStats>& perf_stats, Pica::PicaCore& pica);
+    ~GPUThread();
+
+    /// Queues a command list for processing on the GPU thread.
+    void SubmitList(PAddr addr, u32 size);
+
+    /// Queues a task to run on the GPU thread once the work queued before it is processed.
+    void SubmitTask(std::function<void()> task);
+
+    /// Blocks until all queued command lists have been processed.
+    void WaitIdle();
+
+    /// Returns true if all queued command lists have been processed.
+    [[nodiscard]] bool IsIdle() const;
+
+    /// Returns true when called from the GPU thread itself.
+    [[nodiscard]] bool IsGPUThread() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace VideoCore
@@ -0,0 +1,115 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+//? #version 430 core
+
+// Reads a texel of the source surface, packs it into the bits the PICA stores in memory and
+// unpacks those as a texel of the destination format. Color destinations are written to the
+// color attachment, depth ones to the depth attachment. The stencil of a D24S8 destination is
+// written one bit per draw, the draws discarding the texels without the bit set.
+
+precision highp int;
+precision highp float;
+
+layout(location = 0) in mediump vec2 tex_coord;
+layout(location = 0) out lowp vec4 frag_color;
+
+layout(binding = 0) uniform highp sampler2D source;
+layout(binding = 1) uniform lowp usampler2D stencil;
+
+layout(location = 2) uniform int src_format;
+layout(location = 3) uniform int dst_format;
+layout(location = 4) uniform int stencil_bit;
+
+// Must match VideoCore::PixelFormat
+const int FORMAT_RGBA8 = 0;
+const int FORMAT_RGB8 = 1;
+const int FORMAT_RGB5A1 = 2;
+const int FORMAT_RGB565 = 3;
+const int FORMAT_RGBA4 = 4;
+const int FORMAT_IA8 = 5;
+const int FORMAT_RG8 = 6;
+const int FORMAT_D16 = 14;
+const int FORMAT_D24 = 16;
+const int FORMAT_D24S8 = 17;
+
+uint Quantize(float value, int bits) {
+    return uint(round(clamp(value, 0.0, 1.0) * (exp2(float(bits)) - 1.0)));
+}
+
+float Normalize(uint value, int offset, int bits) {
+    return float(bitfieldExtract(value, offset, bits)) / (exp2(float(bits)) - 1.0);
+}
+
+uint Encode(vec4 color, uint stencil_val) {
+    switch (src_format) {
+    case FORMAT_RGBA8:
+        return (Quantize(color.r, 8) << 24) | (Quantize(color.g, 8) << 16) |
+               (Quantize(color.b, 8) << 8) | Quantize(color.a, 8);
+    case FORMAT_RGB8:
+        return (Quantize(color.r, 8) << 16) | (Quantize(color.g, 8) << 8) | Quantize(color.b, 8);
+    case FORMAT_RGB5A1:
+        return (Quantize(color.r, 5) << 11) | (Quantize(color.g, 5) << 6) |
+               (Quantize(color.b, 5) << 1) | Quantize(color.a, 1);
+    case FORMAT_RGB565:
+        return (Quantize(color.r, 5) << 11) | (Quantize(color.g, 6) << 5) | Quantize(color.b, 5);
+    case FORMAT_RGBA4:
+        return (Quantize(color.r, 4) << 12) | (Quantize(color.g, 4) << 8) |
+               (Quantize(color.b, 4) << 4) | Quantize(color.a, 4);
+    case FORMAT_IA8:
+        return (Quantize(color.r, 8) << 8) | Quantize(color.a, 8);
+    case FORMAT_RG8:
+        return (Quantize(color.r, 8) << 8) | Quantize(color.g, 8);
+    case FORMAT_D16:
+        return Quantize(color.r, 16);
+    case FORMAT_D24:
+        return Quantize(color.r, 24);
+    case FORMAT_D24S8:
+        return (stencil_val << 24) | Quantize(color.r, 24);
+    default:
+        return 0u;
+    }
+}
+
+vec4 Decode(uint value) {
+    switch (dst_format) {
+    case FORMAT_RGBA8:
+        return vec4(Normalize(value, 24, 8), Normalize(value, 16, 8), Normalize(value, 8, 8),
+                    Normalize(value, 0, 8));
+    case FORMAT_RGB8:
+        return vec4(Normalize(value, 16, 8), Normalize(value, 8, 8), Normalize(value, 0, 8), 1.0);
+    case FORMAT_RGB5A1:
+        return vec4(Normalize(value, 11, 5), Normalize(value, 6, 5), Normalize(value, 1, 5),
+                    Normalize(value, 0, 1));
+    case FORMAT_RGB565:
+        return vec4(Normalize(value, 11, 5), Normalize(value, 5, 6), Normalize(value, 0, 5), 1.0);
+    case FORMAT_RGBA4:
+        return vec4(Normalize(value, 12, 4), Normalize(value, 8, 4), Normalize(value, 4, 4),
+                    Normalize(value, 0, 4));
+    case FORMAT_IA8:
+        return vec4(vec3(Normalize(value, 8, 8)), Normalize(value, 0, 8));
+    case FORMAT_RG8:
+        return vec4(Normalize(value, 8, 8), Normalize(value, 0, 8), 0.0, 1.0);
+    case FORMAT_D16:
+        return vec4(Normalize(value, 0, 16));
+    case FORMAT_D24:
+    case FORMAT_D24S8:
+        return vec4(Normalize(value, 0, 24));
+    default:
+        return vec4(0.0);
+    }
+}
+
+void main() {
+    mediump vec2 coord = tex_coord * vec2(textureSize(source, 0));
+    mediump ivec2 tex_icoord = ivec2(coord);
+    lowp uint stencil_val = src_format == FORMAT_D24S8 ? texelFetch(stencil, tex_icoord, 0).x : 0u;
+    highp uint value = Encode(texelFetch(source, tex_icoord, 0), stencil_val);
+    if (stencil_bit >= 0 && bitfieldExtract(value, 24 + stencil_bit, 1) == 0u) {
+        discard;
+    }
+    highp vec4 texel = Decode(value);
+    frag_color = texel;
+    gl_FragDepth = texel.x;
+}
@@ -0,0 +1,179 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#version 450 core
+#extension GL_ARB_separate_shader_objects : enable
+
+// Edge adaptive spatial upscaler modelled after AMD FidelityFX Super Resolution 1 EASU, with an
+// optional contrast limited sharpening step in place of a separate RCAS pass.
+
+layout (location = 0) in vec2 frag_tex_coord;
+layout (location = 0) out vec4 color;
+
+layout (push_constant, std140) uniform DrawInfo {
+    mat4 modelview_matrix;
+    vec4 i_resolution;
+    vec4 o_resolution;
+    int screen_id_l;
+    int screen_id_r;
+    int layer;
+    int reverse_interlaced;
+    float sharpness;
+};
+
+layout (set = 0, binding = 0) uniform sampler2D screen_textures[4];
+
+ivec2 tex_size;
+
+// Not all vulkan drivers support shaderSampledImageArrayDynamicIndexing, so index manually.
+ivec2 ScreenSize() {
+    switch (screen_id_l) {
+    case 0:
+        return textureSize(screen_textures[0], 0);
+    case 1:
+        return textureSize(screen_textures[1], 0);
+    case 2:
+        return textureSize(screen_textures[2], 0);
+    case 3:
+        return textureSize(screen_textures[3], 0);
+    }
+}
+
+vec4 SampleScreen(vec2 coord) {
+    switch (screen_id_l) {
+    case 0:
+        return texture(screen_textures[0], coord);
+    case 1:
+        return texture(screen_textures[1], coord);
+    case 2:
+        return texture(screen_textures[2], coord);
+    case 3:
+        return texture(screen_textures[3], coord);
+    }
+}
+
+vec3 Fetch(ivec2 base, int x, int y) {
+    const ivec2 coord = clamp(base + ivec2(x, y), ivec2(0), tex_size - 1);
+    switch (screen_id_l) {
+    case 0:
+        return texelFetch(screen_textures[0], coord, 0).rgb;
+    case 1:
+        return texelFetch(screen_textures[1], coord, 0).rgb;
+    case 2:
+        return texelFetch(screen_textures[2], coord, 0).rgb;
+    case 3:
+        return texelFetch(screen_textures[3], coord, 0).rgb;
+    }
+}
+
+float Luma(vec3 c) {
+    return c.b * 0.5 + (c.r * 0.5 + c.g);
+}
+
+// Accumulates the gradient direction and edge strength around a center texel, weighted by its
+// bilinear weight.
+void AddGradient(inout vec2 dir, inout float len, float w, float up, float left, float center,
+                 float right, float down) {
+    float edge_x = max(abs(right - center), abs(center - left));
+    float dir_x = right - left;
+    float len_x = edge_x > 0.0 ? clamp(abs(dir_x) / edge_x, 0.0, 1.0) : 0.0;
+    dir.x += dir_x * w;
+    len += len_x * len_x * w;
+
+    float edge_y = max(abs(down - center), abs(center - up));
+    float dir_y = down - up;
+    float len_y = edge_y > 0.0 ? clamp(abs(dir_y) / edge_y, 0.0, 1.0) : 0.0;
+    dir.y += dir_y * w;
+    len += len_y * len_y * w;
+}
+
+// Polynomial approximation of a Lanczos2 lobe, takes the squared distance to the tap.
+void AddTap(inout vec3 sum, inout float weight_sum, vec2 offset, vec2 dir, vec2 len2, float lobe,
+            float clip, vec3 tap) {
+    vec2 v = vec2(offset.x * dir.x + offset.y * dir.y, offset.x * -dir.y + offset.y * dir.x);
+    v *= len2;
+    float d2 = min(dot(v, v), clip);
+    float base = (2.0 / 5.0) * d2 - 1.0;
+    float window = lobe * d2 - 1.0;
+    float w = (25.0 / 16.0 * base * base - (25.0 / 16.0 - 1.0)) * window * window;
+    sum += tap * w;
+    weight_sum += w;
+}
+
+void main() {
+    tex_size = ScreenSize();
+    vec2 texels_per_pixel = fwidth(frag_tex_coord * vec2(tex_size));
+    vec4 bilinear = SampleScreen(frag_tex_coord);
+    if (max(texels_per_pixel.x, texels_per_pixel.y) >= 1.0) {
+        // Nothing to reconstruct when the screen is drawn at or below its resolution.
+        color = bilinear;
+        return;
+    }
+
+    vec2 pp = frag_tex_coord * vec2(tex_size) - 0.5;
+    vec2 fp = floor(pp);
+    pp -= fp;
+    ivec2 base = ivec2(fp);
+
+    //    b c
+    //  e f g h
+    //  i j k l
+    //    n o
+    vec3 b = Fetch(base, 0, -1);
+    vec3 c = Fetch(base, 1, -1);
+    vec3 e = Fetch(base, -1, 0);
+    vec3 f = Fetch(base, 0, 0);
+    vec3 g = Fetch(base, 1, 0);
+    vec3 h = Fetch(base, 2, 0);
+    vec3 i = Fetch(base, -1, 1);
+    vec3 j = Fetch(base, 0, 1);
+    vec3 k = Fetch(base, 1, 1);
+    vec3 l = Fetch(base, 2, 1);
+    vec3 n = Fetch(base, 0, 2);
+    vec3 o = Fetch(base, 1, 2);
+
+    float lb = Luma(b), lc = Luma(c), le = Luma(e), lf = Luma(f), lg = Luma(g), lh = Luma(h);
+    float li = Luma(i), lj = Luma(j), lk = Luma(k), ll = Luma(l), ln = Luma(n), lo = Luma(o);
+
+    vec2 dir = vec2(0.0);
+    float len = 0.0;
+    AddGradient(dir, len, (1.0 - pp.x) * (1.0 - pp.y), lb, le, lf, lg, lj);
+    AddGradient(dir, len, pp.x * (1.0 - pp.y), lc, lf, lg, lh, lk);
+    AddGradient(dir, len, (1.0 - pp.x) * pp.y, lf, li, lj, lk, ln);
+    AddGradient(dir, len, pp.x * pp.y, lg, lj, lk, ll, lo);
+
+    // Stretch the kernel along edges and sharpen its lobe the stronger the edge is.
+    float dir_r = dot(dir, dir);
+    dir = dir_r < 1.0 / 32768.0 ? vec2(1.0, 0.0) : dir * inversesqrt(dir_r);
+    len = len * 0.5;
+    len *= len;
+    float stretch = dot(dir, dir) / max(abs(dir.x), abs(dir.y));
+    vec2 len2 = vec2(1.0 + (stretch - 1.0) * len, 1.0 - 0.5 * len);
+    float lobe = 0.5 + ((1.0 / 4.0 - 0.04) - 0.5) * len;
+    float clip = 1.0 / lobe;
+
+    vec3 sum = vec3(0.0);
+    float weight_sum = 0.0;
+    AddTap(sum, weight_sum, vec2(0.0, -1.0) - pp, dir, len2, lobe, clip, b);
+    AddTap(sum, weight_sum, vec2(1.0, -1.0) - pp, dir, len2, lobe, clip, c);
+    AddTap(sum, weight_sum, vec2(-1.0, 1.0) - pp, dir, len2, lobe, clip, i);
+    AddTap(sum, weight_sum, vec2(0.0, 1.0) - pp, dir, len2, lobe, clip, j);
+    AddTap(sum, weight_sum, vec2(0.0, 0.0) - pp, dir, len2, lobe, clip, f);
+    AddTap(sum, weight_sum, vec2(-1.0, 0.0) - pp, dir, len2, lobe, clip, e);
+    AddTap(sum, weight_sum, vec2(1.0, 1.0) - pp, dir, len2, lobe, clip, k);
+    AddTap(sum, weight_sum, vec2(2.0, 1.0) - pp, dir, len2, lobe, clip, l);
+    AddTap(sum, weight_sum, vec2(2.0, 0.0) - pp, dir, len2, lobe, clip, h);
+    AddTap(sum, weight_sum, vec2(1.0, 0.0) - pp, dir, len2, lobe, clip, g);
+    AddTap(sum, weight_sum, vec2(1.0, 2.0) - pp, dir, len2, lobe, clip, o);
+    AddTap(sum, weight_sum, vec2(0.0, 2.0) - pp, dir, len2, lobe, clip, n);
+
+    // Deringing: the result never leaves the range of the nearest texels.
+    vec3 min4 = min(min(f, g), min(j, k));
+    vec3 max4 = max(max(f, g), max(j, k));
+    vec3 upscaled = clamp(sum / weight_sum, min4, max4);
+
+    // Push the result away from the bilinear estimate, limited to the same range.
+    upscaled = clamp(upscaled + (upscaled - bilinear.rgb) * sharpness, min4, max4);
+    color = vec4(upscaled, bilinear.a);
+}
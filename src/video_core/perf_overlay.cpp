@@ -0,0 +1,161 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <fmt/format.h>
+#include "video_core/perf_overlay.h"
+
+namespace VideoCore {
+
+namespace {
+
+using FrameTimer = Core::PerfStats::FrameTimer;
+using FrameCounter = Core::PerfStats::FrameCounter;
+
+/// Characters of the font, lowercase letters are drawn as uppercase ones
+constexpr std::string_view FontCharacters = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.:%/-";
+
+/// 5x7 glyphs of FontCharacters, one byte per row with the leftmost pixel in bit 4
+constexpr std::array<std::array<u8, 7>, FontCharacters.size()> FontGlyphs = {{
+    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // 0
+    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 1
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // 2
+    {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // 3
+    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // 4
+    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // 5
+    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // 6
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // 7
+    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // 8
+    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // 9
+    {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11}, // A
+    {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // B
+    {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // C
+    {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // D
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // E
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // F
+    {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // G
+    {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // H
+    {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // I
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // J
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // K
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // L
+    {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // M
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // N
+    {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // O
+    {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // P
+    {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // Q
+    {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // R
+    {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // S
+    {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // T
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // U
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // V
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // W
+    {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // X
+    {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // Y
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // Z
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, // .
+    {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}, // :
+    {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // %
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // /
+    {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, // -
+}};
+
+constexpr std::array<u8, 4> TextColor = {0xFF, 0xFF, 0xFF, 0xFF};
+constexpr std::array<u8, 4> BackgroundColor = {0x18, 0x18, 0x18, 0xFF};
+
+double ToMilliseconds(Core::PerfStats::Clock::duration time, u32 num_frames) {
+    return std::chrono::duration<double, std::milli>(time).count() / num_frames;
+}
+
+} // Anonymous namespace
+
+PerfOverlay::PerfOverlay() : pixels(Width * Height * 4) {
+    for (std::size_t i = 0; i < pixels.size(); i += 4) {
+        std::copy(BackgroundColor.begin(), BackgroundColor.end(), pixels.begin() + i);
+    }
+}
+
+PerfOverlay::~PerfOverlay() = default;
+
+bool PerfOverlay::AddFrame(const Core::PerfStats::FrameStats& stats) {
+    const auto now = Clock::now();
+    // After a pause or while the overlay was hidden, start over instead of averaging the gap
+    if (now - last_frame > RefreshInterval) {
+        last_refresh = now - RefreshInterval;
+        num_frames = 0;
+        frametime = {};
+        times = {};
+        counts = {};
+    }
+    last_frame = now;
+
+    num_frames++;
+    frametime += stats.frametime;
+    for (std::size_t i = 0; i < times.size(); i++) {
+        times[i] += stats.times[i];
+    }
+    for (std::size_t i = 0; i < counts.size(); i++) {
+        counts[i] += stats.counts[i];
+    }
+    audio_fill = stats.audio_fill;
+
+    const auto elapsed = now - last_refresh;
+    if (elapsed < RefreshInterval) {
+        return false;
+    }
+    Redraw(elapsed);
+    last_refresh = now;
+    num_frames = 0;
+    frametime = {};
+    times = {};
+    counts = {};
+    return true;
+}
+
+void PerfOverlay::Redraw(Clock::duration elapsed) {
+    const auto time = [this](FrameTimer timer) {
+        return ToMilliseconds(times[static_cast<std::size_t>(timer)], num_frames);
+    };
+    const auto count = [this](FrameCounter counter) {
+        return counts[static_cast<std::size_t>(counter)];
+    };
+    const double fps = num_frames / std::chrono::duration<double>(elapsed).count();
+
+    DrawLine(0, fmt::format("FPS {:5.1f}  FRAME {:6.2f} MS", fps,
+                            ToMilliseconds(frametime, num_frames)));
+    DrawLine(1, fmt::format("CPU       {:6.2f} MS", time(FrameTimer::CpuSlices)));
+    DrawLine(2, fmt::format("GPU CMD   {:6.2f} MS", time(FrameTimer::GpuCommands)));
+    DrawLine(3, fmt::format("GPU EXEC  {:6.2f} MS", time(FrameTimer::GpuExecution)));
+    DrawLine(4, fmt::format("PRESENT   {:6.2f} MS", time(FrameTimer::PresentWait)));
+    DrawLine(5, fmt::format("AUDIO     {:6.1f} MS", audio_fill * 1000.0));
+    DrawLine(6, fmt::format("SHADERS {:4}  PIPELINES {:4}", count(FrameCounter::ShaderCompiles),
+                            count(FrameCounter::PipelineCompiles)));
+    DrawLine(7, fmt::format("FLUSHES {:4}  DOWNLOADS {:4}", count(FrameCounter::CacheFlushes),
+                            count(FrameCounter::CacheDownloads)));
+}
+
+void PerfOverlay::DrawLine(u32 line, std::string_view text) {
+    const u32 top = Padding + line * CellHeight;
+    for (u32 column = 0; column < NumColumns; column++) {
+        const char c = column < text.size() ? text[column] : ' ';
+        const std::size_t glyph =
+            FontCharacters.find(static_cast<char>(c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c));
+        const u32 left = Padding + column * CellWidth;
+        for (u32 y = 0; y < GlyphHeight; y++) {
+            const u8 row = glyph == std::string_view::npos ? 0 : FontGlyphs[glyph][y];
+            for (u32 x = 0; x < GlyphWidth; x++) {
+                SetPixel(left + x, top + y, (row >> (GlyphWidth - 1 - x)) & 1);
+            }
+        }
+    }
+}
+
+void PerfOverlay::SetPixel(u32 x, u32 y, bool is_set) {
+    // The screens are stored rotated, each column of the window is a row of the texture
+    const std::size_t offset = (static_cast<std::size_t>(x) * Height + (Height - 1 - y)) * 4;
+    const auto& color = is_set ? TextColor : BackgroundColor;
+    std::copy(color.begin(), color.end(), pixels.begin() + offset);
+}
+
+} // namespace VideoCore
@@ -0,0 +1,77 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "common/common_types.h"
+#include "core/perf_stats.h"
+
+namespace VideoCore {
+
+/**
+ * Draws a breakdown of the recent frames into a small RGBA8 image that the renderers show on top
+ * of the emulated screens. The text is rasterized on the CPU with a built-in bitmap font, so the
+ * overlay works the same in every frontend. To stay readable the image is only redrawn a few
+ * times per second, with the times averaged and the events summed over the frames in between.
+ * The image is stored rotated like the 3DS framebuffers, so that it is drawn like a screen.
+ */
+class PerfOverlay {
+    static constexpr u32 GlyphWidth = 5;
+    static constexpr u32 GlyphHeight = 7;
+    static constexpr u32 CellWidth = GlyphWidth + 1;
+    static constexpr u32 CellHeight = GlyphHeight + 2;
+    static constexpr u32 Padding = 4;
+    static constexpr u32 NumColumns = 28;
+    static constexpr u32 NumLines = 8;
+
+public:
+    /// Size of the image as shown on the window, before scaling
+    static constexpr u32 Width = NumColumns * CellWidth + Padding * 2;
+    static constexpr u32 Height = NumLines * CellHeight + Padding * 2;
+
+    /// Time over which the frames are summarized
+    static constexpr std::chrono::milliseconds RefreshInterval{250};
+
+    PerfOverlay();
+    ~PerfOverlay();
+
+    /**
+     * Accumulates the breakdown of a frame.
+     * @returns True if the image was redrawn and has to be uploaded again
+     */
+    bool AddFrame(const Core::PerfStats::FrameStats& stats);
+
+    /// Returns the pixels of the image, Height texels wide and Width texels tall
+    [[nodiscard]] std::span<const u8> Pixels() const noexcept {
+        return pixels;
+    }
+
+    /// Returns the integer scale the image is shown at in a window of the given height
+    [[nodiscard]] static u32 GetScale(u32 window_height) noexcept {
+        return window_height < 720 ? 1 : window_height / 360;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void Redraw(Clock::duration elapsed);
+    void DrawLine(u32 line, std::string_view text);
+    void SetPixel(u32 x, u32 y, bool is_set);
+
+    std::vector<u8> pixels;
+    Clock::time_point last_refresh{};
+    Clock::time_point last_frame{};
+    u32 num_frames{};
+    Core::PerfStats::Clock::duration frametime{};
+    std::array<Core::PerfStats::Clock::duration, Core::PerfStats::NumFrameTimers> times{};
+    std::array<u32, Core::PerfStats::NumFrameCounters> counts{};
+    double audio_fill{};
+};
+
+} // namespace VideoCore
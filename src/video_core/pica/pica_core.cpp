@@ -4,20 +4,43 @@
 
 #include "common/arch.h"
 #include "common/archives.h"
+#include "common/hash.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "core/core.h"
 #include "core/memory.h"
+#include "core/tracer/recorder.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/pica/pica_core.h"
 #include "video_core/pica/vertex_loader.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/shader/shader.h"
+#include "video_core/texture/texture_decode.h"
 
 namespace Pica {
 
 MICROPROFILE_DEFINE(GPU_Drawing, "GPU", "Drawing", MP_RGB(50, 50, 240));
+MICROPROFILE_DEFINE(GPU_ParallelVS, "GPU", "Parallel Vertex Shading", MP_RGB(100, 100, 240));
+
+/// Minimum number of vertices shaded by a single worker task.
+constexpr u32 MinVerticesPerTask = 256;
+
+/// Number of vertices handed to the shader engine in a single call.
+constexpr u32 VerticesPerShaderBatch = 16;
+
+/// Maximum number of immediate mode vertices drawn at once, whole triangles of a list.
+constexpr std::size_t MaxImmediateBatch = 3 * 256;
+
+/// Maximum number of command lists kept decoded, the cache is emptied when it grows past it.
+constexpr std::size_t MaxCachedCmdLists = 1024;
+
+// Expand a 4-bit mask to 4-byte mask, e.g. 0b0101 -> 0x00FF00FF
+constexpr std::array<u32, 16> ExpandBitsToBytes = {
+    0x00000000, 0x000000ff, 0x0000ff00, 0x0000ffff, 0x00ff0000, 0x00ff00ff,
+    0x00ffff00, 0x00ffffff, 0xff000000, 0xff0000ff, 0xff00ff00, 0xff00ffff,
+    0xffff0000, 0xffff00ff, 0xffffff00, 0xffffffff,
+};
 
 using namespace DebugUtils;
 
@@ -30,6 +53,43 @@ union CommandHeader {
 };
 static_assert(sizeof(CommandHeader) == sizeof(u32), "CommandHeader has incorrect size!");
 
+/**
+ * Registers whose writes do more than store the value, handled by the switch in
+ * WriteInternalReg. Writes to every other register only need their final value.
+ */
+constexpr std::array<bool, RegsInternal::NUM_REGS> RegHasSideEffects = [] {
+    std::array<bool, RegsInternal::NUM_REGS> table{};
+    const auto mark = [&table](std::size_t first, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            table[first + i] = true;
+        }
+    };
+
+    mark(PICA_REG_INDEX(trigger_irq), 1);
+    mark(PICA_REG_INDEX(pipeline.triangle_topology), 1);
+    mark(PICA_REG_INDEX(pipeline.restart_primitive), 1);
+    mark(PICA_REG_INDEX(pipeline.vs_default_attributes_setup.index), 1);
+    mark(PICA_REG_INDEX(pipeline.vs_default_attributes_setup.set_value[0]), 3);
+    mark(PICA_REG_INDEX(pipeline.command_buffer.trigger[0]), 2);
+    mark(PICA_REG_INDEX(pipeline.trigger_draw), 1);
+    mark(PICA_REG_INDEX(pipeline.trigger_draw_indexed), 1);
+    mark(PICA_REG_INDEX(gs.bool_uniforms), 1);
+    mark(PICA_REG_INDEX(gs.int_uniforms[0]), 4);
+    mark(PICA_REG_INDEX(gs.uniform_setup.set_value[0]), 8);
+    mark(PICA_REG_INDEX(gs.program.set_word[0]), 8);
+    mark(PICA_REG_INDEX(gs.swizzle_patterns.set_word[0]), 8);
+    mark(PICA_REG_INDEX(vs.output_mask), 1);
+    mark(PICA_REG_INDEX(vs.bool_uniforms), 1);
+    mark(PICA_REG_INDEX(vs.int_uniforms[0]), 4);
+    mark(PICA_REG_INDEX(vs.uniform_setup.set_value[0]), 8);
+    mark(PICA_REG_INDEX(vs.program.set_word[0]), 8);
+    mark(PICA_REG_INDEX(vs.swizzle_patterns.set_word[0]), 8);
+    mark(PICA_REG_INDEX(lighting.lut_data[0]), 8);
+    mark(PICA_REG_INDEX(texturing.fog_lut_data[0]), 8);
+    mark(PICA_REG_INDEX(texturing.proctex_lut_data[0]), 8);
+    return table;
+}();
+
 PicaCore::PicaCore(Memory::MemorySystem& memory_, std::shared_ptr<DebugContext> debug_context_)
     : memory{memory_}, debug_context{std::move(debug_context_)}, geometry_pipeline{regs.internal,
                                                                                    gs_unit,
@@ -38,12 +98,8 @@ PicaCore::PicaCore(Memory::MemorySystem& memory_, std::shared_ptr<DebugContext>
     InitializeRegs();
 
     const auto submit_vertex = [this](const AttributeBuffer& buffer) {
-        const auto add_triangle = [this](const OutputVertex& v0, const OutputVertex& v1,
-                                         const OutputVertex& v2) {
-            rasterizer->AddTriangle(v0, v1, v2);
-        };
         const auto vertex = OutputVertex(regs.internal.rasterizer, buffer);
-        primitive_assembler.SubmitVertex(vertex, add_triangle);
+        primitive_assembler.SubmitVertex(vertex, triangle_batch);
     };
 
     gs_unit.SetVertexHandlers(submit_vertex, [this]() { primitive_assembler.SetWinding(); });
@@ -93,10 +149,46 @@ void PicaCore::SetInterruptHandler(Service::GSP::InterruptHandler& signal_interr
 }
 
 void PicaCore::ProcessCmdList(PAddr list, u32 size) {
+    RecordMemory(list, size);
+
     // Initialize command list tracking.
     const u8* head = memory.GetPhysicalPointer(list);
     cmd_list.Reset(list, head, size);
 
+    // The debugger and the tracer observe each write
+    if (debug_context || DebugUtils::IsPicaTracing()) {
+        ExecuteCmdList();
+        return;
+    }
+
+    // Static scenes and menus submit the same lists every frame. Hashing a list is much cheaper
+    // than decoding it, and catches every change to it the CPU or a DMA made meanwhile.
+    const u64 hash = Common::ComputeFastHash64(head, size);
+    const u64 key = (static_cast<u64>(list) << 32) | size;
+    if (cmd_list_cache.size() >= MaxCachedCmdLists && !cmd_list_cache.contains(key)) {
+        cmd_list_cache.clear();
+    }
+    CachedCmdList& cached = cmd_list_cache[key];
+    if (cached.hash != hash) {
+        // Lists that change every frame are not worth decoding
+        cached.hash = hash;
+        cached.state = CachedCmdList::State::Seen;
+        cached.writes.clear();
+        ExecuteCmdList();
+        return;
+    }
+    if (cached.state == CachedCmdList::State::Seen) {
+        cached.state = DecodeCmdList(cached.writes) ? CachedCmdList::State::Decoded
+                                                    : CachedCmdList::State::Uncached;
+    }
+    if (cached.state == CachedCmdList::State::Uncached) {
+        ExecuteCmdList();
+        return;
+    }
+    ReplayCmdList(cached.writes);
+}
+
+void PicaCore::ExecuteCmdList() {
     while (cmd_list.current_index < cmd_list.length) {
         // Align read pointer to 8 bytes
         if (cmd_list.current_index % 2 != 0) {
@@ -107,6 +199,18 @@ void PicaCore::ProcessCmdList(PAddr list, u32 size) {
         const u32 value = cmd_list.head[cmd_list.current_index++];
         const CommandHeader header{cmd_list.head[cmd_list.current_index++]};
 
+        // Repeated writes with the same mask to a register without side effects leave only the
+        // last value behind, so a single write of it is enough unless someone observes each one.
+        const u32 id = header.cmd_id;
+        if (header.extra_data_length != 0 && !header.group_commands &&
+            id < RegsInternal::NUM_REGS && !RegHasSideEffects[id] && !debug_context &&
+            !DebugUtils::IsPicaTracing()) {
+            cmd_list.current_index += header.extra_data_length;
+            WriteInternalReg(id, cmd_list.head[cmd_list.current_index - 1],
+                             header.parameter_mask);
+            continue;
+        }
+
         // Write to the requested PICA register.
         WriteInternalReg(header.cmd_id, value, header.parameter_mask);
 
@@ -117,6 +221,90 @@ void PicaCore::ProcessCmdList(PAddr list, u32 size) {
             WriteInternalReg(cmd, extra_value, header.parameter_mask);
         }
     }
+
+    // Nothing observes the vertices batched by the list before it completes.
+    DrawImmediate();
+}
+
+bool PicaCore::DecodeCmdList(std::vector<DecodedWrite>& writes) const {
+    static constexpr u32 NoWrite = std::numeric_limits<u32>::max();
+    writes.clear();
+
+    // Writes without side effects since the last one with, merged into one per register as
+    // nothing reads the registers in between. Their index in writes is kept per register.
+    std::array<u32, RegsInternal::NUM_REGS> state_writes;
+    state_writes.fill(NoWrite);
+    std::size_t run_start = 0;
+
+    const auto decode_write = [&](u32 id, u32 value, u32 mask) {
+        if (id >= RegsInternal::NUM_REGS || RegHasSideEffects[id]) {
+            if (id == PICA_REG_INDEX(pipeline.command_buffer.trigger[0]) ||
+                id == PICA_REG_INDEX(pipeline.command_buffer.trigger[1])) {
+                return false;
+            }
+            writes.push_back({id, value, mask, true});
+            run_start = writes.size();
+            return true;
+        }
+        const u32 write_mask = ExpandBitsToBytes[mask];
+        u32& index = state_writes[id];
+        if (index == NoWrite || index < run_start) {
+            index = static_cast<u32>(writes.size());
+            writes.push_back({id, value & write_mask, write_mask, false});
+        } else {
+            DecodedWrite& write = writes[index];
+            write.value = (write.value & ~write_mask) | (value & write_mask);
+            write.mask |= write_mask;
+        }
+        return true;
+    };
+
+    // Walks the list like ExecuteCmdList
+    u32 current_index = 0;
+    while (current_index < cmd_list.length) {
+        if (current_index % 2 != 0) {
+            current_index++;
+        }
+        const u32 value = cmd_list.head[current_index++];
+        const CommandHeader header{cmd_list.head[current_index++]};
+        if (!decode_write(header.cmd_id, value, header.parameter_mask)) {
+            return false;
+        }
+        for (u32 i = 0; i < header.extra_data_length; ++i) {
+            const u32 cmd = header.cmd_id + (header.group_commands ? i + 1 : 0);
+            if (!decode_write(cmd, cmd_list.head[current_index++], header.parameter_mask)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void PicaCore::ReplayCmdList(std::span<const DecodedWrite> writes) {
+    std::size_t i = 0;
+    while (i < writes.size()) {
+        if (writes[i].has_side_effects) {
+            WriteInternalReg(writes[i].id, writes[i].value, writes[i].mask);
+            i++;
+            continue;
+        }
+
+        // The run of state writes leaves the registers as the writes one at a time would, and the
+        // rasterizer syncs its state from them once per register instead of once per write.
+        DrawImmediate();
+        const std::size_t first = i;
+        for (; i < writes.size() && !writes[i].has_side_effects; i++) {
+            u32& reg = regs.internal.reg_array[writes[i].id];
+            reg = (reg & ~writes[i].mask) | writes[i].value;
+        }
+        for (std::size_t j = first; j < i; j++) {
+            rasterizer->NotifyPicaRegisterChanged(writes[j].id);
+        }
+    }
+    cmd_list.current_index = cmd_list.length;
+
+    // Nothing observes the vertices batched by the list before it completes.
+    DrawImmediate();
 }
 
 void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
@@ -128,12 +316,13 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         return;
     }
 
-    // Expand a 4-bit mask to 4-byte mask, e.g. 0b0101 -> 0x00FF00FF
-    constexpr std::array<u32, 16> ExpandBitsToBytes = {
-        0x00000000, 0x000000ff, 0x0000ff00, 0x0000ffff, 0x00ff0000, 0x00ff00ff,
-        0x00ffff00, 0x00ffffff, 0xff000000, 0xff0000ff, 0xff00ff00, 0xff00ffff,
-        0xffff0000, 0xffff00ff, 0xffffff00, 0xffffffff,
-    };
+    // Batched immediate mode vertices are drawn with the state they were submitted with.
+    const bool is_immediate_data =
+        id >= PICA_REG_INDEX(pipeline.vs_default_attributes_setup.set_value[0]) &&
+        id <= PICA_REG_INDEX(pipeline.vs_default_attributes_setup.set_value[2]);
+    if (!is_immediate_data) {
+        DrawImmediate();
+    }
 
     // TODO: Figure out how register masking acts on e.g. vs.uniform_setup.set_value
     const u32 old_value = regs.internal.reg_array[id];
@@ -149,6 +338,12 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         SCOPE_EXIT({ debug_context->OnEvent(DebugContext::Event::PicaCommandProcessed, &id); });
     }
 
+    // Most writes only update state, which the rasterizer picks up below.
+    if (!RegHasSideEffects[id]) {
+        rasterizer->NotifyPicaRegisterChanged(id);
+        return;
+    }
+
     switch (id) {
     // Trigger IRQ
     case PICA_REG_INDEX(trigger_irq):
@@ -184,6 +379,7 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         const PAddr addr = regs.internal.pipeline.command_buffer.GetPhysicalAddress(index);
         const u32 size = regs.internal.pipeline.command_buffer.GetSize(index);
         const u8* head = memory.GetPhysicalPointer(addr);
+        RecordMemory(addr, size);
         cmd_list.Reset(addr, head, size);
         break;
     }
@@ -233,8 +429,7 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         if (offset >= 4096) {
             LOG_ERROR(HW_GPU, "Invalid GS program offset {}", offset);
         } else {
-            gs_setup.program_code[offset] = value;
-            gs_setup.MarkProgramCodeDirty();
+            gs_setup.WriteProgramCode(offset, value);
             offset++;
         }
         break;
@@ -252,8 +447,7 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         if (offset >= gs_setup.swizzle_data.size()) {
             LOG_ERROR(HW_GPU, "Invalid GS swizzle pattern offset {}", offset);
         } else {
-            gs_setup.swizzle_data[offset] = value;
-            gs_setup.MarkSwizzleDataDirty();
+            gs_setup.WriteSwizzleData(offset, value);
             offset++;
         }
         break;
@@ -315,11 +509,9 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         if (offset >= 512) {
             LOG_ERROR(HW_GPU, "Invalid VS program offset {}", offset);
         } else {
-            vs_setup.program_code[offset] = value;
-            vs_setup.MarkProgramCodeDirty();
+            vs_setup.WriteProgramCode(offset, value);
             if (!regs.internal.pipeline.gs_unit_exclusive_configuration) {
-                gs_setup.program_code[offset] = value;
-                gs_setup.MarkProgramCodeDirty();
+                gs_setup.WriteProgramCode(offset, value);
             }
             offset++;
         }
@@ -338,11 +530,9 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         if (offset >= vs_setup.swizzle_data.size()) {
             LOG_ERROR(HW_GPU, "Invalid VS swizzle pattern offset {}", offset);
         } else {
-            vs_setup.swizzle_data[offset] = value;
-            vs_setup.MarkSwizzleDataDirty();
+            vs_setup.WriteSwizzleData(offset, value);
             if (!regs.internal.pipeline.gs_unit_exclusive_configuration) {
-                gs_setup.swizzle_data[offset] = value;
-                gs_setup.MarkSwizzleDataDirty();
+                gs_setup.WriteSwizzleData(offset, value);
             }
             offset++;
         }
@@ -445,29 +635,74 @@ void PicaCore::SubmitImmediate(u32 value) {
         return;
     }
 
-    // We formed a vertex, flush.
-    DrawImmediate();
+    // We formed a vertex, batch it until the state changes.
+    immediate_batch.push_back(immediate.input_vertex);
+    immediate.current_attribute = 0;
+    if (debug_context || immediate_batch.size() == MaxImmediateBatch) {
+        DrawImmediate();
+    }
 }
 
 void PicaCore::DrawImmediate() {
+    if (immediate_batch.empty()) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(GPU_Drawing);
+    SCOPE_EXIT({ immediate_batch.clear(); });
+    if (ShouldSkipDraw()) {
+        return;
+    }
+
+    const bool accelerate_draw = [this] {
+        // The geometry shader input can span several batches, so geometry shaders only run on
+        // the host for draw calls.
+        if (regs.internal.pipeline.use_gs != PipelineRegs::UseGS::No || debug_context) {
+            return false;
+        }
+        if (!Settings::values.use_hw_shader || !primitive_assembler.IsEmpty()) {
+            return false;
+        }
+
+        // Strips and fans may continue in the next batch, which only the software primitive
+        // assembler can keep track of.
+        const auto topology = primitive_assembler.GetTopology();
+        return (topology == PipelineRegs::TriangleTopology::Shader ||
+                topology == PipelineRegs::TriangleTopology::List) &&
+               immediate_batch.size() % 3 == 0;
+    }();
+
+    // Attempt to use hardware vertex shaders if possible.
+    if (accelerate_draw && rasterizer->AccelerateDrawImmediate(immediate_batch)) {
+        return;
+    }
+
     // Compile the vertex shader.
     shader_engine->SetupBatch(vs_setup, regs.internal.vs.main_offset);
 
-    // Track vertex in the debug recorder.
+    // Track vertices in the debug recorder.
     if (debug_context) {
-        debug_context->OnEvent(DebugContext::Event::VertexShaderInvocation,
-                               std::addressof(immediate.input_vertex));
+        for (const auto& vertex : immediate_batch) {
+            debug_context->OnEvent(DebugContext::Event::VertexShaderInvocation,
+                                   std::addressof(vertex));
+        }
         SCOPE_EXIT(
             { debug_context->OnEvent(DebugContext::Event::FinishedPrimitiveBatch, nullptr); });
     }
 
-    ShaderUnit shader_unit;
-    AttributeBuffer output{};
-
-    // Invoke the vertex shader for the vertex.
-    shader_unit.LoadInput(regs.internal.vs, immediate.input_vertex);
-    shader_engine->Run(vs_setup, shader_unit);
-    shader_unit.WriteOutput(regs.internal.vs, output);
+    // Invoke the vertex shader for groups of vertices, the outputs replace the inputs.
+    std::array<ShaderUnit, VerticesPerShaderBatch> shader_units;
+    for (std::size_t batch = 0; batch < immediate_batch.size(); batch += VerticesPerShaderBatch) {
+        const std::size_t count =
+            std::min<std::size_t>(immediate_batch.size() - batch, VerticesPerShaderBatch);
+        for (std::size_t i = 0; i < count; ++i) {
+            shader_units[i].LoadInput(regs.internal.vs, immediate_batch[batch + i]);
+        }
+        shader_engine->RunBatch(vs_setup, std::span{shader_units.data(), count});
+        for (std::size_t i = 0; i < count; ++i) {
+            shader_units[i].WriteOutput(regs.internal.vs, immediate_batch[batch + i]);
+        }
+    }
 
     // Reconfigure geometry pipeline if needed.
     if (immediate.reset_geometry_pipeline) {
@@ -478,15 +713,20 @@ void PicaCore::DrawImmediate() {
     // Send to geometry pipeline.
     ASSERT(!geometry_pipeline.NeedIndexInput());
     geometry_pipeline.Setup(shader_engine.get());
-    geometry_pipeline.SubmitVertex(output);
+    for (const auto& output : immediate_batch) {
+        geometry_pipeline.SubmitVertex(output);
+    }
 
-    // Flush the immediate triangle.
+    // Flush the immediate triangles.
+    SubmitTriangles();
     rasterizer->DrawTriangles();
-    immediate.current_attribute = 0;
 }
 
 void PicaCore::DrawArrays(bool is_indexed) {
     MICROPROFILE_SCOPE(GPU_Drawing);
+    if (ShouldSkipDraw()) {
+        return;
+    }
 
     // Track vertex in the debug recorder.
     if (debug_context) {
@@ -496,8 +736,11 @@ void PicaCore::DrawArrays(bool is_indexed) {
     }
 
     const bool accelerate_draw = [this] {
-        // Geometry shaders cannot be accelerated due to register preservation.
-        if (regs.internal.pipeline.use_gs == PipelineRegs::UseGS::Yes) {
+        // Only Point mode geometry shaders, which get all of their input vertices at once, can
+        // run on the host. The others feed the shader through registers it keeps between
+        // invocations.
+        const bool use_gs = regs.internal.pipeline.use_gs == PipelineRegs::UseGS::Yes;
+        if (use_gs && regs.internal.pipeline.gs_config.mode != PipelineRegs::GSMode::Point) {
             return false;
         }
 
@@ -510,13 +753,19 @@ void PicaCore::DrawArrays(bool is_indexed) {
 
         bool accelerate_draw = Settings::values.use_hw_shader && primitive_assembler.IsEmpty();
         const auto topology = primitive_assembler.GetTopology();
-        if (topology == PipelineRegs::TriangleTopology::Shader ||
-            topology == PipelineRegs::TriangleTopology::List) {
+        // Vertices left over by the geometry shader input are dropped by the host like they are
+        // here, so only the triangle topologies need whole primitives.
+        if (!use_gs && (topology == PipelineRegs::TriangleTopology::Shader ||
+                        topology == PipelineRegs::TriangleTopology::List)) {
             accelerate_draw = accelerate_draw && (regs.internal.pipeline.num_vertices % 3) == 0;
         }
         return accelerate_draw;
     }();
 
+    if (debug_context && debug_context->recorder) {
+        RecordDrawMemory(is_indexed);
+    }
+
     // Attempt to use hardware vertex shaders if possible.
     if (accelerate_draw && rasterizer->AccelerateDrawBatch(is_indexed)) {
         return;
@@ -526,9 +775,110 @@ void PicaCore::DrawArrays(bool is_indexed) {
     LoadVertices(is_indexed);
 
     // Draw emitted triangles.
+    SubmitTriangles();
     rasterizer->DrawTriangles();
 }
 
+bool PicaCore::ShouldSkipDraw() const {
+    if (debug_context) {
+        return false;
+    }
+    if (rasterizer->DiscardsDraws()) {
+        return true;
+    }
+    if (!skip_draws) {
+        return false;
+    }
+    // The skipped draws are never rendered later, so targets the CPU reads must stay current.
+    const auto& framebuffer = regs.internal.framebuffer.framebuffer;
+    return !rasterizer->IsReadbackTarget(framebuffer.GetColorBufferPhysicalAddress()) &&
+           !rasterizer->IsReadbackTarget(framebuffer.GetDepthBufferPhysicalAddress());
+}
+
+void PicaCore::SubmitTriangles() {
+    rasterizer->AddTriangles(triangle_batch);
+    triangle_batch.clear();
+}
+
+void PicaCore::RecordMemory(PAddr addr, u32 size) {
+    if (!debug_context || !debug_context->recorder || size == 0) {
+        return;
+    }
+    const u8* data = memory.GetPhysicalPointer(addr);
+    if (!data || !memory.IsValidPhysicalAddress(addr + size - 1)) {
+        return;
+    }
+
+    // The trace is replayed without the host caches, so it must see what the GPU rendered.
+    rasterizer->FlushRegion(addr, size);
+    debug_context->recorder->MemoryAccessed(data, size, addr);
+}
+
+void PicaCore::RecordDrawMemory(bool is_indexed) {
+    const auto& pipeline = regs.internal.pipeline;
+    const PAddr base_address = pipeline.vertex_attributes.GetPhysicalBaseAddress();
+    if (pipeline.num_vertices == 0) {
+        return;
+    }
+
+    u32 vertex_min = pipeline.vertex_offset;
+    u32 vertex_max = pipeline.vertex_offset + pipeline.num_vertices - 1;
+    if (is_indexed) {
+        const auto& index_info = pipeline.index_array;
+        const PAddr index_address = base_address + index_info.offset;
+        const bool index_u16 = index_info.format != 0;
+        RecordMemory(index_address, pipeline.num_vertices * (index_u16 ? 2 : 1));
+
+        const u8* index_address_8 = memory.GetPhysicalPointer(index_address);
+        const u16* index_address_16 = reinterpret_cast<const u16*>(index_address_8);
+        vertex_min = 0xFFFF;
+        vertex_max = 0;
+        for (u32 index = 0; index < pipeline.num_vertices; ++index) {
+            const u32 vertex = index_u16 ? index_address_16[index] : index_address_8[index];
+            vertex_min = std::min(vertex_min, vertex);
+            vertex_max = std::max(vertex_max, vertex);
+        }
+    }
+
+    for (const auto& loader : pipeline.vertex_attributes.attribute_loaders) {
+        if (loader.component_count == 0 || loader.byte_count == 0) {
+            continue;
+        }
+        RecordMemory(base_address + loader.data_offset + vertex_min * loader.byte_count,
+                     (vertex_max - vertex_min + 1) * loader.byte_count);
+    }
+
+    const auto& texturing = regs.internal.texturing;
+    const auto textures = texturing.GetTextures();
+    for (u32 unit = 0; unit < textures.size(); unit++) {
+        const auto& texture = textures[unit];
+        if (!texture.enabled) {
+            continue;
+        }
+
+        // Mipmap levels follow the base level, each one a quarter of the size of the previous.
+        const auto info = Texture::TextureInfo::FromPicaRegister(texture.config, texture.format);
+        const u32 level_size = static_cast<u32>(info.stride) * (info.height / 8);
+        u32 size = 0;
+        for (u32 level = 0; level <= texture.config.lod.max_level; level++) {
+            size += level_size >> (2 * level);
+        }
+
+        const bool is_cube = texture.config.type == TexturingRegs::TextureConfig::TextureCube ||
+                             texture.config.type == TexturingRegs::TextureConfig::ShadowCube;
+        if (unit != 0 || !is_cube) {
+            RecordMemory(info.physical_address, size);
+            continue;
+        }
+        for (const auto face :
+             {TexturingRegs::CubeFace::PositiveX, TexturingRegs::CubeFace::NegativeX,
+              TexturingRegs::CubeFace::PositiveY, TexturingRegs::CubeFace::NegativeY,
+              TexturingRegs::CubeFace::PositiveZ, TexturingRegs::CubeFace::NegativeZ}) {
+            RecordMemory(texturing.GetCubePhysicalAddress(face), size);
+        }
+    }
+}
+
 void PicaCore::LoadVertices(bool is_indexed) {
     // Read and validate vertex information from the loaders
     const auto& pipeline = regs.internal.pipeline;
@@ -542,12 +892,18 @@ void PicaCore::LoadVertices(bool is_indexed) {
     const u16* index_address_16 = reinterpret_cast<const u16*>(index_address_8);
     const bool index_u16 = index_info.format != 0;
 
-    // Simple circular-replacement vertex cache
-    const std::size_t VERTEX_CACHE_SIZE = 64;
-    std::array<bool, VERTEX_CACHE_SIZE> vertex_cache_valid{};
-    std::array<u16, VERTEX_CACHE_SIZE> vertex_cache_ids;
-    std::array<AttributeBuffer, VERTEX_CACHE_SIZE> vertex_cache;
-    u32 vertex_cache_pos = 0;
+    // Size the post-transform cache to the index range referenced by this draw.
+    const bool use_vertex_cache = is_indexed && !geometry_pipeline.NeedIndexInput();
+    if (use_vertex_cache) {
+        u32 max_index = 0;
+        for (u32 index = 0; index < pipeline.num_vertices; ++index) {
+            const u32 vertex = index_u16 ? index_address_16[index] : index_address_8[index];
+            max_index = std::max(max_index, vertex);
+        }
+        vertex_cache.Reset(max_index, Settings::values.vertex_cache_size.GetValue());
+    }
+    u32 vertex_cache_hits = 0;
+    u32 vertex_cache_misses = 0;
 
     // Compile the vertex shader for this batch.
     ShaderUnit shader_unit;
@@ -559,29 +915,41 @@ void PicaCore::LoadVertices(bool is_indexed) {
     geometry_pipeline.Setup(shader_engine.get());
     ASSERT(!geometry_pipeline.NeedIndexInput() || is_indexed);
 
+    // Non-indexed batches are shaded in groups of vertices, large ones in parallel, and then
+    // submitted in order.
+    if (!is_indexed && !debug_context) {
+        const u32 num_vertices = pipeline.num_vertices;
+        if (vs_batch_outputs.size() < num_vertices) {
+            vs_batch_outputs.resize(num_vertices);
+        }
+        if (Settings::values.parallel_vertex_shading.GetValue() &&
+            num_vertices >= 2 * MinVerticesPerTask) {
+            ShadeVerticesParallel(loader, base_address);
+        } else {
+            ShadeVertices(loader, base_address, 0, num_vertices);
+        }
+        for (u32 index = 0; index < num_vertices; ++index) {
+            geometry_pipeline.SubmitVertex(vs_batch_outputs[index]);
+        }
+        return;
+    }
+
     for (u32 index = 0; index < pipeline.num_vertices; ++index) {
         // Indexed rendering doesn't use the start offset
         const u32 vertex = is_indexed
                                ? (index_u16 ? index_address_16[index] : index_address_8[index])
                                : (index + pipeline.vertex_offset);
 
-        bool vertex_cache_hit = false;
-        if (is_indexed) {
-            if (geometry_pipeline.NeedIndexInput()) {
-                geometry_pipeline.SubmitIndex(vertex);
-                continue;
-            }
-
-            for (u32 i = 0; i < VERTEX_CACHE_SIZE; ++i) {
-                if (vertex_cache_valid[i] && vertex == vertex_cache_ids[i]) {
-                    vs_output = vertex_cache[i];
-                    vertex_cache_hit = true;
-                    break;
-                }
-            }
+        if (is_indexed && geometry_pipeline.NeedIndexInput()) {
+            geometry_pipeline.SubmitIndex(vertex);
+            continue;
         }
 
-        if (!vertex_cache_hit) {
+        const AttributeBuffer* cached = use_vertex_cache ? vertex_cache.Find(vertex) : nullptr;
+        if (cached) {
+            vs_output = *cached;
+            ++vertex_cache_hits;
+        } else {
             // Initialize data for the current vertex
             AttributeBuffer input;
             loader.LoadVertex(base_address, index, vertex, input, input_default_attributes);
@@ -598,17 +966,60 @@ void PicaCore::LoadVertices(bool is_indexed) {
             shader_unit.WriteOutput(regs.internal.vs, vs_output);
 
             // Cache the vertex when doing indexed rendering.
-            if (is_indexed) {
-                vertex_cache[vertex_cache_pos] = vs_output;
-                vertex_cache_valid[vertex_cache_pos] = true;
-                vertex_cache_ids[vertex_cache_pos] = vertex;
-                vertex_cache_pos = (vertex_cache_pos + 1) % VERTEX_CACHE_SIZE;
+            if (use_vertex_cache) {
+                vertex_cache.Insert(vertex, vs_output);
+                ++vertex_cache_misses;
             }
         }
 
         // Send to geometry pipeline
         geometry_pipeline.SubmitVertex(vs_output);
     }
+
+    MICROPROFILE_META_CPU("Vertex Cache Hits", static_cast<int>(vertex_cache_hits));
+    MICROPROFILE_META_CPU("Vertex Cache Misses", static_cast<int>(vertex_cache_misses));
+}
+
+void PicaCore::ShadeVerticesParallel(const VertexLoader& loader, PAddr base_address) {
+    MICROPROFILE_SCOPE(GPU_ParallelVS);
+
+    if (!vs_workers) {
+        const u32 num_workers = std::max(std::thread::hardware_concurrency(), 2U);
+        vs_workers = std::make_unique<Common::ThreadWorker>(num_workers, "VS workers",
+                                                            Common::ThreadRole::Render);
+    }
+
+    const u32 num_vertices = regs.internal.pipeline.num_vertices;
+
+    // Split the batch into roughly equal ranges, one per worker, each with its own shader units.
+    const u32 num_workers = static_cast<u32>(vs_workers->NumWorkers());
+    const u32 vertices_per_task =
+        std::max((num_vertices + num_workers - 1) / num_workers, MinVerticesPerTask);
+    for (u32 start = 0; start < num_vertices; start += vertices_per_task) {
+        const u32 end = std::min(start + vertices_per_task, num_vertices);
+        vs_workers->QueueWork([this, &loader, base_address, start, end] {
+            ShadeVertices(loader, base_address, start, end);
+        });
+    }
+    vs_workers->WaitForRequests();
+}
+
+void PicaCore::ShadeVertices(const VertexLoader& loader, PAddr base_address, u32 start, u32 end) {
+    const u32 vertex_offset = regs.internal.pipeline.vertex_offset;
+    std::array<ShaderUnit, VerticesPerShaderBatch> shader_units;
+    AttributeBuffer input;
+    for (u32 batch = start; batch < end; batch += VerticesPerShaderBatch) {
+        const u32 count = std::min(end - batch, VerticesPerShaderBatch);
+        for (u32 i = 0; i < count; ++i) {
+            loader.LoadVertex(base_address, batch + i, batch + i + vertex_offset, input,
+                              input_default_attributes);
+            shader_units[i].LoadInput(regs.internal.vs, input);
+        }
+        shader_engine->RunBatch(vs_setup, std::span{shader_units.data(), count});
+        for (u32 i = 0; i < count; ++i) {
+            shader_units[i].WriteOutput(regs.internal.vs, vs_batch_outputs[batch + i]);
+        }
+    }
 }
 
 template <class Archive>
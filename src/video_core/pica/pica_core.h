@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "common/thread_worker.h"
 #include "core/hle/service/gsp/gsp_interrupt.h"
 #include "video_core/pica/geometry_pipeline.h"
 #include "video_core/pica/packed_attribute.h"
@@ -13,6 +18,7 @@
 #include "video_core/pica/regs_lcd.h"
 #include "video_core/pica/shader_setup.h"
 #include "video_core/pica/shader_unit.h"
+#include "video_core/pica/vertex_cache.h"
 
 namespace Memory {
 class MemorySystem;
@@ -26,6 +32,7 @@ namespace Pica {
 
 class DebugContext;
 class ShaderEngine;
+class VertexLoader;
 
 class PicaCore {
 public:
@@ -38,19 +45,70 @@ public:
 
     void ProcessCmdList(PAddr list, u32 size);
 
+    /// Stores the guest memory read by the GPU in the CiTrace being recorded, if any
+    void RecordMemory(PAddr addr, u32 size);
+
+    /// Drops the draws of the following frame, except to render targets the CPU reads back
+    void SetSkipDraws(bool skip) noexcept {
+        skip_draws = skip;
+    }
+
 private:
+    /// Register write of a command list decoded for replay
+    struct DecodedWrite {
+        u32 id;
+        u32 value;
+        u32 mask; ///< Byte mask of state writes, parameter mask of the others
+        bool has_side_effects;
+    };
+
+    /// Command list submitted before, decoded once it is submitted again unchanged
+    struct CachedCmdList {
+        enum class State {
+            Seen,     ///< Executed once with these contents
+            Decoded,  ///< Replayed from the decoded writes
+            Uncached, ///< Jumps to another list, so it is always executed
+        };
+
+        u64 hash{};
+        State state{};
+        std::vector<DecodedWrite> writes;
+    };
+
     void InitializeRegs();
 
+    /// Executes the current command list a write at a time
+    void ExecuteCmdList();
+
+    /// Decodes the current command list, returns false if it jumps to another list
+    bool DecodeCmdList(std::vector<DecodedWrite>& writes) const;
+
+    /// Replays the writes of a decoded command list
+    void ReplayCmdList(std::span<const DecodedWrite> writes);
+
     void WriteInternalReg(u32 id, u32 value, u32 mask);
 
     void SubmitImmediate(u32 data);
 
+    /// Draws the immediate mode vertices batched since the last state change
     void DrawImmediate();
 
     void DrawArrays(bool is_indexed);
 
     void LoadVertices(bool is_indexed);
 
+    void ShadeVerticesParallel(const VertexLoader& loader, PAddr base_address);
+
+    void ShadeVertices(const VertexLoader& loader, PAddr base_address, u32 start, u32 end);
+
+    void SubmitTriangles();
+
+    /// Records the vertex, index and texture data read by the current draw
+    void RecordDrawMemory(bool is_indexed);
+
+    /// Returns true if the current draw is dropped by frame skipping
+    bool ShouldSkipDraw() const;
+
 public:
     union Regs {
         static constexpr std::size_t NUM_REGS = 0x732;
@@ -279,7 +337,15 @@ private:
     GeometryPipeline geometry_pipeline;
     PrimitiveAssembler primitive_assembler;
     CommandList cmd_list;
+    VertexCache vertex_cache;
     std::unique_ptr<ShaderEngine> shader_engine;
+    std::unique_ptr<Common::ThreadWorker> vs_workers;
+    std::vector<AttributeBuffer> vs_batch_outputs;
+    std::vector<OutputVertex> triangle_batch;
+    std::vector<AttributeBuffer> immediate_batch;
+    /// Decoded command lists, keyed by their address and size
+    std::unordered_map<u64, CachedCmdList> cmd_list_cache;
+    bool skip_draws{};
 };
 
 #define GPU_REG_INDEX(field_name) (offsetof(Pica::PicaCore::Regs, field_name) / sizeof(u32))
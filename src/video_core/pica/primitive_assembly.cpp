@@ -11,7 +11,7 @@ PrimitiveAssembler::PrimitiveAssembler(PipelineRegs::TriangleTopology topology)
     : topology(topology) {}
 
 void PrimitiveAssembler::SubmitVertex(const OutputVertex& vtx,
-                                      const TriangleHandler& triangle_handler) {
+                                      std::vector<OutputVertex>& triangles) {
     switch (topology) {
     case PipelineRegs::TriangleTopology::List:
     case PipelineRegs::TriangleTopology::Shader:
@@ -20,10 +20,10 @@ void PrimitiveAssembler::SubmitVertex(const OutputVertex& vtx,
         } else {
             buffer_index = 0;
             if (topology == PipelineRegs::TriangleTopology::Shader && winding) {
-                triangle_handler(buffer[1], buffer[0], vtx);
+                triangles.insert(triangles.end(), {buffer[1], buffer[0], vtx});
                 winding = false;
             } else {
-                triangle_handler(buffer[0], buffer[1], vtx);
+                triangles.insert(triangles.end(), {buffer[0], buffer[1], vtx});
             }
         }
         break;
@@ -31,7 +31,7 @@ void PrimitiveAssembler::SubmitVertex(const OutputVertex& vtx,
     case PipelineRegs::TriangleTopology::Strip:
     case PipelineRegs::TriangleTopology::Fan:
         if (strip_ready) {
-            triangle_handler(buffer[0], buffer[1], vtx);
+            triangles.insert(triangles.end(), {buffer[0], buffer[1], vtx});
         }
 
         buffer[buffer_index] = vtx;
@@ -5,7 +5,7 @@
 #pragma once
 
 #include <array>
-#include <functional>
+#include <vector>
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/array.hpp>
 #include "video_core/pica/output_vertex.h"
@@ -18,19 +18,14 @@ namespace Pica {
  * according to a given triangle topology.
  */
 struct PrimitiveAssembler {
-    using TriangleHandler =
-        std::function<void(const OutputVertex&, const OutputVertex&, const OutputVertex&)>;
-
     explicit PrimitiveAssembler(
         PipelineRegs::TriangleTopology topology = PipelineRegs::TriangleTopology::List);
 
     /**
      * Queues a vertex, builds primitives from the vertex queue according to the given
-     * triangle topology, and calls triangle_handler for each generated primitive.
-     * NOTE: We could specify the triangle handler in the constructor, but this way we can
-     * keep event and handler code next to each other.
+     * triangle topology, and appends the three vertices of each generated primitive to triangles.
      */
-    void SubmitVertex(const OutputVertex& vtx, const TriangleHandler& triangle_handler);
+    void SubmitVertex(const OutputVertex& vtx, std::vector<OutputVertex>& triangles);
 
     /**
      * Invert the vertex order of the next triangle. Called by geometry shader emitter.
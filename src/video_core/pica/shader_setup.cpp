@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include "common/assert.h"
 #include "common/bit_set.h"
 #include "common/hash.h"
@@ -41,8 +43,13 @@ std::optional<u32> ShaderSetup::WriteUniformFloatReg(ShaderRegs& config, u32 val
     }
 
     const u32 index = uniform_setup.index.Value();
-    uniforms.f[index] = uniform;
     uniform_setup.index.Assign(index + 1);
+    // Titles often upload the same values again before each draw, those are not tracked
+    if (std::memcmp(&uniforms.f[index], &uniform, sizeof(uniform)) != 0) {
+        uniforms.f[index] = uniform;
+        dirty_float_begin = std::min(dirty_float_begin, index);
+        dirty_float_end = std::max(dirty_float_end, index + 1);
+    }
     return index;
 }
 
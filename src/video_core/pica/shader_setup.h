@@ -5,6 +5,7 @@
 #pragma once
 
 #include <optional>
+#include <utility>
 #include "common/vector_math.h"
 #include "video_core/pica/packed_attribute.h"
 #include "video_core/pica_types.h"
@@ -61,10 +62,40 @@ public:
 
     std::optional<u32> WriteUniformFloatReg(ShaderRegs& config, u32 value);
 
+    /**
+     * Returns the range of the float uniforms written with a new value since the last call, so
+     * that the hardware shader backends only convert the ones that changed.
+     */
+    std::pair<u32, u32> ConsumeDirtyFloatUniforms() {
+        const std::pair range{dirty_float_begin, dirty_float_end};
+        dirty_float_begin = static_cast<u32>(uniforms.f.size());
+        dirty_float_end = 0;
+        return range;
+    }
+
     u64 GetProgramCodeHash();
 
     u64 GetSwizzleDataHash();
 
+    /**
+     * Writes a word of the program code. The hash is only invalidated when the word changes, so
+     * that uploading the same program again does not hash the code nor look up the shaders again.
+     */
+    void WriteProgramCode(u32 offset, u32 value) {
+        if (program_code[offset] != value) {
+            program_code[offset] = value;
+            program_code_hash_dirty = true;
+        }
+    }
+
+    /// Writes a word of the swizzle data, only invalidating the hash when it changes.
+    void WriteSwizzleData(u32 offset, u32 value) {
+        if (swizzle_data[offset] != value) {
+            swizzle_data[offset] = value;
+            swizzle_data_hash_dirty = true;
+        }
+    }
+
     void MarkProgramCodeDirty() {
         program_code_hash_dirty = true;
     }
@@ -86,6 +117,8 @@ private:
     bool swizzle_data_hash_dirty{true};
     u64 program_code_hash{0xDEADC0DE};
     u64 swizzle_data_hash{0xDEADC0DE};
+    u32 dirty_float_begin{0};
+    u32 dirty_float_end{static_cast<u32>(std::tuple_size_v<decltype(Uniforms::f)>)};
 
     friend class boost::serialization::access;
     template <class Archive>
@@ -98,6 +131,10 @@ private:
         ar& swizzle_data_hash_dirty;
         ar& program_code_hash;
         ar& swizzle_data_hash;
+        if (Archive::is_loading::value) {
+            dirty_float_begin = 0;
+            dirty_float_end = static_cast<u32>(uniforms.f.size());
+        }
     }
 };
 
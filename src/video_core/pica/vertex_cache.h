@@ -0,0 +1,67 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include "video_core/pica/output_vertex.h"
+
+namespace Pica {
+
+/**
+ * Direct-mapped post-transform vertex cache keyed by vertex index. The cache is sized to the
+ * index range of each draw (up to a configurable limit) so that every unique index is shaded
+ * exactly once. Entries are invalidated in constant time by bumping a generation counter.
+ */
+class VertexCache {
+public:
+    /// Prepares the cache for a draw referencing vertex indices up to max_index.
+    void Reset(u32 max_index, u32 max_entries) {
+        const u32 limit = std::bit_floor(std::max(max_entries, 1U));
+        const u32 size = std::min(std::bit_ceil(max_index + 1), limit);
+        if (size > tags.size()) {
+            tags.resize(size);
+            outputs.resize(size);
+        }
+        mask = size - 1;
+
+        // Clear all tags when the generation wraps around to keep stale entries from matching.
+        if (++generation == 0) {
+            std::fill(tags.begin(), tags.end(), Tag{});
+            generation = 1;
+        }
+    }
+
+    /// Returns the cached shader output of the provided vertex, if any.
+    [[nodiscard]] const AttributeBuffer* Find(u32 vertex) const {
+        const Tag& tag = tags[vertex & mask];
+        if (tag.generation != generation || tag.vertex != vertex) {
+            return nullptr;
+        }
+        return &outputs[vertex & mask];
+    }
+
+    /// Stores the shader output of the provided vertex.
+    void Insert(u32 vertex, const AttributeBuffer& output) {
+        const u32 slot = vertex & mask;
+        tags[slot] = Tag{generation, vertex};
+        outputs[slot] = output;
+    }
+
+private:
+    struct Tag {
+        u32 generation;
+        u32 vertex;
+    };
+
+    std::vector<Tag> tags;
+    std::vector<AttributeBuffer> outputs;
+    u32 mask{};
+    u32 generation{};
+};
+
+} // namespace Pica
@@ -8,6 +8,51 @@
 
 namespace Pica {
 
+namespace {
+
+template <typename T, u32 NumElements>
+void LoadAttribute(const u8* data, Common::Vec4<f24>& out) {
+    const T* elements = reinterpret_cast<const T*>(data);
+    for (u32 comp = 0; comp < NumElements; ++comp) {
+        out[comp] = f24::FromFloat32(static_cast<float>(elements[comp]));
+    }
+
+    // Default attribute values set if array elements have < 4 components. This
+    // is *not* carried over from the default attribute settings even if they're
+    // enabled for this attribute.
+    for (u32 comp = NumElements; comp < 4; ++comp) {
+        out[comp] = comp == 3 ? f24::One() : f24::Zero();
+    }
+}
+
+template <typename T>
+constexpr std::array<void (*)(const u8*, Common::Vec4<f24>&), 4> AttributeLoaders = {
+    &LoadAttribute<T, 1>,
+    &LoadAttribute<T, 2>,
+    &LoadAttribute<T, 3>,
+    &LoadAttribute<T, 4>,
+};
+
+} // Anonymous namespace
+
+VertexLoader::AttributeLoader VertexLoader::GetAttributeLoader(
+    PipelineRegs::VertexAttributeFormat format, u32 num_elements) {
+    ASSERT(num_elements >= 1 && num_elements <= 4);
+    const u32 index = num_elements - 1;
+    switch (format) {
+    case PipelineRegs::VertexAttributeFormat::BYTE:
+        return AttributeLoaders<s8>[index];
+    case PipelineRegs::VertexAttributeFormat::UBYTE:
+        return AttributeLoaders<u8>[index];
+    case PipelineRegs::VertexAttributeFormat::SHORT:
+        return AttributeLoaders<s16>[index];
+    case PipelineRegs::VertexAttributeFormat::FLOAT:
+        return AttributeLoaders<f32>[index];
+    }
+    UNREACHABLE();
+    return nullptr;
+}
+
 VertexLoader::VertexLoader(Memory::MemorySystem& memory_, const PipelineRegs& regs)
     : memory{memory_} {
     const auto& attribute_config = regs.vertex_attributes;
@@ -45,6 +90,9 @@ VertexLoader::VertexLoader(Memory::MemorySystem& memory_, const PipelineRegs& re
                     attribute_config.GetFormat(attribute_index);
                 vertex_attribute_elements[attribute_index] =
                     attribute_config.GetNumElements(attribute_index);
+                vertex_attribute_loaders[attribute_index] =
+                    GetAttributeLoader(vertex_attribute_formats[attribute_index],
+                                       vertex_attribute_elements[attribute_index]);
                 offset += attribute_config.GetStride(attribute_index);
             } else if (attribute_index < 16) {
                 // Attribute ids 12, 13, 14 and 15 signify 4, 8, 12 and 16-byte paddings,
@@ -82,27 +130,7 @@ void VertexLoader::LoadVertex(PAddr base_address, u32 index, u32 vertex, Attribu
         const PAddr source_addr =
             base_address + vertex_attribute_sources[i] + vertex_attribute_strides[i] * vertex;
 
-        switch (vertex_attribute_formats[i]) {
-        case PipelineRegs::VertexAttributeFormat::BYTE:
-            LoadAttribute<s8>(source_addr, i, input);
-            break;
-        case PipelineRegs::VertexAttributeFormat::UBYTE:
-            LoadAttribute<u8>(source_addr, i, input);
-            break;
-        case PipelineRegs::VertexAttributeFormat::SHORT:
-            LoadAttribute<s16>(source_addr, i, input);
-            break;
-        case PipelineRegs::VertexAttributeFormat::FLOAT:
-            LoadAttribute<f32>(source_addr, i, input);
-            break;
-        }
-
-        // Default attribute values set if array elements have < 4 components. This
-        // is *not* carried over from the default attribute settings even if they're
-        // enabled for this attribute.
-        for (u32 comp = vertex_attribute_elements[i]; comp < 4; comp++) {
-            input[i][comp] = comp == 3 ? f24::One() : f24::Zero();
-        }
+        vertex_attribute_loaders[i](memory.GetPhysicalPointer(source_addr), input[i]);
     }
 }
 
@@ -22,20 +22,21 @@ public:
     void LoadVertex(PAddr base_address, u32 index, u32 vertex, AttributeBuffer& input,
                     AttributeBuffer& input_default_attributes) const;
 
-    template <typename T>
-    void LoadAttribute(PAddr source_addr, u32 attrib, AttributeBuffer& out) const {
-        const T* data = reinterpret_cast<const T*>(memory.GetPhysicalPointer(source_addr));
-        for (u32 comp = 0; comp < vertex_attribute_elements[attrib]; ++comp) {
-            out[attrib][comp] = f24::FromFloat32(data[comp]);
-        }
-    }
-
     int GetNumTotalAttributes() const {
         return num_total_attributes;
     }
 
+private:
+    /// Converts a single attribute from guest memory and fills its missing components.
+    using AttributeLoader = void (*)(const u8* data, Common::Vec4<f24>& out);
+
+    /// Returns the loader specialized for the provided attribute format and element count.
+    static AttributeLoader GetAttributeLoader(PipelineRegs::VertexAttributeFormat format,
+                                              u32 num_elements);
+
 private:
     Memory::MemorySystem& memory;
+    std::array<AttributeLoader, 16> vertex_attribute_loaders{};
     std::array<u32, 16> vertex_attribute_sources;
     std::array<u32, 16> vertex_attribute_strides{};
     std::array<PipelineRegs::VertexAttributeFormat, 16> vertex_attribute_formats;
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+
 #include "common/alignment.h"
 #include "core/memory.h"
 #include "video_core/pica/pica_core.h"
@@ -81,11 +83,18 @@ static bool AreQuaternionsOpposite(Common::Vec4<f24> qa, Common::Vec4<f24> qb) {
     return (Common::Dot(a, b) < 0.f);
 }
 
-void RasterizerAccelerated::AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
-                                        const Pica::OutputVertex& v2) {
-    vertex_batch.emplace_back(v0, false);
-    vertex_batch.emplace_back(v1, AreQuaternionsOpposite(v0.quat, v1.quat));
-    vertex_batch.emplace_back(v2, AreQuaternionsOpposite(v0.quat, v2.quat));
+void RasterizerAccelerated::AddTriangles(std::span<const Pica::OutputVertex> vertices) {
+    const std::size_t num_vertices = vertices.size() - vertices.size() % 3;
+    std::size_t index = vertex_batch.size();
+    vertex_batch.resize(index + num_vertices);
+    for (std::size_t i = 0; i < num_vertices; i += 3) {
+        const auto& v0 = vertices[i];
+        const auto& v1 = vertices[i + 1];
+        const auto& v2 = vertices[i + 2];
+        vertex_batch[index++] = HardwareVertex{v0, false};
+        vertex_batch[index++] = HardwareVertex{v1, AreQuaternionsOpposite(v0.quat, v1.quat)};
+        vertex_batch[index++] = HardwareVertex{v2, AreQuaternionsOpposite(v0.quat, v2.quat)};
+    }
 }
 
 RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray(
@@ -128,11 +137,40 @@ RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray
     return {vertex_min, vertex_max, vs_input_size};
 }
 
+u32 RasterizerAccelerated::ImmediateVertexStride() const {
+    return (regs.pipeline.max_input_attrib_index + 1) * sizeof(Common::Vec4f);
+}
+
+void RasterizerAccelerated::LoadImmediateVertices(std::span<const Pica::AttributeBuffer> vertices,
+                                                  u8* dst) const {
+    const u32 num_attributes = regs.pipeline.max_input_attrib_index + 1;
+    for (const auto& vertex : vertices) {
+        for (u32 attr = 0; attr < num_attributes; ++attr) {
+            const std::array data = {vertex[attr].x.ToFloat32(), vertex[attr].y.ToFloat32(),
+                                     vertex[attr].z.ToFloat32(), vertex[attr].w.ToFloat32()};
+            std::memcpy(dst, data.data(), sizeof(data));
+            dst += sizeof(data);
+        }
+    }
+}
+
+bool RasterizerAccelerated::SyncVSPicaUniforms() {
+    if (vs_pica_uniforms_dirty) {
+        vs_pica_uniforms_changed |= vs_pica_uniform_data.uniforms.Update(regs.vs, pica.vs_setup);
+        vs_pica_uniforms_dirty = false;
+    }
+    return vs_pica_uniforms_changed;
+}
+
 void RasterizerAccelerated::SyncEntireState() {
     // Sync renderer-specific fixed-function state
     SyncFixedState();
 
     // Sync uniforms
+    vs_pica_uniform_data.uniforms.SetFromRegs(regs.vs, pica.vs_setup);
+    vs_pica_uniforms_dirty = true;
+    vs_pica_uniforms_changed = true;
+    gs_pica_uniforms_dirty = true;
     SyncClipPlane();
     SyncDepthScale();
     SyncDepthOffset();
@@ -165,462 +203,210 @@ void RasterizerAccelerated::SyncEntireState() {
     }
 }
 
-void RasterizerAccelerated::NotifyPicaRegisterChanged(u32 id) {
-    switch (id) {
+const RasterizerAccelerated::RegHandlerTable RasterizerAccelerated::reg_handlers =
+    RasterizerAccelerated::MakeRegHandlers();
+
+RasterizerAccelerated::RegHandlerTable RasterizerAccelerated::MakeRegHandlers() {
+    RegHandlerTable table{};
+    const auto set = [&table](std::size_t id, RegHandler handler, std::size_t count = 1) {
+        for (std::size_t i = 0; i < count; i++) {
+            table[id + i] = handler;
+        }
+    };
+    const auto mark_shader_dirty = [](RasterizerAccelerated& r, u32) { r.shader_dirty = true; };
+
     // Depth modifiers
-    case PICA_REG_INDEX(rasterizer.viewport_depth_range):
-        SyncDepthScale();
-        break;
-    case PICA_REG_INDEX(rasterizer.viewport_depth_near_plane):
-        SyncDepthOffset();
-        break;
+    set(PICA_REG_INDEX(rasterizer.viewport_depth_range),
+        [](RasterizerAccelerated& r, u32) { r.SyncDepthScale(); });
+    set(PICA_REG_INDEX(rasterizer.viewport_depth_near_plane),
+        [](RasterizerAccelerated& r, u32) { r.SyncDepthOffset(); });
 
     // Depth buffering
-    case PICA_REG_INDEX(rasterizer.depthmap_enable):
-        shader_dirty = true;
-        break;
+    set(PICA_REG_INDEX(rasterizer.depthmap_enable), mark_shader_dirty);
 
     // Shadow texture
-    case PICA_REG_INDEX(texturing.shadow):
-        SyncShadowTextureBias();
-        break;
+    set(PICA_REG_INDEX(texturing.shadow),
+        [](RasterizerAccelerated& r, u32) { r.SyncShadowTextureBias(); });
 
     // Fog state
-    case PICA_REG_INDEX(texturing.fog_color):
-        SyncFogColor();
-        break;
-    case PICA_REG_INDEX(texturing.fog_lut_data[0]):
-    case PICA_REG_INDEX(texturing.fog_lut_data[1]):
-    case PICA_REG_INDEX(texturing.fog_lut_data[2]):
-    case PICA_REG_INDEX(texturing.fog_lut_data[3]):
-    case PICA_REG_INDEX(texturing.fog_lut_data[4]):
-    case PICA_REG_INDEX(texturing.fog_lut_data[5]):
-    case PICA_REG_INDEX(texturing.fog_lut_data[6]):
-    case PICA_REG_INDEX(texturing.fog_lut_data[7]):
-        fs_uniform_block_data.fog_lut_dirty = true;
-        break;
+    set(PICA_REG_INDEX(texturing.fog_color),
+        [](RasterizerAccelerated& r, u32) { r.SyncFogColor(); });
+    set(
+        PICA_REG_INDEX(texturing.fog_lut_data[0]),
+        [](RasterizerAccelerated& r, u32) { r.fs_uniform_block_data.fog_lut_dirty = true; }, 8);
 
     // ProcTex state
-    case PICA_REG_INDEX(texturing.proctex):
-    case PICA_REG_INDEX(texturing.proctex_lut):
-    case PICA_REG_INDEX(texturing.proctex_lut_offset):
-        SyncProcTexBias();
-        shader_dirty = true;
-        break;
-
-    case PICA_REG_INDEX(texturing.proctex_noise_u):
-    case PICA_REG_INDEX(texturing.proctex_noise_v):
-    case PICA_REG_INDEX(texturing.proctex_noise_frequency):
-        SyncProcTexNoise();
-        break;
-
-    case PICA_REG_INDEX(texturing.proctex_lut_data[0]):
-    case PICA_REG_INDEX(texturing.proctex_lut_data[1]):
-    case PICA_REG_INDEX(texturing.proctex_lut_data[2]):
-    case PICA_REG_INDEX(texturing.proctex_lut_data[3]):
-    case PICA_REG_INDEX(texturing.proctex_lut_data[4]):
-    case PICA_REG_INDEX(texturing.proctex_lut_data[5]):
-    case PICA_REG_INDEX(texturing.proctex_lut_data[6]):
-    case PICA_REG_INDEX(texturing.proctex_lut_data[7]):
-        using Pica::TexturingRegs;
-        switch (regs.texturing.proctex_lut_config.ref_table.Value()) {
-        case TexturingRegs::ProcTexLutTable::Noise:
-            fs_uniform_block_data.proctex_noise_lut_dirty = true;
-            break;
-        case TexturingRegs::ProcTexLutTable::ColorMap:
-            fs_uniform_block_data.proctex_color_map_dirty = true;
-            break;
-        case TexturingRegs::ProcTexLutTable::AlphaMap:
-            fs_uniform_block_data.proctex_alpha_map_dirty = true;
-            break;
-        case TexturingRegs::ProcTexLutTable::Color:
-            fs_uniform_block_data.proctex_lut_dirty = true;
-            break;
-        case TexturingRegs::ProcTexLutTable::ColorDiff:
-            fs_uniform_block_data.proctex_diff_lut_dirty = true;
-            break;
-        }
-        break;
+    const RegHandler proctex_config = [](RasterizerAccelerated& r, u32) {
+        r.SyncProcTexBias();
+        r.shader_dirty = true;
+    };
+    set(PICA_REG_INDEX(texturing.proctex), proctex_config);
+    set(PICA_REG_INDEX(texturing.proctex_lut), proctex_config);
+    set(PICA_REG_INDEX(texturing.proctex_lut_offset), proctex_config);
+
+    const RegHandler proctex_noise = [](RasterizerAccelerated& r, u32) { r.SyncProcTexNoise(); };
+    set(PICA_REG_INDEX(texturing.proctex_noise_u), proctex_noise);
+    set(PICA_REG_INDEX(texturing.proctex_noise_v), proctex_noise);
+    set(PICA_REG_INDEX(texturing.proctex_noise_frequency), proctex_noise);
+
+    set(
+        PICA_REG_INDEX(texturing.proctex_lut_data[0]),
+        [](RasterizerAccelerated& r, u32) {
+            using Pica::TexturingRegs;
+            auto& data = r.fs_uniform_block_data;
+            switch (r.regs.texturing.proctex_lut_config.ref_table.Value()) {
+            case TexturingRegs::ProcTexLutTable::Noise:
+                data.proctex_noise_lut_dirty = true;
+                break;
+            case TexturingRegs::ProcTexLutTable::ColorMap:
+                data.proctex_color_map_dirty = true;
+                break;
+            case TexturingRegs::ProcTexLutTable::AlphaMap:
+                data.proctex_alpha_map_dirty = true;
+                break;
+            case TexturingRegs::ProcTexLutTable::Color:
+                data.proctex_lut_dirty = true;
+                break;
+            case TexturingRegs::ProcTexLutTable::ColorDiff:
+                data.proctex_diff_lut_dirty = true;
+                break;
+            }
+        },
+        8);
 
     // Fragment operation mode
-    case PICA_REG_INDEX(framebuffer.output_merger.fragment_operation_mode):
-        shader_dirty = true;
-        break;
+    set(PICA_REG_INDEX(framebuffer.output_merger.fragment_operation_mode), mark_shader_dirty);
 
     // Alpha test
-    case PICA_REG_INDEX(framebuffer.output_merger.alpha_test):
-        SyncAlphaTest();
-        shader_dirty = true;
-        break;
+    set(PICA_REG_INDEX(framebuffer.output_merger.alpha_test), [](RasterizerAccelerated& r, u32) {
+        r.SyncAlphaTest();
+        r.shader_dirty = true;
+    });
 
-    case PICA_REG_INDEX(framebuffer.shadow):
-        SyncShadowBias();
-        break;
+    set(PICA_REG_INDEX(framebuffer.shadow),
+        [](RasterizerAccelerated& r, u32) { r.SyncShadowBias(); });
 
     // Scissor test
-    case PICA_REG_INDEX(rasterizer.scissor_test.mode):
-        shader_dirty = true;
-        break;
+    set(PICA_REG_INDEX(rasterizer.scissor_test.mode), mark_shader_dirty);
 
-    case PICA_REG_INDEX(texturing.main_config):
-        shader_dirty = true;
-        break;
+    set(PICA_REG_INDEX(texturing.main_config), mark_shader_dirty);
 
     // Texture 0 type
-    case PICA_REG_INDEX(texturing.texture0.type):
-        shader_dirty = true;
-        break;
+    set(PICA_REG_INDEX(texturing.texture0.type), mark_shader_dirty);
 
     // TEV stages
     // (This also syncs fog_mode and fog_flip which are part of tev_combiner_buffer_input)
-    case PICA_REG_INDEX(texturing.tev_stage0.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage0.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage0.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage0.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage1.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage1.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage1.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage1.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage2.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage2.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage2.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage2.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage3.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage3.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage3.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage3.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage4.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage4.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage4.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage4.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage5.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage5.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage5.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage5.color_scale):
-    case PICA_REG_INDEX(texturing.tev_combiner_buffer_input):
-        shader_dirty = true;
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage0.const_r):
-        SyncTevConstColor(0, regs.texturing.tev_stage0);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage1.const_r):
-        SyncTevConstColor(1, regs.texturing.tev_stage1);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage2.const_r):
-        SyncTevConstColor(2, regs.texturing.tev_stage2);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage3.const_r):
-        SyncTevConstColor(3, regs.texturing.tev_stage3);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage4.const_r):
-        SyncTevConstColor(4, regs.texturing.tev_stage4);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage5.const_r):
-        SyncTevConstColor(5, regs.texturing.tev_stage5);
-        break;
+#define TEV_STAGE(n)                                                                               \
+    set(PICA_REG_INDEX(texturing.tev_stage##n.color_source1), mark_shader_dirty);                  \
+    set(PICA_REG_INDEX(texturing.tev_stage##n.color_modifier1), mark_shader_dirty);                \
+    set(PICA_REG_INDEX(texturing.tev_stage##n.color_op), mark_shader_dirty);                       \
+    set(PICA_REG_INDEX(texturing.tev_stage##n.color_scale), mark_shader_dirty);                    \
+    set(PICA_REG_INDEX(texturing.tev_stage##n.const_r), [](RasterizerAccelerated& r, u32) {       \
+        r.SyncTevConstColor(n, r.regs.texturing.tev_stage##n);                                     \
+    });
+    TEV_STAGE(0)
+    TEV_STAGE(1)
+    TEV_STAGE(2)
+    TEV_STAGE(3)
+    TEV_STAGE(4)
+    TEV_STAGE(5)
+#undef TEV_STAGE
+    set(PICA_REG_INDEX(texturing.tev_combiner_buffer_input), mark_shader_dirty);
 
     // TEV combiner buffer color
-    case PICA_REG_INDEX(texturing.tev_combiner_buffer_color):
-        SyncCombinerColor();
-        break;
-
-    // Fragment lighting switches
-    case PICA_REG_INDEX(lighting.disable):
-    case PICA_REG_INDEX(lighting.max_light_index):
-    case PICA_REG_INDEX(lighting.config0):
-    case PICA_REG_INDEX(lighting.config1):
-    case PICA_REG_INDEX(lighting.abs_lut_input):
-    case PICA_REG_INDEX(lighting.lut_input):
-    case PICA_REG_INDEX(lighting.lut_scale):
-    case PICA_REG_INDEX(lighting.light_enable):
-        break;
-
-    // Fragment lighting specular 0 color
-    case PICA_REG_INDEX(lighting.light[0].specular_0):
-        SyncLightSpecular0(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].specular_0):
-        SyncLightSpecular0(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].specular_0):
-        SyncLightSpecular0(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].specular_0):
-        SyncLightSpecular0(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].specular_0):
-        SyncLightSpecular0(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].specular_0):
-        SyncLightSpecular0(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].specular_0):
-        SyncLightSpecular0(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].specular_0):
-        SyncLightSpecular0(7);
-        break;
-
-    // Fragment lighting specular 1 color
-    case PICA_REG_INDEX(lighting.light[0].specular_1):
-        SyncLightSpecular1(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].specular_1):
-        SyncLightSpecular1(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].specular_1):
-        SyncLightSpecular1(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].specular_1):
-        SyncLightSpecular1(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].specular_1):
-        SyncLightSpecular1(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].specular_1):
-        SyncLightSpecular1(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].specular_1):
-        SyncLightSpecular1(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].specular_1):
-        SyncLightSpecular1(7);
-        break;
-
-    // Fragment lighting diffuse color
-    case PICA_REG_INDEX(lighting.light[0].diffuse):
-        SyncLightDiffuse(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].diffuse):
-        SyncLightDiffuse(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].diffuse):
-        SyncLightDiffuse(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].diffuse):
-        SyncLightDiffuse(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].diffuse):
-        SyncLightDiffuse(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].diffuse):
-        SyncLightDiffuse(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].diffuse):
-        SyncLightDiffuse(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].diffuse):
-        SyncLightDiffuse(7);
-        break;
-
-    // Fragment lighting ambient color
-    case PICA_REG_INDEX(lighting.light[0].ambient):
-        SyncLightAmbient(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].ambient):
-        SyncLightAmbient(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].ambient):
-        SyncLightAmbient(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].ambient):
-        SyncLightAmbient(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].ambient):
-        SyncLightAmbient(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].ambient):
-        SyncLightAmbient(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].ambient):
-        SyncLightAmbient(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].ambient):
-        SyncLightAmbient(7);
-        break;
-
-    // Fragment lighting position
-    case PICA_REG_INDEX(lighting.light[0].x):
-    case PICA_REG_INDEX(lighting.light[0].z):
-        SyncLightPosition(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].x):
-    case PICA_REG_INDEX(lighting.light[1].z):
-        SyncLightPosition(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].x):
-    case PICA_REG_INDEX(lighting.light[2].z):
-        SyncLightPosition(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].x):
-    case PICA_REG_INDEX(lighting.light[3].z):
-        SyncLightPosition(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].x):
-    case PICA_REG_INDEX(lighting.light[4].z):
-        SyncLightPosition(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].x):
-    case PICA_REG_INDEX(lighting.light[5].z):
-        SyncLightPosition(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].x):
-    case PICA_REG_INDEX(lighting.light[6].z):
-        SyncLightPosition(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].x):
-    case PICA_REG_INDEX(lighting.light[7].z):
-        SyncLightPosition(7);
-        break;
-
-    // Fragment spot lighting direction
-    case PICA_REG_INDEX(lighting.light[0].spot_x):
-    case PICA_REG_INDEX(lighting.light[0].spot_z):
-        SyncLightSpotDirection(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].spot_x):
-    case PICA_REG_INDEX(lighting.light[1].spot_z):
-        SyncLightSpotDirection(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].spot_x):
-    case PICA_REG_INDEX(lighting.light[2].spot_z):
-        SyncLightSpotDirection(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].spot_x):
-    case PICA_REG_INDEX(lighting.light[3].spot_z):
-        SyncLightSpotDirection(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].spot_x):
-    case PICA_REG_INDEX(lighting.light[4].spot_z):
-        SyncLightSpotDirection(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].spot_x):
-    case PICA_REG_INDEX(lighting.light[5].spot_z):
-        SyncLightSpotDirection(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].spot_x):
-    case PICA_REG_INDEX(lighting.light[6].spot_z):
-        SyncLightSpotDirection(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].spot_x):
-    case PICA_REG_INDEX(lighting.light[7].spot_z):
-        SyncLightSpotDirection(7);
-        break;
-
-    // Fragment lighting light source config
-    case PICA_REG_INDEX(lighting.light[0].config):
-    case PICA_REG_INDEX(lighting.light[1].config):
-    case PICA_REG_INDEX(lighting.light[2].config):
-    case PICA_REG_INDEX(lighting.light[3].config):
-    case PICA_REG_INDEX(lighting.light[4].config):
-    case PICA_REG_INDEX(lighting.light[5].config):
-    case PICA_REG_INDEX(lighting.light[6].config):
-    case PICA_REG_INDEX(lighting.light[7].config):
-        shader_dirty = true;
-        break;
-
-    // Fragment lighting distance attenuation bias
-    case PICA_REG_INDEX(lighting.light[0].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(7);
-        break;
-
-    // Fragment lighting distance attenuation scale
-    case PICA_REG_INDEX(lighting.light[0].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(7);
-        break;
+    set(PICA_REG_INDEX(texturing.tev_combiner_buffer_color),
+        [](RasterizerAccelerated& r, u32) { r.SyncCombinerColor(); });
+
+    // Fragment lighting per light state, the light index is recovered from the register id
+    constexpr std::size_t light_base = PICA_REG_INDEX(lighting.light[0]);
+    constexpr std::size_t light_stride =
+        PICA_REG_INDEX(lighting.light[1]) - PICA_REG_INDEX(lighting.light[0]);
+    const auto set_light = [&table](std::size_t light0_id, RegHandler handler) {
+        for (std::size_t light = 0; light < 8; light++) {
+            table[light0_id + light * light_stride] = handler;
+        }
+    };
+#define LIGHT_HANDLER(func)                                                                        \
+    [](RasterizerAccelerated& r, u32 id) {                                                         \
+        r.func(static_cast<int>((id - light_base) / light_stride));                                \
+    }
+    set_light(PICA_REG_INDEX(lighting.light[0].specular_0), LIGHT_HANDLER(SyncLightSpecular0));
+    set_light(PICA_REG_INDEX(lighting.light[0].specular_1), LIGHT_HANDLER(SyncLightSpecular1));
+    set_light(PICA_REG_INDEX(lighting.light[0].diffuse), LIGHT_HANDLER(SyncLightDiffuse));
+    set_light(PICA_REG_INDEX(lighting.light[0].ambient), LIGHT_HANDLER(SyncLightAmbient));
+    set_light(PICA_REG_INDEX(lighting.light[0].x), LIGHT_HANDLER(SyncLightPosition));
+    set_light(PICA_REG_INDEX(lighting.light[0].z), LIGHT_HANDLER(SyncLightPosition));
+    set_light(PICA_REG_INDEX(lighting.light[0].spot_x), LIGHT_HANDLER(SyncLightSpotDirection));
+    set_light(PICA_REG_INDEX(lighting.light[0].spot_z), LIGHT_HANDLER(SyncLightSpotDirection));
+    set_light(PICA_REG_INDEX(lighting.light[0].config), mark_shader_dirty);
+    set_light(PICA_REG_INDEX(lighting.light[0].dist_atten_bias),
+              LIGHT_HANDLER(SyncLightDistanceAttenuationBias));
+    set_light(PICA_REG_INDEX(lighting.light[0].dist_atten_scale),
+              LIGHT_HANDLER(SyncLightDistanceAttenuationScale));
+#undef LIGHT_HANDLER
 
     // Fragment lighting global ambient color (emission + ambient * ambient)
-    case PICA_REG_INDEX(lighting.global_ambient):
-        SyncGlobalAmbient();
-        break;
+    set(PICA_REG_INDEX(lighting.global_ambient),
+        [](RasterizerAccelerated& r, u32) { r.SyncGlobalAmbient(); });
 
     // Fragment lighting lookup tables
-    case PICA_REG_INDEX(lighting.lut_data[0]):
-    case PICA_REG_INDEX(lighting.lut_data[1]):
-    case PICA_REG_INDEX(lighting.lut_data[2]):
-    case PICA_REG_INDEX(lighting.lut_data[3]):
-    case PICA_REG_INDEX(lighting.lut_data[4]):
-    case PICA_REG_INDEX(lighting.lut_data[5]):
-    case PICA_REG_INDEX(lighting.lut_data[6]):
-    case PICA_REG_INDEX(lighting.lut_data[7]): {
-        const auto& lut_config = regs.lighting.lut_config;
-        fs_uniform_block_data.lighting_lut_dirty[lut_config.type] = true;
-        fs_uniform_block_data.lighting_lut_dirty_any = true;
-        break;
-    }
+    set(
+        PICA_REG_INDEX(lighting.lut_data[0]),
+        [](RasterizerAccelerated& r, u32) {
+            const auto& lut_config = r.regs.lighting.lut_config;
+            r.fs_uniform_block_data.lighting_lut_dirty[lut_config.type] = true;
+            r.fs_uniform_block_data.lighting_lut_dirty_any = true;
+        },
+        8);
 
     // Texture LOD biases
-    case PICA_REG_INDEX(texturing.texture0.lod.bias):
-        SyncTextureLodBias(0);
-        break;
-    case PICA_REG_INDEX(texturing.texture1.lod.bias):
-        SyncTextureLodBias(1);
-        break;
-    case PICA_REG_INDEX(texturing.texture2.lod.bias):
-        SyncTextureLodBias(2);
-        break;
+    set(PICA_REG_INDEX(texturing.texture0.lod.bias),
+        [](RasterizerAccelerated& r, u32) { r.SyncTextureLodBias(0); });
+    set(PICA_REG_INDEX(texturing.texture1.lod.bias),
+        [](RasterizerAccelerated& r, u32) { r.SyncTextureLodBias(1); });
+    set(PICA_REG_INDEX(texturing.texture2.lod.bias),
+        [](RasterizerAccelerated& r, u32) { r.SyncTextureLodBias(2); });
 
     // Texture borders
-    case PICA_REG_INDEX(texturing.texture0.border_color):
-        SyncTextureBorderColor(0);
-        break;
-    case PICA_REG_INDEX(texturing.texture1.border_color):
-        SyncTextureBorderColor(1);
-        break;
-    case PICA_REG_INDEX(texturing.texture2.border_color):
-        SyncTextureBorderColor(2);
-        break;
+    set(PICA_REG_INDEX(texturing.texture0.border_color),
+        [](RasterizerAccelerated& r, u32) { r.SyncTextureBorderColor(0); });
+    set(PICA_REG_INDEX(texturing.texture1.border_color),
+        [](RasterizerAccelerated& r, u32) { r.SyncTextureBorderColor(1); });
+    set(PICA_REG_INDEX(texturing.texture2.border_color),
+        [](RasterizerAccelerated& r, u32) { r.SyncTextureBorderColor(2); });
+
+    // Vertex shader uniforms, which the PICA also copies to the geometry shader unit while it is
+    // not in use and not configured on its own
+    const RegHandler vs_uniforms = [](RasterizerAccelerated& r, u32) {
+        r.vs_pica_uniforms_dirty = true;
+        if (!r.regs.pipeline.gs_unit_exclusive_configuration &&
+            r.regs.pipeline.use_gs == Pica::PipelineRegs::UseGS::No) {
+            r.gs_pica_uniforms_dirty = true;
+        }
+    };
+    set(PICA_REG_INDEX(vs.bool_uniforms), vs_uniforms);
+    set(PICA_REG_INDEX(vs.int_uniforms[0]), vs_uniforms, 4);
+    set(PICA_REG_INDEX(vs.uniform_setup.set_value[0]), vs_uniforms, 8);
+
+    // Geometry shader uniforms
+    const RegHandler gs_uniforms = [](RasterizerAccelerated& r, u32) {
+        r.gs_pica_uniforms_dirty = true;
+    };
+    set(PICA_REG_INDEX(gs.bool_uniforms), gs_uniforms);
+    set(PICA_REG_INDEX(gs.int_uniforms[0]), gs_uniforms, 4);
+    set(PICA_REG_INDEX(gs.uniform_setup.set_value[0]), gs_uniforms, 8);
 
     // Clipping plane
-    case PICA_REG_INDEX(rasterizer.clip_enable):
-    case PICA_REG_INDEX(rasterizer.clip_coef[0]):
-    case PICA_REG_INDEX(rasterizer.clip_coef[1]):
-    case PICA_REG_INDEX(rasterizer.clip_coef[2]):
-    case PICA_REG_INDEX(rasterizer.clip_coef[3]):
-        SyncClipPlane();
-        break;
+    const RegHandler clip_plane = [](RasterizerAccelerated& r, u32) { r.SyncClipPlane(); };
+    set(PICA_REG_INDEX(rasterizer.clip_enable), clip_plane);
+    set(PICA_REG_INDEX(rasterizer.clip_coef[0]), clip_plane, 4);
+
+    return table;
+}
+
+void RasterizerAccelerated::NotifyPicaRegisterChanged(u32 id) {
+    if (const RegHandler handler = reg_handlers[id]) {
+        handler(*this, id);
     }
 
     // Forward registers that map to fixed function API features to the video backend
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "common/hash.h"
 #include "common/vector_math.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/shader/generator/pica_fs_config.h"
@@ -24,8 +25,7 @@ public:
     explicit RasterizerAccelerated(Memory::MemorySystem& memory, Pica::PicaCore& pica);
     virtual ~RasterizerAccelerated() = default;
 
-    void AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
-                     const Pica::OutputVertex& v2) override;
+    void AddTriangles(std::span<const Pica::OutputVertex> vertices) override;
 
     void NotifyPicaRegisterChanged(u32 id) override;
 
@@ -150,6 +150,45 @@ protected:
     /// Retrieve the range and the size of the input vertex
     VertexArrayInfo AnalyzeVertexArray(bool is_indexed, u32 stride_alignment = 1);
 
+    /// Returns the size of an immediate mode vertex uploaded by LoadImmediateVertices
+    u32 ImmediateVertexStride() const;
+
+    /**
+     * Converts the immediate mode vertices to float attributes read by the hardware vertex
+     * shader, one vector per input attribute in attribute order.
+     */
+    void LoadImmediateVertices(std::span<const Pica::AttributeBuffer> vertices, u8* dst) const;
+
+    /**
+     * Converts the vertex shader uniforms written since the last call. Returns true when they
+     * differ from the ones uploaded last, meaning they have to be uploaded again.
+     */
+    bool SyncVSPicaUniforms();
+
+    /**
+     * Updates the stored content hash of a PICA lookup table. Returns true when the contents
+     * changed since the last call, meaning the table has to be converted and uploaded again.
+     */
+    template <typename Lut>
+    static bool UpdateLutHash(const Lut& lut, u64& hash) {
+        const u64 new_hash = Common::ComputeFastHash64(lut.data(), lut.size() * sizeof(lut[0]));
+        if (new_hash == hash) {
+            return false;
+        }
+        hash = new_hash;
+        return true;
+    }
+
+private:
+    /// Syncs the state derived from the PICA register with the given id
+    using RegHandler = void (*)(RasterizerAccelerated& rasterizer, u32 id);
+    using RegHandlerTable = std::array<RegHandler, Pica::RegsInternal::NUM_REGS>;
+
+    /// Builds the table of handlers indexed by register id, empty for untracked registers
+    static RegHandlerTable MakeRegHandlers();
+
+    static const RegHandlerTable reg_handlers;
+
 protected:
     Memory::MemorySystem& memory;
     Pica::PicaCore& pica;
@@ -158,17 +197,20 @@ protected:
     std::vector<HardwareVertex> vertex_batch;
     Pica::Shader::UserConfig user_config{};
     bool shader_dirty = true;
+    bool vs_pica_uniforms_dirty = true;
+    bool vs_pica_uniforms_changed = true;
+    bool gs_pica_uniforms_dirty = true;
 
+    Pica::Shader::Generator::VSPicaUniformData vs_pica_uniform_data{};
     VSUniformBlockData vs_uniform_block_data{};
     FSUniformBlockData fs_uniform_block_data{};
-    using LightLUT = std::array<Common::Vec2f, 256>;
-    std::array<LightLUT, Pica::LightingRegs::NumLightingSampler> lighting_lut_data{};
-    std::array<Common::Vec2f, 128> fog_lut_data{};
-    std::array<Common::Vec2f, 128> proctex_noise_lut_data{};
-    std::array<Common::Vec2f, 128> proctex_color_map_data{};
-    std::array<Common::Vec2f, 128> proctex_alpha_map_data{};
-    std::array<Common::Vec4f, 256> proctex_lut_data{};
-    std::array<Common::Vec4f, 256> proctex_diff_lut_data{};
+    std::array<u64, Pica::LightingRegs::NumLightingSampler> lighting_lut_hashes{};
+    u64 fog_lut_hash{};
+    u64 proctex_noise_lut_hash{};
+    u64 proctex_color_map_hash{};
+    u64 proctex_alpha_map_hash{};
+    u64 proctex_lut_hash{};
+    u64 proctex_diff_lut_hash{};
 };
 
 } // namespace VideoCore
@@ -0,0 +1,41 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/rasterizer_cache/decoded_texture_cache.h"
+
+namespace VideoCore {
+
+std::span<const u8> DecodedTextureCache::Find(u64 key) {
+    const auto it = lookup.find(key);
+    if (it == lookup.end()) {
+        return {};
+    }
+    // Most recently used entries are kept at the front
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+void DecodedTextureCache::Insert(u64 key, std::vector<u8>&& decoded) {
+    if (decoded.size() > capacity || lookup.contains(key)) {
+        return;
+    }
+    while (size + decoded.size() > capacity) {
+        size -= entries.back().second.size();
+        lookup.erase(entries.back().first);
+        entries.pop_back();
+    }
+    size += decoded.size();
+    entries.emplace_front(key, std::move(decoded));
+    lookup.emplace(key, entries.begin());
+}
+
+u64 DecodedTextureCache::Clear() {
+    const u64 freed = size;
+    entries.clear();
+    lookup.clear();
+    size = 0;
+    return freed;
+}
+
+} // namespace VideoCore
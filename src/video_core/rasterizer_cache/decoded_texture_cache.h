@@ -0,0 +1,43 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <list>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * Keeps the most recently decoded textures by the hash of their guest data and parameters.
+ * Titles often upload the same compressed texture to several surfaces, or again after it was
+ * evicted, and decoding ETC1 on the CPU costs a lot more than copying the result.
+ */
+class DecodedTextureCache {
+public:
+    explicit DecodedTextureCache(u64 capacity_) : capacity{capacity_} {}
+
+    /// Returns the decoded data with the key, or an empty span if it is not cached
+    [[nodiscard]] std::span<const u8> Find(u64 key);
+
+    /// Caches the decoded data with the key, evicting the least recently used data to fit it
+    void Insert(u64 key, std::vector<u8>&& decoded);
+
+    /// Drops all the cached data and returns the number of bytes freed
+    u64 Clear();
+
+private:
+    using Entry = std::pair<u64, std::vector<u8>>;
+
+    u64 capacity;
+    u64 size{};
+    std::list<Entry> entries;
+    std::unordered_map<u64, std::list<Entry>::iterator> lookup;
+};
+
+} // namespace VideoCore
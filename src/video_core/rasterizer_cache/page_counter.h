@@ -0,0 +1,105 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "core/memory.h"
+
+namespace VideoCore {
+
+/**
+ * Counts the cached surfaces touching every 4 KiB page of the physical address space. The counts
+ * are kept in a flat array, which makes updating them a linear walk over a few cache lines instead
+ * of an interval tree traversal, and only the runs of pages that start or stop being cached are
+ * reported back, so the memory system is notified as rarely as before.
+ */
+class PageCounter {
+public:
+    static constexpr u32 NUM_PAGES = static_cast<u32>(Memory::PAGE_TABLE_NUM_ENTRIES);
+
+    PageCounter() : counts(NUM_PAGES) {}
+
+    /**
+     * Adds delta to the count of every page touching the specified region.
+     * @param func Called with the address and size of each contiguous run of pages whose count
+     *             went from zero to non-zero (when delta is positive) or from non-zero to zero.
+     */
+    template <typename Func>
+    void Update(PAddr addr, u32 size, int delta, Func&& func) {
+        if (size == 0) {
+            return;
+        }
+        const u32 page_start = addr >> Memory::CITRA_PAGE_BITS;
+        const u32 page_end = static_cast<u32>(
+            std::min<u64>((static_cast<u64>(addr) + size - 1) >> Memory::CITRA_PAGE_BITS,
+                          NUM_PAGES - 1) +
+            1);
+
+        u32 run_start = 0;
+        u32 run_end = 0;
+        const auto flush_run = [&] {
+            if (run_start != run_end) {
+                func(run_start << Memory::CITRA_PAGE_BITS,
+                     (run_end - run_start) << Memory::CITRA_PAGE_BITS);
+            }
+        };
+        for (u32 page = page_start; page < page_end; page++) {
+            const int count = counts[page] + delta;
+            ASSERT_MSG(count >= 0 && count <= std::numeric_limits<u16>::max(),
+                       "Invalid cached count {} for page=0x{:x}", count,
+                       page << Memory::CITRA_PAGE_BITS);
+            counts[page] = static_cast<u16>(count);
+
+            const bool transitioned = delta > 0 ? count == delta : count == 0;
+            if (!transitioned) {
+                continue;
+            }
+            if (page != run_end) {
+                flush_run();
+                run_start = page;
+            }
+            run_end = page + 1;
+        }
+        flush_run();
+    }
+
+    /// Calls func with the address and size of each contiguous run of cached pages
+    template <typename Func>
+    void ForEachCachedRange(Func&& func) const {
+        u32 page = 0;
+        while (page < NUM_PAGES) {
+            if (counts[page] == 0) {
+                page++;
+                continue;
+            }
+            const u32 run_start = page;
+            while (page < NUM_PAGES && counts[page] != 0) {
+                page++;
+            }
+            const u32 run_size = (page - run_start) << Memory::CITRA_PAGE_BITS;
+            func(run_start << Memory::CITRA_PAGE_BITS, run_size);
+        }
+    }
+
+    /// Returns the number of cached surfaces touching the page containing addr
+    [[nodiscard]] u32 Count(PAddr addr) const {
+        return counts[addr >> Memory::CITRA_PAGE_BITS];
+    }
+
+    /// Resets the count of every page to zero
+    void Clear() {
+        std::fill(counts.begin(), counts.end(), u16{0});
+    }
+
+private:
+    std::vector<u16> counts;
+};
+
+} // namespace VideoCore
@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <tuple>
 #include <type_traits>
 #include <boost/container/small_vector.hpp>
 #include <boost/range/iterator_range.hpp>
 #include "common/alignment.h"
+#include "common/literals.h"
 #include "common/logging/log.h"
+#include "common/memory_budget.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/settings.h"
@@ -20,6 +24,7 @@
 #include "video_core/rasterizer_cache/surface_base.h"
 #include "video_core/renderer_base.h"
 #include "video_core/texture/texture_decode.h"
+#include "video_core/video_core.h"
 
 namespace VideoCore {
 
@@ -28,6 +33,9 @@ MICROPROFILE_DECLARE(RasterizerCache_UploadSurface);
 MICROPROFILE_DECLARE(RasterizerCache_DownloadSurface);
 MICROPROFILE_DECLARE(RasterizerCache_Invalidation);
 
+/// Bytes of decoded compressed textures kept to skip decoding identical uploads again
+constexpr u64 DECODED_TEXTURE_CAPACITY = 32ULL << 20;
+
 constexpr auto RangeFromInterval(const auto& map, const auto& interval) {
     return boost::make_iterator_range(map.equal_range(interval));
 }
@@ -37,12 +45,21 @@ RasterizerCache<T>::RasterizerCache(Memory::MemorySystem& memory_,
                                     CustomTexManager& custom_tex_manager_, Runtime& runtime_,
                                     Pica::RegsInternal& regs_, RendererBase& renderer_)
     : memory{memory_}, custom_tex_manager{custom_tex_manager_}, runtime{runtime_}, regs{regs_},
-      renderer{renderer_}, resolution_scale_factor{renderer.GetResolutionScaleFactor()},
+      renderer{renderer_}, page_table(NUM_PAGE_BUCKETS), decoded_textures{DECODED_TEXTURE_CAPACITY},
+      scale_policy{custom_tex_manager.GetScaleConfig()},
+      configured_scale_factor{renderer.GetResolutionScaleFactor()},
+      resolution_scale_factor{renderer.GetRenderScaleFactor()},
       filter{Settings::values.texture_filter.GetValue()},
       dump_textures{Settings::values.dump_textures.GetValue()},
+      gpu_texture_decode{Settings::values.gpu_texture_decode.GetValue()},
+      deduplicate_uploads{Settings::values.deduplicate_texture_uploads.GetValue()},
+      async_readback{Settings::values.async_surface_readback.GetValue() &&
+                     runtime.ReadbackCapacity() != 0},
       use_custom_textures{Settings::values.custom_textures.GetValue()} {
     using TextureConfig = Pica::TexturingRegs::TextureConfig;
 
+    scale_policy.SetHeuristicsEnabled(Settings::values.adaptive_target_scale.GetValue());
+
     // Create null handles for all cached resources
     void(slot_surfaces.insert(runtime, SurfaceParams{
                                            .width = 1,
@@ -77,10 +94,21 @@ RasterizerCache<T>::RasterizerCache(Memory::MemorySystem& memory_,
                                                    .color = {0.f, 0.f, 0.f, 0.f},
                                                },
                                        });
+
+    // The surfaces are the most expensive to rebuild, so they are trimmed last. Under critical
+    // pressure half of them go, otherwise a quarter.
+    memory_budget_handle = Common::MemoryBudget::Instance().AddCache(
+        "surfaces", Common::MemoryBudget::Priority::Surfaces,
+        [this](Common::MemoryPressure pressure) {
+            const u64 usage = memory_usage;
+            EvictSurfaces(pressure == Common::MemoryPressure::Critical ? usage / 2 : usage * 3 / 4);
+            return usage - memory_usage + decoded_textures.Clear();
+        });
 }
 
 template <class T>
 RasterizerCache<T>::~RasterizerCache() {
+    Common::MemoryBudget::Instance().RemoveCache(memory_budget_handle);
     ClearAll(false);
 }
 
@@ -88,20 +116,27 @@ template <class T>
 void RasterizerCache<T>::TickFrame() {
     custom_tex_manager.TickFrame();
     RunGarbageCollector();
+    EvictSurfaces(SurfaceMemoryBudget());
+    cpu_fallback_stats = std::exchange(cpu_fallbacks, {});
 
     const auto new_filter = Settings::values.texture_filter.GetValue();
     if (filter != new_filter) [[unlikely]] {
         filter = new_filter;
+        filtered_uploads.clear();
         UnregisterAll();
     }
 
     const u32 scale_factor = renderer.GetResolutionScaleFactor();
-    const bool resolution_scale_changed = resolution_scale_factor != scale_factor;
+    const bool resolution_scale_changed = configured_scale_factor != scale_factor;
     const bool use_custom_texture_changed =
         Settings::values.custom_textures.GetValue() != use_custom_textures;
 
+    // Dynamic resolution only changes the scale new surfaces are created at. Cached surfaces of
+    // the old scale are copied to the new one when they get rendered to again.
+    resolution_scale_factor = renderer.GetRenderScaleFactor();
+
     if (resolution_scale_changed || use_custom_texture_changed) {
-        resolution_scale_factor = scale_factor;
+        configured_scale_factor = scale_factor;
         use_custom_textures = Settings::values.custom_textures.GetValue();
         if (use_custom_textures) {
             custom_tex_manager.FindCustomTextures();
@@ -120,11 +155,100 @@ void RasterizerCache<T>::RunGarbageCollector() {
             continue;
         }
         RemoveFramebuffers(surface_id);
+        ForgetFilteredUploads(surface_id);
         slot_surfaces.erase(surface_id);
         it = sentenced.erase(it);
     }
 }
 
+template <class T>
+u64 RasterizerCache<T>::SurfaceMemoryBudget() const {
+    using namespace Common::Literals;
+    const u64 budget_mib = Settings::values.texture_memory_budget.GetValue();
+    if (budget_mib != 0) {
+        return budget_mib * 1_MiB;
+    }
+    // Leave the rest to the swapchain, stream buffers, pipelines and the driver itself.
+    const u64 device_budget = runtime.MemoryBudget() / 2;
+#ifdef ANDROID
+    // The GPU shares the memory with the system, whose low memory killer ignores the driver budget
+    const u64 host_budget = Common::MemoryBudget::Instance().CacheBudget() / 2;
+    return device_budget == 0 ? host_budget : std::min(device_budget, host_budget);
+#else
+    return device_budget;
+#endif
+}
+
+template <class T>
+void RasterizerCache<T>::EvictSurfaces(u64 budget) {
+    using namespace Common::Literals;
+    eviction_stats = {
+        .memory_usage = memory_usage,
+        .memory_budget = budget,
+    };
+    if (eviction_stats.memory_budget == 0 || memory_usage <= eviction_stats.memory_budget) {
+        return;
+    }
+
+    // Surfaces used in the last few frames are likely to be needed again right away, so evicting
+    // them would only thrash. Bound the write-backs too as each one stalls on a download.
+    static constexpr u64 MIN_IDLE_FRAMES = 4;
+    static constexpr u32 MAX_FLUSHES_PER_FRAME = 4;
+
+    struct Candidate {
+        SurfaceId surface_id;
+        u64 last_used_tick;
+        bool is_dirty;
+    };
+    std::vector<Candidate> candidates;
+    ForEachSurfaceInRegion(0, 0xFFFFFFFF, [&](SurfaceId surface_id, Surface& surface) {
+        if (surface.type == SurfaceType::Fill || True(surface.flags & SurfaceFlagBits::Tracked) ||
+            surface_id == bound_color_id || surface_id == bound_depth_id ||
+            frame_tick - surface.last_used_tick < MIN_IDLE_FRAMES) {
+            return;
+        }
+        candidates.push_back({surface_id, surface.last_used_tick,
+                              IsSurfaceDirty(surface_id, surface)});
+    });
+
+    // Clean surfaces can simply be reloaded from guest memory, so those go first.
+    std::ranges::sort(candidates, [](const Candidate& lhs, const Candidate& rhs) {
+        return std::tie(lhs.is_dirty, lhs.last_used_tick) <
+               std::tie(rhs.is_dirty, rhs.last_used_tick);
+    });
+
+    for (const Candidate& candidate : candidates) {
+        if (memory_usage <= eviction_stats.memory_budget) {
+            break;
+        }
+        if (candidate.is_dirty) {
+            if (eviction_stats.flushed_surfaces == MAX_FLUSHES_PER_FRAME) {
+                break;
+            }
+            const Surface& surface = slot_surfaces[candidate.surface_id];
+            FlushRegion(surface.addr, surface.size, candidate.surface_id);
+            eviction_stats.flushed_surfaces++;
+        }
+        eviction_stats.evicted_bytes += slot_surfaces[candidate.surface_id].charged_bytes;
+        eviction_stats.evicted_surfaces++;
+        UnregisterSurface(candidate.surface_id);
+    }
+
+    eviction_stats.memory_usage = memory_usage;
+    LOG_DEBUG(HW_GPU, "Evicted {} surfaces ({} flushed), {} MiB, now using {} of {} MiB",
+              eviction_stats.evicted_surfaces, eviction_stats.flushed_surfaces,
+              eviction_stats.evicted_bytes / 1_MiB, memory_usage / 1_MiB,
+              eviction_stats.memory_budget / 1_MiB);
+}
+
+template <class T>
+bool RasterizerCache<T>::IsSurfaceDirty(SurfaceId surface_id, const Surface& surface) const {
+    const auto [begin, end] = dirty_regions.equal_range(surface.GetInterval());
+    return std::any_of(begin, end, [surface_id](const auto& pair) {
+        return pair.second == surface_id;
+    });
+}
+
 template <class T>
 void RasterizerCache<T>::RemoveFramebuffers(SurfaceId surface_id) {
     for (auto it = framebuffers.begin(); it != framebuffers.end();) {
@@ -239,8 +363,16 @@ bool RasterizerCache<T>::AccelerateTextureCopy(const Pica::DisplayTransferConfig
     Surface& src_surface = slot_surfaces[src_surface_id];
     Surface& dst_surface = slot_surfaces[dst_surface_id];
 
-    if (dst_surface.type == SurfaceType::Texture ||
-        !CheckFormatsBlittable(src_surface.pixel_format, dst_surface.pixel_format)) {
+    // Texture formats can only be copied raw into a surface of the same format, anything else
+    // would need the texels reinterpreted. Custom textures no longer match the guest layout.
+    if (True((src_surface.flags | dst_surface.flags) & SurfaceFlagBits::Custom)) {
+        return false;
+    }
+    if (dst_surface.type == SurfaceType::Texture &&
+        dst_surface.pixel_format != src_surface.pixel_format) {
+        return false;
+    }
+    if (!CheckFormatsBlittable(src_surface.pixel_format, dst_surface.pixel_format)) {
         return false;
     }
 
@@ -358,6 +490,56 @@ bool RasterizerCache<T>::AccelerateFill(const Pica::MemoryFillConfig& config) {
     return true;
 }
 
+template <class T>
+bool RasterizerCache<T>::AccelerateY2R(const Y2RConfig& config) {
+    const DebugScope scope{runtime, Common::Vec4f{0.f, 1.f, 1.f, 1.f},
+                           "RasterizerCache::AccelerateY2R ({}x{})", config.width, config.height};
+
+    SurfaceParams dst_params;
+    dst_params.addr = config.dst_addr;
+    dst_params.width = config.width;
+    dst_params.height = config.height;
+    dst_params.is_tiled = true;
+    dst_params.pixel_format = config.output_format;
+    dst_params.UpdateParams();
+
+    // Rendering to the input planes must be written back, as they are read from memory
+    std::array<std::span<const u8>, 3> planes{};
+    for (std::size_t i = 0; i < planes.size(); i++) {
+        const auto& plane = config.planes[i];
+        if (plane.size == 0) {
+            continue;
+        }
+        FlushRegion(plane.addr, plane.size);
+        const MemoryRef plane_ptr = memory.GetPhysicalRef(plane.addr);
+        if (!plane_ptr) [[unlikely]] {
+            return false;
+        }
+        planes[i] = plane_ptr.GetReadBytes<u8>(plane.size);
+        if (planes[i].size() != plane.size) [[unlikely]] {
+            return false;
+        }
+    }
+
+    const SurfaceId dst_surface_id =
+        GetSurfaceSubRect(dst_params, ScaleMatch::Ignore, false).first;
+    if (!dst_surface_id) {
+        return false;
+    }
+
+    Surface& dst_surface = slot_surfaces[dst_surface_id];
+    const BufferTextureCopy upload = {
+        .texture_rect = dst_surface.GetSubRect(dst_params),
+        .texture_level = dst_surface.LevelOf(dst_params.addr),
+    };
+    if (!runtime.ConvertY2R(dst_surface, config, planes, upload)) {
+        return false;
+    }
+
+    InvalidateRegion(dst_params.addr, dst_params.size, dst_surface_id);
+    return true;
+}
+
 template <class T>
 typename T::Surface& RasterizerCache<T>::GetSurface(SurfaceId surface_id) {
     return slot_surfaces[surface_id];
@@ -427,7 +609,7 @@ void RasterizerCache<T>::CopySurface(Surface& src_surface, Surface& dst_surface,
     const u32 src_scale = src_surface.res_scale;
     const u32 dst_scale = dst_surface.res_scale;
     if (src_scale > dst_scale) {
-        dst_surface.ScaleUp(src_scale);
+        ScaleSurfaceUp(dst_surface, src_scale);
     }
 
     const auto src_rect = src_surface.GetScaledSubRect(subrect_params);
@@ -678,9 +860,22 @@ FramebufferHelper<T> RasterizerCache<T>::GetFramebufferSurfaces(bool using_color
         static_cast<u32>(std::clamp(viewport_rect.bottom, 0, framebuffer_height)),
     };
 
+    // Color and depth share the framebuffer, so both use the lower of their scales.
+    const auto target_scale = [&](PAddr addr) {
+        return scale_policy.TargetScale(addr, config.GetWidth(), config.GetHeight(),
+                                        resolution_scale_factor);
+    };
+    u32 fb_scale = resolution_scale_factor;
+    if (using_color_fb) {
+        fb_scale = std::min(fb_scale, target_scale(config.GetColorBufferPhysicalAddress()));
+    }
+    if (using_depth_fb) {
+        fb_scale = std::min(fb_scale, target_scale(config.GetDepthBufferPhysicalAddress()));
+    }
+
     SurfaceParams color_params;
     color_params.is_tiled = true;
-    color_params.res_scale = resolution_scale_factor;
+    color_params.res_scale = fb_scale;
     color_params.width = config.GetWidth();
     color_params.height = config.GetHeight();
     SurfaceParams depth_params = color_params;
@@ -748,6 +943,18 @@ FramebufferHelper<T> RasterizerCache<T>::GetFramebufferSurfaces(bool using_color
         .shadow_rendering = regs.framebuffer.IsShadowRendering(),
     };
 
+    // Bound render targets must never be evicted, whether or not readback tracks them.
+    bound_color_id = color_id;
+    bound_depth_id = depth_id;
+
+    // Switching render targets ends the previous render pass, start copying out what it drew
+    // so a later CPU read only has to wait for the GPU instead of stalling on a full download.
+    if (async_readback && this->fb_params != fb_params) {
+        QueueReadback(this->fb_params.color_id);
+        QueueReadback(this->fb_params.depth_id);
+        this->fb_params = fb_params;
+    }
+
     auto [it, new_framebuffer] = framebuffers.try_emplace(fb_params);
     if (new_framebuffer) {
         it->second = slot_framebuffers.insert(runtime, fb_params, color_surface, depth_surface);
@@ -792,15 +999,7 @@ void RasterizerCache<T>::ForEachSurfaceInRegion(PAddr addr, std::size_t size, Fu
     static constexpr bool BOOL_BREAK = std::is_same_v<FuncReturn, bool>;
     boost::container::small_vector<SurfaceId, 8> surfaces;
     ForEachPage(addr, size, [this, &surfaces, addr, size, func](u64 page) {
-        const auto it = page_table.find(page);
-        if (it == page_table.end()) {
-            if constexpr (BOOL_BREAK) {
-                return false;
-            } else {
-                return;
-            }
-        }
-        for (const SurfaceId surface_id : it->second) {
+        for (const SurfaceId surface_id : page_table[page]) {
             Surface& surface = slot_surfaces[surface_id];
             if (True(surface.flags & SurfaceFlagBits::Picked)) {
                 continue;
@@ -912,6 +1111,9 @@ SurfaceId RasterizerCache<T>::FindMatch(const SurfaceParams& params, ScaleMatch
             return std::make_pair(surface.CanTexCopy(params), surface.GetInterval());
         });
     });
+    if (match_id) {
+        slot_surfaces[match_id].last_used_tick = frame_tick;
+    }
     return match_id;
 }
 
@@ -969,6 +1171,13 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
             continue;
         }
 
+        // Clear the parts of fills that do not make a copyable rectangle.
+        const SurfaceInterval fill_interval = ValidateByFill(surface, interval);
+        if (!boost::icl::is_empty(fill_interval)) {
+            notify_validated(fill_interval);
+            continue;
+        }
+
         // Try to find surface in cache with different format
         // that can can be reinterpreted to the requested format.
         if (ValidateByReinterpretation(surface, params, interval)) {
@@ -977,10 +1186,15 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
         }
 
         FlushRegion(params.addr, params.size);
+        u64 upload_hash = 0;
         if (!use_custom_textures || !UploadCustomSurface(surface_id, interval)) {
-            UploadSurface(surface, interval);
+            upload_hash = UploadSurface(surface, interval);
         }
         notify_validated(params.GetInterval());
+        surface.upload_hashes[level] = upload_hash;
+        if (upload_hash != 0 && CanReuseFilteredUpload(surface, interval)) {
+            filtered_uploads.insert_or_assign(upload_hash, surface_id);
+        }
     }
 
     // Filtered mipmaps often look really bad. We can achieve better quality by
@@ -991,39 +1205,131 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
 }
 
 template <class T>
-void RasterizerCache<T>::UploadSurface(Surface& surface, SurfaceInterval interval) {
+u64 RasterizerCache<T>::UploadSurface(Surface& surface, SurfaceInterval interval) {
     MICROPROFILE_SCOPE(RasterizerCache_UploadSurface);
 
     const SurfaceParams load_info = surface.FromInterval(interval);
     ASSERT(load_info.addr >= surface.addr && load_info.end <= surface.end);
 
-    const auto staging = runtime.FindStaging(
-        load_info.width * load_info.height * surface.GetInternalBytesPerPixel(), true);
-
     MemoryRef source_ptr = memory.GetPhysicalRef(load_info.addr);
     if (!source_ptr) [[unlikely]] {
-        return;
+        return 0;
     }
 
     const auto upload_data = source_ptr.GetWriteBytes(load_info.end - load_info.addr);
-    DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, staging.mapped,
-                  runtime.NeedsConversion(surface.pixel_format));
+    BufferTextureCopy upload = {
+        .texture_rect = surface.GetSubRect(load_info),
+        .texture_level = surface.LevelOf(load_info.addr),
+    };
+
+    // Titles often stream identical data back into the same address after invalidating it.
+    // When the texture still holds that data there is nothing to decode or upload. Filtering is
+    // expensive enough that identical data uploaded to another surface is worth copying as well.
+    const bool reuse_filtered = CanReuseFilteredUpload(surface, interval);
+    const bool whole_level = interval == surface.LevelInterval(upload.texture_level);
+    u64 upload_hash = 0;
+    if (whole_level && (deduplicate_uploads || reuse_filtered)) {
+        upload_hash = Common::ComputeFastHash64(upload_data.data(), upload_data.size());
+        if (deduplicate_uploads && upload_hash == surface.upload_hashes[upload.texture_level]) {
+            MICROPROFILE_META_CPU("Deduplicated Uploads", 1);
+            return upload_hash;
+        }
+        if (reuse_filtered && CopyFilteredUpload(surface, upload.texture_level, upload_hash)) {
+            MICROPROFILE_META_CPU("Reused Filtered Uploads", 1);
+            return upload_hash;
+        }
+    }
+    if (!gpu_texture_decode || !runtime.UploadTiled(surface, load_info, upload_data, upload)) {
+        const auto staging = runtime.FindStaging(
+            load_info.width * load_info.height * surface.GetInternalBytesPerPixel(), true);
+        const bool convert = runtime.NeedsConversion(surface.pixel_format);
+        if (surface.pixel_format == PixelFormat::ETC1 ||
+            surface.pixel_format == PixelFormat::ETC1A4) {
+            DecodeCompressed(load_info, upload_data, upload_hash, convert, staging.mapped);
+        } else {
+            DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, staging.mapped,
+                          convert);
+        }
+
+        upload.buffer_offset = staging.offset;
+        upload.buffer_size = staging.size;
+        surface.Upload(upload, staging);
+    }
 
     const bool should_dump = False(surface.flags & SurfaceFlagBits::Custom) &&
                              False(surface.flags & SurfaceFlagBits::RenderTarget);
     if (dump_textures && should_dump) {
         const u64 hash = ComputeHash(load_info, upload_data);
-        const u32 level = surface.LevelOf(load_info.addr);
-        custom_tex_manager.DumpTexture(load_info, level, upload_data, hash);
+        custom_tex_manager.DumpTexture(load_info, upload.texture_level, upload_data, hash);
     }
+    return upload_hash;
+}
 
-    const BufferTextureCopy upload = {
-        .buffer_offset = staging.offset,
-        .buffer_size = staging.size,
-        .texture_rect = surface.GetSubRect(load_info),
-        .texture_level = surface.LevelOf(load_info.addr),
+template <class T>
+void RasterizerCache<T>::DecodeCompressed(const SurfaceParams& load_info,
+                                          std::span<u8> upload_data, u64 upload_hash,
+                                          bool convert, std::span<u8> dest) {
+    const u64 data_hash = upload_hash != 0
+                              ? upload_hash
+                              : Common::ComputeFastHash64(upload_data.data(), upload_data.size());
+    const u64 params_hash = (u64{load_info.width} << 40) | (u64{load_info.height} << 16) |
+                            (static_cast<u64>(load_info.pixel_format) << 1) | convert;
+    const u64 key = Common::HashCombine(data_hash, params_hash);
+    if (const auto decoded = decoded_textures.Find(key); !decoded.empty()) {
+        MICROPROFILE_META_CPU("Decoded Texture Hits", 1);
+        std::memcpy(dest.data(), decoded.data(), decoded.size());
+        return;
+    }
+    // Decoded apart from the staging buffer, which may be write combined and slow to read back
+    std::vector<u8> decoded(load_info.width * load_info.height * 4);
+    DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, decoded, convert);
+    std::memcpy(dest.data(), decoded.data(), decoded.size());
+    decoded_textures.Insert(key, std::move(decoded));
+}
+
+template <class T>
+bool RasterizerCache<T>::CanReuseFilteredUpload(const Surface& surface,
+                                                SurfaceInterval interval) const {
+    return filter != Settings::TextureFilter::None && surface.res_scale != 1 &&
+           surface.texture_type == TextureType::Texture2D &&
+           False(surface.flags & SurfaceFlagBits::Custom) &&
+           interval == surface.LevelInterval(surface.LevelOf(boost::icl::first(interval)));
+}
+
+template <class T>
+bool RasterizerCache<T>::CopyFilteredUpload(Surface& surface, u32 level, u64 upload_hash) {
+    const auto it = filtered_uploads.find(upload_hash);
+    if (it == filtered_uploads.end()) {
+        return false;
+    }
+    // Rendering or copying into the other surface clears its hash, so a matching hash means the
+    // level still holds the filtered result of this data.
+    Surface& source = slot_surfaces[it->second];
+    if (&source == &surface || source.upload_hashes[level] != upload_hash ||
+        source.pixel_format != surface.pixel_format || source.width != surface.width ||
+        source.height != surface.height || source.res_scale != surface.res_scale ||
+        source.levels <= level) {
+        return false;
+    }
+    const auto rect = surface.GetScaledRect(level);
+    const TextureCopy copy = {
+        .src_level = level,
+        .dst_level = level,
+        .src_offset = {0, 0},
+        .dst_offset = {0, 0},
+        .extent = {rect.GetWidth(), rect.GetHeight()},
     };
-    surface.Upload(upload, staging);
+    return runtime.CopyTextures(source, surface, copy);
+}
+
+template <class T>
+void RasterizerCache<T>::ForgetFilteredUploads(SurfaceId surface_id) {
+    for (const u64 upload_hash : slot_surfaces[surface_id].upload_hashes) {
+        const auto it = filtered_uploads.find(upload_hash);
+        if (it != filtered_uploads.end() && it->second == surface_id) {
+            filtered_uploads.erase(it);
+        }
+    }
 }
 
 template <class T>
@@ -1091,6 +1397,7 @@ bool RasterizerCache<T>::UploadCustomSurface(SurfaceId surface_id, SurfaceInterv
 template <class T>
 void RasterizerCache<T>::DownloadSurface(Surface& surface, SurfaceInterval interval) {
     MICROPROFILE_SCOPE(RasterizerCache_DownloadSurface);
+    CountFrameEvent(renderer.GetSystem(), Core::PerfStats::FrameCounter::CacheDownloads);
 
     const SurfaceParams flush_info = surface.FromInterval(interval);
     const u32 flush_start = boost::icl::first(interval);
@@ -1150,6 +1457,144 @@ void RasterizerCache<T>::DownloadFillSurface(Surface& surface, SurfaceInterval i
     }
 }
 
+template <class T>
+void RasterizerCache<T>::QueueReadback(SurfaceId surface_id) {
+    if (!surface_id) {
+        return;
+    }
+
+    Surface& surface = slot_surfaces[surface_id];
+    if (!surface.is_tiled || False(surface.flags & SurfaceFlagBits::Registered)) {
+        return;
+    }
+
+    // Readbacks older than half the ring may have been overwritten by the time they are read.
+    const u64 capacity = runtime.ReadbackCapacity();
+    const auto is_stale = [&](const Readback& readback) {
+        return readback_position - readback.position > capacity / 2;
+    };
+
+    for (const auto& [region, owner_id] : RangeFromInterval(dirty_regions, surface.GetInterval())) {
+        if (owner_id != surface_id) {
+            continue;
+        }
+
+        const auto interval = region & surface.GetInterval();
+        const u32 start_level = surface.LevelOf(interval.lower());
+        const u32 end_level = surface.LevelOf(interval.upper());
+        for (u32 level = start_level; level <= end_level; level++) {
+            const auto download_interval = interval & surface.LevelInterval(level);
+            if (boost::icl::is_empty(download_interval)) {
+                continue;
+            }
+
+            const bool is_queued = std::ranges::any_of(readbacks, [&](const Readback& readback) {
+                return readback.surface_id == surface_id &&
+                       boost::icl::contains(readback.interval, download_interval);
+            });
+            if (is_queued) {
+                continue;
+            }
+
+            const SurfaceParams flush_info = surface.FromInterval(download_interval);
+            const u32 size =
+                flush_info.width * flush_info.height * surface.GetInternalBytesPerPixel();
+            if (size > capacity / 4) {
+                continue;
+            }
+
+            const auto staging = runtime.FindReadback(size);
+            const BufferTextureCopy download = {
+                .buffer_offset = staging.offset,
+                .buffer_size = staging.size,
+                .texture_rect = surface.GetSubRect(flush_info),
+                .texture_level = level,
+            };
+            const u64 tick = surface.DownloadAsync(download, staging);
+            CountFrameEvent(renderer.GetSystem(), Core::PerfStats::FrameCounter::CacheDownloads);
+
+            readbacks.push_back(Readback{
+                .surface_id = surface_id,
+                .interval = download_interval,
+                .staging = staging,
+                .tick = tick,
+                .position = readback_position,
+            });
+            readback_position += size;
+            std::erase_if(readbacks, is_stale);
+        }
+    }
+}
+
+template <class T>
+bool RasterizerCache<T>::FinishReadback(SurfaceId surface_id, SurfaceInterval interval) {
+    const auto it = std::ranges::find_if(readbacks, [&](const Readback& readback) {
+        return readback.surface_id == surface_id &&
+               boost::icl::contains(readback.interval, interval);
+    });
+    if (it == readbacks.end() ||
+        readback_position - it->position > runtime.ReadbackCapacity() / 2) {
+        return false;
+    }
+
+    MICROPROFILE_SCOPE(RasterizerCache_DownloadSurface);
+
+    const u32 flush_start = boost::icl::first(interval);
+    const u32 flush_end = boost::icl::last_next(interval);
+    MemoryRef dest_ptr = memory.GetPhysicalRef(flush_start);
+    if (!dest_ptr) [[unlikely]] {
+        return true;
+    }
+
+    // The readback may cover more than the requested interval, so only encode the flushed part.
+    // The rest stays queued until the CPU touches it or the surface is drawn to again.
+    Surface& surface = slot_surfaces[surface_id];
+    const SurfaceParams flush_info = surface.FromInterval(it->interval);
+    runtime.WaitReadback(it->tick, it->staging);
+
+    const auto download_dest = dest_ptr.GetWriteBytes(flush_end - flush_start);
+    EncodeTexture(flush_info, flush_start, flush_end, it->staging.mapped, download_dest,
+                  runtime.NeedsConversion(surface.pixel_format));
+    return true;
+}
+
+template <class T>
+SurfaceInterval RasterizerCache<T>::ValidateByFill(Surface& surface, SurfaceInterval interval) {
+    const PAddr addr = interval.lower();
+    const u32 size = boost::icl::length(interval);
+    SurfaceId fill_id{};
+    ForEachSurfaceInRegion(addr, size, [&](SurfaceId surface_id, Surface& fill_surface) {
+        if (fill_surface.type != SurfaceType::Fill ||
+            !fill_surface.IsRegionValid(interval & fill_surface.GetInterval())) {
+            return false;
+        }
+        fill_id = surface_id;
+        return true;
+    });
+    if (!fill_id) {
+        return {};
+    }
+
+    Surface& fill_surface = slot_surfaces[fill_id];
+    const SurfaceInterval fill_interval = interval & fill_surface.GetInterval();
+    const auto rects = surface.SplitIntoRects(fill_interval);
+    if (rects.empty() || !fill_surface.CanFillFormat(surface.pixel_format)) {
+        cpu_fallbacks.fills++;
+        return {};
+    }
+
+    const u32 level = surface.LevelOf(fill_interval.lower());
+    for (const SurfaceSubRect& sub_rect : rects) {
+        const TextureClear clear = {
+            .texture_level = level,
+            .texture_rect = sub_rect.rect * surface.res_scale,
+            .value = fill_surface.MakeClearValue(sub_rect.addr, surface.pixel_format),
+        };
+        runtime.ClearTexture(surface, clear);
+    }
+    return fill_interval;
+}
+
 template <class T>
 bool RasterizerCache<T>::ValidateByReinterpretation(Surface& surface, SurfaceParams params,
                                                     const SurfaceInterval& interval) {
@@ -1163,7 +1608,7 @@ bool RasterizerCache<T>::ValidateByReinterpretation(Surface& surface, SurfacePar
         }
         const u32 res_scale = src_surface.res_scale;
         if (res_scale > surface.res_scale) {
-            surface.ScaleUp(res_scale);
+            ScaleSurfaceUp(surface, res_scale);
         }
         const PAddr addr = boost::icl::lower(interval);
         const SurfaceParams copy_params = surface.FromInterval(copy_interval);
@@ -1176,7 +1621,11 @@ bool RasterizerCache<T>::ValidateByReinterpretation(Surface& surface, SurfacePar
             .dst_offset = {dst_rect.left, dst_rect.bottom},
             .extent = {src_rect.GetWidth(), src_rect.GetHeight()},
         };
-        return runtime.Reinterpret(src_surface, surface, reinterpret);
+        if (!runtime.Reinterpret(src_surface, surface, reinterpret)) {
+            cpu_fallbacks.reinterpretations++;
+            return false;
+        }
+        return true;
     }
 
     // No surfaces were found in the cache that had a matching bit-width.
@@ -1205,26 +1654,27 @@ bool RasterizerCache<T>::IntervalHasInvalidPixelFormat(const SurfaceParams& para
 
 template <class T>
 void RasterizerCache<T>::ClearAll(bool flush) {
-    const auto flush_interval = PageMap::interval_type::right_open(0x0, 0xFFFFFFFF);
     // Force flush all surfaces from the cache
     if (flush) {
         FlushRegion(0x0, 0xFFFFFFFF);
     }
     // Unmark all of the marked pages
-    for (auto& pair : RangeFromInterval(cached_pages, flush_interval)) {
-        const auto interval = pair.first & flush_interval;
-
-        const PAddr interval_start_addr = boost::icl::first(interval) << Memory::CITRA_PAGE_BITS;
-        const PAddr interval_end_addr = boost::icl::last_next(interval) << Memory::CITRA_PAGE_BITS;
-        const u32 interval_size = interval_end_addr - interval_start_addr;
-
-        memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, false);
-    }
+    cached_pages.ForEachCachedRange([this](PAddr addr, u32 size) {
+        memory.RasterizerMarkRegionCached(addr, size, false);
+        memory.RasterizerMarkRegionDirty(addr, size, false);
+    });
 
     // Remove the whole cache without really looking at it.
-    cached_pages -= flush_interval;
+    cached_pages.Clear();
+    memory_usage = 0;
     dirty_regions.clear();
-    page_table.clear();
+    readbacks.clear();
+    filtered_uploads.clear();
+    scale_policy.Reset();
+    readback_targets.clear();
+    for (PageBucket& surfaces : page_table) {
+        surfaces.clear();
+    }
 }
 
 template <class T>
@@ -1247,6 +1697,7 @@ void RasterizerCache<T>::FlushRegion(PAddr addr, u32 size, SurfaceId flush_surfa
         const auto interval = size <= 8 ? region : region & flush_interval;
         Surface& surface = slot_surfaces[surface_id];
         ASSERT_MSG(surface.IsRegionValid(interval), "Region owner has invalid regions");
+        CountFrameEvent(renderer.GetSystem(), Core::PerfStats::FrameCounter::CacheFlushes);
 
         const DebugScope scope{runtime, Common::Vec4f{0.f, 0.f, 0.f, 1.f},
                                "RasterizerCache::FlushRegion (from {:#x} to {:#x})",
@@ -1258,6 +1709,15 @@ void RasterizerCache<T>::FlushRegion(PAddr addr, u32 size, SurfaceId flush_surfa
             continue;
         }
 
+        if (True(surface.flags & SurfaceFlagBits::RenderTarget)) {
+            if (surface.res_scale > 1) {
+                scale_policy.OnReadback(surface.addr);
+            }
+            if (!flush_surface_id) {
+                readback_targets.insert(surface.addr);
+            }
+        }
+
         // Download each requested level of the surface.
         const u32 start_level = surface.LevelOf(interval.lower());
         const u32 end_level = surface.LevelOf(interval.upper());
@@ -1266,12 +1726,16 @@ void RasterizerCache<T>::FlushRegion(PAddr addr, u32 size, SurfaceId flush_surfa
             if (boost::icl::is_empty(download_interval)) {
                 continue;
             }
+            if (async_readback && FinishReadback(surface_id, download_interval)) {
+                continue;
+            }
             DownloadSurface(surface, download_interval);
         }
     }
 
     // Reset dirty regions
     dirty_regions -= flushed_intervals;
+    UpdatePagesDirty(flushed_intervals);
 }
 
 template <class T>
@@ -1317,10 +1781,21 @@ void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, SurfaceId region
 
     if (region_owner_id) {
         dirty_regions.set({invalid_interval, region_owner_id});
+        memory.RasterizerMarkRegionDirty(addr, size, true);
     } else {
+        SurfaceRegions cleaned_intervals;
+        for (const auto& pair : RangeFromInterval(dirty_regions, invalid_interval)) {
+            cleaned_intervals += pair.first & invalid_interval;
+        }
         dirty_regions.erase(invalid_interval);
+        UpdatePagesDirty(cleaned_intervals);
     }
 
+    // Any queued readback of the region is now stale, whoever wrote to it.
+    std::erase_if(readbacks, [&](const Readback& readback) {
+        return boost::icl::intersects(readback.interval, invalid_interval);
+    });
+
     for (const SurfaceId surface_id : remove_surfaces) {
         UnregisterSurface(surface_id);
     }
@@ -1354,11 +1829,24 @@ void RasterizerCache<T>::RegisterSurface(SurfaceId surface_id) {
                "Trying to register an already registered surface");
 
     surface.flags |= SurfaceFlagBits::Registered;
+    surface.last_used_tick = frame_tick;
+    surface.charged_bytes = surface.HostMemoryUsage();
+    memory_usage += surface.charged_bytes;
     UpdatePagesCachedCount(surface.addr, surface.size, 1);
     ForEachPage(surface.addr, surface.size,
                 [this, surface_id](u64 page) { page_table[page].push_back(surface_id); });
 }
 
+template <class T>
+void RasterizerCache<T>::ScaleSurfaceUp(Surface& surface, u32 new_scale) {
+    surface.ScaleUp(new_scale);
+    if (True(surface.flags & SurfaceFlagBits::Registered)) {
+        memory_usage -= surface.charged_bytes;
+        surface.charged_bytes = surface.HostMemoryUsage();
+        memory_usage += surface.charged_bytes;
+    }
+}
+
 template <class T>
 void RasterizerCache<T>::UnregisterSurface(SurfaceId surface_id) {
     Surface& surface = slot_surfaces[surface_id];
@@ -1366,14 +1854,11 @@ void RasterizerCache<T>::UnregisterSurface(SurfaceId surface_id) {
                "Trying to unregister an already unregistered surface");
 
     surface.flags &= ~SurfaceFlagBits::Registered;
+    memory_usage -= surface.charged_bytes;
+    surface.charged_bytes = 0;
     UpdatePagesCachedCount(surface.addr, surface.size, -1);
     ForEachPage(surface.addr, surface.size, [this, surface_id](u64 page) {
-        const auto page_it = page_table.find(page);
-        if (page_it == page_table.end()) {
-            ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}", page << CITRA_PAGEBITS);
-            return;
-        }
-        std::vector<SurfaceId>& surfaces = page_it.value();
+        PageBucket& surfaces = page_table[page];
         const auto vector_it = std::find(surfaces.begin(), surfaces.end(), surface_id);
         if (vector_it == surfaces.end()) {
             ASSERT_MSG(false, "Unregistering unregistered surface in page=0x{:x}",
@@ -1383,6 +1868,19 @@ void RasterizerCache<T>::UnregisterSurface(SurfaceId surface_id) {
         surfaces.erase(vector_it);
     });
 
+    std::erase_if(readbacks, [surface_id](const Readback& readback) {
+        return readback.surface_id == surface_id;
+    });
+    if (fb_params.color_id == surface_id || fb_params.depth_id == surface_id) {
+        fb_params = {};
+    }
+    if (bound_color_id == surface_id) {
+        bound_color_id = {};
+    }
+    if (bound_depth_id == surface_id) {
+        bound_depth_id = {};
+    }
+
     if (surface.type != SurfaceType::Fill) {
         RemoveTextureCubeFace(surface_id);
         sentenced.emplace_back(surface_id, frame_tick);
@@ -1395,7 +1893,7 @@ void RasterizerCache<T>::UnregisterSurface(SurfaceId surface_id) {
 template <class T>
 void RasterizerCache<T>::UnregisterAll() {
     FlushAll();
-    for (auto& [page, surfaces] : page_table) {
+    for (PageBucket& surfaces : page_table) {
         while (!surfaces.empty()) {
             UnregisterSurface(surfaces.back());
         }
@@ -1406,39 +1904,23 @@ void RasterizerCache<T>::UnregisterAll() {
 }
 
 template <class T>
-void RasterizerCache<T>::UpdatePagesCachedCount(PAddr addr, u32 size, int delta) {
-    const u32 num_pages =
-        ((addr + size - 1) >> Memory::CITRA_PAGE_BITS) - (addr >> Memory::CITRA_PAGE_BITS) + 1;
-    const u32 page_start = addr >> Memory::CITRA_PAGE_BITS;
-    const u32 page_end = page_start + num_pages;
-
-    // Interval maps will erase segments if count reaches 0, so if delta is negative we have to
-    // subtract after iterating
-    const auto pages_interval = PageMap::interval_type::right_open(page_start, page_end);
-    if (delta > 0) {
-        cached_pages.add({pages_interval, delta});
-    }
-
-    for (const auto& pair : RangeFromInterval(cached_pages, pages_interval)) {
-        const auto interval = pair.first & pages_interval;
-        const int count = pair.second;
-
-        const PAddr interval_start_addr = boost::icl::first(interval) << Memory::CITRA_PAGE_BITS;
-        const PAddr interval_end_addr = boost::icl::last_next(interval) << Memory::CITRA_PAGE_BITS;
-        const u32 interval_size = interval_end_addr - interval_start_addr;
-
-        if (delta > 0 && count == delta) {
-            memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, true);
-        } else if (delta < 0 && count == -delta) {
-            memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, false);
-        } else {
-            ASSERT(count >= 0);
+void RasterizerCache<T>::UpdatePagesDirty(const SurfaceRegions& regions) {
+    for (const auto& interval : regions) {
+        const PAddr end = boost::icl::last_next(interval);
+        PAddr page = boost::icl::first(interval) & ~Memory::CITRA_PAGE_MASK;
+        for (; page < end; page += Memory::CITRA_PAGE_SIZE) {
+            const SurfaceInterval page_interval{page, page + Memory::CITRA_PAGE_SIZE};
+            const bool is_dirty = boost::icl::intersects(dirty_regions, page_interval);
+            memory.RasterizerMarkRegionDirty(page, Memory::CITRA_PAGE_SIZE, is_dirty);
         }
     }
+}
 
-    if (delta < 0) {
-        cached_pages.add({pages_interval, delta});
-    }
+template <class T>
+void RasterizerCache<T>::UpdatePagesCachedCount(PAddr addr, u32 size, int delta) {
+    cached_pages.Update(addr, size, delta, [this, delta](PAddr run_addr, u32 run_size) {
+        memory.RasterizerMarkRegionCached(run_addr, run_size, delta > 0);
+    });
 }
 
 } // namespace VideoCore
@@ -9,14 +9,20 @@
 #include <optional>
 #include <span>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include <boost/container/small_vector.hpp>
 #include <boost/icl/interval_map.hpp>
-#include <tsl/robin_map.h>
 
+#include "video_core/rasterizer_cache/decoded_texture_cache.h"
 #include "video_core/rasterizer_cache/framebuffer_base.h"
+#include "video_core/rasterizer_cache/page_counter.h"
+#include "video_core/rasterizer_cache/scale_policy.h"
 #include "video_core/rasterizer_cache/sampler_params.h"
+#include "video_core/rasterizer_cache/surface_base.h"
 #include "video_core/rasterizer_cache/surface_params.h"
 #include "video_core/rasterizer_cache/texture_cube.h"
+#include "video_core/rasterizer_cache/utils.h"
 
 namespace Memory {
 class MemorySystem;
@@ -57,10 +63,26 @@ DECLARE_ENUM_FLAG_OPERATORS(MatchFlags);
 class CustomTexManager;
 class RendererBase;
 
+/// Surface eviction statistics of the last frame
+struct SurfaceEvictionStats {
+    u64 memory_usage{};     ///< Estimated host memory of the registered surfaces after eviction
+    u64 memory_budget{};    ///< Memory the surfaces may use, zero if unlimited
+    u64 evicted_bytes{};    ///< Estimated host memory of the evicted surfaces
+    u32 evicted_surfaces{}; ///< Number of evicted surfaces
+    u32 flushed_surfaces{}; ///< Number of evicted surfaces that were written back first
+};
+
+/// Surface validations of the last frame that could not be done on the GPU
+struct CpuFallbackStats {
+    u32 reinterpretations{}; ///< Regions written in another format without a GPU reinterpretation
+    u32 fills{};             ///< Regions written by a fill that could not be cleared on the GPU
+};
+
 template <class T>
 class RasterizerCache {
-    /// Address shift for caching surfaces into a hash table
+    /// Address shift for bucketing surfaces in the page table
     static constexpr u64 CITRA_PAGEBITS = 18;
+    static constexpr u64 NUM_PAGE_BUCKETS = 1ULL << (32 - CITRA_PAGEBITS);
 
     using Runtime = typename T::Runtime;
     using Sampler = typename T::Sampler;
@@ -73,7 +95,15 @@ class RasterizerCache {
                                                 boost::icl::inter_section, SurfaceInterval>;
 
     using SurfaceRect_Tuple = std::pair<SurfaceId, Common::Rectangle<u32>>;
-    using PageMap = boost::icl::interval_map<u32, int>;
+    using PageBucket = boost::container::small_vector<SurfaceId, 4>;
+
+    struct Readback {
+        SurfaceId surface_id;
+        SurfaceInterval interval;
+        StagingData staging;
+        u64 tick;
+        u64 position;
+    };
 
 public:
     explicit RasterizerCache(Memory::MemorySystem& memory, CustomTexManager& custom_tex_manager,
@@ -83,6 +113,21 @@ public:
     /// Notify the cache that a new frame has been queued
     void TickFrame();
 
+    /// Returns true if the render target at addr was flushed for a read by the guest
+    bool IsReadbackTarget(PAddr addr) const {
+        return readback_targets.contains(addr);
+    }
+
+    /// Returns the eviction statistics of the last frame
+    const SurfaceEvictionStats& GetEvictionStats() const noexcept {
+        return eviction_stats;
+    }
+
+    /// Returns the validations of the last frame that fell back to the CPU
+    const CpuFallbackStats& GetCpuFallbackStats() const noexcept {
+        return cpu_fallback_stats;
+    }
+
     /// Perform hardware accelerated texture copy according to the provided configuration
     bool AccelerateTextureCopy(const Pica::DisplayTransferConfig& config);
 
@@ -92,6 +137,9 @@ public:
     /// Perform hardware accelerated memory fill according to the provided configuration
     bool AccelerateFill(const Pica::MemoryFillConfig& config);
 
+    /// Perform hardware accelerated Y2R conversion according to the provided configuration
+    bool AccelerateY2R(const Y2RConfig& config);
+
     /// Returns a reference to the surface object assigned to surface_id
     Surface& GetSurface(SurfaceId surface_id);
 
@@ -141,7 +189,8 @@ private:
     template <typename Func>
     void ForEachPage(PAddr addr, std::size_t size, Func&& func) {
         static constexpr bool RETURNS_BOOL = std::is_same_v<std::invoke_result<Func, u64>, bool>;
-        const u64 page_end = (addr + size - 1) >> CITRA_PAGEBITS;
+        const u64 page_end =
+            std::min<u64>((addr + size - 1) >> CITRA_PAGEBITS, NUM_PAGE_BUCKETS - 1);
         for (u64 page = addr >> CITRA_PAGEBITS; page <= page_end; ++page) {
             if constexpr (RETURNS_BOOL) {
                 if (func(page)) {
@@ -165,6 +214,15 @@ private:
     /// Unregisters sentenced surfaces that have surpassed the destruction threshold.
     void RunGarbageCollector();
 
+    /// Returns the host memory the registered surfaces may use, zero if unlimited.
+    u64 SurfaceMemoryBudget() const;
+
+    /// Unregisters the least recently used surfaces until they fit in the memory budget.
+    void EvictSurfaces(u64 budget);
+
+    /// Returns true if the surface owns regions that have not been flushed to guest memory.
+    bool IsSurfaceDirty(SurfaceId surface_id, const Surface& surface) const;
+
     /// Removes any framebuffers that reference the provided surface_id.
     void RemoveFramebuffers(SurfaceId surface_id);
 
@@ -177,8 +235,26 @@ private:
     /// Update surface's texture for given region when necessary
     void ValidateSurface(SurfaceId surface, PAddr addr, u32 size);
 
-    /// Copies pixel data in interval from the guest VRAM to the host GPU surface
-    void UploadSurface(Surface& surface, SurfaceInterval interval);
+    /**
+     * Copies pixel data in interval from the guest VRAM to the host GPU surface
+     * @returns Hash of the guest data when upload deduplication or filtered upload reuse applies
+     *          and the interval covers a whole level, zero otherwise
+     */
+    u64 UploadSurface(Surface& surface, SurfaceInterval interval);
+
+    /// Decodes a compressed texture into dest, reusing the result of identical earlier uploads
+    void DecodeCompressed(const SurfaceParams& load_info, std::span<u8> upload_data,
+                          u64 upload_hash, bool convert, std::span<u8> dest);
+
+    /// Returns true when uploads to the interval of surface run through the texture filter and
+    /// their result can be shared with other surfaces holding identical data
+    bool CanReuseFilteredUpload(const Surface& surface, SurfaceInterval interval) const;
+
+    /// Copies the already filtered level of another surface that was uploaded from identical data
+    bool CopyFilteredUpload(Surface& surface, u32 level, u64 upload_hash);
+
+    /// Drops the filtered uploads of surface_id from the reuse map
+    void ForgetFilteredUploads(SurfaceId surface_id);
 
     /// Uploads a custom texture identified with hash to the target surface
     bool UploadCustomSurface(SurfaceId surface_id, SurfaceInterval interval);
@@ -189,6 +265,15 @@ private:
     /// Downloads a fill surface to guest VRAM
     void DownloadFillSurface(Surface& surface, SurfaceInterval interval);
 
+    /// Queues asynchronous downloads of the dirty regions owned by the render target
+    void QueueReadback(SurfaceId surface_id);
+
+    /// Writes interval back to guest VRAM from a queued readback, returns false if none covers it
+    bool FinishReadback(SurfaceId surface_id, SurfaceInterval interval);
+
+    /// Clears the part of interval covered by a valid fill surface, returning the cleared interval
+    SurfaceInterval ValidateByFill(Surface& surface, SurfaceInterval interval);
+
     /// Attempt to find a reinterpretable surface in the cache and use it to copy for validation
     bool ValidateByReinterpretation(Surface& surface, SurfaceParams params,
                                     const SurfaceInterval& interval);
@@ -205,12 +290,18 @@ private:
     /// Remove surface from the cache
     void UnregisterSurface(SurfaceId surface);
 
+    /// Rescales the surface, updating the memory charged for it when it is registered
+    void ScaleSurfaceUp(Surface& surface, u32 new_scale);
+
     /// Unregisters all surfaces from the cache
     void UnregisterAll();
 
     /// Increase/decrease the number of surface in pages touching the specified region
     void UpdatePagesCachedCount(PAddr addr, u32 size, int delta);
 
+    /// Marks the pages touching regions as dirty if they still overlap a dirty region
+    void UpdatePagesDirty(const SurfaceRegions& regions);
+
 private:
     Memory::MemorySystem& memory;
     CustomTexManager& custom_tex_manager;
@@ -218,7 +309,7 @@ private:
     Pica::RegsInternal& regs;
     RendererBase& renderer;
     std::unordered_map<TextureCubeConfig, TextureCube> texture_cube_cache;
-    tsl::robin_pg_map<u64, std::vector<SurfaceId>, Common::IdentityHash<u64>> page_table;
+    std::vector<PageBucket> page_table;
     std::unordered_map<FramebufferParams, FramebufferId> framebuffers;
     std::unordered_map<SamplerParams, SamplerId> samplers;
     std::list<std::pair<SurfaceId, u64>> sentenced;
@@ -226,12 +317,29 @@ private:
     Common::SlotVector<Sampler> slot_samplers;
     Common::SlotVector<Framebuffer> slot_framebuffers;
     SurfaceMap dirty_regions;
-    PageMap cached_pages;
+    PageCounter cached_pages;
+    std::unordered_map<u64, SurfaceId> filtered_uploads;
+    DecodedTextureCache decoded_textures;
+    ScalePolicy scale_policy;
+    std::unordered_set<PAddr> readback_targets;
+    std::vector<Readback> readbacks;
+    u64 readback_position{};
+    u32 configured_scale_factor;
     u32 resolution_scale_factor;
     u64 frame_tick{};
+    u64 memory_usage{};
+    SurfaceEvictionStats eviction_stats{};
+    CpuFallbackStats cpu_fallbacks{};
+    CpuFallbackStats cpu_fallback_stats{};
+    std::size_t memory_budget_handle{};
     FramebufferParams fb_params;
+    SurfaceId bound_color_id{};
+    SurfaceId bound_depth_id{};
     Settings::TextureFilter filter;
     bool dump_textures;
+    bool gpu_texture_decode;
+    bool deduplicate_uploads;
+    bool async_readback;
     bool use_custom_textures;
 };
 
@@ -0,0 +1,37 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+
+#include "video_core/rasterizer_cache/scale_policy.h"
+
+namespace VideoCore {
+
+u32 ScalePolicy::TargetScale(PAddr addr, u32 width, u32 height, u32 scale_factor) const {
+    if (scale_factor <= 1) {
+        return scale_factor;
+    }
+    if (const auto it = config.targets.find(addr); it != config.targets.end()) {
+        return it->second == 0 ? scale_factor : std::min(it->second, scale_factor);
+    }
+    if (!use_heuristics) {
+        return scale_factor;
+    }
+    if (width <= config.small_target_size && height <= config.small_target_size) {
+        return 1;
+    }
+    const auto it = readback_counts.find(addr);
+    if (it != readback_counts.end() && it->second >= config.readback_threshold) {
+        return 1;
+    }
+    return scale_factor;
+}
+
+void ScalePolicy::OnReadback(PAddr addr) {
+    if (use_heuristics) {
+        readback_counts[addr]++;
+    }
+}
+
+} // namespace VideoCore
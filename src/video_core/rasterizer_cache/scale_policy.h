@@ -0,0 +1,55 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/// Per-title tuning of the render target scale heuristics, read from scale.json next to the
+/// custom texture pack config of the title.
+struct ScaleConfig {
+    /// Targets no larger than this in either dimension are rendered at native resolution.
+    u32 small_target_size = 64;
+    /// Targets downloaded this many times are rendered at native resolution from then on.
+    u32 readback_threshold = 8;
+    /// Scale of the targets at specific addresses. Zero selects the configured scale.
+    std::unordered_map<PAddr, u32> targets;
+};
+
+/**
+ * Picks the scale each render target is created at. Upscaling tiny intermediate targets has no
+ * visible benefit, and targets the guest keeps reading back have to be downscaled on every
+ * download, so both are kept at native resolution while the main targets use the full scale.
+ */
+class ScalePolicy {
+public:
+    explicit ScalePolicy(const ScaleConfig& config_) : config{config_} {}
+
+    /// Enables the size and readback heuristics. Per-title overrides apply regardless.
+    void SetHeuristicsEnabled(bool enabled) noexcept {
+        use_heuristics = enabled;
+    }
+
+    /// Returns the scale a render target at addr with the provided dimensions is rendered at
+    [[nodiscard]] u32 TargetScale(PAddr addr, u32 width, u32 height, u32 scale_factor) const;
+
+    /// Records that the render target at addr was downloaded by the guest
+    void OnReadback(PAddr addr);
+
+    /// Forgets the readback history of all targets
+    void Reset() {
+        readback_counts.clear();
+    }
+
+private:
+    const ScaleConfig& config;
+    std::unordered_map<PAddr, u32> readback_counts;
+    bool use_heuristics{};
+};
+
+} // namespace VideoCore
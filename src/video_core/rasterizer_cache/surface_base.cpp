@@ -14,34 +14,35 @@ SurfaceBase::SurfaceBase(const SurfaceParams& params) : SurfaceParams{params} {}
 SurfaceBase::~SurfaceBase() = default;
 
 bool SurfaceBase::CanFill(const SurfaceParams& dest_surface, SurfaceInterval fill_interval) const {
-    if (type == SurfaceType::Fill && IsRegionValid(fill_interval) &&
-        boost::icl::first(fill_interval) >= addr &&
-        boost::icl::last_next(fill_interval) <= end && // dest_surface is within our fill range
-        dest_surface.FromInterval(fill_interval).GetInterval() ==
-            fill_interval) { // make sure interval is a rectangle in dest surface
-        if (fill_size * 8 != dest_surface.GetFormatBpp()) {
-            // Check if bits repeat for our fill_size
-            const u32 dest_bytes_per_pixel = std::max(dest_surface.GetFormatBpp() / 8, 1u);
-            std::vector<u8> fill_test(fill_size * dest_bytes_per_pixel);
-
-            for (u32 i = 0; i < dest_bytes_per_pixel; ++i) {
-                std::memcpy(&fill_test[i * fill_size], &fill_data[0], fill_size);
-            }
-
-            for (u32 i = 0; i < fill_size; ++i) {
-                if (std::memcmp(&fill_test[dest_bytes_per_pixel * i], &fill_test[0],
-                                dest_bytes_per_pixel) != 0) {
-                    return false;
-                }
-            }
-
-            if (dest_surface.GetFormatBpp() == 4 && (fill_test[0] & 0xF) != (fill_test[0] >> 4)) {
-                return false;
-            }
-        }
+    return type == SurfaceType::Fill && IsRegionValid(fill_interval) &&
+           boost::icl::first(fill_interval) >= addr &&
+           boost::icl::last_next(fill_interval) <= end && // dest_surface is within our fill range
+           dest_surface.FromInterval(fill_interval).GetInterval() ==
+               fill_interval && // make sure interval is a rectangle in dest surface
+           CanFillFormat(dest_surface.pixel_format);
+}
+
+bool SurfaceBase::CanFillFormat(PixelFormat format) const {
+    const u32 dest_bpp = VideoCore::GetFormatBpp(format);
+    if (fill_size * 8 == dest_bpp) {
         return true;
     }
-    return false;
+    // Check if bits repeat for our fill_size
+    const u32 dest_bytes_per_pixel = std::max(dest_bpp / 8, 1u);
+    std::vector<u8> fill_test(fill_size * dest_bytes_per_pixel);
+
+    for (u32 i = 0; i < dest_bytes_per_pixel; ++i) {
+        std::memcpy(&fill_test[i * fill_size], &fill_data[0], fill_size);
+    }
+
+    for (u32 i = 0; i < fill_size; ++i) {
+        if (std::memcmp(&fill_test[dest_bytes_per_pixel * i], &fill_test[0],
+                        dest_bytes_per_pixel) != 0) {
+            return false;
+        }
+    }
+
+    return dest_bpp != 4 || (fill_test[0] & 0xF) == (fill_test[0] >> 4);
 }
 
 bool SurfaceBase::CanCopy(const SurfaceParams& dest_surface, SurfaceInterval copy_interval) const {
@@ -126,6 +127,17 @@ bool SurfaceBase::HasNormalMap() const noexcept {
     return material && material->Map(MapType::Normal) != nullptr;
 }
 
+u64 SurfaceBase::HostMemoryUsage() const noexcept {
+    if (type == SurfaceType::Fill) {
+        return 0;
+    }
+    const u64 level_size =
+        static_cast<u64>(GetScaledWidth()) * GetScaledHeight() * GetFormatBpp() / 8;
+    // The full mipmap chain adds up to a third of the base level
+    const u64 texture_size = levels > 1 ? level_size * 4 / 3 : level_size;
+    return texture_type == TextureType::CubeMap ? texture_size * 6 : texture_size;
+}
+
 ClearValue SurfaceBase::MakeClearValue(PAddr copy_addr, PixelFormat dst_format) {
     const SurfaceType dst_type = GetFormatType(dst_format);
     const std::array fill_buffer = MakeFillBuffer(copy_addr);
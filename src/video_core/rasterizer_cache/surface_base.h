@@ -32,6 +32,9 @@ public:
     /// Returns true when this surface can be used to fill the fill_interval of dest_surface
     bool CanFill(const SurfaceParams& dest_surface, SurfaceInterval fill_interval) const;
 
+    /// Returns true when the fill pattern of this surface repeats for every pixel of format
+    bool CanFillFormat(PixelFormat format) const;
+
     /// Returns true when surface can validate copy_interval of dest_surface
     bool CanCopy(const SurfaceParams& dest_surface, SurfaceInterval copy_interval) const;
 
@@ -47,6 +50,9 @@ public:
     /// Returns true if the surface contains a custom material with a normal map.
     bool HasNormalMap() const noexcept;
 
+    /// Returns an estimate of the host memory used by the scaled surface texture.
+    u64 HostMemoryUsage() const noexcept;
+
     bool Overlaps(PAddr overlap_addr, std::size_t overlap_size) const noexcept {
         const PAddr overlap_end = overlap_addr + static_cast<PAddr>(overlap_size);
         return addr < overlap_end && overlap_addr < end;
@@ -67,6 +73,11 @@ public:
     void MarkValid(SurfaceInterval interval) {
         invalid_regions.erase(interval);
         modification_tick++;
+        for (u32 level = 0; level < levels; level++) {
+            if (boost::icl::intersects(LevelInterval(level), interval)) {
+                upload_hashes[level] = 0;
+            }
+        }
     }
 
     void MarkInvalid(SurfaceInterval interval) {
@@ -90,6 +101,12 @@ public:
     u32 fill_size = 0;
     std::array<u8, 4> fill_data;
     u64 modification_tick = 1;
+    u64 last_used_tick = 0;
+    /// Host memory counted in the usage of the cache for this surface while it is registered
+    u64 charged_bytes = 0;
+    /// Hash of the guest data each level was last uploaded from, zero if the level has been
+    /// written by other means since. Invalidation keeps them, as the texture still holds the data.
+    std::array<u64, MAX_PICA_LEVELS> upload_hashes{};
 };
 
 } // namespace VideoCore
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <bit>
 #include "common/alignment.h"
 #include "video_core/rasterizer_cache/surface_params.h"
 
@@ -146,6 +147,91 @@ SurfaceParams SurfaceParams::FromInterval(SurfaceInterval interval) const {
     return params;
 }
 
+std::vector<SurfaceSubRect> SurfaceParams::SplitIntoRects(SurfaceInterval interval) const {
+    const u32 level = LevelOf(interval.lower());
+    const PAddr start = mipmap_offsets[level];
+    const u32 first_offset = boost::icl::first(interval) - start;
+    const u32 last_offset = boost::icl::last_next(interval) - start;
+    u32 pixel = PixelsInBytes(first_offset);
+    const u32 last_pixel = PixelsInBytes(last_offset);
+    if (BytesInPixels(pixel) != first_offset || BytesInPixels(last_pixel) != last_offset) {
+        return {};
+    }
+
+    const u32 width_lod = width >> level;
+    const u32 height_lod = height >> level;
+    const u32 stride_lod = stride >> level;
+    std::vector<SurfaceSubRect> rects;
+    const auto add_rect = [&](u32 x, u32 y, u32 rect_width, u32 rect_height) {
+        const u32 right = std::min(x + rect_width, width_lod);
+        if (x >= right) {
+            return;
+        }
+        // Tiled surfaces are stored top to bottom, linear ones bottom to top
+        const Common::Rectangle<u32> rect =
+            is_tiled ? Common::Rectangle<u32>{x, height_lod - y, right,
+                                              height_lod - (y + rect_height)}
+                     : Common::Rectangle<u32>{x, y + rect_height, right, y};
+        rects.push_back({start + BytesInPixels(pixel), rect});
+    };
+
+    if (!is_tiled) {
+        while (pixel < last_pixel) {
+            const u32 x = pixel % stride_lod;
+            const u32 y = pixel / stride_lod;
+            if (x == 0 && last_pixel - pixel >= stride_lod) {
+                const u32 rows = (last_pixel - pixel) / stride_lod;
+                add_rect(0, y, stride_lod, rows);
+                pixel += rows * stride_lod;
+                continue;
+            }
+            const u32 row_end = std::min(last_pixel, (y + 1) * stride_lod);
+            add_rect(x, y, row_end - pixel, 1);
+            pixel = row_end;
+        }
+        return rects;
+    }
+
+    constexpr u32 TilePixels = 8 * 8;
+    const u32 tiles_per_row = stride_lod / 8;
+    while (pixel < last_pixel) {
+        const u32 tile = pixel / TilePixels;
+        const u32 tile_x = (tile % tiles_per_row) * 8;
+        const u32 tile_y = (tile / tiles_per_row) * 8;
+        const u32 tile_offset = pixel % TilePixels;
+        const u32 remaining = last_pixel - pixel;
+        if (tile_offset == 0 && remaining >= TilePixels) {
+            if (tile_x == 0 && remaining >= TilePixels * tiles_per_row) {
+                const u32 rows = remaining / (TilePixels * tiles_per_row);
+                add_rect(0, tile_y, stride_lod, rows * 8);
+                pixel += rows * TilePixels * tiles_per_row;
+            } else {
+                const u32 tiles = std::min(remaining / TilePixels, tiles_per_row - tile_x / 8);
+                add_rect(tile_x, tile_y, tiles * 8, 8);
+                pixel += tiles * TilePixels;
+            }
+            continue;
+        }
+        // Pixels are in Morton order within a tile, so an aligned block of 2^n pixels is a
+        // rectangle with the even bits of the offset selecting the column and the odd ones the row
+        u32 block_size = tile_offset == 0 ? TilePixels : tile_offset & (~tile_offset + 1);
+        while (block_size > remaining) {
+            block_size /= 2;
+        }
+        const u32 block_bits = static_cast<u32>(std::countr_zero(block_size));
+        u32 block_x = 0;
+        u32 block_y = 0;
+        for (u32 bit = 0; bit < 3; bit++) {
+            block_x |= ((tile_offset >> (2 * bit)) & 1) << bit;
+            block_y |= ((tile_offset >> (2 * bit + 1)) & 1) << bit;
+        }
+        add_rect(tile_x + block_x, tile_y + block_y, 1u << ((block_bits + 1) / 2),
+                 1u << (block_bits / 2));
+        pixel += block_size;
+    }
+    return rects;
+}
+
 SurfaceInterval SurfaceParams::GetSubRectInterval(Common::Rectangle<u32> unscaled_rect,
                                                   u32 level) const {
     if (unscaled_rect.GetHeight() == 0 || unscaled_rect.GetWidth() == 0) [[unlikely]] {
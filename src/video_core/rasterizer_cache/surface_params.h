@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <vector>
 #include <boost/icl/right_open_interval.hpp>
 #include "common/math_util.h"
 #include "video_core/custom_textures/custom_format.h"
@@ -15,6 +16,12 @@ using SurfaceInterval = boost::icl::right_open_interval<PAddr>;
 
 constexpr std::size_t MAX_PICA_LEVELS = 8;
 
+/// Unscaled rectangle of a surface and the address of its first pixel
+struct SurfaceSubRect {
+    PAddr addr;
+    Common::Rectangle<u32> rect;
+};
+
 class SurfaceParams {
 public:
     /// Returns true if other_surface matches exactly params
@@ -41,6 +48,12 @@ public:
     /// Returns the outer rectangle containing interval
     SurfaceParams FromInterval(SurfaceInterval interval) const;
 
+    /**
+     * Splits an interval of a single level into the unscaled rectangles it covers, down to
+     * blocks of a tile for tiled surfaces. Returns nothing if the interval splits a pixel.
+     */
+    std::vector<SurfaceSubRect> SplitIntoRects(SurfaceInterval interval) const;
+
     /// Returns the address interval referenced by unscaled_rect
     SurfaceInterval GetSubRectInterval(Common::Rectangle<u32> unscaled_rect, u32 level = 0) const;
 
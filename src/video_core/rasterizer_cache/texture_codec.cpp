@@ -0,0 +1,59 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/arch.h"
+#include "video_core/rasterizer_cache/texture_codec.h"
+
+#if CITRA_ARCH(x86_64)
+#include <tmmintrin.h>
+#include "common/x64/cpu_detect.h"
+
+// SSSE3 is not part of the x86-64 baseline the project is built for, so the shuffle is compiled
+// for it on its own and only called once the CPU is known to support it.
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define TARGET_SSSE3
+#endif
+
+namespace VideoCore {
+
+bool HasSIMDMortonCopy() {
+    static const bool has_ssse3 = Common::GetCPUCaps().ssse3;
+    return has_ssse3;
+}
+
+TARGET_SSSE3 void MortonShuffleTileSIMD(bool morton_to_linear, u32 stride, u8* tile_buffer,
+                                        u8* linear_buffer, u32 shuffle) {
+    // Repeat the byte order of one pixel for the four pixels of a vector
+    const __m128i mask = _mm_add_epi8(_mm_set1_epi32(static_cast<s32>(shuffle)),
+                                      _mm_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12,
+                                                    12, 12));
+
+    // Each half of a tile row is two horizontally adjacent pixel pairs, four pixels apart in
+    // Morton order.
+    for (u32 y = 0; y < 8; y++) {
+        u8* tiled_row = tile_buffer + MortonInterleave(0, y) * 4;
+        u8* linear_row = linear_buffer + (7 - y) * stride * 4;
+        for (u32 x = 0; x < 8; x += 4) {
+            auto* first_pair = reinterpret_cast<__m128i*>(tiled_row + MortonInterleave(x, 0) * 4);
+            auto* second_pair =
+                reinterpret_cast<__m128i*>(tiled_row + MortonInterleave(x + 2, 0) * 4);
+            auto* linear_pixels = reinterpret_cast<__m128i*>(linear_row + x * 4);
+            if (morton_to_linear) {
+                const __m128i pixels = _mm_unpacklo_epi64(_mm_loadl_epi64(first_pair),
+                                                          _mm_loadl_epi64(second_pair));
+                _mm_storeu_si128(linear_pixels, _mm_shuffle_epi8(pixels, mask));
+            } else {
+                const __m128i pixels = _mm_shuffle_epi8(_mm_loadu_si128(linear_pixels), mask);
+                _mm_storel_epi64(first_pair, pixels);
+                _mm_storel_epi64(second_pair, _mm_unpackhi_epi64(pixels, pixels));
+            }
+        }
+    }
+}
+
+} // namespace VideoCore
+
+#endif
@@ -5,9 +5,11 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <span>
 #include "common/alignment.h"
+#include "common/arch.h"
 #include "common/color.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
 #include "video_core/texture/etc1.h"
@@ -85,33 +87,38 @@ constexpr void DecodePixel4(u32 x, u32 y, const u8* source_tile, u8* dest_pixel)
 }
 
 template <PixelFormat format>
-constexpr void DecodePixelETC1(u32 x, u32 y, const u8* source_tile, u8* dest_pixel) {
+void DecodeTileETC1(u32 stride, const u8* source_tile, u8* linear_tile) {
     constexpr u32 subtile_width = 4;
     constexpr u32 subtile_height = 4;
     constexpr bool has_alpha = format == PixelFormat::ETC1A4;
     constexpr std::size_t subtile_size = has_alpha ? 16 : 8;
 
-    const u32 subtile_index = (x / subtile_width) + 2 * (y / subtile_height);
-    x %= subtile_width;
-    y %= subtile_height;
-
-    const u8* subtile_ptr = source_tile + subtile_index * subtile_size;
-
-    u8 alpha = 255;
-    if constexpr (has_alpha) {
-        u64_le packed_alpha;
-        std::memcpy(&packed_alpha, subtile_ptr, sizeof(u64));
-        subtile_ptr += sizeof(u64);
-
-        alpha = Common::Color::Convert4To8((packed_alpha >> (4 * (x * subtile_width + y))) & 0xF);
+    // The 8x8 tile is made of four 4x4 subtiles, each decoded as a whole
+    alignas(16) std::array<u8, Pica::Texture::ETC1SubtileDecodedSize> texels;
+    for (u32 subtile_index = 0; subtile_index < 4; subtile_index++) {
+        const u8* subtile_ptr = source_tile + subtile_index * subtile_size;
+        u64 packed_alpha = 0;
+        if constexpr (has_alpha) {
+            packed_alpha = MakeInt<u64_le>(subtile_ptr);
+            subtile_ptr += sizeof(u64);
+        }
+        Pica::Texture::DecodeETC1Subtile(MakeInt<u64_le>(subtile_ptr), texels);
+
+        const u32 subtile_x = (subtile_index % 2) * subtile_width;
+        const u32 subtile_y = (subtile_index / 2) * subtile_height;
+        for (u32 y = 0; y < subtile_height; y++) {
+            u8* texel_row = &texels[y * subtile_width * 4];
+            if constexpr (has_alpha) {
+                for (u32 x = 0; x < subtile_width; x++) {
+                    const u8 alpha = (packed_alpha >> (4 * (x * subtile_width + y))) & 0xF;
+                    texel_row[x * 4 + 3] = Common::Color::Convert4To8(alpha);
+                }
+            }
+            // The linear buffer is written from the bottom up
+            u8* linear_row = linear_tile + ((7 - (subtile_y + y)) * stride + subtile_x) * 4;
+            std::memcpy(linear_row, texel_row, subtile_width * 4);
+        }
     }
-
-    const u64_le subtile_data = MakeInt<u64_le>(subtile_ptr);
-    const auto rgb = Pica::Texture::SampleETC1Subtile(subtile_data, x, y);
-
-    // Copy the uncompressed pixel to the destination
-    std::memcpy(dest_pixel, rgb.AsArray(), 3);
-    dest_pixel[3] = alpha;
 }
 
 template <PixelFormat format, bool converted>
@@ -196,12 +203,70 @@ constexpr void EncodePixel4(u32 x, u32 y, const u8* source_pixel, u8* dest_tile_
     }
 }
 
+#if CITRA_ARCH(x86_64)
+/// Returns true if the host CPU supports the byte shuffles of MortonShuffleTileSIMD
+bool HasSIMDMortonCopy();
+
+/**
+ * Copies an 8x8 tile of 4 byte pixels between Morton and linear order four pixels at a time,
+ * reordering the bytes of every pixel on the way.
+ * @param stride The width of the linear buffer in pixels
+ * @param shuffle Byte i holds the index of the source byte of byte i of a destination pixel
+ */
+void MortonShuffleTileSIMD(bool morton_to_linear, u32 stride, u8* tile_buffer, u8* linear_buffer,
+                           u32 shuffle);
+#endif
+
 template <bool morton_to_linear, PixelFormat format, bool converted>
 constexpr void MortonCopyTile(u32 stride, std::span<u8> tile_buffer, std::span<u8> linear_buffer) {
     constexpr u32 bytes_per_pixel = GetFormatBpp(format) / 8;
     constexpr u32 linear_bytes_per_pixel = converted ? 4 : GetFormatBytesPerPixel(format);
     constexpr bool is_compressed = format == PixelFormat::ETC1 || format == PixelFormat::ETC1A4;
     constexpr bool is_4bit = format == PixelFormat::I4 || format == PixelFormat::A4;
+    constexpr bool is_raw_copy = !converted && !is_compressed && !is_4bit &&
+                                 format != PixelFormat::D24S8 &&
+                                 bytes_per_pixel == linear_bytes_per_pixel;
+
+    // Horizontally adjacent pixel pairs are contiguous in Morton order, so formats that need no
+    // conversion can be copied a pair at a time with a fixed size the compiler can inline.
+    if constexpr (is_raw_copy) {
+        constexpr u32 pair_size = 2 * bytes_per_pixel;
+        for (u32 y = 0; y < 8; y++) {
+            u8* tiled_row = tile_buffer.data();
+            u8* linear_row = linear_buffer.data() + (7 - y) * stride * linear_bytes_per_pixel;
+            for (u32 x = 0; x < 8; x += 2) {
+                u8* tiled_pixel = tiled_row + VideoCore::MortonInterleave(x, y) * bytes_per_pixel;
+                u8* linear_pixel = linear_row + x * linear_bytes_per_pixel;
+                if constexpr (morton_to_linear) {
+                    std::memcpy(linear_pixel, tiled_pixel, pair_size);
+                } else {
+                    std::memcpy(tiled_pixel, linear_pixel, pair_size);
+                }
+            }
+        }
+        return;
+    }
+
+    if constexpr (is_compressed && morton_to_linear) {
+        DecodeTileETC1<format>(stride, tile_buffer.data(), linear_buffer.data());
+        return;
+    }
+
+#if CITRA_ARCH(x86_64)
+    // Formats whose conversion only reorders the bytes of each pixel are converted a vector of
+    // pixels at a time where the CPU can shuffle bytes.
+    constexpr bool is_byte_shuffle =
+        (format == PixelFormat::RGBA8 && converted) || format == PixelFormat::D24S8;
+    if constexpr (is_byte_shuffle) {
+        constexpr u32 d24s8_shuffle = morton_to_linear ? 0x02010003 : 0x00030201;
+        constexpr u32 shuffle = format == PixelFormat::D24S8 ? d24s8_shuffle : 0x00010203;
+        if (HasSIMDMortonCopy()) {
+            MortonShuffleTileSIMD(morton_to_linear, stride, tile_buffer.data(),
+                                  linear_buffer.data(), shuffle);
+            return;
+        }
+    }
+#endif
 
     for (u32 y = 0; y < 8; y++) {
         for (u32 x = 0; x < 8; x++) {
@@ -210,9 +275,7 @@ constexpr void MortonCopyTile(u32 stride, std::span<u8> tile_buffer, std::span<u
             const auto linear_pixel = linear_buffer.subspan(
                 ((7 - y) * stride + x) * linear_bytes_per_pixel, linear_bytes_per_pixel);
             if constexpr (morton_to_linear) {
-                if constexpr (is_compressed) {
-                    DecodePixelETC1<format>(x, y, tile_buffer.data(), linear_pixel.data());
-                } else if constexpr (is_4bit) {
+                if constexpr (is_4bit) {
                     DecodePixel4<format>(x, y, tile_buffer.data(), linear_pixel.data());
                 } else {
                     DecodePixel<format, converted>(tiled_pixel.data(), linear_pixel.data());
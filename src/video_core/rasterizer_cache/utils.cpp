@@ -2,12 +2,44 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/thread_pool.h"
 #include "video_core/rasterizer_cache/surface_params.h"
 #include "video_core/rasterizer_cache/texture_codec.h"
 #include "video_core/rasterizer_cache/utils.h"
 
 namespace VideoCore {
 
+namespace {
+
+/// Compressed textures with at least this many pixels are decoded on the shared thread pool
+constexpr u32 ParallelDecodePixels = 128 * 128;
+
+/// Decodes a whole tiled texture on the thread pool, as each row of tiles is independent
+void UnswizzleParallel(MortonFunc unswizzle, const SurfaceParams& surface_info,
+                       std::span<u8> source, std::span<u8> dest) {
+    const u32 num_rows = surface_info.height / 8;
+    const u32 tiled_row_size = surface_info.BytesInPixels(surface_info.width * 8);
+    const u32 linear_row_size =
+        surface_info.width * 8 * GetFormatBytesPerPixel(surface_info.pixel_format);
+
+    Common::TaskGroup workers{Common::TaskPriority::FrameCritical};
+    const u32 num_workers = static_cast<u32>(workers.NumWorkers());
+    const u32 rows_per_task = (num_rows + num_workers - 1) / num_workers;
+    for (u32 first = 0; first < num_rows; first += rows_per_task) {
+        const u32 last = std::min(first + rows_per_task, num_rows);
+        const u32 rows = last - first;
+        // The linear data is stored bottom to top, so the last rows come first
+        workers.QueueWork([=] {
+            unswizzle(surface_info.width, rows * 8, 0, rows * tiled_row_size,
+                      dest.subspan((num_rows - last) * linear_row_size, rows * linear_row_size),
+                      source.subspan(first * tiled_row_size, rows * tiled_row_size));
+        });
+    }
+    workers.WaitForRequests();
+}
+
+} // Anonymous namespace
+
 u32 MipLevels(u32 width, u32 height, u32 max_level) {
     u32 levels = 1;
     while (width > 8 && height > 8) {
@@ -54,6 +86,13 @@ void DecodeTexture(const SurfaceParams& surface_info, PAddr start_addr, PAddr en
     if (surface_info.is_tiled) {
         const MortonFunc UnswizzleImpl =
             (convert ? UNSWIZZLE_TABLE_CONVERTED : UNSWIZZLE_TABLE)[func_index];
+        const bool is_etc1 = format == PixelFormat::ETC1 || format == PixelFormat::ETC1A4;
+        if (UnswizzleImpl && is_etc1 && start_addr == surface_info.addr &&
+            end_addr == surface_info.end &&
+            surface_info.width * surface_info.height >= ParallelDecodePixels) {
+            UnswizzleParallel(UnswizzleImpl, surface_info, source, dest);
+            return;
+        }
         if (UnswizzleImpl) {
             UnswizzleImpl(surface_info.width, surface_info.height, start_addr - surface_info.addr,
                           end_addr - surface_info.addr, dest, source);
@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <array>
 #include <span>
 #include "common/math_util.h"
 #include "common/vector_math.h"
+#include "video_core/rasterizer_cache/pixel_format.h"
 
 namespace VideoCore {
 
@@ -66,6 +68,30 @@ struct StagingData {
     std::span<u8> mapped;
 };
 
+/// A Y2R conversion of contiguous 8-bit YUV planes into a tiled image
+struct Y2RConfig {
+    /// Must match the formats of vulkan_y2r.comp
+    enum class InputFormat : u32 {
+        YUV422 = 0,  ///< Individual Y, U and V planes, with a U and V sample per two pixels
+        YUV420 = 1,  ///< Individual Y, U and V planes, with a U and V sample per 2x2 pixels
+        YUYV422 = 2, ///< Interleaved YUYV in the first plane
+    };
+
+    struct Plane {
+        PAddr addr;
+        u32 size;
+    };
+
+    InputFormat input_format;
+    PixelFormat output_format;
+    u32 width;
+    u32 height;
+    u32 alpha;
+    std::array<s32, 8> coefficients;
+    std::array<Plane, 3> planes; ///< Unused planes have a size of 0
+    PAddr dst_addr;
+};
+
 class SurfaceParams;
 struct FramebufferParams;
 
@@ -6,11 +6,9 @@
 
 #include <atomic>
 #include <functional>
+#include <span>
 #include "common/common_types.h"
-
-namespace Pica {
-struct OutputVertex;
-}
+#include "video_core/pica/output_vertex.h"
 
 namespace Pica {
 struct DisplayTransferConfig;
@@ -19,6 +17,8 @@ struct MemoryFillConfig;
 
 namespace VideoCore {
 
+struct Y2RConfig;
+
 enum class LoadCallbackStage {
     Prepare,
     Preload,
@@ -28,13 +28,27 @@ enum class LoadCallbackStage {
 };
 using DiskResourceLoadCallback = std::function<void(LoadCallbackStage, std::size_t, std::size_t)>;
 
+/// Occupancy of the host caches of a rasterizer
+struct CacheStats {
+    std::size_t pipelines{};     ///< Graphics pipelines, or linked programs in OpenGL
+    std::size_t shaders{};       ///< Compiled shader stages
+    u64 surface_memory{};        ///< Estimated host memory of the cached surfaces
+    u32 evicted_surfaces{};      ///< Surfaces evicted during the last frame
+    u32 flushed_surfaces{};      ///< Evicted surfaces that were written back first
+    u64 stream_wait_us{};        ///< Time spent waiting on stream buffers during the last frame
+    u32 cpu_reinterpretations{}; ///< Reinterpretations done on the CPU during the last frame
+    u32 cpu_fills{};             ///< Partial fills done on the CPU during the last frame
+    u32 pipeline_waits{};        ///< Draws that waited on a compiling pipeline in the last frame
+    u64 pipeline_wait_us{};      ///< Time spent in those waits
+    u64 pipeline_max_wait_us{};  ///< Longest of those waits
+};
+
 class RasterizerInterface {
 public:
     virtual ~RasterizerInterface() = default;
 
-    /// Queues the primitive formed by the given vertices for rendering
-    virtual void AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
-                             const Pica::OutputVertex& v2) = 0;
+    /// Queues the triangles formed by each three consecutive vertices for rendering
+    virtual void AddTriangles(std::span<const Pica::OutputVertex> vertices) = 0;
 
     /// Draw the current batch of triangles
     virtual void DrawTriangles() = 0;
@@ -51,6 +65,16 @@ public:
     /// Notify rasterizer that any caches of the specified region should be invalidated
     virtual void InvalidateRegion(PAddr addr, u32 size) = 0;
 
+    /// Returns true if the guest has read back the render target at addr with the CPU
+    virtual bool IsReadbackTarget(PAddr addr) const {
+        return false;
+    }
+
+    /// Returns true if the rasterizer drops every draw, so that they can be skipped altogether
+    virtual bool DiscardsDraws() const {
+        return false;
+    }
+
     /// Notify rasterizer that any caches of the specified region should be flushed to 3DS memory
     /// and invalidated
     virtual void FlushAndInvalidateRegion(PAddr addr, u32 size) = 0;
@@ -73,14 +97,30 @@ public:
         return false;
     }
 
+    /// Attempt to perform a Y2R conversion into the cached surface at its destination
+    virtual bool AccelerateY2R(const Y2RConfig&) {
+        return false;
+    }
+
     /// Attempt to draw using hardware shaders
     virtual bool AccelerateDrawBatch([[maybe_unused]] bool is_indexed) {
         return false;
     }
 
+    /// Attempt to draw the batched immediate mode vertices using hardware shaders
+    virtual bool AccelerateDrawImmediate(
+        [[maybe_unused]] std::span<const Pica::AttributeBuffer> vertices) {
+        return false;
+    }
+
     virtual void LoadDiskResources([[maybe_unused]] const std::atomic_bool& stop_loading,
                                    [[maybe_unused]] const DiskResourceLoadCallback& callback) {}
 
     virtual void SyncEntireState() {}
+
+    /// Returns the occupancy of the pipeline, shader and surface caches
+    virtual CacheStats GetCacheStats() const {
+        return {};
+    }
 };
 } // namespace VideoCore
@@ -3,7 +3,9 @@
 // Refer to the license.txt file included.
 
 #include "common/settings.h"
+#include "common/trace_recorder.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/frontend/emu_window.h"
 #include "core/tracer/recorder.h"
 #include "video_core/debug_utils/debug_utils.h"
@@ -19,7 +21,8 @@ RendererBase::~RendererBase() = default;
 
 u32 RendererBase::GetResolutionScaleFactor() {
     const auto graphics_api = Settings::values.graphics_api.GetValue();
-    if (graphics_api == Settings::GraphicsAPI::Software) {
+    if (graphics_api == Settings::GraphicsAPI::Software ||
+        graphics_api == Settings::GraphicsAPI::Null) {
         // Software renderer always render at native resolution
         return 1;
     }
@@ -29,6 +32,35 @@ u32 RendererBase::GetResolutionScaleFactor() {
                              : render_window.GetFramebufferLayout().GetScalingRatio();
 }
 
+u32 RendererBase::GetRenderScaleFactor() {
+    const u32 scale_factor = GetResolutionScaleFactor();
+    if (!Settings::values.dynamic_resolution.GetValue()) {
+        return scale_factor;
+    }
+    dynamic_resolution.SetMaxScale(scale_factor);
+    return dynamic_resolution.Scale();
+}
+
+void RendererBase::UpdateDynamicResolution(std::chrono::nanoseconds gpu_time) {
+    last_gpu_time = gpu_time;
+    if (system.perf_stats) {
+        system.perf_stats->AddFrameTime(Core::PerfStats::FrameTimer::GpuExecution, gpu_time);
+    }
+    if (!Settings::values.dynamic_resolution.GetValue()) {
+        return;
+    }
+    // Frames are due at the emulated refresh rate scaled by the frame limit, unless unlimited.
+    const u16 frame_limit = Settings::values.frame_limit.GetValue();
+    const auto target_frame_time =
+        frame_limit == 0 ? std::chrono::nanoseconds::zero()
+                         : std::chrono::nanoseconds{static_cast<s64>(
+                               1e11 / (SCREEN_REFRESH_RATE * frame_limit))};
+    dynamic_resolution.SetTargetFrameTime(target_frame_time);
+    if (dynamic_resolution.OnFrame(gpu_time)) {
+        LOG_DEBUG(Render, "Dynamic resolution scale changed to {}x", dynamic_resolution.Scale());
+    }
+}
+
 void RendererBase::UpdateCurrentFramebufferLayout(bool is_portrait_mode) {
     const auto update_layout = [is_portrait_mode](Frontend::EmuWindow& window) {
         const Layout::FramebufferLayout& layout = window.GetFramebufferLayout();
@@ -40,10 +72,36 @@ void RendererBase::UpdateCurrentFramebufferLayout(bool is_portrait_mode) {
     }
 }
 
+bool RendererBase::UpdatePerfOverlay() {
+    if (!Settings::values.perf_overlay.GetValue()) {
+        return false;
+    }
+    return perf_overlay.AddFrame(system.GetLastFrameStats());
+}
+
+bool RendererBase::IsEyePresented(u32 eye) const {
+    if (Settings::values.render_3d.GetValue() != Settings::StereoRenderOption::Off) {
+        return true;
+    }
+    return eye == static_cast<u32>(Settings::values.mono_render_option.GetValue());
+}
+
 void RendererBase::EndFrame() {
     current_frame++;
 
     system.perf_stats->EndSystemFrame();
+    gpu_profiler.EndFrame();
+    // The GPU times are only measured when GPU profiling is enabled as well
+    auto* trace_recorder = system.GetTraceRecorder();
+    if (trace_recorder && gpu_profiler.IsEnabled()) {
+        std::vector<std::pair<const char*, double>> gpu_times;
+        for (const auto& entry : gpu_profiler.LastFrame()) {
+            gpu_times.emplace_back(
+                entry.name, std::chrono::duration<double, std::milli>(entry.time).count());
+        }
+        trace_recorder->RecordCounter("GPU time (ms)", gpu_times);
+    }
+    system.OnFrameEnd();
 
     render_window.PollEvents();
 
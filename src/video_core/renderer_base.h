@@ -4,8 +4,13 @@
 
 #pragma once
 
+#include <chrono>
+
 #include "common/common_types.h"
 #include "core/frontend/framebuffer_layout.h"
+#include "video_core/dynamic_resolution.h"
+#include "video_core/gpu_profiler.h"
+#include "video_core/perf_overlay.h"
 #include "video_core/rasterizer_interface.h"
 
 namespace Frontend {
@@ -33,6 +38,7 @@ struct RendererSettings {
     // Renderer
     std::atomic_bool bg_color_update_requested{false};
     std::atomic_bool shader_update_requested{false};
+    std::atomic_bool skip_presentation{false};
 };
 
 class RendererBase : NonCopyable {
@@ -69,6 +75,10 @@ public:
     /// Returns the resolution scale factor relative to the native 3DS screen resolution
     u32 GetResolutionScaleFactor();
 
+    /// Returns the scale factor the rasterizer renders at. This is the resolution scale factor
+    /// unless dynamic resolution lowered it to keep up with the frame limit.
+    u32 GetRenderScaleFactor();
+
     /// Updates the framebuffer layout of the contained render window handle.
     void UpdateCurrentFramebufferLayout(bool is_portrait_mode = {});
 
@@ -83,6 +93,10 @@ public:
         return current_frame;
     }
 
+    Core::System& GetSystem() {
+        return system;
+    }
+
     Frontend::EmuWindow& GetRenderWindow() {
         return render_window;
     }
@@ -102,10 +116,35 @@ public:
     /// Returns true if a screenshot is being processed
     [[nodiscard]] bool IsScreenshotPending() const;
 
+    /// Returns the GPU time spent on the last frame, zero if the renderer does not measure it
+    [[nodiscard]] std::chrono::nanoseconds LastGpuTime() const {
+        return last_gpu_time;
+    }
+
+    /// Returns the GPU time of the profiled operations, when GPU profiling is enabled
+    [[nodiscard]] GpuProfiler& Profiler() {
+        return gpu_profiler;
+    }
+
+    [[nodiscard]] const GpuProfiler& Profiler() const {
+        return gpu_profiler;
+    }
+
     /// Request a screenshot of the next frame
     void RequestScreenshot(void* data, std::function<void(bool)> callback,
                            const Layout::FramebufferLayout& layout);
 
+protected:
+    /// Stores the GPU time spent on the last frame and adapts the render scale to it
+    void UpdateDynamicResolution(std::chrono::nanoseconds gpu_time);
+
+    /// Adds the last frame to the performance overlay when it is enabled.
+    /// Returns true if the overlay image changed and has to be uploaded again.
+    bool UpdatePerfOverlay();
+
+    /// Returns true if the top screen image of the eye is shown with the stereoscopy settings
+    [[nodiscard]] bool IsEyePresented(u32 eye) const;
+
 protected:
     Core::System& system;
     RendererSettings settings;
@@ -113,6 +152,10 @@ protected:
     Frontend::EmuWindow* secondary_window; ///< Reference to the secondary render window handle.
     f32 current_fps = 0.0f;                ///< Current framerate, should be set by the renderer
     s32 current_frame = 0;                 ///< Current frame, should be set by the renderer
+    DynamicResolution dynamic_resolution;
+    std::chrono::nanoseconds last_gpu_time{};
+    GpuProfiler gpu_profiler;
+    PerfOverlay perf_overlay;
 };
 
 } // namespace VideoCore
@@ -0,0 +1,54 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+
+namespace Core {
+class System;
+}
+
+namespace NullRenderer {
+
+/// Rasterizer that drops every draw, so that the vertices are not even processed.
+class RasterizerNull : public VideoCore::RasterizerInterface {
+public:
+    void AddTriangles(std::span<const Pica::OutputVertex> vertices) override {}
+    void DrawTriangles() override {}
+    void NotifyPicaRegisterChanged(u32 id) override {}
+    void FlushAll() override {}
+    void FlushRegion(PAddr addr, u32 size) override {}
+    void InvalidateRegion(PAddr addr, u32 size) override {}
+    void FlushAndInvalidateRegion(PAddr addr, u32 size) override {}
+    void ClearAll(bool flush) override {}
+
+    bool DiscardsDraws() const override {
+        return true;
+    }
+};
+
+/**
+ * Renderer that renders and presents nothing, to measure the CPU and HLE emulation alone and run
+ * on hosts without a GPU. Memory fills and display transfers are still done in guest memory by
+ * the software blitter, and frames still end on VBlank, so games see the same timing.
+ */
+class RendererNull : public VideoCore::RendererBase {
+public:
+    explicit RendererNull(Core::System& system, Frontend::EmuWindow& window);
+    ~RendererNull() override;
+
+    [[nodiscard]] VideoCore::RasterizerInterface* Rasterizer() override {
+        return &rasterizer;
+    }
+
+    void SwapBuffers() override;
+    void TryPresent(int timeout_ms, bool is_secondary) override {}
+
+private:
+    RasterizerNull rasterizer;
+};
+
+} // namespace NullRenderer
@@ -7,11 +7,11 @@
 #include "video_core/rasterizer_cache/pixel_format.h"
 #include "video_core/renderer_opengl/gl_blit_helper.h"
 #include "video_core/renderer_opengl/gl_driver.h"
+#include "video_core/renderer_opengl/gl_gpu_timer.h"
 #include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/renderer_opengl/gl_texture_runtime.h"
 
-#include "video_core/host_shaders/format_reinterpreter/d24s8_to_rgba8_frag.h"
-#include "video_core/host_shaders/format_reinterpreter/rgba4_to_rgb5a1_frag.h"
+#include "video_core/host_shaders/format_reinterpreter/opengl_reinterpret_frag.h"
 #include "video_core/host_shaders/full_screen_triangle_vert.h"
 #include "video_core/host_shaders/texture_filtering/bicubic_frag.h"
 #include "video_core/host_shaders/texture_filtering/mmpx_frag.h"
@@ -24,6 +24,7 @@
 namespace OpenGL {
 
 using Settings::TextureFilter;
+using VideoCore::PixelFormat;
 using VideoCore::SurfaceType;
 
 namespace {
@@ -53,8 +54,8 @@ OGLProgram CreateProgram(std::string_view frag) {
 
 } // Anonymous namespace
 
-BlitHelper::BlitHelper(const Driver& driver_)
-    : driver{driver_}, linear_sampler{CreateSampler(GL_LINEAR)},
+BlitHelper::BlitHelper(const Driver& driver_, GpuTimer& gpu_timer_)
+    : driver{driver_}, gpu_timer{gpu_timer_}, linear_sampler{CreateSampler(GL_LINEAR)},
       nearest_sampler{CreateSampler(GL_NEAREST)}, bicubic_program{CreateProgram(
                                                       HostShaders::BICUBIC_FRAG)},
       scale_force_program{CreateProgram(HostShaders::SCALE_FORCE_FRAG)},
@@ -63,8 +64,7 @@ BlitHelper::BlitHelper(const Driver& driver_)
                                                                HostShaders::X_GRADIENT_FRAG)},
       gradient_y_program{CreateProgram(HostShaders::Y_GRADIENT_FRAG)},
       refine_program{CreateProgram(HostShaders::REFINE_FRAG)},
-      d24s8_to_rgba8{CreateProgram(HostShaders::D24S8_TO_RGBA8_FRAG)},
-      rgba4_to_rgb5a1{CreateProgram(HostShaders::RGBA4_TO_RGB5A1_FRAG)} {
+      reinterpret_program{CreateProgram(HostShaders::OPENGL_REINTERPRET_FRAG)} {
     vao.Create();
     draw_fbo.Create();
     state.draw.vertex_array = vao.handle;
@@ -81,15 +81,49 @@ BlitHelper::BlitHelper(const Driver& driver_)
 
 BlitHelper::~BlitHelper() = default;
 
-bool BlitHelper::ConvertDS24S8ToRGBA8(Surface& source, Surface& dest,
-                                      const VideoCore::TextureCopy& copy) {
+bool BlitHelper::Reinterpret(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy) {
+    if (source.GetFormatBpp() < 16) {
+        return false;
+    }
+    const GpuTimer::Scope profile{gpu_timer, "Reinterpret"};
     OpenGLState prev_state = OpenGLState::GetCurState();
     SCOPE_EXIT({ prev_state.Apply(); });
 
+    // The shader fetches the texels, so the sampler filtering of depth textures does not matter
     state.texture_units[0].texture_2d = source.Handle();
     state.texture_units[0].sampler = 0;
     state.texture_units[1].sampler = 0;
+    if (source.pixel_format == PixelFormat::D24S8) {
+        BindStencil(source, copy);
+    }
+
+    glProgramUniform1i(reinterpret_program.handle, 2, static_cast<GLint>(source.pixel_format));
+    glProgramUniform1i(reinterpret_program.handle, 3, static_cast<GLint>(dest.pixel_format));
+    glProgramUniform1i(reinterpret_program.handle, 4, -1);
+
+    const Common::Rectangle src_rect{copy.src_offset.x, copy.src_offset.y + copy.extent.height,
+                                     copy.src_offset.x + copy.extent.width, copy.src_offset.y};
+    const Common::Rectangle dst_rect{copy.dst_offset.x, copy.dst_offset.y + copy.extent.height,
+                                     copy.dst_offset.x + copy.extent.width, copy.dst_offset.y};
+    SetParams(reinterpret_program, source.RealExtent(), src_rect);
+    if (dest.type == SurfaceType::Color || dest.type == SurfaceType::Texture) {
+        Draw(reinterpret_program, dest.Handle(), draw_fbo.handle, copy.dst_level, dst_rect);
+    } else {
+        DrawDepthStencil(dest, copy.dst_level, dst_rect);
+    }
 
+    if (use_texture_view) {
+        temp_tex.Release();
+    }
+
+    // Restore the sampler handles
+    state.texture_units[0].sampler = linear_sampler.handle;
+    state.texture_units[1].sampler = linear_sampler.handle;
+    return true;
+}
+
+void BlitHelper::BindStencil(Surface& source, const VideoCore::TextureCopy& copy) {
+    const VideoCore::Extent extent = source.RealExtent();
     if (use_texture_view) {
         temp_tex.Create();
         glActiveTexture(GL_TEXTURE1);
@@ -97,8 +131,8 @@ bool BlitHelper::ConvertDS24S8ToRGBA8(Surface& source, Surface& dest,
                       1);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    } else if (copy.extent.width > temp_extent.width || copy.extent.height > temp_extent.height) {
-        temp_extent = copy.extent;
+    } else if (extent.width > temp_extent.width || extent.height > temp_extent.height) {
+        temp_extent = extent;
         temp_tex.Release();
         temp_tex.Create();
         state.texture_units[1].texture_2d = temp_tex.handle;
@@ -119,40 +153,54 @@ bool BlitHelper::ConvertDS24S8ToRGBA8(Surface& source, Surface& dest,
                            copy.src_offset.y, 0, copy.extent.width, copy.extent.height, 1);
     }
     glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_STENCIL_INDEX);
-
-    const Common::Rectangle src_rect{copy.src_offset.x, copy.src_offset.y + copy.extent.height,
-                                     copy.src_offset.x + copy.extent.width, copy.src_offset.x};
-    const Common::Rectangle dst_rect{copy.dst_offset.x, copy.dst_offset.y + copy.extent.height,
-                                     copy.dst_offset.x + copy.extent.width, copy.dst_offset.x};
-    SetParams(d24s8_to_rgba8, source.RealExtent(), src_rect);
-    Draw(d24s8_to_rgba8, dest.Handle(), draw_fbo.handle, 0, dst_rect);
-
-    if (use_texture_view) {
-        temp_tex.Release();
-    }
-
-    // Restore the sampler handles
-    state.texture_units[0].sampler = linear_sampler.handle;
-    state.texture_units[1].sampler = linear_sampler.handle;
-
-    return true;
 }
 
-bool BlitHelper::ConvertRGBA4ToRGB5A1(Surface& source, Surface& dest,
-                                      const VideoCore::TextureCopy& copy) {
-    OpenGLState prev_state = OpenGLState::GetCurState();
-    SCOPE_EXIT({ prev_state.Apply(); });
-
-    state.texture_units[0].texture_2d = source.Handle();
+void BlitHelper::DrawDepthStencil(Surface& dest, u32 dst_level, Common::Rectangle<u32> dst_rect) {
+    OpenGLState depth_state = state;
+    depth_state.draw.draw_framebuffer = draw_fbo.handle;
+    depth_state.draw.shader_program = reinterpret_program.handle;
+    depth_state.viewport.x = dst_rect.left;
+    depth_state.viewport.y = dst_rect.bottom;
+    depth_state.viewport.width = dst_rect.GetWidth();
+    depth_state.viewport.height = dst_rect.GetHeight();
+    depth_state.scissor.enabled = true;
+    depth_state.scissor.x = dst_rect.left;
+    depth_state.scissor.y = dst_rect.bottom;
+    depth_state.scissor.width = dst_rect.GetWidth();
+    depth_state.scissor.height = dst_rect.GetHeight();
+    depth_state.depth.test_enabled = true;
+    depth_state.depth.test_func = GL_ALWAYS;
+    depth_state.depth.write_mask = GL_TRUE;
+    depth_state.Apply();
+
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    dest.Attach(GL_DRAW_FRAMEBUFFER, dst_level, 0);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
 
-    const Common::Rectangle src_rect{copy.src_offset.x, copy.src_offset.y + copy.extent.height,
-                                     copy.src_offset.x + copy.extent.width, copy.src_offset.x};
-    const Common::Rectangle dst_rect{copy.dst_offset.x, copy.dst_offset.y + copy.extent.height,
-                                     copy.dst_offset.x + copy.extent.width, copy.dst_offset.x};
-    SetParams(rgba4_to_rgb5a1, source.RealExtent(), src_rect);
-    Draw(rgba4_to_rgb5a1, dest.Handle(), draw_fbo.handle, 0, dst_rect);
+    // Without stencil export the stencil is written a bit at a time, each draw replacing the bit
+    // in the texels that have it set and discarding the others.
+    if (dest.type == SurfaceType::DepthStencil) {
+        depth_state.depth.write_mask = GL_FALSE;
+        depth_state.stencil.test_enabled = true;
+        depth_state.stencil.test_func = GL_ALWAYS;
+        depth_state.stencil.test_ref = 0xFF;
+        depth_state.stencil.test_mask = 0xFF;
+        depth_state.stencil.action_stencil_fail = GL_KEEP;
+        depth_state.stencil.action_depth_fail = GL_KEEP;
+        depth_state.stencil.action_depth_pass = GL_REPLACE;
+        depth_state.stencil.write_mask = 0xFF;
+        depth_state.Apply();
+        const GLint zero = 0;
+        glClearBufferiv(GL_STENCIL, 0, &zero);
+        for (GLint bit = 0; bit < 8; bit++) {
+            depth_state.stencil.write_mask = 1u << bit;
+            depth_state.Apply();
+            glProgramUniform1i(reinterpret_program.handle, 4, bit);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+    }
 
-    return true;
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
 }
 
 bool BlitHelper::Filter(Surface& surface, const VideoCore::TextureBlit& blit) {
@@ -166,6 +214,7 @@ bool BlitHelper::Filter(Surface& surface, const VideoCore::TextureBlit& blit) {
         return true;
     }
 
+    const GpuTimer::Scope profile{gpu_timer, "Texture Filter"};
     switch (filter) {
     case TextureFilter::Anime4K:
         FilterAnime4K(surface, blit);
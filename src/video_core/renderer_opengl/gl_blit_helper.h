@@ -18,18 +18,21 @@ struct TextureCopy;
 namespace OpenGL {
 
 class Driver;
+class GpuTimer;
 class Surface;
 
 class BlitHelper {
 public:
-    explicit BlitHelper(const Driver& driver);
+    explicit BlitHelper(const Driver& driver, GpuTimer& gpu_timer);
     ~BlitHelper();
 
     bool Filter(Surface& surface, const VideoCore::TextureBlit& blit);
 
-    bool ConvertDS24S8ToRGBA8(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
-
-    bool ConvertRGBA4ToRGB5A1(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
+    /**
+     * Copies the texels of source to dest as if the memory holding them was read in the format of
+     * dest. Both formats must have the same number of bits per pixel, 16 or more.
+     */
+    bool Reinterpret(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
 
 private:
     void FilterAnime4K(Surface& surface, const VideoCore::TextureBlit& blit);
@@ -38,6 +41,9 @@ private:
     void FilterXbrz(Surface& surface, const VideoCore::TextureBlit& blit);
     void FilterMMPX(Surface& surface, const VideoCore::TextureBlit& blit);
 
+    void BindStencil(Surface& source, const VideoCore::TextureCopy& copy);
+    void DrawDepthStencil(Surface& dest, u32 dst_level, Common::Rectangle<u32> dst_rect);
+
     void SetParams(OGLProgram& program, const VideoCore::Extent& src_extent,
                    Common::Rectangle<u32> src_rect);
     void Draw(OGLProgram& program, GLuint dst_tex, GLuint dst_fbo, u32 dst_level,
@@ -45,6 +51,7 @@ private:
 
 private:
     const Driver& driver;
+    GpuTimer& gpu_timer;
     OGLVertexArray vao;
     OpenGLState state;
     OGLFramebuffer draw_fbo;
@@ -58,8 +65,7 @@ private:
     OGLProgram gradient_x_program;
     OGLProgram gradient_y_program;
     OGLProgram refine_program;
-    OGLProgram d24s8_to_rgba8;
-    OGLProgram rgba4_to_rgb5a1;
+    OGLProgram reinterpret_program;
 
     OGLTexture temp_tex;
     VideoCore::Extent temp_extent{};
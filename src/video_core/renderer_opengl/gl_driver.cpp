@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
 #include <glad/glad.h>
 #include "common/assert.h"
 #include "common/settings.h"
@@ -86,6 +87,7 @@ Driver::Driver(Core::TelemetrySession& telemetry_session_) : telemetry_session{t
     DeduceGLES();
     DeduceVendor();
     CheckExtensionSupport();
+    QueryMemoryBudget();
     FindBugs();
 }
 
@@ -188,6 +190,32 @@ void Driver::CheckExtensionSupport() {
     is_suitable = GLAD_GL_VERSION_4_3 || GLAD_GL_ES_VERSION_3_1;
 }
 
+void Driver::QueryMemoryBudget() {
+    // Neither memory info extension is part of the glad profile, so look them up by name.
+    constexpr GLenum GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX = 0x9048;
+    constexpr GLenum TEXTURE_FREE_MEMORY_ATI = 0x87FC;
+
+    GLint num_extensions{};
+    glGetIntegerv(GL_NUM_EXTENSIONS, &num_extensions);
+    for (GLint i = 0; i < num_extensions; i++) {
+        const std::string_view extension{
+            reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i))};
+        if (extension == "GL_NVX_gpu_memory_info") {
+            GLint total_kib{};
+            glGetIntegerv(GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &total_kib);
+            memory_budget = static_cast<u64>(total_kib) * 1024;
+            return;
+        }
+        if (extension == "GL_ATI_meminfo") {
+            // Only free memory is reported, which is the best estimate available at startup.
+            std::array<GLint, 4> texture_free_kib{};
+            glGetIntegerv(TEXTURE_FREE_MEMORY_ATI, texture_free_kib.data());
+            memory_budget = static_cast<u64>(texture_free_kib[0]) * 1024;
+            return;
+        }
+    }
+}
+
 void Driver::FindBugs() {
 #ifdef __unix__
     const bool is_linux = true;
@@ -135,11 +135,17 @@ public:
         return blend_minmax_factor;
     }
 
+    /// Returns the video memory in bytes reported by the driver, or zero if it is unknown
+    u64 GetMemoryBudget() const {
+        return memory_budget;
+    }
+
 private:
     void ReportDriverInfo();
     void DeduceGLES();
     void DeduceVendor();
     void CheckExtensionSupport();
+    void QueryMemoryBudget();
     void FindBugs();
 
 private:
@@ -162,6 +168,7 @@ private:
     bool nv_fragment_shader_interlock{};
     bool intel_fragment_shader_ordering{};
     bool blend_minmax_factor{};
+    u64 memory_budget{};
 
     std::string_view gl_version{};
     std::string_view gpu_vendor{};
@@ -0,0 +1,73 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include "video_core/gpu_profiler.h"
+#include "video_core/renderer_opengl/gl_driver.h"
+#include "video_core/renderer_opengl/gl_gpu_timer.h"
+
+namespace OpenGL {
+
+GpuTimer::GpuTimer(const Driver& driver, VideoCore::GpuProfiler& profiler_)
+    : profiler{profiler_}, is_supported{!driver.IsOpenGLES()} {
+    if (is_supported) {
+        glGenQueries(static_cast<GLsizei>(handles.size()), handles.data());
+    }
+}
+
+GpuTimer::~GpuTimer() {
+    if (is_supported) {
+        glDeleteQueries(static_cast<GLsizei>(handles.size()), handles.data());
+    }
+}
+
+s32 GpuTimer::Begin(const char* name) {
+    if (!is_supported || !profiler.IsEnabled()) {
+        return -1;
+    }
+    // Operations are dropped while the ring is full of unread results.
+    auto& query = queries[next_query];
+    if (query.state != State::Free) {
+        return -1;
+    }
+    query = {name, State::Open};
+    glQueryCounter(handles[next_query * 2], GL_TIMESTAMP);
+
+    const s32 index = static_cast<s32>(next_query);
+    next_query = (next_query + 1) % NUM_QUERIES;
+    return index;
+}
+
+void GpuTimer::End(s32 index) {
+    if (index < 0) {
+        return;
+    }
+    glQueryCounter(handles[index * 2 + 1], GL_TIMESTAMP);
+    queries[index].state = State::Pending;
+}
+
+void GpuTimer::Collect() {
+    if (!is_supported) {
+        return;
+    }
+    while (queries[oldest_query].state == State::Pending) {
+        GLint available{};
+        glGetQueryObjectiv(handles[oldest_query * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 begin{};
+        GLuint64 end{};
+        glGetQueryObjectui64v(handles[oldest_query * 2], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(handles[oldest_query * 2 + 1], GL_QUERY_RESULT, &end);
+        if (end > begin) {
+            profiler.AddSample(queries[oldest_query].name,
+                               std::chrono::nanoseconds{static_cast<s64>(end - begin)});
+        }
+        queries[oldest_query].state = State::Free;
+        oldest_query = (oldest_query + 1) % NUM_QUERIES;
+    }
+}
+
+} // namespace OpenGL
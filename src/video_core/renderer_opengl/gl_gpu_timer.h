@@ -0,0 +1,79 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <glad/glad.h>
+#include "common/common_types.h"
+
+namespace VideoCore {
+class GpuProfiler;
+}
+
+namespace OpenGL {
+
+class Driver;
+
+/**
+ * Measures the GPU time of OpenGL commands with GL_TIMESTAMP queries. Results are read back
+ * once available, so collecting them never stalls the pipeline. Timer queries are not part of
+ * OpenGL ES, the timer does nothing there.
+ */
+class GpuTimer {
+    /// Number of begin and end query pairs that can be in flight at once
+    static constexpr u32 NUM_QUERIES = 1024;
+
+public:
+    explicit GpuTimer(const Driver& driver, VideoCore::GpuProfiler& profiler);
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    /// Starts timing the commands issued until End, returns -1 when profiling is disabled.
+    [[nodiscard]] s32 Begin(const char* name);
+
+    /// Stops timing the commands of a query returned by Begin.
+    void End(s32 index);
+
+    /// Hands the completed queries to the profiler without waiting.
+    void Collect();
+
+    /// Times the commands issued during its lifetime.
+    class Scope {
+    public:
+        explicit Scope(GpuTimer& timer_, const char* name)
+            : timer{timer_}, index{timer.Begin(name)} {}
+
+        ~Scope() {
+            timer.End(index);
+        }
+
+    private:
+        GpuTimer& timer;
+        s32 index;
+    };
+
+private:
+    enum class State : u8 {
+        Free,
+        Open,
+        Pending,
+    };
+
+    struct Query {
+        const char* name;
+        State state;
+    };
+
+    VideoCore::GpuProfiler& profiler;
+    std::array<GLuint, NUM_QUERIES * 2> handles{};
+    std::array<Query, NUM_QUERIES> queries{};
+    u32 next_query{};
+    u32 oldest_query{};
+    bool is_supported{};
+};
+
+} // namespace OpenGL
@@ -49,6 +49,24 @@ GLenum MakePrimitiveMode(Pica::PipelineRegs::TriangleTopology topology) {
     return GL_TRIANGLES;
 }
 
+GLenum MakeGeometryInputMode(u32 vertices_per_invocation) {
+    switch (vertices_per_invocation) {
+    case 1:
+        return GL_POINTS;
+    case 2:
+        return GL_LINES;
+    case 3:
+        return GL_TRIANGLES;
+    case 4:
+        return GL_LINES_ADJACENCY;
+    case 6:
+        return GL_TRIANGLES_ADJACENCY;
+    default:
+        UNREACHABLE();
+    }
+    return GL_TRIANGLES;
+}
+
 GLenum MakeAttributeType(Pica::PipelineRegs::VertexAttributeFormat format) {
     switch (format) {
     case Pica::PipelineRegs::VertexAttributeFormat::BYTE:
@@ -77,7 +95,8 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory, Pica::PicaCore&
                                    VideoCore::CustomTexManager& custom_tex_manager,
                                    VideoCore::RendererBase& renderer, Driver& driver_)
     : VideoCore::RasterizerAccelerated{memory, pica}, driver{driver_},
-      shader_manager{renderer.GetRenderWindow(), driver, !driver.IsOpenGLES()},
+      shader_manager{renderer.GetSystem(), renderer.GetRenderWindow(), driver,
+                     !driver.IsOpenGLES()},
       runtime{driver, renderer}, res_cache{memory, custom_tex_manager, runtime, regs, renderer},
       texture_buffer_size{TextureBufferSize()}, vertex_buffer{driver, GL_ARRAY_BUFFER,
                                                               VERTEX_BUFFER_SIZE},
@@ -97,10 +116,14 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory, Pica::PicaCore&
     glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_buffer_alignment);
     uniform_size_aligned_vs_pica =
         Common::AlignUp<std::size_t>(sizeof(VSPicaUniformData), uniform_buffer_alignment);
+    uniform_size_aligned_gs_pica =
+        Common::AlignUp<std::size_t>(sizeof(GSPicaUniformData), uniform_buffer_alignment);
     uniform_size_aligned_vs =
         Common::AlignUp<std::size_t>(sizeof(VSUniformData), uniform_buffer_alignment);
     uniform_size_aligned_fs =
         Common::AlignUp<std::size_t>(sizeof(FSUniformData), uniform_buffer_alignment);
+    uniform_size_aligned_fs_config =
+        Common::AlignUp<std::size_t>(sizeof(FSConfigData), uniform_buffer_alignment);
 
     // Set vertex attributes for software shader path
     state.draw.vertex_array = sw_vao.handle;
@@ -165,7 +188,29 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory, Pica::PicaCore&
 RasterizerOpenGL::~RasterizerOpenGL() = default;
 
 void RasterizerOpenGL::TickFrame() {
+    runtime.Timer().Collect();
     res_cache.TickFrame();
+    vertex_array_cache.TickFrame();
+
+    stream_wait_time = vertex_buffer.ConsumeWaitTime() + uniform_buffer.ConsumeWaitTime() +
+                       index_buffer.ConsumeWaitTime() + texture_buffer.ConsumeWaitTime() +
+                       texture_lf_buffer.ConsumeWaitTime();
+}
+
+VideoCore::CacheStats RasterizerOpenGL::GetCacheStats() const {
+    const auto& eviction = res_cache.GetEvictionStats();
+    const auto& cpu_fallbacks = res_cache.GetCpuFallbackStats();
+    return {
+        .pipelines = shader_manager.NumPrograms(),
+        .shaders = shader_manager.NumShaders(),
+        .surface_memory = eviction.memory_usage,
+        .evicted_surfaces = eviction.evicted_surfaces,
+        .flushed_surfaces = eviction.flushed_surfaces,
+        .stream_wait_us = static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::microseconds>(stream_wait_time).count()),
+        .cpu_reinterpretations = cpu_fallbacks.reinterpretations,
+        .cpu_fills = cpu_fallbacks.fills,
+    };
 }
 
 void RasterizerOpenGL::LoadDiskResources(const std::atomic_bool& stop_loading,
@@ -187,23 +232,57 @@ void RasterizerOpenGL::SyncFixedState() {
     SyncDepthWriteMask();
 }
 
-void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
-                                        GLuint vs_input_index_min, GLuint vs_input_index_max) {
+std::size_t RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
+                                               GLuint vs_input_index_min,
+                                               GLuint vs_input_index_max) {
     MICROPROFILE_SCOPE(OpenGL_VAO);
     const auto& vertex_attributes = regs.pipeline.vertex_attributes;
     PAddr base_address = vertex_attributes.GetPhysicalBaseAddress();
 
     state.draw.vertex_array = hw_vao.handle;
-    state.draw.vertex_buffer = vertex_buffer.GetHandle();
     state.Apply();
 
     std::array<bool, 16> enable_attributes{};
+    std::size_t streamed_size = 0;
 
     for (const auto& loader : vertex_attributes.attribute_loaders) {
         if (loader.component_count == 0 || loader.byte_count == 0) {
             continue;
         }
 
+        const PAddr data_addr =
+            base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
+
+        const u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
+        const u32 data_size = loader.byte_count * vertex_num;
+
+        res_cache.FlushRegion(data_addr, data_size);
+        const u8* data = memory.GetPhysicalPointer(data_addr);
+
+        // Bind the array from its persistent buffer when unchanged, otherwise stream it
+        const OGLBuffer* cached = vertex_array_cache.Get(
+            data_addr, loader.byte_count, {data, data_size}, data_size, [&] {
+                OGLBuffer buffer;
+                buffer.Create();
+                state.draw.vertex_buffer = buffer.handle;
+                state.Apply();
+                glBufferData(GL_ARRAY_BUFFER, data_size, data, GL_STATIC_DRAW);
+                return buffer;
+            });
+
+        GLintptr attrib_offset = 0;
+        if (cached) {
+            state.draw.vertex_buffer = cached->handle;
+        } else {
+            state.draw.vertex_buffer = vertex_buffer.GetHandle();
+            std::memcpy(array_ptr, data, data_size);
+            attrib_offset = buffer_offset;
+            array_ptr += data_size;
+            buffer_offset += data_size;
+            streamed_size += data_size;
+        }
+        state.Apply();
+
         u32 offset = 0;
         for (u32 comp = 0; comp < loader.component_count && comp < 12; ++comp) {
             u32 attribute_index = loader.GetComponent(comp);
@@ -217,7 +296,7 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
                     GLenum type = MakeAttributeType(vertex_attributes.GetFormat(attribute_index));
                     GLsizei stride = loader.byte_count;
                     glVertexAttribPointer(input_reg, size, type, GL_FALSE, stride,
-                                          reinterpret_cast<GLvoid*>(buffer_offset + offset));
+                                          reinterpret_cast<GLvoid*>(attrib_offset + offset));
                     enable_attributes[input_reg] = true;
 
                     offset += vertex_attributes.GetStride(attribute_index);
@@ -229,18 +308,6 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
                 offset += (attribute_index - 11) * 4;
             }
         }
-
-        const PAddr data_addr =
-            base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
-
-        const u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
-        const u32 data_size = loader.byte_count * vertex_num;
-
-        res_cache.FlushRegion(data_addr, data_size);
-        std::memcpy(array_ptr, memory.GetPhysicalPointer(data_addr), data_size);
-
-        array_ptr += data_size;
-        buffer_offset += data_size;
     }
 
     for (std::size_t i = 0; i < enable_attributes.size(); ++i) {
@@ -262,6 +329,50 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
             }
         }
     }
+
+    return streamed_size;
+}
+
+bool RasterizerOpenGL::SetupImmediateArray() {
+    MICROPROFILE_SCOPE(OpenGL_VAO);
+    const u32 stride = ImmediateVertexStride();
+    const u32 size = stride * static_cast<u32>(immediate_vertices.size());
+    if (size > VERTEX_BUFFER_SIZE) {
+        LOG_WARNING(Render_OpenGL, "Too large immediate vertex input size {}", size);
+        return false;
+    }
+
+    state.draw.vertex_array = hw_vao.handle;
+    state.draw.vertex_buffer = vertex_buffer.GetHandle();
+    state.Apply();
+
+    const auto [array_ptr, buffer_offset, _] = vertex_buffer.Map(size, 4);
+    LoadImmediateVertices(immediate_vertices, array_ptr);
+    vertex_buffer.Unmap(size);
+
+    // Every input attribute is part of the vertex, default attributes are never read.
+    std::array<bool, 16> enable_attributes{};
+    const u32 num_attributes = stride / sizeof(Common::Vec4f);
+    for (u32 attr = 0; attr < num_attributes; ++attr) {
+        const u32 input_reg = regs.vs.GetRegisterForAttribute(attr);
+        const GLintptr attrib_offset = buffer_offset + attr * sizeof(Common::Vec4f);
+        glVertexAttribPointer(input_reg, 4, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<GLvoid*>(attrib_offset));
+        enable_attributes[input_reg] = true;
+    }
+
+    for (std::size_t i = 0; i < enable_attributes.size(); ++i) {
+        if (enable_attributes[i] != hw_vao_enabled_attributes[i]) {
+            if (enable_attributes[i]) {
+                glEnableVertexAttribArray(static_cast<GLuint>(i));
+            } else {
+                glDisableVertexAttribArray(static_cast<GLuint>(i));
+            }
+            hw_vao_enabled_attributes[i] = enable_attributes[i];
+        }
+    }
+
+    return true;
 }
 
 bool RasterizerOpenGL::SetupVertexShader() {
@@ -273,8 +384,7 @@ bool RasterizerOpenGL::SetupGeometryShader() {
     MICROPROFILE_SCOPE(OpenGL_GS);
 
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        LOG_ERROR(Render_OpenGL, "Accelerate draw doesn't support geometry shader");
-        return false;
+        return shader_manager.UseProgrammableGeometryShader(regs, pica.gs_setup);
     }
 
     // Enable the quaternion fix-up geometry-shader only if we are actually doing per-fragment
@@ -310,8 +420,37 @@ bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
     return Draw(true, is_indexed);
 }
 
+bool RasterizerOpenGL::AccelerateDrawImmediate(std::span<const Pica::AttributeBuffer> vertices) {
+    if (!SetupVertexShader()) {
+        return false;
+    }
+
+    if (!SetupGeometryShader()) {
+        return false;
+    }
+
+    immediate_vertices = vertices;
+    const bool succeeded = Draw(true, false);
+    immediate_vertices = {};
+    return succeeded;
+}
+
 bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
-    const GLenum primitive_mode = MakePrimitiveMode(regs.pipeline.triangle_topology);
+    const GLenum primitive_mode =
+        regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No
+            ? MakeGeometryInputMode(GetGSVerticesPerInvocation(regs))
+            : MakePrimitiveMode(regs.pipeline.triangle_topology);
+
+    if (!immediate_vertices.empty()) {
+        if (!SetupImmediateArray()) {
+            return false;
+        }
+        shader_manager.ApplyTo(state);
+        state.Apply();
+        glDrawArrays(primitive_mode, 0, static_cast<GLsizei>(immediate_vertices.size()));
+        return true;
+    }
+
     auto [vs_input_index_min, vs_input_index_max, vs_input_size] = AnalyzeVertexArray(is_indexed);
 
     if (vs_input_size > VERTEX_BUFFER_SIZE) {
@@ -325,8 +464,14 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
     u8* buffer_ptr;
     GLintptr buffer_offset;
     std::tie(buffer_ptr, buffer_offset, std::ignore) = vertex_buffer.Map(vs_input_size, 4);
-    SetupVertexArray(buffer_ptr, buffer_offset, vs_input_index_min, vs_input_index_max);
-    vertex_buffer.Unmap(vs_input_size);
+    const std::size_t streamed_size =
+        SetupVertexArray(buffer_ptr, buffer_offset, vs_input_index_min, vs_input_index_max);
+
+    // Cached arrays are bound from their own buffers, the stream buffer is unmapped through its
+    // binding.
+    state.draw.vertex_buffer = vertex_buffer.GetHandle();
+    state.Apply();
+    vertex_buffer.Unmap(streamed_size);
 
     shader_manager.ApplyTo(state);
     state.Apply();
@@ -434,6 +579,7 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     // Sync and bind the shader
     if (shader_dirty) {
         shader_manager.UseFragmentShader(regs, user_config);
+        fs_config_dirty = shader_manager.IsUberShaderEnabled();
         shader_dirty = false;
     }
 
@@ -445,6 +591,7 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     UploadUniforms(accelerate);
 
     // Draw the vertex batch
+    const GpuTimer::Scope profile{runtime.Timer(), "Draw"};
     bool succeeded = true;
     if (accelerate) {
         succeeded = AccelerateDrawBatchInternal(is_indexed);
@@ -703,6 +850,10 @@ void RasterizerOpenGL::FlushAndInvalidateRegion(PAddr addr, u32 size) {
     res_cache.InvalidateRegion(addr, size);
 }
 
+bool RasterizerOpenGL::IsReadbackTarget(PAddr addr) const {
+    return res_cache.IsReadbackTarget(addr);
+}
+
 void RasterizerOpenGL::ClearAll(bool flush) {
     res_cache.ClearAll(flush);
 }
@@ -939,15 +1090,13 @@ void RasterizerOpenGL::SyncAndUploadLUTsLF() {
     if (fs_uniform_block_data.lighting_lut_dirty_any || invalidate) {
         for (unsigned index = 0; index < fs_uniform_block_data.lighting_lut_dirty.size(); index++) {
             if (fs_uniform_block_data.lighting_lut_dirty[index] || invalidate) {
-                std::array<Common::Vec2f, 256> new_data;
                 const auto& source_lut = pica.lighting.luts[index];
-                std::transform(source_lut.begin(), source_lut.end(), new_data.begin(),
-                               [](const auto& entry) {
-                                   return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                               });
-
-                if (new_data != lighting_lut_data[index] || invalidate) {
-                    lighting_lut_data[index] = new_data;
+                if (UpdateLutHash(source_lut, lighting_lut_hashes[index]) || invalidate) {
+                    std::array<Common::Vec2f, 256> new_data;
+                    std::transform(source_lut.begin(), source_lut.end(), new_data.begin(),
+                                   [](const auto& entry) {
+                                       return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
+                                   });
                     std::memcpy(buffer + bytes_used, new_data.data(),
                                 new_data.size() * sizeof(Common::Vec2f));
                     fs_uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
@@ -963,15 +1112,12 @@ void RasterizerOpenGL::SyncAndUploadLUTsLF() {
 
     // Sync the fog lut
     if (fs_uniform_block_data.fog_lut_dirty || invalidate) {
-        std::array<Common::Vec2f, 128> new_data;
-
-        std::transform(pica.fog.lut.begin(), pica.fog.lut.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                       });
-
-        if (new_data != fog_lut_data || invalidate) {
-            fog_lut_data = new_data;
+        if (UpdateLutHash(pica.fog.lut, fog_lut_hash) || invalidate) {
+            std::array<Common::Vec2f, 128> new_data;
+            std::transform(pica.fog.lut.begin(), pica.fog.lut.end(), new_data.begin(),
+                           [](const auto& entry) {
+                               return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
+                           });
             std::memcpy(buffer + bytes_used, new_data.data(),
                         new_data.size() * sizeof(Common::Vec2f));
             fs_uniform_block_data.data.fog_lut_offset =
@@ -982,6 +1128,7 @@ void RasterizerOpenGL::SyncAndUploadLUTsLF() {
         fs_uniform_block_data.fog_lut_dirty = false;
     }
 
+    MICROPROFILE_META_CPU("LUT Upload Bytes", static_cast<int>(bytes_used));
     texture_lf_buffer.Unmap(bytes_used);
 }
 
@@ -1005,14 +1152,12 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
     // helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
     const auto sync_proc_tex_value_lut =
         [this, buffer = buffer, offset = offset, invalidate = invalidate, &bytes_used](
-            const auto& lut, std::array<Common::Vec2f, 128>& lut_data, GLint& lut_offset) {
-            std::array<Common::Vec2f, 128> new_data;
-            std::transform(lut.begin(), lut.end(), new_data.begin(), [](const auto& entry) {
-                return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-            });
-
-            if (new_data != lut_data || invalidate) {
-                lut_data = new_data;
+            const auto& lut, u64& lut_hash, GLint& lut_offset) {
+            if (UpdateLutHash(lut, lut_hash) || invalidate) {
+                std::array<Common::Vec2f, 128> new_data;
+                std::transform(lut.begin(), lut.end(), new_data.begin(), [](const auto& entry) {
+                    return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
+                });
                 std::memcpy(buffer + bytes_used, new_data.data(),
                             new_data.size() * sizeof(Common::Vec2f));
                 lut_offset = static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec2f));
@@ -1023,37 +1168,34 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
 
     // Sync the proctex noise lut
     if (fs_uniform_block_data.proctex_noise_lut_dirty || invalidate) {
-        sync_proc_tex_value_lut(pica.proctex.noise_table, proctex_noise_lut_data,
+        sync_proc_tex_value_lut(pica.proctex.noise_table, proctex_noise_lut_hash,
                                 fs_uniform_block_data.data.proctex_noise_lut_offset);
         fs_uniform_block_data.proctex_noise_lut_dirty = false;
     }
 
     // Sync the proctex color map
     if (fs_uniform_block_data.proctex_color_map_dirty || invalidate) {
-        sync_proc_tex_value_lut(pica.proctex.color_map_table, proctex_color_map_data,
+        sync_proc_tex_value_lut(pica.proctex.color_map_table, proctex_color_map_hash,
                                 fs_uniform_block_data.data.proctex_color_map_offset);
         fs_uniform_block_data.proctex_color_map_dirty = false;
     }
 
     // Sync the proctex alpha map
     if (fs_uniform_block_data.proctex_alpha_map_dirty || invalidate) {
-        sync_proc_tex_value_lut(pica.proctex.alpha_map_table, proctex_alpha_map_data,
+        sync_proc_tex_value_lut(pica.proctex.alpha_map_table, proctex_alpha_map_hash,
                                 fs_uniform_block_data.data.proctex_alpha_map_offset);
         fs_uniform_block_data.proctex_alpha_map_dirty = false;
     }
 
     // Sync the proctex lut
     if (fs_uniform_block_data.proctex_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(pica.proctex.color_table.begin(), pica.proctex.color_table.end(),
-                       new_data.begin(), [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_lut_data || invalidate) {
-            proctex_lut_data = new_data;
+        if (UpdateLutHash(pica.proctex.color_table, proctex_lut_hash) || invalidate) {
+            std::array<Common::Vec4f, 256> new_data;
+            std::transform(pica.proctex.color_table.begin(), pica.proctex.color_table.end(),
+                           new_data.begin(), [](const auto& entry) {
+                               auto rgba = entry.ToVector() / 255.0f;
+                               return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
+                           });
             std::memcpy(buffer + bytes_used, new_data.data(),
                         new_data.size() * sizeof(Common::Vec4f));
             fs_uniform_block_data.data.proctex_lut_offset =
@@ -1066,16 +1208,14 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
 
     // Sync the proctex difference lut
     if (fs_uniform_block_data.proctex_diff_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(pica.proctex.color_diff_table.begin(), pica.proctex.color_diff_table.end(),
-                       new_data.begin(), [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_diff_lut_data || invalidate) {
-            proctex_diff_lut_data = new_data;
+        if (UpdateLutHash(pica.proctex.color_diff_table, proctex_diff_lut_hash) || invalidate) {
+            std::array<Common::Vec4f, 256> new_data;
+            std::transform(pica.proctex.color_diff_table.begin(),
+                           pica.proctex.color_diff_table.end(), new_data.begin(),
+                           [](const auto& entry) {
+                               auto rgba = entry.ToVector() / 255.0f;
+                               return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
+                           });
             std::memcpy(buffer + bytes_used, new_data.data(),
                         new_data.size() * sizeof(Common::Vec4f));
             fs_uniform_block_data.data.proctex_diff_lut_offset =
@@ -1086,6 +1226,7 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
         fs_uniform_block_data.proctex_diff_lut_dirty = false;
     }
 
+    MICROPROFILE_META_CPU("LUT Upload Bytes", static_cast<int>(bytes_used));
     texture_buffer.Unmap(bytes_used);
 }
 
@@ -1094,15 +1235,19 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
     state.draw.uniform_buffer = uniform_buffer.GetHandle();
     state.Apply();
 
-    const bool sync_vs_pica = accelerate_draw;
+    const bool use_gs = accelerate_draw && regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No;
+    const bool sync_vs_pica = accelerate_draw && SyncVSPicaUniforms();
+    const bool sync_gs_pica = use_gs && gs_pica_uniforms_dirty;
     const bool sync_vs = vs_uniform_block_data.dirty;
     const bool sync_fs = fs_uniform_block_data.dirty;
-    if (!sync_vs_pica && !sync_vs && !sync_fs) {
+    const bool sync_fs_config = fs_config_dirty;
+    if (!sync_vs_pica && !sync_gs_pica && !sync_vs && !sync_fs && !sync_fs_config) {
         return;
     }
 
-    std::size_t uniform_size =
-        uniform_size_aligned_vs_pica + uniform_size_aligned_vs + uniform_size_aligned_fs;
+    std::size_t uniform_size = uniform_size_aligned_vs_pica + uniform_size_aligned_gs_pica +
+                               uniform_size_aligned_vs + uniform_size_aligned_fs +
+                               uniform_size_aligned_fs_config;
     std::size_t used_bytes = 0;
 
     const auto [uniforms, offset, invalidate] =
@@ -1126,15 +1271,40 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
         used_bytes += uniform_size_aligned_fs;
     }
 
-    if (sync_vs_pica) {
-        VSPicaUniformData vs_uniforms;
-        vs_uniforms.uniforms.SetFromRegs(regs.vs, pica.vs_setup);
-        std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
+    if (sync_fs_config || (invalidate && shader_manager.IsUberShaderEnabled())) {
+        const auto& config_data = shader_manager.FragmentConfigData();
+        std::memcpy(uniforms + used_bytes, &config_data, sizeof(config_data));
+        glBindBufferRange(GL_UNIFORM_BUFFER, UniformBindings::UberShaderConfig,
+                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(config_data));
+        fs_config_dirty = false;
+        used_bytes += uniform_size_aligned_fs_config;
+    }
+
+    if (sync_vs_pica || (accelerate_draw && invalidate)) {
+        std::memcpy(uniforms + used_bytes, &vs_pica_uniform_data, sizeof(vs_pica_uniform_data));
         glBindBufferRange(GL_UNIFORM_BUFFER, UniformBindings::VSPicaData,
-                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(vs_uniforms));
+                          uniform_buffer.GetHandle(), offset + used_bytes,
+                          sizeof(vs_pica_uniform_data));
         used_bytes += uniform_size_aligned_vs_pica;
+        vs_pica_uniforms_changed = false;
+    } else if (invalidate) {
+        // The previous upload is no longer valid, so it has to be repeated on the next draw.
+        vs_pica_uniforms_changed = true;
+    }
+
+    if (sync_gs_pica || (use_gs && invalidate)) {
+        GSPicaUniformData gs_uniforms;
+        gs_uniforms.uniforms.SetFromRegs(regs.gs, pica.gs_setup);
+        std::memcpy(uniforms + used_bytes, &gs_uniforms, sizeof(gs_uniforms));
+        glBindBufferRange(GL_UNIFORM_BUFFER, UniformBindings::GSPicaData,
+                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(gs_uniforms));
+        used_bytes += uniform_size_aligned_gs_pica;
+        gs_pica_uniforms_dirty = false;
+    } else if (invalidate) {
+        gs_pica_uniforms_dirty = true;
     }
 
+    MICROPROFILE_META_CPU("Uniform Upload Bytes", static_cast<int>(used_bytes));
     uniform_buffer.Unmap(used_bytes);
 }
 
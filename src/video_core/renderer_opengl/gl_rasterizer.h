@@ -10,6 +10,7 @@
 #include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/renderer_opengl/gl_stream_buffer.h"
 #include "video_core/renderer_opengl/gl_texture_runtime.h"
+#include "video_core/vertex_array_cache.h"
 
 namespace VideoCore {
 class RendererBase;
@@ -48,6 +49,7 @@ public:
     void FlushRegion(PAddr addr, u32 size) override;
     void InvalidateRegion(PAddr addr, u32 size) override;
     void FlushAndInvalidateRegion(PAddr addr, u32 size) override;
+    bool IsReadbackTarget(PAddr addr) const override;
     void ClearAll(bool flush) override;
     bool AccelerateDisplayTransfer(const Pica::DisplayTransferConfig& config) override;
     bool AccelerateTextureCopy(const Pica::DisplayTransferConfig& config) override;
@@ -55,6 +57,8 @@ public:
     bool AccelerateDisplay(const Pica::FramebufferConfig& config, PAddr framebuffer_addr,
                            u32 pixel_stride, ScreenInfo& screen_info);
     bool AccelerateDrawBatch(bool is_indexed) override;
+    bool AccelerateDrawImmediate(std::span<const Pica::AttributeBuffer> vertices) override;
+    VideoCore::CacheStats GetCacheStats() const override;
 
 private:
     void SyncFixedState() override;
@@ -124,9 +128,12 @@ private:
     /// Internal implementation for AccelerateDrawBatch
     bool AccelerateDrawBatchInternal(bool is_indexed);
 
-    /// Setup vertex array for AccelerateDrawBatch
-    void SetupVertexArray(u8* array_ptr, GLintptr buffer_offset, GLuint vs_input_index_min,
-                          GLuint vs_input_index_max);
+    /// Setup vertex array for AccelerateDrawBatch, returns the number of bytes streamed
+    std::size_t SetupVertexArray(u8* array_ptr, GLintptr buffer_offset, GLuint vs_input_index_min,
+                                 GLuint vs_input_index_max);
+
+    /// Setup vertex array for AccelerateDrawImmediate, returns false when the batch is too large
+    bool SetupImmediateArray();
 
     /// Setup vertex shader for AccelerateDrawBatch
     bool SetupVertexShader();
@@ -144,6 +151,8 @@ private:
     OGLVertexArray sw_vao; // VAO for software shader draw
     OGLVertexArray hw_vao; // VAO for hardware shader / accelerate draw
     std::array<bool, 16> hw_vao_enabled_attributes{};
+    VideoCore::VertexArrayCache<OGLBuffer> vertex_array_cache;
+    std::span<const Pica::AttributeBuffer> immediate_vertices;
 
     GLsizeiptr texture_buffer_size;
     OGLStreamBuffer vertex_buffer;
@@ -151,10 +160,14 @@ private:
     OGLStreamBuffer index_buffer;
     OGLStreamBuffer texture_buffer;
     OGLStreamBuffer texture_lf_buffer;
+    std::chrono::nanoseconds stream_wait_time{};
     GLint uniform_buffer_alignment;
     std::size_t uniform_size_aligned_vs_pica;
+    std::size_t uniform_size_aligned_gs_pica;
     std::size_t uniform_size_aligned_vs;
     std::size_t uniform_size_aligned_fs;
+    std::size_t uniform_size_aligned_fs_config;
+    bool fs_config_dirty{};
 
     OGLTexture texture_buffer_lut_lf;
     OGLTexture texture_buffer_lut_rg;
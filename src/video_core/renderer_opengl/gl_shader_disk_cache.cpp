@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <cstring>
+#include <random>
 #include <fmt/format.h>
 
 #include "common/common_paths.h"
@@ -103,8 +104,8 @@ bool ShaderDiskCacheRaw::Save(FileUtil::IOFile& file) const {
     return true;
 }
 
-ShaderDiskCache::ShaderDiskCache(bool separable)
-    : separable{separable}, transferable_file(AppendTransferableFile()),
+ShaderDiskCache::ShaderDiskCache(Core::System& system_, bool separable)
+    : system{system_}, separable{separable}, transferable_file(AppendTransferableFile()),
       // seperable shaders use the virtual precompile file, that already has a header.
       precompiled_file(AppendPrecompiledFile(!separable)) {}
 
@@ -116,7 +117,10 @@ std::optional<std::vector<ShaderDiskCacheRaw>> ShaderDiskCache::LoadTransferable
     }
     tried_to_load = true;
 
-    if (transferable_file.GetSize() == 0) {
+    // Other processes append whole entries under an exclusive lock, so the file ends at an entry
+    FileUtil::ScopedFileLock lock{transferable_file, false};
+    const u64 file_size = transferable_file.GetSize();
+    if (file_size == 0) {
         LOG_INFO(Render_OpenGL, "No transferable shader cache found for game with title id={}",
                  GetTitleID());
         return std::nullopt;
@@ -144,7 +148,7 @@ std::optional<std::vector<ShaderDiskCacheRaw>> ShaderDiskCache::LoadTransferable
 
     // Version is valid, load the shaders
     std::vector<ShaderDiskCacheRaw> raws;
-    while (transferable_file.Tell() < transferable_file.GetSize()) {
+    while (transferable_file.Tell() < file_size) {
         TransferableEntryKind kind{};
         if (transferable_file.ReadBytes(&kind, sizeof(u32)) != sizeof(u32)) {
             LOG_ERROR(Render_OpenGL, "Failed to read transferable file - removing");
@@ -366,14 +370,17 @@ void ShaderDiskCache::SaveRaw(const ShaderDiskCacheRaw& entry) {
         return;
     }
 
-    if (transferable_file.WriteObject(TransferableEntryKind::Raw) != 1 ||
-        !entry.Save(transferable_file)) {
-        LOG_ERROR(Render_OpenGL, "Failed to save raw transferable cache entry - removing");
-        InvalidateAll();
-        return;
+    {
+        // Flushed under the lock, so that the entries of other processes do not interleave
+        FileUtil::ScopedFileLock lock{transferable_file, true};
+        if (transferable_file.WriteObject(TransferableEntryKind::Raw) != 1 ||
+            !entry.Save(transferable_file) || !transferable_file.Flush()) {
+            LOG_ERROR(Render_OpenGL, "Failed to save raw transferable cache entry - removing");
+            InvalidateAll();
+            return;
+        }
     }
     transferable.insert({id, entry});
-    transferable_file.Flush();
 }
 
 void ShaderDiskCache::SaveDecompiled(u64 unique_identifier, const std::string& code,
@@ -426,6 +433,7 @@ void ShaderDiskCache::SaveDumpToFile(u64 unique_identifier, GLuint program, bool
     std::vector<u8> binary(binary_length);
     glGetProgramBinary(program, binary_length, nullptr, &binary_format, binary.data());
 
+    FileUtil::ScopedFileLock lock{precompiled_file, true};
     if (precompiled_file.WriteObject(static_cast<u32>(PrecompiledEntryKind::Dump)) != 1 ||
         precompiled_file.WriteObject(unique_identifier) != 1 ||
         precompiled_file.WriteObject(static_cast<u32>(binary_format)) != 1 ||
@@ -453,20 +461,15 @@ FileUtil::IOFile ShaderDiskCache::AppendTransferableFile() {
         return {};
 
     const auto transferable_path{GetTransferablePath()};
-    const bool existed = FileUtil::Exists(transferable_path);
-
     FileUtil::IOFile file(transferable_path, "ab+");
     if (!file.IsOpen()) {
         LOG_ERROR(Render_OpenGL, "Failed to open transferable cache in path={}", transferable_path);
         return {};
     }
-    if (!existed || file.GetSize() == 0) {
-        // If the file didn't exist, write its version
-        if (file.WriteObject(NativeVersion) != 1) {
-            LOG_ERROR(Render_OpenGL, "Failed to write transferable cache version in path={}",
-                      transferable_path);
-            return {};
-        }
+    if (!WriteHeaderIfEmpty(file, [&file] { return file.WriteObject(NativeVersion) == 1; })) {
+        LOG_ERROR(Render_OpenGL, "Failed to write transferable cache version in path={}",
+                  transferable_path);
+        return {};
     }
     return file;
 }
@@ -476,22 +479,19 @@ FileUtil::IOFile ShaderDiskCache::AppendPrecompiledFile(bool write_header) {
         return {};
 
     const auto precompiled_path{GetPrecompiledPath()};
-    const bool existed = FileUtil::Exists(precompiled_path);
-
     FileUtil::IOFile file(precompiled_path, "ab+");
     if (!file.IsOpen()) {
         LOG_ERROR(Render_OpenGL, "Failed to open precompiled cache in path={}", precompiled_path);
         return {};
     }
 
-    // If the file didn't exist, write its version
-    if (write_header && (!existed || file.GetSize() == 0)) {
-        const auto hash{GetShaderCacheVersionHash()};
-        if (file.WriteArray(hash.data(), hash.size()) != hash.size()) {
-            LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache version in path={}",
-                      precompiled_path);
-            return {};
-        }
+    if (write_header && !WriteHeaderIfEmpty(file, [&file] {
+            const auto hash{GetShaderCacheVersionHash()};
+            return file.WriteArray(hash.data(), hash.size()) == hash.size();
+        })) {
+        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache version in path={}",
+                  precompiled_path);
+        return {};
     }
     return file;
 }
@@ -512,19 +512,36 @@ void ShaderDiskCache::SaveVirtualPrecompiledFile() {
 
     const auto precompiled_path{GetPrecompiledPath()};
 
+    // Written aside and renamed over the cache, so that other processes never read it half written
+    const auto temp_path = fmt::format("{}.{:08x}.tmp", precompiled_path, std::random_device{}());
+    {
+        FileUtil::IOFile temp_file(temp_path, "wb");
+        const auto hash{GetShaderCacheVersionHash()};
+        if (!temp_file.IsOpen() ||
+            (!separable && temp_file.WriteArray(hash.data(), hash.size()) != hash.size()) ||
+            temp_file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache in path={}", temp_path);
+            temp_file.Close();
+            FileUtil::Delete(temp_path);
+            return;
+        }
+    }
+
     precompiled_file.Close();
-    if (!FileUtil::Delete(GetPrecompiledPath())) {
-        LOG_ERROR(Render_OpenGL, "Failed to invalidate precompiled file={}", GetPrecompiledPath());
+    if (!FileUtil::RenameReplacing(temp_path, precompiled_path)) {
+        FileUtil::Delete(temp_path);
     }
     precompiled_file = AppendPrecompiledFile(!separable);
+}
 
-    if (precompiled_file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
-        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache version in path={}",
-                  precompiled_path);
-        return;
+bool ShaderDiskCache::WriteHeaderIfEmpty(FileUtil::IOFile& file,
+                                         const std::function<bool()>& write_header) {
+    // Another process may be creating the file as well
+    FileUtil::ScopedFileLock lock{file, true};
+    if (file.GetSize() != 0) {
+        return true;
     }
-
-    precompiled_file.Flush();
+    return write_header() && file.Flush();
 }
 
 bool ShaderDiskCache::EnsureDirectories() const {
@@ -573,8 +590,7 @@ u64 ShaderDiskCache::GetProgramID() {
     if (program_id != 0) {
         return program_id;
     }
-    if (Core::System::GetInstance().GetAppLoader().ReadProgramId(program_id) !=
-        Loader::ResultStatus::Success) {
+    if (system.GetAppLoader().ReadProgramId(program_id) != Loader::ResultStatus::Success) {
         return 0;
     }
     return program_id;
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -83,7 +84,7 @@ struct ShaderDiskCacheDump {
 
 class ShaderDiskCache {
 public:
-    explicit ShaderDiskCache(bool separable);
+    explicit ShaderDiskCache(Core::System& system, bool separable);
     ~ShaderDiskCache() = default;
 
     /// Loads transferable cache. If file has a old version or on failure, it deletes the file.
@@ -138,6 +139,10 @@ private:
     /// Opens current game's precompiled file and write it's header if it doesn't exist
     FileUtil::IOFile AppendPrecompiledFile(bool write_header);
 
+    /// Writes the header of a cache file opened for appending unless it has contents already
+    static bool WriteHeaderIfEmpty(FileUtil::IOFile& file,
+                                   const std::function<bool()>& write_header);
+
     /// Save precompiled header to precompiled_cache_in_memory
     void SavePrecompiledHeaderToVirtualPrecompiledCache();
 
@@ -212,6 +217,7 @@ private:
     // The cache has been loaded at boot
     bool tried_to_load{};
 
+    Core::System& system;
     bool separable{};
 
     u64 program_id{};
@@ -8,8 +8,10 @@
 #include <span>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 #include "common/settings.h"
+#include "common/thread_worker.h"
 #include "core/frontend/emu_window.h"
 #include "video_core/pica/shader_setup.h"
 #include "video_core/renderer_opengl/gl_driver.h"
@@ -18,8 +20,10 @@
 #include "video_core/renderer_opengl/gl_shader_manager.h"
 #include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/shader/generator/glsl_fs_shader_gen.h"
+#include "video_core/shader/generator/glsl_fs_ubershader_gen.h"
 #include "video_core/shader/generator/glsl_shader_gen.h"
 #include "video_core/shader/generator/profile.h"
+#include "video_core/video_core.h"
 
 using namespace Pica::Shader::Generator;
 using Pica::Shader::FSConfig;
@@ -81,6 +85,13 @@ static std::set<GLenum> GetSupportedFormats() {
     return supported_formats;
 }
 
+static bool UsesGeometryShader(const Pica::RegsInternal& regs) {
+    // The programmable geometry shader consumes the raw vertex shader outputs. Otherwise enable
+    // the geometry-shader only if we are actually doing per-fragment lighting and care about
+    // proper quaternions, and just use standard vertex+fragment shaders when we don't.
+    return regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No || !regs.lighting.disable;
+}
+
 static std::tuple<PicaVSConfig, Pica::ShaderSetup> BuildVSConfigFromRaw(
     const ShaderDiskCacheRaw& raw, const Driver& driver) {
     Pica::ProgramCode program_code{};
@@ -92,9 +103,7 @@ static std::tuple<PicaVSConfig, Pica::ShaderSetup> BuildVSConfigFromRaw(
     setup.program_code = program_code;
     setup.swizzle_data = swizzle_data;
 
-    // Enable the geometry-shader only if we are actually doing per-fragment lighting
-    // and care about proper quaternions. Otherwise just use standard vertex+fragment shaders
-    const bool use_geometry_shader = !raw.GetRawShaderConfig().lighting.disable;
+    const bool use_geometry_shader = UsesGeometryShader(raw.GetRawShaderConfig());
     return {PicaVSConfig{raw.GetRawShaderConfig(), setup, driver.HasClipCullDistance(),
                          use_geometry_shader},
             setup};
@@ -159,7 +168,8 @@ private:
 template <typename KeyConfigType, auto CodeGenerator, GLenum ShaderType>
 class ShaderCache {
 public:
-    explicit ShaderCache(bool separable_) : separable{separable_} {}
+    explicit ShaderCache(Core::System& system_, bool separable_)
+        : system{system_}, separable{separable_} {}
     ~ShaderCache() = default;
 
     template <typename... Args>
@@ -171,10 +181,15 @@ public:
         if (new_shader) {
             result = CodeGenerator(config, args...);
             cached_shader.Create(result->c_str(), ShaderType);
+            VideoCore::CountFrameEvent(system, Core::PerfStats::FrameCounter::ShaderCompiles);
         }
         return {cached_shader.GetHandle(), std::move(result)};
     }
 
+    bool Contains(const KeyConfigType& key) const {
+        return shaders.contains(key);
+    }
+
     void Inject(const KeyConfigType& key, OGLProgram&& program) {
         OGLShaderStage stage{separable};
         stage.Inject(std::move(program));
@@ -185,7 +200,12 @@ public:
         shaders.emplace(key, std::move(stage));
     }
 
+    std::size_t Size() const {
+        return shaders.size();
+    }
+
 private:
+    Core::System& system;
     bool separable;
     std::unordered_map<KeyConfigType, OGLShaderStage> shaders;
 };
@@ -200,7 +220,8 @@ template <typename KeyConfigType,
           GLenum ShaderType>
 class ShaderDoubleCache {
 public:
-    explicit ShaderDoubleCache(bool separable) : separable(separable) {}
+    explicit ShaderDoubleCache(Core::System& system, bool separable)
+        : system(system), separable(separable) {}
     std::tuple<GLuint, std::optional<std::string>> Get(const KeyConfigType& key,
                                                        const Pica::ShaderSetup& setup) {
         std::optional<std::string> result{};
@@ -217,6 +238,7 @@ public:
             if (new_shader) {
                 result = program;
                 cached_shader.Create(program.c_str(), ShaderType);
+                VideoCore::CountFrameEvent(system, Core::PerfStats::FrameCounter::ShaderCompiles);
             }
             shader_map[key] = &cached_shader;
             return {cached_shader.GetHandle(), std::move(result)};
@@ -243,7 +265,12 @@ public:
         shader_map.insert_or_assign(key, &cached_shader);
     }
 
+    std::size_t Size() const {
+        return shader_cache.size();
+    }
+
 private:
+    Core::System& system;
     bool separable;
     std::unordered_map<KeyConfigType, OGLShaderStage*> shader_map;
     std::unordered_map<std::string, OGLShaderStage> shader_cache;
@@ -252,6 +279,9 @@ private:
 using ProgrammableVertexShaders =
     ShaderDoubleCache<PicaVSConfig, &GLSL::GenerateVertexShader, GL_VERTEX_SHADER>;
 
+using ProgrammableGeometryShaders =
+    ShaderDoubleCache<PicaGSConfig, &GLSL::GenerateGeometryShader, GL_GEOMETRY_SHADER>;
+
 using FixedGeometryShaders =
     ShaderCache<PicaFixedGSConfig, &GLSL::GenerateFixedGeometryShader, GL_GEOMETRY_SHADER>;
 
@@ -259,10 +289,12 @@ using FragmentShaders = ShaderCache<FSConfig, &GLSL::GenerateFragmentShader, GL_
 
 class ShaderProgramManager::Impl {
 public:
-    explicit Impl(const Driver& driver, bool separable)
-        : separable(separable), programmable_vertex_shaders(separable),
-          trivial_vertex_shader(driver, separable), fixed_geometry_shaders(separable),
-          fragment_shaders(separable), disk_cache(separable) {
+    explicit Impl(Core::System& system, const Driver& driver, bool separable)
+        : system(system), separable(separable), programmable_vertex_shaders(system, separable),
+          trivial_vertex_shader(driver, separable),
+          programmable_geometry_shaders(system, separable),
+          fixed_geometry_shaders(system, separable), fragment_shaders(system, separable),
+          disk_cache(system, separable) {
         if (separable) {
             pipeline.Create();
         }
@@ -313,6 +345,60 @@ public:
     static_assert(offsetof(ShaderTuple, fs_hash) == sizeof(std::size_t) * 2,
                   "ShaderTuple layout changed!");
 
+    /// Starts compiling fragment shaders on a worker thread with its own shared context.
+    void EnableUberShader(std::unique_ptr<Frontend::GraphicsContext> context) {
+        compile_context = std::move(context);
+        compile_worker = std::make_unique<Common::ThreadWorker>(1, "GLShaderCompile",
+                                                                Common::ThreadRole::Background);
+        compile_worker->QueueWork([this] {
+            const auto scope = compile_context->Acquire();
+            const std::string code =
+                GLSL::GenerateFragmentUberShader(profile, UniformBindings::UberShaderConfig);
+            OGLShader shader;
+            shader.Create(code, GL_FRAGMENT_SHADER);
+            ubershader.Create(true, std::array{shader.handle});
+            glFinish();
+            ubershader_ready = ubershader.handle != 0;
+        });
+    }
+
+    /// Queues the specialized fragment shader for compilation on the worker thread.
+    void QueueFragmentShader(const FSConfig& config, std::string code) {
+        pending_shaders.insert(config);
+        compile_worker->QueueWork([this, config, code = std::move(code)] {
+            const auto scope = compile_context->Acquire();
+            OGLShader shader;
+            shader.Create(code, GL_FRAGMENT_SHADER);
+            OGLProgram program;
+            program.Create(true, std::array{shader.handle});
+            glFinish();
+            VideoCore::CountFrameEvent(system, Core::PerfStats::FrameCounter::ShaderCompiles);
+            std::scoped_lock lock{finished_mutex};
+            finished_shaders.emplace_back(config, std::move(program));
+            has_finished_shaders.store(true, std::memory_order::release);
+        });
+    }
+
+    /**
+     * Moves the fragment shaders completed by the worker thread to the shader cache.
+     * @returns True if any shader was moved
+     */
+    bool InjectFinishedShaders() {
+        // Checked on every draw while the ubershader is bound, so only lock when there is work
+        if (!has_finished_shaders.load(std::memory_order::acquire)) {
+            return false;
+        }
+        std::scoped_lock lock{finished_mutex};
+        for (auto& [config, program] : finished_shaders) {
+            pending_shaders.erase(config);
+            fragment_shaders.Inject(config, std::move(program));
+        }
+        finished_shaders.clear();
+        has_finished_shaders.store(false, std::memory_order::relaxed);
+        return true;
+    }
+
+    Core::System& system;
     bool separable;
     Pica::Shader::Profile profile{};
     ShaderTuple current;
@@ -320,27 +406,52 @@ public:
     ProgrammableVertexShaders programmable_vertex_shaders;
     TrivialVertexShader trivial_vertex_shader;
 
+    ProgrammableGeometryShaders programmable_geometry_shaders;
     FixedGeometryShaders fixed_geometry_shaders;
 
     FragmentShaders fragment_shaders;
     std::unordered_map<u64, OGLProgram> program_cache;
     OGLPipeline pipeline;
     ShaderDiskCache disk_cache;
+
+    OGLProgram ubershader;
+    std::atomic_bool ubershader_ready{};
+    std::optional<FSConfig> ubershader_config;
+    FSConfigData fs_config_data{};
+    std::unordered_set<FSConfig> pending_shaders;
+    std::mutex finished_mutex;
+    std::vector<std::pair<FSConfig, OGLProgram>> finished_shaders;
+    std::atomic_bool has_finished_shaders{};
+    std::unique_ptr<Frontend::GraphicsContext> compile_context;
+    std::unique_ptr<Common::ThreadWorker> compile_worker;
 };
 
-ShaderProgramManager::ShaderProgramManager(Frontend::EmuWindow& emu_window_, const Driver& driver_,
-                                           bool separable)
+ShaderProgramManager::ShaderProgramManager(Core::System& system, Frontend::EmuWindow& emu_window_,
+                                           const Driver& driver_, bool separable)
     : emu_window{emu_window_}, driver{driver_},
-      strict_context_required{emu_window.StrictContextRequired()}, impl{std::make_unique<Impl>(
-                                                                       driver_, separable)} {}
+      strict_context_required{emu_window.StrictContextRequired()},
+      impl{std::make_unique<Impl>(system, driver_, separable)} {
+    // The ubershader hides the compilation in a separate program object, so it requires separable
+    // shaders and a context that can be shared with a worker thread.
+    if (!separable || strict_context_required || !Settings::values.ubershader_fallback.GetValue()) {
+        return;
+    }
+    emu_window.SaveContext();
+    auto context = emu_window.CreateSharedContext();
+    if (context) {
+        context->DoneCurrent();
+    }
+    emu_window.RestoreContext();
+    if (context) {
+        impl->EnableUberShader(std::move(context));
+    }
+}
 
 ShaderProgramManager::~ShaderProgramManager() = default;
 
 bool ShaderProgramManager::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
                                                        Pica::ShaderSetup& setup) {
-    // Enable the geometry-shader only if we are actually doing per-fragment lighting
-    // and care about proper quaternions. Otherwise just use standard vertex+fragment shaders
-    const bool use_geometry_shader = !regs.lighting.disable;
+    const bool use_geometry_shader = UsesGeometryShader(regs);
 
     PicaVSConfig config{regs, setup, driver.HasClipCullDistance(), use_geometry_shader};
     auto [handle, result] = impl->programmable_vertex_shaders.Get(config, setup);
@@ -370,6 +481,18 @@ void ShaderProgramManager::UseTrivialVertexShader() {
     impl->current.vs_hash = 0;
 }
 
+bool ShaderProgramManager::UseProgrammableGeometryShader(const Pica::RegsInternal& regs,
+                                                         Pica::ShaderSetup& setup) {
+    PicaGSConfig config{regs, setup, driver.HasClipCullDistance()};
+    auto [handle, _] = impl->programmable_geometry_shaders.Get(config, setup);
+    if (handle == 0) {
+        return false;
+    }
+    impl->current.gs = handle;
+    impl->current.gs_hash = config.Hash();
+    return true;
+}
+
 void ShaderProgramManager::UseFixedGeometryShader(const Pica::RegsInternal& regs) {
     PicaFixedGSConfig gs_config(regs, driver.HasClipCullDistance());
     auto [handle, _] = impl->fixed_geometry_shaders.Get(gs_config, impl->separable);
@@ -385,9 +508,29 @@ void ShaderProgramManager::UseTrivialGeometryShader() {
 void ShaderProgramManager::UseFragmentShader(const Pica::RegsInternal& regs,
                                              const Pica::Shader::UserConfig& user) {
     const FSConfig fs_config{regs, user, impl->profile};
-    auto [handle, result] = impl->fragment_shaders.Get(fs_config, impl->profile);
-    impl->current.fs = handle;
     impl->current.fs_hash = fs_config.Hash();
+    impl->ubershader_config.reset();
+
+    std::optional<std::string> result{};
+    if (impl->compile_worker) {
+        impl->InjectFinishedShaders();
+    }
+    if (impl->ubershader_ready && !impl->fragment_shaders.Contains(fs_config) &&
+        GLSL::IsUberShaderCompatible(fs_config, impl->profile)) {
+        // Draw with the ubershader until the worker thread finishes the specialized shader.
+        if (!impl->pending_shaders.contains(fs_config)) {
+            result = GLSL::GenerateFragmentShader(fs_config, impl->profile);
+            impl->QueueFragmentShader(fs_config, *result);
+        }
+        impl->current.fs = impl->ubershader.handle;
+        impl->ubershader_config = fs_config;
+        impl->fs_config_data = GLSL::MakeFSConfigData(fs_config);
+    } else {
+        auto [handle, code] = impl->fragment_shaders.Get(fs_config, impl->profile);
+        impl->current.fs = handle;
+        result = std::move(code);
+    }
+
     // Save FS to the disk cache if its a new shader
     if (result) {
         auto& disk_cache = impl->disk_cache;
@@ -398,7 +541,34 @@ void ShaderProgramManager::UseFragmentShader(const Pica::RegsInternal& regs,
     }
 }
 
+std::size_t ShaderProgramManager::NumShaders() const {
+    return impl->programmable_vertex_shaders.Size() + impl->programmable_geometry_shaders.Size() +
+           impl->fixed_geometry_shaders.Size() + impl->fragment_shaders.Size();
+}
+
+std::size_t ShaderProgramManager::NumPrograms() const {
+    return impl->program_cache.size();
+}
+
+bool ShaderProgramManager::IsUberShaderEnabled() const {
+    return impl->compile_worker != nullptr;
+}
+
+const FSConfigData& ShaderProgramManager::FragmentConfigData() const {
+    return impl->fs_config_data;
+}
+
 void ShaderProgramManager::ApplyTo(OpenGLState& state) {
+    // Switch to the specialized fragment shader on the first draw after the worker thread has
+    // finished it, without waiting for the fragment state to change.
+    if (impl->ubershader_config && impl->InjectFinishedShaders()) {
+        if (impl->fragment_shaders.Contains(*impl->ubershader_config)) {
+            std::tie(impl->current.fs, std::ignore) =
+                impl->fragment_shaders.Get(*impl->ubershader_config, impl->profile);
+            impl->ubershader_config.reset();
+        }
+    }
+
     if (impl->separable) {
         if (driver.HasBug(DriverBug::ShaderStageChangeFreeze)) {
             glUseProgramStages(
@@ -417,6 +587,8 @@ void ShaderProgramManager::ApplyTo(OpenGLState& state) {
         if (cached_program.handle == 0) {
             cached_program.Create(false,
                                   std::array{impl->current.vs, impl->current.gs, impl->current.fs});
+            VideoCore::CountFrameEvent(impl->system,
+                                       Core::PerfStats::FrameCounter::PipelineCompiles);
             auto& disk_cache = impl->disk_cache;
             const bool sanitize_mul = Settings::values.shaders_accurate_mul.GetValue();
             disk_cache.SaveDumpToFile(unique_identifier, cached_program.handle, sanitize_mul);
@@ -7,6 +7,10 @@
 #include <memory>
 #include "video_core/rasterizer_interface.h"
 
+namespace Core {
+class System;
+}
+
 namespace Frontend {
 class EmuWindow;
 }
@@ -20,6 +24,10 @@ namespace Pica::Shader {
 union UserConfig;
 }
 
+namespace Pica::Shader::Generator {
+struct FSConfigData;
+}
+
 namespace OpenGL {
 
 class Driver;
@@ -29,12 +37,15 @@ enum UniformBindings {
     VSPicaData = 0,
     VSData = 1,
     FSData = 2,
+    UberShaderConfig = 3,
+    GSPicaData = 4,
 };
 
 /// A class that manage different shader stages and configures them with given config data.
 class ShaderProgramManager {
 public:
-    ShaderProgramManager(Frontend::EmuWindow& emu_window, const Driver& driver, bool separable);
+    ShaderProgramManager(Core::System& system, Frontend::EmuWindow& emu_window,
+                         const Driver& driver, bool separable);
     ~ShaderProgramManager();
 
     void LoadDiskCache(const std::atomic_bool& stop_loading,
@@ -44,12 +55,26 @@ public:
 
     void UseTrivialVertexShader();
 
+    bool UseProgrammableGeometryShader(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup);
+
     void UseFixedGeometryShader(const Pica::RegsInternal& regs);
 
     void UseTrivialGeometryShader();
 
     void UseFragmentShader(const Pica::RegsInternal& config, const Pica::Shader::UserConfig& user);
 
+    /// Returns the number of cached shader stages
+    std::size_t NumShaders() const;
+
+    /// Returns the number of linked programs, always zero with separable shaders
+    std::size_t NumPrograms() const;
+
+    /// Returns true when fragment shaders are compiled in the background behind an ubershader.
+    bool IsUberShaderEnabled() const;
+
+    /// Returns the configuration the ubershader reads while the current shader is compiling.
+    const Pica::Shader::Generator::FSConfigData& FragmentConfigData() const;
+
     void ApplyTo(OpenGLState& state);
 
 private:
@@ -42,26 +42,32 @@ constexpr GLuint ShadowBuffer = 6;
 
 class OpenGLState {
 public:
-    struct {
+    struct Cull {
         bool enabled;      // GL_CULL_FACE
         GLenum mode;       // GL_CULL_FACE_MODE
         GLenum front_face; // GL_FRONT_FACE
+
+        bool operator==(const Cull&) const = default;
     } cull;
 
-    struct {
+    struct Depth {
         bool test_enabled;    // GL_DEPTH_TEST
         GLenum test_func;     // GL_DEPTH_FUNC
         GLboolean write_mask; // GL_DEPTH_WRITEMASK
+
+        bool operator==(const Depth&) const = default;
     } depth;
 
-    struct {
+    struct ColorMask {
         GLboolean red_enabled;
         GLboolean green_enabled;
         GLboolean blue_enabled;
         GLboolean alpha_enabled;
+
+        bool operator==(const ColorMask&) const = default;
     } color_mask; // GL_COLOR_WRITEMASK
 
-    struct {
+    struct Stencil {
         bool test_enabled;          // GL_STENCIL_TEST
         GLenum test_func;           // GL_STENCIL_FUNC
         GLint test_ref;             // GL_STENCIL_REF
@@ -70,9 +76,11 @@ public:
         GLenum action_stencil_fail; // GL_STENCIL_FAIL
         GLenum action_depth_fail;   // GL_STENCIL_PASS_DEPTH_FAIL
         GLenum action_depth_pass;   // GL_STENCIL_PASS_DEPTH_PASS
+
+        bool operator==(const Stencil&) const = default;
     } stencil;
 
-    struct {
+    struct Blend {
         bool enabled;        // GL_BLEND
         GLenum rgb_equation; // GL_BLEND_EQUATION_RGB
         GLenum a_equation;   // GL_BLEND_EQUATION_ALPHA
@@ -81,12 +89,16 @@ public:
         GLenum src_a_func;   // GL_BLEND_SRC_ALPHA
         GLenum dst_a_func;   // GL_BLEND_DST_ALPHA
 
-        struct {
+        struct Color {
             GLclampf red;
             GLclampf green;
             GLclampf blue;
             GLclampf alpha;
+
+            bool operator==(const Color&) const = default;
         } color; // GL_BLEND_COLOR
+
+        bool operator==(const Blend&) const = default;
     } blend;
 
     GLenum logic_op; // GL_LOGIC_OP_MODE
@@ -96,6 +108,8 @@ public:
         GLuint texture_2d; // GL_TEXTURE_BINDING_2D
         GLenum target;     // GL_TEXTURE_TARGET
         GLuint sampler;    // GL_SAMPLER_BINDING
+
+        bool operator==(const TextureUnit&) const = default;
     };
     std::array<TextureUnit, 3> texture_units;
 
@@ -129,7 +143,7 @@ public:
         };
     };
 
-    struct {
+    struct Draw {
         GLuint read_framebuffer; // GL_READ_FRAMEBUFFER_BINDING
         GLuint draw_framebuffer; // GL_DRAW_FRAMEBUFFER_BINDING
         GLuint vertex_array;     // GL_VERTEX_ARRAY_BINDING
@@ -137,21 +151,27 @@ public:
         GLuint uniform_buffer;   // GL_UNIFORM_BUFFER_BINDING
         GLuint shader_program;   // GL_CURRENT_PROGRAM
         GLuint program_pipeline; // GL_PROGRAM_PIPELINE_BINDING
+
+        bool operator==(const Draw&) const = default;
     } draw;
 
-    struct {
+    struct Scissor {
         bool enabled; // GL_SCISSOR_TEST
         GLint x;
         GLint y;
         GLsizei width;
         GLsizei height;
+
+        bool operator==(const Scissor&) const = default;
     } scissor;
 
-    struct {
+    struct Viewport {
         GLint x;
         GLint y;
         GLsizei width;
         GLsizei height;
+
+        bool operator==(const Viewport&) const = default;
     } viewport;
 
     std::array<bool, 2> clip_distance; // GL_CLIP_DISTANCE
@@ -173,7 +193,10 @@ public:
         return blend.a_equation == GL_MIN || blend.a_equation == GL_MAX;
     }
 
-    /// Apply this state as the current OpenGL state
+    /**
+     * Apply this state as the current OpenGL state. Each group of related state is compared
+     * as a whole first, so the groups a caller did not touch cost a single comparison.
+     */
     void Apply() const;
 
     /// Resets any references to the given resource
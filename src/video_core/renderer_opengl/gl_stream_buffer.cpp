@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/microprofile.h"
@@ -10,6 +11,8 @@
 
 MICROPROFILE_DEFINE(OpenGL_StreamBuffer, "OpenGL", "Stream Buffer Orphaning",
                     MP_RGB(128, 128, 192));
+MICROPROFILE_DEFINE(OpenGL_StreamBufferWait, "OpenGL", "Stream Buffer Wait",
+                    MP_RGB(192, 128, 128));
 
 namespace OpenGL {
 
@@ -24,12 +27,17 @@ OGLStreamBuffer::OGLStreamBuffer(Driver& driver, GLenum target, GLsizeiptr size,
         allocate_size *= 2;
     }
 
-    if (GLAD_GL_ARB_buffer_storage) {
+    if (driver.HasArbBufferStorage() || driver.HasExtBufferStorage()) {
         persistent = true;
         coherent = prefer_coherent;
-        GLbitfield flags =
+        region_size = (buffer_size + NUM_REGIONS - 1) / NUM_REGIONS;
+        const GLbitfield flags =
             GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | (coherent ? GL_MAP_COHERENT_BIT : 0);
-        glBufferStorage(gl_target, allocate_size, nullptr, flags);
+        if (driver.HasArbBufferStorage()) {
+            glBufferStorage(gl_target, allocate_size, nullptr, flags);
+        } else {
+            glBufferStorageEXT(gl_target, allocate_size, nullptr, flags);
+        }
         mapped_ptr = static_cast<u8*>(glMapBufferRange(
             gl_target, 0, buffer_size, flags | (coherent ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT)));
     } else {
@@ -42,6 +50,11 @@ OGLStreamBuffer::~OGLStreamBuffer() {
         glBindBuffer(gl_target, gl_buffer.handle);
         glUnmapBuffer(gl_target);
     }
+    for (GLsync& fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
     gl_buffer.Release();
 }
 
@@ -58,6 +71,13 @@ std::tuple<u8*, GLintptr, bool> OGLStreamBuffer::Map(GLsizeiptr size, GLintptr a
     ASSERT(alignment <= buffer_size);
     mapped_size = size;
 
+    if (persistent) {
+        // The commands reading the previous chunks have been issued by now
+        const std::size_t current_region = buffer_pos / region_size;
+        FenceRegions(fenced_region, current_region);
+        fenced_region = current_region;
+    }
+
     if (alignment > 0) {
         buffer_pos = Common::AlignUp<std::size_t>(buffer_pos, alignment);
     }
@@ -68,21 +88,31 @@ std::tuple<u8*, GLintptr, bool> OGLStreamBuffer::Map(GLsizeiptr size, GLintptr a
         invalidate = true;
 
         if (persistent) {
-            glUnmapBuffer(gl_target);
+            // Regions past free_region were not written in this pass and keep their old fences
+            FenceRegions(fenced_region, free_region);
+            fenced_region = 0;
+            free_region = 0;
         }
     }
 
-    if (invalidate || !persistent) {
-        MICROPROFILE_SCOPE(OpenGL_StreamBuffer);
-        GLbitfield flags = GL_MAP_WRITE_BIT | (persistent ? GL_MAP_PERSISTENT_BIT : 0) |
-                           (coherent ? GL_MAP_COHERENT_BIT : GL_MAP_FLUSH_EXPLICIT_BIT) |
-                           (invalidate ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_UNSYNCHRONIZED_BIT);
-        mapped_ptr = static_cast<u8*>(
-            glMapBufferRange(gl_target, buffer_pos, buffer_size - buffer_pos, flags));
-        mapped_offset = buffer_pos;
+    if (persistent) {
+        const std::size_t end_region = (buffer_pos + size + region_size - 1) / region_size;
+        if (end_region > free_region) {
+            WaitRegions(free_region, end_region);
+            free_region = end_region;
+        }
+        return std::make_tuple(mapped_ptr + buffer_pos, buffer_pos, invalidate);
     }
 
-    return std::make_tuple(mapped_ptr + buffer_pos - mapped_offset, buffer_pos, invalidate);
+    MICROPROFILE_SCOPE(OpenGL_StreamBuffer);
+    const GLbitfield flags =
+        GL_MAP_WRITE_BIT | (coherent ? GL_MAP_COHERENT_BIT : GL_MAP_FLUSH_EXPLICIT_BIT) |
+        (invalidate ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_UNSYNCHRONIZED_BIT);
+    mapped_ptr = static_cast<u8*>(
+        glMapBufferRange(gl_target, buffer_pos, buffer_size - buffer_pos, flags));
+    mapped_offset = buffer_pos;
+
+    return std::make_tuple(mapped_ptr, buffer_pos, invalidate);
 }
 
 void OGLStreamBuffer::Unmap(GLsizeiptr size) {
@@ -99,4 +129,28 @@ void OGLStreamBuffer::Unmap(GLsizeiptr size) {
     buffer_pos += size;
 }
 
+void OGLStreamBuffer::FenceRegions(std::size_t begin, std::size_t end) {
+    for (std::size_t region = begin; region < end; region++) {
+        ASSERT(!fences[region]);
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+void OGLStreamBuffer::WaitRegions(std::size_t begin, std::size_t end) {
+    for (std::size_t region = begin; region < end; region++) {
+        GLsync& fence = fences[region];
+        if (!fence) {
+            continue;
+        }
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            MICROPROFILE_SCOPE(OpenGL_StreamBufferWait);
+            const auto start = std::chrono::steady_clock::now();
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            wait_time += std::chrono::steady_clock::now() - start;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
 } // namespace OpenGL
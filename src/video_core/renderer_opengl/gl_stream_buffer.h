@@ -4,14 +4,24 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <tuple>
+#include <utility>
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 
 namespace OpenGL {
 
 class Driver;
 
+/**
+ * Ring buffer used to stream data to the GPU. When buffer storage is available the buffer is
+ * mapped persistently and split in regions, each region is fenced once the commands reading it
+ * were issued and waited on before it gets overwritten. Otherwise the buffer is orphaned when full.
+ */
 class OGLStreamBuffer : private NonCopyable {
+    static constexpr std::size_t NUM_REGIONS = 8;
+
 public:
     explicit OGLStreamBuffer(Driver& driver, GLenum target, GLsizeiptr size,
                              bool prefer_coherent = false);
@@ -32,6 +42,18 @@ public:
 
     void Unmap(GLsizeiptr size);
 
+    /// Returns the time spent waiting on fences since the last call and resets it
+    std::chrono::nanoseconds ConsumeWaitTime() {
+        return std::exchange(wait_time, {});
+    }
+
+private:
+    /// Places fences behind the commands reading the regions [begin, end)
+    void FenceRegions(std::size_t begin, std::size_t end);
+
+    /// Waits until the GPU is done reading the regions [begin, end)
+    void WaitRegions(std::size_t begin, std::size_t end);
+
 private:
     OGLBuffer gl_buffer;
     GLenum gl_target;
@@ -44,6 +66,12 @@ private:
     GLintptr mapped_offset = 0;
     GLsizeiptr mapped_size = 0;
     u8* mapped_ptr = nullptr;
+
+    std::array<GLsync, NUM_REGIONS> fences{};
+    GLsizeiptr region_size = 0;
+    std::size_t fenced_region = 0; ///< First region written in this pass that has no fence yet
+    std::size_t free_region = 0;   ///< First region that may still be read by the GPU
+    std::chrono::nanoseconds wait_time{};
 };
 
 } // namespace OpenGL
@@ -124,6 +124,11 @@ Frontend::Frame* OGLTextureMailbox::TryGetPresentFrame(int timeout_ms) {
     return previous_frame;
 }
 
+bool OGLTextureMailbox::IsPresentPending() {
+    std::scoped_lock lock{swap_chain_lock};
+    return !present_queue.empty();
+}
+
 void OGLTextureMailbox::DebugNotifyNextFrame() {
     if (!has_debug_tool) {
         return;
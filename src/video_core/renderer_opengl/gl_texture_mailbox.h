@@ -48,6 +48,7 @@ public:
 
     Frontend::Frame* GetRenderFrame() override;
     Frontend::Frame* TryGetPresentFrame(int timeout_ms) override;
+    bool IsPresentPending() override;
 
     /// This is virtual as it is to be overriden in OGLVideoDumpingMailbox below.
     virtual void LoadPresentFrame();
@@ -114,7 +114,7 @@ static constexpr std::array<FormatTuple, 8> CUSTOM_TUPLES = {{
 } // Anonymous namespace
 
 TextureRuntime::TextureRuntime(const Driver& driver_, VideoCore::RendererBase& renderer)
-    : driver{driver_}, blit_helper{driver} {
+    : driver{driver_}, gpu_timer{driver, renderer.Profiler()}, blit_helper{driver, gpu_timer} {
     for (std::size_t i = 0; i < draw_fbos.size(); ++i) {
         draw_fbos[i].Create();
         read_fbos[i].Create();
@@ -127,6 +127,10 @@ u32 TextureRuntime::RemoveThreshold() {
     return SWAP_CHAIN_SIZE;
 }
 
+u64 TextureRuntime::MemoryBudget() const {
+    return driver.GetMemoryBudget();
+}
+
 bool TextureRuntime::NeedsConversion(VideoCore::PixelFormat pixel_format) const {
     const bool should_convert = pixel_format == PixelFormat::RGBA8 || // Needs byteswap
                                 pixel_format == PixelFormat::RGB8;    // Is converted to RGBA8
@@ -174,11 +178,7 @@ bool TextureRuntime::Reinterpret(Surface& source, Surface& dest,
     const PixelFormat src_format = source.pixel_format;
     const PixelFormat dst_format = dest.pixel_format;
     ASSERT_MSG(src_format != dst_format, "Reinterpretation with the same format is invalid");
-    if (src_format == PixelFormat::D24S8 && dst_format == PixelFormat::RGBA8) {
-        blit_helper.ConvertDS24S8ToRGBA8(source, dest, copy);
-    } else if (src_format == PixelFormat::RGBA4 && dst_format == PixelFormat::RGB5A1) {
-        blit_helper.ConvertRGBA4ToRGB5A1(source, dest, copy);
-    } else {
+    if (!blit_helper.Reinterpret(source, dest, copy)) {
         LOG_WARNING(Render_OpenGL, "Unimplemented reinterpretation {} -> {}",
                     VideoCore::PixelFormatAsString(src_format),
                     VideoCore::PixelFormatAsString(dst_format));
@@ -218,6 +218,7 @@ bool TextureRuntime::ClearTextureWithoutFbo(Surface& surface,
 }
 
 void TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClear& clear) {
+    const GpuTimer::Scope profile{gpu_timer, "Texture Clear"};
     if (ClearTextureWithoutFbo(surface, clear)) {
         return;
     }
@@ -261,6 +262,7 @@ void TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClea
 
 bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                                   const VideoCore::TextureCopy& copy) {
+    const GpuTimer::Scope profile{gpu_timer, "Texture Copy"};
     const GLenum src_textarget = source.texture_type == VideoCore::TextureType::CubeMap
                                      ? GL_TEXTURE_CUBE_MAP
                                      : GL_TEXTURE_2D;
@@ -275,6 +277,7 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
 
 bool TextureRuntime::BlitTextures(Surface& source, Surface& dest,
                                   const VideoCore::TextureBlit& blit) {
+    const GpuTimer::Scope profile{gpu_timer, "Texture Blit"};
     OpenGLState state = OpenGLState::GetCurState();
     state.scissor.enabled = false;
     state.draw.read_framebuffer = read_fbos[FboIndex(source.type)].handle;
@@ -298,6 +301,7 @@ bool TextureRuntime::BlitTextures(Surface& source, Surface& dest,
 }
 
 void TextureRuntime::GenerateMipmaps(Surface& surface) {
+    const GpuTimer::Scope profile{gpu_timer, "Mipmap Generation"};
     OpenGLState state = OpenGLState::GetCurState();
 
     const auto generate = [&](u32 index) {
@@ -384,6 +388,7 @@ GLuint Surface::CopyHandle() noexcept {
 
 void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
                      const VideoCore::StagingData& staging) {
+    const GpuTimer::Scope profile{runtime->gpu_timer, "Texture Upload"};
     ASSERT(stride * GetFormatBytesPerPixel(pixel_format) % 4 == 0);
 
     const u32 unscaled_width = upload.texture_rect.GetWidth();
@@ -453,6 +458,7 @@ void Surface::UploadCustom(const VideoCore::Material* material, u32 level) {
 
 void Surface::Download(const VideoCore::BufferTextureCopy& download,
                        const VideoCore::StagingData& staging) {
+    const GpuTimer::Scope profile{runtime->gpu_timer, "Texture Download"};
     ASSERT(stride * GetFormatBytesPerPixel(pixel_format) % 4 == 0);
 
     const u32 unscaled_width = download.texture_rect.GetWidth();
@@ -551,6 +557,7 @@ void Surface::Attach(GLenum target, u32 level, u32 layer, bool scaled) {
 }
 
 void Surface::ScaleUp(u32 new_scale) {
+    const GpuTimer::Scope profile{runtime->gpu_timer, "Surface Scale"};
     if (res_scale == new_scale || new_scale == 1) {
         return;
     }
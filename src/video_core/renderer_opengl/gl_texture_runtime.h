@@ -8,6 +8,7 @@
 #include "video_core/rasterizer_cache/rasterizer_cache_base.h"
 #include "video_core/rasterizer_cache/surface_base.h"
 #include "video_core/renderer_opengl/gl_blit_helper.h"
+#include "video_core/renderer_opengl/gl_gpu_timer.h"
 
 namespace VideoCore {
 struct Material;
@@ -42,6 +43,11 @@ public:
     explicit TextureRuntime(const Driver& driver, VideoCore::RendererBase& renderer);
     ~TextureRuntime();
 
+    /// Returns the timer measuring the GPU time of the renderer operations
+    GpuTimer& Timer() {
+        return gpu_timer;
+    }
+
     /// Returns the removal threshold ticks for the garbage collector
     u32 RemoveThreshold();
 
@@ -54,10 +60,39 @@ public:
     /// Maps an internal staging buffer of the provided size of pixel uploads/downloads
     VideoCore::StagingData FindStaging(u32 size, bool upload);
 
+    /// Downloads are synchronous with OpenGL, so there is no readback ring to map from.
+    VideoCore::StagingData FindReadback(u32 size) {
+        return FindStaging(size, false);
+    }
+
+    /// Returns zero as asynchronous downloads are unsupported
+    u64 ReadbackCapacity() const {
+        return 0;
+    }
+
+    /// Returns the video memory in bytes available to surfaces, zero if unknown
+    u64 MemoryBudget() const;
+
+    /// Downloads complete immediately with OpenGL, so there is nothing to wait on.
+    void WaitReadback(u64 tick, const VideoCore::StagingData& staging) {}
+
     /// Returns the OpenGL format tuple associated with the provided pixel format
     const FormatTuple& GetFormatTuple(VideoCore::PixelFormat pixel_format) const;
     const FormatTuple& GetFormatTuple(VideoCore::CustomPixelFormat pixel_format);
 
+    /// Tiled uploads are decoded on the CPU with OpenGL, so this always returns false.
+    bool UploadTiled(Surface& surface, const VideoCore::SurfaceParams& load_info,
+                     std::span<const u8> data, VideoCore::BufferTextureCopy upload) {
+        return false;
+    }
+
+    /// Y2R conversions are done on the CPU with OpenGL, so this always returns false.
+    bool ConvertY2R(Surface& surface, const VideoCore::Y2RConfig& config,
+                    std::span<const std::span<const u8>, 3> planes,
+                    VideoCore::BufferTextureCopy upload) {
+        return false;
+    }
+
     /// Attempts to reinterpret a rectangle of source to another rectangle of dest
     bool Reinterpret(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
 
@@ -84,6 +119,7 @@ private:
 
 private:
     const Driver& driver;
+    GpuTimer gpu_timer;
     BlitHelper blit_helper;
     std::vector<u8> staging_buffer;
     std::array<OGLFramebuffer, 3> draw_fbos;
@@ -123,6 +159,13 @@ public:
     void Download(const VideoCore::BufferTextureCopy& download,
                   const VideoCore::StagingData& staging);
 
+    /// Performs a regular download, OpenGL has no asynchronous readback path.
+    u64 DownloadAsync(const VideoCore::BufferTextureCopy& download,
+                      const VideoCore::StagingData& staging) {
+        Download(download, staging);
+        return 0;
+    }
+
     /// Attaches a handle of surface to the specified framebuffer target
     void Attach(GLenum target, u32 level, u32 layer, bool scaled = true);
 
@@ -19,6 +19,7 @@
 #include "video_core/host_shaders/opengl_present_anaglyph_frag.h"
 #include "video_core/host_shaders/opengl_present_frag.h"
 #include "video_core/host_shaders/opengl_present_interlaced_frag.h"
+#include "video_core/host_shaders/opengl_present_upscale_frag.h"
 #include "video_core/host_shaders/opengl_present_vert.h"
 
 namespace OpenGL {
@@ -96,12 +97,23 @@ void RendererOpenGL::SwapBuffers() {
 
     PrepareRendertarget();
     RenderScreenshot();
+    if (UpdatePerfOverlay()) {
+        UploadPerfOverlay();
+    }
 
-    const auto& main_layout = render_window.GetFramebufferLayout();
-    RenderToMailbox(main_layout, render_window.mailbox, false);
+    // In turbo mode frames are dropped instead of waiting for the presentation thread, so that
+    // frames are only presented as fast as the display shows them.
+    const bool drop_frame =
+        Settings::values.turbo_mode.GetValue() && render_window.mailbox->IsPresentPending();
+    const bool present = !settings.skip_presentation && !drop_frame;
+    if (present) {
+        const auto& main_layout = render_window.GetFramebufferLayout();
+        RenderToMailbox(main_layout, render_window.mailbox, false);
+    }
 
 #ifndef ANDROID
-    if (Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows) {
+    if (present &&
+        Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows) {
         ASSERT(secondary_window);
         const auto& secondary_layout = secondary_window->GetFramebufferLayout();
         RenderToMailbox(secondary_layout, secondary_window->mailbox, false);
@@ -172,6 +184,11 @@ void RendererOpenGL::PrepareRendertarget() {
             texture.format != framebuffer.color_format) {
             ConfigureFramebufferTexture(texture, framebuffer);
         }
+        // With stereoscopy off the framebuffer of the other eye is never shown, so the guest
+        // memory behind it needn't be looked up in the cache or uploaded.
+        if (fb_id == 0 && !IsEyePresented(i)) {
+            continue;
+        }
         LoadFBToScreenInfo(framebuffer, screen_infos[i], i == 1);
     }
 }
@@ -183,6 +200,8 @@ void RendererOpenGL::RenderToMailbox(const Layout::FramebufferLayout& layout,
     Frontend::Frame* frame;
     {
         MICROPROFILE_SCOPE(OpenGL_WaitPresent);
+        Core::PerfStats::ScopedFrameTimer timer{system.perf_stats.get(),
+                                                Core::PerfStats::FrameTimer::PresentWait};
 
         frame = mailbox->GetRenderFrame();
 
@@ -219,6 +238,9 @@ void RendererOpenGL::RenderToMailbox(const Layout::FramebufferLayout& layout,
         state.draw.draw_framebuffer = frame->render.handle;
         state.Apply();
         DrawScreens(layout, flipped);
+        if (&mailbox == &render_window.mailbox && Settings::values.perf_overlay.GetValue()) {
+            DrawPerfOverlay(layout);
+        }
         // Create a fence for the frontend to wait on and swap this frame to OffTex
         frame->render_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
         glFlush();
@@ -227,7 +249,8 @@ void RendererOpenGL::RenderToMailbox(const Layout::FramebufferLayout& layout,
 }
 
 /**
- * Loads framebuffer from emulated memory into the active OpenGL texture.
+ * Points the screen at the cached surface holding the framebuffer, uploading it from emulated
+ * memory when the CPU wrote it.
  */
 void RendererOpenGL::LoadFBToScreenInfo(const Pica::FramebufferConfig& framebuffer,
                                         ScreenInfo& screen_info, bool right_eye) {
@@ -247,11 +270,11 @@ void RendererOpenGL::LoadFBToScreenInfo(const Pica::FramebufferConfig& framebuff
     int bpp = Pica::BytesPerPixel(framebuffer.color_format);
     std::size_t pixel_stride = framebuffer.stride / bpp;
 
-    // OpenGL only supports specifying a stride in units of pixels, not bytes, unfortunately
+    // Cached surfaces only support a stride in units of pixels, not bytes
     ASSERT(pixel_stride * bpp == framebuffer.stride);
 
-    // Ensure no bad interactions with GL_UNPACK_ALIGNMENT, which by default
-    // only allows rows to have a memory alignement of 4.
+    // Ensure no bad interactions with GL_UNPACK_ALIGNMENT when the surface is uploaded, which by
+    // default only allows rows to have a memory alignement of 4.
     ASSERT(pixel_stride % 4 == 0);
 
     if (!rasterizer.AccelerateDisplay(framebuffer, framebuffer_addr, static_cast<u32>(pixel_stride),
@@ -260,29 +283,9 @@ void RendererOpenGL::LoadFBToScreenInfo(const Pica::FramebufferConfig& framebuff
         screen_info.display_texture = screen_info.texture.resource.handle;
         screen_info.display_texcoords = Common::Rectangle<f32>(0.f, 0.f, 1.f, 1.f);
 
-        rasterizer.FlushRegion(framebuffer_addr, framebuffer.stride * framebuffer.height);
-
-        const u8* framebuffer_data = system.Memory().GetPhysicalPointer(framebuffer_addr);
-
-        state.texture_units[0].texture_2d = screen_info.texture.resource.handle;
-        state.Apply();
-
-        glActiveTexture(GL_TEXTURE0);
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint)pixel_stride);
-
-        // Update existing texture
-        // TODO: Test what happens on hardware when you change the framebuffer dimensions so that
-        //       they differ from the LCD resolution.
-        // TODO: Applications could theoretically crash Citra here by specifying too large
-        //       framebuffer sizes. We should make sure that this cannot happen.
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, framebuffer.width, framebuffer.height,
-                        screen_info.texture.gl_format, screen_info.texture.gl_type,
-                        framebuffer_data);
-
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-
-        state.texture_units[0].texture_2d = 0;
-        state.Apply();
+        // The cache uploads every framebuffer it can address through its own path, the rest have
+        // nothing in guest memory to show.
+        FillScreen(Common::Vec3<u8>{}, screen_info.texture);
     }
 }
 
@@ -303,6 +306,24 @@ void RendererOpenGL::FillScreen(Common::Vec3<u8> color, TextureInfo& texture) {
     texture.height = 1;
 }
 
+void RendererOpenGL::UploadPerfOverlay() {
+    auto& screen_info = screen_infos[3];
+    state.texture_units[0].texture_2d = screen_info.texture.resource.handle;
+    state.Apply();
+
+    glActiveTexture(GL_TEXTURE0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, VideoCore::PerfOverlay::Height,
+                 VideoCore::PerfOverlay::Width, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 perf_overlay.Pixels().data());
+
+    state.texture_units[0].texture_2d = 0;
+    state.Apply();
+
+    screen_info.texture.width = VideoCore::PerfOverlay::Height;
+    screen_info.texture.height = VideoCore::PerfOverlay::Width;
+    screen_info.display_texcoords = Common::Rectangle<f32>(0.f, 0.f, 1.f, 1.f);
+}
+
 /**
  * Initializes the OpenGL state and creates persistent objects.
  */
@@ -388,7 +409,11 @@ void RendererOpenGL::ReloadShader() {
         shader_data += HostShaders::OPENGL_PRESENT_INTERLACED_FRAG;
     } else {
         if (Settings::values.pp_shader_name.GetValue() == "none (builtin)") {
-            shader_data += HostShaders::OPENGL_PRESENT_FRAG;
+            if (Settings::values.spatial_upscaling.GetValue() != Settings::SpatialUpscaling::Off) {
+                shader_data += HostShaders::OPENGL_PRESENT_UPSCALE_FRAG;
+            } else {
+                shader_data += HostShaders::OPENGL_PRESENT_FRAG;
+            }
         } else {
             std::string shader_text = OpenGL::GetPostProcessingShaderCode(
                 false, Settings::values.pp_shader_name.GetValue());
@@ -420,6 +445,12 @@ void RendererOpenGL::ReloadShader() {
         else
             glUniform1i(uniform_reverse_interlaced, 0);
     }
+    if (const GLint uniform_sharpness = glGetUniformLocation(shader.handle, "sharpness");
+        uniform_sharpness != -1) {
+        const bool sharp =
+            Settings::values.spatial_upscaling.GetValue() == Settings::SpatialUpscaling::Sharp;
+        glUniform1f(uniform_sharpness, sharp ? 0.5f : 0.f);
+    }
     uniform_i_resolution = glGetUniformLocation(shader.handle, "i_resolution");
     uniform_o_resolution = glGetUniformLocation(shader.handle, "o_resolution");
     uniform_layer = glGetUniformLocation(shader.handle, "layer");
@@ -696,6 +727,34 @@ void RendererOpenGL::DrawScreens(const Layout::FramebufferLayout& layout, bool f
     ResetSecondLayerOpacity();
 }
 
+/**
+ * Draws the performance overlay in the top left corner of the window, on top of the screens.
+ */
+void RendererOpenGL::DrawPerfOverlay(const Layout::FramebufferLayout& layout) {
+    const auto& screen_info = screen_infos[3];
+    if (screen_info.texture.width == 0) {
+        return;
+    }
+    const u32 scale = VideoCore::PerfOverlay::GetScale(layout.height);
+    const float margin = static_cast<float>(4 * scale);
+    const float width = static_cast<float>(VideoCore::PerfOverlay::Width * scale);
+    const float height = static_cast<float>(VideoCore::PerfOverlay::Height * scale);
+
+    glUniform1i(uniform_layer, 0);
+    switch (Settings::values.render_3d.GetValue()) {
+    case Settings::StereoRenderOption::Anaglyph:
+    case Settings::StereoRenderOption::Interlaced:
+    case Settings::StereoRenderOption::ReverseInterlaced:
+        DrawSingleScreenStereo(screen_info, screen_info, margin, margin, width, height,
+                               Layout::DisplayOrientation::Landscape);
+        break;
+    default:
+        DrawSingleScreen(screen_info, margin, margin, width, height,
+                         Layout::DisplayOrientation::Landscape);
+        break;
+    }
+}
+
 void RendererOpenGL::ApplySecondLayerOpacity() {
     if (Settings::values.custom_layout &&
         Settings::values.custom_second_layer_opacity.GetValue() < 100) {
@@ -819,7 +878,8 @@ void RendererOpenGL::DrawBottomScreen(const Layout::FramebufferLayout& layout,
 
 void RendererOpenGL::TryPresent(int timeout_ms, bool is_secondary) {
     const auto& window = is_secondary ? *secondary_window : render_window;
-    const auto& layout = window.GetFramebufferLayout();
+    // The frontend may present on its own thread while the GUI resizes the window
+    const auto layout = window.GetFramebufferLayout();
     auto frame = window.mailbox->TryGetPresentFrame(timeout_ms);
     if (!frame) {
         LOG_DEBUG(Render_OpenGL, "TryGetPresentFrame returned no frame to present");
@@ -856,6 +916,10 @@ void RendererOpenGL::TryPresent(int timeout_ms, bool is_secondary) {
     glFlush();
 
     glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    if (!is_secondary && system.perf_stats) {
+        system.perf_stats->RecordFramePresented();
+    }
 }
 
 void RendererOpenGL::PrepareVideoDumping() {
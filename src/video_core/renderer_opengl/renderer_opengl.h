@@ -71,6 +71,8 @@ private:
                           const Common::Rectangle<u32>& bottom_screen);
     void DrawTopScreen(const Layout::FramebufferLayout& layout,
                        const Common::Rectangle<u32>& top_screen);
+    void UploadPerfOverlay();
+    void DrawPerfOverlay(const Layout::FramebufferLayout& layout);
     void DrawSingleScreen(const ScreenInfo& screen_info, float x, float y, float w, float h,
                           Layout::DisplayOrientation orientation);
     void DrawSingleScreenStereo(const ScreenInfo& screen_info_l, const ScreenInfo& screen_info_r,
@@ -95,8 +97,8 @@ private:
     OGLFramebuffer screenshot_framebuffer;
     std::array<OGLSampler, 2> samplers;
 
-    // Display information for top and bottom screens respectively
-    std::array<ScreenInfo, 3> screen_infos;
+    // Display information for top and bottom screens respectively, then the performance overlay
+    std::array<ScreenInfo, 4> screen_infos{};
 
     // Shader uniform location indices
     GLuint uniform_modelview_matrix;
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include "video_core/renderer_software/sw_lighting.h"
 
 namespace SwRenderer {
@@ -10,21 +11,49 @@ namespace SwRenderer {
 using Pica::f16;
 using Pica::LightingRegs;
 
-static float LookupLightingLut(const Pica::PicaCore::Lighting& lighting, std::size_t lut_index,
-                               u8 index, float delta) {
-    ASSERT_MSG(lut_index < lighting.luts.size(), "Out of range lut");
-    ASSERT_MSG(index < lighting.luts[lut_index].size(), "Out of range index");
+void LightingCache::Update(const LightingRegs& regs, const Pica::PicaCore::Lighting& state) {
+    for (std::size_t i = 0; i < lights.size(); i++) {
+        const auto& light_config = regs.light[i];
+        auto& light = lights[i];
+        light.position = {f16::FromRaw(light_config.x).ToFloat32(),
+                          f16::FromRaw(light_config.y).ToFloat32(),
+                          f16::FromRaw(light_config.z).ToFloat32()};
+        const Common::Vec3<s32> spot_dir{light_config.spot_x.Value(), light_config.spot_y.Value(),
+                                         light_config.spot_z.Value()};
+        light.spot_direction = spot_dir.Cast<float>() / 2047.0f;
+        light.specular_0 = light_config.specular_0.ToVec3f();
+        light.specular_1 = light_config.specular_1.ToVec3f();
+        light.diffuse = light_config.diffuse.ToVec3f();
+        light.ambient = light_config.ambient.ToVec3f();
+        light.dist_atten_scale = Pica::f20::FromRaw(light_config.dist_atten_scale).ToFloat32();
+        light.dist_atten_bias = Pica::f20::FromRaw(light_config.dist_atten_bias).ToFloat32();
+    }
+    global_ambient = regs.global_ambient.ToVec3f();
 
-    const auto& lut = lighting.luts[lut_index][index];
+    static_assert(sizeof(raw_luts) == sizeof(state.luts));
+    if (luts_valid && std::memcmp(raw_luts.data(), state.luts.data(), sizeof(raw_luts)) == 0) {
+        return;
+    }
+    std::memcpy(raw_luts.data(), state.luts.data(), sizeof(raw_luts));
+    for (std::size_t lut = 0; lut < luts.size(); lut++) {
+        for (std::size_t index = 0; index < luts[lut].size(); index++) {
+            const auto& entry = state.luts[lut][index];
+            luts[lut][index] = {entry.ToFloat(), entry.DiffToFloat()};
+        }
+    }
+    luts_valid = true;
+}
 
-    const float lut_value = lut.ToFloat();
-    const float lut_diff = lut.DiffToFloat();
+static float LookupLightingLut(const LightingCache& cache, std::size_t lut_index, u8 index,
+                               float delta) {
+    ASSERT_MSG(lut_index < cache.luts.size(), "Out of range lut");
 
-    return lut_value + lut_diff * delta;
+    const auto& lut = cache.luts[lut_index][index];
+    return lut.x + lut.y * delta;
 }
 
 std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::PicaCore::Lighting& lighting_state,
+    const Pica::LightingRegs& lighting, const LightingCache& cache,
     const Common::Quaternion<f32>& normquat, const Common::Vec3f& view,
     std::span<const Common::Vec4<u8>, 4> texture_color) {
 
@@ -74,10 +103,8 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
     for (u32 light_index = 0; light_index <= lighting.max_light_index; ++light_index) {
         u32 num = lighting.light_enable.GetNum(light_index);
         const auto& light_config = lighting.light[num];
-
-        const Common::Vec3f position = {f16::FromRaw(light_config.x).ToFloat32(),
-                                        f16::FromRaw(light_config.y).ToFloat32(),
-                                        f16::FromRaw(light_config.z).ToFloat32()};
+        const auto& light = cache.lights[num];
+        const Common::Vec3f& position = light.position;
         Common::Vec3f refl_value{};
         Common::Vec3f light_vector{};
 
@@ -94,8 +121,8 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
 
         f32 dist_atten = 1.0f;
         if (!lighting.IsDistAttenDisabled(num)) {
-            const f32 scale = Pica::f20::FromRaw(light_config.dist_atten_scale).ToFloat32();
-            const f32 bias = Pica::f20::FromRaw(light_config.dist_atten_bias).ToFloat32();
+            const f32 scale = light.dist_atten_scale;
+            const f32 bias = light.dist_atten_bias;
             const std::size_t lut =
                 static_cast<std::size_t>(LightingRegs::LightingSampler::DistanceAttenuation) + num;
 
@@ -105,7 +132,7 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
                 static_cast<u8>(std::clamp(std::floor(sample_loc * 256.0f), 0.0f, 255.0f));
             const f32 delta = sample_loc * 256 - lutindex;
 
-            dist_atten = LookupLightingLut(lighting_state, lut, lutindex, delta);
+            dist_atten = LookupLightingLut(cache, lut, lutindex, delta);
         }
 
         auto get_lut_value = [&](LightingRegs::LightingLutInput input, bool abs,
@@ -126,12 +153,9 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
             case LightingRegs::LightingLutInput::LN:
                 result = Common::Dot(light_vector, normal);
                 break;
-            case LightingRegs::LightingLutInput::SP: {
-                Common::Vec3<s32> spot_dir{light_config.spot_x.Value(), light_config.spot_y.Value(),
-                                           light_config.spot_z.Value()};
-                result = Common::Dot(light_vector, spot_dir.Cast<float>() / 2047.0f);
+            case LightingRegs::LightingLutInput::SP:
+                result = Common::Dot(light_vector, light.spot_direction);
                 break;
-            }
             case LightingRegs::LightingLutInput::CP:
                 if (lighting.config0.config == LightingRegs::LightingConfig::Config7) {
                     const Common::Vec3f norm_half_vector = half_vector.Normalized();
@@ -169,8 +193,8 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
             }
 
             const f32 scale = lighting.lut_scale.GetScale(scale_enum);
-            return scale * LookupLightingLut(lighting_state, static_cast<std::size_t>(sampler),
-                                             index, delta);
+            return scale *
+                   LookupLightingLut(cache, static_cast<std::size_t>(sampler), index, delta);
         };
 
         // If enabled, compute spot light attenuation value
@@ -194,7 +218,7 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
                               lighting.lut_scale.d0, LightingRegs::LightingSampler::Distribution0);
         }
 
-        Common::Vec3f specular_0 = d0_lut_value * light_config.specular_0.ToVec3f();
+        Common::Vec3f specular_0 = d0_lut_value * light.specular_0;
 
         // If enabled, lookup ReflectRed value, otherwise, 1.0 is used
         if (lighting.config1.disable_lut_rr == 0 &&
@@ -239,7 +263,7 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
                               lighting.lut_scale.d1, LightingRegs::LightingSampler::Distribution1);
         }
 
-        Common::Vec3f specular_1 = d1_lut_value * refl_value * light_config.specular_1.ToVec3f();
+        Common::Vec3f specular_1 = d1_lut_value * refl_value * light.specular_1;
 
         // Fresnel
         // Note: only the last entry in the light slots applies the Fresnel factor
@@ -285,9 +309,7 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
             }
         }
 
-        auto diffuse =
-            (light_config.diffuse.ToVec3f() * dot_product + light_config.ambient.ToVec3f()) *
-            dist_atten * spot_atten;
+        auto diffuse = (light.diffuse * dot_product + light.ambient) * dist_atten * spot_atten;
         auto specular = (specular_0 + specular_1) * clamp_highlights * dist_atten * spot_atten;
 
         if (!lighting.IsShadowDisabled(num)) {
@@ -316,7 +338,7 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
         }
     }
 
-    diffuse_sum += Common::MakeVec(lighting.global_ambient.ToVec3f(), 0.0f);
+    diffuse_sum += Common::MakeVec(cache.global_ambient, 0.0f);
 
     const auto diffuse = Common::MakeVec(std::clamp(diffuse_sum.x, 0.0f, 1.0f) * 255,
                                          std::clamp(diffuse_sum.y, 0.0f, 1.0f) * 255,
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <span>
 #include <utility>
 
@@ -13,8 +14,34 @@
 
 namespace SwRenderer {
 
+/**
+ * Lighting state of the current draw decoded to floats. The light constants are decoded on
+ * every update, the LUTs only when their guest data has changed.
+ */
+struct LightingCache {
+    struct Light {
+        Common::Vec3f position;
+        Common::Vec3f spot_direction;
+        Common::Vec3f specular_0;
+        Common::Vec3f specular_1;
+        Common::Vec3f diffuse;
+        Common::Vec3f ambient;
+        f32 dist_atten_scale;
+        f32 dist_atten_bias;
+    };
+
+    /// Decodes the lighting configuration of the current draw.
+    void Update(const Pica::LightingRegs& regs, const Pica::PicaCore::Lighting& state);
+
+    std::array<Light, 8> lights;
+    Common::Vec3f global_ambient;
+    std::array<std::array<Common::Vec2f, 256>, 24> luts; ///< LUT value and difference
+    std::array<std::array<u32, 256>, 24> raw_luts;       ///< Guest data luts was decoded from
+    bool luts_valid = false;
+};
+
 std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::PicaCore::Lighting& lighting_state,
+    const Pica::LightingRegs& lighting, const LightingCache& cache,
     const Common::Quaternion<f32>& normquat, const Common::Vec3f& view,
     std::span<const Common::Vec4<u8>, 4> texture_color);
 
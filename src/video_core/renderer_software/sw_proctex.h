@@ -4,14 +4,36 @@
 
 #pragma once
 
+#include <array>
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/pica/pica_core.h"
 
 namespace SwRenderer {
 
+/**
+ * Procedural texture state of the current draw decoded to floats. The tables are only decoded
+ * again when their guest data has changed.
+ */
+struct ProcTexCache {
+    /// Decodes the procedural texture configuration of the current draw.
+    void Update(const Pica::TexturingRegs& regs, const Pica::PicaCore::ProcTex& state);
+
+    Common::Vec2f noise_frequency;
+    Common::Vec2f noise_phase;
+    // Value and difference of each entry
+    std::array<Common::Vec2f, 128> noise_table;
+    std::array<Common::Vec2f, 128> color_map_table;
+    std::array<Common::Vec2f, 128> alpha_map_table;
+    std::array<Common::Vec4<u8>, 256> color_table;
+    std::array<Common::Vec4f, 256> color_value_table;
+    std::array<Common::Vec4f, 256> color_diff_table;
+    Pica::PicaCore::ProcTex raw_tables; ///< Guest data the tables were decoded from
+    bool tables_valid = false;
+};
+
 /// Generates procedural texture color for the given coordinates
 Common::Vec4<u8> ProcTex(float u, float v, const Pica::TexturingRegs& regs,
-                         const Pica::PicaCore::ProcTex& state);
+                         const ProcTexCache& cache);
 
 } // namespace SwRenderer
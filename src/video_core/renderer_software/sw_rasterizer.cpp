@@ -2,7 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <bit>
+#include <limits>
 #include <boost/container/static_vector.hpp>
+#include "common/alignment.h"
+#include "common/arch.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/quaternion.h"
@@ -17,6 +21,12 @@
 #include "video_core/renderer_software/sw_texturing.h"
 #include "video_core/texture/texture_decode.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace SwRenderer {
 
 using Pica::f24;
@@ -69,6 +79,16 @@ struct Vertex : Pica::OutputVertex {
 namespace {
 
 MICROPROFILE_DEFINE(GPU_Rasterization, "GPU", "Rasterization", MP_RGB(50, 50, 240));
+MICROPROFILE_DEFINE(GPU_RasterizeBins, "GPU", "Rasterize Bins", MP_RGB(80, 80, 240));
+
+/// Number of triangles buffered before the batch is rasterized.
+constexpr std::size_t MaxBatchTriangles = 4096;
+
+/// Number of horizontal bins per worker thread, to balance uneven triangle distribution.
+constexpr u32 BinsPerThread = 4;
+
+/// Bin boundaries are aligned to 8 pixel rows, in 12.4 fixed point.
+constexpr u32 BinAlignment = 8 << 4;
 
 struct ClippingEdge {
 public:
@@ -77,11 +97,11 @@ public:
                                                                       f24::Zero(), f24::Zero()))
         : pos(f24::Zero()), coeffs(coeffs), bias(bias) {}
 
-    bool IsInside(const Vertex& vertex) const {
+    bool IsInside(const Pica::OutputVertex& vertex) const {
         return Common::Dot(vertex.pos + bias, coeffs) >= f24::FromFloat32(-EPSILON_Z);
     }
 
-    bool IsOutSide(const Vertex& vertex) const {
+    bool IsOutSide(const Pica::OutputVertex& vertex) const {
         return !IsInside(vertex);
     }
 
@@ -98,12 +118,187 @@ private:
     Common::Vec4<f24> bias;
 };
 
+// NOTE: We clip against a w=epsilon plane to guarantee that the output has a positive w value.
+// TODO: Not sure if this is a valid approach.
+constexpr f24 EPSILON = f24::MinNormal();
+constexpr f24 f0 = f24::Zero();
+constexpr f24 f1 = f24::One();
+constexpr std::array<ClippingEdge, 7> clipping_edges = {{
+    {Common::MakeVec(-f1, f0, f0, f1)},                                        // x = +w
+    {Common::MakeVec(f1, f0, f0, f1)},                                         // x = -w
+    {Common::MakeVec(f0, -f1, f0, f1)},                                        // y = +w
+    {Common::MakeVec(f0, f1, f0, f1)},                                         // y = -w
+    {Common::MakeVec(f0, f0, -f1, f0)},                                        // z =  0
+    {Common::MakeVec(f0, f0, f1, f1)},                                         // z = -w
+    {Common::MakeVec(f0, f0, f0, f1), Common::Vec4<f24>(f0, f0, f0, EPSILON)}, // w = EPSILON
+}};
+
+/// Bit of the clip codes set when the vertex is outside the user clip plane, tested last.
+constexpr u32 CustomEdgeBit = 1U << clipping_edges.size();
+
+/// Vertices whose clip codes are computed at once, a whole number of triangles and vector lanes.
+constexpr std::size_t ClipBatchVertices = 12;
+
+/**
+ * Computes the clip codes of up to ClipBatchVertices vertices, bit i being set when the vertex
+ * is outside clipping_edges[i]. The coefficients of the edges are all 0 or 1 in magnitude, so
+ * the dot products of ClippingEdge::IsInside reduce to the sums below, rounded the same. A NaN
+ * coordinate makes all of them NaN, so such vertices are outside every edge.
+ */
+void ComputeClipCodes(std::span<const Pica::OutputVertex> vertices, std::span<u32> codes) {
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+    // Vertices past the end are padded with an inside position
+    alignas(16) std::array<float, ClipBatchVertices> x{};
+    alignas(16) std::array<float, ClipBatchVertices> y{};
+    alignas(16) std::array<float, ClipBatchVertices> z{};
+    alignas(16) std::array<float, ClipBatchVertices> w;
+    w.fill(1.0f);
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        x[i] = vertices[i].pos.x.ToFloat32();
+        y[i] = vertices[i].pos.y.ToFloat32();
+        z[i] = vertices[i].pos.z.ToFloat32();
+        w[i] = vertices[i].pos.w.ToFloat32();
+    }
+
+    for (std::size_t i = 0; i < vertices.size(); i += 4) {
+        // Each mask has bit n set when vertex i + n is inside the edge
+        std::array<u32, clipping_edges.size()> inside;
+#if CITRA_ARCH(x86_64)
+        const __m128 vx = _mm_load_ps(&x[i]);
+        const __m128 vy = _mm_load_ps(&y[i]);
+        const __m128 vz = _mm_load_ps(&z[i]);
+        const __m128 vw = _mm_load_ps(&w[i]);
+        const __m128 min_distance = _mm_set1_ps(-EPSILON_Z);
+        const __m128 ordered = _mm_and_ps(_mm_cmpord_ps(vx, vy), _mm_cmpord_ps(vz, vw));
+        const auto mask = [&](__m128 distance) {
+            return static_cast<u32>(
+                _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(distance, min_distance), ordered)));
+        };
+        inside = {
+            mask(_mm_sub_ps(vw, vx)),
+            mask(_mm_add_ps(vx, vw)),
+            mask(_mm_sub_ps(vw, vy)),
+            mask(_mm_add_ps(vy, vw)),
+            mask(_mm_xor_ps(vz, _mm_set1_ps(-0.0f))),
+            mask(_mm_add_ps(vz, vw)),
+            mask(_mm_add_ps(vw, _mm_set1_ps(EPSILON.ToFloat32()))),
+        };
+#else
+        const float32x4_t vx = vld1q_f32(&x[i]);
+        const float32x4_t vy = vld1q_f32(&y[i]);
+        const float32x4_t vz = vld1q_f32(&z[i]);
+        const float32x4_t vw = vld1q_f32(&w[i]);
+        const float32x4_t min_distance = vdupq_n_f32(-EPSILON_Z);
+        const uint32x4_t ordered = vandq_u32(vandq_u32(vceqq_f32(vx, vx), vceqq_f32(vy, vy)),
+                                             vandq_u32(vceqq_f32(vz, vz), vceqq_f32(vw, vw)));
+        static constexpr std::array<u32, 4> lane_bits = {1, 2, 4, 8};
+        const uint32x4_t bits = vld1q_u32(lane_bits.data());
+        const auto mask = [&](float32x4_t distance) {
+            return vaddvq_u32(
+                vandq_u32(vandq_u32(vcgeq_f32(distance, min_distance), ordered), bits));
+        };
+        inside = {
+            mask(vsubq_f32(vw, vx)),
+            mask(vaddq_f32(vx, vw)),
+            mask(vsubq_f32(vw, vy)),
+            mask(vaddq_f32(vy, vw)),
+            mask(vnegq_f32(vz)),
+            mask(vaddq_f32(vz, vw)),
+            mask(vaddq_f32(vw, vdupq_n_f32(EPSILON.ToFloat32()))),
+        };
+#endif
+        const std::size_t num_lanes = std::min<std::size_t>(4, vertices.size() - i);
+        for (std::size_t lane = 0; lane < num_lanes; lane++) {
+            u32 code = 0;
+            for (std::size_t edge = 0; edge < inside.size(); edge++) {
+                code |= ((~inside[edge] >> lane) & 1) << edge;
+            }
+            codes[i + lane] = code;
+        }
+    }
+#else
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        u32 code = 0;
+        for (std::size_t edge = 0; edge < clipping_edges.size(); edge++) {
+            code |= static_cast<u32>(clipping_edges[edge].IsOutSide(vertices[i])) << edge;
+        }
+        codes[i] = code;
+    }
+#endif
+}
+
 } // Anonymous namespace
 
+/// A culled and clipped triangle waiting to be rasterized, with its setup precomputed.
+struct RasterizerSoftware::Triangle {
+    Vertex v0;
+    Vertex v1;
+    Vertex v2;
+    std::array<Common::Vec3<Fix12P4>, 3> vtxpos;
+    u16 min_x;
+    u16 min_y;
+    u16 max_x;
+    u16 max_y;
+    int bias0;
+    int bias1;
+    int bias2;
+};
+
 RasterizerSoftware::RasterizerSoftware(Memory::MemorySystem& memory_, Pica::PicaCore& pica_)
     : memory{memory_}, pica{pica_}, regs{pica.regs.internal},
-      num_sw_threads{std::max(std::thread::hardware_concurrency(), 2U)},
-      sw_workers{num_sw_threads, "SwRenderer workers"}, fb{memory, regs.framebuffer} {}
+      sw_workers{Common::TaskPriority::FrameCritical}, num_sw_threads{sw_workers.NumWorkers()},
+      fb{memory, regs.framebuffer},
+      texture_cache{memory} {
+    triangles.reserve(MaxBatchTriangles);
+}
+
+RasterizerSoftware::~RasterizerSoftware() = default;
+
+void RasterizerSoftware::AddTriangles(std::span<const Pica::OutputVertex> vertices) {
+    const bool clip_enable = regs.rasterizer.clip_enable;
+    const ClippingEdge custom_edge{regs.rasterizer.GetClipCoef()};
+    const std::size_t num_vertices = vertices.size() - vertices.size() % 3;
+    std::array<u32, ClipBatchVertices> codes;
+    for (std::size_t first = 0; first < num_vertices; first += ClipBatchVertices) {
+        const auto batch =
+            vertices.subspan(first, std::min(ClipBatchVertices, num_vertices - first));
+        ComputeClipCodes(batch, codes);
+        for (std::size_t i = 0; i < batch.size(); i += 3) {
+            u32 any_outside = 0;
+            u32 all_outside = ~0U;
+            for (std::size_t j = i; j < i + 3; j++) {
+                u32 code = codes[j];
+                if (clip_enable && custom_edge.IsOutSide(batch[j])) {
+                    code |= CustomEdgeBit;
+                }
+                any_outside |= code;
+                all_outside &= code;
+            }
+            if (any_outside == 0) {
+                AddUnclippedTriangle(batch[i], batch[i + 1], batch[i + 2]);
+                continue;
+            }
+            // Clipping against the edges before the first one a vertex is outside of leaves the
+            // triangle as it is, so it is dropped whole when all the vertices are outside that one.
+            if ((all_outside >> std::countr_zero(any_outside)) & 1) {
+                continue;
+            }
+            AddTriangle(batch[i], batch[i + 1], batch[i + 2]);
+        }
+    }
+}
+
+void RasterizerSoftware::AddUnclippedTriangle(const Pica::OutputVertex& v0,
+                                              const Pica::OutputVertex& v1,
+                                              const Pica::OutputVertex& v2) {
+    std::array<Vertex, 3> vertices = {v0, v1, v2};
+    FlipQuaternionIfOpposite(vertices[1].quat, vertices[0].quat);
+    FlipQuaternionIfOpposite(vertices[2].quat, vertices[0].quat);
+    for (Vertex& vertex : vertices) {
+        MakeScreenCoords(vertex);
+    }
+    ProcessTriangle(vertices[0], vertices[1], vertices[2]);
+}
 
 void RasterizerSoftware::AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
                                      const Pica::OutputVertex& v2) {
@@ -124,21 +319,6 @@ void RasterizerSoftware::AddTriangle(const Pica::OutputVertex& v0, const Pica::O
     auto* output_list = &buffer_a;
     auto* input_list = &buffer_b;
 
-    // NOTE: We clip against a w=epsilon plane to guarantee that the output has a positive w value.
-    // TODO: Not sure if this is a valid approach.
-    static constexpr f24 EPSILON = f24::MinNormal();
-    static constexpr f24 f0 = f24::Zero();
-    static constexpr f24 f1 = f24::One();
-    static constexpr std::array<ClippingEdge, 7> clipping_edges = {{
-        {Common::MakeVec(-f1, f0, f0, f1)},                                        // x = +w
-        {Common::MakeVec(f1, f0, f0, f1)},                                         // x = -w
-        {Common::MakeVec(f0, -f1, f0, f1)},                                        // y = +w
-        {Common::MakeVec(f0, f1, f0, f1)},                                         // y = -w
-        {Common::MakeVec(f0, f0, -f1, f0)},                                        // z =  0
-        {Common::MakeVec(f0, f0, f1, f1)},                                         // z = -w
-        {Common::MakeVec(f0, f0, f0, f1), Common::Vec4<f24>(f0, f0, f0, EPSILON)}, // w = EPSILON
-    }};
-
     // Simple implementation of the Sutherland-Hodgman clipping algorithm.
     // TODO: Make this less inefficient (currently lots of useless buffering overhead happens here)
     const auto clip = [&](const ClippingEdge& edge) {
@@ -204,6 +384,10 @@ void RasterizerSoftware::AddTriangle(const Pica::OutputVertex& v0, const Pica::O
     }
 }
 
+void RasterizerSoftware::DrawTriangles() {
+    FlushTriangles();
+}
+
 void RasterizerSoftware::MakeScreenCoords(Vertex& vtx) {
     Viewport viewport{};
     viewport.halfsize_x = f24::FromRaw(regs.rasterizer.viewport_size_x);
@@ -285,189 +469,297 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
     max_x = ((max_x + Fix12P4::FracMask()) & Fix12P4::IntMask());
     max_y = ((max_y + Fix12P4::FracMask()) & Fix12P4::IntMask());
 
-    const int bias0 =
+    Triangle& triangle = triangles.emplace_back(Triangle{v0, v1, v2});
+    triangle.vtxpos = vtxpos;
+    triangle.min_x = min_x;
+    triangle.min_y = min_y;
+    triangle.max_x = max_x;
+    triangle.max_y = max_y;
+    triangle.bias0 =
         IsRightSideOrFlatBottomEdge(vtxpos[0].xy(), vtxpos[1].xy(), vtxpos[2].xy()) ? -1 : 0;
-    const int bias1 =
+    triangle.bias1 =
         IsRightSideOrFlatBottomEdge(vtxpos[1].xy(), vtxpos[2].xy(), vtxpos[0].xy()) ? -1 : 0;
-    const int bias2 =
+    triangle.bias2 =
         IsRightSideOrFlatBottomEdge(vtxpos[2].xy(), vtxpos[0].xy(), vtxpos[1].xy()) ? -1 : 0;
 
-    const auto w_inverse = Common::MakeVec(v0.pos.w, v1.pos.w, v2.pos.w);
+    if (triangles.size() >= MaxBatchTriangles) {
+        FlushTriangles();
+    }
+}
 
-    const auto textures = regs.texturing.GetTextures();
-    const auto tev_stages = regs.texturing.GetTevStages();
+void RasterizerSoftware::FlushTriangles() {
+    if (triangles.empty()) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(GPU_RasterizeBins);
+
+    u16 batch_min_y = std::numeric_limits<u16>::max();
+    u16 batch_max_y = 0;
+    for (const Triangle& triangle : triangles) {
+        batch_min_y = std::min(batch_min_y, triangle.min_y);
+        batch_max_y = std::max(batch_max_y, triangle.max_y);
+    }
 
     fb.Bind();
+    BuildTevProgram();
+    texture_cache.Prepare(regs.texturing, sw_workers);
+    if (!regs.lighting.disable) {
+        lighting_cache.Update(regs.lighting, pica.lighting);
+    }
+    if (regs.texturing.main_config.texture3_enable) {
+        proctex_cache.Update(regs.texturing, pica.proctex);
+    }
 
-    // Enter rasterization loop, starting at the center of the topleft bounding box corner.
-    // TODO: Not sure if looping through x first might be faster
+    // Split the covered rows into horizontal bins aligned to the 8x8 framebuffer tiles. Each
+    // worker owns a bin exclusively for the whole batch, so framebuffer accesses never overlap
+    // and triangles within a bin are still rasterized in submission order.
+    const u32 num_bins = static_cast<u32>(num_sw_threads) * BinsPerThread;
+    const u32 first_row = Common::AlignDown<u32>(batch_min_y, BinAlignment);
+    const u32 bin_height = std::max<u32>(
+        Common::AlignUp((batch_max_y - first_row + num_bins - 1) / num_bins, BinAlignment),
+        BinAlignment);
+    for (u32 bin_begin = first_row; bin_begin < batch_max_y; bin_begin += bin_height) {
+        const u16 begin = static_cast<u16>(bin_begin);
+        const u16 end = static_cast<u16>(std::min<u32>(bin_begin + bin_height, batch_max_y));
+        sw_workers.QueueWork([this, begin, end] {
+            for (const Triangle& triangle : triangles) {
+                if (triangle.max_y > begin && triangle.min_y < end) {
+                    RasterizeTriangle(triangle, begin, end);
+                }
+            }
+        });
+    }
+    sw_workers.WaitForRequests();
+    triangles.clear();
+}
+
+void RasterizerSoftware::RasterizeTriangle(const Triangle& triangle, u16 bin_begin, u16 bin_end) {
+    const Vertex& v0 = triangle.v0;
+    const Vertex& v1 = triangle.v1;
+    const Vertex& v2 = triangle.v2;
+    const auto& vtxpos = triangle.vtxpos;
+    const u16 min_x = triangle.min_x;
+    const u16 max_x = triangle.max_x;
+    const int bias0 = triangle.bias0;
+    const int bias1 = triangle.bias1;
+    const int bias2 = triangle.bias2;
+
+    // Convert the scissor box coordinates to 12.4 fixed point
+    const u16 scissor_x1 = static_cast<u16>(regs.rasterizer.scissor_test.x1 << 4);
+    const u16 scissor_y1 = static_cast<u16>(regs.rasterizer.scissor_test.y1 << 4);
+    // x2,y2 have +1 added to cover the entire sub-pixel area
+    const u16 scissor_x2 = static_cast<u16>((regs.rasterizer.scissor_test.x2 + 1) << 4);
+    const u16 scissor_y2 = static_cast<u16>((regs.rasterizer.scissor_test.y2 + 1) << 4);
+
+    const auto w_inverse = Common::MakeVec(v0.pos.w, v1.pos.w, v2.pos.w);
+
+    const auto textures = regs.texturing.GetTextures();
+    const bool scissor_exclude =
+        regs.rasterizer.scissor_test.mode == RasterizerRegs::ScissorMode::Exclude;
+    const float depth_scale = f24::FromRaw(regs.rasterizer.viewport_depth_range).ToFloat32();
+    const float depth_offset = f24::FromRaw(regs.rasterizer.viewport_depth_near_plane).ToFloat32();
+    const bool w_buffering =
+        regs.rasterizer.depthmap_enable == Pica::RasterizerRegs::DepthBuffering::WBuffering;
+
+    // The edge functions SignedArea(a, b, p) are linear in p, so along a row they change by a
+    // constant step per pixel. This lets the covered span of each row be solved for directly
+    // instead of testing every pixel of the bounding box.
+    struct Edge {
+        s32 dx;
+        s32 dy;
+        s32 ax;
+        s32 ay;
+        s32 bias;
+
+        s32 Evaluate(s32 x, s32 y) const {
+            return bias + dx * (y - ay) - dy * (x - ax);
+        }
+    };
+    const auto make_edge = [&](u32 a, u32 b, s32 bias) {
+        const s32 ax = vtxpos[a].x, ay = vtxpos[a].y;
+        return Edge{vtxpos[b].x - ax, vtxpos[b].y - ay, ax, ay, bias};
+    };
+    const std::array<Edge, 3> edges = {
+        make_edge(1, 2, bias0),
+        make_edge(2, 0, bias1),
+        make_edge(0, 1, bias2),
+    };
+    const s32 num_columns = (max_x - min_x) >> 4;
+
+    // Enter rasterization loop, starting at the center of the topleft bounding box corner
+    // that falls within this bin.
+    const u16 min_y = std::max(triangle.min_y, bin_begin);
+    const u16 max_y = std::min(triangle.max_y, bin_end);
     for (u16 y = min_y + 8; y < max_y; y += 0x10) {
-        const auto process_scanline = [&, y] {
-            for (u16 x = min_x + 8; x < max_x; x += 0x10) {
-                // Do not process the pixel if it's inside the scissor box and the scissor mode is
-                // set to Exclude.
-                if (regs.rasterizer.scissor_test.mode == RasterizerRegs::ScissorMode::Exclude) {
-                    if (x >= scissor_x1 && x < scissor_x2 && y >= scissor_y1 && y < scissor_y2) {
-                        continue;
-                    }
+        const u16 start_x = min_x + 8;
+        std::array<s32, 3> row_start;
+        std::array<s32, 3> step;
+        s32 begin = 0;
+        s32 end = num_columns;
+        for (u32 i = 0; i < 3; i++) {
+            row_start[i] = edges[i].Evaluate(start_x, y);
+            step[i] = -edges[i].dy * 0x10;
+            if (step[i] > 0) {
+                if (row_start[i] < 0) {
+                    begin = std::max(begin, (-row_start[i] + step[i] - 1) / step[i]);
                 }
+            } else if (row_start[i] < 0) {
+                end = 0;
+            } else if (step[i] < 0) {
+                end = std::min(end, row_start[i] / -step[i] + 1);
+            }
+        }
 
-                // Calculate the barycentric coordinates w0, w1 and w2
-                const s32 w0 = bias0 + SignedArea(vtxpos[1].xy(), vtxpos[2].xy(), {x, y});
-                const s32 w1 = bias1 + SignedArea(vtxpos[2].xy(), vtxpos[0].xy(), {x, y});
-                const s32 w2 = bias2 + SignedArea(vtxpos[0].xy(), vtxpos[1].xy(), {x, y});
-                const s32 wsum = w0 + w1 + w2;
+        for (s32 column = begin; column < end; column++) {
+            const u16 x = static_cast<u16>(start_x + (column << 4));
 
-                // If current pixel is not covered by the current primitive
-                if (w0 < 0 || w1 < 0 || w2 < 0) {
+            // Do not process the pixel if it's inside the scissor box and the scissor mode is
+            // set to Exclude.
+            if (scissor_exclude) {
+                if (x >= scissor_x1 && x < scissor_x2 && y >= scissor_y1 && y < scissor_y2) {
                     continue;
                 }
+            }
 
-                const auto baricentric_coordinates = Common::MakeVec(
-                    f24::FromFloat32(static_cast<f32>(w0)), f24::FromFloat32(static_cast<f32>(w1)),
-                    f24::FromFloat32(static_cast<f32>(w2)));
-                const f24 interpolated_w_inverse =
-                    f24::One() / Common::Dot(w_inverse, baricentric_coordinates);
-
-                // interpolated_z = z / w
-                const float interpolated_z_over_w =
-                    (v0.screenpos[2].ToFloat32() * w0 + v1.screenpos[2].ToFloat32() * w1 +
-                     v2.screenpos[2].ToFloat32() * w2) /
-                    wsum;
-
-                // Not fully accurate. About 3 bits in precision are missing.
-                // Z-Buffer (z / w * scale + offset)
-                const float depth_scale =
-                    f24::FromRaw(regs.rasterizer.viewport_depth_range).ToFloat32();
-                const float depth_offset =
-                    f24::FromRaw(regs.rasterizer.viewport_depth_near_plane).ToFloat32();
-                float depth = interpolated_z_over_w * depth_scale + depth_offset;
-
-                // Potentially switch to W-Buffer
-                if (regs.rasterizer.depthmap_enable ==
-                    Pica::RasterizerRegs::DepthBuffering::WBuffering) {
-                    // W-Buffer (z * scale + w * offset = (z / w * scale + offset) * w)
-                    depth *= interpolated_w_inverse.ToFloat32() * wsum;
-                }
+            // Calculate the barycentric coordinates w0, w1 and w2
+            const s32 w0 = row_start[0] + step[0] * column;
+            const s32 w1 = row_start[1] + step[1] * column;
+            const s32 w2 = row_start[2] + step[2] * column;
+            const s32 wsum = w0 + w1 + w2;
+
+            const auto baricentric_coordinates = Common::MakeVec(
+                f24::FromFloat32(static_cast<f32>(w0)), f24::FromFloat32(static_cast<f32>(w1)),
+                f24::FromFloat32(static_cast<f32>(w2)));
+            const f24 interpolated_w_inverse =
+                f24::One() / Common::Dot(w_inverse, baricentric_coordinates);
+
+            // interpolated_z = z / w
+            const float interpolated_z_over_w =
+                (v0.screenpos[2].ToFloat32() * w0 + v1.screenpos[2].ToFloat32() * w1 +
+                 v2.screenpos[2].ToFloat32() * w2) /
+                wsum;
+
+            // Not fully accurate. About 3 bits in precision are missing.
+            // Z-Buffer (z / w * scale + offset)
+            float depth = interpolated_z_over_w * depth_scale + depth_offset;
+
+            // Potentially switch to W-Buffer
+            if (w_buffering) {
+                // W-Buffer (z * scale + w * offset = (z / w * scale + offset) * w)
+                depth *= interpolated_w_inverse.ToFloat32() * wsum;
+            }
 
-                // Clamp the result
-                depth = std::clamp(depth, 0.0f, 1.0f);
-
-                /**
-                 * Perspective correct attribute interpolation:
-                 * Attribute values cannot be calculated by simple linear interpolation since
-                 * they are not linear in screen space. For example, when interpolating a
-                 * texture coordinate across two vertices, something simple like
-                 *     u = (u0*w0 + u1*w1)/(w0+w1)
-                 * will not work. However, the attribute value divided by the
-                 * clipspace w-coordinate (u/w) and and the inverse w-coordinate (1/w) are linear
-                 * in screenspace. Hence, we can linearly interpolate these two independently and
-                 * calculate the interpolated attribute by dividing the results.
-                 * I.e.
-                 *     u_over_w   = ((u0/v0.pos.w)*w0 + (u1/v1.pos.w)*w1)/(w0+w1)
-                 *     one_over_w = (( 1/v0.pos.w)*w0 + ( 1/v1.pos.w)*w1)/(w0+w1)
-                 *     u = u_over_w / one_over_w
-                 *
-                 * The generalization to three vertices is straightforward in baricentric
-                 *coordinates.
-                 **/
-                const auto get_interpolated_attribute = [&](f24 attr0, f24 attr1, f24 attr2) {
-                    auto attr_over_w = Common::MakeVec(attr0, attr1, attr2);
-                    f24 interpolated_attr_over_w =
-                        Common::Dot(attr_over_w, baricentric_coordinates);
-                    return interpolated_attr_over_w * interpolated_w_inverse;
-                };
+            // Clamp the result
+            depth = std::clamp(depth, 0.0f, 1.0f);
+
+            /**
+             * Perspective correct attribute interpolation:
+             * Attribute values cannot be calculated by simple linear interpolation since
+             * they are not linear in screen space. For example, when interpolating a
+             * texture coordinate across two vertices, something simple like
+             *     u = (u0*w0 + u1*w1)/(w0+w1)
+             * will not work. However, the attribute value divided by the
+             * clipspace w-coordinate (u/w) and and the inverse w-coordinate (1/w) are linear
+             * in screenspace. Hence, we can linearly interpolate these two independently and
+             * calculate the interpolated attribute by dividing the results.
+             * I.e.
+             *     u_over_w   = ((u0/v0.pos.w)*w0 + (u1/v1.pos.w)*w1)/(w0+w1)
+             *     one_over_w = (( 1/v0.pos.w)*w0 + ( 1/v1.pos.w)*w1)/(w0+w1)
+             *     u = u_over_w / one_over_w
+             *
+             * The generalization to three vertices is straightforward in baricentric
+             *coordinates.
+             **/
+            const auto get_interpolated_attribute = [&](f24 attr0, f24 attr1, f24 attr2) {
+                auto attr_over_w = Common::MakeVec(attr0, attr1, attr2);
+                f24 interpolated_attr_over_w = Common::Dot(attr_over_w, baricentric_coordinates);
+                return interpolated_attr_over_w * interpolated_w_inverse;
+            };
+
+            const Common::Vec4<u8> primary_color{
+                static_cast<u8>(
+                    round(get_interpolated_attribute(v0.color.r(), v1.color.r(), v2.color.r())
+                              .ToFloat32() *
+                          255)),
+                static_cast<u8>(
+                    round(get_interpolated_attribute(v0.color.g(), v1.color.g(), v2.color.g())
+                              .ToFloat32() *
+                          255)),
+                static_cast<u8>(
+                    round(get_interpolated_attribute(v0.color.b(), v1.color.b(), v2.color.b())
+                              .ToFloat32() *
+                          255)),
+                static_cast<u8>(
+                    round(get_interpolated_attribute(v0.color.a(), v1.color.a(), v2.color.a())
+                              .ToFloat32() *
+                          255)),
+            };
+
+            std::array<Common::Vec2<f24>, 3> uv;
+            uv[0].u() = get_interpolated_attribute(v0.tc0.u(), v1.tc0.u(), v2.tc0.u());
+            uv[0].v() = get_interpolated_attribute(v0.tc0.v(), v1.tc0.v(), v2.tc0.v());
+            uv[1].u() = get_interpolated_attribute(v0.tc1.u(), v1.tc1.u(), v2.tc1.u());
+            uv[1].v() = get_interpolated_attribute(v0.tc1.v(), v1.tc1.v(), v2.tc1.v());
+            uv[2].u() = get_interpolated_attribute(v0.tc2.u(), v1.tc2.u(), v2.tc2.u());
+            uv[2].v() = get_interpolated_attribute(v0.tc2.v(), v1.tc2.v(), v2.tc2.v());
+
+            // Sample bound texture units.
+            const f24 tc0_w = get_interpolated_attribute(v0.tc0_w, v1.tc0_w, v2.tc0_w);
+            const auto texture_color = TextureColor(uv, textures, tc0_w);
+
+            Common::Vec4<u8> primary_fragment_color = {0, 0, 0, 0};
+            Common::Vec4<u8> secondary_fragment_color = {0, 0, 0, 0};
+
+            if (!regs.lighting.disable) {
+                const auto normquat =
+                    Common::Quaternion<f32>{
+                        {get_interpolated_attribute(v0.quat.x, v1.quat.x, v2.quat.x).ToFloat32(),
+                         get_interpolated_attribute(v0.quat.y, v1.quat.y, v2.quat.y).ToFloat32(),
+                         get_interpolated_attribute(v0.quat.z, v1.quat.z, v2.quat.z).ToFloat32()},
+                        get_interpolated_attribute(v0.quat.w, v1.quat.w, v2.quat.w).ToFloat32(),
+                    }
+                        .Normalized();
 
-                const Common::Vec4<u8> primary_color{
-                    static_cast<u8>(
-                        round(get_interpolated_attribute(v0.color.r(), v1.color.r(), v2.color.r())
-                                  .ToFloat32() *
-                              255)),
-                    static_cast<u8>(
-                        round(get_interpolated_attribute(v0.color.g(), v1.color.g(), v2.color.g())
-                                  .ToFloat32() *
-                              255)),
-                    static_cast<u8>(
-                        round(get_interpolated_attribute(v0.color.b(), v1.color.b(), v2.color.b())
-                                  .ToFloat32() *
-                              255)),
-                    static_cast<u8>(
-                        round(get_interpolated_attribute(v0.color.a(), v1.color.a(), v2.color.a())
-                                  .ToFloat32() *
-                              255)),
+                const Common::Vec3f view{
+                    get_interpolated_attribute(v0.view.x, v1.view.x, v2.view.x).ToFloat32(),
+                    get_interpolated_attribute(v0.view.y, v1.view.y, v2.view.y).ToFloat32(),
+                    get_interpolated_attribute(v0.view.z, v1.view.z, v2.view.z).ToFloat32(),
                 };
+                std::tie(primary_fragment_color, secondary_fragment_color) =
+                    ComputeFragmentsColors(regs.lighting, lighting_cache, normquat, view,
+                                           texture_color);
+            }
 
-                std::array<Common::Vec2<f24>, 3> uv;
-                uv[0].u() = get_interpolated_attribute(v0.tc0.u(), v1.tc0.u(), v2.tc0.u());
-                uv[0].v() = get_interpolated_attribute(v0.tc0.v(), v1.tc0.v(), v2.tc0.v());
-                uv[1].u() = get_interpolated_attribute(v0.tc1.u(), v1.tc1.u(), v2.tc1.u());
-                uv[1].v() = get_interpolated_attribute(v0.tc1.v(), v1.tc1.v(), v2.tc1.v());
-                uv[2].u() = get_interpolated_attribute(v0.tc2.u(), v1.tc2.u(), v2.tc2.u());
-                uv[2].v() = get_interpolated_attribute(v0.tc2.v(), v1.tc2.v(), v2.tc2.v());
-
-                // Sample bound texture units.
-                const f24 tc0_w = get_interpolated_attribute(v0.tc0_w, v1.tc0_w, v2.tc0_w);
-                const auto texture_color = TextureColor(uv, textures, tc0_w);
-
-                Common::Vec4<u8> primary_fragment_color = {0, 0, 0, 0};
-                Common::Vec4<u8> secondary_fragment_color = {0, 0, 0, 0};
-
-                if (!regs.lighting.disable) {
-                    const auto normquat =
-                        Common::Quaternion<f32>{
-                            {get_interpolated_attribute(v0.quat.x, v1.quat.x, v2.quat.x)
-                                 .ToFloat32(),
-                             get_interpolated_attribute(v0.quat.y, v1.quat.y, v2.quat.y)
-                                 .ToFloat32(),
-                             get_interpolated_attribute(v0.quat.z, v1.quat.z, v2.quat.z)
-                                 .ToFloat32()},
-                            get_interpolated_attribute(v0.quat.w, v1.quat.w, v2.quat.w).ToFloat32(),
-                        }
-                            .Normalized();
-
-                    const Common::Vec3f view{
-                        get_interpolated_attribute(v0.view.x, v1.view.x, v2.view.x).ToFloat32(),
-                        get_interpolated_attribute(v0.view.y, v1.view.y, v2.view.y).ToFloat32(),
-                        get_interpolated_attribute(v0.view.z, v1.view.z, v2.view.z).ToFloat32(),
-                    };
-                    std::tie(primary_fragment_color, secondary_fragment_color) =
-                        ComputeFragmentsColors(regs.lighting, pica.lighting, normquat, view,
-                                               texture_color);
-                }
-
-                // Write the TEV stages.
-                auto combiner_output =
-                    WriteTevConfig(texture_color, tev_stages, primary_color, primary_fragment_color,
-                                   secondary_fragment_color);
-
-                const auto& output_merger = regs.framebuffer.output_merger;
-                if (output_merger.fragment_operation_mode ==
-                    FramebufferRegs::FragmentOperationMode::Shadow) {
-                    const u32 depth_int = static_cast<u32>(depth * 0xFFFFFF);
-                    // Use green color as the shadow intensity
-                    const u8 stencil = combiner_output.y;
-                    fb.DrawShadowMapPixel(x >> 4, y >> 4, depth_int, stencil);
-                    // Skip the normal output merger pipeline if it is in shadow mode
-                    continue;
-                }
+            // Write the TEV stages.
+            auto combiner_output = WriteTevConfig(texture_color, primary_color,
+                                                  primary_fragment_color, secondary_fragment_color);
+
+            const auto& output_merger = regs.framebuffer.output_merger;
+            if (output_merger.fragment_operation_mode ==
+                FramebufferRegs::FragmentOperationMode::Shadow) {
+                const u32 depth_int = static_cast<u32>(depth * 0xFFFFFF);
+                // Use green color as the shadow intensity
+                const u8 stencil = combiner_output.y;
+                fb.DrawShadowMapPixel(x >> 4, y >> 4, depth_int, stencil);
+                // Skip the normal output merger pipeline if it is in shadow mode
+                continue;
+            }
 
-                // Does alpha testing happen before or after stencil?
-                if (!DoAlphaTest(combiner_output.a())) {
-                    continue;
-                }
-                WriteFog(depth, combiner_output);
-                if (!DoDepthStencilTest(x, y, depth)) {
-                    continue;
-                }
-                const auto result = PixelColor(x, y, combiner_output);
-                if (regs.framebuffer.framebuffer.allow_color_write != 0) {
-                    fb.DrawPixel(x >> 4, y >> 4, result);
-                }
+            // Does alpha testing happen before or after stencil?
+            if (!DoAlphaTest(combiner_output.a())) {
+                continue;
             }
-        };
-        sw_workers.QueueWork(std::move(process_scanline));
+            WriteFog(depth, combiner_output);
+            if (!DoDepthStencilTest(x, y, depth)) {
+                continue;
+            }
+            const auto result = PixelColor(x, y, combiner_output);
+            if (regs.framebuffer.framebuffer.allow_color_write != 0) {
+                fb.DrawPixel(x >> 4, y >> 4, result);
+            }
+        }
     }
-    sw_workers.WaitForRequests();
 }
 
 std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
@@ -556,11 +848,14 @@ std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
             t = texture.config.height - 1 -
                 GetWrappedTexCoord(texture.config.wrap_t, t, texture.config.height);
 
-            const u8* texture_data = memory.GetPhysicalPointer(texture_address);
-            const auto info = TextureInfo::FromPicaRegister(texture.config, texture.format);
-
             // TODO: Apply the min and mag filters to the texture
-            texture_color[i] = LookupTexture(texture_data, s, t, info);
+            if (const auto* texels = texture_cache.Texels(i, texture_address)) {
+                texture_color[i] = texels[t * texture.config.width + s];
+            } else {
+                const u8* texture_data = memory.GetPhysicalPointer(texture_address);
+                const auto info = TextureInfo::FromPicaRegister(texture.config, texture.format);
+                texture_color[i] = LookupTexture(texture_data, s, t, info);
+            }
         }
 
         if (i == 0 && (texture.config.type == TexturingRegs::TextureConfig::Shadow2D ||
@@ -584,7 +879,7 @@ std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
     if (regs.texturing.main_config.texture3_enable) {
         const auto& proctex_uv = uv[regs.texturing.main_config.texture3_coordinates];
         texture_color[3] = ProcTex(proctex_uv.u().ToFloat32(), proctex_uv.v().ToFloat32(),
-                                   regs.texturing, pica.proctex);
+                                   regs.texturing, proctex_cache);
     }
 
     return texture_color;
@@ -681,11 +976,67 @@ Common::Vec4<u8> RasterizerSoftware::PixelColor(u16 x, u16 y,
     return result;
 }
 
+void RasterizerSoftware::BuildTevProgram() {
+    using TevStageConfig = TexturingRegs::TevStageConfig;
+    using Source = TevStageConfig::Source;
+
+    const auto is_valid_source = [](Source source) {
+        return source <= Source::Texture3 ||
+               (source >= Source::PreviousBuffer && source <= Source::Previous);
+    };
+
+    const auto tev_stages = regs.texturing.GetTevStages();
+    const auto& buffer_input = regs.texturing.tev_combiner_buffer_input;
+    tev_program.num_stages = 0;
+    tev_program.uses_buffer = false;
+    for (u32 i = 0; i < tev_stages.size(); ++i) {
+        const auto& config = tev_stages[i];
+        auto& stage = tev_program.stages[i];
+        stage.config = config;
+        stage.constant = Common::MakeVec(config.const_r.Value(), config.const_g.Value(),
+                                         config.const_b.Value(), config.const_a.Value())
+                             .Cast<u8>();
+        stage.color_multiplier = config.GetColorMultiplier();
+        stage.alpha_multiplier = config.GetAlphaMultiplier();
+        stage.pass_through = config.color_op == TevStageConfig::Operation::Replace &&
+                             config.alpha_op == TevStageConfig::Operation::Replace &&
+                             config.color_source1 == Source::Previous &&
+                             config.alpha_source1 == Source::Previous &&
+                             config.color_modifier1 == TevStageConfig::ColorModifier::SourceColor &&
+                             config.alpha_modifier1 == TevStageConfig::AlphaModifier::SourceAlpha &&
+                             stage.color_multiplier == 1 && stage.alpha_multiplier == 1;
+        stage.updates_buffer_color = buffer_input.TevStageUpdatesCombinerBufferColor(i);
+        stage.updates_buffer_alpha = buffer_input.TevStageUpdatesCombinerBufferAlpha(i);
+        if (stage.pass_through) {
+            continue;
+        }
+
+        tev_program.num_stages = i + 1;
+        const std::array<Source, 6> stage_sources = {
+            config.color_source1.Value(), config.color_source2.Value(),
+            config.color_source3.Value(), config.alpha_source1.Value(),
+            config.alpha_source2.Value(), config.alpha_source3.Value(),
+        };
+        for (const Source source : stage_sources) {
+            if (!is_valid_source(source)) {
+                LOG_ERROR(HW_GPU, "Unknown color combiner source {}", static_cast<u32>(source));
+                UNIMPLEMENTED();
+            }
+            tev_program.uses_buffer |= source == Source::PreviousBuffer;
+        }
+    }
+
+    tev_program.buffer_color =
+        Common::MakeVec(regs.texturing.tev_combiner_buffer_color.r.Value(),
+                        regs.texturing.tev_combiner_buffer_color.g.Value(),
+                        regs.texturing.tev_combiner_buffer_color.b.Value(),
+                        regs.texturing.tev_combiner_buffer_color.a.Value())
+            .Cast<u8>();
+}
+
 Common::Vec4<u8> RasterizerSoftware::WriteTevConfig(
-    std::span<const Common::Vec4<u8>, 4> texture_color,
-    std::span<const Pica::TexturingRegs::TevStageConfig, 6> tev_stages,
-    Common::Vec4<u8> primary_color, Common::Vec4<u8> primary_fragment_color,
-    Common::Vec4<u8> secondary_fragment_color) {
+    std::span<const Common::Vec4<u8>, 4> texture_color, Common::Vec4<u8> primary_color,
+    Common::Vec4<u8> primary_fragment_color, Common::Vec4<u8> secondary_fragment_color) const {
     /**
      * Texture environment - consists of 6 stages of color and alpha combining.
      * Color combiners take three input color values from some source (e.g. interpolated
@@ -694,94 +1045,85 @@ Common::Vec4<u8> RasterizerSoftware::WriteTevConfig(
      * with some basic arithmetic. Alpha combiners can be configured separately but work
      * analogously.
      **/
+    using Source = TexturingRegs::TevStageConfig::Source;
+
+    // Indexed by the source enum. Invalid sources were reported when building the program and
+    // read zero here.
+    std::array<Common::Vec4<u8>, 16> sources{};
+    sources[static_cast<u32>(Source::PrimaryColor)] = primary_color;
+    sources[static_cast<u32>(Source::PrimaryFragmentColor)] = primary_fragment_color;
+    sources[static_cast<u32>(Source::SecondaryFragmentColor)] = secondary_fragment_color;
+    sources[static_cast<u32>(Source::Texture0)] = texture_color[0];
+    sources[static_cast<u32>(Source::Texture1)] = texture_color[1];
+    sources[static_cast<u32>(Source::Texture2)] = texture_color[2];
+    sources[static_cast<u32>(Source::Texture3)] = texture_color[3];
+
     Common::Vec4<u8> combiner_output = primary_color;
     Common::Vec4<u8> combiner_buffer = {0, 0, 0, 0};
-    Common::Vec4<u8> next_combiner_buffer =
-        Common::MakeVec(regs.texturing.tev_combiner_buffer_color.r.Value(),
-                        regs.texturing.tev_combiner_buffer_color.g.Value(),
-                        regs.texturing.tev_combiner_buffer_color.b.Value(),
-                        regs.texturing.tev_combiner_buffer_color.a.Value())
-            .Cast<u8>();
-
-    for (u32 tev_stage_index = 0; tev_stage_index < tev_stages.size(); ++tev_stage_index) {
-        const auto& tev_stage = tev_stages[tev_stage_index];
-        using Source = TexturingRegs::TevStageConfig::Source;
-
-        auto get_source = [&](Source source) -> Common::Vec4<u8> {
-            switch (source) {
-            case Source::PrimaryColor:
-                return primary_color;
-            case Source::PrimaryFragmentColor:
-                return primary_fragment_color;
-            case Source::SecondaryFragmentColor:
-                return secondary_fragment_color;
-            case Source::Texture0:
-                return texture_color[0];
-            case Source::Texture1:
-                return texture_color[1];
-            case Source::Texture2:
-                return texture_color[2];
-            case Source::Texture3:
-                return texture_color[3];
-            case Source::PreviousBuffer:
-                return combiner_buffer;
-            case Source::Constant:
-                return Common::MakeVec(tev_stage.const_r.Value(), tev_stage.const_g.Value(),
-                                       tev_stage.const_b.Value(), tev_stage.const_a.Value())
-                    .Cast<u8>();
-            case Source::Previous:
-                return combiner_output;
-            default:
-                LOG_ERROR(HW_GPU, "Unknown color combiner source {}", (int)source);
-                UNIMPLEMENTED();
-                return {0, 0, 0, 0};
+    Common::Vec4<u8> next_combiner_buffer = tev_program.buffer_color;
+
+    for (u32 tev_stage_index = 0; tev_stage_index < tev_program.num_stages; ++tev_stage_index) {
+        const auto& stage = tev_program.stages[tev_stage_index];
+        const auto& tev_stage = stage.config;
+
+        if (!stage.pass_through) {
+            sources[static_cast<u32>(Source::PreviousBuffer)] = combiner_buffer;
+            sources[static_cast<u32>(Source::Constant)] = stage.constant;
+            sources[static_cast<u32>(Source::Previous)] = combiner_output;
+            const auto get_source = [&](Source source) -> const Common::Vec4<u8>& {
+                return sources[static_cast<u32>(source)];
+            };
+
+            /**
+             * Color combiner
+             * NOTE: Not sure if the alpha combiner might use the color output of the previous
+             *       stage as input. Hence, we currently don't directly write the result to
+             *       combiner_output.rgb(), but instead store it in a temporary variable until
+             *       alpha combining has been done.
+             **/
+            const std::array<Common::Vec3<u8>, 3> color_result = {
+                GetColorModifier(tev_stage.color_modifier1, get_source(tev_stage.color_source1)),
+                GetColorModifier(tev_stage.color_modifier2, get_source(tev_stage.color_source2)),
+                GetColorModifier(tev_stage.color_modifier3, get_source(tev_stage.color_source3)),
+            };
+            const Common::Vec3<u8> color_output = ColorCombine(tev_stage.color_op, color_result);
+
+            u8 alpha_output;
+            if (tev_stage.color_op == TexturingRegs::TevStageConfig::Operation::Dot3_RGBA) {
+                // result of Dot3_RGBA operation is also placed to the alpha component
+                alpha_output = color_output.x;
+            } else {
+                // alpha combiner
+                const std::array<u8, 3> alpha_result = {{
+                    GetAlphaModifier(tev_stage.alpha_modifier1,
+                                     get_source(tev_stage.alpha_source1)),
+                    GetAlphaModifier(tev_stage.alpha_modifier2,
+                                     get_source(tev_stage.alpha_source2)),
+                    GetAlphaModifier(tev_stage.alpha_modifier3,
+                                     get_source(tev_stage.alpha_source3)),
+                }};
+                alpha_output = AlphaCombine(tev_stage.alpha_op, alpha_result);
             }
-        };
-
-        /**
-         * Color combiner
-         * NOTE: Not sure if the alpha combiner might use the color output of the previous
-         *       stage as input. Hence, we currently don't directly write the result to
-         *       combiner_output.rgb(), but instead store it in a temporary variable until
-         *       alpha combining has been done.
-         **/
-        const std::array<Common::Vec3<u8>, 3> color_result = {
-            GetColorModifier(tev_stage.color_modifier1, get_source(tev_stage.color_source1)),
-            GetColorModifier(tev_stage.color_modifier2, get_source(tev_stage.color_source2)),
-            GetColorModifier(tev_stage.color_modifier3, get_source(tev_stage.color_source3)),
-        };
-        const Common::Vec3<u8> color_output = ColorCombine(tev_stage.color_op, color_result);
 
-        u8 alpha_output;
-        if (tev_stage.color_op == TexturingRegs::TevStageConfig::Operation::Dot3_RGBA) {
-            // result of Dot3_RGBA operation is also placed to the alpha component
-            alpha_output = color_output.x;
-        } else {
-            // alpha combiner
-            const std::array<u8, 3> alpha_result = {{
-                GetAlphaModifier(tev_stage.alpha_modifier1, get_source(tev_stage.alpha_source1)),
-                GetAlphaModifier(tev_stage.alpha_modifier2, get_source(tev_stage.alpha_source2)),
-                GetAlphaModifier(tev_stage.alpha_modifier3, get_source(tev_stage.alpha_source3)),
-            }};
-            alpha_output = AlphaCombine(tev_stage.alpha_op, alpha_result);
+            combiner_output[0] = std::min(255U, color_output.r() * stage.color_multiplier);
+            combiner_output[1] = std::min(255U, color_output.g() * stage.color_multiplier);
+            combiner_output[2] = std::min(255U, color_output.b() * stage.color_multiplier);
+            combiner_output[3] = std::min(255U, alpha_output * stage.alpha_multiplier);
         }
 
-        combiner_output[0] = std::min(255U, color_output.r() * tev_stage.GetColorMultiplier());
-        combiner_output[1] = std::min(255U, color_output.g() * tev_stage.GetColorMultiplier());
-        combiner_output[2] = std::min(255U, color_output.b() * tev_stage.GetColorMultiplier());
-        combiner_output[3] = std::min(255U, alpha_output * tev_stage.GetAlphaMultiplier());
+        if (!tev_program.uses_buffer) {
+            continue;
+        }
 
         combiner_buffer = next_combiner_buffer;
 
-        if (regs.texturing.tev_combiner_buffer_input.TevStageUpdatesCombinerBufferColor(
-                tev_stage_index)) {
+        if (stage.updates_buffer_color) {
             next_combiner_buffer.r() = combiner_output.r();
             next_combiner_buffer.g() = combiner_output.g();
             next_combiner_buffer.b() = combiner_output.b();
         }
 
-        if (regs.texturing.tev_combiner_buffer_input.TevStageUpdatesCombinerBufferAlpha(
-                tev_stage_index)) {
+        if (stage.updates_buffer_alpha) {
             next_combiner_buffer.a() = combiner_output.a();
         }
     }
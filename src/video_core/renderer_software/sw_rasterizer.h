@@ -5,11 +5,15 @@
 #pragma once
 
 #include <span>
-#include "common/thread_worker.h"
+#include <vector>
+#include "common/thread_pool.h"
 #include "video_core/pica/regs_texturing.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_software/sw_clipper.h"
 #include "video_core/renderer_software/sw_framebuffer.h"
+#include "video_core/renderer_software/sw_lighting.h"
+#include "video_core/renderer_software/sw_proctex.h"
+#include "video_core/renderer_software/sw_texture_cache.h"
 
 namespace Pica {
 struct RegsInternal;
@@ -23,10 +27,10 @@ struct Vertex;
 class RasterizerSoftware : public VideoCore::RasterizerInterface {
 public:
     explicit RasterizerSoftware(Memory::MemorySystem& memory, Pica::PicaCore& pica);
+    ~RasterizerSoftware() override;
 
-    void AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
-                     const Pica::OutputVertex& v2) override;
-    void DrawTriangles() override {}
+    void AddTriangles(std::span<const Pica::OutputVertex> vertices) override;
+    void DrawTriangles() override;
     void NotifyPicaRegisterChanged(u32 id) override {}
     void FlushAll() override {}
     void FlushRegion(PAddr addr, u32 size) override {}
@@ -35,13 +39,47 @@ public:
     void ClearAll(bool flush) override {}
 
 private:
+    struct Triangle;
+
+    /// TEV configuration of the current draw, resolved once instead of for every pixel.
+    struct TevStage {
+        Pica::TexturingRegs::TevStageConfig config;
+        Common::Vec4<u8> constant;
+        u32 color_multiplier;
+        u32 alpha_multiplier;
+        bool pass_through;
+        bool updates_buffer_color;
+        bool updates_buffer_alpha;
+    };
+
+    struct TevProgram {
+        std::array<TevStage, 6> stages;
+        u32 num_stages; ///< Trailing pass-through stages are not evaluated.
+        bool uses_buffer;
+        Common::Vec4<u8> buffer_color;
+    };
+
+    /// Clips the triangle formed by the provided vertices against the view volume.
+    void AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
+                     const Pica::OutputVertex& v2);
+
+    /// Queues the triangle formed by the provided vertices, which lies within the view volume.
+    void AddUnclippedTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
+                              const Pica::OutputVertex& v2);
+
     /// Computes the screen coordinates of the provided vertex.
     void MakeScreenCoords(Vertex& vtx);
 
-    /// Processes the triangle defined by the provided vertices.
+    /// Culls the triangle defined by the provided vertices and queues it for rasterization.
     void ProcessTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2,
                          bool reversed = false);
 
+    /// Rasterizes all queued triangles, distributing horizontal screen bins across the workers.
+    void FlushTriangles();
+
+    /// Rasterizes the part of the triangle that lies within the rows [bin_begin, bin_end).
+    void RasterizeTriangle(const Triangle& triangle, u16 bin_begin, u16 bin_end);
+
     /// Returns the texture color of the currently processed pixel.
     std::array<Common::Vec4<u8>, 4> TextureColor(
         std::span<const Common::Vec2<f24>, 3> uv,
@@ -50,12 +88,14 @@ private:
     /// Returns the final pixel color with blending or logic ops applied.
     Common::Vec4<u8> PixelColor(u16 x, u16 y, Common::Vec4<u8> combiner_output) const;
 
+    /// Resolves the TEV configuration of the current draw.
+    void BuildTevProgram();
+
     /// Emulates the TEV configuration and returns the combiner output.
-    Common::Vec4<u8> WriteTevConfig(
-        std::span<const Common::Vec4<u8>, 4> texture_color,
-        std::span<const Pica::TexturingRegs::TevStageConfig, 6> tev_stages,
-        Common::Vec4<u8> primary_color, Common::Vec4<u8> primary_fragment_color,
-        Common::Vec4<u8> secondary_fragment_color);
+    Common::Vec4<u8> WriteTevConfig(std::span<const Common::Vec4<u8>, 4> texture_color,
+                                    Common::Vec4<u8> primary_color,
+                                    Common::Vec4<u8> primary_fragment_color,
+                                    Common::Vec4<u8> secondary_fragment_color) const;
 
     /// Blends fog to the combiner output if enabled.
     void WriteFog(float depth, Common::Vec4<u8>& combiner_output) const;
@@ -70,9 +110,14 @@ private:
     Memory::MemorySystem& memory;
     Pica::PicaCore& pica;
     Pica::RegsInternal& regs;
+    Common::TaskGroup sw_workers;
     std::size_t num_sw_threads;
-    Common::ThreadWorker sw_workers;
     Framebuffer fb;
+    TextureCache texture_cache;
+    LightingCache lighting_cache;
+    ProcTexCache proctex_cache;
+    std::vector<Triangle> triangles;
+    TevProgram tev_program{};
 };
 
 } // namespace SwRenderer
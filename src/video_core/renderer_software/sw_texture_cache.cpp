@@ -0,0 +1,107 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/hash.h"
+#include "core/memory.h"
+#include "video_core/renderer_software/sw_texture_cache.h"
+
+namespace SwRenderer {
+
+namespace {
+
+/// Entries unused for this many draws are evicted
+constexpr u64 MaxUnusedDraws = 1024;
+
+} // Anonymous namespace
+
+using Pica::TexturingRegs;
+using Pica::Texture::TextureInfo;
+
+TextureCache::TextureCache(Memory::MemorySystem& memory_) : memory{memory_} {}
+
+TextureCache::~TextureCache() = default;
+
+void TextureCache::Prepare(const TexturingRegs& regs, Common::TaskGroup& workers) {
+    current_draw++;
+    slots.fill({});
+
+    const auto textures = regs.GetTextures();
+    for (u32 i = 0; i < textures.size(); i++) {
+        const auto& texture = textures[i];
+        if (!texture.enabled || texture.config.address == 0) {
+            continue;
+        }
+        auto info = TextureInfo::FromPicaRegister(texture.config, texture.format);
+        if (i != 0) {
+            Bind(i, info, workers);
+            continue;
+        }
+
+        switch (texture.config.type) {
+        case TexturingRegs::TextureConfig::Disabled:
+            break;
+        case TexturingRegs::TextureConfig::ShadowCube:
+        case TexturingRegs::TextureConfig::TextureCube: {
+            static constexpr std::array faces = {
+                TexturingRegs::CubeFace::PositiveX, TexturingRegs::CubeFace::NegativeX,
+                TexturingRegs::CubeFace::PositiveY, TexturingRegs::CubeFace::NegativeY,
+                TexturingRegs::CubeFace::PositiveZ, TexturingRegs::CubeFace::NegativeZ,
+            };
+            for (std::size_t face = 0; face < faces.size(); face++) {
+                info.physical_address = regs.GetCubePhysicalAddress(faces[face]);
+                Bind(face == 0 ? 0 : face + 2, info, workers);
+            }
+            break;
+        }
+        default:
+            Bind(0, info, workers);
+            break;
+        }
+    }
+    workers.WaitForRequests();
+
+    std::erase_if(entries, [this](const auto& entry) {
+        return entry.second.last_use + MaxUnusedDraws < current_draw;
+    });
+}
+
+void TextureCache::Bind(std::size_t slot, const TextureInfo& info, Common::TaskGroup& workers) {
+    const PAddr address = info.physical_address;
+    const std::size_t size = info.stride * (info.height / 8);
+    const u8* data = memory.GetPhysicalPointer(address);
+    if (!data || size == 0 || !memory.IsValidPhysicalAddress(address + size - 1)) {
+        return;
+    }
+
+    auto& entry = entries[address];
+    const bool same_layout = entry.info.width == info.width && entry.info.height == info.height &&
+                             entry.info.format == info.format && !entry.texels.empty();
+    if (entry.last_use != current_draw) {
+        entry.last_use = current_draw;
+        if (!same_layout) {
+            entry.info = info;
+            entry.texels.resize(info.width * info.height);
+        }
+        workers.QueueWork([&entry, data, size, decode = !same_layout] {
+            const u64 hash = Common::ComputeFastHash64(data, size);
+            if (!decode && hash == entry.hash) {
+                return;
+            }
+            entry.hash = hash;
+            const auto& info = entry.info;
+            for (u32 y = 0; y < info.height; y++) {
+                for (u32 x = 0; x < info.width; x++) {
+                    entry.texels[y * info.width + x] =
+                        Pica::Texture::LookupTexture(data, x, y, info);
+                }
+            }
+        });
+    } else if (!same_layout) {
+        // Another unit of this draw sampled the address in a different layout
+        return;
+    }
+    slots[slot] = {address, entry.texels.data()};
+}
+
+} // namespace SwRenderer
@@ -0,0 +1,77 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "common/thread_pool.h"
+#include "common/vector_math.h"
+#include "video_core/texture/texture_decode.h"
+
+namespace Memory {
+class MemorySystem;
+}
+
+namespace SwRenderer {
+
+/**
+ * Keeps the textures sampled by the software rasterizer decoded to linear RGBA8, so that a
+ * texture fetch is a single array read instead of a tile decode. The software renderer is not
+ * notified of guest writes, so entries are revalidated against a hash of their guest data on
+ * every draw.
+ */
+class TextureCache {
+    /// Texture units plus the five additional cube map faces of unit 0
+    static constexpr std::size_t NUM_SLOTS = 8;
+
+public:
+    explicit TextureCache(Memory::MemorySystem& memory);
+    ~TextureCache();
+
+    /// Decodes the textures referenced by the current texturing registers, unless unchanged.
+    void Prepare(const Pica::TexturingRegs& regs, Common::TaskGroup& workers);
+
+    /// Returns the decoded texels of the texture unit at address, or nullptr if not cached.
+    [[nodiscard]] const Common::Vec4<u8>* Texels(u32 unit, PAddr address) const {
+        if (slots[unit].address == address) {
+            return slots[unit].texels;
+        }
+        if (unit == 0) {
+            for (std::size_t i = 3; i < NUM_SLOTS; i++) {
+                if (slots[i].address == address) {
+                    return slots[i].texels;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    struct Entry {
+        Pica::Texture::TextureInfo info;
+        u64 hash;
+        u64 last_use;
+        std::vector<Common::Vec4<u8>> texels;
+    };
+
+    struct Slot {
+        PAddr address;
+        const Common::Vec4<u8>* texels;
+    };
+
+    /// Binds the texture described by info to the slot, queueing a decode when it has changed.
+    void Bind(std::size_t slot, const Pica::Texture::TextureInfo& info,
+              Common::TaskGroup& workers);
+
+private:
+    Memory::MemorySystem& memory;
+    std::unordered_map<PAddr, Entry> entries;
+    std::array<Slot, NUM_SLOTS> slots{};
+    u64 current_draw{};
+};
+
+} // namespace SwRenderer
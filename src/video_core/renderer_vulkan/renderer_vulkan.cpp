@@ -18,6 +18,7 @@
 #include "video_core/host_shaders/vulkan_present_anaglyph_frag_spv.h"
 #include "video_core/host_shaders/vulkan_present_frag_spv.h"
 #include "video_core/host_shaders/vulkan_present_interlaced_frag_spv.h"
+#include "video_core/host_shaders/vulkan_present_upscale_frag_spv.h"
 #include "video_core/host_shaders/vulkan_present_vert_spv.h"
 
 #include <vk_mem_alloc.h>
@@ -36,6 +37,9 @@ struct ScreenRectVertex {
 };
 
 constexpr u32 VERTEX_BUFFER_SIZE = sizeof(ScreenRectVertex) * 8192;
+constexpr u32 OVERLAY_IMAGE_SIZE =
+    VideoCore::PerfOverlay::Width * VideoCore::PerfOverlay::Height * 4;
+constexpr u32 OVERLAY_BUFFER_SIZE = OVERLAY_IMAGE_SIZE * 4;
 
 constexpr std::array<f32, 4 * 4> MakeOrthographicMatrix(u32 width, u32 height) {
     // clang-format off
@@ -47,7 +51,7 @@ constexpr std::array<f32, 4 * 4> MakeOrthographicMatrix(u32 width, u32 height) {
 }
 
 constexpr static std::array<vk::DescriptorSetLayoutBinding, 1> PRESENT_BINDINGS = {{
-    {0, vk::DescriptorType::eCombinedImageSampler, 3, vk::ShaderStageFlagBits::eFragment},
+    {0, vk::DescriptorType::eCombinedImageSampler, 4, vk::ShaderStageFlagBits::eFragment},
 }};
 
 RendererVulkan::RendererVulkan(Core::System& system, Pica::PicaCore& pica_,
@@ -56,8 +60,11 @@ RendererVulkan::RendererVulkan(Core::System& system, Pica::PicaCore& pica_,
       instance{system.TelemetrySession(), window, Settings::values.physical_device.GetValue()},
       scheduler{instance}, renderpass_cache{instance, scheduler}, pool{instance},
       main_window{window, instance, scheduler},
+      frame_dumper{system, instance, scheduler, main_window},
       vertex_buffer{instance, scheduler, vk::BufferUsageFlagBits::eVertexBuffer,
                     VERTEX_BUFFER_SIZE},
+      overlay_buffer{instance, scheduler, vk::BufferUsageFlagBits::eTransferSrc,
+                     OVERLAY_BUFFER_SIZE, BufferType::Upload},
       rasterizer{memory,
                  pica,
                  system.CustomTexManager(),
@@ -69,12 +76,24 @@ RendererVulkan::RendererVulkan(Core::System& system, Pica::PicaCore& pica_,
                  renderpass_cache,
                  main_window.ImageCount()},
       present_set_provider{instance, pool, PRESENT_BINDINGS} {
+    scheduler.SetProfiler(&gpu_profiler);
     CompileShaders();
     BuildLayouts();
     BuildPipelines();
+    CreatePerfOverlayTexture();
     if (secondary_window) {
         second_window = std::make_unique<PresentWindow>(*secondary_window, instance, scheduler);
     }
+    main_window.SetPresentCallback([&system] {
+        if (system.perf_stats) {
+            system.perf_stats->RecordFramePresented();
+        }
+    });
+    main_window.SetDisplayCallback([&system](std::chrono::nanoseconds latency) {
+        if (system.perf_stats) {
+            system.perf_stats->RecordDisplayLatency(latency);
+        }
+    });
 }
 
 RendererVulkan::~RendererVulkan() {
@@ -121,6 +140,11 @@ void RendererVulkan::PrepareRendertarget() {
             ConfigureFramebufferTexture(texture, framebuffer);
         }
 
+        // With stereoscopy off the framebuffer of the other eye is never shown, so the guest
+        // memory behind it needn't be looked up in the cache or uploaded.
+        if (fb_id == 0 && !IsEyePresented(i)) {
+            continue;
+        }
         LoadFBToScreenInfo(framebuffer, screen_infos[i], i == 1);
     }
 }
@@ -177,7 +201,12 @@ void RendererVulkan::PrepareDraw(Frame* frame, const Layout::FramebufferLayout&
 
 void RendererVulkan::RenderToWindow(PresentWindow& window, const Layout::FramebufferLayout& layout,
                                     bool flipped) {
-    Frame* frame = window.GetRenderFrame();
+    Frame* frame;
+    {
+        Core::PerfStats::ScopedFrameTimer timer{system.perf_stats.get(),
+                                                Core::PerfStats::FrameTimer::PresentWait};
+        frame = window.GetRenderFrame();
+    }
 
     if (layout.width != frame->width || layout.height != frame->height) {
         window.WaitPresent();
@@ -185,12 +214,23 @@ void RendererVulkan::RenderToWindow(PresentWindow& window, const Layout::Framebu
         window.RecreateFrame(frame, layout.width, layout.height);
     }
 
-    DrawScreens(frame, layout, flipped);
+    DrawScreens(frame, layout, flipped,
+                &window == &main_window && Settings::values.perf_overlay.GetValue());
     scheduler.Flush(frame->render_ready);
 
     window.Present(frame);
 }
 
+void RendererVulkan::RenderToDumper() {
+    frame_dumper.ProcessFrames();
+    Frame* frame = frame_dumper.GetRenderFrame();
+    if (!frame) {
+        return;
+    }
+    DrawScreens(frame, frame_dumper.GetLayout(), false);
+    frame_dumper.CaptureFrame();
+}
+
 void RendererVulkan::LoadFBToScreenInfo(const Pica::FramebufferConfig& framebuffer,
                                         ScreenInfo& screen_info, bool right_eye) {
 
@@ -219,7 +259,9 @@ void RendererVulkan::LoadFBToScreenInfo(const Pica::FramebufferConfig& framebuff
         screen_info.image_view = screen_info.texture.image_view;
         screen_info.texcoords = {0.f, 0.f, 1.f, 1.f};
 
-        ASSERT(false);
+        // The cache uploads every framebuffer it can address through its own path, the rest have
+        // nothing in guest memory to show.
+        FillScreen(Common::Vec3<u8>{}, screen_info.texture);
     }
 }
 
@@ -229,6 +271,7 @@ void RendererVulkan::CompileShaders() {
     present_shaders[0] = CompileSPV(VULKAN_PRESENT_FRAG_SPV, device);
     present_shaders[1] = CompileSPV(VULKAN_PRESENT_ANAGLYPH_FRAG_SPV, device);
     present_shaders[2] = CompileSPV(VULKAN_PRESENT_INTERLACED_FRAG_SPV, device);
+    present_shaders[3] = CompileSPV(VULKAN_PRESENT_UPSCALE_FRAG_SPV, device);
 
     auto properties = instance.GetPhysicalDevice().getProperties();
     for (std::size_t i = 0; i < present_samplers.size(); i++) {
@@ -510,6 +553,149 @@ void RendererVulkan::FillScreen(Common::Vec3<u8> color, const TextureInfo& textu
     });
 }
 
+void RendererVulkan::CreatePerfOverlayTexture() {
+    // The texture is always bound to the present descriptor set, so it exists even when the
+    // overlay is disabled. It is stored rotated like the screens.
+    TextureInfo& texture = screen_infos[3].texture;
+    const vk::ImageCreateInfo image_info = {
+        .imageType = vk::ImageType::e2D,
+        .format = vk::Format::eR8G8B8A8Unorm,
+        .extent = {VideoCore::PerfOverlay::Height, VideoCore::PerfOverlay::Width, 1},
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = vk::SampleCountFlagBits::e1,
+        .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+    };
+
+    const VmaAllocationCreateInfo alloc_info = {
+        .flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        .requiredFlags = 0,
+        .preferredFlags = 0,
+        .pool = VK_NULL_HANDLE,
+        .pUserData = nullptr,
+    };
+
+    VkImage unsafe_image{};
+    VkImageCreateInfo unsafe_image_info = static_cast<VkImageCreateInfo>(image_info);
+
+    VkResult result = vmaCreateImage(instance.GetAllocator(), &unsafe_image_info, &alloc_info,
+                                     &unsafe_image, &texture.allocation, nullptr);
+    if (result != VK_SUCCESS) [[unlikely]] {
+        LOG_CRITICAL(Render_Vulkan, "Failed allocating overlay texture with error {}", result);
+        UNREACHABLE();
+    }
+    texture.image = vk::Image{unsafe_image};
+
+    const vk::ImageViewCreateInfo view_info = {
+        .image = texture.image,
+        .viewType = vk::ImageViewType::e2D,
+        .format = vk::Format::eR8G8B8A8Unorm,
+        .subresourceRange{
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+    };
+    texture.image_view = instance.GetDevice().createImageView(view_info);
+    texture.width = VideoCore::PerfOverlay::Height;
+    texture.height = VideoCore::PerfOverlay::Width;
+
+    screen_infos[3].image_view = texture.image_view;
+    screen_infos[3].texcoords = {0.f, 0.f, 1.f, 1.f};
+
+    // Moves the image to the layout it is sampled in
+    UploadPerfOverlay();
+}
+
+void RendererVulkan::UploadPerfOverlay() {
+    const auto pixels = perf_overlay.Pixels();
+    auto [data, offset, invalidate] = overlay_buffer.Map(OVERLAY_IMAGE_SIZE, 4);
+    std::memcpy(data, pixels.data(), OVERLAY_IMAGE_SIZE);
+    overlay_buffer.Commit(OVERLAY_IMAGE_SIZE);
+
+    renderpass_cache.EndRendering();
+    scheduler.Record([buffer = overlay_buffer.Handle(), offset = offset,
+                      image = screen_infos[3].texture.image](vk::CommandBuffer cmdbuf) {
+        const vk::ImageSubresourceRange range = {
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        };
+
+        // The previous contents are discarded, they are fully overwritten
+        const vk::ImageMemoryBarrier pre_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eShaderRead,
+            .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .oldLayout = vk::ImageLayout::eUndefined,
+            .newLayout = vk::ImageLayout::eTransferDstOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image,
+            .subresourceRange = range,
+        };
+
+        const vk::ImageMemoryBarrier post_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eShaderRead,
+            .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image,
+            .subresourceRange = range,
+        };
+
+        const vk::BufferImageCopy copy = {
+            .bufferOffset = offset,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource{
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {VideoCore::PerfOverlay::Height, VideoCore::PerfOverlay::Width, 1},
+        };
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eFragmentShader,
+                               vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, pre_barrier);
+
+        cmdbuf.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, copy);
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                               vk::PipelineStageFlagBits::eFragmentShader,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, post_barrier);
+    });
+}
+
+void RendererVulkan::DrawPerfOverlay(const Layout::FramebufferLayout& layout) {
+    const u32 scale = VideoCore::PerfOverlay::GetScale(layout.height);
+    const float margin = static_cast<float>(4 * scale);
+    const float width = static_cast<float>(VideoCore::PerfOverlay::Width * scale);
+    const float height = static_cast<float>(VideoCore::PerfOverlay::Height * scale);
+
+    draw_info.layer = 0;
+    switch (Settings::values.render_3d.GetValue()) {
+    case Settings::StereoRenderOption::Anaglyph:
+    case Settings::StereoRenderOption::Interlaced:
+    case Settings::StereoRenderOption::ReverseInterlaced:
+        DrawSingleScreenStereo(3, 3, margin, margin, width, height,
+                               Layout::DisplayOrientation::Landscape);
+        break;
+    default:
+        DrawSingleScreen(3, margin, margin, width, height, Layout::DisplayOrientation::Landscape);
+        break;
+    }
+}
+
 void RendererVulkan::ReloadPipeline() {
     const Settings::StereoRenderOption render_3d = Settings::values.render_3d.GetValue();
     switch (render_3d) {
@@ -521,10 +707,13 @@ void RendererVulkan::ReloadPipeline() {
         current_pipeline = 2;
         draw_info.reverse_interlaced = render_3d == Settings::StereoRenderOption::ReverseInterlaced;
         break;
-    default:
-        current_pipeline = 0;
+    default: {
+        const auto upscaling = Settings::values.spatial_upscaling.GetValue();
+        current_pipeline = upscaling == Settings::SpatialUpscaling::Off ? 0 : 3;
+        draw_info.sharpness = upscaling == Settings::SpatialUpscaling::Sharp ? 0.5f : 0.f;
         break;
     }
+    }
 }
 
 void RendererVulkan::DrawSingleScreen(u32 screen_id, float x, float y, float w, float h,
@@ -767,7 +956,7 @@ void RendererVulkan::DrawBottomScreen(const Layout::FramebufferLayout& layout,
 }
 
 void RendererVulkan::DrawScreens(Frame* frame, const Layout::FramebufferLayout& layout,
-                                 bool flipped) {
+                                 bool flipped, bool draw_perf_overlay) {
     if (settings.bg_color_update_requested.exchange(false)) {
         clear_color.float32[0] = Settings::values.bg_red.GetValue();
         clear_color.float32[1] = Settings::values.bg_green.GetValue();
@@ -802,6 +991,9 @@ void RendererVulkan::DrawScreens(Frame* frame, const Layout::FramebufferLayout&
             DrawBottomScreen(layout, additional_screen);
         }
     }
+    if (draw_perf_overlay) {
+        DrawPerfOverlay(layout);
+    }
 
     scheduler.Record([image = frame->image](vk::CommandBuffer cmdbuf) {
         const vk::ImageMemoryBarrier render_barrier = {
@@ -831,10 +1023,22 @@ void RendererVulkan::DrawScreens(Frame* frame, const Layout::FramebufferLayout&
 void RendererVulkan::SwapBuffers() {
     const Layout::FramebufferLayout& layout = render_window.GetFramebufferLayout();
     PrepareRendertarget();
+    if (UpdatePerfOverlay()) {
+        UploadPerfOverlay();
+    }
     RenderScreenshot();
-    RenderToWindow(main_window, layout, false);
+    RenderToDumper();
+    // In turbo mode frames are dropped instead of waiting for the present thread, so that
+    // frames are only presented as fast as the display shows them.
+    const bool drop_frame =
+        Settings::values.turbo_mode.GetValue() && main_window.IsPresentPending();
+    const bool present = !settings.skip_presentation && !drop_frame;
+    if (present) {
+        RenderToWindow(main_window, layout, false);
+    }
 #ifndef ANDROID
-    if (Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows) {
+    if (present &&
+        Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows) {
         ASSERT(secondary_window);
         const auto& secondary_layout = secondary_window->GetFramebufferLayout();
         if (!second_window) {
@@ -844,10 +1048,20 @@ void RendererVulkan::SwapBuffers() {
         secondary_window->PollEvents();
     }
 #endif
+    UpdateDynamicResolution(scheduler.ConsumeGpuTime());
+    scheduler.CollectProfileScopes();
     rasterizer.TickFrame();
     EndFrame();
 }
 
+void RendererVulkan::PrepareVideoDumping() {
+    frame_dumper.StartDumping();
+}
+
+void RendererVulkan::CleanupVideoDumping() {
+    frame_dumper.StopDumping();
+}
+
 void RendererVulkan::RenderScreenshot() {
     if (!settings.screenshot_requested.exchange(false)) {
         return;
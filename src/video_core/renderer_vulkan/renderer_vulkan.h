@@ -8,6 +8,7 @@
 #include "common/math_util.h"
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
+#include "video_core/renderer_vulkan/vk_frame_dumper.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_present_window.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
@@ -59,12 +60,13 @@ struct PresentUniformData {
     int screen_id_r = 0;
     int layer = 0;
     int reverse_interlaced = 0;
+    f32 sharpness = 0.f;
 };
-static_assert(sizeof(PresentUniformData) == 112,
+static_assert(sizeof(PresentUniformData) == 116,
               "PresentUniformData does not structure in shader!");
 
 class RendererVulkan : public VideoCore::RendererBase {
-    static constexpr std::size_t PRESENT_PIPELINES = 3;
+    static constexpr std::size_t PRESENT_PIPELINES = 4;
 
 public:
     explicit RendererVulkan(Core::System& system, Pica::PicaCore& pica, Frontend::EmuWindow& window,
@@ -82,6 +84,8 @@ public:
     void SwapBuffers() override;
     void TryPresent(int timeout_ms, bool is_secondary) override {}
     void Sync() override;
+    void PrepareVideoDumping() override;
+    void CleanupVideoDumping() override;
 
 private:
     void ReloadPipeline();
@@ -98,8 +102,10 @@ private:
     void PrepareDraw(Frame* frame, const Layout::FramebufferLayout& layout);
     void RenderToWindow(PresentWindow& window, const Layout::FramebufferLayout& layout,
                         bool flipped);
+    void RenderToDumper();
 
-    void DrawScreens(Frame* frame, const Layout::FramebufferLayout& layout, bool flipped);
+    void DrawScreens(Frame* frame, const Layout::FramebufferLayout& layout, bool flipped,
+                     bool draw_perf_overlay = false);
     void DrawBottomScreen(const Layout::FramebufferLayout& layout,
                           const Common::Rectangle<u32>& bottom_screen);
     void DrawTopScreen(const Layout::FramebufferLayout& layout,
@@ -111,6 +117,9 @@ private:
     void LoadFBToScreenInfo(const Pica::FramebufferConfig& framebuffer, ScreenInfo& screen_info,
                             bool right_eye);
     void FillScreen(Common::Vec3<u8> color, const TextureInfo& texture);
+    void CreatePerfOverlayTexture();
+    void UploadPerfOverlay();
+    void DrawPerfOverlay(const Layout::FramebufferLayout& layout);
 
 private:
     Memory::MemorySystem& memory;
@@ -121,7 +130,9 @@ private:
     RenderpassCache renderpass_cache;
     DescriptorPool pool;
     PresentWindow main_window;
+    FrameDumper frame_dumper;
     StreamBuffer vertex_buffer;
+    StreamBuffer overlay_buffer;
     RasterizerVulkan rasterizer;
     std::unique_ptr<PresentWindow> second_window;
 
@@ -133,8 +144,9 @@ private:
     vk::ShaderModule present_vertex_shader;
     u32 current_pipeline = 0;
 
-    std::array<ScreenInfo, 3> screen_infos{};
-    std::array<DescriptorData, 3> present_textures{};
+    // Top left, top right and bottom screens, then the performance overlay
+    std::array<ScreenInfo, 4> screen_infos{};
+    std::array<DescriptorData, 4> present_textures{};
     PresentUniformData draw_info{};
     vk::ClearColorValue clear_color{};
 };
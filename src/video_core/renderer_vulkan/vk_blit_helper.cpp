@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/alignment.h"
 #include "common/vector_math.h"
+#include "video_core/rasterizer_cache/surface_params.h"
 #include "video_core/renderer_vulkan/vk_blit_helper.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
@@ -10,10 +12,12 @@
 #include "video_core/renderer_vulkan/vk_shader_util.h"
 #include "video_core/renderer_vulkan/vk_texture_runtime.h"
 
-#include "video_core/host_shaders/format_reinterpreter/vulkan_d24s8_to_rgba8_comp_spv.h"
+#include "video_core/host_shaders/format_reinterpreter/vulkan_reinterpret_comp_spv.h"
 #include "video_core/host_shaders/full_screen_triangle_vert_spv.h"
 #include "video_core/host_shaders/vulkan_blit_depth_stencil_frag_spv.h"
 #include "video_core/host_shaders/vulkan_depth_to_buffer_comp_spv.h"
+#include "video_core/host_shaders/vulkan_texture_decode_comp_spv.h"
+#include "video_core/host_shaders/vulkan_y2r_comp_spv.h"
 
 namespace Vulkan {
 
@@ -49,6 +53,65 @@ constexpr std::array<vk::DescriptorSetLayoutBinding, 3> COMPUTE_BUFFER_BINDINGS
     {2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute},
 }};
 
+constexpr std::array<vk::DescriptorSetLayoutBinding, 2> TEXTURE_DECODE_BINDINGS = {{
+    {0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute},
+    {1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute},
+}};
+
+struct DecodeInfo {
+    u32 format;
+    u32 width;
+    u32 height;
+};
+static_assert(sizeof(DecodeInfo) <= sizeof(ComputeInfo));
+
+struct Y2RInfo {
+    u32 input_format;
+    u32 width;
+    u32 height;
+    u32 alpha;
+    u32 u_offset;
+    u32 v_offset;
+};
+static_assert(sizeof(Y2RInfo) <= sizeof(ComputeInfo));
+
+struct ReinterpretInfo {
+    Common::Vec2i src_offset;
+    Common::Vec2i extent;
+    u32 src_format;
+    u32 dst_format;
+};
+static_assert(sizeof(ReinterpretInfo) <= sizeof(ComputeInfo));
+
+/// Layouts of the texels written by the reinterpretation shader, must match vulkan_reinterpret.comp
+enum class ReinterpretLayout : u32 {
+    RGBA8,
+    Packed16,
+    D24,
+    D32F,
+    Invalid,
+};
+
+ReinterpretLayout GetReinterpretLayout(vk::Format format) {
+    switch (format) {
+    case vk::Format::eR8G8B8A8Unorm:
+        return ReinterpretLayout::RGBA8;
+    case vk::Format::eR5G5B5A1UnormPack16:
+    case vk::Format::eR5G6B5UnormPack16:
+    case vk::Format::eR4G4B4A4UnormPack16:
+    case vk::Format::eD16Unorm:
+        return ReinterpretLayout::Packed16;
+    case vk::Format::eX8D24UnormPack32:
+    case vk::Format::eD24UnormS8Uint:
+        return ReinterpretLayout::D24;
+    case vk::Format::eD32Sfloat:
+    case vk::Format::eD32SfloatS8Uint:
+        return ReinterpretLayout::D32F;
+    default:
+        return ReinterpretLayout::Invalid;
+    }
+}
+
 constexpr std::array<vk::DescriptorSetLayoutBinding, 2> TWO_TEXTURES_BINDINGS = {{
     {0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
     {1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
@@ -183,19 +246,27 @@ BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_, Descrip
       device{instance.GetDevice()}, compute_provider{instance, pool, COMPUTE_BINDINGS},
       compute_buffer_provider{instance, pool, COMPUTE_BUFFER_BINDINGS},
       two_textures_provider{instance, pool, TWO_TEXTURES_BINDINGS},
+      texture_decode_provider{instance, pool, TEXTURE_DECODE_BINDINGS},
       compute_pipeline_layout{
           device.createPipelineLayout(PipelineLayoutCreateInfo(&compute_provider.Layout(), true))},
       compute_buffer_pipeline_layout{device.createPipelineLayout(
           PipelineLayoutCreateInfo(&compute_buffer_provider.Layout(), true))},
       two_textures_pipeline_layout{
           device.createPipelineLayout(PipelineLayoutCreateInfo(&two_textures_provider.Layout()))},
+      texture_decode_pipeline_layout{device.createPipelineLayout(
+          PipelineLayoutCreateInfo(&texture_decode_provider.Layout(), true))},
       full_screen_vert{CompileSPV(FULL_SCREEN_TRIANGLE_VERT_SPV, device)},
-      d24s8_to_rgba8_comp{CompileSPV(VULKAN_D24S8_TO_RGBA8_COMP_SPV, device)},
+      reinterpret_comp{CompileSPV(VULKAN_REINTERPRET_COMP_SPV, device)},
       depth_to_buffer_comp{CompileSPV(VULKAN_DEPTH_TO_BUFFER_COMP_SPV, device)},
+      texture_decode_comp{CompileSPV(VULKAN_TEXTURE_DECODE_COMP_SPV, device)},
+      y2r_comp{CompileSPV(VULKAN_Y2R_COMP_SPV, device)},
       blit_depth_stencil_frag{CompileSPV(VULKAN_BLIT_DEPTH_STENCIL_FRAG_SPV, device)},
-      d24s8_to_rgba8_pipeline{MakeComputePipeline(d24s8_to_rgba8_comp, compute_pipeline_layout)},
+      reinterpret_pipeline{MakeComputePipeline(reinterpret_comp, compute_buffer_pipeline_layout)},
       depth_to_buffer_pipeline{
           MakeComputePipeline(depth_to_buffer_comp, compute_buffer_pipeline_layout)},
+      texture_decode_pipeline{
+          MakeComputePipeline(texture_decode_comp, texture_decode_pipeline_layout)},
+      y2r_pipeline{MakeComputePipeline(y2r_comp, texture_decode_pipeline_layout)},
       depth_blit_pipeline{MakeDepthStencilBlitPipeline()},
       linear_sampler{device.createSampler(SAMPLER_CREATE_INFO<vk::Filter::eLinear>)},
       nearest_sampler{device.createSampler(SAMPLER_CREATE_INFO<vk::Filter::eNearest>)} {
@@ -206,12 +277,18 @@ BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_, Descrip
                       "BlitHelper: compute_buffer_pipeline_layout");
         SetObjectName(device, two_textures_pipeline_layout,
                       "BlitHelper: two_textures_pipeline_layout");
+        SetObjectName(device, texture_decode_pipeline_layout,
+                      "BlitHelper: texture_decode_pipeline_layout");
         SetObjectName(device, full_screen_vert, "BlitHelper: full_screen_vert");
-        SetObjectName(device, d24s8_to_rgba8_comp, "BlitHelper: d24s8_to_rgba8_comp");
+        SetObjectName(device, reinterpret_comp, "BlitHelper: reinterpret_comp");
         SetObjectName(device, depth_to_buffer_comp, "BlitHelper: depth_to_buffer_comp");
+        SetObjectName(device, texture_decode_comp, "BlitHelper: texture_decode_comp");
+        SetObjectName(device, y2r_comp, "BlitHelper: y2r_comp");
         SetObjectName(device, blit_depth_stencil_frag, "BlitHelper: blit_depth_stencil_frag");
-        SetObjectName(device, d24s8_to_rgba8_pipeline, "BlitHelper: d24s8_to_rgba8_pipeline");
+        SetObjectName(device, reinterpret_pipeline, "BlitHelper: reinterpret_pipeline");
         SetObjectName(device, depth_to_buffer_pipeline, "BlitHelper: depth_to_buffer_pipeline");
+        SetObjectName(device, texture_decode_pipeline, "BlitHelper: texture_decode_pipeline");
+        SetObjectName(device, y2r_pipeline, "BlitHelper: y2r_pipeline");
         if (depth_blit_pipeline) {
             SetObjectName(device, depth_blit_pipeline, "BlitHelper: depth_blit_pipeline");
         }
@@ -224,12 +301,17 @@ BlitHelper::~BlitHelper() {
     device.destroyPipelineLayout(compute_pipeline_layout);
     device.destroyPipelineLayout(compute_buffer_pipeline_layout);
     device.destroyPipelineLayout(two_textures_pipeline_layout);
+    device.destroyPipelineLayout(texture_decode_pipeline_layout);
     device.destroyShaderModule(full_screen_vert);
-    device.destroyShaderModule(d24s8_to_rgba8_comp);
+    device.destroyShaderModule(reinterpret_comp);
     device.destroyShaderModule(depth_to_buffer_comp);
+    device.destroyShaderModule(texture_decode_comp);
+    device.destroyShaderModule(y2r_comp);
     device.destroyShaderModule(blit_depth_stencil_frag);
     device.destroyPipeline(depth_to_buffer_pipeline);
-    device.destroyPipeline(d24s8_to_rgba8_pipeline);
+    device.destroyPipeline(texture_decode_pipeline);
+    device.destroyPipeline(y2r_pipeline);
+    device.destroyPipeline(reinterpret_pipeline);
     device.destroyPipeline(depth_blit_pipeline);
     device.destroySampler(linear_sampler);
     device.destroySampler(nearest_sampler);
@@ -316,122 +398,141 @@ bool BlitHelper::BlitDepthStencil(Surface& source, Surface& dest,
     return true;
 }
 
-bool BlitHelper::ConvertDS24S8ToRGBA8(Surface& source, Surface& dest,
-                                      const VideoCore::TextureCopy& copy) {
+u32 BlitHelper::ReinterpretSize(const Surface& dest, VideoCore::Extent extent) {
+    const u32 num_texels = extent.width * extent.height;
+    switch (GetReinterpretLayout(dest.traits.native)) {
+    case ReinterpretLayout::RGBA8:
+        return num_texels * 4;
+    case ReinterpretLayout::Packed16:
+        return Common::AlignUp(num_texels * 2, sizeof(u32));
+    case ReinterpretLayout::D24:
+    case ReinterpretLayout::D32F:
+        // The stencil bytes follow the depth words
+        if (dest.type == VideoCore::SurfaceType::DepthStencil) {
+            return num_texels * 4 + Common::AlignUp(num_texels, sizeof(u32));
+        }
+        return num_texels * 4;
+    default:
+        return 0;
+    }
+}
+
+bool BlitHelper::Reinterpret(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy,
+                             vk::Buffer buffer, u32 offset, u32 size) {
+    const ReinterpretLayout layout = GetReinterpretLayout(dest.traits.native);
+    if (layout == ReinterpretLayout::Invalid) {
+        return false;
+    }
+    const bool is_depth = source.type == VideoCore::SurfaceType::Depth ||
+                          source.type == VideoCore::SurfaceType::DepthStencil;
+    const bool has_stencil = source.type == VideoCore::SurfaceType::DepthStencil;
+
     std::array<DescriptorData, 3> textures{};
     textures[0].image_info = vk::DescriptorImageInfo{
-        .imageView = source.DepthView(),
-        .imageLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+        .sampler = nearest_sampler,
+        .imageView = is_depth ? source.DepthView() : source.ImageView(),
+        .imageLayout = is_depth ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                                : vk::ImageLayout::eGeneral,
     };
+    // The stencil is only read for D24S8 sources, the others bind their image again
     textures[1].image_info = vk::DescriptorImageInfo{
-        .imageView = source.StencilView(),
-        .imageLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+        .sampler = nearest_sampler,
+        .imageView = has_stencil ? source.StencilView() : textures[0].image_info.imageView,
+        .imageLayout = textures[0].image_info.imageLayout,
     };
-    textures[2].image_info = vk::DescriptorImageInfo{
-        .imageView = dest.ImageView(),
-        .imageLayout = vk::ImageLayout::eGeneral,
+    textures[2].buffer_info = vk::DescriptorBufferInfo{
+        .buffer = buffer,
+        .offset = offset,
+        .range = size,
     };
 
-    const auto descriptor_set = compute_provider.Acquire(textures);
+    const auto descriptor_set = compute_buffer_provider.Acquire(textures);
+
+    // Texels smaller than a word are merged into the buffer with atomics
+    const bool needs_clear = layout == ReinterpretLayout::Packed16 ||
+                             dest.type == VideoCore::SurfaceType::DepthStencil;
 
     renderpass_cache.EndRendering();
-    scheduler.Record([this, descriptor_set, copy, src_image = source.Image(),
-                      dst_image = dest.Image()](vk::CommandBuffer cmdbuf) {
-        const std::array pre_barriers = {
-            vk::ImageMemoryBarrier{
-                .srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite,
-                .dstAccessMask = vk::AccessFlagBits::eShaderRead,
-                .oldLayout = vk::ImageLayout::eGeneral,
-                .newLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = src_image,
-                .subresourceRange{
-                    .aspectMask =
-                        vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil,
-                    .baseMipLevel = 0,
-                    .levelCount = VK_REMAINING_MIP_LEVELS,
-                    .baseArrayLayer = 0,
-                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
-                },
-            },
-            vk::ImageMemoryBarrier{
-                .srcAccessMask = vk::AccessFlagBits::eNone,
-                .dstAccessMask = vk::AccessFlagBits::eShaderWrite,
-                .oldLayout = vk::ImageLayout::eUndefined,
-                .newLayout = vk::ImageLayout::eGeneral,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = dst_image,
-                .subresourceRange{
-                    .aspectMask = vk::ImageAspectFlagBits::eColor,
-                    .baseMipLevel = 0,
-                    .levelCount = VK_REMAINING_MIP_LEVELS,
-                    .baseArrayLayer = 0,
-                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
-                },
+    const ProfileScope profile{scheduler, "Reinterpret"};
+    scheduler.Record([this, descriptor_set, buffer, offset, size, is_depth, needs_clear,
+                      src_image = source.Image(), src_aspect = source.Aspect(),
+                      src_access = source.AccessFlags(),
+                      src_stages = source.PipelineStageFlags(),
+                      info = ReinterpretInfo{
+                          .src_offset = Common::Vec2i{static_cast<int>(copy.src_offset.x),
+                                                      static_cast<int>(copy.src_offset.y)},
+                          .extent = Common::Vec2i{static_cast<int>(copy.extent.width),
+                                                  static_cast<int>(copy.extent.height)},
+                          .src_format = static_cast<u32>(source.pixel_format),
+                          .dst_format = static_cast<u32>(dest.pixel_format) |
+                                        (static_cast<u32>(layout) << 16),
+                      }](vk::CommandBuffer cmdbuf) {
+        const vk::ImageMemoryBarrier pre_barrier = {
+            .srcAccessMask = src_access,
+            .dstAccessMask = vk::AccessFlagBits::eShaderRead,
+            .oldLayout = vk::ImageLayout::eGeneral,
+            .newLayout = is_depth ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                                  : vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = src_image,
+            .subresourceRange{
+                .aspectMask = src_aspect,
+                .baseMipLevel = 0,
+                .levelCount = VK_REMAINING_MIP_LEVELS,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
             },
         };
-        const std::array post_barriers = {
-            vk::ImageMemoryBarrier{
-                .srcAccessMask = vk::AccessFlagBits::eShaderRead,
-                .dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite |
-                                 vk::AccessFlagBits::eDepthStencilAttachmentRead,
-                .oldLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal,
-                .newLayout = vk::ImageLayout::eGeneral,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = src_image,
-                .subresourceRange{
-                    .aspectMask =
-                        vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil,
-                    .baseMipLevel = 0,
-                    .levelCount = VK_REMAINING_MIP_LEVELS,
-                    .baseArrayLayer = 0,
-                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
-                },
-            },
-            vk::ImageMemoryBarrier{
-                .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
-                .dstAccessMask = vk::AccessFlagBits::eTransferRead,
-                .oldLayout = vk::ImageLayout::eGeneral,
-                .newLayout = vk::ImageLayout::eGeneral,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = dst_image,
-                .subresourceRange{
-                    .aspectMask = vk::ImageAspectFlagBits::eColor,
-                    .baseMipLevel = 0,
-                    .levelCount = VK_REMAINING_MIP_LEVELS,
-                    .baseArrayLayer = 0,
-                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
-                },
-            }};
-        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eEarlyFragmentTests |
-                                   vk::PipelineStageFlagBits::eLateFragmentTests,
-                               vk::PipelineStageFlagBits::eComputeShader,
-                               vk::DependencyFlagBits::eByRegion, {}, {}, pre_barriers);
+        const vk::ImageMemoryBarrier post_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eShaderRead,
+            .dstAccessMask = src_access,
+            .oldLayout = pre_barrier.newLayout,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = src_image,
+            .subresourceRange = pre_barrier.subresourceRange,
+        };
+        const vk::BufferMemoryBarrier clear_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = buffer,
+            .offset = offset,
+            .size = size,
+        };
+        const vk::BufferMemoryBarrier buffer_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = buffer,
+            .offset = offset,
+            .size = size,
+        };
 
-        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, compute_pipeline_layout, 0,
-                                  descriptor_set, {});
-        cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, d24s8_to_rgba8_pipeline);
+        if (needs_clear) {
+            cmdbuf.fillBuffer(buffer, offset, size, 0);
+            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                   vk::PipelineStageFlagBits::eComputeShader,
+                                   vk::DependencyFlagBits::eByRegion, {}, clear_barrier, {});
+        }
+        cmdbuf.pipelineBarrier(src_stages, vk::PipelineStageFlagBits::eComputeShader,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, pre_barrier);
 
-        const ComputeInfo info = {
-            .src_offset = Common::Vec2i{static_cast<int>(copy.src_offset.x),
-                                        static_cast<int>(copy.src_offset.y)},
-            .dst_offset = Common::Vec2i{static_cast<int>(copy.dst_offset.x),
-                                        static_cast<int>(copy.dst_offset.y)},
-        };
-        cmdbuf.pushConstants(compute_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, compute_buffer_pipeline_layout,
+                                  0, descriptor_set, {});
+        cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, reinterpret_pipeline);
+        cmdbuf.pushConstants(compute_buffer_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
                              sizeof(info), &info);
 
-        cmdbuf.dispatch(copy.extent.width / 8, copy.extent.height / 8, 1);
+        cmdbuf.dispatch((info.extent.x + 7) / 8, (info.extent.y + 7) / 8, 1);
 
         cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
-                               vk::PipelineStageFlagBits::eEarlyFragmentTests |
-                                   vk::PipelineStageFlagBits::eLateFragmentTests |
-                                   vk::PipelineStageFlagBits::eTransfer,
-                               vk::DependencyFlagBits::eByRegion, {}, {}, post_barriers);
+                               src_stages | vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, buffer_barrier, post_barrier);
     });
     return true;
 }
@@ -458,6 +559,7 @@ bool BlitHelper::DepthToBuffer(Surface& source, vk::Buffer buffer,
     const auto descriptor_set = compute_buffer_provider.Acquire(textures);
 
     renderpass_cache.EndRendering();
+    const ProfileScope profile{scheduler, "Depth To Buffer"};
     scheduler.Record([this, descriptor_set, copy, src_image = source.Image(),
                       extent = source.RealExtent(false)](vk::CommandBuffer cmdbuf) {
         const vk::ImageMemoryBarrier pre_barrier = {
@@ -522,6 +624,126 @@ bool BlitHelper::DepthToBuffer(Surface& source, vk::Buffer buffer,
     return true;
 }
 
+bool BlitHelper::CanDecodeTexture(VideoCore::PixelFormat format) {
+    switch (format) {
+    case PixelFormat::IA8:
+    case PixelFormat::RG8:
+    case PixelFormat::I8:
+    case PixelFormat::A8:
+    case PixelFormat::IA4:
+    case PixelFormat::I4:
+    case PixelFormat::A4:
+    case PixelFormat::ETC1:
+    case PixelFormat::ETC1A4:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void BlitHelper::DecodeTexture(const VideoCore::SurfaceParams& params, vk::Buffer buffer,
+                               u32 src_offset, u32 src_size, u32 dst_offset) {
+    const u32 dst_size = params.width * params.height * sizeof(u32);
+
+    std::array<DescriptorData, 2> buffers{};
+    buffers[0].buffer_info = vk::DescriptorBufferInfo{
+        .buffer = buffer,
+        .offset = src_offset,
+        .range = src_size,
+    };
+    buffers[1].buffer_info = vk::DescriptorBufferInfo{
+        .buffer = buffer,
+        .offset = dst_offset,
+        .range = dst_size,
+    };
+
+    const auto descriptor_set = texture_decode_provider.Acquire(buffers);
+
+    renderpass_cache.EndRendering();
+    const ProfileScope profile{scheduler, "Texture Decode"};
+    scheduler.Record([this, descriptor_set, buffer, dst_offset, dst_size,
+                      info = DecodeInfo{
+                          .format = static_cast<u32>(params.pixel_format),
+                          .width = params.width,
+                          .height = params.height,
+                      }](vk::CommandBuffer cmdbuf) {
+        const vk::BufferMemoryBarrier post_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = buffer,
+            .offset = dst_offset,
+            .size = dst_size,
+        };
+
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, texture_decode_pipeline_layout,
+                                  0, descriptor_set, {});
+        cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, texture_decode_pipeline);
+        cmdbuf.pushConstants(texture_decode_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+                             sizeof(info), &info);
+
+        cmdbuf.dispatch(info.width / 8, info.height / 8, 1);
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                               vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, post_barrier, {});
+    });
+}
+
+void BlitHelper::ConvertY2R(const VideoCore::Y2RConfig& config, vk::Buffer buffer, u32 src_offset,
+                            u32 src_size, u32 dst_offset) {
+    const u32 dst_size = config.width * config.height * sizeof(u32);
+
+    std::array<DescriptorData, 2> buffers{};
+    buffers[0].buffer_info = vk::DescriptorBufferInfo{
+        .buffer = buffer,
+        .offset = src_offset,
+        .range = src_size,
+    };
+    buffers[1].buffer_info = vk::DescriptorBufferInfo{
+        .buffer = buffer,
+        .offset = dst_offset,
+        .range = dst_size,
+    };
+
+    const auto descriptor_set = texture_decode_provider.Acquire(buffers);
+
+    renderpass_cache.EndRendering();
+    const ProfileScope profile{scheduler, "Y2R Conversion"};
+    scheduler.Record([this, descriptor_set, buffer, dst_offset, dst_size,
+                      info = Y2RInfo{
+                          .input_format = static_cast<u32>(config.input_format),
+                          .width = config.width,
+                          .height = config.height,
+                          .alpha = config.alpha,
+                          .u_offset = config.planes[0].size,
+                          .v_offset = config.planes[0].size + config.planes[1].size,
+                      }](vk::CommandBuffer cmdbuf) {
+        const vk::BufferMemoryBarrier post_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = buffer,
+            .offset = dst_offset,
+            .size = dst_size,
+        };
+
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, texture_decode_pipeline_layout,
+                                  0, descriptor_set, {});
+        cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, y2r_pipeline);
+        cmdbuf.pushConstants(texture_decode_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+                             sizeof(info), &info);
+
+        cmdbuf.dispatch(info.width / 8, info.height / 8, 1);
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                               vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, post_barrier, {});
+    });
+}
+
 vk::Pipeline BlitHelper::MakeComputePipeline(vk::ShaderModule shader, vk::PipelineLayout layout) {
     const vk::ComputePipelineCreateInfo compute_info = {
         .stage = MakeStages(shader),
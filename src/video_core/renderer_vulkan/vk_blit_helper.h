@@ -7,9 +7,12 @@
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 
 namespace VideoCore {
+class SurfaceParams;
 struct TextureBlit;
 struct TextureCopy;
+struct Extent;
 struct BufferTextureCopy;
+struct Y2RConfig;
 } // namespace VideoCore
 
 namespace Vulkan {
@@ -29,11 +32,33 @@ public:
 
     bool BlitDepthStencil(Surface& source, Surface& dest, const VideoCore::TextureBlit& blit);
 
-    bool ConvertDS24S8ToRGBA8(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
+    /// Returns the size of the buffer written by Reinterpret for extent texels of dest, 0 if none
+    static u32 ReinterpretSize(const Surface& dest, VideoCore::Extent extent);
+
+    /**
+     * Reads the copy region of source as if its memory held texels in the format of dest, writing
+     * them to buffer at offset laid out for a copy to the image of dest.
+     */
+    bool Reinterpret(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy,
+                     vk::Buffer buffer, u32 offset, u32 size);
 
     bool DepthToBuffer(Surface& source, vk::Buffer buffer,
                        const VideoCore::BufferTextureCopy& copy);
 
+    /// Returns true if the provided tiled format can be decoded to RGBA8 with DecodeTexture.
+    static bool CanDecodeTexture(VideoCore::PixelFormat format);
+
+    /// Detiles and decodes raw guest data at src_offset into linear RGBA8 pixels at dst_offset.
+    void DecodeTexture(const VideoCore::SurfaceParams& params, vk::Buffer buffer, u32 src_offset,
+                       u32 src_size, u32 dst_offset);
+
+    /**
+     * Converts the coefficients and YUV planes of a Y2R conversion at src_offset into linear
+     * RGBA8 pixels at dst_offset.
+     */
+    void ConvertY2R(const VideoCore::Y2RConfig& config, vk::Buffer buffer, u32 src_offset,
+                    u32 src_size, u32 dst_offset);
+
 private:
     vk::Pipeline MakeComputePipeline(vk::ShaderModule shader, vk::PipelineLayout layout);
     vk::Pipeline MakeDepthStencilBlitPipeline();
@@ -49,17 +74,23 @@ private:
     DescriptorSetProvider compute_provider;
     DescriptorSetProvider compute_buffer_provider;
     DescriptorSetProvider two_textures_provider;
+    DescriptorSetProvider texture_decode_provider;
     vk::PipelineLayout compute_pipeline_layout;
     vk::PipelineLayout compute_buffer_pipeline_layout;
     vk::PipelineLayout two_textures_pipeline_layout;
+    vk::PipelineLayout texture_decode_pipeline_layout;
 
     vk::ShaderModule full_screen_vert;
-    vk::ShaderModule d24s8_to_rgba8_comp;
+    vk::ShaderModule reinterpret_comp;
     vk::ShaderModule depth_to_buffer_comp;
+    vk::ShaderModule texture_decode_comp;
+    vk::ShaderModule y2r_comp;
     vk::ShaderModule blit_depth_stencil_frag;
 
-    vk::Pipeline d24s8_to_rgba8_pipeline;
+    vk::Pipeline reinterpret_pipeline;
     vk::Pipeline depth_to_buffer_pipeline;
+    vk::Pipeline texture_decode_pipeline;
+    vk::Pipeline y2r_pipeline;
     vk::Pipeline depth_blit_pipeline;
     vk::Sampler linear_sampler;
     vk::Sampler nearest_sampler;
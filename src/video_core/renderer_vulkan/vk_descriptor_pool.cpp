@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/assert.h"
 #include "common/microprofile.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
@@ -74,10 +75,9 @@ vk::UniqueDescriptorPool DescriptorPool::CreatePool() {
 
 DescriptorSetProvider::DescriptorSetProvider(
     const Instance& instance, DescriptorPool& pool_,
-    std::span<const vk::DescriptorSetLayoutBinding> bindings)
-    : pool{pool_}, device{instance.GetDevice()} {
-    std::array<vk::DescriptorUpdateTemplateEntry, MAX_DESCRIPTORS> update_entries;
-
+    std::span<const vk::DescriptorSetLayoutBinding> bindings, bool push_descriptor_)
+    : pool{pool_}, device{instance.GetDevice()}, num_bindings{static_cast<u32>(bindings.size())},
+      push_descriptor{push_descriptor_} {
     for (u32 i = 0; i < bindings.size(); i++) {
         update_entries[i] = vk::DescriptorUpdateTemplateEntry{
             .dstBinding = bindings[i].binding,
@@ -90,11 +90,18 @@ DescriptorSetProvider::DescriptorSetProvider(
     }
 
     const vk::DescriptorSetLayoutCreateInfo layout_info = {
+        .flags = push_descriptor ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR
+                                 : vk::DescriptorSetLayoutCreateFlags{},
         .bindingCount = static_cast<u32>(bindings.size()),
         .pBindings = bindings.data(),
     };
     layout = device.createDescriptorSetLayoutUnique(layout_info);
 
+    // Push templates also reference the pipeline layout, they are built once it exists.
+    if (push_descriptor) {
+        return;
+    }
+
     const vk::DescriptorUpdateTemplateCreateInfo template_info = {
         .descriptorUpdateEntryCount = static_cast<u32>(bindings.size()),
         .pDescriptorUpdateEntries = update_entries.data(),
@@ -106,8 +113,22 @@ DescriptorSetProvider::DescriptorSetProvider(
 
 DescriptorSetProvider::~DescriptorSetProvider() = default;
 
+void DescriptorSetProvider::BuildPushTemplate(vk::PipelineLayout pipeline_layout, u32 set) {
+    ASSERT(push_descriptor);
+    const vk::DescriptorUpdateTemplateCreateInfo template_info = {
+        .descriptorUpdateEntryCount = num_bindings,
+        .pDescriptorUpdateEntries = update_entries.data(),
+        .templateType = vk::DescriptorUpdateTemplateType::ePushDescriptorsKHR,
+        .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
+        .pipelineLayout = pipeline_layout,
+        .set = set,
+    };
+    update_template = device.createDescriptorUpdateTemplateUnique(template_info);
+}
+
 vk::DescriptorSet DescriptorSetProvider::Acquire(std::span<const DescriptorData> data) {
     MICROPROFILE_SCOPE(Vulkan_DescriptorSetAcquire);
+    ASSERT(!push_descriptor);
     DescriptorSetData key{};
     std::memcpy(key.data(), data.data(), data.size_bytes());
     const auto [it, new_set] = descriptor_set_map.try_emplace(key);
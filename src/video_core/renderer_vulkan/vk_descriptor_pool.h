@@ -56,18 +56,27 @@ private:
 };
 
 /**
- * Allocates and caches descriptor sets of a specific layout.
+ * Allocates and caches descriptor sets of a specific layout. A provider created with push
+ * descriptors never allocates sets, its data is pushed directly into the command buffer instead.
  */
 class DescriptorSetProvider {
 public:
     explicit DescriptorSetProvider(const Instance& instance, DescriptorPool& pool,
-                                   std::span<const vk::DescriptorSetLayoutBinding> bindings);
+                                   std::span<const vk::DescriptorSetLayoutBinding> bindings,
+                                   bool push_descriptor = false);
     ~DescriptorSetProvider();
 
     vk::DescriptorSet Acquire(std::span<const DescriptorData> data);
 
     void FreeWithImage(vk::ImageView image_view);
 
+    /// Creates the push descriptor update template for the provided set of the pipeline layout.
+    void BuildPushTemplate(vk::PipelineLayout pipeline_layout, u32 set);
+
+    [[nodiscard]] bool IsPushDescriptor() const noexcept {
+        return push_descriptor;
+    }
+
     [[nodiscard]] vk::DescriptorSetLayout Layout() const noexcept {
         return *layout;
     }
@@ -85,6 +94,9 @@ private:
     vk::Device device;
     vk::UniqueDescriptorSetLayout layout;
     vk::UniqueDescriptorUpdateTemplate update_template;
+    std::array<vk::DescriptorUpdateTemplateEntry, MAX_DESCRIPTORS> update_entries;
+    u32 num_bindings;
+    bool push_descriptor;
     std::vector<vk::DescriptorSet> free_sets;
     tsl::robin_map<DescriptorSetData, vk::DescriptorSet, DataHasher> descriptor_set_map;
 };
@@ -0,0 +1,211 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/dumping/backend.h"
+#include "video_core/renderer_vulkan/vk_frame_dumper.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+
+#include <vk_mem_alloc.h>
+
+namespace Vulkan {
+
+FrameDumper::FrameDumper(Core::System& system_, const Instance& instance_, Scheduler& scheduler_,
+                         PresentWindow& window_)
+    : system{system_}, instance{instance_}, scheduler{scheduler_}, window{window_} {}
+
+FrameDumper::~FrameDumper() {
+    Release();
+}
+
+void FrameDumper::StartDumping() {
+    std::scoped_lock lock{mutex};
+    is_dumping = true;
+}
+
+void FrameDumper::StopDumping() {
+    std::scoped_lock lock{mutex};
+    is_dumping = false;
+    pending.clear();
+}
+
+Layout::FramebufferLayout FrameDumper::GetLayout() const {
+    const auto video_dumper = system.GetVideoDumper();
+    return video_dumper ? video_dumper->GetLayout() : Layout::FramebufferLayout{};
+}
+
+Frame* FrameDumper::GetRenderFrame() {
+    std::scoped_lock lock{mutex};
+    if (!is_dumping) {
+        Release();
+        return nullptr;
+    }
+    const auto layout = GetLayout();
+    if (frame.width != layout.width || frame.height != layout.height) {
+        Release();
+        Allocate(layout);
+    }
+    return &frame;
+}
+
+void FrameDumper::CaptureFrame() {
+    std::scoped_lock lock{mutex};
+    if (!is_dumping) {
+        return;
+    }
+    if (pending.size() == NUM_READBACK_BUFFERS) {
+        // The encoder is more than a ring behind the GPU, wait for the oldest download.
+        scheduler.Wait(buffers[pending.front()].tick);
+        SendFrame();
+    }
+
+    auto& readback = buffers[next_buffer];
+    scheduler.Record([width = frame.width, height = frame.height, source_image = frame.image,
+                      dst_buffer = readback.buffer](vk::CommandBuffer cmdbuf) {
+        const vk::ImageMemoryBarrier read_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = source_image,
+            .subresourceRange{
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        };
+        const vk::BufferMemoryBarrier host_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eHostRead,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = dst_buffer,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE,
+        };
+        const vk::BufferImageCopy image_copy = {
+            .bufferOffset = 0,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource =
+                {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .mipLevel = 0,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {width, height, 1},
+        };
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                               vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
+        cmdbuf.copyImageToBuffer(source_image, vk::ImageLayout::eTransferSrcOptimal, dst_buffer,
+                                 image_copy);
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                               vk::PipelineStageFlagBits::eHost, vk::DependencyFlagBits::eByRegion,
+                               {}, host_barrier, {});
+    });
+
+    readback.tick = scheduler.CurrentTick();
+    pending.push_back(next_buffer);
+    next_buffer = (next_buffer + 1) % NUM_READBACK_BUFFERS;
+}
+
+void FrameDumper::ProcessFrames() {
+    std::scoped_lock lock{mutex};
+    if (!is_dumping || pending.empty()) {
+        return;
+    }
+    scheduler.Refresh();
+    while (!pending.empty() && scheduler.IsFree(buffers[pending.front()].tick)) {
+        SendFrame();
+    }
+}
+
+void FrameDumper::SendFrame() {
+    const auto& readback = buffers[pending.front()];
+    pending.pop_front();
+
+    auto video_dumper = system.GetVideoDumper();
+    if (!video_dumper) {
+        return;
+    }
+
+    vmaInvalidateAllocation(instance.GetAllocator(), readback.allocation, 0, VK_WHOLE_SIZE);
+    VideoDumper::VideoFrame frame_data{frame.width, frame.height, readback.mapped};
+    if (window.SurfaceFormat() == vk::Format::eR8G8B8A8Unorm) {
+        // The encoder expects BGRA
+        for (std::size_t i = 0; i < frame_data.data.size(); i += 4) {
+            std::swap(frame_data.data[i], frame_data.data[i + 2]);
+        }
+    }
+    video_dumper->AddVideoFrame(std::move(frame_data));
+}
+
+void FrameDumper::Allocate(const Layout::FramebufferLayout& layout) {
+    window.RecreateFrame(&frame, layout.width, layout.height);
+
+    const vk::BufferCreateInfo buffer_info = {
+        .size = layout.width * layout.height * 4,
+        .usage = vk::BufferUsageFlagBits::eTransferDst,
+    };
+    const VmaAllocationCreateInfo alloc_create_info = {
+        .flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT |
+                 VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+        .requiredFlags = 0,
+        .preferredFlags = 0,
+        .pool = VK_NULL_HANDLE,
+        .pUserData = nullptr,
+    };
+
+    for (auto& readback : buffers) {
+        VkBuffer unsafe_buffer{};
+        VmaAllocationInfo alloc_info;
+        VkBufferCreateInfo unsafe_buffer_info = static_cast<VkBufferCreateInfo>(buffer_info);
+        const VkResult result =
+            vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info, &alloc_create_info,
+                            &unsafe_buffer, &readback.allocation, &alloc_info);
+        if (result != VK_SUCCESS) [[unlikely]] {
+            LOG_CRITICAL(Render_Vulkan, "Failed allocating readback buffer with error {}", result);
+            UNREACHABLE();
+        }
+        readback.buffer = vk::Buffer{unsafe_buffer};
+        readback.mapped = static_cast<u8*>(alloc_info.pMappedData);
+        readback.tick = 0;
+    }
+    pending.clear();
+    next_buffer = 0;
+}
+
+void FrameDumper::Release() {
+    if (!frame.image) {
+        return;
+    }
+    scheduler.Finish();
+
+    const vk::Device device = instance.GetDevice();
+    for (auto& readback : buffers) {
+        vmaDestroyBuffer(instance.GetAllocator(), readback.buffer, readback.allocation);
+        readback = {};
+    }
+    vmaDestroyImage(instance.GetAllocator(), frame.image, frame.allocation);
+    device.destroyFramebuffer(frame.framebuffer);
+    device.destroyImageView(frame.image_view);
+    frame = {};
+    pending.clear();
+}
+
+} // namespace Vulkan
@@ -0,0 +1,83 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include "core/frontend/framebuffer_layout.h"
+#include "video_core/renderer_vulkan/vk_present_window.h"
+
+namespace Core {
+class System;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * Downloads the frames drawn for video dumping into a ring of host visible buffers and hands
+ * them to the video dumper once the GPU has finished the copy, so dumping never waits on the
+ * frame that was just submitted.
+ */
+class FrameDumper {
+    static constexpr std::size_t NUM_READBACK_BUFFERS = 3;
+
+public:
+    explicit FrameDumper(Core::System& system, const Instance& instance, Scheduler& scheduler,
+                         PresentWindow& window);
+    ~FrameDumper();
+
+    /// Starts accepting frames, called when the video dumper starts
+    void StartDumping();
+
+    /// Stops accepting frames, pending downloads are dropped
+    void StopDumping();
+
+    /// Returns the layout of the dumped frames
+    [[nodiscard]] Layout::FramebufferLayout GetLayout() const;
+
+    /// Returns the frame the dumped screens are drawn to, or nullptr when not dumping
+    [[nodiscard]] Frame* GetRenderFrame();
+
+    /// Records a download of the frame returned by GetRenderFrame into the next free buffer
+    void CaptureFrame();
+
+    /// Hands the downloads the GPU has completed to the video dumper
+    void ProcessFrames();
+
+private:
+    struct ReadbackBuffer {
+        vk::Buffer buffer;
+        VmaAllocation allocation;
+        u8* mapped;
+        u64 tick;
+    };
+
+    /// Sends the oldest pending download to the video dumper
+    void SendFrame();
+
+    /// Allocates the frame and readback buffers for the current dump layout
+    void Allocate(const Layout::FramebufferLayout& layout);
+
+    /// Frees all resources once the GPU no longer uses them
+    void Release();
+
+private:
+    Core::System& system;
+    const Instance& instance;
+    Scheduler& scheduler;
+    PresentWindow& window;
+    Frame frame{};
+    std::array<ReadbackBuffer, NUM_READBACK_BUFFERS> buffers{};
+    std::deque<u32> pending;
+    u32 next_buffer{};
+    std::mutex mutex;
+    bool is_dumping{};
+};
+
+} // namespace Vulkan
@@ -6,6 +6,7 @@
 
 #include "common/hash.h"
 #include "common/microprofile.h"
+#include "video_core/rasterizer_cache/pixel_format.h"
 #include "video_core/renderer_vulkan/pica_to_vk.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
@@ -15,6 +16,9 @@
 namespace Vulkan {
 
 MICROPROFILE_DEFINE(Vulkan_Pipeline, "Vulkan", "Pipeline Building", MP_RGB(0, 192, 32));
+MICROPROFILE_DEFINE(Vulkan_PipelineLibrary, "Vulkan", "Pipeline Library Building",
+                    MP_RGB(0, 160, 64));
+MICROPROFILE_DEFINE(Vulkan_PipelineLink, "Vulkan", "Pipeline Linking", MP_RGB(0, 128, 96));
 
 vk::ShaderStageFlagBits MakeShaderStage(std::size_t index) {
     switch (index) {
@@ -40,7 +44,16 @@ u64 PipelineInfo::Hash(const Instance& instance) const {
 
     append_hash(vertex_layout);
     append_hash(attachments);
-    append_hash(blending);
+
+    // Leave out whatever state the device lets us set dynamically at draw time.
+    if (!instance.IsExtendedDynamicState3BlendSupported()) {
+        append_hash(blending.blend_enable);
+        append_hash(blending.color_write_mask);
+        append_hash(blending.value);
+    }
+    if (!instance.IsExtendedDynamicState2LogicOpSupported()) {
+        append_hash(blending.logic_op);
+    }
 
     if (!instance.IsExtendedDynamicStateSupported()) {
         append_hash(rasterization);
@@ -50,59 +63,35 @@ u64 PipelineInfo::Hash(const Instance& instance) const {
     return info_hash;
 }
 
-Shader::Shader(const Instance& instance) : device{instance.GetDevice()} {}
-
-Shader::Shader(const Instance& instance, vk::ShaderStageFlagBits stage, std::string code)
-    : Shader{instance} {
-    module = Compile(code, stage, instance.GetDevice());
-    MarkDone();
-}
-
-Shader::~Shader() {
-    if (device && module) {
-        device.destroyShaderModule(module);
-    }
-}
-
-GraphicsPipeline::GraphicsPipeline(const Instance& instance_, RenderpassCache& renderpass_cache_,
-                                   const PipelineInfo& info_, vk::PipelineCache pipeline_cache_,
-                                   vk::PipelineLayout layout_, std::array<Shader*, 3> stages_,
-                                   Common::ThreadWorker* worker_)
-    : instance{instance_}, renderpass_cache{renderpass_cache_}, worker{worker_},
-      pipeline_layout{layout_}, pipeline_cache{pipeline_cache_}, info{info_}, stages{stages_} {}
-
-GraphicsPipeline::~GraphicsPipeline() = default;
+namespace {
 
-bool GraphicsPipeline::TryBuild(bool wait_built) {
-    // The pipeline is currently being compiled. We can either wait for it
-    // or skip the draw.
-    if (is_pending) {
-        return wait_built;
-    }
-
-    // If the shaders haven't been compiled yet, we cannot proceed.
-    const bool shaders_pending = std::any_of(
-        stages.begin(), stages.end(), [](Shader* shader) { return shader && !shader->IsDone(); });
-    if (!wait_built && shaders_pending) {
-        return false;
-    }
-
-    // Ask the driver if it can give us the pipeline quickly.
-    if (!shaders_pending && instance.IsPipelineCreationCacheControlSupported() && Build(true)) {
-        return true;
-    }
-
-    // Fallback to (a)synchronous compilation
-    worker->QueueWork([this] { Build(); });
-    is_pending = true;
-    return wait_built;
-}
-
-bool GraphicsPipeline::Build(bool fail_on_compile_required) {
-    MICROPROFILE_SCOPE(Vulkan_Pipeline);
-    const vk::Device device = instance.GetDevice();
+/// Fixed function state of a graphics pipeline. Shared by full pipelines and pipeline libraries.
+struct PipelineState {
+    explicit PipelineState(const Instance& instance, const PipelineInfo& info);
+    PipelineState(const PipelineState&) = delete;
+    PipelineState& operator=(const PipelineState&) = delete;
 
     std::array<vk::VertexInputBindingDescription, MAX_VERTEX_BINDINGS> bindings;
+    std::array<vk::VertexInputAttributeDescription, MAX_VERTEX_ATTRIBUTES> attributes;
+    vk::PipelineVertexInputStateCreateInfo vertex_input_info;
+    vk::PipelineInputAssemblyStateCreateInfo input_assembly;
+    vk::PipelineRasterizationStateCreateInfo raster_state;
+    vk::PipelineMultisampleStateCreateInfo multisampling;
+    vk::PipelineColorBlendAttachmentState colorblend_attachment;
+    vk::PipelineColorBlendStateCreateInfo color_blending;
+    vk::Viewport viewport;
+    vk::Rect2D scissor;
+    vk::PipelineViewportStateCreateInfo viewport_info;
+    boost::container::static_vector<vk::DynamicState, 20> dynamic_states;
+    vk::PipelineDynamicStateCreateInfo dynamic_info;
+    vk::StencilOpState stencil_op_state;
+    vk::PipelineDepthStencilStateCreateInfo depth_info;
+    vk::Format color_format;
+    vk::Format depth_format;
+    vk::PipelineRenderingCreateInfoKHR rendering_info;
+};
+
+PipelineState::PipelineState(const Instance& instance, const PipelineInfo& info) {
     for (u32 i = 0; i < info.vertex_layout.binding_count; i++) {
         const auto& binding = info.vertex_layout.bindings[i];
         bindings[i] = vk::VertexInputBindingDescription{
@@ -113,7 +102,6 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         };
     }
 
-    std::array<vk::VertexInputAttributeDescription, MAX_VERTEX_ATTRIBUTES> attributes;
     for (u32 i = 0; i < info.vertex_layout.attribute_count; i++) {
         const auto& attr = info.vertex_layout.attributes[i];
         const FormatTraits& traits = instance.GetTraits(attr.type, attr.size);
@@ -132,19 +120,19 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         }
     }
 
-    const vk::PipelineVertexInputStateCreateInfo vertex_input_info = {
+    vertex_input_info = vk::PipelineVertexInputStateCreateInfo{
         .vertexBindingDescriptionCount = info.vertex_layout.binding_count,
         .pVertexBindingDescriptions = bindings.data(),
         .vertexAttributeDescriptionCount = info.vertex_layout.attribute_count,
         .pVertexAttributeDescriptions = attributes.data(),
     };
 
-    const vk::PipelineInputAssemblyStateCreateInfo input_assembly = {
+    input_assembly = vk::PipelineInputAssemblyStateCreateInfo{
         .topology = PicaToVK::PrimitiveTopology(info.rasterization.topology),
         .primitiveRestartEnable = false,
     };
 
-    const vk::PipelineRasterizationStateCreateInfo raster_state = {
+    raster_state = vk::PipelineRasterizationStateCreateInfo{
         .depthClampEnable = false,
         .rasterizerDiscardEnable = false,
         .cullMode = PicaToVK::CullMode(info.rasterization.cull_mode),
@@ -153,12 +141,12 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .lineWidth = 1.0f,
     };
 
-    const vk::PipelineMultisampleStateCreateInfo multisampling = {
+    multisampling = vk::PipelineMultisampleStateCreateInfo{
         .rasterizationSamples = vk::SampleCountFlagBits::e1,
         .sampleShadingEnable = false,
     };
 
-    const vk::PipelineColorBlendAttachmentState colorblend_attachment = {
+    colorblend_attachment = vk::PipelineColorBlendAttachmentState{
         .blendEnable = info.blending.blend_enable,
         .srcColorBlendFactor = PicaToVK::BlendFunc(info.blending.src_color_blend_factor),
         .dstColorBlendFactor = PicaToVK::BlendFunc(info.blending.dst_color_blend_factor),
@@ -169,7 +157,7 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .colorWriteMask = static_cast<vk::ColorComponentFlags>(info.blending.color_write_mask),
     };
 
-    const vk::PipelineColorBlendStateCreateInfo color_blending = {
+    color_blending = vk::PipelineColorBlendStateCreateInfo{
         .logicOpEnable = !info.blending.blend_enable && !instance.NeedsLogicOpEmulation(),
         .logicOp = PicaToVK::LogicOp(info.blending.logic_op),
         .attachmentCount = 1,
@@ -177,7 +165,7 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .blendConstants = std::array{1.0f, 1.0f, 1.0f, 1.0f},
     };
 
-    const vk::Viewport viewport = {
+    viewport = vk::Viewport{
         .x = 0.0f,
         .y = 0.0f,
         .width = 1.0f,
@@ -186,19 +174,19 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .maxDepth = 1.0f,
     };
 
-    const vk::Rect2D scissor = {
+    scissor = vk::Rect2D{
         .offset = {0, 0},
         .extent = {1, 1},
     };
 
-    const vk::PipelineViewportStateCreateInfo viewport_info = {
+    viewport_info = vk::PipelineViewportStateCreateInfo{
         .viewportCount = 1,
         .pViewports = &viewport,
         .scissorCount = 1,
         .pScissors = &scissor,
     };
 
-    boost::container::static_vector<vk::DynamicState, 14> dynamic_states = {
+    dynamic_states = {
         vk::DynamicState::eViewport,           vk::DynamicState::eScissor,
         vk::DynamicState::eStencilCompareMask, vk::DynamicState::eStencilWriteMask,
         vk::DynamicState::eStencilReference,   vk::DynamicState::eBlendConstants,
@@ -214,19 +202,33 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         dynamic_states.insert(dynamic_states.end(), extended.begin(), extended.end());
     }
 
-    const vk::PipelineDynamicStateCreateInfo dynamic_info = {
+    if (instance.IsExtendedDynamicState2LogicOpSupported()) {
+        dynamic_states.push_back(vk::DynamicState::eLogicOpEXT);
+    }
+
+    if (instance.IsExtendedDynamicState3BlendSupported()) {
+        constexpr std::array extended3 = {
+            vk::DynamicState::eColorBlendEnableEXT,
+            vk::DynamicState::eColorBlendEquationEXT,
+            vk::DynamicState::eColorWriteMaskEXT,
+            vk::DynamicState::eLogicOpEnableEXT,
+        };
+        dynamic_states.insert(dynamic_states.end(), extended3.begin(), extended3.end());
+    }
+
+    dynamic_info = vk::PipelineDynamicStateCreateInfo{
         .dynamicStateCount = static_cast<u32>(dynamic_states.size()),
         .pDynamicStates = dynamic_states.data(),
     };
 
-    const vk::StencilOpState stencil_op_state = {
+    stencil_op_state = vk::StencilOpState{
         .failOp = PicaToVK::StencilOp(info.depth_stencil.stencil_fail_op),
         .passOp = PicaToVK::StencilOp(info.depth_stencil.stencil_pass_op),
         .depthFailOp = PicaToVK::StencilOp(info.depth_stencil.stencil_depth_fail_op),
         .compareOp = PicaToVK::CompareFunc(info.depth_stencil.stencil_compare_op),
     };
 
-    const vk::PipelineDepthStencilStateCreateInfo depth_info = {
+    depth_info = vk::PipelineDepthStencilStateCreateInfo{
         .depthTestEnable = static_cast<u32>(info.depth_stencil.depth_test_enable.Value()),
         .depthWriteEnable = static_cast<u32>(info.depth_stencil.depth_write_enable.Value()),
         .depthCompareOp = PicaToVK::CompareFunc(info.depth_stencil.depth_compare_op),
@@ -236,6 +238,267 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .back = stencil_op_state,
     };
 
+    // With dynamic rendering the pipeline only needs the attachment formats, not a render pass.
+    color_format = instance.GetTraits(info.attachments.color).native;
+    depth_format = instance.GetTraits(info.attachments.depth).native;
+    const bool has_stencil =
+        VideoCore::GetFormatType(info.attachments.depth) == VideoCore::SurfaceType::DepthStencil;
+    rendering_info = vk::PipelineRenderingCreateInfoKHR{
+        .colorAttachmentCount = color_format != vk::Format::eUndefined ? 1u : 0u,
+        .pColorAttachmentFormats = &color_format,
+        .depthAttachmentFormat = depth_format,
+        .stencilAttachmentFormat = has_stencil ? depth_format : vk::Format::eUndefined,
+    };
+}
+
+} // Anonymous namespace
+
+Shader::Shader(const Instance& instance) : device{instance.GetDevice()} {}
+
+Shader::Shader(const Instance& instance, vk::ShaderStageFlagBits stage, std::string code)
+    : Shader{instance} {
+    module = Compile(code, stage, instance.GetDevice());
+    MarkDone();
+}
+
+Shader::~Shader() {
+    library.reset();
+    if (device && module) {
+        device.destroyShaderModule(module);
+    }
+}
+
+PipelineLibraries::PipelineLibraries(const Instance& instance_, vk::PipelineLayout layout_)
+    : instance{instance_}, pipeline_layout{layout_} {}
+
+PipelineLibraries::~PipelineLibraries() = default;
+
+void PipelineLibraries::BuildFragmentShader(Shader& shader,
+                                            vk::PipelineCache pipeline_cache) const {
+    const PipelineState state{instance, PipelineInfo{}};
+    const vk::PipelineShaderStageCreateInfo shader_stage = {
+        .stage = vk::ShaderStageFlagBits::eFragment,
+        .module = shader.Handle(),
+        .pName = "main",
+    };
+    shader.library = Build(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader,
+                           vk::GraphicsPipelineCreateInfo{
+                               .stageCount = 1,
+                               .pStages = &shader_stage,
+                               .pMultisampleState = &state.multisampling,
+                               .pDepthStencilState = &state.depth_info,
+                               .pDynamicState = &state.dynamic_info,
+                               .layout = pipeline_layout,
+                           },
+                           pipeline_cache);
+}
+
+vk::Pipeline PipelineLibraries::VertexInput(const PipelineInfo& info,
+                                            vk::PipelineCache pipeline_cache) {
+    const u64 key = Common::ComputeStructHash64(info.vertex_layout);
+    auto [it, new_library] = vertex_input.try_emplace(key);
+    if (new_library) {
+        const PipelineState state{instance, info};
+        it.value() = Build(vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface,
+                           vk::GraphicsPipelineCreateInfo{
+                               .pVertexInputState = &state.vertex_input_info,
+                               .pInputAssemblyState = &state.input_assembly,
+                               .pDynamicState = &state.dynamic_info,
+                           },
+                           pipeline_cache);
+    }
+    return *it->second;
+}
+
+vk::Pipeline PipelineLibraries::PreRasterization(const std::array<Shader*, 3>& stages,
+                                                 vk::PipelineCache pipeline_cache) {
+    Shader* const vertex = stages[0];
+    Shader* const geometry = stages[2];
+    const u64 key = Common::HashCombine(reinterpret_cast<u64>(vertex),
+                                        reinterpret_cast<u64>(geometry));
+    auto [it, new_library] = pre_rasterization.try_emplace(key);
+    if (new_library) {
+        const PipelineState state{instance, PipelineInfo{}};
+        u32 shader_count = 0;
+        std::array<vk::PipelineShaderStageCreateInfo, 2> shader_stages;
+        for (const std::size_t i : {0U, 2U}) {
+            if (!stages[i]) {
+                continue;
+            }
+            shader_stages[shader_count++] = vk::PipelineShaderStageCreateInfo{
+                .stage = MakeShaderStage(i),
+                .module = stages[i]->Handle(),
+                .pName = "main",
+            };
+        }
+        it.value() = Build(vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders,
+                           vk::GraphicsPipelineCreateInfo{
+                               .stageCount = shader_count,
+                               .pStages = shader_stages.data(),
+                               .pViewportState = &state.viewport_info,
+                               .pRasterizationState = &state.raster_state,
+                               .pDynamicState = &state.dynamic_info,
+                               .layout = pipeline_layout,
+                           },
+                           pipeline_cache);
+    }
+    return *it->second;
+}
+
+vk::Pipeline PipelineLibraries::FragmentOutput(const PipelineInfo& info,
+                                               vk::PipelineCache pipeline_cache) {
+    // Only the parts of the blending state that are baked into pipelines distinguish libraries.
+    u64 key = Common::ComputeStructHash64(info.attachments);
+    if (!instance.IsExtendedDynamicState3BlendSupported()) {
+        key = Common::HashCombine(key, Common::ComputeStructHash64(info.blending));
+    } else if (!instance.IsExtendedDynamicState2LogicOpSupported()) {
+        key = Common::HashCombine(key, Common::ComputeStructHash64(info.blending.logic_op));
+    }
+    auto [it, new_library] = fragment_output.try_emplace(key);
+    if (new_library) {
+        const PipelineState state{instance, info};
+        it.value() = Build(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface,
+                           vk::GraphicsPipelineCreateInfo{
+                               .pNext = &state.rendering_info,
+                               .pMultisampleState = &state.multisampling,
+                               .pColorBlendState = &state.color_blending,
+                               .pDynamicState = &state.dynamic_info,
+                           },
+                           pipeline_cache);
+    }
+    return *it->second;
+}
+
+vk::UniquePipeline PipelineLibraries::Build(vk::GraphicsPipelineLibraryFlagsEXT flags,
+                                            vk::GraphicsPipelineCreateInfo pipeline_info,
+                                            vk::PipelineCache pipeline_cache) const {
+    MICROPROFILE_SCOPE(Vulkan_PipelineLibrary);
+    const vk::GraphicsPipelineLibraryCreateInfoEXT library_info = {
+        .pNext = pipeline_info.pNext,
+        .flags = flags,
+    };
+    pipeline_info.pNext = &library_info;
+    pipeline_info.flags |= vk::PipelineCreateFlagBits::eLibraryKHR;
+
+    auto result = instance.GetDevice().createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
+    if (result.result != vk::Result::eSuccess) {
+        UNREACHABLE_MSG("Graphics pipeline library creation failed!");
+    }
+    return std::move(result.value);
+}
+
+GraphicsPipeline::GraphicsPipeline(const Instance& instance_, RenderpassCache& renderpass_cache_,
+                                   const PipelineInfo& info_, vk::PipelineCache pipeline_cache_,
+                                   vk::PipelineLayout layout_, std::array<Shader*, 3> stages_,
+                                   Common::TaskGroup* worker_, PipelineLibraries* libraries_)
+    : instance{instance_}, renderpass_cache{renderpass_cache_}, worker{worker_},
+      libraries{libraries_}, pipeline_layout{layout_}, pipeline_cache{pipeline_cache_},
+      info{info_}, stages{stages_} {}
+
+GraphicsPipeline::~GraphicsPipeline() = default;
+
+void GraphicsPipeline::QueueBuild(Common::TaskPriority priority) {
+    if (is_pending && priority >= queued_priority) {
+        return;
+    }
+    // The copy queued earlier at a less urgent class is skipped when it comes up
+    worker->QueueWork(
+        [this] {
+            if (!build_claimed.exchange(true)) {
+                Build();
+            }
+        },
+        priority);
+    is_pending = true;
+    queued_priority = priority;
+}
+
+bool GraphicsPipeline::TryBuild(bool wait_built) {
+    // Needed by the current draw or likely needed soon.
+    const auto priority =
+        wait_built ? Common::TaskPriority::FrameCritical : Common::TaskPriority::Background;
+
+    // The pipeline is currently being compiled. We can either wait for it
+    // or skip the draw, moving it ahead of the prefetched pipelines meanwhile.
+    if (is_pending) {
+        QueueBuild(priority);
+        return wait_built;
+    }
+
+    // A build is only queued once its shaders are compiled, otherwise it would occupy a worker
+    // waiting for them. A draw that needs the pipeline helps compiling them instead.
+    if (ShadersPending()) {
+        if (!wait_built) {
+            return false;
+        }
+        for (Shader* shader : stages) {
+            if (shader) {
+                shader->WaitDone(Common::ThreadPool::Instance());
+            }
+        }
+    }
+
+    // Ask the driver if it can give us the pipeline quickly.
+    if (instance.IsPipelineCreationCacheControlSupported() && Build(true)) {
+        return true;
+    }
+
+    // Link the precompiled libraries for immediate use and optimize the pipeline in the background.
+    if (Link()) {
+        QueueBuild(Common::TaskPriority::Background);
+        return true;
+    }
+
+    // Fallback to (a)synchronous compilation
+    QueueBuild(priority);
+    return wait_built;
+}
+
+bool GraphicsPipeline::ShadersPending() const {
+    return std::any_of(stages.begin(), stages.end(),
+                       [](Shader* shader) { return shader && !shader->IsDone(); });
+}
+
+bool GraphicsPipeline::Link() {
+    Shader* const fragment = stages[1];
+    if (!libraries || !fragment || !fragment->library) {
+        return false;
+    }
+
+    MICROPROFILE_SCOPE(Vulkan_PipelineLink);
+    const std::array pipeline_libraries = {
+        libraries->VertexInput(info, pipeline_cache),
+        libraries->PreRasterization(stages, pipeline_cache),
+        *fragment->library,
+        libraries->FragmentOutput(info, pipeline_cache),
+    };
+    const vk::PipelineLibraryCreateInfoKHR library_info = {
+        .libraryCount = static_cast<u32>(pipeline_libraries.size()),
+        .pLibraries = pipeline_libraries.data(),
+    };
+    const vk::GraphicsPipelineCreateInfo pipeline_info = {
+        .pNext = &library_info,
+        .layout = pipeline_layout,
+    };
+
+    const vk::Device device = instance.GetDevice();
+    auto result = device.createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
+    if (result.result != vk::Result::eSuccess) {
+        LOG_ERROR(Render_Vulkan, "Failed to link graphics pipeline libraries");
+        return false;
+    }
+
+    linked_pipeline = std::move(result.value);
+    handle.store(static_cast<VkPipeline>(*linked_pipeline), std::memory_order::release);
+    MarkDone();
+    return true;
+}
+
+bool GraphicsPipeline::Build(bool fail_on_compile_required) {
+    MICROPROFILE_SCOPE(Vulkan_Pipeline);
+    const vk::Device device = instance.GetDevice();
+    const PipelineState state{instance, info};
+
     u32 shader_count = 0;
     std::array<vk::PipelineShaderStageCreateInfo, MAX_SHADER_STAGES> shader_stages;
     for (std::size_t i = 0; i < stages.size(); i++) {
@@ -244,7 +507,7 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
             continue;
         }
 
-        shader->WaitDone();
+        shader->WaitDone(Common::ThreadPool::Instance());
         shader_stages[shader_count++] = vk::PipelineShaderStageCreateInfo{
             .stage = MakeShaderStage(i),
             .module = shader->Handle(),
@@ -255,19 +518,24 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
     vk::GraphicsPipelineCreateInfo pipeline_info = {
         .stageCount = shader_count,
         .pStages = shader_stages.data(),
-        .pVertexInputState = &vertex_input_info,
-        .pInputAssemblyState = &input_assembly,
-        .pViewportState = &viewport_info,
-        .pRasterizationState = &raster_state,
-        .pMultisampleState = &multisampling,
-        .pDepthStencilState = &depth_info,
-        .pColorBlendState = &color_blending,
-        .pDynamicState = &dynamic_info,
+        .pVertexInputState = &state.vertex_input_info,
+        .pInputAssemblyState = &state.input_assembly,
+        .pViewportState = &state.viewport_info,
+        .pRasterizationState = &state.raster_state,
+        .pMultisampleState = &state.multisampling,
+        .pDepthStencilState = &state.depth_info,
+        .pColorBlendState = &state.color_blending,
+        .pDynamicState = &state.dynamic_info,
         .layout = pipeline_layout,
-        .renderPass =
-            renderpass_cache.GetRenderpass(info.attachments.color, info.attachments.depth, false),
     };
 
+    if (instance.IsDynamicRenderingSupported()) {
+        pipeline_info.pNext = &state.rendering_info;
+    } else {
+        pipeline_info.renderPass =
+            renderpass_cache.GetRenderpass(info.attachments.color, info.attachments.depth, false);
+    }
+
     if (fail_on_compile_required) {
         pipeline_info.flags |= vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequiredEXT;
     }
@@ -281,6 +549,8 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         UNREACHABLE_MSG("Graphics pipeline creation failed!");
     }
 
+    // A linked pipeline that is already in use stays alive until this one is destroyed.
+    handle.store(static_cast<VkPipeline>(*pipeline), std::memory_order::release);
     MarkDone();
     return true;
 }
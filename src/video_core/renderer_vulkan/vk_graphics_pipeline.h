@@ -2,7 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include "common/thread_worker.h"
+#include <tsl/robin_map.h>
+
+#include "common/hash.h"
+#include "common/thread_pool.h"
 #include "video_core/pica/regs_pipeline.h"
 #include "video_core/pica/regs_rasterizer.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
@@ -23,6 +26,21 @@ public:
         condvar.wait(lock, [this] { return is_done.load(std::memory_order::relaxed); });
     }
 
+    /**
+     * Waits for the completion of a task queued to the pool, running its other queued tasks
+     * meanwhile. Workers of the pool must wait this way, as with work stealing the task may still
+     * be queued behind the waiting one.
+     */
+    void WaitDone(ThreadPool& pool) noexcept {
+        while (!IsDone()) {
+            // With nothing left to run, the awaited task is already running on another thread
+            if (!pool.RunPendingTask(TaskPriority::Prefetch)) {
+                WaitDone();
+                return;
+            }
+        }
+    }
+
     void MarkDone(bool done = true) noexcept {
         std::scoped_lock lock{mutex};
         is_done = done;
@@ -161,6 +179,45 @@ struct Shader : public Common::AsyncHandle {
     vk::ShaderModule module;
     vk::Device device;
     std::string program;
+    vk::UniquePipeline library;
+};
+
+/**
+ * Caches the VK_EXT_graphics_pipeline_library parts that graphics pipelines are linked from.
+ * Fragment shader libraries belong to their shader and are built on the workers right after its
+ * module, the remaining parts only depend on a few bits of state and are built on first use.
+ * With dynamic rendering and extended dynamic state none of them needs the attachments or the
+ * depth and rasterization state, except for the fragment output interface.
+ */
+class PipelineLibraries {
+public:
+    explicit PipelineLibraries(const Instance& instance, vk::PipelineLayout layout);
+    ~PipelineLibraries();
+
+    /// Builds the fragment shader library of a compiled fragment shader
+    void BuildFragmentShader(Shader& shader, vk::PipelineCache pipeline_cache) const;
+
+    /// Returns the vertex input interface library for the vertex layout of info
+    vk::Pipeline VertexInput(const PipelineInfo& info, vk::PipelineCache pipeline_cache);
+
+    /// Returns the pre-rasterization library for the vertex and geometry stages
+    vk::Pipeline PreRasterization(const std::array<Shader*, 3>& stages,
+                                  vk::PipelineCache pipeline_cache);
+
+    /// Returns the fragment output interface library for the attachments and blending of info
+    vk::Pipeline FragmentOutput(const PipelineInfo& info, vk::PipelineCache pipeline_cache);
+
+private:
+    vk::UniquePipeline Build(vk::GraphicsPipelineLibraryFlagsEXT flags,
+                             vk::GraphicsPipelineCreateInfo pipeline_info,
+                             vk::PipelineCache pipeline_cache) const;
+
+private:
+    const Instance& instance;
+    vk::PipelineLayout pipeline_layout;
+    tsl::robin_map<u64, vk::UniquePipeline, Common::IdentityHash<u64>> vertex_input;
+    tsl::robin_map<u64, vk::UniquePipeline, Common::IdentityHash<u64>> pre_rasterization;
+    tsl::robin_map<u64, vk::UniquePipeline, Common::IdentityHash<u64>> fragment_output;
 };
 
 class GraphicsPipeline : public Common::AsyncHandle {
@@ -168,29 +225,52 @@ public:
     explicit GraphicsPipeline(const Instance& instance, RenderpassCache& renderpass_cache,
                               const PipelineInfo& info, vk::PipelineCache pipeline_cache,
                               vk::PipelineLayout layout, std::array<Shader*, 3> stages,
-                              Common::ThreadWorker* worker);
+                              Common::TaskGroup* worker,
+                              PipelineLibraries* libraries = nullptr);
     ~GraphicsPipeline();
 
     bool TryBuild(bool wait_built);
 
     bool Build(bool fail_on_compile_required = false);
 
+    /// Queues the compilation of the pipeline on the worker, binding it waits for it to finish
+    void QueueBuild(Common::TaskPriority priority);
+
+    /// Returns true when the compilation of the pipeline is queued or running
+    [[nodiscard]] bool IsPending() const noexcept {
+        return is_pending;
+    }
+
     [[nodiscard]] vk::Pipeline Handle() const noexcept {
-        return *pipeline;
+        return vk::Pipeline{handle.load(std::memory_order::acquire)};
     }
 
+private:
+    /// Fast links the pipeline from precompiled libraries, returns false when they are missing
+    bool Link();
+
+    /// Returns true when one of the shader stages is still compiling
+    bool ShadersPending() const;
+
 private:
     const Instance& instance;
     RenderpassCache& renderpass_cache;
-    Common::ThreadWorker* worker;
+    Common::TaskGroup* worker;
+    PipelineLibraries* libraries;
 
     vk::UniquePipeline pipeline;
+    vk::UniquePipeline linked_pipeline;
+    std::atomic<VkPipeline> handle{};
     vk::PipelineLayout pipeline_layout;
     vk::PipelineCache pipeline_cache;
 
     PipelineInfo info;
     std::array<Shader*, 3> stages;
     bool is_pending{};
+    /// Most urgent class the compilation was queued at, requeued when it is needed sooner
+    Common::TaskPriority queued_priority{};
+    /// Set by the first queued compilation to run, the copies queued after it are skipped
+    std::atomic_bool build_claimed{};
 };
 
 } // namespace Vulkan
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
 #include <span>
 #include <boost/container/static_vector.hpp>
 
@@ -400,11 +401,14 @@ bool Instance::CreateDevice() {
         vk::PhysicalDeviceCustomBorderColorFeaturesEXT, vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
         vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT,
         vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT,
-        vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR>();
+        vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR,
+        vk::PhysicalDeviceDynamicRenderingFeaturesKHR,
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
     const vk::StructureChain properties_chain =
         physical_device.getProperties2<vk::PhysicalDeviceProperties2,
                                        vk::PhysicalDevicePortabilitySubsetPropertiesKHR,
-                                       vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>();
+                                       vk::PhysicalDeviceExternalMemoryHostPropertiesEXT,
+                                       vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>();
 
     features = feature_chain.get().features;
     if (available_extensions.empty()) {
@@ -412,7 +416,7 @@ bool Instance::CreateDevice() {
         return false;
     }
 
-    boost::container::static_vector<const char*, 13> enabled_extensions;
+    boost::container::static_vector<const char*, 25> enabled_extensions;
     const auto add_extension = [&](std::string_view extension, bool blacklist = false,
                                    std::string_view reason = "") -> bool {
         const auto result =
@@ -444,6 +448,9 @@ bool Instance::CreateDevice() {
     shader_stencil_export = add_extension(VK_EXT_SHADER_STENCIL_EXPORT_EXTENSION_NAME);
     external_memory_host = add_extension(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
     tooling_info = add_extension(VK_EXT_TOOLING_INFO_EXTENSION_NAME);
+    display_timing = add_extension(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME);
+    push_descriptor = add_extension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    memory_budget = add_extension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
     const bool has_timeline_semaphores =
         add_extension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, is_qualcomm || is_turnip,
                       "it is broken on Qualcomm drivers");
@@ -451,6 +458,12 @@ bool Instance::CreateDevice() {
     const bool has_extended_dynamic_state =
         add_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME, is_arm || is_qualcomm,
                       "it is broken on Qualcomm and ARM drivers");
+    const bool has_extended_dynamic_state2 =
+        add_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME, is_arm || is_qualcomm,
+                      "it is broken on Qualcomm and ARM drivers");
+    const bool has_extended_dynamic_state3 =
+        add_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, is_arm || is_qualcomm,
+                      "it is broken on Qualcomm and ARM drivers");
     const bool has_custom_border_color =
         add_extension(VK_EXT_CUSTOM_BORDER_COLOR_EXTENSION_NAME, is_qualcomm,
                       "it is broken on most Qualcomm driver versions");
@@ -464,6 +477,21 @@ bool Instance::CreateDevice() {
     const bool has_fragment_shader_barycentric =
         add_extension(VK_KHR_FRAGMENT_SHADER_BARYCENTRIC_EXTENSION_NAME, is_moltenvk,
                       "the PerVertexKHR attribute is not supported by MoltenVK");
+    const bool has_dynamic_rendering =
+        add_extension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+                      properties.apiVersion < VK_API_VERSION_1_2,
+                      "its dependencies are only core from Vulkan 1.2");
+
+    // Libraries are only linked with dynamic rendering and dynamic depth/rasterization state,
+    // which keeps the number of distinct libraries small.
+    const bool fast_linking =
+        properties_chain.get<vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>()
+            .graphicsPipelineLibraryFastLinking;
+    const bool has_graphics_pipeline_library =
+        add_extension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+                      !fast_linking || !has_dynamic_rendering || !has_extended_dynamic_state,
+                      "it requires fast linking, dynamic rendering and extended dynamic state") &&
+        add_extension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
 
     const auto family_properties = physical_device.getQueueFamilyProperties();
     if (family_properties.empty()) {
@@ -485,18 +513,44 @@ bool Instance::CreateDevice() {
         return false;
     }
 
+    // Prefer a family that only does transfers, those usually map to the copy engines. Any
+    // granularity allows copying whole mip levels, which is all the transfer queue is used for.
+    const auto is_transfer_family = [&](u32 index, bool allow_compute) {
+        const auto flags = family_properties[index].queueFlags;
+        return index != queue_family_index && (flags & vk::QueueFlagBits::eTransfer) &&
+               !(flags & vk::QueueFlagBits::eGraphics) &&
+               (allow_compute || !(flags & vk::QueueFlagBits::eCompute));
+    };
+    for (const bool allow_compute : {false, true}) {
+        for (u32 i = 0; i < family_properties.size(); i++) {
+            if (transfer_queue_family_index == VK_QUEUE_FAMILY_IGNORED &&
+                is_transfer_family(i, allow_compute)) {
+                transfer_queue_family_index = i;
+            }
+        }
+    }
+
     static constexpr std::array<f32, 1> queue_priorities = {1.0f};
 
-    const vk::DeviceQueueCreateInfo queue_info = {
+    u32 num_queue_infos = 1;
+    std::array<vk::DeviceQueueCreateInfo, 2> queue_infos;
+    queue_infos[0] = vk::DeviceQueueCreateInfo{
         .queueFamilyIndex = queue_family_index,
         .queueCount = static_cast<u32>(queue_priorities.size()),
         .pQueuePriorities = queue_priorities.data(),
     };
+    if (transfer_queue_family_index != VK_QUEUE_FAMILY_IGNORED) {
+        queue_infos[num_queue_infos++] = vk::DeviceQueueCreateInfo{
+            .queueFamilyIndex = transfer_queue_family_index,
+            .queueCount = static_cast<u32>(queue_priorities.size()),
+            .pQueuePriorities = queue_priorities.data(),
+        };
+    }
 
     vk::StructureChain device_chain = {
         vk::DeviceCreateInfo{
-            .queueCreateInfoCount = 1u,
-            .pQueueCreateInfos = &queue_info,
+            .queueCreateInfoCount = num_queue_infos,
+            .pQueueCreateInfos = queue_infos.data(),
             .enabledExtensionCount = static_cast<u32>(enabled_extensions.size()),
             .ppEnabledExtensionNames = enabled_extensions.data(),
         },
@@ -520,6 +574,8 @@ bool Instance::CreateDevice() {
         vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT{},
         vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT{},
         vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR{},
+        vk::PhysicalDeviceDynamicRenderingFeaturesKHR{},
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT{},
     };
 
 #define PROP_GET(structName, prop, property) property = properties_chain.get<structName>().prop;
@@ -571,6 +627,29 @@ bool Instance::CreateDevice() {
         device_chain.unlink<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
     }
 
+    if (has_extended_dynamic_state2) {
+        FEAT_SET(vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT,
+                 extendedDynamicState2LogicOp, extended_dynamic_state2_logic_op)
+    } else {
+        device_chain.unlink<vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT>();
+    }
+
+    if (has_extended_dynamic_state3) {
+        bool color_blend_enable{}, color_blend_equation{}, color_write_mask{}, logic_op_enable{};
+        FEAT_SET(vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT,
+                 extendedDynamicState3ColorBlendEnable, color_blend_enable)
+        FEAT_SET(vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT,
+                 extendedDynamicState3ColorBlendEquation, color_blend_equation)
+        FEAT_SET(vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT,
+                 extendedDynamicState3ColorWriteMask, color_write_mask)
+        FEAT_SET(vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT,
+                 extendedDynamicState3LogicOpEnable, logic_op_enable)
+        extended_dynamic_state3_blend =
+            color_blend_enable && color_blend_equation && color_write_mask && logic_op_enable;
+    } else {
+        device_chain.unlink<vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>();
+    }
+
     if (has_custom_border_color) {
         FEAT_SET(vk::PhysicalDeviceCustomBorderColorFeaturesEXT, customBorderColors,
                  custom_border_color)
@@ -599,6 +678,20 @@ bool Instance::CreateDevice() {
         device_chain.unlink<vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR>();
     }
 
+    if (has_dynamic_rendering) {
+        FEAT_SET(vk::PhysicalDeviceDynamicRenderingFeaturesKHR, dynamicRendering,
+                 dynamic_rendering)
+    } else {
+        device_chain.unlink<vk::PhysicalDeviceDynamicRenderingFeaturesKHR>();
+    }
+
+    if (has_graphics_pipeline_library && dynamic_rendering && extended_dynamic_state) {
+        FEAT_SET(vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT, graphicsPipelineLibrary,
+                 graphics_pipeline_library)
+    } else {
+        device_chain.unlink<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+    }
+
 #undef PROP_GET
 #undef FEAT_SET
 
@@ -613,6 +706,9 @@ bool Instance::CreateDevice() {
 
     graphics_queue = device->getQueue(queue_family_index, 0);
     present_queue = device->getQueue(queue_family_index, 0);
+    if (transfer_queue_family_index != VK_QUEUE_FAMILY_IGNORED) {
+        transfer_queue = device->getQueue(transfer_queue_family_index, 0);
+    }
 
     CreateAllocator();
     return true;
@@ -625,6 +721,7 @@ void Instance::CreateAllocator() {
     };
 
     const VmaAllocatorCreateInfo allocator_info = {
+        .flags = memory_budget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u,
         .physicalDevice = physical_device,
         .device = *device,
         .pVulkanFunctions = &functions,
@@ -638,6 +735,35 @@ void Instance::CreateAllocator() {
     }
 }
 
+u64 Instance::GetDeviceLocalBudget() const {
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    // Without VK_EXT_memory_budget VMA estimates the budget as a fraction of the heap size.
+    const auto memory_properties = physical_device.getMemoryProperties();
+    u64 budget = 0;
+    for (u32 i = 0; i < memory_properties.memoryHeapCount; i++) {
+        if (memory_properties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+            budget += budgets[i].budget;
+        }
+    }
+    return budget;
+}
+
+u64 Instance::GetDeviceLocalUsage() const {
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    const auto memory_properties = physical_device.getMemoryProperties();
+    u64 usage = 0;
+    for (u32 i = 0; i < memory_properties.memoryHeapCount; i++) {
+        if (memory_properties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+            usage += budgets[i].usage;
+        }
+    }
+    return usage;
+}
+
 void Instance::CollectTelemetryParameters(Core::TelemetrySession& telemetry) {
     const vk::StructureChain property_chain =
         physical_device
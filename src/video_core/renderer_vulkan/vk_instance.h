@@ -98,6 +98,19 @@ public:
         return present_queue;
     }
 
+    /// Returns true when the device exposes a transfer queue family separate from graphics
+    bool HasDedicatedTransferQueue() const {
+        return static_cast<bool>(transfer_queue);
+    }
+
+    u32 GetTransferQueueFamilyIndex() const {
+        return transfer_queue_family_index;
+    }
+
+    vk::Queue GetTransferQueue() const {
+        return transfer_queue;
+    }
+
     /// Returns true when a known debugging tool is attached.
     bool HasDebuggingToolAttached() const {
         return has_renderdoc || has_nsight_graphics;
@@ -138,6 +151,16 @@ public:
         return extended_dynamic_state;
     }
 
+    /// Returns true when VK_EXT_extended_dynamic_state2 with dynamic logic ops is supported
+    bool IsExtendedDynamicState2LogicOpSupported() const {
+        return extended_dynamic_state2_logic_op;
+    }
+
+    /// Returns true when VK_EXT_extended_dynamic_state3 can make all color blend state dynamic
+    bool IsExtendedDynamicState3BlendSupported() const {
+        return extended_dynamic_state3_blend;
+    }
+
     /// Returns true when VK_EXT_custom_border_color is supported
     bool IsCustomBorderColorSupported() const {
         return custom_border_color;
@@ -178,6 +201,37 @@ public:
         return fragment_shader_barycentric;
     }
 
+    /// Returns true when VK_GOOGLE_display_timing is supported
+    bool IsDisplayTimingSupported() const {
+        return display_timing;
+    }
+
+    /// Returns true when VK_KHR_push_descriptor is supported
+    bool IsPushDescriptorSupported() const {
+        return push_descriptor;
+    }
+
+    /// Returns true when VK_KHR_dynamic_rendering is supported
+    bool IsDynamicRenderingSupported() const {
+        return dynamic_rendering;
+    }
+
+    /// Returns true when VK_EXT_graphics_pipeline_library is supported with fast linking
+    bool IsGraphicsPipelineLibrarySupported() const {
+        return graphics_pipeline_library;
+    }
+
+    /// Returns true when VK_EXT_memory_budget is supported
+    bool IsMemoryBudgetSupported() const {
+        return memory_budget;
+    }
+
+    /// Returns the memory budget in bytes of all device local heaps
+    u64 GetDeviceLocalBudget() const;
+
+    /// Returns the memory in bytes currently used by the application in all device local heaps
+    u64 GetDeviceLocalUsage() const;
+
     /// Returns the vendor ID of the physical device
     u32 GetVendorID() const {
         return properties.vendorID;
@@ -228,6 +282,11 @@ public:
         return properties.limits.minUniformBufferOffsetAlignment;
     }
 
+    /// Returns the minimum required alignment for storage buffers
+    vk::DeviceSize StorageMinAlignment() const {
+        return properties.limits.minStorageBufferOffsetAlignment;
+    }
+
     /// Returns the minimum alignemt required for accessing host-mapped device memory
     vk::DeviceSize NonCoherentAtomSize() const {
         return properties.limits.nonCoherentAtomSize;
@@ -238,6 +297,16 @@ public:
         return properties.limits.maxTexelBufferElements;
     }
 
+    /// Returns true if timestamps can be written on the graphics queue
+    bool IsTimestampQuerySupported() const {
+        return properties.limits.timestampComputeAndGraphics;
+    }
+
+    /// Returns the number of nanoseconds a timestamp query value increments by
+    float TimestampPeriod() const {
+        return properties.limits.timestampPeriod;
+    }
+
     /// Returns true if shaders can declare the ClipDistance attribute
     bool IsShaderClipDistanceSupported() const {
         return features.shaderClipDistance;
@@ -302,6 +371,7 @@ private:
     VmaAllocator allocator{};
     vk::Queue present_queue;
     vk::Queue graphics_queue;
+    vk::Queue transfer_queue;
     std::vector<vk::PhysicalDevice> physical_devices;
     FormatTraits null_traits;
     std::array<FormatTraits, VideoCore::PIXEL_FORMAT_COUNT> format_table;
@@ -309,11 +379,14 @@ private:
     std::array<FormatTraits, 16> attrib_table;
     std::vector<std::string> available_extensions;
     u32 queue_family_index{0};
+    u32 transfer_queue_family_index{VK_QUEUE_FAMILY_IGNORED};
     bool triangle_fan_supported{true};
     bool image_view_reinterpretation{true};
     u32 min_vertex_stride_alignment{1};
     bool timeline_semaphores{};
     bool extended_dynamic_state{};
+    bool extended_dynamic_state2_logic_op{};
+    bool extended_dynamic_state3_blend{};
     bool custom_border_color{};
     bool index_type_uint8{};
     bool fragment_shader_interlock{};
@@ -324,6 +397,11 @@ private:
     bool external_memory_host{};
     u64 min_imported_host_pointer_alignment{};
     bool tooling_info{};
+    bool display_timing{};
+    bool push_descriptor{};
+    bool dynamic_rendering{};
+    bool graphics_pipeline_library{};
+    bool memory_budget{};
     bool debug_utils_supported{};
     bool has_nsight_graphics{};
     bool has_renderdoc{};
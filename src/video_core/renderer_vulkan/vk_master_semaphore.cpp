@@ -3,6 +3,7 @@
 
 #include <limits>
 #include <mutex>
+#include "common/assert.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_master_semaphore.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
@@ -62,21 +63,30 @@ void MasterSemaphoreTimeline::Wait(u64 tick) {
 }
 
 void MasterSemaphoreTimeline::SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait,
-                                         vk::Semaphore signal, u64 signal_value) {
+                                         vk::Semaphore signal, u64 signal_value,
+                                         TimelineWait timeline_wait) {
     cmdbuf.end();
 
     const u32 num_signal_semaphores = signal ? 2U : 1U;
     const std::array signal_values{signal_value, u64(0)};
     const std::array signal_semaphores{Handle(), signal};
 
-    const u32 num_wait_semaphores = wait ? 2U : 1U;
-    const std::array wait_values{signal_value - 1, u64(1)};
-    const std::array wait_semaphores{Handle(), wait};
-
-    static constexpr std::array<vk::PipelineStageFlags, 2> wait_stage_masks = {
-        vk::PipelineStageFlagBits::eAllCommands,
-        vk::PipelineStageFlagBits::eColorAttachmentOutput,
-    };
+    u32 num_wait_semaphores = 1;
+    std::array<u64, 3> wait_values{signal_value - 1};
+    std::array<vk::Semaphore, 3> wait_semaphores{Handle()};
+    std::array<vk::PipelineStageFlags, 3> wait_stage_masks{
+        vk::PipelineStageFlagBits::eAllCommands};
+    if (wait) {
+        wait_values[num_wait_semaphores] = 1;
+        wait_semaphores[num_wait_semaphores] = wait;
+        wait_stage_masks[num_wait_semaphores++] =
+            vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    }
+    if (timeline_wait.semaphore) {
+        wait_values[num_wait_semaphores] = timeline_wait.value;
+        wait_semaphores[num_wait_semaphores] = timeline_wait.semaphore;
+        wait_stage_masks[num_wait_semaphores++] = vk::PipelineStageFlagBits::eAllCommands;
+    }
 
     const vk::TimelineSemaphoreSubmitInfoKHR timeline_si = {
         .waitSemaphoreValueCount = num_wait_semaphores,
@@ -129,7 +139,9 @@ void MasterSemaphoreFence::Wait(u64 tick) {
 }
 
 void MasterSemaphoreFence::SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait,
-                                      vk::Semaphore signal, u64 signal_value) {
+                                      vk::Semaphore signal, u64 signal_value,
+                                      TimelineWait timeline_wait) {
+    ASSERT_MSG(!timeline_wait.semaphore, "Timeline waits require timeline semaphores");
     cmdbuf.end();
 
     const u32 num_signal_semaphores = signal ? 1U : 0U;
@@ -15,6 +15,12 @@ namespace Vulkan {
 class Instance;
 class Scheduler;
 
+/// A timeline semaphore value that has to be reached before a submission executes
+struct TimelineWait {
+    vk::Semaphore semaphore;
+    u64 value;
+};
+
 class MasterSemaphore {
 public:
     virtual ~MasterSemaphore() = default;
@@ -43,7 +49,7 @@ public:
 
     /// Submits the provided command buffer for execution
     virtual void SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait, vk::Semaphore signal,
-                            u64 signal_value) = 0;
+                            u64 signal_value, TimelineWait timeline_wait) = 0;
 
 protected:
     std::atomic<u64> gpu_tick{0};     ///< Current known GPU tick.
@@ -64,7 +70,7 @@ public:
     void Wait(u64 tick) override;
 
     void SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait, vk::Semaphore signal,
-                    u64 signal_value) override;
+                    u64 signal_value, TimelineWait timeline_wait) override;
 
 private:
     const Instance& instance;
@@ -81,7 +87,7 @@ public:
     void Wait(u64 tick) override;
 
     void SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait, vk::Semaphore signal,
-                    u64 signal_value) override;
+                    u64 signal_value, TimelineWait timeline_wait) override;
 
 private:
     void WaitThread(std::stop_token token);
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
+#include <thread>
 #include <boost/container/static_vector.hpp>
 
 #include "common/common_paths.h"
@@ -10,6 +12,9 @@
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/settings.h"
+#include "core/core.h"
+#include "core/loader/loader.h"
+#include "video_core/pica/shader_setup.h"
 #include "video_core/renderer_vulkan/pica_to_vk.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
@@ -17,8 +22,10 @@
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/renderer_vulkan/vk_shader_util.h"
 #include "video_core/shader/generator/glsl_fs_shader_gen.h"
+#include "video_core/shader/generator/glsl_fs_ubershader_gen.h"
 #include "video_core/shader/generator/glsl_shader_gen.h"
 #include "video_core/shader/generator/spv_fs_shader_gen.h"
+#include "video_core/video_core.h"
 
 using namespace Pica::Shader::Generator;
 using Pica::Shader::FSConfig;
@@ -27,6 +34,25 @@ MICROPROFILE_DEFINE(Vulkan_Bind, "Vulkan", "Pipeline Bind", MP_RGB(192, 32, 32))
 
 namespace Vulkan {
 
+enum class TransferableEntryKind : u32 {
+    VertexShader,
+    GeometryShader,
+    FragmentShader,
+    Pipeline,
+};
+
+constexpr u32 TransferableVersion = 1;
+
+/// Written together with GLSL_COMPILER_VERSION at the start of the SPIR-V cache file.
+constexpr u32 SpirvCacheVersion = 1;
+
+/// Takes the place of the fragment shader hash in the key of ubershader pipelines.
+constexpr u64 UberShaderHash = ~0ULL;
+
+/// Pipeline compilations draws may queue each frame when the ubershader can draw in their place,
+/// the ones past it are queued on the following frames.
+constexpr u32 MaxPipelineCompilesPerFrame = 16;
+
 u32 AttribBytes(Pica::PipelineRegs::VertexAttributeFormat format, u32 size) {
     switch (format) {
     case Pica::PipelineRegs::VertexAttributeFormat::FLOAT:
@@ -52,7 +78,7 @@ AttribLoadFlags MakeAttribLoadFlag(Pica::PipelineRegs::VertexAttributeFormat for
     }
 }
 
-constexpr std::array<vk::DescriptorSetLayoutBinding, 6> BUFFER_BINDINGS = {{
+constexpr std::array<vk::DescriptorSetLayoutBinding, 7> BUFFER_BINDINGS = {{
     {0, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex},
     {1, vk::DescriptorType::eUniformBufferDynamic, 1,
      vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eGeometry},
@@ -60,6 +86,8 @@ constexpr std::array<vk::DescriptorSetLayoutBinding, 6> BUFFER_BINDINGS = {{
     {3, vk::DescriptorType::eUniformTexelBuffer, 1, vk::ShaderStageFlagBits::eFragment},
     {4, vk::DescriptorType::eUniformTexelBuffer, 1, vk::ShaderStageFlagBits::eFragment},
     {5, vk::DescriptorType::eUniformTexelBuffer, 1, vk::ShaderStageFlagBits::eFragment},
+    {FS_CONFIG_BINDING, vk::DescriptorType::eUniformBufferDynamic, 1,
+     vk::ShaderStageFlagBits::eFragment},
 }};
 
 constexpr std::array<vk::DescriptorSetLayoutBinding, 3> TEXTURE_BINDINGS = {{
@@ -79,17 +107,20 @@ constexpr std::array<vk::DescriptorSetLayoutBinding, 7> SHADOW_BINDINGS = {{
     {6, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eFragment},
 }};
 
-PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
-                             RenderpassCache& renderpass_cache_, DescriptorPool& pool_)
-    : instance{instance_}, scheduler{scheduler_}, renderpass_cache{renderpass_cache_}, pool{pool_},
-      num_worker_threads{std::max(std::thread::hardware_concurrency(), 2U)},
-      workers{num_worker_threads, "Pipeline workers"},
+PipelineCache::PipelineCache(Core::System& system_, const Instance& instance_,
+                             Scheduler& scheduler_, RenderpassCache& renderpass_cache_,
+                             DescriptorPool& pool_)
+    : system{system_}, instance{instance_}, scheduler{scheduler_},
+      renderpass_cache{renderpass_cache_}, pool{pool_},
+      workers{Common::TaskPriority::Background},
       descriptor_set_providers{DescriptorSetProvider{instance, pool, BUFFER_BINDINGS},
-                               DescriptorSetProvider{instance, pool, TEXTURE_BINDINGS},
+                               DescriptorSetProvider{instance, pool, TEXTURE_BINDINGS,
+                                                     instance.IsPushDescriptorSupported()},
                                DescriptorSetProvider{instance, pool, SHADOW_BINDINGS}},
       trivial_vertex_shader{
           instance, vk::ShaderStageFlagBits::eVertex,
-          GLSL::GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported(), true)} {
+          GLSL::GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported(), true)},
+      ubershader{instance}, use_ubershader{Settings::values.ubershader_fallback.GetValue()} {
     profile = Pica::Shader::Profile{
         .has_separable_shaders = true,
         .has_clip_planes = instance.IsShaderClipDistanceSupported(),
@@ -103,6 +134,23 @@ PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
         .is_vulkan = true,
     };
     BuildLayout();
+
+    if (instance.IsGraphicsPipelineLibrarySupported()) {
+        libraries = std::make_unique<PipelineLibraries>(instance, *pipeline_layout);
+    }
+
+    if (use_ubershader) {
+        workers.QueueWork([this] {
+            const std::string code = GLSL::GenerateFragmentUberShader(profile, FS_CONFIG_BINDING);
+            ubershader.module =
+                Compile(code, vk::ShaderStageFlagBits::eFragment, instance.GetDevice());
+            if (libraries) {
+                // The pipeline cache is created later when loading the disk cache.
+                libraries->BuildFragmentShader(ubershader, {});
+            }
+            ubershader.MarkDone();
+        });
+    }
 }
 
 void PipelineCache::BuildLayout() {
@@ -118,17 +166,30 @@ void PipelineCache::BuildLayout() {
         .pPushConstantRanges = nullptr,
     };
     pipeline_layout = instance.GetDevice().createPipelineLayoutUnique(layout_info);
+
+    for (u32 i = 0; i < NUM_RASTERIZER_SETS; i++) {
+        if (descriptor_set_providers[i].IsPushDescriptor()) {
+            descriptor_set_providers[i].BuildPushTemplate(*pipeline_layout, i);
+        }
+    }
 }
 
 PipelineCache::~PipelineCache() {
     SaveDiskCache();
 }
 
-void PipelineCache::LoadDiskCache() {
+void PipelineCache::LoadDiskCache(const std::atomic_bool& stop_loading,
+                                  const VideoCore::DiskResourceLoadCallback& callback) {
     if (!Settings::values.use_disk_shader_cache || !EnsureDirectories()) {
         return;
     }
 
+    // Declared first so it runs after the pipeline cache below has been created.
+    SCOPE_EXIT({
+        LoadTransferable(stop_loading, callback);
+        OpenTransferable();
+    });
+
     const auto cache_dir = GetPipelineCacheDir();
     const u32 vendor_id = instance.GetVendorID();
     const u32 device_id = instance.GetDeviceID();
@@ -136,6 +197,7 @@ void PipelineCache::LoadDiskCache() {
 
     vk::PipelineCacheCreateInfo cache_info{};
     std::vector<u8> cache_data;
+    Common::MappedFile cache_mapping;
 
     SCOPE_EXIT({
         const vk::Device device = instance.GetDevice();
@@ -148,23 +210,39 @@ void PipelineCache::LoadDiskCache() {
         return;
     }
 
-    const u64 cache_file_size = cache_file.GetSize();
-    cache_data.resize(cache_file_size);
-    if (cache_file.ReadBytes(cache_data.data(), cache_file_size) != cache_file_size) {
+    const std::span<const u8> cache = ReadPipelineCacheFile(cache_file, cache_mapping, cache_data);
+    if (cache.empty()) {
         LOG_ERROR(Render_Vulkan, "Error during pipeline cache read");
         return;
     }
 
-    if (!IsCacheValid(cache_data)) {
+    if (!IsCacheValid(cache)) {
         LOG_WARNING(Render_Vulkan, "Pipeline cache provided invalid, removing");
         cache_file.Close();
         FileUtil::Delete(cache_file_path);
         return;
     }
 
-    LOG_INFO(Render_Vulkan, "Loading pipeline cache with size {} KB", cache_file_size / 1024);
-    cache_info.initialDataSize = cache_file_size;
-    cache_info.pInitialData = cache_data.data();
+    LOG_INFO(Render_Vulkan, "Loading pipeline cache with size {} KB", cache.size() / 1024);
+    cache_info.initialDataSize = cache.size();
+    cache_info.pInitialData = cache.data();
+}
+
+std::span<const u8> PipelineCache::ReadPipelineCacheFile(FileUtil::IOFile& file,
+                                                         Common::MappedFile& mapping,
+                                                         std::vector<u8>& buffer) {
+    // The file is only ever replaced as a whole, and a mapping shares the pages with the other
+    // processes reading it instead of keeping a copy of its own
+    const u64 file_size = file.GetSize();
+    mapping = Common::MappedFile(file, 0, file_size);
+    if (mapping.IsValid()) {
+        return mapping.Data();
+    }
+    buffer.resize(file_size);
+    if (file.ReadAtBytes(buffer.data(), buffer.size(), 0) != buffer.size()) {
+        return {};
+    }
+    return buffer;
 }
 
 void PipelineCache::SaveDiskCache() {
@@ -177,17 +255,44 @@ void PipelineCache::SaveDiskCache() {
     const u32 device_id = instance.GetDeviceID();
     const auto cache_file_path = fmt::format("{}{:x}{:x}.bin", cache_dir, vendor_id, device_id);
 
-    FileUtil::IOFile cache_file{cache_file_path, "wb"};
-    if (!cache_file.IsOpen()) {
-        LOG_ERROR(Render_Vulkan, "Unable to open pipeline cache for writing");
-        return;
-    }
+    // Processes sharing the cache save one at a time, each merging in what the others saved
+    FileUtil::IOFile lock_file{cache_file_path + ".lock", "ab"};
+    FileUtil::ScopedFileLock lock{lock_file, true};
 
     const vk::Device device = instance.GetDevice();
-    const auto cache_data = device.getPipelineCacheData(*pipeline_cache);
-    if (cache_file.WriteBytes(cache_data.data(), cache_data.size()) != cache_data.size()) {
-        LOG_ERROR(Render_Vulkan, "Error during pipeline cache write");
-        return;
+    if (FileUtil::IOFile saved_file{cache_file_path, "rb"}; saved_file.IsOpen()) {
+        Common::MappedFile saved_mapping;
+        std::vector<u8> saved_data;
+        const auto saved = ReadPipelineCacheFile(saved_file, saved_mapping, saved_data);
+        if (!saved.empty() && IsCacheValid(saved)) {
+            const vk::PipelineCacheCreateInfo saved_info{
+                .initialDataSize = saved.size(),
+                .pInitialData = saved.data(),
+            };
+            const auto saved_cache = device.createPipelineCacheUnique(saved_info);
+            device.mergePipelineCaches(*pipeline_cache, *saved_cache);
+        }
+    }
+
+    // Written aside and renamed over the cache, so that other processes never read it half written
+    const auto temp_path = cache_file_path + ".tmp";
+    {
+        FileUtil::IOFile cache_file{temp_path, "wb"};
+        if (!cache_file.IsOpen()) {
+            LOG_ERROR(Render_Vulkan, "Unable to open pipeline cache for writing");
+            return;
+        }
+
+        const auto cache_data = device.getPipelineCacheData(*pipeline_cache);
+        if (cache_file.WriteBytes(cache_data.data(), cache_data.size()) != cache_data.size()) {
+            LOG_ERROR(Render_Vulkan, "Error during pipeline cache write");
+            cache_file.Close();
+            FileUtil::Delete(temp_path);
+            return;
+        }
+    }
+    if (!FileUtil::RenameReplacing(temp_path, cache_file_path)) {
+        FileUtil::Delete(temp_path);
     }
 }
 
@@ -206,54 +311,67 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
     if (new_pipeline) {
         it.value() =
             std::make_unique<GraphicsPipeline>(instance, renderpass_cache, info, *pipeline_cache,
-                                               *pipeline_layout, current_shaders, &workers);
+                                               *pipeline_layout, current_shaders, &workers,
+                                               libraries.get());
+        SaveTransferable(static_cast<u32>(TransferableEntryKind::Pipeline), shader_hashes, info);
+        VideoCore::CountFrameEvent(system, Core::PerfStats::FrameCounter::PipelineCompiles);
     }
 
-    GraphicsPipeline* const pipeline{it->second.get()};
-    if (!pipeline->IsDone() && !pipeline->TryBuild(wait_built)) {
-        return false;
+    GraphicsPipeline* pipeline{it->second.get()};
+    if (!pipeline->IsDone()) {
+        // Never block on the specialized pipeline when the ubershader can draw in its place.
+        GraphicsPipeline* const uber_pipeline = GetUberPipeline(info);
+        const bool was_pending = pipeline->IsPending();
+        const bool over_budget =
+            uber_pipeline && !was_pending && frame_compiles >= MaxPipelineCompilesPerFrame;
+        const bool ready = !over_budget && pipeline->TryBuild(uber_pipeline ? false : wait_built);
+        if (!was_pending && pipeline->IsPending()) {
+            frame_compiles++;
+        }
+        if (!ready) {
+            if (!uber_pipeline) {
+                return false;
+            }
+            pipeline = uber_pipeline;
+        }
     }
 
-    u32 new_descriptors_start = 0;
-    std::span<vk::DescriptorSet> new_descriptors_span{};
     std::span<u32> new_offsets_span{};
+    std::optional<DescriptorSetData> push_textures{};
 
     // Ensure all the descriptor sets are set at least once at the beginning.
-    if (scheduler.IsStateDirty(StateFlags::DescriptorSets)) {
+    const bool descriptors_dirty = scheduler.IsStateDirty(StateFlags::DescriptorSets);
+    if (descriptors_dirty) {
         set_dirty.set();
     }
 
-    if (set_dirty.any()) {
-        for (u32 i = 0; i < NUM_RASTERIZER_SETS; i++) {
-            if (!set_dirty.test(i)) {
-                continue;
-            }
-            bound_descriptor_sets[i] = descriptor_set_providers[i].Acquire(update_data[i]);
+    for (u32 i = 0; i < NUM_RASTERIZER_SETS; i++) {
+        if (!set_dirty.test(i)) {
+            continue;
         }
-        new_descriptors_span = bound_descriptor_sets;
-
-        // Only send new offsets if the buffer descriptor-set changed.
-        if (set_dirty.test(0)) {
-            new_offsets_span = offsets;
+        auto& provider = descriptor_set_providers[i];
+        if (provider.IsPushDescriptor()) {
+            push_textures = update_data[i];
+            set_dirty.reset(i);
+            continue;
         }
-
-        // Try to compact the number of updated descriptor-set slots to the ones that have actually
-        // changed
-        if (!set_dirty.all()) {
-            const u64 dirty_mask = set_dirty.to_ulong();
-            new_descriptors_start = static_cast<u32>(std::countr_zero(dirty_mask));
-            const u32 new_descriptors_end = 64u - static_cast<u32>(std::countl_zero(dirty_mask));
-            const u32 new_descriptors_size = new_descriptors_end - new_descriptors_start;
-
-            new_descriptors_span =
-                new_descriptors_span.subspan(new_descriptors_start, new_descriptors_size);
+        const vk::DescriptorSet descriptor_set = provider.Acquire(update_data[i]);
+        // Rebinding the same set is redundant unless it also carries new dynamic offsets.
+        if (i != 0 && !descriptors_dirty && descriptor_set == bound_descriptor_sets[i]) {
+            set_dirty.reset(i);
+            continue;
         }
+        bound_descriptor_sets[i] = descriptor_set;
+    }
 
-        set_dirty.reset();
+    // Only send new offsets if the buffer descriptor-set changed.
+    if (set_dirty.test(0)) {
+        new_offsets_span = offsets;
     }
 
-    boost::container::static_vector<vk::DescriptorSet, NUM_RASTERIZER_SETS> new_descriptors(
-        new_descriptors_span.begin(), new_descriptors_span.end());
+    const u32 bind_mask = static_cast<u32>(set_dirty.to_ulong());
+    set_dirty.reset();
+
     boost::container::static_vector<u32, NUM_DYNAMIC_OFFSETS> new_offsets(new_offsets_span.begin(),
                                                                           new_offsets_span.end());
 
@@ -261,12 +379,13 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
     const bool pipeline_dirty = (current_pipeline != pipeline) || is_dirty;
     scheduler.Record([this, is_dirty, pipeline_dirty, pipeline,
                       current_dynamic = current_info.dynamic, dynamic = info.dynamic,
-                      new_descriptors_start, descriptor_sets = std::move(new_descriptors),
-                      offsets = std::move(new_offsets),
+                      bind_mask, descriptor_sets = bound_descriptor_sets,
+                      offsets = std::move(new_offsets), push_textures = std::move(push_textures),
                       current_rasterization = current_info.rasterization,
                       current_depth_stencil = current_info.depth_stencil,
-                      rasterization = info.rasterization,
-                      depth_stencil = info.depth_stencil](vk::CommandBuffer cmdbuf) {
+                      current_blending = current_info.blending,
+                      rasterization = info.rasterization, depth_stencil = info.depth_stencil,
+                      blending = info.blending](vk::CommandBuffer cmdbuf) {
         if (dynamic.viewport != current_dynamic.viewport || is_dirty) {
             const vk::Viewport vk_viewport = {
                 .x = static_cast<f32>(dynamic.viewport.left),
@@ -357,16 +476,72 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
             }
         }
 
+        if (instance.IsExtendedDynamicState2LogicOpSupported()) {
+            if (blending.logic_op != current_blending.logic_op || is_dirty) {
+                cmdbuf.setLogicOpEXT(PicaToVK::LogicOp(blending.logic_op));
+            }
+        }
+
+        if (instance.IsExtendedDynamicState3BlendSupported()) {
+            if (blending.blend_enable != current_blending.blend_enable || is_dirty) {
+                const vk::Bool32 blend_enable = blending.blend_enable;
+                cmdbuf.setColorBlendEnableEXT(0, blend_enable);
+                cmdbuf.setLogicOpEnableEXT(!blending.blend_enable &&
+                                           !instance.NeedsLogicOpEmulation());
+            }
+
+            if (blending.value != current_blending.value || is_dirty) {
+                const vk::ColorBlendEquationEXT blend_equation = {
+                    .srcColorBlendFactor = PicaToVK::BlendFunc(blending.src_color_blend_factor),
+                    .dstColorBlendFactor = PicaToVK::BlendFunc(blending.dst_color_blend_factor),
+                    .colorBlendOp = PicaToVK::BlendEquation(blending.color_blend_eq),
+                    .srcAlphaBlendFactor = PicaToVK::BlendFunc(blending.src_alpha_blend_factor),
+                    .dstAlphaBlendFactor = PicaToVK::BlendFunc(blending.dst_alpha_blend_factor),
+                    .alphaBlendOp = PicaToVK::BlendEquation(blending.alpha_blend_eq),
+                };
+                cmdbuf.setColorBlendEquationEXT(0, blend_equation);
+            }
+
+            if (blending.color_write_mask != current_blending.color_write_mask || is_dirty) {
+                const auto write_mask =
+                    static_cast<vk::ColorComponentFlags>(blending.color_write_mask);
+                cmdbuf.setColorWriteMaskEXT(0, write_mask);
+            }
+        }
+
         if (pipeline_dirty) {
             if (!pipeline->IsDone()) {
+                const auto start = std::chrono::steady_clock::now();
                 pipeline->WaitDone();
+                const u64 wait_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now() - start)
+                                        .count();
+                frame_waits.fetch_add(1, std::memory_order_relaxed);
+                frame_wait_us.fetch_add(wait_us, std::memory_order_relaxed);
+                u64 max_us = frame_max_wait_us.load(std::memory_order_relaxed);
+                while (max_us < wait_us && !frame_max_wait_us.compare_exchange_weak(
+                                               max_us, wait_us, std::memory_order_relaxed)) {
+                }
             }
             cmdbuf.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->Handle());
         }
 
-        if (descriptor_sets.size()) {
-            cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline_layout,
-                                      new_descriptors_start, descriptor_sets, offsets);
+        // Bind each contiguous run of changed sets, push descriptor sets are never bound.
+        for (u32 mask = bind_mask; mask != 0;) {
+            const u32 first = static_cast<u32>(std::countr_zero(mask));
+            const u32 count = static_cast<u32>(std::countr_one(mask >> first));
+            const auto run_sets = std::span{descriptor_sets}.subspan(first, count);
+            const auto run_offsets =
+                first == 0 ? std::span<const u32>{offsets} : std::span<const u32>{};
+            cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline_layout, first,
+                                      run_sets, run_offsets);
+            mask &= ~(((1U << count) - 1) << first);
+        }
+
+        if (push_textures) {
+            const auto& provider = descriptor_set_providers[1];
+            cmdbuf.pushDescriptorSetWithTemplateKHR(provider.UpdateTemplate(), *pipeline_layout, 1,
+                                                    push_textures->data());
         }
     });
 
@@ -402,28 +577,20 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
         }
     }
 
+    // Draws mostly keep the vertex shader, so the config is compared before it is hashed
+    if (last_vs_config == config) {
+        current_shaders[ProgramType::VS] = last_vs_shader;
+        shader_hashes[ProgramType::VS] = last_vs_hash;
+        return true;
+    }
+
     auto [it, new_config] = programmable_vertex_map.try_emplace(config);
     if (new_config) {
-        auto program = GLSL::GenerateVertexShader(setup, config, true);
-        if (program.empty()) {
-            LOG_ERROR(Render_Vulkan, "Failed to retrieve programmable vertex shader");
-            programmable_vertex_map[config] = nullptr;
-            return false;
+        it->second = CompileProgrammableVertexShader(config, setup);
+        if (it->second) {
+            SaveTransferable(static_cast<u32>(TransferableEntryKind::VertexShader), config.state,
+                             setup.program_code, setup.swizzle_data);
         }
-
-        auto [iter, new_program] = programmable_vertex_cache.try_emplace(program, instance);
-        auto& shader = iter->second;
-
-        if (new_program) {
-            shader.program = std::move(program);
-            const vk::Device device = instance.GetDevice();
-            workers.QueueWork([device, &shader] {
-                shader.module = Compile(shader.program, vk::ShaderStageFlagBits::eVertex, device);
-                shader.MarkDone();
-            });
-        }
-
-        it->second = &shader;
     }
 
     Shader* const shader{it->second};
@@ -434,6 +601,9 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
 
     current_shaders[ProgramType::VS] = shader;
     shader_hashes[ProgramType::VS] = config.Hash();
+    last_vs_config = config;
+    last_vs_shader = shader;
+    last_vs_hash = shader_hashes[ProgramType::VS];
 
     return true;
 }
@@ -450,18 +620,11 @@ bool PipelineCache::UseFixedGeometryShader(const Pica::RegsInternal& regs) {
     }
 
     const PicaFixedGSConfig gs_config{regs, instance.IsShaderClipDistanceSupported()};
-    auto [it, new_shader] = fixed_geometry_shaders.try_emplace(gs_config, instance);
-    auto& shader = it->second;
-
-    if (new_shader) {
-        workers.QueueWork([gs_config, device = instance.GetDevice(), &shader]() {
-            const auto code = GLSL::GenerateFixedGeometryShader(gs_config, true);
-            shader.module = Compile(code, vk::ShaderStageFlagBits::eGeometry, device);
-            shader.MarkDone();
-        });
+    if (!fixed_geometry_shaders.contains(gs_config)) {
+        SaveTransferable(static_cast<u32>(TransferableEntryKind::GeometryShader), gs_config.state);
     }
 
-    current_shaders[ProgramType::GS] = &shader;
+    current_shaders[ProgramType::GS] = &CompileFixedGeometryShader(gs_config);
     shader_hashes[ProgramType::GS] = gs_config.Hash();
 
     return true;
@@ -475,26 +638,390 @@ void PipelineCache::UseTrivialGeometryShader() {
 void PipelineCache::UseFragmentShader(const Pica::RegsInternal& regs,
                                       const Pica::Shader::UserConfig& user) {
     const FSConfig fs_config{regs, user, profile};
+    if (!fragment_shaders.contains(fs_config)) {
+        SaveTransferable(static_cast<u32>(TransferableEntryKind::FragmentShader), fs_config);
+    }
+
+    current_shaders[ProgramType::FS] = &CompileFragmentShader(fs_config);
+    shader_hashes[ProgramType::FS] = fs_config.Hash();
+
+    if (use_ubershader) {
+        ubershader_compatible = GLSL::IsUberShaderCompatible(fs_config, profile);
+        fs_config_data = GLSL::MakeFSConfigData(fs_config);
+    }
+}
+
+void PipelineCache::TickFrame() {
+    frame_compiles = 0;
+    last_frame_waits = {
+        .waits = frame_waits.exchange(0, std::memory_order_relaxed),
+        .total_us = frame_wait_us.exchange(0, std::memory_order_relaxed),
+        .max_us = frame_max_wait_us.exchange(0, std::memory_order_relaxed),
+    };
+}
+
+GraphicsPipeline* PipelineCache::GetUberPipeline(const PipelineInfo& info) {
+    if (!use_ubershader || !ubershader_compatible || !ubershader.IsDone()) {
+        return nullptr;
+    }
+    const auto is_pending = [](Shader* shader) { return shader && !shader->IsDone(); };
+    if (is_pending(current_shaders[ProgramType::VS]) ||
+        is_pending(current_shaders[ProgramType::GS])) {
+        return nullptr;
+    }
+
+    u64 shader_hash = 0;
+    for (u32 i = 0; i < MAX_SHADER_STAGES; i++) {
+        shader_hash = Common::HashCombine(shader_hash,
+                                          i == ProgramType::FS ? UberShaderHash : shader_hashes[i]);
+    }
+    const u64 pipeline_hash = Common::HashCombine(shader_hash, info.Hash(instance));
+
+    auto [it, new_pipeline] = graphics_pipelines.try_emplace(pipeline_hash);
+    if (new_pipeline) {
+        std::array<Shader*, MAX_SHADER_STAGES> stages = current_shaders;
+        stages[ProgramType::FS] = &ubershader;
+        it.value() = std::make_unique<GraphicsPipeline>(instance, renderpass_cache, info,
+                                                        *pipeline_cache, *pipeline_layout, stages,
+                                                        &workers, libraries.get());
+        VideoCore::CountFrameEvent(system, Core::PerfStats::FrameCounter::PipelineCompiles);
+    }
+
+    GraphicsPipeline* const pipeline{it->second.get()};
+    if (!pipeline->IsDone() && !pipeline->TryBuild(false)) {
+        return nullptr;
+    }
+    return pipeline;
+}
+
+Shader* PipelineCache::CompileProgrammableVertexShader(const PicaVSConfig& config,
+                                                       const Pica::ShaderSetup& setup) {
+    auto program = GLSL::GenerateVertexShader(setup, config, true);
+    if (program.empty()) {
+        LOG_ERROR(Render_Vulkan, "Failed to retrieve programmable vertex shader");
+        return nullptr;
+    }
+
+    auto [iter, new_program] = programmable_vertex_cache.try_emplace(program, instance);
+    auto& shader = iter->second;
+
+    if (new_program) {
+        shader.program = std::move(program);
+        workers.QueueWork([this, &shader] {
+            shader.module = CompileCached(shader.program, vk::ShaderStageFlagBits::eVertex);
+            VideoCore::CountFrameEvent(system, Core::PerfStats::FrameCounter::ShaderCompiles);
+            shader.MarkDone();
+        });
+    }
+
+    return &shader;
+}
+
+Shader& PipelineCache::CompileFixedGeometryShader(const PicaFixedGSConfig& gs_config) {
+    auto [it, new_shader] = fixed_geometry_shaders.try_emplace(gs_config, instance);
+    auto& shader = it->second;
+
+    if (new_shader) {
+        workers.QueueWork([gs_config, this, &shader]() {
+            const auto code = GLSL::GenerateFixedGeometryShader(gs_config, true);
+            shader.module = CompileCached(code, vk::ShaderStageFlagBits::eGeometry);
+            VideoCore::CountFrameEvent(system, Core::PerfStats::FrameCounter::ShaderCompiles);
+            shader.MarkDone();
+        });
+    }
+
+    return shader;
+}
+
+Shader& PipelineCache::CompileFragmentShader(const FSConfig& fs_config) {
     const auto [it, new_shader] = fragment_shaders.try_emplace(fs_config, instance);
     auto& shader = it->second;
 
     if (new_shader) {
-        workers.QueueWork([fs_config, this, &shader]() {
+        workers.QueueWork([fs_config, this, cache = *pipeline_cache, &shader]() {
             const bool use_spirv = Settings::values.spirv_shader_gen.GetValue();
             if (use_spirv && !fs_config.UsesShadowPipeline()) {
                 const std::vector code = SPIRV::GenerateFragmentShader(fs_config, profile);
                 shader.module = CompileSPV(code, instance.GetDevice());
             } else {
                 const std::string code = GLSL::GenerateFragmentShader(fs_config, profile);
-                shader.module =
-                    Compile(code, vk::ShaderStageFlagBits::eFragment, instance.GetDevice());
+                shader.module = CompileCached(code, vk::ShaderStageFlagBits::eFragment);
             }
+            if (libraries) {
+                libraries->BuildFragmentShader(shader, cache);
+            }
+            VideoCore::CountFrameEvent(system, Core::PerfStats::FrameCounter::ShaderCompiles);
             shader.MarkDone();
         });
     }
 
-    current_shaders[ProgramType::FS] = &shader;
-    shader_hashes[ProgramType::FS] = fs_config.Hash();
+    return shader;
+}
+
+void PipelineCache::LoadTransferable(const std::atomic_bool& stop_loading,
+                                     const VideoCore::DiskResourceLoadCallback& callback) {
+    if (system.GetAppLoader().ReadProgramId(program_id) != Loader::ResultStatus::Success ||
+        program_id == 0) {
+        return;
+    }
+
+    LoadSpirvCache();
+
+    const auto path = GetTransferablePath();
+    FileUtil::IOFile file{path, "rb"};
+    if (!file.IsOpen() || GetAppendedSize(file) == 0) {
+        LOG_INFO(Render_Vulkan, "No transferable pipeline cache found for title id={:016X}",
+                 program_id);
+        return;
+    }
+
+    u32 version{};
+    if (file.ReadBytes(&version, sizeof(version)) != sizeof(version) ||
+        version != TransferableVersion) {
+        LOG_INFO(Render_Vulkan, "Transferable pipeline cache is outdated - removing");
+        file.Close();
+        FileUtil::Delete(path);
+        return;
+    }
+
+    // Shaders are keyed by the same hashes BindPipeline uses to identify the stages.
+    std::unordered_map<u64, Shader*> vs_shaders{{0, &trivial_vertex_shader}};
+    std::unordered_map<u64, Shader*> gs_shaders{{0, nullptr}};
+    std::unordered_map<u64, Shader*> fs_shaders;
+    std::vector<std::pair<std::array<u64, MAX_SHADER_STAGES>, PipelineInfo>> pipelines;
+
+    const bool sanitize_mul = Settings::values.shaders_accurate_mul.GetValue();
+    const std::size_t file_size = GetAppendedSize(file);
+    if (callback) {
+        callback(VideoCore::LoadCallbackStage::Decompile, 0, file_size);
+    }
+
+    while (!stop_loading && file.Tell() < file_size) {
+        TransferableEntryKind kind{};
+        if (file.ReadBytes(&kind, sizeof(kind)) != sizeof(kind)) {
+            break;
+        }
+
+        bool success = false;
+        switch (kind) {
+        case TransferableEntryKind::VertexShader: {
+            auto setup = std::make_unique<Pica::ShaderSetup>();
+            PicaVSConfig config{Pica::RegsInternal{}, *setup, false, false};
+            success = file.ReadBytes(&config.state, sizeof(config.state)) ==
+                          sizeof(config.state) &&
+                      file.ReadArray(setup->program_code.data(), setup->program_code.size()) ==
+                          setup->program_code.size() &&
+                      file.ReadArray(setup->swizzle_data.data(), setup->swizzle_data.size()) ==
+                          setup->swizzle_data.size();
+            if (success && config.state.sanitize_mul == sanitize_mul) {
+                auto [it, new_config] = programmable_vertex_map.try_emplace(config);
+                if (new_config) {
+                    it->second = CompileProgrammableVertexShader(config, *setup);
+                }
+                vs_shaders.emplace(config.Hash(), it->second);
+            }
+            break;
+        }
+        case TransferableEntryKind::GeometryShader: {
+            PicaFixedGSConfig config{Pica::RegsInternal{}, false};
+            success =
+                file.ReadBytes(&config.state, sizeof(config.state)) == sizeof(config.state);
+            if (success && instance.UseGeometryShaders()) {
+                gs_shaders.emplace(config.Hash(), &CompileFixedGeometryShader(config));
+            }
+            break;
+        }
+        case TransferableEntryKind::FragmentShader: {
+            FSConfig config{Pica::RegsInternal{}, {}, profile};
+            success = file.ReadBytes(&config, sizeof(config)) == sizeof(config);
+            if (success) {
+                fs_shaders.emplace(config.Hash(), &CompileFragmentShader(config));
+            }
+            break;
+        }
+        case TransferableEntryKind::Pipeline: {
+            auto& [hashes, info] = pipelines.emplace_back();
+            success = file.ReadArray(hashes.data(), hashes.size()) == hashes.size() &&
+                      file.ReadBytes(&info, sizeof(info)) == sizeof(info);
+            break;
+        }
+        }
+
+        if (!success) {
+            LOG_ERROR(Render_Vulkan, "Transferable pipeline cache is corrupted - removing");
+            file.Close();
+            FileUtil::Delete(path);
+            return;
+        }
+        if (callback) {
+            callback(VideoCore::LoadCallbackStage::Decompile, file.Tell(), file_size);
+        }
+    }
+
+    // Pipelines can only be linked once all their stages are compiled.
+    workers.WaitForRequests();
+
+    std::vector<GraphicsPipeline*> queued;
+    queued.reserve(pipelines.size());
+    for (const auto& [hashes, info] : pipelines) {
+        if (stop_loading) {
+            break;
+        }
+
+        const auto vs = vs_shaders.find(hashes[ProgramType::VS]);
+        const auto fs = fs_shaders.find(hashes[ProgramType::FS]);
+        const auto gs = gs_shaders.find(hashes[ProgramType::GS]);
+        if (vs == vs_shaders.end() || fs == fs_shaders.end() || gs == gs_shaders.end() ||
+            !vs->second) {
+            continue;
+        }
+
+        u64 shader_hash = 0;
+        for (u32 i = 0; i < MAX_SHADER_STAGES; i++) {
+            shader_hash = Common::HashCombine(shader_hash, hashes[i]);
+        }
+        const u64 pipeline_hash = Common::HashCombine(shader_hash, info.Hash(instance));
+
+        auto [it, new_pipeline] = graphics_pipelines.try_emplace(pipeline_hash);
+        if (new_pipeline) {
+            std::array<Shader*, MAX_SHADER_STAGES> stages{};
+            stages[ProgramType::VS] = vs->second;
+            stages[ProgramType::FS] = fs->second;
+            stages[ProgramType::GS] = gs->second;
+            it.value() = std::make_unique<GraphicsPipeline>(instance, renderpass_cache, info,
+                                                            *pipeline_cache, *pipeline_layout,
+                                                            stages, &workers);
+            it->second->QueueBuild(Common::TaskPriority::Prefetch);
+            queued.push_back(it->second.get());
+        }
+    }
+
+    // With asynchronous compilation the title boots right away, drawing with the ubershader until
+    // its pipelines are built in the background.
+    if (Settings::values.async_shader_compilation.GetValue()) {
+        LOG_INFO(Render_Vulkan, "Building {} pipelines from the transferable cache in background",
+                 queued.size());
+        return;
+    }
+
+    // Report the pipelines as they are built by the workers, so the loading screen can estimate
+    // the remaining time.
+    std::size_t built = 0;
+    while (!stop_loading) {
+        built = std::count_if(queued.begin(), queued.end(),
+                              [](GraphicsPipeline* pipeline) { return pipeline->IsDone(); });
+        if (callback) {
+            callback(VideoCore::LoadCallbackStage::Build, built, queued.size());
+        }
+        if (built == queued.size()) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    }
+    LOG_INFO(Render_Vulkan, "Loaded {} pipelines from the transferable cache", built);
+}
+
+void PipelineCache::OpenTransferable() {
+    if (program_id == 0) {
+        return;
+    }
+
+    const auto path = GetTransferablePath();
+    transferable_file = FileUtil::IOFile{path, "ab"};
+    if (!transferable_file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Failed to open transferable pipeline cache in path={}", path);
+        return;
+    }
+    // Another process may be creating the file as well
+    FileUtil::ScopedFileLock lock{transferable_file, true};
+    if (transferable_file.GetSize() == 0) {
+        transferable_file.WriteObject(TransferableVersion);
+        transferable_file.Flush();
+    }
+}
+
+u64 PipelineCache::GetAppendedSize(FileUtil::IOFile& file) {
+    // Other processes append whole entries under an exclusive lock, so the file ends at an entry
+    FileUtil::ScopedFileLock lock{file, false};
+    return file.GetSize();
+}
+
+void PipelineCache::LoadSpirvCache() {
+    const auto path = GetSpirvCachePath();
+    std::scoped_lock lock{spirv_mutex};
+
+    FileUtil::IOFile file{path, "rb"};
+    if (file.IsOpen() && GetAppendedSize(file) != 0) {
+        u32 version{};
+        u32 compiler_version{};
+        if (file.ReadBytes(&version, sizeof(version)) != sizeof(version) ||
+            file.ReadBytes(&compiler_version, sizeof(compiler_version)) !=
+                sizeof(compiler_version) ||
+            version != SpirvCacheVersion || compiler_version != GLSL_COMPILER_VERSION) {
+            LOG_INFO(Render_Vulkan, "SPIR-V cache is outdated - removing");
+            file.Close();
+            FileUtil::Delete(path);
+        } else {
+            const std::size_t file_size = GetAppendedSize(file);
+            while (file.Tell() < file_size) {
+                u64 key{};
+                u32 word_count{};
+                if (file.ReadBytes(&key, sizeof(key)) != sizeof(key) ||
+                    file.ReadBytes(&word_count, sizeof(word_count)) != sizeof(word_count)) {
+                    break;
+                }
+                std::vector<u32> code(word_count);
+                if (file.ReadArray(code.data(), code.size()) != code.size()) {
+                    LOG_ERROR(Render_Vulkan, "SPIR-V cache entry is truncated, ignoring the rest");
+                    break;
+                }
+                spirv_cache.try_emplace(key, std::move(code));
+            }
+            LOG_INFO(Render_Vulkan, "Loaded {} shaders from the SPIR-V cache", spirv_cache.size());
+            file.Close();
+        }
+    }
+
+    spirv_file = FileUtil::IOFile{path, "ab"};
+    if (!spirv_file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Failed to open SPIR-V cache in path={}", path);
+        return;
+    }
+    FileUtil::ScopedFileLock file_lock{spirv_file, true};
+    if (spirv_file.GetSize() == 0) {
+        spirv_file.WriteObject(SpirvCacheVersion);
+        spirv_file.WriteObject(GLSL_COMPILER_VERSION);
+        spirv_file.Flush();
+    }
+}
+
+vk::ShaderModule PipelineCache::CompileCached(std::string_view code,
+                                              vk::ShaderStageFlagBits stage) {
+    const u64 key = Common::HashCombine(Common::ComputeHash64(code.data(), code.size()),
+                                        static_cast<u64>(stage));
+    const vk::Device device = instance.GetDevice();
+    {
+        // Shaders are deduplicated by the caches above, so each entry is used at most once.
+        std::scoped_lock lock{spirv_mutex};
+        if (auto node = spirv_cache.extract(key)) {
+            return CompileSPV(node.mapped(), device);
+        }
+    }
+
+    const std::vector<u32> spirv = CompileGLSL(code, stage);
+    if (spirv.empty()) {
+        return {};
+    }
+
+    std::scoped_lock lock{spirv_mutex};
+    if (spirv_file.IsOpen()) {
+        FileUtil::ScopedFileLock file_lock{spirv_file, true};
+        spirv_file.WriteObject(key);
+        spirv_file.WriteObject(static_cast<u32>(spirv.size()));
+        spirv_file.WriteArray(spirv.data(), spirv.size());
+        spirv_file.Flush();
+    }
+    return CompileSPV(spirv, device);
 }
 
 void PipelineCache::BindTexture(u32 binding, vk::ImageView image_view, vk::Sampler sampler) {
@@ -544,8 +1071,10 @@ void PipelineCache::BindTexelBuffer(u32 binding, vk::BufferView buffer_view) {
 }
 
 void PipelineCache::SetBufferOffset(u32 binding, std::size_t offset) {
-    if (offsets[binding] != static_cast<u32>(offset)) {
-        offsets[binding] = static_cast<u32>(offset);
+    // Dynamic offsets are ordered by binding, the fragment config follows the first three blocks.
+    const u32 index = binding == FS_CONFIG_BINDING ? NUM_DYNAMIC_OFFSETS - 1 : binding;
+    if (offsets[index] != static_cast<u32>(offset)) {
+        offsets[index] = static_cast<u32>(offset);
         set_dirty[0] = true;
     }
 }
@@ -610,4 +1139,12 @@ std::string PipelineCache::GetPipelineCacheDir() const {
     return FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir) + "vulkan" + DIR_SEP;
 }
 
+std::string PipelineCache::GetTransferablePath() const {
+    return fmt::format("{}{:016X}.keys", GetPipelineCacheDir(), program_id);
+}
+
+std::string PipelineCache::GetSpirvCachePath() const {
+    return fmt::format("{}{:016X}.spv", GetPipelineCacheDir(), program_id);
+}
+
 } // namespace Vulkan
@@ -4,14 +4,27 @@
 
 #pragma once
 
+#include <atomic>
 #include <bitset>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
 #include <tsl/robin_map.h>
 
+#include "common/file_util.h"
+#include "common/mapped_file.h"
+#include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/shader/generator/pica_fs_config.h"
 #include "video_core/shader/generator/profile.h"
 #include "video_core/shader/generator/shader_gen.h"
+#include "video_core/shader/generator/shader_uniforms.h"
+
+namespace Core {
+class System;
+}
 
 namespace Pica {
 struct RegsInternal;
@@ -26,14 +39,17 @@ class RenderpassCache;
 class DescriptorPool;
 
 constexpr u32 NUM_RASTERIZER_SETS = 3;
-constexpr u32 NUM_DYNAMIC_OFFSETS = 3;
+constexpr u32 NUM_DYNAMIC_OFFSETS = 4;
+
+/// Binding of the uniform block that provides the fragment configuration to the ubershader
+constexpr u32 FS_CONFIG_BINDING = 6;
 
 /**
  * Stores a collection of rasterizer pipelines used during rendering.
  */
 class PipelineCache {
 public:
-    explicit PipelineCache(const Instance& instance, Scheduler& scheduler,
+    explicit PipelineCache(Core::System& system, const Instance& instance, Scheduler& scheduler,
                            RenderpassCache& renderpass_cache, DescriptorPool& pool);
     ~PipelineCache();
 
@@ -41,8 +57,9 @@ public:
         return descriptor_set_providers[1];
     }
 
-    /// Loads the pipeline cache stored to disk
-    void LoadDiskCache();
+    /// Loads the pipeline cache stored to disk and precompiles the transferable entries
+    void LoadDiskCache(const std::atomic_bool& stop_loading,
+                       const VideoCore::DiskResourceLoadCallback& callback);
 
     /// Stores the generated pipeline cache to disk
     void SaveDiskCache();
@@ -66,6 +83,42 @@ public:
     /// Binds a fragment shader generated from PICA state
     void UseFragmentShader(const Pica::RegsInternal& regs, const Pica::Shader::UserConfig& user);
 
+    /// Returns the number of cached graphics pipelines
+    [[nodiscard]] std::size_t NumPipelines() const noexcept {
+        return graphics_pipelines.size();
+    }
+
+    /// Returns the number of cached shader modules
+    [[nodiscard]] std::size_t NumShaders() const noexcept {
+        return programmable_vertex_cache.size() + fixed_geometry_shaders.size() +
+               fragment_shaders.size();
+    }
+
+    /// Blocking waits on pipelines still compiling when bound
+    struct PipelineWaitStats {
+        u32 waits{};
+        u64 total_us{};
+        u64 max_us{};
+    };
+
+    /// Returns the waits on compiling pipelines during the last frame
+    [[nodiscard]] const PipelineWaitStats& GetPipelineWaitStats() const noexcept {
+        return last_frame_waits;
+    }
+
+    /// Resets the compilation budget and the wait statistics of the frame
+    void TickFrame();
+
+    /// Returns true when draws fall back to the fragment ubershader while pipelines compile
+    [[nodiscard]] bool IsUberShaderEnabled() const noexcept {
+        return use_ubershader;
+    }
+
+    /// Returns the configuration of the current fragment shader as read by the ubershader
+    [[nodiscard]] const Pica::Shader::Generator::FSConfigData& FragmentConfigData() const noexcept {
+        return fs_config_data;
+    }
+
     /// Binds a texture to the specified binding
     void BindTexture(u32 binding, vk::ImageView image_view, vk::Sampler sampler);
 
@@ -82,6 +135,9 @@ public:
     void SetBufferOffset(u32 binding, std::size_t offset);
 
 private:
+    /// Returns the ubershader variant of the current pipeline when it can be bound right away
+    GraphicsPipeline* GetUberPipeline(const PipelineInfo& info);
+
     /// Builds the rasterizer pipeline layout
     void BuildLayout();
 
@@ -94,7 +150,58 @@ private:
     /// Returns the pipeline cache storage dir
     std::string GetPipelineCacheDir() const;
 
+    /// Returns the path of the current title's transferable cache file
+    std::string GetTransferablePath() const;
+
+    /// Returns the path of the current title's SPIR-V cache file
+    std::string GetSpirvCachePath() const;
+
+    /// Compiles all shaders and pipelines recorded in the transferable cache file
+    void LoadTransferable(const std::atomic_bool& stop_loading,
+                          const VideoCore::DiskResourceLoadCallback& callback);
+
+    /// Opens the transferable cache file for appending new entries
+    void OpenTransferable();
+
+    /// Returns the size of a cache file other processes append to, which ends at a whole entry
+    static u64 GetAppendedSize(FileUtil::IOFile& file);
+
+    /// Reads the pipeline cache data of a file, mapping it when possible
+    static std::span<const u8> ReadPipelineCacheFile(FileUtil::IOFile& file,
+                                                     Common::MappedFile& mapping,
+                                                     std::vector<u8>& buffer);
+
+    /// Loads the SPIR-V cached for the current title and opens the file for appending
+    void LoadSpirvCache();
+
+    /// Compiles GLSL to a shader module, reusing the SPIR-V stored by a previous session
+    vk::ShaderModule CompileCached(std::string_view code, vk::ShaderStageFlagBits stage);
+
+    /// Appends a raw entry to the transferable cache file
+    template <typename... Ts>
+    void SaveTransferable(u32 kind, const Ts&... payload) {
+        if (!transferable_file.IsOpen()) {
+            return;
+        }
+        // Flushed under the lock, so that the entries of other processes do not interleave
+        FileUtil::ScopedFileLock lock{transferable_file, true};
+        transferable_file.WriteObject(kind);
+        (transferable_file.WriteObject(payload), ...);
+        transferable_file.Flush();
+    }
+
+    /// Queues compilation of a programmable vertex shader
+    Shader* CompileProgrammableVertexShader(const Pica::Shader::Generator::PicaVSConfig& config,
+                                            const Pica::ShaderSetup& setup);
+
+    /// Queues compilation of a fixed geometry shader
+    Shader& CompileFixedGeometryShader(const Pica::Shader::Generator::PicaFixedGSConfig& config);
+
+    /// Queues compilation of a fragment shader
+    Shader& CompileFragmentShader(const Pica::Shader::FSConfig& config);
+
 private:
+    Core::System& system;
     const Instance& instance;
     Scheduler& scheduler;
     RenderpassCache& renderpass_cache;
@@ -103,12 +210,19 @@ private:
     Pica::Shader::Profile profile{};
     vk::UniquePipelineCache pipeline_cache;
     vk::UniquePipelineLayout pipeline_layout;
-    std::size_t num_worker_threads;
-    Common::ThreadWorker workers;
+    std::unique_ptr<PipelineLibraries> libraries;
+    Common::TaskGroup workers;
     PipelineInfo current_info{};
     GraphicsPipeline* current_pipeline{};
     tsl::robin_map<u64, std::unique_ptr<GraphicsPipeline>, Common::IdentityHash<u64>>
         graphics_pipelines;
+    /// Pipeline compilations queued by draws during the current frame
+    u32 frame_compiles{};
+    /// Waits of the current frame, counted when the commands are recorded on the scheduler thread
+    std::atomic<u32> frame_waits{};
+    std::atomic<u64> frame_wait_us{};
+    std::atomic<u64> frame_max_wait_us{};
+    PipelineWaitStats last_frame_waits{};
 
     std::array<DescriptorSetProvider, NUM_RASTERIZER_SETS> descriptor_set_providers;
     std::array<DescriptorSetData, NUM_RASTERIZER_SETS> update_data{};
@@ -119,10 +233,24 @@ private:
     std::array<u64, MAX_SHADER_STAGES> shader_hashes;
     std::array<Shader*, MAX_SHADER_STAGES> current_shaders;
     std::unordered_map<Pica::Shader::Generator::PicaVSConfig, Shader*> programmable_vertex_map;
+    /// Programmable vertex shader of the previous lookup, which is usually the one needed again
+    std::optional<Pica::Shader::Generator::PicaVSConfig> last_vs_config;
+    Shader* last_vs_shader{};
+    u64 last_vs_hash{};
     std::unordered_map<std::string, Shader> programmable_vertex_cache;
     std::unordered_map<Pica::Shader::Generator::PicaFixedGSConfig, Shader> fixed_geometry_shaders;
     std::unordered_map<Pica::Shader::FSConfig, Shader> fragment_shaders;
     Shader trivial_vertex_shader;
+    Shader ubershader;
+    Pica::Shader::Generator::FSConfigData fs_config_data{};
+    bool use_ubershader{};
+    bool ubershader_compatible{};
+
+    u64 program_id{};
+    FileUtil::IOFile transferable_file;
+    std::mutex spirv_mutex;
+    std::unordered_map<u64, std::vector<u32>> spirv_cache;
+    FileUtil::IOFile spirv_file;
 };
 
 } // namespace Vulkan
@@ -21,6 +21,9 @@ namespace Vulkan {
 
 namespace {
 
+/// Longest wait of low latency mode for the previous frame, after which rendering goes ahead
+constexpr std::chrono::milliseconds LowLatencyWaitTimeout{100};
+
 bool CanBlitToSwapchain(const vk::PhysicalDevice& physical_device, vk::Format format) {
     const vk::FormatProperties props{physical_device.getFormatProperties(format)};
     return static_cast<bool>(props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eBlitDst);
@@ -108,6 +111,7 @@ PresentWindow::PresentWindow(Frontend::EmuWindow& emu_window_, const Instance& i
       blit_supported{
           CanBlitToSwapchain(instance.GetPhysicalDevice(), swapchain.GetSurfaceFormat().format)},
       use_present_thread{Settings::values.async_presentation.GetValue()},
+      low_latency{Settings::values.low_latency_presentation.GetValue()},
       last_render_surface{emu_window.GetWindowInfo().render_surface} {
 
     const u32 num_images = swapchain.GetImageCount();
@@ -146,6 +150,7 @@ PresentWindow::PresentWindow(Frontend::EmuWindow& emu_window_, const Instance& i
         }
     }
 
+    frame_pacer.SetRefreshInterval(swapchain.GetRefreshInterval());
     if (use_present_thread) {
         present_thread = std::jthread([this](std::stop_token token) { PresentThread(token); });
     }
@@ -153,6 +158,12 @@ PresentWindow::PresentWindow(Frontend::EmuWindow& emu_window_, const Instance& i
 
 PresentWindow::~PresentWindow() {
     scheduler.Finish();
+    // The present thread may wake up on its own to repeat a frame, so stop it before
+    // destroying the resources it uses.
+    if (present_thread.joinable()) {
+        present_thread.request_stop();
+        present_thread.join();
+    }
     const vk::Device device = instance.GetDevice();
     device.destroyCommandPool(command_pool);
     device.destroyRenderPass(present_renderpass);
@@ -239,6 +250,14 @@ void PresentWindow::RecreateFrame(Frame* frame, u32 width, u32 height) {
 Frame* PresentWindow::GetRenderFrame() {
     MICROPROFILE_SCOPE(Vulkan_WaitPresent);
 
+    // In low latency mode only start a frame once the previous one has been handed to the
+    // swapchain, so at most one frame waits for presentation and it carries the newest input.
+    // The wait is bounded so a frame that is never handed over cannot stall emulation.
+    if (use_present_thread && low_latency) {
+        std::unique_lock queue_lock{queue_mutex};
+        frame_cv.wait_for(queue_lock, LowLatencyWaitTimeout, [this] { return queued_frames == 0; });
+    }
+
     // Wait for free presentation frames
     std::unique_lock lock{free_mutex};
     free_cv.wait(lock, [this] { return !free_queue.empty(); });
@@ -274,19 +293,46 @@ Frame* PresentWindow::GetRenderFrame() {
     return frame;
 }
 
+bool PresentWindow::IsPresentPending() {
+    if (!use_present_thread) {
+        return false;
+    }
+    {
+        std::scoped_lock lock{queue_mutex};
+        if (queued_frames > 0) {
+            return true;
+        }
+    }
+    std::scoped_lock lock{free_mutex};
+    return free_queue.empty();
+}
+
 void PresentWindow::Present(Frame* frame) {
     if (!use_present_thread) {
         scheduler.WaitWorker();
         CopyToSwapchain(frame);
+        if (present_callback) {
+            present_callback();
+        }
         free_queue.push(frame);
         return;
     }
 
+    {
+        std::scoped_lock lock{queue_mutex};
+        ++queued_frames;
+    }
     scheduler.Record([this, frame](vk::CommandBuffer) {
         std::unique_lock lock{queue_mutex};
         present_queue.push(frame);
-        frame_cv.notify_one();
+        frame_cv.notify_all();
     });
+
+    // Hand the frame to the present thread right away instead of with the next batch of work,
+    // GetRenderFrame would otherwise wait on it forever.
+    if (low_latency) {
+        scheduler.DispatchWork();
+    }
 }
 
 void PresentWindow::WaitPresent() {
@@ -307,20 +353,39 @@ void PresentWindow::WaitPresent() {
 }
 
 void PresentWindow::PresentThread(std::stop_token token) {
-    Common::SetCurrentThreadName("VulkanPresent");
+    using Clock = VideoCore::FramePacer::Clock;
+
+    Common::SetCurrentThreadRole(Common::ThreadRole::Render, "VulkanPresent");
     while (!token.stop_requested()) {
         std::unique_lock lock{queue_mutex};
-
-        // Wait for presentation frames
-        Common::CondvarWait(frame_cv, lock, token, [this] { return !present_queue.empty(); });
+        frame_pacer.OnVsync(emu_window.GetLastVsync());
+
+        // Wait for presentation frames. When pacing, wake up in time to repeat the held frame
+        // on the next refresh if the guest has not produced a new one by then.
+        const auto has_frame = [this] { return !present_queue.empty(); };
+        if (IsPacing(Clock::now())) {
+            Common::CondvarWaitUntil(frame_cv, lock, token, frame_pacer.NextPresentDeadline(),
+                                     has_frame);
+        } else {
+            Common::CondvarWait(frame_cv, lock, token, has_frame);
+        }
         if (token.stop_requested()) {
             return;
         }
 
+        if (present_queue.empty()) {
+            std::exchange(lock, std::unique_lock{swapchain_mutex});
+            CopyToSwapchain(held_frame, true);
+            frame_pacer.OnPresent(Clock::now());
+            continue;
+        }
+
         // Take the frame and notify anyone waiting
         Frame* frame = present_queue.front();
         present_queue.pop();
-        frame_cv.notify_one();
+        --queued_frames;
+        frame_cv.notify_all();
+        frame_pacer.OnGuestFrame(Clock::now());
 
         // By exchanging the lock ownership we take the swapchain lock
         // before the queue lock goes out of scope. This way the swapchain
@@ -328,14 +393,52 @@ void PresentWindow::PresentThread(std::stop_token token) {
         std::exchange(lock, std::unique_lock{swapchain_mutex});
 
         CopyToSwapchain(frame);
+        frame_pacer.OnPresent(Clock::now());
+        if (present_callback) {
+            present_callback();
+        }
 
-        // Free the frame for reuse
+        // Free the frame for reuse, holding on to it instead if it may have to be repeated.
+        ReleaseHeldFrame();
+        if (Settings::values.frame_pacing.GetValue() && swapchain.IsVsyncPresentMode()) {
+            held_frame = frame;
+            continue;
+        }
         std::scoped_lock fl{free_mutex};
         free_queue.push(frame);
         free_cv.notify_one();
     }
 }
 
+bool PresentWindow::IsPacing(VideoCore::FramePacer::Clock::time_point now) const {
+    return held_frame && Settings::values.frame_pacing.GetValue() && frame_pacer.IsActive(now);
+}
+
+void PresentWindow::ReleaseHeldFrame() {
+    if (!held_frame) {
+        return;
+    }
+    std::scoped_lock fl{free_mutex};
+    free_queue.push(std::exchange(held_frame, nullptr));
+    free_cv.notify_one();
+}
+
+void PresentWindow::SetRefreshHook(RefreshHook hook) {
+    std::scoped_lock lock{swapchain_mutex};
+    refresh_hook = std::move(hook);
+}
+
+void PresentWindow::SetPresentCallback(std::function<void()> callback) {
+    std::scoped_lock lock{swapchain_mutex};
+    present_callback = std::move(callback);
+}
+
+void PresentWindow::SetDisplayCallback(
+    std::function<void(std::chrono::nanoseconds latency)> callback) {
+    std::scoped_lock lock{swapchain_mutex};
+    display_callback = std::move(callback);
+}
+
 void PresentWindow::NotifySurfaceChanged() {
 #ifdef ANDROID
     std::scoped_lock lock{recreate_surface_mutex};
@@ -344,7 +447,7 @@ void PresentWindow::NotifySurfaceChanged() {
 #endif
 }
 
-void PresentWindow::CopyToSwapchain(Frame* frame) {
+void PresentWindow::CopyToSwapchain(Frame* frame, bool repeat) {
     const auto recreate_swapchain = [&] {
 #ifdef ANDROID
         {
@@ -356,6 +459,7 @@ void PresentWindow::CopyToSwapchain(Frame* frame) {
         std::scoped_lock submit_lock{scheduler.submit_mutex};
         graphics_queue.waitIdle();
         swapchain.Create(frame->width, frame->height, surface);
+        frame_pacer.SetRefreshInterval(swapchain.GetRefreshInterval());
     };
 
 #ifndef ANDROID
@@ -375,6 +479,16 @@ void PresentWindow::CopyToSwapchain(Frame* frame) {
 
     const vk::Image swapchain_image = swapchain.Image();
 
+    // A repeated frame was already submitted once, wait for that copy before reusing its
+    // command buffer and fence.
+    if (repeat) {
+        const vk::Device device = instance.GetDevice();
+        while (device.waitForFences(frame->present_done, false, std::numeric_limits<u64>::max()) !=
+               vk::Result::eSuccess) {
+        }
+        device.resetFences(frame->present_done);
+    }
+
     const vk::CommandBufferBeginInfo begin_info = {
         .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
     };
@@ -437,7 +551,10 @@ void PresentWindow::CopyToSwapchain(Frame* frame) {
                            vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlagBits::eByRegion,
                            {}, {}, pre_barriers);
 
-    if (blit_supported) {
+    if (repeat && refresh_hook) {
+        refresh_hook(cmdbuf, *frame, swapchain_image, extent,
+                     frame_pacer.Phase(VideoCore::FramePacer::Clock::now()));
+    } else if (blit_supported) {
         cmdbuf.blitImage(frame->image, vk::ImageLayout::eTransferSrcOptimal, swapchain_image,
                          vk::ImageLayout::eTransferDstOptimal,
                          MakeImageBlit(frame->width, frame->height, extent.width, extent.height),
@@ -463,8 +580,9 @@ void PresentWindow::CopyToSwapchain(Frame* frame) {
     const vk::Semaphore image_acquired = swapchain.GetImageAcquiredSemaphore();
     const std::array wait_semaphores = {image_acquired, frame->render_ready};
 
+    // The render semaphore of a repeated frame was consumed by its first presentation.
     vk::SubmitInfo submit_info = {
-        .waitSemaphoreCount = static_cast<u32>(wait_semaphores.size()),
+        .waitSemaphoreCount = repeat ? 1u : static_cast<u32>(wait_semaphores.size()),
         .pWaitSemaphores = wait_semaphores.data(),
         .pWaitDstStageMask = wait_stage_masks.data(),
         .commandBufferCount = 1u,
@@ -482,7 +600,16 @@ void PresentWindow::CopyToSwapchain(Frame* frame) {
         UNREACHABLE();
     }
 
-    swapchain.Present();
+    // With frame pacing each refresh is scheduled for a vblank of its own
+    const auto now = VideoCore::FramePacer::Clock::now();
+    swapchain.Present(Settings::values.frame_pacing.GetValue() ? frame_pacer.NextVsync(now)
+                                                               : Swapchain::Clock::time_point{});
+    for (const auto& timing : swapchain.GetPastPresentTimings()) {
+        frame_pacer.OnDisplayed(timing.present_time, timing.display_time);
+        if (display_callback && timing.display_time > timing.present_time) {
+            display_callback(timing.display_time - timing.present_time);
+        }
+    }
 }
 
 vk::RenderPass PresentWindow::CreateRenderpass() {
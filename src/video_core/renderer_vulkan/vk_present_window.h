@@ -4,9 +4,11 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <queue>
 #include "common/polyfill_thread.h"
+#include "video_core/frame_pacer.h"
 #include "video_core/renderer_vulkan/vk_swapchain.h"
 
 VK_DEFINE_HANDLE(VmaAllocation)
@@ -36,6 +38,14 @@ struct Frame {
 
 class PresentWindow final {
 public:
+    /**
+     * Records the contents of a refresh that has no new guest frame into the swapchain image,
+     * which is in TransferDstOptimal layout. Phase is how far the refresh lies between the last
+     * guest frame and the next one, allowing the hook to interpolate instead of repeating frame.
+     */
+    using RefreshHook = std::function<void(vk::CommandBuffer cmdbuf, const Frame& frame,
+                                           vk::Image target, vk::Extent2D extent, float phase)>;
+
     explicit PresentWindow(Frontend::EmuWindow& emu_window, const Instance& instance,
                            Scheduler& scheduler);
     ~PresentWindow();
@@ -46,6 +56,9 @@ public:
     /// Returns the last used render frame.
     Frame* GetRenderFrame();
 
+    /// Returns true when GetRenderFrame would wait for the present thread.
+    bool IsPresentPending();
+
     /// Recreates the render frame to match provided parameters.
     void RecreateFrame(Frame* frame, u32 width, u32 height);
 
@@ -55,10 +68,26 @@ public:
     /// This is called to notify the rendering backend of a surface change
     void NotifySurfaceChanged();
 
+    /// Sets the hook used to fill paced refreshes, or clears it to repeat the last frame.
+    void SetRefreshHook(RefreshHook hook);
+
+    /// Sets a callback invoked on the present thread whenever a new frame has been presented.
+    void SetPresentCallback(std::function<void()> callback);
+
+    /**
+     * Sets a callback invoked on the present thread with the time between presenting an image and
+     * the display showing it, whenever the presentation engine reports it.
+     */
+    void SetDisplayCallback(std::function<void(std::chrono::nanoseconds latency)> callback);
+
     [[nodiscard]] vk::RenderPass Renderpass() const noexcept {
         return present_renderpass;
     }
 
+    [[nodiscard]] vk::Format SurfaceFormat() const {
+        return swapchain.GetSurfaceFormat().format;
+    }
+
     u32 ImageCount() const noexcept {
         return swapchain.GetImageCount();
     }
@@ -66,7 +95,13 @@ public:
 private:
     void PresentThread(std::stop_token token);
 
-    void CopyToSwapchain(Frame* frame);
+    /// Returns true if refreshes without a new guest frame should repeat the held frame.
+    bool IsPacing(VideoCore::FramePacer::Clock::time_point now) const;
+
+    /// Returns the frame held for repeated refreshes to the free queue.
+    void ReleaseHeldFrame();
+
+    void CopyToSwapchain(Frame* frame, bool repeat = false);
 
     vk::RenderPass CreateRenderpass();
 
@@ -91,9 +126,16 @@ private:
     std::mutex queue_mutex;
     std::mutex free_mutex;
     std::jthread present_thread;
+    VideoCore::FramePacer frame_pacer;
+    RefreshHook refresh_hook;
+    std::function<void()> present_callback;
+    std::function<void(std::chrono::nanoseconds)> display_callback;
+    u32 queued_frames{};
+    Frame* held_frame{};
     bool vsync_enabled{};
     bool blit_supported;
     bool use_present_thread{true};
+    bool low_latency{};
     void* last_render_surface{};
 };
 
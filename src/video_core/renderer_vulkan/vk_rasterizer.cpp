@@ -16,6 +16,8 @@
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/texture/texture_decode.h"
 
+#include <vk_mem_alloc.h>
+
 namespace Vulkan {
 
 namespace {
@@ -41,10 +43,23 @@ struct DrawParams {
     u32 vertex_count;
     s32 vertex_offset;
     u32 binding_count;
+    std::array<vk::Buffer, 16> buffers;
     std::array<u32, 16> bindings;
     bool is_indexed;
 };
 
+/// Copies vertex_num vertices of the array, padding each one to the aligned stride
+void CopyVertexArray(u8* dst_ptr, const u8* src_ptr, u32 stride, u32 aligned_stride,
+                     u32 vertex_num) {
+    if (aligned_stride == stride) {
+        std::memcpy(dst_ptr, src_ptr, stride * vertex_num);
+        return;
+    }
+    for (std::size_t vertex = 0; vertex < vertex_num; vertex++) {
+        std::memcpy(dst_ptr + vertex * aligned_stride, src_ptr + vertex * stride, stride);
+    }
+}
+
 [[nodiscard]] u64 TextureBufferSize(const Instance& instance) {
     // Use the smallest texel size from the texel views
     // which corresponds to eR32G32Sfloat
@@ -61,8 +76,8 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
                                    Scheduler& scheduler, DescriptorPool& pool,
                                    RenderpassCache& renderpass_cache, u32 image_count)
     : RasterizerAccelerated{memory, pica}, instance{instance}, scheduler{scheduler},
-      renderpass_cache{renderpass_cache}, pipeline_cache{instance, scheduler, renderpass_cache,
-                                                         pool},
+      renderpass_cache{renderpass_cache}, pipeline_cache{renderer.GetSystem(), instance, scheduler,
+                                                         renderpass_cache, pool},
       runtime{instance,   scheduler, renderpass_cache, pool, pipeline_cache.TextureProvider(),
               image_count},
       res_cache{memory, custom_tex_manager, runtime, regs, renderer},
@@ -73,7 +88,10 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
                      TextureBufferSize(instance)},
       texture_lf_buffer{instance, scheduler, vk::BufferUsageFlagBits::eUniformTexelBuffer,
                         TextureBufferSize(instance)},
-      async_shaders{Settings::values.async_shader_compilation.GetValue()} {
+      async_shaders{Settings::values.async_shader_compilation.GetValue()},
+      vertex_array_cache{[this](VertexArrayBuffer&& buffer) {
+          vertex_array_garbage.emplace_back(scheduler.CurrentTick(), buffer);
+      }} {
 
     vertex_buffers.fill(stream_buffer.Handle());
 
@@ -82,6 +100,8 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
         Common::AlignUp(sizeof(VSPicaUniformData), uniform_buffer_alignment);
     uniform_size_aligned_vs = Common::AlignUp(sizeof(VSUniformData), uniform_buffer_alignment);
     uniform_size_aligned_fs = Common::AlignUp(sizeof(FSUniformData), uniform_buffer_alignment);
+    uniform_size_aligned_fs_config =
+        Common::AlignUp(sizeof(FSConfigData), uniform_buffer_alignment);
 
     // Define vertex layout for software shaders
     MakeSoftwareVertexLayout();
@@ -112,6 +132,7 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
     pipeline_cache.BindBuffer(0, uniform_buffer.Handle(), 0, sizeof(VSPicaUniformData));
     pipeline_cache.BindBuffer(1, uniform_buffer.Handle(), 0, sizeof(VSUniformData));
     pipeline_cache.BindBuffer(2, uniform_buffer.Handle(), 0, sizeof(FSUniformData));
+    pipeline_cache.BindBuffer(FS_CONFIG_BINDING, uniform_buffer.Handle(), 0, sizeof(FSConfigData));
     pipeline_cache.BindTexelBuffer(3, *texture_lf_view);
     pipeline_cache.BindTexelBuffer(4, *texture_rg_view);
     pipeline_cache.BindTexelBuffer(5, *texture_rgba_view);
@@ -129,15 +150,55 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
     SyncEntireState();
 }
 
-RasterizerVulkan::~RasterizerVulkan() = default;
+RasterizerVulkan::~RasterizerVulkan() {
+    scheduler.Finish();
+    vertex_array_cache.Clear();
+    for (const auto& [tick, buffer] : vertex_array_garbage) {
+        vmaDestroyBuffer(instance.GetAllocator(), buffer.buffer, buffer.allocation);
+    }
+}
 
 void RasterizerVulkan::TickFrame() {
     res_cache.TickFrame();
+    runtime.TickFrame();
+    vertex_array_cache.TickFrame();
+    pipeline_cache.TickFrame();
+    CollectVertexArrayBuffers();
+}
+
+VideoCore::CacheStats RasterizerVulkan::GetCacheStats() const {
+    const auto& eviction = res_cache.GetEvictionStats();
+    const auto& cpu_fallbacks = res_cache.GetCpuFallbackStats();
+    const auto& pipeline_waits = pipeline_cache.GetPipelineWaitStats();
+    return {
+        .pipelines = pipeline_cache.NumPipelines(),
+        .shaders = pipeline_cache.NumShaders(),
+        .surface_memory = eviction.memory_usage,
+        .evicted_surfaces = eviction.evicted_surfaces,
+        .flushed_surfaces = eviction.flushed_surfaces,
+        .cpu_reinterpretations = cpu_fallbacks.reinterpretations,
+        .cpu_fills = cpu_fallbacks.fills,
+        .pipeline_waits = pipeline_waits.waits,
+        .pipeline_wait_us = pipeline_waits.total_us,
+        .pipeline_max_wait_us = pipeline_waits.max_us,
+    };
+}
+
+void RasterizerVulkan::CollectVertexArrayBuffers() {
+    if (vertex_array_garbage.empty()) {
+        return;
+    }
+    scheduler.Refresh();
+    while (!vertex_array_garbage.empty() && scheduler.IsFree(vertex_array_garbage.front().first)) {
+        const auto& buffer = vertex_array_garbage.front().second;
+        vmaDestroyBuffer(instance.GetAllocator(), buffer.buffer, buffer.allocation);
+        vertex_array_garbage.pop_front();
+    }
 }
 
 void RasterizerVulkan::LoadDiskResources(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
-    pipeline_cache.LoadDiskCache();
+    pipeline_cache.LoadDiskCache(stop_loading, callback);
 }
 
 void RasterizerVulkan::SyncFixedState() {
@@ -227,19 +288,10 @@ void RasterizerVulkan::SetupVertexArray() {
         }
 
         const u8* src_ptr = src_ref.GetPtr();
-        u8* dst_ptr = array_ptr + buffer_offset;
 
         // Align stride up if required by Vulkan implementation.
-        const u32 aligned_stride =
-            Common::AlignUp(static_cast<u32>(loader.byte_count), stride_alignment);
-        if (aligned_stride == loader.byte_count) {
-            std::memcpy(dst_ptr, src_ptr, data_size);
-        } else {
-            for (std::size_t vertex = 0; vertex < vertex_num; vertex++) {
-                std::memcpy(dst_ptr + vertex * aligned_stride, src_ptr + vertex * loader.byte_count,
-                            loader.byte_count);
-            }
-        }
+        const u32 stride = loader.byte_count;
+        const u32 aligned_stride = Common::AlignUp(stride, stride_alignment);
 
         // Create the binding associated with this loader
         VertexBinding& binding = layout.bindings[layout.binding_count];
@@ -247,7 +299,25 @@ void RasterizerVulkan::SetupVertexArray() {
         binding.fixed.Assign(0);
         binding.stride.Assign(aligned_stride);
 
+        // Bind the array from its persistent buffer when unchanged, otherwise stream it
+        const VertexArrayBuffer* cached =
+            src_ref.GetSize() < data_size
+                ? nullptr
+                : vertex_array_cache.Get(data_addr, stride, {src_ptr, data_size},
+                                         aligned_stride * vertex_num, [&] {
+                                             return CreateVertexArrayBuffer(
+                                                 src_ptr, stride, aligned_stride, vertex_num);
+                                         });
+        if (cached) {
+            vertex_buffers[layout.binding_count] = cached->buffer;
+            binding_offsets[layout.binding_count++] = 0;
+            continue;
+        }
+
+        CopyVertexArray(array_ptr + buffer_offset, src_ptr, stride, aligned_stride, vertex_num);
+
         // Keep track of the binding offsets so we can bind the vertex buffer later
+        vertex_buffers[layout.binding_count] = stream_buffer.Handle();
         binding_offsets[layout.binding_count++] = static_cast<u32>(array_offset + buffer_offset);
         buffer_offset += Common::AlignUp(aligned_stride * vertex_num, 4);
     }
@@ -258,11 +328,85 @@ void RasterizerVulkan::SetupVertexArray() {
     SetupFixedAttribs();
 }
 
+void RasterizerVulkan::SetupImmediateArray() {
+    const u32 stride = ImmediateVertexStride();
+    const u32 size = stride * static_cast<u32>(immediate_vertices.size());
+    auto [array_ptr, array_offset, invalidate] = stream_buffer.Map(size, 16);
+    LoadImmediateVertices(immediate_vertices, array_ptr);
+
+    VertexLayout& layout = pipeline_info.vertex_layout;
+    layout.binding_count = 0;
+    layout.attribute_count = 16;
+    enable_attributes.fill(false);
+
+    // Every input attribute is part of the vertex, stored as a float vector in attribute order.
+    const u32 num_attributes = stride / sizeof(Common::Vec4f);
+    for (u32 attr = 0; attr < num_attributes; attr++) {
+        const u32 input_reg = regs.vs.GetRegisterForAttribute(attr);
+        VertexAttribute& attribute = layout.attributes[input_reg];
+        attribute.binding.Assign(layout.binding_count);
+        attribute.location.Assign(input_reg);
+        attribute.offset.Assign(attr * sizeof(Common::Vec4f));
+        attribute.type.Assign(Pica::PipelineRegs::VertexAttributeFormat::FLOAT);
+        attribute.size.Assign(4);
+        enable_attributes[input_reg] = true;
+    }
+
+    VertexBinding& binding = layout.bindings[layout.binding_count];
+    binding.binding.Assign(layout.binding_count);
+    binding.fixed.Assign(0);
+    binding.stride.Assign(stride);
+
+    vertex_buffers[layout.binding_count] = stream_buffer.Handle();
+    binding_offsets[layout.binding_count++] = static_cast<u32>(array_offset);
+    stream_buffer.Commit(size);
+
+    SetupFixedAttribs();
+}
+
+RasterizerVulkan::VertexArrayBuffer RasterizerVulkan::CreateVertexArrayBuffer(const u8* data,
+                                                                              u32 stride,
+                                                                              u32 aligned_stride,
+                                                                              u32 vertex_num) {
+    const vk::BufferCreateInfo buffer_info = {
+        .size = aligned_stride * vertex_num,
+        .usage = vk::BufferUsageFlagBits::eVertexBuffer,
+    };
+    const VmaAllocationCreateInfo alloc_create_info = {
+        .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT |
+                 VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO,
+        .requiredFlags = 0,
+        .preferredFlags = 0,
+        .pool = VK_NULL_HANDLE,
+        .pUserData = nullptr,
+    };
+
+    VkBuffer unsafe_buffer{};
+    VmaAllocation allocation{};
+    VmaAllocationInfo alloc_info;
+    VkBufferCreateInfo unsafe_buffer_info = static_cast<VkBufferCreateInfo>(buffer_info);
+    const VkResult result = vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info,
+                                            &alloc_create_info, &unsafe_buffer, &allocation,
+                                            &alloc_info);
+    if (result != VK_SUCCESS) [[unlikely]] {
+        LOG_CRITICAL(Render_Vulkan, "Failed allocating vertex array buffer with error {}", result);
+        UNREACHABLE();
+    }
+
+    // The buffer is never written again, a new one is created when the guest data changes.
+    CopyVertexArray(static_cast<u8*>(alloc_info.pMappedData), data, stride, aligned_stride,
+                    vertex_num);
+    vmaFlushAllocation(instance.GetAllocator(), allocation, 0, VK_WHOLE_SIZE);
+    return {vk::Buffer{unsafe_buffer}, allocation};
+}
+
 void RasterizerVulkan::SetupFixedAttribs() {
     const auto& vertex_attributes = regs.pipeline.vertex_attributes;
     VertexLayout& layout = pipeline_info.vertex_layout;
 
     auto [fixed_ptr, fixed_offset, _] = stream_buffer.Map(16 * sizeof(Common::Vec4f), 0);
+    vertex_buffers[layout.binding_count] = stream_buffer.Handle();
     binding_offsets[layout.binding_count] = static_cast<u32>(fixed_offset);
 
     // Reserve the last binding for fixed and default attributes
@@ -345,13 +489,10 @@ bool RasterizerVulkan::SetupGeometryShader() {
 }
 
 bool RasterizerVulkan::AccelerateDrawBatch(bool is_indexed) {
+    // Geometry shaders have no host path here, so leave them to the software pipeline before any
+    // vertex data is set up.
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        if (regs.pipeline.gs_config.mode != Pica::PipelineRegs::GSMode::Point) {
-            return false;
-        }
-        if (regs.pipeline.triangle_topology != Pica::PipelineRegs::TriangleTopology::Shader) {
-            return false;
-        }
+        return false;
     }
 
     pipeline_info.rasterization.topology.Assign(regs.pipeline.triangle_topology);
@@ -377,20 +518,39 @@ bool RasterizerVulkan::AccelerateDrawBatch(bool is_indexed) {
     return Draw(true, is_indexed);
 }
 
+bool RasterizerVulkan::AccelerateDrawImmediate(std::span<const Pica::AttributeBuffer> vertices) {
+    pipeline_info.rasterization.topology.Assign(regs.pipeline.triangle_topology);
+
+    // Vertex data setup might involve scheduler flushes so perform it
+    // early to avoid invalidating our state in the middle of the draw.
+    immediate_vertices = vertices;
+    vertex_info = {0, static_cast<u32>(vertices.size()) - 1,
+                   ImmediateVertexStride() * static_cast<u32>(vertices.size())};
+    SetupImmediateArray();
+
+    const bool succeeded = SetupVertexShader() && SetupGeometryShader() && Draw(true, false);
+    immediate_vertices = {};
+    return succeeded;
+}
+
 bool RasterizerVulkan::AccelerateDrawBatchInternal(bool is_indexed) {
     if (is_indexed) {
         SetupIndexArray();
     }
 
-    const bool wait_built = !async_shaders || regs.pipeline.num_vertices <= 6;
+    const u32 vertex_count = immediate_vertices.empty()
+                                 ? regs.pipeline.num_vertices
+                                 : static_cast<u32>(immediate_vertices.size());
+    const bool wait_built = !async_shaders || vertex_count <= 6;
     if (!pipeline_cache.BindPipeline(pipeline_info, wait_built)) {
         return true;
     }
 
     const DrawParams params = {
-        .vertex_count = regs.pipeline.num_vertices,
+        .vertex_count = vertex_count,
         .vertex_offset = -static_cast<s32>(vertex_info.vs_input_index_min),
         .binding_count = pipeline_info.vertex_layout.binding_count,
+        .buffers = vertex_buffers,
         .bindings = binding_offsets,
         .is_indexed = is_indexed,
     };
@@ -399,7 +559,7 @@ bool RasterizerVulkan::AccelerateDrawBatchInternal(bool is_indexed) {
         std::array<vk::DeviceSize, 16> offsets;
         std::transform(params.bindings.begin(), params.bindings.end(), offsets.begin(),
                        [](u32 offset) { return static_cast<vk::DeviceSize>(offset); });
-        cmdbuf.bindVertexBuffers(0, params.binding_count, vertex_buffers.data(), offsets.data());
+        cmdbuf.bindVertexBuffers(0, params.binding_count, params.buffers.data(), offsets.data());
         if (params.is_indexed) {
             cmdbuf.drawIndexed(params.vertex_count, 1, 0, params.vertex_offset, 0);
         } else {
@@ -470,7 +630,7 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
 
     const auto fb_helper = res_cache.GetFramebufferSurfaces(using_color_fb, using_depth_fb);
     const Framebuffer* framebuffer = fb_helper.Framebuffer();
-    if (!framebuffer->Handle()) {
+    if (!framebuffer->IsValid()) {
         return true;
     }
 
@@ -504,6 +664,7 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
     // Sync and bind the shader
     if (shader_dirty) {
         pipeline_cache.UseFragmentShader(regs, user_config);
+        fs_config_dirty = pipeline_cache.IsUberShaderEnabled();
         shader_dirty = false;
     }
 
@@ -735,6 +896,10 @@ void RasterizerVulkan::FlushAndInvalidateRegion(PAddr addr, u32 size) {
     res_cache.InvalidateRegion(addr, size);
 }
 
+bool RasterizerVulkan::IsReadbackTarget(PAddr addr) const {
+    return res_cache.IsReadbackTarget(addr);
+}
+
 void RasterizerVulkan::ClearAll(bool flush) {
     res_cache.ClearAll(flush);
 }
@@ -751,6 +916,10 @@ bool RasterizerVulkan::AccelerateFill(const Pica::MemoryFillConfig& config) {
     return res_cache.AccelerateFill(config);
 }
 
+bool RasterizerVulkan::AccelerateY2R(const VideoCore::Y2RConfig& config) {
+    return res_cache.AccelerateY2R(config);
+}
+
 bool RasterizerVulkan::AccelerateDisplay(const Pica::FramebufferConfig& config,
                                          PAddr framebuffer_addr, u32 pixel_stride,
                                          ScreenInfo& screen_info) {
@@ -932,15 +1101,13 @@ void RasterizerVulkan::SyncAndUploadLUTsLF() {
     if (fs_uniform_block_data.lighting_lut_dirty_any || invalidate) {
         for (unsigned index = 0; index < fs_uniform_block_data.lighting_lut_dirty.size(); index++) {
             if (fs_uniform_block_data.lighting_lut_dirty[index] || invalidate) {
-                std::array<Common::Vec2f, 256> new_data;
                 const auto& source_lut = pica.lighting.luts[index];
-                std::transform(source_lut.begin(), source_lut.end(), new_data.begin(),
-                               [](const auto& entry) {
-                                   return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                               });
-
-                if (new_data != lighting_lut_data[index] || invalidate) {
-                    lighting_lut_data[index] = new_data;
+                if (UpdateLutHash(source_lut, lighting_lut_hashes[index]) || invalidate) {
+                    std::array<Common::Vec2f, 256> new_data;
+                    std::transform(source_lut.begin(), source_lut.end(), new_data.begin(),
+                                   [](const auto& entry) {
+                                       return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
+                                   });
                     std::memcpy(buffer + bytes_used, new_data.data(),
                                 new_data.size() * sizeof(Common::Vec2f));
                     fs_uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
@@ -956,15 +1123,12 @@ void RasterizerVulkan::SyncAndUploadLUTsLF() {
 
     // Sync the fog lut
     if (fs_uniform_block_data.fog_lut_dirty || invalidate) {
-        std::array<Common::Vec2f, 128> new_data;
-
-        std::transform(pica.fog.lut.begin(), pica.fog.lut.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                       });
-
-        if (new_data != fog_lut_data || invalidate) {
-            fog_lut_data = new_data;
+        if (UpdateLutHash(pica.fog.lut, fog_lut_hash) || invalidate) {
+            std::array<Common::Vec2f, 128> new_data;
+            std::transform(pica.fog.lut.begin(), pica.fog.lut.end(), new_data.begin(),
+                           [](const auto& entry) {
+                               return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
+                           });
             std::memcpy(buffer + bytes_used, new_data.data(),
                         new_data.size() * sizeof(Common::Vec2f));
             fs_uniform_block_data.data.fog_lut_offset =
@@ -975,6 +1139,7 @@ void RasterizerVulkan::SyncAndUploadLUTsLF() {
         fs_uniform_block_data.fog_lut_dirty = false;
     }
 
+    MICROPROFILE_META_CPU("LUT Upload Bytes", static_cast<int>(bytes_used));
     texture_lf_buffer.Commit(static_cast<u32>(bytes_used));
 }
 
@@ -999,14 +1164,12 @@ void RasterizerVulkan::SyncAndUploadLUTs() {
     auto sync_proctex_value_lut =
         [this, buffer = buffer, offset = offset, invalidate = invalidate,
          &bytes_used](const std::array<Pica::PicaCore::ProcTex::ValueEntry, 128>& lut,
-                      std::array<Common::Vec2f, 128>& lut_data, int& lut_offset) {
-            std::array<Common::Vec2f, 128> new_data;
-            std::transform(lut.begin(), lut.end(), new_data.begin(), [](const auto& entry) {
-                return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-            });
-
-            if (new_data != lut_data || invalidate) {
-                lut_data = new_data;
+                      u64& lut_hash, int& lut_offset) {
+            if (UpdateLutHash(lut, lut_hash) || invalidate) {
+                std::array<Common::Vec2f, 128> new_data;
+                std::transform(lut.begin(), lut.end(), new_data.begin(), [](const auto& entry) {
+                    return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
+                });
                 std::memcpy(buffer + bytes_used, new_data.data(),
                             new_data.size() * sizeof(Common::Vec2f));
                 lut_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
@@ -1017,37 +1180,34 @@ void RasterizerVulkan::SyncAndUploadLUTs() {
 
     // Sync the proctex noise lut
     if (fs_uniform_block_data.proctex_noise_lut_dirty || invalidate) {
-        sync_proctex_value_lut(proctex.noise_table, proctex_noise_lut_data,
+        sync_proctex_value_lut(proctex.noise_table, proctex_noise_lut_hash,
                                fs_uniform_block_data.data.proctex_noise_lut_offset);
         fs_uniform_block_data.proctex_noise_lut_dirty = false;
     }
 
     // Sync the proctex color map
     if (fs_uniform_block_data.proctex_color_map_dirty || invalidate) {
-        sync_proctex_value_lut(proctex.color_map_table, proctex_color_map_data,
+        sync_proctex_value_lut(proctex.color_map_table, proctex_color_map_hash,
                                fs_uniform_block_data.data.proctex_color_map_offset);
         fs_uniform_block_data.proctex_color_map_dirty = false;
     }
 
     // Sync the proctex alpha map
     if (fs_uniform_block_data.proctex_alpha_map_dirty || invalidate) {
-        sync_proctex_value_lut(proctex.alpha_map_table, proctex_alpha_map_data,
+        sync_proctex_value_lut(proctex.alpha_map_table, proctex_alpha_map_hash,
                                fs_uniform_block_data.data.proctex_alpha_map_offset);
         fs_uniform_block_data.proctex_alpha_map_dirty = false;
     }
 
     // Sync the proctex lut
     if (fs_uniform_block_data.proctex_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(proctex.color_table.begin(), proctex.color_table.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_lut_data || invalidate) {
-            proctex_lut_data = new_data;
+        if (UpdateLutHash(proctex.color_table, proctex_lut_hash) || invalidate) {
+            std::array<Common::Vec4f, 256> new_data;
+            std::transform(proctex.color_table.begin(), proctex.color_table.end(), new_data.begin(),
+                           [](const auto& entry) {
+                               auto rgba = entry.ToVector() / 255.0f;
+                               return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
+                           });
             std::memcpy(buffer + bytes_used, new_data.data(),
                         new_data.size() * sizeof(Common::Vec4f));
             fs_uniform_block_data.data.proctex_lut_offset =
@@ -1060,16 +1220,13 @@ void RasterizerVulkan::SyncAndUploadLUTs() {
 
     // Sync the proctex difference lut
     if (fs_uniform_block_data.proctex_diff_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(proctex.color_diff_table.begin(), proctex.color_diff_table.end(),
-                       new_data.begin(), [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_diff_lut_data || invalidate) {
-            proctex_diff_lut_data = new_data;
+        if (UpdateLutHash(proctex.color_diff_table, proctex_diff_lut_hash) || invalidate) {
+            std::array<Common::Vec4f, 256> new_data;
+            std::transform(proctex.color_diff_table.begin(), proctex.color_diff_table.end(),
+                           new_data.begin(), [](const auto& entry) {
+                               auto rgba = entry.ToVector() / 255.0f;
+                               return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
+                           });
             std::memcpy(buffer + bytes_used, new_data.data(),
                         new_data.size() * sizeof(Common::Vec4f));
             fs_uniform_block_data.data.proctex_diff_lut_offset =
@@ -1080,19 +1237,21 @@ void RasterizerVulkan::SyncAndUploadLUTs() {
         fs_uniform_block_data.proctex_diff_lut_dirty = false;
     }
 
+    MICROPROFILE_META_CPU("LUT Upload Bytes", static_cast<int>(bytes_used));
     texture_buffer.Commit(static_cast<u32>(bytes_used));
 }
 
 void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
-    const bool sync_vs_pica = accelerate_draw;
+    const bool sync_vs_pica = accelerate_draw && SyncVSPicaUniforms();
     const bool sync_vs = vs_uniform_block_data.dirty;
     const bool sync_fs = fs_uniform_block_data.dirty;
-    if (!sync_vs_pica && !sync_vs && !sync_fs) {
+    const bool sync_fs_config = fs_config_dirty;
+    if (!sync_vs_pica && !sync_vs && !sync_fs && !sync_fs_config) {
         return;
     }
 
-    const u64 uniform_size =
-        uniform_size_aligned_vs_pica + uniform_size_aligned_vs + uniform_size_aligned_fs;
+    const u64 uniform_size = uniform_size_aligned_vs_pica + uniform_size_aligned_vs +
+                             uniform_size_aligned_fs + uniform_size_aligned_fs_config;
     auto [uniforms, offset, invalidate] =
         uniform_buffer.Map(uniform_size, uniform_buffer_alignment);
 
@@ -1116,15 +1275,27 @@ void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
         used_bytes += static_cast<u32>(uniform_size_aligned_fs);
     }
 
-    if (sync_vs_pica) {
-        VSPicaUniformData vs_uniforms;
-        vs_uniforms.uniforms.SetFromRegs(regs.vs, pica.vs_setup);
-        std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
+    if (sync_fs_config || (invalidate && pipeline_cache.IsUberShaderEnabled())) {
+        const auto& config_data = pipeline_cache.FragmentConfigData();
+        std::memcpy(uniforms + used_bytes, &config_data, sizeof(config_data));
+
+        pipeline_cache.SetBufferOffset(FS_CONFIG_BINDING, offset + used_bytes);
+        fs_config_dirty = false;
+        used_bytes += static_cast<u32>(uniform_size_aligned_fs_config);
+    }
+
+    if (sync_vs_pica || (accelerate_draw && invalidate)) {
+        std::memcpy(uniforms + used_bytes, &vs_pica_uniform_data, sizeof(vs_pica_uniform_data));
 
         pipeline_cache.SetBufferOffset(0, offset + used_bytes);
         used_bytes += static_cast<u32>(uniform_size_aligned_vs_pica);
+        vs_pica_uniforms_changed = false;
+    } else if (invalidate) {
+        // The previous upload is no longer valid, so it has to be repeated on the next draw.
+        vs_pica_uniforms_changed = true;
     }
 
+    MICROPROFILE_META_CPU("Uniform Upload Bytes", static_cast<int>(used_bytes));
     uniform_buffer.Commit(used_bytes);
 }
 
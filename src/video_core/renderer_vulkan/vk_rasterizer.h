@@ -4,11 +4,13 @@
 
 #pragma once
 
+#include <deque>
 #include "video_core/rasterizer_accelerated.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
 #include "video_core/renderer_vulkan/vk_stream_buffer.h"
 #include "video_core/renderer_vulkan/vk_texture_runtime.h"
+#include "video_core/vertex_array_cache.h"
 
 namespace Frontend {
 class EmuWindow;
@@ -52,13 +54,17 @@ public:
     void FlushRegion(PAddr addr, u32 size) override;
     void InvalidateRegion(PAddr addr, u32 size) override;
     void FlushAndInvalidateRegion(PAddr addr, u32 size) override;
+    bool IsReadbackTarget(PAddr addr) const override;
     void ClearAll(bool flush) override;
     bool AccelerateDisplayTransfer(const Pica::DisplayTransferConfig& config) override;
     bool AccelerateTextureCopy(const Pica::DisplayTransferConfig& config) override;
     bool AccelerateFill(const Pica::MemoryFillConfig& config) override;
+    bool AccelerateY2R(const VideoCore::Y2RConfig& config) override;
     bool AccelerateDisplay(const Pica::FramebufferConfig& config, PAddr framebuffer_addr,
                            u32 pixel_stride, ScreenInfo& screen_info);
     bool AccelerateDrawBatch(bool is_indexed) override;
+    bool AccelerateDrawImmediate(std::span<const Pica::AttributeBuffer> vertices) override;
+    VideoCore::CacheStats GetCacheStats() const override;
 
     void SyncFixedState() override;
 
@@ -127,9 +133,24 @@ private:
     /// Setup index array for AccelerateDrawBatch
     void SetupIndexArray();
 
+    struct VertexArrayBuffer {
+        vk::Buffer buffer;
+        VmaAllocation allocation;
+    };
+
     /// Setup vertex array for AccelerateDrawBatch
     void SetupVertexArray();
 
+    /// Setup vertex array for AccelerateDrawImmediate
+    void SetupImmediateArray();
+
+    /// Creates the persistent buffer of a vertex array that is redrawn unchanged
+    VertexArrayBuffer CreateVertexArrayBuffer(const u8* data, u32 stride, u32 aligned_stride,
+                                              u32 vertex_num);
+
+    /// Destroys the released vertex array buffers the GPU is done with
+    void CollectVertexArrayBuffers();
+
     /// Setup the fixed attribute emulation in vulkan
     void SetupFixedAttribs();
 
@@ -155,6 +176,7 @@ private:
     std::array<bool, 16> enable_attributes{};
     std::array<vk::Buffer, 16> vertex_buffers;
     VertexArrayInfo vertex_info;
+    std::span<const Pica::AttributeBuffer> immediate_vertices;
     PipelineInfo pipeline_info{};
 
     StreamBuffer stream_buffer;     ///< Vertex+Index buffer
@@ -168,7 +190,11 @@ private:
     u64 uniform_size_aligned_vs_pica;
     u64 uniform_size_aligned_vs;
     u64 uniform_size_aligned_fs;
+    u64 uniform_size_aligned_fs_config;
+    bool fs_config_dirty{};
     bool async_shaders{false};
+    VideoCore::VertexArrayCache<VertexArrayBuffer> vertex_array_cache;
+    std::deque<std::pair<u64, VertexArrayBuffer>> vertex_array_garbage;
 };
 
 } // namespace Vulkan
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <limits>
+#include <utility>
 #include "common/assert.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
@@ -34,6 +35,27 @@ void RenderpassCache::BeginRendering(const Framebuffer* framebuffer,
             .height = draw_rect.GetHeight(),
         },
     };
+    images = framebuffer->Images();
+    aspects = framebuffer->Aspects();
+    if (instance.IsDynamicRenderingSupported()) {
+        // Shadow rendering writes through a storage image and has no attachments.
+        const bool has_attachments = !framebuffer->shadow_rendering;
+        const RenderPass new_pass = {
+            .render_area = render_area,
+            .clear = {},
+            .do_clear = false,
+            .color_view = has_attachments ? framebuffer->ImageView(SurfaceType::Color)
+                                          : vk::ImageView{},
+            .depth_view = has_attachments ? framebuffer->ImageView(SurfaceType::Depth)
+                                          : vk::ImageView{},
+            .has_stencil = VideoCore::GetFormatType(framebuffer->Format(SurfaceType::Depth)) ==
+                           SurfaceType::DepthStencil,
+            .is_dynamic = true,
+        };
+        BeginDynamicRendering(new_pass);
+        return;
+    }
+
     const RenderPass new_pass = {
         .framebuffer = framebuffer->Handle(),
         .render_pass = framebuffer->RenderPass(),
@@ -41,19 +63,56 @@ void RenderpassCache::BeginRendering(const Framebuffer* framebuffer,
         .clear = {},
         .do_clear = false,
     };
-    images = framebuffer->Images();
-    aspects = framebuffer->Aspects();
     BeginRendering(new_pass);
 }
 
-void RenderpassCache::BeginRendering(const RenderPass& new_pass) {
+void RenderpassCache::BeginDynamicRendering(const RenderPass& new_pass) {
     if (pass == new_pass) [[likely]] {
         num_draws++;
         return;
     }
 
+    // Dynamic rendering instances are recorded inline, secondary command buffers would need to
+    // inherit the attachment formats instead of a render pass.
     EndRendering();
+    pass_scope = scheduler.BeginProfileScope("Render Pass");
     scheduler.Record([info = new_pass](vk::CommandBuffer cmdbuf) {
+        const vk::RenderingAttachmentInfoKHR color_attachment = {
+            .imageView = info.color_view,
+            .imageLayout = vk::ImageLayout::eGeneral,
+            .loadOp = vk::AttachmentLoadOp::eLoad,
+            .storeOp = vk::AttachmentStoreOp::eStore,
+        };
+        const vk::RenderingAttachmentInfoKHR depth_attachment = {
+            .imageView = info.depth_view,
+            .imageLayout = vk::ImageLayout::eGeneral,
+            .loadOp = vk::AttachmentLoadOp::eLoad,
+            .storeOp = vk::AttachmentStoreOp::eStore,
+        };
+        const vk::RenderingInfoKHR rendering_info = {
+            .renderArea = info.render_area,
+            .layerCount = 1,
+            .colorAttachmentCount = info.color_view ? 1u : 0u,
+            .pColorAttachments = &color_attachment,
+            .pDepthAttachment = info.depth_view ? &depth_attachment : nullptr,
+            .pStencilAttachment = info.depth_view && info.has_stencil ? &depth_attachment : nullptr,
+        };
+        cmdbuf.beginRenderingKHR(rendering_info);
+    });
+
+    pass = new_pass;
+}
+
+void RenderpassCache::BeginRendering(const RenderPass& new_pass) {
+    if (pass == new_pass) [[likely]] {
+        num_draws++;
+        return;
+    }
+
+    EndRendering();
+    pass_scope = scheduler.BeginProfileScope("Render Pass");
+    const bool use_secondary = scheduler.IsParallelRecordingEnabled();
+    scheduler.Record([info = new_pass, use_secondary](vk::CommandBuffer cmdbuf) {
         const vk::RenderPassBeginInfo renderpass_begin_info = {
             .renderPass = info.render_pass,
             .framebuffer = info.framebuffer,
@@ -61,19 +120,27 @@ void RenderpassCache::BeginRendering(const RenderPass& new_pass) {
             .clearValueCount = info.do_clear ? 1u : 0u,
             .pClearValues = &info.clear,
         };
-        cmdbuf.beginRenderPass(renderpass_begin_info, vk::SubpassContents::eInline);
+        cmdbuf.beginRenderPass(renderpass_begin_info,
+                               use_secondary ? vk::SubpassContents::eSecondaryCommandBuffers
+                                             : vk::SubpassContents::eInline);
     });
+    if (use_secondary) {
+        scheduler.BeginSecondaryRange(new_pass.render_pass, new_pass.framebuffer);
+    }
 
     pass = new_pass;
 }
 
 void RenderpassCache::EndRendering() {
-    if (!pass.render_pass) {
+    if (!pass.IsActive()) {
         return;
     }
 
+    const bool is_dynamic = pass.is_dynamic;
     pass.render_pass = vk::RenderPass{};
-    scheduler.Record([images = images, aspects = aspects](vk::CommandBuffer cmdbuf) {
+    pass.is_dynamic = false;
+    scheduler.EndSecondaryRange();
+    scheduler.Record([images = images, aspects = aspects, is_dynamic](vk::CommandBuffer cmdbuf) {
         u32 num_barriers = 0;
         vk::PipelineStageFlags pipeline_flags{};
         std::array<vk::ImageMemoryBarrier, 2> barriers;
@@ -107,13 +174,18 @@ void RenderpassCache::EndRendering() {
                 },
             };
         }
-        cmdbuf.endRenderPass();
+        if (is_dynamic) {
+            cmdbuf.endRenderingKHR();
+        } else {
+            cmdbuf.endRenderPass();
+        }
         cmdbuf.pipelineBarrier(pipeline_flags,
                                vk::PipelineStageFlagBits::eFragmentShader |
                                    vk::PipelineStageFlagBits::eTransfer,
                                vk::DependencyFlagBits::eByRegion, 0, nullptr, 0, nullptr,
                                num_barriers, barriers.data());
     });
+    scheduler.EndProfileScope(std::exchange(pass_scope, 0));
 
     // The Mali guide recommends flushing at the end of each major renderpass
     // Testing has shown this has a significant effect on rendering performance
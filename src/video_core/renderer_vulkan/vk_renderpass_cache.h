@@ -25,13 +25,24 @@ struct RenderPass {
     vk::Rect2D render_area;
     vk::ClearValue clear;
     bool do_clear;
+    /// Attachments rendered into directly when the pass is a dynamic rendering instance.
+    vk::ImageView color_view;
+    vk::ImageView depth_view;
+    bool has_stencil;
+    bool is_dynamic;
 
     bool operator==(const RenderPass& other) const noexcept {
-        return std::tie(framebuffer, render_pass, render_area, do_clear) ==
+        return std::tie(framebuffer, render_pass, render_area, do_clear, color_view, depth_view,
+                        has_stencil, is_dynamic) ==
                    std::tie(other.framebuffer, other.render_pass, other.render_area,
-                            other.do_clear) &&
+                            other.do_clear, other.color_view, other.depth_view, other.has_stencil,
+                            other.is_dynamic) &&
                std::memcmp(&clear, &other.clear, sizeof(vk::ClearValue)) == 0;
     }
+
+    [[nodiscard]] bool IsActive() const noexcept {
+        return render_pass || is_dynamic;
+    }
 };
 
 class RenderpassCache {
@@ -56,6 +67,9 @@ public:
                                  bool is_clear);
 
 private:
+    /// Records the start of a dynamic rendering instance into the provided image views
+    void BeginDynamicRendering(const RenderPass& new_pass);
+
     /// Creates a renderpass configured appropriately and stores it in cached_renderpasses
     vk::UniqueRenderPass CreateRenderPass(vk::Format color, vk::Format depth,
                                           vk::AttachmentLoadOp load_op) const;
@@ -68,6 +82,7 @@ private:
     std::array<vk::Image, 2> images;
     std::array<vk::ImageAspectFlags, 2> aspects;
     RenderPass pass{};
+    u64 pass_scope{};
     u32 num_draws{};
 };
 
@@ -69,8 +69,9 @@ struct CommandPool::Pool {
     std::array<vk::CommandBuffer, COMMAND_BUFFER_POOL_SIZE> cmdbufs;
 };
 
-CommandPool::CommandPool(const Instance& instance, MasterSemaphore* master_semaphore)
-    : ResourcePool{master_semaphore, COMMAND_BUFFER_POOL_SIZE}, instance{instance} {}
+CommandPool::CommandPool(const Instance& instance, MasterSemaphore* master_semaphore,
+                         vk::CommandBufferLevel level)
+    : ResourcePool{master_semaphore, COMMAND_BUFFER_POOL_SIZE}, instance{instance}, level{level} {}
 
 CommandPool::~CommandPool() {
     vk::Device device = instance.GetDevice();
@@ -95,7 +96,7 @@ void CommandPool::Allocate(std::size_t begin, std::size_t end) {
 
     const vk::CommandBufferAllocateInfo buffer_alloc_info = {
         .commandPool = pool.handle,
-        .level = vk::CommandBufferLevel::ePrimary,
+        .level = level,
         .commandBufferCount = COMMAND_BUFFER_POOL_SIZE,
     };
 
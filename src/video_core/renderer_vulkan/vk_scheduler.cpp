@@ -2,22 +2,39 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <mutex>
+#include <thread>
 #include <utility>
+#include "common/assert.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
 #include "common/thread.h"
+#include "video_core/gpu_profiler.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 
 MICROPROFILE_DEFINE(Vulkan_WaitForWorker, "Vulkan", "Wait for worker", MP_RGB(255, 192, 192));
 MICROPROFILE_DEFINE(Vulkan_Submit, "Vulkan", "Submit Exectution", MP_RGB(255, 192, 255));
+MICROPROFILE_DEFINE(Vulkan_RecordChunk, "Vulkan", "Record Chunk", MP_RGB(192, 255, 192));
+MICROPROFILE_DEFINE(Vulkan_RecordSecondary, "Vulkan", "Record Secondary", MP_RGB(128, 255, 128));
+MICROPROFILE_DEFINE(Vulkan_WaitForSecondary, "Vulkan", "Wait for secondary",
+                    MP_RGB(255, 128, 128));
 
 namespace Vulkan {
 
 namespace {
 
+constexpr u32 MAX_RECORDING_THREADS = 4;
+
+/// Command buffers whose timestamps can be in flight at once, each one uses a begin and end query.
+constexpr u32 NUM_TIMESTAMP_SLOTS = 64;
+
+/// Queries a command buffer may use for profile scopes, each scope uses a begin and end query.
+constexpr u32 MAX_PROFILE_QUERIES = 128;
+
 std::unique_ptr<MasterSemaphore> MakeMasterSemaphore(const Instance& instance) {
     if (instance.IsTimelineSemaphoreSupported()) {
         return std::make_unique<MasterSemaphoreTimeline>(instance);
@@ -29,6 +46,7 @@ std::unique_ptr<MasterSemaphore> MakeMasterSemaphore(const Instance& instance) {
 } // Anonymous namespace
 
 void Scheduler::CommandChunk::ExecuteAll(vk::CommandBuffer cmdbuf) {
+    MICROPROFILE_SCOPE(Vulkan_RecordChunk);
     auto command = first;
     while (command != nullptr) {
         auto next = command->GetNext();
@@ -43,13 +61,27 @@ void Scheduler::CommandChunk::ExecuteAll(vk::CommandBuffer cmdbuf) {
 }
 
 Scheduler::Scheduler(const Instance& instance)
-    : master_semaphore{MakeMasterSemaphore(instance)},
+    : device{instance.GetDevice()}, master_semaphore{MakeMasterSemaphore(instance)},
       command_pool{instance, master_semaphore.get()}, use_worker_thread{true} {
+    CreateTimestampQueries(instance);
     AllocateWorkerCommandBuffers();
     if (use_worker_thread) {
         AcquireNewChunk();
         worker_thread = std::jthread([this](std::stop_token token) { WorkerThread(token); });
     }
+    use_parallel_recording =
+        use_worker_thread && Settings::values.parallel_command_recording.GetValue();
+    if (use_parallel_recording) {
+        const u32 num_threads =
+            std::clamp(std::thread::hardware_concurrency() / 2, 1U, MAX_RECORDING_THREADS);
+        // Command pools are externally synchronized, so every recording thread owns one.
+        recording_workers = std::make_unique<RecordingWorker>(
+            num_threads, "VulkanRecorder", Common::ThreadRole::Render,
+            [&instance, this](std::size_t) {
+                return std::make_unique<CommandPool>(instance, master_semaphore.get(),
+                                                     vk::CommandBufferLevel::eSecondary);
+            });
+    }
 }
 
 Scheduler::~Scheduler() = default;
@@ -98,6 +130,13 @@ void Scheduler::DispatchWork() {
         return;
     }
 
+    // Chunks of an open secondary range are recorded together once the range ends.
+    if (current_range) {
+        current_range->chunks.push_back(std::move(chunk));
+        AcquireNewChunk();
+        return;
+    }
+
     {
         std::scoped_lock ql{queue_mutex};
         work_queue.push(std::move(chunk));
@@ -107,8 +146,160 @@ void Scheduler::DispatchWork() {
     AcquireNewChunk();
 }
 
+void Scheduler::BeginSecondaryRange(vk::RenderPass render_pass, vk::Framebuffer framebuffer) {
+    ASSERT(use_parallel_recording && !current_range);
+    DispatchWork();
+    current_range = std::make_shared<SecondaryRange>();
+    current_range->render_pass = render_pass;
+    current_range->framebuffer = framebuffer;
+    state = StateFlags::AllDirty;
+}
+
+void Scheduler::EndSecondaryRange() {
+    if (!current_range) {
+        return;
+    }
+    DispatchWork();
+    std::shared_ptr<SecondaryRange> range = std::move(current_range);
+    state = StateFlags::AllDirty;
+
+    recording_workers->QueueWork(
+        [this, range](std::unique_ptr<CommandPool>* pool) { RecordSecondary(**pool, *range); });
+    Record([range](vk::CommandBuffer cmdbuf) {
+        {
+            MICROPROFILE_SCOPE(Vulkan_WaitForSecondary);
+            range->recorded.wait(false);
+        }
+        cmdbuf.executeCommands(range->cmdbuf);
+    });
+}
+
+std::chrono::nanoseconds Scheduler::ConsumeGpuTime() {
+    if (!timestamp_pool) {
+        return std::chrono::nanoseconds::zero();
+    }
+    master_semaphore->Refresh();
+
+    std::scoped_lock lock{timestamp_mutex};
+    u64 elapsed_ticks = 0;
+    while (!pending_timestamps.empty() && IsFree(pending_timestamps.front().tick)) {
+        const u32 query = pending_timestamps.front().slot * 2;
+        pending_timestamps.pop_front();
+
+        std::array<u64, 2> timestamps{};
+        const vk::Result result = device.getQueryPoolResults(
+            *timestamp_pool, query, 2, sizeof(timestamps), timestamps.data(), sizeof(u64),
+            vk::QueryResultFlagBits::e64);
+        if (result == vk::Result::eSuccess && timestamps[1] > timestamps[0]) {
+            elapsed_ticks += timestamps[1] - timestamps[0];
+        }
+    }
+    return std::chrono::nanoseconds{
+        static_cast<s64>(static_cast<double>(elapsed_ticks) * timestamp_period)};
+}
+
+u64 Scheduler::BeginProfileScope(const char* name) {
+    if (!profile_pool || !profiler || !profiler->IsEnabled() || current_range) {
+        return 0;
+    }
+    const u64 id = ++profile_scope_id;
+    Record([this, id, name](vk::CommandBuffer cmdbuf) {
+        if (!profile_active || profile_queries + 2 > MAX_PROFILE_QUERIES) {
+            return;
+        }
+        const u32 query = timestamp_slot * MAX_PROFILE_QUERIES + profile_queries;
+        profile_queries += 2;
+        cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *profile_pool, query);
+        open_profile_scopes.push_back({id, name, query});
+    });
+    return id;
+}
+
+void Scheduler::EndProfileScope(u64 scope) {
+    if (scope == 0 || current_range) {
+        return;
+    }
+    Record([this, scope](vk::CommandBuffer cmdbuf) {
+        const auto it = std::ranges::find(open_profile_scopes, scope, &OpenProfileScope::id);
+        if (it == open_profile_scopes.end()) {
+            return;
+        }
+        cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *profile_pool,
+                              it->query + 1);
+        profile_samples.push_back({it->name, it->query});
+        open_profile_scopes.erase(it);
+    });
+}
+
+void Scheduler::CollectProfileScopes() {
+    if (!profile_pool || !profiler) {
+        return;
+    }
+    master_semaphore->Refresh();
+
+    // Each query is followed by its availability, scopes left open in a command buffer have no
+    // end timestamp and must not prevent reading the others.
+    std::vector<u64> results;
+    std::scoped_lock lock{timestamp_mutex};
+    while (!pending_profiles.empty() && IsFree(pending_profiles.front().tick)) {
+        const PendingProfile pending = std::move(pending_profiles.front());
+        pending_profiles.pop_front();
+
+        const u32 base = pending.slot * MAX_PROFILE_QUERIES;
+        results.assign(pending.num_queries * 2, 0);
+        const vk::Result result = device.getQueryPoolResults(
+            *profile_pool, base, pending.num_queries, results.size() * sizeof(u64),
+            results.data(), sizeof(u64) * 2,
+            vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+        if (result != vk::Result::eSuccess && result != vk::Result::eNotReady) {
+            continue;
+        }
+        for (const auto& sample : pending.samples) {
+            const u32 index = (sample.query - base) * 2;
+            const u64 begin = results[index];
+            const u64 end = results[index + 2];
+            if (!results[index + 1] || !results[index + 3] || end <= begin) {
+                continue;
+            }
+            profiler->AddSample(sample.name,
+                                std::chrono::nanoseconds{static_cast<s64>(
+                                    static_cast<double>(end - begin) * timestamp_period)});
+        }
+    }
+}
+
+void Scheduler::RecordSecondary(CommandPool& pool, SecondaryRange& range) {
+    MICROPROFILE_SCOPE(Vulkan_RecordSecondary);
+    const vk::CommandBufferInheritanceInfo inheritance_info = {
+        .renderPass = range.render_pass,
+        .subpass = 0,
+        .framebuffer = range.framebuffer,
+    };
+    const vk::CommandBufferBeginInfo begin_info = {
+        .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit |
+                 vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+        .pInheritanceInfo = &inheritance_info,
+    };
+
+    range.cmdbuf = pool.Commit();
+    range.cmdbuf.begin(begin_info);
+    for (auto& work : range.chunks) {
+        work->ExecuteAll(range.cmdbuf);
+        RecycleChunk(std::move(work));
+    }
+    range.cmdbuf.end();
+
+    range.recorded = true;
+    range.recorded.notify_all();
+}
+
+void Scheduler::RecycleChunk(std::unique_ptr<CommandChunk> work) {
+    std::scoped_lock rl{reserve_mutex};
+    chunk_reserve.emplace_back(std::move(work));
+}
+
 void Scheduler::WorkerThread(std::stop_token stop_token) {
-    Common::SetCurrentThreadName("VulkanWorker");
+    Common::SetCurrentThreadRole(Common::ThreadRole::Render, "VulkanWorker");
 
     const auto TryPopQueue{[this](auto& work) -> bool {
         if (work_queue.empty()) {
@@ -151,12 +342,8 @@ void Scheduler::WorkerThread(std::stop_token stop_token) {
             }
         }
 
-        {
-            std::scoped_lock rl{reserve_mutex};
-
-            // Recycle the chunk back to the reserve.
-            chunk_reserve.emplace_back(std::move(work));
-        }
+        // Recycle the chunk back to the reserve.
+        RecycleChunk(std::move(work));
     }
 }
 
@@ -167,16 +354,62 @@ void Scheduler::AllocateWorkerCommandBuffers() {
 
     current_cmdbuf = command_pool.Commit();
     current_cmdbuf.begin(begin_info);
+
+    if (timestamp_pool) {
+        {
+            // The oldest unread command buffer gives up its slot when all of them are in flight.
+            std::scoped_lock lock{timestamp_mutex};
+            if (!pending_timestamps.empty() && pending_timestamps.front().slot == timestamp_slot) {
+                pending_timestamps.pop_front();
+            }
+        }
+        const u32 query = timestamp_slot * 2;
+        current_cmdbuf.resetQueryPool(*timestamp_pool, query, 2);
+        current_cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *timestamp_pool,
+                                      query);
+    }
+
+    // Scopes opened in the previous command buffer can no longer be ended.
+    open_profile_scopes.clear();
+    profile_samples.clear();
+    profile_queries = 0;
+    profile_active = profile_pool && profiler && profiler->IsEnabled();
+    if (profile_active) {
+        {
+            std::scoped_lock lock{timestamp_mutex};
+            std::erase_if(pending_profiles, [this](const PendingProfile& pending) {
+                return pending.slot == timestamp_slot;
+            });
+        }
+        current_cmdbuf.resetQueryPool(*profile_pool, timestamp_slot * MAX_PROFILE_QUERIES,
+                                      MAX_PROFILE_QUERIES);
+    }
 }
 
 void Scheduler::SubmitExecution(vk::Semaphore signal_semaphore, vk::Semaphore wait_semaphore) {
+    ASSERT_MSG(!current_range, "Submitting inside a render pass");
     state = StateFlags::AllDirty;
     const u64 signal_value = master_semaphore->NextTick();
+    const TimelineWait timeline_wait = submit_callback ? submit_callback() : TimelineWait{};
 
-    Record([signal_semaphore, wait_semaphore, signal_value, this](vk::CommandBuffer cmdbuf) {
+    Record([signal_semaphore, wait_semaphore, signal_value, timeline_wait,
+            this](vk::CommandBuffer cmdbuf) {
         MICROPROFILE_SCOPE(Vulkan_Submit);
+        if (timestamp_pool) {
+            cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *timestamp_pool,
+                                  timestamp_slot * 2 + 1);
+            std::scoped_lock lock{timestamp_mutex};
+            pending_timestamps.push_back({timestamp_slot, signal_value});
+            if (!profile_samples.empty()) {
+                pending_profiles.push_back(
+                    {timestamp_slot, signal_value, profile_queries, std::move(profile_samples)});
+                profile_samples.clear();
+            }
+            timestamp_slot = (timestamp_slot + 1) % NUM_TIMESTAMP_SLOTS;
+        }
         std::scoped_lock lock{submit_mutex};
-        master_semaphore->SubmitWork(cmdbuf, wait_semaphore, signal_semaphore, signal_value);
+        master_semaphore->SubmitWork(cmdbuf, wait_semaphore, signal_semaphore, signal_value,
+                                     timeline_wait);
     });
 
     if (!use_worker_thread) {
@@ -198,4 +431,22 @@ void Scheduler::AcquireNewChunk() {
     chunk_reserve.pop_back();
 }
 
+void Scheduler::CreateTimestampQueries(const Instance& instance) {
+    if (!instance.IsTimestampQuerySupported()) {
+        return;
+    }
+    const vk::QueryPoolCreateInfo pool_info = {
+        .queryType = vk::QueryType::eTimestamp,
+        .queryCount = NUM_TIMESTAMP_SLOTS * 2,
+    };
+    timestamp_pool = device.createQueryPoolUnique(pool_info);
+    timestamp_period = instance.TimestampPeriod();
+
+    const vk::QueryPoolCreateInfo profile_pool_info = {
+        .queryType = vk::QueryType::eTimestamp,
+        .queryCount = NUM_TIMESTAMP_SLOTS * MAX_PROFILE_QUERIES,
+    };
+    profile_pool = device.createQueryPoolUnique(profile_pool_info);
+}
+
 } // namespace Vulkan
@@ -4,14 +4,23 @@
 
 #pragma once
 
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
 #include "common/alignment.h"
 #include "common/common_funcs.h"
 #include "common/polyfill_thread.h"
+#include "common/thread_worker.h"
 #include "video_core/renderer_vulkan/vk_master_semaphore.h"
 #include "video_core/renderer_vulkan/vk_resource_pool.h"
 
+namespace VideoCore {
+class GpuProfiler;
+}
+
 namespace Vulkan {
 
 enum class StateFlags {
@@ -46,6 +55,21 @@ public:
     /// Sends currently recorded work to the worker thread.
     void DispatchWork();
 
+    /// Returns true when render pass contents are recorded into secondary command buffers.
+    [[nodiscard]] bool IsParallelRecordingEnabled() const noexcept {
+        return use_parallel_recording;
+    }
+
+    /**
+     * Starts collecting the following commands into a secondary command buffer executed inside the
+     * provided render pass. The render pass must have been begun with secondary contents. Bound
+     * state does not carry over into secondary command buffers, so all state is marked dirty.
+     */
+    void BeginSecondaryRange(vk::RenderPass render_pass, vk::Framebuffer framebuffer);
+
+    /// Hands the current secondary range to a recording thread and executes it in its place.
+    void EndSecondaryRange();
+
     /// Records the command to the current chunk.
     template <typename T>
     void Record(T&& command) {
@@ -81,11 +105,49 @@ public:
         return master_semaphore->CurrentTick();
     }
 
+    /// Updates the known GPU tick without waiting.
+    void Refresh() {
+        master_semaphore->Refresh();
+    }
+
     /// Returns true when a tick has been triggered by the GPU.
     [[nodiscard]] bool IsFree(u64 tick) const noexcept {
         return master_semaphore->IsFree(tick);
     }
 
+    /**
+     * Returns the GPU time spent executing the command buffers that completed since the last call.
+     * Results are only read once their submission has completed, so this never waits on the GPU.
+     * Returns zero when the device cannot write timestamps.
+     */
+    std::chrono::nanoseconds ConsumeGpuTime();
+
+    /**
+     * Sets a function called on the submitting thread before each submission. The submission
+     * waits for the timeline semaphore value it returns, if any.
+     */
+    void SetSubmitCallback(std::function<TimelineWait()>&& callback) {
+        submit_callback = std::move(callback);
+    }
+
+    /// Sets the profiler that receives the GPU time of the profile scopes.
+    void SetProfiler(VideoCore::GpuProfiler* profiler_) noexcept {
+        profiler = profiler_;
+    }
+
+    /**
+     * Starts measuring the GPU time of the commands recorded until the scope is ended.
+     * Scopes may nest but are dropped when they span a submission or are opened inside a
+     * secondary range. Returns zero when profiling is disabled.
+     */
+    [[nodiscard]] u64 BeginProfileScope(const char* name);
+
+    /// Ends a profile scope returned by BeginProfileScope.
+    void EndProfileScope(u64 scope);
+
+    /// Hands the profile scopes of the completed submissions to the profiler without waiting.
+    void CollectProfileScopes();
+
     /// Returns the master timeline semaphore.
     [[nodiscard]] MasterSemaphore* GetMasterSemaphore() noexcept {
         return master_semaphore.get();
@@ -177,16 +239,61 @@ private:
         alignas(std::max_align_t) std::array<u8, 0x8000> data{};
     };
 
+    /// A run of chunks recorded into a single secondary command buffer by a recording thread.
+    struct SecondaryRange {
+        std::vector<std::unique_ptr<CommandChunk>> chunks;
+        vk::RenderPass render_pass;
+        vk::Framebuffer framebuffer;
+        vk::CommandBuffer cmdbuf;
+        std::atomic_bool recorded{};
+    };
+
+    using RecordingWorker = Common::StatefulThreadWorker<std::unique_ptr<CommandPool>>;
+
 private:
     void WorkerThread(std::stop_token stop_token);
 
+    void RecordSecondary(CommandPool& pool, SecondaryRange& range);
+
+    void RecycleChunk(std::unique_ptr<CommandChunk> chunk);
+
     void AllocateWorkerCommandBuffers();
 
     void SubmitExecution(vk::Semaphore signal_semaphore, vk::Semaphore wait_semaphore);
 
     void AcquireNewChunk();
 
+    void CreateTimestampQueries(const Instance& instance);
+
 private:
+    /// A command buffer whose begin and end timestamps have not been read yet.
+    struct PendingTimestamp {
+        u32 slot;
+        u64 tick;
+    };
+
+    /// A profile scope whose end timestamp has not been recorded yet.
+    struct OpenProfileScope {
+        u64 id;
+        const char* name;
+        u32 query;
+    };
+
+    /// A profile scope recorded in a command buffer, its end timestamp follows the begin one.
+    struct ProfileSample {
+        const char* name;
+        u32 query;
+    };
+
+    /// A command buffer whose profile scopes have not been read yet.
+    struct PendingProfile {
+        u32 slot;
+        u64 tick;
+        u32 num_queries;
+        std::vector<ProfileSample> samples;
+    };
+
+    vk::Device device;
     std::unique_ptr<MasterSemaphore> master_semaphore;
     CommandPool command_pool;
     std::unique_ptr<CommandChunk> chunk;
@@ -198,8 +305,40 @@ private:
     std::mutex reserve_mutex;
     std::mutex queue_mutex;
     std::condition_variable_any event_cv;
+    std::shared_ptr<SecondaryRange> current_range;
+    std::unique_ptr<RecordingWorker> recording_workers;
     std::jthread worker_thread;
+    vk::UniqueQueryPool timestamp_pool;
+    std::deque<PendingTimestamp> pending_timestamps;
+    std::mutex timestamp_mutex;
+    u32 timestamp_slot{};
+    float timestamp_period{};
+    std::function<TimelineWait()> submit_callback;
+    VideoCore::GpuProfiler* profiler{};
+    vk::UniqueQueryPool profile_pool;
+    std::deque<PendingProfile> pending_profiles;
+    std::vector<OpenProfileScope> open_profile_scopes;
+    std::vector<ProfileSample> profile_samples;
+    u64 profile_scope_id{};
+    u32 profile_queries{};
+    bool profile_active{};
     bool use_worker_thread;
+    bool use_parallel_recording{};
+};
+
+/// Measures the GPU time of the commands recorded during its lifetime.
+class ProfileScope {
+public:
+    explicit ProfileScope(Scheduler& scheduler_, const char* name)
+        : scheduler{scheduler_}, scope{scheduler.BeginProfileScope(name)} {}
+
+    ~ProfileScope() {
+        scheduler.EndProfileScope(scope);
+    }
+
+private:
+    Scheduler& scheduler;
+    u64 scope;
 };
 
 } // namespace Vulkan
@@ -158,7 +158,7 @@ bool InitializeCompiler() {
 }
 } // Anonymous namespace
 
-vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device) {
+std::vector<u32> CompileGLSL(std::string_view code, vk::ShaderStageFlagBits stage) {
     if (!InitializeCompiler()) {
         return {};
     }
@@ -212,6 +212,14 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
         LOG_INFO(Render_Vulkan, "SPIR-V conversion messages: {}", spv_messages);
     }
 
+    return out_code;
+}
+
+vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device) {
+    const std::vector<u32> out_code = CompileGLSL(code, stage);
+    if (out_code.empty()) {
+        return {};
+    }
     return CompileSPV(out_code, device);
 }
 
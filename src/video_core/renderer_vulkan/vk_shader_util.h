@@ -5,11 +5,23 @@
 #pragma once
 
 #include <span>
+#include <vector>
 
 #include "video_core/renderer_vulkan/vk_common.h"
 
 namespace Vulkan {
 
+/// Bumped whenever the GLSL to SPIR-V conversion options change, invalidating cached SPIR-V.
+constexpr u32 GLSL_COMPILER_VERSION = 1;
+
+/**
+ * @brief Converts GLSL to SPIR-V using glslang.
+ * @param code The string containing GLSL code.
+ * @param stage The pipeline stage the shader will be used in.
+ * @returns The SPIR-V bytecode, or an empty vector on failure.
+ */
+std::vector<u32> CompileGLSL(std::string_view code, vk::ShaderStageFlagBits stage);
+
 /**
  * @brief Creates a vulkan shader module from GLSL by converting it to SPIR-V using glslang.
  * @param code The string containing GLSL code.
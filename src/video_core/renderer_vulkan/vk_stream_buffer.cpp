@@ -145,6 +145,22 @@ void StreamBuffer::Commit(u64 size) {
     watch.tick = scheduler.CurrentTick();
 }
 
+void StreamBuffer::Invalidate(u64 offset, u64 size) {
+    if (is_coherent) {
+        return;
+    }
+
+    const u64 atom_size = instance.NonCoherentAtomSize();
+    const u64 range_start = Common::AlignDown(offset, atom_size);
+    const u64 range_end = std::min(Common::AlignUp(offset + size, atom_size), stream_buffer_size);
+    const vk::MappedMemoryRange range = {
+        .memory = memory,
+        .offset = range_start,
+        .size = range_end - range_start,
+    };
+    device.invalidateMappedMemoryRanges(range);
+}
+
 void StreamBuffer::CreateBuffers(u64 prefered_size) {
     const vk::Device device = instance.GetDevice();
     const auto memory_properties = instance.GetPhysicalDevice().getMemoryProperties();
@@ -75,6 +75,7 @@ void Swapchain::Create(u32 width_, u32 height_, vk::SurfaceKHR surface_) {
 
     SetupImages();
     RefreshSemaphores();
+    QueryRefreshInterval();
 }
 
 bool Swapchain::AcquireNextImage() {
@@ -101,12 +102,12 @@ bool Swapchain::AcquireNextImage() {
     return !needs_recreation;
 }
 
-void Swapchain::Present() {
+void Swapchain::Present(Clock::time_point desired_time) {
     if (needs_recreation) {
         return;
     }
 
-    const vk::PresentInfoKHR present_info = {
+    vk::PresentInfoKHR present_info = {
         .waitSemaphoreCount = 1,
         .pWaitSemaphores = &present_ready[image_index],
         .swapchainCount = 1,
@@ -114,6 +115,23 @@ void Swapchain::Present() {
         .pImageIndices = &image_index,
     };
 
+    // Ids start at 1, the presentation engine reports the timing of every image with one
+    const auto now = Clock::now();
+    const auto desired_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(desired_time.time_since_epoch());
+    const vk::PresentTimeGOOGLE present_time = {
+        .presentID = ++present_id,
+        .desiredPresentTime = desired_time > now ? static_cast<u64>(desired_ns.count()) : 0,
+    };
+    const vk::PresentTimesInfoGOOGLE present_times_info = {
+        .swapchainCount = 1,
+        .pTimes = &present_time,
+    };
+    if (instance.IsDisplayTimingSupported()) {
+        present_info.pNext = &present_times_info;
+        present_times[present_id % present_times.size()] = now;
+    }
+
     MICROPROFILE_SCOPE(Vulkan_Present);
     try {
         [[maybe_unused]] vk::Result result = instance.GetPresentQueue().presentKHR(present_info);
@@ -127,6 +145,50 @@ void Swapchain::Present() {
     frame_index = (frame_index + 1) % image_count;
 }
 
+std::vector<Swapchain::PresentTiming> Swapchain::GetPastPresentTimings() {
+    std::vector<PresentTiming> timings;
+    if (!instance.IsDisplayTimingSupported() || !swapchain) {
+        return timings;
+    }
+
+    std::vector<vk::PastPresentationTimingGOOGLE> past_timings;
+    try {
+        past_timings = instance.GetDevice().getPastPresentationTimingGOOGLE(swapchain);
+    } catch (const vk::SystemError& err) {
+        LOG_DEBUG(Render_Vulkan, "Unable to query past presentation timing: {}", err.what());
+        return timings;
+    }
+
+    // The display timestamps use the monotonic clock of the host, like steady_clock
+    timings.reserve(past_timings.size());
+    for (const vk::PastPresentationTimingGOOGLE& timing : past_timings) {
+        if (present_id - timing.presentID >= present_times.size()) {
+            continue;
+        }
+        timings.push_back({
+            .present_time = present_times[timing.presentID % present_times.size()],
+            .display_time = Clock::time_point{std::chrono::duration_cast<Clock::duration>(
+                std::chrono::nanoseconds{timing.actualPresentTime})},
+        });
+    }
+    return timings;
+}
+
+void Swapchain::QueryRefreshInterval() {
+    refresh_interval = std::chrono::nanoseconds::zero();
+    if (!instance.IsDisplayTimingSupported()) {
+        return;
+    }
+
+    try {
+        const auto properties = instance.GetDevice().getRefreshCycleDurationGOOGLE(swapchain);
+        refresh_interval = std::chrono::nanoseconds{properties.refreshDuration};
+        LOG_INFO(Render_Vulkan, "Display refresh interval is {} ns", properties.refreshDuration);
+    } catch (const vk::SystemError& err) {
+        LOG_WARNING(Render_Vulkan, "Unable to query display refresh interval: {}", err.what());
+    }
+}
+
 void Swapchain::FindPresentFormat() {
     const auto formats = instance.GetPhysicalDevice().getSurfaceFormatsKHR(surface);
 
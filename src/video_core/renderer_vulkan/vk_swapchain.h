@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <mutex>
 #include <vector>
 #include "common/common_types.h"
@@ -16,6 +18,14 @@ class Scheduler;
 
 class Swapchain {
 public:
+    using Clock = std::chrono::steady_clock;
+
+    /// When a presented image was first shown by the display
+    struct PresentTiming {
+        Clock::time_point present_time;
+        Clock::time_point display_time;
+    };
+
     explicit Swapchain(const Instance& instance, u32 width, u32 height, vk::SurfaceKHR surface);
     ~Swapchain();
 
@@ -25,8 +35,15 @@ public:
     /// Acquires the next image in the swapchain.
     bool AcquireNextImage();
 
-    /// Presents the current image and move to the next one
-    void Present();
+    /**
+     * Presents the current image and move to the next one.
+     * @param desired_time Vblank the image should be displayed at, if the presentation engine
+     *                     supports VK_GOOGLE_display_timing. The image is never shown earlier.
+     */
+    void Present(Clock::time_point desired_time = {});
+
+    /// Returns the timing of the images displayed since the last call, if it is known.
+    [[nodiscard]] std::vector<PresentTiming> GetPastPresentTimings();
 
     vk::SurfaceKHR GetSurface() const {
         return surface;
@@ -60,6 +77,17 @@ public:
         return extent;
     }
 
+    /// Returns the refresh interval reported by the presentation engine, or zero if unknown.
+    [[nodiscard]] std::chrono::nanoseconds GetRefreshInterval() const {
+        return refresh_interval;
+    }
+
+    /// Returns true when presents are throttled to the display refresh rate.
+    [[nodiscard]] bool IsVsyncPresentMode() const {
+        return present_mode == vk::PresentModeKHR::eFifo ||
+               present_mode == vk::PresentModeKHR::eFifoRelaxed;
+    }
+
     [[nodiscard]] vk::Semaphore GetImageAcquiredSemaphore() const {
         return image_acquired[frame_index];
     }
@@ -87,6 +115,9 @@ private:
     /// Creates the image acquired and present ready semaphores
     void RefreshSemaphores();
 
+    /// Queries the display refresh interval through VK_GOOGLE_display_timing
+    void QueryRefreshInterval();
+
 private:
     const Instance& instance;
     vk::SwapchainKHR swapchain{};
@@ -99,6 +130,10 @@ private:
     std::vector<vk::Image> images;
     std::vector<vk::Semaphore> image_acquired;
     std::vector<vk::Semaphore> present_ready;
+    std::chrono::nanoseconds refresh_interval{};
+    /// Times of the last presents, indexed by their present id
+    std::array<Clock::time_point, 16> present_times{};
+    u32 present_id = 0;
     u32 width = 0;
     u32 height = 0;
     u32 image_count = 0;
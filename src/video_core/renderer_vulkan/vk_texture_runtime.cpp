@@ -2,8 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <boost/container/small_vector.hpp>
 
+#include "common/hash.h"
 #include "common/literals.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
@@ -142,10 +144,18 @@ boost::container::small_vector<vk::ImageMemoryBarrier, 3> MakeInitBarriers(
     return barriers;
 }
 
-Handle MakeHandle(const Instance* instance, u32 width, u32 height, u32 levels, TextureType type,
-                  vk::Format format, vk::ImageUsageFlags usage, vk::ImageCreateFlags flags,
-                  vk::ImageAspectFlags aspect, bool need_format_list,
+void SetHandleName(const Instance* instance, const Handle& handle, std::string_view debug_name) {
+    if (!debug_name.empty() && instance->HasDebuggingToolAttached()) {
+        Vulkan::SetObjectName(instance->GetDevice(), handle.image, debug_name);
+        Vulkan::SetObjectName(instance->GetDevice(), handle.image_view.get(), "{} View({})",
+                              debug_name, vk::to_string(handle.params.aspect));
+    }
+}
+
+Handle MakeHandle(const Instance* instance, const ImageParams& params,
                   std::string_view debug_name = {}) {
+    const auto [width, height, levels, type, format, usage, flags, aspect, need_format_list] =
+        params;
     const u32 layers = type == TextureType::CubeMap ? 6 : 1;
 
     const std::array format_list = {
@@ -203,19 +213,14 @@ Handle MakeHandle(const Instance* instance, u32 width, u32 height, u32 levels, T
             .layerCount = layers,
         },
     };
-    vk::UniqueImageView image_view = instance->GetDevice().createImageViewUnique(view_info);
-
-    if (!debug_name.empty() && instance->HasDebuggingToolAttached()) {
-        Vulkan::SetObjectName(instance->GetDevice(), image, debug_name);
-        Vulkan::SetObjectName(instance->GetDevice(), image_view.get(), "{} View({})", debug_name,
-                              vk::to_string(aspect));
-    }
-
-    return Handle{
+    Handle handle{
         .alloc = allocation,
         .image = image,
-        .image_view = std::move(image_view),
+        .image_view = instance->GetDevice().createImageViewUnique(view_info),
+        .params = params,
     };
+    SetHandleName(instance, handle, debug_name);
+    return handle;
 }
 
 vk::UniqueFramebuffer MakeFramebuffer(vk::Device device, vk::RenderPass render_pass, u32 width,
@@ -245,23 +250,48 @@ vk::ImageSubresourceRange MakeSubresourceRange(vk::ImageAspectFlags aspect, u32
 
 constexpr u64 UPLOAD_BUFFER_SIZE = 512_MiB;
 constexpr u64 DOWNLOAD_BUFFER_SIZE = 16_MiB;
+constexpr u64 READBACK_BUFFER_SIZE = 16_MiB;
+
+/// Upper bound of the memory held by images waiting to be reused
+constexpr u64 MAX_RECYCLED_BYTES = 256_MiB;
+
+/// Recycled images not reused for this many frames are destroyed
+constexpr u64 MAX_RECYCLED_FRAMES = 300;
 
 } // Anonymous namespace
 
+std::size_t ImageParams::Hash::operator()(const ImageParams& params) const noexcept {
+    u64 hash = Common::HashCombine(params.width, params.height);
+    hash = Common::HashCombine(hash, params.levels);
+    hash = Common::HashCombine(hash, static_cast<u64>(params.type));
+    hash = Common::HashCombine(hash, static_cast<u64>(params.format));
+    hash = Common::HashCombine(hash, static_cast<VkImageUsageFlags>(params.usage));
+    hash = Common::HashCombine(hash, static_cast<VkImageCreateFlags>(params.flags));
+    hash = Common::HashCombine(hash, static_cast<VkImageAspectFlags>(params.aspect));
+    return Common::HashCombine(hash, params.need_format_list);
+}
+
 TextureRuntime::TextureRuntime(const Instance& instance, Scheduler& scheduler,
                                RenderpassCache& renderpass_cache, DescriptorPool& pool,
                                DescriptorSetProvider& texture_provider_, u32 num_swapchain_images_)
     : instance{instance}, scheduler{scheduler}, renderpass_cache{renderpass_cache},
       texture_provider{texture_provider_}, blit_helper{instance, scheduler, pool, renderpass_cache},
-      upload_buffer{instance, scheduler, vk::BufferUsageFlagBits::eTransferSrc, UPLOAD_BUFFER_SIZE,
-                    BufferType::Upload},
+      upload_buffer{instance, scheduler,
+                    vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eStorageBuffer,
+                    UPLOAD_BUFFER_SIZE, BufferType::Upload},
       download_buffer{instance, scheduler,
                       vk::BufferUsageFlagBits::eTransferDst |
                           vk::BufferUsageFlagBits::eStorageBuffer,
                       DOWNLOAD_BUFFER_SIZE, BufferType::Download},
-      num_swapchain_images{num_swapchain_images_} {}
+      readback_buffer{instance, scheduler,
+                      vk::BufferUsageFlagBits::eTransferDst |
+                          vk::BufferUsageFlagBits::eStorageBuffer,
+                      READBACK_BUFFER_SIZE, BufferType::Download},
+      transfer_queue{instance, scheduler}, num_swapchain_images{num_swapchain_images_} {}
 
-TextureRuntime::~TextureRuntime() = default;
+TextureRuntime::~TextureRuntime() {
+    ReleaseRecycledImages([](const RecycledImage&) { return true; });
+}
 
 VideoCore::StagingData TextureRuntime::FindStaging(u32 size, bool upload) {
     StreamBuffer& buffer = upload ? upload_buffer : download_buffer;
@@ -273,6 +303,28 @@ VideoCore::StagingData TextureRuntime::FindStaging(u32 size, bool upload) {
     };
 }
 
+VideoCore::StagingData TextureRuntime::FindReadback(u32 size) {
+    const auto [data, offset, invalidate] = readback_buffer.Map(size, 16);
+    return VideoCore::StagingData{
+        .size = size,
+        .offset = static_cast<u32>(offset),
+        .mapped = std::span{data, size},
+    };
+}
+
+u64 TextureRuntime::ReadbackCapacity() const {
+    return READBACK_BUFFER_SIZE;
+}
+
+u64 TextureRuntime::MemoryBudget() const {
+    return instance.GetDeviceLocalBudget();
+}
+
+void TextureRuntime::WaitReadback(u64 tick, const VideoCore::StagingData& staging) {
+    scheduler.Wait(tick);
+    readback_buffer.Invalidate(staging.offset, staging.size);
+}
+
 u32 TextureRuntime::RemoveThreshold() {
     return num_swapchain_images;
 }
@@ -281,6 +333,74 @@ void TextureRuntime::Finish() {
     scheduler.Finish();
 }
 
+bool TextureRuntime::UploadTiled(Surface& surface, const VideoCore::SurfaceParams& load_info,
+                                 std::span<const u8> data, VideoCore::BufferTextureCopy upload) {
+    if (!load_info.is_tiled || load_info.width != load_info.stride ||
+        surface.traits.native != vk::Format::eR8G8B8A8Unorm ||
+        !BlitHelper::CanDecodeTexture(load_info.pixel_format)) {
+        return false;
+    }
+
+    const u32 alignment = static_cast<u32>(instance.StorageMinAlignment());
+    const u32 src_size = static_cast<u32>(data.size());
+    const auto [src_ptr, src_offset, src_invalidate] = upload_buffer.Map(src_size, alignment);
+    std::memcpy(src_ptr, data.data(), src_size);
+    upload_buffer.Commit(src_size);
+
+    const u32 dst_size = load_info.width * load_info.height * sizeof(u32);
+    const auto [dst_ptr, dst_offset, dst_invalidate] = upload_buffer.Map(dst_size, alignment);
+    blit_helper.DecodeTexture(load_info, upload_buffer.Handle(), static_cast<u32>(src_offset),
+                              src_size, static_cast<u32>(dst_offset));
+
+    const VideoCore::StagingData staging = {
+        .size = dst_size,
+        .offset = static_cast<u32>(dst_offset),
+        .mapped = std::span{dst_ptr, dst_size},
+    };
+    upload.buffer_offset = staging.offset;
+    upload.buffer_size = staging.size;
+    surface.Upload(upload, staging);
+    return true;
+}
+
+bool TextureRuntime::ConvertY2R(Surface& surface, const VideoCore::Y2RConfig& config,
+                                std::span<const std::span<const u8>, 3> planes,
+                                VideoCore::BufferTextureCopy upload) {
+    if (surface.traits.native != vk::Format::eR8G8B8A8Unorm) {
+        return false;
+    }
+
+    // The coefficients are followed by the planes, packed one after the other
+    const u32 alignment = static_cast<u32>(instance.StorageMinAlignment());
+    u32 src_size = sizeof(config.coefficients);
+    for (const auto plane : planes) {
+        src_size += static_cast<u32>(plane.size());
+    }
+    const auto [src_ptr, src_offset, src_invalidate] = upload_buffer.Map(src_size, alignment);
+    std::memcpy(src_ptr, config.coefficients.data(), sizeof(config.coefficients));
+    u8* plane_ptr = src_ptr + sizeof(config.coefficients);
+    for (const auto plane : planes) {
+        std::memcpy(plane_ptr, plane.data(), plane.size());
+        plane_ptr += plane.size();
+    }
+    upload_buffer.Commit(src_size);
+
+    const u32 dst_size = config.width * config.height * sizeof(u32);
+    const auto [dst_ptr, dst_offset, dst_invalidate] = upload_buffer.Map(dst_size, alignment);
+    blit_helper.ConvertY2R(config, upload_buffer.Handle(), static_cast<u32>(src_offset), src_size,
+                           static_cast<u32>(dst_offset));
+
+    const VideoCore::StagingData staging = {
+        .size = dst_size,
+        .offset = static_cast<u32>(dst_offset),
+        .mapped = std::span{dst_ptr, dst_size},
+    };
+    upload.buffer_offset = staging.offset;
+    upload.buffer_size = staging.size;
+    surface.Upload(upload, staging);
+    return true;
+}
+
 bool TextureRuntime::Reinterpret(Surface& source, Surface& dest,
                                  const VideoCore::TextureCopy& copy) {
     const PixelFormat src_format = source.pixel_format;
@@ -293,19 +413,94 @@ bool TextureRuntime::Reinterpret(Surface& source, Surface& dest,
         return true;
     }
 
-    if (src_format == PixelFormat::D24S8 && dst_format == PixelFormat::RGBA8) {
-        blit_helper.ConvertDS24S8ToRGBA8(source, dest, copy);
-    } else {
+    // Storage images cannot hold most formats, so the shader writes the texels to the upload
+    // buffer and they are copied to dest from there
+    const u32 size = BlitHelper::ReinterpretSize(dest, copy.extent);
+    if (source.GetFormatBpp() < 16 || size == 0) {
         LOG_WARNING(Render_Vulkan, "Unimplemented reinterpretation {} -> {}",
                     VideoCore::PixelFormatAsString(src_format),
                     VideoCore::PixelFormatAsString(dst_format));
         return false;
     }
+    const u32 alignment = static_cast<u32>(instance.StorageMinAlignment());
+    const auto [ptr, buffer_offset, invalidate] = upload_buffer.Map(size, alignment);
+    const u32 offset = static_cast<u32>(buffer_offset);
+    if (!blit_helper.Reinterpret(source, dest, copy, upload_buffer.Handle(), offset, size)) {
+        return false;
+    }
+    upload_buffer.Commit(size);
+
+    const RecordParams params = {
+        .aspect = dest.Aspect(),
+        .pipeline_flags = dest.PipelineStageFlags(),
+        .src_access = dest.AccessFlags(),
+        .src_image = dest.Image(),
+    };
+
+    scheduler.Record([buffer = upload_buffer.Handle(), params, copy,
+                      offset](vk::CommandBuffer cmdbuf) {
+        u32 num_copies = 1;
+        std::array<vk::BufferImageCopy, 2> buffer_image_copies;
+        buffer_image_copies[0] = vk::BufferImageCopy{
+            .bufferOffset = offset,
+            .bufferRowLength = copy.extent.width,
+            .bufferImageHeight = copy.extent.height,
+            .imageSubresource{
+                .aspectMask = params.aspect,
+                .mipLevel = copy.dst_level,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+            .imageOffset = {static_cast<s32>(copy.dst_offset.x),
+                            static_cast<s32>(copy.dst_offset.y), 0},
+            .imageExtent = {copy.extent.width, copy.extent.height, 1},
+        };
+
+        if (params.aspect & vk::ImageAspectFlagBits::eStencil) {
+            buffer_image_copies[0].imageSubresource.aspectMask = vk::ImageAspectFlagBits::eDepth;
+            vk::BufferImageCopy& stencil_copy = buffer_image_copies[1];
+            stencil_copy = buffer_image_copies[0];
+            stencil_copy.bufferOffset += copy.extent.width * copy.extent.height * 4;
+            stencil_copy.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eStencil;
+            num_copies++;
+        }
+
+        const vk::ImageMemoryBarrier read_barrier = {
+            .srcAccessMask = params.src_access,
+            .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .oldLayout = vk::ImageLayout::eGeneral,
+            .newLayout = vk::ImageLayout::eTransferDstOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = params.src_image,
+            .subresourceRange = MakeSubresourceRange(params.aspect, copy.dst_level),
+        };
+        const vk::ImageMemoryBarrier write_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = params.src_access,
+            .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = params.src_image,
+            .subresourceRange = MakeSubresourceRange(params.aspect, copy.dst_level),
+        };
+
+        cmdbuf.pipelineBarrier(params.pipeline_flags, vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
+
+        cmdbuf.copyBufferToImage(buffer, params.src_image, vk::ImageLayout::eTransferDstOptimal,
+                                 num_copies, buffer_image_copies.data());
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, params.pipeline_flags,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, write_barrier);
+    });
     return true;
 }
 
 bool TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClear& clear) {
     renderpass_cache.EndRendering();
+    const ProfileScope profile{scheduler, "Texture Clear"};
 
     const RecordParams params = {
         .aspect = surface.Aspect(),
@@ -455,6 +650,7 @@ void TextureRuntime::ClearTextureWithRenderpass(Surface& surface,
 bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                                   const VideoCore::TextureCopy& copy) {
     renderpass_cache.EndRendering();
+    const ProfileScope profile{scheduler, "Texture Copy"};
 
     const RecordParams params = {
         .aspect = source.Aspect(),
@@ -560,6 +756,7 @@ bool TextureRuntime::BlitTextures(Surface& source, Surface& dest,
     }
 
     renderpass_cache.EndRendering();
+    const ProfileScope profile{scheduler, "Texture Blit"};
 
     const RecordParams params = {
         .aspect = source.Aspect(),
@@ -668,6 +865,7 @@ void TextureRuntime::GenerateMipmaps(Surface& surface) {
     }
 
     renderpass_cache.EndRendering();
+    const ProfileScope profile{scheduler, "Mipmap Generation"};
 
     auto [width, height] = surface.RealExtent();
     const u32 levels = surface.levels;
@@ -701,6 +899,77 @@ void TextureRuntime::FreeDescriptorSetsWithImage(vk::ImageView image_view) {
     blit_helper.two_textures_provider.FreeWithImage(image_view);
 }
 
+void TextureRuntime::TickFrame() {
+    ++current_frame;
+    if (recycled_bytes == 0) {
+        return;
+    }
+    // Pooled images are only worth keeping while the device has memory to spare.
+    const u64 budget = instance.GetDeviceLocalBudget();
+    if (budget != 0 && instance.GetDeviceLocalUsage() > budget / 10 * 9) {
+        ReleaseRecycledImages([](const RecycledImage&) { return true; });
+        return;
+    }
+    ReleaseRecycledImages([this](const RecycledImage& image) {
+        return image.frame + MAX_RECYCLED_FRAMES < current_frame;
+    });
+}
+
+Handle TextureRuntime::AllocateImage(const ImageParams& params, std::string_view debug_name) {
+    const auto it = recycled_images.find(params);
+    if (it != recycled_images.end()) {
+        auto& images = it->second;
+        const auto free_image = std::ranges::find_if(
+            images, [this](const RecycledImage& image) { return scheduler.IsFree(image.tick); });
+        if (free_image != images.end()) {
+            Handle handle = std::move(free_image->handle);
+            recycled_bytes -= free_image->size;
+            images.erase(free_image);
+            SetHandleName(&instance, handle, debug_name);
+            return handle;
+        }
+    }
+    return MakeHandle(&instance, params, debug_name);
+}
+
+void TextureRuntime::RecycleImage(Handle&& handle) {
+    FreeDescriptorSetsWithImage(*handle.image_view);
+
+    VmaAllocationInfo alloc_info;
+    vmaGetAllocationInfo(instance.GetAllocator(), handle.alloc, &alloc_info);
+    if (recycled_bytes + alloc_info.size > MAX_RECYCLED_BYTES) {
+        handle.image_view.reset();
+        vmaDestroyImage(instance.GetAllocator(), handle.image, handle.alloc);
+        return;
+    }
+
+    // Surfaces are destroyed after staying unused for a few frames, the tick guards against
+    // reusing an image the GPU may still access anyway.
+    recycled_bytes += alloc_info.size;
+    recycled_images[handle.params].push_back({
+        .handle = std::move(handle),
+        .tick = scheduler.CurrentTick(),
+        .frame = current_frame,
+        .size = alloc_info.size,
+    });
+}
+
+template <typename Predicate>
+void TextureRuntime::ReleaseRecycledImages(Predicate&& predicate) {
+    for (auto it = recycled_images.begin(); it != recycled_images.end();) {
+        std::erase_if(it->second, [&](RecycledImage& image) {
+            if (!predicate(image)) {
+                return false;
+            }
+            image.handle.image_view.reset();
+            vmaDestroyImage(instance.GetAllocator(), image.handle.image, image.handle.alloc);
+            recycled_bytes -= image.size;
+            return true;
+        });
+        it = it->second.empty() ? recycled_images.erase(it) : std::next(it);
+    }
+}
+
 Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceParams& params)
     : SurfaceBase{params}, runtime{&runtime_}, instance{&runtime_.GetInstance()},
       scheduler{&runtime_.GetScheduler()}, traits{instance->GetTraits(pixel_format)} {
@@ -727,14 +996,16 @@ Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceParams& param
     }
 
     const bool need_format_list = is_mutable && instance->IsImageFormatListSupported();
-    handles[0] = MakeHandle(instance, width, height, levels, texture_type, format, traits.usage,
-                            flags, traits.aspect, need_format_list, DebugName(false));
+    handles[0] = runtime->AllocateImage({width, height, levels, texture_type, format,
+                                         traits.usage, flags, traits.aspect, need_format_list},
+                                        DebugName(false));
     raw_images[num_images++] = handles[0].image;
 
     if (res_scale != 1) {
-        handles[1] =
-            MakeHandle(instance, GetScaledWidth(), GetScaledHeight(), levels, texture_type, format,
-                       traits.usage, flags, traits.aspect, need_format_list, DebugName(true));
+        handles[1] = runtime->AllocateImage({GetScaledWidth(), GetScaledHeight(), levels,
+                                             texture_type, format, traits.usage, flags,
+                                             traits.aspect, need_format_list},
+                                            DebugName(true));
         raw_images[num_images++] = handles[1].image;
     }
 
@@ -758,29 +1029,46 @@ Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceBase& surface
     const bool has_normal = mat && mat->Map(MapType::Normal);
     const vk::Format format = traits.native;
 
-    u32 num_images = 0;
-    std::array<vk::Image, 2> raw_images;
-
     vk::ImageCreateFlags flags{};
     if (texture_type == VideoCore::TextureType::CubeMap) {
         flags |= vk::ImageCreateFlagBits::eCubeCompatible;
     }
 
     const std::string debug_name = DebugName(false, true);
-    handles[0] = MakeHandle(instance, mat->width, mat->height, levels, texture_type, format,
-                            traits.usage, flags, traits.aspect, false, debug_name);
-    raw_images[num_images++] = handles[0].image;
-
+    handles[0] = runtime->AllocateImage({mat->width, mat->height, levels, texture_type, format,
+                                         traits.usage, flags, traits.aspect, false},
+                                        debug_name);
     if (res_scale != 1) {
-        handles[1] = MakeHandle(instance, mat->width, mat->height, levels, texture_type,
-                                vk::Format::eR8G8B8A8Unorm, traits.usage, flags, traits.aspect,
-                                false, debug_name);
-        raw_images[num_images++] = handles[1].image;
+        handles[1] = runtime->AllocateImage({mat->width, mat->height, levels, texture_type,
+                                             vk::Format::eR8G8B8A8Unorm, traits.usage, flags,
+                                             traits.aspect, false},
+                                            debug_name);
     }
     if (has_normal) {
-        handles[2] = MakeHandle(instance, mat->width, mat->height, levels, texture_type, format,
-                                traits.usage, flags, traits.aspect, false, debug_name);
-        raw_images[num_images++] = handles[2].image;
+        handles[2] = runtime->AllocateImage({mat->width, mat->height, levels, texture_type,
+                                             format, traits.usage, flags, traits.aspect, false},
+                                            debug_name);
+    }
+
+    custom_format = mat->format;
+    material = mat;
+
+    // The layout transition is deferred to the first upload, which may record it on the
+    // transfer queue along with the copies.
+    if (runtime->transfer_queue.IsEnabled()) {
+        transfer_pending = true;
+        return;
+    }
+    InitializeImages();
+}
+
+void Surface::InitializeImages() {
+    u32 num_images = 0;
+    std::array<vk::Image, 3> raw_images;
+    for (const auto& handle : handles) {
+        if (handle.image) {
+            raw_images[num_images++] = handle.image;
+        }
     }
 
     runtime->renderpass_cache.EndRendering();
@@ -790,31 +1078,26 @@ Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceBase& surface
                                vk::PipelineStageFlagBits::eTopOfPipe,
                                vk::DependencyFlagBits::eByRegion, {}, {}, barriers);
     });
-
-    custom_format = mat->format;
-    material = mat;
 }
 
 Surface::~Surface() {
     if (!handles[0].image_view) {
         return;
     }
-    for (const auto& [alloc, image, image_view] : handles) {
-        if (image_view) {
-            runtime->FreeDescriptorSetsWithImage(*image_view);
-        }
-        if (image) {
-            vmaDestroyImage(instance->GetAllocator(), image, alloc);
+    for (auto& handle : handles) {
+        if (handle.image) {
+            runtime->RecycleImage(std::move(handle));
         }
     }
-    if (copy_handle.image_view) {
-        vmaDestroyImage(instance->GetAllocator(), copy_handle.image, copy_handle.alloc);
+    if (copy_handle.image) {
+        runtime->RecycleImage(std::move(copy_handle));
     }
 }
 
 void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
                      const VideoCore::StagingData& staging) {
     runtime->renderpass_cache.EndRendering();
+    const ProfileScope profile{*scheduler, "Texture Upload"};
 
     const RecordParams params = {
         .aspect = Aspect(),
@@ -898,6 +1181,13 @@ void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
 }
 
 void Surface::UploadCustom(const VideoCore::Material* material, u32 level) {
+    if (std::exchange(transfer_pending, false)) {
+        if (level == 0 && UploadCustomTransfer(material)) {
+            return;
+        }
+        InitializeImages();
+    }
+
     const u32 width = material->width;
     const u32 height = material->height;
     const auto color = material->textures[0];
@@ -975,17 +1265,127 @@ void Surface::UploadCustom(const VideoCore::Material* material, u32 level) {
     }
 }
 
+bool Surface::UploadCustomTransfer(const VideoCore::Material* material) {
+    auto& transfer_queue = runtime->transfer_queue;
+    u64 total_size = 0;
+    for (const auto texture : material->textures) {
+        total_size += texture ? texture->data.size() : 0;
+    }
+    if (!transfer_queue.CanStage(total_size)) {
+        return false;
+    }
+
+    struct ImageCopy {
+        vk::Image image;
+        u64 offset;
+    };
+    u32 num_copies = 0;
+    std::array<ImageCopy, VideoCore::MAX_MAPS> copies;
+    auto& staging = transfer_queue.Staging();
+    for (u32 i = 0; i < VideoCore::MAX_MAPS; i++) {
+        const auto texture = material->textures[i];
+        if (!texture) {
+            continue;
+        }
+        const u64 custom_size = texture->data.size();
+        const auto [data, offset, invalidate] = staging.Map(custom_size, 0);
+        std::memcpy(data, texture->data.data(), custom_size);
+        staging.Commit(custom_size);
+        copies[num_copies++] = {Image(i == 0 ? 0 : i + 1), offset};
+    }
+
+    u32 num_images = 0;
+    std::array<vk::Image, 3> raw_images;
+    for (const auto& handle : handles) {
+        if (handle.image) {
+            raw_images[num_images++] = handle.image;
+        }
+    }
+
+    // The images are exclusive to the graphics family, so the transfer queue releases them
+    // after the copies and the graphics queue acquires them before its first use.
+    const auto make_barriers = [&](vk::ImageLayout old_layout, vk::ImageLayout new_layout,
+                                   vk::AccessFlags src_access, vk::AccessFlags dst_access,
+                                   bool ownership_transfer) {
+        auto barriers = MakeInitBarriers(vk::ImageAspectFlagBits::eColor, raw_images, num_images);
+        for (auto& barrier : barriers) {
+            barrier.oldLayout = old_layout;
+            barrier.newLayout = new_layout;
+            barrier.srcAccessMask = src_access;
+            barrier.dstAccessMask = dst_access;
+            if (ownership_transfer) {
+                barrier.srcQueueFamilyIndex = instance->GetTransferQueueFamilyIndex();
+                barrier.dstQueueFamilyIndex = instance->GetGraphicsQueueFamilyIndex();
+            }
+        }
+        return barriers;
+    };
+    const auto init_barriers =
+        make_barriers(vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, {},
+                      vk::AccessFlagBits::eTransferWrite, false);
+    const auto release_barriers =
+        make_barriers(vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eGeneral,
+                      vk::AccessFlagBits::eTransferWrite, {}, true);
+    const auto acquire_barriers = make_barriers(vk::ImageLayout::eTransferDstOptimal,
+                                                vk::ImageLayout::eGeneral, {}, AccessFlags(), true);
+
+    const u32 width = material->width;
+    const u32 height = material->height;
+    transfer_queue.Record([&](vk::CommandBuffer cmdbuf) {
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                               vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, init_barriers);
+        for (u32 i = 0; i < num_copies; i++) {
+            const vk::BufferImageCopy buffer_image_copy = {
+                .bufferOffset = copies[i].offset,
+                .bufferRowLength = 0,
+                .bufferImageHeight = height,
+                .imageSubresource{
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .mipLevel = 0,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+                .imageOffset = {0, 0, 0},
+                .imageExtent = {width, height, 1},
+            };
+            cmdbuf.copyBufferToImage(staging.Handle(), copies[i].image,
+                                     vk::ImageLayout::eTransferDstOptimal, buffer_image_copy);
+        }
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                               vk::PipelineStageFlagBits::eBottomOfPipe,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, release_barriers);
+    });
+
+    runtime->renderpass_cache.EndRendering();
+    scheduler->Record([acquire_barriers, pipeline_flags = PipelineStageFlags()](
+                          vk::CommandBuffer cmdbuf) {
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, pipeline_flags,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, acquire_barriers);
+    });
+    return true;
+}
+
 void Surface::Download(const VideoCore::BufferTextureCopy& download,
                        const VideoCore::StagingData& staging) {
-    SCOPE_EXIT({
-        scheduler->Finish();
-        runtime->download_buffer.Commit(staging.size);
-    });
+    RecordDownload(download, runtime->download_buffer.Handle());
+    scheduler->Finish();
+    runtime->download_buffer.Commit(staging.size);
+}
+
+u64 Surface::DownloadAsync(const VideoCore::BufferTextureCopy& download,
+                           const VideoCore::StagingData& staging) {
+    RecordDownload(download, runtime->readback_buffer.Handle());
+    runtime->readback_buffer.Commit(staging.size);
+    return scheduler->CurrentTick();
+}
 
+void Surface::RecordDownload(const VideoCore::BufferTextureCopy& download, vk::Buffer buffer) {
     runtime->renderpass_cache.EndRendering();
+    const ProfileScope profile{*scheduler, "Texture Download"};
 
     if (pixel_format == PixelFormat::D24S8) {
-        runtime->blit_helper.DepthToBuffer(*this, runtime->download_buffer.Handle(), download);
+        runtime->blit_helper.DepthToBuffer(*this, buffer, download);
         return;
     }
 
@@ -1007,58 +1407,57 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download,
         .src_image = Image(0),
     };
 
-    scheduler->Record(
-        [buffer = runtime->download_buffer.Handle(), params, download](vk::CommandBuffer cmdbuf) {
-            const auto rect = download.texture_rect;
-            const vk::BufferImageCopy buffer_image_copy = {
-                .bufferOffset = download.buffer_offset,
-                .bufferRowLength = rect.GetWidth(),
-                .bufferImageHeight = rect.GetHeight(),
-                .imageSubresource{
-                    .aspectMask = params.aspect,
-                    .mipLevel = download.texture_level,
-                    .baseArrayLayer = 0,
-                    .layerCount = 1,
-                },
-                .imageOffset = {static_cast<s32>(rect.left), static_cast<s32>(rect.bottom), 0},
-                .imageExtent = {rect.GetWidth(), rect.GetHeight(), 1},
-            };
+    scheduler->Record([buffer, params, download](vk::CommandBuffer cmdbuf) {
+        const auto rect = download.texture_rect;
+        const vk::BufferImageCopy buffer_image_copy = {
+            .bufferOffset = download.buffer_offset,
+            .bufferRowLength = rect.GetWidth(),
+            .bufferImageHeight = rect.GetHeight(),
+            .imageSubresource{
+                .aspectMask = params.aspect,
+                .mipLevel = download.texture_level,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+            .imageOffset = {static_cast<s32>(rect.left), static_cast<s32>(rect.bottom), 0},
+            .imageExtent = {rect.GetWidth(), rect.GetHeight(), 1},
+        };
 
-            const vk::ImageMemoryBarrier read_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .dstAccessMask = vk::AccessFlagBits::eTransferRead,
-                .oldLayout = vk::ImageLayout::eGeneral,
-                .newLayout = vk::ImageLayout::eTransferSrcOptimal,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = params.src_image,
-                .subresourceRange = MakeSubresourceRange(params.aspect, download.texture_level),
-            };
-            const vk::ImageMemoryBarrier image_write_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eNone,
-                .dstAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
-                .newLayout = vk::ImageLayout::eGeneral,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = params.src_image,
-                .subresourceRange = MakeSubresourceRange(params.aspect, download.texture_level),
-            };
-            const vk::MemoryBarrier memory_write_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
-            };
+        const vk::ImageMemoryBarrier read_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .oldLayout = vk::ImageLayout::eGeneral,
+            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = params.src_image,
+            .subresourceRange = MakeSubresourceRange(params.aspect, download.texture_level),
+        };
+        const vk::ImageMemoryBarrier image_write_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eNone,
+            .dstAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = params.src_image,
+            .subresourceRange = MakeSubresourceRange(params.aspect, download.texture_level),
+        };
+        const vk::MemoryBarrier memory_write_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+        };
 
-            cmdbuf.pipelineBarrier(params.pipeline_flags, vk::PipelineStageFlagBits::eTransfer,
-                                   vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
+        cmdbuf.pipelineBarrier(params.pipeline_flags, vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
 
-            cmdbuf.copyImageToBuffer(params.src_image, vk::ImageLayout::eTransferSrcOptimal, buffer,
-                                     buffer_image_copy);
+        cmdbuf.copyImageToBuffer(params.src_image, vk::ImageLayout::eTransferSrcOptimal, buffer,
+                                 buffer_image_copy);
 
-            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, params.pipeline_flags,
-                                   vk::DependencyFlagBits::eByRegion, memory_write_barrier, {},
-                                   image_write_barrier);
-        });
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, params.pipeline_flags,
+                               vk::DependencyFlagBits::eByRegion, memory_write_barrier, {},
+                               image_write_barrier);
+    });
 }
 
 void Surface::ScaleUp(u32 new_scale) {
@@ -1078,11 +1477,13 @@ void Surface::ScaleUp(u32 new_scale) {
         flags |= vk::ImageCreateFlagBits::eMutableFormat;
     }
 
-    handles[1] =
-        MakeHandle(instance, GetScaledWidth(), GetScaledHeight(), levels, texture_type,
-                   traits.native, traits.usage, flags, traits.aspect, false, DebugName(true));
+    handles[1] = runtime->AllocateImage({GetScaledWidth(), GetScaledHeight(), levels,
+                                         texture_type, traits.native, traits.usage, flags,
+                                         traits.aspect, false},
+                                        DebugName(true));
 
     runtime->renderpass_cache.EndRendering();
+    const ProfileScope profile{*scheduler, "Surface Scale"};
     scheduler->Record(
         [raw_images = std::array{Image()}, aspect = traits.aspect](vk::CommandBuffer cmdbuf) {
             const auto barriers = MakeInitBarriers(aspect, raw_images, raw_images.size());
@@ -1154,9 +1555,9 @@ vk::ImageView Surface::CopyImageView() noexcept {
         if (texture_type == VideoCore::TextureType::CubeMap) {
             flags |= vk::ImageCreateFlagBits::eCubeCompatible;
         }
-        copy_handle =
-            MakeHandle(instance, GetScaledWidth(), GetScaledHeight(), levels, texture_type,
-                       traits.native, traits.usage, flags, traits.aspect, false);
+        copy_handle = runtime->AllocateImage({GetScaledWidth(), GetScaledHeight(), levels,
+                                              texture_type, traits.native, traits.usage, flags,
+                                              traits.aspect, false});
         copy_layout = vk::ImageLayout::eUndefined;
     }
 
@@ -1494,6 +1895,12 @@ Framebuffer::Framebuffer(TextureRuntime& runtime, const VideoCore::FramebufferPa
         attachments[num_attachments++] = image_views[1];
     }
 
+    valid = true;
+    if (runtime.GetInstance().IsDynamicRenderingSupported()) {
+        // Dynamic rendering renders straight into the image views.
+        return;
+    }
+
     const vk::Device device = runtime.GetInstance().GetDevice();
     if (shadow_rendering) {
         render_pass =
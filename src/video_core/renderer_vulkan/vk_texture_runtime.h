@@ -6,12 +6,16 @@
 
 #include <deque>
 #include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include "video_core/rasterizer_cache/framebuffer_base.h"
 #include "video_core/rasterizer_cache/rasterizer_cache_base.h"
 #include "video_core/rasterizer_cache/surface_base.h"
 #include "video_core/renderer_vulkan/vk_blit_helper.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_stream_buffer.h"
+#include "video_core/renderer_vulkan/vk_transfer_queue.h"
 
 VK_DEFINE_HANDLE(VmaAllocation)
 
@@ -27,10 +31,30 @@ class DescriptorPool;
 class DescriptorSetProvider;
 class Surface;
 
+/// Creation parameters of a surface image, images with equal parameters are interchangeable
+struct ImageParams {
+    u32 width;
+    u32 height;
+    u32 levels;
+    VideoCore::TextureType type;
+    vk::Format format;
+    vk::ImageUsageFlags usage;
+    vk::ImageCreateFlags flags;
+    vk::ImageAspectFlags aspect;
+    bool need_format_list;
+
+    bool operator==(const ImageParams&) const = default;
+
+    struct Hash {
+        std::size_t operator()(const ImageParams& params) const noexcept;
+    };
+};
+
 struct Handle {
     VmaAllocation alloc;
     vk::Image image;
     vk::UniqueImageView image_view;
+    ImageParams params;
 };
 
 /**
@@ -67,6 +91,27 @@ public:
     /// Maps an internal staging buffer of the provided size for pixel uploads/downloads
     VideoCore::StagingData FindStaging(u32 size, bool upload);
 
+    /// Maps a region of the readback ring used by asynchronous surface downloads
+    VideoCore::StagingData FindReadback(u32 size);
+
+    /// Returns the size of the readback ring, zero if asynchronous downloads are unsupported
+    u64 ReadbackCapacity() const;
+
+    /// Returns the device memory in bytes available to surfaces, zero if unknown
+    u64 MemoryBudget() const;
+
+    /// Waits for the asynchronous download submitted at tick to land in staging
+    void WaitReadback(u64 tick, const VideoCore::StagingData& staging);
+
+    /// Attempts to decode and upload tiled guest data to the surface with a compute shader
+    bool UploadTiled(Surface& surface, const VideoCore::SurfaceParams& load_info,
+                     std::span<const u8> data, VideoCore::BufferTextureCopy upload);
+
+    /// Attempts to perform a Y2R conversion into the surface with a compute shader
+    bool ConvertY2R(Surface& surface, const VideoCore::Y2RConfig& config,
+                    std::span<const std::span<const u8>, 3> planes,
+                    VideoCore::BufferTextureCopy upload);
+
     /// Attempts to reinterpret a rectangle of source to another rectangle of dest
     bool Reinterpret(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
 
@@ -88,11 +133,31 @@ public:
     /// Removes any descriptor sets that contain the provided image view.
     void FreeDescriptorSetsWithImage(vk::ImageView image_view);
 
+    /// Releases the recycled images that were not reused recently or exceed the memory budget
+    void TickFrame();
+
 private:
     /// Clears a partial texture rect using a clear rectangle
     void ClearTextureWithRenderpass(Surface& surface, const VideoCore::TextureClear& clear);
 
+    /// Returns an image created with params, reusing a recycled one when the GPU is done with it
+    Handle AllocateImage(const ImageParams& params, std::string_view debug_name = {});
+
+    /// Keeps the image of a destroyed surface around for surfaces created with same parameters
+    void RecycleImage(Handle&& handle);
+
+    /// Destroys the recycled images for which predicate returns true
+    template <typename Predicate>
+    void ReleaseRecycledImages(Predicate&& predicate);
+
 private:
+    struct RecycledImage {
+        Handle handle;
+        u64 tick;
+        u64 frame;
+        u64 size;
+    };
+
     const Instance& instance;
     Scheduler& scheduler;
     RenderpassCache& renderpass_cache;
@@ -100,6 +165,11 @@ private:
     BlitHelper blit_helper;
     StreamBuffer upload_buffer;
     StreamBuffer download_buffer;
+    StreamBuffer readback_buffer;
+    TransferQueue transfer_queue;
+    std::unordered_map<ImageParams, std::vector<RecycledImage>, ImageParams::Hash> recycled_images;
+    u64 recycled_bytes{};
+    u64 current_frame{};
     u32 num_swapchain_images;
 };
 
@@ -156,6 +226,10 @@ public:
     void Download(const VideoCore::BufferTextureCopy& download,
                   const VideoCore::StagingData& staging);
 
+    /// Records a download to staging without waiting for it, returning the tick to wait on
+    u64 DownloadAsync(const VideoCore::BufferTextureCopy& download,
+                      const VideoCore::StagingData& staging);
+
     /// Scales up the surface to match the new resolution scale.
     void ScaleUp(u32 new_scale);
 
@@ -172,6 +246,15 @@ private:
     /// Performs blit between the scaled/unscaled images
     void BlitScale(const VideoCore::TextureBlit& blit, bool up_scale);
 
+    /// Records the commands copying a rectangle region of the surface into buffer
+    void RecordDownload(const VideoCore::BufferTextureCopy& download, vk::Buffer buffer);
+
+    /// Transitions all images of the surface to the general layout on the graphics queue
+    void InitializeImages();
+
+    /// Uploads the base level of the material on the transfer queue, if it can stage it
+    bool UploadCustomTransfer(const VideoCore::Material* material);
+
     /// Downloads scaled depth stencil data
     void DepthStencilDownload(const VideoCore::BufferTextureCopy& download,
                               const VideoCore::StagingData& staging);
@@ -189,6 +272,7 @@ public:
     vk::UniqueImageView storage_view;
     bool is_framebuffer{};
     bool is_storage{};
+    bool transfer_pending{}; ///< Images are uninitialized until the first custom upload
 };
 
 class Framebuffer : public VideoCore::FramebufferParams {
@@ -215,6 +299,11 @@ public:
         return framebuffer.get();
     }
 
+    /// Returns false when there is nothing to render into, such as shadow rendering without color.
+    [[nodiscard]] bool IsValid() const noexcept {
+        return valid;
+    }
+
     [[nodiscard]] std::array<vk::Image, 2> Images() const noexcept {
         return images;
     }
@@ -250,6 +339,7 @@ private:
     u32 width{};
     u32 height{};
     u32 res_scale{1};
+    bool valid{};
 };
 
 class Sampler {
@@ -0,0 +1,122 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <limits>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_transfer_queue.h"
+
+namespace Vulkan {
+
+TransferQueue::TransferQueue(const Instance& instance_, Scheduler& scheduler_)
+    : instance{instance_}, scheduler{scheduler_} {
+    // Graphics submissions wait on the batches with a timeline semaphore
+    if (!instance.HasDedicatedTransferQueue() || !instance.IsTimelineSemaphoreSupported()) {
+        return;
+    }
+
+    const vk::Device device = instance.GetDevice();
+    const vk::StructureChain semaphore_chain = {
+        vk::SemaphoreCreateInfo{},
+        vk::SemaphoreTypeCreateInfoKHR{
+            .semaphoreType = vk::SemaphoreType::eTimeline,
+            .initialValue = 0,
+        },
+    };
+    semaphore = device.createSemaphoreUnique(semaphore_chain.get());
+
+    const vk::CommandPoolCreateInfo pool_create_info = {
+        .flags = vk::CommandPoolCreateFlagBits::eTransient |
+                 vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+        .queueFamilyIndex = instance.GetTransferQueueFamilyIndex(),
+    };
+    command_pool = device.createCommandPoolUnique(pool_create_info);
+
+    // The staging buffer is only read by the transfer queue, its regions are recycled with the
+    // ticks of the graphics submissions that wait on the batch reading them.
+    staging.emplace(instance, scheduler, vk::BufferUsageFlagBits::eTransferSrc, STAGING_SIZE,
+                    BufferType::Upload);
+    scheduler.SetSubmitCallback([this] { return Flush(); });
+
+    LOG_INFO(Render_Vulkan, "Using transfer queue family {} for uploads",
+             instance.GetTransferQueueFamilyIndex());
+}
+
+TransferQueue::~TransferQueue() {
+    if (!IsEnabled()) {
+        return;
+    }
+    scheduler.SetSubmitCallback({});
+
+    const u64 last_value = next_value - 1;
+    const vk::SemaphoreWaitInfoKHR wait_info = {
+        .semaphoreCount = 1,
+        .pSemaphores = &semaphore.get(),
+        .pValues = &last_value,
+    };
+    const vk::Result result =
+        instance.GetDevice().waitSemaphoresKHR(&wait_info, std::numeric_limits<u64>::max());
+    ASSERT(result == vk::Result::eSuccess);
+}
+
+TimelineWait TransferQueue::Flush() {
+    std::scoped_lock lock{mutex};
+    if (!current) {
+        return {};
+    }
+    current.end();
+
+    const u64 signal_value = next_value++;
+    const vk::TimelineSemaphoreSubmitInfoKHR timeline_si = {
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &signal_value,
+    };
+    const vk::SubmitInfo submit_info = {
+        .pNext = &timeline_si,
+        .commandBufferCount = 1u,
+        .pCommandBuffers = &current,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &semaphore.get(),
+    };
+
+    try {
+        instance.GetTransferQueue().submit(submit_info);
+    } catch (vk::DeviceLostError& err) {
+        LOG_CRITICAL(Render_Vulkan, "Device lost during transfer submit: {}", err.what());
+        UNREACHABLE();
+    }
+
+    submitted.push_back({current, signal_value});
+    current = vk::CommandBuffer{};
+    return {*semaphore, signal_value};
+}
+
+vk::CommandBuffer TransferQueue::CommandBuffer() {
+    if (current) {
+        return current;
+    }
+
+    // Recycle the command buffer of the oldest batch once the GPU is done with it
+    const vk::Device device = instance.GetDevice();
+    if (!submitted.empty() &&
+        device.getSemaphoreCounterValueKHR(*semaphore) >= submitted.front().value) {
+        current = submitted.front().cmdbuf;
+        submitted.pop_front();
+        current.reset();
+    } else {
+        const vk::CommandBufferAllocateInfo buffer_alloc_info = {
+            .commandPool = *command_pool,
+            .level = vk::CommandBufferLevel::ePrimary,
+            .commandBufferCount = 1,
+        };
+        current = device.allocateCommandBuffers(buffer_alloc_info).front();
+    }
+
+    current.begin({.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    return current;
+}
+
+} // namespace Vulkan
@@ -0,0 +1,80 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <optional>
+#include "common/literals.h"
+#include "video_core/renderer_vulkan/vk_master_semaphore.h"
+#include "video_core/renderer_vulkan/vk_stream_buffer.h"
+
+namespace Vulkan {
+
+using namespace Common::Literals;
+
+class Instance;
+class Scheduler;
+
+/**
+ * Records uploads on the dedicated transfer queue of the device, when it exposes one, so that
+ * large copies overlap with rendering instead of stalling the graphics queue. Commands are
+ * batched and submitted right before the next graphics submission, which waits on the timeline
+ * semaphore signalled by the batch.
+ */
+class TransferQueue {
+    static constexpr u64 STAGING_SIZE = 128_MiB;
+
+public:
+    explicit TransferQueue(const Instance& instance, Scheduler& scheduler);
+    ~TransferQueue();
+
+    /// Returns true when uploads can be recorded on the transfer queue.
+    [[nodiscard]] bool IsEnabled() const noexcept {
+        return staging.has_value();
+    }
+
+    /// Returns true when size bytes can be staged in a single upload.
+    [[nodiscard]] bool CanStage(u64 size) const noexcept {
+        return IsEnabled() && size <= STAGING_SIZE / 2;
+    }
+
+    /// Returns the staging buffer read by the transfer commands.
+    [[nodiscard]] StreamBuffer& Staging() noexcept {
+        return *staging;
+    }
+
+    /// Records commands in the current batch.
+    template <typename Func>
+    void Record(Func&& func) {
+        std::scoped_lock lock{mutex};
+        func(CommandBuffer());
+    }
+
+    /// Submits the current batch, returning the value graphics work must wait for.
+    TimelineWait Flush();
+
+private:
+    /// Returns the command buffer of the current batch, beginning a new one if needed.
+    vk::CommandBuffer CommandBuffer();
+
+private:
+    struct Batch {
+        vk::CommandBuffer cmdbuf;
+        u64 value;
+    };
+
+    const Instance& instance;
+    Scheduler& scheduler;
+    vk::UniqueSemaphore semaphore;
+    vk::UniqueCommandPool command_pool;
+    std::optional<StreamBuffer> staging;
+    std::deque<Batch> submitted;
+    vk::CommandBuffer current{};
+    u64 next_value{1};
+    std::mutex mutex;
+};
+
+} // namespace Vulkan
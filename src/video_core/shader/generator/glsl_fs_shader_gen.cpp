@@ -37,7 +37,7 @@ static bool IsPassThroughTevStage(const Pica::TexturingRegs::TevStageConfig& sta
 }
 
 // High precision may or may not be supported in GLES3. If it isn't, use medium precision instead.
-static constexpr char fragment_shader_precision_OES[] = R"(
+const std::string_view FSPrecisionDef = R"(
 #if GL_ES
 #ifdef GL_FRAGMENT_PRECISION_HIGH
 precision highp int;
@@ -53,7 +53,7 @@ precision mediump uimage2D;
 #endif
 )";
 
-constexpr static std::string_view FSUniformBlockDef = R"(
+const std::string_view FSUniformBlockDef = R"(
 #define NUM_TEV_STAGES 6
 #define NUM_LIGHTS 8
 #define NUM_LIGHTING_SAMPLERS 24
@@ -867,23 +867,29 @@ uint s = uint(combiner_output.g * float(0xFF));
 ivec2 image_coord = ivec2(gl_FragCoord.xy);
 )";
 
+    // Most fragments fail the depth comparison and leave the pixel as it is, they skip the store
     if (use_fragment_shader_interlock) {
         out += R"(
 beginInvocationInterlock();
 uint old_shadow = imageLoad(shadow_buffer, image_coord).x;
 uint new_shadow = UpdateShadow(old_shadow, d, s);
-imageStore(shadow_buffer, image_coord, uvec4(new_shadow));
+if (new_shadow != old_shadow) {
+    imageStore(shadow_buffer, image_coord, uvec4(new_shadow));
+}
 endInvocationInterlock();
 )";
     } else {
         out += R"(
 uint old = imageLoad(shadow_buffer, image_coord).x;
-uint new1;
-uint old2;
-do {
-    old2 = old;
+uint new1 = UpdateShadow(old, d, s);
+while (new1 != old) {
+    uint old2 = imageAtomicCompSwap(shadow_buffer, image_coord, old, new1);
+    if (old2 == old) {
+        break;
+    }
+    old = old2;
     new1 = UpdateShadow(old, d, s);
-} while ((old = imageAtomicCompSwap(shadow_buffer, image_coord, old, new1)) != old2);
+}
 )";
     }
 }
@@ -1226,15 +1232,19 @@ void FragmentModule::DefineExtensions() {
         out += "#extension GL_ARB_separate_shader_objects : enable\n";
     }
     if (config.framebuffer.shadow_rendering) {
+        // Overlapping fragments only need to update the shadow buffer one at a time. Like with the
+        // atomic fallback, they do not need to do so in primitive order, which is cheaper.
         use_fragment_shader_interlock = true;
         if (profile.has_fragment_shader_interlock) {
             out += "#extension GL_ARB_fragment_shader_interlock : enable\n";
             out += "#define beginInvocationInterlock beginInvocationInterlockARB\n";
             out += "#define endInvocationInterlock endInvocationInterlockARB\n";
+            out += "layout(pixel_interlock_unordered) in;\n";
         } else if (profile.has_gl_nv_fragment_shader_interlock) {
             out += "#extension GL_NV_fragment_shader_interlock : enable\n";
             out += "#define beginInvocationInterlock beginInvocationInterlockNV\n";
             out += "#define endInvocationInterlock endInvocationInterlockNV\n";
+            out += "layout(pixel_interlock_unordered) in;\n";
         } else if (profile.has_gl_intel_fragment_shader_ordering) {
             // NOTE: Intel does not have an end function for this.
             out += "#extension GL_INTEL_fragment_shader_ordering : enable\n";
@@ -1272,7 +1282,7 @@ void FragmentModule::DefineExtensions() {
     }
 
     if (!profile.is_vulkan) {
-        out += fragment_shader_precision_OES;
+        out += FSPrecisionDef;
     }
 }
 
@@ -1334,8 +1344,9 @@ void FragmentModule::DefineBindings() {
             shadow_set, i, postfixes[i]);
     }
     if (config.framebuffer.shadow_rendering) {
-        out += fmt::format("layout({}binding = 6, r32ui) uniform uimage2D shadow_buffer;\n\n",
-                           shadow_set);
+        out += fmt::format(
+            "layout({}binding = 6, r32ui) uniform coherent uimage2D shadow_buffer;\n\n",
+            shadow_set);
     }
 }
 
@@ -8,6 +8,12 @@
 
 namespace Pica::Shader::Generator::GLSL {
 
+/// Precision qualifiers declared by fragment shaders running on GLES
+extern const std::string_view FSPrecisionDef;
+
+/// Declaration of the fs_data uniform block, matching the layout of FSUniformData
+extern const std::string_view FSUniformBlockDef;
+
 class FragmentModule {
 public:
     explicit FragmentModule(const FSConfig& config, const Profile& profile);
@@ -0,0 +1,1167 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <cstring>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "video_core/shader/generator/glsl_fs_shader_gen.h"
+#include "video_core/shader/generator/glsl_fs_ubershader_gen.h"
+#include "video_core/shader/generator/shader_gen.h"
+
+namespace Pica::Shader::Generator::GLSL {
+
+namespace {
+
+using TevStageConfig = TexturingRegs::TevStageConfig;
+using TextureType = TexturingRegs::TextureConfig::TextureType;
+using LightingSampler = LightingRegs::LightingSampler;
+
+static_assert(sizeof(FSConfig) <= sizeof(FSConfigData), "FSConfig does not fit the ubershader");
+static_assert(sizeof(TevStageConfigRaw) == 4 * sizeof(u32));
+static_assert(sizeof(LutConfig) == 2 * sizeof(u32));
+static_assert(sizeof(Light) == sizeof(u16));
+static_assert(sizeof(TextureBorder) == sizeof(u32));
+
+constexpr std::size_t LutSlot(std::size_t offset) {
+    return (offset - offsetof(FSConfig, lighting.lut_d0)) / sizeof(LutConfig);
+}
+
+/// LUT configurations are stored in the order d0, d1, sp, fr, rr, rg, rb.
+constexpr std::array<std::pair<LightingSampler, std::size_t>, 7> LightingLuts = {{
+    {LightingSampler::Distribution0, LutSlot(offsetof(FSConfig, lighting.lut_d0))},
+    {LightingSampler::Distribution1, LutSlot(offsetof(FSConfig, lighting.lut_d1))},
+    {LightingSampler::SpotlightAttenuation, LutSlot(offsetof(FSConfig, lighting.lut_sp))},
+    {LightingSampler::Fresnel, LutSlot(offsetof(FSConfig, lighting.lut_fr))},
+    {LightingSampler::ReflectRed, LutSlot(offsetof(FSConfig, lighting.lut_rr))},
+    {LightingSampler::ReflectGreen, LutSlot(offsetof(FSConfig, lighting.lut_rg))},
+    {LightingSampler::ReflectBlue, LutSlot(offsetof(FSConfig, lighting.lut_rb))},
+}};
+
+/// Defines a macro that reads bits [position, position + bits) of the config at byte offset
+void DefineBits(std::string& out, std::string_view name, std::size_t offset, std::size_t position,
+                std::size_t bits) {
+    const std::size_t bit = (offset % sizeof(u32)) * 8 + position;
+    out += fmt::format("#define {} ConfigBits({}u, {}u, {}u)\n", name, offset / sizeof(u32), bit,
+                       bits);
+}
+
+/// Defines a macro that reads the bitfield Field of the config structure at byte offset
+template <typename Field>
+void DefineField(std::string& out, std::string_view name, std::size_t offset) {
+    DefineBits(out, name, offset, Field::position, Field::bits);
+}
+
+/// Defines a function-like macro that extracts the bitfield Field from an already read word
+template <typename Field>
+void DefineExtract(std::string& out, std::string_view name) {
+    out += fmt::format("#define {}(value) (((value) >> {}u) & {}u)\n", name, Field::position,
+                       (1u << Field::bits) - 1);
+}
+
+/// Defines a macro holding the config word index of the provided byte offset
+void DefineWord(std::string& out, std::string_view name, std::size_t offset) {
+    out += fmt::format("#define {} {}u\n", name, offset / sizeof(u32));
+}
+
+template <typename T>
+void DefineConstant(std::string& out, std::string_view name, T value) {
+    out += fmt::format("#define {} {}u\n", name, static_cast<u32>(value));
+}
+
+void DefineConfigLayout(std::string& out) {
+    constexpr std::size_t fb = offsetof(FSConfig, framebuffer);
+    DefineField<decltype(FramebufferConfig::alpha_test_func)>(out, "ALPHA_TEST_FUNC", fb);
+    DefineField<decltype(FramebufferConfig::scissor_test_mode)>(out, "SCISSOR_TEST_MODE", fb);
+    DefineField<decltype(FramebufferConfig::depthmap_enable)>(out, "DEPTHMAP_ENABLE", fb);
+    DefineField<decltype(FramebufferConfig::logic_op)>(out, "LOGIC_OP", fb);
+
+    constexpr std::size_t tex = offsetof(FSConfig, texture);
+    DefineField<decltype(TextureConfig::texture0_type)>(out, "TEXTURE0_TYPE", tex);
+    DefineField<decltype(TextureConfig::texture2_use_coord1)>(out, "TEXTURE2_USE_COORD1", tex);
+    DefineField<decltype(TextureConfig::combiner_buffer_input)>(out, "COMBINER_BUFFER_INPUT",
+                                                                tex);
+    DefineField<decltype(TextureConfig::fog_mode)>(out, "FOG_MODE", tex);
+    DefineField<decltype(TextureConfig::fog_flip)>(out, "FOG_FLIP", tex);
+    for (u32 i = 0; i < 3; i++) {
+        const std::size_t border =
+            offsetof(FSConfig, texture.texture_border_color) + i * sizeof(TextureBorder);
+        DefineField<decltype(TextureBorder::enable_s)>(out, fmt::format("TEXTURE_BORDER_S{}", i),
+                                                       border);
+        DefineField<decltype(TextureBorder::enable_t)>(out, fmt::format("TEXTURE_BORDER_T{}", i),
+                                                       border);
+    }
+
+    DefineWord(out, "TEV_STAGES_WORD", offsetof(FSConfig, texture.tev_stages));
+    DefineExtract<decltype(TevStageConfig::color_source1)>(out, "TEV_COLOR_SOURCE1");
+    DefineExtract<decltype(TevStageConfig::color_source2)>(out, "TEV_COLOR_SOURCE2");
+    DefineExtract<decltype(TevStageConfig::color_source3)>(out, "TEV_COLOR_SOURCE3");
+    DefineExtract<decltype(TevStageConfig::alpha_source1)>(out, "TEV_ALPHA_SOURCE1");
+    DefineExtract<decltype(TevStageConfig::alpha_source2)>(out, "TEV_ALPHA_SOURCE2");
+    DefineExtract<decltype(TevStageConfig::alpha_source3)>(out, "TEV_ALPHA_SOURCE3");
+    DefineExtract<decltype(TevStageConfig::color_modifier1)>(out, "TEV_COLOR_MODIFIER1");
+    DefineExtract<decltype(TevStageConfig::color_modifier2)>(out, "TEV_COLOR_MODIFIER2");
+    DefineExtract<decltype(TevStageConfig::color_modifier3)>(out, "TEV_COLOR_MODIFIER3");
+    DefineExtract<decltype(TevStageConfig::alpha_modifier1)>(out, "TEV_ALPHA_MODIFIER1");
+    DefineExtract<decltype(TevStageConfig::alpha_modifier2)>(out, "TEV_ALPHA_MODIFIER2");
+    DefineExtract<decltype(TevStageConfig::alpha_modifier3)>(out, "TEV_ALPHA_MODIFIER3");
+    DefineExtract<decltype(TevStageConfig::color_op)>(out, "TEV_COLOR_OP");
+    DefineExtract<decltype(TevStageConfig::alpha_op)>(out, "TEV_ALPHA_OP");
+    DefineExtract<decltype(TevStageConfig::color_scale)>(out, "TEV_COLOR_SCALE");
+    DefineExtract<decltype(TevStageConfig::alpha_scale)>(out, "TEV_ALPHA_SCALE");
+
+    constexpr std::size_t light = offsetof(FSConfig, lighting);
+    DefineField<decltype(LightConfig::enable)>(out, "LIGHTING_ENABLE", light);
+    DefineField<decltype(LightConfig::src_num)>(out, "LIGHTING_SRC_NUM", light);
+    DefineField<decltype(LightConfig::bump_mode)>(out, "LIGHTING_BUMP_MODE", light);
+    DefineField<decltype(LightConfig::bump_selector)>(out, "LIGHTING_BUMP_SELECTOR", light);
+    DefineField<decltype(LightConfig::bump_renorm)>(out, "LIGHTING_BUMP_RENORM", light);
+    DefineField<decltype(LightConfig::clamp_highlights)>(out, "LIGHTING_CLAMP_HIGHLIGHTS", light);
+    DefineField<decltype(LightConfig::config)>(out, "LIGHTING_CONFIG", light);
+    DefineField<decltype(LightConfig::enable_primary_alpha)>(out, "LIGHTING_PRIMARY_ALPHA", light);
+    DefineField<decltype(LightConfig::enable_secondary_alpha)>(out, "LIGHTING_SECONDARY_ALPHA",
+                                                               light);
+    DefineField<decltype(LightConfig::enable_shadow)>(out, "LIGHTING_ENABLE_SHADOW", light);
+    DefineField<decltype(LightConfig::shadow_primary)>(out, "LIGHTING_SHADOW_PRIMARY", light);
+    DefineField<decltype(LightConfig::shadow_secondary)>(out, "LIGHTING_SHADOW_SECONDARY", light);
+    DefineField<decltype(LightConfig::shadow_invert)>(out, "LIGHTING_SHADOW_INVERT", light);
+    DefineField<decltype(LightConfig::shadow_alpha)>(out, "LIGHTING_SHADOW_ALPHA", light);
+    DefineField<decltype(LightConfig::shadow_selector)>(out, "LIGHTING_SHADOW_SELECTOR", light);
+
+    DefineWord(out, "LIGHTING_LUT_WORD", offsetof(FSConfig, lighting.lut_d0));
+    DefineExtract<decltype(LutConfig::enable)>(out, "LUT_ENABLE");
+    DefineExtract<decltype(LutConfig::abs_input)>(out, "LUT_ABS_INPUT");
+    DefineExtract<decltype(LutConfig::type)>(out, "LUT_TYPE");
+
+    out += fmt::format("#define LIGHTS_OFFSET {}u\n", offsetof(FSConfig, lighting.lights));
+    DefineExtract<decltype(Light::num)>(out, "LIGHT_NUM");
+    DefineExtract<decltype(Light::directional)>(out, "LIGHT_DIRECTIONAL");
+    DefineExtract<decltype(Light::two_sided_diffuse)>(out, "LIGHT_TWO_SIDED_DIFFUSE");
+    DefineExtract<decltype(Light::dist_atten_enable)>(out, "LIGHT_DIST_ATTEN_ENABLE");
+    DefineExtract<decltype(Light::spot_atten_enable)>(out, "LIGHT_SPOT_ATTEN_ENABLE");
+    DefineExtract<decltype(Light::geometric_factor_0)>(out, "LIGHT_GEOMETRIC_FACTOR_0");
+    DefineExtract<decltype(Light::geometric_factor_1)>(out, "LIGHT_GEOMETRIC_FACTOR_1");
+    DefineExtract<decltype(Light::shadow_enable)>(out, "LIGHT_SHADOW_ENABLE");
+
+    constexpr std::size_t proctex = offsetof(FSConfig, proctex);
+    DefineField<decltype(ProcTexConfig::enable)>(out, "PROCTEX_ENABLE", proctex);
+    DefineField<decltype(ProcTexConfig::coord)>(out, "PROCTEX_COORD", proctex);
+    DefineField<decltype(ProcTexConfig::u_clamp)>(out, "PROCTEX_U_CLAMP", proctex);
+    DefineField<decltype(ProcTexConfig::v_clamp)>(out, "PROCTEX_V_CLAMP", proctex);
+    DefineField<decltype(ProcTexConfig::color_combiner)>(out, "PROCTEX_COLOR_COMBINER", proctex);
+    DefineField<decltype(ProcTexConfig::alpha_combiner)>(out, "PROCTEX_ALPHA_COMBINER", proctex);
+    DefineField<decltype(ProcTexConfig::lut_filter)>(out, "PROCTEX_LUT_FILTER", proctex);
+    DefineField<decltype(ProcTexConfig::separate_alpha)>(out, "PROCTEX_SEPARATE_ALPHA", proctex);
+    DefineField<decltype(ProcTexConfig::noise_enable)>(out, "PROCTEX_NOISE_ENABLE", proctex);
+    DefineField<decltype(ProcTexConfig::u_shift)>(out, "PROCTEX_U_SHIFT", proctex);
+    DefineField<decltype(ProcTexConfig::v_shift)>(out, "PROCTEX_V_SHIFT", proctex);
+    const auto define_int = [&out](std::string_view name, std::size_t offset) {
+        out += fmt::format("#define {} int(ConfigWord({}u))\n", name, offset / sizeof(u32));
+    };
+    define_int("PROCTEX_LUT_WIDTH", offsetof(FSConfig, proctex.lut_width));
+    define_int("PROCTEX_LUT_OFFSET0", offsetof(FSConfig, proctex.lut_offset0));
+    define_int("PROCTEX_LUT_OFFSET1", offsetof(FSConfig, proctex.lut_offset1));
+    define_int("PROCTEX_LUT_OFFSET2", offsetof(FSConfig, proctex.lut_offset2));
+    define_int("PROCTEX_LUT_OFFSET3", offsetof(FSConfig, proctex.lut_offset3));
+    DefineBits(out, "PROCTEX_LOD_MIN", offsetof(FSConfig, proctex.lod_min), 0, 16);
+    DefineBits(out, "PROCTEX_LOD_MAX", offsetof(FSConfig, proctex.lod_max), 0, 16);
+}
+
+void DefineConstants(std::string& out) {
+    using CompareFunc = FramebufferRegs::CompareFunc;
+    DefineConstant(out, "COMPARE_NEVER", CompareFunc::Never);
+    DefineConstant(out, "COMPARE_ALWAYS", CompareFunc::Always);
+    DefineConstant(out, "COMPARE_EQUAL", CompareFunc::Equal);
+    DefineConstant(out, "COMPARE_NOT_EQUAL", CompareFunc::NotEqual);
+    DefineConstant(out, "COMPARE_LESS_THAN", CompareFunc::LessThan);
+    DefineConstant(out, "COMPARE_LESS_THAN_OR_EQUAL", CompareFunc::LessThanOrEqual);
+    DefineConstant(out, "COMPARE_GREATER_THAN", CompareFunc::GreaterThan);
+    DefineConstant(out, "COMPARE_GREATER_THAN_OR_EQUAL", CompareFunc::GreaterThanOrEqual);
+
+    DefineConstant(out, "SCISSOR_DISABLED", RasterizerRegs::ScissorMode::Disabled);
+    DefineConstant(out, "SCISSOR_INCLUDE", RasterizerRegs::ScissorMode::Include);
+    DefineConstant(out, "DEPTH_W_BUFFERING", RasterizerRegs::DepthBuffering::WBuffering);
+    DefineConstant(out, "LOGIC_OP_CLEAR", FramebufferRegs::LogicOp::Clear);
+    DefineConstant(out, "LOGIC_OP_SET", FramebufferRegs::LogicOp::Set);
+    DefineConstant(out, "TEXTURE_TYPE_PROJECTION_2D", TextureType::Projection2D);
+    DefineConstant(out, "TEXTURE_TYPE_DISABLED", TextureType::Disabled);
+    DefineConstant(out, "FOG_MODE_FOG", TexturingRegs::FogMode::Fog);
+    DefineConstant(out, "FOG_MODE_GAS", TexturingRegs::FogMode::Gas);
+
+    using Source = TevStageConfig::Source;
+    DefineConstant(out, "SOURCE_PRIMARY_COLOR", Source::PrimaryColor);
+    DefineConstant(out, "SOURCE_PRIMARY_FRAGMENT_COLOR", Source::PrimaryFragmentColor);
+    DefineConstant(out, "SOURCE_SECONDARY_FRAGMENT_COLOR", Source::SecondaryFragmentColor);
+    DefineConstant(out, "SOURCE_TEXTURE0", Source::Texture0);
+    DefineConstant(out, "SOURCE_TEXTURE1", Source::Texture1);
+    DefineConstant(out, "SOURCE_TEXTURE2", Source::Texture2);
+    DefineConstant(out, "SOURCE_TEXTURE3", Source::Texture3);
+    DefineConstant(out, "SOURCE_PREVIOUS_BUFFER", Source::PreviousBuffer);
+    DefineConstant(out, "SOURCE_CONSTANT", Source::Constant);
+    DefineConstant(out, "SOURCE_PREVIOUS", Source::Previous);
+
+    using ColorModifier = TevStageConfig::ColorModifier;
+    DefineConstant(out, "COLOR_SOURCE_COLOR", ColorModifier::SourceColor);
+    DefineConstant(out, "COLOR_ONE_MINUS_SOURCE_COLOR", ColorModifier::OneMinusSourceColor);
+    DefineConstant(out, "COLOR_SOURCE_ALPHA", ColorModifier::SourceAlpha);
+    DefineConstant(out, "COLOR_ONE_MINUS_SOURCE_ALPHA", ColorModifier::OneMinusSourceAlpha);
+    DefineConstant(out, "COLOR_SOURCE_RED", ColorModifier::SourceRed);
+    DefineConstant(out, "COLOR_ONE_MINUS_SOURCE_RED", ColorModifier::OneMinusSourceRed);
+    DefineConstant(out, "COLOR_SOURCE_GREEN", ColorModifier::SourceGreen);
+    DefineConstant(out, "COLOR_ONE_MINUS_SOURCE_GREEN", ColorModifier::OneMinusSourceGreen);
+    DefineConstant(out, "COLOR_SOURCE_BLUE", ColorModifier::SourceBlue);
+    DefineConstant(out, "COLOR_ONE_MINUS_SOURCE_BLUE", ColorModifier::OneMinusSourceBlue);
+
+    using AlphaModifier = TevStageConfig::AlphaModifier;
+    DefineConstant(out, "ALPHA_SOURCE_ALPHA", AlphaModifier::SourceAlpha);
+    DefineConstant(out, "ALPHA_ONE_MINUS_SOURCE_ALPHA", AlphaModifier::OneMinusSourceAlpha);
+    DefineConstant(out, "ALPHA_SOURCE_RED", AlphaModifier::SourceRed);
+    DefineConstant(out, "ALPHA_ONE_MINUS_SOURCE_RED", AlphaModifier::OneMinusSourceRed);
+    DefineConstant(out, "ALPHA_SOURCE_GREEN", AlphaModifier::SourceGreen);
+    DefineConstant(out, "ALPHA_ONE_MINUS_SOURCE_GREEN", AlphaModifier::OneMinusSourceGreen);
+    DefineConstant(out, "ALPHA_SOURCE_BLUE", AlphaModifier::SourceBlue);
+    DefineConstant(out, "ALPHA_ONE_MINUS_SOURCE_BLUE", AlphaModifier::OneMinusSourceBlue);
+
+    using Operation = TevStageConfig::Operation;
+    DefineConstant(out, "OPERATION_REPLACE", Operation::Replace);
+    DefineConstant(out, "OPERATION_MODULATE", Operation::Modulate);
+    DefineConstant(out, "OPERATION_ADD", Operation::Add);
+    DefineConstant(out, "OPERATION_ADD_SIGNED", Operation::AddSigned);
+    DefineConstant(out, "OPERATION_LERP", Operation::Lerp);
+    DefineConstant(out, "OPERATION_SUBTRACT", Operation::Subtract);
+    DefineConstant(out, "OPERATION_DOT3_RGB", Operation::Dot3_RGB);
+    DefineConstant(out, "OPERATION_DOT3_RGBA", Operation::Dot3_RGBA);
+    DefineConstant(out, "OPERATION_MULTIPLY_THEN_ADD", Operation::MultiplyThenAdd);
+    DefineConstant(out, "OPERATION_ADD_THEN_MULTIPLY", Operation::AddThenMultiply);
+
+    DefineConstant(out, "BUMP_NORMAL_MAP", LightingRegs::LightingBumpMode::NormalMap);
+    DefineConstant(out, "BUMP_TANGENT_MAP", LightingRegs::LightingBumpMode::TangentMap);
+    DefineConstant(out, "LIGHTING_CONFIG_7", LightingRegs::LightingConfig::Config7);
+
+    using LutInput = LightingRegs::LightingLutInput;
+    DefineConstant(out, "LUT_INPUT_NH", LutInput::NH);
+    DefineConstant(out, "LUT_INPUT_VH", LutInput::VH);
+    DefineConstant(out, "LUT_INPUT_NV", LutInput::NV);
+    DefineConstant(out, "LUT_INPUT_LN", LutInput::LN);
+    DefineConstant(out, "LUT_INPUT_SP", LutInput::SP);
+    DefineConstant(out, "LUT_INPUT_CP", LutInput::CP);
+
+    // Each lighting LUT is addressed by its slot in the config and its sampler in the LUT buffer.
+    static constexpr std::array lut_names = {"D0", "D1", "SP", "FR", "RR", "RG", "RB"};
+    for (std::size_t i = 0; i < LightingLuts.size(); i++) {
+        const auto [sampler, slot] = LightingLuts[i];
+        DefineConstant(out, fmt::format("LUT_{}", lut_names[i]), slot);
+        DefineConstant(out, fmt::format("SAMPLER_{}", lut_names[i]), sampler);
+    }
+    DefineConstant(out, "SAMPLER_DA", LightingSampler::DistanceAttenuation);
+
+    using ProcTexClamp = TexturingRegs::ProcTexClamp;
+    DefineConstant(out, "PROCTEX_CLAMP_TO_ZERO", ProcTexClamp::ToZero);
+    DefineConstant(out, "PROCTEX_CLAMP_TO_EDGE", ProcTexClamp::ToEdge);
+    DefineConstant(out, "PROCTEX_CLAMP_SYMMETRICAL_REPEAT", ProcTexClamp::SymmetricalRepeat);
+    DefineConstant(out, "PROCTEX_CLAMP_MIRRORED_REPEAT", ProcTexClamp::MirroredRepeat);
+    DefineConstant(out, "PROCTEX_CLAMP_PULSE", ProcTexClamp::Pulse);
+
+    using ProcTexCombiner = TexturingRegs::ProcTexCombiner;
+    DefineConstant(out, "PROCTEX_COMBINER_U", ProcTexCombiner::U);
+    DefineConstant(out, "PROCTEX_COMBINER_U2", ProcTexCombiner::U2);
+    DefineConstant(out, "PROCTEX_COMBINER_V", ProcTexCombiner::V);
+    DefineConstant(out, "PROCTEX_COMBINER_V2", ProcTexCombiner::V2);
+    DefineConstant(out, "PROCTEX_COMBINER_ADD", ProcTexCombiner::Add);
+    DefineConstant(out, "PROCTEX_COMBINER_ADD2", ProcTexCombiner::Add2);
+    DefineConstant(out, "PROCTEX_COMBINER_SQRT_ADD2", ProcTexCombiner::SqrtAdd2);
+    DefineConstant(out, "PROCTEX_COMBINER_MIN", ProcTexCombiner::Min);
+    DefineConstant(out, "PROCTEX_COMBINER_MAX", ProcTexCombiner::Max);
+    DefineConstant(out, "PROCTEX_COMBINER_RMAX", ProcTexCombiner::RMax);
+
+    DefineConstant(out, "PROCTEX_SHIFT_ODD", TexturingRegs::ProcTexShift::Odd);
+    DefineConstant(out, "PROCTEX_SHIFT_EVEN", TexturingRegs::ProcTexShift::Even);
+
+    using ProcTexFilter = TexturingRegs::ProcTexFilter;
+    DefineConstant(out, "PROCTEX_FILTER_NEAREST", ProcTexFilter::Nearest);
+    DefineConstant(out, "PROCTEX_FILTER_LINEAR", ProcTexFilter::Linear);
+    DefineConstant(out, "PROCTEX_FILTER_NEAREST_MIPMAP_NEAREST",
+                   ProcTexFilter::NearestMipmapNearest);
+    DefineConstant(out, "PROCTEX_FILTER_LINEAR_MIPMAP_NEAREST", ProcTexFilter::LinearMipmapNearest);
+    DefineConstant(out, "PROCTEX_FILTER_NEAREST_MIPMAP_LINEAR", ProcTexFilter::NearestMipmapLinear);
+    DefineConstant(out, "PROCTEX_FILTER_LINEAR_MIPMAP_LINEAR", ProcTexFilter::LinearMipmapLinear);
+
+    // Bitmask of the LUT slots each lighting configuration samples from.
+    std::array<u32, 16> lut_support{};
+    for (u32 config = 0; config < lut_support.size(); config++) {
+        for (const auto& [sampler, slot] : LightingLuts) {
+            if (LightingRegs::IsLightingSamplerSupported(
+                    static_cast<LightingRegs::LightingConfig>(config), sampler)) {
+                lut_support[config] |= 1u << slot;
+            }
+        }
+    }
+    out += fmt::format("const uint lighting_lut_support[16] = uint[]({}u);\n",
+                       fmt::join(lut_support, "u, "));
+}
+
+constexpr std::string_view UberShaderHelpers = R"(
+uint ConfigWord(uint word) {
+    return fs_config[word >> 2u][word & 3u];
+}
+
+uint ConfigBits(uint word, uint position, uint bits) {
+    return (ConfigWord(word) >> position) & ((1u << bits) - 1u);
+}
+
+float ConfigFloat(uint word) {
+    return uintBitsToFloat(ConfigWord(word));
+}
+
+uint LightConfig(uint index) {
+    uint offset = LIGHTS_OFFSET + 2u * index;
+    return (ConfigWord(offset >> 2u) >> ((offset & 3u) * 8u)) & 0xFFFFu;
+}
+
+vec4 rounded_primary_color;
+vec4 primary_fragment_color;
+vec4 secondary_fragment_color;
+vec4 texture_color[4];
+
+vec3 quaternion_rotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+float byteround(float x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec3 byteround(vec3 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec4 byteround(vec4 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+float getLod(vec2 coord) {
+    vec2 d = max(abs(dFdx(coord)), abs(dFdy(coord)));
+    return log2(max(d.x, d.y));
+}
+
+vec4 SampleTexUnit0() {
+    uint type = TEXTURE0_TYPE;
+    if (type == TEXTURE_TYPE_DISABLED) {
+        return vec4(0.0);
+    }
+    if ((TEXTURE_BORDER_S0 != 0u && (texcoord0.x < 0.0 || texcoord0.x > 1.0)) ||
+        (TEXTURE_BORDER_T0 != 0u && (texcoord0.y < 0.0 || texcoord0.y > 1.0))) {
+        return tex_border_color[0];
+    }
+    if (type == TEXTURE_TYPE_PROJECTION_2D) {
+        return textureProj(tex0, vec3(texcoord0, texcoord0_w));
+    }
+    return textureLod(tex0, texcoord0,
+                      getLod(texcoord0 * vec2(textureSize(tex0, 0))) + tex_lod_bias[0]);
+}
+
+vec4 SampleTexUnit1() {
+    if ((TEXTURE_BORDER_S1 != 0u && (texcoord1.x < 0.0 || texcoord1.x > 1.0)) ||
+        (TEXTURE_BORDER_T1 != 0u && (texcoord1.y < 0.0 || texcoord1.y > 1.0))) {
+        return tex_border_color[1];
+    }
+    return textureLod(tex1, texcoord1,
+                      getLod(texcoord1 * vec2(textureSize(tex1, 0))) + tex_lod_bias[1]);
+}
+
+vec4 SampleTexUnit2() {
+    vec2 coord = TEXTURE2_USE_COORD1 != 0u ? texcoord1 : texcoord2;
+    if ((TEXTURE_BORDER_S2 != 0u && (coord.x < 0.0 || coord.x > 1.0)) ||
+        (TEXTURE_BORDER_T2 != 0u && (coord.y < 0.0 || coord.y > 1.0))) {
+        return tex_border_color[2];
+    }
+    return textureLod(tex2, coord, getLod(coord * vec2(textureSize(tex2, 0))) + tex_lod_bias[2]);
+}
+
+float ProcTexLookupLUT(int offset, float coord) {
+    coord *= 128.0;
+    float index_i = clamp(floor(coord), 0.0, 127.0);
+    float index_f = coord - index_i;
+    vec2 entry = texelFetch(texture_buffer_lut_rg, int(index_i) + offset).rg;
+    return clamp(entry.r + entry.g * index_f, 0.0, 1.0);
+}
+
+int ProcTexNoiseRand1D(int v) {
+    const int table[] = int[](0,4,10,8,4,9,7,12,5,15,13,14,11,15,2,11);
+    return ((v % 9 + 2) * 3 & 0xF) ^ table[(v / 9) & 0xF];
+}
+
+float ProcTexNoiseRand2D(vec2 point) {
+    const int table[] = int[](10,2,15,8,0,7,4,5,5,13,2,6,13,9,3,14);
+    int u2 = ProcTexNoiseRand1D(int(point.x));
+    int v2 = ProcTexNoiseRand1D(int(point.y));
+    v2 += ((u2 & 3) == 1) ? 4 : 0;
+    v2 ^= (u2 & 1) * 6;
+    v2 += 10 + u2;
+    v2 &= 0xF;
+    v2 ^= table[u2];
+    return -1.0 + float(v2) * (2.0/15.0);
+}
+
+float ProcTexNoiseCoef(vec2 x) {
+    vec2 grid  = 9.0 * proctex_noise_f * abs(x + proctex_noise_p);
+    vec2 point = floor(grid);
+    vec2 frac  = grid - point;
+
+    float g0 = ProcTexNoiseRand2D(point) * (frac.x + frac.y);
+    float g1 = ProcTexNoiseRand2D(point + vec2(1.0, 0.0)) * (frac.x + frac.y - 1.0);
+    float g2 = ProcTexNoiseRand2D(point + vec2(0.0, 1.0)) * (frac.x + frac.y - 1.0);
+    float g3 = ProcTexNoiseRand2D(point + vec2(1.0, 1.0)) * (frac.x + frac.y - 2.0);
+
+    float x_noise = ProcTexLookupLUT(proctex_noise_lut_offset, frac.x);
+    float y_noise = ProcTexLookupLUT(proctex_noise_lut_offset, frac.y);
+    float x0 = mix(g0, g1, x_noise);
+    float x1 = mix(g2, g3, x_noise);
+    return mix(x0, x1, y_noise);
+}
+
+float ProcTexShiftOffset(float v, uint mode, uint clamp_mode) {
+    float offset = clamp_mode == PROCTEX_CLAMP_MIRRORED_REPEAT ? 1.0 : 0.5;
+    if (mode == PROCTEX_SHIFT_ODD) {
+        return offset * float((int(v) / 2) % 2);
+    }
+    if (mode == PROCTEX_SHIFT_EVEN) {
+        return offset * float(((int(v) + 1) / 2) % 2);
+    }
+    return 0.0;
+}
+
+float ProcTexClamp(float v, uint mode) {
+    switch (mode) {
+    case PROCTEX_CLAMP_TO_ZERO:
+        return v > 1.0 ? 0.0 : v;
+    case PROCTEX_CLAMP_SYMMETRICAL_REPEAT:
+        return fract(v);
+    case PROCTEX_CLAMP_MIRRORED_REPEAT:
+        return int(v) % 2 == 0 ? fract(v) : 1.0 - fract(v);
+    case PROCTEX_CLAMP_PULSE:
+        return v > 0.5 ? 1.0 : 0.0;
+    }
+    return min(v, 1.0);
+}
+
+float ProcTexCombineAndMap(uint combiner, float u, float v, int offset) {
+    float combined = 0.0;
+    switch (combiner) {
+    case PROCTEX_COMBINER_U:
+        combined = u;
+        break;
+    case PROCTEX_COMBINER_U2:
+        combined = u * u;
+        break;
+    case PROCTEX_COMBINER_V:
+        combined = v;
+        break;
+    case PROCTEX_COMBINER_V2:
+        combined = v * v;
+        break;
+    case PROCTEX_COMBINER_ADD:
+        combined = (u + v) * 0.5;
+        break;
+    case PROCTEX_COMBINER_ADD2:
+        combined = (u * u + v * v) * 0.5;
+        break;
+    case PROCTEX_COMBINER_SQRT_ADD2:
+        combined = min(sqrt(u * u + v * v), 1.0);
+        break;
+    case PROCTEX_COMBINER_MIN:
+        combined = min(u, v);
+        break;
+    case PROCTEX_COMBINER_MAX:
+        combined = max(u, v);
+        break;
+    case PROCTEX_COMBINER_RMAX:
+        combined = min(((u + v) * 0.5 + sqrt(u * u + v * v)) * 0.5, 1.0);
+        break;
+    }
+    return ProcTexLookupLUT(offset, combined);
+}
+
+vec4 SampleProcTexColor(float lut_coord, int level) {
+    int lut_width = PROCTEX_LUT_WIDTH >> level;
+    int lut_offsets[8] = int[](PROCTEX_LUT_OFFSET0, PROCTEX_LUT_OFFSET1, PROCTEX_LUT_OFFSET2,
+                               PROCTEX_LUT_OFFSET3, 0xF0, 0xF8, 0xFC, 0xFE);
+    int lut_offset = lut_offsets[level];
+    lut_coord *= float(lut_width - 1);
+
+    uint lut_filter = PROCTEX_LUT_FILTER;
+    if (lut_filter == PROCTEX_FILTER_LINEAR || lut_filter == PROCTEX_FILTER_LINEAR_MIPMAP_LINEAR ||
+        lut_filter == PROCTEX_FILTER_LINEAR_MIPMAP_NEAREST) {
+        int lut_index_i = int(lut_coord) + lut_offset;
+        float lut_index_f = fract(lut_coord);
+        return texelFetch(texture_buffer_lut_rgba, lut_index_i + proctex_lut_offset) +
+               lut_index_f * texelFetch(texture_buffer_lut_rgba,
+                                        lut_index_i + proctex_diff_lut_offset);
+    }
+    lut_coord += float(lut_offset);
+    return texelFetch(texture_buffer_lut_rgba, int(round(lut_coord)) + proctex_lut_offset);
+}
+
+vec4 ProcTex() {
+    uint coord = PROCTEX_COORD;
+    vec2 uv = abs(coord == 1u ? texcoord1 : (coord == 2u ? texcoord2 : texcoord0));
+
+    vec2 duv = max(abs(dFdx(uv)), abs(dFdy(uv)));
+    float lod = log2(abs(float(PROCTEX_LUT_WIDTH) * proctex_bias) * (duv.x + duv.y));
+    if (proctex_bias == 0.0) lod = 0.0;
+    lod = clamp(lod, max(0.0, float(PROCTEX_LOD_MIN)), min(7.0, float(PROCTEX_LOD_MAX)));
+
+    uint u_clamp = PROCTEX_U_CLAMP;
+    uint v_clamp = PROCTEX_V_CLAMP;
+    float u_shift = ProcTexShiftOffset(uv.y, PROCTEX_U_SHIFT, u_clamp);
+    float v_shift = ProcTexShiftOffset(uv.x, PROCTEX_V_SHIFT, v_clamp);
+
+    if (PROCTEX_NOISE_ENABLE != 0u) {
+        uv += proctex_noise_a * ProcTexNoiseCoef(uv);
+        uv = abs(uv);
+    }
+
+    float u = ProcTexClamp(uv.x + u_shift, u_clamp);
+    float v = ProcTexClamp(uv.y + v_shift, v_clamp);
+    float lut_coord = ProcTexCombineAndMap(PROCTEX_COLOR_COMBINER, u, v, proctex_color_map_offset);
+
+    vec4 final_color;
+    uint lut_filter = PROCTEX_LUT_FILTER;
+    if (lut_filter == PROCTEX_FILTER_NEAREST_MIPMAP_NEAREST ||
+        lut_filter == PROCTEX_FILTER_LINEAR_MIPMAP_NEAREST) {
+        final_color = SampleProcTexColor(lut_coord, int(round(lod)));
+    } else if (lut_filter == PROCTEX_FILTER_NEAREST_MIPMAP_LINEAR ||
+               lut_filter == PROCTEX_FILTER_LINEAR_MIPMAP_LINEAR) {
+        int lod_i = int(lod);
+        float lod_f = fract(lod);
+        final_color = mix(SampleProcTexColor(lut_coord, lod_i),
+                          SampleProcTexColor(lut_coord, lod_i + 1), lod_f);
+    } else {
+        final_color = SampleProcTexColor(lut_coord, 0);
+    }
+
+    // In separate alpha mode the alpha channel skips the color LUT and uses the mapped value.
+    if (PROCTEX_SEPARATE_ALPHA != 0u) {
+        final_color.a = ProcTexCombineAndMap(PROCTEX_ALPHA_COMBINER, u, v,
+                                             proctex_alpha_map_offset);
+    }
+    return final_color;
+}
+
+float LookupLightingLUT(int lut_index, int index, float delta) {
+    vec2 entry = texelFetch(texture_buffer_lut_lf, lighting_lut_offset[lut_index >> 2][lut_index & 3] + index).rg;
+    return entry.r + entry.g * delta;
+}
+
+float LookupLightingLUTUnsigned(int lut_index, float pos) {
+    int index = int(clamp(floor(pos * 256.0), 0.f, 255.f));
+    float delta = pos * 256.0 - float(index);
+    return LookupLightingLUT(lut_index, index, delta);
+}
+
+float LookupLightingLUTSigned(int lut_index, float pos) {
+    int index = int(clamp(floor(pos * 128.0), -128.f, 127.f));
+    float delta = pos * 128.0 - float(index);
+    if (index < 0) index += 256;
+    return LookupLightingLUT(lut_index, index, delta);
+}
+
+vec3 normal;
+vec3 tangent;
+vec3 light_vector;
+vec3 spot_dir;
+vec3 half_vector;
+
+bool IsLightingLutEnabled(uint lut) {
+    return LUT_ENABLE(ConfigWord(LIGHTING_LUT_WORD + 2u * lut)) != 0u &&
+           ((lighting_lut_support[LIGHTING_CONFIG] >> lut) & 1u) != 0u;
+}
+
+float LightingLutIndex(uint lut_input) {
+    switch (lut_input) {
+    case LUT_INPUT_NH:
+        return dot(normal, normalize(half_vector));
+    case LUT_INPUT_VH:
+        return dot(normalize(view), normalize(half_vector));
+    case LUT_INPUT_NV:
+        return dot(normal, normalize(view));
+    case LUT_INPUT_LN:
+        return dot(light_vector, normal);
+    case LUT_INPUT_SP:
+        return dot(light_vector, spot_dir);
+    case LUT_INPUT_CP:
+        // CP input is only available with configuration 7
+        if (LIGHTING_CONFIG == LIGHTING_CONFIG_7) {
+            vec3 half_angle_proj =
+                normalize(half_vector) - normal * dot(normal, normalize(half_vector));
+            return dot(half_angle_proj, tangent);
+        }
+        return 0.0;
+    }
+    return 0.0;
+}
+
+float LightingLutValue(uint lut, uint lut_sampler, uint light) {
+    uint lut_config = ConfigWord(LIGHTING_LUT_WORD + 2u * lut);
+    float index = LightingLutIndex(LUT_TYPE(lut_config));
+    float value;
+    if (LUT_ABS_INPUT(lut_config) != 0u) {
+        index = LIGHT_TWO_SIDED_DIFFUSE(light) != 0u ? abs(index) : max(index, 0.0);
+        value = LookupLightingLUTUnsigned(int(lut_sampler), index);
+    } else {
+        value = LookupLightingLUTSigned(int(lut_sampler), index);
+    }
+    return ConfigFloat(LIGHTING_LUT_WORD + 2u * lut + 1u) * value;
+}
+
+void ComputeLighting() {
+    vec4 diffuse_sum = vec4(0.0, 0.0, 0.0, 1.0);
+    vec4 specular_sum = vec4(0.0, 0.0, 0.0, 1.0);
+
+    vec3 surface_normal = vec3(0.0, 0.0, 1.0);
+    vec3 surface_tangent = vec3(1.0, 0.0, 0.0);
+    vec3 perturbation = 2.0 * texture_color[LIGHTING_BUMP_SELECTOR].rgb - 1.0;
+    uint bump_mode = LIGHTING_BUMP_MODE;
+    if (bump_mode == BUMP_NORMAL_MAP) {
+        surface_normal = perturbation;
+        if (LIGHTING_BUMP_RENORM != 0u) {
+            float val = (1.0 - (surface_normal.x*surface_normal.x +
+                                surface_normal.y*surface_normal.y));
+            surface_normal.z = sqrt(max(val, 0.0));
+        }
+    } else if (bump_mode == BUMP_TANGENT_MAP) {
+        surface_tangent = perturbation;
+    }
+
+    vec4 normalized_normquat = normalize(GetNormquat());
+    normal = quaternion_rotate(normalized_normquat, surface_normal);
+    tangent = quaternion_rotate(normalized_normquat, surface_tangent);
+
+    vec4 shadow = vec4(1.0);
+    if (LIGHTING_ENABLE_SHADOW != 0u) {
+        shadow = texture_color[LIGHTING_SHADOW_SELECTOR];
+        if (LIGHTING_SHADOW_INVERT != 0u) {
+            shadow = vec4(1.0) - shadow;
+        }
+    }
+
+    uint src_num = LIGHTING_SRC_NUM;
+    for (uint light_index = 0u; light_index < src_num; light_index++) {
+        uint light = LightConfig(light_index);
+        uint num = LIGHT_NUM(light);
+        // The two sided diffuse flag of the LUT lookups is taken from the light with index num.
+        uint lut_light = LightConfig(num);
+
+        light_vector = light_src[num].position;
+        if (LIGHT_DIRECTIONAL(light) == 0u) {
+            light_vector += view;
+        }
+        float light_distance = length(light_vector);
+        light_vector = normalize(light_vector);
+        spot_dir = light_src[num].spot_direction;
+        half_vector = normalize(view) + light_vector;
+
+        float dot_product = dot(light_vector, normal);
+        dot_product = LIGHT_TWO_SIDED_DIFFUSE(light) != 0u ? abs(dot_product)
+                                                           : max(dot_product, 0.0);
+
+        float clamp_highlights = 1.0;
+        if (LIGHTING_CLAMP_HIGHLIGHTS != 0u) {
+            clamp_highlights = sign(dot_product);
+        }
+
+        float spot_atten = 1.0;
+        if (LIGHT_SPOT_ATTEN_ENABLE(light) != 0u && IsLightingLutEnabled(LUT_SP)) {
+            spot_atten = LightingLutValue(LUT_SP, SAMPLER_SP + num, lut_light);
+        }
+
+        float dist_atten = 1.0;
+        if (LIGHT_DIST_ATTEN_ENABLE(light) != 0u) {
+            float index = clamp(light_src[num].dist_atten_scale * light_distance +
+                                light_src[num].dist_atten_bias, 0.0, 1.0);
+            dist_atten = LookupLightingLUTUnsigned(int(SAMPLER_DA + num), index);
+        }
+
+        bool geo_factor_0 = LIGHT_GEOMETRIC_FACTOR_0(light) != 0u;
+        bool geo_factor_1 = LIGHT_GEOMETRIC_FACTOR_1(light) != 0u;
+        float geo_factor = 1.0;
+        if (geo_factor_0 || geo_factor_1) {
+            geo_factor = dot(half_vector, half_vector);
+            geo_factor = geo_factor == 0.0 ? 0.0 : min(dot_product / geo_factor, 1.0);
+        }
+
+        float d0_lut_value = 1.0;
+        if (IsLightingLutEnabled(LUT_D0)) {
+            d0_lut_value = LightingLutValue(LUT_D0, SAMPLER_D0, lut_light);
+        }
+        vec3 specular_0 = d0_lut_value * light_src[num].specular_0;
+        if (geo_factor_0) {
+            specular_0 *= geo_factor;
+        }
+
+        vec3 refl_value = vec3(1.0);
+        if (IsLightingLutEnabled(LUT_RR)) {
+            refl_value.r = LightingLutValue(LUT_RR, SAMPLER_RR, lut_light);
+        }
+        refl_value.g = refl_value.r;
+        if (IsLightingLutEnabled(LUT_RG)) {
+            refl_value.g = LightingLutValue(LUT_RG, SAMPLER_RG, lut_light);
+        }
+        refl_value.b = refl_value.r;
+        if (IsLightingLutEnabled(LUT_RB)) {
+            refl_value.b = LightingLutValue(LUT_RB, SAMPLER_RB, lut_light);
+        }
+
+        float d1_lut_value = 1.0;
+        if (IsLightingLutEnabled(LUT_D1)) {
+            d1_lut_value = LightingLutValue(LUT_D1, SAMPLER_D1, lut_light);
+        }
+        vec3 specular_1 = d1_lut_value * refl_value * light_src[num].specular_1;
+        if (geo_factor_1) {
+            specular_1 *= geo_factor;
+        }
+
+        // Only the last entry in the light slots applies the Fresnel factor
+        if (light_index == src_num - 1u && IsLightingLutEnabled(LUT_FR)) {
+            float value = LightingLutValue(LUT_FR, SAMPLER_FR, lut_light);
+            if (LIGHTING_PRIMARY_ALPHA != 0u) {
+                diffuse_sum.a = value;
+            }
+            if (LIGHTING_SECONDARY_ALPHA != 0u) {
+                specular_sum.a = value;
+            }
+        }
+
+        bool shadow_enable = LIGHT_SHADOW_ENABLE(light) != 0u;
+        vec3 shadow_primary = vec3(1.0);
+        if (LIGHTING_SHADOW_PRIMARY != 0u && shadow_enable) {
+            shadow_primary = shadow.rgb;
+        }
+        vec3 shadow_secondary = vec3(1.0);
+        if (LIGHTING_SHADOW_SECONDARY != 0u && shadow_enable) {
+            shadow_secondary = shadow.rgb;
+        }
+
+        diffuse_sum.rgb += ((light_src[num].diffuse * dot_product) + light_src[num].ambient) *
+                           dist_atten * spot_atten * shadow_primary;
+        specular_sum.rgb += (specular_0 + specular_1) * clamp_highlights * dist_atten *
+                            spot_atten * shadow_secondary;
+    }
+
+    if (LIGHTING_SHADOW_ALPHA != 0u) {
+        if (LIGHTING_PRIMARY_ALPHA != 0u) {
+            diffuse_sum.a *= shadow.a;
+        }
+        if (LIGHTING_SECONDARY_ALPHA != 0u) {
+            specular_sum.a *= shadow.a;
+        }
+    }
+
+    diffuse_sum.rgb += lighting_global_ambient;
+    primary_fragment_color = clamp(diffuse_sum, vec4(0.0), vec4(1.0));
+    secondary_fragment_color = clamp(specular_sum, vec4(0.0), vec4(1.0));
+}
+
+vec4 TevSource(uint source, uint stage, vec4 combiner_output, vec4 combiner_buffer) {
+    switch (source) {
+    case SOURCE_PRIMARY_COLOR:
+        return rounded_primary_color;
+    case SOURCE_PRIMARY_FRAGMENT_COLOR:
+        return primary_fragment_color;
+    case SOURCE_SECONDARY_FRAGMENT_COLOR:
+        return secondary_fragment_color;
+    case SOURCE_TEXTURE0:
+        return texture_color[0];
+    case SOURCE_TEXTURE1:
+        return texture_color[1];
+    case SOURCE_TEXTURE2:
+        return texture_color[2];
+    case SOURCE_TEXTURE3:
+        return texture_color[3];
+    case SOURCE_PREVIOUS_BUFFER:
+        return combiner_buffer;
+    case SOURCE_CONSTANT:
+        return const_color[stage];
+    case SOURCE_PREVIOUS:
+        return combiner_output;
+    }
+    return vec4(0.0);
+}
+
+vec3 TevColorModifier(uint modifier, vec4 value) {
+    switch (modifier) {
+    case COLOR_SOURCE_COLOR:
+        return value.rgb;
+    case COLOR_ONE_MINUS_SOURCE_COLOR:
+        return vec3(1.0) - value.rgb;
+    case COLOR_SOURCE_ALPHA:
+        return value.aaa;
+    case COLOR_ONE_MINUS_SOURCE_ALPHA:
+        return vec3(1.0) - value.aaa;
+    case COLOR_SOURCE_RED:
+        return value.rrr;
+    case COLOR_ONE_MINUS_SOURCE_RED:
+        return vec3(1.0) - value.rrr;
+    case COLOR_SOURCE_GREEN:
+        return value.ggg;
+    case COLOR_ONE_MINUS_SOURCE_GREEN:
+        return vec3(1.0) - value.ggg;
+    case COLOR_SOURCE_BLUE:
+        return value.bbb;
+    case COLOR_ONE_MINUS_SOURCE_BLUE:
+        return vec3(1.0) - value.bbb;
+    }
+    return vec3(0.0);
+}
+
+float TevAlphaModifier(uint modifier, vec4 value) {
+    switch (modifier) {
+    case ALPHA_SOURCE_ALPHA:
+        return value.a;
+    case ALPHA_ONE_MINUS_SOURCE_ALPHA:
+        return 1.0 - value.a;
+    case ALPHA_SOURCE_RED:
+        return value.r;
+    case ALPHA_ONE_MINUS_SOURCE_RED:
+        return 1.0 - value.r;
+    case ALPHA_SOURCE_GREEN:
+        return value.g;
+    case ALPHA_ONE_MINUS_SOURCE_GREEN:
+        return 1.0 - value.g;
+    case ALPHA_SOURCE_BLUE:
+        return value.b;
+    case ALPHA_ONE_MINUS_SOURCE_BLUE:
+        return 1.0 - value.b;
+    }
+    return 0.0;
+}
+
+vec3 TevColorCombiner(uint operation, vec3 color_results_1, vec3 color_results_2,
+                      vec3 color_results_3) {
+    vec3 result = vec3(0.0);
+    switch (operation) {
+    case OPERATION_REPLACE:
+        result = color_results_1;
+        break;
+    case OPERATION_MODULATE:
+        result = color_results_1 * color_results_2;
+        break;
+    case OPERATION_ADD:
+        result = color_results_1 + color_results_2;
+        break;
+    case OPERATION_ADD_SIGNED:
+        result = color_results_1 + color_results_2 - vec3(0.5);
+        break;
+    case OPERATION_LERP:
+        result = color_results_1 * color_results_3 +
+                 color_results_2 * (vec3(1.0) - color_results_3);
+        break;
+    case OPERATION_SUBTRACT:
+        result = color_results_1 - color_results_2;
+        break;
+    case OPERATION_MULTIPLY_THEN_ADD:
+        result = color_results_1 * color_results_2 + color_results_3;
+        break;
+    case OPERATION_ADD_THEN_MULTIPLY:
+        result = min(color_results_1 + color_results_2, vec3(1.0)) * color_results_3;
+        break;
+    case OPERATION_DOT3_RGB:
+    case OPERATION_DOT3_RGBA:
+        result = vec3(dot(color_results_1 - vec3(0.5), color_results_2 - vec3(0.5)) * 4.0);
+        break;
+    }
+    return clamp(result, vec3(0.0), vec3(1.0));
+}
+
+float TevAlphaCombiner(uint operation, float alpha_results_1, float alpha_results_2,
+                       float alpha_results_3) {
+    float result = 0.0;
+    switch (operation) {
+    case OPERATION_REPLACE:
+        result = alpha_results_1;
+        break;
+    case OPERATION_MODULATE:
+        result = alpha_results_1 * alpha_results_2;
+        break;
+    case OPERATION_ADD:
+        result = alpha_results_1 + alpha_results_2;
+        break;
+    case OPERATION_ADD_SIGNED:
+        result = alpha_results_1 + alpha_results_2 - 0.5;
+        break;
+    case OPERATION_LERP:
+        result = alpha_results_1 * alpha_results_3 + alpha_results_2 * (1.0 - alpha_results_3);
+        break;
+    case OPERATION_SUBTRACT:
+        result = alpha_results_1 - alpha_results_2;
+        break;
+    case OPERATION_MULTIPLY_THEN_ADD:
+        result = alpha_results_1 * alpha_results_2 + alpha_results_3;
+        break;
+    case OPERATION_ADD_THEN_MULTIPLY:
+        result = min(alpha_results_1 + alpha_results_2, 1.0) * alpha_results_3;
+        break;
+    }
+    return clamp(result, 0.0, 1.0);
+}
+
+float TevMultiplier(uint scale) {
+    return scale < 3u ? float(1u << scale) : 1.0;
+}
+
+bool IsPassThroughTevStage(uint sources, uint modifiers, uint ops, uint scales) {
+    return TEV_COLOR_OP(ops) == OPERATION_REPLACE && TEV_ALPHA_OP(ops) == OPERATION_REPLACE &&
+           TEV_COLOR_SOURCE1(sources) == SOURCE_PREVIOUS &&
+           TEV_ALPHA_SOURCE1(sources) == SOURCE_PREVIOUS &&
+           TEV_COLOR_MODIFIER1(modifiers) == COLOR_SOURCE_COLOR &&
+           TEV_ALPHA_MODIFIER1(modifiers) == ALPHA_SOURCE_ALPHA &&
+           TevMultiplier(TEV_COLOR_SCALE(scales)) == 1.0 &&
+           TevMultiplier(TEV_ALPHA_SCALE(scales)) == 1.0;
+}
+
+bool PassesAlphaTest(uint func, int alpha) {
+    switch (func) {
+    case COMPARE_NEVER:
+        return false;
+    case COMPARE_EQUAL:
+        return alpha == alphatest_ref;
+    case COMPARE_NOT_EQUAL:
+        return alpha != alphatest_ref;
+    case COMPARE_LESS_THAN:
+        return alpha < alphatest_ref;
+    case COMPARE_LESS_THAN_OR_EQUAL:
+        return alpha <= alphatest_ref;
+    case COMPARE_GREATER_THAN:
+        return alpha > alphatest_ref;
+    case COMPARE_GREATER_THAN_OR_EQUAL:
+        return alpha >= alphatest_ref;
+    }
+    return true;
+}
+
+void main() {
+    rounded_primary_color = byteround(primary_color);
+    primary_fragment_color = vec4(0.0);
+    secondary_fragment_color = vec4(0.0);
+
+    uint alpha_test_func = ALPHA_TEST_FUNC;
+    if (alpha_test_func == COMPARE_NEVER) {
+        discard;
+    }
+
+    uint scissor_mode = SCISSOR_TEST_MODE;
+    if (scissor_mode != SCISSOR_DISABLED) {
+        bool inside = gl_FragCoord.x >= float(scissor_x1) && gl_FragCoord.y >= float(scissor_y1) &&
+                      gl_FragCoord.x < float(scissor_x2) && gl_FragCoord.y < float(scissor_y2);
+        if (inside != (scissor_mode == SCISSOR_INCLUDE)) {
+            discard;
+        }
+    }
+
+    float depth = ZOverW() * depth_scale + depth_offset;
+    if (DEPTHMAP_ENABLE == DEPTH_W_BUFFERING) {
+        depth /= gl_FragCoord.w;
+    }
+
+    texture_color[0] = SampleTexUnit0();
+    texture_color[1] = SampleTexUnit1();
+    texture_color[2] = SampleTexUnit2();
+    texture_color[3] = vec4(0.0);
+    if (PROCTEX_ENABLE != 0u) {
+        texture_color[3] = ProcTex();
+    }
+
+    if (LIGHTING_ENABLE != 0u) {
+        ComputeLighting();
+    }
+
+    vec4 combiner_buffer = vec4(0.0);
+    vec4 next_combiner_buffer = tev_combiner_buffer_color;
+    vec4 combiner_output = rounded_primary_color;
+    uint buffer_input = COMBINER_BUFFER_INPUT;
+    for (uint stage = 0u; stage < uint(NUM_TEV_STAGES); stage++) {
+        uint word = TEV_STAGES_WORD + stage * 4u;
+        uint sources = ConfigWord(word);
+        uint modifiers = ConfigWord(word + 1u);
+        uint ops = ConfigWord(word + 2u);
+        uint scales = ConfigWord(word + 3u);
+
+        if (!IsPassThroughTevStage(sources, modifiers, ops, scales)) {
+            vec3 color_results_1 = TevColorModifier(TEV_COLOR_MODIFIER1(modifiers),
+                TevSource(TEV_COLOR_SOURCE1(sources), stage, combiner_output, combiner_buffer));
+            vec3 color_results_2 = TevColorModifier(TEV_COLOR_MODIFIER2(modifiers),
+                TevSource(TEV_COLOR_SOURCE2(sources), stage, combiner_output, combiner_buffer));
+            vec3 color_results_3 = TevColorModifier(TEV_COLOR_MODIFIER3(modifiers),
+                TevSource(TEV_COLOR_SOURCE3(sources), stage, combiner_output, combiner_buffer));
+
+            // Round the output of each TEV stage to maintain the PICA's 8 bits of precision
+            uint color_op = TEV_COLOR_OP(ops);
+            vec3 color_output = byteround(TevColorCombiner(color_op, color_results_1,
+                                                           color_results_2, color_results_3));
+
+            float alpha_output;
+            if (color_op == OPERATION_DOT3_RGBA) {
+                // result of Dot3_RGBA operation is also placed to the alpha component
+                alpha_output = color_output[0];
+            } else {
+                float alpha_results_1 = TevAlphaModifier(TEV_ALPHA_MODIFIER1(modifiers),
+                    TevSource(TEV_ALPHA_SOURCE1(sources), stage, combiner_output, combiner_buffer));
+                float alpha_results_2 = TevAlphaModifier(TEV_ALPHA_MODIFIER2(modifiers),
+                    TevSource(TEV_ALPHA_SOURCE2(sources), stage, combiner_output, combiner_buffer));
+                float alpha_results_3 = TevAlphaModifier(TEV_ALPHA_MODIFIER3(modifiers),
+                    TevSource(TEV_ALPHA_SOURCE3(sources), stage, combiner_output, combiner_buffer));
+                alpha_output = byteround(TevAlphaCombiner(TEV_ALPHA_OP(ops), alpha_results_1,
+                                                          alpha_results_2, alpha_results_3));
+            }
+
+            combiner_output = vec4(
+                clamp(color_output * TevMultiplier(TEV_COLOR_SCALE(scales)), vec3(0.0), vec3(1.0)),
+                clamp(alpha_output * TevMultiplier(TEV_ALPHA_SCALE(scales)), 0.0, 1.0));
+        }
+
+        combiner_buffer = next_combiner_buffer;
+        if (stage < 4u) {
+            if (((buffer_input >> stage) & 1u) != 0u) {
+                next_combiner_buffer.rgb = combiner_output.rgb;
+            }
+            if (((buffer_input >> (stage + 4u)) & 1u) != 0u) {
+                next_combiner_buffer.a = combiner_output.a;
+            }
+        }
+    }
+
+    if (!PassesAlphaTest(alpha_test_func, int(combiner_output.a * 255.0))) {
+        discard;
+    }
+
+    uint fog_mode = FOG_MODE;
+    if (fog_mode == FOG_MODE_FOG) {
+        float fog_index = FOG_FLIP != 0u ? (1.0 - depth) * 128.0 : depth * 128.0;
+        float fog_i = clamp(floor(fog_index), 0.0, 127.0);
+        float fog_f = fog_index - fog_i;
+        vec2 fog_lut_entry = texelFetch(texture_buffer_lut_lf, int(fog_i) + fog_lut_offset).rg;
+        float fog_factor = clamp(fog_lut_entry.r + fog_lut_entry.g * fog_f, 0.0, 1.0);
+        combiner_output.rgb = mix(fog_color.rgb, combiner_output.rgb, fog_factor);
+    } else if (fog_mode == FOG_MODE_GAS) {
+        // Gas rendering is not implemented by the specialized shader either
+        discard;
+    }
+
+    gl_FragDepth = depth;
+    // Round the final fragment color to maintain the PICA's 8 bits of precision
+    color = byteround(combiner_output);
+
+    uint logic_op = LOGIC_OP;
+    if (logic_op == LOGIC_OP_CLEAR) {
+        color = vec4(0.0);
+    } else if (logic_op == LOGIC_OP_SET) {
+        color = vec4(1.0);
+    }
+}
+)";
+
+} // Anonymous namespace
+
+bool IsUberShaderCompatible(const FSConfig& config, const Profile& profile) {
+    using LogicOp = FramebufferRegs::LogicOp;
+    const auto logic_op = config.framebuffer.logic_op.Value();
+    const bool logic_op_supported = logic_op == LogicOp::Copy || logic_op == LogicOp::NoOp ||
+                                    logic_op == LogicOp::Clear || logic_op == LogicOp::Set;
+    return logic_op_supported && !config.UsesShadowPipeline() &&
+           config.texture.texture0_type != TextureType::TextureCube &&
+           !config.user.use_custom_normal && (profile.is_vulkan || !config.EmulateBlend());
+}
+
+FSConfigData MakeFSConfigData(const FSConfig& config) {
+    FSConfigData data{};
+    std::memcpy(data.raw.data(), &config, sizeof(config));
+    return data;
+}
+
+std::string GenerateFragmentUberShader(const Profile& profile, u32 config_binding) {
+    std::string out;
+    out.reserve(64 * 1024);
+
+    bool use_fragment_shader_barycentric = false;
+    if (profile.has_separable_shaders) {
+        out += "#extension GL_ARB_separate_shader_objects : enable\n";
+    }
+    if (profile.has_fragment_shader_barycentric) {
+        use_fragment_shader_barycentric = true;
+        out += "#extension GL_EXT_fragment_shader_barycentric : enable\n";
+        out += "#define pervertex pervertexEXT\n";
+        out += "#define gl_BaryCoord gl_BaryCoordEXT\n";
+    } else if (profile.has_gl_nv_fragment_shader_barycentric) {
+        use_fragment_shader_barycentric = true;
+        out += "#extension GL_NV_fragment_shader_barycentric : enable\n";
+        out += "#define pervertex pervertexNV\n";
+        out += "#define gl_BaryCoord gl_BaryCoordNV\n";
+    }
+    if (!profile.is_vulkan) {
+        out += FSPrecisionDef;
+    }
+
+    const auto define_input = [&](std::string_view var, Attributes location) {
+        if (profile.has_separable_shaders) {
+            out += fmt::format("layout (location = {}) ", static_cast<u32>(location));
+        }
+        out += fmt::format("in {};\n", var);
+    };
+    define_input("vec4 primary_color", ATTRIBUTE_COLOR);
+    define_input("vec2 texcoord0", ATTRIBUTE_TEXCOORD0);
+    define_input("vec2 texcoord1", ATTRIBUTE_TEXCOORD1);
+    define_input("vec2 texcoord2", ATTRIBUTE_TEXCOORD2);
+    define_input("float texcoord0_w", ATTRIBUTE_TEXCOORD0_W);
+    if (use_fragment_shader_barycentric) {
+        define_input("pervertex vec4 normquats[]", ATTRIBUTE_NORMQUAT);
+    } else {
+        define_input("vec4 normquat", ATTRIBUTE_NORMQUAT);
+    }
+    define_input("vec3 view", ATTRIBUTE_VIEW);
+    out += "layout (location = 0) out vec4 color;\n\n";
+
+    out += FSUniformBlockDef;
+    out += fmt::format("layout (binding = {}, std140) uniform fs_config_data {{\n"
+                       "    uvec4 fs_config[{}];\n"
+                       "}};\n",
+                       config_binding, sizeof(FSConfigData) / (4 * sizeof(u32)));
+    out += "layout(binding = 3) uniform samplerBuffer texture_buffer_lut_lf;\n";
+    out += "layout(binding = 4) uniform samplerBuffer texture_buffer_lut_rg;\n";
+    out += "layout(binding = 5) uniform samplerBuffer texture_buffer_lut_rgba;\n";
+    const auto texunit_set = profile.is_vulkan ? "set = 1, " : "";
+    for (u32 i = 0; i < 3; i++) {
+        out += fmt::format("layout({0}binding = {1}) uniform sampler2D tex{1};\n", texunit_set, i);
+    }
+    out += '\n';
+
+    DefineConfigLayout(out);
+    DefineConstants(out);
+
+    // See FragmentModule::WriteDepth for the derivation of the PICA depth value.
+    if (profile.has_minus_one_to_one_range) {
+        out += "float ZOverW() { return -2.0 * gl_FragCoord.z + 1.0; }\n";
+    } else {
+        out += "float ZOverW() { return -gl_FragCoord.z; }\n";
+    }
+
+    if (use_fragment_shader_barycentric) {
+        out += R"(
+vec4 GetNormquat() {
+    vec4 normquat_0 = normquats[0];
+    // Flip quaternions that are opposite to the first one before interpolating
+    vec4 normquat_1 = dot(normquats[0], normquats[1]) < 0.0 ? -normquats[1] : normquats[1];
+    vec4 normquat_2 = dot(normquats[0], normquats[2]) < 0.0 ? -normquats[2] : normquats[2];
+    return gl_BaryCoord.x * normquat_0 + gl_BaryCoord.y * normquat_1 + gl_BaryCoord.z * normquat_2;
+}
+)";
+    } else {
+        out += "vec4 GetNormquat() { return normquat; }\n";
+    }
+
+    out += UberShaderHelpers;
+    return out;
+}
+
+} // namespace Pica::Shader::Generator::GLSL
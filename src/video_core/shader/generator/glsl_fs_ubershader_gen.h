@@ -0,0 +1,33 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "video_core/shader/generator/pica_fs_config.h"
+#include "video_core/shader/generator/shader_uniforms.h"
+
+namespace Pica::Shader::Generator::GLSL {
+
+/**
+ * Returns true when the fragment ubershader renders the provided configuration identically to the
+ * specialized shader. Shadow rendering, cube maps and shader emulated blending are not supported.
+ */
+bool IsUberShaderCompatible(const FSConfig& config, const Profile& profile);
+
+/// Packs the provided configuration into the uniform block read by the fragment ubershader
+FSConfigData MakeFSConfigData(const FSConfig& config);
+
+/**
+ * Generates a GLSL fragment shader that reads the pica fragment configuration from the fs_config
+ * uniform block instead of baking it into the code. It can be compiled once and used for any
+ * compatible configuration while the corresponding specialized shader is still compiling.
+ * @param profile Host capabilities the shader is generated for
+ * @param config_binding Binding of the fs_config uniform block
+ * @returns String of the shader source code
+ */
+std::string GenerateFragmentUberShader(const Profile& profile, u32 config_binding);
+
+} // namespace Pica::Shader::Generator::GLSL
@@ -5,6 +5,7 @@
 #include <string_view>
 #include <fmt/format.h>
 
+#include "common/logging/log.h"
 #include "video_core/pica/regs_rasterizer.h"
 #include "video_core/shader/generator/glsl_shader_decompiler.h"
 #include "video_core/shader/generator/glsl_shader_gen.h"
@@ -30,6 +31,18 @@ layout (binding = 0, std140) uniform vs_pica_data {
 };
 )";
 
+constexpr std::string_view GSPicaUniformBlockDef = R"(
+struct pica_uniforms {
+    bool b[16];
+    uvec4 i[4];
+    vec4 f[96];
+};
+
+layout (binding = 4, std140) uniform gs_pica_data {
+    pica_uniforms uniforms;
+};
+)";
+
 constexpr std::string_view VSUniformBlockDef = R"(
 #ifdef VULKAN
 layout (set = 0, binding = 1, std140) uniform vs_data {
@@ -179,7 +192,7 @@ std::string GenerateVertexShader(const ShaderSetup& setup, const PicaVSConfig& c
 
     auto program_source =
         DecompileProgram(setup.program_code, setup.swizzle_data, config.state.main_offset,
-                         get_input_reg, get_output_reg, config.state.sanitize_mul);
+                         get_input_reg, get_output_reg, config.state.sanitize_mul, false);
 
     if (program_source.empty()) {
         return "";
@@ -413,4 +426,112 @@ void main() {
 
     return out;
 }
+
+std::string GenerateGeometryShader(const ShaderSetup& setup, const PicaGSConfig& config,
+                                   bool separable_shader) {
+    const auto& state = config.state;
+    if (state.num_outputs == 0 || state.num_inputs % state.attributes_per_vertex != 0) {
+        return "";
+    }
+
+    std::string_view input_primitive;
+    switch (state.num_inputs / state.attributes_per_vertex) {
+    case 1:
+        input_primitive = "points";
+        break;
+    case 2:
+        input_primitive = "lines";
+        break;
+    case 3:
+        input_primitive = "triangles";
+        break;
+    case 4:
+        input_primitive = "lines_adjacency";
+        break;
+    case 6:
+        input_primitive = "triangles_adjacency";
+        break;
+    default:
+        LOG_WARNING(Render, "Unsupported geometry shader input of {} vertices",
+                    state.num_inputs / state.attributes_per_vertex);
+        return "";
+    }
+
+    const auto get_input_reg = [&state](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        const u32 attr = state.input_map[reg];
+        if (attr < state.num_inputs) {
+            return fmt::format("vs_out_attr{}[{}]", attr % state.attributes_per_vertex,
+                               attr / state.attributes_per_vertex);
+        }
+        return "vec4(0.0)";
+    };
+
+    const auto get_output_reg = [&state](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        if (state.output_map[reg] < state.num_outputs) {
+            return fmt::format("output_buffer.attributes[{}]", state.output_map[reg]);
+        }
+        return "";
+    };
+
+    auto program_source =
+        DecompileProgram(setup.program_code, setup.swizzle_data, state.main_offset,
+                         get_input_reg, get_output_reg, state.sanitize_mul, true);
+
+    if (program_source.empty()) {
+        return "";
+    }
+
+    std::string out;
+    if (separable_shader) {
+        out += "#extension GL_ARB_separate_shader_objects : enable\n";
+    }
+
+    // Each emitted primitive takes three vertices, this is the most that fits the minimum
+    // geometry shader output component limit. Any further primitives are dropped.
+    out += fmt::format("layout({}) in;\n", input_primitive);
+    out += "layout(triangle_strip, max_vertices = 30) out;\n\n";
+
+    out += GSPicaUniformBlockDef;
+    out += GetGSCommonSource(state.gs_state, separable_shader);
+
+    out += R"(
+Vertex output_buffer;
+Vertex prim_buffer[3];
+uint vertex_id = 0u;
+bool prim_emit = false;
+bool winding = false;
+
+void setemit(uint vertex_id_, bool prim_emit_, bool winding_) {
+    vertex_id = vertex_id_;
+    prim_emit = prim_emit_;
+    winding = winding_;
+}
+
+void emit() {
+    prim_buffer[vertex_id] = output_buffer;
+    if (prim_emit) {
+        if (winding) {
+            EmitPrim(prim_buffer[1], prim_buffer[0], prim_buffer[2]);
+            winding = false;
+        } else {
+            EmitPrim(prim_buffer[0], prim_buffer[1], prim_buffer[2]);
+        }
+    }
+}
+
+bool exec_shader();
+
+void main() {
+)";
+    for (u32 i = 0; i < state.num_outputs; ++i) {
+        out += fmt::format("    output_buffer.attributes[{}] = vec4(0.0, 0.0, 0.0, 1.0);\n", i);
+    }
+    out += "    exec_shader();\n}\n\n";
+
+    out += program_source;
+
+    return out;
+}
 } // namespace Pica::Shader::Generator::GLSL
@@ -103,6 +103,45 @@ struct PicaFixedGSConfig : Common::HashableStruct<PicaGSConfigState> {
     explicit PicaFixedGSConfig(const Pica::RegsInternal& regs, bool use_clip_planes_);
 };
 
+/**
+ * This struct contains common information to identify a GLSL geometry shader generated from
+ * PICA geometry shader program running in Point mode.
+ */
+struct PicaGSProgramConfigState {
+    void Init(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup, bool use_clip_planes_);
+
+    u64 program_hash;
+    u64 swizzle_hash;
+    u32 main_offset;
+    bool sanitize_mul;
+
+    // Number of vertex shader outputs gathered for each invocation, and how many of them form
+    // an input vertex
+    u32 num_inputs;
+    u32 attributes_per_vertex;
+
+    // input_map[input register index] -> input attribute index
+    std::array<u32, 16> input_map;
+
+    u32 num_outputs;
+    // output_map[output register index] -> output attribute index
+    std::array<u32, 16> output_map;
+
+    PicaGSConfigState gs_state;
+};
+
+/**
+ * This struct contains information to identify a GL geometry shader generated from PICA geometry
+ * shader program.
+ */
+struct PicaGSConfig : Common::HashableStruct<PicaGSProgramConfigState> {
+    explicit PicaGSConfig(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup,
+                          bool use_clip_planes_);
+};
+
+/// Returns the number of vertices the geometry pipeline gathers for each Point mode invocation
+u32 GetGSVerticesPerInvocation(const Pica::RegsInternal& regs);
+
 } // namespace Pica::Shader::Generator
 
 namespace std {
@@ -119,4 +158,11 @@ struct hash<Pica::Shader::Generator::PicaFixedGSConfig> {
         return k.Hash();
     }
 };
+
+template <>
+struct hash<Pica::Shader::Generator::PicaGSConfig> {
+    std::size_t operator()(const Pica::Shader::Generator::PicaGSConfig& k) const noexcept {
+        return k.Hash();
+    }
+};
 } // namespace std
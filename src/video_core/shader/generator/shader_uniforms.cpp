@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include "video_core/pica/regs_shader.h"
 #include "video_core/pica/shader_setup.h"
 #include "video_core/shader/generator/shader_uniforms.h"
@@ -23,4 +24,26 @@ void PicaUniformsData::SetFromRegs(const Pica::ShaderRegs& regs, const Pica::Sha
                    });
 }
 
+bool PicaUniformsData::Update(const Pica::ShaderRegs& regs, Pica::ShaderSetup& setup) {
+    const auto old_bools = bools;
+    const auto old_i = i;
+    std::transform(std::begin(setup.uniforms.b), std::end(setup.uniforms.b), std::begin(bools),
+                   [](bool value) -> BoolAligned { return {value ? 1 : 0}; });
+    std::transform(std::begin(regs.int_uniforms), std::end(regs.int_uniforms), std::begin(i),
+                   [](const auto& value) -> Common::Vec4u {
+                       return {value.x.Value(), value.y.Value(), value.z.Value(), value.w.Value()};
+                   });
+    bool changed = std::memcmp(&old_bools, &bools, sizeof(bools)) != 0 ||
+                   std::memcmp(&old_i, &i, sizeof(i)) != 0;
+
+    const auto [first, last] = setup.ConsumeDirtyFloatUniforms();
+    for (u32 index = first; index < last; index++) {
+        const auto& value = setup.uniforms.f[index];
+        f[index] = {value.x.ToFloat32(), value.y.ToFloat32(), value.z.ToFloat32(),
+                    value.w.ToFloat32()};
+        changed = true;
+    }
+    return changed;
+}
+
 } // namespace Pica::Shader::Generator
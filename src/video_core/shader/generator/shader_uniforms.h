@@ -69,6 +69,16 @@ static_assert(sizeof(FSUniformData) == 0x530,
 static_assert(sizeof(FSUniformData) < 16384,
               "UniformData structure must be less than 16kb as per the OpenGL spec");
 
+/**
+ * Uniform structure read by the fragment ubershader. The FSConfig of the draw is copied here
+ * verbatim, so a single shader can evaluate any pipeline configuration it supports.
+ */
+struct FSConfigData {
+    std::array<u32, 64> raw;
+};
+static_assert(sizeof(FSConfigData) < 16384,
+              "FSConfigData structure must be less than 16kb as per the OpenGL spec");
+
 /**
  * Uniform struct for the Uniform Buffer Object that contains PICA vertex/geometry shader uniforms.
  * NOTE: the same rule from UniformData also applies here.
@@ -76,6 +86,13 @@ static_assert(sizeof(FSUniformData) < 16384,
 struct PicaUniformsData {
     void SetFromRegs(const ShaderRegs& regs, const ShaderSetup& setup);
 
+    /**
+     * Converts the bool and int uniforms and the float uniforms written with a new value since the
+     * last update of the setup.
+     * @returns True if any of the converted uniforms changed
+     */
+    bool Update(const ShaderRegs& regs, ShaderSetup& setup);
+
     struct BoolAligned {
         alignas(16) int b;
     };
@@ -102,4 +119,12 @@ static_assert(sizeof(VSPicaUniformData) == 1856,
 static_assert(sizeof(VSPicaUniformData) < 16384,
               "VSPicaUniformData structure must be less than 16kb as per the OpenGL spec");
 
+struct GSPicaUniformData {
+    alignas(16) PicaUniformsData uniforms;
+};
+static_assert(sizeof(GSPicaUniformData) == 1856,
+              "The size of the GSPicaUniformData does not match the structure in the shader");
+static_assert(sizeof(GSPicaUniformData) < 16384,
+              "GSPicaUniformData structure must be less than 16kb as per the OpenGL spec");
+
 } // namespace Pica::Shader::Generator
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include "common/common_types.h"
 
 namespace Pica {
@@ -29,6 +30,14 @@ public:
      * @param state Shader unit state, must be setup with input data before each shader invocation.
      */
     virtual void Run(const ShaderSetup& setup, ShaderUnit& state) const = 0;
+
+    /**
+     * Runs the currently setup shader once for each of the shader units, in order.
+     *
+     * @param setup Shader engine state, must be setup with SetupBatch on each shader change.
+     * @param states Shader unit states, each must be setup with input data.
+     */
+    virtual void RunBatch(const ShaderSetup& setup, std::span<ShaderUnit> states) const;
 };
 
 std::unique_ptr<ShaderEngine> CreateEngine(bool use_jit);
@@ -30,15 +30,14 @@ void JitEngine::SetupBatch(ShaderSetup& setup, u32 entry_point) {
     const u64 swizzle_hash = setup.GetSwizzleDataHash();
 
     const u64 cache_key = Common::HashCombine(code_hash, swizzle_hash);
-    auto iter = cache.find(cache_key);
-    if (iter != cache.end()) {
-        setup.cached_shader = iter->second.get();
-    } else {
-        auto shader = std::make_unique<JitShader>();
+    auto [found, shader] = cache.request(cache_key);
+    if (!found) {
+        // This may replace an evicted shader, which is fine as every user of a shader sets up its
+        // batch right before running it.
+        shader = std::make_unique<JitShader>();
         shader->Compile(&setup.program_code, &setup.swizzle_data);
-        setup.cached_shader = shader.get();
-        cache.emplace_hint(iter, cache_key, std::move(shader));
     }
+    setup.cached_shader = shader.get();
 }
 
 MICROPROFILE_DECLARE(GPU_Shader);
@@ -52,6 +51,15 @@ void JitEngine::Run(const ShaderSetup& setup, ShaderUnit& state) const {
     shader->Run(setup, state, setup.entry_point);
 }
 
+void JitEngine::RunBatch(const ShaderSetup& setup, std::span<ShaderUnit> states) const {
+    ASSERT(setup.cached_shader != nullptr);
+
+    MICROPROFILE_SCOPE(GPU_Shader);
+
+    const JitShader* shader = static_cast<const JitShader*>(setup.cached_shader);
+    shader->RunBatch(setup, states, setup.entry_point);
+}
+
 } // namespace Pica::Shader
 
 #endif // CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
@@ -8,8 +8,8 @@
 #if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
 
 #include <memory>
-#include <unordered_map>
 #include "common/common_types.h"
+#include "common/static_lru_cache.h"
 #include "video_core/shader/shader.h"
 
 namespace Pica::Shader {
@@ -23,9 +23,13 @@ public:
 
     void SetupBatch(ShaderSetup& setup, u32 entry_point) override;
     void Run(const ShaderSetup& setup, ShaderUnit& state) const override;
+    void RunBatch(const ShaderSetup& setup, std::span<ShaderUnit> states) const override;
 
 private:
-    std::unordered_map<u64, std::unique_ptr<JitShader>> cache;
+    /// Each compiled shader owns its own code buffer, so only the most recently used are kept.
+    static constexpr std::size_t MaxCachedShaders = 128;
+
+    Common::StaticLRUCache<u64, std::unique_ptr<JitShader>, MaxCachedShaders> cache;
 };
 
 } // namespace Pica::Shader
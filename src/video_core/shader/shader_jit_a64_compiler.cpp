@@ -115,6 +115,10 @@ constexpr XReg COND0 = X13;
 constexpr XReg COND1 = X14;
 /// Pointer to the UnitState instance for the current VS unit
 constexpr XReg STATE = X15;
+/// Address of the instruction each shader unit of a batch starts at
+constexpr XReg START_ADDR = X19;
+/// Number of shader units of the batch left to run
+constexpr XReg NUM_UNITS = X20;
 /// Scratch registers
 constexpr XReg XSCRATCH0 = X4;
 constexpr XReg XSCRATCH1 = X5;
@@ -635,8 +639,7 @@ void JitShader::Compile_END(Instruction instr) {
         u32(offsetof(ShaderUnit, address_registers)));
     STR(LOOPCOUNT_REG.toW(), STATE, u32(offsetof(ShaderUnit, address_registers[2])));
 
-    ABI_PopRegisters(*this, ABI_ALL_CALLEE_SAVED, 16);
-    RET();
+    B(unit_end);
 }
 
 void JitShader::Compile_BREAKC(Instruction instr) {
@@ -926,6 +929,7 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
     program_counter = 0;
     loop_depth = 0;
     instruction_labels.fill(Label());
+    unit_end = Label();
 
     // Find all `CALL` instructions and identify return locations
     FindReturnOffsets();
@@ -939,6 +943,14 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
 
     MOV(UNIFORMS, ABI_PARAM1);
     MOV(STATE, ABI_PARAM2);
+    MOV(START_ADDR, ABI_PARAM3);
+    MOV(NUM_UNITS, ABI_PARAM4);
+
+    // Used to set a register to one
+    FMOV(ONE.S4(), FImm8(false, 7, 0));
+
+    Label next_unit;
+    l(next_unit);
 
     // Load address/loop registers
     LDP(ADDROFFS_REG_0.toW(), ADDROFFS_REG_1.toW(), STATE,
@@ -949,11 +961,17 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
     LDRB(COND0.toW(), STATE, u32(offsetof(ShaderUnit, conditional_code[0])));
     LDRB(COND1.toW(), STATE, u32(offsetof(ShaderUnit, conditional_code[1])));
 
-    // Used to set a register to one
-    FMOV(ONE.S4(), FImm8(false, 7, 0));
-
     // Jump to start of the shader program
-    BR(ABI_PARAM3);
+    BR(START_ADDR);
+
+    // END branches back here, continue with the next shader unit of the batch
+    l(unit_end);
+    ADD(STATE, STATE, sizeof(ShaderUnit));
+    SUBS(NUM_UNITS, NUM_UNITS, 1);
+    B(Cond::NE, next_unit);
+
+    ABI_PopRegisters(*this, ABI_ALL_CALLEE_SAVED, 16);
+    RET();
 
     // Compile entire program
     Compile_Block(static_cast<u32>(program_code->size()));
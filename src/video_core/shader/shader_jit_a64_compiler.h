@@ -11,6 +11,7 @@
 #include <bitset>
 #include <cstddef>
 #include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 #include <nihstro/shader_bytecode.h>
@@ -42,7 +43,15 @@ public:
     JitShader();
 
     void Run(const ShaderSetup& setup, ShaderUnit& state, u32 offset) const {
-        program(&setup.uniforms, &state, instruction_labels[offset].ptr<const std::byte*>());
+        program(&setup.uniforms, &state, instruction_labels[offset].ptr<const std::byte*>(), 1);
+    }
+
+    /// Runs the shader on each of the units within a single call into the compiled code.
+    void RunBatch(const ShaderSetup& setup, std::span<ShaderUnit> states, u32 offset) const {
+        if (!states.empty()) {
+            program(&setup.uniforms, states.data(),
+                    instruction_labels[offset].ptr<const std::byte*>(), states.size());
+        }
     }
 
     void Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code,
@@ -138,11 +147,15 @@ private:
     u32 program_counter = 0; ///< Offset of the next instruction to decode
     u8 loop_depth = 0;       ///< Depth of the (nested) loops currently compiled
 
-    using CompiledShader = void(const void* setup, void* state, const std::byte* start_addr);
+    using CompiledShader = void(const void* setup, void* states, const std::byte* start_addr,
+                                std::size_t num_states);
     CompiledShader* program = nullptr;
 
     oaknut::Label log2_subroutine;
     oaknut::Label exp2_subroutine;
+
+    /// Branched to by END once the current shader unit has finished
+    oaknut::Label unit_end;
 };
 
 } // namespace Pica::Shader
@@ -123,6 +123,8 @@ constexpr Reg64 COND0 = r13;
 constexpr Reg64 COND1 = r14;
 /// Pointer to the ShaderUnit instance for the current VS unit
 constexpr Reg64 STATE = r15;
+/// Address of the instruction each shader unit of a batch starts at
+constexpr Reg64 START_ADDR = rbp;
 /// SIMD scratch register
 constexpr Xmm SCRATCH = xmm0;
 /// Loaded with the first swizzled source register, otherwise can be used as a scratch register
@@ -673,8 +675,7 @@ void JitShader::Compile_END(Instruction instr) {
     mov(dword[STATE + offsetof(ShaderUnit, address_registers[1])], ADDROFFS_REG_1.cvt32());
     mov(dword[STATE + offsetof(ShaderUnit, address_registers[2])], LOOPCOUNT_REG);
 
-    ABI_PopRegistersAndAdjustStack(*this, ABI_ALL_CALLEE_SAVED, 8, 16);
-    ret();
+    jmp(unit_end);
 }
 
 void JitShader::Compile_BREAKC(Instruction instr) {
@@ -983,6 +984,7 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
     program_counter = 0;
     loop_depth = 0;
     instruction_labels.fill(Xbyak::Label());
+    unit_end = Xbyak::Label();
 
     // Find all `CALL` instructions and identify return locations
     FindReturnOffsets();
@@ -993,17 +995,12 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
     ABI_PushRegistersAndAdjustStack(*this, ABI_ALL_CALLEE_SAVED, 8, 16);
     mov(qword[rsp + 8], 0xFFFFFFFFFFFFFFFFULL);
 
+    // Keep the number of shader units to run in the frame, it is read first as ABI_PARAM4 is
+    // aliased by UNIFORMS on Windows.
+    mov(qword[rsp], ABI_PARAM4);
     mov(UNIFORMS, ABI_PARAM1);
     mov(STATE, ABI_PARAM2);
-
-    // Load address/loop registers
-    movsxd(ADDROFFS_REG_0, dword[STATE + offsetof(ShaderUnit, address_registers[0])]);
-    movsxd(ADDROFFS_REG_1, dword[STATE + offsetof(ShaderUnit, address_registers[1])]);
-    mov(LOOPCOUNT_REG, dword[STATE + offsetof(ShaderUnit, address_registers[2])]);
-
-    // Load conditional code
-    mov(COND0, byte[STATE + offsetof(ShaderUnit, conditional_code[0])]);
-    mov(COND1, byte[STATE + offsetof(ShaderUnit, conditional_code[1])]);
+    mov(START_ADDR, ABI_PARAM3);
 
     // Used to set a register to one
     static const __m128 one = {1.f, 1.f, 1.f, 1.f};
@@ -1015,8 +1012,29 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
     mov(rax, reinterpret_cast<std::size_t>(&neg));
     movaps(NEGBIT, xword[rax]);
 
+    Label next_unit;
+    L(next_unit);
+
+    // Load address/loop registers
+    movsxd(ADDROFFS_REG_0, dword[STATE + offsetof(ShaderUnit, address_registers[0])]);
+    movsxd(ADDROFFS_REG_1, dword[STATE + offsetof(ShaderUnit, address_registers[1])]);
+    mov(LOOPCOUNT_REG, dword[STATE + offsetof(ShaderUnit, address_registers[2])]);
+
+    // Load conditional code
+    mov(COND0, byte[STATE + offsetof(ShaderUnit, conditional_code[0])]);
+    mov(COND1, byte[STATE + offsetof(ShaderUnit, conditional_code[1])]);
+
     // Jump to start of the shader program
-    jmp(ABI_PARAM3);
+    jmp(START_ADDR);
+
+    // END jumps back here, continue with the next shader unit of the batch
+    L(unit_end);
+    add(STATE, static_cast<u32>(sizeof(ShaderUnit)));
+    sub(qword[rsp], 1);
+    jnz(next_unit);
+
+    ABI_PopRegistersAndAdjustStack(*this, ABI_ALL_CALLEE_SAVED, 8, 16);
+    ret();
 
     // Compile entire program
     Compile_Block(static_cast<u32>(program_code->size()));
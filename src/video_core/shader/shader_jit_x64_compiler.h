@@ -10,6 +10,7 @@
 #include <array>
 #include <bitset>
 #include <cstddef>
+#include <span>
 #include <vector>
 #include <nihstro/shader_bytecode.h>
 #include <xbyak/xbyak.h>
@@ -39,7 +40,15 @@ public:
     JitShader();
 
     void Run(const ShaderSetup& setup, ShaderUnit& state, u32 offset) const {
-        program(&setup.uniforms, &state, instruction_labels[offset].getAddress());
+        program(&setup.uniforms, &state, instruction_labels[offset].getAddress(), 1);
+    }
+
+    /// Runs the shader on each of the units within a single call into the compiled code.
+    void RunBatch(const ShaderSetup& setup, std::span<ShaderUnit> states, u32 offset) const {
+        if (!states.empty()) {
+            program(&setup.uniforms, states.data(), instruction_labels[offset].getAddress(),
+                    states.size());
+        }
     }
 
     void Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code,
@@ -135,11 +144,15 @@ private:
     u32 program_counter = 0; ///< Offset of the next instruction to decode
     u8 loop_depth = 0;       ///< Depth of the (nested) loops currently compiled
 
-    using CompiledShader = void(const void* setup, void* state, const u8* start_addr);
+    using CompiledShader = void(const void* setup, void* states, const u8* start_addr,
+                                std::size_t num_states);
     CompiledShader* program = nullptr;
 
     Xbyak::Label log2_subroutine;
     Xbyak::Label exp2_subroutine;
+
+    /// Jumped to by END once the current shader unit has finished
+    Xbyak::Label unit_end;
 };
 
 } // namespace Pica::Shader
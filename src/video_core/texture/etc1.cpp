@@ -4,12 +4,19 @@
 
 #include <algorithm>
 #include <array>
+#include "common/arch.h"
 #include "common/bit_field.h"
 #include "common/color.h"
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/texture/etc1.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace Pica::Texture {
 
 namespace {
@@ -69,19 +76,14 @@ union ETC1Tile {
         BitField<60, 4, u64> r1;
     } separate;
 
-    const Common::Vec3<u8> GetRGB(unsigned int x, unsigned int y) const {
-        int texel = 4 * x + y;
-
-        if (flip)
-            std::swap(x, y);
-
-        // Lookup base value
+    /// Returns the base color of the half of the block, 0 for the left or top one
+    Common::Vec3<int> GetBaseColor(unsigned half) const {
         Common::Vec3<int> ret;
         if (differential_mode) {
             ret.r() = static_cast<int>(differential.r);
             ret.g() = static_cast<int>(differential.g);
             ret.b() = static_cast<int>(differential.b);
-            if (x >= 2) {
+            if (half == 1) {
                 ret.r() += static_cast<int>(differential.dr);
                 ret.g() += static_cast<int>(differential.dg);
                 ret.b() += static_cast<int>(differential.db);
@@ -90,7 +92,7 @@ union ETC1Tile {
             ret.g() = Common::Color::Convert5To8(ret.g());
             ret.b() = Common::Color::Convert5To8(ret.b());
         } else {
-            if (x < 2) {
+            if (half == 0) {
                 ret.r() = Common::Color::Convert4To8(static_cast<u8>(separate.r1));
                 ret.g() = Common::Color::Convert4To8(static_cast<u8>(separate.g1));
                 ret.b() = Common::Color::Convert4To8(static_cast<u8>(separate.b1));
@@ -100,20 +102,30 @@ union ETC1Tile {
                 ret.b() = Common::Color::Convert4To8(static_cast<u8>(separate.b2));
             }
         }
+        return ret;
+    }
 
-        // Add modifier
-        unsigned table_index =
-            static_cast<int>((x < 2) ? table_index_1.Value() : table_index_2.Value());
-
-        int modifier = etc1_modifier_table[table_index][GetTableSubIndex(texel)];
-        if (GetNegationFlag(texel))
-            modifier *= -1;
+    /// Returns the modifier added to the base color of the texel
+    int GetModifier(unsigned half, unsigned texel) const {
+        const unsigned table_index =
+            static_cast<unsigned>(half == 0 ? table_index_1.Value() : table_index_2.Value());
+        const int modifier = etc1_modifier_table[table_index][GetTableSubIndex(texel)];
+        return GetNegationFlag(texel) ? -modifier : modifier;
+    }
 
-        ret.r() = std::clamp(ret.r() + modifier, 0, 255);
-        ret.g() = std::clamp(ret.g() + modifier, 0, 255);
-        ret.b() = std::clamp(ret.b() + modifier, 0, 255);
+    /// Returns the half of the block holding the texel
+    unsigned GetHalf(unsigned x, unsigned y) const {
+        return ((flip ? y : x) >= 2) ? 1 : 0;
+    }
 
-        return ret.Cast<u8>();
+    const Common::Vec3<u8> GetRGB(unsigned int x, unsigned int y) const {
+        const unsigned half = GetHalf(x, y);
+        const int modifier = GetModifier(half, 4 * x + y);
+        const Common::Vec3<int> ret = GetBaseColor(half);
+        return Common::Vec3<int>{std::clamp(ret.r() + modifier, 0, 255),
+                                 std::clamp(ret.g() + modifier, 0, 255),
+                                 std::clamp(ret.b() + modifier, 0, 255)}
+            .Cast<u8>();
     }
 };
 
@@ -124,4 +136,42 @@ Common::Vec3<u8> SampleETC1Subtile(u64 value, unsigned int x, unsigned int y) {
     return tile.GetRGB(x, y);
 }
 
+void DecodeETC1Subtile(u64 value, std::span<u8, ETC1SubtileDecodedSize> dest) {
+    const ETC1Tile tile{value};
+    const std::array<Common::Vec3<int>, 2> base_colors = {tile.GetBaseColor(0),
+                                                          tile.GetBaseColor(1)};
+
+    // The block header is parsed once, then each texel only needs its modifier added to the base
+    // color of its half. The sums are saturated to bytes a row at a time.
+    alignas(16) std::array<s16, ETC1SubtileDecodedSize> sums;
+    for (unsigned y = 0; y < 4; y++) {
+        for (unsigned x = 0; x < 4; x++) {
+            const unsigned half = tile.GetHalf(x, y);
+            const int modifier = tile.GetModifier(half, 4 * x + y);
+            const Common::Vec3<int>& base = base_colors[half];
+            s16* texel = &sums[(y * 4 + x) * 4];
+            texel[0] = static_cast<s16>(base.r() + modifier);
+            texel[1] = static_cast<s16>(base.g() + modifier);
+            texel[2] = static_cast<s16>(base.b() + modifier);
+            texel[3] = 255;
+        }
+    }
+
+    for (std::size_t i = 0; i < sums.size(); i += 16) {
+#if CITRA_ARCH(x86_64)
+        const __m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(&sums[i]));
+        const __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(&sums[i + 8]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dest[i]), _mm_packus_epi16(low, high));
+#elif CITRA_ARCH(arm64)
+        const uint8x8_t low = vqmovun_s16(vld1q_s16(&sums[i]));
+        const uint8x8_t high = vqmovun_s16(vld1q_s16(&sums[i + 8]));
+        vst1q_u8(&dest[i], vcombine_u8(low, high));
+#else
+        for (std::size_t j = i; j < i + 16; j++) {
+            dest[j] = static_cast<u8>(std::clamp<int>(sums[j], 0, 255));
+        }
+#endif
+    }
+}
+
 } // namespace Pica::Texture
@@ -4,11 +4,21 @@
 
 #pragma once
 
+#include <span>
 #include "common/common_types.h"
 #include "common/vector_math.h"
 
 namespace Pica::Texture {
 
+/// Size of a decoded 4x4 ETC1 subtile, in RGBA8 texels
+constexpr std::size_t ETC1SubtileDecodedSize = 4 * 4 * 4;
+
 Common::Vec3<u8> SampleETC1Subtile(u64 value, unsigned int x, unsigned int y);
 
+/**
+ * Decodes all the texels of a 4x4 ETC1 subtile to RGBA8 with an opaque alpha. The texel at
+ * (x, y), y counted from the top, is stored at (y * 4 + x) * 4.
+ */
+void DecodeETC1Subtile(u64 value, std::span<u8, ETC1SubtileDecodedSize> dest);
+
 } // namespace Pica::Texture
@@ -0,0 +1,140 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include "common/common_types.h"
+#include "common/hash.h"
+#include "common/literals.h"
+
+namespace VideoCore {
+
+using namespace Common::Literals;
+
+/**
+ * Keeps the guest vertex arrays read by accelerated draws in persistent host buffers, so that
+ * meshes redrawn unchanged are bound directly instead of being copied to the stream buffer on
+ * every draw. Guest writes are not tracked, every lookup compares a hash of the guest data with
+ * the cached one instead. An array only gets a buffer after being drawn unchanged a few times,
+ * dynamic data keeps being streamed.
+ */
+template <typename Buffer>
+class VertexArrayCache {
+    /// Number of unchanged draws after which an array is given a persistent buffer
+    static constexpr u32 PromoteDraws = 2;
+
+    /// Arrays not drawn for this many frames are evicted
+    static constexpr u64 MaxUnusedFrames = 120;
+
+    /// Upper bound of the total size of the persistent buffers
+    static constexpr std::size_t MaxCachedBytes = 64_MiB;
+
+public:
+    /// Receives the buffers dropped by the cache, they may still be used by pending draws
+    using ReleaseFunc = std::function<void(Buffer&&)>;
+
+    explicit VertexArrayCache(ReleaseFunc release_ = {}) : release{std::move(release_)} {}
+
+    /**
+     * Looks up the array at address with the given guest contents.
+     * @param stride Guest stride of the vertices, the layout of the buffer depends on it
+     * @param buffer_size Size of the persistent buffer created for the array
+     * @param create Called to create the persistent buffer once the array is considered static
+     * @returns The buffer holding the array, or nullptr when it has to be streamed
+     */
+    template <typename Create>
+    const Buffer* Get(PAddr address, u32 stride, std::span<const u8> data,
+                      std::size_t buffer_size, Create&& create) {
+        const Key key{address, static_cast<u32>(data.size()), stride};
+        const u64 hash = Common::ComputeFastHash64(data.data(), data.size());
+        auto& entry = entries[key];
+        entry.last_use = current_frame;
+        if (entry.hash != hash) {
+            entry.hash = hash;
+            entry.unchanged_draws = 0;
+            Drop(entry);
+            return nullptr;
+        }
+        if (entry.buffer) {
+            return &*entry.buffer;
+        }
+        if (++entry.unchanged_draws < PromoteDraws ||
+            cached_bytes + buffer_size > MaxCachedBytes) {
+            return nullptr;
+        }
+        entry.buffer.emplace(create());
+        entry.buffer_size = buffer_size;
+        cached_bytes += buffer_size;
+        return &*entry.buffer;
+    }
+
+    /// Evicts the arrays that were not drawn recently
+    void TickFrame() {
+        ++current_frame;
+        for (auto it = entries.begin(); it != entries.end();) {
+            auto& entry = it->second;
+            if (entry.last_use + MaxUnusedFrames >= current_frame) {
+                ++it;
+                continue;
+            }
+            Drop(entry);
+            it = entries.erase(it);
+        }
+    }
+
+    /// Drops all arrays
+    void Clear() {
+        for (auto& [key, entry] : entries) {
+            Drop(entry);
+        }
+        entries.clear();
+    }
+
+private:
+    struct Key {
+        PAddr address;
+        u32 size;
+        u32 stride;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept {
+            return Common::HashCombine(key.address | static_cast<u64>(key.size) << 32,
+                                       key.stride);
+        }
+    };
+
+    struct Entry {
+        u64 hash;
+        u64 last_use;
+        u32 unchanged_draws;
+        std::size_t buffer_size;
+        std::optional<Buffer> buffer;
+    };
+
+    void Drop(Entry& entry) {
+        if (!entry.buffer) {
+            return;
+        }
+        cached_bytes -= entry.buffer_size;
+        if (release) {
+            release(std::move(*entry.buffer));
+        }
+        entry.buffer.reset();
+    }
+
+private:
+    ReleaseFunc release;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::size_t cached_bytes{};
+    u64 current_frame{};
+};
+
+} // namespace VideoCore
@@ -4,7 +4,9 @@
 
 #include "common/logging/log.h"
 #include "common/settings.h"
+#include "core/core.h"
 #include "video_core/gpu.h"
+#include "video_core/renderer_null/renderer_null.h"
 #ifdef ENABLE_OPENGL
 #include "video_core/renderer_opengl/renderer_opengl.h"
 #endif
@@ -35,6 +37,8 @@ std::unique_ptr<RendererBase> CreateRenderer(Frontend::EmuWindow& emu_window,
     case Settings::GraphicsAPI::OpenGL:
         return std::make_unique<OpenGL::RendererOpenGL>(system, pica, emu_window, secondary_window);
 #endif
+    case Settings::GraphicsAPI::Null:
+        return std::make_unique<NullRenderer::RendererNull>(system, emu_window);
     default:
         LOG_CRITICAL(Render,
                      "Unknown or unsupported graphics API {}, falling back to available default",
@@ -46,10 +50,15 @@ std::unique_ptr<RendererBase> CreateRenderer(Frontend::EmuWindow& emu_window,
 #elif ENABLE_SOFTWARE_RENDERER
         return std::make_unique<SwRenderer::RendererSoftware>(system, pica, emu_window);
 #else
-// TODO: Add a null renderer backend for this, perhaps.
-#error "At least one renderer must be enabled."
+        return std::make_unique<NullRenderer::RendererNull>(system, emu_window);
 #endif
     }
 }
 
+void CountFrameEvent(Core::System& system, Core::PerfStats::FrameCounter counter) {
+    if (auto& perf_stats = system.perf_stats) {
+        perf_stats->CountFrameEvent(counter);
+    }
+}
+
 } // namespace VideoCore
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include "core/perf_stats.h"
 
 namespace Frontend {
 class EmuWindow;
@@ -26,4 +27,7 @@ std::unique_ptr<RendererBase> CreateRenderer(Frontend::EmuWindow& emu_window,
                                              Frontend::EmuWindow* secondary_window,
                                              Pica::PicaCore& pica, Core::System& system);
 
+/// Counts an event of the current frame in the performance statistics of the running title.
+void CountFrameEvent(Core::System& system, Core::PerfStats::FrameCounter counter);
+
 } // namespace VideoCore
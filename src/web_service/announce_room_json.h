@@ -33,6 +33,7 @@ public:
     void ClearPlayers() override;
     AnnounceMultiplayerRoom::RoomList GetRoomList() override;
     void Delete() override;
+    void Interrupt() override;
 
 private:
     AnnounceMultiplayerRoom::Room room;
@@ -4,14 +4,18 @@
 
 #include <array>
 #include <cstdlib>
+#include <deque>
+#include <map>
 #include <mutex>
 #include <string>
+#include <tuple>
 #include <fmt/format.h>
 #if defined(__ANDROID__)
 #include <ifaddrs.h>
 #endif
 #include <httplib.h>
 #include "common/common_types.h"
+#include "common/detached_tasks.h"
 #include "common/logging/log.h"
 #include "common/web_result.h"
 #include "web_service/web_backend.h"
@@ -20,7 +24,8 @@ namespace WebService {
 
 constexpr std::array<const char, 1> API_VERSION{'1'};
 
-constexpr std::size_t TIMEOUT_SECONDS = 30;
+constexpr std::size_t CONNECTION_TIMEOUT_SECONDS = 5;
+constexpr std::size_t TIMEOUT_SECONDS = 15;
 
 struct Client::Impl {
     Impl(std::string host, std::string username, std::string token)
@@ -33,6 +38,12 @@ struct Client::Impl {
         if (!this->host.empty() && this->host.back() == '/') {
             static_cast<void>(this->host.pop_back());
         }
+        // The connection is kept open between the requests of the client
+        cli = std::make_unique<httplib::Client>(this->host.c_str());
+        cli->set_keep_alive(true);
+        cli->set_connection_timeout(CONNECTION_TIMEOUT_SECONDS);
+        cli->set_read_timeout(TIMEOUT_SECONDS);
+        cli->set_write_timeout(TIMEOUT_SECONDS);
     }
 
     /// A generic function handles POST, GET and DELETE request together
@@ -69,12 +80,6 @@ struct Client::Impl {
                                      const std::string& data, const std::string& accept,
                                      const std::string& jwt = "", const std::string& username = "",
                                      const std::string& token = "") {
-        if (cli == nullptr) {
-            cli = std::make_unique<httplib::Client>(host.c_str());
-            cli->set_connection_timeout(TIMEOUT_SECONDS);
-            cli->set_read_timeout(TIMEOUT_SECONDS);
-            cli->set_write_timeout(TIMEOUT_SECONDS);
-        }
         if (!cli->is_valid()) {
             LOG_ERROR(WebService, "Invalid URL {}", host + path);
             return Common::WebResult{Common::WebResult::Code::InvalidURL, "Invalid URL"};
@@ -199,4 +204,70 @@ Common::WebResult Client::GetExternalJWT(const std::string& audience) {
                                 "text/html");
 }
 
+void Client::Interrupt() {
+    impl->cli->stop();
+}
+
+namespace {
+
+class RequestQueue {
+public:
+    void Push(std::string host, std::string username, std::string token,
+              std::function<void(Client&)> request) {
+        std::scoped_lock lock{mutex};
+        requests.push_back({{std::move(host), std::move(username), std::move(token)},
+                            std::move(request)});
+        if (!running) {
+            running = true;
+            Common::DetachedTasks::AddTask([this] { Run(); });
+        }
+    }
+
+private:
+    using ClientKey = std::tuple<std::string, std::string, std::string>;
+
+    struct QueuedRequest {
+        ClientKey key;
+        std::function<void(Client&)> request;
+    };
+
+    /// Sends the queued requests, and returns once there are none left
+    void Run() {
+        while (true) {
+            QueuedRequest request;
+            {
+                std::scoped_lock lock{mutex};
+                if (requests.empty()) {
+                    running = false;
+                    return;
+                }
+                request = std::move(requests.front());
+                requests.pop_front();
+            }
+
+            // Only one task runs at a time, so the clients need no lock
+            auto& client = clients[request.key];
+            if (!client) {
+                const auto& [host, username, token] = request.key;
+                client = std::make_unique<Client>(host, username, token);
+            }
+            request.request(*client);
+        }
+    }
+
+    std::mutex mutex;
+    std::deque<QueuedRequest> requests;
+    bool running = false;
+
+    std::map<ClientKey, std::unique_ptr<Client>> clients;
+};
+
+} // Anonymous namespace
+
+void QueueRequest(std::string host, std::string username, std::string token,
+                  std::function<void(Client&)> request) {
+    static RequestQueue queue;
+    queue.Push(std::move(host), std::move(username), std::move(token), std::move(request));
+}
+
 } // namespace WebService
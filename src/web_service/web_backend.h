@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -69,9 +70,28 @@ public:
      */
     Common::WebResult GetExternalJWT(const std::string& audience);
 
+    /**
+     * Aborts the request this client is sending, from another thread. The request fails as if the
+     * connection was lost.
+     */
+    void Interrupt();
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl;
 };
 
+/**
+ * Sends a request without waiting for it, like a telemetry report. The queued requests are sent
+ * one after the other on a single background task, which the program waits for on exit. Their
+ * clients are kept, so that requests with the same host and credentials reuse the connection and
+ * the JWT of the previous ones.
+ * @param host the host address of the web service.
+ * @param username the username to authenticate with, or empty for anonymous requests.
+ * @param token the token to authenticate with, or empty for anonymous requests.
+ * @param request function sending the request with the client, called on the background task.
+ */
+void QueueRequest(std::string host, std::string username, std::string token,
+                  std::function<void(Client&)> request);
+
 } // namespace WebService